@@ -0,0 +1,429 @@
+/**
+ * \file            bench.c
+ * \brief           Benchmark suite for drawing primitives and widget scenarios
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "app.h"
+#include "bench.h"
+#include "gui/gui_private.h"
+
+#if defined(GUI_BENCH)
+
+#if !GUI_CFG_USE_STATS
+#error "Benchmark requires GUI_CFG_USE_STATS to be enabled"
+#endif /* !GUI_CFG_USE_STATS */
+
+extern gui_const gui_font_t GUI_Font_Arial_Narrow_Italic_21_AA;
+
+#define BENCH_ID_BASE               (GUI_ID_USER + 0x7000)
+#define BENCH_IMAGE_SIZE            64
+#define BENCH_FRAME_TIME            20          /* Time of single scenario step in units of milliseconds */
+
+/**
+ * \brief           Measurement of single benchmark entry
+ */
+typedef struct {
+    uint32_t count;                             /*!< Number of calls or frames */
+    uint32_t total;                             /*!< Total time in units of microseconds */
+    uint32_t max;                               /*!< Maximal time of single call or frame */
+} bench_result_t;
+
+/* Source image data in all direct color formats and indexed formats */
+static uint32_t image_data[BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE];
+static gui_color_t image_palette[256];
+static gui_display_t disp;
+static char line[96];
+
+/**
+ * \brief           Lock GUI core so drawing is not interrupted by GUI thread
+ */
+static void
+bench_lock(void) {
+#if GUI_CFG_OS
+    gui_sys_protect();
+#endif /* GUI_CFG_OS */
+}
+
+/**
+ * \brief           Wait for low-level drawing to finish and unlock GUI core
+ */
+static void
+bench_unlock(void) {
+    while (!GUI.ll.IsReady(&GUI.lcd));
+#if GUI_CFG_OS
+    gui_sys_unprotect();
+#endif /* GUI_CFG_OS */
+}
+
+/**
+ * \brief           Print single result line
+ * \param[in]       group: Result group name
+ * \param[in]       name: Result name
+ * \param[in]       r: Measurement
+ */
+static void
+bench_report(const char* group, const char* name, const bench_result_t* r) {
+    sprintf(line, "%s,%s,%u,%u,%u.%02u,%u\r\n", group, name, (unsigned)r->count, (unsigned)r->total,
+        (unsigned)(r->count ? r->total / r->count : 0), (unsigned)(r->count ? (r->total % r->count) * 100 / r->count : 0),
+        (unsigned)r->max);
+    bench_print(line);
+}
+
+/**
+ * \brief           Draw one primitive, selected by index
+ * \param[in]       type: Primitive type
+ * \param[in]       i: Iteration number to vary position and color
+ * \param[in]       arg: Primitive specific argument
+ */
+static void
+bench_draw(uint8_t type, uint32_t i, const void* arg) {
+    gui_dim_t w = GUI.lcd.width, h = GUI.lcd.height;
+    gui_dim_t x = (gui_dim_t)((i * 37) % (w - BENCH_IMAGE_SIZE)), y = (gui_dim_t)((i * 23) % (h - BENCH_IMAGE_SIZE));
+    gui_color_t color = (i & 1) ? GUI_COLOR_BLUE : GUI_COLOR_RED;
+    
+    switch (type) {
+        case 0: gui_draw_filledrectangle(&disp, 0, 0, w, h, color); break;
+        case 1: gui_draw_filledrectangle(&disp, x, y, 64, 64, color); break;
+        case 2: gui_draw_line(&disp, x, y, w - 1 - x, h - 1 - y, color); break;
+        case 3: gui_draw_line_aa(&disp, x, y, w - 1 - x, h - 1 - y, color); break;
+        case 4: gui_draw_filledcircle(&disp, x + 32, y + 32, 30, color); break;
+        case 5: gui_draw_circle_aa(&disp, x + 32, y + 32, 30, color); break;
+        case 6: gui_draw_image(&disp, x, y, arg); break;
+        case 7: {
+            gui_draw_font_t f;
+            
+            gui_draw_font_init(&f);
+            f.x = x;
+            f.y = y;
+            f.width = w - x;
+            f.height = 40;
+            f.color1width = f.width;
+            f.color1 = color;
+            gui_draw_writetext(&disp, arg, _GT("The quick brown fox jumps over the lazy dog"), &f);
+            break;
+        }
+        default: break;
+    }
+}
+
+/**
+ * \brief           Measure drawing primitive
+ * \param[in]       name: Result name
+ * \param[in]       type: Primitive type for \ref bench_draw
+ * \param[in]       count: Number of calls
+ * \param[in]       arg: Primitive specific argument
+ */
+static void
+bench_primitive(const char* name, uint8_t type, uint32_t count, const void* arg) {
+    bench_result_t r = {0};
+    uint32_t i, t, start;
+    
+    bench_lock();
+    bench_draw(type, 0, arg);                   /* Warm up caches, for example font cache */
+    while (!GUI.ll.IsReady(&GUI.lcd));
+    start = bench_time();
+    for (i = 0; i < count; i++) {
+        t = bench_time();
+        bench_draw(type, i, arg);
+        t = bench_time() - t;
+        r.max = GUI_MAX(r.max, t);
+    }
+    while (!GUI.ll.IsReady(&GUI.lcd));          /* Queued hardware drawing is part of measurement */
+    r.total = bench_time() - start;
+    r.count = count;
+    bench_unlock();
+    bench_report("draw", name, &r);
+}
+
+/**
+ * \brief           Prepare images in all formats from the same pixel data
+ * \param[out]      imgs: Image descriptors for 16, 24, 32 bit and 8, 4 bit indexed images
+ */
+static void
+bench_images(gui_image_desc_t* imgs) {
+    static uint16_t data16[BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE];
+    static uint8_t data24[BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE * 3];
+    static uint8_t data8[BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE];
+    static uint8_t data4[BENCH_IMAGE_SIZE * BENCH_IMAGE_SIZE / 2];
+    size_t i;
+    uint8_t r, g, b;
+    
+    for (i = 0; i < GUI_COUNT_OF(image_palette); i++) {
+        image_palette[i] = 0xFF000000UL | ((uint32_t)i << 16) | ((uint32_t)(255 - i) << 8) | (uint32_t)(i ^ 0x55);
+    }
+    for (i = 0; i < GUI_COUNT_OF(image_data); i++) {
+        r = (uint8_t)(i * 4);
+        g = (uint8_t)(i / BENCH_IMAGE_SIZE * 4);
+        b = (uint8_t)(r ^ g);
+        image_data[i] = ((i & 0x07) == 0 ? 0x80000000UL : 0x00000000UL) | ((uint32_t)b << 16) | ((uint32_t)g << 8) | r;  /* Inverted alpha, swapped red and blue */
+        data16[i] = (uint16_t)(((b >> 3) << 11) | ((g >> 2) << 5) | (r >> 3));
+        data24[3 * i + 0] = r;
+        data24[3 * i + 1] = g;
+        data24[3 * i + 2] = b;
+        data8[i] = (uint8_t)(r ^ g);
+        if (i & 0x01) {
+            data4[i >> 1] |= (uint8_t)((data8[i] & 0x0F) << 4);
+        } else {
+            data4[i >> 1] = (uint8_t)(data8[i] & 0x0F);
+        }
+    }
+    for (i = 0; i < 5; i++) {
+        memset(&imgs[i], 0x00, sizeof(imgs[i]));
+        imgs[i].x_size = BENCH_IMAGE_SIZE;
+        imgs[i].y_size = BENCH_IMAGE_SIZE;
+    }
+    imgs[0].bpp = 16; imgs[0].image = (const uint8_t *)data16;
+    imgs[1].bpp = 24; imgs[1].image = data24;
+    imgs[2].bpp = 32; imgs[2].image = (const uint8_t *)image_data;
+    imgs[3].bpp = 8; imgs[3].image = data8; imgs[3].palette = image_palette; imgs[3].palette_size = 256;
+    imgs[4].bpp = 4; imgs[4].image = data4; imgs[4].palette = image_palette; imgs[4].palette_size = 16;
+}
+
+/**
+ * \brief           Collect redraw time of last frame
+ * \param[in,out]   r: Scenario result to update
+ * \param[in,out]   frames: Frame counter seen at last call
+ */
+static void
+bench_frame(bench_result_t* r, uint32_t* frames) {
+    gui_stats_t st;
+    uint32_t t;
+    
+    gui_getstats(&st);
+    if (st.frames != *frames) {                 /* New frame was drawn since last check */
+        *frames = st.frames;
+        t = st.time_redraw + st.time_wait;      /* Include waiting for hardware drawing */
+        r->count++;
+        r->total += t;
+        r->max = GUI_MAX(r->max, t);
+    }
+}
+
+/**
+ * \brief           Scroll full screen listview row by row
+ */
+static void
+bench_scenario_listview(void) {
+    bench_result_t r = {0};
+    gui_handle_p h;
+    gui_listview_row_p row;
+    uint32_t frames = 0;
+    static char str[200][2][12];               /* Listview does not copy item text */
+    int i;
+    
+    h = gui_listview_create(BENCH_ID_BASE, 0, 0, GUI.lcd.width, GUI.lcd.height, NULL, NULL, 0);
+    gui_listview_addcolumn(h, _GT("Name"), GUI.lcd.width / 2);
+    gui_listview_addcolumn(h, _GT("Value"), GUI.lcd.width / 4);
+    for (i = 0; i < (int)GUI_COUNT_OF(str); i++) {
+        row = gui_listview_addrow(h);
+        sprintf(str[i][0], "Row %d", i);
+        gui_listview_setitemstring(h, row, 0, _GT(str[i][0]));
+        sprintf(str[i][1], "%d", i * 7);
+        gui_listview_setitemstring(h, row, 1, _GT(str[i][1]));
+    }
+    bench_wait(BENCH_FRAME_TIME);
+    bench_frame(&r, &frames);
+    r.count = r.total = r.max = 0;              /* First frame is not part of scroll */
+    
+    for (i = 0; i < 100; i++) {
+        gui_listview_scroll(h, 1);
+        bench_wait(BENCH_FRAME_TIME);
+        bench_frame(&r, &frames);
+    }
+    bench_report("scenario", "listview_scroll", &r);
+    gui_widget_remove(&h);
+    bench_wait(BENCH_FRAME_TIME);
+}
+
+/**
+ * \brief           Toggle 50 LEDs at the same time
+ */
+static void
+bench_scenario_leds(void) {
+    bench_result_t r = {0};
+    gui_handle_p win, leds[50];
+    uint32_t frames = 0;
+    size_t i;
+    int step;
+    
+    win = gui_window_create(BENCH_ID_BASE, 0, 0, GUI.lcd.width, GUI.lcd.height, NULL, NULL, 0);
+    for (i = 0; i < GUI_COUNT_OF(leds); i++) {
+        leds[i] = gui_led_create(BENCH_ID_BASE + 1 + i, 10 + (i % 10) * 40, 10 + (i / 10) * 40, 30, 30, win, NULL, 0);
+    }
+    bench_wait(BENCH_FRAME_TIME);
+    bench_frame(&r, &frames);
+    r.count = r.total = r.max = 0;
+    
+    for (step = 0; step < 50; step++) {
+        for (i = 0; i < GUI_COUNT_OF(leds); i++) {
+            gui_led_toggle(leds[i]);
+        }
+        bench_wait(BENCH_FRAME_TIME);
+        bench_frame(&r, &frames);
+    }
+    bench_report("scenario", "leds_toggle_50", &r);
+    gui_widget_remove(&win);
+    bench_wait(BENCH_FRAME_TIME);
+}
+
+/**
+ * \brief           Open and close virtual keyboard with animation
+ */
+static void
+bench_scenario_keyboard(void) {
+    bench_result_t r = {0};
+    gui_handle_p h;
+    uint32_t frames = 0;
+    int step;
+    
+    h = gui_edittext_create(BENCH_ID_BASE, 10, 10, 200, 40, NULL, NULL, 0);
+    bench_wait(BENCH_FRAME_TIME);
+    bench_frame(&r, &frames);
+    r.count = r.total = r.max = 0;
+    
+    gui_keyboard_show(h);
+    for (step = 0; step < 20; step++) {         /* Covers whole opening animation */
+        bench_wait(BENCH_FRAME_TIME);
+        bench_frame(&r, &frames);
+    }
+    bench_report("scenario", "keyboard_open", &r);
+    
+    memset(&r, 0x00, sizeof(r));
+    gui_keyboard_hide();
+    for (step = 0; step < 20; step++) {
+        bench_wait(BENCH_FRAME_TIME);
+        bench_frame(&r, &frames);
+    }
+    bench_report("scenario", "keyboard_close", &r);
+    gui_widget_remove(&h);
+    bench_wait(BENCH_FRAME_TIME);
+}
+
+/**
+ * \brief           Get hash of shown frame
+ * \return          FNV-1a hash of active layer pixels
+ */
+static uint32_t
+bench_framehash(void) {
+    const gui_layer_t* layer = GUI.lcd.active_layer;
+    const uint8_t* p = (const uint8_t *)layer->start_address;
+    size_t i, len = (size_t)layer->width * layer->height * layer->pixel_size;
+    uint32_t hash = 0x811C9DC5UL;
+    
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ p[i]) * 0x01000193UL;
+    }
+    return hash;
+}
+
+/**
+ * \brief           Scroll listview while edit text below it is invalidated in the same frame
+ * \note            Invalidation marks overlapping listview for redraw inside dirty regions only,
+ *                  so moved rows must still be copied. Final frame is compared with complete redraw
+ */
+static void
+bench_scenario_scroll_sibling(void) {
+    bench_result_t r = {0};
+    gui_handle_p ed, lv;
+    gui_listview_row_p row;
+    uint32_t frames = 0, hash;
+    static char str[60][12];                    /* Listview does not copy item text */
+    int i;
+    
+    ed = gui_edittext_create(BENCH_ID_BASE, 10, 10, 200, 40, NULL, NULL, 0);
+    lv = gui_listview_create(BENCH_ID_BASE + 1, 10, 30, GUI.lcd.width / 2, GUI.lcd.height - 40, NULL, NULL, 0);
+    gui_listview_addcolumn(lv, _GT("Name"), GUI.lcd.width / 3);
+    for (i = 0; i < (int)GUI_COUNT_OF(str); i++) {
+        row = gui_listview_addrow(lv);
+        sprintf(str[i], "Row %d", i);
+        gui_listview_setitemstring(lv, row, 0, _GT(str[i]));
+    }
+    bench_wait(BENCH_FRAME_TIME);
+    bench_frame(&r, &frames);
+    r.count = r.total = r.max = 0;
+    
+    for (i = 0; i < 30; i++) {
+        gui_listview_scroll(lv, 1);
+        gui_widget_invalidate(ed);
+        bench_wait(BENCH_FRAME_TIME);
+        bench_frame(&r, &frames);
+    }
+    bench_report("scenario", "listview_scroll_sibling", &r);
+    
+    hash = bench_framehash();
+    gui_widget_invalidate(gui_window_getdesktop());
+    bench_wait(BENCH_FRAME_TIME);
+    bench_print(hash == bench_framehash() ? "check,scroll_sibling_redraw,ok\r\n" : "check,scroll_sibling_redraw,FAIL\r\n");
+    gui_widget_remove(&lv);
+    gui_widget_remove(&ed);
+    bench_wait(BENCH_FRAME_TIME);
+}
+
+/**
+ * \brief           Run all benchmarks and print results
+ * \note            Run it before application creates its widgets, screen content is overwritten
+ */
+void
+bench_run(void) {
+    gui_image_desc_t imgs[5];
+    
+    guii_widget_setfontdefault(&GUI_Font_Arial_Narrow_Italic_22);  /* Scenario widgets use application font */
+    
+    disp.x1 = 0;
+    disp.y1 = 0;
+    disp.x2 = GUI.lcd.width;
+    disp.y2 = GUI.lcd.height;
+    bench_images(imgs);
+    
+    bench_print("group,name,count,total_us,avg_us,max_us\r\n");
+    
+    bench_primitive("fill_screen", 0, 50, NULL);
+    bench_primitive("fill_rect_64", 1, 1000, NULL);
+    bench_primitive("line", 2, 1000, NULL);
+    bench_primitive("line_aa", 3, 1000, NULL);
+    bench_primitive("filledcircle_r30", 4, 1000, NULL);
+    bench_primitive("circle_aa_r30", 5, 1000, NULL);
+    bench_primitive("image_16bpp_64", 6, 500, &imgs[0]);
+    bench_primitive("image_24bpp_64", 6, 500, &imgs[1]);
+    bench_primitive("image_32bpp_64", 6, 500, &imgs[2]);
+    bench_primitive("image_8bpp_idx_64", 6, 500, &imgs[3]);
+    bench_primitive("image_4bpp_idx_64", 6, 500, &imgs[4]);
+    bench_primitive("text", 7, 200, &GUI_Font_Arial_Narrow_Italic_22);
+    bench_primitive("text_aa", 7, 200, &GUI_Font_Arial_Narrow_Italic_21_AA);
+    
+    gui_widget_invalidate(gui_window_getdesktop()); /* Primitives drew over screen content */
+    bench_wait(BENCH_FRAME_TIME);
+    
+    bench_scenario_listview();
+    bench_scenario_leds();
+    bench_scenario_keyboard();
+    bench_scenario_scroll_sibling();
+}
+
+#endif /* defined(GUI_BENCH) */
@@ -0,0 +1,59 @@
+/**
+ * \file            bench.h
+ * \brief           Benchmark suite for drawing primitives and widget scenarios
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#include "stdint.h"
+
+/*
+ * Results are printed as CSV table with header line:
+ *
+ * group,name,count,total_us,avg_us,max_us
+ *
+ * Rendering checks, run after scenarios, print "check,name,ok" or "check,name,FAIL" line
+ *
+ * Primitives report time of all calls, scenarios report redraw time of frames
+ * taken from GUI statistics, so GUI_CFG_USE_STATS must be enabled with
+ * GUI_CFG_STATS_TIME set to bench_time()
+ *
+ * On host, build "main.c" and "bench.c" with headless port, see "main.c".
+ * On board, define GUI_BENCH globally, add "dev/bench" to include path
+ * and "bench.c" with "bench_board.c" to project, results go to debug output
+ */
+
+void        bench_run(void);
+
+/* Functions provided by port */
+uint32_t    bench_time(void);                   /* Get time in units of microseconds */
+void        bench_wait(uint32_t ms);            /* Let GUI process inputs, timers and redraw for some time */
+void        bench_print(const char* line);      /* Output single line of result table */
+
+#endif /* __BENCH_H */
@@ -0,0 +1,51 @@
+/**
+ * \file            bench_board.c
+ * \brief           Benchmark port functions for STM32 board
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#include "app.h"
+#include "bench.h"
+
+#if defined(GUI_BENCH) && !defined(GUI_SIM)
+/* DWT cycle counter is enabled in main() */
+uint32_t
+bench_time(void) {
+    return DWT->CYCCNT / (SystemCoreClock / 1000000UL);
+}
+
+void
+bench_wait(uint32_t ms) {
+    osDelay(ms);                                /* GUI thread processes meanwhile */
+}
+
+void
+bench_print(const char* line) {
+    printf("%s", line);                         /* Printed to debug USART */
+}
+
+#endif /* defined(GUI_BENCH) && !defined(GUI_SIM) */
@@ -0,0 +1,46 @@
+/**
+ * \file            gui_config.h
+ * \brief           GUI configuration for host benchmark with headless port
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#ifndef __GUI_BENCH_CONFIG_H
+#define __GUI_BENCH_CONFIG_H
+
+/*
+ * Put "dev/bench" and "dev/sim" before "dev/include" on include path,
+ * benchmark uses same settings as board application
+ */
+
+#define GUI_SIM                                 1
+#define GUI_BENCH                               1
+#define GUI_CFG_OS                              0   /* Headless port is driven from benchmark directly */
+#define GUI_CFG_MEM_ALIGNMENT                   8   /* Pointers are 64-bit on most hosts */
+
+#include "../include/gui_config.h"
+
+#endif /* __GUI_BENCH_CONFIG_H */
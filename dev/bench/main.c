@@ -0,0 +1,77 @@
+/**
+ * \file            main.c
+ * \brief           Host benchmark entry point
+ *
+ * \note            Benchmark renders to memory with headless port, time of GUI is virtual,
+ *                  while measured times come from host monotonic clock.
+ *                  Compile with host compiler, with "dev/bench" and "dev/sim" before "dev/include" on include path:
+ *
+ *                  - All source files from "src/gui" except "gui_template.c", all from "src/widget" and "dev/images"
+ *                  - Fonts from "src/fonts" used by board project, "Roboto_Italic_14.c" is not part of it
+ *                  - "src/system/gui_ll_headless.c" and "src/system/gui_system_headless.c"
+ *                  - "dev/src/gui_app.c", "dev/src/gui_callbacks.c", "dev/sim/sim.c" and all source files from "dev/bench"
+ *
+ *                  Use the same optimization flags as compared builds, for example "-O2"
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#include "time.h"
+#include "app.h"
+#include "bench.h"
+#include "system/gui_headless.h"
+
+uint32_t
+bench_time(void) {
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL);
+}
+
+void
+bench_wait(uint32_t ms) {
+    gui_sys_headless_settime(gui_sys_now() + ms);
+    gui_process();                              /* Single frame per wait keeps statistics complete */
+}
+
+void
+bench_print(const char* line) {
+    fputs(line, stdout);
+}
+
+int
+main(int argc, char* argv[]) {
+    GUI_UNUSED(argc);
+    GUI_UNUSED(argv);
+    
+    gui_init();                                 /* Init GUI library */
+    gui_keyboard_create();                      /* Create virtual keyboard */
+    bench_wait(0);
+    
+    bench_run();                                /* Print results to standard output */
+    return 0;
+}
@@ -31,14 +31,13 @@
 #ifndef __APP_H
 #define __APP_H
 
-#include "cmsis_os.h"
-
 /* GUI library */
 #include "gui/gui.h"
 #include "widget/gui_window.h"
 #include "widget/gui_button.h"
 #include "widget/gui_led.h"
 #include "widget/gui_progbar.h"
+#include "widget/gui_gauge.h"
 #include "widget/gui_graph.h"
 #include "widget/gui_edittext.h"
 #include "widget/gui_checkbox.h"
@@ -55,7 +54,11 @@
 #include "widget/gui_list_container.h"
 #include "gui/gui_keyboard.h"
 #include "gui/gui_lcd.h"
+
+#ifndef GUI_SIM
+#include "cmsis_os.h"
 #include "netconn_server.h"
+#include "remote_view.h"
 
 #include "tm_stm32_touch.h"
 
@@ -67,6 +70,9 @@
 #include "esp_app.h"
 
 extern TM_TOUCH_t TS;
+#else
+#include "sim.h"                                /* Host simulator replacement for board and ESP device */
+#endif /* GUI_SIM */
 
 /* Thread definitions */
 void user_thread(void const * arg);
@@ -78,8 +84,10 @@ void read_touch(void);
 /* Application functions */
 void console_write(const char* str);
 
+#ifndef GUI_SIM
 /* ESP callback function */
 espr_t  esp_cb_func(esp_cb_t* cb);
+#endif /* GUI_SIM */
 
 /* GUI APP based functions */
 void    create_desktop(void);
@@ -88,6 +96,7 @@ void    open_container(gui_id_t cont_id);
 /* Widget event functions */
 uint8_t gui_window_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
 uint8_t gui_container_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result); 
+uint8_t gui_container_build(gui_handle_p h);
 uint8_t gui_image_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
 uint8_t gui_button_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
 uint8_t gui_textview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
@@ -101,6 +110,7 @@ extern size_t access_points_count;
 
 /* ESP APP based functions */
 void    list_access_points(void);
+#ifndef GUI_SIM
 void    enable_wifi_access_point(void);
 espr_t  mqtt_send_data(const void* data, size_t len);
 espr_t  start_server(void);
@@ -108,6 +118,7 @@ void    lcd_update_ip(esp_ip_t* ip);
 
 /* MQTT client */
 extern mqtt_client_t* mqtt_client;
+#endif /* GUI_SIM */
 
 /* List of GUI widget IDs */
 #define GUI_ID_CONTAINER_STATUS             (GUI_ID_USER + 0x0001)
@@ -43,6 +43,18 @@
 #define GUI_CFG_USE_KEYBOARD                    1
 #define GUI_CFG_USE_TRANSPARENCY                1
 #define GUI_CFG_USE_UNICODE                     1
+#define GUI_CFG_LCD_FRAME_CALLBACK              1   /* Changed regions are streamed by "dev/src/remote_view.c" */
+#define GUI_CFG_TOUCH_FILTER                    1   /* Every controller poll is passed to GUI, noise is filtered there */
+#define GUI_CFG_USE_TRANSITION                  1   /* Containers are switched with push animation */
+#define GUI_CFG_SCREEN_STACK                    4   /* Last containers keep their pixels for back navigation */
+
+/* Benchmark build measures frames with microsecond timer, see "dev/bench/bench.h" */
+#if defined(GUI_BENCH)
+#include <stdint.h>
+uint32_t bench_time(void);
+#define GUI_CFG_USE_STATS                       1
+#define GUI_CFG_STATS_TIME()                    bench_time()
+#endif /* defined(GUI_BENCH) */
 
 /* After user configuration, call default config to merge config together */
 #include "gui/gui_config_default.h"
@@ -40,7 +40,10 @@
 
 #endif /* defined(STM32F769_DISCOVERY) */
 
-#if defined(LCD_COLOR_FORMAT_RGB565)
+#if defined(LCD_COLOR_FORMAT_L8)
+/* Indexed frame buffer, requires GUI_CFG_LCD_CLUT */
+#define LCD_PIXEL_SIZE              1
+#elif defined(LCD_COLOR_FORMAT_RGB565)
 #define LCD_PIXEL_SIZE              2
 #else
 #define LCD_PIXEL_SIZE              4
@@ -51,14 +54,24 @@
 /*****************************/
 /* Frame buffer settings */
 #define LCD_FRAME_BUFFER            ((uint32_t)SDRAM_START_ADR)
+#if GUI_CFG_LCD_BACKGROUND
+/* Drawing layers need alpha channel to show background layer through */
+#define LCD_FRAME_BUFFER_SIZE       ((uint32_t)(LCD_WIDTH * LCD_HEIGHT * 4))
+#else
 #define LCD_FRAME_BUFFER_SIZE       ((uint32_t)(LCD_WIDTH * LCD_HEIGHT * LCD_PIXEL_SIZE))
+#endif
 
 /* Number of layers */
 #define GUI_LAYERS                  2
 
+/* Static background buffer follows drawing layers */
+#define LCD_BG_FRAME_BUFFER         (LCD_FRAME_BUFFER + GUI_LAYERS * LCD_FRAME_BUFFER_SIZE)
+
 /* Set heap size on sdram memory */
 #define SDRAM_HEAP_SIZE             0x600000
 
 void _LCD_Init(void);
+void _LCD_Sleep(uint8_t sleep);
+void _LCD_SetCLUT(const gui_color_t* clut, uint32_t size);
 
 #endif /* __LCD_DISCOVERY */
@@ -0,0 +1,14 @@
+#ifndef __REMOTE_VIEW_H
+#define __REMOTE_VIEW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void remote_view_thread(void const* arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
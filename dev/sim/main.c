@@ -0,0 +1,59 @@
+/**
+ * \file            main.c
+ * \brief           Host simulator entry point
+ *
+ * \note            Simulator runs same GUI application as board, drawn to SDL2 window.
+ *                  Compile with host compiler and SDL2, with "dev/sim" before "dev/include" on include path:
+ *
+ *                  - All source files from "src/gui" except "gui_template.c", all from "src/widget" and "dev/images"
+ *                  - Fonts from "src/fonts" used by board project, "Roboto_Italic_14.c" is not part of it
+ *                  - "src/system/gui_ll_sdl.c" and "src/system/gui_system_posix.c"
+ *                  - "dev/src/gui_app.c", "dev/src/gui_callbacks.c" and all source files from "dev/sim"
+ *
+ *                  Link with SDL2, POSIX threads and math library
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#include "app.h"
+#include "system/gui_ll_sdl.h"
+
+int
+main(int argc, char* argv[]) {
+    GUI_UNUSED(argc);
+    GUI_UNUSED(argv);
+    
+    gui_init();                                 /* Init GUI library and SDL window */
+    
+    gui_keyboard_create();                      /* Create virtual keyboard */
+    create_desktop();                           /* Create desktop on screen */
+    list_access_points();                       /* List all access points */
+    
+    while (gui_ll_sdl_process(10)) {            /* Process window until closed */
+        
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * \file            sim.c
+ * \brief           Host simulator replacement for board and ESP device
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#include "app.h"
+
+/* Access points visible to simulated device */
+esp_ap_t access_points[10] = {
+    {ESP_ECN_WPA2_PSK, "Office", -45},
+    {ESP_ECN_WPA_WPA2_PSK, "Guests", -60},
+    {ESP_ECN_OPEN, "Public hotspot", -72},
+    {ESP_ECN_WPA_PSK, "Lab", -80},
+};
+size_t access_points_count = 4;
+
+static uint8_t joined;                          /* Set to `1` when simulated station is joined */
+
+/**
+ * \brief           Set text of connect button according to station state
+ */
+static void
+update_connect_button(void) {
+    gui_handle_p h;
+    
+    h = gui_widget_getbyid(GUI_ID_BUTTON_WIFI_CONNECT);
+    if (h != NULL) {
+        gui_widget_settext(h, joined ? _GT("Disconnect") : _GT("Connect"));
+    }
+}
+
+uint8_t
+esp_sta_is_joined(void) {
+    return joined;
+}
+
+espr_t
+esp_sta_join(const char* name, const char* pass, const uint8_t* mac, uint8_t def, uint32_t blocking) {
+    joined = 1;
+    update_connect_button();
+    console_write("WiFi connected\r\n");
+    return 0;
+}
+
+espr_t
+esp_sta_quit(uint32_t blocking) {
+    joined = 0;
+    update_connect_button();
+    console_write("WiFi disconnected\r\n");
+    return 0;
+}
+
+/**
+ * \brief           List access points to listview, simulated device responds immediately
+ */
+void
+list_access_points(void) {
+    size_t i;
+    gui_handle_p h;
+    gui_listview_row_p row;
+    
+    h = gui_widget_getbyid(GUI_ID_LISTVIEW_WIFI_APS);
+    if (h == NULL) {
+        return;
+    }
+    gui_listview_removerows(h);                 /* Remove all rows from listview */
+    for (i = 0; i < access_points_count; i++) {
+        row = gui_listview_addrow(h);
+        if (row == NULL) {
+            break;
+        }
+        gui_listview_setitemstring(h, row, 0, _GT(access_points[i].ssid));
+        switch (access_points[i].ecn) {
+            case ESP_ECN_OPEN: gui_listview_setitemstring(h, row, 1, _GT("Open")); break;
+            case ESP_ECN_WPA_PSK: gui_listview_setitemstring(h, row, 1, _GT("WPA")); break;
+            case ESP_ECN_WPA2_PSK: gui_listview_setitemstring(h, row, 1, _GT("WPA2")); break;
+            case ESP_ECN_WPA_WPA2_PSK: gui_listview_setitemstring(h, row, 1, _GT("WPA/2")); break;
+            default: break;
+        }
+    }
+    gui_widget_invalidate(h);
+    console_write("WiFi access points listed\r\n");
+}
+
+/**
+ * \brief           Write text to console window
+ */
+void
+console_write(const char* str) {
+    gui_handle_p h;
+    static char str_b[100];
+    uint32_t time;
+    
+    time = gui_sys_now() / 1000;
+    
+    h = gui_widget_getbyid(GUI_ID_DEBUGBOX_LOG);
+    if (h != NULL) {
+        sprintf(str_b, "%02d:%02d:%02d: %s", (int)(time / 3600), (int)((time / 60) % 60), (int)(time % 60), str);
+        gui_debugbox_addstring(h, _GT(str_b));
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * \file            sim.h
+ * \brief           Host simulator replacement for board and ESP device
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#ifndef __SIM_H
+#define __SIM_H
+
+#include "stdint.h"
+
+/*
+ * Minimal subset of ESP-AT API used by GUI callbacks.
+ * Simulated device reports fixed list of access points and joins any of them
+ */
+
+typedef int espr_t;
+
+/**
+ * \brief           Access point encryption
+ */
+typedef enum {
+    ESP_ECN_OPEN = 0x00,
+    ESP_ECN_WEP,
+    ESP_ECN_WPA_PSK,
+    ESP_ECN_WPA2_PSK,
+    ESP_ECN_WPA_WPA2_PSK,
+} esp_ecn_t;
+
+/**
+ * \brief           Access point data
+ */
+typedef struct {
+    esp_ecn_t ecn;                              /*!< Encryption */
+    char ssid[21];                              /*!< Access point name */
+    int16_t rssi;                               /*!< Received signal strength */
+} esp_ap_t;
+
+uint8_t esp_sta_is_joined(void);
+espr_t  esp_sta_join(const char* name, const char* pass, const uint8_t* mac, uint8_t def, uint32_t blocking);
+espr_t  esp_sta_quit(uint32_t blocking);
+
+#endif /* __SIM_H */
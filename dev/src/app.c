@@ -8,6 +8,9 @@
 #include "tm_stm32_disco.h"
 #include "cpu_utils.h"
 #include "netconn_server.h"
+#if defined(GUI_BENCH)
+#include "bench.h"
+#endif /* defined(GUI_BENCH) */
 
 /* Thread definitions */
 osThreadDef(user_thread, user_thread, osPriorityNormal, 0, 512);
@@ -51,6 +54,9 @@ user_thread(void const * arg) {
     float volt, volt_25, degrees;
     
     gui_keyboard_create();                      /* Create virtual keyboard */
+#if defined(GUI_BENCH)
+    bench_run();                                /* Print benchmark results before application starts */
+#endif /* defined(GUI_BENCH) */
     create_desktop();                           /* Create desktop on screen */
     
     list_access_points();                       /* List all access points */
@@ -47,6 +47,7 @@ espr_t
 start_server(void) {
     /* Start server */
     esp_sys_thread_create(NULL, "esp_server_netconn", (esp_sys_thread_fn)netconn_server_thread, NULL, ESP_SYS_THREAD_SS, ESP_SYS_THREAD_PRIO);
+    esp_sys_thread_create(NULL, "remote_view", (esp_sys_thread_fn)remote_view_thread, NULL, ESP_SYS_THREAD_SS, ESP_SYS_THREAD_PRIO);
     return espOK;
 }
 
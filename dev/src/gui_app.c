@@ -5,8 +5,10 @@
 
 #include "app.h"
 
+#ifndef GUI_SIM
 /* Touch data structure */
 TM_TOUCH_t TS;
+#endif /* GUI_SIM */
 
 gui_dim_t lcd_width, lcd_height;
 
@@ -28,10 +30,8 @@ create_desktop(void) {
         gui_container_create(GUI_ID_CONTAINER_STATUS, 0, 0, lcd_width, 40, NULL, gui_container_callback, 0);
     }
     
-    /* Fake opening containers to create them */
-    open_container(GUI_ID_CONTAINER_CONSOLE);
-    open_container(GUI_ID_CONTAINER_LOG);
-    open_container(GUI_ID_CONTAINER_WIFI);      /* Open WiFi container as last one */
+    /* Other containers are created when opened first time */
+    open_container(GUI_ID_CONTAINER_WIFI);
 }
 
 /**
@@ -40,26 +40,35 @@ create_desktop(void) {
  */
 void
 open_container(gui_id_t cont_id) {
+    static gui_id_t opened_id;
     gui_handle_p h;
     
-    gui_widget_hidechildren(gui_window_getdesktop());   /* Hide all widgets on desktop first */
-    gui_widget_show(gui_widget_getbyid(GUI_ID_CONTAINER_STATUS));
-    
     h = gui_widget_getbyid(cont_id);            /* Get widget by ID */
     if (h == NULL) {
         h = gui_container_create(cont_id, 0, 40, lcd_width, lcd_height - 40, NULL, gui_container_callback, 0);
+        gui_container_setbuilder(h, gui_container_build, 0);   /* Create children now, keep them when hidden */
     }
+#if GUI_CFG_USE_TRANSITION
+    if (opened_id && opened_id != cont_id) {    /* Containers are ordered as buttons on status bar */
+        gui_transition_start(h, cont_id > opened_id ? GUI_TRANSITION_PUSH_LEFT : GUI_TRANSITION_PUSH_RIGHT, 250);
+    }
+#endif /* GUI_CFG_USE_TRANSITION */
+    opened_id = cont_id;
+    
+    gui_widget_hidechildren(gui_window_getdesktop());   /* Hide all widgets on desktop first */
+    gui_widget_show(gui_widget_getbyid(GUI_ID_CONTAINER_STATUS));
     gui_widget_show(h);                         /* Show widget */
     gui_widget_putonfront(h);                   /* Put widget to most visible area */
 }
 
+#ifndef GUI_SIM
 /**
  * \brief           Read touch from screen and notify GUI
  */
 void
 read_touch(void) {
-    static gui_touch_data_t p = {0}, t = {0};
-    uint8_t i, update = 0, diffx, diffy;
+    static gui_touch_data_t t = {0};
+    uint8_t i;
     TM_TOUCH_Read(&TS);                         /* Read touch data */
     
     memset((void *)&t, 0x00, sizeof(t));
@@ -69,22 +78,6 @@ read_touch(void) {
         t.x[i] = TS.X[i];
         t.y[i] = TS.Y[i];
     }
-    if (t.count != p.count) {
-        update = 1;
-    } else {
-        for (i = 0; i < t.count; i++) {
-            diffx = GUI_ABS(p.x[i] - t.x[i]);
-            diffy = GUI_ABS(p.y[i] - t.y[i]);
-            if (diffx > 2 || diffy > 2) {
-                update = 1;
-                break;
-            }
-        }
-    }
-    
-    /* Check differences */
-    if (update || (t.status == GUI_TOUCH_STATE_RELEASED && p.status != GUI_TOUCH_STATE_RELEASED)) {
-        gui_input_touchadd(&t);
-    }
-    memcpy(&p, &t, sizeof(p));
+    gui_input_touchadd(&t);                     /* Unchanged and noisy samples are dropped by GUI */
 }
+#endif /* GUI_SIM */
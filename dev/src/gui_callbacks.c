@@ -36,19 +36,11 @@ gui_container_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                 gui_container_setcolor(h, GUI_CONTAINER_COLOR_BG, GUI_COLOR_LIGHTGRAY);
             }
             if (GUI_ID_CONTAINER_STATUS == id) {
-                gui_textview_create(gui_id_tEXTVIEW_CPU_USAGE, 10, 0, 150, 40, h, gui_textview_callback, NULL);
-                gui_textview_create(gui_id_tEXTVIEW_TIME, width - 50, 0, 46, 40, h, gui_textview_callback, NULL);
+                gui_textview_create(gui_id_tEXTVIEW_CPU_USAGE, 10, 0, 150, 40, h, gui_textview_callback, 0);
+                gui_textview_create(gui_id_tEXTVIEW_TIME, width - 50, 0, 46, 40, h, gui_textview_callback, 0);
                 gui_image_create(GUI_ID_IMAGE_WIFI_STATUS, width - 100 + 4, 4, 32, 32, h, gui_image_callback, 0);
                 gui_image_create(GUI_ID_IMAGE_CONSOLE, width - 140 + 4, 4, 32, 32, h, gui_image_callback, 0);
                 gui_image_create(GUI_ID_IMAGE_LOG, width - 180 + 4, 4, 32, 32, h, gui_image_callback, 0);
-            } else if (GUI_ID_CONTAINER_WIFI == id) {
-                gui_listview_create(GUI_ID_LISTVIEW_WIFI_APS, 2, 2, 2, 2, h, gui_listview_callback, 0);
-                gui_button_create(GUI_ID_BUTTON_WIFI_RELOAD, 2, 2, 2, 2, h, gui_button_callback, 0);
-                gui_button_create(GUI_ID_BUTTON_WIFI_CONNECT, 2, 2, 2, 2, h, gui_button_callback, 0);
-                gui_edittext_create(GUI_ID_EDITTEXT_WIFI_PASSWORD, 2, 2, 2, 2, h, gui_edittext_callback, 0);
-                gui_textview_create(gui_id_tEXTVIEW_IP_ADDR, 2, 2, 2, 2, h, gui_textview_callback, NULL);
-            } else if (GUI_ID_CONTAINER_LOG == id) {
-                gui_debugbox_create(GUI_ID_DEBUGBOX_LOG, 2, 2, 2, 2, h, gui_debugbox_callback, 0);
             }
             break;
         }
@@ -60,6 +52,26 @@ gui_container_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
     return res;
 }
 
+/**
+ * \brief           Create children widgets of container when it is opened first time
+ */
+uint8_t
+gui_container_build(gui_handle_p h) {
+    gui_id_t id;
+    
+    id = gui_widget_getid(h);                   /* Get widget ID */
+    if (GUI_ID_CONTAINER_WIFI == id) {
+        gui_listview_create(GUI_ID_LISTVIEW_WIFI_APS, 2, 2, 2, 2, h, gui_listview_callback, 0);
+        gui_button_create(GUI_ID_BUTTON_WIFI_RELOAD, 2, 2, 2, 2, h, gui_button_callback, 0);
+        gui_button_create(GUI_ID_BUTTON_WIFI_CONNECT, 2, 2, 2, 2, h, gui_button_callback, 0);
+        gui_edittext_create(GUI_ID_EDITTEXT_WIFI_PASSWORD, 2, 2, 2, 2, h, gui_edittext_callback, 0);
+        gui_textview_create(gui_id_tEXTVIEW_IP_ADDR, 2, 2, 2, 2, h, gui_textview_callback, 0);
+    } else if (GUI_ID_CONTAINER_LOG == id) {
+        gui_debugbox_create(GUI_ID_DEBUGBOX_LOG, 2, 2, 2, 2, h, gui_debugbox_callback, 0);
+    }
+    return 1;
+}
+
 /**
  * \brief           Image event function
  */
@@ -352,6 +352,26 @@ _LCD_Init(void) {
     HAL_DSI_Refresh(&hdsi);
 }
 
+/* Stop refresh loop and put panel to sleep or wake it up again */
+void
+_LCD_Sleep(uint8_t sleep) {
+    if (sleep) {
+        pending_buffer = -1;                    /* Refresh callback stops starting new transfers */
+        HAL_Delay(40);                          /* Let running frame finish, both halves */
+        HAL_DSI_ShortWrite(&hdsi, 0, DSI_DCS_SHORT_PKT_WRITE_P1, OTM8009A_CMD_DISPOFF, 0x00);
+        HAL_DSI_ShortWrite(&hdsi, 0, DSI_DCS_SHORT_PKT_WRITE_P1, OTM8009A_CMD_SLPIN, 0x00);
+    } else {
+        HAL_DSI_ShortWrite(&hdsi, 0, DSI_DCS_SHORT_PKT_WRITE_P1, OTM8009A_CMD_SLPOUT, 0x00);
+        HAL_Delay(120);                         /* Panel needs 120ms after sleep out */
+        HAL_DSI_ShortWrite(&hdsi, 0, DSI_DCS_SHORT_PKT_WRITE_P1, OTM8009A_CMD_DISPON, 0x00);
+
+        active_area = LEFT_AREA;
+        HAL_DSI_LongWrite(&hdsi, 0, DSI_DCS_LONG_PKT_WRITE, 4, OTM8009A_CMD_CASET, pColLeft);
+        pending_buffer = 0;
+        HAL_DSI_Refresh(&hdsi);                 /* Start refresh loop again */
+    }
+}
+
 /**
   * @brief  End of Refresh DSI callback.
   * @param  hdsi: pointer to a DSI_HandleTypeDef structure that contains
@@ -373,7 +393,11 @@ void HAL_DSI_EndOfRefreshCallback(DSI_HandleTypeDef *hdsi) {
             HAL_DSI_Refresh(hdsi);    
 
         } else if (active_area == RIGHT_AREA) {
-            /* Find next pending layer */
+            /*
+             * Complete frame was sent to display, this is the only moment
+             * where frame buffer can be swapped without tearing.
+             * Confirmation wakes up GUI thread to draw next frame
+             */
             uint8_t i = 0;
             for (i = 0; i < GUI_LAYERS; i++) {
                 if (Layers[i].pending) {
@@ -94,7 +94,9 @@ void _LCD_Init(void) {
     layer_cfg.WindowX1 = LCD_WIDTH;
     layer_cfg.WindowY0 = 0;
     layer_cfg.WindowY1 = LCD_HEIGHT; 
-#if defined(LCD_COLOR_FORMAT_RGB565)
+#if defined(LCD_COLOR_FORMAT_L8)
+    layer_cfg.PixelFormat = LTDC_PIXEL_FORMAT_L8;
+#elif defined(LCD_COLOR_FORMAT_RGB565)
     layer_cfg.PixelFormat = LTDC_PIXEL_FORMAT_RGB565;
 #else
     layer_cfg.PixelFormat = LTDC_PIXEL_FORMAT_ARGB8888;
@@ -108,6 +110,21 @@ void _LCD_Init(void) {
     layer_cfg.ImageWidth = LCD_WIDTH;
     layer_cfg.ImageHeight = LCD_HEIGHT;
 
+#if GUI_CFG_LCD_BACKGROUND
+    /* Config layer 1, static background */
+    layer_cfg.Alpha = 255;
+    layer_cfg.BlendingFactor1 = LTDC_BLENDING_FACTOR1_CA;
+    layer_cfg.BlendingFactor2 = LTDC_BLENDING_FACTOR2_CA;
+    layer_cfg.FBStartAdress = LCD_BG_FRAME_BUFFER;
+    HAL_LTDC_ConfigLayer(&LTDCHandle, &layer_cfg, 0);
+    
+    /* Config layer 2, drawing layers are swapped by address and blended with pixel alpha */
+    layer_cfg.PixelFormat = LTDC_PIXEL_FORMAT_ARGB8888;
+    layer_cfg.BlendingFactor1 = LTDC_BLENDING_FACTOR1_PAxCA;
+    layer_cfg.BlendingFactor2 = LTDC_BLENDING_FACTOR2_PAxCA;
+    layer_cfg.FBStartAdress = LCD_FRAME_BUFFER;
+    HAL_LTDC_ConfigLayer(&LTDCHandle, &layer_cfg, 1);
+#else
     /* Config layer 1 */
     layer_cfg.Alpha = 255;
     layer_cfg.FBStartAdress = LCD_FRAME_BUFFER;
@@ -117,26 +134,56 @@ void _LCD_Init(void) {
     layer_cfg.Alpha = 0;
     layer_cfg.FBStartAdress = LCD_FRAME_BUFFER + LCD_FRAME_BUFFER_SIZE;
     HAL_LTDC_ConfigLayer(&LTDCHandle, &layer_cfg, 1);
+#endif
 
     /* Init line event interrupt */
     HAL_NVIC_SetPriority(LTDC_IRQn, 0xE, 0);
     HAL_NVIC_EnableIRQ(LTDC_IRQn);
 
+#if !GUI_CFG_LCD_BACKGROUND
     HAL_LTDC_SetAlpha(&LTDCHandle, 255, 0);
     HAL_LTDC_SetAlpha(&LTDCHandle, 0, 1);
+#endif
     
     HAL_LTDC_ProgramLineEvent(&LTDCHandle, 0);
 }
 
+/* Stop LTDC refresh and switch display off or start it again */
+void _LCD_Sleep(uint8_t sleep) {
+    if (sleep) {
+        TM_GPIO_SetPinLow(GPIOK, GPIO_PIN_3);   /* Backlight off */
+        TM_GPIO_SetPinLow(GPIOI, GPIO_PIN_12);  /* Display off */
+        __HAL_LTDC_DISABLE(&LTDCHandle);
+    } else {
+        __HAL_LTDC_ENABLE(&LTDCHandle);
+        HAL_LTDC_ProgramLineEvent(&LTDCHandle, 0);
+        TM_GPIO_SetPinHigh(GPIOI, GPIO_PIN_12);
+        TM_GPIO_SetPinHigh(GPIOK, GPIO_PIN_3);
+    }
+}
+
+/* Load color lookup table of L8 drawing layers */
+void _LCD_SetCLUT(const gui_color_t* clut, uint32_t size) {
+    uint8_t i;
+    for (i = 0; i < GUI_LAYERS; i++) {
+        HAL_LTDC_ConfigCLUT(&LTDCHandle, (uint32_t *)clut, size, i);
+        HAL_LTDC_EnableCLUT(&LTDCHandle, i);
+    }
+}
+
 /* IRQ callback for line event */
 void HAL_LTDC_LineEvenCallback(LTDC_HandleTypeDef *hltdc) {
     uint8_t i = 0;
     for (i = 0; i < GUI_LAYERS; i++) {
-        if (Layers[i].Pending) {                /* Is layer waiting for redraw operation */
+        if (Layers[i].pending) {                /* Is layer waiting for redraw operation */
+#if GUI_CFG_LCD_BACKGROUND
+            LTDC_LAYER(hltdc, 1)->CFBAR = Layers[i].start_address;  /* Background stays on layer 1, show new drawing layer on layer 2 */
+#else
             LTDC_LAYER(hltdc, !!i)->CACR &= ~(LTDC_LxCACR_CONSTA);
             LTDC_LAYER(hltdc, !!i)->CACR = (255);
             LTDC_LAYER(hltdc, !i)->CACR &= ~(LTDC_LxCACR_CONSTA);
             LTDC_LAYER(hltdc, !i)->CACR = (0);
+#endif
             
             __HAL_LTDC_RELOAD_CONFIG(hltdc);
             gui_lcd_confirmactivelayer(i);
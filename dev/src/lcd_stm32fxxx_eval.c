@@ -81,7 +81,9 @@ void _LCD_Init(void) {
     layer_cfg.WindowX1 = LCD_WIDTH;
     layer_cfg.WindowY0 = 0;
     layer_cfg.WindowY1 = LCD_HEIGHT; 
-#if defined(LCD_COLOR_FORMAT_RGB565)
+#if defined(LCD_COLOR_FORMAT_L8)
+    layer_cfg.PixelFormat = LTDC_PIXEL_FORMAT_L8;
+#elif defined(LCD_COLOR_FORMAT_RGB565)
     layer_cfg.PixelFormat = LTDC_PIXEL_FORMAT_RGB565;
 #else
     layer_cfg.PixelFormat = LTDC_PIXEL_FORMAT_ARGB8888;
@@ -115,6 +117,25 @@ void _LCD_Init(void) {
     HAL_LTDC_ProgramLineEvent(&LTDCHandle, 0);
 }
 
+/* Stop LTDC refresh or start it again */
+void _LCD_Sleep(uint8_t sleep) {
+    if (sleep) {
+        __HAL_LTDC_DISABLE(&LTDCHandle);
+    } else {
+        __HAL_LTDC_ENABLE(&LTDCHandle);
+        HAL_LTDC_ProgramLineEvent(&LTDCHandle, 0);
+    }
+}
+
+/* Load color lookup table of L8 drawing layers */
+void _LCD_SetCLUT(const gui_color_t* clut, uint32_t size) {
+    uint8_t i;
+    for (i = 0; i < GUI_LAYERS; i++) {
+        HAL_LTDC_ConfigCLUT(&LTDCHandle, (uint32_t *)clut, size, i);
+        HAL_LTDC_EnableCLUT(&LTDCHandle, i);
+    }
+}
+
 /* IRQ callback for line event */
 void HAL_LTDC_LineEvenCallback(LTDC_HandleTypeDef *hltdc) {
     uint8_t i = 0;
@@ -54,6 +54,27 @@ resp_data_style[] = ""
 "   #maindiv { width: 100%; }"
 "}";
 
+#if GUI_CFG_USE_METRICS
+/**
+ * \brief           Header of GUI metrics response, report lines follow
+ */
+static const uint8_t
+resp_data_metrics[] = ""
+"HTTP/1.1 200 OK\r\n"
+"Content-Type: text/plain\r\n"
+"\r\n";
+
+/**
+ * \brief           Write single GUI metrics report line to client
+ * \param[in]       str: Line to write
+ * \param[in]       arg: Client netconn handle
+ */
+static void
+metrics_write(const char* str, void* arg) {
+    esp_netconn_write(arg, str, strlen(str));
+}
+#endif /* GUI_CFG_USE_METRICS */
+
 /**
  * \brief           Netconn server thread implementation
  * \param[in]       arg: User argument
@@ -177,6 +198,12 @@ netconn_server_processing_thread(void* const arg) {
                 } else if (esp_pbuf_strfind(pbuf, "GET /style.css ", 0) != ESP_SIZET_MAX) {
                     printf("Style page request\r\n");
                     esp_netconn_write(client, resp_data_style, sizeof(resp_data_style) - 1);
+#if GUI_CFG_USE_METRICS
+                } else if (esp_pbuf_strfind(pbuf, "GET /metrics ", 0) != ESP_SIZET_MAX) {
+                    printf("Metrics request\r\n");
+                    esp_netconn_write(client, resp_data_metrics, sizeof(resp_data_metrics) - 1);
+                    gui_metrics_report(metrics_write, client);  /* Snapshot is safe to read from this thread */
+#endif /* GUI_CFG_USE_METRICS */
                 } 
                 esp_netconn_close(client);      /* Close netconn connection */
                 esp_pbuf_free(p);               /* Do not forget to free memory after usage! */
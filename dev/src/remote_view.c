@@ -0,0 +1,323 @@
+/*
+ * Remote view server streams display content to single TCP client
+ * and injects touches received from client to GUI input queue.
+ *
+ * Frame callback of GUI only collects regions changed in each frame.
+ * Sender loop reads collected regions from last drawn layer,
+ * compresses them and sends them to client. When client is slower
+ * than display, regions of many frames are merged together,
+ * so bandwidth follows rate of UI changes and never size of frames.
+ *
+ * Protocol on port 5900, all values are little endian:
+ *
+ *  Server to client:
+ *      'I', u16 width, u16 height              Size of display memory, sent once before first rectangle
+ *      'R', u16 x, u16 y, u16 w, u16 h, data   Rectangle of RGB565 pixels, row by row
+ *
+ *      Pixel data is run length encoded, control byte C is followed by:
+ *          C >= 0x80: single pixel repeated (C - 0x80 + 1) times
+ *          C <  0x80: (C + 1) different pixels
+ *
+ *  Client to server:
+ *      'T', u8 pressed, u16 x, u16 y           Touch state in display coordinates
+ */
+#include "app.h"
+#include "remote_view.h"
+
+#define REMOTE_VIEW_PORT            5900
+#define REMOTE_VIEW_PERIOD          40          /* Minimal time between 2 sends in milliseconds */
+#define REMOTE_VIEW_RECTS           8           /* Number of separate regions waiting for send */
+#define REMOTE_VIEW_BUFF_SIZE       4096        /* Size of encoded chunk in units of bytes */
+
+/**
+ * \brief           Remote view state shared between GUI and server threads
+ */
+typedef struct {
+    const gui_layer_t* layer;                   /*!< Layer with last drawn frame */
+    gui_display_t rects[REMOTE_VIEW_RECTS];     /*!< Regions changed since last send */
+    size_t rects_count;                         /*!< Number of valid regions */
+    uint8_t full;                               /*!< Set to `1` when complete screen must be sent */
+    uint8_t info_sent;                          /*!< Set to `1` when screen info was sent to client */
+    volatile uint8_t connected;                 /*!< Set to `1` while client is connected */
+    volatile uint8_t rx_running;                /*!< Set to `1` while receive thread uses connection */
+} remote_view_t;
+
+static remote_view_t rv;
+static uint8_t buff[REMOTE_VIEW_BUFF_SIZE];
+
+static void remote_view_receive_thread(void* const arg);
+
+/**
+ * \brief           Add region to list of regions waiting for send
+ * \note            Overlapping regions are merged, last region is grown when list is full
+ * \param[in]       r: Region to add
+ */
+static void
+add_rect(const gui_display_t* r) {
+    gui_display_t* e;
+    size_t i;
+    
+    for (i = 0; i < rv.rects_count; i++) {
+        e = &rv.rects[i];
+        if (r->x1 < e->x2 && e->x1 < r->x2 && r->y1 < e->y2 && e->y1 < r->y2) {
+            break;
+        }
+    }
+    if (i == rv.rects_count && rv.rects_count < REMOTE_VIEW_RECTS) {
+        rv.rects[rv.rects_count++] = *r;
+        return;
+    }
+    if (i == rv.rects_count) {
+        i = rv.rects_count - 1;
+    }
+    e = &rv.rects[i];
+    e->x1 = GUI_MIN(e->x1, r->x1);
+    e->y1 = GUI_MIN(e->y1, r->y1);
+    e->x2 = GUI_MAX(e->x2, r->x2);
+    e->y2 = GUI_MAX(e->y2, r->y2);
+}
+
+/**
+ * \brief           GUI frame callback, collects changed regions
+ * \param[in]       layer: Layer with finished frame
+ * \param[in]       rects: Changed regions in display memory coordinates
+ * \param[in]       count: Number of regions
+ * \param[in]       arg: User argument
+ */
+static void
+remote_view_frame_cb(const gui_layer_t* layer, const gui_display_t* rects, size_t count, void* arg) {
+    gui_display_t full;
+    size_t i;
+    
+    GUI_UNUSED(arg);
+    if (!rv.connected) {
+        return;
+    }
+    gui_sys_protect();                          /* Sender thread reads regions and layer */
+    rv.layer = layer;
+    if (rv.full) {
+        full.x1 = 0;
+        full.y1 = 0;
+        full.x2 = layer->width;
+        full.y2 = layer->height;
+        rv.rects_count = 0;
+        add_rect(&full);
+        rv.full = 0;
+    } else {
+        for (i = 0; i < count; i++) {
+            add_rect(&rects[i]);
+        }
+    }
+    gui_sys_unprotect();
+}
+
+/**
+ * \brief           Read pixel from layer memory and convert it to RGB565
+ * \param[in]       layer: Layer to read from
+ * \param[in]       x, y: Pixel position in layer memory
+ * \return          RGB565 pixel value
+ */
+static uint16_t
+read_pixel(const gui_layer_t* layer, gui_dim_t x, gui_dim_t y) {
+    const uint8_t* p = (const uint8_t *)layer->start_address + layer->pixel_size * ((size_t)y * layer->width + x);
+    
+    if (layer->pixel_size == 2) {
+        return (uint16_t)(p[0] | (p[1] << 8));
+    }
+    return (uint16_t)(((p[2] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[0] >> 3));
+}
+
+/**
+ * \brief           Encode one row of pixels with run length encoding
+ * \param[in]       layer: Layer to read from
+ * \param[in]       x, y: Position of first pixel in row
+ * \param[in]       w: Number of pixels in row
+ * \param[out]      out: Output buffer, at least `w * 2 + w / 128 + 1` bytes long
+ * \return          Number of bytes written
+ */
+static size_t
+encode_row(const gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t w, uint8_t* out) {
+    size_t len = 0, ctrl;
+    gui_dim_t i = 0, n;
+    uint16_t px;
+    
+    while (i < w) {
+        px = read_pixel(layer, x + i, y);
+        for (n = 1; i + n < w && n < 128 && read_pixel(layer, x + i + n, y) == px; n++) {}
+        if (n > 2) {                            /* Run of same pixel */
+            out[len++] = (uint8_t)(0x80 + n - 1);
+            out[len++] = (uint8_t)px;
+            out[len++] = (uint8_t)(px >> 8);
+            i += n;
+            continue;
+        }
+        
+        /* Block of different pixels until next run starts */
+        ctrl = len++;
+        for (n = 0; i < w && n < 128; n++, i++) {
+            px = read_pixel(layer, x + i, y);
+            if (n && i + 2 < w && read_pixel(layer, x + i + 1, y) == px && read_pixel(layer, x + i + 2, y) == px) {
+                break;
+            }
+            out[len++] = (uint8_t)px;
+            out[len++] = (uint8_t)(px >> 8);
+        }
+        out[ctrl] = (uint8_t)(n - 1);
+    }
+    return len;
+}
+
+/**
+ * \brief           Write little endian 16-bit value to buffer
+ * \param[out]      p: Buffer pointer
+ * \param[in]       v: Value to write
+ */
+static void
+put_u16(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+/**
+ * \brief           Send rows of changed regions in chunks of encoded data
+ * \param[in]       client: Client connection
+ * \return          \ref espOK on success, member of \ref espr_t otherwise
+ */
+static espr_t
+send_changes(esp_netconn_p client) {
+    gui_display_t r;
+    gui_dim_t y, rows, w;
+    size_t len, max_row;
+    espr_t res = espOK;
+    
+    while (res == espOK) {
+        gui_sys_protect();                      /* Layer is not drawn while locked */
+        if (!rv.rects_count || rv.layer == NULL) {
+            gui_sys_unprotect();
+            break;
+        }
+        if (!rv.info_sent) {                    /* Size of display memory is known with first frame */
+            buff[0] = 'I';
+            put_u16(&buff[1], rv.layer->width);
+            put_u16(&buff[3], rv.layer->height);
+            gui_sys_unprotect();
+            rv.info_sent = 1;
+            res = esp_netconn_write(client, buff, 5);
+            continue;
+        }
+        r = rv.rects[0];
+        w = r.x2 - r.x1;
+        max_row = (size_t)w * 2 + w / 128 + 1;
+        
+        /* Encode as many rows of first region as fit to buffer */
+        len = 9;
+        for (y = r.y1; y < r.y2 && len + max_row <= sizeof(buff); y++) {
+            len += encode_row(rv.layer, r.x1, y, w, &buff[len]);
+        }
+        rows = y - r.y1;
+        if (y < r.y2) {                         /* Remaining rows are sent with next chunk */
+            rv.rects[0].y1 = y;
+        } else {
+            memmove(&rv.rects[0], &rv.rects[1], sizeof(rv.rects[0]) * --rv.rects_count);
+        }
+        gui_sys_unprotect();
+        
+        buff[0] = 'R';
+        put_u16(&buff[1], r.x1);
+        put_u16(&buff[3], r.y1);
+        put_u16(&buff[5], w);
+        put_u16(&buff[7], rows);
+        res = esp_netconn_write(client, buff, len);
+    }
+    return res;
+}
+
+/**
+ * \brief           Remote view server thread implementation
+ * \param[in]       arg: User argument
+ */
+void
+remote_view_thread(void const* arg) {
+    esp_netconn_p server, client;
+    espr_t res = espOK;
+    
+    gui_lcd_setframecallback(remote_view_frame_cb, NULL);
+    server = esp_netconn_new(ESP_NETCONN_TYPE_TCP);
+    if (server == NULL || esp_netconn_bind(server, REMOTE_VIEW_PORT) != espOK || esp_netconn_listen(server) != espOK) {
+        console_write("Remote view server cannot listen\r\n");
+        esp_sys_thread_terminate(NULL);
+        return;
+    }
+    console_write("Remote view server listens on port 5900\r\n");
+    
+    while (1) {
+        if (esp_netconn_accept(server, &client) != espOK) {
+            continue;
+        }
+        console_write("Remote view client connected\r\n");
+        
+        gui_sys_protect();
+        rv.rects_count = 0;
+        rv.full = 1;                            /* Complete screen with next frame */
+        rv.info_sent = 0;
+        rv.connected = 1;
+        rv.rx_running = 1;
+        gui_sys_unprotect();
+        gui_widget_invalidate(gui_window_getdesktop()); /* Force frame even if nothing changes */
+        
+        res = espOK;
+        if (!esp_sys_thread_create(NULL, "remote_view_rx", (esp_sys_thread_fn)remote_view_receive_thread, client, 512, ESP_SYS_THREAD_PRIO)) {
+            rv.rx_running = 0;
+            res = espERR;
+        }
+        while (res == espOK && rv.connected) {
+            res = send_changes(client);
+            osDelay(REMOTE_VIEW_PERIOD);
+        }
+        
+        rv.connected = 0;
+        esp_netconn_close(client);              /* Receive thread returns on closed connection */
+        while (rv.rx_running) {
+            osDelay(10);
+        }
+        esp_netconn_delete(client);
+        console_write("Remote view client disconnected\r\n");
+    }
+}
+
+/**
+ * \brief           Receive touch messages of client and add them to GUI input
+ * \param[in]       arg: Client connection
+ */
+static void
+remote_view_receive_thread(void* const arg) {
+    esp_netconn_p client = arg;
+    gui_touch_data_t t;
+    esp_pbuf_p pbuf;
+    uint8_t msg[6];
+    size_t len = 0, off, n, i;
+    const uint8_t* d;
+    
+    while (rv.connected && esp_netconn_receive(client, &pbuf) == espOK) {
+        for (off = 0; (d = esp_pbuf_get_linear_addr(pbuf, off, &n)) != NULL && n; off += n) {
+            for (i = 0; i < n; i++) {
+                msg[len++] = d[i];
+                if (msg[0] != 'T') {            /* Unknown messages are skipped byte by byte */
+                    len = 0;
+                } else if (len == sizeof(msg)) {
+                    memset(&t, 0x00, sizeof(t));
+                    t.status = msg[1] ? GUI_TOUCH_STATE_PRESSED : GUI_TOUCH_STATE_RELEASED;
+                    t.count = msg[1] ? 1 : 0;
+                    t.x[0] = (gui_dim_t)(msg[2] | (msg[3] << 8));
+                    t.y[0] = (gui_dim_t)(msg[4] | (msg[5] << 8));
+                    gui_input_touchadd(&t);     /* Same path as local touch driver */
+                    len = 0;
+                }
+            }
+        }
+        esp_pbuf_free(pbuf);
+    }
+    rv.connected = 0;                           /* Stop sender loop */
+    rv.rx_running = 0;                          /* Sender may delete connection now */
+    esp_sys_thread_terminate(NULL);
+}
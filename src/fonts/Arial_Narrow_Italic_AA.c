@@ -1,7 +1,7 @@
 #include "gui/gui.h"
 
-gui_const uint8_t Font_Arial_Narrow_Italic_21_0020[1] = {
-    ________, 
+gui_const uint8_t Font_Arial_Narrow_Italic_21_0020[2] = {
+    ________, ________, 
 };
 
 gui_const uint8_t Font_Arial_Narrow_Italic_21_0021[32] = {
@@ -33,17 +33,139 @@
 #include "gui/gui.h"
 #include "system/gui_sys.h"
 
+#if GUI_CFG_INSTANCES > 1
+#if GUI_CFG_OS_RENDER_THREAD || GUI_CFG_LL_STATIC || GUI_CFG_USE_TRACE
+#error "GUI_CFG_INSTANCES is not supported together with GUI_CFG_OS_RENDER_THREAD, GUI_CFG_LL_STATIC or GUI_CFG_USE_TRACE"
+#endif /* GUI_CFG_OS_RENDER_THREAD || GUI_CFG_LL_STATIC || GUI_CFG_USE_TRACE */
+/**
+ * \brief           GUI structures of all instances
+ */
+gui_t guii_instances[GUI_CFG_INSTANCES];
+gui_t* guii_instance = &guii_instances[0];         /* Instance currently processed */
+static gui_t* instance_selected = &guii_instances[0];  /* Instance selected by application */
+#if GUI_CFG_OS
+static uint8_t sys_ready;                           /* System is initialized by first instance */
+#endif /* GUI_CFG_OS */
+#else /* GUI_CFG_INSTANCES > 1 */
 /**
  * \brief           GUI global structure
  */
 gui_t GUI;
+#endif /* !(GUI_CFG_INSTANCES > 1) */
+
+#if GUI_CFG_LCD_BAND
+static uint32_t band_mem[2][(GUI_CFG_LCD_BAND_SIZE + 3) / 4];  /* Word aligned band buffers */
+#endif /* GUI_CFG_LCD_BAND */
+
+#if GUI_CFG_LCD_TILE
+#if GUI_CFG_LCD_BAND
+#error "GUI_CFG_LCD_TILE is not supported together with GUI_CFG_LCD_BAND"
+#endif /* GUI_CFG_LCD_BAND */
+static uint32_t tile_mem[GUI_CFG_LCD_TILE_WIDTH * GUI_CFG_LCD_TILE_HEIGHT] GUI_CFG_LCD_TILE_ATTR; /* Tile buffer, up to 4 bytes per pixel */
+#if GUI_CFG_LCD_TILE_CORES > 1
+#if !GUI_CFG_USE_DISPLAY_LIST
+#error "GUI_CFG_LCD_TILE_CORES requires GUI_CFG_USE_DISPLAY_LIST"
+#endif /* !GUI_CFG_USE_DISPLAY_LIST */
+#if GUI_CFG_LCD_ROTATION || GUI_CFG_USE_TRANSPARENCY
+#error "GUI_CFG_LCD_TILE_CORES is not supported together with GUI_CFG_LCD_ROTATION or GUI_CFG_USE_TRANSPARENCY"
+#endif /* GUI_CFG_LCD_ROTATION || GUI_CFG_USE_TRANSPARENCY */
+static gui_tile_job_t tile_job GUI_CFG_LCD_TILE_SHARED_ATTR;   /* Tiles shared with second core */
+#endif /* GUI_CFG_LCD_TILE_CORES > 1 */
+#endif /* GUI_CFG_LCD_TILE */
+
+#if GUI_CFG_OS_RENDER_THREAD
+#if !GUI_CFG_OS || !GUI_CFG_USE_DISPLAY_LIST
+#error "GUI_CFG_OS_RENDER_THREAD requires GUI_CFG_OS and GUI_CFG_USE_DISPLAY_LIST"
+#endif /* !GUI_CFG_OS || !GUI_CFG_USE_DISPLAY_LIST */
+#if GUI_CFG_LCD_BAND || GUI_CFG_LCD_TILE || GUI_CFG_USE_TRANSPARENCY
+#error "GUI_CFG_OS_RENDER_THREAD is not supported together with GUI_CFG_LCD_BAND, GUI_CFG_LCD_TILE or GUI_CFG_USE_TRANSPARENCY"
+#endif /* GUI_CFG_LCD_BAND || GUI_CFG_LCD_TILE || GUI_CFG_USE_TRANSPARENCY */
+#endif /* GUI_CFG_OS_RENDER_THREAD */
+
+#if GUI_CFG_WIDGET_MASK && !GUI_CFG_USE_TRANSPARENCY
+#error "GUI_CFG_WIDGET_MASK requires GUI_CFG_USE_TRANSPARENCY"
+#endif /* GUI_CFG_WIDGET_MASK && !GUI_CFG_USE_TRANSPARENCY */
+#if GUI_CFG_USE_STREAM && !GUI_CFG_OS && !GUI_CFG_USE_IDLE_TASKS
+#error "GUI_CFG_USE_STREAM without GUI_CFG_OS requires GUI_CFG_USE_IDLE_TASKS"
+#endif /* GUI_CFG_USE_STREAM && !GUI_CFG_OS && !GUI_CFG_USE_IDLE_TASKS */
+#if GUI_CFG_FONT_PREWARM_QUEUE && !GUI_CFG_USE_IDLE_TASKS
+#error "GUI_CFG_FONT_PREWARM_QUEUE requires GUI_CFG_USE_IDLE_TASKS"
+#endif /* GUI_CFG_FONT_PREWARM_QUEUE && !GUI_CFG_USE_IDLE_TASKS */
+#if GUI_CFG_MEM_RELOC
+#if !GUI_CFG_USE_MEM || GUI_CFG_MEM_TLSF
+#error "GUI_CFG_MEM_RELOC requires GUI_CFG_USE_MEM with first-fit allocator, GUI_CFG_MEM_TLSF must be disabled"
+#endif /* !GUI_CFG_USE_MEM || GUI_CFG_MEM_TLSF */
+#if GUI_CFG_OS_RENDER_THREAD
+#error "GUI_CFG_MEM_RELOC is not supported together with GUI_CFG_OS_RENDER_THREAD"
+#endif /* GUI_CFG_OS_RENDER_THREAD */
+#endif /* GUI_CFG_MEM_RELOC */
+#if GUI_CFG_REDRAW_BUDGET && (GUI_CFG_LCD_BAND || GUI_CFG_LCD_TILE || GUI_CFG_OS_RENDER_THREAD)
+#error "GUI_CFG_REDRAW_BUDGET is not supported together with GUI_CFG_LCD_BAND, GUI_CFG_LCD_TILE or GUI_CFG_OS_RENDER_THREAD"
+#endif /* GUI_CFG_REDRAW_BUDGET && (GUI_CFG_LCD_BAND || GUI_CFG_LCD_TILE || GUI_CFG_OS_RENDER_THREAD) */
+#if GUI_CFG_STATS_LATENCY && (!GUI_CFG_USE_STATS || !GUI_CFG_USE_TOUCH || GUI_CFG_LCD_BAND || GUI_CFG_OS_RENDER_THREAD)
+#error "GUI_CFG_STATS_LATENCY requires GUI_CFG_USE_STATS and GUI_CFG_USE_TOUCH and is not supported together with GUI_CFG_LCD_BAND or GUI_CFG_OS_RENDER_THREAD"
+#endif /* GUI_CFG_STATS_LATENCY && (!GUI_CFG_USE_STATS || !GUI_CFG_USE_TOUCH || GUI_CFG_LCD_BAND || GUI_CFG_OS_RENDER_THREAD) */
+#if GUI_CFG_MEM_STATIC && (!GUI_CFG_MEM_POOL || !GUI_CFG_FONT_CACHE_SIZE || GUI_CFG_LINKEDLIST_COMPACT)
+#error "GUI_CFG_MEM_STATIC requires GUI_CFG_MEM_POOL and GUI_CFG_FONT_CACHE_SIZE and is not supported together with GUI_CFG_LINKEDLIST_COMPACT"
+#endif /* GUI_CFG_MEM_STATIC && (!GUI_CFG_MEM_POOL || !GUI_CFG_FONT_CACHE_SIZE || GUI_CFG_LINKEDLIST_COMPACT) */
+#if GUI_CFG_MEM_ZERO_LL && (!GUI_CFG_USE_MEM || GUI_CFG_OS_RENDER_THREAD)
+#error "GUI_CFG_MEM_ZERO_LL requires GUI_CFG_USE_MEM and is not supported together with GUI_CFG_OS_RENDER_THREAD"
+#endif /* GUI_CFG_MEM_ZERO_LL && (!GUI_CFG_USE_MEM || GUI_CFG_OS_RENDER_THREAD) */
+#if GUI_CFG_USE_TRANSITION && (GUI_CFG_LCD_BAND || GUI_CFG_OS_RENDER_THREAD)
+#error "GUI_CFG_USE_TRANSITION is not supported together with GUI_CFG_LCD_BAND or GUI_CFG_OS_RENDER_THREAD"
+#endif /* GUI_CFG_USE_TRANSITION && (GUI_CFG_LCD_BAND || GUI_CFG_OS_RENDER_THREAD) */
+#if GUI_CFG_SCREEN_STACK && (GUI_CFG_LCD_BAND || GUI_CFG_OS_RENDER_THREAD)
+#error "GUI_CFG_SCREEN_STACK is not supported together with GUI_CFG_LCD_BAND or GUI_CFG_OS_RENDER_THREAD"
+#endif /* GUI_CFG_SCREEN_STACK && (GUI_CFG_LCD_BAND || GUI_CFG_OS_RENDER_THREAD) */
+#if GUI_CFG_USE_METRICS && !GUI_CFG_USE_STATS
+#error "GUI_CFG_USE_METRICS requires GUI_CFG_USE_STATS"
+#endif /* GUI_CFG_USE_METRICS && !GUI_CFG_USE_STATS */
+#if GUI_CFG_WIDGET_ARENA_SIZE && !GUI_CFG_WIDGET_TREE
+#error "GUI_CFG_WIDGET_ARENA_SIZE requires GUI_CFG_WIDGET_TREE"
+#endif /* GUI_CFG_WIDGET_ARENA_SIZE && !GUI_CFG_WIDGET_TREE */
+
+#if GUI_CFG_USE_STATS
+/* Add time since last measurement to statistics field of current frame */
+#define STATS_MEASURE(field)        do { now = GUI_CFG_STATS_TIME(); GUI.StatsFrame.field += now - t; t = now; } while (0)
+#else
+#define STATS_MEASURE(field)
+#endif /* GUI_CFG_USE_STATS */
+
+/* Number of pixels in clipping region of widget being redrawn */
+#define REDRAW_PIXELS()             ((uint32_t)(GUI.DisplayTemp.x2 - GUI.DisplayTemp.x1) * (uint32_t)(GUI.DisplayTemp.y2 - GUI.DisplayTemp.y1))
+
+/**
+ * \brief           Get clipping area of widget given by inner area of all its parents
+ * \note            Clipping area is passed down the widget tree traversal,
+ *                  so children area is single intersection with area of their parent
+ * \param[in]       parent: Parent widget handle or `NULL` for widgets on root level
+ * \param[in]       area: Clipping area of parent widget. Ignored when parent is `NULL`
+ * \param[out]      r: Clipping area for children of parent widget
+ */
+static void
+get_children_clip(gui_handle_p parent, const gui_display_t* area, gui_display_t* r) {
+    if (parent == NULL) {                           /* Root widgets are clipped by screen */
+        r->x1 = 0;
+        r->y1 = 0;
+        r->x2 = GUI.lcd.width;
+        r->y2 = GUI.lcd.height;
+        return;
+    }
+    r->x1 = guii_widget_getabsolutex(parent) + guii_widget_getpaddingleft(parent);
+    r->y1 = guii_widget_getabsolutey(parent) + guii_widget_getpaddingtop(parent);
+    r->x2 = GUI_MIN(area->x2, r->x1 + guii_widget_getinnerwidth(parent));
+    r->y2 = GUI_MIN(area->y2, r->y1 + guii_widget_getinnerheight(parent));
+    r->x1 = GUI_MAX(area->x1, r->x1);
+    r->y1 = GUI_MAX(area->y1, r->y1);
+}
 
 /**
  * \brief           Clip are required to draw widget
  * \param[in]       h: Widget handle
+ * \param[in]       area: Clipping area given by parents of widget, see \ref get_children_clip
  */
 static void
-check_disp_clipping(gui_handle_p h) {
+check_disp_clipping(gui_handle_p h, const gui_display_t* area) {
     gui_dim_t x, y;
     gui_dim_t wi, hi;
     
@@ -70,86 +192,503 @@ check_disp_clipping(gui_handle_p h) {
     /*
      * Step 2: Set active clipping area, combining all parent together
      * 
-     * Process all parent widgets and check what is the position of them
-     * Make sure that on current widget we only draw actual visible area
+     * Area of all parents was combined already during traversal,
+     * make sure that on current widget we only draw actual visible area
      */
-    for (; h != NULL; h = guii_widget_getparent(h)) {
-        x = guii_widget_getparentabsolutex(h);     /* Parent absolute X position for inner widgets */
-        y = guii_widget_getparentabsolutey(h);     /* Parent absolute Y position for inner widgets */
-        wi = guii_widget_getparentinnerwidth(h);   /* Get parent inner width */
-        hi = guii_widget_getparentinnerheight(h);  /* Get parent inner height */
+    if (GUI.DisplayTemp.x1 < area->x1)      { GUI.DisplayTemp.x1 = area->x1; }
+    if (GUI.DisplayTemp.x2 > area->x2)      { GUI.DisplayTemp.x2 = area->x2; }
+    if (GUI.DisplayTemp.y1 < area->y1)      { GUI.DisplayTemp.y1 = area->y1; }
+    if (GUI.DisplayTemp.y2 > area->y2)      { GUI.DisplayTemp.y2 = area->y2; }
+}
+
+#if GUI_CFG_USE_TRANSPARENCY || __DOXYGEN__
+/**
+ * \brief           Get memory for temporary layer from scratch memory
+ * \note            Memory is used as stack and must be released in reverse order
+ *
+ * \note            When scratch memory is too small, heap is used for this layer
+ *                  and scratch memory grows to required size when it is not in use anymore
+ * \param[in]       size: Number of bytes required
+ * \return          Pointer to memory on success, `NULL` otherwise
+ */
+static void*
+scratch_get(size_t size) {
+    void* ptr;
+    
+    size = GUI_MEM_ALIGN(size);
+    GUI.ScratchPeak = GUI_MAX(GUI.ScratchPeak, GUI.ScratchUsed + size);
+    if (!GUI.ScratchUsed && GUI.ScratchPeak > GUI.ScratchSize) {   /* Grow when not in use */
+        GUI_MEMFREE(GUI.Scratch);
+        GUI_MEM_TAGGED(GUI_MEM_TAG_LAYER, GUI.Scratch = GUI_MEMALLOC_NOZERO_HINT(GUI.ScratchPeak, GUI_MEM_BULK));
+        GUI.ScratchSize = GUI.Scratch != NULL ? GUI.ScratchPeak : 0;
+    }
+    if (GUI.ScratchUsed + size <= GUI.ScratchSize) {
+        ptr = GUI.Scratch + GUI.ScratchUsed;        /* Take memory from top of scratch */
+        GUI.ScratchUsed += size;
+    } else {
+        GUI_MEM_TAGGED(GUI_MEM_TAG_LAYER, ptr = GUI_MEMALLOC_NOZERO_HINT(size, GUI_MEM_BULK)); /* Scratch is too small */
+    }
+    return ptr;
+}
+
+/**
+ * \brief           Release memory returned by \ref scratch_get
+ * \param[in]       ptr: Pointer to memory
+ * \param[in]       size: Number of bytes used in call to \ref scratch_get
+ */
+static void
+scratch_release(void* ptr, size_t size) {
+    if ((uint8_t *)ptr >= GUI.Scratch && (uint8_t *)ptr < GUI.Scratch + GUI.ScratchSize) {
+        GUI.ScratchUsed -= GUI_MEM_ALIGN(size);
+    } else {
+        GUI_MEMFREE(ptr);
+    }
+}
+
+/**
+ * \brief           Put new temporary layer on layer stack and start drawing to it
+ * \note            Layer starts with content of layer below, so parts not drawn stay unchanged after blending
+ * \param[in]       disp: Region covered by new layer. It must be inside layer below
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+layer_push(const gui_display_t* disp) {
+    gui_layer_t* below = GUI.lcd.drawing_layer;
+    gui_layer_t* layer;
+    gui_dim_t x = disp->x1, y = disp->y1;
+    gui_dim_t width = disp->x2 - disp->x1;
+    gui_dim_t height = disp->y2 - disp->y1;
+    void* mem;
+    
+#if GUI_CFG_LCD_ROTATION
+    guii_lcd_maprect(&x, &y, &width, &height);      /* Layer covers region in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+    if (GUI.LayerStackDepth >= GUI_COUNT_OF(GUI.LayerStack) || width <= 0 || height <= 0) {
+        return 0;
+    }
+    mem = scratch_get((size_t)width * (size_t)height * (size_t)below->pixel_size);
+    if (mem == NULL) {
+        return 0;
+    }
+    if (!GUI.LayerStackDepth) {                     /* Save main drawing layer */
+        GUI.LayerStackBase = below;
+    }
+    
+    layer = &GUI.LayerStack[GUI.LayerStackDepth++];
+    layer->num = below->num;
+    layer->pixel_format = below->pixel_format;      /* Blending requires the same format */
+    layer->pixel_size = below->pixel_size;
+    layer->start_address = (uintptr_t)mem;
+    layer->width = width;
+    layer->height = height;
+    layer->x_offset = x;
+    layer->y_offset = y;
+    
+    /* Start with content of layer below */
+    GUI.ll.Copy(&GUI.lcd, layer,
+        (void *)(below->start_address + 
+            below->pixel_size * (below->width * (layer->y_offset - below->y_offset) + (layer->x_offset - below->x_offset))),
+        (void *)layer->start_address,
+        width, height,
+        below->width - width, 0
+    );
+    GUI.lcd.drawing_layer = layer;                  /* Draw to new layer */
+    return 1;
+}
+
+/**
+ * \brief           Blend top temporary layer to layer below and remove it from layer stack
+ * \param[in]       h: Widget drawn to layer
+ * \param[in]       alpha: Transparency of top layer
+ */
+static void
+layer_pop(gui_handle_p h, uint8_t alpha) {
+    gui_layer_t* layer = &GUI.LayerStack[--GUI.LayerStackDepth];
+    gui_layer_t* below = GUI.LayerStackDepth ? &GUI.LayerStack[GUI.LayerStackDepth - 1] : GUI.LayerStackBase;
+    
+#if GUI_CFG_WIDGET_MASK
+    if (guii_widget_hasmask(h) && GUI.ll.CopyMask != NULL) {
+        const gui_mask_t* mask = h->mask;
+        gui_dim_t mx, my, x1, y1, x2, y2;
         
-        if (GUI.DisplayTemp.x1 < x)         { GUI.DisplayTemp.x1 = x; }
-        if (GUI.DisplayTemp.x2 > x + wi)    { GUI.DisplayTemp.x2 = x + wi; }
-        if (GUI.DisplayTemp.y1 < y)         { GUI.DisplayTemp.y1 = y; }
-        if (GUI.DisplayTemp.y2 > y + hi)    { GUI.DisplayTemp.y2 = y + hi; }
+        /* Blend only part of layer covered by mask, pixels of layer below stay outside of it */
+        mx = guii_widget_getabsolutex(h);
+        my = guii_widget_getabsolutey(h);
+        x1 = GUI_MAX(layer->x_offset, mx);
+        y1 = GUI_MAX(layer->y_offset, my);
+        x2 = GUI_MIN(layer->x_offset + layer->width, mx + mask->width);
+        y2 = GUI_MIN(layer->y_offset + layer->height, my + mask->height);
+        if (x1 < x2 && y1 < y2) {
+            GUI.ll.CopyMask(&GUI.lcd, below,
+                (void *)(layer->start_address + 
+                    layer->pixel_size * (layer->width * (y1 - layer->y_offset) + (x1 - layer->x_offset))),
+                (void *)(below->start_address + 
+                    below->pixel_size * (below->width * (y1 - below->y_offset) + (x1 - below->x_offset))),
+                mask->data + (size_t)mask->width * (y1 - my) + (x1 - mx),
+                alpha,
+                x2 - x1, y2 - y1,
+                layer->width - (x2 - x1), below->width - (x2 - x1), mask->width - (x2 - x1)
+            );
+        }
+    } else
+#else
+    GUI_UNUSED(h);
+#endif /* GUI_CFG_WIDGET_MASK */
+    {
+        GUI.ll.CopyBlend(&GUI.lcd, below,
+            (void *)layer->start_address, 
+            (void *)(below->start_address + 
+                below->pixel_size * (below->width * (layer->y_offset - below->y_offset) + (layer->x_offset - below->x_offset))),
+            alpha, 0xFF,
+            layer->width, layer->height,
+            0, below->width - layer->width
+        );
+    }
+    
+    guii_ll_waitready();                            /* Wait blending to finish before memory is released */
+    scratch_release((void *)layer->start_address, (size_t)layer->width * (size_t)layer->height * (size_t)layer->pixel_size);
+    GUI.lcd.drawing_layer = below;                  /* Continue drawing on layer below */
+}
+#endif /* GUI_CFG_USE_TRANSPARENCY || __DOXYGEN__ */
+
+/**
+ * \brief           Check if current widget clipping region is covered by opaque widget above it
+ * \note            Only siblings drawn after widget are checked. Each of them is
+ *                  marked for redraw by invalidation when overlapping, so covered area is redrawn anyway
+ * \note            Clipping region in \ref GUI.DisplayTemp must be prepared for widget before call
+ * \param[in]       h: Widget handle
+ * \return          `1` if widget does not need to be drawn, `0` otherwise
+ */
+static uint8_t
+is_widget_covered(gui_handle_p h) {
+    gui_handle_p t;
+    gui_dim_t x, y;
+    
+    if (GUI.DisplayTemp.x1 >= GUI.DisplayTemp.x2 || GUI.DisplayTemp.y1 >= GUI.DisplayTemp.y2) {
+        return 1;                                   /* Nothing visible to draw */
+    }
+    for (t = gui_linkedlist_widgetgetnext(NULL, h); t != NULL; t = gui_linkedlist_widgetgetnext(NULL, t)) {
+        if (!guii_widget_isvisible(t) || !guii_widget_isopaque(t)) {
+            continue;
+        }
+        x = guii_widget_getabsolutex(t);
+        y = guii_widget_getabsolutey(t);
+        if (x <= GUI.DisplayTemp.x1 && y <= GUI.DisplayTemp.y1 &&
+            x + guii_widget_getwidth(t) >= GUI.DisplayTemp.x2 &&
+            y + guii_widget_getheight(t) >= GUI.DisplayTemp.y2) {
+            return 1;                               /* Widget is hidden behind opaque sibling */
+        }
+    }
+    return 0;
+}
+
+#if !GUI_CFG_LCD_BAND
+/**
+ * \brief           Check if region will be completely repainted by current redraw process
+ * \note            Region is repainted when it is inside one of current dirty regions
+ *                  and fully covered by visible opaque widget on top level, marked for redraw
+ * \param[in]       disp: Region to check
+ * \return          `1` if region is repainted, `0` otherwise
+ */
+static uint8_t
+is_region_repainted(const gui_display_t* disp) {
+    gui_handle_p h;
+    gui_dim_t x, y;
+    size_t i;
+    
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {
+        if (GUI.DirtyRects[i].x1 <= disp->x1 && GUI.DirtyRects[i].y1 <= disp->y1 &&
+            GUI.DirtyRects[i].x2 >= disp->x2 && GUI.DirtyRects[i].y2 >= disp->y2) {
+            break;
+        }
+    }
+    if (i == GUI.DirtyRectsCount) {                 /* Region is not redrawn at all */
+        return 0;
+    }
+    for (h = gui_linkedlist_widgetgetnext(NULL, NULL); h != NULL; h = gui_linkedlist_widgetgetnext(NULL, h)) {
+        if (!guii_widget_isvisible(h) || !guii_widget_isopaque(h) || !guii_widget_getflag(h, GUI_FLAG_REDRAW)) {
+            continue;
+        }
+        x = guii_widget_getabsolutex(h);
+        y = guii_widget_getabsolutey(h);
+        if (x <= disp->x1 && y <= disp->y1 &&
+            x + guii_widget_getwidth(h) >= disp->x2 &&
+            y + guii_widget_getheight(h) >= disp->y2) {
+            return 1;                               /* Opaque widget draws over complete region */
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Copy regions of previous frame from active layer to drawing layer
+ * \note            When low-level implements \ref gui_ll_t.CopyRects, all regions are passed to it
+ *                  with single call, so it can copy them in one chained transfer
+ * \param[in]       active: Layer currently shown on display
+ * \param[in]       drawing: Layer to draw new frame to
+ * \param[in]       disps: Regions to copy
+ * \param[in]       count: Number of regions, up to \ref GUI_CFG_DISPLAY_DIRTY_RECTS
+ */
+static void
+copy_regions(gui_layer_t* active, gui_layer_t* drawing, const gui_display_t* disps, size_t count) {
+    gui_display_t rects[GUI_CFG_DISPLAY_DIRTY_RECTS];
+    gui_dim_t x, y, width, height;
+    size_t i;
+    
+    for (i = 0; i < count; i++) {
+        x = disps[i].x1;
+        y = disps[i].y1;
+        width = disps[i].x2 - disps[i].x1;
+        height = disps[i].y2 - disps[i].y1;
+#if GUI_CFG_LCD_ROTATION
+        guii_lcd_maprect(&x, &y, &width, &height);
+#endif /* GUI_CFG_LCD_ROTATION */
+        if (GUI.ll.CopyRects != NULL) {             /* Regions are copied together at the end */
+            rects[i].x1 = x;
+            rects[i].y1 = y;
+            rects[i].x2 = x + width;
+            rects[i].y2 = y + height;
+            continue;
+        }
+        GUI.ll.Copy(&GUI.lcd, drawing, 
+            (void *)(active->start_address + active->pixel_size * (y * active->width + x)), /* Source address */
+            (void *)(drawing->start_address + drawing->pixel_size * (y * drawing->width + x)),   /* Destination address */
+            width, height,                          /* Area size */
+            active->width - width,                  /* Offline source */
+            drawing->width - width                  /* Offline destination */
+        );
+    }
+    if (GUI.ll.CopyRects != NULL && count) {
+        GUI.ll.CopyRects(&GUI.lcd, drawing, active, rects, count);
+    }
+}
+#endif /* !GUI_CFG_LCD_BAND */
+
+/**
+ * \brief           Clear redraw flag on all children of widget drawn from retained bitmap
+ * \param[in]       parent: Parent widget handle
+ */
+static void
+clear_redraw(gui_handle_p parent) {
+    gui_handle_p h;
+    
+    if (!guii_widget_allowchildren(parent)) {
+        return;
+    }
+    for (h = guii_widget_treenext(parent, NULL, 1); h != NULL; h = guii_widget_treenext(parent, h, 1)) {
+        guii_widget_clrflag(h, GUI_FLAG_REDRAW | GUI_FLAG_REDRAW_CHILDREN);
+    }
+}
+
+#if GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__
+/**
+ * \brief           Draw number of redraws of widget in its top left corner
+ * \param[in]       h: Widget handle
+ */
+static void
+overlay_drawcount(gui_handle_p h) {
+    gui_draw_font_t f;
+    char str[12];
+    gui_dim_t w, hh;
+    
+    if (h->font == NULL) {                          /* Widget has nothing to write with */
+        return;
+    }
+    gui_string_fmt_int((gui_char *)str, sizeof(str), (int32_t)h->redraw_count);
+    gui_draw_font_init(&f);
+    f.width = GUI.lcd.width;                        /* Do not limit text size */
+    gui_draw_textsize(h->font, (const gui_char *)str, &f, &w, &hh);
+    f.x = guii_widget_getabsolutex(h);
+    f.y = guii_widget_getabsolutey(h);
+    f.width = w;
+    f.height = hh;
+    f.color1width = w;
+    f.color1 = GUI_COLOR_WHITE;
+    gui_draw_filledrectangle(&GUI.DisplayTemp, f.x, f.y, w, hh, GUI_COLOR_BLACK);
+    gui_draw_writetext(&GUI.DisplayTemp, h->font, (const gui_char *)str, &f);
+}
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__ */
+
+/**
+ * \brief           State of one nesting level during redraw
+ */
+typedef struct {
+    gui_handle_p h;                                 /*!< Widget whose children are drawn, `NULL` for top level */
+    gui_display_t clip;                             /*!< Clipping area of children, see \ref get_children_clip */
+    uint8_t drawn;                                  /*!< Widget itself was drawn and must be finished after children */
+#if GUI_CFG_USE_TRANSPARENCY
+    uint8_t transparent;                            /*!< Widget is drawn to temporary layer */
+#endif /* GUI_CFG_USE_TRANSPARENCY */
+    gui_display_t retained;                         /*!< Clipping region of retained widget */
+#if GUI_CFG_WIDGET_INSTANCE_CACHE
+    uint32_t instance;                              /*!< Instance cache key of widget */
+#endif /* GUI_CFG_WIDGET_INSTANCE_CACHE */
+} redraw_level_t;
+
+/**
+ * \brief           Finish widget drawing after its children were drawn
+ * \param[in]       l: Nesting level of widget
+ */
+static void
+redraw_finish(redraw_level_t* l) {
+    if (guii_widget_getflag(l->h, GUI_FLAG_RETAINED)) {
+        guii_widget_saveretained(l->h, &l->retained);   /* Keep drawn widget for next redraws */
+    }
+#if GUI_CFG_WIDGET_INSTANCE_CACHE
+    guii_widget_saveinstance(l->h, l->instance);    /* Share drawn widget with identical widgets */
+#endif /* GUI_CFG_WIDGET_INSTANCE_CACHE */
+    
+#if GUI_CFG_USE_TRANSPARENCY
+    /*
+     * If transparent mode is used on widget, copy content back
+     */
+    if (l->transparent) {                           /* If we were in transparent mode */
+        layer_pop(l->h, guii_widget_gettransparency(l->h)); /* Blend widget layer to layer below */
     }
+#endif /* GUI_CFG_USE_TRANSPARENCY */
+    guii_trace_end(GUI_TRACE_TYPE_REDRAW, 0, l->h, REDRAW_PIXELS());
 }
 
 /**
- * \brief           Redraw all widgets of selected parent
- * \param[in]       parent: Parent widget handle to draw widgets on
+ * \brief           Redraw all widgets inside current clipping region
+ * \note            Widget may cover more than one dirty region. Redraw flag is cleared
+ *                  only when processing last region to draw widget in all required regions
+ * \note            Widget tree is walked without recursion, state of each nesting level is kept
+ *                  in local array of \ref GUI_CFG_WIDGET_TREE_DEPTH entries.
+ *                  Children of widgets on last level are not drawn
+ * \param[in]       last: Set to `1` when current clipping region is last one to redraw
  * \return          Number of widgets redrawn
  */
 static uint32_t
-redraw_widgets(gui_handle_p parent) {
+redraw_widgets(uint8_t last) {
+    redraw_level_t levels[GUI_CFG_WIDGET_TREE_DEPTH + 1], *l = levels;
     gui_handle_p h;
+    gui_display_t r;
+    gui_dim_t x, y;
     uint32_t cnt = 0;
-    static uint32_t level = 0;
 
-    /* Go through all elements of parent */
-    for (h = gui_linkedlist_widgetgetnext((gui_handle_root_t *)parent, NULL); h != NULL; 
-            h = gui_linkedlist_widgetgetnext(NULL, h)) {
+    l->h = NULL;
+    l->drawn = 0;
+    get_children_clip(NULL, NULL, &l->clip);        /* Parents are combined only once for all children */
+    h = gui_linkedlist_widgetgetnext(NULL, NULL);
+    
+    /* Go through all elements of tree */
+    for (;;) {
+        if (h == NULL) {                            /* All children of level were processed */
+            if (l == levels) {
+                break;
+            }
+            if (l->drawn) {
+                redraw_finish(l);
+            }
+            h = gui_linkedlist_widgetgetnext(NULL, l->h);
+            l--;                                    /* Continue with next widget of parent level */
+            continue;
+        }
         if (!guii_widget_isvisible(h)) {            /* Check if visible */
-            guii_widget_clrflag(h, GUI_FLAG_REDRAW);   /* Clear flag to be sure */
+            if (guii_widget_getflag(h, GUI_FLAG_REDRAW_CHILDREN)) {
+                clear_redraw(h);                    /* Hidden children are redrawn when shown again */
+            }
+            guii_widget_clrflag(h, GUI_FLAG_REDRAW | GUI_FLAG_REDRAW_CHILDREN); /* Clear flag to be sure */
+            h = gui_linkedlist_widgetgetnext(NULL, h);
             continue;                               /* Ignore hidden elements */
         }
-        if (guii_widget_isinsideclippingregion(h)) { /* If widget is inside clipping region */
-            /* Draw main widget if required */
-            if (guii_widget_getflag(h, GUI_FLAG_REDRAW)) {  /* Check if redraw required */
+        if (!guii_widget_getflag(h, GUI_FLAG_REDRAW | GUI_FLAG_REDRAW_CHILDREN)) {
+            h = gui_linkedlist_widgetgetnext(NULL, h);
+            continue;                               /* Nothing to redraw in this branch */
+        }
+        x = guii_widget_getabsolutex(h);
+        y = guii_widget_getabsolutey(h);
+        r.x1 = GUI_MAX(l->clip.x1, x);
+        r.y1 = GUI_MAX(l->clip.y1, y);
+        r.x2 = GUI_MIN(l->clip.x2, x + guii_widget_getwidth(h));
+        r.y2 = GUI_MIN(l->clip.y2, y + guii_widget_getheight(h));
+        if (__GUI_RECT_MATCH(r.x1, r.y1, r.x2, r.y2,  /* If widget is inside clipping region */
+            GUI.Display.x1, GUI.Display.y1, GUI.Display.x2, GUI.Display.y2)) {
+            redraw_level_t* n = l + 1;              /* Level of widget and its children */
+            
+            n->drawn = 0;
 #if GUI_CFG_USE_TRANSPARENCY
-                gui_layer_t* layerPrev = GUI.lcd.drawing_layer; /* Save drawing layer */
-                uint8_t transparent = 0;
+            n->transparent = 0;
 #endif /* GUI_CFG_USE_TRANSPARENCY */
-                
-                guii_widget_clrflag(h, GUI_FLAG_REDRAW);    /* Clear flag for drawing on widget */
+#if GUI_CFG_WIDGET_INSTANCE_CACHE
+            n->instance = 0;
+#endif /* GUI_CFG_WIDGET_INSTANCE_CACHE */
+            
+            /* Draw main widget if required */
+            if (guii_widget_getflag(h, GUI_FLAG_REDRAW)) {  /* Check if redraw required */
+                if (last) {
+                    guii_widget_clrflag(h, GUI_FLAG_REDRAW);    /* Clear flag for drawing on widget */
+                }
                 
                 /*
                  * Prepare clipping region for this widget drawing
                  */
-                check_disp_clipping(h);             /* Check coordinates for drawings only particular widget */
+                check_disp_clipping(h, &l->clip);   /* Check coordinates for drawings only particular widget */
+                if (is_widget_covered(h)) {         /* Skip widget and its children when not visible at all */
+                    h = gui_linkedlist_widgetgetnext(NULL, h);
+                    continue;
+                }
+                if (guii_widget_getflag(h, GUI_FLAG_RETAINED)) {
+                    if (guii_widget_drawretained(h, &GUI.DisplayTemp)) {    /* Copy widget with children from bitmap */
+                        if (last) {
+                            guii_widget_clrflag(h, GUI_FLAG_REDRAW_CHILDREN);
+                            clear_redraw(h);
+                        }
+                        cnt++;
+                        h = gui_linkedlist_widgetgetnext(NULL, h);
+                        continue;
+                    }
+                    n->retained = GUI.DisplayTemp;  /* Children change clipping region */
+                }
+#if GUI_CFG_WIDGET_INSTANCE_CACHE
+                if (guii_widget_getflag(h, GUI_FLAG_INSTANCED)) {
+                    if (guii_widget_drawinstance(h, &GUI.DisplayTemp, &n->instance)) { /* Copy identical widget drawn before */
+                        cnt++;
+                        h = gui_linkedlist_widgetgetnext(NULL, h);
+                        continue;
+                    }
+                }
+#endif /* GUI_CFG_WIDGET_INSTANCE_CACHE */
+
+#if GUI_CFG_WIDGET_SAVE_UNDER
+                if (guii_widget_getflag(h, GUI_FLAG_SAVE_UNDER)) {
+                    guii_widget_captureunder(h);    /* Keep pixels below popup before it covers them */
+                }
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
+                guii_trace_begin(GUI_TRACE_TYPE_REDRAW, 0, h, REDRAW_PIXELS());
 
 #if GUI_CFG_USE_TRANSPARENCY
                 /*
                  * Check transparency and check if blending function exists to merge layers later together
                  */
                 if (guii_widget_istransparent(h) && GUI.ll.CopyBlend) {
-                    gui_dim_t width = GUI.DisplayTemp.x2 - GUI.DisplayTemp.x1;
-                    gui_dim_t height = GUI.DisplayTemp.y2 - GUI.DisplayTemp.y1;
-                    
-                    /*
-                     * Try to allocate memory for new virtual layer for temporary usage
-                     */
-                    GUI.lcd.drawing_layer = GUI_MEMALLOC(sizeof(*GUI.lcd.drawing_layer) + (size_t)width * (size_t)height * (size_t)GUI.lcd.pixel_size);
-                    
-                    if (GUI.lcd.drawing_layer != NULL) {/* Check if allocation was successful */
-                        GUI.lcd.drawing_layer->width = width;
-                        GUI.lcd.drawing_layer->height = height;
-                        GUI.lcd.drawing_layer->x_offset = GUI.DisplayTemp.x1;
-                        GUI.lcd.drawing_layer->y_offset = GUI.DisplayTemp.y1;
-                        GUI.lcd.drawing_layer->start_address = (uint32_t)((char *)GUI.lcd.drawing_layer) + sizeof(*GUI.lcd.drawing_layer);
-                        transparent = 1;            /* We are going to transparent drawing mode */
-                    } else {
-                        GUI.lcd.drawing_layer = layerPrev;  /* Reset layer back */
-                    }
+                    n->transparent = layer_push(&GUI.DisplayTemp);  /* Draw widget to temporary layer */
                 }
 #endif /* GUI_CFG_USE_TRANSPARENCY */
                 
                 /*
                  * Draw widget itself normally, don't care on layer offset and size
                  */
-                GUI_WIDGET_PARAMTYPE_DISP(&GUI.WidgetParam) = &GUI.DisplayTemp;  /* Set parameter */
-                guii_widget_callback(h, GUI_WC_Draw, &GUI.WidgetParam, &GUI.WidgetResult); /* Draw widget */
+#if GUI_CFG_USE_DISPLAY_LIST
+                if (!guii_widget_getflag(h, GUI_FLAG_DISPLAY_LIST) || !guii_widget_drawlist(h, &GUI.DisplayTemp))
+#endif /* GUI_CFG_USE_DISPLAY_LIST */
+                {
+                    GUI_WIDGET_PARAMTYPE_DISP(&GUI.WidgetParam) = &GUI.DisplayTemp;  /* Set parameter */
+                    guii_widget_callback(h, GUI_WC_Draw, &GUI.WidgetParam, &GUI.WidgetResult); /* Draw widget */
+                }
+#if GUI_CFG_WIDGET_STATICS
+                guii_widget_drawstatics(h, &GUI.DisplayTemp);   /* Static elements are below children */
+#endif /* GUI_CFG_WIDGET_STATICS */
+                cnt++;                              /* Widget was redrawn */
+#if GUI_CFG_USE_DEBUG_OVERLAY
+                if (!GUI.OverlayPass) {             /* Overlay repaints are not counted */
+                    h->redraw_count++;
+                }
+                if (GUI.Overlay) {
+                    overlay_drawcount(h);
+                }
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY */
                 
                 /* Check if there are children widgets in this widget */
                 if (guii_widget_allowchildren(h)) {
@@ -160,39 +699,35 @@ redraw_widgets(gui_handle_p parent) {
                             tmp = gui_linkedlist_widgetgetnext(NULL, tmp)) {
                         guii_widget_setflag(tmp, GUI_FLAG_REDRAW); /* Set redraw bit to all children elements */
                     }
-                    /* ...now call function for actual redrawing process */
-                    level++;
-                    cnt += redraw_widgets(h);       /* Redraw children widgets */
-                    level--;
                 }
-                
-#if GUI_CFG_USE_TRANSPARENCY
-                /*
-                 * If transparent mode is used on widget, copy content back
-                 */
-                if (transparent) {                  /* If we were in transparent mode */
-                    /* Copy layers with blending */
-                    GUI.ll.CopyBlend(&GUI.lcd, GUI.lcd.drawing_layer,
-                        (void *)GUI.lcd.drawing_layer->start_address, 
-                        (void *)(layerPrev->start_address + 
-                            GUI.lcd.pixel_size * (layerPrev->width * (GUI.lcd.drawing_layer->y_offset - layerPrev->y_offset) + (GUI.lcd.drawing_layer->x_offset - layerPrev->x_offset))),
-                        guii_widget_gettransparency(h), 0xFF,
-                        GUI.lcd.drawing_layer->width, GUI.lcd.drawing_layer->height,
-                        0, layerPrev->width - GUI.lcd.drawing_layer->width
-                    );
-                    
-                    GUI_MEMFREE(GUI.lcd.drawing_layer); /* Free memory for virtual layer */
-                    GUI.lcd.drawing_layer = layerPrev;  /* Reset layer pointer */
-                }
-#endif /* GUI_CFG_USE_TRANSPARENCY */
-                
+                n->drawn = 1;
+            }
+            
             /*
-             * Check if any widget from children should be redrawn
+             * Children are drawn on next level, widget is finished when the level is done
              */
-            } else if (guii_widget_allowchildren(h)) {
-                cnt += redraw_widgets(h);           /* Redraw children widgets */
+            if (n->drawn || guii_widget_allowchildren(h)) {
+                l = n;
+                l->h = h;
+                h = NULL;                           /* Level is done at once without children */
+                if (guii_widget_allowchildren(l->h)) {
+                    if (last) {                     /* Widgets marked during drawing set it again */
+                        guii_widget_clrflag(l->h, GUI_FLAG_REDRAW_CHILDREN);
+                    }
+                    if (l < &levels[GUI_CFG_WIDGET_TREE_DEPTH]) {
+                        get_children_clip(l->h, &l[-1].clip, &l->clip);
+                        h = gui_linkedlist_widgetgetnext((gui_handle_root_t *)l->h, NULL);  /* Redraw children widgets */
+                    } else if (last) {
+                        clear_redraw(l->h);         /* Children are too deep to be drawn */
+                    }
+                }
+                continue;
             }
+        } else if (last) {                          /* Widget was drawn in previous regions if required */
+            guii_widget_clrflag(h, GUI_FLAG_REDRAW | GUI_FLAG_REDRAW_CHILDREN);
+            clear_redraw(h);
         }
+        h = gui_linkedlist_widgetgetnext(NULL, h);
     }
     return cnt;                                     /* Return number of redrawn objects */
 }
@@ -233,6 +768,48 @@ redraw_widgets(gui_handle_p parent) {
  * This is all handled by this "thread" function
  */
 
+/**
+ * \brief           Touch timeout timer callback
+ * \param[in]       t: Timer handle
+ */
+static void
+touch_timer_callback(gui_timer_t* t) {
+    GUI_UNUSED(t);
+    GUI.TouchTimerArmed = 0;
+    GUI.TouchTimeout = 1;                           /* Let touch threads check their deadlines */
+}
+
+/**
+ * \brief           Check touch timeout and arm timer for it when not yet expired
+ *
+ *                  Instead of polling touch threads on every process call,
+ *                  timer is armed for earliest pending deadline of all touch threads
+ * \param[in]       start: Start time of timeout in units of milliseconds
+ * \param[in]       timeout: Timeout in units of milliseconds
+ * \return          `1` when timeout expired, `0` otherwise
+ */
+static uint8_t
+touch_timeout(uint32_t start, uint32_t timeout) {
+    uint32_t now = gui_sys_now(), deadline;
+    
+    if ((now - start) > timeout) {
+        return 1;
+    }
+    deadline = start + timeout + 1;                 /* First time when timeout condition is true */
+    if (GUI.TouchTimer == NULL) {
+        GUI.TouchTimer = guii_timer_create(0, touch_timer_callback, NULL);
+        if (GUI.TouchTimer == NULL) {
+            return 0;                               /* Threads are polled periodically without timer */
+        }
+    }
+    if (!GUI.TouchTimerArmed || (int32_t)(GUI.TouchDeadline - deadline) > 0) {
+        GUI.TouchDeadline = deadline;
+        GUI.TouchTimer->period = (uint16_t)(deadline - now);
+        GUI.TouchTimerArmed = guii_timer_start(GUI.TouchTimer);
+    }
+    return 0;
+}
+
 /**
  * \brief           Touch event proto thread 
  *
@@ -240,37 +817,36 @@ redraw_widgets(gui_handle_p parent) {
  * \param[in]       ts: Touch information with X and Y positions
  * \param[in]       old: Old touch information
  * \param[in]       v: Is input value valid or is just "check" call
+ * \param[in]       active: Widget active by this touch
  * \param[out]      result: Result of event, if any
  * \return          PT thread result
  */
 static
-PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* ts, guii_touch_data_t* old, uint8_t v, gui_wc_t* result)) {
-    static volatile uint32_t time;
-    static uint8_t i = 0;
-    static gui_dim_t x[2], y[2];
+PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* ts, guii_touch_data_t* old, uint8_t v, gui_handle_p active, gui_wc_t* result)) {
+    guii_touch_click_t* c = &ts->click;             /* State is kept with touch data, not in static variables */
     
     *result = (gui_wc_t)0;                          /* Reset widget control variable */          
     
     PT_BEGIN(&ts->pt);                              /* Start thread execution */
     
-    memset(x, 0x00, sizeof(x));                     /* Reset X values */
-    memset(y, 0x00, sizeof(y));                     /* Reset Y values */
-    for (i = 0; i < 2;) {                           /* Allow up to 2 touch presses */
+    memset(c->x, 0x00, sizeof(c->x));               /* Reset X values */
+    memset(c->y, 0x00, sizeof(c->y));               /* Reset Y values */
+    for (c->index = 0; c->index < 2;) {             /* Allow up to 2 touch presses */
         /*
          * Wait for valid input with pressed state
          */
         PT_WAIT_UNTIL(&ts->pt, v && ts->ts.status && !old->ts.status && ts->ts.count == 1);
         
-        time = ts->ts.time;                         /* Get start time of this touch */
-        x[i] = ts->x_rel[0];                        /* Save X value */
-        y[i] = ts->y_rel[0];                        /* Save Y value */
+        c->time = ts->ts.time;                      /* Get start time of this touch */
+        c->x[c->index] = ts->x_rel[0];              /* Save X value */
+        c->y[c->index] = ts->y_rel[0];              /* Save Y value */
         
         /*
          * Either wait for released status or timeout
          */
         do {
             PT_YIELD(&ts->pt);                      /* Stop thread for now and wait next call */
-            PT_WAIT_UNTIL(&ts->pt, v || (gui_sys_now() - time) > 2000); /* Wait touch with released state or timeout */
+            PT_WAIT_UNTIL(&ts->pt, v || touch_timeout(c->time, GUI_CFG_TOUCH_LONGCLICK_TIME));   /* Wait touch with released state or timeout */
             
             if (v) {                                /* New valid touch entry received, either released or pressed again */
                 /*
@@ -278,10 +854,10 @@ PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* ts, guii_touch_data_t* old, ui
                  * then we can use click events also after touch move (for example, button is that widget) where in
                  * some cases, click event should not be processed after touch move (slider, dropdown, etc)
                  */
-                if (ts->ts.status && GUI.ActiveWidget != NULL && !guii_widget_getflag(GUI.ActiveWidget, GUI_FLAG_TOUCH_MOVE)) {
-                    time = ts->ts.time;             /* Get start time of this touch */
-                    x[i] = ts->x_rel[0];            /* Update X value */
-                    y[i] = ts->y_rel[0];            /* Update Y value */
+                if (ts->ts.status && active != NULL && !guii_widget_getflag(active, GUI_FLAG_TOUCH_MOVE)) {
+                    c->time = ts->ts.time;          /* Get start time of this touch */
+                    c->x[c->index] = ts->x_rel[0];  /* Update X value */
+                    c->y[c->index] = ts->y_rel[0];  /* Update Y value */
                     continue;                       /* Continue and wait for next (released) event */
                 } else {                            /* Released status received */
                     break;                          /* Stop execution, continue later */
@@ -296,31 +872,36 @@ PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* ts, guii_touch_data_t* old, ui
          */
         if (v) {                                    /* New touch event occurred */
             if (!ts->ts.status) {                   /* We received released state */
-                if (i) {                            /* Try to get second click, check difference for double click */
-                    if (GUI_ABS(x[0] - x[1]) > 30 || GUI_ABS(y[0] - y[1]) > 30) {
-                        i = 0;                      /* Difference was too big, reset and act like normal click */
+                if (c->index) {                     /* Try to get second click, check difference for double click */
+                    if (GUI_ABS(c->x[0] - c->x[1]) > GUI_CFG_TOUCH_DBLCLICK_DISTANCE || GUI_ABS(c->y[0] - c->y[1]) > GUI_CFG_TOUCH_DBLCLICK_DISTANCE) {
+                        c->index = 0;               /* Difference was too big, reset and act like normal click */
                     }
                 }
                 if (
-                    x[0] < 0 || x[0] > ts->widget_width ||
-                    y[0] < 0 || y[0] > ts->widget_height ||
-                    x[1] < 0 || x[1] > ts->widget_width ||
-                    y[1] < 0 || y[1] > ts->widget_height
+                    c->x[0] < 0 || c->x[0] > ts->widget_width ||
+                    c->y[0] < 0 || c->y[0] > ts->widget_height ||
+                    c->x[1] < 0 || c->x[1] > ts->widget_width ||
+                    c->y[1] < 0 || c->y[1] > ts->widget_height
                 ) {
                     PT_EXIT(&ts->pt);               /* Exit thread, invalid coordinate for touch click or double click */
                 }
-                if (!i) {                           /* On first call, this is click event */
+                if (!c->index) {                    /* On first call, this is click event */
                     *result = GUI_WC_Click;         /* Click event occurred */
                     
-                    time = ts->ts.time;             /* Save last time */
+                    c->time = ts->ts.time;          /* Save last time */
+                    touch_timeout(c->time, GUI_CFG_TOUCH_DBLCLICK_TIME);    /* Arm timer now, thread is not called again without it */
                     PT_YIELD(&ts->pt);              /* Stop thread for now and wait next call with new touch event */
                     
                     /*
                      * Wait for valid input with pressed state
                      */
-                    PT_WAIT_UNTIL(&ts->pt, (v && ts->ts.status) || (gui_sys_now() - time) > 300);
-                    if ((gui_sys_now() - time) > 300) { /* Check timeout for new pressed state */
-                        PT_EXIT(&ts->pt);           /* Exit protothread */
+                    PT_WAIT_UNTIL(&ts->pt, (v && ts->ts.status) || touch_timeout(c->time, GUI_CFG_TOUCH_DBLCLICK_TIME));
+                    if ((gui_sys_now() - c->time) > GUI_CFG_TOUCH_DBLCLICK_TIME) { /* Check timeout for new pressed state */
+                        if (!v) {
+                            PT_EXIT(&ts->pt);       /* Exit protothread */
+                        }
+                        c->index = 0;               /* Late press starts new click */
+                        continue;
                     }
                 } else {
                     *result = GUI_WC_DblClick;      /* Double click event */
@@ -328,12 +909,12 @@ PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* ts, guii_touch_data_t* old, ui
                 }
             }
         } else {
-            if (!i) {                               /* Timeout occurred with no touch data, long click */
+            if (!c->index) {                        /* Timeout occurred with no touch data, long click */
                 *result = GUI_WC_LongClick;         /* Click event occurred */
             }
             PT_EXIT(&ts->pt);                       /* Exit protothread here */
         }
-        i++;
+        c->index++;
     }
     PT_END(&ts->pt);                                /* Stop thread execution */
 }
@@ -370,23 +951,101 @@ set_relative_coordinate(guii_touch_data_t* ts, gui_dim_t x, gui_dim_t y, gui_dim
 #endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 */
 }
 
+/**
+ * \brief           Start touch on widget found below touch position
+ * \param[in]       touch: Touch data info
+ * \param[in]       h: Widget handle below touch position
+ * \param[in]       keyboard: Set to `1` when widget is part of keyboard,
+ *                      to keep focus on currently focused widget
+ * \return          Member of \ref guii_touch_status_t enumeration about success
+ */
+static guii_touch_status_t
+touch_start(guii_touch_data_t* touch, gui_handle_p h, uint8_t keyboard) {
+    guii_touch_status_t tStat;
+    
+    set_relative_coordinate(touch,                  /* Set relative coordinate */
+        guii_widget_getabsolutex(h), guii_widget_getabsolutey(h), 
+        guii_widget_getwidth(h), guii_widget_getheight(h)
+    ); 
+    
+    /* Call touch start callback to see if widget accepts touches */
+    GUI_WIDGET_PARAMTYPE_TOUCH(&GUI.WidgetParam) = touch;
+    guii_widget_callback(h, GUI_WC_TouchStart, &GUI.WidgetParam, &GUI.WidgetResult);
+    tStat = GUI_WIDGET_RESULTTYPE_TOUCH(&GUI.WidgetResult);
+    if (tStat == touchCONTINUE) {                   /* Check result status */
+        tStat = touchHANDLED;                       /* If command is processed, touchCONTINUE can't work */
+    }
+    
+    /*
+     * Move widget down on parent linked list and do the same with all of its parents,
+     * no matter of touch focus or not
+     */
+    guii_widget_movedowntree(h);
+    
+    if (tStat == touchHANDLED) {                    /* Touch handled for widget completely */
+        /*
+         * Set active widget and set flag for it
+         * Set focus widget and set flag for it but only do this if widget is not related to keyboard
+         *
+         * This allows us to click keyboard items but not to lose focus on main widget
+         */
+        if (!keyboard) {
+            guii_widget_focus_set(h);
+        }
+        guii_widget_active_set(h);
+        
+        /*
+         * Invalidate actual handle object
+         * Already invalidated in __GUI_ACTIVE_SET function
+         */
+        //guii_widget_invalidate(h);
+    } else {                                        /* Touch handled with no focus */
+        /*
+         * When touch was handled without focus,
+         * process only clearing currently focused and active widgets and clear them
+         */
+        if (!keyboard) {
+            guii_widget_focus_clear();
+        }
+        guii_widget_active_clear();
+    }
+    return tStat;
+}
+
+/**
+ * \brief           State of one nesting level during touch processing
+ */
+typedef struct {
+    gui_handle_p h;                                 /*!< Widget whose children are checked, `NULL` for top level */
+    gui_display_t clip;                             /*!< Clipping area of children, see \ref get_children_clip */
+    uint8_t dialogOnly;                             /*!< Only dialog based widgets are checked on level */
+#if GUI_CFG_TOUCH_INDEX_GRID
+    uint8_t keyboard;                               /*!< Widget is part of keyboard */
+#endif /* GUI_CFG_TOUCH_INDEX_GRID */
+} touch_level_t;
+
 /**
  * \brief           Process input touch event
  *                  
  *                  Scan all widgets from top to bottom which will be first on valid 
  *                  position for touch and call callback function to this widget
  *
+ * \note            Widget tree is walked without recursion, state of each nesting level is kept
+ *                  in local array of \ref GUI_CFG_WIDGET_TREE_DEPTH entries.
+ *                  Children of widgets on last level do not receive touch
  * \param[in]       touch: Touch data info
- * \param[in]       parent: Parent widget where to check for touch
  * \return          Member of \ref guii_touch_status_t enumeration about success
  */
 static guii_touch_status_t
-process_touch(guii_touch_data_t* touch, gui_handle_p parent) {
+process_touch(guii_touch_data_t* touch) {
+    touch_level_t levels[GUI_CFG_WIDGET_TREE_DEPTH], *l = levels;
     gui_handle_p h;
-    static uint8_t deep = 0;
-    static uint8_t isKeyboard = 0;
-    uint8_t dialogOnly = 0;
-    guii_touch_status_t tStat = touchCONTINUE;
+    uint8_t isKeyboard = 0;
+    guii_touch_status_t tStat;
+    
+    l->h = NULL;
+    l->dialogOnly = 0;
+    get_children_clip(NULL, NULL, &l->clip);        /* Parents are combined only once for all children */
     
     /*
      * To handle touch events, process widgets in reverse order,
@@ -395,124 +1054,607 @@ process_touch(guii_touch_data_t* touch, gui_handle_p parent) {
      * This is due to the fact that widget with most deep level,
      * is displayed on top of screen = should be detected first
      */
-    for (h = gui_linkedlist_widgetgetprev((gui_handle_root_t *)parent, NULL); h != NULL; 
-            h = gui_linkedlist_widgetgetprev(NULL, h)) {
-        if (guii_widget_ishidden(h)) {             /* Ignore hidden widget */
-            continue;
+    h = gui_linkedlist_widgetgetprev(NULL, NULL);
+    for (;;) {
+        if (h == NULL) {                            /* All children of level were checked */
+            if (l == levels) {
+                break;
+            }
+            h = l->h;                               /* Children did not take touch, check widget itself */
+            l--;
+            guii_trace_end(GUI_TRACE_TYPE_TOUCH, (uint8_t)touchCONTINUE, h, 0);
+        } else {
+            if (guii_widget_ishidden(h)) {          /* Ignore hidden widget */
+                h = gui_linkedlist_widgetgetprev(NULL, h);
+                continue;
+            }
+            
+            /*
+             * Dialogs are placed as children of main window
+             * If level 1 is current and dialog is detected,
+             * stop process of other widgets except if widget is inside dialog
+             */
+            if (l == &levels[1]) {                  /* On base elements list = children of base window element */
+                if (guii_widget_isdialogbase(h)) { /* We found dialog element */
+                    l->dialogOnly = 1;              /* Check only widgets which are dialog based */
+                }
+            }
+            
+            /* When we should only check dialogs and previous element is not dialog anymore */
+            if (l->dialogOnly && !guii_widget_isdialogbase(h)) {
+                h = NULL;                           /* Level is done */
+                continue;
+            }
+            
+            /* Check for keyboard mode */
+            if (guii_widget_getid(h) == GUI_ID_KEYBOARD_BASE) {
+                isKeyboard = 1;                     /* Set keyboard mode as 1 */
+            }
+            
+            /*
+             * Before we check if touch position matches widget coordinates
+             * we have to check if this widget has any direct children
+             */
+            if (guii_widget_allowchildren(h) && l < &levels[GUI_CFG_WIDGET_TREE_DEPTH - 1]) {
+                guii_trace_begin(GUI_TRACE_TYPE_TOUCH, 0, h, 0);
+                l++;                                /* Go deeper in level */
+                l->h = h;
+                l->dialogOnly = 0;
+                get_children_clip(h, &l[-1].clip, &l->clip);
+                h = gui_linkedlist_widgetgetprev((gui_handle_root_t *)h, NULL); /* Process touch on widget elements first */
+                continue;
+            }
         }
         
         /*
-         * Dialogs are placed as children of main window
-         * If level 1 is current and dialog is detected,
-         * stop process of other widgets except if widget is inside dialog
+         * Children widgets were not detected
          */
-        if (deep == 1) {                            /* On base elements list = children of base window element */
-            if (guii_widget_isdialogbase(h)) {     /* We found dialog element */
-                dialogOnly = 1;                     /* Check only widgets which are dialog based */
-            }
-        }
-        
-        /* When we should only check dialogs and previous element is not dialog anymore */
-        if (dialogOnly && !guii_widget_isdialogbase(h)) {
-            break;
+        tStat = touchCONTINUE;
+        check_disp_clipping(h, &l->clip);           /* Check display region where widget is placed */
+    
+        /* Check if widget is in touch area */
+        if (touch->ts.x[0] >= GUI.DisplayTemp.x1 && touch->ts.x[0] <= GUI.DisplayTemp.x2 && 
+            touch->ts.y[0] >= GUI.DisplayTemp.y1 && touch->ts.y[0] <= GUI.DisplayTemp.y2) {
+            tStat = touch_start(touch, h, isKeyboard);
         }
         
         /* Check for keyboard mode */
         if (guii_widget_getid(h) == GUI_ID_KEYBOARD_BASE) {
-            isKeyboard = 1;                         /* Set keyboard mode as 1 */
+            isKeyboard = 0;                         /* Set keyboard mode as 1 */
         }
         
-        /*
-         * Before we check if touch position matches widget coordinates
-         * we have to check if this widget has any direct children
-         */
-        if (guii_widget_allowchildren(h)) {        /* If children widgets are allowed */
-            deep++;                                 /* Go deeper in level */
-            tStat = process_touch(touch, h);        /* Process touch on widget elements first */
-            deep--;                                 /* Go back to normal level */
+        if (tStat != touchCONTINUE) {               /* Return status if necessary */
+            for (; l != levels; l--) {              /* Finish all parent levels */
+                guii_trace_end(GUI_TRACE_TYPE_TOUCH, (uint8_t)tStat, l->h, 0);
+            }
+            return tStat;
         }
-        
-        /*
-         * Children widgets were not detected
-         */
-        if (tStat == touchCONTINUE) {               /* Do we still have to check this widget? */
-            check_disp_clipping(h);                 /* Check display region where widget is placed */
-        
-            /* Check if widget is in touch area */
-            if (touch->ts.x[0] >= GUI.DisplayTemp.x1 && touch->ts.x[0] <= GUI.DisplayTemp.x2 && 
-                touch->ts.y[0] >= GUI.DisplayTemp.y1 && touch->ts.y[0] <= GUI.DisplayTemp.y2) {
-                set_relative_coordinate(touch,      /* Set relative coordinate */
-                    guii_widget_getabsolutex(h), guii_widget_getabsolutey(h), 
-                    guii_widget_getwidth(h), guii_widget_getheight(h)
-                ); 
-            
-                /* Call touch start callback to see if widget accepts touches */
-                GUI_WIDGET_PARAMTYPE_TOUCH(&GUI.WidgetParam) = touch;
-                guii_widget_callback(h, GUI_WC_TouchStart, &GUI.WidgetParam, &GUI.WidgetResult);
-                tStat = GUI_WIDGET_RESULTTYPE_TOUCH(&GUI.WidgetResult);
-                if (tStat == touchCONTINUE) {       /* Check result status */
-                    tStat = touchHANDLED;           /* If command is processed, touchCONTINUE can't work */
-                }
-                
-                /*
-                 * Move widget down on parent linked list and do the same with all of its parents,
-                 * no matter of touch focus or not
-                 */
-                guii_widget_movedowntree(h);
-                
-                if (tStat == touchHANDLED) {        /* Touch handled for widget completely */
-                    /*
-                     * Set active widget and set flag for it
-                     * Set focus widget and set flag for it but only do this if widget is not related to keyboard
-                     *
-                     * This allows us to click keyboard items but not to lose focus on main widget
-                     */
-                    if (!isKeyboard) {
-                        guii_widget_focus_set(h);
-                    }
-                    guii_widget_active_set(h);
-                    
-                    /*
-                     * Invalidate actual handle object
-                     * Already invalidated in __GUI_ACTIVE_SET function
-                     */
-                    //guii_widget_invalidate(h);
-                } else {                            /* Touch handled with no focus */
-                    /*
-                     * When touch was handled without focus,
-                     * process only clearing currently focused and active widgets and clear them
-                     */
-                    if (!isKeyboard) {
-                        guii_widget_focus_clear();
-                    }
-                    guii_widget_active_clear();
-                }
+        h = gui_linkedlist_widgetgetprev(NULL, h);
+    }
+    return touchCONTINUE;                           /* Try with another widget */
+}
+
+#if GUI_CFG_TOUCH_INDEX_GRID || __DOXYGEN__
+
+/**
+ * \brief           Get grid cell for screen coordinate
+ * \note            Coordinates outside screen are placed to first or last cell
+ * \param[in]       v: X or Y coordinate on screen
+ * \param[in]       cs: Size of one cell in units of pixels
+ * \return          Cell index in range from `0` to \ref GUI_CFG_TOUCH_INDEX_GRID - 1
+ */
+static size_t
+touch_index_cell(gui_dim_t v, gui_dim_t cs) {
+    if (v < 0) {
+        return 0;
+    }
+    return GUI_MIN((size_t)(v / cs), GUI_CFG_TOUCH_INDEX_GRID - 1);
+}
+
+/**
+ * \brief           Collect visible widgets to touch index
+ *
+ *                  Widgets are visited in the same order as \ref process_touch checks them,
+ *                  so first entry which contains touch position is the one to receive touch
+ *
+ * \note            Entries are written only while there is memory available for them,
+ *                  but all of them are counted
+ * \param[in]       area: Visible area of screen
+ * \return          Number of entries collected
+ */
+static size_t
+touch_index_collect(const gui_display_t* area) {
+    touch_level_t levels[GUI_CFG_WIDGET_TREE_DEPTH], *l = levels;
+    gui_touch_index_entry_t* e;
+    gui_display_t r;
+    gui_handle_p h;
+    gui_dim_t x, y;
+    size_t cnt = 0;
+    uint8_t kb;
+    
+    l->h = NULL;
+    l->clip = *area;
+    l->dialogOnly = 0;
+    l->keyboard = 0;
+    h = gui_linkedlist_widgetgetprev(NULL, NULL);
+    for (;;) {
+        if (h == NULL) {                            /* All children of level were collected */
+            if (l == levels) {
+                break;
+            }
+            h = l->h;                               /* Widget itself is after its children */
+            kb = l->keyboard;
+            l--;
+        } else {
+            if (guii_widget_ishidden(h)) {          /* Ignore hidden widget */
+                h = gui_linkedlist_widgetgetprev(NULL, h);
+                continue;
+            }
+            if (l == &levels[1] && guii_widget_isdialogbase(h)) {  /* Only dialogs are touchable next to main window */
+                l->dialogOnly = 1;
+            }
+            if (l->dialogOnly && !guii_widget_isdialogbase(h)) {
+                h = NULL;                           /* Level is done */
+                continue;
+            }
+            kb = l->keyboard || guii_widget_getid(h) == GUI_ID_KEYBOARD_BASE;
+            
+            if (guii_widget_allowchildren(h) && l < &levels[GUI_CFG_WIDGET_TREE_DEPTH - 1]) {   /* Children are checked before widget itself */
+                r.x1 = guii_widget_getabsolutex(h) + guii_widget_getpaddingleft(h);
+                r.y1 = guii_widget_getabsolutey(h) + guii_widget_getpaddingtop(h);
+                r.x2 = GUI_MIN(l->clip.x2, r.x1 + guii_widget_getinnerwidth(h));
+                r.y2 = GUI_MIN(l->clip.y2, r.y1 + guii_widget_getinnerheight(h));
+                r.x1 = GUI_MAX(l->clip.x1, r.x1);
+                r.y1 = GUI_MAX(l->clip.y1, r.y1);
+                l++;
+                l->h = h;
+                l->clip = r;
+                l->dialogOnly = 0;
+                l->keyboard = kb;
+                h = gui_linkedlist_widgetgetprev((gui_handle_root_t *)h, NULL);
+                continue;
             }
         }
         
-        /* Check for keyboard mode */
-        if (guii_widget_getid(h) == GUI_ID_KEYBOARD_BASE) {
-            isKeyboard = 0;                         /* Set keyboard mode as 1 */
+        x = guii_widget_getabsolutex(h);
+        y = guii_widget_getabsolutey(h);
+        r.x1 = GUI_MAX(l->clip.x1, x);
+        r.y1 = GUI_MAX(l->clip.y1, y);
+        r.x2 = GUI_MIN(l->clip.x2, x + guii_widget_getwidth(h));
+        r.y2 = GUI_MIN(l->clip.y2, y + guii_widget_getheight(h));
+        if (r.x1 <= r.x2 && r.y1 <= r.y2) {         /* Widget is visible */
+            if (cnt < GUI.TouchIndex.size) {
+                e = &GUI.TouchIndex.entries[cnt];
+                e->h = h;
+                e->x1 = r.x1;
+                e->y1 = r.y1;
+                e->x2 = r.x2;
+                e->y2 = r.y2;
+                e->keyboard = kb;
+            }
+            cnt++;
         }
-        
-        if (tStat != touchCONTINUE) {               /* Return status if necessary */
-            return tStat;
+        h = gui_linkedlist_widgetgetprev(NULL, h);
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Build touch hit-test index from visible widgets
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+touch_index_build(void) {
+    gui_touch_index_t* idx = &GUI.TouchIndex;
+    gui_touch_index_entry_t* e;
+    gui_display_t area;
+    gui_dim_t cw, ch;
+    size_t cnt, items, i, cx, cy, cx1, cx2, cy1, cy2;
+    
+    area.x1 = 0;
+    area.y1 = 0;
+    area.x2 = GUI.lcd.width;
+    area.y2 = GUI.lcd.height;
+    
+    cnt = touch_index_collect(&area);
+    if (cnt > 0xFFFF) {                             /* Entries are referenced with 16-bit indexes */
+        return 0;
+    }
+    if (cnt > idx->size) {                          /* Not all entries could be written */
+        if (idx->entries != NULL) {
+            GUI_MEMFREE(idx->entries);
+        }
+        idx->size = 0;
+        GUI_MEM_TAGGED(GUI_MEM_TAG_TOUCH, idx->entries = GUI_MEMALLOC(sizeof(*idx->entries) * cnt));
+        if (idx->entries == NULL) {
+            return 0;
         }
+        idx->size = cnt;
+        cnt = touch_index_collect(&area);          /* Collect again to new memory */
     }
-    return touchCONTINUE;                           /* Try with another widget */
+    idx->count = cnt;
+    
+    /*
+     * Sort entries to grid cells.
+     *
+     * Count entries for each cell first, then fill cells in order of entries,
+     * so every cell keeps most visible widget first
+     */
+    cw = GUI_MAX(1, (GUI.lcd.width + GUI_CFG_TOUCH_INDEX_GRID - 1) / GUI_CFG_TOUCH_INDEX_GRID);
+    ch = GUI_MAX(1, (GUI.lcd.height + GUI_CFG_TOUCH_INDEX_GRID - 1) / GUI_CFG_TOUCH_INDEX_GRID);
+    memset(idx->cells, 0x00, sizeof(idx->cells));
+    items = 0;
+    for (i = 0, e = idx->entries; i < cnt; i++, e++) {
+        cx1 = touch_index_cell(e->x1, cw);
+        cx2 = touch_index_cell(e->x2, cw);
+        cy1 = touch_index_cell(e->y1, ch);
+        cy2 = touch_index_cell(e->y2, ch);
+        for (cy = cy1; cy <= cy2; cy++) {
+            for (cx = cx1; cx <= cx2; cx++) {
+                idx->cells[cy * GUI_CFG_TOUCH_INDEX_GRID + cx + 1]++;
+            }
+        }
+        items += (cx2 - cx1 + 1) * (cy2 - cy1 + 1);
+    }
+    if (items > 0xFFFF) {                           /* Cells are 16-bit offsets */
+        return 0;
+    }
+    if (items > idx->items_size) {
+        if (idx->items != NULL) {
+            GUI_MEMFREE(idx->items);
+        }
+        idx->items_size = 0;
+        GUI_MEM_TAGGED(GUI_MEM_TAG_TOUCH, idx->items = GUI_MEMALLOC(sizeof(*idx->items) * items));
+        if (idx->items == NULL) {
+            return 0;
+        }
+        idx->items_size = items;
+    }
+    for (i = 1; i < GUI_COUNT_OF(idx->cells); i++) {/* Convert counts to start offsets */
+        idx->cells[i] += idx->cells[i - 1];
+    }
+    for (i = 0, e = idx->entries; i < cnt; i++, e++) {
+        cx1 = touch_index_cell(e->x1, cw);
+        cx2 = touch_index_cell(e->x2, cw);
+        cy1 = touch_index_cell(e->y1, ch);
+        cy2 = touch_index_cell(e->y2, ch);
+        for (cy = cy1; cy <= cy2; cy++) {
+            for (cx = cx1; cx <= cx2; cx++) {
+                idx->items[idx->cells[cy * GUI_CFG_TOUCH_INDEX_GRID + cx]++] = (uint16_t)i;
+            }
+        }
+    }
+    /* Each cell start was moved to start of next cell, move them back */
+    memmove(&idx->cells[1], &idx->cells[0], sizeof(idx->cells) - sizeof(idx->cells[0]));
+    idx->cells[0] = 0;
+    return 1;
+}
+
+/**
+ * \brief           Find most visible widget on touch position with touch index
+ * \param[in]       x: Touch X position on screen
+ * \param[in]       y: Touch Y position on screen
+ * \return          Index entry of widget on success, `NULL` otherwise
+ */
+static gui_touch_index_entry_t*
+touch_index_find(gui_dim_t x, gui_dim_t y) {
+    gui_touch_index_t* idx = &GUI.TouchIndex;
+    gui_touch_index_entry_t* e;
+    gui_dim_t cw, ch;
+    size_t c, i;
+    
+    cw = GUI_MAX(1, (GUI.lcd.width + GUI_CFG_TOUCH_INDEX_GRID - 1) / GUI_CFG_TOUCH_INDEX_GRID);
+    ch = GUI_MAX(1, (GUI.lcd.height + GUI_CFG_TOUCH_INDEX_GRID - 1) / GUI_CFG_TOUCH_INDEX_GRID);
+    c = touch_index_cell(y, ch) * GUI_CFG_TOUCH_INDEX_GRID + touch_index_cell(x, cw);
+    for (i = idx->cells[c]; i < idx->cells[c + 1]; i++) {
+        e = &idx->entries[idx->items[i]];
+        if (x >= e->x1 && x <= e->x2 && y >= e->y1 && y <= e->y2) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Rebuild touch index when widgets changed since it was built
+ * \return          `1` when index is valid, `0` otherwise
+ */
+static uint8_t
+touch_index_update(void) {
+    gui_touch_index_t* idx = &GUI.TouchIndex;
+    
+    if (!idx->valid || idx->geometry_gen != GUI.GeometryGen || idx->tree_gen != GUI.TreeGen) {
+        idx->valid = touch_index_build();           /* Rebuild index of visible widgets */
+        idx->geometry_gen = GUI.GeometryGen;
+        idx->tree_gen = GUI.TreeGen;
+    }
+    return idx->valid;
 }
+#endif /* GUI_CFG_TOUCH_INDEX_GRID || __DOXYGEN__ */
 
-#define __ProcessAfterTouchEventsThread() do {\
+/**
+ * \brief           Find widget on touch down position and start touch on it
+ * \note            Touch index is used when available and rebuilt only
+ *                  when widgets changed since last touch
+ * \param[in]       touch: Touch data info
+ */
+static void
+process_touch_down(guii_touch_data_t* touch) {
+#if GUI_CFG_TOUCH_INDEX_GRID
+    gui_touch_index_entry_t* e;
+    
+    if (touch_index_update()) {
+        e = touch_index_find(touch->ts.x[0], touch->ts.y[0]);
+        if (e != NULL) {
+            touch_start(touch, e->h, e->keyboard);
+        }
+        return;
+    }
+#endif /* GUI_CFG_TOUCH_INDEX_GRID */
+    guii_trace_begin(GUI_TRACE_TYPE_TOUCH, 0, NULL, 0);
+    process_touch(touch);                           /* Walk complete widget tree */
+    guii_trace_end(GUI_TRACE_TYPE_TOUCH, 0, NULL, 0);
+}
+
+#define __ProcessAfterTouchEventsThread(h, touch) do {\
     if (rresult != 0) {                             /* Valid event occurred */\
         uint8_t ret;                                \
-        GUI_WIDGET_PARAMTYPE_TOUCH(&param) = &GUI.Touch;    \
-        ret = guii_widget_callback(GUI.ActiveWidget, rresult, &param, NULL);\
+        GUI_WIDGET_PARAMTYPE_TOUCH(&param) = (touch);   \
+        ret = guii_widget_callback((h), rresult, &param, NULL);\
         if (rresult == GUI_WC_DblClick && !ret) {   /* If double click was not recorded, proceed with normal click again */\
-            guii_widget_callback(GUI.ActiveWidget, GUI_WC_Click, &param, NULL);    /* Check for normal click now */\
+            guii_widget_callback((h), GUI_WC_Click, &param, NULL);  /* Check for normal click now */\
         }\
     }\
 } while (0)
 
+#if GUI_CFG_USE_TOUCH_GESTURES || __DOXYGEN__
+
+/**
+ * \brief           Send recognized gesture to active widget
+ *
+ *                  When widget does not process gesture, it is sent to parent widgets
+ *
+ * \param[in]       evt: Gesture event, \ref GUI_WC_Swipe or \ref GUI_WC_Pinch
+ */
+static void
+process_gesture(gui_wc_t evt) {
+    gui_widget_param_t param = {0};
+    gui_handle_p h;
+    
+    GUI_WIDGET_PARAMTYPE_TOUCH(&param) = &GUI.Touch;
+    for (h = GUI.ActiveWidget; h != NULL; h = guii_widget_getparent(h)) {
+        if (guii_widget_callback(h, evt, &param, NULL)) {  /* Stop when gesture processed */
+            break;
+        }
+    }
+}
+
+#endif /* GUI_CFG_USE_TOUCH_GESTURES || __DOXYGEN__ */
+
+#if GUI_CFG_TOUCH_POINTERS || __DOXYGEN__
+
+/**
+ * \brief           Check if widget is the same as parent widget or one of its children
+ * \param[in]       h: Widget handle to check
+ * \param[in]       parent: Parent widget handle
+ * \return          `1` when widgets are related, `0` otherwise
+ */
+static uint8_t
+pointer_isrelated(gui_handle_p h, gui_handle_p parent) {
+    for (; h != NULL; h = guii_widget_getparent(h)) {
+        if (h == parent) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Process one sample of independent pointer
+ * \note            On press, widget of pointer must already be set by caller
+ * \param[in,out]   p: Touch pointer
+ * \param[in]       ts: Sample with one pressed point or released state
+ */
+static void
+pointer_process(guii_touch_pointer_t* p, const gui_touch_data_t* ts) {
+    gui_widget_param_t param = {0};
+    gui_widget_result_t result = {0};
+    gui_wc_t rresult;
+    
+    p->touch.ts = *ts;
+    if (p->h != NULL && p->touch.ts.status) {
+        set_relative_coordinate(&p->touch, 
+            guii_widget_getabsolutex(p->h), guii_widget_getabsolutey(p->h),
+            guii_widget_getwidth(p->h), guii_widget_getheight(p->h)
+        );
+    }
+    GUI_WIDGET_PARAMTYPE_TOUCH(&param) = &p->touch;
+    GUI_WIDGET_RESULTTYPE_TOUCH(&result) = touchCONTINUE;
+    if (p->touch.ts.status && !p->old.ts.status) {  /* Pointer pressed */
+        if (p->h != p->prev) {                      /* Double click only on the same widget */
+            PT_INIT(&p->touch.pt);
+        }
+        p->prev = p->h;
+        if (p->h != NULL) {
+            guii_widget_callback(p->h, GUI_WC_TouchStart, &param, &result);
+            guii_widget_movedowntree(p->h);
+            if (GUI_WIDGET_RESULTTYPE_TOUCH(&result) == touchHANDLEDNOFOCUS) {
+                p->h = NULL;                        /* Widget does not use touches, pointer is ignored until release */
+            } else {
+                guii_widget_setflag(p->h, GUI_FLAG_ACTIVE); /* Widget is active without taking main active widget */
+                guii_widget_callback(p->h, GUI_WC_ActiveIn, NULL, NULL);
+            }
+        }
+    } else if (p->touch.ts.status && p->h != NULL) {/* Pointer moved */
+        if (guii_widget_callback(p->h, GUI_WC_TouchMove, &param, &result)) {
+            guii_widget_setflag(p->h, GUI_FLAG_TOUCH_MOVE);
+        } else {
+            guii_widget_clrflag(p->h, GUI_FLAG_TOUCH_MOVE);
+        }
+    }
+    if (p->h != NULL) {
+        __TouchEvents_Thread(&p->touch, &p->old, 1, p->h, &rresult);
+        __ProcessAfterTouchEventsThread(p->h, &p->touch);
+    }
+    if (!p->touch.ts.status && p->h != NULL) {      /* Pointer released */
+        GUI_WIDGET_RESULTTYPE_TOUCH(&result) = touchCONTINUE;
+        guii_widget_callback(p->h, GUI_WC_TouchEnd, &param, &result);
+        guii_widget_callback(p->h, GUI_WC_ActiveOut, NULL, NULL);
+        guii_widget_clrflag(p->h, GUI_FLAG_ACTIVE | GUI_FLAG_TOUCH_MOVE);
+        p->h = NULL;
+    }
+    memcpy(&p->old, &p->touch, sizeof(p->touch));
+}
+
+/**
+ * \brief           Split touch sample to points of first touch and independent pointers
+ *
+ *                  Points are matched to points of previous sample, shortest distance first.
+ *                  Unmatched previous point of pointer releases pointer.
+ *                  New point pressed on widget not related to active widget of first touch
+ *                  starts free pointer, other new points stay with first touch
+ *
+ * \param[in,out]   ts: Touch sample to split, only points of first touch are kept
+ */
+static void
+pointer_split(gui_touch_data_t* ts) {
+    gui_touch_data_t* old = &GUI.TouchOld.ts;
+    gui_touch_data_t m, ps;
+    gui_touch_index_entry_t* e;
+    guii_touch_pointer_t* p;
+    gui_handle_p mw = NULL;
+    gui_dim_t tx[2 * GUI_CFG_TOUCH_MAX_PRESSES], ty[2 * GUI_CFG_TOUCH_MAX_PRESSES];
+    int8_t tpoint[2 * GUI_CFG_TOUCH_MAX_PRESSES];   /* Sample point assigned to previous point */
+    int8_t owner[GUI_CFG_TOUCH_MAX_PRESSES];        /* Previous point assigned to sample point */
+    uint32_t d, best;
+    size_t mc, tc, i, j, bi, bj;
+    uint8_t mwvalid = 0;
+    
+    /* Previous points, first of first touch and then of pressed pointers */
+    mc = old->status ? old->count : 0;
+    for (tc = 0; tc < mc; tc++) {
+        tx[tc] = old->x[tc];
+        ty[tc] = old->y[tc];
+    }
+    for (i = 0; i < GUI_COUNT_OF(GUI.TouchPointers); i++) {
+        p = &GUI.TouchPointers[i];
+        if (p->old.ts.status) {
+            tx[tc] = p->old.ts.x[0];
+            ty[tc] = p->old.ts.y[0];
+            tc++;
+        }
+    }
+    memset(tpoint, 0xFF, sizeof(tpoint));
+    memset(owner, 0xFF, sizeof(owner));
+    
+    /* Match closest pairs first */
+    for (;;) {
+        best = 0xFFFFFFFF;
+        bi = bj = 0;
+        for (i = 0; i < tc; i++) {
+            if (tpoint[i] >= 0) {
+                continue;
+            }
+            for (j = 0; j < ts->count; j++) {
+                if (owner[j] >= 0) {
+                    continue;
+                }
+                d = (uint32_t)((int32_t)(tx[i] - ts->x[j]) * (tx[i] - ts->x[j]) + (int32_t)(ty[i] - ts->y[j]) * (ty[i] - ts->y[j]));
+                if (d < best) {
+                    best = d;
+                    bi = i;
+                    bj = j;
+                }
+            }
+        }
+        if (best == 0xFFFFFFFF) {                   /* No more pairs */
+            break;
+        }
+        tpoint[bi] = (int8_t)bj;
+        owner[bj] = (int8_t)bi;
+    }
+    
+    /* Points of first touch keep their order */
+    m = *ts;
+    m.count = 0;
+    for (i = 0; i < mc; i++) {
+        if (tpoint[i] >= 0) {
+            m.x[m.count] = ts->x[(size_t)tpoint[i]];
+            m.y[m.count] = ts->y[(size_t)tpoint[i]];
+            m.count++;
+        }
+    }
+    
+    /* Continue or release pressed pointers */
+    ps = *ts;
+    for (i = 0, j = mc; i < GUI_COUNT_OF(GUI.TouchPointers); i++) {
+        p = &GUI.TouchPointers[i];
+        if (p->old.ts.status) {
+            ps.count = tpoint[j] >= 0;
+            ps.status = ps.count ? GUI_TOUCH_STATE_PRESSED : GUI_TOUCH_STATE_RELEASED;
+            if (ps.count) {
+                ps.x[0] = ts->x[(size_t)tpoint[j]];
+                ps.y[0] = ts->y[(size_t)tpoint[j]];
+            }
+            pointer_process(p, &ps);
+            j++;
+        }
+    }
+    
+    /* New points start pointer or join first touch */
+    for (j = 0; j < ts->count; j++) {
+        if (owner[j] >= 0) {
+            continue;
+        }
+        if (!old->status && !m.count) {             /* First touch is released, new point starts it */
+            m.x[0] = ts->x[j];
+            m.y[0] = ts->y[j];
+            m.count = 1;
+            continue;
+        }
+        if (!mwvalid) {                             /* Find widget of first touch only when needed */
+            if (old->status) {
+                mw = GUI.ActiveWidget;
+            } else if (touch_index_update() && (e = touch_index_find(m.x[0], m.y[0])) != NULL) {
+                mw = e->h;
+            }
+            mwvalid = 1;
+        }
+        p = NULL;
+        e = touch_index_update() ? touch_index_find(ts->x[j], ts->y[j]) : NULL;
+        if (e != NULL && (mw == NULL || !pointer_isrelated(e->h, mw))) {
+            for (i = 0; i < GUI_COUNT_OF(GUI.TouchPointers); i++) {
+                if (!GUI.TouchPointers[i].old.ts.status) {
+                    p = &GUI.TouchPointers[i];
+                    break;
+                }
+            }
+        }
+        if (p != NULL) {                            /* Point is on unrelated widget */
+            ps.count = 1;
+            ps.status = GUI_TOUCH_STATE_PRESSED;
+            ps.x[0] = ts->x[j];
+            ps.y[0] = ts->y[j];
+            p->h = e->h;
+            pointer_process(p, &ps);
+        } else {
+            m.x[m.count] = ts->x[j];
+            m.y[m.count] = ts->y[j];
+            m.count++;
+        }
+    }
+    
+    m.status = m.count ? GUI_TOUCH_STATE_PRESSED : GUI_TOUCH_STATE_RELEASED;
+    *ts = m;
+    
+    GUI.TouchPointersPressed = 0;
+    for (i = 0; i < GUI_COUNT_OF(GUI.TouchPointers); i++) {
+        GUI.TouchPointersPressed += GUI.TouchPointers[i].old.ts.status != GUI_TOUCH_STATE_RELEASED;
+    }
+}
+
+#endif /* GUI_CFG_TOUCH_POINTERS || __DOXYGEN__ */
+
 /**
  * \brief           Process touch inputs
  * 
@@ -524,9 +1666,69 @@ gui_process_touch(void) {
     gui_widget_param_t param = {0};
     gui_widget_result_t result = {0};
     gui_wc_t rresult;
+#if GUI_CFG_TOUCH_POINTERS
+    size_t i;
+#endif /* GUI_CFG_TOUCH_POINTERS */
+#if GUI_CFG_TOUCH_MOVE_COALESCE
+    gui_touch_data_t next;
+#endif /* GUI_CFG_TOUCH_MOVE_COALESCE */
+#if GUI_CFG_USE_TOUCH_GESTURES
+    gui_wc_t gesture;
+#endif /* GUI_CFG_USE_TOUCH_GESTURES */
+#if GUI_CFG_STATS_LATENCY
+    uint32_t time;
+#endif /* GUI_CFG_STATS_LATENCY */
     
     if (gui_input_touchavailable()) {               /* Check if any touch available */
         while (gui_input_touchread(&GUI.Touch.ts)) {/* Process all touch events possible */
+#if GUI_CFG_IDLE_TIMEOUT
+            if (GUI.IdleTouchIgnore) {              /* Touch woke display up, skip it until released */
+                GUI.IdleTouchIgnore = GUI.Touch.ts.status != GUI_TOUCH_STATE_RELEASED;
+                continue;
+            }
+#endif /* GUI_CFG_IDLE_TIMEOUT */
+#if GUI_CFG_STATS_LATENCY
+            time = GUI.Touch.ts.time;               /* Merged move samples are measured from first one */
+#endif /* GUI_CFG_STATS_LATENCY */
+#if GUI_CFG_TOUCH_MOVE_COALESCE
+            /*
+             * Merge consecutive move samples with the same number of touches,
+             * widget receives only latest of them in current frame
+             */
+            GUI.Touch.coalesced = 0;
+            if (GUI.Touch.ts.status && GUI.TouchOld.ts.status && GUI.Touch.ts.count == GUI.TouchOld.ts.count
+#if GUI_CFG_TOUCH_POINTERS
+                && !GUI.TouchPointersPressed        /* Raw samples contain points of other pointers */
+#endif /* GUI_CFG_TOUCH_POINTERS */
+                ) {
+                while (gui_input_touchpeek(&next) && next.status && next.count == GUI.Touch.ts.count) {
+#if GUI_CFG_TOUCH_HISTORY_SIZE
+                    guii_input_touchhistoryadd(&GUI.Touch, &GUI.Touch.ts);  /* Keep merged position for velocity */
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE */
+                    gui_input_touchread(&GUI.Touch.ts);
+                    if (GUI.Touch.coalesced < 0xFF) {
+                        GUI.Touch.coalesced++;
+                    }
+                }
+            }
+#endif /* GUI_CFG_TOUCH_MOVE_COALESCE */
+#if GUI_CFG_TOUCH_POINTERS
+            if (GUI.Touch.ts.count > 1 || GUI.TouchPointersPressed) {
+                pointer_split(&GUI.Touch.ts);       /* Keep only points of first touch */
+            }
+#endif /* GUI_CFG_TOUCH_POINTERS */
+#if GUI_CFG_TOUCH_HISTORY_SIZE
+            if (GUI.Touch.ts.status) {              /* Record positions while touch is pressed */
+                if (!GUI.TouchOld.ts.status) {      /* New press starts new history */
+                    GUI.Touch.history_count = 0;
+                    GUI.Touch.history_index = 0;
+                }
+                guii_input_touchhistoryadd(&GUI.Touch, &GUI.Touch.ts);
+            }
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE */
+#if GUI_CFG_USE_TOUCH_GESTURES
+            gesture = guii_gesture_process(&GUI.Touch, &GUI.TouchOld);  /* Recognize gestures before widgets process sample */
+#endif /* GUI_CFG_USE_TOUCH_GESTURES */
             if (GUI.ActiveWidget && GUI.Touch.ts.status) {  /* Check active widget for touch and pressed status */
                 set_relative_coordinate(&GUI.Touch, /* Set relative touch (for widget) from current touch */
                     guii_widget_getabsolutex(GUI.ActiveWidget), guii_widget_getabsolutey(GUI.ActiveWidget), 
@@ -586,13 +1788,23 @@ gui_process_touch(void) {
                 }
             }
             
+#if GUI_CFG_USE_TOUCH_GESTURES
+            /**
+             * Gesture recognized on current sample,
+             * pinch during touch move or swipe before touch up
+             */
+            if (gesture && GUI.ActiveWidget) {
+                process_gesture(gesture);
+            }
+#endif /* GUI_CFG_USE_TOUCH_GESTURES */
+            
             /**
              * Old status: released
              * New status: pressed
              * Action: Touch down on element, find element
              */
             if (GUI.Touch.ts.status && !GUI.TouchOld.ts.status) {
-                process_touch(&GUI.Touch, NULL);
+                process_touch_down(&GUI.Touch);
                 if (GUI.ActiveWidget != GUI.ActiveWidgetPrev) { /* If new active widget is not the same as previous */
                     PT_INIT(&GUI.Touch.pt)          /* Reset thread, otherwise process with double click event */
                 }
@@ -602,8 +1814,8 @@ gui_process_touch(void) {
              * Periodical check for events on active widget
              */
             if (GUI.ActiveWidget) {
-                __TouchEvents_Thread(&GUI.Touch, &GUI.TouchOld, 1, &rresult);   /* Call thread for touch process */
-                __ProcessAfterTouchEventsThread();  /* Process after event macro */
+                __TouchEvents_Thread(&GUI.Touch, &GUI.TouchOld, 1, GUI.ActiveWidget, &rresult); /* Call thread for touch process */
+                __ProcessAfterTouchEventsThread(GUI.ActiveWidget, &GUI.Touch);  /* Process after event macro */
             }
             
             /**
@@ -621,10 +1833,26 @@ gui_process_touch(void) {
             }
             
             memcpy((void *)&GUI.TouchOld, (void *)&GUI.Touch, sizeof(GUI.Touch));   /* Copy current touch to last touch status */
+#if GUI_CFG_STATS_LATENCY
+            if (!GUI.Latency.input_valid && (GUI.flags & GUI_FLAG_REDRAW)) {   /* Measure sample until its result is shown */
+                GUI.Latency.input_time = time;
+                GUI.Latency.input_valid = 1;
+            }
+#endif /* GUI_CFG_STATS_LATENCY */
         }
-    } else {                                        /* No new touch events, periodically call touch event thread */
-        __TouchEvents_Thread(&GUI.Touch, &GUI.TouchOld, 0, &rresult);   /* Call thread for touch process periodically, handle long presses or timeouts */
-        __ProcessAfterTouchEventsThread();          /* Process after event macro */
+    } else if (GUI.TouchTimer == NULL || GUI.TouchTimeout) {  /* No new touch events, check timeouts when deadline passed */
+        GUI.TouchTimeout = 0;
+        __TouchEvents_Thread(&GUI.Touch, &GUI.TouchOld, 0, GUI.ActiveWidget, &rresult); /* Call thread for touch process, handle long presses or timeouts */
+        __ProcessAfterTouchEventsThread(GUI.ActiveWidget, &GUI.Touch);  /* Process after event macro */
+#if GUI_CFG_TOUCH_POINTERS
+        for (i = 0; i < GUI_COUNT_OF(GUI.TouchPointers); i++) {
+            guii_touch_pointer_t* p = &GUI.TouchPointers[i];
+            __TouchEvents_Thread(&p->touch, &p->old, 0, p->h, &rresult);   /* Long press and double click timeout */
+            if (p->h != NULL) {
+                __ProcessAfterTouchEventsThread(p->h, &p->touch);
+            }
+        }
+#endif /* GUI_CFG_TOUCH_POINTERS */
     }
 }
 #endif /* GUI_CFG_USE_TOUCH */
@@ -673,97 +1901,923 @@ process_keyboard(void) {
 }
 #endif /* GUI_CFG_USE_KEYBOARD || __DOXYGEN__ */
 
+#if GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__
 /**
- * \brief           Process redraw of all widgets
+ * \brief           Outline redrawn regions of last frames on drawing layer
+ * \note            Regions outlined in previous frames are repainted first, so their outlines
+ *                  can be drawn again with faded color and outlines of oldest frame disappear
  */
 static void
-process_redraw(void) {
-    gui_layer_t* active = GUI.lcd.active_layer;
-    gui_layer_t* drawing = GUI.lcd.drawing_layer;
-    uint8_t result = 1;
-    gui_display_t* dispA = &active->display;
+overlay_process(void) {
+    gui_display_t rects[GUI_CFG_DISPLAY_DIRTY_RECTS];
+    gui_display_t disp;
+    gui_display_t* r;
+    gui_handle_p h;
+    size_t cnt = 0, i, k, slot;
+    uint32_t c;
     
-    if ((GUI.lcd.flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM) || !(GUI.flags & GUI_FLAG_REDRAW)) {  /* Check if anything to draw first */
-        return;
+    /* Collect regions of all remembered frames */
+    for (k = 0; k < GUI_CFG_DEBUG_OVERLAY_FRAMES; k++) {
+        for (i = 0; i < GUI.OverlayRectsCount[k]; i++) {
+            r = &GUI.OverlayRects[k][i];
+            guii_widget_addrect(rects, &cnt, GUI_COUNT_OF(rects), r->x1, r->y1, r->x2, r->y2);
+        }
     }
     
-    GUI.flags &= ~GUI_FLAG_REDRAW;                  /* Clear redraw flag */
-    
-    /* Copy from currently active layer to drawing layer only changes on layer */
-    GUI.ll.Copy(&GUI.lcd, drawing, 
-        (void *)(active->start_address + GUI.lcd.pixel_size * (dispA->y1 * active->width + dispA->x1)), /* Source address */
-        (void *)(drawing->start_address + GUI.lcd.pixel_size * (dispA->y1 * drawing->width + dispA->x1)),   /* Destination address */
-        dispA->x2 - dispA->x1,                      /* Area width */
-        dispA->y2 - dispA->y1,                      /* Area height */
-        active->width - (dispA->x2 - dispA->x1),    /* Offline source */
-        drawing->width - (dispA->x2 - dispA->x1)    /* Offline destination */
-    );
-    
-    redraw_widgets(NULL);                           /* Redraw all widgets now on drawing layer */
-    drawing->pending = 1;                           /* Set drawing layer as pending */
-    
-    /* Notify low-level about layer change */
-    GUI.lcd.flags |= GUI_FLAG_LCD_WAIT_LAYER_CONFIRM;
-    gui_ll_control(&GUI.lcd, GUI_LL_Command_SetActiveLayer, &drawing, &result); /* Set new active layer to low-level driver */
-    
-    /* Swap active and drawing layers */
-    /* New drawings won't be affected until confirmation from low-level is not received */
-    GUI.lcd.active_layer = drawing;
-    GUI.lcd.drawing_layer = active;
+    /* Regions of current frame replace regions of oldest frame */
+    GUI.OverlayFrame = (GUI.OverlayFrame + 1) % GUI_CFG_DEBUG_OVERLAY_FRAMES;
+    memcpy(GUI.OverlayRects[GUI.OverlayFrame], GUI.DirtyRects, sizeof(GUI.DirtyRects[0]) * GUI.DirtyRectsCount);
+    GUI.OverlayRectsCount[GUI.OverlayFrame] = GUI.DirtyRectsCount;
     
-    memcpy(&GUI.lcd.active_layer->display, &GUI.Display, sizeof(GUI.Display));  /* Copy clipping data to region */
+    /* Repaint old outlines with all widgets below them */
+    GUI.OverlayPass = 1;
+    for (i = 0; i < cnt; i++) {
+        r = &rects[i];
+        guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS, r->x1, r->y1, r->x2, r->y2);
+        memcpy(&GUI.Display, r, sizeof(GUI.Display));
+        for (h = gui_linkedlist_widgetgetnext(NULL, NULL); h != NULL; h = gui_linkedlist_widgetgetnext(NULL, h)) {
+            if (guii_widget_isinsideclippingregion(h)) {
+                guii_widget_setflag(h, GUI_FLAG_REDRAW);    /* Children are set by redraw */
+            }
+        }
+        redraw_widgets(1);
+    }
+    GUI.OverlayPass = 0;
     
-    /* Invalid clipping region(s) for next drawing process */
-    GUI.Display.x1 = 0x7FFF;
-    GUI.Display.y1 = 0x7FFF;
-    GUI.Display.x2 = 0x8000;
-    GUI.Display.y2 = 0x8000;
+    /* Draw outlines from oldest to newest frame */
+    disp.x1 = 0;
+    disp.y1 = 0;
+    disp.x2 = GUI.lcd.width;
+    disp.y2 = GUI.lcd.height;
+    for (k = 1; k <= GUI_CFG_DEBUG_OVERLAY_FRAMES; k++) {
+        slot = (GUI.OverlayFrame + k) % GUI_CFG_DEBUG_OVERLAY_FRAMES;
+        c = 0xFF - (GUI_CFG_DEBUG_OVERLAY_FRAMES - k) * 0xC0 / GUI_CFG_DEBUG_OVERLAY_FRAMES;  /* Older frames are darker */
+        for (i = 0; i < GUI.OverlayRectsCount[slot]; i++) {
+            r = &GUI.OverlayRects[slot][i];
+            gui_draw_rectangle(&disp, r->x1, r->y1, r->x2 - r->x1, r->y2 - r->y1, 0xFF000000UL | (c << 16));
+        }
+    }
 }
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__ */
 
+#if GUI_CFG_LCD_BAND || __DOXYGEN__
 /**
- * \brief           Default global callback function
+ * \brief           Get next free band buffer for drawing
+ * \note            Function waits until low-level finished transfer of band previously drawn to this buffer
+ * \return          Band layer to draw to
  */
-static void
-default_event_cb(void) {
-
+static gui_layer_t*
+band_get(void) {
+    gui_layer_t* band = &GUI.Band[GUI.BandIdx];
+#if GUI_CFG_USE_STATS
+    uint32_t t = GUI_CFG_STATS_TIME();
+#endif /* GUI_CFG_USE_STATS */
+    
+    GUI.BandIdx = !GUI.BandIdx;                     /* Alternate buffers */
+    guii_trace_begin(GUI_TRACE_TYPE_WAIT, 0, NULL, 0);
+    while (band->pending) {}                        /* Wait for previous transfer from this buffer */
+    guii_trace_end(GUI_TRACE_TYPE_WAIT, 0, NULL, 0);
+#if GUI_CFG_USE_STATS
+    GUI.StatsFrame.time_wait += GUI_CFG_STATS_TIME() - t;
+#endif /* GUI_CFG_USE_STATS */
+    return band;
 }
 
-#if GUI_CFG_OS || __DOXYGEN__
 /**
- * \brief           GUI main thread for RTOS
- * \param[in]       argument: Pointer to user specific argument
+ * \brief           Send drawn band to display
+ * \param[in]       band: Band layer with position and size set
+ * \param[in]       last: Set to `1` when band is last one of frame
  */
 static void
-gui_thread(void * const argument) {
-    while (1) {
-        gui_process();                              /* Process graphical update */
+band_flush(gui_layer_t* band, uint8_t last) {
+    gui_ll_flush_t flush;
+    uint8_t result = 1;
+    
+    guii_ll_waitready();                            /* Drawing must be finished before transfer */
+    flush.band = band;
+    flush.last = last;
+    band->pending = 1;
+    if (!gui_ll_control(&GUI.lcd, GUI_LL_Command_Flush, &flush, &result) || result) {
+        band->pending = 0;                          /* Transfer did not start, buffer is free */
     }
 }
-#endif /* GUI_CFG_OS || __DOXYGEN__ */
 
 /**
- * \brief           Initializes GUI stack.
- *                    In addition, it prepares memory for work with widgets on later usage and
- *                    calls low-layer functions to initialize LCD or custom driver for LCD
- * \return          Member of \ref guir_t enumeration
+ * \brief           Redraw dirty regions band by band
+ *
+ *                  Each region is split to bands fitting to band buffer, widgets are drawn to band
+ *                  and band is sent to display while next one is drawn to other buffer
+ *
+ * \return          Number of widgets redrawn
  */
-guir_t
-gui_init(void) {
-    uint8_t result;
-    
-    memset((void *)&GUI, 0x00, sizeof(GUI));        /* Reset GUI structure */
-    
-    gui_seteventcallback(NULL);                     /* Set event callback */
+static uint32_t
+band_redraw(void) {
+    const gui_display_t* r;
+    gui_layer_t* band;
+    gui_dim_t x, y, w, h;
+    uint32_t cnt = 0;
+    uint8_t last;
+    size_t i, max = GUI_CFG_LCD_BAND_SIZE / GUI.Band[0].pixel_size;
     
-#if GUI_CFG_OS
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {
+        r = &GUI.DirtyRects[i];
+        if (r->x2 <= r->x1 || r->y2 <= r->y1) {
+            continue;
+        }
+        w = GUI_MIN(r->x2 - r->x1, (gui_dim_t)max); /* Use complete lines when they fit to buffer */
+        h = (gui_dim_t)(max / (size_t)w);
+        for (y = r->y1; y < r->y2; y += h) {
+            for (x = r->x1; x < r->x2; x += w) {
+                last = i == GUI.DirtyRectsCount - 1 && y + h >= r->y2 && x + w >= r->x2;
+                
+                band = band_get();
+                band->x_offset = x;
+                band->y_offset = y;
+                band->width = GUI_MIN(w, r->x2 - x);
+                band->height = GUI_MIN(h, r->y2 - y);
+                
+                GUI.Display.x1 = x;
+                GUI.Display.y1 = y;
+                GUI.Display.x2 = x + band->width;
+                GUI.Display.y2 = y + band->height;
+                GUI.lcd.drawing_layer = band;       /* Draw widgets to band buffer */
+                cnt += redraw_widgets(last);
+                band_flush(band, last);
+            }
+        }
+#if GUI_CFG_USE_STATS
+        GUI.StatsFrame.dirty_area += (uint32_t)(r->x2 - r->x1) * (uint32_t)(r->y2 - r->y1);
+#endif /* GUI_CFG_USE_STATS */
+    }
+    GUI.lcd.drawing_layer = GUI.lcd.active_layer;
+    return cnt;
+}
+#endif /* GUI_CFG_LCD_BAND || __DOXYGEN__ */
+
+#if GUI_CFG_LCD_TILE || __DOXYGEN__
+/**
+ * \brief           Redraw dirty regions tile by tile
+ *
+ *                  Each region is split to tiles of fixed grid, widgets are drawn to tile buffer
+ *                  and finished tile is copied to drawing layer with single low-level operation
+ *
+ * \param[in]       drawing: Drawing layer to copy tiles to
+ * \return          Number of widgets redrawn
+ */
+static uint32_t
+tile_redraw(gui_layer_t* drawing) {
+    const gui_display_t* r;
+    gui_layer_t* tile = &GUI.Tile;
+    gui_dim_t x, y, x2, y2, px, py, pw, ph;
+    uint32_t cnt = 0;
+    uint8_t last;
+    size_t i;
+    
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {
+        r = &GUI.DirtyRects[i];
+        for (y = r->y1; y < r->y2; y = y2) {
+            y2 = GUI_MIN(r->y2, (y / GUI_CFG_LCD_TILE_HEIGHT + 1) * GUI_CFG_LCD_TILE_HEIGHT);
+            for (x = r->x1; x < r->x2; x = x2) {
+                x2 = GUI_MIN(r->x2, (x / GUI_CFG_LCD_TILE_WIDTH + 1) * GUI_CFG_LCD_TILE_WIDTH);
+                last = i == GUI.DirtyRectsCount - 1 && y2 == r->y2 && x2 == r->x2;
+                
+                px = x;
+                py = y;
+                pw = x2 - x;
+                ph = y2 - y;
+#if GUI_CFG_LCD_ROTATION
+                guii_lcd_maprect(&px, &py, &pw, &ph);   /* Tile covers rectangle in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+                tile->num = drawing->num;
+                tile->x_offset = px;
+                tile->y_offset = py;
+                tile->width = pw;
+                tile->height = ph;
+                
+                GUI.Display.x1 = x;
+                GUI.Display.y1 = y;
+                GUI.Display.x2 = x2;
+                GUI.Display.y2 = y2;
+                GUI.lcd.drawing_layer = tile;       /* Draw widgets to tile buffer */
+                cnt += redraw_widgets(last);
+                GUI.lcd.drawing_layer = drawing;
+                GUI.ll.Copy(&GUI.lcd, drawing,
+                    (void *)tile->start_address,    /* Source address */
+                    (void *)(drawing->start_address + drawing->pixel_size * (py * drawing->width + px)),    /* Destination address */
+                    pw, ph,                         /* Area size */
+                    0,                              /* Offline source */
+                    drawing->width - pw             /* Offline destination */
+                );
+            }
+        }
+#if GUI_CFG_USE_STATS
+        GUI.StatsFrame.dirty_area += (uint32_t)(r->x2 - r->x1) * (uint32_t)(r->y2 - r->y1);
+#endif /* GUI_CFG_USE_STATS */
+    }
+    return cnt;
+}
+
+#if GUI_CFG_LCD_TILE_CORES > 1 || __DOXYGEN__
+/**
+ * \brief           Get index of next tile of shared job not drawn yet
+ * \param[out]      idx: Pointer to output tile index
+ * \return          `1` when tile is available, `0` otherwise
+ */
+static uint8_t
+tile_claim(uint32_t* idx) {
+    uint8_t result = 1, ret = 0;
+    
+    gui_ll_control(&GUI.lcd, GUI_LL_Command_CoreLock, NULL, &result);
+    if (tile_job.next < tile_job.count) {
+        *idx = tile_job.next++;
+        ret = 1;
+    }
+    gui_ll_control(&GUI.lcd, GUI_LL_Command_CoreUnlock, NULL, &result);
+    return ret;
+}
+
+/**
+ * \brief           Draw single tile of shared job from display list and copy it to drawing layer
+ * \note            Called by both cores
+ * \param[in]       idx: Tile index in all dirty regions
+ */
+static void
+tile_render(uint32_t idx) {
+    const gui_display_t* r = tile_job.rects;
+    gui_layer_t* tile = &GUI.Tile;
+    gui_layer_t* drawing = &tile_job.layer;
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    gui_display_t disp;
+    gui_dim_t cols, rows, x, y;
+    uint8_t result = 1;
+    
+    /* Find dirty region with tile, tiles are aligned to grid of whole screen */
+    for (;; r++) {
+        cols = (r->x2 - 1) / GUI_CFG_LCD_TILE_WIDTH - r->x1 / GUI_CFG_LCD_TILE_WIDTH + 1;
+        rows = (r->y2 - 1) / GUI_CFG_LCD_TILE_HEIGHT - r->y1 / GUI_CFG_LCD_TILE_HEIGHT + 1;
+        if (idx < (uint32_t)cols * (uint32_t)rows) {
+            break;
+        }
+        idx -= (uint32_t)cols * (uint32_t)rows;
+    }
+    x = (r->x1 / GUI_CFG_LCD_TILE_WIDTH + (gui_dim_t)(idx % cols)) * GUI_CFG_LCD_TILE_WIDTH;
+    y = (r->y1 / GUI_CFG_LCD_TILE_HEIGHT + (gui_dim_t)(idx / cols)) * GUI_CFG_LCD_TILE_HEIGHT;
+    disp.x1 = GUI_MAX(r->x1, x);
+    disp.y1 = GUI_MAX(r->y1, y);
+    disp.x2 = GUI_MIN(r->x2, x + GUI_CFG_LCD_TILE_WIDTH);
+    disp.y2 = GUI_MIN(r->y2, y + GUI_CFG_LCD_TILE_HEIGHT);
+    
+    tile->num = drawing->num;
+    tile->x_offset = disp.x1;
+    tile->y_offset = disp.y1;
+    tile->width = disp.x2 - disp.x1;
+    tile->height = disp.y2 - disp.y1;
+    tile->pixel_format = drawing->pixel_format;
+    tile->pixel_size = drawing->pixel_size;
+    
+    GUI.lcd.drawing_layer = tile;                   /* Replay commands to tile buffer */
+    guii_draw_dlist_replay(&tile_job.list, &disp);
+    GUI.lcd.drawing_layer = layer;
+    GUI.ll.Copy(&GUI.lcd, drawing,
+        (void *)tile->start_address,                /* Source address */
+        (void *)(drawing->start_address + drawing->pixel_size * (disp.y1 * drawing->width + disp.x1)),  /* Destination address */
+        tile->width, tile->height,                  /* Area size */
+        0,                                          /* Offline source */
+        drawing->width - tile->width                /* Offline destination */
+    );
+    guii_ll_waitready();                            /* Tile is finished only when copy is done */
+    
+    gui_ll_control(&GUI.lcd, GUI_LL_Command_CoreLock, NULL, &result);
+    tile_job.done++;
+    gui_ll_control(&GUI.lcd, GUI_LL_Command_CoreUnlock, NULL, &result);
+}
+
+/**
+ * \brief           Record widgets of dirty regions once and draw tiles together with second core
+ * \param[in]       drawing: Layer to copy finished tiles to
+ * \return          Number of widgets redrawn
+ */
+static uint32_t
+tile_redraw_shared(gui_layer_t* drawing) {
+    const gui_display_t* r;
+    uint32_t cnt = 0, count = 0, idx;
+    uint8_t result = 1;
+    size_t i;
+    
+    tile_job.list.detached = 1;                     /* Second core has no access to widgets */
+    guii_draw_dlist_begin(&tile_job.list);
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {
+        r = &GUI.DirtyRects[i];
+        memcpy(&GUI.Display, r, sizeof(GUI.Display));
+        cnt += redraw_widgets(i == GUI.DirtyRectsCount - 1);
+        count += (uint32_t)((r->x2 - 1) / GUI_CFG_LCD_TILE_WIDTH - r->x1 / GUI_CFG_LCD_TILE_WIDTH + 1)
+            * (uint32_t)((r->y2 - 1) / GUI_CFG_LCD_TILE_HEIGHT - r->y1 / GUI_CFG_LCD_TILE_HEIGHT + 1);
+#if GUI_CFG_USE_STATS
+        GUI.StatsFrame.dirty_area += (uint32_t)(r->x2 - r->x1) * (uint32_t)(r->y2 - r->y1);
+#endif /* GUI_CFG_USE_STATS */
+    }
+    if (!guii_draw_dlist_end()) {                   /* Out of memory for list, draw on main core only */
+#if GUI_CFG_USE_STATS
+        GUI.StatsFrame.dirty_area = 0;
+#endif /* GUI_CFG_USE_STATS */
+        return tile_redraw(drawing);
+    }
+    
+    /* Publish job, second core starts claiming tiles after lock is released */
+    gui_ll_control(&GUI.lcd, GUI_LL_Command_CoreLock, NULL, &result);
+    memcpy(tile_job.rects, GUI.DirtyRects, sizeof(GUI.DirtyRects[0]) * GUI.DirtyRectsCount);
+    tile_job.rects_count = GUI.DirtyRectsCount;
+    tile_job.layer = *drawing;
+    tile_job.next = 0;
+    tile_job.done = 0;
+    tile_job.count = count;
+    gui_ll_control(&GUI.lcd, GUI_LL_Command_CoreUnlock, NULL, &result);
+    
+    while (tile_claim(&idx)) {                      /* Draw tiles until all are taken */
+        tile_render(idx);
+    }
+    while (tile_job.done < count) {}                /* Wait for tiles of second core */
+    return cnt;
+}
+
+/**
+ * \brief           Initialize drawing of shared tiles on second core
+ * \note            Called on second core instead of \ref gui_init.
+ *                  Low-level driver of second core sets drawing functions and LCD parameters only,
+ *                  display hardware is initialized by main core
+ * \return          Member of \ref guir_t enumeration
+ */
+guir_t
+gui_tile_init(void) {
+    uint8_t result = 1;
+    
+    memset((void *)&GUI, 0x00, sizeof(GUI));        /* Reset GUI structure */
+    gui_ll_control(&GUI.lcd, GUI_LL_Command_Init, &GUI.ll, &result);
+#if GUI_CFG_LL_SOFTWARE
+    guii_lcd_setsoftwaredrawing(&GUI.ll);           /* Use software drawing where driver has no function */
+#endif /* GUI_CFG_LL_SOFTWARE */
+    if (result || GUI.ll.Copy == NULL) {
+        return guiERROR;
+    }
+    GUI.Tile.start_address = (uintptr_t)tile_mem;  /* Each core draws to own tile buffer */
+    GUI.Initialized = 1;
+    return guiOK;
+}
+
+/**
+ * \brief           Draw tiles of current frame not taken by main core yet
+ * \note            Called periodically on second core after \ref gui_tile_init,
+ *                  for example when main core signals new frame with hardware semaphore interrupt
+ * \return          Number of tiles drawn in current call
+ */
+uint32_t
+gui_tile_process(void) {
+    uint32_t cnt = 0, idx;
+    
+    while (tile_claim(&idx)) {
+        tile_render(idx);
+        cnt++;
+    }
+    return cnt;
+}
+#endif /* GUI_CFG_LCD_TILE_CORES > 1 || __DOXYGEN__ */
+#endif /* GUI_CFG_LCD_TILE || __DOXYGEN__ */
+
+#if GUI_CFG_OS_RENDER_THREAD || __DOXYGEN__
+/**
+ * \brief           Record redraw of dirty regions to free frame and send it to rasterizer thread
+ *
+ *                  Drawing functions only add commands to frame display list,
+ *                  pixels are never accessed by GUI thread
+ *
+ * \return          Number of widgets redrawn
+ */
+static uint32_t
+frame_record(void) {
+    gui_frame_t* frame = &GUI.Frames[GUI.FrameIdx];
+    const gui_frame_t* prev = &GUI.Frames[!GUI.FrameIdx];
+    gui_handle_p h;
+    uint32_t cnt = 0;
+    size_t i;
+    
+    /* Regions of previous frame are on active layer when this frame is drawn */
+    frame->copy_count = 0;
+    for (i = 0; i < prev->rects_count; i++) {
+        if (!is_region_repainted(&prev->rects[i])) {
+            frame->copy[frame->copy_count++] = prev->rects[i];
+        }
+    }
+    
+    frame->list.detached = 1;                       /* Widgets may change before frame is drawn */
+    guii_draw_dlist_begin(&frame->list);
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {
+        memcpy(&GUI.Display, &GUI.DirtyRects[i], sizeof(GUI.Display));
+        cnt += redraw_widgets(i == GUI.DirtyRectsCount - 1);
+#if GUI_CFG_USE_STATS
+        GUI.StatsFrame.dirty_area += (uint32_t)(GUI.Display.x2 - GUI.Display.x1) * (uint32_t)(GUI.Display.y2 - GUI.Display.y1);
+#endif /* GUI_CFG_USE_STATS */
+    }
+#if GUI_CFG_USE_DEBUG_OVERLAY
+    if (GUI.Overlay) {
+        overlay_process();                          /* Adds its regions to dirty list */
+    }
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY */
+    if (!guii_draw_dlist_end()) {                   /* Not enough memory for all commands */
+        h = (gui_handle_p)gui_linkedlist_getnext_gen(&GUI.root, NULL);  /* Desktop window */
+        if (h != NULL) {
+            guii_widget_invalidate(h);              /* Record complete screen with next frame */
+        }
+        return cnt;
+    }
+    
+    memcpy(frame->rects, GUI.DirtyRects, sizeof(GUI.DirtyRects[0]) * GUI.DirtyRectsCount);
+    frame->rects_count = GUI.DirtyRectsCount;
+    frame->layer = NULL;
+    frame->busy = 1;
+    GUI.FrameIdx = !GUI.FrameIdx;
+    gui_sys_mbox_putnow(&GUI.OS.render_mbox, frame);    /* Send frame to rasterizer thread */
+    return cnt;
+}
+#endif /* GUI_CFG_OS_RENDER_THREAD || __DOXYGEN__ */
+
+#if GUI_CFG_IDLE_TIMEOUT || __DOXYGEN__
+/**
+ * \brief           Power display down after idle timeout and up again on activity
+ * \return          `1` when display is powered down and nothing should be processed, `0` otherwise
+ */
+static uint8_t
+idle_process(void) {
+    uint8_t active, result = 1, retained = 0;
+    uint32_t now = gui_sys_now();
+    gui_handle_p h;
+    
+    active = (GUI.flags & GUI_FLAG_REDRAW) != 0;
+#if GUI_CFG_USE_TOUCH
+    active = active || gui_input_touchavailable();
+#endif /* GUI_CFG_USE_TOUCH */
+#if GUI_CFG_USE_KEYBOARD
+    active = active || gui_input_keyavailable();
+#endif /* GUI_CFG_USE_KEYBOARD */
+    
+    if (GUI.PowerDown) {
+        if (!active) {
+            return 1;                               /* Keep sleeping */
+        }
+        gui_ll_control(&GUI.lcd, GUI_LL_Command_PowerUp, &retained, &result);
+        GUI.PowerDown = 0;
+        GUI.IdleTime = now;
+#if GUI_CFG_USE_TOUCH
+        GUI.IdleTouchIgnore = gui_input_touchavailable();   /* Waking touch is not a click */
+#endif /* GUI_CFG_USE_TOUCH */
+        if (!retained) {                            /* Display memory lost its content */
+            h = (gui_handle_p)gui_linkedlist_getnext_gen(&GUI.root, NULL);  /* Desktop window */
+            if (h != NULL) {
+                guii_widget_invalidate(h);
+            }
+        }
+        return 0;
+    }
+    if (active || (GUI.lcd.flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM)) {
+        GUI.IdleTime = now;
+    } else if ((now - GUI.IdleTime) >= GUI_CFG_IDLE_TIMEOUT) {
+        guii_ll_waitready();                        /* Last frame is finished before clocks stop */
+        gui_ll_control(&GUI.lcd, GUI_LL_Command_PowerDown, NULL, &result);
+        GUI.PowerDown = 1;
+        return 1;
+    }
+    return 0;
+}
+#endif /* GUI_CFG_IDLE_TIMEOUT || __DOXYGEN__ */
+
+#if GUI_CFG_FRAME_PERIOD || __DOXYGEN__
+/**
+ * \brief           Check if frame period passed since last redraw
+ * \param[out]      wait: Pointer to save time until next frame in units of milliseconds
+ * \return          `1` when new frame may be drawn, `0` otherwise
+ */
+static uint8_t
+frame_ready(uint32_t* wait) {
+    uint32_t elapsed = gui_sys_now() - GUI.FrameTime;
+    
+    if (elapsed >= GUI.FramePeriod) {
+        *wait = 0;
+        return 1;
+    }
+    *wait = GUI.FramePeriod - elapsed;
+    return 0;
+}
+
+/**
+ * \brief           Adapt frame period to time needed for last redraw
+ * \param[in]       duration: Redraw time of last frame in units of milliseconds
+ */
+static void
+frame_adapt(uint32_t duration) {
+    if (GUI.FramePeriodMax <= GUI.FramePeriodMin) {
+        return;
+    }
+    if (duration * 2 > GUI.FramePeriod) {           /* Redraw uses more than half of period */
+        GUI.FramePeriod = GUI_MIN(GUI.FramePeriod + GUI.FramePeriod / 2 + 1, GUI.FramePeriodMax);
+    } else if (duration * 4 < GUI.FramePeriod) {    /* Enough time left, slowly return to faster rate */
+        GUI.FramePeriod = GUI_MAX(GUI.FramePeriod - GUI.FramePeriod / 8 - 1, GUI.FramePeriodMin);
+    }
+}
+#endif /* GUI_CFG_FRAME_PERIOD || __DOXYGEN__ */
+
+#if GUI_CFG_REDRAW_BUDGET || __DOXYGEN__
+
+/**
+ * \brief           Check if dirty region contains part of widget
+ * \param[in]       r: Dirty region
+ * \param[in]       h: Widget handle or `NULL`
+ * \return          `1` if region contains part of widget, `0` otherwise
+ */
+static uint8_t
+budget_haswidget(const gui_display_t* r, gui_handle_p h) {
+    gui_dim_t x, y;
+    
+    if (h == NULL || !guii_widget_isvisible(h)) {
+        return 0;
+    }
+    x = guii_widget_getabsolutex(h);
+    y = guii_widget_getabsolutey(h);
+    return __GUI_RECT_MATCH(r->x1, r->y1, r->x2, r->y2, x, y, x + guii_widget_getwidth(h), y + guii_widget_getheight(h));
+}
+
+/**
+ * \brief           Sort dirty regions in order they are drawn with time budget
+ * \note            Regions with focused or touched widget are first, other regions follow from smallest to biggest
+ */
+static void
+budget_sort(void) {
+    gui_display_t tmp;
+    uint32_t prio[GUI_CFG_DISPLAY_DIRTY_RECTS], p;
+    size_t i, j;
+    
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {     /* Insertion sort, number of regions is small */
+        tmp = GUI.DirtyRects[i];
+        if (budget_haswidget(&tmp, GUI.FocusedWidget) || budget_haswidget(&tmp, GUI.ActiveWidget)) {
+            p = 0;                                  /* Feedback of input is shown first */
+        } else {
+            p = (uint32_t)(tmp.x2 - tmp.x1) * (uint32_t)(tmp.y2 - tmp.y1);
+        }
+        for (j = i; j > 0 && prio[j - 1] > p; j--) {
+            prio[j] = prio[j - 1];
+            GUI.DirtyRects[j] = GUI.DirtyRects[j - 1];
+        }
+        prio[j] = p;
+        GUI.DirtyRects[j] = tmp;
+    }
+}
+
+/**
+ * \brief           Redraw dirty regions strip by strip until time budget is spent
+ * \note            At least one strip is drawn in every frame. On return, dirty regions
+ *                  contain only parts drawn in this frame
+ * \param[out]      rest: Regions not drawn in this frame
+ * \param[out]      rest_count: Number of valid entries in `rest`
+ * \return          Number of widgets redrawn
+ */
+static uint32_t
+budget_redraw(gui_display_t* rest, size_t* rest_count) {
+    uint32_t start = gui_sys_now(), cnt = 0;
+    gui_display_t* r;
+    gui_dim_t y;
+    size_t i;
+    
+    *rest_count = 0;
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {
+        r = &GUI.DirtyRects[i];
+        for (y = r->y1; y < r->y2; y = GUI.Display.y2) {
+            if ((i || y != r->y1) && (uint32_t)(gui_sys_now() - start) >= GUI_CFG_REDRAW_BUDGET) {
+                rest[0] = *r;                       /* Rest of current region and all next regions */
+                rest[0].y1 = y;
+                memcpy(&rest[1], &GUI.DirtyRects[i + 1], sizeof(rest[0]) * (GUI.DirtyRectsCount - i - 1));
+                *rest_count = GUI.DirtyRectsCount - i;
+                r->y2 = y;                          /* Drawn part of current region */
+                GUI.DirtyRectsCount = i + (y != r->y1);
+                return cnt;
+            }
+            GUI.Display = *r;
+            GUI.Display.y1 = y;
+            GUI.Display.y2 = GUI_MIN(y + GUI_CFG_REDRAW_BUDGET_LINES, r->y2);
+            cnt += redraw_widgets(i == GUI.DirtyRectsCount - 1 && GUI.Display.y2 == r->y2);
+#if GUI_CFG_USE_STATS
+            GUI.StatsFrame.dirty_area += (uint32_t)(GUI.Display.x2 - GUI.Display.x1) * (uint32_t)(GUI.Display.y2 - GUI.Display.y1);
+#endif /* GUI_CFG_USE_STATS */
+        }
+    }
+    return cnt;
+}
+
+#endif /* GUI_CFG_REDRAW_BUDGET || __DOXYGEN__ */
+
+/**
+ * \brief           Process redraw of all widgets
+ * \return          Number of widgets redrawn
+ */
+static uint32_t
+process_redraw(void) {
+    gui_layer_t* active = GUI.lcd.active_layer;
+    gui_layer_t* drawing = GUI.lcd.drawing_layer;
+    uint8_t result = 1;
+    gui_display_t* dispA;
+    uint32_t cnt = 0;
+    size_t i;
+#if GUI_CFG_FRAME_PERIOD
+    uint32_t wait;
+#endif /* GUI_CFG_FRAME_PERIOD */
+#if !GUI_CFG_LCD_BAND && !GUI_CFG_OS_RENDER_THREAD
+    gui_display_t copy[GUI_CFG_DISPLAY_DIRTY_RECTS];
+    size_t copy_count = 0;
+#endif /* !GUI_CFG_LCD_BAND && !GUI_CFG_OS_RENDER_THREAD */
+#if GUI_CFG_REDRAW_BUDGET
+    gui_display_t rest[GUI_CFG_DISPLAY_DIRTY_RECTS];
+    size_t rest_count = 0;
+#endif /* GUI_CFG_REDRAW_BUDGET */
+    
+#if GUI_CFG_OS_RENDER_THREAD
+    if (GUI.Frames[GUI.FrameIdx].busy || !(GUI.flags & GUI_FLAG_REDRAW)) {  /* Wait for free frame, rasterizer thread wakes GUI thread */
+        return 0;
+    }
+#else /* GUI_CFG_OS_RENDER_THREAD */
+    if ((GUI.lcd.flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM) || !(GUI.flags & GUI_FLAG_REDRAW)) {  /* Check if anything to draw first */
+        return 0;
+    }
+#endif /* !GUI_CFG_OS_RENDER_THREAD */
+#if GUI_CFG_FRAME_PERIOD
+    if (!frame_ready(&wait)) {                      /* Invalidations are collected until next frame */
+        return 0;
+    }
+    GUI.FrameTime = gui_sys_now();
+#endif /* GUI_CFG_FRAME_PERIOD */
+    
+    guii_widget_processinvalidated();               /* Resolve all invalidations of this frame once */
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE
+    guii_widget_processscrolled();                  /* Add exposed parts of scrolled widgets */
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE */
+#if GUI_CFG_USE_TRANSITION
+    guii_transition_prepare(active);                /* Transition area is composed, not copied from last frame */
+#endif /* GUI_CFG_USE_TRANSITION */
+    
+    GUI.flags &= ~GUI_FLAG_REDRAW;                  /* Clear redraw flag */
+    
+#if GUI_CFG_LCD_BAND
+    GUI_UNUSED3(active, drawing, dispA);
+    GUI_UNUSED2(result, i);
+    cnt = band_redraw();                            /* Draw and send regions band by band */
+#elif GUI_CFG_OS_RENDER_THREAD
+    GUI_UNUSED3(active, drawing, dispA);
+    GUI_UNUSED2(result, i);
+    cnt = frame_record();                           /* Record regions, rasterizer thread draws them */
+#else /* GUI_CFG_LCD_BAND */
+    /*
+     * Copy from currently active layer to drawing layer only regions changed in last frame.
+     * Regions repainted by this frame anyway are not copied to save memory bandwidth
+     */
+    for (i = 0; i < active->display_count; i++) {
+        dispA = &active->display[i];
+        if (!is_region_repainted(dispA)) {
+            copy[copy_count++] = *dispA;
+        }
+    }
+    copy_regions(active, drawing, copy, copy_count);
+#if GUI_CFG_REDRAW_BUDGET
+    budget_sort();                                  /* Input feedback is drawn first */
+    copy_regions(active, drawing, GUI.DirtyRects, GUI.DirtyRectsCount); /* Regions not drawn in time show previous frame */
+#endif /* GUI_CFG_REDRAW_BUDGET */
+#if GUI_CFG_SPRITE_COUNT
+    if (guii_instance_isfirst()) {
+        guii_sprite_restore(drawing);               /* Remove sprites of last frame */
+    }
+#endif /* GUI_CFG_SPRITE_COUNT */
+#if GUI_CFG_WIDGET_SAVE_UNDER
+    guii_widget_blitunder(drawing);                 /* Pixels below closed popup, widgets above them are drawn next */
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
+#if GUI_CFG_SCREEN_STACK
+    guii_screen_draw(drawing);                      /* Pixels of screen shown again, changed widgets are drawn next */
+#endif /* GUI_CFG_SCREEN_STACK */
+    
+#if GUI_CFG_LCD_TILE
+#if GUI_CFG_LCD_TILE_CORES > 1
+    cnt = tile_redraw_shared(drawing);              /* Tiles are drawn by both cores */
+#else /* GUI_CFG_LCD_TILE_CORES > 1 */
+    cnt = tile_redraw(drawing);                     /* Draw regions tile by tile and copy tiles to drawing layer */
+#endif /* !(GUI_CFG_LCD_TILE_CORES > 1) */
+#elif GUI_CFG_REDRAW_BUDGET
+    cnt = budget_redraw(rest, &rest_count);         /* Draw regions until time budget is spent */
+#else /* GUI_CFG_LCD_TILE */
+    /* Redraw all widgets now on drawing layer, one dirty region at a time */
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {
+        memcpy(&GUI.Display, &GUI.DirtyRects[i], sizeof(GUI.Display));
+        cnt += redraw_widgets(i == GUI.DirtyRectsCount - 1);
+#if GUI_CFG_USE_STATS
+        GUI.StatsFrame.dirty_area += (uint32_t)(GUI.Display.x2 - GUI.Display.x1) * (uint32_t)(GUI.Display.y2 - GUI.Display.y1);
+#endif /* GUI_CFG_USE_STATS */
+    }
+#endif /* !GUI_CFG_LCD_TILE */
+    
+#if GUI_CFG_USE_DEBUG_OVERLAY
+    if (GUI.Overlay) {
+        overlay_process();                          /* Adds its regions to dirty list */
+    }
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY */
+    
+    /* Copy clipping data to region */
+    memcpy(drawing->display, GUI.DirtyRects, sizeof(GUI.DirtyRects[0]) * GUI.DirtyRectsCount);
+    drawing->display_count = GUI.DirtyRectsCount;
+    
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE
+    guii_widget_blitscrolled(active, drawing);      /* Move pixels of scrolled widgets from last frame */
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE */
+#if GUI_CFG_SCREEN_STACK
+    guii_screen_drawdone(drawing);                  /* Add area of copied screen to changed regions */
+#endif /* GUI_CFG_SCREEN_STACK */
+#if GUI_CFG_USE_TRANSITION
+    guii_transition_draw(drawing);                  /* Copy old and new screen at current offsets */
+#endif /* GUI_CFG_USE_TRANSITION */
+#if GUI_CFG_SPRITE_COUNT
+    if (guii_instance_isfirst()) {
+        guii_sprite_draw(drawing);                  /* Sprites are drawn over finished frame */
+    }
+#endif /* GUI_CFG_SPRITE_COUNT */
+#if GUI_CFG_LCD_FRAME_CALLBACK
+    guii_lcd_framedone(drawing);                    /* Frame is complete in layer memory */
+#endif /* GUI_CFG_LCD_FRAME_CALLBACK */
+    
+#if GUI_CFG_STATS_LATENCY
+    if (GUI.Latency.input_valid) {                  /* Frame shows result of input, wait for display to confirm it */
+        GUI.Latency.shown_time = GUI.Latency.input_time;
+        GUI.Latency.shown_frame = GUI.Stats.frames + 1;
+        GUI.Latency.input_valid = 0;
+        GUI.Latency.shown_valid = 1;
+    }
+#endif /* GUI_CFG_STATS_LATENCY */
+    
+    /* Notify low-level about layer change, driver sets layer pending when it is ready to be shown */
+    GUI.lcd.flags |= GUI_FLAG_LCD_WAIT_LAYER_CONFIRM;
+    gui_ll_control(&GUI.lcd, GUI_LL_Command_SetActiveLayer, &drawing, &result); /* Set new active layer to low-level driver */
+    
+    /* Swap active and drawing layers */
+    /* New drawings won't be affected until confirmation from low-level is not received */
+    GUI.lcd.active_layer = drawing;
+    GUI.lcd.drawing_layer = active;
+#endif /* !GUI_CFG_LCD_BAND && !GUI_CFG_OS_RENDER_THREAD */
+    
+    /* Invalid clipping region(s) for next drawing process */
+    GUI.DirtyRectsCount = 0;
+    GUI.Display.x1 = 0x7FFF;
+    GUI.Display.y1 = 0x7FFF;
+    GUI.Display.x2 = 0x8000;
+    GUI.Display.y2 = 0x8000;
+#if GUI_CFG_REDRAW_BUDGET
+    if (rest_count) {                               /* Regions not drawn in time are drawn in next frame */
+        memcpy(GUI.DirtyRects, rest, sizeof(rest[0]) * rest_count);
+        GUI.DirtyRectsCount = rest_count;
+        GUI.flags |= GUI_FLAG_REDRAW;
+    }
+#endif /* GUI_CFG_REDRAW_BUDGET */
+    
+#if GUI_CFG_FRAME_PERIOD
+    frame_adapt(gui_sys_now() - GUI.FrameTime);
+#endif /* GUI_CFG_FRAME_PERIOD */
+    return cnt;
+}
+
+/**
+ * \brief           Default global callback function
+ */
+static void
+default_event_cb(void) {
+
+}
+
+#if GUI_CFG_OS || __DOXYGEN__
+/**
+ * \brief           GUI main thread for RTOS
+ * \param[in]       argument: Pointer to user specific argument
+ */
+static void
+gui_thread(void * const argument) {
+#if GUI_CFG_INSTANCES > 1
+    ((gui_t *)argument)->OS.thread_id = gui_sys_thread_getid();  /* Known before first process call */
+#else
+    GUI_UNUSED(argument);
+#endif /* GUI_CFG_INSTANCES > 1 */
+    while (1) {
+        gui_process();                              /* Process graphical update */
+    }
+}
+#endif /* GUI_CFG_OS || __DOXYGEN__ */
+
+#if GUI_CFG_OS_RENDER_THREAD || __DOXYGEN__
+/**
+ * \brief           Rasterizer thread drawing frames recorded by GUI thread
+ * \note            Thread owns drawing and active layers, it swaps them after each frame
+ * \param[in]       argument: Pointer to user specific argument
+ */
+static void
+render_thread(void * const argument) {
+    gui_frame_t* frame;
+    gui_layer_t *active, *drawing;
+    gui_display_t disp;
+    uint8_t result;
+    
+    GUI_UNUSED(argument);
+    
+    /* Recorded clipping regions limit all commands */
+    disp.x1 = 0;
+    disp.y1 = 0;
+    disp.x2 = 0x7FFF;
+    disp.y2 = 0x7FFF;
+    while (1) {
+        gui_sys_mbox_get(&GUI.OS.render_mbox, (void **)&frame, 0); /* Wait for recorded frame */
+        if (frame->layer != NULL) {                 /* Static content of other layer */
+            drawing = GUI.lcd.drawing_layer;
+            GUI.lcd.drawing_layer = frame->layer;
+            guii_draw_dlist_replay(&frame->list, &disp);
+            GUI.lcd.drawing_layer = drawing;
+            guii_ll_waitready();
+            frame->busy = 0;
+            continue;
+        }
+        
+        while (GUI.lcd.flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM) {
+            gui_sys_sem_wait(&GUI.OS.render_sem, 0);    /* Previous frame must be shown first */
+        }
+        active = GUI.lcd.active_layer;
+        drawing = GUI.lcd.drawing_layer;
+        if (active != drawing) {
+            copy_regions(active, drawing, frame->copy, frame->copy_count);
+        }
+        guii_draw_dlist_replay(&frame->list, &disp);
+        memcpy(drawing->display, frame->rects, sizeof(frame->rects[0]) * frame->rects_count);
+        drawing->display_count = frame->rects_count;
+#if GUI_CFG_LCD_FRAME_CALLBACK
+        guii_lcd_framedone(drawing);                /* Frame is complete in layer memory */
+#endif /* GUI_CFG_LCD_FRAME_CALLBACK */
+        
+        __GUI_SYS_PROTECT();                        /* LCD flags are shared with GUI thread */
+        GUI.lcd.flags |= GUI_FLAG_LCD_WAIT_LAYER_CONFIRM;
+        result = 1;
+        gui_ll_control(&GUI.lcd, GUI_LL_Command_SetActiveLayer, &drawing, &result);
+        GUI.lcd.active_layer = drawing;
+        GUI.lcd.drawing_layer = active;
+        frame->busy = 0;
+        __GUI_SYS_UNPROTECT();
+        __GUI_WAKEUP(0x00);                         /* Wake GUI thread waiting for free frame */
+    }
+}
+#endif /* GUI_CFG_OS_RENDER_THREAD || __DOXYGEN__ */
+
+/**
+ * \brief           Initialize current GUI instance
+ * \return          Member of \ref guir_t enumeration
+ */
+static guir_t
+init_instance(void) {
+    uint8_t result;
+    
+    memset((void *)&GUI, 0x00, sizeof(GUI));        /* Reset GUI structure */
+    GUI.Display.x1 = 0x7FFF;                        /* Set invalid clipping region */
+    GUI.Display.y1 = 0x7FFF;
+    GUI.Display.x2 = 0x8000;
+    GUI.Display.y2 = 0x8000;
+    
+    gui_seteventcallback(NULL);                     /* Set event callback */
+    
+#if GUI_CFG_OS
     /* Init system */
+#if GUI_CFG_INSTANCES > 1
+    if (!sys_ready) {                               /* System is shared by all instances */
+        gui_sys_init();
+        sys_ready = 1;
+    }
+#else /* GUI_CFG_INSTANCES > 1 */
     gui_sys_init();                                 /* Init low-level system */
+#endif /* !(GUI_CFG_INSTANCES > 1) */
     gui_sys_mbox_create(&GUI.OS.mbox, 32);          /* Message box for 10 elements */
+#if GUI_CFG_WIDGET_POST_QUEUE_SIZE
+    gui_sys_mutex_create(&GUI.OS.post_mutex);       /* Mutex for posted widget parameters */
+#endif /* GUI_CFG_WIDGET_POST_QUEUE_SIZE */
+#if GUI_CFG_OS_RENDER_THREAD
+    gui_sys_mbox_create(&GUI.OS.render_mbox, GUI_COUNT_OF(GUI.Frames) + 1); /* Frames and background frame */
+    gui_sys_sem_create(&GUI.OS.render_sem, 0);      /* Released on layer confirmation */
+#endif /* GUI_CFG_OS_RENDER_THREAD */
 #endif /* GUI_CFG_OS */
     
     /* Call LCD low-level function */
     result = 1;
     gui_ll_control(&GUI.lcd, GUI_LL_Command_Init, &GUI.ll, &result);/* Call low-level initialization */
+    if (result) {                                   /* Driver failed, for example memory was not assigned */
+        return guiERROR;
+    }
+#if GUI_CFG_LL_SOFTWARE
+    guii_lcd_setsoftwaredrawing(&GUI.ll);           /* Use software drawing where driver has no function */
+#endif /* GUI_CFG_LL_SOFTWARE */
+#if GUI_CFG_USE_TRACE
+    guii_trace_setll(&GUI.ll);                      /* Trace all drawing operations of driver */
+#endif /* GUI_CFG_USE_TRACE */
     GUI.ll.Init(&GUI.lcd);                          /* Call user LCD driver function */
     
     /* Check situation with layers */
@@ -775,67 +2829,491 @@ gui_init(void) {
             GUI.lcd.layers[i].y_offset = 0;
             GUI.lcd.layers[i].width = GUI.lcd.width;
             GUI.lcd.layers[i].height = GUI.lcd.height;
+            if (GUI.lcd.layers[i].pixel_format == GUI_PIXEL_FORMAT_DEFAULT) {  /* Driver did not select own format */
+                GUI.lcd.layers[i].pixel_format = GUI_PIXEL_FORMAT_FROM_SIZE(GUI.lcd.pixel_size);
+            }
+            GUI.lcd.layers[i].pixel_size = GUI_PIXEL_FORMAT_SIZE(GUI.lcd.layers[i].pixel_format);
         }
+        /* Changed regions are copied between swapped layers without conversion */
+        if (GUI.lcd.layer_count > 1 && GUI.lcd.layers[0].pixel_format != GUI.lcd.layers[1].pixel_format) {
+            return guiERROR;
+        }
+#if GUI_CFG_LCD_CLUT
+        guii_lcd_initpalette();                     /* Indexed layers are filled right after */
+#else /* GUI_CFG_LCD_CLUT */
+        if (GUI.lcd.layers[0].pixel_format == GUI_PIXEL_FORMAT_L8) {
+            return guiERROR;                        /* Indexed layers need display palette */
+        }
+#endif /* !GUI_CFG_LCD_CLUT */
+#if GUI_CFG_LCD_BACKGROUND
+        /* Background must show through drawing layers */
+        if (GUI.lcd.background != NULL) {
+            if (GUI.lcd.layers[0].pixel_format != GUI_PIXEL_FORMAT_ARGB8888) {
+                return guiERROR;
+            }
+            GUI.lcd.background->x_offset = 0;
+            GUI.lcd.background->y_offset = 0;
+            GUI.lcd.background->width = GUI.lcd.width;
+            GUI.lcd.background->height = GUI.lcd.height;
+            if (GUI.lcd.background->pixel_format == GUI_PIXEL_FORMAT_DEFAULT) {
+                GUI.lcd.background->pixel_format = GUI_PIXEL_FORMAT_FROM_SIZE(GUI.lcd.pixel_size);
+            }
+            GUI.lcd.background->pixel_size = GUI_PIXEL_FORMAT_SIZE(GUI.lcd.background->pixel_format);
+#if !GUI_CFG_LCD_CLUT
+            if (GUI.lcd.background->pixel_format == GUI_PIXEL_FORMAT_L8) {
+                return guiERROR;
+            }
+#endif /* !GUI_CFG_LCD_CLUT */
+            GUI.ll.Fill(&GUI.lcd, GUI.lcd.background, (void *)GUI.lcd.background->start_address, GUI.lcd.width, GUI.lcd.height, 0, GUI_COLOR_LIGHTGRAY);
+        }
+#endif /* GUI_CFG_LCD_BACKGROUND */
         GUI.lcd.active_layer = &GUI.lcd.layers[0];
         GUI.lcd.drawing_layer = &GUI.lcd.layers[0];
-        GUI.ll.Fill(&GUI.lcd, GUI.lcd.drawing_layer, (void *)GUI.lcd.drawing_layer->start_address, GUI.lcd.width, GUI.lcd.height, 0, GUI_COLOR_LIGHTGRAY);
+#if GUI_CFG_LCD_BAND
+        /* Layer describes display only, bands are drawn to own buffers */
+        for (i = 0; i < GUI_COUNT_OF(GUI.Band); i++) {
+            GUI.Band[i].num = (uint8_t)i;
+            GUI.Band[i].start_address = (uintptr_t)band_mem[i];
+            GUI.Band[i].pixel_format = GUI.lcd.layers[0].pixel_format;
+            GUI.Band[i].pixel_size = GUI.lcd.layers[0].pixel_size;
+        }
+#else /* GUI_CFG_LCD_BAND */
+#if GUI_CFG_LCD_SPLASH
+        if (guii_lcd_drawsplash()) {
+            /* Splash stays visible until first frame is shown */
+        } else
+#endif /* GUI_CFG_LCD_SPLASH */
+#if GUI_CFG_LCD_BACKGROUND
+        if (GUI.lcd.background != NULL) {
+            GUI.ll.Fill(&GUI.lcd, GUI.lcd.drawing_layer, (void *)GUI.lcd.drawing_layer->start_address, GUI.lcd.width, GUI.lcd.height, 0, GUI_COLOR_TRANS);
+        } else
+#endif /* GUI_CFG_LCD_BACKGROUND */
+        {
+            GUI.ll.Fill(&GUI.lcd, GUI.lcd.drawing_layer, (void *)GUI.lcd.drawing_layer->start_address, GUI.lcd.width, GUI.lcd.height, 0, GUI_COLOR_LIGHTGRAY);
+        }
         if (GUI.lcd.layer_count > 1) {
             GUI.lcd.drawing_layer = &GUI.lcd.layers[1];
         }
+#if GUI_CFG_LCD_TILE
+        /* Tile buffer uses format of drawing layers, its position is set for each tile */
+        GUI.Tile.start_address = (uintptr_t)tile_mem;
+        GUI.Tile.pixel_format = GUI.lcd.layers[0].pixel_format;
+        GUI.Tile.pixel_size = GUI.lcd.layers[0].pixel_size;
+#endif /* GUI_CFG_LCD_TILE */
+#endif /* !GUI_CFG_LCD_BAND */
     } else {
         return guiERROR;
     }
     
-    gui_input_init();                               /* Init input devices */
+#if GUI_CFG_USE_TRANSPARENCY
+    GUI.ScratchPeak = GUI_CFG_TRANSPARENCY_SCRATCH_SIZE;    /* Scratch memory is allocated on first use */
+#endif /* GUI_CFG_USE_TRANSPARENCY */
+#if GUI_CFG_IDLE_TIMEOUT
+    GUI.IdleTime = gui_sys_now();
+#endif /* GUI_CFG_IDLE_TIMEOUT */
+#if GUI_CFG_FRAME_PERIOD
+    GUI.FramePeriod = GUI.FramePeriodMin = GUI_CFG_FRAME_PERIOD;
+    GUI.FramePeriodMax = GUI_MAX(GUI_CFG_FRAME_PERIOD_MAX, GUI_CFG_FRAME_PERIOD);
+    GUI.FrameTime = gui_sys_now() - GUI.FramePeriod;    /* First frame is drawn immediately */
+#endif /* GUI_CFG_FRAME_PERIOD */
+    if (guii_instance_isfirst()) {
+        gui_input_init();                           /* Init input devices */
+    }
     GUI.Initialized = 1;                            /* GUI is initialized */
     guii_widget_init();                              /* Init widgets */
     
 #if GUI_CFG_OS
+#if GUI_CFG_OS_RENDER_THREAD
+    /* Create rasterizer thread first, its ID must be known before first frame is recorded */
+    if (GUI.OS.render_thread_id == NULL) {
+        gui_sys_thread_create(&GUI.OS.render_thread_id, "gui_render", render_thread, NULL, GUI_SYS_THREAD_SS, GUI_SYS_THREAD_PRIO);
+    }
+#endif /* GUI_CFG_OS_RENDER_THREAD */
     /* Create graphical thread */
     if (GUI.OS.thread_id == NULL) {
-        gui_sys_thread_create(&GUI.OS.thread_id, "gui_thread", gui_thread, NULL, GUI_SYS_THREAD_SS, GUI_SYS_THREAD_PRIO);
+        gui_sys_thread_create(&GUI.OS.thread_id, "gui_thread", gui_thread, &GUI, GUI_SYS_THREAD_SS, GUI_SYS_THREAD_PRIO);
     }
 #endif
     
     return guiOK;
 }
 
+/**
+ * \brief           Initializes GUI stack.
+ *                    In addition, it prepares memory for work with widgets on later usage and
+ *                    calls low-layer functions to initialize LCD or custom driver for LCD
+ * \note            With \ref GUI_CFG_INSTANCES greater than `1`, instance selected with \ref gui_instance_select is initialized
+ * \return          Member of \ref guir_t enumeration
+ */
+guir_t
+gui_init(void) {
+#if GUI_CFG_INSTANCES > 1
+    guir_t res;
+#if GUI_CFG_OS
+    uint8_t locked = sys_ready;                     /* Other instances may already run */
+    
+    if (locked) {
+        __GUI_SYS_PROTECT();
+    }
+#endif /* GUI_CFG_OS */
+    guii_instance = instance_selected;
+    res = init_instance();
+#if GUI_CFG_OS
+    if (locked) {
+        __GUI_SYS_UNPROTECT();
+    }
+#endif /* GUI_CFG_OS */
+    return res;
+#else /* GUI_CFG_INSTANCES > 1 */
+    return init_instance();
+#endif /* !(GUI_CFG_INSTANCES > 1) */
+}
+
+#if GUI_CFG_STATS_LATENCY || __DOXYGEN__
+
+/**
+ * \brief           Add latency measured by display confirmation to samples
+ * \note            Display driver confirms layer at most once per frame,
+ *                  latency is collected before next frame is drawn
+ */
+static void
+latency_collect(void) {
+    if (GUI.Latency.confirmed_valid) {
+        GUI.Latency.samples[GUI.Latency.count % GUI_CFG_STATS_LATENCY_SAMPLES] = GUI.Latency.confirmed;
+        GUI.Latency.frame = GUI.Latency.shown_frame;
+        GUI.Latency.count++;
+        GUI.Latency.confirmed_valid = 0;
+    }
+}
+
+/**
+ * \brief           Fill latency percentiles of last measured inputs to statistics
+ * \param[out]      stats: Pointer to \ref gui_stats_t structure to fill
+ */
+static void
+latency_getstats(gui_stats_t* stats) {
+    uint32_t sorted[GUI_CFG_STATS_LATENCY_SAMPLES], v;
+    size_t n, i, j;
+    
+    latency_collect();
+    n = GUI_MIN(GUI.Latency.count, GUI_CFG_STATS_LATENCY_SAMPLES);
+    for (i = 0; i < n; i++) {                       /* Insertion sort, number of samples is small */
+        v = GUI.Latency.samples[i];
+        for (j = i; j > 0 && sorted[j - 1] > v; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = v;
+    }
+    stats->latency_count = GUI.Latency.count;
+    stats->latency_frame = GUI.Latency.frame;
+    if (n) {                                        /* Nearest-rank percentiles */
+        stats->latency_last = GUI.Latency.samples[(GUI.Latency.count - 1) % GUI_CFG_STATS_LATENCY_SAMPLES];
+        stats->latency_p50 = sorted[(n * 50 + 99) / 100 - 1];
+        stats->latency_p90 = sorted[(n * 90 + 99) / 100 - 1];
+        stats->latency_p99 = sorted[(n * 99 + 99) / 100 - 1];
+        stats->latency_max = sorted[n - 1];
+    }
+}
+
+#endif /* GUI_CFG_STATS_LATENCY || __DOXYGEN__ */
+
 /**
  * \brief           Processes all drawing operations for GUI
  * \note            When GUI_CFG_OS is set to 0, then user has to call this function in main loop, otherwise it is processed in separated thread by GUI (GUI_CFG_OS != 0)
- * \return          Number of jobs done in current call
+ * \return          Number of widgets redrawn in current call
  */
 int32_t
 gui_process(void) {
+    uint32_t cnt;
+#if GUI_CFG_USE_STATS
+    uint32_t t, now;
+#endif /* GUI_CFG_USE_STATS */
 #if GUI_CFG_OS
     gui_mbox_msg_t* msg;
     uint32_t time;
-    uint32_t tmr_cnt = guii_timer_getactivecount(); /* Get number of active timers in system */
+    uint8_t tmr;
+#if GUI_CFG_IDLE_TIMEOUT
+    uint32_t idle;
+#endif /* GUI_CFG_IDLE_TIMEOUT */
+#if GUI_CFG_FRAME_PERIOD
+    uint32_t frame;
+#endif /* GUI_CFG_FRAME_PERIOD */
+    
+    __GUI_SYS_PROTECT();
+#if GUI_CFG_INSTANCES > 1
+    guii_instance_enter();                          /* Thread processes own instance */
+#endif /* GUI_CFG_INSTANCES > 1 */
+    tmr = guii_timer_getnext(&time);                /* Get time until next timer expires */
+#if GUI_CFG_IDLE_TIMEOUT
+    idle = gui_sys_now() - GUI.IdleTime;
+    idle = idle < GUI_CFG_IDLE_TIMEOUT ? GUI_CFG_IDLE_TIMEOUT - idle : 0;
+    if (GUI.PowerDown) {
+        tmr = 0;                                    /* Timers wait until display is on again */
+    } else if (!tmr || time > idle) {
+        tmr = 1;                                    /* Wake up when idle timeout expires */
+        time = idle;
+    }
+#endif /* GUI_CFG_IDLE_TIMEOUT */
+#if GUI_CFG_FRAME_PERIOD
+    if ((GUI.flags & GUI_FLAG_REDRAW) && !frame_ready(&frame) && (!tmr || frame < time)) {
+        tmr = 1;                                    /* Wake up for frame waiting for its period */
+        time = frame;
+    }
+#endif /* GUI_CFG_FRAME_PERIOD */
+#if GUI_CFG_USE_IDLE_TASKS
+    if (guii_instance_isfirst() && guii_idle_pending() && !(GUI.flags & GUI_FLAG_REDRAW)) {
+        tmr = 1;                                    /* Idle work is pending, don't sleep */
+        time = 0;
+    }
+#endif /* GUI_CFG_USE_IDLE_TASKS */
+    __GUI_SYS_UNPROTECT();
     
-    time = gui_sys_mbox_get(&GUI.OS.mbox, (void **)&msg, tmr_cnt ? 1 : 0); /* Get value from message queue */
+    /*
+     * Sleep until message is received or next timer expires.
+     * Without active timers, wait for message forever
+     */
+    if (!tmr) {
+        gui_sys_mbox_get(&GUI.OS.mbox, (void **)&msg, 0);
+    } else if (time) {
+        gui_sys_mbox_get(&GUI.OS.mbox, (void **)&msg, time);
+    } else {
+        gui_sys_mbox_getnow(&GUI.OS.mbox, (void **)&msg);
+    }
     
-    GUI_UNUSED(time);                               /* Unused variable */
     GUI_UNUSED(msg);                                /* Unused variable */
 #endif /* GUI_CFG_OS */
    
     __GUI_SYS_PROTECT();                            /* Protect from multiple access */
+#if GUI_CFG_INSTANCES > 1
+    guii_instance_enter();
+#endif /* GUI_CFG_INSTANCES > 1 */
+#if GUI_CFG_OS
+    GUI.OS.wakeup_pending = 0;                      /* Changes from now on need new wake up message */
+#endif /* GUI_CFG_OS */
+#if GUI_CFG_IDLE_TIMEOUT
+    if (idle_process()) {                           /* Nothing is processed while display is off */
+        __GUI_SYS_UNPROTECT();
+        return 0;
+    }
+#endif /* GUI_CFG_IDLE_TIMEOUT */
+#if GUI_CFG_USE_STATS
+    t = GUI_CFG_STATS_TIME();                       /* Get start time */
+#endif /* GUI_CFG_USE_STATS */
+#if GUI_CFG_STATS_LATENCY
+    latency_collect();                              /* Layer of previous frame may be confirmed */
+#endif /* GUI_CFG_STATS_LATENCY */
     
     /*
      * Periodically process everything
      */
+#if GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE
+    guii_widget_processposted();                    /* Apply parameters set from other threads */
+#endif /* GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE */
+#if GUI_CFG_BIND_COUNT
+    if (guii_instance_isfirst()) {
+        guii_bind_process();                        /* Format changed bound values */
+    }
+#endif /* GUI_CFG_BIND_COUNT */
     guii_timer_process();                           /* Process all timers */
     guii_widget_executeremove();                    /* Delete widgets */
+    STATS_MEASURE(time_timers);
+#if GUI_CFG_WIDGET_LAYOUT
+    guii_widget_layout();                           /* Resolve geometry once for touch and redraw */
+#endif /* GUI_CFG_WIDGET_LAYOUT */
 #if GUI_CFG_USE_TOUCH
-    gui_process_touch();                            /* Process touch inputs */
+    if (guii_instance_isfirst()) {
+        gui_process_touch();                        /* Process touch inputs */
+    }
+    STATS_MEASURE(time_touch);
 #endif /* GUI_CFG_USE_TOUCH */
 #if GUI_CFG_USE_KEYBOARD
-    process_keyboard();                             /* Process keyboard inputs */
+    if (guii_instance_isfirst()) {
+        process_keyboard();                         /* Process keyboard inputs */
+    }
+    STATS_MEASURE(time_keyboard);
 #endif /* GUI_CFG_USE_KEYBOARD */
-    process_redraw();                               /* Redraw widgets */
+    cnt = process_redraw();                         /* Redraw widgets */
+#if GUI_CFG_USE_IDLE_TASKS
+    if (!cnt && !(GUI.flags & GUI_FLAG_REDRAW) && guii_instance_isfirst()) {  /* Nothing to draw, use time for background work */
+        guii_idle_process();
+    }
+#endif /* GUI_CFG_USE_IDLE_TASKS */
+#if GUI_CFG_OS && GUI_CFG_FRAME_PERIOD
+    if ((GUI.flags & GUI_FLAG_REDRAW) && !frame_ready(&frame)) {
+        GUI.OS.wakeup_pending = 1;                  /* Thread wakes up for next frame without messages */
+    }
+#endif /* GUI_CFG_OS && GUI_CFG_FRAME_PERIOD */
+    
+#if GUI_CFG_USE_STATS
+    if (cnt || GUI.StatsFrame.dirty_area) {         /* Frame was redrawn */
+        STATS_MEASURE(time_redraw);
+        GUI.StatsFrame.frames = GUI.Stats.frames + 1;
+        GUI.StatsFrame.time_redraw_max = GUI_MAX(GUI.Stats.time_redraw_max, GUI.StatsFrame.time_redraw);
+        GUI.StatsFrame.widgets_redrawn = cnt;
+        GUI.StatsFrame.mem_min_free = gui_mem_getminfree();
+#if GUI_CFG_INPUT_RECORD
+        guii_input_replayframe(&GUI.StatsFrame);    /* Collect statistics of replayed interaction */
+#endif /* GUI_CFG_INPUT_RECORD */
+#if GUI_CFG_USE_METRICS
+        if (guii_instance_isfirst()) {
+            guii_metrics_frame(&GUI.StatsFrame);    /* Add frame to counters for remote monitoring */
+        }
+#endif /* GUI_CFG_USE_METRICS */
+        memcpy(&GUI.Stats, &GUI.StatsFrame, sizeof(GUI.Stats)); /* Save statistics of finished frame */
+        memset(&GUI.StatsFrame, 0x00, sizeof(GUI.StatsFrame));  /* Start new frame */
+    }
+#endif /* GUI_CFG_USE_STATS */
+#if GUI_CFG_USE_METRICS
+    if (guii_instance_isfirst()) {
+        guii_metrics_process();                     /* Publish snapshot for other threads */
+    }
+#endif /* GUI_CFG_USE_METRICS */
     
     __GUI_SYS_UNPROTECT();                          /* Release protection */
-    return 0;                                       /* Return number of elements updated on GUI */
+    return (int32_t)cnt;                            /* Return number of elements updated on GUI */
+}
+
+#if GUI_CFG_USE_STATS || __DOXYGEN__
+/**
+ * \brief           Get processing statistics of last redrawn frame
+ * \note            Available only when \ref GUI_CFG_USE_STATS is enabled.
+ *                  With \ref GUI_CFG_STATS_LATENCY, latency percentiles of last measured inputs are added
+ * \param[out]      stats: Pointer to \ref gui_stats_t structure to fill
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_getstats(gui_stats_t* stats) {
+    __GUI_ASSERTPARAMS(stats != NULL);              /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    memcpy(stats, &GUI.Stats, sizeof(*stats));      /* Copy statistics */
+#if GUI_CFG_STATS_LATENCY
+    latency_getstats(stats);                        /* Latency covers last measured inputs, not only last frame */
+#endif /* GUI_CFG_STATS_LATENCY */
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
 }
+#endif /* GUI_CFG_USE_STATS || __DOXYGEN__ */
+
+#if GUI_CFG_FRAME_PERIOD || __DOXYGEN__
+/**
+ * \brief           Set limits of time between 2 redraw operations
+ *
+ *                  Frame period starts at minimal value and grows up to maximal value
+ *                  when redraw takes more than half of period. Use longer periods to save power,
+ *                  for example when device runs on battery
+ *
+ * \note            Available only when \ref GUI_CFG_FRAME_PERIOD is not `0`
+ * \param[in]       min_period: Minimal frame period in units of milliseconds, `0` to redraw as soon as possible
+ * \param[in]       max_period: Maximal frame period in units of milliseconds, same as minimal to disable adaptation
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_setframeperiod(uint32_t min_period, uint32_t max_period) {
+    __GUI_ASSERTPARAMS(max_period >= min_period);   /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    GUI.FramePeriodMin = min_period;
+    GUI.FramePeriodMax = max_period;
+    GUI.FramePeriod = min_period;
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Get current time between 2 redraw operations
+ * \note            Available only when \ref GUI_CFG_FRAME_PERIOD is not `0`
+ * \return          Frame period in units of milliseconds, adapted to redraw time
+ */
+uint32_t
+gui_getframeperiod(void) {
+    return GUI.FramePeriod;
+}
+#endif /* GUI_CFG_FRAME_PERIOD || __DOXYGEN__ */
+
+#if GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__
+/**
+ * \brief           Turn dirty region debug overlay on or off
+ * \note            Available only when \ref GUI_CFG_USE_DEBUG_OVERLAY is enabled
+ * \note            Overlay repaints outlined regions of previous frames and disables
+ *                  scrolling of widget content by memory copy, redraw time is longer while it is on
+ * \param[in]       enable: Set to `1` to turn overlay on or `0` to turn it off
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_setdebugoverlay(uint8_t enable) {
+    gui_handle_p h;
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    enable = enable ? 1 : 0;
+    if (GUI.Overlay != enable) {
+        GUI.Overlay = enable;
+        memset(GUI.OverlayRectsCount, 0x00, sizeof(GUI.OverlayRectsCount));
+        h = (gui_handle_p)gui_linkedlist_getnext_gen(&GUI.root, NULL);  /* Desktop window */
+        if (h != NULL) {
+            guii_widget_invalidate(h);              /* Show or remove overlay on complete screen */
+        }
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__ */
+
+#if GUI_CFG_INSTANCES > 1 || __DOXYGEN__
+
+/**
+ * \brief           Select GUI instance used by next calls of application
+ *
+ *                  Select instance before \ref gui_init to initialize it and before widgets
+ *                  of its display are created or changed. Without \ref GUI_CFG_OS,
+ *                  select instance before \ref gui_process to process its display.
+ *
+ * \note            With \ref GUI_CFG_OS enabled, selection is shared by all application threads,
+ *                  GUI thread of each instance always uses own instance
+ * \param[in]       num: Instance number, from `0` to \ref GUI_CFG_INSTANCES - 1
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_instance_select(uint8_t num) {
+    if (num >= GUI_CFG_INSTANCES) {
+        return 0;
+    }
+    instance_selected = &guii_instances[num];
+#if !GUI_CFG_OS
+    guii_instance = instance_selected;              /* Single thread, use it immediately */
+#endif /* !GUI_CFG_OS */
+    return 1;
+}
+
+/**
+ * \brief           Get number of GUI instance currently processed
+ * \note            Low-level driver uses it on initialization to find display of instance
+ * \return          Instance number
+ */
+uint8_t
+gui_instance_getselected(void) {
+    return (uint8_t)(guii_instance - guii_instances);
+}
+
+/**
+ * \brief           Set current instance after GUI protection is taken
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ */
+void
+guii_instance_enter(void) {
+#if GUI_CFG_OS
+    gui_sys_thread_t id = gui_sys_thread_getid();
+    size_t i;
+    
+    for (i = 0; i < GUI_CFG_INSTANCES; i++) {
+        if (guii_instances[i].OS.thread_id != NULL && guii_instances[i].OS.thread_id == id) {
+            guii_instance = &guii_instances[i];     /* GUI thread and its callbacks use own instance */
+            return;
+        }
+    }
+#endif /* GUI_CFG_OS */
+    guii_instance = instance_selected;
+}
+
+#endif /* GUI_CFG_INSTANCES > 1 || __DOXYGEN__ */
 
 /**
  * \brief           Set callback for global events from GUI
@@ -0,0 +1,279 @@
+/**	
+ * \file            gui_anim.c
+ * \brief           Time based animations
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_anim.h"
+#include "gui/gui_input.h"
+#include "system/gui_sys.h"
+
+#define ANIM_SCALE                      1024        /*!< Fixed point scale for animation progress */
+
+/**
+ * \brief           Apply easing function to linear progress
+ * \param[in]       ease: Easing function, member of \ref gui_anim_ease_t
+ * \param[in]       t: Linear progress between `0` and \ref ANIM_SCALE
+ * \return          Eased progress between `0` and \ref ANIM_SCALE
+ */
+static int32_t
+ease_progress(uint8_t ease, int32_t t) {
+    switch (ease) {
+        case GUI_ANIM_EASE_IN:
+            return (t * t) / ANIM_SCALE;
+        case GUI_ANIM_EASE_OUT:
+            t = ANIM_SCALE - t;
+            return ANIM_SCALE - (t * t) / ANIM_SCALE;
+        case GUI_ANIM_EASE_IN_OUT:
+            if (t < ANIM_SCALE / 2) {
+                return (2 * t * t) / ANIM_SCALE;
+            }
+            t = ANIM_SCALE - t;
+            return ANIM_SCALE - (2 * t * t) / ANIM_SCALE;
+        default:
+            return t;
+    }
+}
+
+/**
+ * \brief           Find running animation for widget and callback
+ * \param[in]       h: Widget handle
+ * \param[in]       exec: Value callback function
+ * \return          Animation index or `GUI_CFG_ANIM_MAX` if not found
+ */
+static size_t
+anim_find(gui_handle_p h, gui_anim_exec_fn exec) {
+    size_t i;
+    for (i = 0; i < GUI.anim.count; i++) {
+        if (GUI.anim.anims[i].h == h && GUI.anim.anims[i].exec == exec) {
+            return i;
+        }
+    }
+    return GUI_CFG_ANIM_MAX;
+}
+
+/**
+ * \brief           Remove animation from list of running animations
+ * \param[in]       i: Animation index
+ */
+static void
+anim_remove(size_t i) {
+    GUI.anim.count--;
+    if (i != GUI.anim.count) {
+        GUI.anim.anims[i] = GUI.anim.anims[GUI.anim.count]; /* Move last entry to free place */
+    }
+    if (!GUI.anim.count && GUI.anim.timer != NULL) {
+        guii_timer_stop(GUI.anim.timer);            /* No more animations, stop shared timer */
+    }
+}
+
+/**
+ * \brief           Shared timer callback, evaluates all running animations at current time
+ * \param[in]       t: Timer handle
+ */
+static void
+anim_timer_callback(gui_timer_t* t) {
+    gui_anim_t* a;
+    gui_handle_p h;
+    gui_anim_exec_fn exec;
+    uint32_t now, elapsed;
+    int32_t value;
+    size_t i = 0;
+    
+    now = gui_sys_now();                            /* Get time once for all animations */
+    while (i < GUI.anim.count) {
+        a = &GUI.anim.anims[i];
+        h = a->h;
+        exec = a->exec;
+        elapsed = now - a->time;
+        if (elapsed >= a->duration) {               /* Animation finished */
+            value = a->end;
+            anim_remove(i);                         /* Remove before callback, it may start new animation */
+            exec(h, value);
+            continue;
+        }
+        value = a->start + (int32_t)(((int64_t)(a->end - a->start) * ease_progress(a->ease, (int32_t)((elapsed * ANIM_SCALE) / a->duration))) / ANIM_SCALE);
+        i++;
+        if (value != a->value) {                    /* Call callback only when value changed */
+            a->value = value;
+            exec(h, value);
+        }
+    }
+    GUI_UNUSED(t);
+}
+
+/**
+ * \brief           Start animation of widget value
+ * \note            When animation with the same widget and callback is already running,
+ *                  it is replaced with new one. Use current value as `start` to continue smoothly
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle animation belongs to
+ * \param[in]       exec: Callback function to apply new value
+ * \param[in]       start: Value at start of animation, already applied by caller
+ * \param[in]       end: Value at end of animation
+ * \param[in]       duration: Animation duration in units of milliseconds
+ * \param[in]       ease: Easing function, member of \ref gui_anim_ease_t
+ * \return          `1` if animation started, `0` if value was set to `end` immediately
+ */
+uint8_t
+guii_anim_start(gui_handle_p h, gui_anim_exec_fn exec, int32_t start, int32_t end, uint16_t duration, gui_anim_ease_t ease) {
+    gui_anim_t* a;
+    size_t i;
+    
+    __GUI_ASSERTPARAMS(h != NULL && exec != NULL);  /* Check input parameters */
+    
+    i = anim_find(h, exec);                         /* Search for running animation */
+    if (i == GUI_CFG_ANIM_MAX && start != end && duration) {
+        if (GUI.anim.timer == NULL) {               /* Create shared timer on first use */
+            GUI.anim.timer = guii_timer_create(GUI_CFG_ANIM_PERIOD, anim_timer_callback, NULL);
+        }
+        if (GUI.anim.timer != NULL && GUI.anim.count < GUI_CFG_ANIM_MAX) {
+            i = GUI.anim.count++;                   /* Use new entry */
+        }
+    }
+    if (i == GUI_CFG_ANIM_MAX) {                    /* Animation not possible */
+        exec(h, end);                               /* Set final value immediately */
+        return 0;
+    }
+    if (start == end || !duration) {                /* Running animation is not needed anymore */
+        anim_remove(i);
+        exec(h, end);
+        return 0;
+    }
+    
+    a = &GUI.anim.anims[i];
+    a->h = h;
+    a->exec = exec;
+    a->start = start;
+    a->end = end;
+    a->value = start;
+    a->time = gui_sys_now();
+    a->duration = duration;
+    a->ease = (uint8_t)ease;
+    if (GUI.anim.count == 1) {
+        guii_timer_startperiodic(GUI.anim.timer);   /* Start shared timer with first animation */
+    }
+    return 1;
+}
+
+/**
+ * \brief           Stop running animation without setting final value
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle animation belongs to
+ * \param[in]       exec: Callback function of animation or `NULL` to stop all animations of widget
+ * \return          `1` if at least one animation was stopped, `0` otherwise
+ */
+uint8_t
+guii_anim_stop(gui_handle_p h, gui_anim_exec_fn exec) {
+    uint8_t ret = 0;
+    size_t i = 0;
+    
+    while (i < GUI.anim.count) {
+        if (GUI.anim.anims[i].h == h && (exec == NULL || GUI.anim.anims[i].exec == exec)) {
+            anim_remove(i);                         /* Last entry is moved to this place */
+            ret = 1;
+        } else {
+            i++;
+        }
+    }
+    return ret;
+}
+
+/**
+ * \brief           Check if animation is running
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle animation belongs to
+ * \param[in]       exec: Callback function of animation
+ * \return          `1` if running, `0` otherwise
+ */
+uint8_t
+guii_anim_isrunning(gui_handle_p h, gui_anim_exec_fn exec) {
+    return anim_find(h, exec) != GUI_CFG_ANIM_MAX;
+}
+
+#if (GUI_CFG_USE_TOUCH && GUI_CFG_TOUCH_HISTORY_SIZE) || __DOXYGEN__
+
+/**
+ * \brief           Start kinetic vertical scroll after touch has been released
+ *
+ *                  Scroll continues with velocity of touch at release and decelerates
+ *                  with \ref GUI_CFG_ANIM_FLING_DECELERATION until it stops or reaches end of scroll range.
+ *                  Moving finger up increases scroll position
+ *
+ * \note            Call it on \ref GUI_WC_TouchEnd event and stop animation on \ref GUI_WC_TouchStart event
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle animation belongs to
+ * \param[in]       exec: Callback function to apply new scroll position in units of pixels
+ * \param[in]       pos: Current scroll position in units of pixels
+ * \param[in]       max: Maximal scroll position in units of pixels, minimal is always `0`
+ * \param[in]       ts: Touch data at release, with touch history
+ * \return          `1` if kinetic scroll started, `0` otherwise
+ */
+uint8_t
+guii_anim_fling(gui_handle_p h, gui_anim_exec_fn exec, int32_t pos, int32_t max, const guii_touch_data_t* ts) {
+    const guii_touch_sample_t* newest;
+    float vx, vy, v, duration, dist;
+    int32_t end;
+    
+    if (!guii_input_touchvelocity(ts, &vx, &vy)) {  /* Not enough positions */
+        return 0;
+    }
+    newest = &ts->history[ts->history_index ? ts->history_index - 1 : GUI_CFG_TOUCH_HISTORY_SIZE - 1];
+    if (ts->ts.time - newest->time > 100) {         /* Finger stopped before release */
+        return 0;
+    }
+    v = -vy;                                        /* Content follows finger */
+    if (GUI_ABS(v) < GUI_CFG_ANIM_FLING_MIN_VELOCITY) {
+        return 0;
+    }
+    
+    /*
+     * With constant deceleration, scroll stops after v / a seconds
+     * and travels half of distance it would travel with constant speed.
+     * This matches ease-out curve, which starts with double of average speed
+     */
+    duration = GUI_ABS(v) / (float)GUI_CFG_ANIM_FLING_DECELERATION;
+    dist = v * duration / 2.0f;
+    end = pos + (int32_t)dist;
+    if (end < 0) {                                  /* Stop at the end of range */
+        end = 0;
+    } else if (end > max) {
+        end = max;
+    }
+    if (end == pos) {
+        return 0;
+    }
+    if (GUI_ABS(end - pos) < GUI_ABS(dist)) {       /* Range end reached earlier */
+        duration *= (float)GUI_ABS(end - pos) / GUI_ABS(dist);
+    }
+    duration = GUI_MIN(duration * 1000.0f, 0xFFFF);
+    return guii_anim_start(h, exec, pos, end, (uint16_t)duration, GUI_ANIM_EASE_OUT);
+}
+
+#endif /* (GUI_CFG_USE_TOUCH && GUI_CFG_TOUCH_HISTORY_SIZE) || __DOXYGEN__ */
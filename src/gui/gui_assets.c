@@ -0,0 +1,230 @@
+/**	
+ * \file            gui_assets.c
+ * \brief           Asset bank for fonts and images in memory-mapped flash
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_assets.h"
+
+#if GUI_CFG_USE_ASSETS || __DOXYGEN__
+
+/**
+ * \brief           Descriptor built in RAM for requested asset
+ */
+typedef struct gui_assets_item {
+    struct gui_assets_item* next;           /*!< Next loaded asset */
+    const gui_assets_entry_t* entry;        /*!< Table entry of asset */
+    union {
+        gui_font_t font;                    /*!< Font descriptor */
+        gui_image_desc_t image;             /*!< Image descriptor */
+    } desc;                                 /*!< Asset descriptor */
+} gui_assets_item_t;
+
+#define bank_ptr(offset)            ((const uint8_t *)GUI.assets.base + (offset))
+
+/**
+ * \brief           Find asset descriptor, create it when asset is requested for the first time
+ * \param[in]       name: Asset name
+ * \param[in]       type: Asset type
+ * \return          Asset descriptor or `NULL` if not found or no memory
+ */
+static gui_assets_item_t *
+get_item(const gui_char* name, uint8_t type) {
+    const gui_assets_header_t* hdr = GUI.assets.base;
+    const gui_assets_entry_t* e = NULL;
+    gui_assets_item_t* item;
+    uint16_t i;
+    
+    for (item = GUI.assets.items; item != NULL; item = item->next) {
+        if (item->entry->type == type && !gui_string_compare(item->entry->name, name)) {
+            return item;                            /* Descriptor already exists */
+        }
+    }
+    
+    for (i = 0; i < hdr->count; i++) {              /* Find entry in bank table */
+        e = &((const gui_assets_entry_t *)(hdr + 1))[i];
+        if (e->type == type && !gui_string_compare(e->name, name)) {
+            break;
+        }
+    }
+    if (i == hdr->count) {                          /* Asset does not exist */
+        return NULL;
+    }
+    
+    if (type == GUI_ASSETS_TYPE_IMAGE) {
+        const gui_assets_image_t* img = (const gui_assets_image_t *)bank_ptr(e->offset);
+        
+        if ((item = GUI_MEMALLOC(sizeof(*item))) != NULL) {
+            item->desc.image.x_size = img->x_size;
+            item->desc.image.y_size = img->y_size;
+            item->desc.image.bpp = img->bpp;
+            item->desc.image.image = (const uint8_t *)(img + 1);    /* Pixels are used directly from flash */
+        }
+    } else {
+        const gui_assets_font_t* font = (const gui_assets_font_t *)bank_ptr(e->offset);
+        const gui_assets_font_range_t* r = (const gui_assets_font_range_t *)(font + 1);
+        const gui_assets_font_char_t* fc = (const gui_assets_font_char_t *)(r + font->ranges_count);
+        gui_font_range_t* ranges;
+        gui_font_char_t* chars;
+        uint8_t* advance;
+        size_t count = 0, k, k2;
+        uint32_t ch;
+        
+        for (i = 0; i < font->ranges_count; i++) {  /* Get number of all characters */
+            count += r[i].endchar - r[i].startchar + 1;
+        }
+        
+        /* Character and advance tables are built in RAM, character data stay in flash */
+        item = GUI_MEMALLOC(GUI_MEM_ALIGN(sizeof(*item)) + GUI_MEM_ALIGN(font->ranges_count * sizeof(*ranges)) + count * (sizeof(*chars) + 1));
+        if (item != NULL) {
+            ranges = (gui_font_range_t *)((uint8_t *)item + GUI_MEM_ALIGN(sizeof(*item)));
+            chars = (gui_font_char_t *)((uint8_t *)ranges + GUI_MEM_ALIGN(font->ranges_count * sizeof(*ranges)));
+            advance = (uint8_t *)&chars[count];
+            
+            for (i = 0, k = 0; i < font->ranges_count; i++) {
+                ranges[i].startchar = r[i].startchar;
+                ranges[i].endchar = r[i].endchar;
+                ranges[i].data = &chars[k];
+                ranges[i].advance = &advance[k];
+                for (ch = r[i].startchar; ch <= r[i].endchar; ch++, k++) {
+                    chars[k].x_size = fc[k].x_size;
+                    chars[k].y_size = fc[k].y_size;
+                    chars[k].x_pos = fc[k].x_pos;
+                    chars[k].y_pos = fc[k].y_pos;
+                    chars[k].x_margin = fc[k].x_margin;
+                    chars[k].data = bank_ptr(fc[k].offset);
+                    k2 = (font->flags & GUI_FLAG_FONT_FIXEDWIDTH) ? 0 : k;  /* Fixed width is set by first character */
+                    advance[k] = (uint8_t)(fc[k2].x_size + fc[k2].x_margin);
+                }
+            }
+            item->desc.font.name = e->name;
+            item->desc.font.size = font->size;
+            item->desc.font.flags = font->flags;
+            item->desc.font.ranges = ranges;
+            item->desc.font.ranges_count = font->ranges_count;
+        }
+    }
+    if (item != NULL) {
+        item->entry = e;
+        item->next = GUI.assets.items;              /* Add to list of loaded assets */
+        GUI.assets.items = item;
+    }
+    return item;
+}
+
+/**
+ * \brief           Mount asset bank from memory-mapped flash
+ * \note            Previously mounted bank is unmounted first
+ * \param[in]       base: Address of bank in memory-mapped flash
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_assets_unmount
+ */
+uint8_t
+gui_assets_mount(const void* base) {
+    const gui_assets_header_t* hdr = base;
+    uint8_t ret = 0;
+    
+    __GUI_ASSERTPARAMS(base != NULL);               /* Check input parameters */
+    gui_assets_unmount();                           /* Release previous bank */
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (hdr->magic == GUI_ASSETS_MAGIC && hdr->version == GUI_ASSETS_VERSION) {
+        GUI.assets.base = hdr;
+        ret = 1;
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Unmount asset bank and release all descriptors built for it
+ * \note            Fonts and images from bank must not be used by any widget anymore
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_assets_unmount(void) {
+    gui_assets_item_t* item;
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    while ((item = GUI.assets.items) != NULL) {
+        GUI.assets.items = item->next;
+        if (item->entry->type == GUI_ASSETS_TYPE_FONT) {
+            guii_draw_font_release(&item->desc.font);   /* Remove characters of font from cache */
+        }
+#if GUI_CFG_IMAGE_SCALE_CACHE
+        if (item->entry->type == GUI_ASSETS_TYPE_IMAGE) {
+            guii_draw_image_release(&item->desc.image); /* Remove scaled copies of image */
+        }
+#endif /* GUI_CFG_IMAGE_SCALE_CACHE */
+        GUI_MEMFREE(item);
+    }
+    GUI.assets.base = NULL;
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Get font from mounted asset bank
+ * \note            Returned font is valid until bank is unmounted
+ * \param[in]       name: Font name in bank
+ * \return          Pointer to font or `NULL` if not found
+ */
+const gui_font_t *
+gui_assets_getfont(const gui_char* name) {
+    gui_assets_item_t* item = NULL;
+    
+    __GUI_ASSERTPARAMS(name != NULL);               /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (GUI.assets.base != NULL) {
+        item = get_item(name, GUI_ASSETS_TYPE_FONT);
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return item != NULL ? &item->desc.font : NULL;
+}
+
+/**
+ * \brief           Get image from mounted asset bank
+ * \note            Image data are read directly from flash by low-level drawing
+ * \param[in]       name: Image name in bank
+ * \return          Pointer to image descriptor or `NULL` if not found
+ */
+const gui_image_desc_t *
+gui_assets_getimage(const gui_char* name) {
+    gui_assets_item_t* item = NULL;
+    
+    __GUI_ASSERTPARAMS(name != NULL);               /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (GUI.assets.base != NULL) {
+        item = get_item(name, GUI_ASSETS_TYPE_IMAGE);
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return item != NULL ? &item->desc.image : NULL;
+}
+
+#endif /* GUI_CFG_USE_ASSETS || __DOXYGEN__ */
@@ -0,0 +1,308 @@
+/**	
+ * \file            gui_bind.c
+ * \brief           Value slots bound to widget text
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_bind.h"
+#include "widget/gui_widget.h"
+#include "system/gui_sys.h"
+
+#if GUI_CFG_BIND_COUNT || __DOXYGEN__
+
+/**
+ * \brief           Widget bound to value slot
+ */
+typedef struct {
+    gui_handle_p h;                         /*!< Bound widget or `NULL` when entry is free */
+    const gui_bind_value_t* v;              /*!< Value slot */
+    const char* fmt;                        /*!< Format for value */
+    uint32_t seq;                           /*!< Slot sequence of last formatted value */
+    uint8_t valid;                          /*!< Set to `1` when text was formatted at least once */
+    gui_char text[GUI_CFG_BIND_TEXT_SIZE];  /*!< Formatted text, set as widget text */
+} bind_t;
+
+static bind_t binds[GUI_CFG_BIND_COUNT];
+static volatile uint8_t bind_changed;       /* Set by producers, cleared by GUI thread before slots are checked */
+#if GUI_CFG_OS
+static gui_mbox_msg_t msg_bind = { GUI_SYS_MBOX_TYPE_INVALIDATE };
+#endif /* GUI_CFG_OS */
+
+/**
+ * \brief           Notify GUI thread that value slot was written
+ * \note            Called without GUI lock, from producer thread
+ */
+static void
+bind_notify(void) {
+    bind_changed = 1;
+#if GUI_CFG_OS
+    __GUI_WAKEUP(&msg_bind);
+#endif /* GUI_CFG_OS */
+}
+
+/**
+ * \brief           Format value of slot to text
+ * \param[in]       b: Binding entry
+ * \param[out]      text: Output text of \ref GUI_CFG_BIND_TEXT_SIZE bytes
+ * \return          `1` when consistent value was read, `0` when producer was writing it
+ */
+static uint8_t
+bind_format(const bind_t* b, gui_char* text) {
+    const gui_bind_value_t* v = b->v;
+    gui_char str[GUI_CFG_BIND_TEXT_SIZE];
+    uint32_t seq;
+    int32_t i = 0;
+    float f = 0;
+    size_t k;
+    
+    seq = v->seq;
+    if (seq & 0x01) {                               /* Write in progress */
+        return 0;
+    }
+    switch (v->type) {
+        case GUI_BIND_INT:      i = v->v.i; break;
+        case GUI_BIND_FLOAT:    f = v->v.f; break;
+        default:
+            for (k = 0; k < sizeof(str) - 1 && v->v.str[k]; k++) {
+                str[k] = v->v.str[k];
+            }
+            str[k] = 0;
+            break;
+    }
+    if (v->seq != seq) {                            /* Value changed during copy */
+        return 0;
+    }
+    
+    switch (v->type) {
+        case GUI_BIND_INT:
+            if (b->fmt == NULL) {                   /* Default format does not need printf */
+                gui_string_fmt_int(text, GUI_CFG_BIND_TEXT_SIZE, i);
+            } else {
+                snprintf((char *)text, GUI_CFG_BIND_TEXT_SIZE, b->fmt, (long)i);
+            }
+            break;
+        case GUI_BIND_FLOAT:
+            if (b->fmt == NULL) {
+                gui_string_fmt_fixed(text, GUI_CFG_BIND_TEXT_SIZE, (int32_t)(f * 100.0f + (f < 0 ? -0.5f : 0.5f)), 2);
+            } else {
+                snprintf((char *)text, GUI_CFG_BIND_TEXT_SIZE, b->fmt, (double)f);
+            }
+            break;
+        default:
+            snprintf((char *)text, GUI_CFG_BIND_TEXT_SIZE, b->fmt != NULL ? b->fmt : "%s", (const char *)str);
+            break;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Update text of widgets bound to changed value slots
+ * \note            Called once per frame from GUI thread before timers and redraw
+ */
+void
+guii_bind_process(void) {
+    gui_char text[GUI_CFG_BIND_TEXT_SIZE];
+    uint32_t seq;
+    size_t i;
+    
+    if (!bind_changed) {                            /* No slot written since last check */
+        return;
+    }
+    bind_changed = 0;                               /* Writes from now on set it again */
+    for (i = 0; i < GUI_COUNT_OF(binds); i++) {
+        bind_t* b = &binds[i];
+        if (b->h == NULL) {
+            continue;
+        }
+        seq = b->v->seq;
+        if (b->valid && seq == b->seq) {            /* Slot not written since last format */
+            continue;
+        }
+        if (!bind_format(b, text)) {
+            bind_changed = 1;                       /* Producer finishes write and wakes thread again */
+            continue;
+        }
+        b->seq = seq;
+        if (!b->valid || gui_string_compare(text, b->text)) {   /* Redraw only when shown text changes */
+            gui_string_copy(b->text, text);
+            b->valid = 1;
+            guii_widget_settext(b->h, b->text);
+        }
+    }
+}
+
+/**
+ * \brief           Remove binding of widget
+ * \note            Called when widget is deleted
+ * \param[in]       h: Widget handle
+ */
+void
+guii_bind_remove(gui_handle_p h) {
+    size_t i;
+    
+    for (i = 0; i < GUI_COUNT_OF(binds); i++) {
+        if (binds[i].h == h) {
+            binds[i].h = NULL;
+        }
+    }
+}
+
+/**
+ * \brief           Initialize value slot
+ * \note            Slot must be initialized before widgets are bound to it
+ * \param[out]      v: Value slot
+ * \param[in]       type: Value type. This parameter can be a value of \ref gui_bind_type_t enumeration
+ */
+void
+gui_bind_init(gui_bind_value_t* v, gui_bind_type_t type) {
+    memset((void *)v, 0x00, sizeof(*v));
+    v->type = type;
+}
+
+/**
+ * \brief           Write integer value to slot
+ * \note            Function does not take GUI lock and can be called from any thread,
+ *                  but only one thread may write the same slot
+ * \param[in,out]   v: Value slot of \ref GUI_BIND_INT type
+ * \param[in]       value: New value
+ */
+void
+gui_bind_setint(gui_bind_value_t* v, int32_t value) {
+    if (v->v.i == value) {                          /* Only writer reads its own value */
+        return;
+    }
+    v->seq++;
+    v->v.i = value;
+    v->seq++;
+    bind_notify();
+}
+
+/**
+ * \brief           Write float value to slot
+ * \note            Function does not take GUI lock and can be called from any thread,
+ *                  but only one thread may write the same slot
+ * \param[in,out]   v: Value slot of \ref GUI_BIND_FLOAT type
+ * \param[in]       value: New value
+ */
+void
+gui_bind_setfloat(gui_bind_value_t* v, float value) {
+    if (v->v.f == value) {
+        return;
+    }
+    v->seq++;
+    v->v.f = value;
+    v->seq++;
+    bind_notify();
+}
+
+/**
+ * \brief           Write string value to slot
+ * \note            Function does not take GUI lock and can be called from any thread,
+ *                  but only one thread may write the same slot
+ * \param[in,out]   v: Value slot of \ref GUI_BIND_STRING type
+ * \param[in]       str: New string, cut to \ref GUI_CFG_BIND_TEXT_SIZE bytes including trailing zero
+ */
+void
+gui_bind_setstring(gui_bind_value_t* v, const gui_char* str) {
+    size_t k;
+    
+    v->seq++;                                       /* Odd sequence, GUI thread does not use value */
+    for (k = 0; k < sizeof(v->v.str) - 1 && str[k]; k++) {
+        v->v.str[k] = str[k];
+    }
+    v->v.str[k] = 0;
+    v->seq++;
+    bind_notify();
+}
+
+/**
+ * \brief           Bind widget text to value slot
+ * \note            Text of widget is formatted by GUI thread on next frame and every time slot changes.
+ *                  Widget can be bound to one slot, binding again replaces previous slot
+ * \param[in,out]   h: Widget handle
+ * \param[in]       v: Value slot. Slot must stay valid until widget is deleted or binding is removed
+ * \param[in]       fmt: Printf style format with one modifier matching slot type, for example `"%d mV"`.
+ *                      Must stay valid while binding exists. Set to `NULL` to use `%ld`, `%.2f` or `%s`
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_bind_remove
+ */
+uint8_t
+gui_bind_widget(gui_handle_p h, const gui_bind_value_t* v, const char* fmt) {
+    bind_t* b = NULL;
+    size_t i;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h) && v != NULL);   /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    for (i = 0; i < GUI_COUNT_OF(binds); i++) {
+        if (binds[i].h == h) {                      /* Widget already bound */
+            b = &binds[i];
+            break;
+        }
+        if (b == NULL && binds[i].h == NULL) {
+            b = &binds[i];
+        }
+    }
+    if (b != NULL) {
+        b->h = h;
+        b->v = v;
+        b->fmt = fmt;
+        b->valid = 0;                               /* Format on next frame */
+        bind_notify();
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return b != NULL;
+}
+
+/**
+ * \brief           Remove binding of widget
+ * \note            Widget with dynamic text memory keeps last formatted text,
+ *                  text of other widgets is cleared as binding memory is reused by next binding
+ * \param[in,out]   h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_bind_widget
+ */
+uint8_t
+gui_bind_remove(gui_handle_p h) {
+    size_t i;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    for (i = 0; i < GUI_COUNT_OF(binds); i++) {
+        if (binds[i].h == h) {
+            if (h->text == binds[i].text) {         /* Widget shows text from binding memory */
+                guii_widget_settext(h, NULL);
+            }
+            binds[i].h = NULL;
+        }
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+#endif /* GUI_CFG_BIND_COUNT || __DOXYGEN__ */
@@ -52,7 +52,7 @@ gui_buffer_init(GUI_BUFFER_t* Buffer, uint32_t Size, void* BufferPtr) {
 	Buffer->Buffer = BufferPtr;
 	
 	if (!Buffer->Buffer) {                      			/* Check if malloc should be used */
-		Buffer->Buffer = GUI_MEMALLOC(Size * sizeof(uint8_t));  /* Try to allocate memory for buffer */
+		Buffer->Buffer = GUI_MEMALLOC_NOZERO(Size * sizeof(uint8_t));  /* Try to allocate memory for buffer */
 		if (Buffer->Buffer == NULL) {                  	    /* Check if allocated */    
 			Buffer->Size = 0;                               /* Reset size */
 			return 1;                           			/* Return error */
@@ -199,6 +199,161 @@ gui_buffer_read(GUI_BUFFER_t* Buffer, void* Data, uint32_t count) {
 #endif
 }
 
+/**
+ * \brief  Reads data from buffer without removing it
+ * \param  *Buffer: Pointer to \ref GUI_BUFFER_t structure
+ * \param  skip: Number of elements to skip before first element copied to output
+ * \param  *Data: Pointer to data where read values will be stored
+ * \param  count: Number of elements of type unsigned char to read
+ * \return Number of elements copied to output
+ */
+uint32_t
+gui_buffer_peek(GUI_BUFFER_t* Buffer, uint32_t skip, void* Data, uint32_t count) {
+	uint32_t full, r, tocopy;
+    uint8_t *d = (uint8_t *)Data;
+	
+	if (Buffer == NULL || count == 0) {						/* Check buffer structure */
+		return 0;
+	}
+	full = gui_buffer_getfull(Buffer);						/* Get number of elements in buffer */
+	if (skip >= full) {										/* Nothing left after skipped elements */
+		return 0;
+	}
+	full -= skip;
+	if (full < count) {										/* Check available memory */
+		count = full;
+	}
+	r = Buffer->Out >= Buffer->Size ? 0 : Buffer->Out;		/* Start of data */
+	r += skip;
+	if (r >= Buffer->Size) {								/* Skipped elements wrap around */
+		r -= Buffer->Size;
+	}
+	tocopy = Buffer->Size - r;								/* Elements until end of buffer */
+	if (tocopy > count) {
+		tocopy = count;
+	}
+	memcpy(d, &Buffer->Buffer[r], tocopy);					/* Copy content from buffer */
+	if (count > tocopy) {									/* Rest is at start of buffer */
+		memcpy(&d[tocopy], Buffer->Buffer, count - tocopy);
+	}
+	return count;											/* Return number of copied elements */
+}
+
+/**
+ * \brief  Gets address of linear block of elements ready to read
+ * \note   Elements are processed in place and released with \ref gui_buffer_skip.
+ *           When data wraps around end of buffer, call function again after skip to get second part
+ * \param  *Buffer: Pointer to \ref GUI_BUFFER_t structure
+ * \param  *count: Pointer to output number of elements in linear block
+ * \return Address of first element to read or NULL when buffer is empty
+ */
+void*
+gui_buffer_getlinearread(GUI_BUFFER_t* Buffer, uint32_t* count) {
+	uint32_t in, out;
+	
+	*count = 0;
+	if (Buffer == NULL || Buffer->Buffer == NULL) {			/* Check buffer structure */
+		return NULL;
+	}
+	in = Buffer->In;										/* Save values */
+	out = Buffer->Out >= Buffer->Size ? 0 : Buffer->Out;
+	if (in == out) {										/* Buffer is empty */
+		return NULL;
+	}
+	*count = in > out ? in - out : Buffer->Size - out;		/* Elements until write pointer or end of buffer */
+	return &Buffer->Buffer[out];
+}
+
+/**
+ * \brief  Removes elements from buffer without copying them
+ * \param  *Buffer: Pointer to \ref GUI_BUFFER_t structure
+ * \param  count: Number of elements to remove
+ * \return Number of elements removed from buffer
+ */
+uint32_t
+gui_buffer_skip(GUI_BUFFER_t* Buffer, uint32_t count) {
+	uint32_t full;
+	
+	if (Buffer == NULL || count == 0) {						/* Check buffer structure */
+		return 0;
+	}
+	full = gui_buffer_getfull(Buffer);						/* Get number of elements in buffer */
+	if (full < count) {
+		count = full;
+	}
+	if (Buffer->Out >= Buffer->Size) {						/* Check output pointer */
+		Buffer->Out = 0;
+	}
+	Buffer->Out += count;
+	if (Buffer->Out >= Buffer->Size) {						/* Check output overflow */
+		Buffer->Out -= Buffer->Size;
+	}
+	return count;
+}
+
+/**
+ * \brief  Gets address of linear block of free elements to write to
+ * \note   Elements are written in place and published with \ref gui_buffer_advance.
+ *           When free memory wraps around end of buffer, call function again after advance to get second part
+ * \param  *Buffer: Pointer to \ref GUI_BUFFER_t structure
+ * \param  *count: Pointer to output number of free elements in linear block
+ * \return Address of first free element or NULL when buffer is full
+ */
+void*
+gui_buffer_getlinearwrite(GUI_BUFFER_t* Buffer, uint32_t* count) {
+	uint32_t in, out, free;
+	
+	*count = 0;
+	if (Buffer == NULL || Buffer->Buffer == NULL) {			/* Check buffer structure */
+		return NULL;
+	}
+	if (Buffer->In >= Buffer->Size) {						/* Check input pointer */
+		Buffer->In = 0;
+	}
+	in = Buffer->In;										/* Save values */
+	out = Buffer->Out;
+	if (out > in) {											/* Free memory is up to read pointer, one element stays empty */
+		free = out - in - 1;
+	} else {												/* Free memory is up to end of buffer */
+		free = Buffer->Size - in;
+		if (out == 0) {										/* Read pointer at start, last element stays empty */
+			free--;
+		}
+	}
+	if (free == 0) {										/* Buffer is full */
+		return NULL;
+	}
+	*count = free;
+	return &Buffer->Buffer[in];
+}
+
+/**
+ * \brief  Publishes elements written in place to buffer
+ * \param  *Buffer: Pointer to \ref GUI_BUFFER_t structure
+ * \param  count: Number of elements written to address from \ref gui_buffer_getlinearwrite
+ * \return Number of elements added to buffer
+ */
+uint32_t
+gui_buffer_advance(GUI_BUFFER_t* Buffer, uint32_t count) {
+	uint32_t free;
+	
+	if (Buffer == NULL || count == 0) {						/* Check buffer structure */
+		return 0;
+	}
+	free = gui_buffer_getfree(Buffer);						/* Get free memory */
+	if (free < count) {
+		count = free;
+	}
+	if (Buffer->In >= Buffer->Size) {						/* Check input pointer */
+		Buffer->In = 0;
+	}
+	Buffer->In += count;
+	if (Buffer->In >= Buffer->Size) {						/* Check input overflow */
+		Buffer->In -= Buffer->Size;
+	}
+	return count;
+}
+
 /**
  * \brief  Gets number of free elements in buffer 
  * \param  *Buffer: Pointer to \ref GUI_BUFFER_t structure
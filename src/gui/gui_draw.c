@@ -31,6 +31,7 @@
 #define GUI_INTERNAL
 #include "gui/gui_private.h"
 #include "gui/gui_draw.h"
+#include "math.h"
 
 typedef struct {
     size_t Lines;                                   /*!< Number of lines processed */
@@ -40,6 +41,7 @@ typedef struct {
     size_t IsEditMode;                              /*!< Status whether text is in edit mode */
     size_t ReadTotal;                               /*!< Total number of characters to read */
     size_t ReadDraw;                                /*!< Total number of characters to actually draw after read */
+    const gui_char* ReadEnd;                        /*!< End of text read for last line. In multi-line mode one byte after termination when complete text was read */
 
     gui_draw_font_t* StringDraw;                    /*!< Pointer to object to draw string */
     const gui_font_t* Font;                         /*!< Pointer to used font */
@@ -69,44 +71,183 @@ typedef struct {
 #define CH_WS           GUI_KEY_WS
 #define get_char_from_value(ch)      (uint32_t)((CH_CR == (ch) || CH_LF == (ch)) ? CH_WS : (ch))
 
-static gui_stringrectvars_t var;
+/**
+ * \brief           Character cache and image line buffers, shared by all GUI instances
+ */
+typedef struct {
+    gui_linkedlistroot_t RootFonts;                 /*!< Root linked list of font widgets */
+    gui_font_charentry_t* FontHash[GUI_CFG_FONT_CACHE_HASH_SIZE];   /*!< Hash buckets of character entries for fast lookup */
+    gui_draw_font_cache_stats_t FontCache;          /*!< Font character cache statistics */
+    uint8_t* ImageBuff;                             /*!< Buffer for decoded lines of compressed images */
+    size_t ImageBuffSize;                           /*!< Size of image buffer in units of bytes */
+#if GUI_CFG_LCD_ROTATION || __DOXYGEN__
+    uint8_t* RotateBuff;                            /*!< Buffer for image lines rotated to display memory */
+    size_t RotateBuffSize;                          /*!< Size of rotation buffer in units of bytes */
+#endif /* GUI_CFG_LCD_ROTATION || __DOXYGEN__ */
+#if GUI_CFG_FONT_FALLBACK_CACHE_SIZE || __DOXYGEN__
+    gui_font_fallback_t FontFallback[GUI_CFG_FONT_FALLBACK_CACHE_SIZE]; /*!< Memorized character lookups in fallback fonts */
+#endif /* GUI_CFG_FONT_FALLBACK_CACHE_SIZE || __DOXYGEN__ */
+#if GUI_CFG_FONT_LINE_COMPOSE || __DOXYGEN__
+    uint8_t* TextStrip;                             /*!< Buffer for text line composed before blending */
+    size_t TextStripSize;                           /*!< Size of text strip buffer in units of bytes */
+#endif /* GUI_CFG_FONT_LINE_COMPOSE || __DOXYGEN__ */
+#if GUI_CFG_MEM_STATIC || __DOXYGEN__
+    uint64_t FontMem[(GUI_CFG_FONT_CACHE_SIZE + 7) / 8];    /*!< Static ring memory of character entries */
+    size_t FontMemHead;                             /*!< Offset of next entry in ring */
+    size_t FontMemTail;                             /*!< Offset of oldest entry in ring */
+    size_t FontMemEnd;                              /*!< End of entries before ring wrapped to start, `0` when not wrapped */
+#endif /* GUI_CFG_MEM_STATIC || __DOXYGEN__ */
+} draw_shared_t;
+
+static draw_shared_t DrawShared;
+
+/**
+ * \brief           Find range of sparse font with character
+ * \note            Ranges are searched with binary search
+ * \param[in]       font: Font with range table
+ * \param[in]       ch: Unicode character for font
+ * \return          Range with character or `NULL` if not in font
+ */
+static const gui_font_range_t *
+font_find_range(const gui_font_t* font, uint32_t ch) {
+    size_t l = 0, r = font->ranges_count, m;
+    
+    while (l < r) {
+        m = l + (r - l) / 2;
+        if (ch < font->ranges[m].startchar) {
+            r = m;
+        } else if (ch > font->ranges[m].endchar) {
+            l = m + 1;
+        } else {
+            return &font->ranges[m];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Find character info in font without fallback character
+ * \note            Fonts with range table are searched with binary search
+ * \param[in]       font: Font to use for drawing
+ * \param[in]       ch: Unicode character for font
+ * \return          Char info of specific font and character code or `NULL` if not in font
+ */
+static const gui_font_char_t *
+font_find_char(const gui_font_t* font, uint32_t ch) {
+    if (font->ranges != NULL) {                     /* Sparse font with range table */
+        const gui_font_range_t* r = font_find_range(font, ch);
+        return r != NULL ? &r->data[ch - r->startchar] : NULL;
+    }
+    if (ch >= font->startchar && ch <= font->endchar) { /* Character is in font structure */
+        return &font->data[ch - font->startchar];  /* Return character pointer from font */
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Find entry in advance table of font without fallback character
+ * \param[in]       font: Font to use for drawing
+ * \param[in]       ch: Unicode character for font
+ * \return          Pointer to advance of character or `NULL` if font or its range has no advance table
+ */
+static const uint8_t *
+font_find_advance(const gui_font_t* font, uint32_t ch) {
+    if (font->ranges != NULL) {                     /* Sparse font with range table */
+        const gui_font_range_t* r = font_find_range(font, ch);
+        return r != NULL && r->advance != NULL ? &r->advance[ch - r->startchar] : NULL;
+    }
+    if (font->advance != NULL && ch >= font->startchar && ch <= font->endchar) {
+        return &font->advance[ch - font->startchar];
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Find character in fallback chain of font
+ * \note            Result is memorized, next lookup of the same character needs no search
+ * \param[in]       font: Font with fallback chain
+ * \param[in]       ch: Unicode character for font
+ * \param[out]      owner: Output variable for font with found character
+ * \return          Char info from fallback font or `NULL` if not in any font
+ */
+static const gui_font_char_t *
+font_find_fallback_char(const gui_font_t* font, uint32_t ch, const gui_font_t** owner) {
+    const gui_font_char_t* c = NULL;
+    const gui_font_t* f;
+#if GUI_CFG_FONT_FALLBACK_CACHE_SIZE
+    gui_font_fallback_t* e = &DrawShared.FontFallback[(((size_t)font >> 2) ^ ch) & (GUI_CFG_FONT_FALLBACK_CACHE_SIZE - 1)];
+    
+    if (e->Font == font && e->ch == ch) {           /* Already resolved */
+        *owner = e->Owner;
+        return e->Ch;
+    }
+#endif /* GUI_CFG_FONT_FALLBACK_CACHE_SIZE */
+    
+    for (f = font->fallback; f != NULL && f != font; f = f->fallback) {
+        if ((c = font_find_char(f, ch)) != NULL) {
+            break;
+        }
+    }
+    *owner = c != NULL ? f : NULL;
+#if GUI_CFG_FONT_FALLBACK_CACHE_SIZE
+    e->Font = font;                                 /* Memorize result, including failed lookup */
+    e->ch = ch;
+    e->Owner = *owner;
+    e->Ch = c;
+#endif /* GUI_CFG_FONT_FALLBACK_CACHE_SIZE */
+    return c;
+}
 
 /**
  * \brief           Get info structure from font for given character
  * \param[in]       font: Font to use for drawing
  * \param[in]       ch: Unicode decoded character for font
+ * \param[out]      owner: Output variable for font the character belongs to. Can be set to `NULL`
  * \return          Char info of specific font and character code
  */
 static const gui_font_char_t *
-string_get_char_ptr(const gui_font_t* font, uint32_t ch) {
+string_get_char_ptr(const gui_font_t* font, uint32_t ch, const gui_font_t** owner) {
+    const gui_font_char_t* c;
+    const gui_font_t* f = font;
+    
     ch = get_char_from_value(ch);                   /* Get char from char value */
-    if (ch >= font->startchar && ch <= font->endchar) { /* Character is in font structure */
-        return &font->data[(ch) - font->startchar]; /* Return character pointer from font */
-    } else if ('?' >= font->startchar && '?' <= font->endchar) {/* Try to return ? character */
-        return &font->data[(uint32_t)'?' - font->startchar];/* Get pointer of ? character */
+    if ((c = font_find_char(font, ch)) == NULL) {   /* Character is not in font structure */
+        if (font->fallback != NULL) {               /* Try fonts in fallback chain */
+            c = font_find_fallback_char(font, ch, &f);
+        }
+        if (c == NULL) {
+            f = font;
+            c = font_find_char(font, (uint32_t)'?');/* Try to return ? character */
+        }
     }
-    return 0;                                       /* No character in font */
+    if (owner != NULL) {
+        *owner = f;
+    }
+    return c;
 }
 
 /**
- * \brief           Get width and height of specific character
+ * \brief           Get width of specific character including right margin
+ * \note            When font has advance table, width is read from it and character info is not accessed.
+ *                  For fonts with \ref GUI_FLAG_FONT_FIXEDWIDTH flag, size of characters in font is known from first character
  * \param[in]       font: Font to use for drawing
  * \param[in]       ch: Unicode decoded character for font
- * \param[out]      width: Output width variable
- * \param[out]      width: Output height variable
+ * \return          Character width in units of pixels
  */
-static void
-string_get_char_size(const gui_font_t* font, uint32_t ch, gui_dim_t* width, gui_dim_t* height) {
+static gui_dim_t
+string_get_char_width(const gui_font_t* font, uint32_t ch) {
     const gui_font_char_t* c = 0;
+    const uint8_t* advance;
     
-    c = string_get_char_ptr(font, ch);              /* Get character from font */
-    if (c != NULL) {
-        *width = c->x_size + c->x_margin;
-        *height = c->y_size;
+    if ((advance = font_find_advance(font, get_char_from_value(ch))) != NULL) {
+        return *advance;                            /* Dense table, measurement touches few cache lines */
+    }
+    if ((font->flags & GUI_FLAG_FONT_FIXEDWIDTH) && font_find_char(font, get_char_from_value(ch)) != NULL) {
+        c = font->ranges != NULL ? font->ranges[0].data : font->data;   /* All characters have the same size as first one */
     } else {
-        *width = 0;
-        *height = 0;
+        c = string_get_char_ptr(font, ch, NULL);    /* Get character from font */
     }
+    return c != NULL ? c->x_size + c->x_margin : 0;
 }
 
 /* Get string rectangle width and height */
@@ -196,7 +337,8 @@ process_string_rectangle_before_return(gui_stringrectvars_t* var, gui_stringrect
  */
 static size_t
 string_rectangle(gui_stringrect_t* rect, gui_string_t* str, uint8_t onlyToNextLine) {
-    gui_dim_t w, h, mW = 0, tH = 0;                /* Maximal width and total height */
+    gui_stringrectvars_t var;                       /* Processing context, local for reentrancy */
+    gui_dim_t w, mW = 0, tH = 0;                   /* Maximal width and total height */
     uint8_t i;
     const gui_char* lastS;
     gui_string_t tmpStr;
@@ -259,7 +401,7 @@ string_rectangle(gui_stringrect_t* rect, gui_string_t* str, uint8_t onlyToNextLi
                     var.spacecount++;               /* Increase number of spaces on last element */
                 } else {                            /* Try to get character size */
                     /* Try to fit character in current line */
-                    string_get_char_size(rect->Font, var.ch, &w, &h);   /* Get character dimensions */
+                    w = string_get_char_width(rect->Font, var.ch);  /* Get character width */
                     if ((var.cW + w) < rect->StringDraw->width) {   /* Do we have enough memory available */
                         var.cW += w;                /* Increase total line width */
                         if (CH_WS == var.ch) {      /* Check if character is white space */
@@ -276,6 +418,7 @@ string_rectangle(gui_stringrect_t* rect, gui_string_t* str, uint8_t onlyToNextLi
 
                 /* Check if line should be "closed" */
                 if (var.Final) {                    /* Is this final for this line? */
+                    rect->ReadEnd = var.s.Str;      /* Line break depends on text until here */
                     process_string_rectangle_before_return(&var, rect, 0);
 
                     if (mW < var.cW) {              /* Check for width value */
@@ -296,6 +439,7 @@ string_rectangle(gui_stringrect_t* rect, gui_string_t* str, uint8_t onlyToNextLi
                     RECT_CONTINUE(1);
                 }
             } else {                                /* Everything has been read and line may still be free */
+                rect->ReadEnd = lastS + 1;          /* Line depends also on end of text */
                 process_string_rectangle_before_return(&var, rect, 1);  /* Process size before return */
                 tH += rect->StringDraw->Lineheight; /* Increase line height for next line processing */
                 if (mW < var.cW) {                  /* Current width check */
@@ -308,7 +452,7 @@ string_rectangle(gui_stringrect_t* rect, gui_string_t* str, uint8_t onlyToNextLi
     } else {
         var.cW = 0;
         while (gui_string_getch(&var.s, &var.ch, &i)) { /* Get next character from string */
-            string_get_char_size(rect->Font, var.ch, &w, &h);   /* Get character width and height */
+            w = string_get_char_width(rect->Font, var.ch);  /* Get character width */
             if (!(rect->StringDraw->flags & GUI_FLAG_FONT_RIGHTALIGN) && (var.cW + w) > rect->StringDraw->width) {  /* Check if end now */
                 break;
             }
@@ -318,6 +462,7 @@ string_rectangle(gui_stringrect_t* rect, gui_string_t* str, uint8_t onlyToNextLi
             var.cnt++;                              /* Increase number of characters to read */
         }
         rect->ReadTotal = rect->ReadDraw = var.cnt; /* Set values for drawing and reading */
+        rect->ReadEnd = var.s.Str;
         rect->width = var.cW;                       /* Save width value */
         tH += rect->StringDraw->Lineheight;         /* Set line height */
     }
@@ -326,24 +471,355 @@ string_rectangle(gui_stringrect_t* rect, gui_string_t* str, uint8_t onlyToNextLi
 }
 
 /**
- * \brief           Get character entry generated in memory for fast drawing
+ * \brief           Get hash bucket index for font character
+ * \note            Character pointer is unique for each font in the system
+ * \param[in]       c: Character info handle
+ * \return          Bucket index in range of \ref GUI_CFG_FONT_CACHE_HASH_SIZE
+ */
+#define FONT_HASH(c)                ((((size_t)(c) >> 2) ^ ((size_t)(c) >> 9)) & (GUI_CFG_FONT_CACHE_HASH_SIZE - 1))
+
+#if GUI_CFG_FONT_PREWARM_QUEUE || __DOXYGEN__
+
+/* Table of strings with characters to prepare in RAM */
+typedef struct {
+    const gui_font_t* font;                         /*!< Font of characters, `NULL` when slot is free */
+    const gui_char* const* strings;                 /*!< List of strings */
+    size_t count;                                   /*!< Number of strings in list */
+    size_t index;                                   /*!< Index of currently processed string */
+    gui_string_t s;                                 /*!< Position in currently processed string */
+} font_prewarm_t;
+
+static font_prewarm_t prewarm_queue[GUI_CFG_FONT_PREWARM_QUEUE];
+static gui_idle_task_t prewarm_task;
+static uint8_t font_prewarm_process(uint32_t budget, void* arg);
+
+#endif /* GUI_CFG_FONT_PREWARM_QUEUE || __DOXYGEN__ */
+
+/**
+ * \brief           Find character entry in hash map without changing its use order
  * \param[in]       font: Font used for character
  * \param[in]       c: Character info handle
- * \return          Character entry or NULL on failure
+ * \return          Character entry or NULL when character is not in memory
  */
 static gui_font_charentry_t *
-get_char_entry_from_font(const gui_font_t* font, const gui_font_char_t* c) {
+find_char_entry(const gui_font_t* font, const gui_font_char_t* c) {
     gui_font_charentry_t* entry;
     
-    for (entry = (gui_font_charentry_t *)gui_linkedlist_getnext_gen(&GUI.RootFonts, NULL); entry != NULL;
-        entry = (gui_font_charentry_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)entry)) {
+    for (entry = DrawShared.FontHash[FONT_HASH(c)]; entry != NULL; entry = entry->hash_next) {
+#if GUI_CFG_LCD_ROTATION
+        if (entry->Font == font && entry->Ch == c && entry->rotation == GUI.lcd.rotation) {
+#else /* GUI_CFG_LCD_ROTATION */
         if (entry->Font == font && entry->Ch == c) {
+#endif /* !GUI_CFG_LCD_ROTATION */
             return entry;
         }
     }
+    return NULL;
+}
+
+/**
+ * \brief           Get character entry generated in memory for fast drawing
+ * \param[in]       font: Font used for character
+ * \param[in]       c: Character info handle
+ * \return          Character entry or NULL on failure
+ */
+static gui_font_charentry_t *
+get_char_entry_from_font(const gui_font_t* font, const gui_font_char_t* c) {
+    gui_font_charentry_t* entry;
+    
+    if ((entry = find_char_entry(font, c)) != NULL) {
+        /* Move entry to the end of list as most recently used */
+        gui_linkedlist_remove_gen(&DrawShared.RootFonts, (gui_linkedlist_t *)entry);
+        gui_linkedlist_add_gen(&DrawShared.RootFonts, (gui_linkedlist_t *)entry);
+        DrawShared.FontCache.hits++;
+        return entry;
+    }
+    DrawShared.FontCache.misses++;
     return 0;
 }
 
+/**
+ * \brief           Remove character entry from cache and free its memory
+ * \param[in]       entry: Character entry to remove
+ */
+static void
+remove_char_entry(gui_font_charentry_t* entry) {
+    gui_font_charentry_t** bucket;
+    
+    /* Remove entry from hash bucket */
+    for (bucket = &DrawShared.FontHash[FONT_HASH(entry->Ch)]; *bucket != NULL; bucket = &(*bucket)->hash_next) {
+        if (*bucket == entry) {
+            *bucket = entry->hash_next;
+            break;
+        }
+    }
+    gui_linkedlist_remove_gen(&DrawShared.RootFonts, (gui_linkedlist_t *)entry);
+    guii_ll_waitready();                            /* Entry may still be used by pending low-level transfer */
+    DrawShared.FontCache.size -= entry->size;
+    DrawShared.FontCache.entries--;
+#if GUI_CFG_MEM_STATIC
+    entry->Font = NULL;                             /* Memory in ring is reused when ring reaches it */
+#else /* GUI_CFG_MEM_STATIC */
+    GUI_MEMFREE(entry);                             /* Free memory */
+#endif /* !GUI_CFG_MEM_STATIC */
+}
+
+#if GUI_CFG_MEM_STATIC || __DOXYGEN__
+
+/**
+ * \brief           Release oldest character entry in static ring memory
+ */
+static void
+font_mem_release(void) {
+    gui_font_charentry_t* entry = (gui_font_charentry_t *)((uint8_t *)DrawShared.FontMem + DrawShared.FontMemTail);
+    
+    if (entry->Font != NULL) {                      /* Entry is still in cache */
+        remove_char_entry(entry);
+        DrawShared.FontCache.evictions++;
+    }
+    DrawShared.FontMemTail += entry->size;
+    if (DrawShared.FontMemEnd && DrawShared.FontMemTail == DrawShared.FontMemEnd) {
+        DrawShared.FontMemTail = 0;                 /* Oldest entries continue at start of ring */
+        DrawShared.FontMemEnd = 0;
+    }
+}
+
+/**
+ * \brief           Allocate memory for character entry from static ring memory
+ * \note            Oldest entries are released until enough contiguous memory is available
+ * \param[in]       size: Number of bytes required for new entry
+ * \return          Pointer to entry memory on success, `NULL` otherwise
+ */
+static void*
+font_mem_alloc(size_t size) {
+    size_t offset;
+    
+    if (size > GUI_CFG_FONT_CACHE_SIZE) {
+        return NULL;
+    }
+    for (;;) {
+        if (DrawShared.FontMemEnd) {                /* Free memory is between head and tail */
+            if (DrawShared.FontMemHead + size <= DrawShared.FontMemTail) {
+                break;
+            }
+        } else if (DrawShared.FontMemHead == DrawShared.FontMemTail) {  /* Ring is empty */
+            DrawShared.FontMemHead = 0;
+            DrawShared.FontMemTail = 0;
+            break;
+        } else if (DrawShared.FontMemHead + size <= GUI_CFG_FONT_CACHE_SIZE) {
+            break;
+        } else if (size <= DrawShared.FontMemTail) {/* Continue at start of ring */
+            DrawShared.FontMemEnd = DrawShared.FontMemHead;
+            DrawShared.FontMemHead = 0;
+            break;
+        }
+        font_mem_release();
+    }
+    offset = DrawShared.FontMemHead;
+    DrawShared.FontMemHead += size;
+    return (uint8_t *)DrawShared.FontMem + offset;
+}
+
+#else /* GUI_CFG_MEM_STATIC || __DOXYGEN__ */
+
+/**
+ * \brief           Remove least recently used character entries until required memory is available
+ * \param[in]       size: Number of bytes required for new entry
+ */
+static void
+release_char_entries(size_t size) {
+#if GUI_CFG_FONT_CACHE_SIZE
+    gui_font_charentry_t* entry;
+    
+    while (DrawShared.FontCache.size + size > GUI_CFG_FONT_CACHE_SIZE
+        && (entry = (gui_font_charentry_t *)gui_linkedlist_getnext_gen(&DrawShared.RootFonts, NULL)) != NULL) {
+        remove_char_entry(entry);
+        DrawShared.FontCache.evictions++;
+    }
+#else
+    GUI_UNUSED(size);
+#endif /* GUI_CFG_FONT_CACHE_SIZE */
+}
+
+#endif /* !(GUI_CFG_MEM_STATIC || __DOXYGEN__) */
+
+#if (GUI_CFG_MEM_RECLAIM && !GUI_CFG_MEM_STATIC) || __DOXYGEN__
+
+static gui_mem_reclaim_t font_reclaim;
+
+/**
+ * \brief           Memory reclaimer of glyph cache, least recently used characters are released first
+ * \note            Most recently used character is kept, it may be drawn right now
+ * \param[in]       size: Number of bytes of failed allocation
+ * \param[in]       arg: Unused
+ * \return          Number of released bytes
+ */
+static size_t
+font_reclaim_fn(size_t size, void* arg) {
+    gui_font_charentry_t* entry;
+    size_t released = 0;
+    
+    GUI_UNUSED(arg);
+    while (released < size
+        && (entry = (gui_font_charentry_t *)gui_linkedlist_getnext_gen(&DrawShared.RootFonts, NULL)) != NULL
+        && gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)entry) != NULL) {
+        released += entry->size;
+        remove_char_entry(entry);
+        DrawShared.FontCache.evictions++;
+    }
+    return released;
+}
+
+#endif /* (GUI_CFG_MEM_RECLAIM && !GUI_CFG_MEM_STATIC) || __DOXYGEN__ */
+
+/**
+ * \brief           Remove all cached data of font before font memory is released
+ * \param[in]       font: Font to remove from caches
+ */
+void
+guii_draw_font_release(const gui_font_t* font) {
+    gui_font_charentry_t *entry, *next;
+    
+    for (entry = (gui_font_charentry_t *)gui_linkedlist_getnext_gen(&DrawShared.RootFonts, NULL); entry != NULL; entry = next) {
+        next = (gui_font_charentry_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)entry);
+        if (entry->Font == font) {
+            remove_char_entry(entry);
+        }
+    }
+#if GUI_CFG_FONT_PREWARM_QUEUE
+    {
+        size_t i;
+        for (i = 0; i < GUI_COUNT_OF(prewarm_queue); i++) {
+            if (prewarm_queue[i].font == font) {
+                prewarm_queue[i].font = NULL;       /* Characters must not be prepared again */
+            }
+        }
+    }
+#endif /* GUI_CFG_FONT_PREWARM_QUEUE */
+#if GUI_CFG_FONT_FALLBACK_CACHE_SIZE
+    {
+        size_t i;
+        for (i = 0; i < GUI_COUNT_OF(DrawShared.FontFallback); i++) {
+            if (DrawShared.FontFallback[i].Font == font || DrawShared.FontFallback[i].Owner == font) {
+                memset(&DrawShared.FontFallback[i], 0x00, sizeof(DrawShared.FontFallback[i]));
+            }
+        }
+    }
+#endif /* GUI_CFG_FONT_FALLBACK_CACHE_SIZE */
+}
+
+/**
+ * \brief           Character data reader for raw or run-length compressed characters
+ */
+typedef struct {
+    const uint8_t* data;                            /*!< Raw data or next compressed byte */
+    uint32_t pos;                                   /*!< Index of next byte to decode */
+    uint8_t rle;                                    /*!< Set to 1 when data are compressed */
+    uint8_t b;                                      /*!< Last decoded byte */
+    uint8_t run;                                    /*!< Number of bytes left in current block */
+    uint8_t repeat;                                 /*!< Set to non-zero when current block is repeated byte */
+} char_data_t;
+
+/**
+ * \brief           Prepare reader for character data
+ * \param[out]      r: Reader to prepare
+ * \param[in]       font: Font used for character
+ * \param[in]       c: Character info handle
+ */
+static void
+char_data_init(char_data_t* r, const gui_font_t* font, const gui_font_char_t* c) {
+    memset(r, 0x00, sizeof(*r));
+    r->data = c->data;
+    r->rle = (font->flags & GUI_FLAG_FONT_RLE) ? 1 : 0;
+}
+
+/**
+ * \brief           Get byte of character data
+ * \note            For compressed characters index must not be lower than index of previous call
+ * \param[in,out]   r: Character data reader
+ * \param[in]       index: Byte index in uncompressed data
+ * \return          Data byte
+ */
+static uint8_t
+char_data_get(char_data_t* r, uint32_t index) {
+    if (!r->rle) {                                  /* Raw data have random access */
+        return r->data[index];
+    }
+    while (r->pos <= index) {                       /* Decode until requested byte */
+        if (!r->run) {                              /* Start new block */
+            r->repeat = *r->data & 0x80;
+            r->run = (*r->data++ & 0x7F) + 1;
+            if (r->repeat) {
+                r->b = *r->data++;                  /* Repeated value follows control byte */
+            }
+        }
+        if (!r->repeat) {
+            r->b = *r->data++;                      /* Literal value */
+        }
+        r->run--;
+        r->pos++;
+    }
+    return r->b;
+}
+
+/**
+ * \brief           Get alpha of single pixel of character
+ * \note            For compressed characters pixels must be read line by line from left to right
+ * \param[in,out]   r: Character data reader
+ * \param[in]       font: Font used for character
+ * \param[in]       c: Character info handle
+ * \param[in]       x: Pixel X position in character
+ * \param[in]       y: Pixel Y position in character
+ * \return          8-bit alpha of pixel
+ */
+static uint8_t
+char_data_alpha(char_data_t* r, const gui_font_t* font, const gui_font_char_t* c, uint16_t x, uint16_t y) {
+    uint8_t b;
+    
+    if (font->flags & GUI_FLAG_FONT_A8) {
+        return char_data_get(r, (uint32_t)y * c->x_size + x);
+    } else if (font->flags & GUI_FLAG_FONT_A4) {
+        b = char_data_get(r, (uint32_t)y * ((c->x_size + 1) >> 1) + (x >> 1));
+        return ((x & 0x01) ? (b >> 4) : (b & 0x0F)) * 0x11;    /* Scale 4-bit to 8-bit alpha */
+    } else if (font->flags & GUI_FLAG_FONT_AA) {
+        b = char_data_get(r, (uint32_t)y * ((c->x_size + 3) >> 2) + (x >> 2));
+        return ((b >> (6 - 2 * (x & 0x03))) & 0x03) * 0x55;    /* Scale 2-bit to 8-bit alpha */
+    }
+    b = char_data_get(r, (uint32_t)y * ((c->x_size + 7) >> 3) + (x >> 3));
+    return ((b >> (7 - (x & 0x07))) & 0x01) * 0xFF;
+}
+
+/**
+ * \brief           Get width and height of character image prepared in RAM
+ * \note            Image is rotated to display memory when screen is rotated
+ * \param[in]       c: Character info handle
+ * \return          Number of pixels per line or number of lines
+ */
+#if GUI_CFG_LCD_ROTATION || __DOXYGEN__
+#define CHAR_ENTRY_WIDTH(c)         ((GUI.lcd.rotation & 0x01) ? (c)->y_size : (c)->x_size)
+#define CHAR_ENTRY_HEIGHT(c)        ((GUI.lcd.rotation & 0x01) ? (c)->x_size : (c)->y_size)
+#else /* GUI_CFG_LCD_ROTATION || __DOXYGEN__ */
+#define CHAR_ENTRY_WIDTH(c)         ((c)->x_size)
+#define CHAR_ENTRY_HEIGHT(c)        ((c)->y_size)
+#endif /* !(GUI_CFG_LCD_ROTATION || __DOXYGEN__) */
+
+/**
+ * \brief           Get number of bytes for single line of character prepared in RAM
+ * \param[in]       c: Character info handle
+ * \return          Number of bytes per line, taking \ref GUI_FLAG_LCD_CHAR_A4 into account
+ */
+#define CHAR_ENTRY_LINE_SIZE(c)     ((GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) ? ((CHAR_ENTRY_WIDTH(c) + 1) >> 1) : CHAR_ENTRY_WIDTH(c))
+
+/**
+ * \brief           Check if character data of font can be copied by low-level directly from font memory
+ * \note            Data must not be compressed and must have the same alpha format as low-level expects.
+ *                  Line size of such data is equal to \ref CHAR_ENTRY_LINE_SIZE when screen is not rotated
+ * \param[in]       font: Font to check
+ * \return          Non-zero when RAM cache entry is not needed
+ */
+#define CHAR_DATA_DIRECT(font)      (!((font)->flags & GUI_FLAG_FONT_RLE) &&  \
+    ((font)->flags & ((GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) ? GUI_FLAG_FONT_A4 : GUI_FLAG_FONT_A8)))
+
 /* Create char and put it to RAM for fast drawing with memory to memory copy */
 static gui_font_charentry_t *
 create_char_entry_from_font(const gui_font_t* font, const gui_font_char_t* c) {
@@ -353,43 +829,88 @@ create_char_entry_from_font(const gui_font_t* font, const gui_font_char_t* c) {
     uint16_t memDataSize;
     
     /* Calculate memory size for data */
-    memDataSize = c->x_size * c->y_size;
+    memDataSize = CHAR_ENTRY_LINE_SIZE(c) * CHAR_ENTRY_HEIGHT(c);
     
     memsize += GUI_MEM_ALIGN(memDataSize);          /* align memory before increase */
-    entry = GUI_MEMALLOC(memsize);                  /* Allocate memory for entry */
+#if GUI_CFG_MEM_STATIC
+    entry = font_mem_alloc(memsize);                /* Oldest entries are released when ring is full */
+#else /* GUI_CFG_MEM_STATIC */
+    release_char_entries(memsize);                  /* Make sure we are inside cache limits */
+#if GUI_CFG_MEM_RECLAIM
+    if (!font_reclaim.added) {
+        gui_mem_reclaim_add(&font_reclaim, font_reclaim_fn, NULL, GUI_MEM_RECLAIM_PRIO_GLYPH);
+    }
+#endif /* GUI_CFG_MEM_RECLAIM */
+    GUI_MEM_TAGGED(GUI_MEM_TAG_GLYPH, entry = GUI_MEMALLOC_NOZERO_HINT(memsize, GUI_MEM_BULK));    /* Allocate memory for entry, character image is read by low-level only */
+#endif /* !GUI_CFG_MEM_STATIC */
     if (entry != NULL) {                            /* Allocation was successful */
         uint16_t i, x;
         uint8_t b, k, t;
+        char_data_t r;
         uint8_t* ptr = (uint8_t *)entry;            /* Go to memory size */
         ptr += GUI_MEM_ALIGN(sizeof(*entry));       /* Go to start of data, at the end of aligned structure size */
         
+        memset(entry, 0x00, sizeof(*entry));
+        if (GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) { /* Packed pixels are merged to existing byte */
+            memset(ptr, 0x00, memDataSize);
+        }
+        entry->size = memsize;                      /* Save entry size */
         entry->Ch = c;                              /* Set pointer to character */
         entry->Font = font;                         /* Set pointer to font structure */
+        char_data_init(&r, font, c);                /* Compressed data are decompressed only here */
         
-        if (font->flags & GUI_FLAG_FONT_AA) {       /* Anti-alliased font */
+#if GUI_CFG_LCD_ROTATION
+        entry->rotation = GUI.lcd.rotation;
+        if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {   /* Rotate image once, drawing is then plain copy */
+            uint16_t line = CHAR_ENTRY_LINE_SIZE(c);
+            uint16_t y;
+            gui_dim_t bx, by, bw, bh;
+            
+            for (y = 0; y < c->y_size; y++) {
+                for (x = 0; x < c->x_size; x++) {
+                    t = char_data_alpha(&r, font, c, x, y);
+                    bx = x;
+                    by = y;
+                    bw = bh = 1;
+                    guii_lcd_rotaterect(GUI.lcd.rotation, c->x_size, c->y_size, &bx, &by, &bw, &bh);
+                    if (GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) {
+                        ptr[by * line + (bx >> 1)] |= (bx & 0x01) ? (t & 0xF0) : (t >> 4);
+                    } else {
+                        ptr[by * line + bx] = t;
+                    }
+                }
+            }
+        } else
+#endif /* GUI_CFG_LCD_ROTATION */
+        if (GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) { /* Low-level accepts packed 4-bit alpha */
+            uint16_t line = CHAR_ENTRY_LINE_SIZE(c);
+            uint16_t y;
+            
+            for (y = 0; y < c->y_size; y++) {
+                for (x = 0; x < c->x_size; x++) {
+                    t = char_data_alpha(&r, font, c, x, y) >> 4;
+                    ptr[y * line + (x >> 1)] |= (x & 0x01) ? (t << 4) : t;  /* First pixel is in low nibble */
+                }
+            }
+        } else if (font->flags & (GUI_FLAG_FONT_A8 | GUI_FLAG_FONT_A4)) {   /* Compressed 8-bit or 4-bit alpha */
+            uint16_t y;
+            
+            for (y = 0; y < c->y_size; y++) {
+                for (x = 0; x < c->x_size; x++) {
+                    *ptr++ = char_data_alpha(&r, font, c, x, y);
+                }
+            }
+        } else if (font->flags & GUI_FLAG_FONT_AA) {/* Anti-alliased font */
             columns = c->x_size >> 2;               /* Calculate number of bytes used for single character line */
             if (c->x_size % 4) {                    /* If only 1 column used */
                 columns++;
             }
             x = 0;
             for (i = 0; i < c->y_size * columns; i++) { /* Inspect all vertical lines */
-                b = c->data[i];                     /* Get byte of data */
+                b = char_data_get(&r, i);           /* Get byte of data */
                 for (k = 0; k < 4; k++) {           /* Scan each bit in byte */
                     t = (b >> (6 - 2 * k)) & 0x03;  /* Get temporary bits on bottom */
-                    switch (t) {
-                        case 0:
-                            *ptr |= 0x00;
-                            break;
-                        case 1:
-                            *ptr |= 0x55;
-                            break;
-                        case 2:
-                            *ptr |= 0xAA;
-                            break;
-                        default:
-                            *ptr |= 0xFF;
-                    }
-                    ptr++;
+                    *ptr++ = t * 0x55;              /* Scale 2-bit to 8-bit alpha */
                     x++;
                     if (x == c->x_size) {
                         x = 0;
@@ -404,7 +925,7 @@ create_char_entry_from_font(const gui_font_t* font, const gui_font_char_t* c) {
             }
             x = 0;
             for (i = 0; i < c->y_size * columns; i++) {  /* Inspect all vertical lines */
-                b = c->data[i];                     /* Get byte of data */
+                b = char_data_get(&r, i);           /* Get byte of data */
                 for (k = 0; k < 8; k++) {           /* Scan each bit in byte */
                     if ((b >> (7 - k)) & 0x01) {
                         *ptr++ = 0xFF;
@@ -420,19 +941,213 @@ create_char_entry_from_font(const gui_font_t* font, const gui_font_char_t* c) {
             }
         }
         
-        gui_linkedlist_add_gen(&GUI.RootFonts, (gui_linkedlist_t *)entry);  /* Add entry to linked list */
+        gui_linkedlist_add_gen(&DrawShared.RootFonts, (gui_linkedlist_t *)entry);  /* Add entry to linked list */
+        entry->hash_next = DrawShared.FontHash[FONT_HASH(c)];  /* Add entry to hash bucket */
+        DrawShared.FontHash[FONT_HASH(c)] = entry;
+        DrawShared.FontCache.entries++;
+        DrawShared.FontCache.size += memsize;
+        if (DrawShared.FontCache.size > DrawShared.FontCache.size_max) {
+            DrawShared.FontCache.size_max = DrawShared.FontCache.size;
+        }
     }
     return entry;                                   /* Return new created entry */
 }
 
+#if GUI_CFG_FONT_PREWARM_QUEUE || __DOXYGEN__
+
+/**
+ * \brief           Add table of strings to characters prewarm queue
+ * \param[in]       font: Font to prepare characters for
+ * \param[in]       strings: List of strings
+ * \param[in]       count: Number of strings in list
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+font_prewarm_add(const gui_font_t* font, const gui_char* const* strings, size_t count) {
+    size_t i;
+    
+#if GUI_CFG_OS_RENDER_THREAD
+    return 0;                                       /* Cache is used by rasterizer thread only */
+#endif /* GUI_CFG_OS_RENDER_THREAD */
+    for (i = 0; i < GUI_COUNT_OF(prewarm_queue); i++) {
+        if (prewarm_queue[i].font == NULL) {
+            prewarm_queue[i].font = font;
+            prewarm_queue[i].strings = strings;
+            prewarm_queue[i].count = count;
+            prewarm_queue[i].index = 0;
+            prewarm_queue[i].s.Str = NULL;          /* String is prepared on first step */
+            guii_idle_add(&prewarm_task, font_prewarm_process, NULL, 0, GUI_CFG_FONT_PREWARM_BUDGET);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Idle task preparing next characters of first table in prewarm queue
+ * \note            Table is removed when all its characters are processed or when cache is full,
+ *                  characters prepared for current screen are never released for it
+ * \param[in]       budget: Time available for preparation, in units of microseconds
+ * \param[in]       arg: Unused
+ * \return          `1` when there are more characters to process, `0` otherwise
+ */
+static uint8_t
+font_prewarm_process(uint32_t budget, void* arg) {
+    font_prewarm_t* p = NULL;
+    const gui_font_char_t* c;
+    const gui_font_t* f;
+    uint32_t ch, start;
+    uint8_t len;
+    size_t i, scanned = 0;
+    
+    GUI_UNUSED(arg);
+    for (i = 0; i < GUI_COUNT_OF(prewarm_queue); i++) {
+        if (prewarm_queue[i].font != NULL) {
+            p = &prewarm_queue[i];
+            break;
+        }
+    }
+    if (p == NULL) {
+        return 0;
+    }
+    start = GUI_CFG_IDLE_TIME();
+    /* Most characters are usually in memory already, read time only every few of them */
+    while ((++scanned & 0x0F) || GUI_CFG_IDLE_TIME() - start < budget) {
+        if (p->s.Str == NULL || !gui_string_getch(&p->s, &ch, &len)) {
+            if (p->s.Str != NULL) {
+                p->index++;                         /* Continue with next string */
+            }
+            while (p->index < p->count && p->strings[p->index] == NULL) {
+                p->index++;                         /* Translation tables may have missing entries */
+            }
+            if (p->index >= p->count || !GUI_LL_HAS(CopyChar)) {
+                p->font = NULL;                     /* Table is done */
+                break;
+            }
+            gui_string_prepare(&p->s, p->strings[p->index]);
+            continue;
+        }
+        if (!gui_string_isprintable(ch) || (c = string_get_char_ptr(p->font, ch, &f)) == NULL) {
+            continue;
+        }
+#if GUI_CFG_LCD_ROTATION
+        if (GUI.lcd.rotation == GUI_LCD_ROTATION_0 && CHAR_DATA_DIRECT(f)) {
+#else /* GUI_CFG_LCD_ROTATION */
+        if (CHAR_DATA_DIRECT(f)) {
+#endif /* !GUI_CFG_LCD_ROTATION */
+            continue;                               /* Character is drawn from font memory */
+        }
+        if (find_char_entry(f, c) != NULL) {
+            continue;
+        }
+#if GUI_CFG_FONT_CACHE_SIZE
+        if (DrawShared.FontCache.size + GUI_MEM_ALIGN(sizeof(gui_font_charentry_t))
+            + GUI_MEM_ALIGN(CHAR_ENTRY_LINE_SIZE(c) * CHAR_ENTRY_HEIGHT(c)) > GUI_CFG_FONT_CACHE_SIZE) {
+            p->font = NULL;                         /* Cache is full, stop before characters in use are released */
+            break;
+        }
+#endif /* GUI_CFG_FONT_CACHE_SIZE */
+        if (create_char_entry_from_font(f, c) == NULL) {
+            p->font = NULL;                         /* Out of memory */
+            break;
+        }
+        if (GUI_CFG_IDLE_TIME() - start >= budget) {
+            break;
+        }
+    }
+    for (i = 0; i < GUI_COUNT_OF(prewarm_queue); i++) {
+        if (prewarm_queue[i].font != NULL) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif /* GUI_CFG_FONT_PREWARM_QUEUE || __DOXYGEN__ */
+
+/**
+ * \brief           Blend two colors with integer arithmetic
+ * \param[in]       fg: Foreground color
+ * \param[in]       bg: Background color
+ * \param[in]       a: Foreground alpha, `0xFF` for foreground only
+ * \return          Blended color with alpha of background
+ */
+static gui_color_t
+blend_color(gui_color_t fg, gui_color_t bg, uint8_t a) {
+    uint32_t rb, g;
+    
+    /* Red and blue channels are blended together, (x + 0x80 + (x >> 8)) >> 8 is fast division by 255 */
+    rb = (fg & 0x00FF00FF) * a + (bg & 0x00FF00FF) * (0xFF - a) + 0x00800080;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    g = (fg & 0x0000FF00) * a + (bg & 0x0000FF00) * (0xFF - a) + 0x00008000;
+    g = ((g + (g >> 8)) >> 8) & 0x0000FF00;
+    return (bg & 0xFF000000UL) | rb | g;
+}
+
+#if GUI_CFG_LCD_ROTATION || __DOXYGEN__
+
+/**
+ * \brief           Copy visible part of rotated character image to drawing layer
+ * \param[in]       disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       draw: Font drawing settings with colors
+ * \param[in]       x: Top left X position of character on logical screen
+ * \param[in]       y: Top left Y position of character on logical screen
+ * \param[in]       c: Character info handle
+ * \param[in]       entry: Character entry rotated for current screen rotation
+ * \return          `1` if character was drawn, `0` if software drawing must be used
+ */
+static uint8_t
+draw_char_rotated(const gui_display_t* disp, const gui_draw_font_t* draw, gui_dim_t x, gui_dim_t y, const gui_font_char_t* c, const gui_font_charentry_t* entry) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    const uint8_t* ptr = (const uint8_t *)entry + GUI_MEM_ALIGN(sizeof(*entry));
+    uint8_t a4 = (GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) ? 1 : 0;
+    gui_dim_t x1, x2, y1, y2, split, bx[2], by[2], px, py, pw, ph, bw, bh;
+    uint8_t i;
+    
+    x1 = GUI_MAX(x, disp->x1);
+    x2 = GUI_MIN(x + c->x_size, disp->x2);
+    y1 = GUI_MAX(y, disp->y1);
+    y2 = GUI_MIN(y + c->y_size, disp->y2);
+    split = GUI_MIN(GUI_MAX(draw->x + draw->color1width, x1), x2);  /* Second color starts here */
+    
+    /* Part with each color must start on byte boundary of packed 4-bit data */
+    for (i = 0; i < 2; i++) {
+        bx[i] = (i ? split : x1) - x;
+        by[i] = y1 - y;
+        bw = (i ? x2 : split) - (i ? split : x1);
+        bh = y2 - y1;
+        guii_lcd_rotaterect(GUI.lcd.rotation, c->x_size, c->y_size, &bx[i], &by[i], &bw, &bh);
+        if (a4 && bw > 0 && (bx[i] & 0x01)) {
+            return 0;
+        }
+    }
+    for (i = 0; i < 2; i++) {
+        px = i ? split : x1;
+        py = y1;
+        pw = (i ? x2 : split) - px;
+        ph = y2 - y1;
+        if (pw <= 0 || ph <= 0) {
+            continue;
+        }
+        guii_lcd_maprect(&px, &py, &pw, &ph);
+        GUI_LL(CopyChar)(&GUI.lcd, layer,
+            ptr + by[i] * CHAR_ENTRY_LINE_SIZE(c) + (bx[i] >> a4),
+            (void *)(layer->start_address + layer->pixel_size * ((py - layer->y_offset) * layer->width + (px - layer->x_offset))),
+            pw, ph,
+            (CHAR_ENTRY_LINE_SIZE(c) << a4) - pw, layer->width - pw, i ? draw->Color2 : draw->color1);
+    }
+    return 1;
+}
+
+#endif /* GUI_CFG_LCD_ROTATION || __DOXYGEN__ */
+
 /* Draw character to screen */
 /* X and Y coordinates are TOP LEFT coordinates for character */
 static void
 draw_char(const gui_display_t* disp, const gui_font_t* font, const gui_draw_font_t* draw, gui_dim_t x, gui_dim_t y, const gui_font_char_t* c) {
     uint8_t i, b, k, columns;
     gui_dim_t x1;
-    
-    while (!GUI.ll.IsReady(&GUI.lcd));              /* Wait till ready */
+    char_data_t r;
     
     y += c->y_pos;                                  /* Set Y position */
     
@@ -443,37 +1158,56 @@ draw_char(const gui_display_t* disp, const gui_font_t* font, const gui_draw_font
         return;
     }
     
-    if (GUI.ll.CopyChar != NULL) {                  /* If copying character function exists in low-level part */
+    if (GUI_LL_HAS(CopyChar)) {                     /* If copying character function exists in low-level part */
         gui_font_charentry_t* entry = NULL;
+        const uint8_t* ptr = NULL;
         
-        entry = get_char_entry_from_font(font, c);  /* Get char entry from font and character for fast alpha drawing operations */
-        if (entry == NULL) {
-            entry = create_char_entry_from_font(font, c);   /* Create new entry */
+#if GUI_CFG_LCD_ROTATION
+        if (GUI.lcd.rotation == GUI_LCD_ROTATION_0 && CHAR_DATA_DIRECT(font)) {
+#else /* GUI_CFG_LCD_ROTATION */
+        if (CHAR_DATA_DIRECT(font)) {
+#endif /* !GUI_CFG_LCD_ROTATION */
+            ptr = c->data;                          /* Font data are already in low-level format */
+        } else {
+            entry = get_char_entry_from_font(font, c);  /* Get char entry from font and character for fast alpha drawing operations */
+            if (entry == NULL) {
+                entry = create_char_entry_from_font(font, c);   /* Create new entry */
+            }
+#if GUI_CFG_LCD_ROTATION
+            if (entry != NULL && GUI.lcd.rotation != GUI_LCD_ROTATION_0) {
+                if (draw_char_rotated(disp, draw, x, y, c, entry)) {
+                    return;
+                }
+                entry = NULL;                       /* Draw with software */
+            }
+#endif /* GUI_CFG_LCD_ROTATION */
+            if (entry != NULL) {
+                ptr = (const uint8_t *)entry + GUI_MEM_ALIGN(sizeof(*entry));   /* Go to start of data array */
+            }
         }
-        if (entry != NULL) {                        /* We have valid data */
-            gui_dim_t width, height, offlineSrc, offlineDst, tmpx;
+        if (ptr != NULL) {                          /* We have valid data */
+            gui_dim_t width, height, offlineSrc, offlineDst, tmpx, firstWidth = 0;
             uint8_t* dst = 0;
-            uint8_t* ptr = (uint8_t *)entry;        /* Get pointer */
+            uint8_t a4 = (GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) ? 1 : 0;
             
             tmpx = x;                               /* Start X */
             
-            ptr += sizeof(*entry);                  /* Go to start of data array */
-            dst = (uint8_t *)(GUI.lcd.drawing_layer->start_address + ((y - GUI.lcd.drawing_layer->y_offset) * GUI.lcd.drawing_layer->width + (x - GUI.lcd.drawing_layer->x_offset)) * GUI.lcd.pixel_size);
+            dst = (uint8_t *)(GUI.lcd.drawing_layer->start_address + ((y - GUI.lcd.drawing_layer->y_offset) * GUI.lcd.drawing_layer->width + (x - GUI.lcd.drawing_layer->x_offset)) * GUI.lcd.drawing_layer->pixel_size);
             
             width = c->x_size;                      /* Get X size */
             height = c->y_size;                     /* Get Y size */
             
             if (y < disp->y1) {                     /* Start Y position if outside visible area */
-                ptr += (disp->y1 - y) * c->x_size;  /* Set offset for number of lines */
-                dst += (disp->y1 - y) * GUI.lcd.drawing_layer->width * GUI.lcd.pixel_size;  /* Set offset for number of LCD lines */
+                ptr += (disp->y1 - y) * CHAR_ENTRY_LINE_SIZE(c);    /* Set offset for number of lines */
+                dst += (disp->y1 - y) * GUI.lcd.drawing_layer->width * GUI.lcd.drawing_layer->pixel_size;  /* Set offset for number of LCD lines */
                 height -= disp->y1 - y;             /* Decrease effective height */
             }
             if ((y + c->y_size) > disp->y2) {
                 height -= y + c->y_size - disp->y2; /* Decrease effective height */
             }
             if (x < disp->x1) {                     /* Set offset start address if required */
-                ptr += (disp->x1 - x);              /* Set offset of start address in X direction */
-                dst += (disp->x1 - x) * GUI.lcd.pixel_size; /* Set offset of start address in X direction */
+                ptr += (disp->x1 - x) >> a4;        /* Set offset of start address in X direction */
+                dst += (disp->x1 - x) * GUI.lcd.drawing_layer->pixel_size; /* Set offset of start address in X direction */
                 width -= disp->x1 - x;              /* Increase source offline */
                 tmpx += disp->x1 - x;               /* Increase effective start X position */
             }
@@ -481,76 +1215,66 @@ draw_char(const gui_display_t* disp, const gui_font_t* font, const gui_draw_font
                 width -= x + c->x_size - disp->x2;  /* Decrease effective width */
             }
             
-            offlineSrc = c->x_size - width;         /* Set offline source */
+            offlineSrc = (CHAR_ENTRY_LINE_SIZE(c) << a4) - width;   /* Set offline source */
             offlineDst = GUI.lcd.drawing_layer->width - width;   /* Set offline destination */
             
             /**
              * Check if character must be drawn with 2 colors, on the middle of color switch
              */
             if (tmpx < (draw->x + draw->color1width) && (tmpx + width) > (draw->x + draw->color1width)) {
-                gui_dim_t firstWidth = (draw->x + draw->color1width) - tmpx;
-                
-                /* First part draw */
-                GUI.ll.CopyChar(&GUI.lcd, GUI.lcd.drawing_layer, ptr, dst, 
-                    firstWidth, height,
-                    offlineSrc + width - firstWidth, offlineDst + width - firstWidth, draw->color1);
-                
-                /* Second part draw */
-                GUI.ll.CopyChar(&GUI.lcd, GUI.lcd.drawing_layer, ptr + firstWidth, dst + firstWidth * GUI.lcd.pixel_size, 
-                    width - firstWidth, height,
-                    offlineSrc + firstWidth, offlineDst + firstWidth, draw->Color2);
-            } else {
-                /* Draw entire character with single color */
-                GUI.ll.CopyChar(&GUI.lcd, GUI.lcd.drawing_layer, ptr, dst, 
-                    width, height,
-                    offlineSrc, offlineDst, (draw->x + draw->color1width) > x ? draw->color1 : draw->Color2);
+                firstWidth = (draw->x + draw->color1width) - tmpx;
+            }
+            
+            /*
+             * Packed 4-bit data can only start on byte boundary,
+             * use software drawing when character starts on odd pixel
+             */
+            if (!a4 || (!((tmpx - x) & 0x01) && !(firstWidth & 0x01))) {
+                if (firstWidth) {
+                    /* First part draw */
+                    GUI_LL(CopyChar)(&GUI.lcd, GUI.lcd.drawing_layer, ptr, dst, 
+                        firstWidth, height,
+                        offlineSrc + width - firstWidth, offlineDst + width - firstWidth, draw->color1);
+                    
+                    /* Second part draw */
+                    GUI_LL(CopyChar)(&GUI.lcd, GUI.lcd.drawing_layer, ptr + (firstWidth >> a4), dst + firstWidth * GUI.lcd.drawing_layer->pixel_size, 
+                        width - firstWidth, height,
+                        offlineSrc + firstWidth, offlineDst + firstWidth, draw->Color2);
+                } else {
+                    /* Draw entire character with single color */
+                    GUI_LL(CopyChar)(&GUI.lcd, GUI.lcd.drawing_layer, ptr, dst, 
+                        width, height,
+                        offlineSrc, offlineDst, (draw->x + draw->color1width) > x ? draw->color1 : draw->Color2);
+                }
+                return;
             }
-            return;
         }
     }
     
-    if (font->flags & GUI_FLAG_FONT_AA) {           /* Font has anti alliasing enabled */
-        gui_color_t color;                          /* Temporary color for AA */
-        uint8_t tmp, r1, g1, b1;
-        
-        columns = c->x_size / 4;                    /* Calculate number of bytes used for single character line */
-        if (c->x_size % 4) {                        /* If only 1 column used */
-            columns++;
-        }
+    char_data_init(&r, font, c);                    /* Prepare reader for software drawing */
+    if (font->flags & (GUI_FLAG_FONT_AA | GUI_FLAG_FONT_A8 | GUI_FLAG_FONT_A4)) {   /* Font has alpha for each pixel */
+        gui_color_t baseColor;
+        gui_dim_t row, col;
+        uint8_t a;
         
-        for (i = 0; i < columns * c->y_size; i++) { /* Go through all data bytes */
-            if (y >= disp->y1 && y <= disp->y2 && y < (draw->y + draw->height)) {   /* Do not draw when we are outside clipping are */            
-                b = c->data[i];                     /* Get character byte */
-                for (k = 0; k < 4; k++) {           /* Scan each bit in byte */
-                    gui_color_t baseColor;
-                    x1 = x + (i % columns) * 4 + k; /* Get new X value for pixel draw */
-                    if (x1 < disp->x1 || x1 > disp->x2) {
-                        continue;
-                    }
-                    if (x1 < (draw->x + draw->color1width)) {
-                        baseColor = draw->color1;
-                    } else {
-                        baseColor = draw->Color2;
-                    }
-                    tmp = (b >> (6 - 2 * k)) & 0x03;/* Get temporary bits on bottom */
-                    if (tmp == 0x03) {              /* Draw solid color if both bits are enabled */
-                        gui_draw_setpixel(disp, x1, y, baseColor);
-                    } else if (tmp) {               /* Calculate new color */
-                        float t = (float)tmp / 3.0f;
-                        color = gui_draw_getpixel(disp, x1, y); /* Read current color */
-                        
-                        /* Calculate new values for pixel */
-                        r1 = (float)t * (float)((color >> 16) & 0xFF) + (float)(1.0f - (float)t) * (float)((baseColor >> 16) & 0xFF);
-                        g1 = (float)t * (float)((color >>  8) & 0xFF) + (float)(1.0f - (float)t) * (float)((baseColor >>  8) & 0xFF);
-                        b1 = (float)t * (float)((color >>  0) & 0xFF) + (float)(1.0f - (float)t) * (float)((baseColor >>  0) & 0xFF);
-                        
-                        /* Draw actual pixel to screen */
-                        gui_draw_setpixel(disp, x1, y, (color & 0xFF000000UL) | r1 << 16 | g1 << 8 | b1);
-                    }
-                }
+        for (row = 0; row < c->y_size; row++, y++) {/* Draw character row by row */
+            if (y < disp->y1 || y >= disp->y2 || y >= (draw->y + draw->height)) {  /* Do not draw when we are outside clipping area */
+                continue;
             }
-            if ((i % columns) == (columns - 1)) {   /* Check for next line */
-                y++;
+            for (col = 0; col < c->x_size; col++) {
+                x1 = x + col;                       /* Get new X value for pixel draw */
+                if (x1 < disp->x1 || x1 >= disp->x2) {
+                    continue;
+                }
+                if ((a = char_data_alpha(&r, font, c, col, row)) == 0) {
+                    continue;
+                }
+                baseColor = x1 < (draw->x + draw->color1width) ? draw->color1 : draw->Color2;
+                if (a == 0xFF) {                    /* Draw solid color if both bits are enabled */
+                    gui_draw_setpixel(disp, x1, y, baseColor);
+                } else {                            /* Blend with current pixel */
+                    gui_draw_setpixel(disp, x1, y, blend_color(baseColor, gui_draw_getpixel(disp, x1, y), a));
+                }
             }
         }
     } else {
@@ -560,7 +1284,7 @@ draw_char(const gui_display_t* disp, const gui_font_t* font, const gui_draw_font
         }
         for (i = 0; i < columns * c->y_size; i++) { /* Go through all data bytes */
             if (y >= disp->y1 && y <= disp->y2 && y < (draw->y + draw->height)) {   /* Do not draw when we are outside clipping are */
-                b = c->data[i];                     /* Get character byte */
+                b = char_data_get(&r, i);           /* Get character byte */
                 for (k = 0; k < 8; k++) {           /* Scan each bit in byte */
                     if (b & (1 << (7 - k))) {       /* If bit is set, draw pixel */
                         x1 = x + (i % columns) * 8 + k; /* Get new X value for pixel draw */
@@ -585,7 +1309,7 @@ draw_char(const gui_display_t* disp, const gui_font_t* font, const gui_draw_font
 /* Get string pointer start address for specific width of rectangle */
 static const gui_char *
 string_get_pointer_for_width(const gui_font_t* font, gui_string_t* str, gui_draw_font_t* draw) {
-    gui_dim_t tot = 0, w, h;
+    gui_dim_t tot = 0, w;
     uint8_t i;
     uint32_t ch;
     const gui_char* tmp = str->Str;                 /* Set start of string */
@@ -596,7 +1320,7 @@ string_get_pointer_for_width(const gui_font_t* font, gui_string_t* str, gui_draw
         if (!gui_string_getchreverse(str, &ch, &i)) {   /* Get character in reverse order */
             break;
         }
-        string_get_char_size(font, ch, &w, &h);
+        w = string_get_char_width(font, ch);
         if ((tot + w) < draw->width) {
             tot += w;
         } else {
@@ -607,6 +1331,239 @@ string_get_pointer_for_width(const gui_font_t* font, gui_string_t* str, gui_draw
     return str->Str + i + 1;
 }
 
+#if GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__
+
+/* Commands of display list */
+typedef enum {
+    DL_CLIP = 0x00,                                 /*!< Set clipping region for next commands */
+    DL_FILLSCREEN,
+    DL_PIXEL,
+    DL_HLINE,
+    DL_VLINE,
+    DL_RECTANGLE,
+    DL_FILLEDRECTANGLE,
+    DL_FILLEDRECTANGLES,
+    DL_GRADIENTRECTANGLE,
+    DL_RECTANGLE3D,
+    DL_IMAGE,
+    DL_IMAGE_SCALED,
+    DL_TEXT,
+    DL_LINE_AA,
+    DL_CIRCLE_AA,
+    DL_ARC_AA,
+} dl_op_t;
+
+/* Single command of display list, text and rectangles are followed by variable data */
+typedef struct {
+    uint16_t op;                                    /*!< Command, member of dl_op_t enumeration */
+    uint16_t size;                                  /*!< Size of command with variable data in units of bytes */
+    union {
+        gui_display_t clip;                         /*!< Clipping region of next commands */
+        struct {
+            gui_dim_t x, y, width, height;
+            gui_color_t color;                      /*!< Color or 3D state */
+        } rect;                                     /*!< Pixels, lines and rectangles, length of line is in width */
+        struct {
+            gui_dim_t x, y, width, height;
+            gui_gradient_t gradient;
+            uint8_t dir;
+        } gradient;                                 /*!< Gradient rectangle */
+        struct {
+            gui_dim_t x, y;
+            const gui_image_desc_t* img;
+        } image;                                    /*!< Image */
+        struct {
+            gui_dim_t x, y, width, height;
+            const gui_image_desc_t* img;
+        } scaled;                                   /*!< Image scaled to new size */
+        struct {
+            gui_dim_t x1, y1, x2, y2;
+            gui_color_t color;
+        } line;                                     /*!< Anti-aliased line */
+        struct {
+            gui_dim_t x, y, r;
+            int16_t start, end;
+            gui_color_t color;
+        } arc;                                      /*!< Anti-aliased circle or arc */
+        struct {
+            const gui_font_t* font;
+            gui_draw_font_t draw;
+        } text;                                     /*!< Text, followed by copy of string */
+        size_t count;                               /*!< Number of rectangles following command */
+    } u;
+} dl_cmd_t;
+
+#define DL_CMD_SIZE(memb, extra)    GUI_MEM_ALIGN(offsetof(dl_cmd_t, u) + sizeof(((dl_cmd_t *)0)->u.memb) + (extra))
+#if GUI_CFG_OS_RENDER_THREAD
+/* Rasterizer thread draws previous frame while GUI thread records next one, it never reads recorder state */
+#define DL_RECORDING()              (gui_sys_thread_getid() != GUI.OS.render_thread_id && dl_list != NULL)
+#else /* GUI_CFG_OS_RENDER_THREAD */
+#define DL_RECORDING()              (dl_list != NULL)
+#endif /* !GUI_CFG_OS_RENDER_THREAD */
+
+/* While list is recorded, commands are only added to it and nothing is drawn */
+#define DL_RECORD(call)             do { if (DL_RECORDING()) { call; return; } } while (0)
+
+static gui_dlist_t* dl_list;                        /* Display list being recorded */
+static gui_display_t dl_clip;                       /* Clipping region of last recorded command */
+static uint8_t dl_error;                            /* Set to 1 when command could not be recorded */
+static gui_dlist_t* dl_outer_list;                  /* List recorded before current one was started */
+static uint8_t dl_outer_error;                      /* Error status of outer list */
+
+/* Add command to display list being recorded, returns NULL on failure */
+static dl_cmd_t *
+dl_add(const gui_display_t* disp, dl_op_t op, size_t size) {
+    gui_dlist_t* l = dl_list;
+    uint8_t newclip = l->len == 0 || memcmp(disp, &dl_clip, sizeof(dl_clip));
+    size_t need = size + (newclip ? DL_CMD_SIZE(clip, 0) : 0);
+    dl_cmd_t* cmd;
+    
+    if (dl_error || size > 0xFFFF) {
+        dl_error = 1;
+        return NULL;
+    }
+    if (l->len + need > l->size) {                  /* Grow list */
+        size_t s = GUI_MAX(GUI_MAX(l->size * 2, l->len + need), 128);
+        uint8_t* p;
+        
+        GUI_MEM_TAGGED(GUI_MEM_TAG_DISPLAY_LIST, p = GUI_MEMREALLOC(l->data, s));
+        if (p == NULL) {
+            dl_error = 1;
+            return NULL;
+        }
+        l->data = p;
+        l->size = s;
+    }
+    if (newclip) {                                  /* Widget drawing uses new clipping region */
+        cmd = (dl_cmd_t *)(l->data + l->len);
+        cmd->op = DL_CLIP;
+        cmd->size = DL_CMD_SIZE(clip, 0);
+        cmd->u.clip = *disp;
+        dl_clip = *disp;
+        l->len += cmd->size;
+    }
+    cmd = (dl_cmd_t *)(l->data + l->len);
+    cmd->op = op;
+    cmd->size = (uint16_t)size;
+    l->len += size;
+    return cmd;
+}
+
+/* Record rectangle based command */
+static void
+dl_add_rect(const gui_display_t* disp, dl_op_t op, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color) {
+    dl_cmd_t* cmd = dl_add(disp, op, DL_CMD_SIZE(rect, 0));
+    
+    if (cmd != NULL) {
+        cmd->u.rect.x = x;
+        cmd->u.rect.y = y;
+        cmd->u.rect.width = width;
+        cmd->u.rect.height = height;
+        cmd->u.rect.color = color;
+    }
+}
+
+/* Record anti-aliased circle or arc, full circle has start equal to end */
+static void
+dl_add_arc(const gui_display_t* disp, dl_op_t op, gui_dim_t x, gui_dim_t y, gui_dim_t r, int16_t start, int16_t end, gui_color_t color) {
+    dl_cmd_t* cmd = dl_add(disp, op, DL_CMD_SIZE(arc, 0));
+    
+    if (cmd != NULL) {
+        cmd->u.arc.x = x;
+        cmd->u.arc.y = y;
+        cmd->u.arc.r = r;
+        cmd->u.arc.start = start;
+        cmd->u.arc.end = end;
+        cmd->u.arc.color = color;
+    }
+}
+
+/* Record anti-aliased line */
+static void
+dl_add_line(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x2, gui_dim_t y2, gui_color_t color) {
+    dl_cmd_t* cmd = dl_add(disp, DL_LINE_AA, DL_CMD_SIZE(line, 0));
+    
+    if (cmd != NULL) {
+        cmd->u.line.x1 = x1;
+        cmd->u.line.y1 = y1;
+        cmd->u.line.x2 = x2;
+        cmd->u.line.y2 = y2;
+        cmd->u.line.color = color;
+    }
+}
+
+/* Record gradient rectangle */
+static void
+dl_add_gradient(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, const gui_gradient_t* gradient, gui_draw_gradient_dir_t dir) {
+    dl_cmd_t* cmd = dl_add(disp, DL_GRADIENTRECTANGLE, DL_CMD_SIZE(gradient, 0));
+    
+    if (cmd != NULL) {
+        cmd->u.gradient.x = x;
+        cmd->u.gradient.y = y;
+        cmd->u.gradient.width = width;
+        cmd->u.gradient.height = height;
+        cmd->u.gradient.gradient = *gradient;
+        cmd->u.gradient.dir = (uint8_t)dir;
+    }
+}
+
+/* Record image, image descriptor is expected to stay valid */
+static void
+dl_add_image(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, const gui_image_desc_t* img) {
+    dl_cmd_t* cmd = dl_add(disp, DL_IMAGE, DL_CMD_SIZE(image, 0));
+    
+    if (cmd != NULL) {
+        cmd->u.image.x = x;
+        cmd->u.image.y = y;
+        cmd->u.image.img = img;
+    }
+}
+
+/* Record scaled image, image descriptor is expected to stay valid */
+static void
+dl_add_image_scaled(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, const gui_image_desc_t* img) {
+    dl_cmd_t* cmd = dl_add(disp, DL_IMAGE_SCALED, DL_CMD_SIZE(scaled, 0));
+    
+    if (cmd != NULL) {
+        cmd->u.scaled.x = x;
+        cmd->u.scaled.y = y;
+        cmd->u.scaled.width = width;
+        cmd->u.scaled.height = height;
+        cmd->u.scaled.img = img;
+    }
+}
+
+/* Record list of rectangles with copy of array */
+static void
+dl_add_rects(const gui_display_t* disp, const gui_ll_rect_t* rects, size_t count) {
+    dl_cmd_t* cmd = dl_add(disp, DL_FILLEDRECTANGLES, DL_CMD_SIZE(count, count * sizeof(*rects)));
+    
+    if (cmd != NULL) {
+        cmd->u.count = count;
+        memcpy(&cmd->u.count + 1, rects, count * sizeof(*rects));
+    }
+}
+
+/* Record text with copy of string, string may be temporary buffer of widget */
+static void
+dl_add_text(const gui_display_t* disp, const gui_font_t* font, const gui_char* str, const gui_draw_font_t* draw) {
+    size_t len = strlen((const char *)str) + 1;
+    dl_cmd_t* cmd = dl_add(disp, DL_TEXT, DL_CMD_SIZE(text, len));
+    
+    if (cmd != NULL) {
+        cmd->u.text.font = font;
+        cmd->u.text.draw = *draw;
+        if (dl_list->detached) {
+            cmd->u.text.draw.layout = NULL;         /* Layout cache is owned by widget */
+        }
+        memcpy(&cmd->u.text + 1, str, len);
+    }
+}
+
+#else /* GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__ */
+#define DL_RECORD(call)
+#endif /* !(GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__) */
+
 /* Fill screen with color on specific coordinates */
 static void
 gui_draw_fill(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color) {
@@ -638,10 +1595,169 @@ gui_draw_fill(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t wid
         height = disp->y2 - y;
     }
     if (width > 0 && height > 0) {
-        GUI.ll.FillRect(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, width, height, color);
+#if GUI_CFG_LCD_ROTATION
+        guii_lcd_maprect(&x, &y, &width, &height);  /* Rotated rectangle is still rectangle */
+#endif /* GUI_CFG_LCD_ROTATION */
+        GUI_LL(FillRect)(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, width, height, color);
+    }
+}
+
+/* Get color of gradient line at position pos of total lines */
+static gui_color_t
+gradient_color(const gui_gradient_t* gradient, gui_dim_t pos, gui_dim_t total) {
+    gui_color_t color = 0;
+    int32_t a, b;
+    uint8_t i;
+    
+    if (total <= 1) {
+        return gradient->start;
+    }
+    for (i = 0; i < 32; i += 8) {                   /* Interpolate each channel, alpha included */
+        a = (int32_t)((gradient->start >> i) & 0xFF);
+        b = (int32_t)((gradient->stop >> i) & 0xFF);
+        color |= (gui_color_t)(a + (b - a) * pos / (total - 1)) << i;
+    }
+    return color;
+}
+
+/* Fill clipped rectangle with one color per row (vertical) or per column */
+static void
+fill_gradient(gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t* colors, uint8_t vertical) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    gui_dim_t i, n, count;
+    
+#if GUI_CFG_LCD_ROTATION
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {
+        uint8_t rot = GUI.lcd.rotation;
+        
+        if (vertical ? (rot == GUI_LCD_ROTATION_90 || rot == GUI_LCD_ROTATION_180) :
+                        (rot == GUI_LCD_ROTATION_180 || rot == GUI_LCD_ROTATION_270)) {
+            count = vertical ? height : width;      /* Lines go in opposite direction in display memory */
+            for (i = 0; i < count / 2; i++) {
+                gui_color_t c = colors[i];
+                colors[i] = colors[count - 1 - i];
+                colors[count - 1 - i] = c;
+            }
+        }
+        guii_lcd_maprect(&x, &y, &width, &height);
+        if (rot & 0x01) {
+            vertical = !vertical;                   /* Rows become columns */
+        }
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    x -= layer->x_offset;
+    y -= layer->y_offset;
+    if (GUI_LL_HAS(FillGradient)) {
+        GUI_LL(FillGradient)(&GUI.lcd, layer, x, y, width, height, colors, vertical);
+        return;
+    }
+    count = vertical ? height : width;
+    for (i = 0; i < count; i += n) {                /* Lines with the same color are filled at once */
+        for (n = 1; i + n < count && colors[i + n] == colors[i]; n++) {}
+        if (vertical) {
+            GUI_LL(FillRect)(&GUI.lcd, layer, x, y + i, width, n, colors[i]);
+        } else {
+            GUI_LL(FillRect)(&GUI.lcd, layer, x + i, y, n, height, colors[i]);
+        }
+    }
+}
+
+/* Send clipped rectangles to low-level, with single call when supported */
+static void
+fill_rects(const gui_ll_rect_t* rects, size_t count) {
+    size_t i;
+    
+    if (GUI_LL_HAS(FillRects)) {
+        GUI_LL(FillRects)(&GUI.lcd, GUI.lcd.drawing_layer, rects, count);
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        GUI_LL(FillRect)(&GUI.lcd, GUI.lcd.drawing_layer, rects[i].x, rects[i].y, rects[i].width, rects[i].height, rects[i].color);
+    }
+}
+
+/* Clip rectangle to display region and add it as layer rectangle to batch, returns new count */
+static size_t
+add_rect(const gui_display_t* disp, gui_ll_rect_t* rects, size_t count, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color) {
+    gui_dim_t x1 = GUI_MAX(x, disp->x1), y1 = GUI_MAX(y, disp->y1);
+    gui_dim_t x2 = GUI_MIN(x + width, disp->x2), y2 = GUI_MIN(y + height, disp->y2);
+    gui_ll_rect_t* r = &rects[count];
+    
+    if (width <= 0 || height <= 0 || x1 >= x2 || y1 >= y2) {
+        return count;
+    }
+    r->x = x1;
+    r->y = y1;
+    r->width = x2 - x1;
+    r->height = y2 - y1;
+#if GUI_CFG_LCD_ROTATION
+    guii_lcd_maprect(&r->x, &r->y, &r->width, &r->height);
+#endif /* GUI_CFG_LCD_ROTATION */
+    r->x -= GUI.lcd.drawing_layer->x_offset;
+    r->y -= GUI.lcd.drawing_layer->y_offset;
+    r->color = color;
+    return count + 1;
+}
+
+/**
+ * \brief           Get statistics of font characters prepared in RAM
+ * \param[out]      stats: Pointer to \ref gui_draw_font_cache_stats_t structure to fill
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_draw_font_getcachestats(gui_draw_font_cache_stats_t* stats) {
+    __GUI_ASSERTPARAMS(stats != NULL);              /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    memcpy(stats, &DrawShared.FontCache, sizeof(*stats));  /* Copy statistics */
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+#if GUI_CFG_FONT_PREWARM_QUEUE || __DOXYGEN__
+
+/**
+ * \brief           Prepare characters of strings in RAM for fast drawing when GUI is idle
+ * \note            Characters are prepared few at a time in \ref gui_process calls without redraw,
+ *                  first draw of new screen or keyboard then finds them ready.
+ *                  Preparation stops when character cache is full, see \ref GUI_CFG_FONT_CACHE_SIZE
+ * \note            Font and list of strings must stay valid until all characters are prepared
+ * \param[in]       font: Font strings will be drawn with
+ * \param[in]       strings: List of strings. Entries set to `NULL` are skipped
+ * \param[in]       count: Number of strings in list
+ * \return          `1` on success, `0` when queue is full, see \ref GUI_CFG_FONT_PREWARM_QUEUE
+ * \sa              gui_draw_font_prewarmlanguage
+ */
+uint8_t
+gui_draw_font_prewarm(const gui_font_t* font, const gui_char* const* strings, size_t count) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(font != NULL && (strings != NULL || !count));    /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    ret = font_prewarm_add(font, strings, count);
+    __GUI_LEAVE();                                  /* Leave GUI */
+#if GUI_CFG_OS
+    if (ret) {
+        __GUI_WAKEUP(0x00);                         /* Start preparation if GUI thread waits for events */
     }
+#endif /* GUI_CFG_OS */
+    return ret;
+}
+
+/**
+ * \brief           Prepare characters of all entries of translation language in RAM when GUI is idle
+ * \note            Call it before language is switched, see \ref gui_draw_font_prewarm for details
+ * \param[in]       font: Font strings will be drawn with
+ * \param[in]       lang: Language table
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_draw_font_prewarmlanguage(const gui_font_t* font, const gui_translate_language_t* lang) {
+    __GUI_ASSERTPARAMS(lang != NULL);               /* Check input parameters */
+    return gui_draw_font_prewarm(font, (const gui_char* const*)lang->entries, lang->count);
 }
 
+#endif /* GUI_CFG_FONT_PREWARM_QUEUE || __DOXYGEN__ */
+
 /**
  * \brief           Initialize \ref gui_draw_font_t structure for further usage
  * \param[in,out]   f: Pointer to empty \ref gui_draw_font_t structure 
@@ -658,7 +1774,8 @@ gui_draw_font_init(gui_draw_font_t* f) {
  */
 void
 gui_draw_fillscreen(const gui_display_t* disp, gui_color_t color) {
-    GUI.ll.Fill(&GUI.lcd, GUI.lcd.drawing_layer, 0, GUI.lcd.drawing_layer->width, GUI.lcd.drawing_layer->height, 0, color);
+    DL_RECORD(dl_add_rect(disp, DL_FILLSCREEN, 0, 0, 0, 0, color));
+    GUI_LL(Fill)(&GUI.lcd, GUI.lcd.drawing_layer, 0, GUI.lcd.drawing_layer->width, GUI.lcd.drawing_layer->height, 0, color);
 }
 
 /**
@@ -674,7 +1791,11 @@ gui_draw_setpixel(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_color
     if (y < disp->y1 || y >= disp->y2 || x < disp->x1 || x >= disp->x2) {
         return;
     }
-    GUI.ll.SetPixel(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, color);
+    DL_RECORD(dl_add_rect(disp, DL_PIXEL, x, y, 1, 1, color));
+#if GUI_CFG_LCD_ROTATION
+    guii_lcd_mappoint(&x, &y);
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI_LL(SetPixel)(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, color);
 }
 
 /**
@@ -687,7 +1808,10 @@ gui_draw_setpixel(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_color
  */
 gui_color_t
 gui_draw_getpixel(const gui_display_t* disp, gui_dim_t x, gui_dim_t y) {
-    return GUI.ll.GetPixel(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset);
+#if GUI_CFG_LCD_ROTATION
+    guii_lcd_mappoint(&x, &y);
+#endif /* GUI_CFG_LCD_ROTATION */
+    return GUI_LL(GetPixel)(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset);
 }
 
 /**
@@ -704,6 +1828,7 @@ gui_draw_vline(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t le
     if (x >= disp->x2 || x < disp->x1 || y > disp->y2 || (y + length) < disp->y1) {
         return;
     }
+    DL_RECORD(dl_add_rect(disp, DL_VLINE, x, y, length, 1, color));
     if (y < disp->y1) {
         length -= disp->y1 - y;
         y = disp->y1;
@@ -711,7 +1836,18 @@ gui_draw_vline(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t le
     if ((y + length) > disp->y2) {
         length = disp->y2 - y;
     }
-    GUI.ll.DrawVLine(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, length, color);
+#if GUI_CFG_LCD_ROTATION
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {
+        gui_dim_t width = 1;
+        
+        guii_lcd_maprect(&x, &y, &width, &length);
+        if (width > 1) {                            /* Line is horizontal in display memory */
+            GUI_LL(DrawHLine)(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, width, color);
+            return;
+        }
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI_LL(DrawVLine)(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, length, color);
 }
 
 /**
@@ -728,6 +1864,7 @@ gui_draw_hline(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t le
     if (y >= disp->y2 || y < disp->y1 || x > disp->x2 || (x + length) < disp->x1) {
         return;
     }
+    DL_RECORD(dl_add_rect(disp, DL_HLINE, x, y, length, 1, color));
     if (x < disp->x1) {
         length -= disp->x1 - x;
         x = disp->x1;
@@ -735,7 +1872,18 @@ gui_draw_hline(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t le
     if ((x + length) > disp->x2) {
         length = disp->x2 - x;
     }
-    GUI.ll.DrawHLine(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, length, color);
+#if GUI_CFG_LCD_ROTATION
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {
+        gui_dim_t height = 1;
+        
+        guii_lcd_maprect(&x, &y, &length, &height);
+        if (height > 1) {                           /* Line is vertical in display memory */
+            GUI_LL(DrawVLine)(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, height, color);
+            return;
+        }
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI_LL(DrawHLine)(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, length, color);
 }
 
 /******************************************************************************/
@@ -744,8 +1892,30 @@ gui_draw_hline(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t le
 /******************************************************************************/
 /******************************************************************************/
 
+/**
+ * \brief           Get range of steps where coordinate moving from start point is inside clipping range
+ * \param[in]       start: Coordinate of line start point
+ * \param[in]       inc: Direction of coordinate on each step, `1` or `-1`
+ * \param[in]       lo: First coordinate inside clipping range
+ * \param[in]       hi: First coordinate after clipping range
+ * \param[out]      first: First step inside range
+ * \param[out]      last: Last step inside range
+ */
+static void
+line_clip_range(gui_dim_t start, gui_dim_t inc, gui_dim_t lo, gui_dim_t hi, int32_t* first, int32_t* last) {
+    if (inc > 0) {
+        *first = (int32_t)lo - start;
+        *last = (int32_t)hi - 1 - start;
+    } else {
+        *first = (int32_t)start - (hi - 1);
+        *last = (int32_t)start - lo;
+    }
+}
+
 /**
  * \brief           Draw line from point 1 to point 2
+ * \note            Line is clipped to drawing region before it is rasterized,
+ *                  only visible pixels are calculated and they are the same as pixels of non-clipped line
  * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
  * \param[in]       x1: Line start X position
  * \param[in]       y1: Line start Y position
@@ -759,13 +1929,15 @@ gui_draw_line(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x
     gui_dim_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
     yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
     curpixel = 0;
+    int32_t first, last, mfirst, mlast;
+    int64_t t;
     
     /* Check if coordinates are inside drawing region */
-//    if (                                            /* Check if redraw is inside area */
-//        !__GUI_RECT_MATCH(  x1, y1, x2, y2,
-//                            disp->x1, disp->y1, disp->x2, disp->y2)) {
-//        return;
-//    }
+    if (!__GUI_RECT_MATCH(                          /* Check if redraw is inside area */
+        GUI_MIN(x1, x2), GUI_MIN(y1, y2), GUI_MAX(x1, x2) + 1, GUI_MAX(y1, y2) + 1,
+        disp->x1, disp->y1, disp->x2, disp->y2)) {
+        return;
+    }
 
 	deltax = GUI_ABS(x2 - x1);
 	deltay = GUI_ABS(y2 - y1);
@@ -779,9 +1951,6 @@ gui_draw_line(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x
         return;
     }
 
-    x = x1;
-    y = y1;
-
     if (x2 >= x1) {
         xinc1 = 1;
         xinc2 = 1;
@@ -798,7 +1967,14 @@ gui_draw_line(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x
         yinc2 = -1;
     }
 
+    /*
+     * Pixel on step k moves k pixels on major axis
+     * and (den / 2 + k * numadd) / den pixels on minor axis.
+     * Clipping region is converted to range of steps for both axes
+     */
     if (deltax >= deltay) {
+        line_clip_range(x1, xinc2, disp->x1, disp->x2, &first, &last);
+        line_clip_range(y1, yinc1, disp->y1, disp->y2, &mfirst, &mlast);
         xinc1 = 0;
         yinc2 = 0;
         den = deltax;
@@ -806,6 +1982,8 @@ gui_draw_line(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x
         numadd = deltay;
         numpixels = deltax;
     } else {
+        line_clip_range(y1, yinc2, disp->y1, disp->y2, &first, &last);
+        line_clip_range(x1, xinc1, disp->x1, disp->x2, &mfirst, &mlast);
         xinc2 = 0;
         yinc1 = 0;
         den = deltay;
@@ -813,6 +1991,27 @@ gui_draw_line(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x
         numadd = deltax;
         numpixels = deltay;
     }
+    if (mlast < 0) {                                /* Minor axis never gets inside */
+        return;
+    }
+    t = (int64_t)mfirst * den - num;                /* First step where minor axis is inside */
+    if (t > 0) {
+        first = GUI_MAX(first, (int32_t)((t + numadd - 1) / numadd));
+    }
+    t = ((int64_t)mlast + 1) * den - 1 - num;       /* Last step where minor axis is inside */
+    last = GUI_MIN(last, (int32_t)(t / numadd));
+    first = GUI_MAX(first, 0);
+    last = GUI_MIN(last, (int32_t)numpixels);
+    if (first > last) {                             /* Line does not cross drawing region */
+        return;
+    }
+    
+    /* Move to first visible pixel */
+    t = (int64_t)num + (int64_t)first * numadd;
+    x = x1 + (gui_dim_t)first * xinc2 + (gui_dim_t)(t / den) * xinc1;
+    y = y1 + (gui_dim_t)first * yinc2 + (gui_dim_t)(t / den) * yinc1;
+    num = (gui_dim_t)(t % den);
+    numpixels = (gui_dim_t)(last - first);
 
     for (curpixel = 0; curpixel <= numpixels; curpixel++) {
         gui_draw_setpixel(disp, x, y, color);
@@ -839,14 +2038,21 @@ gui_draw_line(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x
  */
 void
 gui_draw_rectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color) {
+    gui_ll_rect_t rects[4];
+    size_t cnt = 0;
+    
     if (width == 0 || height == 0) {
         return;
     }
-    gui_draw_hline(disp, x,             y,              width,  color);
-    gui_draw_vline(disp, x,             y,              height, color);
+    DL_RECORD(dl_add_rect(disp, DL_RECTANGLE, x, y, width, height, color));
+    cnt = add_rect(disp, rects, cnt, x,             y,              width,  1,      color);
+    cnt = add_rect(disp, rects, cnt, x,             y,              1,      height, color);
     
-    gui_draw_hline(disp, x,             y + height - 1, width,  color);
-    gui_draw_vline(disp, x + width - 1, y,              height, color);
+    cnt = add_rect(disp, rects, cnt, x,             y + height - 1, width,  1,      color);
+    cnt = add_rect(disp, rects, cnt, x + width - 1, y,              1,      height, color);
+    if (cnt) {
+        fill_rects(rects, cnt);                     /* All lines at once */
+    }
 }
 
 /**
@@ -861,9 +2067,88 @@ gui_draw_rectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_
  */
 void
 gui_draw_filledrectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color) {
+    DL_RECORD(dl_add_rect(disp, DL_FILLEDRECTANGLE, x, y, width, height, color));
     gui_draw_fill(disp, x, y, width, height, color);
 }
 
+/**
+ * \brief           Draw list of filled rectangles
+ * \note            Rectangles are sent to low-level driver in groups, which can queue them together
+ *                  instead of starting separate transfer for each one. Rectangles are filled in array order
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       rects: Array of rectangles with fill colors
+ * \param[in]       count: Number of rectangles in array
+ * \sa              gui_draw_filledrectangle
+ */
+void
+gui_draw_filledrectangles(const gui_display_t* disp, const gui_ll_rect_t* rects, size_t count) {
+    gui_ll_rect_t batch[16];
+    size_t cnt = 0;
+    
+    DL_RECORD(dl_add_rects(disp, rects, count));
+    for (; count > 0; count--, rects++) {
+        cnt = add_rect(disp, batch, cnt, rects->x, rects->y, rects->width, rects->height, rects->color);
+        if (cnt == GUI_COUNT_OF(batch)) {
+            fill_rects(batch, cnt);
+            cnt = 0;
+        }
+    }
+    if (cnt) {
+        fill_rects(batch, cnt);
+    }
+}
+
+/**
+ * \brief           Draw filled rectangle with linear color gradient
+ * \note            Colors are computed for complete rectangle, only visible lines are drawn.
+ *                  When low-level driver supports gradient fill, lines are sent to it in groups,
+ *                  otherwise lines with the same color are filled as single rectangle
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       x: Top left X position
+ * \param[in]       y: Top left Y position
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       gradient: Gradient colors. Start color is used for top or left line, stop color for bottom or right line
+ * \param[in]       dir: Gradient direction. This parameter can be a value of \ref gui_draw_gradient_dir_t enumeration
+ * \sa              gui_draw_filledrectangle
+ */
+void
+gui_draw_gradientrectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, const gui_gradient_t* gradient, gui_draw_gradient_dir_t dir) {
+    gui_color_t colors[32];
+    gui_dim_t x1, y1, x2, y2, pos, end, total, i, n;
+    uint8_t vertical = dir == GUI_DRAW_GRADIENT_DIR_VERTICAL;
+    
+    if (gradient == NULL || width <= 0 || height <= 0) {
+        return;
+    }
+    DL_RECORD(dl_add_gradient(disp, x, y, width, height, gradient, dir));
+    if (gradient->start == gradient->stop) {        /* No gradient at all */
+        gui_draw_fill(disp, x, y, width, height, gradient->start);
+        return;
+    }
+    x1 = GUI_MAX(x, disp->x1);                      /* Get visible part of rectangle */
+    y1 = GUI_MAX(y, disp->y1);
+    x2 = GUI_MIN(x + width, disp->x2);
+    y2 = GUI_MIN(y + height, disp->y2);
+    if (x1 >= x2 || y1 >= y2) {
+        return;
+    }
+    total = vertical ? height : width;
+    pos = vertical ? (y1 - y) : (x1 - x);           /* First visible gradient line */
+    end = vertical ? (y2 - y) : (x2 - x);
+    for (; pos < end; pos += n) {
+        n = GUI_MIN(end - pos, (gui_dim_t)GUI_COUNT_OF(colors));
+        for (i = 0; i < n; i++) {
+            colors[i] = gradient_color(gradient, pos + i, total);
+        }
+        if (vertical) {
+            fill_gradient(x1, y + pos, x2 - x1, n, colors, 1);
+        } else {
+            fill_gradient(x + pos, y1, n, y2 - y1, colors, 0);
+        }
+    }
+}
+
 /**
  * \brief           Draw rectangle with 3D view
  * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
@@ -876,7 +2161,13 @@ gui_draw_filledrectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gu
 void
 gui_draw_rectangle3d(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_draw_3d_state_t state) {
     gui_color_t c1, c2, c3;
+    gui_ll_rect_t rects[8];
+    size_t cnt = 0;
     
+    if (width == 0 || height == 0) {
+        return;
+    }
+    DL_RECORD(dl_add_rect(disp, DL_RECTANGLE3D, x, y, width, height, (gui_color_t)state));
     c1 = GUI_COLOR_BLACK;
     if (state == GUI_DRAW_3D_State_Raised) {
         c2 = 0xFFAAAAAA;
@@ -886,13 +2177,71 @@ gui_draw_rectangle3d(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_di
         c3 = 0xFFAAAAAA;
     }
     
-    gui_draw_rectangle(disp, x, y, width, height, c1);
+    cnt = add_rect(disp, rects, cnt, x,             y,              width,      1,          c1);
+    cnt = add_rect(disp, rects, cnt, x,             y,              1,          height,     c1);
+    cnt = add_rect(disp, rects, cnt, x,             y + height - 1, width,      1,          c1);
+    cnt = add_rect(disp, rects, cnt, x + width - 1, y,              1,          height,     c1);
+    
+    cnt = add_rect(disp, rects, cnt, x + 1,         y + 1,          width - 2,  1,          c2);
+    cnt = add_rect(disp, rects, cnt, x + 1,         y + 1,          1,          height - 3, c2);
+    
+    cnt = add_rect(disp, rects, cnt, x + 1,         y + height - 2, width - 2,  1,          c3);
+    cnt = add_rect(disp, rects, cnt, x + width - 2, y + 2,          1,          height - 4, c3);
+    if (cnt) {
+        fill_rects(rects, cnt);                     /* Complete bevel with single low-level call */
+    }
+}
+
+/**
+ * \brief           Fill rectangle with rounded corners using one horizontal line per row
+ *
+ *                  Row widths in corners are calculated incrementally with integer midpoint test,
+ *                  rows between corners are filled with single rectangle
+ *
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       x: Top left X position
+ * \param[in]       y: Top left Y position
+ * \param[in]       width: Rectangle width
+ * \param[in]       height: Rectangle height
+ * \param[in]       r: Corner radius, `2 * r` must be less than width and height
+ * \param[in]       color: Color used for drawing operation
+ */
+static void
+fill_round_spans(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t r, gui_color_t color) {
+    gui_dim_t dx, dy, row;
+    int32_t lim = (int32_t)r * r + r;               /* Midpoint limit for pixel inside circle */
+    
+    if (!__GUI_RECT_MATCH(
+        disp->x1, disp->y1, disp->x2, disp->y2,
+        x, y, x + width, y + height
+    )) {
+        return;
+    }
+    
+    /* Top corners, width grows with each row */
+    for (dx = 0, dy = r, row = y; dy > 0; dy--, row++) {
+        while ((int32_t)(dx + 1) * (dx + 1) + (int32_t)dy * dy <= lim) {
+            dx++;
+        }
+        if (row >= disp->y1 && row < disp->y2) {
+            gui_draw_hline(disp, x + r - dx, row, width - 2 * (r - dx), color);
+        }
+    }
     
-    gui_draw_hline(disp, x + 1, y + 1, width - 2, c2);
-    gui_draw_vline(disp, x + 1, y + 1, height - 3, c2);
+    /* Middle part without corners */
+    if (height > 2 * r) {
+        gui_draw_filledrectangle(disp, x, y + r, width, height - 2 * r, color);
+    }
     
-    gui_draw_hline(disp, x + 1, y + height - 2, width - 2, c3);
-    gui_draw_vline(disp, x + width - 2, y + 2, height - 4, c3);
+    /* Bottom corners, width decreases with each row */
+    for (dx = r, dy = 1, row = y + height - r; dy <= r; dy++, row++) {
+        while ((int32_t)dx * dx + (int32_t)dy * dy > lim) {
+            dx--;
+        }
+        if (row >= disp->y1 && row < disp->y2) {
+            gui_draw_hline(disp, x + r - dx, row, width - 2 * (r - dx), color);
+        }
+    }
 }
 
 /**
@@ -948,19 +2297,8 @@ gui_draw_filledroundedrectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_
     if (r >= (width / 2)) {
         r = width / 2 - 1;
     }
-    if (r) {
-        if ((gui_dim_t)(width - 2 * r) > 0) {
-            gui_draw_filledrectangle(disp, x + r,         y,     width - 2 * r, height,         color);
-        }
-        if ((gui_dim_t)(height - 2 * r) > 0) {
-            gui_draw_filledrectangle(disp, x,             y + r, r,             height - 2 * r, color);
-            gui_draw_filledrectangle(disp, x + width - r, y + r, r,             height - 2 * r, color);
-        }
-        
-        gui_draw_filledcirclecorner(disp, x + r,             y + r,              r, GUI_DRAW_CIRCLE_TL, color);
-        gui_draw_filledcirclecorner(disp, x + width - r - 1, y + r,              r, GUI_DRAW_CIRCLE_TR, color);
-        gui_draw_filledcirclecorner(disp, x + r,             y + height - r - 1, r, GUI_DRAW_CIRCLE_BL, color);
-        gui_draw_filledcirclecorner(disp, x + width - r - 1, y + height - r - 1, r, GUI_DRAW_CIRCLE_BR, color);
+    if (r > 0) {
+        fill_round_spans(disp, x, y, width, height, r, color);
     } else {
         gui_draw_filledrectangle(disp, x, y, width, height, color);
     }
@@ -994,10 +2332,9 @@ gui_draw_circle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t r
  */
 void
 gui_draw_filledcircle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t r, gui_color_t color) {
-    gui_draw_filledcirclecorner(disp, x, y, r, GUI_DRAW_CIRCLE_TL, color);
-    gui_draw_filledcirclecorner(disp, x, y, r, GUI_DRAW_CIRCLE_TR, color);
-    gui_draw_filledcirclecorner(disp, x, y - 1, r, GUI_DRAW_CIRCLE_BL, color);
-    gui_draw_filledcirclecorner(disp, x, y - 1, r, GUI_DRAW_CIRCLE_BR, color);
+    if (r > 0) {
+        fill_round_spans(disp, x - r, y - r, 2 * r + 1, 2 * r + 1, r, color);
+    }
 }
 
 /**
@@ -1033,60 +2370,13 @@ gui_draw_triangle(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1,  gui_di
  */
 void
 gui_draw_filledtriangle(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x2, gui_dim_t y2, gui_dim_t x3, gui_dim_t y3, gui_color_t color) {
-    gui_dim_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0, 
-    yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0, 
-    curpixel = 0;
-
-    deltax = GUI_ABS(x2 - x1);
-    deltay = GUI_ABS(y2 - y1);
-    x = x1;
-    y = y1;
-
-    if (x2 >= x1) {
-        xinc1 = 1;
-        xinc2 = 1;
-    } else {
-        xinc1 = -1;
-        xinc2 = -1;
-    }
-
-    if (y2 >= y1) {
-        yinc1 = 1;
-        yinc2 = 1;
-    } else {
-        yinc1 = -1;
-        yinc2 = -1;
-    }
-
-    if (deltax >= deltay){
-        xinc1 = 0;
-        yinc2 = 0;
-        den = deltax;
-        num = deltax / 2;
-        numadd = deltay;
-        numpixels = deltax;
-    } else {
-        xinc2 = 0;
-        yinc1 = 0;
-        den = deltay;
-        num = deltay / 2;
-        numadd = deltax;
-        numpixels = deltay;
-    }
-
-    for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-        gui_draw_line(disp, x, y, x3, y3, color);
-
-        num += numadd;
-        if (num >= den) {
-            num -= den;
-            x += xinc1;
-            y += yinc1;
-        }
-        x += xinc2;
-        y += yinc2;
-    }
-}
+    gui_draw_poly_t points[3];
+    
+    points[0].x = x1; points[0].y = y1;
+    points[1].x = x2; points[1].y = y2;
+    points[2].x = x3; points[2].y = y3;
+    gui_draw_filledpoly(disp, points, GUI_COUNT_OF(points), color);
+}
 
 /**
  * \brief           Draw circle corner, selected with parameter
@@ -1207,8 +2497,254 @@ gui_draw_filledcirclecorner(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y
     }
 }
 
+/**
+ * \brief           Run-length compressed image reader
+ */
+typedef struct {
+    const uint8_t* data;                            /*!< Next compressed byte */
+    const uint8_t* pixel;                           /*!< Repeated pixel of current block */
+    uint8_t run;                                    /*!< Number of pixels left in current block */
+    uint8_t bytes;                                  /*!< Number of bytes per pixel */
+} image_rle_t;
+
+/**
+ * \brief           Decode pixels of run-length compressed image
+ * \param[in,out]   r: Image reader
+ * \param[out]      dst: Output buffer for pixels. Set to `NULL` to skip pixels
+ * \param[in]       count: Number of pixels to decode
+ */
+static void
+image_rle_read(image_rle_t* r, uint8_t* dst, size_t count) {
+    size_t n;
+    
+    while (count) {
+        if (!r->run) {                              /* Start new block */
+            r->run = (*r->data & 0x7F) + 1;
+            r->pixel = (*r->data++ & 0x80) ? r->data : NULL;
+            if (r->pixel != NULL) {
+                r->data += r->bytes;                /* Repeated pixel follows control byte */
+            }
+        }
+        n = GUI_MIN(count, r->run);
+        if (r->pixel != NULL) {                     /* Repeated pixel */
+            if (dst != NULL) {
+                size_t i;
+                for (i = 0; i < n; i++, dst += r->bytes) {
+                    memcpy(dst, r->pixel, r->bytes);
+                }
+            }
+        } else {                                    /* Literal pixels */
+            if (dst != NULL) {
+                memcpy(dst, r->data, n * r->bytes);
+                dst += n * r->bytes;
+            }
+            r->data += n * r->bytes;
+        }
+        r->run -= n;
+        count -= n;
+    }
+}
+
+/**
+ * \brief           Decode all pixels of image to memory
+ * \note            Image must have at least 8 bits per pixel and cannot be \ref GUI_FLAG_IMAGE_JPEG
+ * \param[in]       img: Image descriptor
+ * \param[out]      dst: Destination for first pixel of first line
+ * \param[in]       stride: Distance between destination lines in units of bytes
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_draw_image_decode(const gui_image_desc_t* img, uint8_t* dst, size_t stride) {
+    uint8_t bytes = img->bpp >> 3;
+    size_t line = (size_t)img->x_size * bytes;
+    gui_dim_t y;
+    
+    if (!bytes || (img->flags & GUI_FLAG_IMAGE_JPEG)) {
+        return 0;
+    }
+    if (img->flags & GUI_FLAG_IMAGE_RLE) {
+        image_rle_t r;
+        
+        memset(&r, 0x00, sizeof(r));
+        r.data = img->image;
+        r.bytes = bytes;
+        for (y = 0; y < img->y_size; y++) {
+            image_rle_read(&r, dst + y * stride, img->x_size);
+        }
+    } else {
+        for (y = 0; y < img->y_size; y++) {
+            memcpy(dst + y * stride, img->image + y * line, line);
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Draw indexed image with software
+ * \param[in]       disp: Display for drawing
+ * \param[in]       img: Image descriptor
+ * \param[in]       x: Top left X position of first visible pixel
+ * \param[in]       y: Top left Y position of first visible pixel
+ * \param[in]       left: Index of first visible pixel in image line
+ * \param[in]       top: Index of first visible image line
+ * \param[in]       width: Number of visible pixels in line
+ * \param[in]       height: Number of visible lines
+ */
+static void
+draw_image_indexed_sw(const gui_display_t* disp, const gui_image_desc_t* img, gui_dim_t x, gui_dim_t y,
+                        gui_dim_t left, gui_dim_t top, gui_dim_t width, gui_dim_t height) {
+    const uint8_t* line = img->image + top * GUI_IMAGE_INDEXED_LINE_SIZE(img);
+    gui_color_t color;
+    gui_dim_t i, k;
+    uint8_t index, a;
+    
+    for (i = 0; i < height; i++, line += GUI_IMAGE_INDEXED_LINE_SIZE(img)) {
+        for (k = left; k < left + width; k++) {
+            if (img->bpp == 4) {
+                index = (line[k >> 1] >> ((k & 0x01) ? 4 : 0)) & 0x0F;
+            } else {
+                index = line[k];
+            }
+            if (index >= img->palette_size) {
+                continue;
+            }
+            color = img->palette[index];
+            a = (color >> 24) & 0xFF;               /* Get alpha of palette color */
+            if (a == 0xFF) {
+                gui_draw_setpixel(disp, x + k - left, y + i, color);
+            } else if (a) {                         /* Blend with current pixel */
+                gui_draw_setpixel(disp, x + k - left, y + i, blend_color(color, gui_draw_getpixel(disp, x + k - left, y + i), a));
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Draw raw image data with low-level function for image depth
+ * \param[in]       img: Image descriptor
+ * \param[in]       src: Source pixels
+ * \param[in]       dst: Destination address in drawing layer
+ * \param[in]       width: Number of pixels per line to draw
+ * \param[in]       height: Number of lines to draw
+ * \param[in]       offlineSrc: Number of pixels to skip in source after each line
+ * \param[in]       offlineDst: Number of pixels to skip in destination after each line
+ */
+static void
+draw_image_ll(const gui_image_desc_t* img, const uint8_t* src, const uint8_t* dst, gui_dim_t width, gui_dim_t height, gui_dim_t offlineSrc, gui_dim_t offlineDst) {
+    uint8_t bytes = img->bpp >> 3;
+    
+    /*******************/
+    /*    Draw image   */
+    /*******************/
+    if (img->palette != NULL) {                     /* Draw indexed image */
+        if (GUI_LL_HAS(DrawImageIndexed)) {
+            GUI_LL(DrawImageIndexed)(&GUI.lcd, GUI.lcd.drawing_layer, img, (uint8_t *)src, (uint8_t *)dst, width, height, offlineSrc, offlineDst);
+        }
+    } else if (bytes == 4) {                        /* Draw 32BPP image */
+        if (GUI_LL_HAS(DrawImage32)) {              /* Draw image 32BPP if possible */
+            GUI_LL(DrawImage32)(&GUI.lcd, GUI.lcd.drawing_layer, img, (uint8_t *)src, (uint8_t *)dst, width, height, offlineSrc, offlineDst);
+        }
+    } else if (bytes == 3) {                        /* Draw 24BPP image */
+        if (GUI_LL_HAS(DrawImage24)) {              /* Draw image 24BPP if possible */
+            GUI_LL(DrawImage24)(&GUI.lcd, GUI.lcd.drawing_layer, img, (uint8_t *)src, (uint8_t *)dst, width, height, offlineSrc, offlineDst);
+        }
+    } else if (bytes == 2) {                        /* Draw 16BPP image */
+        if (GUI_LL_HAS(DrawImage16)) {              /* Draw image 16BPP if possible */
+            GUI_LL(DrawImage16)(&GUI.lcd, GUI.lcd.drawing_layer, img, (uint8_t *)src, (uint8_t *)dst, width, height, offlineSrc, offlineDst);
+        }
+    }
+}
+
+#if GUI_CFG_LCD_ROTATION || __DOXYGEN__
+
+/**
+ * \brief           Rotate block of image pixels to display memory and draw it with low-level function
+ *
+ *                  Block is rotated in strips of lines which fit to rotation buffer,
+ *                  so low-level can still convert and blend every strip in single transfer
+ *
+ * \param[in]       img: Image descriptor
+ * \param[in]       src: First source pixel of block
+ * \param[in]       stride: Number of bytes between source lines
+ * \param[in]       x: Top left X position of block on logical screen
+ * \param[in]       y: Top left Y position of block on logical screen
+ * \param[in]       width: Block width in units of pixels
+ * \param[in]       height: Block height in units of pixels
+ */
+static void
+draw_image_rotated_ll(const gui_image_desc_t* img, const uint8_t* src, size_t stride, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    uint8_t bytes = img->bpp >> 3, b;
+    size_t line = (size_t)width * bytes;
+    gui_dim_t rows, i, k, px, py, pw, ph, bx, by, bw, bh;
+    ptrdiff_t pos, step;
+    
+    guii_ll_waitready();                            /* Buffer may still be read by low-level */
+    if (DrawShared.RotateBuffSize < line) {                /* Buffer must hold at least one line */
+        GUI_MEMFREE(DrawShared.RotateBuff);
+        DrawShared.RotateBuffSize = GUI_MAX(line, GUI_CFG_IMAGE_DECODE_BUFFER_SIZE);
+        GUI_MEM_TAGGED(GUI_MEM_TAG_IMAGE, DrawShared.RotateBuff = GUI_MEMALLOC_NOZERO_HINT(DrawShared.RotateBuffSize, GUI_MEM_BULK));
+        if (DrawShared.RotateBuff == NULL) {
+            DrawShared.RotateBuffSize = 0;
+            return;
+        }
+    }
+    while (height > 0) {
+        rows = (gui_dim_t)GUI_MIN((size_t)height, DrawShared.RotateBuffSize / line);
+        pw = (GUI.lcd.rotation & 0x01) ? rows : width;  /* Strip width in display memory */
+        for (i = 0; i < rows; i++, src += stride) {
+            /* Pixels of one source line are equally spaced in rotated strip */
+            bx = 0; by = i; bw = bh = 1;
+            guii_lcd_rotaterect(GUI.lcd.rotation, width, rows, &bx, &by, &bw, &bh);
+            pos = (ptrdiff_t)by * pw + bx;
+            bx = 1; by = i; bw = bh = 1;
+            guii_lcd_rotaterect(GUI.lcd.rotation, width, rows, &bx, &by, &bw, &bh);
+            step = (ptrdiff_t)by * pw + bx - pos;
+            for (k = 0; k < width; k++, pos += step) {
+                for (b = 0; b < bytes; b++) {
+                    DrawShared.RotateBuff[pos * bytes + b] = src[k * bytes + b];
+                }
+            }
+        }
+        px = x; py = y; pw = width; ph = rows;
+        guii_lcd_maprect(&px, &py, &pw, &ph);       /* Strip in display memory */
+        draw_image_ll(img, DrawShared.RotateBuff,
+            (uint8_t *)(layer->start_address + layer->pixel_size * ((py - layer->y_offset) * layer->width + (px - layer->x_offset))),
+            pw, ph, 0, layer->width - pw);
+        y += rows;
+        height -= rows;
+        if (height > 0) {
+            guii_ll_waitready();                    /* Buffer is reused for next strip */
+        }
+    }
+}
+
+#endif /* GUI_CFG_LCD_ROTATION || __DOXYGEN__ */
+
+/**
+ * \brief           Prepare image decode buffer for new lines
+ * \param[in]       line: Number of bytes of single line, buffer must hold at least one line
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+image_buffer(size_t line) {
+    guii_ll_waitready();                            /* Buffer may still be read by low-level */
+    if (DrawShared.ImageBuffSize < line) {
+        GUI_MEMFREE(DrawShared.ImageBuff);
+        DrawShared.ImageBuffSize = GUI_MAX(line, GUI_CFG_IMAGE_DECODE_BUFFER_SIZE);
+        GUI_MEM_TAGGED(GUI_MEM_TAG_IMAGE, DrawShared.ImageBuff = GUI_MEMALLOC_NOZERO_HINT(DrawShared.ImageBuffSize, GUI_MEM_BULK));
+        if (DrawShared.ImageBuff == NULL) {
+            DrawShared.ImageBuffSize = 0;
+            return 0;
+        }
+    }
+    return 1;
+}
+
 /**
  * \brief           Draw image to display of any depth and size
+ * \note            \ref GUI_FLAG_IMAGE_JPEG images are drawn only when low-level driver implements
+ *                  \ref gui_ll_t.DrawJPEG and are not drawn on rotated screen
  * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
  * \param[in]       x: Top left X position
  * \param[in]       y: Top left Y position
@@ -1230,6 +2766,7 @@ gui_draw_image(gui_display_t* disp, gui_dim_t x, gui_dim_t y, const gui_image_de
     )) {
         return;
     }
+    DL_RECORD(dl_add_image(disp, x, y, img));
     
     layer = GUI.lcd.drawing_layer;                  /* Set layer pointer */
     
@@ -1237,12 +2774,11 @@ gui_draw_image(gui_display_t* disp, gui_dim_t x, gui_dim_t y, const gui_image_de
     height = img->y_size;                           /* Set default height */
     
     src = (uint8_t *)(img->image);                  /* Set source address */
-    dst = (uint8_t *)(layer->start_address + GUI.lcd.pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset)));
+    dst = (uint8_t *)(layer->start_address + layer->pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset)));
     
-    //TODO: Check proper coordinates for memory!
     if (y < disp->y1) {
         src += (disp->y1 - y) * img->x_size * bytes;/* Set offset for number of image lines */
-        dst += (disp->y1 - y) * GUI.lcd.width * GUI.lcd.pixel_size;  /* Set offset for number of LCD lines */
+        dst += (disp->y1 - y) * layer->width * layer->pixel_size;  /* Set offset for number of layer lines */
         height -= disp->y1 - y;                     /* Decrease effective height */
     }
     if ((y + img->y_size) > disp->y2) {
@@ -1250,7 +2786,7 @@ gui_draw_image(gui_display_t* disp, gui_dim_t x, gui_dim_t y, const gui_image_de
     }
     if (x < disp->x1) {                             /* Set offset start address if required */
         src += (disp->x1 - x) * bytes;              /* Set offset of start address in X direction */
-        dst += (disp->x1 - x) * GUI.lcd.pixel_size; /* Set offset of start address in X direction */
+        dst += (disp->x1 - x) * layer->pixel_size; /* Set offset of start address in X direction */
         width -= disp->x1 - x;                      /* Decrease effective width */
     }
     if ((x + img->x_size) > disp->x2) {
@@ -1260,20 +2796,328 @@ gui_draw_image(gui_display_t* disp, gui_dim_t x, gui_dim_t y, const gui_image_de
     offlineSrc = img->x_size - width;               /* Set offline source */
     offlineDst = layer->width - width;              /* Set offline destination */
     
-    /*******************/
-    /*    Draw image   */
-    /*******************/
-    if (bytes == 4) {                               /* Draw 32BPP image */
-        if (GUI.ll.DrawImage32) {                   /* Draw image 32BPP if possible */
-            GUI.ll.DrawImage32(&GUI.lcd, GUI.lcd.drawing_layer, img, (uint8_t *)src, (uint8_t *)dst, width, height, offlineSrc, offlineDst);
+    if (img->flags & GUI_FLAG_IMAGE_JPEG) {         /* Decoder writes visible part directly to layer */
+        if (width > 0 && height > 0 && GUI_LL_HAS(DrawJPEG)
+#if GUI_CFG_LCD_ROTATION
+            && GUI.lcd.rotation == GUI_LCD_ROTATION_0
+#endif /* GUI_CFG_LCD_ROTATION */
+        ) {
+            GUI_LL(DrawJPEG)(&GUI.lcd, layer, img, (void *)dst, x < disp->x1 ? disp->x1 - x : 0,
+                y < disp->y1 ? disp->y1 - y : 0, width, height, offlineDst);
         }
-    } else if (bytes == 3) {                        /* Draw 24BPP image */
-        if (GUI.ll.DrawImage24) {                   /* Draw image 24BPP if possible */
-            GUI.ll.DrawImage24(&GUI.lcd, GUI.lcd.drawing_layer, img, (uint8_t *)src, (uint8_t *)dst, width, height, offlineSrc, offlineDst);
+        return;
+    }
+    
+#if GUI_CFG_LCD_ROTATION
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0 && !(img->flags & GUI_FLAG_IMAGE_RLE)) {
+        gui_dim_t left = x < disp->x1 ? disp->x1 - x : 0, top = y < disp->y1 ? disp->y1 - y : 0;
+        
+        if (width <= 0 || height <= 0) {
+            return;
         }
-    } else if (bytes == 2) {                        /* Draw 16BPP image */
-        if (GUI.ll.DrawImage16) {                   /* Draw image 16BPP if possible */
-            GUI.ll.DrawImage16(&GUI.lcd, GUI.lcd.drawing_layer, img, (uint8_t *)src, (uint8_t *)dst, width, height, offlineSrc, offlineDst);
+        if (img->palette != NULL) {
+            /* Packed 4-bit pixels are drawn one by one */
+            if (!GUI_LL_HAS(DrawImageIndexed) || img->bpp == 4) {
+                draw_image_indexed_sw(disp, img, x + left, y + top, left, top, width, height);
+            } else {
+                draw_image_rotated_ll(img, img->image + top * GUI_IMAGE_INDEXED_LINE_SIZE(img) + left,
+                    GUI_IMAGE_INDEXED_LINE_SIZE(img), x + left, y + top, width, height);
+            }
+        } else {
+            draw_image_rotated_ll(img, img->image + (top * img->x_size + left) * bytes,
+                img->x_size * bytes, x + left, y + top, width, height);
+        }
+        return;
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    
+    if (img->palette != NULL && !(img->flags & GUI_FLAG_IMAGE_RLE)) {  /* Indexed image has own line layout */
+        gui_dim_t left = x < disp->x1 ? disp->x1 - x : 0, top = y < disp->y1 ? disp->y1 - y : 0;
+        
+        if (width <= 0 || height <= 0) {
+            return;
+        }
+#if GUI_CFG_LCD_CLUT
+        /* Pixels of image indexed with display palette are already pixels of layer */
+        if (img->palette == GUI.lcd.palette && img->bpp == 8 && layer->pixel_format == GUI_PIXEL_FORMAT_L8) {
+            GUI.ll.Copy(&GUI.lcd, layer, img->image + top * img->x_size + left, (void *)dst, width, height, img->x_size - width, offlineDst);
+            return;
+        }
+#endif /* GUI_CFG_LCD_CLUT */
+        /* Packed 4-bit data can only start on byte boundary for low-level */
+        if (GUI_LL_HAS(DrawImageIndexed) && (img->bpp == 8 || !(left & 0x01))) {
+            src = img->image + top * GUI_IMAGE_INDEXED_LINE_SIZE(img) + (img->bpp == 4 ? (left >> 1) : left);
+            offlineSrc = (img->bpp == 4 ? ((img->x_size + 1) & ~1) : img->x_size) - width;
+            draw_image_ll(img, src, dst, width, height, offlineSrc, offlineDst);
+        } else {
+            draw_image_indexed_sw(disp, img, x + left, y + top, left, top, width, height);
+        }
+        return;
+    }
+    
+    if (img->flags & GUI_FLAG_IMAGE_RLE) {          /* Decode visible lines to buffer first */
+        image_rle_t r;
+        size_t line = width * bytes, lines;
+        gui_dim_t left = x < disp->x1 ? disp->x1 - x : 0, i, cnt;
+#if GUI_CFG_LCD_ROTATION
+        gui_dim_t top = y < disp->y1 ? disp->y1 : y;/* Logical Y position of next decoded lines */
+#endif /* GUI_CFG_LCD_ROTATION */
+        
+        if (width <= 0 || height <= 0 || !bytes) {  /* Compressed images need at least 8 bits per pixel */
+            return;
+        }
+        if (!image_buffer(line)) {
+            return;
+        }
+        lines = DrawShared.ImageBuffSize / line;           /* Number of lines decoded at a time */
+        
+        memset(&r, 0x00, sizeof(r));
+        r.data = img->image;
+        r.bytes = bytes;
+        image_rle_read(&r, NULL, (y < disp->y1 ? disp->y1 - y : 0) * img->x_size);  /* Skip invisible lines on top */
+        while (height > 0) {
+            cnt = (gui_dim_t)GUI_MIN((size_t)height, lines);
+            for (i = 0; i < cnt; i++) {             /* Decode only visible part of lines */
+                image_rle_read(&r, NULL, left);
+                image_rle_read(&r, &DrawShared.ImageBuff[i * line], width);
+                image_rle_read(&r, NULL, img->x_size - left - width);
+            }
+#if GUI_CFG_LCD_ROTATION
+            if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {
+                draw_image_rotated_ll(img, DrawShared.ImageBuff, line, x + left, top, width, cnt);
+                top += cnt;
+            } else
+#endif /* GUI_CFG_LCD_ROTATION */
+            {
+                draw_image_ll(img, DrawShared.ImageBuff, dst, width, cnt, 0, offlineDst);
+            }
+            dst += cnt * layer->width * layer->pixel_size;
+            height -= cnt;
+            if (height > 0) {
+                guii_ll_waitready();                /* Buffer is reused for next lines */
+            }
+        }
+        return;
+    }
+    draw_image_ll(img, src, dst, width, height, offlineSrc, offlineDst);
+}
+
+#if GUI_CFG_IMAGE_SCALE_CACHE || __DOXYGEN__
+
+/* Scaled copy of image kept for next draws */
+typedef struct {
+    const gui_image_desc_t* src;                    /*!< Original image, `NULL` when entry is free */
+    gui_image_desc_t img;                           /*!< Descriptor of scaled pixels */
+    uint32_t used;                                  /*!< Value of use counter on last draw */
+} image_scaled_t;
+
+static image_scaled_t scaled_cache[GUI_CFG_IMAGE_SCALE_CACHE];
+static uint32_t scaled_used;                        /* Use counter to find least recently drawn entry */
+
+#endif /* GUI_CFG_IMAGE_SCALE_CACHE || __DOXYGEN__ */
+
+/**
+ * \brief           Scale lines of image with nearest neighbour method
+ * \param[in]       img: Original image descriptor
+ * \param[out]      dst: Output buffer for packed lines of scaled image
+ * \param[in]       width: Width of scaled image
+ * \param[in]       height: Height of scaled image
+ * \param[in]       first: First line of scaled image to output
+ * \param[in]       count: Number of lines to output
+ */
+static void
+image_scale_lines(const gui_image_desc_t* img, uint8_t* dst, gui_dim_t width, gui_dim_t height, gui_dim_t first, gui_dim_t count) {
+    uint8_t bytes = img->bpp >> 3, b;
+    uint32_t sx, sy, stepx, stepy;
+    size_t stride;
+    const uint8_t* line;
+    gui_dim_t i, k;
+    
+    stride = img->palette != NULL ? GUI_IMAGE_INDEXED_LINE_SIZE(img) : (size_t)img->x_size * bytes;
+    stepx = ((uint32_t)img->x_size << 16) / width;  /* Source step in 16.16 fixed point */
+    stepy = ((uint32_t)img->y_size << 16) / height;
+    for (i = 0; i < count; i++) {
+        sy = (uint32_t)(((uint64_t)(first + i) * stepy + (stepy >> 1)) >> 16);  /* Sample in the middle of pixel */
+        line = img->image + sy * stride;
+        for (k = 0, sx = stepx >> 1; k < width; k++, sx += stepx) {
+            for (b = 0; b < bytes; b++) {
+                *dst++ = line[(sx >> 16) * bytes + b];
+            }
+        }
+    }
+}
+
+#if GUI_CFG_IMAGE_SCALE_CACHE || __DOXYGEN__
+
+/* Free pixels of cached scaled image */
+static void
+image_scaled_free(image_scaled_t* e) {
+    void* pixels;
+    
+    if (e->src != NULL) {
+        guii_ll_waitready();                        /* Pixels may still be read by low-level */
+        pixels = (void *)e->img.image;              /* Descriptor holds constant pointer */
+        GUI_MEMFREE(pixels);
+        e->src = NULL;
+    }
+}
+
+#if GUI_CFG_MEM_RECLAIM || __DOXYGEN__
+
+static gui_mem_reclaim_t scaled_reclaim;
+
+/**
+ * \brief           Memory reclaimer of scaled images, least recently drawn images are released first
+ * \note            Most recently drawn image is kept, it may be drawn right now
+ * \param[in]       size: Number of bytes of failed allocation
+ * \param[in]       arg: Unused
+ * \return          Number of released bytes
+ */
+static size_t
+image_scaled_reclaim_fn(size_t size, void* arg) {
+    image_scaled_t *e, *victim;
+    size_t released = 0, i;
+    
+    GUI_UNUSED(arg);
+    while (released < size) {
+        victim = NULL;
+        for (i = 0; i < GUI_COUNT_OF(scaled_cache); i++) {
+            e = &scaled_cache[i];
+            if (e->src != NULL && e->used != scaled_used && (victim == NULL || e->used < victim->used)) {
+                victim = e;
+            }
+        }
+        if (victim == NULL) {
+            break;
+        }
+        released += (size_t)victim->img.x_size * victim->img.y_size * (victim->img.bpp >> 3);
+        image_scaled_free(victim);
+    }
+    return released;
+}
+
+#endif /* GUI_CFG_MEM_RECLAIM || __DOXYGEN__ */
+
+/**
+ * \brief           Get scaled copy of image from cache or create new one
+ * \param[in]       img: Original image descriptor
+ * \param[in]       width: Width of scaled image
+ * \param[in]       height: Height of scaled image
+ * \return          Descriptor of scaled image or `NULL` when there is no memory for it
+ */
+static const gui_image_desc_t *
+image_scaled_get(const gui_image_desc_t* img, gui_dim_t width, gui_dim_t height) {
+    image_scaled_t *e, *victim = NULL;
+    uint8_t* pixels;
+    size_t i;
+    
+    for (i = 0; i < GUI_COUNT_OF(scaled_cache); i++) {
+        e = &scaled_cache[i];
+        if (e->src == img && e->img.x_size == width && e->img.y_size == height) {
+            e->used = ++scaled_used;
+            return &e->img;                         /* Scaled before, only copy is needed */
+        }
+        if (victim == NULL || (victim->src != NULL && (e->src == NULL || e->used < victim->used))) {
+            victim = e;                             /* Free or least recently drawn entry */
+        }
+    }
+    image_scaled_free(victim);
+#if GUI_CFG_MEM_RECLAIM
+    if (!scaled_reclaim.added) {
+        gui_mem_reclaim_add(&scaled_reclaim, image_scaled_reclaim_fn, NULL, GUI_MEM_RECLAIM_PRIO_IMAGE);
+    }
+#endif /* GUI_CFG_MEM_RECLAIM */
+    GUI_MEM_TAGGED(GUI_MEM_TAG_IMAGE_SCALED, pixels = GUI_MEMALLOC_NOZERO_HINT((size_t)width * height * (img->bpp >> 3), GUI_MEM_BULK));
+    if (pixels == NULL) {
+        return NULL;
+    }
+    image_scale_lines(img, pixels, width, height, 0, height);
+    victim->src = img;
+    victim->img = *img;                             /* Scaled image keeps format and palette */
+    victim->img.x_size = width;
+    victim->img.y_size = height;
+    victim->img.image = pixels;
+    victim->used = ++scaled_used;
+    return &victim->img;
+}
+
+/**
+ * \brief           Remove scaled copies of image from cache
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       img: Original image descriptor. Set to `NULL` to remove all cached images
+ */
+void
+guii_draw_image_release(const gui_image_desc_t* img) {
+    size_t i;
+    
+    for (i = 0; i < GUI_COUNT_OF(scaled_cache); i++) {
+        if (img == NULL || scaled_cache[i].src == img) {
+            image_scaled_free(&scaled_cache[i]);
+        }
+    }
+}
+
+#endif /* GUI_CFG_IMAGE_SCALE_CACHE || __DOXYGEN__ */
+
+/**
+ * \brief           Draw image scaled to new size
+ * \note            Image is scaled with nearest neighbour method. Scaled copy is kept in cache
+ *                  when \ref GUI_CFG_IMAGE_SCALE_CACHE is enabled, next draws at the same size only copy the pixels.
+ *                  Otherwise only visible lines are scaled on every draw
+ * \note            Compressed images and indexed images with 4 bits per pixel are drawn at native size
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       x: Top left X position
+ * \param[in]       y: Top left Y position
+ * \param[in]       width: Width of drawn image
+ * \param[in]       height: Height of drawn image
+ * \param[in]       img: Pointer to \ref gui_image_desc_t structure with image description
+ */
+void
+gui_draw_image_scaled(gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, const gui_image_desc_t* img) {
+    gui_image_desc_t strip;
+    size_t line;
+    gui_dim_t first, last, cnt;
+    
+    if (img == NULL || width <= 0 || height <= 0 || !__GUI_RECT_MATCH(
+        disp->x1, disp->y1, disp->x2, disp->y2,
+        x, y, x + width, y + height
+    )) {
+        return;
+    }
+    if ((width == img->x_size && height == img->y_size) || img->bpp < 8 || (img->flags & (GUI_FLAG_IMAGE_RLE | GUI_FLAG_IMAGE_JPEG))) {
+        gui_draw_image(disp, x, y, img);            /* Draw at native size */
+        return;
+    }
+    DL_RECORD(dl_add_image_scaled(disp, x, y, width, height, img));
+    
+#if GUI_CFG_IMAGE_SCALE_CACHE
+    {
+        const gui_image_desc_t* scaled = image_scaled_get(img, width, height);
+        if (scaled != NULL) {
+            gui_draw_image(disp, x, y, scaled);
+            return;
+        }
+    }
+#endif /* GUI_CFG_IMAGE_SCALE_CACHE */
+    
+    /* Scale only visible lines, strip by strip through decode buffer */
+    line = (size_t)width * (img->bpp >> 3);
+    if (!image_buffer(line)) {
+        return;
+    }
+    first = y < disp->y1 ? disp->y1 - y : 0;
+    last = y + height > disp->y2 ? disp->y2 - y : height;
+    strip = *img;
+    strip.x_size = width;
+    strip.image = DrawShared.ImageBuff;
+    while (first < last) {
+        cnt = (gui_dim_t)GUI_MIN((size_t)(last - first), DrawShared.ImageBuffSize / line);
+        image_scale_lines(img, DrawShared.ImageBuff, width, height, first, cnt);
+        strip.y_size = cnt;
+        gui_draw_image(disp, x, y + first, &strip);
+        first += cnt;
+        if (first < last) {
+            guii_ll_waitready();                    /* Buffer is reused for next lines */
         }
     }
 }
@@ -1304,64 +3148,967 @@ gui_draw_poly(const gui_display_t* disp, const gui_draw_poly_t* points, size_t l
 }
 
 /**
- * \brief           Write text to screen
+ * \brief           Draw filled polygon
+ *
+ *                  Polygon is filled with scanlines, one horizontal line per row.
+ *                  Even-odd rule is used, edges and vertices are part of the polygon
+ *
  * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
- * \param[in]       font: Pointer to \ref gui_font_t structure with font to use
- * \param[in]       str: Pointer to string to draw on screen
- * \param[in]       draw: Pointer to \ref gui_draw_font_t structure with specifications about drawing style 
+ * \param[in]       points: Pointer to array of \ref gui_draw_poly_t polygon points
+ * \param[in]       len: Number of points in array. There must be at least 3 points
+ * \param[in]       color: Color to use for drawing 
+ * \sa              gui_draw_poly
  */
 void
-gui_draw_writetext(const gui_display_t* disp, const gui_font_t* font, const gui_char* str, gui_draw_font_t* draw) {
-    gui_dim_t x, y;
-    uint32_t ch;
-    uint8_t i;
-    size_t cnt;
-    const gui_font_char_t* c;
-    gui_stringrect_t rect = {0};                    /* Get string object */
-    gui_string_t currStr;
+gui_draw_filledpoly(const gui_display_t* disp, const gui_draw_poly_t* points, size_t len, gui_color_t color) {
+    gui_dim_t nodesBuff[16];
+    gui_dim_t* nodes = nodesBuff;
+    gui_dim_t x, y, ymin, ymax;
+    int32_t dx, dy, num;
+    size_t i, j, k, cnt;
     
-    if (!draw->Lineheight) {                        /* When line height is not set */
-        draw->Lineheight = font->size;              /* Set font size */
+    if (len < 3) {
+        return;
     }
     
-    rect.Font = font;                               /* Save font structure */
-    rect.StringDraw = draw;                         /* Set drawing pointer */
-    rect.IsEditMode = !!(draw->flags & GUI_FLAG_FONT_EDITMODE); /* Check if in edit mode */
-      
-    gui_string_prepare(&currStr, str);              /* Prepare string */
-    string_rectangle(&rect, &currStr, 0);           /* Get string width for this box */
-    if (rect.width > draw->width) {                 /* If string is wider than available rectangle */
-        if (draw->flags & GUI_FLAG_FONT_RIGHTALIGN) {   /* Check right align text */
-            gui_string_prepare(&currStr, str);      /* Prepare string */
-            str = string_get_pointer_for_width(font, &currStr, draw);  /* Get string pointer */
-        } else {
-            rect.width = draw->width;               /* Strip text width to available */
-        }
+    ymin = ymax = points[0].y;                      /* Get vertical size of polygon */
+    for (i = 1; i < len; i++) {
+        ymin = GUI_MIN(ymin, points[i].y);
+        ymax = GUI_MAX(ymax, points[i].y);
     }
-    
-    x = draw->x;                                    /* Get start X position */
-    y = draw->y;                                    /* Get start Y position */
-    
-    if (draw->align & GUI_VALIGN_CENTER) {          /* Check for vertical align center */
-        y += (draw->height - rect.height) / 2;      /* align center of drawing area */
-    } else if (draw->align & GUI_VALIGN_BOTTOM) {   /* Check for vertical align bottom */
-        y += draw->height - rect.height;            /* align bottom of drawing area */
+    if (ymax < disp->y1 || ymin >= disp->y2) {      /* Polygon is not visible */
+        return;
     }
     
-    if (y < draw->y) {                              /* Check situation first */
-        y = draw->y;
+    if (len > GUI_COUNT_OF(nodesBuff)) {            /* Each edge can cross scanline once */
+        nodes = GUI_MEMALLOC(sizeof(*nodes) * len);
+        if (nodes == NULL) {
+            return;
+        }
     }
-    y -= draw->Scrolly;                             /* Go scroll top */
     
-    /**
-     * Check Y start value in case of edit mode = allow always on bottom
+    /*
+     * Edges cross row when it is in range [y0, y1),
+     * last row uses range (y0, y1] to include bottom vertices and edges
+     */
+    for (y = GUI_MAX(ymin, disp->y1); y <= ymax && y < disp->y2; y++) {
+        cnt = 0;
+        for (i = 0, j = len - 1; i < len; j = i++) {
+            const gui_draw_poly_t *top, *bottom;
+            
+            if (points[j].y == points[i].y) {       /* Horizontal edges are filled by neighbour edges */
+                continue;
+            }
+            top = points[j].y < points[i].y ? &points[j] : &points[i];
+            bottom = points[j].y < points[i].y ? &points[i] : &points[j];
+            if (y < ymax ? (y >= top->y && y < bottom->y) : (y > top->y && y <= bottom->y)) {
+                dx = bottom->x - top->x;
+                dy = bottom->y - top->y;
+                num = (int32_t)(y - top->y) * dx * 2;   /* Get rounded crossing, dy is always positive */
+                x = top->x + (gui_dim_t)(num >= 0 ? (num + dy) / (2 * dy) : -((dy - num) / (2 * dy)));
+                
+                for (k = cnt++; k > 0 && nodes[k - 1] > x; k--) {   /* Insertion sort crossings */
+                    nodes[k] = nodes[k - 1];
+                }
+                nodes[k] = x;
+            }
+        }
+        for (i = 0; i + 1 < cnt; i += 2) {          /* Draw spans between pairs of crossings */
+            gui_draw_hline(disp, nodes[i], y, nodes[i + 1] - nodes[i] + 1, color);
+        }
+    }
+    
+    if (nodes != nodesBuff) {
+        GUI_MEMFREE(nodes);
+    }
+}
+
+/**
+ * \brief           Horizontal span of anti-aliased pixels waiting for blending
+ */
+typedef struct {
+    gui_dim_t x;                                    /*!< X position of first pixel */
+    gui_dim_t y;                                    /*!< Y position of span */
+    gui_dim_t len;                                  /*!< Number of pixels in span */
+    uint8_t alpha[32];                              /*!< Coverage of each pixel */
+} aa_span_t;
+
+/**
+ * \brief           Blend collected span to drawing layer
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in,out]   s: Span to flush
+ * \param[in]       color: Color used for drawing operation
+ */
+static void
+aa_span_flush(const gui_display_t* disp, aa_span_t* s, gui_color_t color) {
+    gui_dim_t i;
+    
+    if (!s->len) {
+        return;
+    }
+#if GUI_CFG_LCD_ROTATION
+    if (GUI_LL_HAS(BlendHLine) && GUI.lcd.rotation != GUI_LCD_ROTATION_0) {
+        gui_dim_t x, y;
+        
+        for (i = 0; i < s->len; i++) {              /* Span is not continuous in display memory */
+            x = s->x + i;
+            y = s->y;
+            guii_lcd_mappoint(&x, &y);
+            GUI_LL(BlendHLine)(&GUI.lcd, GUI.lcd.drawing_layer, x - GUI.lcd.drawing_layer->x_offset, y - GUI.lcd.drawing_layer->y_offset, 1, &s->alpha[i], color);
+        }
+    } else
+#endif /* GUI_CFG_LCD_ROTATION */
+    if (GUI_LL_HAS(BlendHLine)) {
+        GUI_LL(BlendHLine)(&GUI.lcd, GUI.lcd.drawing_layer, s->x - GUI.lcd.drawing_layer->x_offset, s->y - GUI.lcd.drawing_layer->y_offset, s->len, s->alpha, color);
+    } else {                                        /* Blend pixel by pixel */
+        for (i = 0; i < s->len; i++) {
+            if (s->alpha[i] == 0xFF) {
+                gui_draw_setpixel(disp, s->x + i, s->y, color);
+            } else if (s->alpha[i]) {
+                gui_draw_setpixel(disp, s->x + i, s->y, blend_color(color, gui_draw_getpixel(disp, s->x + i, s->y), s->alpha[i]));
+            }
+        }
+    }
+    s->len = 0;
+}
+
+/**
+ * \brief           Add anti-aliased pixel to span
+ * \note            Span is blended when pixel does not continue it
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in,out]   s: Span to add pixel to
+ * \param[in]       x: Pixel X position
+ * \param[in]       y: Pixel Y position
+ * \param[in]       a: Pixel coverage
+ * \param[in]       color: Color used for drawing operation
+ */
+static void
+aa_span_put(const gui_display_t* disp, aa_span_t* s, gui_dim_t x, gui_dim_t y, uint8_t a, gui_color_t color) {
+    if (x < disp->x1 || x >= disp->x2 || y < disp->y1 || y >= disp->y2) {
+        return;
+    }
+    if (s->len && (y != s->y || x != s->x + s->len || s->len == GUI_COUNT_OF(s->alpha))) {
+        aa_span_flush(disp, s, color);
+    }
+    if (!s->len) {
+        s->x = x;
+        s->y = y;
+    }
+    s->alpha[s->len++] = a;
+}
+
+/**
+ * \brief           Integer square root
+ * \param[in]       v: Input value
+ * \return          Square root rounded down
+ */
+static uint32_t
+isqrt(uint32_t v) {
+    uint32_t res = 0, bit = 1UL << 30;
+    
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+/**
+ * \brief           Draw anti-aliased line from point 1 to point 2
+ *
+ *                  Line is drawn with Xiaolin Wu algorithm,
+ *                  coverage of 2 neighbour pixels is calculated in 16.16 fixed point
+ *
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       x1: Line start X position
+ * \param[in]       y1: Line start Y position
+ * \param[in]       x2: Line end X position
+ * \param[in]       y2: Line end Y position
+ * \param[in]       color: Color used for drawing operation
+ * \sa              gui_draw_line, gui_draw_circle_aa, gui_draw_arc_aa
+ */
+void
+gui_draw_line_aa(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x2, gui_dim_t y2, gui_color_t color) {
+    aa_span_t spans[2];
+    int32_t grad, pos;
+    gui_dim_t i, tmp, p;
+    uint8_t a;
+    
+    if (x1 == x2 || y1 == y2) {                     /* Straight lines are already sharp */
+        gui_draw_line(disp, x1, y1, x2, y2, color);
+        return;
+    }
+    DL_RECORD(dl_add_line(disp, x1, y1, x2, y2, color));
+    if (!__GUI_RECT_MATCH(
+        disp->x1, disp->y1, disp->x2, disp->y2,
+        GUI_MIN(x1, x2), GUI_MIN(y1, y2), GUI_MAX(x1, x2) + 2, GUI_MAX(y1, y2) + 2
+    )) {
+        return;
+    }
+    spans[0].len = spans[1].len = 0;
+    
+    if (GUI_ABS(x2 - x1) >= GUI_ABS(y2 - y1)) {     /* Step in X direction */
+        if (x1 > x2) {
+            tmp = x1; x1 = x2; x2 = tmp;
+            tmp = y1; y1 = y2; y2 = tmp;
+        }
+        grad = (int32_t)(y2 - y1) * 65536 / (x2 - x1);
+        pos = (int32_t)y1 * 65536;
+        for (i = x1; i <= x2; i++, pos += grad) {
+            p = (gui_dim_t)(pos >> 16);             /* Upper pixel row */
+            a = (uint8_t)((pos >> 8) & 0xFF);       /* Coverage of lower pixel */
+            
+            /* Rows are mapped to spans by parity so each row keeps its span */
+            aa_span_put(disp, &spans[p & 0x01], i, p, 0xFF - a, color);
+            aa_span_put(disp, &spans[(p + 1) & 0x01], i, p + 1, a, color);
+        }
+    } else {                                        /* Step in Y direction */
+        if (y1 > y2) {
+            tmp = x1; x1 = x2; x2 = tmp;
+            tmp = y1; y1 = y2; y2 = tmp;
+        }
+        grad = (int32_t)(x2 - x1) * 65536 / (y2 - y1);
+        pos = (int32_t)x1 * 65536;
+        for (i = y1; i <= y2; i++, pos += grad) {
+            p = (gui_dim_t)(pos >> 16);             /* Left pixel column */
+            a = (uint8_t)((pos >> 8) & 0xFF);       /* Coverage of right pixel */
+            
+            aa_span_put(disp, &spans[0], p, i, 0xFF - a, color);
+            aa_span_put(disp, &spans[0], p + 1, i, a, color);
+        }
+    }
+    aa_span_flush(disp, &spans[0], color);
+    aa_span_flush(disp, &spans[1], color);
+}
+
+/**
+ * \brief           Check if point is part of arc
+ * \param[in]       dx: X offset from center
+ * \param[in]       dy: Y offset from center
+ * \param[in]       arc: Arc start and end vectors and flag if arc is larger than half circle, `NULL` for full circle
+ * \return          `1` if point is inside, `0` otherwise
+ */
+static uint8_t
+arc_contains(int32_t dx, int32_t dy, const int32_t* arc) {
+    int32_t cs, ce;
+    
+    if (arc == NULL) {
+        return 1;
+    }
+    cs = arc[0] * dy - arc[1] * dx;                 /* Positive when point is clockwise from start */
+    ce = dx * arc[3] - dy * arc[2];                 /* Positive when end is clockwise from point */
+    return arc[4] ? (cs >= 0 || ce >= 0) : (cs >= 0 && ce >= 0);
+}
+
+/**
+ * \brief           Draw anti-aliased circle or its part
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       x0: X position of circle center
+ * \param[in]       y0: Y position of circle center
+ * \param[in]       r: Circle radius
+ * \param[in]       arc: Arc description for \ref arc_contains, `NULL` for full circle
+ * \param[in]       color: Color used for drawing operation
+ */
+static void
+draw_circle_aa(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y0, gui_dim_t r, const int32_t* arc, gui_color_t color) {
+    aa_span_t spans[2];
+    gui_dim_t i, u, v, xmax;
+    uint32_t pos;
+    uint8_t oct, a, sx, sy;
+    
+    if (r <= 0 || !__GUI_RECT_MATCH(
+        disp->x1, disp->y1, disp->x2, disp->y2,
+        x0 - r - 1, y0 - r - 1, x0 + r + 2, y0 + r + 2
+    )) {
+        return;
+    }
+    xmax = (gui_dim_t)((r * 181) >> 8);             /* Octant ends at r / sqrt(2) */
+    
+    /*
+     * Each octant is drawn separately, pixels are put with increasing X coordinate,
+     * so pixels on the same row join to spans
      */
-    if (draw->flags & GUI_FLAG_FONT_MULTILINE && rect.IsEditMode) { /* In multi-line and edit mode */
-        if (rect.height > draw->height) {           /* If text is greater than visible area in edit mode, set it to bottom align */
-            y = draw->y + draw->height - rect.height;
+    for (oct = 0; oct < 8; oct++) {
+        sx = oct & 0x01;                            /* Mirror in X direction */
+        sy = (oct >> 1) & 0x01;                     /* Mirror in Y direction */
+        spans[0].len = spans[1].len = 0;
+        for (i = 0; i <= xmax; i++) {
+            u = sx ? (xmax - i) : i;                /* Go in direction of increasing X */
+            if (!u && (oct < 4 ? sx : sy)) {
+                continue;                           /* Pixel on axis is drawn by not mirrored octant */
+            }
+            pos = isqrt(((uint32_t)r * r - (uint32_t)u * u) << 16); /* Exact distance from axis in 8.8 format */
+            v = (gui_dim_t)(pos >> 8);
+            a = (uint8_t)(pos & 0xFF);              /* Coverage of outer pixel */
+            if (oct < 4) {                          /* Top and bottom octants, X is moving */
+                gui_dim_t x = sx ? x0 - u : x0 + u;
+                gui_dim_t yi = sy ? y0 + v : y0 - v;
+                gui_dim_t yo = sy ? yi + 1 : yi - 1;
+                
+                if (u >= v) {
+                    continue;                       /* Diagonal is drawn by side octants */
+                }
+                if (arc_contains(x - x0, yi - y0, arc)) {
+                    aa_span_put(disp, &spans[yi & 0x01], x, yi, 0xFF - a, color);
+                    aa_span_put(disp, &spans[yo & 0x01], x, yo, a, color);
+                }
+            } else {                                /* Left and right octants, Y is moving */
+                gui_dim_t y = sy ? y0 + u : y0 - u;
+                gui_dim_t xi = sx ? x0 - v : x0 + v;
+                
+                if (!arc_contains(xi - x0, y - y0, arc)) {
+                    continue;
+                }
+                if (sx) {                           /* Outer pixel is on the left */
+                    aa_span_put(disp, &spans[0], xi - 1, y, a, color);
+                    aa_span_put(disp, &spans[0], xi, y, 0xFF - a, color);
+                } else {
+                    aa_span_put(disp, &spans[0], xi, y, 0xFF - a, color);
+                    aa_span_put(disp, &spans[0], xi + 1, y, a, color);
+                }
+            }
+        }
+        aa_span_flush(disp, &spans[0], color);
+        aa_span_flush(disp, &spans[1], color);
+    }
+}
+
+/**
+ * \brief           Draw anti-aliased circle
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       x0: X position of circle center
+ * \param[in]       y0: Y position of circle center
+ * \param[in]       r: Circle radius
+ * \param[in]       color: Color used for drawing operation
+ * \sa              gui_draw_circle, gui_draw_arc_aa, gui_draw_line_aa
+ */
+void
+gui_draw_circle_aa(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y0, gui_dim_t r, gui_color_t color) {
+    DL_RECORD(dl_add_arc(disp, DL_CIRCLE_AA, x0, y0, r, 0, 0, color));
+    draw_circle_aa(disp, x0, y0, r, NULL, color);
+}
+
+/**
+ * \brief           Draw anti-aliased arc
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       x0: X position of arc center
+ * \param[in]       y0: Y position of arc center
+ * \param[in]       r: Arc radius
+ * \param[in]       start: Start angle in units of degrees. `0` points to the right, angle increases clockwise
+ * \param[in]       end: End angle in units of degrees. Arc is drawn clockwise from start to end angle
+ * \param[in]       color: Color used for drawing operation
+ * \sa              gui_draw_circle_aa, gui_draw_line_aa
+ */
+void
+gui_draw_arc_aa(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y0, gui_dim_t r, int16_t start, int16_t end, gui_color_t color) {
+    int32_t arc[5];
+    int16_t sweep;
+    
+    DL_RECORD(dl_add_arc(disp, DL_ARC_AA, x0, y0, r, start, end, color));
+    sweep = (int16_t)(((end - start) % 360 + 360) % 360);   /* Get clockwise arc length */
+    if (!sweep && end != start) {
+        sweep = 360;
+    }
+    if (sweep >= 360) {
+        draw_circle_aa(disp, x0, y0, r, NULL, color);
+        return;
+    }
+    
+    /* Start and end direction vectors in 1.14 format, trigonometry is needed only once per arc */
+    arc[0] = (int32_t)(cosf(start * 0.01745329f) * 16384.0f);
+    arc[1] = (int32_t)(sinf(start * 0.01745329f) * 16384.0f);
+    arc[2] = (int32_t)(cosf(end * 0.01745329f) * 16384.0f);
+    arc[3] = (int32_t)(sinf(end * 0.01745329f) * 16384.0f);
+    arc[4] = sweep > 180;
+    draw_circle_aa(disp, x0, y0, r, arc, color);
+}
+
+#if GUI_CFG_FONT_LINE_COMPOSE || __DOXYGEN__
+
+/**
+ * \brief           Visible part of text line composed to alpha strip before blending
+ */
+typedef struct {
+    gui_dim_t x1, y1, x2, y2;                       /*!< Area of strip on screen */
+    gui_dim_t used_x1, used_x2;                     /*!< Columns cleared and used by composed characters */
+    uint8_t* buff;                                  /*!< One alpha value per pixel in range of low-level format, `NULL` when not used */
+} text_strip_t;
+
+/**
+ * \brief           Prepare strip for visible part of text line
+ * \param[out]      st: Strip to prepare
+ * \param[in]       disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       font: Font used for drawing
+ * \param[in]       x: Start X position of line
+ * \param[in]       y: Top Y position of line
+ * \param[in]       width: Width of line in units of pixels
+ */
+static void
+text_strip_begin(text_strip_t* st, const gui_display_t* disp, const gui_font_t* font, gui_dim_t x, gui_dim_t y, gui_dim_t width) {
+    size_t size;
+    
+    st->x1 = GUI_MAX(x, disp->x1);
+    st->x2 = GUI_MIN(x + width, disp->x2);
+    st->y1 = GUI_MAX(y, disp->y1);
+    st->y2 = GUI_MIN(y + font->size, disp->y2);
+    st->used_x1 = st->used_x2 = 0;
+    st->buff = NULL;
+    if (!GUI_LL_HAS(CopyChar) || st->x2 <= st->x1 || st->y2 <= st->y1) {
+        return;
+    }
+#if GUI_CFG_LCD_ROTATION
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {
+        return;                                     /* Characters are copied from rotated entries */
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    
+    /* Unpacked values, followed by packed copy of both color parts when low-level expects 4-bit alpha */
+    size = (size_t)(st->x2 - st->x1) * (st->y2 - st->y1);
+    if (GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) {
+        size += (size_t)(((st->x2 - st->x1) >> 1) + 1) * (st->y2 - st->y1);
+    }
+    guii_ll_waitready();                            /* Strip may still be read by low-level */
+    if (DrawShared.TextStripSize < size) {
+        GUI_MEMFREE(DrawShared.TextStrip);
+        GUI_MEM_TAGGED(GUI_MEM_TAG_TEXT_STRIP, DrawShared.TextStrip = GUI_MEMALLOC_NOZERO_HINT(size, GUI_MEM_BULK));
+        DrawShared.TextStripSize = DrawShared.TextStrip != NULL ? size : 0;
+    }
+    st->buff = DrawShared.TextStrip;
+}
+
+/**
+ * \brief           Compose character to text strip
+ * \param[in,out]   st: Text strip
+ * \param[in]       disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       font: Font character belongs to
+ * \param[in]       x: Left X position of character
+ * \param[in]       y: Top Y position of text line
+ * \param[in]       c: Character info handle
+ * \return          `1` when character was composed, `0` when it must be drawn separately
+ */
+static uint8_t
+text_strip_char(text_strip_t* st, const gui_display_t* disp, const gui_font_t* font, gui_dim_t x, gui_dim_t y, const gui_font_char_t* c) {
+    gui_font_charentry_t* entry;
+    const uint8_t *ptr, *src;
+    uint8_t* dst;
+    gui_dim_t x1, x2, y1, y2, px, py, stride;
+    uint8_t a4 = (GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) ? 1 : 0, max = a4 ? 0x0F : 0xFF, a, b;
+    
+    if (st->buff == NULL) {
+        return 0;
+    }
+    y += c->y_pos;
+    x1 = GUI_MAX(x, disp->x1);                      /* Visible part of character */
+    x2 = GUI_MIN(x + c->x_size, disp->x2);
+    y1 = GUI_MAX(y, disp->y1);
+    y2 = GUI_MIN(y + c->y_size, disp->y2);
+    if (x1 >= x2 || y1 >= y2) {
+        return 1;                                   /* Nothing to draw */
+    }
+    if (x1 < st->x1 || x2 > st->x2 || y1 < st->y1 || y2 > st->y2
+        || (st->used_x2 > st->used_x1 && x1 < st->used_x1)) {
+        return 0;                                   /* Outside of strip or left of cleared columns */
+    }
+    if (CHAR_DATA_DIRECT(font)) {
+        ptr = c->data;                              /* Font data are already in low-level format */
+    } else {
+        if ((entry = get_char_entry_from_font(font, c)) == NULL
+            && (entry = create_char_entry_from_font(font, c)) == NULL) {
+            return 0;
+        }
+        ptr = (const uint8_t *)entry + GUI_MEM_ALIGN(sizeof(*entry));
+    }
+    
+    stride = st->x2 - st->x1;
+    if (st->used_x2 <= st->used_x1) {               /* First character of line */
+        st->used_x1 = st->used_x2 = x1;
+    }
+    if (x2 > st->used_x2) {                         /* Clear new columns on all lines */
+        for (py = 0; py < st->y2 - st->y1; py++) {
+            memset(st->buff + (size_t)py * stride + (st->used_x2 - st->x1), 0x00, (size_t)(x2 - st->used_x2));
+        }
+        st->used_x2 = x2;
+    }
+    
+    /* Overlapping pixels are combined the same way as blending characters one after another */
+    for (py = y1; py < y2; py++) {
+        src = ptr + (size_t)(py - y) * CHAR_ENTRY_LINE_SIZE(c);
+        dst = st->buff + (size_t)(py - st->y1) * stride + (x1 - st->x1);
+        for (px = x1 - x; px < x2 - x; px++, dst++) {
+            a = a4 ? (uint8_t)((src[px >> 1] >> ((px & 0x01) << 2)) & 0x0F) : src[px];
+            if (a) {
+                b = *dst;
+                *dst = b ? (uint8_t)(a + b - (a * b + (max >> 1)) / max) : a;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Blend composed text strip to drawing layer
+ *
+ *                  Strip is blended with one low-level call for every text color it contains
+ *
+ * \param[in,out]   st: Text strip
+ * \param[in]       draw: Drawing parameters with colors
+ */
+static void
+text_strip_flush(text_strip_t* st, const gui_draw_font_t* draw) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    gui_dim_t split, px1, w, h, stride, line, i, k;
+    const uint8_t *src, *v;
+    uint8_t *packed, *p;
+    uint8_t part;
+    
+    if (st->buff == NULL || st->used_x2 <= st->used_x1) {
+        return;
+    }
+    h = st->y2 - st->y1;
+    stride = st->x2 - st->x1;
+    packed = st->buff + (size_t)stride * h;
+    split = GUI_MIN(GUI_MAX(draw->x + draw->color1width, st->used_x1), st->used_x2);    /* Second color starts here */
+    for (part = 0; part < 2; part++) {
+        px1 = part ? split : st->used_x1;
+        w = (part ? st->used_x2 : split) - px1;
+        if (w <= 0) {
+            continue;
+        }
+        src = st->buff + (px1 - st->x1);
+        line = stride;
+        if (GUI.lcd.flags & GUI_FLAG_LCD_CHAR_A4) { /* Pack part to start on byte boundary, first pixel is in low nibble */
+            line = (w + 1) >> 1;
+            for (k = 0, p = packed; k < h; k++) {
+                v = src + (size_t)k * stride;
+                for (i = 0; i + 1 < w; i += 2) {
+                    *p++ = (uint8_t)(v[i] | (v[i + 1] << 4));
+                }
+                if (i < w) {
+                    *p++ = v[i];
+                }
+            }
+            src = packed;
+            packed = p;                             /* Second part must not overwrite data of pending transfer */
+            line <<= 1;
+        }
+        GUI_LL(CopyChar)(&GUI.lcd, layer, src,
+            (void *)(layer->start_address + layer->pixel_size * ((st->y1 - layer->y_offset) * layer->width + (px1 - layer->x_offset))),
+            w, h, line - w, layer->width - w, part ? draw->Color2 : draw->color1);
+    }
+    st->used_x1 = st->used_x2 = 0;
+}
+
+#endif /* GUI_CFG_FONT_LINE_COMPOSE || __DOXYGEN__ */
+
+/**
+ * \brief           Draw single line of text
+ * \param[in]       disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       font: Font used for drawing
+ * \param[in]       draw: Drawing parameters
+ * \param[in]       x: Start X position of line
+ * \param[in]       y: Top Y position of line
+ * \param[in]       width: Width of line in units of pixels
+ * \param[in,out]   s: String object pointing to first character of line
+ * \param[in]       cnt: Number of characters to read from string
+ * \param[in]       drawcnt: Number of characters to draw, others are only read
+ */
+static void
+draw_text_line(const gui_display_t* disp, const gui_font_t* font, const gui_draw_font_t* draw, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_string_t* s, size_t cnt, size_t drawcnt) {
+    const gui_font_char_t* c;
+    const gui_font_t* f;
+    uint32_t ch;
+    uint8_t i;
+#if GUI_CFG_FONT_LINE_COMPOSE
+    text_strip_t st;
+    
+    text_strip_begin(&st, disp, font, x, y, width);
+#else /* GUI_CFG_FONT_LINE_COMPOSE */
+    GUI_UNUSED(width);
+#endif /* !GUI_CFG_FONT_LINE_COMPOSE */
+    
+    while (cnt-- && gui_string_getch(s, &ch, &i)) { /* Read character by character */
+        if (drawcnt == 0) {                         /* Anything to draw? */
+            gui_string_skip(s, cnt);                /* Only read remaining characters */
+            break;
+        }
+        drawcnt--;                                  /* Decrease number of drawn elements */
+        
+        if (x > disp->x2) {                         /* Check if X over line */
+            continue;
+        }
+        
+        ch = get_char_from_value(ch);               /* Get char from char value */
+        if ((c = string_get_char_ptr(font, ch, &f)) == 0) { /* Get character pointer */
+            continue;                               /* Character is not known */
+        }
+#if GUI_CFG_FONT_LINE_COMPOSE
+        if (!text_strip_char(&st, disp, f, x, y, c)) {
+            draw_char(disp, f, draw, x, y, c);      /* Character does not fit to strip */
+        }
+#else /* GUI_CFG_FONT_LINE_COMPOSE */
+        draw_char(disp, f, draw, x, y, c);          /* Draw actual char with font it belongs to */
+#endif /* !GUI_CFG_FONT_LINE_COMPOSE */
+        
+        x += c->x_size + c->x_margin;               /* Increase X position */
+    }
+#if GUI_CFG_FONT_LINE_COMPOSE
+    text_strip_flush(&st, draw);                    /* Blend whole line at once */
+#endif /* GUI_CFG_FONT_LINE_COMPOSE */
+}
+
+/**
+ * \brief           Calculate hash and length of text
+ * \param[in]       str: Text to process
+ * \param[out]      len: Output variable for text length in units of bytes
+ * \return          Text hash value
+ */
+static uint32_t
+text_hash(const gui_char* str, size_t* len) {
+    const gui_char* p = str;
+    uint32_t hash = 0x811C9DC5;                     /* FNV-1a hash */
+    
+    for (; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 0x01000193;
+    }
+    *len = p - str;
+    return hash;
+}
+
+/**
+ * \brief           Calculate hash of part of text
+ * \param[in]       str: Text to process
+ * \param[in]       len: Number of bytes to process
+ * \return          Hash value
+ */
+static uint32_t
+text_hash_part(const gui_char* str, size_t len) {
+    uint32_t hash = 0x811C9DC5;                     /* FNV-1a hash */
+    
+    while (len--) {
+        hash = (hash ^ (uint8_t)*str++) * 0x01000193;
+    }
+    return hash;
+}
+
+/**
+ * \brief           Get offset of line end, which is start of next line or end of text
+ * \param[in]       l: Text layout
+ * \param[in]       i: Line index
+ * \param[in]       len: Text length in units of bytes
+ * \return          Offset from beginning of text in units of bytes
+ */
+#define TEXT_LINE_END(l, i, len)    ((i) + 1 < (l)->lines_count ? (size_t)((l)->lines[(i) + 1].str - (l)->str) : (len))
+
+/**
+ * \brief           Set size of text rectangle from lines of layout
+ * \param[in,out]   l: Text layout with valid lines
+ */
+static void
+text_layout_size(gui_draw_text_layout_t* l) {
+    size_t i;
+    
+    l->rect_width = 0;
+    for (i = 0; i < l->lines_count; i++) {
+        if (l->lines[i].width > l->rect_width) {
+            l->rect_width = l->lines[i].width;
+        }
+    }
+    l->rect_height = (gui_dim_t)GUI_MAX(l->lines_count, 1) * l->lineheight;
+}
+
+/**
+ * \brief           Update layout of multi-line text in edit mode after text has been edited in place
+ *
+ *                  Line break depends only on text read from line start to \ref gui_draw_text_line_t.lookahead.
+ *                  Lines which have not read edited text are kept, computation starts from first line which has,
+ *                  as word wrap may move text back to it, and stops when new line starts
+ *                  at the same text as one of old lines with unmodified text after it.
+ *                  Remaining old lines are then only moved
+ *
+ * \param[in]       l: Layout computed for the same text buffer, font and drawing box
+ * \param[in]       rect: Rectangle parameters prepared for drawing
+ * \param[in]       len: New text length in units of bytes
+ * \param[in]       hash: New text hash
+ * \return          Updated layout on success, `NULL` when complete layout must be computed again
+ */
+static gui_draw_text_layout_t*
+text_layout_update(gui_draw_text_layout_t* l, gui_stringrect_t* rect, size_t len, uint32_t hash) {
+    gui_draw_text_layout_t* n;
+    gui_string_t s;
+    const gui_char *str = l->str, *start;
+    size_t i, k, q, end, cnt, lines, count, tail;
+    ptrdiff_t delta = (ptrdiff_t)len - (ptrdiff_t)l->len;
+    
+    /* Find first line with modified text */
+    for (i = 0; i + 1 < l->lines_count; i++) {
+        end = TEXT_LINE_END(l, i, l->len);
+        if (end > len || text_hash_part(l->lines[i].str, end - (l->lines[i].str - str)) != l->lines[i].hash) {
+            break;
+        }
+    }
+    
+    /* Find first line which has read modified text to get its line break */
+    for (k = 0; k < i && (size_t)(l->lines[k].str - str) + l->lines[k].lookahead <= (size_t)(l->lines[i].str - str); k++) {}
+    start = l->lines[k].str;
+    
+    /* Count new lines until they are aligned to old lines again */
+    lines = 0;
+    tail = 0;
+    q = i + 1;
+    gui_string_prepare(&s, start);
+    while ((cnt = string_rectangle(rect, &s, 1)) > 0) {
+        gui_string_skip(&s, cnt);
+        lines++;
+        end = s.Str - str;                          /* Start of next line */
+        for (; q < l->lines_count && (ptrdiff_t)(l->lines[q].str - str) + delta < (ptrdiff_t)end; q++) {}
+        if (q < l->lines_count && (ptrdiff_t)(l->lines[q].str - str) + delta == (ptrdiff_t)end) {
+            for (i = q; i < l->lines_count; i++) {  /* Text of all remaining lines must be the same */
+                if (text_hash_part(l->lines[i].str + delta, TEXT_LINE_END(l, i, l->len) - (l->lines[i].str - str)) != l->lines[i].hash) {
+                    break;
+                }
+            }
+            if (i == l->lines_count) {
+                tail = l->lines_count - q;          /* Old lines are valid from here */
+                break;
+            }
+        }
+    }
+    count = k + lines + tail;
+    
+    if (count > l->lines_count) {
+        GUI_MEM_TAGGED(GUI_MEM_TAG_TEXTLAYOUT, n = GUI_MEMREALLOC(l, sizeof(*l) + count * sizeof(l->lines[0])));
+        if (n == NULL) {
+            return NULL;
+        }
+        l = n;
+    }
+    memmove(&l->lines[k + lines], &l->lines[q], tail * sizeof(l->lines[0]));
+    for (i = k + lines; i < count; i++) {
+        l->lines[i].str += delta;                   /* Text after edit is moved */
+    }
+    if (count < l->lines_count) {
+        GUI_MEM_TAGGED(GUI_MEM_TAG_TEXTLAYOUT, n = GUI_MEMREALLOC(l, sizeof(*l) + count * sizeof(l->lines[0])));
+        if (n != NULL) {                            /* Shrinking can keep old memory */
+            l = n;
+        }
+    }
+    
+    /* Get line breaks of edited lines and save them */
+    gui_string_prepare(&s, start);
+    for (i = k; i < k + lines && (cnt = string_rectangle(rect, &s, 1)) > 0; i++) {
+        l->lines[i].str = s.Str;
+        l->lines[i].total = cnt;
+        l->lines[i].draw = rect->ReadDraw;
+        l->lines[i].width = rect->width;
+        l->lines[i].lookahead = rect->ReadEnd - s.Str;
+        gui_string_skip(&s, cnt);
+        l->lines[i].hash = text_hash_part(l->lines[i].str, s.Str - l->lines[i].str);
+    }
+    
+    l->lines_count = count;
+    text_layout_size(l);
+    l->len = len;
+    l->hash = hash;
+    return l;
+}
+
+/**
+ * \brief           Get layout of text for drawing box, compute it again only when anything changed
+ * \param[in]       font: Font used for drawing
+ * \param[in]       str: Text to draw
+ * \param[in]       draw: Drawing parameters with valid layout cache pointer
+ * \return          Layout on success, `NULL` when there is no memory for it
+ */
+static gui_draw_text_layout_t*
+text_layout_get(const gui_font_t* font, const gui_char* str, gui_draw_font_t* draw) {
+    gui_draw_text_layout_t* l = *draw->layout;
+    gui_stringrect_t rect = {0};
+    gui_string_t s;
+    const gui_char* start = str;
+    gui_dim_t x_offset = 0, x;
+    size_t len, cnt, lines = 0;
+    uint32_t hash;
+    
+    hash = text_hash(str, &len);
+    if (l != NULL && l->str == str && l->len == len && l->hash == hash && l->font == font &&
+        l->width == draw->width && l->lineheight == draw->Lineheight && l->flags == draw->flags) {
+        return l;                                   /* Nothing changed since last time */
+    }
+    
+    rect.Font = font;                               /* Save font structure */
+    rect.StringDraw = draw;                         /* Set drawing pointer */
+    rect.IsEditMode = !!(draw->flags & GUI_FLAG_FONT_EDITMODE); /* Check if in edit mode */
+    
+    /* Text edited in place by widget, update only changed lines */
+    if (l != NULL && l->str == str && l->font == font && l->width == draw->width && l->lineheight == draw->Lineheight && l->flags == draw->flags
+        && (draw->flags & GUI_FLAG_FONT_MULTILINE) && rect.IsEditMode && !l->x_offset && l->lines_count) {
+        gui_draw_text_layout_t* n = text_layout_update(l, &rect, len, hash);
+        if (n != NULL) {
+            *draw->layout = l = n;
+            if (l->rect_width <= draw->width) {
+                return l;
+            }
+        }
+    }
+    
+    gui_string_prepare(&s, str);                    /* Prepare string */
+    string_rectangle(&rect, &s, 0);                 /* Get string width for this box */
+    if (rect.width > draw->width) {                 /* If string is wider than available rectangle */
+        if (draw->flags & GUI_FLAG_FONT_RIGHTALIGN) {   /* Check right align text */
+            x = draw->x;
+            gui_string_prepare(&s, str);            /* Prepare string */
+            start = string_get_pointer_for_width(font, &s, draw);   /* Get string pointer */
+            x_offset = draw->x - x;                 /* Save alignment offset */
+            draw->x = x;
+        } else {
+            rect.width = draw->width;               /* Strip text width to available */
+        }
+    }
+    
+    /* Count lines first to allocate memory only once */
+    gui_string_prepare(&s, start);
+    while ((cnt = string_rectangle(&rect, &s, 1)) > 0) {
+        gui_string_skip(&s, cnt);
+        lines++;
+        if (!(draw->flags & GUI_FLAG_FONT_MULTILINE)) {
+            break;
+        }
+    }
+    
+    GUI_MEM_TAGGED(GUI_MEM_TAG_TEXTLAYOUT, l = GUI_MEMREALLOC(l, sizeof(*l) + lines * sizeof(l->lines[0])));
+    if (l == NULL) {                                /* Draw without cache */
+        GUI_MEMFREE(*draw->layout);
+        return NULL;
+    }
+    *draw->layout = l;
+    
+    l->str = str;
+    l->len = len;
+    l->hash = hash;
+    l->font = font;
+    l->width = draw->width;
+    l->lineheight = draw->Lineheight;
+    l->flags = draw->flags;
+    l->x_offset = x_offset;
+    
+    /* Get line breaks again and save them */
+    gui_string_prepare(&s, start);
+    for (l->lines_count = 0; l->lines_count < lines && (cnt = string_rectangle(&rect, &s, 1)) > 0; l->lines_count++) {
+        l->lines[l->lines_count].str = s.Str;
+        l->lines[l->lines_count].total = cnt;
+        l->lines[l->lines_count].draw = rect.ReadDraw;
+        l->lines[l->lines_count].width = rect.width;
+        l->lines[l->lines_count].lookahead = rect.ReadEnd - s.Str;
+        gui_string_skip(&s, cnt);
+        l->lines[l->lines_count].hash = text_hash_part(l->lines[l->lines_count].str, s.Str - l->lines[l->lines_count].str);
+    }
+    text_layout_size(l);
+    return l;
+}
+
+/**
+ * \brief           Write text to screen
+ * \note            When \ref gui_draw_font_t.layout is set, line breaks and widths are computed
+ *                  only when text, font or drawing box changes and are reused on next redraw.
+ *                  Drawing then starts at first line visible on display, lines above it are not processed
+ * \param[in,out]   disp: Pointer to \ref gui_display_t structure for display operations
+ * \param[in]       font: Pointer to \ref gui_font_t structure with font to use
+ * \param[in]       str: Pointer to string to draw on screen
+ * \param[in]       draw: Pointer to \ref gui_draw_font_t structure with specifications about drawing style 
+ */
+void
+gui_draw_writetext(const gui_display_t* disp, const gui_font_t* font, const gui_char* str, gui_draw_font_t* draw) {
+    gui_dim_t x, y, height;
+    size_t cnt, i;
+    gui_stringrect_t rect = {0};                    /* Get string object */
+    gui_draw_text_layout_t* l = NULL;
+    gui_string_t currStr;
+    
+    DL_RECORD(dl_add_text(disp, font, str, draw));
+    if (!draw->Lineheight) {                        /* When line height is not set */
+        draw->Lineheight = font->size;              /* Set font size */
+    }
+    
+    if (draw->layout != NULL) {                     /* Use cached layout if possible */
+        l = text_layout_get(font, str, draw);
+    }
+    
+    if (l != NULL) {
+        draw->x += l->x_offset;                     /* Align right if text is too wide */
+        height = l->rect_height;
+    } else {
+        rect.Font = font;                           /* Save font structure */
+        rect.StringDraw = draw;                     /* Set drawing pointer */
+        rect.IsEditMode = !!(draw->flags & GUI_FLAG_FONT_EDITMODE); /* Check if in edit mode */
+          
+        gui_string_prepare(&currStr, str);          /* Prepare string */
+        string_rectangle(&rect, &currStr, 0);       /* Get string width for this box */
+        if (rect.width > draw->width) {             /* If string is wider than available rectangle */
+            if (draw->flags & GUI_FLAG_FONT_RIGHTALIGN) {   /* Check right align text */
+                gui_string_prepare(&currStr, str);  /* Prepare string */
+                str = string_get_pointer_for_width(font, &currStr, draw);  /* Get string pointer */
+            } else {
+                rect.width = draw->width;           /* Strip text width to available */
+            }
+        }
+        height = rect.height;
+    }
+    
+    x = draw->x;                                    /* Get start X position */
+    y = draw->y;                                    /* Get start Y position */
+    
+    if (draw->align & GUI_VALIGN_CENTER) {          /* Check for vertical align center */
+        y += (draw->height - height) / 2;           /* align center of drawing area */
+    } else if (draw->align & GUI_VALIGN_BOTTOM) {   /* Check for vertical align bottom */
+        y += draw->height - height;                 /* align bottom of drawing area */
+    }
+    
+    if (y < draw->y) {                              /* Check situation first */
+        y = draw->y;
+    }
+    y -= draw->Scrolly;                             /* Go scroll top */
+    
+    /**
+     * Check Y start value in case of edit mode = allow always on bottom
+     */
+    if (draw->flags & GUI_FLAG_FONT_MULTILINE && (draw->flags & GUI_FLAG_FONT_EDITMODE)) {  /* In multi-line and edit mode */
+        if (height > draw->height) {                /* If text is greater than visible area in edit mode, set it to bottom align */
+            y = draw->y + draw->height - height;
         }
     }    
     
+    if (l != NULL) {                                /* Draw lines from layout */
+        i = 0;
+        /* Characters may reach below line height, keep font size of margin above display area */
+        if ((draw->flags & GUI_FLAG_FONT_MULTILINE) && y + draw->Lineheight + font->size <= disp->y1) {
+            i = (size_t)((disp->y1 - font->size - y) / draw->Lineheight);   /* Jump directly to first visible line */
+            y += (gui_dim_t)i * draw->Lineheight;
+        }
+        for (; i < l->lines_count; i++) {
+            x = draw->x;
+            if (draw->align & GUI_HALIGN_CENTER) {  /* Check for horizontal align center */
+                x += (draw->width - l->lines[i].width) / 2; /* align center of drawing area */
+            } else if (draw->align & GUI_HALIGN_RIGHT) {    /* Check for horizontal align right */
+                x += draw->width - l->lines[i].width;   /* align right of drawing area */
+            }
+            gui_string_prepare(&currStr, l->lines[i].str);
+            draw_text_line(disp, font, draw, x, y, l->lines[i].width, &currStr, l->lines[i].total, l->lines[i].draw);
+            y += draw->Lineheight;                  /* Go to next line */
+            if (!(draw->flags & GUI_FLAG_FONT_MULTILINE) || y > disp->y2) { /* Not multiline or over visible Y area */
+                break;
+            }
+        }
+        return;
+    }
+    
     gui_string_prepare(&currStr, str);              /* Prepare string again */
     while ((cnt = string_rectangle(&rect, &currStr, 1)) > 0) {
         x = draw->x;                                       
@@ -1370,24 +4117,7 @@ gui_draw_writetext(const gui_display_t* disp, const gui_font_t* font, const gui_
         } else if (draw->align & GUI_HALIGN_RIGHT) {/* Check for horizontal align right */
             x += draw->width - rect.width;          /* align right of drawing area */
         }
-        while (cnt-- && gui_string_getch(&currStr, &ch, &i)) {  /* Read character by character */
-            if (rect.ReadDraw == 0) {               /* Anything to draw? */
-                continue;
-            }
-            rect.ReadDraw--;                        /* Decrease number of drawn elements */
-            
-            if (x > disp->x2) {                     /* Check if X over line */
-                continue;
-            }
-            
-            ch = get_char_from_value(ch);           /* Get char from char value */
-            if ((c = string_get_char_ptr(font, ch)) == 0) { /* Get character pointer */
-                continue;                           /* Character is not known */
-            }
-            draw_char(disp, font, draw, x, y, c);   /* Draw actual char */
-            
-            x += c->x_size + c->x_margin;           /* Increase X position */
-        }
+        draw_text_line(disp, font, draw, x, y, rect.width, &currStr, cnt, rect.ReadDraw);
         y += draw->Lineheight;                      /* Go to next line */
         if (!(draw->flags & GUI_FLAG_FONT_MULTILINE) || y > disp->y2) { /* Not multiline or over visible Y area */
             break;
@@ -1395,6 +4125,46 @@ gui_draw_writetext(const gui_display_t* disp, const gui_font_t* font, const gui_
     }
 }
 
+/**
+ * \brief           Get size of rectangle text occupies when drawn with specific parameters
+ * \note            Function uses only caller owned memory and does not access drawing layers.
+ *                  It may be called from any thread, for example to prepare widget size before drawing
+ * \param[in]       font: Pointer to \ref gui_font_t structure with font to use
+ * \param[in]       str: Pointer to string to measure
+ * \param[in]       draw: Pointer to \ref gui_draw_font_t structure with box width, flags and line height
+ * \param[out]      width: Output variable for text width in units of pixels. Can be `NULL`
+ * \param[out]      height: Output variable for text height in units of pixels. Can be `NULL`
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_draw_textsize(const gui_font_t* font, const gui_char* str, const gui_draw_font_t* draw, gui_dim_t* width, gui_dim_t* height) {
+    gui_stringrect_t rect = {0};
+    gui_draw_font_t d;
+    gui_string_t s;
+    
+    if (font == NULL || str == NULL || draw == NULL) {
+        return 0;
+    }
+    memcpy(&d, draw, sizeof(d));                    /* Work on local copy of parameters */
+    if (!d.Lineheight) {                            /* When line height is not set */
+        d.Lineheight = font->size;                  /* Set font size */
+    }
+    
+    rect.Font = font;
+    rect.StringDraw = &d;
+    rect.IsEditMode = !!(d.flags & GUI_FLAG_FONT_EDITMODE);
+    
+    gui_string_prepare(&s, str);                    /* Prepare string */
+    string_rectangle(&rect, &s, 0);                 /* Get string rectangle */
+    if (width != NULL) {
+        *width = rect.width;
+    }
+    if (height != NULL) {
+        *height = rect.height;
+    }
+    return 1;
+}
+
 /**
  * \brief           Initializes \ref gui_draw_sb_t structure for drawing operations
  * \param[in]       sb: Pointer to \ref gui_draw_sb_t to initialize to default values 
@@ -1440,3 +4210,153 @@ gui_draw_scrollbar(const gui_display_t* disp, gui_draw_sb_t* sb) {
     }
     gui_draw_rectangle3d(disp, sb->x, sb->y + btnH + midOffset, sb->width, rectheight, GUI_DRAW_3D_State_Raised); 
 }
+
+#if GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__
+
+/**
+ * \brief           Start recording of drawing commands to display list
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Drawing functions only record commands until \ref guii_draw_dlist_end is called,
+ *                  content is drawn by replaying recorded list.
+ *                  Recording of list can be started while other list is recorded, replay of inner list is then recorded to outer one
+ * \param[in,out]   list: Display list to record commands to
+ */
+void
+guii_draw_dlist_begin(gui_dlist_t* list) {
+    dl_outer_list = dl_list;                        /* Save outer list being recorded */
+    dl_outer_error = dl_error;
+    list->len = 0;                                  /* Start with empty list */
+    dl_error = 0;
+    dl_list = list;
+}
+
+/**
+ * \brief           Stop recording of drawing commands
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \return          `1` when all commands were recorded, `0` otherwise
+ */
+uint8_t
+guii_draw_dlist_end(void) {
+    gui_dlist_t* list = dl_list;
+    uint8_t error = dl_error;
+    
+    dl_list = dl_outer_list;                        /* Continue with outer list */
+    dl_error = dl_outer_error;
+    dl_outer_list = NULL;
+    dl_clip.x1 = 0x7FFF;                            /* Outer list needs new clipping command */
+    dl_clip.x2 = 0x8000;
+    if (error) {                                    /* List is not complete */
+        GUI_MEMFREE(list->data);
+        list->len = list->size = 0;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Check if drawing commands are recorded instead of drawn
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Pixels copied directly to layer with low-level functions are not part of recorded list
+ * \return          `1` when display list is recorded, `0` otherwise
+ */
+uint8_t
+guii_draw_dlist_isrecording(void) {
+    return DL_RECORDING() ? 1 : 0;
+}
+
+/**
+ * \brief           Draw recorded commands again
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       list: Recorded display list
+ * \param[in]       disp: Clipping region to draw in
+ */
+void
+guii_draw_dlist_replay(const gui_dlist_t* list, const gui_display_t* disp) {
+    const uint8_t* ptr = list->data;
+    const uint8_t* end = ptr + list->len;
+    const dl_cmd_t* cmd;
+    gui_display_t clip = *disp;
+    uint8_t visible = 1;
+    
+    for (; ptr < end; ptr += cmd->size) {
+        cmd = (const dl_cmd_t *)ptr;
+        if (cmd->op == DL_CLIP) {                   /* Recorded region is limited to current one */
+            clip.x1 = GUI_MAX(cmd->u.clip.x1, disp->x1);
+            clip.y1 = GUI_MAX(cmd->u.clip.y1, disp->y1);
+            clip.x2 = GUI_MIN(cmd->u.clip.x2, disp->x2);
+            clip.y2 = GUI_MIN(cmd->u.clip.y2, disp->y2);
+            visible = clip.x1 < clip.x2 && clip.y1 < clip.y2;
+            continue;
+        }
+        if (!visible) {                             /* Commands are completely outside region */
+            continue;
+        }
+        switch (cmd->op) {
+            case DL_FILLSCREEN:
+                gui_draw_fillscreen(&clip, cmd->u.rect.color);
+                break;
+            case DL_PIXEL:
+                gui_draw_setpixel(&clip, cmd->u.rect.x, cmd->u.rect.y, cmd->u.rect.color);
+                break;
+            case DL_HLINE:
+                gui_draw_hline(&clip, cmd->u.rect.x, cmd->u.rect.y, cmd->u.rect.width, cmd->u.rect.color);
+                break;
+            case DL_VLINE:
+                gui_draw_vline(&clip, cmd->u.rect.x, cmd->u.rect.y, cmd->u.rect.width, cmd->u.rect.color);
+                break;
+            case DL_RECTANGLE:
+                gui_draw_rectangle(&clip, cmd->u.rect.x, cmd->u.rect.y, cmd->u.rect.width, cmd->u.rect.height, cmd->u.rect.color);
+                break;
+            case DL_FILLEDRECTANGLE:
+                gui_draw_filledrectangle(&clip, cmd->u.rect.x, cmd->u.rect.y, cmd->u.rect.width, cmd->u.rect.height, cmd->u.rect.color);
+                break;
+            case DL_FILLEDRECTANGLES:
+                gui_draw_filledrectangles(&clip, (const gui_ll_rect_t *)(&cmd->u.count + 1), cmd->u.count);
+                break;
+            case DL_GRADIENTRECTANGLE:
+                gui_draw_gradientrectangle(&clip, cmd->u.gradient.x, cmd->u.gradient.y, cmd->u.gradient.width, cmd->u.gradient.height,
+                    &cmd->u.gradient.gradient, (gui_draw_gradient_dir_t)cmd->u.gradient.dir);
+                break;
+            case DL_RECTANGLE3D:
+                gui_draw_rectangle3d(&clip, cmd->u.rect.x, cmd->u.rect.y, cmd->u.rect.width, cmd->u.rect.height, (gui_draw_3d_state_t)cmd->u.rect.color);
+                break;
+            case DL_IMAGE:
+                gui_draw_image(&clip, cmd->u.image.x, cmd->u.image.y, cmd->u.image.img);
+                break;
+            case DL_IMAGE_SCALED:
+#if GUI_CFG_OS_RENDER_THREAD
+                __GUI_SYS_PROTECT();                /* Scaled image cache is shared with GUI thread */
+#endif /* GUI_CFG_OS_RENDER_THREAD */
+                gui_draw_image_scaled(&clip, cmd->u.scaled.x, cmd->u.scaled.y, cmd->u.scaled.width, cmd->u.scaled.height, cmd->u.scaled.img);
+#if GUI_CFG_OS_RENDER_THREAD
+                __GUI_SYS_UNPROTECT();
+#endif /* GUI_CFG_OS_RENDER_THREAD */
+                break;
+            case DL_TEXT: {
+                gui_draw_font_t draw = cmd->u.text.draw;    /* Drawing function may modify parameters */
+                
+#if GUI_CFG_OS_RENDER_THREAD
+                __GUI_SYS_PROTECT();                /* Font caches are shared with text functions of GUI thread */
+#endif /* GUI_CFG_OS_RENDER_THREAD */
+                gui_draw_writetext(&clip, cmd->u.text.font, (const gui_char *)(&cmd->u.text + 1), &draw);
+#if GUI_CFG_OS_RENDER_THREAD
+                __GUI_SYS_UNPROTECT();
+#endif /* GUI_CFG_OS_RENDER_THREAD */
+                break;
+            }
+            case DL_LINE_AA:
+                gui_draw_line_aa(&clip, cmd->u.line.x1, cmd->u.line.y1, cmd->u.line.x2, cmd->u.line.y2, cmd->u.line.color);
+                break;
+            case DL_CIRCLE_AA:
+                gui_draw_circle_aa(&clip, cmd->u.arc.x, cmd->u.arc.y, cmd->u.arc.r, cmd->u.arc.color);
+                break;
+            case DL_ARC_AA:
+                gui_draw_arc_aa(&clip, cmd->u.arc.x, cmd->u.arc.y, cmd->u.arc.r, cmd->u.arc.start, cmd->u.arc.end, cmd->u.arc.color);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+#endif /* GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__ */
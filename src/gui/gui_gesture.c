@@ -0,0 +1,165 @@
+/**	
+ * \file            gui_gesture.c
+ * \brief           Touch gesture recognition
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_gesture.h"
+#include "gui/gui_input.h"
+
+#if (GUI_CFG_USE_TOUCH && GUI_CFG_USE_TOUCH_GESTURES) || __DOXYGEN__
+
+/**
+ * \brief           Calculate swipe velocity of first touch at release
+ * \param[in]       touch: Touch data at release
+ * \param[in]       g: Gesture state with start position and time
+ * \param[out]      vx: Pointer to output X velocity in units of pixels per second
+ * \param[out]      vy: Pointer to output Y velocity in units of pixels per second
+ */
+static void
+swipe_velocity(const guii_touch_data_t* touch, const guii_touch_gesture_t* g, float* vx, float* vy) {
+#if GUI_CFG_TOUCH_HISTORY_SIZE
+    if (guii_input_touchvelocity(touch, vx, vy)) {  /* Use velocity of last part of movement */
+        return;
+    }
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE */
+    *vx = *vy = 0;
+    if (touch->ts.time != g->start_time) {          /* Use average velocity instead */
+        *vx = (float)g->dx * 1000.0f / (float)(touch->ts.time - g->start_time);
+        *vy = (float)g->dy * 1000.0f / (float)(touch->ts.time - g->start_time);
+    }
+}
+
+/**
+ * \brief           Check for swipe at touch release
+ * \param[in,out]   touch: Touch data at release
+ * \return          \ref GUI_WC_Swipe if swipe is detected, `0` otherwise
+ */
+static gui_wc_t
+swipe_check(guii_touch_data_t* touch) {
+    guii_touch_gesture_t* g = &touch->gesture;
+    float vx, vy;
+    
+    if (g->multi) {                                 /* Swipe is single touch gesture */
+        return (gui_wc_t)0;
+    }
+    g->dx = touch->ts.x[0] - g->start_x;            /* Release sample keeps last position */
+    g->dy = touch->ts.y[0] - g->start_y;
+    swipe_velocity(touch, g, &vx, &vy);
+    if (GUI_ABS(g->dx) >= GUI_ABS(g->dy)) {         /* Horizontal swipe */
+        if (GUI_ABS(g->dx) < GUI_CFG_TOUCH_SWIPE_DISTANCE || GUI_ABS(vx) < GUI_CFG_TOUCH_SWIPE_VELOCITY) {
+            return (gui_wc_t)0;
+        }
+        g->dir = g->dx < 0 ? GUI_TOUCH_SWIPE_LEFT : GUI_TOUCH_SWIPE_RIGHT;
+        g->velocity = GUI_ABS(vx);
+    } else {                                        /* Vertical swipe */
+        if (GUI_ABS(g->dy) < GUI_CFG_TOUCH_SWIPE_DISTANCE || GUI_ABS(vy) < GUI_CFG_TOUCH_SWIPE_VELOCITY) {
+            return (gui_wc_t)0;
+        }
+        g->dir = g->dy < 0 ? GUI_TOUCH_SWIPE_UP : GUI_TOUCH_SWIPE_DOWN;
+        g->velocity = GUI_ABS(vy);
+    }
+    g->x = g->start_x;
+    g->y = g->start_y;
+    return GUI_WC_Swipe;
+}
+
+#if GUI_CFG_TOUCH_MAX_PRESSES > 1 || __DOXYGEN__
+
+/**
+ * \brief           Check for pinch on touch move with 2 touches
+ * \param[in,out]   touch: Current touch data
+ * \return          \ref GUI_WC_Pinch if distance changed enough, `0` otherwise
+ */
+static gui_wc_t
+pinch_check(guii_touch_data_t* touch) {
+    guii_touch_gesture_t* g = &touch->gesture;
+    float distance, cx, cy;
+    
+    gui_math_distancebetweenxy(touch->ts.x[0], touch->ts.y[0], touch->ts.x[1], touch->ts.y[1], &distance);
+    if (!g->pinching) {                             /* Wait for enough change before start */
+        if (GUI_ABS(distance - g->distance) < GUI_CFG_TOUCH_PINCH_DISTANCE) {
+            return (gui_wc_t)0;
+        }
+        g->pinching = 1;
+    } else if (distance == g->distance) {
+        return (gui_wc_t)0;
+    }
+    if (g->distance <= 0) {                         /* Touches were at the same position */
+        g->distance = distance;
+        return (gui_wc_t)0;
+    }
+    g->scale = distance / g->distance;
+    g->distance = distance;
+    gui_math_centerofxy(touch->ts.x[0], touch->ts.y[0], touch->ts.x[1], touch->ts.y[1], &cx, &cy);
+    g->x = (gui_dim_t)cx;
+    g->y = (gui_dim_t)cy;
+    return GUI_WC_Pinch;
+}
+
+#endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 || __DOXYGEN__ */
+
+/**
+ * \brief           Process new touch sample and recognize gestures
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   touch: Current touch data
+ * \param[in]       old: Touch data of previous sample
+ * \return          \ref GUI_WC_Swipe or \ref GUI_WC_Pinch when gesture is recognized, `0` otherwise
+ */
+gui_wc_t
+guii_gesture_process(guii_touch_data_t* touch, const guii_touch_data_t* old) {
+    guii_touch_gesture_t* g = &touch->gesture;
+    
+    if (touch->ts.status && !old->ts.status) {      /* New press, reset state */
+        memset(g, 0x00, sizeof(*g));
+        g->start_x = touch->ts.x[0];
+        g->start_y = touch->ts.y[0];
+        g->start_time = touch->ts.time;
+    }
+    if (!touch->ts.status) {
+        return old->ts.status ? swipe_check(touch) : (gui_wc_t)0;
+    }
+#if GUI_CFG_TOUCH_MAX_PRESSES > 1
+    if (touch->ts.count == 2) {
+        if (!g->multi || old->ts.count != 2) {      /* Second touch just pressed */
+            g->multi = 1;
+            g->pinching = 0;
+            gui_math_distancebetweenxy(touch->ts.x[0], touch->ts.y[0], touch->ts.x[1], touch->ts.y[1], &g->distance);
+            return (gui_wc_t)0;
+        }
+        return pinch_check(touch);
+    }
+#endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 */
+    if (touch->ts.count > 1) {
+        g->multi = 1;
+    }
+    return (gui_wc_t)0;
+}
+
+#endif /* (GUI_CFG_USE_TOUCH && GUI_CFG_USE_TOUCH_GESTURES) || __DOXYGEN__ */
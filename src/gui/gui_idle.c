@@ -0,0 +1,205 @@
+/**	
+ * \file            gui_idle.c
+ * \brief           Background tasks run by GUI thread in idle time
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_idle.h"
+#include "system/gui_sys.h"
+
+#if GUI_CFG_USE_IDLE_TASKS || __DOXYGEN__
+
+static gui_idle_task_t* idle_tasks;         /* Queue of tasks, sorted by priority */
+static gui_idle_task_t* idle_next;          /* Task to run after current one, updated when it is removed */
+
+/**
+ * \brief           Check if GUI has more important work than idle tasks
+ * \return          `1` when input, timer or redraw is waiting, `0` otherwise
+ */
+static uint8_t
+idle_interrupted(void) {
+    uint32_t time;
+    
+    if (GUI.flags & GUI_FLAG_REDRAW) {              /* Task or user invalidated widget */
+        return 1;
+    }
+#if GUI_CFG_USE_TOUCH
+    if (gui_input_touchavailable()) {
+        return 1;
+    }
+#endif /* GUI_CFG_USE_TOUCH */
+#if GUI_CFG_USE_KEYBOARD
+    if (gui_input_keyavailable()) {
+        return 1;
+    }
+#endif /* GUI_CFG_USE_KEYBOARD */
+    if (guii_timer_getnext(&time) && !time) {       /* Timer callbacks may invalidate widgets */
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Add task to idle queue
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       t: Task structure
+ * \param[in]       fn: Callback function
+ * \param[in]       arg: User argument for callback
+ * \param[in]       priority: Task priority, tasks with higher value run first
+ * \param[in]       budget: Maximal time of single call, in units of microseconds
+ * \return          `1` on success, `0` when task is already in queue
+ */
+uint8_t
+guii_idle_add(gui_idle_task_t* t, gui_idle_fn fn, void* arg, uint8_t priority, uint32_t budget) {
+    gui_idle_task_t** p;
+    
+    if (t->queued) {
+        return 0;
+    }
+    t->fn = fn;
+    t->arg = arg;
+    t->priority = priority;
+    t->budget = budget;
+    for (p = &idle_tasks; *p != NULL && (*p)->priority >= priority; p = &(*p)->next) {}
+    t->next = *p;                                   /* Insert after tasks of same priority */
+    *p = t;
+    t->queued = 1;
+    return 1;
+}
+
+/**
+ * \brief           Remove task from idle queue
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       t: Task structure
+ * \return          `1` on success, `0` when task is not in queue
+ */
+uint8_t
+guii_idle_remove(gui_idle_task_t* t) {
+    gui_idle_task_t** p;
+    
+    for (p = &idle_tasks; *p != NULL; p = &(*p)->next) {
+        if (*p == t) {
+            if (idle_next == t) {                   /* Task removed from callback of another task */
+                idle_next = t->next;
+            }
+            *p = t->next;
+            t->next = NULL;
+            t->queued = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Check if idle tasks wait to be run
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \return          `1` when queue is not empty, `0` otherwise
+ */
+uint8_t
+guii_idle_pending(void) {
+    return idle_tasks != NULL;
+}
+
+/**
+ * \brief           Run idle tasks for at most \ref GUI_CFG_IDLE_SLICE
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Call it only when there is nothing to redraw
+ * \return          `1` when tasks are still in queue, `0` otherwise
+ */
+uint8_t
+guii_idle_process(void) {
+    gui_idle_task_t* t;
+    uint32_t start, used;
+    
+    start = GUI_CFG_IDLE_TIME();
+    for (t = idle_tasks; t != NULL; t = idle_next) {
+        idle_next = t->next;
+        if (idle_interrupted()) {
+            break;
+        }
+        used = GUI_CFG_IDLE_TIME() - start;
+        if (used >= GUI_CFG_IDLE_SLICE) {
+            break;
+        }
+        if (!t->fn(GUI_MIN(t->budget, GUI_CFG_IDLE_SLICE - used), t->arg) && t->queued) {
+            guii_idle_remove(t);                    /* Task is done */
+        }
+    }
+    idle_next = NULL;
+    return idle_tasks != NULL;
+}
+
+/**
+ * \brief           Add task to queue of background work done by GUI thread in idle time
+ * \note            Structure is owned by user and must stay valid until task returns `0` or is removed
+ * \param[in]       t: Task structure
+ * \param[in]       fn: Callback function, called repeatedly until it returns `0`
+ * \param[in]       arg: User argument for callback
+ * \param[in]       priority: Task priority, tasks with higher value run first.
+ *                      Tasks with the same priority run in order they were added
+ * \param[in]       budget: Maximal time of single call, in units of microseconds
+ * \return          `1` on success, `0` when task is already in queue
+ * \sa              gui_idle_remove
+ */
+uint8_t
+gui_idle_add(gui_idle_task_t* t, gui_idle_fn fn, void* arg, uint8_t priority, uint32_t budget) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(t != NULL && fn != NULL && budget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    ret = guii_idle_add(t, fn, arg, priority, budget);
+    __GUI_LEAVE();                                  /* Leave GUI */
+#if GUI_CFG_OS
+    if (ret) {
+        __GUI_WAKEUP(0x00);                         /* Run task if GUI thread waits for events */
+    }
+#endif /* GUI_CFG_OS */
+    return ret;
+}
+
+/**
+ * \brief           Remove task from idle queue before it is done
+ * \note            Task callback is not called anymore after function returns
+ * \param[in]       t: Task structure
+ * \return          `1` on success, `0` when task is not in queue
+ * \sa              gui_idle_add
+ */
+uint8_t
+gui_idle_remove(gui_idle_task_t* t) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(t != NULL);                  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    ret = guii_idle_remove(t);
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+#endif /* GUI_CFG_USE_IDLE_TASKS || __DOXYGEN__ */
@@ -33,37 +33,612 @@
 #include "gui/gui_input.h"
 #include "system/gui_sys.h"
 
+/**
+ * \brief           Indexes of single-producer single-consumer input ring
+ *
+ *                  Producer (touch or keyboard driver, possibly from interrupt) only writes `in` and `overflow`,
+ *                  consumer (GUI processing) only writes `out`, so no locking is required
+ */
+typedef struct {
+    volatile uint32_t in;                   /*!< Index of next entry to write */
+    volatile uint32_t out;                  /*!< Index of next entry to read */
+    volatile uint32_t overflow;             /*!< Number of entries dropped because ring was full */
+#if GUI_CFG_OS || __DOXYGEN__
+    volatile uint8_t notified;              /*!< Set to `1` when consumer was woken up and did not empty ring yet */
+#endif /* GUI_CFG_OS || __DOXYGEN__ */
+} input_ring_t;
+
+#if GUI_CFG_USE_TOUCH || GUI_CFG_USE_KEYBOARD
+#if GUI_CFG_USE_TOUCH
+static input_ring_t ts_ring;
+static gui_touch_data_t ts_data[GUI_CFG_TOUCH_BUFFER_SIZE + 1];
+#endif /* GUI_CFG_USE_TOUCH */
+#if GUI_CFG_USE_KEYBOARD
+static input_ring_t kb_ring;
+static gui_keyboard_data_t kb_data[GUI_CFG_KEYBOARD_BUFFER_SIZE + 1];
+#endif /* GUI_CFG_USE_KEYBOARD */
+
+/**
+ * \brief           Get index following current one in ring
+ * \param[in]       i: Current index
+ * \param[in]       size: Number of entries in ring memory
+ * \return          Next index
+ */
+static uint32_t
+ring_next(uint32_t i, uint32_t size) {
+    return ++i >= size ? 0 : i;
+}
+
+/**
+ * \brief           Get index of free entry to write to
+ * \note            When ring is full, overflow counter is increased
+ * \param[in,out]   r: Ring indexes
+ * \param[in]       size: Number of entries in ring memory
+ * \param[out]      idx: Output index of free entry
+ * \return          `1` on success, `0` when ring is full
+ */
+static uint8_t
+ring_write_get(input_ring_t* r, uint32_t size, uint32_t* idx) {
+    *idx = r->in;
+    if (ring_next(*idx, size) == r->out) {          /* No free entry */
+        r->overflow++;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Publish written entry to consumer
+ * \param[in,out]   r: Ring indexes
+ * \param[in]       size: Number of entries in ring memory
+ * \return          `1` when GUI thread has to be woken up, `0` otherwise
+ */
+static uint8_t
+ring_write_commit(input_ring_t* r, uint32_t size) {
+    GUI_CFG_MEMORY_BARRIER();                       /* Entry data must be visible before index */
+    r->in = ring_next(r->in, size);
+#if GUI_CFG_OS
+    /*
+     * Wake up GUI thread only once for all entries
+     * written until it empties ring again
+     */
+    GUI_CFG_MEMORY_BARRIER();
+    if (!r->notified) {
+        r->notified = 1;
+        return 1;
+    }
+#endif /* GUI_CFG_OS */
+    return 0;
+}
+
+/**
+ * \brief           Get index of oldest entry to read
+ * \param[in,out]   r: Ring indexes
+ * \param[out]      idx: Output index of entry
+ * \return          `1` on success, `0` when ring is empty
+ */
+static uint8_t
+ring_read_get(input_ring_t* r, uint32_t* idx) {
+    *idx = r->out;
+    if (*idx == r->in) {                            /* Ring is empty */
+#if GUI_CFG_OS
+        r->notified = 0;                            /* Next write must wake up thread again */
+        GUI_CFG_MEMORY_BARRIER();
+        if (*idx == r->in) {                        /* Check again for entry written meanwhile */
+            return 0;
+        }
+#else
+        return 0;
+#endif /* GUI_CFG_OS */
+    }
+    GUI_CFG_MEMORY_BARRIER();                       /* Read entry data only after index */
+    return 1;
+}
+
+/**
+ * \brief           Release entry after it has been read
+ * \param[in,out]   r: Ring indexes
+ * \param[in]       size: Number of entries in ring memory
+ */
+static void
+ring_read_commit(input_ring_t* r, uint32_t size) {
+    GUI_CFG_MEMORY_BARRIER();                       /* Entry must be read before producer can reuse it */
+    r->out = ring_next(r->out, size);
+}
+
+#endif /* GUI_CFG_USE_TOUCH || GUI_CFG_USE_KEYBOARD */
+
 #if GUI_CFG_USE_TOUCH
-static GUI_BUFFER_t TSBuffer;
-static uint8_t TSBufferData[GUI_CFG_TOUCH_BUFFER_SIZE * sizeof(gui_touch_data_t) + 1];
+static uint8_t touch_add(gui_touch_data_t* ts);
 #endif /* GUI_CFG_USE_TOUCH */
 #if GUI_CFG_USE_KEYBOARD
-static GUI_BUFFER_t KBBuffer;
-static uint8_t KBBufferData[GUI_CFG_KEYBOARD_BUFFER_SIZE * sizeof(gui_keyboard_data_t) + 1];
+static uint8_t key_add(gui_keyboard_data_t* kb);
 #endif /* GUI_CFG_USE_KEYBOARD */
 
+#if GUI_CFG_INPUT_RECORD || __DOXYGEN__
+
+/**
+ * \brief           Input recorder state
+ */
+typedef struct {
+    gui_input_record_t* buff;               /*!< Recording buffer, `NULL` when recording is not active */
+    volatile size_t count;                  /*!< Number of recorded entries */
+    size_t len;                             /*!< Length of buffer in units of entries */
+    uint32_t start;                         /*!< Time when recording started */
+    volatile uint32_t overflow;             /*!< Number of entries not recorded because buffer was full */
+} input_record_t;
+
+/**
+ * \brief           Input replay state
+ */
+typedef struct {
+    const gui_input_record_t* buff;         /*!< Entries to replay, `NULL` when replay is not active */
+    size_t len;                             /*!< Number of entries to replay */
+    size_t index;                           /*!< Index of next entry to replay */
+    uint32_t start;                         /*!< Time matching time `0` of recording */
+    gui_timer_t* timer;                     /*!< Timer armed for next entry */
+#if GUI_CFG_USE_STATS || __DOXYGEN__
+    gui_stats_t stats;                      /*!< Statistics of frames redrawn during replay */
+    uint8_t collect;                        /*!< Set to `1` when frame statistics are collected */
+#endif /* GUI_CFG_USE_STATS || __DOXYGEN__ */
+} input_replay_t;
+
+static input_record_t rec;
+static input_replay_t replay;
+
+/**
+ * \brief           Get next free entry in recording buffer
+ * \note            Touch and keyboard entries must be added from the same context,
+ *                  or recording must not be active while both are added
+ * \param[in]       time: Time of input entry
+ * \param[in]       type: Type of input entry
+ * \return          Entry with recorded time and type to fill data to, `NULL` when not recording
+ */
+static gui_input_record_t *
+record_get(uint32_t time, gui_input_record_type_t type) {
+    gui_input_record_t* r;
+    
+    if (rec.buff == NULL) {
+        return NULL;
+    }
+    if (rec.count >= rec.len) {
+        rec.overflow++;
+        return NULL;
+    }
+    r = &rec.buff[rec.count++];
+    r->time = time - rec.start;
+    r->type = type;
+    return r;
+}
+
+/**
+ * \brief           Start recording of input entries
+ *
+ *                  Every touch and keyboard entry added after this call is recorded
+ *                  with time relative to start of recording, before touch filtering and rotation is applied
+ *
+ * \note            Buffer is filled linearly and entries are dropped when it is full.
+ *                  When recording is finished, buffer can be stored to flash and replayed later
+ * \param[in]       buff: Buffer for recorded entries
+ * \param[in]       len: Length of buffer in units of entries
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_input_recordstop
+ */
+uint8_t
+gui_input_recordstart(gui_input_record_t* buff, size_t len) {
+    __GUI_ASSERTPARAMS(buff != NULL && len > 0);    /* Check input parameters */
+    rec.buff = NULL;                                /* Stop current recording first */
+    GUI_CFG_MEMORY_BARRIER();
+    rec.count = 0;
+    rec.overflow = 0;
+    rec.len = len;
+    rec.start = gui_sys_now();
+    GUI_CFG_MEMORY_BARRIER();
+    rec.buff = buff;                                /* Start recording */
+    return 1;
+}
+
+/**
+ * \brief           Stop recording of input entries
+ * \param[out]      overflow: Pointer to output number of entries not recorded because buffer was full.
+ *                      Set to `NULL` if not used
+ * \return          Number of entries recorded to buffer
+ * \sa              gui_input_recordstart
+ */
+size_t
+gui_input_recordstop(uint32_t* overflow) {
+    rec.buff = NULL;
+    GUI_CFG_MEMORY_BARRIER();
+    if (overflow != NULL) {
+        *overflow = rec.overflow;
+    }
+    return rec.count;
+}
+
+/**
+ * \brief           Feed all recorded entries which are due and arm timer for next one
+ * \param[in]       t: Replay timer
+ */
+static void
+replay_timer_callback(gui_timer_t* t) {
+    const gui_input_record_t* r;
+    uint32_t elapsed;
+    
+    if (replay.buff == NULL) {
+        return;
+    }
+    elapsed = gui_sys_now() - replay.start;
+    for (; replay.index < replay.len; replay.index++) {
+        r = &replay.buff[replay.index];
+        if (r->time > elapsed) {                    /* Entry is not due yet */
+            t->period = (uint16_t)GUI_MIN(r->time - elapsed, 0xFFFF);
+            guii_timer_start(t);
+            return;
+        }
+        switch (r->type) {
+#if GUI_CFG_USE_TOUCH
+            case GUI_INPUT_RECORD_TOUCH: {
+                gui_touch_data_t ts = r->data.ts;
+                ts.time = replay.start + r->time;   /* Original timing, even when GUI was late */
+                touch_add(&ts);
+                break;
+            }
+#endif /* GUI_CFG_USE_TOUCH */
+#if GUI_CFG_USE_KEYBOARD
+            case GUI_INPUT_RECORD_KEY: {
+                gui_keyboard_data_t kb = r->data.kb;
+                kb.time = replay.start + r->time;
+                key_add(&kb);
+                break;
+            }
+#endif /* GUI_CFG_USE_KEYBOARD */
+            default:
+                break;
+        }
+    }
+    replay.buff = NULL;                             /* All entries were fed */
+}
+
+/**
+ * \brief           Start replay of recorded input entries
+ *
+ *                  Entries are fed to input buffers at the same time offsets as they were recorded,
+ *                  first entry is fed immediately. Entries added by touch and keyboard drivers
+ *                  meanwhile are processed too, so drivers should be stopped during replay
+ *
+ * \note            Buffer must stay valid until replay is finished
+ * \note            When \ref GUI_CFG_USE_STATS is enabled, statistics of frames redrawn
+ *                  are collected until \ref gui_input_replaystop is called
+ *                  and can be read with \ref gui_input_replaygetstats
+ * \param[in]       buff: Recorded entries, for example from \ref gui_input_recordstart
+ * \param[in]       len: Number of entries in buffer
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_input_replaystart(const gui_input_record_t* buff, size_t len) {
+    uint8_t ret = 0;
+    
+    __GUI_ASSERTPARAMS(buff != NULL && len > 0);    /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (replay.timer == NULL) {
+        replay.timer = guii_timer_create(0, replay_timer_callback, NULL);
+    }
+    if (replay.timer != NULL) {
+        replay.buff = buff;
+        replay.len = len;
+        replay.index = 0;
+        replay.start = gui_sys_now() - buff[0].time;
+#if GUI_CFG_USE_STATS
+        memset(&replay.stats, 0x00, sizeof(replay.stats));
+        replay.stats.mem_min_free = (size_t)-1;
+        replay.collect = 1;
+#endif /* GUI_CFG_USE_STATS */
+        replay_timer_callback(replay.timer);        /* Feed first entries and arm timer */
+        ret = 1;
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Stop replay of recorded input entries
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_input_replaystop(void) {
+    __GUI_ENTER();                                  /* Enter GUI */
+    replay.buff = NULL;
+#if GUI_CFG_USE_STATS
+    replay.collect = 0;                             /* Freeze collected statistics */
+#endif /* GUI_CFG_USE_STATS */
+    if (replay.timer != NULL) {
+        guii_timer_stop(replay.timer);
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Check if replay of recorded input entries is in progress
+ * \return          `1` when replay is active, `0` otherwise
+ */
+uint8_t
+gui_input_replayisactive(void) {
+    return replay.buff != NULL;
+}
+
+#if GUI_CFG_USE_STATS || __DOXYGEN__
+
+/**
+ * \brief           Add statistics of redrawn frame to replay statistics
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       frame: Statistics of frame, with only values of single frame
+ */
+void
+guii_input_replayframe(const gui_stats_t* frame) {
+    if (!replay.collect) {
+        return;
+    }
+    replay.stats.frames++;
+    replay.stats.time_timers += frame->time_timers;
+    replay.stats.time_touch += frame->time_touch;
+    replay.stats.time_keyboard += frame->time_keyboard;
+    replay.stats.time_redraw += frame->time_redraw;
+    replay.stats.time_redraw_max = GUI_MAX(replay.stats.time_redraw_max, frame->time_redraw);
+    replay.stats.time_wait += frame->time_wait;
+    replay.stats.widgets_redrawn += frame->widgets_redrawn;
+    replay.stats.dirty_area += frame->dirty_area;
+    replay.stats.mem_min_free = GUI_MIN(replay.stats.mem_min_free, frame->mem_min_free);
+}
+
+/**
+ * \brief           Get statistics of frames redrawn during last replay
+ *
+ *                  Time values and counters are sums over all frames redrawn
+ *                  since \ref gui_input_replaystart was called.
+ *                  Call \ref gui_input_replaystop when \ref gui_input_replayisactive returns `0`
+ *                  and all replayed input was processed, to stop collecting
+ *
+ * \param[out]      stats: Pointer to output statistics
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_input_replaygetstats(gui_stats_t* stats) {
+    __GUI_ASSERTPARAMS(stats != NULL);              /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    memcpy(stats, &replay.stats, sizeof(*stats));
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+#endif /* GUI_CFG_USE_STATS || __DOXYGEN__ */
+
+#endif /* GUI_CFG_INPUT_RECORD || __DOXYGEN__ */
+
 #if GUI_CFG_USE_TOUCH || __DOXYGEN__
 
+#if GUI_CFG_TOUCH_FILTER || __DOXYGEN__
+
+/**
+ * \brief           Filter state of one touch point
+ */
+typedef struct {
+#if GUI_CFG_TOUCH_FILTER_MEDIAN || __DOXYGEN__
+    int32_t hx[3];                          /*!< Last 3 calibrated X samples */
+    int32_t hy[3];                          /*!< Last 3 calibrated Y samples */
+#endif /* GUI_CFG_TOUCH_FILTER_MEDIAN || __DOXYGEN__ */
+    int32_t fx;                             /*!< IIR filter X output in units of 1/256 pixel */
+    int32_t fy;                             /*!< IIR filter Y output in units of 1/256 pixel */
+} touch_filter_t;
+
+static gui_touch_calibration_t ts_cal = { 65536, 0, 0, 0, 65536, 0 };   /* Raw coordinates are screen coordinates */
+static touch_filter_t ts_filter[GUI_CFG_TOUCH_MAX_PRESSES];
+static gui_touch_data_t ts_last;            /* Last sample written to buffer, before rotation */
+
+#if GUI_CFG_TOUCH_FILTER_MEDIAN || __DOXYGEN__
+/**
+ * \brief           Get median of 3 values
+ * \param[in]       v: Array of 3 values
+ * \return          Median value
+ */
+static int32_t
+median3(const int32_t* v) {
+    if (v[0] > v[1]) {
+        return v[1] > v[2] ? v[1] : (v[0] > v[2] ? v[2] : v[0]);
+    }
+    return v[0] > v[2] ? v[0] : (v[1] > v[2] ? v[2] : v[1]);
+}
+#endif /* GUI_CFG_TOUCH_FILTER_MEDIAN || __DOXYGEN__ */
+
+/**
+ * \brief           Calibrate and filter touch sample
+ * \note            Called from producer context only, filter state is not shared with GUI thread
+ * \param[in]       ts: Touch sample with raw coordinates
+ * \param[out]      out: Copy of sample with filtered screen coordinates
+ * \return          `1` when sample must be written to buffer, `0` when it does not change reported state
+ */
+static uint8_t
+touch_condition(const gui_touch_data_t* ts, gui_touch_data_t* out) {
+    touch_filter_t* f;
+    int32_t x, y;
+    uint8_t i, start, moved = 0;
+    
+    /* Press, release and change of touch count are never dropped and restart filters */
+    start = ts->status != ts_last.status || ts->count != ts_last.count;
+    *out = *ts;
+    for (i = 0; i < ts->count; i++) {
+        f = &ts_filter[i];
+        x = (int32_t)(((int64_t)ts_cal.xa * ts->x[i] + (int64_t)ts_cal.xb * ts->y[i] + ts_cal.xc + 0x8000) >> 16);
+        y = (int32_t)(((int64_t)ts_cal.ya * ts->x[i] + (int64_t)ts_cal.yb * ts->y[i] + ts_cal.yc + 0x8000) >> 16);
+#if GUI_CFG_TOUCH_FILTER_MEDIAN
+        if (start) {
+            f->hx[0] = f->hx[1] = x;
+            f->hy[0] = f->hy[1] = y;
+        } else {
+            f->hx[0] = f->hx[1];
+            f->hx[1] = f->hx[2];
+            f->hy[0] = f->hy[1];
+            f->hy[1] = f->hy[2];
+        }
+        f->hx[2] = x;
+        f->hy[2] = y;
+        x = median3(f->hx);
+        y = median3(f->hy);
+#endif /* GUI_CFG_TOUCH_FILTER_MEDIAN */
+        if (start) {
+            f->fx = x * 256;
+            f->fy = y * 256;
+        } else {
+            f->fx += (x * 256 - f->fx) / (1 << GUI_CFG_TOUCH_FILTER_IIR_SHIFT);
+            f->fy += (y * 256 - f->fy) / (1 << GUI_CFG_TOUCH_FILTER_IIR_SHIFT);
+        }
+        x = (f->fx + 128) >> 8;
+        y = (f->fy + 128) >> 8;
+        
+        out->x[i] = (gui_dim_t)x;
+        out->y[i] = (gui_dim_t)y;
+        if (GUI_ABS(x - ts_last.x[i]) >= GUI_CFG_TOUCH_DEADZONE || GUI_ABS(y - ts_last.y[i]) >= GUI_CFG_TOUCH_DEADZONE) {
+            moved = 1;
+        }
+    }
+    return start || moved;
+}
+
+/**
+ * \brief           Set calibration for raw touch controller coordinates
+ * \note            Set it before touch controller starts adding samples, or accept
+ *                  that one sample may be calibrated with mixed coefficients
+ * \param[in]       cal: Calibration to use or `NULL` to use raw coordinates as screen coordinates
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_input_touchcalibrate
+ */
+uint8_t
+gui_input_touchsetcalibration(const gui_touch_calibration_t* cal) {
+    static const gui_touch_calibration_t identity = { 65536, 0, 0, 0, 65536, 0 };
+    
+    ts_cal = cal != NULL ? *cal : identity;
+    return 1;
+}
+
+/**
+ * \brief           Calculate calibration from 3 touched points
+ *
+ *                  Points should be far from each other and not on one line,
+ *                  for example near 3 corners of screen
+ *
+ * \note            Screen coordinates are panel coordinates, before \ref GUI_CFG_LCD_ROTATION is applied
+ * \param[in]       raw: Raw controller coordinates of 3 points as `x0, y0, x1, y1, x2, y2`
+ * \param[in]       screen: Screen coordinates of the same points in the same order
+ * \param[out]      cal: Output calibration for \ref gui_input_touchsetcalibration
+ * \return          `1` on success, `0` when points are on one line
+ */
+uint8_t
+gui_input_touchcalibrate(const gui_dim_t* raw, const gui_dim_t* screen, gui_touch_calibration_t* cal) {
+    int64_t dx0, dy0, dx1, dy1, det;
+    int64_t sx0, sx1, sy0, sy1;
+    
+    __GUI_ASSERTPARAMS(raw != NULL && screen != NULL && cal != NULL);   /* Check input parameters */
+    dx0 = raw[0] - raw[4];                          /* Points relative to third point */
+    dy0 = raw[1] - raw[5];
+    dx1 = raw[2] - raw[4];
+    dy1 = raw[3] - raw[5];
+    det = dx0 * dy1 - dx1 * dy0;
+    if (det == 0) {
+        return 0;
+    }
+    sx0 = screen[0] - screen[4];
+    sy0 = screen[1] - screen[5];
+    sx1 = screen[2] - screen[4];
+    sy1 = screen[3] - screen[5];
+    
+    cal->xa = (int32_t)(((sx0 * dy1 - sx1 * dy0) * 65536) / det);
+    cal->xb = (int32_t)(((dx0 * sx1 - dx1 * sx0) * 65536) / det);
+    cal->xc = (int32_t)((int64_t)screen[4] * 65536 - (int64_t)cal->xa * raw[4] - (int64_t)cal->xb * raw[5]);
+    cal->ya = (int32_t)(((sy0 * dy1 - sy1 * dy0) * 65536) / det);
+    cal->yb = (int32_t)(((dx0 * sy1 - dx1 * sy0) * 65536) / det);
+    cal->yc = (int32_t)((int64_t)screen[5] * 65536 - (int64_t)cal->ya * raw[4] - (int64_t)cal->yb * raw[5]);
+    return 1;
+}
+
+#endif /* GUI_CFG_TOUCH_FILTER || __DOXYGEN__ */
+
 /**
  * \brief           Add new touch data to internal buffer for further processing
+ * \note            Function may be called from touch controller interrupt.
+ *                  When \ref GUI_CFG_OS is enabled, \ref gui_sys_mbox_putnow must be interrupt safe too
+ * \note            With \ref GUI_CFG_TOUCH_FILTER, samples can be added on every controller poll.
+ *                  Calibrated and filtered copy of sample is written to buffer,
+ *                  samples which do not change press state or move out of dead zone are not written
  * \param[in]       ts: Pointer to \ref gui_touch_data_t touch data with valid input
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_input_touchadd(gui_touch_data_t* ts) {
-    uint8_t ret;
+#if GUI_CFG_INPUT_RECORD
+    gui_input_record_t* r;
+#endif /* GUI_CFG_INPUT_RECORD */
+    
     __GUI_ASSERTPARAMS(ts);                         /* Check input parameters */
     ts->time = gui_sys_now();                       /* Set event time */
-    ret = gui_buffer_write(&TSBuffer, ts, sizeof(*ts)) ? 1 : 0; /* Write data to buffer */
+#if GUI_CFG_INPUT_RECORD
+    if ((r = record_get(ts->time, GUI_INPUT_RECORD_TOUCH)) != NULL) {
+        r->data.ts = *ts;        /* Record raw sample */
+    }
+#endif /* GUI_CFG_INPUT_RECORD */
+    return touch_add(ts);
+}
+
+/**
+ * \brief           Write touch data with valid time to internal buffer
+ * \param[in]       ts: Pointer to \ref gui_touch_data_t touch data with valid input and time
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+touch_add(gui_touch_data_t* ts) {
+    uint32_t idx;
+#if GUI_CFG_LCD_ROTATION
+    uint8_t i;
+#endif /* GUI_CFG_LCD_ROTATION */
+#if GUI_CFG_TOUCH_FILTER
+    gui_touch_data_t filtered;
+#endif /* GUI_CFG_TOUCH_FILTER */
     
+#if GUI_CFG_TOUCH_FILTER
+    if (!touch_condition(ts, &filtered)) {
+        return 1;                                   /* Noise only, reported state is still valid */
+    }
+    ts = &filtered;
+#endif /* GUI_CFG_TOUCH_FILTER */
+    if (!ring_write_get(&ts_ring, GUI_COUNT_OF(ts_data), &idx)) {
+        return 0;                                   /* Sample dropped */
+    }
+    ts_data[idx] = *ts;
+#if GUI_CFG_TOUCH_FILTER
+    ts_last = *ts;                                  /* Dead zone is measured from written sample */
+#endif /* GUI_CFG_TOUCH_FILTER */
+#if GUI_CFG_LCD_ROTATION
+    for (i = 0; i < ts_data[idx].count; i++) {  /* Touch controller reports physical panel coordinates */
+        guii_lcd_touchtological(&ts_data[idx].x[i], &ts_data[idx].y[i]);
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    if (ring_write_commit(&ts_ring, GUI_COUNT_OF(ts_data))) {
 #if GUI_CFG_OS
-    /*
-     * Notify OS to wakeup thread
-     */
-    static gui_mbox_msg_t gui_touch_value = {GUI_SYS_MBOX_TYPE_TOUCH};  /* Enter some value, don't care about */
-    gui_sys_mbox_putnow(&GUI.OS.mbox, &gui_touch_value);    /* Notify stack about new key added */
+        static gui_mbox_msg_t gui_touch_value = {GUI_SYS_MBOX_TYPE_TOUCH};  /* Enter some value, don't care about */
+        __GUI_WAKEUP(&gui_touch_value);             /* Notify stack about new entries */
 #endif /* GUI_CFG_OS */
-    return ret;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Get number of touch entries dropped because buffer was full
+ * \return          Number of dropped entries since initialization
+ */
+uint32_t
+gui_input_touchoverflow(void) {
+    return ts_ring.overflow;
 }
 
 /**
@@ -73,19 +648,106 @@ gui_input_touchadd(gui_touch_data_t* ts) {
  */
 uint8_t
 gui_input_touchread(gui_touch_data_t* ts) {
-    if (gui_buffer_getfull(&TSBuffer) >= sizeof(*ts)) {
-        return (uint8_t)gui_buffer_read(&TSBuffer, ts, sizeof(*ts)); /* Read data fro mbuffer */
+    uint32_t idx;
+    
+    if (!ring_read_get(&ts_ring, &idx)) {
+        return 0;
     }
-    return 0;
+    *ts = ts_data[idx];
+    ring_read_commit(&ts_ring, GUI_COUNT_OF(ts_data));
+    return 1;
 }
 
+/**
+ * \brief           Read next touch entry without removing it from buffer
+ * \param[out]      ts: Pointer to \ref gui_touch_data_t structure to save touch into to
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_input_touchpeek(gui_touch_data_t* ts) {
+    uint32_t idx;
+    
+    if (!ring_read_get(&ts_ring, &idx)) {
+        return 0;
+    }
+    *ts = ts_data[idx];                             /* Copy data without releasing entry */
+    return 1;
+}
+
+#if GUI_CFG_TOUCH_HISTORY_SIZE || __DOXYGEN__
+
+/**
+ * \brief           Add position of first touch to touch history
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   touch: Touch data to add position to
+ * \param[in]       ts: Touch sample with position to add
+ */
+void
+guii_input_touchhistoryadd(guii_touch_data_t* touch, const gui_touch_data_t* ts) {
+    guii_touch_sample_t* s = &touch->history[touch->history_index];
+    
+    s->x = ts->x[0];
+    s->y = ts->y[0];
+    s->time = ts->time;
+    if (++touch->history_index >= GUI_CFG_TOUCH_HISTORY_SIZE) {
+        touch->history_index = 0;
+    }
+    if (touch->history_count < GUI_CFG_TOUCH_HISTORY_SIZE) {
+        touch->history_count++;
+    }
+}
+
+/**
+ * \brief           Calculate velocity of first touch from touch history
+ *
+ *                  Velocity is calculated between newest position
+ *                  and oldest position not older than `100ms` from newest
+ *
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       touch: Touch data with valid history
+ * \param[out]      vx: Pointer to output X velocity in units of pixels per second
+ * \param[out]      vy: Pointer to output Y velocity in units of pixels per second
+ * \return          `1` on success, `0` if there is not enough positions in history
+ */
+uint8_t
+guii_input_touchvelocity(const guii_touch_data_t* touch, float* vx, float* vy) {
+    const guii_touch_sample_t *newest, *oldest, *s;
+    size_t i, pos;
+    uint32_t dt;
+    
+    *vx = 0;
+    *vy = 0;
+    if (touch->history_count < 2) {
+        return 0;
+    }
+    pos = touch->history_index ? touch->history_index - 1 : GUI_CFG_TOUCH_HISTORY_SIZE - 1;
+    newest = oldest = &touch->history[pos];
+    for (i = 1; i < touch->history_count; i++) {    /* Go back in time */
+        pos = pos ? pos - 1 : GUI_CFG_TOUCH_HISTORY_SIZE - 1;
+        s = &touch->history[pos];
+        if (newest->time - s->time > 100) {         /* Position is too old */
+            break;
+        }
+        oldest = s;
+    }
+    dt = newest->time - oldest->time;
+    if (dt == 0) {
+        return 0;
+    }
+    *vx = (float)(newest->x - oldest->x) * 1000.0f / (float)dt;
+    *vy = (float)(newest->y - oldest->y) * 1000.0f / (float)dt;
+    return 1;
+}
+
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE || __DOXYGEN__ */
+
 /**
  * \brief           Checks if anything available for touch inputs
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_input_touchavailable(void) {
-    return gui_buffer_getfull(&TSBuffer) > 0;       /* Check if any available touch */
+    return ts_ring.in != ts_ring.out;               /* Check if any available touch */
 }
 
 #endif /* GUI_CFG_USE_TOUCH || __DOXYGEN__ */
@@ -94,24 +756,65 @@ gui_input_touchavailable(void) {
 
 /**
  * \brief           Add new key data to internal buffer for further processing
+ * \note            Function may be called from interrupt.
+ *                  When \ref GUI_CFG_OS is enabled, \ref gui_sys_mbox_putnow must be interrupt safe too
  * \param[in]       kb: Pointer to \ref gui_keyboard_data_t key data
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_input_keyadd(gui_keyboard_data_t* kb) {
-    uint8_t ret;
+#if GUI_CFG_INPUT_RECORD
+    gui_input_record_t* r;
+#endif /* GUI_CFG_INPUT_RECORD */
+    
     __GUI_ASSERTPARAMS(kb);                         /* Check input parameters */
     kb->time = gui_sys_now();                       /* Set event time */
-    ret = gui_buffer_write(&KBBuffer, kb, sizeof(*kb)) ? 1 : 0; /* Write data to buffer */
+#if GUI_CFG_INPUT_RECORD
+    if ((r = record_get(kb->time, GUI_INPUT_RECORD_KEY)) != NULL) {
+        r->data.kb = *kb;        /* Record key */
+    }
+#endif /* GUI_CFG_INPUT_RECORD */
+    return key_add(kb);
+}
+
+/**
+ * \brief           Write key data with valid time to internal buffer
+ * \param[in]       kb: Pointer to \ref gui_keyboard_data_t key data with valid time
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+key_add(gui_keyboard_data_t* kb) {
+    uint32_t idx;
     
+    if (!ring_write_get(&kb_ring, GUI_COUNT_OF(kb_data), &idx)) {
+        return 0;                                   /* Key dropped */
+    }
+    kb_data[idx] = *kb;
+    if (ring_write_commit(&kb_ring, GUI_COUNT_OF(kb_data))) {
 #if GUI_CFG_OS
-    /*
-     * Notify OS to wakeup thread
-     */
-    static gui_mbox_msg_t gui_kbd_value = {GUI_SYS_MBOX_TYPE_KEYBOARD}; /* Enter some value, don't care about */
-    gui_sys_mbox_putnow(&GUI.OS.mbox, &gui_kbd_value);   /* Notify stack about new key added */
+        static gui_mbox_msg_t gui_kbd_value = {GUI_SYS_MBOX_TYPE_KEYBOARD}; /* Enter some value, don't care about */
+        __GUI_WAKEUP(&gui_kbd_value);               /* Notify stack about new entries */
 #endif /* GUI_CFG_OS */
-    return ret;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Get number of key entries dropped because buffer was full
+ * \return          Number of dropped entries since initialization
+ */
+uint32_t
+gui_input_keyoverflow(void) {
+    return kb_ring.overflow;
+}
+
+/**
+ * \brief           Checks if anything available for keyboard inputs
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_input_keyavailable(void) {
+    return kb_ring.in != kb_ring.out;               /* Check if any available key */
 }
 
 /**
@@ -121,10 +824,14 @@ gui_input_keyadd(gui_keyboard_data_t* kb) {
  */
 uint8_t
 gui_input_keyread(gui_keyboard_data_t* kb) {
-    if (gui_buffer_getfull(&KBBuffer) >= sizeof(*kb)) {
-        return (uint8_t)gui_buffer_read(&KBBuffer, kb, sizeof(*kb)); /* Read data fro mbuffer */
+    uint32_t idx;
+    
+    if (!ring_read_get(&kb_ring, &idx)) {
+        return 0;
     }
-    return 0;
+    *kb = kb_data[idx];
+    ring_read_commit(&kb_ring, GUI_COUNT_OF(kb_data));
+    return 1;
 }
 #endif /* GUI_CFG_USE_KEYBOARD || __DOXYGEN__ */
 
@@ -134,9 +841,12 @@ gui_input_keyread(gui_keyboard_data_t* kb) {
 void
 gui_input_init(void) {
 #if GUI_CFG_USE_TOUCH
-    gui_buffer_init(&TSBuffer, sizeof(TSBufferData), TSBufferData);
+    memset(&ts_ring, 0x00, sizeof(ts_ring));
+#if GUI_CFG_TOUCH_FILTER
+    memset(&ts_last, 0x00, sizeof(ts_last));        /* Released state */
+#endif /* GUI_CFG_TOUCH_FILTER */
 #endif /* GUI_CFG_USE_TOUCH */
 #if GUI_CFG_USE_KEYBOARD
-    gui_buffer_init(&KBBuffer, sizeof(KBBufferData), KBBufferData);
+    memset(&kb_ring, 0x00, sizeof(kb_ring));
 #endif /* GUI_CFG_USE_KEYBOARD */
 }
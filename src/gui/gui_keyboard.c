@@ -32,7 +32,6 @@
 #include "gui/gui_private.h"
 #include "gui/gui_keyboard.h"
 #include "widget/gui_container.h"
-#include "widget/gui_button.h"
 
 typedef struct {
     uint32_t c;                                     /*!< Character to print */
@@ -51,19 +50,20 @@ typedef struct {
 typedef struct {
     const key_row_t* rows;                          /*!< Pointer to rows objects */
     size_t rows_count;                              /*!< Number of rows */
-    gui_id_t id;                                    /*!< Layout ID */
 } key_layout_t;
 
 typedef struct {
     uint8_t is_shift;                               /*!< Status indicating shift mode is enabled */
     gui_handle_p handle;                            /*!< Pointer to keyboard handle */
-    gui_handle_p main_layout_handle;                /*!< Pointer to main keyboard layout */
+    size_t layout;                                  /*!< Index of currently visible layout */
+    const key_btn_t* pressed;                       /*!< Currently pressed key or `NULL` if none */
+    size_t pressed_row;                             /*!< Row of currently pressed key */
     
     const gui_font_t* font;                         /*!< Pointer to used font */
     const gui_font_t* default_font;                 /*!< Pointer to default font */
     
     uint8_t action;                                 /*!< Kbd show/hide action */
-    uint8_t action_value;                           /*!< Action custom value */
+    int32_t pos;                                    /*!< Current vertical position in units of percent */
 } key_info_t;
 
 #define SPECIAL_123                     ((uint32_t)0x01)
@@ -74,9 +74,12 @@ typedef struct {
 #define SPECIAL_ENTER                   ((uint32_t)0x06)
 #define SPECIAL_HIDE                    ((uint32_t)0x07)
 
-#define GUI_ID_KEYBOARD_LAYOUT_ABC      (GUI_ID_KEYBOARD_BASE + 0x01UL)
-#define GUI_ID_KEYBOARD_LAYOUT_123      (GUI_ID_KEYBOARD_BASE + 0x02UL)
-#define GUI_ID_KEYBOARD_LAYOUT_CALC     (GUI_ID_KEYBOARD_BASE + 0x03UL)
+#define LAYOUT_ABC                      0x00
+#define LAYOUT_123                      0x01
+#define LAYOUT_CALC                     0x02
+
+#define KEY_ROW_HEIGHT                  23.0f       /*!< Height of key row in percent of keyboard height */
+#define KEY_ROW_PITCH                   25.0f       /*!< Distance between rows in percent of keyboard height */
 
 #define SHIFT_CLEARED                   0x00
 #define SHIFT_NORMAL                    0x01
@@ -85,6 +88,10 @@ typedef struct {
 #define ACTION_HIDE                     0x01
 #define ACTION_SHOW                     0x02
 
+#define KEYBOARD_POS_SHOWN              50          /*!< Vertical position of visible keyboard in units of percent */
+#define KEYBOARD_POS_HIDDEN             100         /*!< Vertical position of hidden keyboard in units of percent */
+#define KEYBOARD_ANIM_DURATION          200         /*!< Show/hide slide duration in units of milliseconds */
+
 #define KEY_ROW(c_v, cs_v, x_v, w_v, s_v)         { .c = ((uint32_t)(c_v)), .cs = ((uint32_t)(cs_v)), .x = x_v, .w = w_v, .s = (s_v) }
 
 /***************************/
@@ -270,213 +277,268 @@ keyboard_rows_l3[] = {
 /************************/
 static const key_layout_t
 layouts[] = {
-    {.id = GUI_ID_KEYBOARD_LAYOUT_ABC, .rows = keyboard_rows_l1, .rows_count = GUI_COUNT_OF(keyboard_rows_l1)},
-    {.id = GUI_ID_KEYBOARD_LAYOUT_123, .rows = keyboard_rows_l2, .rows_count = GUI_COUNT_OF(keyboard_rows_l2)},
-    {.id = GUI_ID_KEYBOARD_LAYOUT_CALC, .rows = keyboard_rows_l3, .rows_count = GUI_COUNT_OF(keyboard_rows_l3)},
+    [LAYOUT_ABC] = {.rows = keyboard_rows_l1, .rows_count = GUI_COUNT_OF(keyboard_rows_l1)},
+    [LAYOUT_123] = {.rows = keyboard_rows_l2, .rows_count = GUI_COUNT_OF(keyboard_rows_l2)},
+    [LAYOUT_CALC] = {.rows = keyboard_rows_l3, .rows_count = GUI_COUNT_OF(keyboard_rows_l3)},
 };
 
 static key_info_t
 keyboard = {
-    .action_value = 10              /* Set action value to max */
+    .pos = KEYBOARD_POS_HIDDEN      /* Keyboard starts below visible area */
 };   
 
 #define SHIFT_DISABLE()     if (keyboard.is_shift) {        \
     keyboard.is_shift = 0;                                  \
-    guii_widget_invalidate(keyboard.main_layout_handle);   \
+    guii_widget_invalidate(keyboard.handle);                \
 }
 
 #define SHIFT_ENABLE(mode)  do {                            \
     if (!keyboard.is_shift && (mode)) {                     \
-        guii_widget_invalidate(keyboard.main_layout_handle);  \
+        guii_widget_invalidate(keyboard.handle);            \
     }                                                       \
     keyboard.is_shift = (mode);                             \
 } while (0)
 
 #define SHIFT_TOGGLE()      do {                            \
     keyboard.is_shift = !keyboard.is_shift;                 \
-    guii_widget_invalidate(keyboard.main_layout_handle);   \
+    guii_widget_invalidate(keyboard.handle);                \
 } while (0)
 
 /**
- * \brief           Keyboard button callback function
+ * \brief           Get position and size of key relative to keyboard widget
+ * \param[in]       h: Keyboard widget handle
+ * \param[in]       row: Row index of key
+ * \param[in]       btn: Key descriptor
+ * \param[out]      x: Output X position
+ * \param[out]      y: Output Y position
+ * \param[out]      w: Output width
+ * \param[out]      hi: Output height
  */
-static uint8_t
-keyboard_btn_callback(gui_handle_p h, gui_wc_t cmd, gui_widget_param_t* param, gui_widget_result_t* result) {
-    switch (cmd) {                                  /* Process commands */
-        case GUI_WC_Draw: {                         /* Draw button */
-            gui_char str[10] = {0};
-            const key_btn_t* kbtn;
-            
-            kbtn = (const key_btn_t *)guii_widget_getuserdata(h);  /* Get user data */
-            
-            switch (kbtn->s) {                      /* Check if there is specal key */
-                case SPECIAL_123: 
-                    strcpy((char *)str, (char *)_GT("123"));
-                    break;
-                case SPECIAL_ABC: 
-                    strcpy((char *)str, (char *)_GT("abc"));
-                    break;
-                case SPECIAL_CALC:
-                    strcpy((char *)str, (char *)_GT("#+="));
-                    break;
-                case SPECIAL_BACKSPACE: 
-                    strcpy((char *)str, (char *)_GT("Back"));
-                    break;
-                case SPECIAL_ENTER: 
-                    strcpy((char *)str, (char *)_GT("Ent"));
-                    break;
-                case SPECIAL_SHIFT: 
-                    strcpy((char *)str, (char *)_GT("Shift"));
-                    break;
-                case SPECIAL_HIDE: 
-                    strcpy((char *)str, (char *)_GT("Hide"));
-                    break;
-                default:
-                    if (keyboard.is_shift && kbtn->cs) {    /* Character when shift is ON */
-                        gui_string_unicode_encode(kbtn->cs, str);   /* Encode character to unicode */
-                    } else {                        /* Character when shift is OFF */
-                        gui_string_unicode_encode(kbtn->c, str);    /* Encode character to unicode */
-                    }
-                    break;
-            }
-                                                
-            if (keyboard.font != NULL) {            /* Check if widget font is set */
-                guii_widget_setfont(h, keyboard.font);  /* Set drawing font */
-            } else {
-                guii_widget_setfont(h, keyboard.default_font); /* Set drawing font */
-            }
-            
-            guii_widget_settext(h, str);       /* Temporary set text */
-            gui_widget_processdefaultcallback(h, cmd, param, result);   /* Process default callback with drawing */
-            return 1;
+static void
+key_getrect(gui_handle_p h, size_t row, const key_btn_t* btn, gui_dim_t* x, gui_dim_t* y, gui_dim_t* w, gui_dim_t* hi) {
+    gui_dim_t width = guii_widget_getwidth(h), height = guii_widget_getheight(h);
+    
+    *x = (gui_dim_t)((float)width * btn->x / 100.0f);
+    *y = (gui_dim_t)((float)height * (1.0f + KEY_ROW_PITCH * (float)row) / 100.0f);
+    *w = (gui_dim_t)((float)width * btn->w / 100.0f);
+    *hi = (gui_dim_t)((float)height * KEY_ROW_HEIGHT / 100.0f);
+}
+
+/**
+ * \brief           Find key on relative position of currently visible layout
+ * \param[in]       h: Keyboard widget handle
+ * \param[in]       x: X position relative to keyboard widget
+ * \param[in]       y: Y position relative to keyboard widget
+ * \param[out]      row: Output row index of found key
+ * \return          Key descriptor on success, `NULL` when position is between keys
+ */
+static const key_btn_t *
+key_find(gui_handle_p h, gui_dim_t x, gui_dim_t y, size_t* row) {
+    const key_layout_t* layout = &layouts[keyboard.layout];
+    const key_btn_t* btn;
+    float px, py;
+    size_t r, i;
+    
+    px = (float)x * 100.0f / (float)guii_widget_getwidth(h);
+    py = (float)y * 100.0f / (float)guii_widget_getheight(h) - 1.0f;
+    if (py < 0) {
+        return NULL;
+    }
+    r = (size_t)(py / KEY_ROW_PITCH);               /* Row is calculated directly */
+    if (r >= layout->rows_count || py - KEY_ROW_PITCH * (float)r > KEY_ROW_HEIGHT) {
+        return NULL;
+    }
+    for (i = 0; i < layout->rows[r].btns_count; i++) {
+        btn = &layout->rows[r].btns[i];
+        if (px >= btn->x && px < btn->x + btn->w) {
+            *row = r;
+            return btn;
         }
-        case GUI_WC_Click: {                    /* Handle pressed button */
-            gui_handle_p tmp1, tmp2, tmp3;
-            const key_btn_t* kbtn;
-            uint32_t ch = 0;
-            gui_keyboard_data_t kbd = {0};
-            
-            kbtn = guii_widget_getuserdata(h); /* Get data from widget */
-            if (kbtn->s) {                      /* Has button special function? */
-                switch (kbtn->s) {              /* Check special function */
-                    case SPECIAL_123:
-                    case SPECIAL_ABC: 
-                    case SPECIAL_CALC: {            /* Special functions 123 or ABC */
-                        tmp1 = guii_widget_getbyid(GUI_ID_KEYBOARD_LAYOUT_123);
-                        tmp2 = guii_widget_getbyid(GUI_ID_KEYBOARD_LAYOUT_ABC);
-                        tmp3 = guii_widget_getbyid(GUI_ID_KEYBOARD_LAYOUT_CALC);
-                        
-                        if (kbtn->s == SPECIAL_ABC) {
-                            guii_widget_hide(tmp1);
-                            guii_widget_show(tmp2);
-                            guii_widget_hide(tmp3);
-                        } else if (kbtn->s == SPECIAL_123) {
-                            guii_widget_show(tmp1);
-                            guii_widget_hide(tmp2);
-                            guii_widget_hide(tmp3);
-                        } else if (kbtn->s == SPECIAL_CALC) {
-                            guii_widget_hide(tmp1);
-                            guii_widget_hide(tmp2);
-                            guii_widget_show(tmp3);
-                        }
-                        SHIFT_DISABLE();        /* Clear shift mode */
-                        break;
-                    }
-                    case SPECIAL_SHIFT: {
-                        SHIFT_TOGGLE();         /* Toggle shift mode */
-                        break;
-                    }
-                    case SPECIAL_BACKSPACE: {
-                        ch = GUI_KEY_BACKSPACE; /* Fake backspace key */
-                        break;
-                    }
-                    case SPECIAL_HIDE: {        /* Hide button pressed */
-                        guii_keyboard_hide();  /* Hide keyboard */
-                        break;
-                    }
-                }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Get text to display on key
+ * \param[in]       btn: Key descriptor
+ * \param[out]      str: Temporary memory for character keys, at least `5` bytes long
+ * \return          Pointer to text to display
+ */
+static const gui_char *
+key_gettext(const key_btn_t* btn, gui_char* str) {
+    switch (btn->s) {                               /* Check if there is special key */
+        case SPECIAL_123:       return _GT("123");
+        case SPECIAL_ABC:       return _GT("abc");
+        case SPECIAL_CALC:      return _GT("#+=");
+        case SPECIAL_BACKSPACE: return _GT("Back");
+        case SPECIAL_ENTER:     return _GT("Ent");
+        case SPECIAL_SHIFT:     return _GT("Shift");
+        case SPECIAL_HIDE:      return _GT("Hide");
+        default:
+            memset(str, 0x00, 5);
+            if (keyboard.is_shift && btn->cs) {     /* Character when shift is ON */
+                gui_string_unicode_encode(btn->cs, str);    /* Encode character to unicode */
+            } else {                                /* Character when shift is OFF */
+                gui_string_unicode_encode(btn->c, str); /* Encode character to unicode */
+            }
+            return str;
+    }
+}
+
+/**
+ * \brief           Draw keys of currently visible layout
+ * \param[in]       h: Keyboard widget handle
+ * \param[in]       disp: Display clipping region
+ */
+static void
+keyboard_draw(gui_handle_p h, const gui_display_t* disp) {
+    const key_layout_t* layout = &layouts[keyboard.layout];
+    const key_btn_t* btn;
+    const gui_font_t* font;
+    gui_draw_font_t f;
+    gui_char str[5];
+    gui_dim_t ax, ay, x, y, w, hi;
+    gui_color_t c1, c2;
+    size_t r, i;
+    
+    ax = guii_widget_getabsolutex(h);
+    ay = guii_widget_getabsolutey(h);
+    font = keyboard.font != NULL ? keyboard.font : keyboard.default_font;
+    for (r = 0; r < layout->rows_count; r++) {
+        for (i = 0; i < layout->rows[r].btns_count; i++) {
+            btn = &layout->rows[r].btns[i];
+            key_getrect(h, r, btn, &x, &y, &w, &hi);
+            x += ax;
+            y += ay;
+            if (!__GUI_RECT_MATCH(x, y, x + w - 1, y + hi - 1, disp->x1, disp->y1, disp->x2 - 1, disp->y2 - 1)) {
+                continue;                           /* Key is not in redraw area */
             }
             
-            /*
-             * Check if we have to add key to input buffer
-             */
-            if (ch || !kbtn->s) {               /* If character from special is set or normal key pressed */
-                if (!ch) {                      /* Only if char not yet set */
-                    if (keyboard.is_shift && kbtn->cs) {/* If shift mode enabled and character has shift mode character */
-                        ch = kbtn->cs;          /* Use shift mode character */
-                    } else {
-                        ch = kbtn->c;           /* Use normal character */
-                    }
-                }
-                
-                /* Clear shift mode if necessary */
-                if (keyboard.is_shift != SHIFT_UPPERCASE) {   /* When not in uppercase shift mode */
-                    SHIFT_DISABLE();            /* Clear shift mode */
-                }
-                
-                /************************************/
-                /* Send character to focused widget */
-                /************************************/
-                gui_string_unicode_encode(ch, kbd.keys);/* Decode key */
-                gui_input_keyadd(&kbd);         /* Add actual key */
-                kbd.keys[0] = 0;                /* Set key to 0 */
-                gui_input_keyadd(&kbd);         /* Add end key */
+            if (btn == keyboard.pressed) {          /* Swap colors for pressed key */
+                c1 = GUI_COLOR_BLACK;
+                c2 = GUI_COLOR_GRAY;
+            } else {
+                c1 = GUI_COLOR_GRAY;
+                c2 = GUI_COLOR_BLACK;
             }
-            return 1;
-        }
-        case GUI_WC_DblClick: {
-            const key_btn_t* kbtn;
+            gui_draw_filledrectangle(disp, x, y, w, hi, c1);
+            gui_draw_rectangle(disp, x, y, w, hi, c2);
             
-            kbtn = guii_widget_getuserdata(h); /* Get data from widget */
-            switch (kbtn->s) {
-                case SPECIAL_SHIFT: {
-                    SHIFT_ENABLE(SHIFT_UPPERCASE);  /* Enable shift upper case mode */
-                    return 1;
-                }
+            if (font != NULL) {
+                gui_draw_font_init(&f);             /* Init structure */
+                f.x = x + 1;
+                f.y = y + 1;
+                f.width = w - 2;
+                f.height = hi - 2;
+                f.align = GUI_HALIGN_CENTER | GUI_VALIGN_CENTER;
+                f.color1width = f.width;
+                f.color1 = c2;
+                gui_draw_writetext(disp, font, key_gettext(btn, str), &f);
             }
-            return 0;
         }
-        default:
-            GUI_UNUSED3(h, param, result);      /* Unused elements to prevent compiler warnings */
-            return gui_widget_processdefaultcallback(h, cmd, param, result);    /* Process default callback */
     }
 }
 
-/* Callback for keyboard base widget */
-static uint8_t
-keyboard_callback(gui_handle_p h, gui_wc_t cmd, gui_widget_param_t* param, gui_widget_result_t* result) {
-    switch (cmd) {
-        case GUI_WC_Init: {
-            return 1;
-        }
-        default:                                /* Handle default option */
-            GUI_UNUSED3(h, param, result);      /* Unused elements to prevent compiler warnings */
-            return gui_widget_processdefaultcallback(h, cmd, param, result);    /* Process default callback */
+/**
+ * \brief           Set pressed key and invalidate only area of previous and new key
+ * \param[in]       h: Keyboard widget handle
+ * \param[in]       btn: New pressed key or `NULL` to release it
+ * \param[in]       row: Row index of new pressed key
+ */
+static void
+keyboard_setpressed(gui_handle_p h, const key_btn_t* btn, size_t row) {
+    gui_dim_t x, y, w, hi;
+    
+    if (keyboard.pressed == btn) {
+        return;
+    }
+    if (keyboard.pressed != NULL) {
+        key_getrect(h, keyboard.pressed_row, keyboard.pressed, &x, &y, &w, &hi);
+        guii_widget_invalidaterect(h, x, y, w, hi);
+    }
+    keyboard.pressed = btn;
+    keyboard.pressed_row = row;
+    if (btn != NULL) {
+        key_getrect(h, row, btn, &x, &y, &w, &hi);
+        guii_widget_invalidaterect(h, x, y, w, hi);
     }
 }
 
-/* Timer callback for keyboard */
+/**
+ * \brief           Process click on keyboard key
+ * \param[in]       kbtn: Clicked key descriptor
+ */
 static void
-keyboard_timer_callback(gui_timer_t* timer) {
-    if (keyboard.action == ACTION_HIDE) {       /* We should hide the keyboard */
-        if (keyboard.action_value < 10) {
-            keyboard.action_value++;
-            guii_widget_setpositionpercent(keyboard.handle, 0, 50 + keyboard.action_value * 5);
-        } else {
-            guii_widget_hide(keyboard.handle);  /* Hide keyboard */
-            guii_timer_stop(timer);             /* Stop timer */
+keyboard_click(const key_btn_t* kbtn) {
+    uint32_t ch = 0;
+    gui_keyboard_data_t kbd = {0};
+    
+    if (kbtn->s) {                                  /* Has button special function? */
+        switch (kbtn->s) {                          /* Check special function */
+            case SPECIAL_123:
+            case SPECIAL_ABC: 
+            case SPECIAL_CALC: {                    /* Special functions 123 or ABC */
+                if (kbtn->s == SPECIAL_ABC) {
+                    keyboard.layout = LAYOUT_ABC;
+                } else if (kbtn->s == SPECIAL_123) {
+                    keyboard.layout = LAYOUT_123;
+                } else {
+                    keyboard.layout = LAYOUT_CALC;
+                }
+                keyboard.pressed = NULL;            /* Key does not exist on new layout */
+                guii_widget_invalidate(keyboard.handle);    /* Draw new layout */
+                SHIFT_DISABLE();                    /* Clear shift mode */
+                break;
+            }
+            case SPECIAL_SHIFT: {
+                SHIFT_TOGGLE();                     /* Toggle shift mode */
+                break;
+            }
+            case SPECIAL_BACKSPACE: {
+                ch = GUI_KEY_BACKSPACE;             /* Fake backspace key */
+                break;
+            }
+            case SPECIAL_HIDE: {                    /* Hide button pressed */
+                guii_keyboard_hide();               /* Hide keyboard */
+                break;
+            }
         }
-    } else if (keyboard.action == ACTION_SHOW) {/* We should show the keyboard */
-        if (keyboard.action_value) {
-            if (keyboard.action_value == 10) {  /* At the bottom? */
-                guii_widget_show(keyboard.handle);  /* First set keyboard as visible */
+    }
+    
+    /*
+     * Check if we have to add key to input buffer
+     */
+    if (ch || !kbtn->s) {                           /* If character from special is set or normal key pressed */
+        if (!ch) {                                  /* Only if char not yet set */
+            if (keyboard.is_shift && kbtn->cs) {    /* If shift mode enabled and character has shift mode character */
+                ch = kbtn->cs;                      /* Use shift mode character */
+            } else {
+                ch = kbtn->c;                       /* Use normal character */
             }
-            keyboard.action_value--;            /* Decrease value */
-            guii_widget_setpositionpercent(keyboard.handle, 0, 50 + keyboard.action_value * 5);
         }
-        if (keyboard.action_value == 0) {
-            guii_timer_stop(timer);             /* Stop timer */
+        
+        /* Clear shift mode if necessary */
+        if (keyboard.is_shift != SHIFT_UPPERCASE) { /* When not in uppercase shift mode */
+            SHIFT_DISABLE();                        /* Clear shift mode */
         }
+        
+        /************************************/
+        /* Send character to focused widget */
+        /************************************/
+        gui_string_unicode_encode(ch, kbd.keys);    /* Decode key */
+        gui_input_keyadd(&kbd);                     /* Add actual key */
+        kbd.keys[0] = 0;                            /* Set key to 0 */
+        gui_input_keyadd(&kbd);                     /* Add end key */
+    }
+}
+
+/* Animation callback for keyboard show/hide slide */
+static void
+keyboard_anim_exec(gui_handle_p h, int32_t value) {
+    keyboard.pos = value;
+    guii_widget_setpositionpercent(h, 0, (float)value);
+    if (value == KEYBOARD_POS_HIDDEN && keyboard.action == ACTION_HIDE) {
+        guii_widget_hide(h);                        /* Hide keyboard at the bottom */
     }
 }
 
@@ -484,67 +546,57 @@ keyboard_timer_callback(gui_timer_t* timer) {
 static uint8_t
 keyboard_base_callback(gui_handle_p h, gui_wc_t cmd, gui_widget_param_t* param, gui_widget_result_t* result) {
     switch (cmd) {
-        case GUI_WC_PreInit: {
-            h->timer = guii_timer_create(60, keyboard_timer_callback, 0);   /* Create timer */
-            if (h->timer == NULL) {
-                GUI_WIDGET_RESULTTYPE_U8(result) = 0;   /* Failed, stop and clear memory */
-            }
-            return 1;
-        }
         case GUI_WC_Init: {                     /* When base element is initialized */
-            gui_handle_p handle, handleLayout;
-            size_t i, k, z;
-            const key_layout_t* layout;
-            const key_row_t* row;
-            const key_btn_t* btn;
-            
             /***************************/
             /*   Configure keyboard    */
             /***************************/
             guii_widget_setsizepercent(h, 100, 50); /* Set keyboard size */
-            guii_widget_setpositionpercent(h, 0, 50);   /* Set position of keyboard outside visible area */
+            guii_widget_setpositionpercent(h, 0, KEYBOARD_POS_HIDDEN);  /* Set position of keyboard outside visible area */
             guii_widget_setzindex(h, GUI_WIDGET_ZINDEX_MAX);   /* Set to maximal z-index */
             guii_widget_hide(h);                /* Hide keyboard by default */
             
             keyboard.default_font = h->font;    /* Save current font */
+            keyboard.layout = LAYOUT_ABC;       /* Show first layout */
+            return 1;
+        }
+        case GUI_WC_Draw: {                     /* Keys are drawn from layout table, no widgets are used */
+            gui_widget_processdefaultcallback(h, cmd, param, result);   /* Draw background */
+            keyboard_draw(h, GUI_WIDGET_PARAMTYPE_DISP(param));
+            return 1;
+        }
+#if GUI_CFG_USE_TOUCH
+        case GUI_WC_TouchStart: {
+            guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);
+            const key_btn_t* btn;
+            size_t row = 0;
             
-            /***************************/
-            /* Create keyboard layouts */
-            /***************************/
-            for (i = 0; i < GUI_COUNT_OF(layouts); i++) {
-                layout = &layouts[i];           /* Get layout data */
-                
-                /***************************/
-                /* Create keyboard layout  */
-                /***************************/
-                handleLayout = gui_container_create(layout->id, 0, 0, 100, 100, h, keyboard_callback, 0);
-                guii_widget_setsizepercent(handleLayout, 100, 100);
-                guii_widget_setpositionpercent(handleLayout, 0, 0);
-                guii_widget_setuserdata(handleLayout, (void *)layout);
-                if (i) {                        /* Show only first layout */
-                    guii_widget_hide(handleLayout);
-                } else {                        /* Save main layout handle */
-                    keyboard.main_layout_handle = handleLayout;
-                }
-                
-                /***************************/
-                /* Draw buttons on layout  */
-                /***************************/
-                for (k = 0; k < layout->rows_count; k++) {
-                    row = &layout->rows[k];     /* Get row pointer */
-                    for (z = 0; z < row->btns_count; z++) {
-                        btn = &row->btns[z];    /* Get button pointer */
-                        
-                        handle = gui_button_create(0, 0, 0, 1, 1, handleLayout, keyboard_btn_callback, 0);    /* Create button object */
-                        guii_widget_setuserdata(handle, (void *)btn);  /* Set pointer to button */
-                        guii_widget_setsizepercent(handle, btn->w, 23);    /* Set button percent */
-                        guii_widget_setpositionpercent(handle, btn->x, 1 + 25 * k);
-                        guii_widget_set3dstyle(handle, 0); /* Make buttons flat */
-                    }
-                }
+            btn = key_find(h, ts->x_rel[0], ts->y_rel[0], &row);
+            keyboard_setpressed(h, btn, row);
+            GUI_WIDGET_RESULTTYPE_TOUCH(result) = touchHANDLED;
+            return 1;
+        }
+        case GUI_WC_TouchMove: {
+            GUI_WIDGET_RESULTTYPE_TOUCH(result) = touchHANDLED;
+            return 1;
+        }
+        case GUI_WC_TouchEnd: {
+            keyboard_setpressed(h, NULL, 0);    /* Release key */
+            return 1;
+        }
+#endif /* GUI_CFG_USE_TOUCH */
+        case GUI_WC_Click: {                    /* Click on key pressed on touch start */
+            if (keyboard.pressed != NULL) {
+                keyboard_click(keyboard.pressed);
             }
             return 1;
         }
+        case GUI_WC_DblClick: {
+            if (keyboard.pressed != NULL && keyboard.pressed->s == SPECIAL_SHIFT) {
+                SHIFT_ENABLE(SHIFT_UPPERCASE);  /* Enable shift upper case mode */
+                return 1;
+            }
+            return 0;                           /* Process as normal click */
+        }
         default:                                /* Handle default option */
             GUI_UNUSED3(h, param, result);      /* Unused elements to prevent compiler warnings */
             return gui_widget_processdefaultcallback(h, cmd, param, result);    /* Process default callback */
@@ -560,9 +612,8 @@ keyboard_base_callback(gui_handle_p h, gui_wc_t cmd, gui_widget_param_t* param,
 uint8_t
 guii_keyboard_hide(void) {
     __GUI_ASSERTPARAMS(keyboard.handle != NULL);/* Check parameters */
-    guii_widget_hide(keyboard.handle);          /* Show keyboard widget */
-    //keyboard.action = ACTION_HIDE;              /* Set action to hide */
-    //guii_timer_startperiodic(keyboard.handle->timer);   /* Start periodic timer */
+    keyboard.action = ACTION_HIDE;              /* Set action to hide */
+    guii_anim_start(keyboard.handle, keyboard_anim_exec, keyboard.pos, KEYBOARD_POS_HIDDEN, KEYBOARD_ANIM_DURATION, GUI_ANIM_EASE_IN);
     
     return 1;
 }
@@ -581,14 +632,9 @@ guii_keyboard_show(gui_handle_p h) {
         keyboard.font = h->font;                /* Save font as display font */
         guii_widget_invalidate(keyboard.handle);/* Force invalidation */
     }
+    keyboard.action = ACTION_SHOW;              /* Set action to show */
     guii_widget_show(keyboard.handle);          /* Show keyboard widget */
-    
-//    keyboard.action = ACTION_SHOW;              /* Set action to show */
-//    if (h != NULL && h->font != NULL) {         /* Check widget and font for it */
-//        keyboard.font = h->font;                /* Save font as display font */
-//        guii_widget_invalidate(keyboard.handle);/* Force invalidation */
-//    }
-//    guii_timer_startperiodic(keyboard.handle->timer);   /* Start periodic timer */
+    guii_anim_start(keyboard.handle, keyboard_anim_exec, keyboard.pos, KEYBOARD_POS_SHOWN, KEYBOARD_ANIM_DURATION, GUI_ANIM_EASE_OUT);
     
     return 1;
 }
@@ -31,6 +31,10 @@
 #define GUI_INTERNAL
 #include "gui/gui_private.h"
 #include "gui/gui_lcd.h"
+#include "gui/gui_draw.h"
+#if GUI_CFG_LL_SOFTWARE && GUI_CFG_LL_SOFTWARE_SIMD && !defined(__CC_ARM)
+#include <arm_acle.h>
+#endif /* GUI_CFG_LL_SOFTWARE && GUI_CFG_LL_SOFTWARE_SIMD && !defined(__CC_ARM) */
 
 /**
  * \brief           Get LCD width in units of pixels
@@ -52,6 +56,8 @@ gui_lcd_getheight(void) {
 
 /**
  * \brief           Notify GUI stack from low-level layer which layer is currently used as display layer
+ * \note            With \ref GUI_CFG_STATS_LATENCY enabled, time of this call ends input-to-display latency
+ *                  of touch input shown by the layer. Call it when display controller actually swapped layers
  * \param[in]       layer_num: Layer number used as display layer
  */
 void
@@ -59,8 +65,1235 @@ gui_lcd_confirmactivelayer(uint8_t layer_num) {
     if ((GUI.lcd.flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM)) {/* If we have anything pending */
         GUI.lcd.layers[layer_num].pending = 0;
         GUI.lcd.flags &= ~GUI_FLAG_LCD_WAIT_LAYER_CONFIRM;  /* Clear flag */
+#if GUI_CFG_STATS_LATENCY
+        if (GUI.Latency.shown_valid) {              /* Shown layer has result of measured input */
+            GUI.Latency.confirmed = gui_sys_now() - GUI.Latency.shown_time;
+            GUI.Latency.shown_valid = 0;
+            GUI.Latency.confirmed_valid = 1;        /* GUI thread adds it to samples */
+        }
+#endif /* GUI_CFG_STATS_LATENCY */
+#if GUI_CFG_OS_RENDER_THREAD
+        gui_sys_sem_release(&GUI.OS.render_sem);    /* Rasterizer thread may draw next frame */
+#endif /* GUI_CFG_OS_RENDER_THREAD */
 #if GUI_CFG_OS
-        gui_sys_mbox_putnow(&GUI.OS.mbox, 0x00);
+        __GUI_WAKEUP(0x00);
 #endif
     }
 }
+
+#if GUI_CFG_LCD_BAND || __DOXYGEN__
+
+/**
+ * \brief           Notify GUI stack from low-level layer that band transfer is finished
+ * \note            Function may be called from interrupt, band buffer is reused for drawing after this call
+ * \param[in]       band_num: Number of band layer from \ref GUI_LL_Command_Flush command
+ */
+void
+gui_lcd_confirmflush(uint8_t band_num) {
+    if (band_num < GUI_COUNT_OF(GUI.Band)) {
+        GUI.Band[band_num].pending = 0;
+    }
+}
+
+#endif /* GUI_CFG_LCD_BAND || __DOXYGEN__ */
+
+#if GUI_CFG_LCD_BACKGROUND || __DOXYGEN__
+
+/**
+ * \brief           Draw static content to background layer
+ *
+ *                  Background layer is shown by display controller below drawing layers
+ *                  and it is not touched by widget redraw operations.
+ *                  Function is usually called once, after \ref gui_init
+ *
+ * \note            With \ref GUI_CFG_OS_RENDER_THREAD enabled, background is drawn by rasterizer thread before next frame
+ * \param[in]       img: Pointer to \ref gui_image_desc_t image drawn to center of screen. Set to `NULL` to use color only
+ * \param[in]       color: Color used to fill background around image
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_lcd_setbackground(const gui_image_desc_t* img, gui_color_t color) {
+    gui_display_t disp;
+    gui_layer_t* layer;
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (GUI.lcd.background == NULL) {               /* Driver has no background layer */
+        __GUI_LEAVE();                              /* Leave GUI */
+        return 0;
+    }
+    
+    disp.x1 = 0;
+    disp.y1 = 0;
+    disp.x2 = GUI.lcd.width;
+    disp.y2 = GUI.lcd.height;
+    
+#if GUI_CFG_OS_RENDER_THREAD
+    GUI_UNUSED(layer);
+    if (GUI.BackgroundFrame.busy) {                 /* Previous background is not drawn yet */
+        __GUI_LEAVE();                              /* Leave GUI */
+        return 0;
+    }
+    GUI.BackgroundFrame.list.detached = 1;
+    guii_draw_dlist_begin(&GUI.BackgroundFrame.list);   /* Only rasterizer thread draws to layers */
+#else /* GUI_CFG_OS_RENDER_THREAD */
+    layer = GUI.lcd.drawing_layer;
+    GUI.lcd.drawing_layer = GUI.lcd.background;     /* Draw functions use drawing layer */
+#endif /* !GUI_CFG_OS_RENDER_THREAD */
+    gui_draw_filledrectangle(&disp, 0, 0, GUI.lcd.width, GUI.lcd.height, color);
+    if (img != NULL) {
+        gui_draw_image(&disp, (GUI.lcd.width - img->x_size) / 2, (GUI.lcd.height - img->y_size) / 2, img);
+    }
+#if GUI_CFG_OS_RENDER_THREAD
+    if (!guii_draw_dlist_end()) {
+        __GUI_LEAVE();                              /* Leave GUI */
+        return 0;
+    }
+    GUI.BackgroundFrame.layer = GUI.lcd.background;
+    GUI.BackgroundFrame.busy = 1;
+    gui_sys_mbox_putnow(&GUI.OS.render_mbox, &GUI.BackgroundFrame);  /* Drawn before next frame */
+#else /* GUI_CFG_OS_RENDER_THREAD */
+    GUI.lcd.drawing_layer = layer;
+    guii_ll_waitready();                            /* Background is visible immediately */
+#endif /* !GUI_CFG_OS_RENDER_THREAD */
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+#endif /* GUI_CFG_LCD_BACKGROUND || __DOXYGEN__ */
+
+#if GUI_CFG_LCD_SPLASH || __DOXYGEN__
+
+#if GUI_CFG_LCD_BAND
+#error "GUI_CFG_LCD_SPLASH is not supported together with GUI_CFG_LCD_BAND"
+#endif /* GUI_CFG_LCD_BAND */
+
+static const gui_image_desc_t* splash_img;          /* Image shown until first frame, kept over GUI reset in init */
+static gui_color_t splash_color;
+static uint8_t splash_set;
+
+/**
+ * \brief           Set image shown on display from initialization until first frame is drawn
+ *
+ *                  Function must be called before \ref gui_init. Image is drawn to visible layer
+ *                  right after low-level initialization instead of solid desktop color,
+ *                  while application creates widgets and first frame is drawn
+ *
+ * \note            When image has pixel format of layers and size of display,
+ *                  such as precomposed screenshot of first screen, image is copied with single low-level operation
+ * \param[in]       img: Pointer to \ref gui_image_desc_t image drawn to center of screen. Set to `NULL` to use color only
+ * \param[in]       color: Color used to fill screen around image
+ * \return          `1` on success, `0` when GUI is already initialized
+ */
+uint8_t
+gui_lcd_setsplash(const gui_image_desc_t* img, gui_color_t color) {
+    if (GUI.Initialized) {                          /* Splash is drawn only during initialization */
+        return 0;
+    }
+    splash_img = img;
+    splash_color = color;
+    splash_set = 1;
+    return 1;
+}
+
+/**
+ * \brief           Draw splash image to current drawing layer
+ * \note            The function is private and can be called only during initialization
+ * \return          `1` when splash is drawn, `0` when it is not set
+ */
+uint8_t
+guii_lcd_drawsplash(void) {
+    gui_display_t disp;
+    
+    if (!splash_set) {
+        return 0;
+    }
+    disp.x1 = 0;
+    disp.y1 = 0;
+    disp.x2 = GUI.lcd.width;
+    disp.y2 = GUI.lcd.height;
+    if (splash_img == NULL || splash_img->x_size < GUI.lcd.width || splash_img->y_size < GUI.lcd.height) {
+        gui_draw_filledrectangle(&disp, 0, 0, GUI.lcd.width, GUI.lcd.height, splash_color);
+    }
+    if (splash_img != NULL) {
+        gui_draw_image(&disp, (GUI.lcd.width - splash_img->x_size) / 2, (GUI.lcd.height - splash_img->y_size) / 2, splash_img);
+    }
+    guii_ll_waitready();                            /* Splash is visible before widgets are created */
+    return 1;
+}
+
+#endif /* GUI_CFG_LCD_SPLASH || __DOXYGEN__ */
+
+#if GUI_CFG_LCD_ROTATION || __DOXYGEN__
+
+#if GUI_CFG_LCD_BAND
+#error "GUI_CFG_LCD_ROTATION is not supported together with GUI_CFG_LCD_BAND"
+#endif /* GUI_CFG_LCD_BAND */
+
+/**
+ * \brief           Rotate rectangle inside area
+ * \param[in]       rotation: Rotation of area, member of \ref gui_lcd_rotation_t
+ * \param[in]       width: Area width before rotation
+ * \param[in]       height: Area height before rotation
+ * \param[in,out]   x, y: Pointers to top left position of rectangle inside area
+ * \param[in,out]   w, h: Pointers to rectangle size, swapped for 90 and 270 degrees
+ */
+void
+guii_lcd_rotaterect(uint8_t rotation, gui_dim_t width, gui_dim_t height, gui_dim_t* x, gui_dim_t* y, gui_dim_t* w, gui_dim_t* h) {
+    gui_dim_t t;
+    
+    switch (rotation) {
+        case GUI_LCD_ROTATION_90:                   /* Left edge of area is on top */
+            t = *x;
+            *x = height - *y - *h;
+            *y = t;
+            break;
+        case GUI_LCD_ROTATION_180:
+            *x = width - *x - *w;
+            *y = height - *y - *h;
+            return;
+        case GUI_LCD_ROTATION_270:                  /* Left edge of area is on bottom */
+            t = *y;
+            *y = width - *x - *w;
+            *x = t;
+            break;
+        default:
+            return;
+    }
+    t = *w;
+    *w = *h;
+    *h = t;
+}
+
+/**
+ * \brief           Map touch position on display to logical screen
+ * \param[in,out]   x, y: Pointers to position reported by touch controller
+ */
+void
+guii_lcd_touchtological(gui_dim_t* x, gui_dim_t* y) {
+    gui_dim_t t;
+    
+    switch (GUI.lcd.rotation) {
+        case GUI_LCD_ROTATION_90:
+            t = *x;
+            *x = *y;
+            *y = GUI.lcd.height - 1 - t;
+            break;
+        case GUI_LCD_ROTATION_180:
+            *x = GUI.lcd.width - 1 - *x;
+            *y = GUI.lcd.height - 1 - *y;
+            break;
+        case GUI_LCD_ROTATION_270:
+            t = *x;
+            *x = GUI.lcd.width - 1 - *y;
+            *y = t;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * \brief           Set rotation of logical screen on display
+ *
+ *                  Width and height reported by \ref gui_lcd_getwidth and \ref gui_lcd_getheight
+ *                  are swapped for 90 and 270 degrees, desktop is resized and redrawn.
+ *                  Touch positions are mapped to rotated screen by GUI
+ *
+ * \param[in]       rotation: Clockwise rotation, member of \ref gui_lcd_rotation_t
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_lcd_setrotation(gui_lcd_rotation_t rotation) {
+    gui_handle_p h;
+    gui_dim_t t;
+    size_t i;
+    
+    if (rotation > GUI_LCD_ROTATION_270) {
+        return 0;
+    }
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (rotation != GUI.lcd.rotation) {
+        if ((rotation ^ GUI.lcd.rotation) & 0x01) { /* Portrait and landscape have swapped size */
+            t = GUI.lcd.width;
+            GUI.lcd.width = GUI.lcd.height;
+            GUI.lcd.height = t;
+        }
+        GUI.lcd.rotation = (uint8_t)rotation;
+        for (i = 0; i < GUI.lcd.layer_count; i++) { /* Regions of last frames are in old orientation */
+            GUI.lcd.layers[i].display_count = 0;
+        }
+        h = (gui_handle_p)gui_linkedlist_getnext_gen(&GUI.root, NULL);  /* Desktop window */
+        if (h != NULL) {
+            guii_widget_setsize(h, GUI.lcd.width, GUI.lcd.height);
+            guii_widget_invalidate(h);              /* Complete screen is drawn in new orientation */
+        }
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Get rotation of logical screen on display
+ * \return          Current rotation, member of \ref gui_lcd_rotation_t
+ */
+gui_lcd_rotation_t
+gui_lcd_getrotation(void) {
+    return (gui_lcd_rotation_t)GUI.lcd.rotation;
+}
+
+#endif /* GUI_CFG_LCD_ROTATION || __DOXYGEN__ */
+
+#if GUI_CFG_LCD_CLUT || __DOXYGEN__
+
+/**
+ * \brief           Get index to palette lookup table for color, 4 bits of each channel
+ * \param[in]       c: ARGB8888 color
+ * \hideinitializer
+ */
+#define clut_key(c)                 ((((c) >> 12) & 0x0F00) | (((c) >> 8) & 0x00F0) | (((c) >> 4) & 0x000F))
+
+static uint8_t clut_lookup[4096];                   /* Nearest palette index for each RGB444 color */
+static gui_color_t clut_default[256];               /* Palette used when low-level driver does not set own */
+
+/**
+ * \brief           Fill default palette with 6x6x6 color cube and gray ramp between its levels
+ */
+static void
+clut_setdefault(void) {
+    uint32_t r, g, b, i = 0;
+    
+    for (r = 0; r < 6; r++) {
+        for (g = 0; g < 6; g++) {
+            for (b = 0; b < 6; b++) {
+                clut_default[i++] = 0xFF000000UL | ((r * 51) << 16) | ((g * 51) << 8) | (b * 51);
+            }
+        }
+    }
+    for (r = 0; i < 256; r++) {                     /* 40 grays, 8 between 2 neighbour cube levels */
+        g = (r / 8) * 51 + ((r % 8) + 1) * 51 / 9;
+        clut_default[i++] = 0xFF000000UL | (g << 16) | (g << 8) | g;
+    }
+    GUI.lcd.palette = clut_default;
+    GUI.lcd.palette_size = 256;
+}
+
+/**
+ * \brief           Build lookup table from colors to nearest palette entries
+ * \note            Each of `4096` colors is compared with all palette colors,
+ *                  colors of palette itself map exactly to their entries afterwards
+ */
+static void
+clut_build(void) {
+    const gui_color_t* pal = GUI.lcd.palette;
+    int32_t r, g, b, dr, dg, db;
+    uint32_t key, i, d, best, best_d;
+    
+    for (key = 0; key < GUI_COUNT_OF(clut_lookup); key++) {
+        r = (int32_t)((key >> 4) & 0xF0) | 0x08;    /* Middle of color range of entry */
+        g = (int32_t)(key & 0xF0) | 0x08;
+        b = (int32_t)((key << 4) & 0xF0) | 0x08;
+        best = 0;
+        best_d = 0xFFFFFFFFUL;
+        for (i = 0; i < GUI.lcd.palette_size && best_d; i++) {
+            dr = (int32_t)((pal[i] >> 16) & 0xFF) - r;
+            dg = (int32_t)((pal[i] >> 8) & 0xFF) - g;
+            db = (int32_t)(pal[i] & 0xFF) - b;
+            d = (uint32_t)(3 * dr * dr + 4 * dg * dg + 2 * db * db);    /* Eye is most sensitive to green */
+            if (d < best_d) {
+                best_d = d;
+                best = i;
+            }
+        }
+        clut_lookup[key] = (uint8_t)best;
+    }
+    for (i = GUI.lcd.palette_size; i > 0; i--) {    /* Lower index wins when colors share entry */
+        clut_lookup[clut_key(pal[i - 1])] = (uint8_t)(i - 1);
+    }
+}
+
+/**
+ * \brief           Load display palette to lookup table and to display controller
+ */
+static void
+clut_load(void) {
+    uint8_t result = 0;
+    
+    clut_build();
+    gui_ll_control(&GUI.lcd, GUI_LL_Command_SetPalette, NULL, &result);
+}
+
+/**
+ * \brief           Set up display palette after low-level initialization
+ * \note            Default palette is used when low-level driver did not set own palette
+ */
+void
+guii_lcd_initpalette(void) {
+    if (GUI.lcd.palette == NULL || !GUI.lcd.palette_size || GUI.lcd.palette_size > 256) {
+        clut_setdefault();
+    }
+    clut_load();
+}
+
+/**
+ * \brief           Get palette index of color for \ref GUI_PIXEL_FORMAT_L8 layers
+ * \note            Color is mapped with 4 bits per channel, colors of palette map exactly
+ *                  when there are no other palette colors with the same upper 4 bits
+ * \param[in]       color: ARGB8888 color, alpha is ignored
+ * \return          Index of nearest palette color
+ */
+uint8_t
+guii_lcd_colortoindex(gui_color_t color) {
+    return clut_lookup[clut_key(color)];
+}
+
+/**
+ * \brief           Set display palette for layers with \ref GUI_PIXEL_FORMAT_L8 pixel format
+ *
+ *                  Palette is loaded to display controller and complete screen is redrawn
+ *                  with nearest palette colors. Flat user interface with few colors
+ *                  should put all its colors to palette, antialiased edges then use nearest colors.
+ *
+ * \note            Colors are not copied and must stay valid while palette is used.
+ *                  Alpha channel of colors is ignored, pixels of layers are always opaque
+ * \note            Building of color lookup table compares `4096` colors with all palette colors
+ * \param[in]       colors: Array of ARGB8888 colors, `NULL` to use default palette
+ * \param[in]       count: Number of colors in array, up to `256`
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_lcd_setpalette(const gui_color_t* colors, size_t count) {
+    gui_handle_p h;
+    
+    if (colors != NULL && (!count || count > 256)) {
+        return 0;
+    }
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (colors != NULL) {
+        GUI.lcd.palette = colors;
+        GUI.lcd.palette_size = (uint16_t)count;
+    } else {
+        clut_setdefault();
+    }
+    GUI.lcd.palette_id++;                           /* Saved bitmaps have indices of old palette */
+    clut_load();
+    h = (gui_handle_p)gui_linkedlist_getnext_gen(&GUI.root, NULL);  /* Desktop window */
+    if (h != NULL) {
+        guii_widget_invalidate(h);                  /* Complete screen is drawn with new palette */
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+#endif /* GUI_CFG_LCD_CLUT || __DOXYGEN__ */
+
+#if GUI_CFG_LCD_FRAME_CALLBACK || __DOXYGEN__
+
+/**
+ * \brief           Set callback called with changed regions of each drawn frame
+ *
+ *                  Callback may read pixels of regions from layer memory,
+ *                  for example to send them to remote view. It must not call GUI functions
+ *
+ * \note            Callback is called from GUI thread, or from rasterizer thread when \ref GUI_CFG_OS_RENDER_THREAD is enabled
+ * \param[in]       fn: Callback function or `NULL` to disable it
+ * \param[in]       arg: User argument passed to callback
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_lcd_setframecallback(gui_lcd_frame_fn fn, void* arg) {
+    __GUI_ENTER();                                  /* Enter GUI */
+    GUI.FrameCallback = fn;
+    GUI.FrameCallbackArg = arg;
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Pass changed regions of finished frame to frame callback
+ * \param[in]       layer: Layer with finished frame, regions are taken from its display list
+ */
+void
+guii_lcd_framedone(const gui_layer_t* layer) {
+    const gui_display_t* rects = layer->display;
+    gui_lcd_frame_fn fn = GUI.FrameCallback;
+#if GUI_CFG_LCD_ROTATION
+    gui_display_t mapped[GUI_CFG_DISPLAY_DIRTY_RECTS];
+    gui_dim_t x, y, w, h;
+    size_t i;
+#endif /* GUI_CFG_LCD_ROTATION */
+    
+    if (fn == NULL || !layer->display_count) {
+        return;
+    }
+#if GUI_CFG_LCD_ROTATION
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {   /* Callback reads display memory */
+        for (i = 0; i < layer->display_count; i++) {
+            x = rects[i].x1;
+            y = rects[i].y1;
+            w = rects[i].x2 - rects[i].x1;
+            h = rects[i].y2 - rects[i].y1;
+            guii_lcd_maprect(&x, &y, &w, &h);
+            mapped[i].x1 = x;
+            mapped[i].y1 = y;
+            mapped[i].x2 = x + w;
+            mapped[i].y2 = y + h;
+        }
+        rects = mapped;
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    fn(layer, rects, layer->display_count, GUI.FrameCallbackArg);
+}
+
+#endif /* GUI_CFG_LCD_FRAME_CALLBACK || __DOXYGEN__ */
+
+#if GUI_CFG_LCD_CAPTURE || __DOXYGEN__
+
+/**
+ * \brief           Screen capture encoder state
+ */
+typedef struct {
+    uint8_t buff[GUI_CFG_LCD_CAPTURE_BUFF_SIZE];    /*!< Encoded data waiting for callback */
+    size_t len;                             /*!< Number of valid bytes in buffer */
+    gui_lcd_capture_fn fn;                  /*!< User callback */
+    void* arg;                              /*!< User callback argument */
+    uint8_t ok;                             /*!< Set to `0` when callback aborted capture */
+    uint32_t index[64];                     /*!< QOI table of recently seen pixels */
+    uint32_t prev;                          /*!< QOI previous pixel */
+    uint8_t run;                            /*!< QOI number of repeated previous pixels */
+} capture_t;
+
+static capture_t capture;                   /* Capture runs under GUI lock, one at a time */
+
+/**
+ * \brief           Pass buffered data to user callback
+ */
+static void
+capture_flush(void) {
+    if (capture.len && capture.ok) {
+        capture.ok = capture.fn(capture.buff, capture.len, capture.arg);
+    }
+    capture.len = 0;
+}
+
+/**
+ * \brief           Add bytes to capture buffer
+ * \param[in]       data: Data to add
+ * \param[in]       len: Number of bytes
+ */
+static void
+capture_put(const uint8_t* data, size_t len) {
+    for (; len > 0; len--) {
+        if (capture.len == sizeof(capture.buff)) {
+            capture_flush();
+        }
+        capture.buff[capture.len++] = *data++;
+    }
+}
+
+/**
+ * \brief           Add single byte to capture buffer
+ * \param[in]       b: Byte to add
+ */
+static void
+capture_byte(uint8_t b) {
+    capture_put(&b, 1);
+}
+
+/**
+ * \brief           Add 32-bit value to capture buffer
+ * \param[in]       v: Value to add
+ * \param[in]       big_endian: Set to `1` to write most significant byte first
+ */
+static void
+capture_u32(uint32_t v, uint8_t big_endian) {
+    uint8_t b[4];
+    uint8_t i;
+    
+    for (i = 0; i < 4; i++) {
+        b[big_endian ? 3 - i : i] = (uint8_t)(v >> (8 * i));
+    }
+    capture_put(b, 4);
+}
+
+/**
+ * \brief           Write file header of capture
+ * \param[in]       format: Member of \ref gui_lcd_capture_format_t enumeration
+ * \param[in]       width: Image width
+ * \param[in]       height: Image height
+ */
+static void
+capture_header(gui_lcd_capture_format_t format, uint32_t width, uint32_t height) {
+    uint32_t row = (width * 3 + 3) & ~0x03UL;       /* BMP rows are aligned to 4 bytes */
+    
+    if (format == GUI_LCD_CAPTURE_QOI) {
+        capture_put((const uint8_t *)"qoif", 4);
+        capture_u32(width, 1);
+        capture_u32(height, 1);
+        capture_byte(3);                            /* RGB channels */
+        capture_byte(0);                            /* sRGB with linear alpha */
+        memset(capture.index, 0x00, sizeof(capture.index));
+        capture.prev = 0xFF000000;
+        capture.run = 0;
+    } else {
+        capture_put((const uint8_t *)"BM", 2);
+        capture_u32(54 + row * height, 0);          /* File size */
+        capture_u32(0, 0);
+        capture_u32(54, 0);                         /* Offset of pixel data */
+        capture_u32(40, 0);                         /* Size of info header */
+        capture_u32(width, 0);
+        capture_u32((uint32_t)-(int32_t)height, 0); /* Negative height, rows go from top to bottom */
+        capture_u32(1 | (24UL << 16), 0);           /* Planes and bits per pixel */
+        capture_u32(0, 0);                          /* No compression */
+        capture_u32(row * height, 0);
+        capture_u32(2835, 0);                       /* 72 DPI */
+        capture_u32(2835, 0);
+        capture_u32(0, 0);
+        capture_u32(0, 0);
+    }
+}
+
+/**
+ * \brief           Encode single pixel with QOI operations
+ * \param[in]       px: Pixel color, alpha channel is ignored
+ */
+static void
+capture_qoi_pixel(uint32_t px) {
+    uint8_t idx;
+    int8_t dr, dg, db, dr_dg, db_dg;
+    
+    px |= 0xFF000000;
+    if (px == capture.prev) {
+        if (++capture.run == 62) {                  /* Longest run of single operation */
+            capture_byte(0xC0 | (capture.run - 1));
+            capture.run = 0;
+        }
+        return;
+    }
+    if (capture.run) {
+        capture_byte(0xC0 | (capture.run - 1));
+        capture.run = 0;
+    }
+    idx = (uint8_t)((((px >> 16) & 0xFF) * 3 + ((px >> 8) & 0xFF) * 5 + (px & 0xFF) * 7 + 0xFF * 11) % 64);
+    if (capture.index[idx] == px) {
+        capture_byte(idx);
+    } else {
+        capture.index[idx] = px;
+        dr = (int8_t)(((px >> 16) & 0xFF) - ((capture.prev >> 16) & 0xFF));
+        dg = (int8_t)(((px >> 8) & 0xFF) - ((capture.prev >> 8) & 0xFF));
+        db = (int8_t)((px & 0xFF) - (capture.prev & 0xFF));
+        dr_dg = (int8_t)(dr - dg);
+        db_dg = (int8_t)(db - dg);
+        if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+            capture_byte((uint8_t)(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+        } else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+            capture_byte((uint8_t)(0x80 | (dg + 32)));
+            capture_byte((uint8_t)(((dr_dg + 8) << 4) | (db_dg + 8)));
+        } else {
+            capture_byte(0xFE);
+            capture_byte((uint8_t)(px >> 16));
+            capture_byte((uint8_t)(px >> 8));
+            capture_byte((uint8_t)px);
+        }
+    }
+    capture.prev = px;
+}
+
+/**
+ * \brief           Capture shown frame and stream it encoded to callback
+ *
+ *                  Frame is read under GUI lock, so it is complete and no layer swap
+ *                  happens during capture. Pixels are read row by row from display memory
+ *                  and encoded to buffer of \ref GUI_CFG_LCD_CAPTURE_BUFF_SIZE bytes.
+ *                  Image has orientation of logical screen when \ref GUI_CFG_LCD_ROTATION is used
+ *
+ * \note            GUI is blocked until capture is finished, callback must not call GUI functions
+ * \param[in]       format: Image file format, member of \ref gui_lcd_capture_format_t enumeration
+ * \param[in]       fn: Callback function receiving file data in chunks
+ * \param[in]       arg: User argument passed to callback
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_lcd_capture(gui_lcd_capture_format_t format, gui_lcd_capture_fn fn, void* arg) {
+    gui_layer_t* layer;
+    gui_dim_t x, y, px, py;
+    gui_color_t color;
+    uint8_t ok;
+    
+    __GUI_ASSERTPARAMS(fn != NULL && format <= GUI_LCD_CAPTURE_QOI);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    layer = GUI.lcd.active_layer;
+    if (layer == NULL || !GUI_LL_HAS(GetPixel)) {
+        __GUI_LEAVE();
+        return 0;
+    }
+    capture.fn = fn;
+    capture.arg = arg;
+    capture.len = 0;
+    capture.ok = 1;
+    capture_header(format, GUI.lcd.width, GUI.lcd.height);
+    for (y = 0; y < GUI.lcd.height && capture.ok; y++) {
+        for (x = 0; x < GUI.lcd.width; x++) {
+            px = x;
+            py = y;
+#if GUI_CFG_LCD_ROTATION
+            guii_lcd_mappoint(&px, &py);            /* Logical pixel in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+            color = GUI_LL(GetPixel)(&GUI.lcd, layer, px, py);
+            if (format == GUI_LCD_CAPTURE_QOI) {
+                capture_qoi_pixel(color);
+            } else {
+                capture_byte((uint8_t)color);       /* Blue, green and red */
+                capture_byte((uint8_t)(color >> 8));
+                capture_byte((uint8_t)(color >> 16));
+            }
+        }
+        if (format == GUI_LCD_CAPTURE_BMP) {
+            for (x = GUI.lcd.width * 3; x & 0x03; x++) {
+                capture_byte(0);                    /* Row padding */
+            }
+        }
+    }
+    if (format == GUI_LCD_CAPTURE_QOI) {
+        if (capture.run) {
+            capture_byte(0xC0 | (capture.run - 1));
+        }
+        capture_put((const uint8_t *)"\0\0\0\0\0\0\0\1", 8);  /* End marker */
+    }
+    capture_flush();
+    ok = capture.ok;
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ok;
+}
+
+#endif /* GUI_CFG_LCD_CAPTURE || __DOXYGEN__ */
+
+#if GUI_CFG_LL_SOFTWARE || __DOXYGEN__
+
+/**
+ * \brief           Get address of pixel in layer memory
+ * \param[in]       layer: Layer handle
+ * \param[in]       x: X position relative to layer
+ * \param[in]       y: Y position relative to layer
+ */
+#define sw_pixel_addr(layer, x, y)  ((uint8_t *)(layer)->start_address + (layer)->pixel_size * ((size_t)(y) * (layer)->width + (x)))
+
+/**
+ * \brief           Case of \ref sw_dispatch for indexed layers, empty without \ref GUI_CFG_LCD_CLUT
+ * \param[in]       stmt: Statement to execute
+ */
+#if GUI_CFG_LCD_CLUT
+#define sw_dispatch_l8(stmt)        case 1:  { const uint8_t ps = 1; stmt; break; }
+#else /* GUI_CFG_LCD_CLUT */
+#define sw_dispatch_l8(stmt)
+#endif /* !GUI_CFG_LCD_CLUT */
+
+/**
+ * \brief           Execute statement specialized for pixel format of layer
+ *
+ *                  Statement uses constant `ps` as number of bytes per pixel,
+ *                  pixel helpers called with it are reduced to single format by compiler
+ *
+ * \param[in]       layer: Layer handle
+ * \param[in]       stmt: Statement to execute
+ */
+#define sw_dispatch(layer, stmt)    do {                        \
+    switch ((layer)->pixel_size) {                              \
+        sw_dispatch_l8(stmt)                                    \
+        case 2:  { const uint8_t ps = 2; stmt; break; }         \
+        case 3:  { const uint8_t ps = 3; stmt; break; }         \
+        default: { const uint8_t ps = 4; stmt; break; }         \
+    }                                                           \
+} while (0)
+
+/**
+ * \brief           Convert ARGB8888 color to pixel value of layer format
+ * \param[in]       color: Color to convert
+ * \param[in]       ps: Number of bytes per pixel
+ * \return          Pixel value, palette index for 1 byte and RGB565 for 2 bytes per pixel, otherwise color itself
+ */
+static uint32_t
+sw_color_to_pixel(gui_color_t color, uint8_t ps) {
+#if GUI_CFG_LCD_CLUT
+    if (ps == 1) {
+        return clut_lookup[clut_key(color)];
+    }
+#endif /* GUI_CFG_LCD_CLUT */
+    if (ps == 2) {
+        return ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+    }
+    return color;
+}
+
+/**
+ * \brief           Read pixel from memory and convert it to ARGB8888 color
+ * \param[in]       p: Pixel address
+ * \param[in]       ps: Number of bytes per pixel
+ * \return          Pixel color
+ */
+static gui_color_t
+sw_read_pixel(const uint8_t* p, uint8_t ps) {
+    uint32_t v;
+    
+    switch (ps) {
+#if GUI_CFG_LCD_CLUT
+        case 1:
+            return 0xFF000000UL | (*p < GUI.lcd.palette_size ? GUI.lcd.palette[*p] : 0);
+#endif /* GUI_CFG_LCD_CLUT */
+        case 2:
+            v = *(const uint16_t *)p;
+            return 0xFF000000UL | ((v & 0xF800) << 8) | ((v & 0xE000) << 3) |
+                ((v & 0x07E0) << 5) | ((v & 0x0600) >> 1) |
+                ((v & 0x001F) << 3) | ((v & 0x001C) >> 2);
+        case 3:
+            return 0xFF000000UL | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+        default:
+            return *(const uint32_t *)p;
+    }
+}
+
+/**
+ * \brief           Write pixel value to memory
+ * \param[in]       p: Pixel address
+ * \param[in]       v: Pixel value from \ref sw_color_to_pixel
+ * \param[in]       ps: Number of bytes per pixel
+ */
+static void
+sw_write_pixel(uint8_t* p, uint32_t v, uint8_t ps) {
+    switch (ps) {
+        case 1: *p = (uint8_t)v; break;
+        case 2: *(uint16_t *)p = (uint16_t)v; break;
+        case 3: p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); break;
+        default: *(uint32_t *)p = v; break;
+    }
+}
+
+/**
+ * \brief           Blend two ARGB8888 colors with integer arithmetic
+ * \note            Translucent background is composited by display controller with layer below,
+ *                  foreground is then put over it and coverage of result grows
+ * \param[in]       fg: Foreground color
+ * \param[in]       bg: Background color
+ * \param[in]       a: Foreground alpha, `0xFF` for foreground only
+ * \return          Blended color, opaque when background is opaque
+ */
+static gui_color_t
+sw_blend(gui_color_t fg, gui_color_t bg, uint8_t a) {
+    uint32_t rb, g, ba, oa;
+    
+    ba = bg >> 24;
+    oa = 0xFF;
+    if (ba != 0xFF) {
+        oa = a + (ba * (0xFF - a) + 0x7F) / 0xFF;   /* Alpha of foreground over background */
+        if (oa == 0) {
+            return bg;
+        }
+        a = (uint8_t)((a * 0xFF + (oa >> 1)) / oa); /* Share of foreground in resulting color */
+    }
+    
+#if GUI_CFG_LL_SOFTWARE_SIMD
+    /* Red with blue and green with alpha are halfword lanes, 0xFF * 0xFF + 0x80 fits single lane */
+    rb = __uxtb16(fg) * a + __uxtb16(bg) * (0xFF - a) + 0x00800080;
+    rb = __uxtb16(__ror(__uxtab16(rb, __ror(rb, 8)), 8));
+    g = __uxtb16(__ror(fg, 8)) * a + __uxtb16(__ror(bg, 8)) * (0xFF - a) + 0x00800080;
+    g = __uxtab16(g, __ror(g, 8)) & 0x0000FF00;
+#else /* GUI_CFG_LL_SOFTWARE_SIMD */
+    /* Red and blue channels are blended together, (x * a + 0x80) * 257 >> 16 is fast division by 255 */
+    rb = (fg & 0x00FF00FF) * a + (bg & 0x00FF00FF) * (0xFF - a) + 0x00800080;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+    g = (fg & 0x0000FF00) * a + (bg & 0x0000FF00) * (0xFF - a) + 0x00008000;
+    g = ((g + (g >> 8)) >> 8) & 0x0000FF00;
+#endif /* !GUI_CFG_LL_SOFTWARE_SIMD */
+    return (oa << 24) | rb | g;
+}
+
+/**
+ * \brief           Mix two ARGB8888 colors where both may be translucent
+ * \param[in]       fg: Foreground color
+ * \param[in]       bg: Background color
+ * \param[in]       a: Foreground weight, `0xFF` for foreground only
+ * \return          Mixed color, colors are weighted with their alpha
+ */
+static gui_color_t
+sw_mix(gui_color_t fg, gui_color_t bg, uint8_t a) {
+    uint32_t fa, ba, oa;
+    
+    fa = ((fg >> 24) * a + 0x7F) / 0xFF;
+    ba = ((bg >> 24) * (0xFF - a) + 0x7F) / 0xFF;
+    oa = fa + ba;
+    if (oa == 0) {
+        return 0;
+    }
+    fa = (fa * 0xFF + (oa >> 1)) / oa;              /* Share of foreground in resulting color */
+    return (oa << 24) | (sw_blend(fg | 0xFF000000UL, bg | 0xFF000000UL, (uint8_t)fa) & 0x00FFFFFFUL);
+}
+
+/**
+ * \brief           Blend color over pixel in memory
+ * \param[in]       p: Pixel address
+ * \param[in]       color: Foreground color
+ * \param[in]       v: Foreground color as pixel value, written when `a` is `0xFF`
+ * \param[in]       a: Foreground alpha
+ * \param[in]       ps: Number of bytes per pixel
+ */
+static void
+sw_blend_pixel(uint8_t* p, gui_color_t color, uint32_t v, uint8_t a, uint8_t ps) {
+    if (a == 0xFF) {
+        sw_write_pixel(p, v, ps);
+    } else if (a) {
+        sw_write_pixel(p, sw_color_to_pixel(sw_blend(color, sw_read_pixel(p, ps), a), ps), ps);
+    }
+}
+
+/**
+ * \brief           Fill horizontal span of pixels with single value
+ * \note            Memory is written with aligned 32-bit words where possible
+ * \param[in]       dst: Address of first pixel
+ * \param[in]       len: Number of pixels
+ * \param[in]       v: Pixel value from \ref sw_color_to_pixel
+ * \param[in]       ps: Number of bytes per pixel
+ */
+static void
+sw_fill_span(uint8_t* dst, gui_dim_t len, uint32_t v, uint8_t ps) {
+    uint32_t* d;
+    
+    if (len <= 0) {
+        return;
+    }
+    if (ps == 1) {
+        memset(dst, (int)v, (size_t)len);
+    } else if (ps == 2) {
+        if ((uintptr_t)dst & 0x02) {                /* Align to 32-bit word */
+            *(uint16_t *)dst = (uint16_t)v;
+            dst += 2;
+            len--;
+        }
+        v |= v << 16;                               /* Two pixels in single word */
+        d = (uint32_t *)dst;
+        for (; len >= 8; len -= 8, d += 4) {
+            d[0] = v; d[1] = v; d[2] = v; d[3] = v;
+        }
+        for (; len >= 2; len -= 2) {
+            *d++ = v;
+        }
+        if (len) {
+            *(uint16_t *)d = (uint16_t)v;
+        }
+    } else if (ps == 4) {
+        d = (uint32_t *)dst;
+        for (; len >= 4; len -= 4, d += 4) {
+            d[0] = v; d[1] = v; d[2] = v; d[3] = v;
+        }
+        while (len--) {
+            *d++ = v;
+        }
+    } else {
+        for (; len > 0; len--, dst += ps) {
+            sw_write_pixel(dst, v, ps);
+        }
+    }
+}
+
+/**
+ * \brief           Fill rectangle area of layer memory
+ * \param[in]       d: Address of first pixel
+ * \param[in]       xSize: Width of area in units of pixels
+ * \param[in]       ySize: Height of area in units of pixels
+ * \param[in]       offLine: Number of pixels between end of line and start of next line
+ * \param[in]       color: Fill color
+ * \param[in]       ps: Number of bytes per pixel
+ */
+static void
+sw_fill_area(uint8_t* d, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLine, gui_color_t color, uint8_t ps) {
+    uint32_t v = sw_color_to_pixel(color, ps);      /* Convert color once for complete area */
+    
+    for (; ySize > 0; ySize--, d += (xSize + offLine) * ps) {
+        sw_fill_span(d, xSize, v, ps);
+    }
+}
+
+/**
+ * \brief           Blend alpha mask with single color to layer memory
+ * \param[in]       s: Alpha mask with 8 bits per pixel
+ * \param[in]       d: Destination address
+ * \param[in]       xSize: Width of area in units of pixels
+ * \param[in]       ySize: Height of area in units of pixels
+ * \param[in]       offLineSrc: Number of mask bytes between end of line and start of next line
+ * \param[in]       offLineDst: Number of layer pixels between end of line and start of next line
+ * \param[in]       color: Color to blend
+ * \param[in]       ps: Number of bytes per pixel
+ */
+static void
+sw_blend_mask(const uint8_t* s, uint8_t* d, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst, gui_color_t color, uint8_t ps) {
+    uint32_t v = sw_color_to_pixel(color, ps), m;
+    gui_dim_t x;
+    
+    for (; ySize > 0; ySize--) {                    /* Blend mask row by row */
+        for (x = 0; x < xSize; ) {
+            /* Masks are mostly empty or fully covered, 4 aligned alpha bytes are checked at once */
+            if (!((uintptr_t)s & 0x03) && xSize - x >= 4) {
+                m = *(const uint32_t *)s;
+                if (m == 0 || m == 0xFFFFFFFFUL) {
+                    if (m) {
+                        sw_fill_span(d, 4, v, ps);
+                    }
+                    x += 4;
+                    s += 4;
+                    d += 4 * ps;
+                    continue;
+                }
+            }
+            sw_blend_pixel(d, color, v, *s, ps);
+            x++;
+            s++;
+            d += ps;
+        }
+        s += offLineSrc;
+        d += offLineDst * ps;
+    }
+}
+
+/**
+ * \brief           Blend area of layer memory over area of the same format with constant alpha
+ * \param[in]       s: Source address
+ * \param[in]       d: Destination address
+ * \param[in]       a: Source alpha
+ * \param[in]       xSize: Width of area in units of pixels
+ * \param[in]       ySize: Height of area in units of pixels
+ * \param[in]       offLineSrc: Number of source pixels between end of line and start of next line
+ * \param[in]       offLineDst: Number of destination pixels between end of line and start of next line
+ * \param[in]       ps: Number of bytes per pixel
+ */
+static void
+sw_blend_area(const uint8_t* s, uint8_t* d, uint8_t a, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst, uint8_t ps) {
+    gui_dim_t x;
+    gui_color_t c, b;
+    
+    for (; ySize > 0; ySize--) {
+        for (x = 0; x < xSize; x++, s += ps, d += ps) {
+            c = sw_read_pixel(s, ps);
+            b = sw_read_pixel(d, ps);
+            if (((c & b) >> 24) != 0xFF) {          /* Translucent pixels when layer has alpha channel */
+                sw_write_pixel(d, sw_color_to_pixel(sw_mix(c, b, a), ps), ps);
+            } else {
+                sw_write_pixel(d, sw_color_to_pixel(sw_blend(c, b, a), ps), ps);
+            }
+        }
+        s += offLineSrc * ps;
+        d += offLineDst * ps;
+    }
+}
+
+/**
+ * \brief           Blend area of layer memory over area of the same format with alpha mask
+ * \param[in]       s: Source address
+ * \param[in]       d: Destination address
+ * \param[in]       m: Mask address, one alpha byte per pixel
+ * \param[in]       a: Overall source alpha, multiplied with mask
+ * \param[in]       xSize: Width of area in units of pixels
+ * \param[in]       ySize: Height of area in units of pixels
+ * \param[in]       offLineSrc: Number of source pixels between end of line and start of next line
+ * \param[in]       offLineDst: Number of destination pixels between end of line and start of next line
+ * \param[in]       offLineMask: Number of mask bytes between end of line and start of next line
+ * \param[in]       ps: Number of bytes per pixel
+ */
+static void
+sw_blend_area_mask(const uint8_t* s, uint8_t* d, const uint8_t* m, uint8_t a, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst, gui_dim_t offLineMask, uint8_t ps) {
+    gui_dim_t x;
+    gui_color_t c, b;
+    uint32_t ma;
+    
+    for (; ySize > 0; ySize--) {
+        for (x = 0; x < xSize; x++, s += ps, d += ps, m++) {
+            ma = *m * a + 0x80;
+            ma = (ma + (ma >> 8)) >> 8;             /* Divide by 255 */
+            if (!ma) {
+                continue;                           /* Pixel stays as it is */
+            }
+            if (ma == 0xFF) {
+                memcpy(d, s, ps);
+                continue;
+            }
+            c = sw_read_pixel(s, ps);
+            b = sw_read_pixel(d, ps);
+            if (((c & b) >> 24) != 0xFF) {          /* Translucent pixels when layer has alpha channel */
+                sw_write_pixel(d, sw_color_to_pixel(sw_mix(c, b, (uint8_t)ma), ps), ps);
+            } else {
+                sw_write_pixel(d, sw_color_to_pixel(sw_blend(c, b, (uint8_t)ma), ps), ps);
+            }
+        }
+        s += offLineSrc * ps;
+        d += offLineDst * ps;
+        m += offLineMask;
+    }
+}
+
+static uint8_t
+sw_IsReady(gui_lcd_t* LCD) {
+    return 1;                                       /* CPU drawing is always finished */
+}
+
+static void
+sw_SetPixel(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_color_t color) {
+    sw_dispatch(layer, sw_write_pixel(sw_pixel_addr(layer, x, y), sw_color_to_pixel(color, ps), ps));
+}
+
+static gui_color_t
+sw_GetPixel(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y) {
+    return sw_read_pixel(sw_pixel_addr(layer, x, y), layer->pixel_size);
+}
+
+static void
+sw_Fill(gui_lcd_t* LCD, gui_layer_t* layer, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLine, gui_color_t color) {
+    uint8_t* d = dst != NULL ? dst : (uint8_t *)layer->start_address;
+    
+    sw_dispatch(layer, sw_fill_area(d, xSize, ySize, offLine, color, ps));
+}
+
+static void
+sw_FillRect(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color) {
+    sw_Fill(LCD, layer, sw_pixel_addr(layer, x, y), width, height, layer->width - width, color);
+}
+
+static void
+sw_DrawHLine(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t length, gui_color_t color) {
+    sw_dispatch(layer, sw_fill_span(sw_pixel_addr(layer, x, y), length, sw_color_to_pixel(color, ps), ps));
+}
+
+static void
+sw_DrawVLine(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t length, gui_color_t color) {
+    sw_Fill(LCD, layer, sw_pixel_addr(layer, x, y), 1, length, layer->width - 1, color);
+}
+
+static void
+sw_Copy(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    const uint8_t* s = src;
+    uint8_t* d = dst;
+    
+    for (; ySize > 0; ySize--) {
+        memmove(d, s, xSize * layer->pixel_size);   /* Areas may overlap when scrolling */
+        s += (xSize + offLineSrc) * layer->pixel_size;
+        d += (xSize + offLineDst) * layer->pixel_size;
+    }
+}
+
+static void
+sw_CopyBlend(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, uint8_t alphaSrc, uint8_t alphaDst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    GUI_UNUSED(alphaDst);
+    sw_dispatch(layer, sw_blend_area(src, dst, alphaSrc, xSize, ySize, offLineSrc, offLineDst, ps));
+}
+
+static void
+sw_CopyMask(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, const uint8_t* mask, uint8_t alpha, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst, gui_dim_t offLineMask) {
+    sw_dispatch(layer, sw_blend_area_mask(src, dst, mask, alpha, xSize, ySize, offLineSrc, offLineDst, offLineMask, ps));
+}
+
+static void
+sw_CopyChar(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst, gui_color_t color) {
+    sw_dispatch(layer, sw_blend_mask(src, dst, xSize, ySize, offLineSrc, offLineDst, color, ps));
+}
+
+static void
+sw_BlendHLine(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t length, const uint8_t* alpha, gui_color_t color) {
+    guii_ll_waitready();                            /* Hardware may still draw to the same memory */
+    sw_dispatch(layer, sw_blend_mask(alpha, sw_pixel_addr(layer, x, y), length, 1, 0, 0, color, ps));
+}
+
+/**
+ * \brief           Read image pixel and convert it to ARGB8888 color
+ * \note            Image formats match DMA2D input with red and blue swapped,
+ *                  32-bit images have inverted alpha where `0x00` is fully opaque
+ * \param[in]       p: Pixel address
+ * \param[in]       bytes: Number of bytes per image pixel
+ * \return          Pixel color
+ */
+static gui_color_t
+sw_read_image_pixel(const uint8_t* p, uint8_t bytes) {
+    uint32_t v;
+    
+    switch (bytes) {
+        case 2:
+            v = *(const uint16_t *)p;
+            return 0xFF000000UL | ((v & 0x001F) << 19) | ((v & 0x001C) << 14) |
+                ((v & 0x07E0) << 5) | ((v & 0x0600) >> 1) |
+                ((v & 0xF800) >> 8) | ((v & 0xE000) >> 13);
+        case 3:
+            return 0xFF000000UL | ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+        default:
+            v = *(const uint32_t *)p;
+            return ((~v) & 0xFF000000UL) | ((v & 0xFF) << 16) | (v & 0xFF00) | ((v >> 16) & 0xFF);
+    }
+}
+
+/**
+ * \brief           Draw direct color image with alpha blending
+ * \param[in]       src: Source image address
+ * \param[in]       dst: Destination address in layer
+ * \param[in]       bytes: Number of bytes per image pixel
+ * \param[in]       xSize: Width of area in units of pixels
+ * \param[in]       ySize: Height of area in units of pixels
+ * \param[in]       offLineSrc: Number of image pixels between end of line and start of next line
+ * \param[in]       offLineDst: Number of layer pixels between end of line and start of next line
+ * \param[in]       ps: Number of bytes per layer pixel
+ */
+static void
+sw_draw_image(const uint8_t* src, uint8_t* dst, uint8_t bytes, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst, uint8_t ps) {
+    gui_color_t c;
+    gui_dim_t x;
+    
+    for (; ySize > 0; ySize--) {
+        for (x = 0; x < xSize; x++, src += bytes, dst += ps) {
+            c = sw_read_image_pixel(src, bytes);
+            sw_blend_pixel(dst, c, sw_color_to_pixel(c, ps), (uint8_t)(c >> 24), ps);
+        }
+        src += offLineSrc * bytes;
+        dst += offLineDst * ps;
+    }
+}
+
+static void
+sw_DrawImage16(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    sw_dispatch(layer, sw_draw_image(src, dst, 2, xSize, ySize, offLineSrc, offLineDst, ps));
+}
+
+static void
+sw_DrawImage24(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    sw_dispatch(layer, sw_draw_image(src, dst, 3, xSize, ySize, offLineSrc, offLineDst, ps));
+}
+
+static void
+sw_DrawImage32(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    sw_dispatch(layer, sw_draw_image(src, dst, 4, xSize, ySize, offLineSrc, offLineDst, ps));
+}
+
+/**
+ * \brief           Set software drawing functions for all functions low-level driver does not implement
+ * \note            Software functions access layer memory directly with CPU.
+ *                  Each layer may use own format, supported are 1 (L8 with \ref GUI_CFG_LCD_CLUT), 2 (RGB565),
+ *                  3 (RGB888) and 4 (ARGB8888) bytes per pixel
+ * \param[in,out]   ll: Low-level structure filled by driver
+ */
+void
+guii_lcd_setsoftwaredrawing(gui_ll_t* ll) {
+    if (ll->IsReady == NULL)    { ll->IsReady = sw_IsReady; }
+    if (ll->SetPixel == NULL)   { ll->SetPixel = sw_SetPixel; }
+    if (ll->GetPixel == NULL)   { ll->GetPixel = sw_GetPixel; }
+    if (ll->Fill == NULL)       { ll->Fill = sw_Fill; }
+    if (ll->FillRect == NULL)   { ll->FillRect = sw_FillRect; }
+    if (ll->DrawHLine == NULL)  { ll->DrawHLine = sw_DrawHLine; }
+    if (ll->DrawVLine == NULL)  { ll->DrawVLine = sw_DrawVLine; }
+    if (ll->Copy == NULL)       { ll->Copy = sw_Copy; }
+    if (ll->CopyBlend == NULL)  { ll->CopyBlend = sw_CopyBlend; }
+    if (ll->CopyMask == NULL)   { ll->CopyMask = sw_CopyMask; }
+    if (ll->BlendHLine == NULL) { ll->BlendHLine = sw_BlendHLine; }
+    if (ll->DrawImage16 == NULL) { ll->DrawImage16 = sw_DrawImage16; }
+    if (ll->DrawImage24 == NULL) { ll->DrawImage24 = sw_DrawImage24; }
+    if (ll->DrawImage32 == NULL) { ll->DrawImage32 = sw_DrawImage32; }
+    if (ll->CopyChar == NULL) {                     /* Software function expects 8-bit alpha */
+        ll->CopyChar = sw_CopyChar;
+        GUI.lcd.flags &= ~GUI_FLAG_LCD_CHAR_A4;
+    }
+}
+
+#endif /* GUI_CFG_LL_SOFTWARE || __DOXYGEN__ */
@@ -32,6 +32,14 @@
 #include "gui/gui_private.h"
 #include "gui/gui_linkedlist.h"
 
+#define LL_NULL                     ((gui_linkedlist_link_t)0)
+#define LL_PREV(e)                  ((gui_linkedlist_t *)GUI_LINKEDLIST_PTR((e)->prev))
+#define LL_NEXT(e)                  ((gui_linkedlist_t *)GUI_LINKEDLIST_PTR((e)->next))
+
+#if GUI_CFG_LINKEDLIST_COMPACT || __DOXYGEN__
+size_t guii_linkedlist_base;                        /* Address of object with link 0, set when memory is assigned */
+#endif /* GUI_CFG_LINKEDLIST_COMPACT || __DOXYGEN__ */
+
 /**
  * \brief           Print linked list from root element
  * \param[in]       root: Root linked list element
@@ -48,7 +56,7 @@ print_list(gui_handle_root_t* root) {
     } else {
         list = &GUI.root;
     }
-    for (h = (gui_handle_root_t *)list->first; h != NULL; h = h->handle.list.next) {
+    for (h = (gui_handle_root_t *)list->first; h != NULL; h = GUI_LINKEDLIST_PTR(h->handle.list.next)) {
         GUI_DEBUG("%*d: W: %s; A: 0x%p, R: %lu; D: %lu\r\n",
             depth, depth,
             (const char *)h->handle.widget->name,
@@ -75,14 +83,14 @@ print_list(gui_handle_root_t* root) {
 void
 gui_linkedlist_add_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element) {
     if (root->first == NULL || root->last == NULL) {/* First widget is about to be created */
-        element->prev = NULL;                       /* There is no previous element */
-        element->next = NULL;                       /* There is no next element */
+        element->prev = LL_NULL;                    /* There is no previous element */
+        element->next = LL_NULL;                    /* There is no next element */
         root->first = element;                      /* Set as first widget */
         root->last = element;                       /* Set as last widget */
     } else {
-        element->next = NULL;                       /* Next element of last is not known */
-        element->prev = root->last;                 /* Previous element of new entry is currently last element */
-        ((gui_linkedlist_t *)root->last)->next = element;   /* Previous's element next element is current element */
+        element->next = LL_NULL;                    /* Next element of last is not known */
+        element->prev = GUI_LINKEDLIST_LINK(root->last); /* Previous element of new entry is currently last element */
+        ((gui_linkedlist_t *)root->last)->next = GUI_LINKEDLIST_LINK(element); /* Previous's element next element is current element */
         root->last = element;                       /* Add new element as last */
     }
 }
@@ -104,14 +112,14 @@ gui_linkedlist_remove_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element)
         return 0;
     }
 
-    prev = element->prev;                           /* Get previous element of current */
-    next = element->next;                           /* Get next element of current */
+    prev = LL_PREV(element);                        /* Get previous element of current */
+    next = LL_NEXT(element);                        /* Get next element of current */
     
     if (prev != NULL) {                             /* If current element has previous elemnet */
-        prev->next = next;                          /* Set new next element to previous element */
+        prev->next = GUI_LINKEDLIST_LINK(next);     /* Set new next element to previous element */
     }
     if (next != NULL) {                             /* If current element has next element */
-        next->prev = prev;                          /* Set new previous element to next element */
+        next->prev = GUI_LINKEDLIST_LINK(prev);     /* Set new previous element to next element */
     }
     if (root->first == element) {                   /* If current is the same as first */
         root->first = next;                         /* Set next element as first */
@@ -120,8 +128,8 @@ gui_linkedlist_remove_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element)
         root->last = prev;                          /* Set previous as last element */
     }
     
-    element->prev = NULL;                           /*!< Clear element pointer */
-    element->next = NULL;                           /*!< Clear element pointer */
+    element->prev = LL_NULL;                        /*!< Clear element pointer */
+    element->next = LL_NULL;                        /*!< Clear element pointer */
     return element;
 }
 
@@ -151,7 +159,7 @@ gui_linkedlist_getnext_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element
             return NULL;
         }
     }
-    return element->next;                           /* Get next widget of current in linked list */
+    return LL_NEXT(element);                        /* Get next widget of current in linked list */
 }
 
 /**
@@ -180,7 +188,7 @@ gui_linkedlist_getprev_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element
             return NULL;
         }
     }
-    return element->prev;                           /* Get next widget of current in linked list */
+    return LL_PREV(element);                        /* Get next widget of current in linked list */
 }
 
 /**
@@ -201,28 +209,28 @@ gui_linkedlist_movedown_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* elemen
         return 0;                                   /* Could not move */
     }
     
-    Prev = element->prev;                           /* Get previous element */
-    Next = element->next;                           /* Get next element */
+    Prev = LL_PREV(element);                        /* Get previous element */
+    Next = LL_NEXT(element);                        /* Get next element */
     if (Next) {                                     /* Check if next is available */
-        NextNext = Next->next;                      /* Get next element of next element */
+        NextNext = LL_NEXT(Next);                   /* Get next element of next element */
     }
     
     if (NextNext != NULL) {                         /* If there is available memory */
-        NextNext->prev = element;                   /* Previous element of next next element is current element */
+        NextNext->prev = GUI_LINKEDLIST_LINK(element); /* Previous element of next next element is current element */
     } else {
         root->last = element;                       /* There is no next next element so we will be last element after move */
     }
     
     if (Next != NULL) {                             /* If there is next element */
-        Next->next = element;                       /* Next element will become previous and set next element as current */
-        Next->prev = Prev;                          /* Set previous element to next element as current previous */
+        Next->next = GUI_LINKEDLIST_LINK(element);  /* Next element will become previous and set next element as current */
+        Next->prev = GUI_LINKEDLIST_LINK(Prev);     /* Set previous element to next element as current previous */
     }
     
-    element->next = NextNext;                       /* Set next next element to current next element */
-    element->prev = Next;                           /* Set next element as previous (swap current and next elements) */
+    element->next = GUI_LINKEDLIST_LINK(NextNext);  /* Set next next element to current next element */
+    element->prev = GUI_LINKEDLIST_LINK(Next);      /* Set next element as previous (swap current and next elements) */
     
     if (Prev != NULL) {                             /* Check if next exists */
-        Prev->next = Next;                          /* Set previous element to next */
+        Prev->next = GUI_LINKEDLIST_LINK(Next);     /* Set previous element to next */
     }
     
     if (root->first == element) {                   /* Check for current element */
@@ -250,28 +258,28 @@ gui_linkedlist_moveup_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element)
         return 0;                                   /* Could not move */
     }
     
-    Prev = element->prev;                           /* Get previous element */
-    Next = element->next;                           /* Get next element */
+    Prev = LL_PREV(element);                        /* Get previous element */
+    Next = LL_NEXT(element);                        /* Get next element */
     if (Prev != NULL) {                             /* Check if previous is available */
-        PrevPrev = Prev->prev;                      /* Get previous element of previous element */
+        PrevPrev = LL_PREV(Prev);                   /* Get previous element of previous element */
     }
     
     if (PrevPrev != NULL) {                         /* If there is available memory */
-        PrevPrev->next = element;                   /* Next element of previous previous element is current element */
+        PrevPrev->next = GUI_LINKEDLIST_LINK(element); /* Next element of previous previous element is current element */
     } else {
         root->first = element;                      /* There is no previous previous element so we will be first element after move */
     }
     
     if (Prev != NULL) {                             /* If there is previous element */
-        Prev->prev = element;                       /* Previous element will become next and set previous element as current */
-        Prev->next = Next;                          /* Set next element to previous element as current previous */
+        Prev->prev = GUI_LINKEDLIST_LINK(element);  /* Previous element will become next and set previous element as current */
+        Prev->next = GUI_LINKEDLIST_LINK(Next);     /* Set next element to previous element as current previous */
     }
     
-    element->prev = PrevPrev;                       /* Set previous previous element to current previous element */
-    element->next = Prev;                           /* Set previous element as next (swap current and previous elements) */
+    element->prev = GUI_LINKEDLIST_LINK(PrevPrev);  /* Set previous previous element to current previous element */
+    element->next = GUI_LINKEDLIST_LINK(Prev);      /* Set previous element as next (swap current and previous elements) */
     
     if (Next != NULL) {                             /* Check if previous exists */
-        Next->prev = Prev;                          /* Set next element to previous */
+        Next->prev = GUI_LINKEDLIST_LINK(Prev);     /* Set next element to previous */
     }
     
     if (root->last == element) {                    /* Check for current element */
@@ -297,6 +305,119 @@ gui_linkedlist_getnext_byindex_gen(gui_linkedlistroot_t* root, uint16_t index) {
     return item;                                    /* Get that item */
 }
 
+/**
+ * \brief           Make sure index has memory for marks of requested number of elements
+ * \param[in,out]   idx: Linked list index
+ * \param[in]       count: Number of elements in list
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+index_reserve(gui_linkedlist_index_t* idx, size_t count) {
+    gui_linkedlist_t** marks;
+    size_t size;
+    
+    size = (count + GUI_CFG_LINKEDLIST_INDEX_STRIDE - 1) / GUI_CFG_LINKEDLIST_INDEX_STRIDE;
+    if (size <= idx->marks_size) {
+        return 1;
+    }
+    size = GUI_MAX(size, 2 * idx->marks_size);      /* Grow in bigger steps */
+    marks = GUI_MEMREALLOC(idx->marks, sizeof(*marks) * size);
+    if (marks == NULL) {
+        return 0;
+    }
+    idx->marks = marks;
+    idx->marks_size = size;
+    return 1;
+}
+
+/**
+ * \brief           Get item from linked list by index using index of list
+ * \note            Index is built again on first call after \ref gui_linkedlist_index_invalidate.
+ *                  Later calls walk at most \ref GUI_CFG_LINKEDLIST_INDEX_STRIDE elements
+ *
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       root: Pointer to \ref gui_linkedlistroot_t structure as base element
+ * \param[in,out]   idx: Index of linked list
+ * \param[in]       index: Number in list to get item
+ * \return          Item handle on success, NULL otherwise
+ * \sa              gui_linkedlist_getnext_byindex_gen
+ */
+gui_linkedlist_t *
+gui_linkedlist_index_get(gui_linkedlistroot_t* root, gui_linkedlist_index_t* idx, size_t index) {
+    gui_linkedlist_t* item;
+    size_t i;
+    
+    if (!idx->valid) {                              /* Build index again */
+        for (i = 0, item = root->first; item != NULL; item = LL_NEXT(item), i++) {}
+        if (!index_reserve(idx, i)) {               /* No memory for index */
+            return index <= 0xFFFF ? gui_linkedlist_getnext_byindex_gen(root, (uint16_t)index) : NULL;
+        }
+        idx->count = i;
+        for (i = 0, item = root->first; item != NULL; item = LL_NEXT(item), i++) {
+            if (!(i % GUI_CFG_LINKEDLIST_INDEX_STRIDE)) {
+                idx->marks[i / GUI_CFG_LINKEDLIST_INDEX_STRIDE] = item;
+            }
+        }
+        idx->valid = 1;
+    }
+    if (index >= idx->count) {
+        return NULL;
+    }
+    item = idx->marks[index / GUI_CFG_LINKEDLIST_INDEX_STRIDE]; /* Get nearest marked element */
+    for (i = index % GUI_CFG_LINKEDLIST_INDEX_STRIDE; i; i--) {
+        item = LL_NEXT(item);
+    }
+    return item;
+}
+
+/**
+ * \brief           Update index after element was added to the end of linked list
+ * \note            Use \ref gui_linkedlist_index_invalidate after any other change of list
+ *
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   idx: Index of linked list
+ * \param[in]       element: Element added with \ref gui_linkedlist_add_gen
+ */
+void
+gui_linkedlist_index_add(gui_linkedlist_index_t* idx, gui_linkedlist_t* element) {
+    if (!idx->valid) {                              /* Index is built on next use */
+        return;
+    }
+    if (!index_reserve(idx, idx->count + 1)) {
+        idx->valid = 0;
+        return;
+    }
+    if (!(idx->count % GUI_CFG_LINKEDLIST_INDEX_STRIDE)) {
+        idx->marks[idx->count / GUI_CFG_LINKEDLIST_INDEX_STRIDE] = element;
+    }
+    idx->count++;
+}
+
+/**
+ * \brief           Invalidate index after linked list has changed
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   idx: Index of linked list
+ */
+void
+gui_linkedlist_index_invalidate(gui_linkedlist_index_t* idx) {
+    idx->valid = 0;
+}
+
+/**
+ * \brief           Free memory used by index of linked list
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   idx: Index of linked list
+ */
+void
+gui_linkedlist_index_free(gui_linkedlist_index_t* idx) {
+    if (idx->marks != NULL) {
+        GUI_MEMFREE(idx->marks);
+    }
+    idx->marks_size = 0;
+    idx->count = 0;
+    idx->valid = 0;
+}
+
 /**
  * \brief           Add element to multi linked list
  * \note            Element can be any type since \ref gui_linkedlistmulti_t structure is dynamicall allocated
@@ -363,7 +484,7 @@ gui_linkedlist_multi_getnext_gen(gui_linkedlistroot_t* root, gui_linkedlistmulti
             return NULL;
         }
     }
-    return (gui_linkedlistmulti_t *)element->list.next; /* Get next widget of current in linked list */
+    return (gui_linkedlistmulti_t *)LL_NEXT(&element->list);  /* Get next widget of current in linked list */
 }
 
 /**
@@ -392,7 +513,7 @@ gui_linkedlist_multi_getprev_gen(gui_linkedlistroot_t* root, gui_linkedlistmulti
             return NULL;
         }
     }
-    return (gui_linkedlistmulti_t *)element->list.prev; /* Get next widget of current in linked list */
+    return (gui_linkedlistmulti_t *)LL_PREV(&element->list);  /* Get next widget of current in linked list */
 }
 
 /**
@@ -464,6 +585,7 @@ gui_linkedlist_widgetadd(gui_handle_root_t* root, gui_handle_p h) {
     }
     gui_linkedlist_widgetmovetotop(h);              /* Reset by moving to top */
     gui_linkedlist_widgetmovetobottom(h);           /* Reset by moving to bottom with reorder */
+    guii_widget_treechanged();                      /* Widget tree has changed */
 }
 
 /**
@@ -479,6 +601,7 @@ gui_linkedlist_widgetremove(gui_handle_p h) {
     } else {
         gui_linkedlist_remove_gen(&GUI.root, (gui_linkedlist_t *)h);
     }
+    guii_widget_treechanged();                      /* Widget tree has changed */
 }
 
 /**
@@ -490,10 +613,16 @@ gui_linkedlist_widgetremove(gui_handle_p h) {
  */
 uint8_t
 gui_linkedlist_widgetmoveup(gui_handle_p h) {
+    uint8_t ret;
     if (guii_widget_hasparent(h)) {
-        return gui_linkedlist_moveup_gen(&__GHR(guii_widget_getparent(h))->root_list, (gui_linkedlist_t *)h);
+        ret = gui_linkedlist_moveup_gen(&__GHR(guii_widget_getparent(h))->root_list, (gui_linkedlist_t *)h);
+    } else {
+        ret = gui_linkedlist_moveup_gen(&GUI.root, (gui_linkedlist_t *)h);
+    }
+    if (ret) {
+        guii_widget_treechanged();                  /* Widget order has changed */
     }
-    return gui_linkedlist_moveup_gen(&GUI.root, (gui_linkedlist_t *)h);
+    return ret;
 }
 
 /**
@@ -505,10 +634,16 @@ gui_linkedlist_widgetmoveup(gui_handle_p h) {
  */
 uint8_t
 gui_linkedlist_widgetmovedown(gui_handle_p h) {
+    uint8_t ret;
     if (guii_widget_hasparent(h)) {
-        return gui_linkedlist_movedown_gen(&__GHR(guii_widget_getparent(h))->root_list, (gui_linkedlist_t *)h);
+        ret = gui_linkedlist_movedown_gen(&__GHR(guii_widget_getparent(h))->root_list, (gui_linkedlist_t *)h);
+    } else {
+        ret = gui_linkedlist_movedown_gen(&GUI.root, (gui_linkedlist_t *)h);
+    }
+    if (ret) {
+        guii_widget_treechanged();                  /* Widget order has changed */
     }
-    return gui_linkedlist_movedown_gen(&GUI.root, (gui_linkedlist_t *)h);
+    return ret;
 }
 
 /**
@@ -540,7 +675,7 @@ gui_linkedlist_widgetgetnext(gui_handle_root_t* parent, gui_handle_p h) {
             return (gui_handle_p)GUI.root.first;    /* Get first widget in GUI */
         }
     }
-    return (gui_handle_p)h->list.next;              /* Get next widget of current in linked list */
+    return (gui_handle_p)LL_NEXT(&h->list);         /* Get next widget of current in linked list */
 }
 
 /**
@@ -572,7 +707,7 @@ gui_linkedlist_widgetgetprev(gui_handle_root_t* parent, gui_handle_p h) {
             return (gui_handle_p)GUI.root.last;     /* Get last widget in GUI */
         }
     }
-    return (gui_handle_p)h->list.prev;      /* Get next widget of current in linked list */
+    return (gui_handle_p)LL_PREV(&h->list);         /* Get next widget of current in linked list */
 }
 
 /*
@@ -583,104 +718,131 @@ gui_linkedlist_widgetgetprev(gui_handle_root_t* parent, gui_handle_p h) {
  * 3. Widgets as dialog base elements
  */
 
+/**
+ * \brief           Get linked list widget belongs to
+ * \param[in]       h: Widget handle
+ * \return          Linked list root of parent widget or root of GUI
+ */
+static gui_linkedlistroot_t *
+widget_list(gui_handle_p h) {
+    if (guii_widget_hasparent(h)) {
+        return &__GHR(guii_widget_getparent(h))->root_list;
+    }
+    return &GUI.root;
+}
+
+/**
+ * \brief           Compare position of 2 widgets according to linked list order
+ * \note            Dialog base elements are always equal between each other, z-index is not used for them
+ * \param[in]       h1: First widget handle
+ * \param[in]       h2: Second widget handle
+ * \return          Negative value when `h1` belongs before `h2`, positive when after and `0` when order is not defined
+ */
+static int32_t
+widget_order_cmp(gui_handle_p h1, gui_handle_p h2) {
+    uint8_t c1, c2;
+    
+    c1 = guii_widget_isdialogbase(h1) ? 2 : (guii_widget_allowchildren(h1) ? 1 : 0);
+    c2 = guii_widget_isdialogbase(h2) ? 2 : (guii_widget_allowchildren(h2) ? 1 : 0);
+    if (c1 != c2) {
+        return (int32_t)c1 - (int32_t)c2;
+    }
+    if (c1 == 2 || h1->zindex == h2->zindex) {
+        return 0;
+    }
+    return h1->zindex < h2->zindex ? -1 : 1;
+}
+
+/**
+ * \brief           Move widget to new position in its linked list with single unlink and relink
+ * \param[in]       root: Linked list root widget belongs to
+ * \param[in]       h: Widget handle to move
+ * \param[in]       prev: Widget to put moved widget after or `NULL` to put it to the beginning of list
+ */
+static void
+widget_relink(gui_linkedlistroot_t* root, gui_handle_p h, gui_handle_p prev) {
+    gui_linkedlist_t* e = (gui_linkedlist_t *)h;
+    gui_linkedlist_t* p = (gui_linkedlist_t *)prev;
+    
+    gui_linkedlist_remove_gen(root, e);             /* Unlink from current position */
+    e->prev = GUI_LINKEDLIST_LINK(p);
+    e->next = GUI_LINKEDLIST_LINK(p != NULL ? LL_NEXT(p) : root->first);
+    if (e->next) {
+        LL_NEXT(e)->prev = GUI_LINKEDLIST_LINK(e);
+    } else {
+        root->last = e;
+    }
+    if (p != NULL) {
+        p->next = GUI_LINKEDLIST_LINK(e);
+    } else {
+        root->first = e;
+    }
+    guii_widget_treechanged();                      /* Widget order has changed */
+}
+
 /**
  * \brief           Move widget to bottom in linked list of parent widget
+ * \note            Widget is moved after all widgets which are allowed to be below it.
+ *                  List is searched from its end, so bringing widget to the front
+ *                  only checks widgets which must stay above it, such as dialogs
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
  * \param[in]       h: Widget to move to bottom
- * \return          Number of moves on linked list, `0` if move not available
+ * \return          `1` if widget was moved, `0` if move not available
  * \sa              gui_linkedlist_widgetmovetotop
  */
 uint8_t
 gui_linkedlist_widgetmovetobottom(gui_handle_p h) {
-    uint32_t cnt = 0;
-    if (h->list.next == NULL) {
+    gui_linkedlistroot_t* root;
+    gui_handle_p t;
+    
+    if (!h->list.next || widget_order_cmp(h, (gui_handle_p)LL_NEXT(&h->list)) < 0) {
+        return 0;                                   /* Already on its place */
+    }
+#if GUI_CFG_WIDGET_LAYOUT
+    if (h->parent != NULL && h->parent->layout.type != GUI_LAYOUT_NONE) {
+        return 0;                                   /* Order defines placement in layout, children never overlap */
+    }
+#endif /* GUI_CFG_WIDGET_LAYOUT */
+    root = widget_list(h);
+    for (t = (gui_handle_p)root->last; t != h && widget_order_cmp(t, h) > 0;
+        t = (gui_handle_p)LL_PREV(&t->list)) {}     /* Find last widget allowed below */
+    if (t == h) {
         return 0;
     }
-    while (h->list.next != NULL) {                  /* While device has next element */
-        if (guii_widget_isdialogbase(h)) {          /* Widget is dialog base element */
-            if (!gui_linkedlist_widgetmovedown(h)) {/* Move down */
-                break;
-            }
-            cnt++;
-        } else if (guii_widget_allowchildren(h)) { /* Widget supports children widgets, go to the end of the list if necessary */
-            if (!guii_widget_isdialogbase(h->list.next)) { /* Go down till dialog base is reached */
-                if (h->zindex >= __GH(h->list.next)->zindex) {  /* Check if z-index allows move */
-                    if (!gui_linkedlist_widgetmovedown(h)) {/* Move down */
-                        break;
-                    }
-                    cnt++;
-                } else {
-                    break;
-                }
-            } else {
-                break;
-            }
-        } else {                                    /* Our widget does not allow sub widgets */
-            if (!guii_widget_allowchildren(h->list.next)) {  /* Allow moving down only if next widget does not allow sub widgets */
-                if (h->zindex >= __GH(h->list.next)->zindex) {  /* Check if z-index allows move */
-                    if (!gui_linkedlist_widgetmovedown(h)) {/* Move down */
-                        break;
-                    }
-                    cnt++;
-                } else {
-                    break;
-                }
-            } else {
-                break;
-            }
-        }
-    }
-    return cnt;
+    widget_relink(root, h, t);                      /* Put widget after it */
+    return 1;
 }
 
 /**
  * \brief           Move widget to top in linked list of parent widget
+ * \note            Widget is moved before all widgets which are allowed to be above it.
+ *                  List is searched from its beginning, so only widgets which must stay below it are checked
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
  * \param[in]       h: Widget to move to top
- * \return          Number of moves on linked list, `0` if move not available
+ * \return          `1` if widget was moved, `0` if move not available
  * \sa              gui_linkedlist_widgetmovetobottom
  */
 uint8_t
 gui_linkedlist_widgetmovetotop(gui_handle_p h) {
-    uint32_t cnt;
-    if (h->list.prev == NULL) {
+    gui_linkedlistroot_t* root;
+    gui_handle_p t;
+    
+    if (!h->list.prev || widget_order_cmp(h, (gui_handle_p)LL_PREV(&h->list)) > 0) {
+        return 0;                                   /* Already on its place */
+    }
+#if GUI_CFG_WIDGET_LAYOUT
+    if (h->parent != NULL && h->parent->layout.type != GUI_LAYOUT_NONE) {
+        return 0;                                   /* Order defines placement in layout, children never overlap */
+    }
+#endif /* GUI_CFG_WIDGET_LAYOUT */
+    root = widget_list(h);
+    for (t = (gui_handle_p)root->first; t != h && widget_order_cmp(t, h) < 0;
+        t = (gui_handle_p)LL_NEXT(&t->list)) {}     /* Find first widget allowed above */
+    if (t == h) {
         return 0;
     }
-    while (h->list.prev != NULL) {                  /* While device has previous element */
-        if (guii_widget_isdialogbase(h)) {          /* Widget is dialog base element */
-            if (guii_widget_isdialogbase(h->list.prev)) {   /* If previous widget is dialog base too */
-                if (!gui_linkedlist_widgetmoveup(h)) {  /* Move up widget */
-                    break;
-                }
-                cnt++;
-            } else {
-                break;                              /* Stop execution */
-            }
-        } else if (guii_widget_allowchildren(h)) {  /* If moving widget allows children elements */
-            if (guii_widget_allowchildren(h->list.prev)) {  /* If previous widget allows children too */
-                if (h->zindex <= __GH(h->list.prev)->zindex) {  /* Check if z-index allows move */
-                    if (!gui_linkedlist_widgetmoveup(h)) {  /* Move up */
-                        break;
-                    }
-                    cnt++;
-                } else {
-                    break;
-                }
-            } else {
-                break;                              /* Stop execution */
-            }
-        } else {                                    /* Normal widget */
-            if (h->zindex <= __GH(h->list.prev)->zindex) {  /* Check if z-index allows move */
-                if (!gui_linkedlist_widgetmoveup(h)) {  /* Move up */
-                    break;
-                }
-                cnt++;
-            } else {
-                break;
-            }
-        }
-    }
-    return cnt;
+    widget_relink(root, h, (gui_handle_p)LL_PREV(&t->list));   /* Put widget before it */
+    return 1;
 }
 
 /**
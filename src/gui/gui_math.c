@@ -31,6 +31,21 @@
 #define GUI_INTERNAL
 #include "gui/gui_math.h"
 
+/* Sine of angles from 0 to 90 degrees in 1 degree steps, Q15 format */
+static const int16_t
+sin_lut[91] = {
+        0,   572,  1144,  1715,  2286,  2856,  3425,  3993,  4560,  5126,
+     5690,  6252,  6813,  7371,  7927,  8481,  9032,  9580, 10126, 10668,
+    11207, 11743, 12275, 12803, 13328, 13848, 14364, 14876, 15383, 15886,
+    16383, 16876, 17364, 17846, 18323, 18794, 19260, 19720, 20173, 20621,
+    21062, 21497, 21925, 22347, 22762, 23170, 23571, 23964, 24351, 24730,
+    25101, 25465, 25821, 26169, 26509, 26841, 27165, 27481, 27788, 28087,
+    28377, 28659, 28932, 29196, 29451, 29697, 29934, 30162, 30381, 30591,
+    30791, 30982, 31163, 31335, 31498, 31650, 31794, 31927, 32051, 32165,
+    32269, 32364, 32448, 32523, 32587, 32642, 32687, 32722, 32747, 32762,
+    32767
+};
+
 /**
  * \brief           Calculate square of input value
  *
@@ -116,3 +131,48 @@ gui_math_centerofxy(float x1, float y1, float x2, float y2, float* resultx, floa
     
     return 1;
 }
+
+/**
+ * \brief           Calculate sine of angle with fixed-point math
+ *
+ *                  Value is interpolated from table of sine values in 1 degree steps,
+ *                  maximal error is below `0.0001`
+ *
+ * \param[in]       angle: Angle in units of `0.1` degree, any positive or negative value
+ * \return          Sine of angle in Q15 format, between `-32767` and `32767`
+ * \sa              gui_math_cos
+ */
+int16_t
+gui_math_sin(int32_t angle) {
+    int32_t a, i, f, v;
+    
+    a = angle % 3600;                               /* Normalize to single turn */
+    if (a < 0) {
+        a += 3600;
+    }
+    if (a >= 1800) {                                /* Second half of turn is negative */
+        v = -gui_math_sin(a - 1800);
+        return (int16_t)v;
+    }
+    if (a > 900) {                                  /* Second quadrant mirrors first one */
+        a = 1800 - a;
+    }
+    i = a / 10;
+    f = a % 10;
+    v = sin_lut[i];
+    if (f) {                                        /* Interpolate between table entries */
+        v += ((sin_lut[i + 1] - v) * f + 5) / 10;
+    }
+    return (int16_t)v;
+}
+
+/**
+ * \brief           Calculate cosine of angle with fixed-point math
+ * \param[in]       angle: Angle in units of `0.1` degree, any positive or negative value
+ * \return          Cosine of angle in Q15 format, between `-32767` and `32767`
+ * \sa              gui_math_sin
+ */
+int16_t
+gui_math_cos(int32_t angle) {
+    return gui_math_sin(angle % 3600 + 900);        /* Cosine leads sine by 90 degrees */
+}
@@ -31,11 +31,12 @@
 #define GUI_INTERNAL
 #include "gui/gui.h"
 #include "gui/gui_mem.h"
-
-typedef struct MemBlock {
-    struct MemBlock* NextFreeBlock;                 /*!< Pointer to next free block */
-    size_t Size;                                    /*!< Size of block */
-} MemBlock_t;
+#if GUI_CFG_MEM_RELOC || GUI_CFG_MEM_ZERO_LL
+#include "gui/gui_private.h"
+#endif /* GUI_CFG_MEM_RELOC || GUI_CFG_MEM_ZERO_LL */
+#if GUI_CFG_MEM_RELOC
+#include "gui/gui_idle.h"
+#endif /* GUI_CFG_MEM_RELOC */
 
 /**
  * \brief           Memory alignment bits and absolute number
@@ -44,15 +45,426 @@ typedef struct MemBlock {
 #define MEM_ALIGN_NUM               ((size_t)GUI_CFG_MEM_ALIGNMENT)
 #define MEM_ALIGN(x)                GUI_MEM_ALIGN(x)
 
+static size_t MemAvailableBytes = 0;
+static size_t MemMinAvailableBytes = 0;
+static size_t MemTotalSize = 0;                     /* Size of memory in units of bytes */
+static size_t MemReallocCount = 0;                  /* Number of reallocations of existing memory */
+static size_t MemReallocInPlaceCount = 0;           /* Number of reallocations done without moving memory */
+
+#if GUI_CFG_MEM_TLSF
+/**
+ * Two-level segregated fit allocator
+ *
+ * Free blocks are stored in lists by size class. First level is power of 2 of block size,
+ * second level divides first level range to TLSF_SL_COUNT linear classes.
+ * Bitmaps of non-empty lists are used to find suitable list in constant time.
+ * Each memory region has own lists and bitmaps, so region preference is found in constant time too
+ */
+typedef struct TlsfBlock {
+    struct TlsfBlock* PrevPhysBlock;                /*!< Pointer to previous block in memory */
+    size_t Size;                                    /*!< Size of block including meta data and free flag */
+    struct TlsfBlock* NextFreeBlock;                /*!< Pointer to next free block in same list, valid for free block only */
+    struct TlsfBlock* PrevFreeBlock;                /*!< Pointer to previous free block in same list, valid for free block only */
+} TlsfBlock_t;
+
+#define TLSF_ALIGN_NUM              (MEM_ALIGN_NUM > sizeof(void *) ? MEM_ALIGN_NUM : sizeof(void *))
+#define TLSF_ALIGN(x)               (((x) + (TLSF_ALIGN_NUM - 1)) & ~(TLSF_ALIGN_NUM - 1))
+#define TLSF_METASIZE               TLSF_ALIGN(2 * sizeof(void *))  /* Previous physical block and size */
+#define TLSF_BLOCK_MIN              TLSF_ALIGN(sizeof(TlsfBlock_t)) /* Free block must hold free list pointers */
+#define TLSF_BLOCK_FREE             ((size_t)0x01)  /* Block is free */
+#define TLSF_BLOCK_SIZE(b)          ((b)->Size & ~TLSF_BLOCK_FREE)
+#define TLSF_BLOCK_ISFREE(b)        ((b)->Size & TLSF_BLOCK_FREE)
+#define TLSF_BLOCK_NEXT(b)          ((TlsfBlock_t *)((uint8_t *)(b) + TLSF_BLOCK_SIZE(b)))
+
+#define TLSF_SL_LOG2                4               /* Number of second level classes as power of 2 */
+#define TLSF_SL_COUNT               (1 << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT               7               /* Blocks smaller than 2^TLSF_FL_SHIFT are in first level 0 */
+#define TLSF_FL_COUNT               (32 - TLSF_FL_SHIFT + 1)
+
+typedef struct {
+    TlsfBlock_t* Free[TLSF_FL_COUNT][TLSF_SL_COUNT];/*!< Lists of free blocks by size class */
+    uint32_t FlBitmap;                              /*!< Bitmap of first levels with non-empty lists */
+    uint32_t SlBitmap[TLSF_FL_COUNT];               /*!< Bitmap of non-empty lists in each first level */
+} TlsfControl_t;
+
+static TlsfControl_t TlsfControl[GUI_CFG_MEM_TLSF_REGIONS];
+static uint8_t* TlsfRegionEnd[GUI_CFG_MEM_TLSF_REGIONS];    /* End address of memory of each control */
+static uint8_t TlsfRegionCount;
+static uint8_t TlsfInitialized;
+
+/* Get index of most significant set bit, x must not be 0 */
+static uint8_t
+tlsf_fls(size_t x) {
+    uint8_t r = 0;
+    
+#if defined(__GNUC__)
+    r = (uint8_t)(sizeof(unsigned long) * 8 - 1 - __builtin_clzl((unsigned long)x));
+#else
+    if (x & 0xFFFF0000UL) { x >>= 16; r += 16; }
+    if (x & 0x0000FF00UL) { x >>= 8;  r += 8; }
+    if (x & 0x000000F0UL) { x >>= 4;  r += 4; }
+    if (x & 0x0000000CUL) { x >>= 2;  r += 2; }
+    if (x & 0x00000002UL) {           r += 1; }
+#endif /* defined(__GNUC__) */
+    return r;
+}
+
+/* Get first and second level indexes of size class size belongs to */
+static void
+tlsf_mapping(size_t size, uint8_t* fl, uint8_t* sl) {
+    uint8_t f;
+    
+    if (size < ((size_t)1 << TLSF_FL_SHIFT)) {
+        *fl = 0;
+        *sl = (uint8_t)(size >> (TLSF_FL_SHIFT - TLSF_SL_LOG2));
+    } else {
+        f = tlsf_fls(size);
+        *sl = (uint8_t)((size >> (f - TLSF_SL_LOG2)) & (TLSF_SL_COUNT - 1));
+        *fl = (uint8_t)(f - TLSF_FL_SHIFT + 1);
+    }
+}
+
+/* Get control of region block belongs to, regions are sorted by address */
+static TlsfControl_t*
+tlsf_getcontrol(const TlsfBlock_t* block) {
+    uint8_t i;
+    
+    for (i = 0; i + 1 < TlsfRegionCount && (const uint8_t *)block >= TlsfRegionEnd[i]; i++) {}
+    return &TlsfControl[i];
+}
+
+/* Remove free block from its list */
+static void
+tlsf_removefreeblock(TlsfBlock_t* block) {
+    TlsfControl_t* ctrl = tlsf_getcontrol(block);
+    uint8_t fl, sl;
+    
+    tlsf_mapping(TLSF_BLOCK_SIZE(block), &fl, &sl);
+    if (block->NextFreeBlock != NULL) {
+        block->NextFreeBlock->PrevFreeBlock = block->PrevFreeBlock;
+    }
+    if (block->PrevFreeBlock != NULL) {
+        block->PrevFreeBlock->NextFreeBlock = block->NextFreeBlock;
+    } else {                                        /* Block is first in list */
+        ctrl->Free[fl][sl] = block->NextFreeBlock;
+        if (ctrl->Free[fl][sl] == NULL) {           /* List is now empty */
+            ctrl->SlBitmap[fl] &= ~((uint32_t)1 << sl);
+            if (!ctrl->SlBitmap[fl]) {
+                ctrl->FlBitmap &= ~((uint32_t)1 << fl);
+            }
+        }
+    }
+    block->Size &= ~TLSF_BLOCK_FREE;
+}
+
+/* Insert free block to the beginning of its list */
+static void
+tlsf_insertfreeblock(TlsfBlock_t* block) {
+    TlsfControl_t* ctrl = tlsf_getcontrol(block);
+    uint8_t fl, sl;
+    
+    tlsf_mapping(TLSF_BLOCK_SIZE(block), &fl, &sl);
+    block->Size |= TLSF_BLOCK_FREE;
+    block->PrevFreeBlock = NULL;
+    block->NextFreeBlock = ctrl->Free[fl][sl];
+    if (block->NextFreeBlock != NULL) {
+        block->NextFreeBlock->PrevFreeBlock = block;
+    }
+    ctrl->Free[fl][sl] = block;
+    ctrl->FlBitmap |= (uint32_t)1 << fl;
+    ctrl->SlBitmap[fl] |= (uint32_t)1 << sl;
+}
+
+/* Find non-empty list of size class fl/sl or bigger, return class as fl * TLSF_SL_COUNT + sl or -1 if none */
+static int16_t
+tlsf_findclass(const TlsfControl_t* ctrl, uint8_t fl, uint8_t sl) {
+    uint32_t map;
+    
+    map = sl < TLSF_SL_COUNT ? ctrl->SlBitmap[fl] & (~(uint32_t)0 << sl) : 0;
+    if (!map) {
+        map = fl + 1 < TLSF_FL_COUNT ? ctrl->FlBitmap & (~(uint32_t)0 << (fl + 1)) : 0;
+        if (!map) {
+            return -1;                              /* No free blocks of required size */
+        }
+        fl = tlsf_fls(map & (~map + 1));            /* Get lowest set bit */
+        map = ctrl->SlBitmap[fl];
+    }
+    return (int16_t)(fl * TLSF_SL_COUNT + tlsf_fls(map & (~map + 1)));
+}
+
+/* Trim used block to size and return remaining memory as free block */
+static void
+tlsf_trimblock(TlsfBlock_t* block, size_t size) {
+    TlsfBlock_t *tail, *next;
+    
+    if (TLSF_BLOCK_SIZE(block) - size < TLSF_BLOCK_MIN) {   /* Remaining memory too small for new block */
+        return;
+    }
+    tail = (TlsfBlock_t *)((uint8_t *)block + size);
+    tail->Size = TLSF_BLOCK_SIZE(block) - size;
+    tail->PrevPhysBlock = block;
+    block->Size = size;
+    MemAvailableBytes += tail->Size;                /* Tail is now available */
+    
+    next = TLSF_BLOCK_NEXT(tail);
+    if (TLSF_BLOCK_ISFREE(next)) {                  /* Merge with next free block */
+        tlsf_removefreeblock(next);
+        tail->Size += next->Size;
+    }
+    TLSF_BLOCK_NEXT(tail)->PrevPhysBlock = tail;
+    tlsf_insertfreeblock(tail);
+}
+
+uint8_t
+mem_assignmem(const mem_region_t* regions, size_t len) {
+    uint8_t* MemStartAddr;
+    size_t MemSize;
+    TlsfBlock_t *FirstBlock, *EndBlock;
+    size_t i;
+    
+    if (TlsfInitialized) {                          /* Regions already defined */
+        return 0;
+    }
+    
+    /**
+     * Check if region address are linear and rising
+     */
+    MemStartAddr = (uint8_t *)0;
+    for (i = 0; i < len; i++) {
+        if (MemStartAddr >= (uint8_t *)regions[i].StartAddress) {   /* Check if previous greater than current */
+            return 0;                               /* Return as invalid and failed */
+        }
+        MemStartAddr = (uint8_t *)regions[i].StartAddress;  /* Save as previous address */
+    }
+    
+    for (; len--; regions++) {
+        MemStartAddr = (uint8_t *)regions->StartAddress;
+        MemSize = regions->Size;
+        
+        /* Align start address and size of region */
+        if ((size_t)MemStartAddr & (TLSF_ALIGN_NUM - 1)) {
+            i = TLSF_ALIGN_NUM - ((size_t)MemStartAddr & (TLSF_ALIGN_NUM - 1));
+            if (MemSize < i) {
+                continue;
+            }
+            MemStartAddr += i;
+            MemSize -= i;
+        }
+        MemSize &= ~(TLSF_ALIGN_NUM - 1);
+        
+        /* Region must hold at least one free block and end block */
+        if (MemSize < (TLSF_BLOCK_MIN + TLSF_METASIZE) || MemSize >= ((size_t)1 << 31)) {
+            continue;
+        }
+        
+        /**
+         * First block covers entire region, except end block.
+         * End block has size 0 and is never free, so it is never merged with blocks before
+         */
+        FirstBlock = (TlsfBlock_t *)MemStartAddr;
+        FirstBlock->PrevPhysBlock = NULL;
+        FirstBlock->Size = MemSize - TLSF_METASIZE;
+        EndBlock = TLSF_BLOCK_NEXT(FirstBlock);
+        EndBlock->PrevPhysBlock = FirstBlock;
+        EndBlock->Size = 0;
+        if (TlsfRegionCount < GUI_CFG_MEM_TLSF_REGIONS) {   /* Regions over limit share last control */
+            TlsfRegionCount++;
+        }
+        TlsfRegionEnd[TlsfRegionCount - 1] = MemStartAddr + MemSize;
+        tlsf_insertfreeblock(FirstBlock);
+        
+        MemAvailableBytes += TLSF_BLOCK_SIZE(FirstBlock);
+        MemTotalSize += TLSF_BLOCK_SIZE(FirstBlock);
+        TlsfInitialized = 1;
+    }
+    
+    MemMinAvailableBytes = MemAvailableBytes;       /* Save minimum ever available bytes in region */
+    return TlsfInitialized;
+}
+
+static void*
+mem_alloc(size_t size, gui_mem_hint_t hint) {
+    TlsfBlock_t* block;
+    int16_t cls, c;
+    uint8_t fl, sl, i, r, region = 0;
+    
+    if (!TlsfInitialized || !size || size >= ((size_t)1 << 30)) {   /* Check input parameters */
+        return 0;
+    }
+    
+    size = TLSF_ALIGN(size) + TLSF_METASIZE;        /* Get size of block */
+    if (size < TLSF_BLOCK_MIN) {
+        size = TLSF_BLOCK_MIN;
+    }
+    if (size > MemAvailableBytes) {                 /* Check if we have enough memory available */
+        return 0;
+    }
+    
+    /**
+     * Round size up to next size class,
+     * so any block in found list is big enough
+     */
+    if (size >= ((size_t)1 << TLSF_FL_SHIFT)) {
+        tlsf_mapping(size + ((size_t)1 << (tlsf_fls(size) - TLSF_SL_LOG2)) - 1, &fl, &sl);
+    } else {
+        tlsf_mapping(size + ((size_t)1 << (TLSF_FL_SHIFT - TLSF_SL_LOG2)) - 1, &fl, &sl);
+    }
+    if (fl >= TLSF_FL_COUNT) {
+        return 0;
+    }
+    
+    /*
+     * Find non-empty list of the same or bigger size class.
+     * Hot data take first region with suitable block, bulk data last one,
+     * others take smallest suitable class of all regions
+     */
+    cls = -1;
+    for (i = 0; i < TlsfRegionCount; i++) {
+        r = hint == GUI_MEM_BULK ? TlsfRegionCount - 1 - i : i;
+        c = tlsf_findclass(&TlsfControl[r], fl, sl);
+        if (c >= 0 && (cls < 0 || c < cls)) {
+            cls = c;
+            region = r;
+            if (hint != GUI_MEM_ANY) {
+                break;
+            }
+        }
+    }
+    if (cls < 0) {
+        return 0;                                   /* No free blocks of required size */
+    }
+    block = TlsfControl[region].Free[cls / TLSF_SL_COUNT][cls % TLSF_SL_COUNT];
+    tlsf_removefreeblock(block);
+    
+    MemAvailableBytes -= TLSF_BLOCK_SIZE(block);    /* Decrease available memory */
+    tlsf_trimblock(block, size);                    /* Split block if remaining memory is big enough for new block */
+    if (MemAvailableBytes < MemMinAvailableBytes) { /* Check if current available memory is less than ever before */
+        MemMinAvailableBytes = MemAvailableBytes;   /* Update minimal available memory */
+    }
+    return (void *)((uint8_t *)block + TLSF_METASIZE);
+}
+
+static void
+mem_free(void* ptr) {
+    TlsfBlock_t *block, *next;
+    
+    if (!ptr) {                                     /* To be in compliance with C free function */
+        return;
+    }
+    
+    block = (TlsfBlock_t *)(((uint8_t *)ptr) - TLSF_METASIZE);  /* Get block data pointer from input pointer */
+    if (TLSF_BLOCK_ISFREE(block) || !TLSF_BLOCK_SIZE(block)) {  /* Block must be allocated */
+        return;
+    }
+    MemAvailableBytes += TLSF_BLOCK_SIZE(block);    /* Increase available bytes back */
+    
+    /* Merge with previous and next block in memory if they are free */
+    if (block->PrevPhysBlock != NULL && TLSF_BLOCK_ISFREE(block->PrevPhysBlock)) {
+        tlsf_removefreeblock(block->PrevPhysBlock);
+        block->PrevPhysBlock->Size += block->Size;
+        block = block->PrevPhysBlock;
+    }
+    next = TLSF_BLOCK_NEXT(block);
+    if (TLSF_BLOCK_ISFREE(next)) {
+        tlsf_removefreeblock(next);
+        block->Size += next->Size;
+    }
+    TLSF_BLOCK_NEXT(block)->PrevPhysBlock = block;
+    tlsf_insertfreeblock(block);
+}
+
+/* Resize allocated block in place, using free block after it when growing */
+static uint8_t
+mem_resize(void* ptr, size_t size) {
+    TlsfBlock_t *block, *next;
+    
+    if (!size || size >= ((size_t)1 << 30)) {       /* Check input parameters */
+        return 0;
+    }
+    block = (TlsfBlock_t *)(((uint8_t *)ptr) - TLSF_METASIZE);  /* Get block data pointer from input pointer */
+    size = TLSF_ALIGN(size) + TLSF_METASIZE;        /* Get size of block */
+    if (size < TLSF_BLOCK_MIN) {
+        size = TLSF_BLOCK_MIN;
+    }
+    
+    if (size > TLSF_BLOCK_SIZE(block)) {            /* Block must grow */
+        next = TLSF_BLOCK_NEXT(block);
+        if (!TLSF_BLOCK_ISFREE(next) || TLSF_BLOCK_SIZE(block) + TLSF_BLOCK_SIZE(next) < size) {
+            return 0;                               /* Not enough free memory right after block */
+        }
+        tlsf_removefreeblock(next);                 /* Merge next block to current */
+        MemAvailableBytes -= next->Size;
+        block->Size += next->Size;
+        TLSF_BLOCK_NEXT(block)->PrevPhysBlock = block;
+    }
+    tlsf_trimblock(block, size);                    /* Return unused tail */
+    
+    if (MemAvailableBytes < MemMinAvailableBytes) { /* Check if current available memory is less than ever before */
+        MemMinAvailableBytes = MemAvailableBytes;   /* Update minimal available memory */
+    }
+    return 1;
+}
+
+/* Get size of user memory from input pointer */
+static size_t
+mem_getusersize(void* ptr) {
+    TlsfBlock_t* block;
+    
+    if (!ptr) {
+        return 0;
+    }
+    block = (TlsfBlock_t *)(((uint8_t *)ptr) - TLSF_METASIZE);  /* Get block meta data pointer */
+    if (!TLSF_BLOCK_ISFREE(block)) {                /* Memory is actually allocated */
+        return TLSF_BLOCK_SIZE(block) - TLSF_METASIZE;  /* Return size of block */
+    }
+    return 0;
+}
+
+/* Get size of largest free block */
+static size_t
+mem_getlargestfree(void) {
+    TlsfBlock_t* block;
+    size_t max = 0;
+    uint8_t fl, i;
+    
+    /* Largest block of region is in its highest non-empty list */
+    for (i = 0; i < TlsfRegionCount; i++) {
+        if (!TlsfControl[i].FlBitmap) {
+            continue;
+        }
+        fl = tlsf_fls(TlsfControl[i].FlBitmap);
+        for (block = TlsfControl[i].Free[fl][tlsf_fls(TlsfControl[i].SlBitmap[fl])]; block != NULL; block = block->NextFreeBlock) {
+            if (TLSF_BLOCK_SIZE(block) > max) {
+                max = TLSF_BLOCK_SIZE(block);
+            }
+        }
+    }
+    return max;
+}
+#else /* GUI_CFG_MEM_TLSF */
+
+typedef struct MemBlock {
+    struct MemBlock* NextFreeBlock;                 /*!< Pointer to next free block */
+    size_t Size;                                    /*!< Size of block */
+} MemBlock_t;
+
 #define MEMBLOCK_METASIZE           MEM_ALIGN(sizeof(MemBlock_t))
 
 static MemBlock_t StartBlock;
 static MemBlock_t* EndBlock = 0;
-static size_t MemAvailableBytes = 0;
-static size_t MemMinAvailableBytes = 0;
 static size_t MemAllocBit = 0;
+#if GUI_CFG_MEM_RELOC
+/*
+ * Movable block keeps address of owner's pointer in its NextFreeBlock member,
+ * compactor updates owner's pointer when block is moved
+ */
+static size_t MemRelocBit = 0;
+static size_t MemRelocCount = 0;                    /* Number of allocated movable blocks */
+#define MEMBLOCK_FLAGS              (MemAllocBit | MemRelocBit)
+#else /* GUI_CFG_MEM_RELOC */
+#define MEMBLOCK_FLAGS              MemAllocBit
+#endif /* !GUI_CFG_MEM_RELOC */
 
-static size_t MemTotalSize = 0;                     /* Size of memory in units of bytes */
 /* Insert block to list of free blocks */
 static void
 mem_insertfreeblock(MemBlock_t* newBlock) {
@@ -193,6 +605,7 @@ mem_assignmem(const mem_region_t* regions, size_t len) {
          * Set number of free bytes available to allocate in region
          */
         MemAvailableBytes += FirstBlock->Size;
+        MemTotalSize += FirstBlock->Size;
         
         regions++;                                  /* Go to next region */
     }
@@ -203,12 +616,15 @@ mem_assignmem(const mem_region_t* regions, size_t len) {
      * Set upper bit in memory allocation bit
      */
     MemAllocBit = (size_t)((size_t)1 << ((sizeof(size_t) * 8 - 1)));
+#if GUI_CFG_MEM_RELOC
+    MemRelocBit = MemAllocBit >> 1;                 /* Next bit marks movable block */
+#endif /* GUI_CFG_MEM_RELOC */
     
     return 1;                                       /* Regions set as expected */
 }
 
 static void*
-mem_alloc(size_t size) {
+mem_alloc(size_t size, gui_mem_hint_t hint) {
     MemBlock_t *Prev, *Curr, *Next;
     void* retval = 0;
 
@@ -219,7 +635,7 @@ mem_alloc(size_t size) {
     /**
      * TODO: Check alignment maybe?
      */    
-    if (!size || size >= MemAllocBit) {             /* Check input parameters */
+    if (!size || size >= (MemAllocBit >> 1)) {      /* Check input parameters, upper bits are used for flags */
         return 0;
     }
 
@@ -240,6 +656,19 @@ mem_alloc(size_t size) {
         Curr = Curr->NextFreeBlock;
     }
     
+    /**
+     * Bulk data prefers last region,
+     * continue to the end and use last sufficient block
+     */
+    if (hint == GUI_MEM_BULK && Curr != EndBlock) {
+        for (Next = Curr; Next->NextFreeBlock != NULL; Next = Next->NextFreeBlock) {
+            if (Next->NextFreeBlock->Size >= size) {
+                Prev = Next;
+                Curr = Next->NextFreeBlock;
+            }
+        }
+    }
+    
     /**
      * Possible improvements
      * Try to find smallest available block for desired amount of memory
@@ -267,10 +696,10 @@ mem_alloc(size_t size) {
              */
             mem_insertfreeblock(Next);              /* Insert free memory block to list of free memory blocks (linked list chain) */
         }
+        MemAvailableBytes -= Curr->Size;            /* Decrease available memory for entire block size */
         Curr->Size |= MemAllocBit;                  /* Set allocated bit = memory is allocated */
         Curr->NextFreeBlock = 0;                    /* Clear next free block pointer as there is no one */
 
-        MemAvailableBytes -= size;                  /* Decrease available memory */
         if (MemAvailableBytes < MemMinAvailableBytes) { /* Check if current available memory is less than ever before */
             MemMinAvailableBytes = MemAvailableBytes;   /* Update minimal available memory */
         }
@@ -295,17 +724,67 @@ mem_free(void* ptr) {
      * Check if block is even allocated by upper bit on size
      * and next free block must be set to NULL in order to work properly
      */
-    if ((block->Size & MemAllocBit) && !block->NextFreeBlock) {
+    if ((block->Size & MemAllocBit) && (!block->NextFreeBlock
+#if GUI_CFG_MEM_RELOC
+        || (block->Size & MemRelocBit)              /* Movable block keeps owner reference */
+#endif /* GUI_CFG_MEM_RELOC */
+    )) {
+#if GUI_CFG_MEM_RELOC
+        if (block->Size & MemRelocBit) {
+            MemRelocCount--;
+        }
+#endif /* GUI_CFG_MEM_RELOC */
         /**
          * Clear allocated bit before entering back to free list
          * List will automatically take care for fragmentation and mix segments back
          */
-        block->Size &= ~MemAllocBit;                /* Clear allocated bit */
+        block->Size &= ~MEMBLOCK_FLAGS;             /* Clear allocated bit */
         MemAvailableBytes += block->Size;           /* Increase available bytes back */
         mem_insertfreeblock(block);                 /* Insert block to list of free blocks */
     }
 }
 
+/* Resize allocated block in place, using free block after it when growing */
+static uint8_t
+mem_resize(void* ptr, size_t size) {
+    MemBlock_t *block, *prev, *next;
+    size_t curr, flags;
+    
+    if (!size || size >= (MemAllocBit >> 1)) {      /* Check input parameters */
+        return 0;
+    }
+    block = (MemBlock_t *)(((uint8_t *)ptr) - MEMBLOCK_METASIZE);   /* Get block data pointer from input pointer */
+    size = MEM_ALIGN(size) + MEMBLOCK_METASIZE;
+    flags = block->Size & MEMBLOCK_FLAGS;           /* Keep allocated and movable flags */
+    curr = block->Size & ~MEMBLOCK_FLAGS;           /* Current block size */
+    
+    if (size > curr) {                              /* Block must grow */
+        /* Find free block right after current one */
+        next = (MemBlock_t *)((uint8_t *)block + curr);
+        for (prev = &StartBlock; prev->NextFreeBlock != NULL && prev->NextFreeBlock < next; prev = prev->NextFreeBlock);
+        if (prev->NextFreeBlock != next || next == EndBlock || curr + next->Size < size) {
+            return 0;                               /* Not enough free memory right after block */
+        }
+        prev->NextFreeBlock = next->NextFreeBlock;  /* Remove block from free chain */
+        MemAvailableBytes -= next->Size;
+        curr += next->Size;
+        if (MemAvailableBytes < MemMinAvailableBytes) { /* Check if current available memory is less than ever before */
+            MemMinAvailableBytes = MemAvailableBytes;   /* Update minimal available memory */
+        }
+    }
+    
+    /* Return unused tail to list of free blocks */
+    if ((curr - size) > (2 * MEMBLOCK_METASIZE)) {
+        next = (MemBlock_t *)((uint8_t *)block + size);
+        next->Size = curr - size;
+        MemAvailableBytes += next->Size;
+        curr = size;
+        mem_insertfreeblock(next);                  /* Insert block and merge it with free blocks around */
+    }
+    block->Size = curr | flags;                     /* Keep block allocated */
+    return 1;
+}
+
 /* Get size of user memory from input pointer */
 static size_t
 mem_getusersize(void* ptr) {
@@ -316,19 +795,178 @@ mem_getusersize(void* ptr) {
     }
     block = (MemBlock_t *)(((uint8_t *)ptr) - MEMBLOCK_METASIZE);   /* Get block meta data pointer */
     if (block->Size & MemAllocBit) {                /* Memory is actually allocated */
-        return (block->Size & ~MemAllocBit) - MEMBLOCK_METASIZE;    /* Return size of block */
+        return (block->Size & ~MEMBLOCK_FLAGS) - MEMBLOCK_METASIZE; /* Return size of block */
+    }
+    return 0;
+}
+
+/* Get size of largest free block */
+static size_t
+mem_getlargestfree(void) {
+    MemBlock_t* ptr;
+    size_t max = 0;
+    
+    for (ptr = StartBlock.NextFreeBlock; ptr != NULL && ptr != EndBlock; ptr = ptr->NextFreeBlock) {
+        if (ptr->Size > max) {
+            max = ptr->Size;
+        }
+    }
+    return max;
+}
+
+#if GUI_CFG_MEM_RELOC
+
+/* Mark allocated block as movable, owner pointer is updated when block is moved */
+static uint8_t
+mem_setmovable(void* ptr, void** ref) {
+    MemBlock_t* block;
+    
+    if (ptr == NULL || ref == NULL) {
+        return 0;
+    }
+    block = (MemBlock_t *)(((uint8_t *)ptr) - MEMBLOCK_METASIZE);
+    if (!(block->Size & MemAllocBit)) {
+        return 0;
+    }
+    if (!(block->Size & MemRelocBit)) {
+        block->Size |= MemRelocBit;
+        MemRelocCount++;
+    }
+    block->NextFreeBlock = (MemBlock_t *)ref;       /* Save owner reference */
+    return 1;
+}
+
+/* Get owner reference of movable block, `NULL` for fixed block */
+static void**
+mem_getref(void* ptr) {
+    MemBlock_t* block = (MemBlock_t *)(((uint8_t *)ptr) - MEMBLOCK_METASIZE);
+    
+    return (block->Size & MemRelocBit) ? (void **)block->NextFreeBlock : NULL;
+}
+
+/* Mark movable block as fixed again */
+static void
+mem_setfixed(void* ptr) {
+    MemBlock_t* block;
+    
+    if (ptr == NULL) {
+        return;
+    }
+    block = (MemBlock_t *)(((uint8_t *)ptr) - MEMBLOCK_METASIZE);
+    if ((block->Size & MemAllocBit) && (block->Size & MemRelocBit)) {
+        block->Size &= ~MemRelocBit;
+        block->NextFreeBlock = 0;
+        MemRelocCount--;
+    }
+}
+
+/*
+ * Slide movable blocks down to free blocks right before them,
+ * free memory is merged with free blocks after moved ones.
+ * Returns number of moved bytes, may exceed max by size of last moved block
+ */
+static size_t
+mem_compact(size_t max) {
+    MemBlock_t *prev, *curr, *next;
+    size_t moved = 0, size, freesize;
+    void** ref;
+    
+    if (!EndBlock || !MemRelocCount) {
+        return 0;
+    }
+    prev = &StartBlock;
+    curr = prev->NextFreeBlock;
+    while (curr != NULL && curr != EndBlock && moved < max) {
+        next = (MemBlock_t *)((uint8_t *)curr + curr->Size);    /* Block physically after free block */
+        if (!(next->Size & MemRelocBit)) {          /* Fixed block or end of region */
+            prev = curr;
+            curr = curr->NextFreeBlock;
+            continue;
+        }
+        size = next->Size & ~MEMBLOCK_FLAGS;
+        freesize = curr->Size;
+        ref = (void **)next->NextFreeBlock;
+        prev->NextFreeBlock = curr->NextFreeBlock;  /* Free block is overwritten by moved block */
+        memmove(curr, next, size);                  /* Move block together with its meta data */
+        *ref = (uint8_t *)*ref - freesize;          /* Update owner pointer */
+        
+        next = (MemBlock_t *)((uint8_t *)curr + size);  /* Free memory is now after moved block */
+        next->Size = freesize;
+        mem_insertfreeblock(next);                  /* Merge with free block after moved one */
+        moved += size;
+        curr = prev->NextFreeBlock;                 /* Continue with the same, now merged, free memory */
+    }
+    return moved;
+}
+
+/* Check if there is movable block to compact */
+static uint8_t
+mem_compactpending(void) {
+    MemBlock_t* ptr;
+    
+    if (!EndBlock || !MemRelocCount) {
+        return 0;
+    }
+    for (ptr = StartBlock.NextFreeBlock; ptr != NULL && ptr != EndBlock; ptr = ptr->NextFreeBlock) {
+        if (((MemBlock_t *)((uint8_t *)ptr + ptr->Size))->Size & MemRelocBit) {
+            return 1;
+        }
     }
     return 0;
 }
 
+#endif /* GUI_CFG_MEM_RELOC */
+#endif /* !GUI_CFG_MEM_TLSF */
+
+#if GUI_CFG_MEM_ZERO_LL
+/**
+ * \brief           Number of 32-bit words in single line of low-level fill
+ */
+#define MEM_ZERO_LINE               256
+
+/**
+ * \brief           Reset big block of memory with low-level fill
+ * \note            Memory is handled as 32-bit pixels of virtual layer.
+ *                  Words which do not fill complete line are reset by CPU
+ * \param[in]       ptr: Pointer to memory to reset
+ * \param[in]       len: Number of bytes to reset
+ * \return          `1` when memory is reset, `0` when low-level cannot be used
+ */
+static uint8_t
+mem_zero(void* ptr, size_t len) {
+    gui_layer_t layer;
+    size_t lines = len / (MEM_ZERO_LINE * 4);
+    
+    if (len < GUI_CFG_MEM_ZERO_LL || !GUI.Initialized || !GUI_LL_HAS_Fill
+        || ((uintptr_t)ptr & 0x03) || !lines || lines > 0x7FFF) {
+        return 0;                                   /* Low-level is not ready or block is not suitable */
+    }
+    memset(&layer, 0x00, sizeof(layer));
+    layer.start_address = (uintptr_t)ptr;
+    layer.pixel_format = GUI_PIXEL_FORMAT_ARGB8888; /* Single pixel is single word */
+    layer.pixel_size = 4;
+    layer.width = MEM_ZERO_LINE;
+    layer.height = (gui_dim_t)lines;
+    GUI_LL_Fill(&GUI.lcd, &layer, ptr, MEM_ZERO_LINE, (gui_dim_t)lines, 0, 0x00000000);
+    memset((uint8_t *)ptr + lines * MEM_ZERO_LINE * 4, 0x00, len - lines * MEM_ZERO_LINE * 4);
+    guii_ll_waitready();                            /* Memory is used immediately after allocation */
+    return 1;
+}
+#endif /* GUI_CFG_MEM_ZERO_LL */
+
 /* Allocate memory and set it to 0 */
 static void*
-mem_calloc(size_t num, size_t size) {
+mem_calloc(size_t num, size_t size, gui_mem_hint_t hint) {
     void* ptr;
     size_t tot_len = num * size;
     
-    if ((ptr = mem_alloc(tot_len)) != NULL) {       /* Try to allocate memory */
-        memset(ptr, 0x00, tot_len);                 /* Reset entire memory */
+    if ((ptr = mem_alloc(tot_len, hint)) != NULL) {       /* Try to allocate memory */
+#if GUI_CFG_MEM_ZERO_LL
+        if (!mem_zero(ptr, tot_len))
+#endif /* GUI_CFG_MEM_ZERO_LL */
+        {
+            memset(ptr, 0x00, tot_len);             /* Reset entire memory */
+        }
     }
     return ptr;
 }
@@ -340,13 +978,24 @@ mem_realloc(void* ptr, size_t size) {
     size_t oldSize;
     
     if (!ptr) {                                     /* If pointer is not valid */
-        return mem_alloc(size);                     /* Only allocate memory */
+        return mem_alloc(size, GUI_MEM_ANY);        /* Only allocate memory */
+    }
+    
+    MemReallocCount++;
+    if (mem_getusersize(ptr) && mem_resize(ptr, size)) {    /* Try to resize block in place first */
+        MemReallocInPlaceCount++;
+        return ptr;
     }
     
     oldSize = mem_getusersize(ptr);                 /* Get size of old pointer */
-    newPtr = mem_alloc(size);                       /* Try to allocate new memory block */
+    newPtr = mem_alloc(size, GUI_MEM_ANY);          /* Try to allocate new memory block */
     if (newPtr != NULL) {                           /* Check success */
         memcpy(newPtr, ptr, size > oldSize ? oldSize : size);   /* Copy old data to new array */
+#if GUI_CFG_MEM_RELOC
+        if (mem_getref(ptr) != NULL) {              /* New block stays movable with the same owner */
+            mem_setmovable(newPtr, mem_getref(ptr));
+        }
+#endif /* GUI_CFG_MEM_RELOC */
         mem_free(ptr);                              /* Free old pointer */
         return newPtr;                              /* Return new pointer */
     }
@@ -368,6 +1017,142 @@ mem_getminfree(void) {
     return MemMinAvailableBytes;                    /* Return minimal bytes ever available */
 }
 
+#if GUI_CFG_MEM_PROFILE
+/**
+ * \brief           Profiler header in front of every allocated block
+ */
+typedef struct {
+    gui_mem_tagstat_t* tag;                         /*!< Tag statistics block is accounted to */
+    size_t size;                                    /*!< Requested size in units of bytes */
+} mem_prof_hdr_t;
+
+#define PROF_HDR_SIZE               MEM_ALIGN(sizeof(mem_prof_hdr_t))
+#define PROF_SIZE(size)             ((size) + PROF_HDR_SIZE)
+
+static gui_mem_tagstat_t MemTags[GUI_CFG_MEM_PROFILE_TAGS] = { { GUI_MEM_TAG_OTHER } };
+static const char* MemTag = GUI_MEM_TAG_OTHER;      /* Tag of new allocations */
+
+/* Get statistics entry of tag, create new one if possible */
+static gui_mem_tagstat_t*
+prof_gettag(const char* name) {
+    size_t i;
+    
+    for (i = 0; i < GUI_COUNT_OF(MemTags) && MemTags[i].name != NULL; i++) {
+        if (MemTags[i].name == name || !strcmp(MemTags[i].name, name)) {
+            return &MemTags[i];
+        }
+    }
+    if (i < GUI_COUNT_OF(MemTags)) {
+        MemTags[i].name = name;
+        return &MemTags[i];
+    }
+    return &MemTags[0];                             /* No free entry, account to first tag */
+}
+
+/* Write header to raw block and account it to tag, returns user pointer */
+static void*
+prof_track(void* raw, size_t size, gui_mem_tagstat_t* tag) {
+    mem_prof_hdr_t* hdr = raw;
+    
+    if (hdr == NULL) {
+        return NULL;
+    }
+    hdr->tag = tag;
+    hdr->size = size;
+    tag->bytes += size;
+    tag->blocks++;
+    if (tag->bytes > tag->peak) {
+        tag->peak = tag->bytes;
+    }
+    return (uint8_t *)hdr + PROF_HDR_SIZE;
+}
+
+/* Remove block accounting, returns raw block pointer */
+static void*
+prof_untrack(void* ptr) {
+    mem_prof_hdr_t* hdr;
+    
+    if (ptr == NULL) {
+        return NULL;
+    }
+    hdr = (mem_prof_hdr_t *)((uint8_t *)ptr - PROF_HDR_SIZE);
+    hdr->tag->bytes -= hdr->size;
+    hdr->tag->blocks--;
+    return hdr;
+}
+
+#define PROF_TRACK(raw, size)       prof_track((raw), (size), prof_gettag(MemTag))
+#define PROF_UNTRACK(ptr)           prof_untrack(ptr)
+#define PROF_RAW(ptr)               ((void *)((uint8_t *)(ptr) - PROF_HDR_SIZE))
+#else
+#define PROF_SIZE(size)             (size)
+#define PROF_RAW(ptr)               (ptr)
+#define PROF_TRACK(raw, size)       (raw)
+#define PROF_UNTRACK(ptr)           (ptr)
+#endif /* GUI_CFG_MEM_PROFILE */
+
+#if GUI_CFG_MEM_RECLAIM
+static gui_mem_reclaim_t* MemReclaimList;           /* Reclaimers sorted by priority */
+static uint8_t MemReclaiming;                       /* Set to `1` while reclaimer is running */
+
+/**
+ * \brief           Ask reclaimers to release memory for failed allocation
+ * \param[in,out]   r: Pointer to first reclaimer to ask. It is set to reclaimer which released memory,
+ *                      so the same one is asked again on next call
+ * \param[in]       size: Number of bytes of failed allocation
+ * \return          `1` when memory was released and allocation may be tried again, `0` otherwise
+ */
+static uint8_t
+mem_reclaim(gui_mem_reclaim_t** r, size_t size) {
+    if (MemReclaiming) {                            /* Memory released by reclaimer is not reclaimed again */
+        return 0;
+    }
+    MemReclaiming = 1;
+    for (; *r != NULL; *r = (*r)->next) {
+        if ((*r)->fn(size, (*r)->arg)) {
+            break;
+        }
+    }
+    MemReclaiming = 0;
+    return *r != NULL;
+}
+
+/* Evaluate allocation and evaluate it again while reclaimers release memory */
+#define MEM_RECLAIM_RETRY(ptr, size, expr)  do {                    \
+    gui_mem_reclaim_t* __r = MemReclaimList;                        \
+    (ptr) = (expr);                                                 \
+    while ((ptr) == NULL && (size) > 0 && mem_reclaim(&__r, (size))) { \
+        (ptr) = (expr);                                             \
+    }                                                               \
+} while (0)
+#else
+#define MEM_RECLAIM_RETRY(ptr, size, expr)  do { (ptr) = (expr); } while (0)
+#endif /* GUI_CFG_MEM_RECLAIM */
+
+#if GUI_CFG_MEM_RELOC && GUI_CFG_USE_IDLE_TASKS
+static gui_idle_task_t compact_task;
+
+/**
+ * \brief           Idle task compacting heap in chunks of \ref GUI_CFG_MEM_RELOC_CHUNK bytes
+ * \param[in]       budget: Time available for compaction, in units of microseconds
+ * \param[in]       arg: Unused
+ * \return          `1` when more blocks can be moved, `0` otherwise
+ */
+static uint8_t
+mem_compact_process(uint32_t budget, void* arg) {
+    uint32_t start = GUI_CFG_IDLE_TIME();
+    
+    GUI_UNUSED(arg);
+    guii_ll_waitready();                            /* Low-level may still read cached bitmaps */
+    do {
+        if (!mem_compact(GUI_CFG_MEM_RELOC_CHUNK)) {
+            return 0;
+        }
+    } while (GUI_CFG_IDLE_TIME() - start < budget);
+    return mem_compactpending();
+}
+#endif /* GUI_CFG_MEM_RELOC && GUI_CFG_USE_IDLE_TASKS */
+
 /**
  * \brief           Allocate memory of specific size
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -380,9 +1165,9 @@ gui_mem_alloc(uint32_t size) {
     void* ptr;
     __GUI_SYS_PROTECT();                            /* Lock system protection */
 #if GUI_CFG_USE_MEM
-    ptr = mem_alloc(size);                          /* Allocate memory and return pointer */ 
+    MEM_RECLAIM_RETRY(ptr, size, PROF_TRACK(mem_alloc(PROF_SIZE(size), GUI_MEM_ANY), size));  /* Allocate memory and return pointer */
 #else
-    ptr = malloc(size);
+    MEM_RECLAIM_RETRY(ptr, size, PROF_TRACK(malloc(PROF_SIZE(size)), size));
 #endif
     __GUI_SYS_UNPROTECT();                          /* Unlock protection */
     return ptr;
@@ -399,11 +1184,36 @@ gui_mem_alloc(uint32_t size) {
  */
 void*
 gui_mem_realloc(void* ptr, size_t size) {
+#if GUI_CFG_MEM_PROFILE
+    gui_mem_tagstat_t* tag;
+    void* raw;
+#endif /* GUI_CFG_MEM_PROFILE */
+    
     __GUI_SYS_PROTECT();                            /* Lock system protection */
+#if GUI_CFG_MEM_PROFILE
+    /* Block keeps tag it was allocated with */
+    tag = ptr != NULL ? ((mem_prof_hdr_t *)((uint8_t *)ptr - PROF_HDR_SIZE))->tag : prof_gettag(MemTag);
+    raw = PROF_UNTRACK(ptr);
 #if GUI_CFG_USE_MEM
-    ptr = mem_realloc(ptr, size);                   /* Reallocate and return pointer */
+    MEM_RECLAIM_RETRY(ptr, size, mem_realloc(raw, PROF_SIZE(size)));
+#else
+    MEM_RECLAIM_RETRY(ptr, size, realloc(raw, PROF_SIZE(size)));
+#endif
+    if (ptr != NULL) {
+        ptr = prof_track(ptr, size, tag);
+    } else if (raw != NULL) {                       /* Old block is still valid */
+        prof_track(raw, ((mem_prof_hdr_t *)raw)->size, tag);
+    }
+#elif GUI_CFG_USE_MEM
+    {
+        void* old = ptr;
+        MEM_RECLAIM_RETRY(ptr, size, mem_realloc(old, size));  /* Reallocate and return pointer */
+    }
 #else
-    ptr = realloc(ptr, size);
+    {
+        void* old = ptr;
+        MEM_RECLAIM_RETRY(ptr, size, realloc(old, size));
+    }
 #endif
     __GUI_SYS_UNPROTECT();                          /* Unlock protection */
     return ptr;
@@ -421,9 +1231,9 @@ gui_mem_calloc(size_t num, size_t size) {
     void* ptr;
     __GUI_SYS_PROTECT();                            /* Lock system protection */
 #if GUI_CFG_USE_MEM
-    ptr = mem_calloc(num, size);                   /* Allocate memory and clear it to 0. Then return pointer */
+    MEM_RECLAIM_RETRY(ptr, num * size, PROF_TRACK(mem_calloc(1, PROF_SIZE(num * size), GUI_MEM_ANY), num * size));  /* Allocate memory and clear it to 0. Then return pointer */
 #else
-    ptr = calloc(num, size);
+    MEM_RECLAIM_RETRY(ptr, num * size, PROF_TRACK(calloc(1, PROF_SIZE(num * size)), num * size));
 #endif
     __GUI_SYS_UNPROTECT();                          /* Unlock protection */
     return ptr;
@@ -437,11 +1247,63 @@ void
 gui_mem_free(void* ptr) {
     __GUI_SYS_PROTECT();                            /* Lock system protection */
 #if GUI_CFG_USE_MEM
-    mem_free(ptr);                                  /* Free already allocated memory */
+    mem_free(PROF_UNTRACK(ptr));                    /* Free already allocated memory */
+#if GUI_CFG_MEM_RELOC && GUI_CFG_USE_IDLE_TASKS
+    if (ptr != NULL && MemRelocCount) {            /* Free space may be filled with movable blocks */
+        guii_idle_add(&compact_task, mem_compact_process, NULL, 0, GUI_CFG_IDLE_SLICE);
+    }
+#endif /* GUI_CFG_MEM_RELOC && GUI_CFG_USE_IDLE_TASKS */
+#else
+    free(PROF_UNTRACK(ptr));
+#endif
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+}
+
+/**
+ * \brief           Allocate memory of specific size with region preference, memory is not reset to zero
+ * \note            Preference is based on order of regions, set with \ref gui_mem_assignmemory
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       hint: Region preference. This parameter can be a value of \ref gui_mem_hint_t enumeration
+ * \return          Allocated memory on success, NULL otherwise
+ */
+void*
+gui_mem_alloc_hint(size_t size, gui_mem_hint_t hint) {
+    void* ptr;
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+#if GUI_CFG_USE_MEM
+    MEM_RECLAIM_RETRY(ptr, size, PROF_TRACK(mem_alloc(PROF_SIZE(size), hint), size)); /* Allocate memory and return pointer */
 #else
-    free(ptr);
+    GUI_UNUSED(hint);
+    MEM_RECLAIM_RETRY(ptr, size, PROF_TRACK(malloc(PROF_SIZE(size)), size));
 #endif
     __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    return ptr;
+}
+
+/**
+ * \brief           Allocate memory of specific size and set memory to zero, with region preference
+ * \note            Preference is based on order of regions, set with \ref gui_mem_assignmemory.
+ *                  Fast memory should be assigned as first region, big but slower memory as last one
+ * \note            When no free block is available in preferred region, memory is allocated from any region
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       num: Number of elements to allocate
+ * \param[in]       size: Size of each element
+ * \param[in]       hint: Region preference. This parameter can be a value of \ref gui_mem_hint_t enumeration
+ * \return          Allocated memory on success, NULL otherwise
+ */
+void*
+gui_mem_calloc_hint(size_t num, size_t size, gui_mem_hint_t hint) {
+    void* ptr;
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+#if GUI_CFG_USE_MEM
+    MEM_RECLAIM_RETRY(ptr, num * size, PROF_TRACK(mem_calloc(1, PROF_SIZE(num * size), hint), num * size)); /* Allocate memory and clear it to 0. Then return pointer */
+#else
+    GUI_UNUSED(hint);
+    MEM_RECLAIM_RETRY(ptr, num * size, PROF_TRACK(calloc(1, PROF_SIZE(num * size)), num * size));
+#endif
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    return ptr;
 }
 
 /**
@@ -474,9 +1336,189 @@ gui_mem_getminfree(void) {
     return mem_getminfree();                        /* Get minimal number of bytes ever available for allocation */
 }
 
+/**
+ * \brief           Get statistics of memory reallocations
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[out]      total: Pointer to variable to save number of reallocations of existing memory to. Can be `NULL`
+ * \param[out]      inplace: Pointer to variable to save number of reallocations done without moving memory to. Can be `NULL`
+ */
+void
+gui_mem_getreallocstats(size_t* total, size_t* inplace) {
+    if (total != NULL) {
+        *total = MemReallocCount;
+    }
+    if (inplace != NULL) {
+        *inplace = MemReallocInPlaceCount;
+    }
+}
+
+/**
+ * \brief           Get fragmentation of free memory
+ * \note            Value is calculated as part of free memory not available in largest free block
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \return          Fragmentation in units of percent, `0` when all free memory is in single block
+ */
+uint8_t
+gui_mem_getfragmentation(void) {
+    size_t avail = mem_getfree();
+    
+    if (!avail) {
+        return 0;
+    }
+    return (uint8_t)(100 - (uint32_t)((uint64_t)mem_getlargestfree() * 100 / avail));
+}
+
+/**
+ * \brief           Get size of largest free block
+ * \note            Allocation bigger than this value fails even when enough free memory is available in total
+ * \return          Size of largest free block in units of bytes
+ */
+size_t
+gui_mem_getlargestfree(void) {
+    size_t ret;
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    ret = mem_getlargestfree();
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    return ret;
+}
+
+#if GUI_CFG_MEM_RELOC || __DOXYGEN__
+
+/**
+ * \brief           Mark allocated memory as movable
+ * \note            Heap compaction may move memory and updates pointer at `ref` to new address.
+ *                  Pointer must stay at the same address while memory is allocated and must not be copied
+ * \note            Movable memory stays movable after \ref gui_mem_realloc, when pointer at `ref` is set to returned value
+ * \note            Available only when \ref GUI_CFG_MEM_RELOC is enabled
+ * \param[in]       ref: Address of pointer to memory returned using \ref gui_mem_alloc,
+ *                      \ref gui_mem_calloc or \ref gui_mem_realloc functions
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_mem_setfixed, gui_mem_compact
+ */
+uint8_t
+gui_mem_setmovable(void** ref) {
+    uint8_t ret;
+    
+    if (ref == NULL || *ref == NULL) {
+        return 0;
+    }
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    ret = mem_setmovable(PROF_RAW(*ref), ref);
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    return ret;
+}
+
+/**
+ * \brief           Mark movable memory as fixed, compaction does not move it anymore
+ * \note            Available only when \ref GUI_CFG_MEM_RELOC is enabled
+ * \param[in]       ptr: Pointer to memory previously marked with \ref gui_mem_setmovable
+ */
+void
+gui_mem_setfixed(void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    mem_setfixed(PROF_RAW(ptr));
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+}
+
+/**
+ * \brief           Move movable memory blocks together to merge free memory
+ * \note            Compaction also runs automatically as idle task after memory is freed,
+ *                  when \ref GUI_CFG_USE_IDLE_TASKS is enabled
+ * \note            Do not call it while pointers to movable memory are used, such as during widget drawing
+ * \note            Available only when \ref GUI_CFG_MEM_RELOC is enabled
+ * \param[in]       max: Maximal number of bytes to move. Use `0` to move all movable blocks possible
+ * \return          Number of moved bytes
+ */
+size_t
+gui_mem_compact(size_t max) {
+    size_t ret;
+    
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    guii_ll_waitready();                            /* Low-level may still read cached bitmaps */
+    ret = mem_compact(max ? max : (size_t)-1);
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    return ret;
+}
+
+#endif /* GUI_CFG_MEM_RELOC || __DOXYGEN__ */
+
+#if GUI_CFG_MEM_PROFILE || __DOXYGEN__
+
+/**
+ * \brief           Set tag for next allocations
+ * \note            Use \ref GUI_MEM_TAGGED macro instead to restore previous tag automatically
+ * \param[in]       tag: Tag name, one of \ref GUI_MEM_TAGS or widget type name. Set to `NULL` for default tag
+ * \return          Previous tag
+ */
+const char*
+guii_mem_settag(const char* tag) {
+    const char* prev;
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    prev = MemTag;
+    MemTag = tag != NULL ? tag : GUI_MEM_TAG_OTHER;
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    return prev;
+}
+
+/**
+ * \brief           Get heap usage per allocation tag
+ * \note            Available only when \ref GUI_CFG_MEM_PROFILE is enabled
+ * \note            Sizes are requested sizes, without allocator and profiler overhead
+ * \param[out]      stats: Array to copy tag statistics to
+ * \param[in]       count: Number of entries in array
+ * \return          Number of copied entries
+ */
+size_t
+gui_mem_gettagstats(gui_mem_tagstat_t* stats, size_t count) {
+    size_t i;
+    
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    for (i = 0; i < count && i < GUI_COUNT_OF(MemTags) && MemTags[i].name != NULL; i++) {
+        memcpy(&stats[i], &MemTags[i], sizeof(*stats));
+    }
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    return i;
+}
+
+/**
+ * \brief           Print heap usage per allocation tag and summary of free memory
+ * \note            Available only when \ref GUI_CFG_MEM_PROFILE is enabled
+ * \param[in]       out: Output function, called once for every line
+ * \param[in]       arg: User argument passed to output function
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_mem_report(gui_mem_output_fn out, void* arg) {
+    gui_mem_tagstat_t stats[GUI_CFG_MEM_PROFILE_TAGS];
+    char str[80];
+    size_t i, cnt;
+    
+    if (out == NULL) {
+        return 0;
+    }
+    cnt = gui_mem_gettagstats(stats, GUI_COUNT_OF(stats));  /* Output may allocate, work on copy */
+    out("tag,bytes,blocks,peak\r\n", arg);
+    for (i = 0; i < cnt; i++) {
+        sprintf(str, "%.32s,%lu,%lu,%lu\r\n", stats[i].name, (unsigned long)stats[i].bytes,
+            (unsigned long)stats[i].blocks, (unsigned long)stats[i].peak);
+        out(str, arg);
+    }
+    sprintf(str, "free %lu, min free %lu, largest free %lu\r\n", (unsigned long)gui_mem_getfree(),
+        (unsigned long)gui_mem_getminfree(), (unsigned long)gui_mem_getlargestfree());
+    out(str, arg);
+    return 1;
+}
+
+#endif /* GUI_CFG_MEM_PROFILE || __DOXYGEN__ */
+
 /**
  * \brief           Assign memory region(s) for allocation functions
  * \note            You can allocate multiple regions by assigning start address and region size in units of bytes
+ * \note            When \ref GUI_CFG_LINKEDLIST_COMPACT is enabled, all regions must end within
+ *                  `65535 * GUI_CFG_MEM_ALIGNMENT` bytes from start of first region
  * \param[in]       regions: Pointer to list of regions to use for allocations
  * \param[in]       len: Number of regions to use
  * \return          `1` on success, `0` otherwise
@@ -484,8 +1526,166 @@ gui_mem_getminfree(void) {
 uint8_t
 gui_mem_assignmemory(const GUI_MEM_Region_t* regions, size_t len) {
     uint8_t ret;
+#if GUI_CFG_LINKEDLIST_COMPACT
+    size_t start;
+
+    if (!len) {
+        return 0;
+    }
+    start = (size_t)regions[0].StartAddress & ~MEM_ALIGN_BITS;
+    if ((size_t)regions[len - 1].StartAddress + regions[len - 1].Size - start > (size_t)0xFFFF * MEM_ALIGN_NUM) {
+        return 0;                                   /* Objects at the end could not be linked with 16-bit index */
+    }
+#endif /* GUI_CFG_LINKEDLIST_COMPACT */
     __GUI_SYS_PROTECT();                            /* Enter GUI */
     ret = mem_assignmem(regions, len);              /* Assign memory */
+#if GUI_CFG_LINKEDLIST_COMPACT
+    if (ret) {
+        guii_linkedlist_base = start - MEM_ALIGN_NUM;   /* Link 0 is reserved for empty link */
+    }
+#endif /* GUI_CFG_LINKEDLIST_COMPACT */
     __GUI_SYS_UNPROTECT();                          /* Leave GUI */
     return ret;                                     
 }
+
+#if GUI_CFG_MEM_RECLAIM || __DOXYGEN__
+
+/**
+ * \brief           Add cache to list of caches releasing memory when allocation fails
+ *
+ *                  When allocation fails, reclaimers are asked from highest priority on
+ *                  and allocation is tried again after each of them released memory
+ *
+ * \note            Adding reclaimer already in list only updates its callback and argument
+ * \param[in,out]   r: Reclaimer entry, owned by caller
+ * \param[in]       fn: Callback releasing memory
+ * \param[in]       arg: User argument for callback
+ * \param[in]       priority: Reclaimer priority, see \ref GUI_MEM_RECLAIM_PRIO for priorities of library caches
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_mem_reclaim_remove
+ */
+uint8_t
+gui_mem_reclaim_add(gui_mem_reclaim_t* r, gui_mem_reclaim_fn fn, void* arg, uint8_t priority) {
+    gui_mem_reclaim_t** p;
+    
+    if (r == NULL || fn == NULL) {
+        return 0;
+    }
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    r->fn = fn;
+    r->arg = arg;
+    if (!r->added) {
+        r->priority = priority;
+        for (p = &MemReclaimList; *p != NULL && (*p)->priority >= priority; p = &(*p)->next) {}
+        r->next = *p;                               /* Same priorities are asked in order of adding */
+        *p = r;
+        r->added = 1;
+    }
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    return 1;
+}
+
+/**
+ * \brief           Remove cache from list of caches releasing memory
+ * \param[in,out]   r: Reclaimer entry previously added with \ref gui_mem_reclaim_add
+ * \return          `1` if removed, `0` if it was not in list
+ */
+uint8_t
+gui_mem_reclaim_remove(gui_mem_reclaim_t* r) {
+    gui_mem_reclaim_t** p;
+    uint8_t ret = 0;
+    
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    for (p = &MemReclaimList; *p != NULL; p = &(*p)->next) {
+        if (*p == r) {
+            *p = r->next;
+            r->added = 0;
+            ret = 1;
+            break;
+        }
+    }
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    return ret;
+}
+
+#endif /* GUI_CFG_MEM_RECLAIM || __DOXYGEN__ */
+
+/**
+ * \brief           Allocate object from fixed-size pool and set it to zero
+ * \note            When pool has no free objects, new object is taken from static memory of pool.
+ *                  Pool without static memory allocates memory for \ref GUI_CFG_MEM_POOL_SLAB_COUNT objects
+ *                  from heap at once. This memory is never returned to heap
+ * \param[in,out]   pool: Pointer to \ref gui_mem_pool_t structure
+ * \return          Pointer to object on success, `NULL` otherwise
+ */
+void*
+gui_mem_pool_alloc(gui_mem_pool_t* pool) {
+#if (GUI_CFG_MEM_POOL && !GUI_CFG_MEM_PROFILE) || GUI_CFG_MEM_STATIC
+    uint8_t* ptr;
+    size_t size, i;
+    
+#if GUI_CFG_MEM_PROFILE
+    if (pool->mem == NULL) {
+        return GUI_MEMALLOC(pool->size);            /* Allocate directly from heap */
+    }
+#endif /* GUI_CFG_MEM_PROFILE */
+    size = GUI_MEM_ALIGN(GUI_MAX(pool->size, sizeof(void *)));  /* Object must hold free list pointer */
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    if (pool->free_list == NULL && pool->mem != NULL) { /* No free objects, take new one from static memory */
+        if (pool->mem->ptr + size > pool->mem->end) {
+            __GUI_SYS_UNPROTECT();                  /* Unlock protection */
+            return NULL;                            /* Static memory is full */
+        }
+        pool->free_list = pool->mem->ptr;
+        *(void **)pool->mem->ptr = NULL;
+        pool->mem->ptr += size;
+        pool->total++;
+    } else if (pool->free_list == NULL) {           /* No free objects, allocate new slab */
+        ptr = gui_mem_calloc_hint(GUI_CFG_MEM_POOL_SLAB_COUNT, size, GUI_MEM_HOT);  /* Pool objects are small and often used */
+        if (ptr == NULL) {
+            __GUI_SYS_UNPROTECT();                  /* Unlock protection */
+            return NULL;
+        }
+        for (i = 0; i < GUI_CFG_MEM_POOL_SLAB_COUNT; i++, ptr += size) {
+            *(void **)ptr = pool->free_list;        /* Add object to free list */
+            pool->free_list = ptr;
+        }
+        pool->total += GUI_CFG_MEM_POOL_SLAB_COUNT;
+    }
+    ptr = pool->free_list;                          /* Take first free object */
+    pool->free_list = *(void **)ptr;
+    pool->used++;
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+    memset(ptr, 0x00, pool->size);                  /* Reset object memory */
+    return ptr;
+#else /* (GUI_CFG_MEM_POOL && !GUI_CFG_MEM_PROFILE) || GUI_CFG_MEM_STATIC */
+    return GUI_MEMALLOC(pool->size);                /* Allocate directly from heap */
+#endif /* !((GUI_CFG_MEM_POOL && !GUI_CFG_MEM_PROFILE) || GUI_CFG_MEM_STATIC) */
+}
+
+/**
+ * \brief           Return object back to fixed-size pool
+ * \param[in,out]   pool: Pointer to \ref gui_mem_pool_t structure object was allocated from
+ * \param[in]       ptr: Pointer to object previously returned with \ref gui_mem_pool_alloc
+ */
+void
+gui_mem_pool_free(gui_mem_pool_t* pool, void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+#if (GUI_CFG_MEM_POOL && !GUI_CFG_MEM_PROFILE) || GUI_CFG_MEM_STATIC
+#if GUI_CFG_MEM_PROFILE
+    if (pool->mem == NULL) {
+        GUI_MEMFREE(ptr);                           /* Free directly to heap */
+        return;
+    }
+#endif /* GUI_CFG_MEM_PROFILE */
+    __GUI_SYS_PROTECT();                            /* Lock system protection */
+    *(void **)ptr = pool->free_list;                /* Add object to free list */
+    pool->free_list = ptr;
+    pool->used--;
+    __GUI_SYS_UNPROTECT();                          /* Unlock protection */
+#else /* (GUI_CFG_MEM_POOL && !GUI_CFG_MEM_PROFILE) || GUI_CFG_MEM_STATIC */
+    GUI_MEMFREE(ptr);                               /* Free directly to heap */
+#endif /* !((GUI_CFG_MEM_POOL && !GUI_CFG_MEM_PROFILE) || GUI_CFG_MEM_STATIC) */
+}
@@ -0,0 +1,216 @@
+/**	
+ * \file            gui_metrics.c
+ * \brief           Metrics snapshot for remote monitoring
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_metrics.h"
+#include "gui/gui_input.h"
+#include "system/gui_sys.h"
+
+#if GUI_CFG_USE_METRICS || __DOXYGEN__
+
+static gui_metrics_t metrics_work;                  /* Counters collected by GUI thread */
+static gui_metrics_t metrics_pub;                   /* Last published snapshot */
+static volatile uint32_t metrics_seq;               /* Odd while snapshot is being written, `0` before first one */
+static uint32_t metrics_last;                       /* Time of last published snapshot */
+
+/**
+ * \brief           Add statistics of redrawn frame to counters
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       frame: Statistics of finished frame
+ */
+void
+guii_metrics_frame(const gui_stats_t* frame) {
+    uint32_t limit = GUI_CFG_METRICS_HIST_BASE;
+    size_t i;
+    
+    for (i = 0; i < GUI_CFG_METRICS_HIST_SIZE - 1 && frame->time_redraw >= limit; i++, limit <<= 1) {}
+    metrics_work.frame_hist[i]++;
+    metrics_work.frames++;
+    metrics_work.time_redraw_max = GUI_MAX(metrics_work.time_redraw_max, frame->time_redraw);
+    metrics_work.widgets_redrawn += frame->widgets_redrawn;
+    metrics_work.dirty_area += frame->dirty_area;
+}
+
+/**
+ * \brief           Publish new snapshot when period has elapsed
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ */
+void
+guii_metrics_process(void) {
+    gui_draw_font_cache_stats_t fc;
+    uint32_t now = gui_sys_now();
+    uint8_t load = 0xFF, result = 0;
+    
+    if (metrics_seq && (uint32_t)(now - metrics_last) < GUI_CFG_METRICS_PERIOD) {
+        return;
+    }
+    metrics_last = now;
+    
+    /* Values of other modules are read only when snapshot is published */
+    gui_draw_font_getcachestats(&fc);
+    metrics_work.glyph_hits = fc.hits;
+    metrics_work.glyph_misses = fc.misses;
+    metrics_work.mem_free = gui_mem_getfree();
+    metrics_work.mem_min_free = gui_mem_getminfree();
+    metrics_work.mem_largest_free = gui_mem_getlargestfree();
+    metrics_work.mem_fragmentation = gui_mem_getfragmentation();
+    if (!gui_ll_control(&GUI.lcd, GUI_LL_Command_GetLoad, &load, &result) || result) {
+        load = 0xFF;                                /* Driver does not measure accelerator */
+    }
+    metrics_work.ll_load = load;
+#if GUI_CFG_USE_TOUCH
+    metrics_work.touch_overflow = gui_input_touchoverflow();
+#endif /* GUI_CFG_USE_TOUCH */
+#if GUI_CFG_USE_KEYBOARD
+    metrics_work.key_overflow = gui_input_keyoverflow();
+#endif /* GUI_CFG_USE_KEYBOARD */
+    metrics_work.time = now;
+    
+    metrics_seq++;                                  /* Readers retry while sequence is odd */
+    GUI_CFG_MEMORY_BARRIER();
+    memcpy(&metrics_pub, &metrics_work, sizeof(metrics_pub));
+    GUI_CFG_MEMORY_BARRIER();
+    metrics_seq++;
+}
+
+/**
+ * \brief           Get last published metrics snapshot
+ * \note            Function does not wait for GUI thread and can be called from any thread.
+ *                  It fails when snapshot was being published during all attempts to read it
+ * \param[out]      m: Pointer to \ref gui_metrics_t structure to fill
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_metrics_get(gui_metrics_t* m) {
+    uint32_t seq;
+    uint8_t i;
+    
+    if (m == NULL) {
+        return 0;
+    }
+    for (i = 0; i < 4; i++) {
+        seq = metrics_seq;
+        GUI_CFG_MEMORY_BARRIER();
+        if (seq && !(seq & 0x01)) {                 /* Snapshot is published and not being written */
+            memcpy(m, &metrics_pub, sizeof(*m));
+            GUI_CFG_MEMORY_BARRIER();
+            if (metrics_seq == seq) {               /* Not changed while copied */
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Convert 64-bit number to decimal string
+ * \param[in]       v: Value to convert
+ * \param[out]      str: Output string of at least `21` bytes
+ */
+static void
+metrics_u64tostr(uint64_t v, char* str) {
+    char tmp[20];
+    size_t i = 0;
+    
+    do {
+        tmp[i++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (i) {
+        *str++ = tmp[--i];
+    }
+    *str = 0;
+}
+
+/**
+ * \brief           Print last published metrics snapshot as text
+ *
+ *                  Every line holds name and value separated by space,
+ *                  histogram entries have upper limit of frame time in braces
+ *
+ * \note            Function does not wait for GUI thread and can be called from any thread
+ * \param[in]       out: Output function, called once for every line
+ * \param[in]       arg: User argument passed to output function
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_metrics_report(gui_metrics_output_fn out, void* arg) {
+    gui_metrics_t m;
+    char str[64], num[21];
+    uint32_t limit = GUI_CFG_METRICS_HIST_BASE;
+    size_t i;
+    
+    if (out == NULL || !gui_metrics_get(&m)) {
+        return 0;
+    }
+    sprintf(str, "gui_time %lu\n", (unsigned long)m.time);
+    out(str, arg);
+    sprintf(str, "gui_frames %lu\n", (unsigned long)m.frames);
+    out(str, arg);
+    for (i = 0; i < GUI_CFG_METRICS_HIST_SIZE; i++, limit <<= 1) {
+        if (i < GUI_CFG_METRICS_HIST_SIZE - 1) {
+            sprintf(str, "gui_frame_time{lt=\"%lu\"} %lu\n", (unsigned long)limit, (unsigned long)m.frame_hist[i]);
+        } else {
+            sprintf(str, "gui_frame_time{lt=\"inf\"} %lu\n", (unsigned long)m.frame_hist[i]);
+        }
+        out(str, arg);
+    }
+    sprintf(str, "gui_frame_time_max %lu\n", (unsigned long)m.time_redraw_max);
+    out(str, arg);
+    sprintf(str, "gui_widgets_redrawn %lu\n", (unsigned long)m.widgets_redrawn);
+    out(str, arg);
+    metrics_u64tostr(m.dirty_area, num);
+    sprintf(str, "gui_dirty_area %s\n", num);
+    out(str, arg);
+    sprintf(str, "gui_glyph_hits %lu\n", (unsigned long)m.glyph_hits);
+    out(str, arg);
+    sprintf(str, "gui_glyph_misses %lu\n", (unsigned long)m.glyph_misses);
+    out(str, arg);
+    sprintf(str, "gui_mem_free %lu\n", (unsigned long)m.mem_free);
+    out(str, arg);
+    sprintf(str, "gui_mem_min_free %lu\n", (unsigned long)m.mem_min_free);
+    out(str, arg);
+    sprintf(str, "gui_mem_largest_free %lu\n", (unsigned long)m.mem_largest_free);
+    out(str, arg);
+    sprintf(str, "gui_mem_fragmentation %u\n", (unsigned)m.mem_fragmentation);
+    out(str, arg);
+    if (m.ll_load != 0xFF) {                        /* Only when reported by low-level */
+        sprintf(str, "gui_ll_load %u\n", (unsigned)m.ll_load);
+        out(str, arg);
+    }
+    sprintf(str, "gui_touch_overflow %lu\n", (unsigned long)m.touch_overflow);
+    out(str, arg);
+    sprintf(str, "gui_key_overflow %lu\n", (unsigned long)m.key_overflow);
+    out(str, arg);
+    return 1;
+}
+
+#endif /* GUI_CFG_USE_METRICS || __DOXYGEN__ */
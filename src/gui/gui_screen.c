@@ -0,0 +1,567 @@
+/**	
+ * \file            gui_screen.c
+ * \brief           Stack of screens with cached pixels
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_screen.h"
+#include "widget/gui_widget.h"
+#include "system/gui_sys.h"
+
+#if GUI_CFG_SCREEN_STACK || __DOXYGEN__
+
+#define S                               GUI.screen
+
+/**
+ * \brief           Get part of screen widget visible on display
+ * \param[in]       h: Screen widget handle
+ * \param[out]      area: Absolute area on display
+ */
+static void
+screen_getarea(gui_handle_p h, gui_display_t* area) {
+    gui_dim_t x, y;
+    
+    x = guii_widget_getabsolutex(h);
+    y = guii_widget_getabsolutey(h);
+    area->x1 = GUI_MAX(x, 0);
+    area->y1 = GUI_MAX(y, 0);
+    area->x2 = GUI_MIN(x + guii_widget_getwidth(h), GUI.lcd.width);
+    area->y2 = GUI_MIN(y + guii_widget_getheight(h), GUI.lcd.height);
+}
+
+/**
+ * \brief           Copy pixels of screen between layer and its buffer
+ * \param[in,out]   e: Screen entry with allocated pixels
+ * \param[in,out]   layer: Drawing layer
+ * \param[in]       save: Set to `1` to copy from layer to buffer or `0` to copy buffer to layer
+ */
+static void
+screen_copy(gui_screen_entry_t* e, gui_layer_t* layer, uint8_t save) {
+    gui_dim_t x, y, w, h;
+    void* pixels;
+    
+    x = e->area.x1;
+    y = e->area.y1;
+    w = e->area.x2 - e->area.x1;
+    h = e->area.y2 - e->area.y1;
+#if GUI_CFG_LCD_ROTATION
+    guii_lcd_maprect(&x, &y, &w, &h);               /* Buffer keeps pixels as they are in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+    pixels = (void *)(layer->start_address + layer->pixel_size * (y * layer->width + x));
+    GUI.ll.Copy(&GUI.lcd, layer,
+        save ? pixels : (void *)e->pixels,          /* Source address */
+        save ? (void *)e->pixels : pixels,          /* Destination address */
+        w, h,                                       /* Area size */
+        save ? layer->width - w : 0,                /* Offline source */
+        save ? 0 : layer->width - w                 /* Offline destination */
+    );
+}
+
+/**
+ * \brief           Free pixels of screen
+ * \param[in,out]   e: Screen entry
+ */
+static void
+screen_release(gui_screen_entry_t* e) {
+    if (e->pixels != NULL) {
+        guii_ll_waitready();                        /* Pixels may still be copied by low-level */
+        GUI_MEMFREE(e->pixels);
+        S.used -= e->size;
+    }
+    e->size = 0;
+    e->changed_count = 0;
+}
+
+#if GUI_CFG_MEM_RECLAIM || __DOXYGEN__
+
+static gui_mem_reclaim_t screen_reclaim;
+
+/**
+ * \brief           Memory reclaimer of screen stack, pixels of oldest screens are released first
+ * \note            Pixels of screen shown by last pop are kept until they are copied to display
+ * \param[in]       size: Number of bytes of failed allocation
+ * \param[in]       arg: Unused
+ * \return          Number of released bytes
+ */
+static size_t
+screen_reclaim_fn(size_t size, void* arg) {
+    size_t released = 0, i;
+    
+    GUI_UNUSED(arg);
+    for (i = 0; i < S.count - (S.restore ? 1 : 0) && released < size; i++) {
+        released += S.stack[i].size;
+        screen_release(&S.stack[i]);
+    }
+    return released;
+}
+
+#endif /* GUI_CFG_MEM_RECLAIM || __DOXYGEN__ */
+
+/**
+ * \brief           Remove screen from stack
+ * \param[in]       index: Index of screen on stack
+ */
+static void
+screen_removeat(size_t index) {
+    screen_release(&S.stack[index]);
+    S.count--;
+    memmove(&S.stack[index], &S.stack[index + 1], sizeof(S.stack[0]) * (S.count - index));
+}
+
+/**
+ * \brief           Draw screen shown by last pop completely on next frame
+ *
+ *                  Used when screens change again before its pixels were copied to display
+ */
+static void
+screen_cancelrestore(void) {
+    if (S.restore) {
+        S.restore = 0;
+        screen_release(&S.stack[S.count - 1]);
+        guii_widget_invalidate(S.stack[S.count - 1].h);
+    }
+}
+
+/**
+ * \brief           Check if pixels of visible screen can be copied from display memory
+ * \param[in]       e: Screen entry with area set
+ * \return          `1` if pixels are valid, `0` otherwise
+ */
+static uint8_t
+screen_cancache(gui_screen_entry_t* e) {
+    gui_handle_p h;
+    
+    if (GUI.ll.Copy == NULL || GUI.BatchLevel || e->area.x1 >= e->area.x2 || e->area.y1 >= e->area.y2
+        || guii_widget_ishidden(e->h) || guii_widget_isparenthidden(e->h) || !guii_widget_iscontentopaque(e->h)) {
+        return 0;
+    }
+#if GUI_CFG_USE_TRANSPARENCY
+    for (h = e->h; h != NULL; h = guii_widget_getparent(h)) {   /* Blended pixels depend on widgets below */
+        if (guii_widget_istransparent(h)) {
+            return 0;
+        }
+    }
+#endif /* GUI_CFG_USE_TRANSPARENCY */
+#if GUI_CFG_SPRITE_COUNT
+    if (guii_sprite_isactive()) {                   /* Last frame may include sprite */
+        return 0;
+    }
+#endif /* GUI_CFG_SPRITE_COUNT */
+#if GUI_CFG_USE_TRANSITION
+    if (guii_transition_isactive()) {               /* Last frame includes parts of other screen */
+        return 0;
+    }
+#endif /* GUI_CFG_USE_TRANSITION */
+#if GUI_CFG_USE_DEBUG_OVERLAY
+    if (GUI.Overlay) {                              /* Last frame includes borders of redrawn regions */
+        return 0;
+    }
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY */
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE
+    {
+        size_t i;
+        
+        for (i = 0; i < GUI.ScrollCount; i++) {     /* Scrolled pixels are moved on next frame */
+            h = GUI.ScrollList[i].h;
+            if (h == e->h || guii_widget_ischildof(h, e->h)) {
+                return 0;
+            }
+        }
+    }
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE */
+    GUI_UNUSED(h);
+    return 1;
+}
+
+/**
+ * \brief           Move focus out of screen without invalidating focused widgets
+ *
+ *                  Saved pixels show widgets in focus, the same focus is set back
+ *                  when screen is shown from saved pixels
+ *
+ * \param[in,out]   e: Screen entry being hidden
+ */
+static void
+screen_focusout(gui_screen_entry_t* e) {
+    gui_handle_p h, parent;
+    
+    e->focus = NULL;
+    if (GUI.FocusedWidget == NULL || (GUI.FocusedWidget != e->h && !guii_widget_ischildof(GUI.FocusedWidget, e->h))) {
+        return;
+    }
+    e->focus = GUI.FocusedWidget;
+    parent = guii_widget_getparent(e->h);
+    for (h = e->focus; h != parent; h = guii_widget_getparent(h)) {
+        guii_widget_clrflag(h, GUI_FLAG_FOCUS);
+        guii_widget_callback(h, GUI_WC_FocusOut, NULL, NULL);
+    }
+    GUI.FocusedWidget = parent;                     /* Parent is in focus already */
+}
+
+/**
+ * \brief           Set focus back to widget focused when screen was hidden
+ * \param[in,out]   e: Screen entry shown from saved pixels
+ */
+static void
+screen_focusin(gui_screen_entry_t* e) {
+    gui_handle_p h, parent;
+    
+    parent = guii_widget_getparent(e->h);
+    if (e->focus == NULL || GUI.FocusedWidget != parent) { /* Focus moved to other widget meanwhile */
+        return;
+    }
+    GUI.FocusedWidget = e->focus;
+    for (h = e->focus; h != parent; h = guii_widget_getparent(h)) {
+        guii_widget_setflag(h, GUI_FLAG_FOCUS);
+        guii_widget_callback(h, GUI_WC_FocusIn, NULL, NULL);
+    }
+    e->focus = NULL;
+}
+
+/**
+ * \brief           Copy pixels of screen from display memory to its buffer
+ *
+ *                  Pixels of oldest screens are released when memory budget is exceeded
+ *
+ * \param[in,out]   e: Screen entry with area set
+ */
+static void
+screen_save(gui_screen_entry_t* e) {
+    size_t i, size;
+    
+    size = (size_t)(e->area.x2 - e->area.x1) * (size_t)(e->area.y2 - e->area.y1) * GUI.lcd.active_layer->pixel_size;
+    if (size > GUI_CFG_SCREEN_CACHE_SIZE) {
+        e->changed_count = 0;
+        return;
+    }
+    for (i = 0; i < S.count && S.used + size > GUI_CFG_SCREEN_CACHE_SIZE; i++) {
+        screen_release(&S.stack[i]);
+    }
+#if GUI_CFG_MEM_RECLAIM
+    if (!screen_reclaim.added) {
+        gui_mem_reclaim_add(&screen_reclaim, screen_reclaim_fn, NULL, GUI_MEM_RECLAIM_PRIO_SCREEN);
+    }
+#endif /* GUI_CFG_MEM_RECLAIM */
+    GUI_MEM_TAGGED(GUI_MEM_TAG_SCREEN, e->pixels = GUI_MEMALLOC_NOZERO_HINT(size, GUI_MEM_BULK));
+    if (e->pixels == NULL) {
+        e->changed_count = 0;
+        return;
+    }
+    e->size = size;
+    S.used += size;
+#if GUI_CFG_LCD_ROTATION
+    e->rotation = GUI.lcd.rotation;
+#endif /* GUI_CFG_LCD_ROTATION */
+    screen_copy(e, GUI.lcd.active_layer, 1);         /* Screen is still on display */
+}
+
+/**
+ * \brief           Check if saved pixels of screen can replace hidden screen
+ * \param[in]       e: Screen entry to show again
+ * \param[in]       h: Widget handle of screen being hidden
+ * \return          `1` if pixels are valid, `0` otherwise
+ */
+static uint8_t
+screen_canrestore(gui_screen_entry_t* e, gui_handle_p h) {
+    gui_display_t area, hidden;
+    
+    if (e->pixels == NULL || GUI.BatchLevel) {
+        return 0;
+    }
+#if GUI_CFG_LCD_ROTATION
+    if (e->rotation != GUI.lcd.rotation) {
+        return 0;
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    screen_getarea(e->h, &area);
+    screen_getarea(h, &hidden);
+    return !memcmp(&area, &e->area, sizeof(area))   /* Screen did not move */
+        && (hidden.x1 >= hidden.x2 || hidden.y1 >= hidden.y2    /* Hidden screen is covered by copied pixels */
+            || (hidden.x1 >= area.x1 && hidden.y1 >= area.y1 && hidden.x2 <= area.x2 && hidden.y2 <= area.y2));
+}
+
+/**
+ * \brief           Invalidate visible widgets drawn over screen area
+ *
+ *                  Copied pixels include widgets above screen as they were when it was hidden
+ *
+ * \param[in]       e: Screen entry shown again
+ */
+static void
+screen_invalidateabove(gui_screen_entry_t* e) {
+    gui_handle_p h, o;
+    gui_dim_t x, y;
+    
+    for (h = e->h; h != NULL; h = guii_widget_getparent(h)) {
+        for (o = gui_linkedlist_widgetgetnext(NULL, h); o != NULL; o = gui_linkedlist_widgetgetnext(NULL, o)) {
+            if (guii_widget_isvisible(o)) {
+                x = guii_widget_getabsolutex(o);
+                y = guii_widget_getabsolutey(o);
+                if (x < e->area.x2 && x + guii_widget_getwidth(o) > e->area.x1
+                    && y < e->area.y2 && y + guii_widget_getheight(o) > e->area.y1) {
+                    guii_widget_invalidate(o);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Show new screen on top of screen stack
+ *
+ *                  Screen currently on top is hidden and its pixels are kept in RAM if possible.
+ *                  When screen is already on stack, it is moved to top
+ *
+ * \note            Oldest screen is removed from stack when stack is full
+ * \param[in]       h: Widget handle of new screen
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_screen_pop
+ */
+uint8_t
+gui_screen_push(gui_handle_p h) {
+    gui_screen_entry_t* e;
+    size_t i;
+    uint8_t cache;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    screen_cancelrestore();
+    if (!S.count || S.stack[S.count - 1].h != h) {
+        for (i = 0; i < S.count; i++) {             /* Screen is moved to top */
+            if (S.stack[i].h == h) {
+                screen_removeat(i);
+                break;
+            }
+        }
+        if (S.count == GUI_COUNT_OF(S.stack)) {     /* Oldest screen is not kept anymore */
+            screen_removeat(0);
+        }
+        if (S.count) {
+            e = &S.stack[S.count - 1];
+            screen_getarea(e->h, &e->area);
+            e->changed_count = 0;
+            cache = screen_cancache(e);
+            if (cache) {
+                for (i = 0; i < GUI.DirtyRectsCount; i++) { /* Regions not drawn yet are drawn when screen is shown */
+                    guii_widget_addrect(e->changed, &e->changed_count, GUI_CFG_DISPLAY_DIRTY_RECTS,
+                        GUI_MAX(GUI.DirtyRects[i].x1, e->area.x1), GUI_MAX(GUI.DirtyRects[i].y1, e->area.y1),
+                        GUI_MIN(GUI.DirtyRects[i].x2, e->area.x2), GUI_MIN(GUI.DirtyRects[i].y2, e->area.y2));
+                }
+            }
+            if (cache) {
+                screen_focusout(e);
+            }
+            guii_widget_hide(e->h);                 /* Hidden screen releases its pixels, save them afterwards */
+            if (cache) {
+                screen_save(e);
+            }
+        }
+        e = &S.stack[S.count++];
+        memset(e, 0x00, sizeof(*e));
+        e->h = h;
+    }
+    guii_widget_show(h);
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Hide screen on top of screen stack and show previous one
+ *
+ *                  When pixels of previous screen are kept, they are copied to display on next frame
+ *                  and only widgets changed while it was hidden are drawn again.
+ *                  Hidden screen is removed from stack
+ *
+ * \return          `1` on success, `0` if stack is empty
+ * \sa              gui_screen_push
+ */
+uint8_t
+gui_screen_pop(void) {
+    gui_screen_entry_t* e;
+    gui_handle_p h;
+    size_t i;
+    uint8_t ret = 0;
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    screen_cancelrestore();
+    if (S.count) {
+        h = S.stack[S.count - 1].h;
+        screen_removeat(S.count - 1);
+        if (S.count) {
+            e = &S.stack[S.count - 1];
+            if (screen_canrestore(e, h)) {          /* Copy pixels and draw only changed areas */
+                guii_widget_setvisiblequiet(h, 0);
+                guii_widget_setvisiblequiet(e->h, 1);
+                screen_focusin(e);
+                for (i = 0; i < e->changed_count; i++) {
+                    guii_widget_invalidatearea(e->h, &e->changed[i]);
+                }
+                screen_invalidateabove(e);
+                S.restore = 1;
+                GUI.flags |= GUI_FLAG_REDRAW;       /* Pixels are copied on next frame */
+            } else {
+                screen_release(e);
+                guii_widget_hide(h);
+                guii_widget_show(e->h);
+            }
+        } else {
+            guii_widget_hide(h);
+        }
+        ret = 1;
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Get screen on top of screen stack
+ * \return          Widget handle of visible screen or `NULL` if stack is empty
+ */
+gui_handle_p
+gui_screen_gettop(void) {
+    gui_handle_p h = NULL;
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (S.count) {
+        h = S.stack[S.count - 1].h;
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return h;
+}
+
+/**
+ * \brief           Record change of hidden widget for screens with saved pixels
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by widget invalidation when widget itself or any of its parents is hidden.
+ *                  Area of changed widget inside screen is drawn again when screen is shown.
+ *                  Pixels are released when screen widget itself changes
+ * \param[in]       h: Invalidated widget handle
+ */
+void
+guii_screen_invalidated(gui_handle_p h) {
+    gui_screen_entry_t* e;
+    gui_dim_t x, y;
+    size_t i;
+    
+    for (i = 0; i < S.count; i++) {
+        e = &S.stack[i];
+        if (e->pixels == NULL) {
+            continue;
+        }
+        if (e->h == h) {
+            screen_release(e);
+        } else if (guii_widget_ischildof(h, e->h)) {
+            x = guii_widget_getabsolutex(h);
+            y = guii_widget_getabsolutey(h);
+            guii_widget_addrect(e->changed, &e->changed_count, GUI_CFG_DISPLAY_DIRTY_RECTS,
+                GUI_MAX(x, e->area.x1), GUI_MAX(y, e->area.y1),
+                GUI_MIN(x + guii_widget_getwidth(h), e->area.x2), GUI_MIN(y + guii_widget_getheight(h), e->area.y2));
+        }
+    }
+}
+
+/**
+ * \brief           Remove deleted widget from screen stack
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle being removed
+ */
+void
+guii_screen_remove(gui_handle_p h) {
+    size_t i;
+    
+    for (i = 0; i < S.count; i++) {
+        if (S.stack[i].focus == h) {                /* Focus is not set back to removed widget */
+            S.stack[i].focus = NULL;
+        }
+    }
+    for (i = 0; i < S.count; i++) {
+        if (S.stack[i].h == h) {
+            if (i == S.count - 1) {
+                S.restore = 0;
+            }
+            screen_removeat(i);
+            return;
+        }
+    }
+}
+
+/**
+ * \brief           Copy pixels of screen shown by last pop to drawing layer
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack after regions of last frame are copied, before widgets are drawn in dirty regions
+ * \param[in,out]   dst: Layer with frame being drawn
+ */
+void
+guii_screen_draw(gui_layer_t* dst) {
+    gui_screen_entry_t* e;
+    gui_display_t area;
+    
+    if (!S.restore) {
+        return;
+    }
+    e = &S.stack[S.count - 1];
+    screen_getarea(e->h, &area);
+    if (e->pixels == NULL || memcmp(&area, &e->area, sizeof(area))
+#if GUI_CFG_LCD_ROTATION
+        || e->rotation != GUI.lcd.rotation
+#endif /* GUI_CFG_LCD_ROTATION */
+        ) {                                         /* Screen changed completely and is drawn by widgets */
+        screen_release(e);
+        S.restore = 0;
+        return;
+    }
+    screen_copy(e, dst, 0);
+}
+
+/**
+ * \brief           Finish copy of screen shown by last pop
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack when regions drawn in frame are set to layer.
+ *                  Copied area is added to them, pixels are released as screen is visible again
+ * \param[in,out]   dst: Layer with frame being drawn
+ */
+void
+guii_screen_drawdone(gui_layer_t* dst) {
+    gui_screen_entry_t* e;
+    
+    if (!S.restore) {
+        return;
+    }
+    e = &S.stack[S.count - 1];
+    guii_widget_addrect(dst->display, &dst->display_count, GUI_CFG_DISPLAY_DIRTY_RECTS,
+        e->area.x1, e->area.y1, e->area.x2, e->area.y2);
+    screen_release(e);
+    S.restore = 0;
+}
+
+#endif /* GUI_CFG_SCREEN_STACK || __DOXYGEN__ */
@@ -0,0 +1,320 @@
+/**	
+ * \file            gui_sprite.c
+ * \brief           Sprites composited over widgets
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_sprite.h"
+#include "widget/gui_widget.h"
+#include "system/gui_sys.h"
+
+#if GUI_CFG_SPRITE_COUNT || __DOXYGEN__
+
+#define SPRITE_FLAG_USED                0x01        /*!< Sprite entry is allocated */
+#define SPRITE_FLAG_VISIBLE             0x02        /*!< Sprite is drawn on next frame */
+#define SPRITE_FLAG_DRAWN               0x04        /*!< Sprite is drawn on last frame, pixels below it are saved */
+#define SPRITE_FLAG_REMOVE              0x08        /*!< Sprite is freed after its pixels are restored */
+
+static gui_sprite_t sprites[GUI_CFG_SPRITE_COUNT];
+#if GUI_CFG_OS
+static gui_mbox_msg_t msg_sprite = { GUI_SYS_MBOX_TYPE_INVALIDATE };
+#endif /* GUI_CFG_OS */
+
+/**
+ * \brief           Notify GUI stack that frame must be drawn again
+ */
+static void
+sprite_changed(void) {
+    GUI.flags |= GUI_FLAG_REDRAW;
+#if GUI_CFG_OS
+    __GUI_WAKEUP(&msg_sprite);
+#endif /* GUI_CFG_OS */
+}
+
+/**
+ * \brief           Allocate sprite entry and memory for pixels below it
+ * \param[in]       width: Sprite width in units of pixels
+ * \param[in]       height: Sprite height in units of pixels
+ * \return          Sprite handle on success, `NULL` otherwise
+ */
+static gui_sprite_p
+sprite_alloc(gui_dim_t width, gui_dim_t height) {
+    gui_sprite_p s = NULL;
+    size_t i;
+    
+    /* Band buffer does not keep frame, frame buffer of rasterizer thread is not accessed */
+    if (GUI_CFG_LCD_BAND || GUI_CFG_OS_RENDER_THREAD || GUI.ll.Copy == NULL || width <= 0 || height <= 0) {
+        return NULL;
+    }
+    for (i = 0; i < GUI_COUNT_OF(sprites); i++) {
+        if (!sprites[i].flags) {
+            s = &sprites[i];
+            break;
+        }
+    }
+    if (s == NULL) {
+        return NULL;
+    }
+    memset(s, 0x00, sizeof(*s));
+    GUI_MEM_TAGGED(GUI_MEM_TAG_SPRITE,
+        s->under = GUI_MEMALLOC_NOZERO_HINT((size_t)width * (size_t)height * GUI.lcd.drawing_layer->pixel_size, GUI_MEM_BULK));
+    if (s->under == NULL) {
+        return NULL;
+    }
+    s->width = width;
+    s->height = height;
+    s->flags = SPRITE_FLAG_USED;
+    return s;
+}
+
+/**
+ * \brief           Copy rectangle between layer and sprite buffer
+ * \param[in,out]   s: Sprite handle
+ * \param[in,out]   layer: Drawing layer
+ * \param[in]       save: Set to `1` to copy from layer to buffer or `0` to copy buffer back to layer
+ */
+static void
+sprite_copy(gui_sprite_p s, gui_layer_t* layer, uint8_t save) {
+    gui_dim_t x, y, width, height;
+    void* pixels;
+    
+    x = s->drawn.x1;
+    y = s->drawn.y1;
+    width = s->drawn.x2 - s->drawn.x1;
+    height = s->drawn.y2 - s->drawn.y1;
+#if GUI_CFG_LCD_ROTATION
+    guii_lcd_maprect(&x, &y, &width, &height);      /* Copy rectangle as it is in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+    pixels = (void *)(layer->start_address + layer->pixel_size * (y * layer->width + x));
+    GUI.ll.Copy(&GUI.lcd, layer,
+        save ? pixels : s->under,                   /* Source address */
+        save ? s->under : pixels,                   /* Destination address */
+        width, height,                              /* Area size */
+        save ? layer->width - width : 0,            /* Offline source */
+        save ? 0 : layer->width - width             /* Offline destination */
+    );
+}
+
+/**
+ * \brief           Create new sprite from image
+ * \note            Sprite is hidden after creation, use \ref gui_sprite_setvisible to show it
+ * \param[in]       img: Pointer to image. It must stay valid until sprite is removed
+ * \return          Sprite handle on success, `NULL` otherwise
+ * \sa              gui_sprite_createfilled, gui_sprite_remove
+ */
+gui_sprite_p
+gui_sprite_create(const gui_image_desc_t* img) {
+    gui_sprite_p s;
+    
+    __GUI_ASSERTPARAMS(img != NULL);                /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    s = sprite_alloc(img->x_size, img->y_size);
+    if (s != NULL) {
+        s->img = img;
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return s;
+}
+
+/**
+ * \brief           Create new sprite as filled rectangle, for example text cursor
+ * \note            Sprite is hidden after creation, use \ref gui_sprite_setvisible to show it
+ * \param[in]       width: Sprite width in units of pixels
+ * \param[in]       height: Sprite height in units of pixels
+ * \param[in]       color: Fill color
+ * \return          Sprite handle on success, `NULL` otherwise
+ * \sa              gui_sprite_create, gui_sprite_remove
+ */
+gui_sprite_p
+gui_sprite_createfilled(gui_dim_t width, gui_dim_t height, gui_color_t color) {
+    gui_sprite_p s;
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    s = sprite_alloc(width, height);
+    if (s != NULL) {
+        s->color = color;
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return s;
+}
+
+/**
+ * \brief           Set absolute position of sprite on screen
+ * \param[in,out]   s: Sprite handle
+ * \param[in]       x: X position in units of pixels
+ * \param[in]       y: Y position in units of pixels
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sprite_setposition(gui_sprite_p s, gui_dim_t x, gui_dim_t y) {
+    __GUI_ASSERTPARAMS(s != NULL && (s->flags & SPRITE_FLAG_USED)); /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (s->x != x || s->y != y) {
+        s->x = x;
+        s->y = y;
+        if (s->flags & SPRITE_FLAG_VISIBLE) {
+            sprite_changed();
+        }
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Show or hide sprite
+ * \param[in,out]   s: Sprite handle
+ * \param[in]       visible: Set to `1` to show sprite or `0` to hide it
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sprite_setvisible(gui_sprite_p s, uint8_t visible) {
+    __GUI_ASSERTPARAMS(s != NULL && (s->flags & SPRITE_FLAG_USED) && !(s->flags & SPRITE_FLAG_REMOVE));   /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (!visible != !(s->flags & SPRITE_FLAG_VISIBLE)) {
+        if (visible) {
+            s->flags |= SPRITE_FLAG_VISIBLE;
+        } else {
+            s->flags &= ~SPRITE_FLAG_VISIBLE;
+        }
+        sprite_changed();
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Remove sprite from screen and free its memory
+ * \note            Memory is freed on next frame, when pixels below sprite are copied back
+ * \param[in]       s: Sprite handle. It must not be used after function call
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sprite_remove(gui_sprite_p s) {
+    __GUI_ASSERTPARAMS(s != NULL && (s->flags & SPRITE_FLAG_USED) && !(s->flags & SPRITE_FLAG_REMOVE));   /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    s->flags &= ~SPRITE_FLAG_VISIBLE;
+    s->flags |= SPRITE_FLAG_REMOVE;
+    sprite_changed();
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Copy saved pixels back to areas covered by sprites on last frame
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack after unchanged regions are copied from last frame, before widgets are drawn.
+ *                  Copied regions include sprites drawn on last frame, they are removed here
+ * \param[in,out]   dst: Layer with frame being drawn
+ */
+void
+guii_sprite_restore(gui_layer_t* dst) {
+    gui_sprite_p s;
+    size_t i;
+    
+    for (i = 0; i < GUI_COUNT_OF(sprites); i++) {
+        s = &sprites[i];
+        if (!(s->flags & SPRITE_FLAG_DRAWN)) {
+            continue;
+        }
+        /* Screen might be rotated since last frame, all widgets are drawn again in this case */
+        if (s->drawn.x2 <= GUI.lcd.width && s->drawn.y2 <= GUI.lcd.height) {
+            sprite_copy(s, dst, 0);
+        }
+    }
+}
+
+/**
+ * \brief           Save pixels below visible sprites and draw them
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack when frame is finished, before drawing layer is set as active.
+ *                  Areas of sprites on last and this frame are added to list of regions changed on drawing layer
+ * \param[in,out]   dst: Layer with frame being drawn
+ */
+void
+guii_sprite_draw(gui_layer_t* dst) {
+    gui_display_t disp;
+    gui_sprite_p s;
+    size_t i;
+    
+    disp.x1 = 0;
+    disp.y1 = 0;
+    disp.x2 = GUI.lcd.width;
+    disp.y2 = GUI.lcd.height;
+    for (i = 0; i < GUI_COUNT_OF(sprites); i++) {
+        s = &sprites[i];
+        if (s->flags & SPRITE_FLAG_DRAWN) {         /* Restored area differs from last frame */
+            guii_widget_addrect(dst->display, &dst->display_count, GUI_CFG_DISPLAY_DIRTY_RECTS, s->drawn.x1, s->drawn.y1, s->drawn.x2, s->drawn.y2);
+            s->flags &= ~SPRITE_FLAG_DRAWN;
+        }
+        if (s->flags & SPRITE_FLAG_REMOVE) {
+            guii_ll_waitready();                    /* Pixels may still be copied by low-level */
+            GUI_MEMFREE(s->under);
+            s->flags = 0;
+            continue;
+        }
+        if (!(s->flags & SPRITE_FLAG_VISIBLE)) {
+            continue;
+        }
+        s->drawn.x1 = GUI_MAX(s->x, disp.x1);      /* Only part on screen is saved and drawn */
+        s->drawn.y1 = GUI_MAX(s->y, disp.y1);
+        s->drawn.x2 = GUI_MIN(s->x + s->width, disp.x2);
+        s->drawn.y2 = GUI_MIN(s->y + s->height, disp.y2);
+        if (s->drawn.x1 >= s->drawn.x2 || s->drawn.y1 >= s->drawn.y2) {
+            continue;
+        }
+        sprite_copy(s, dst, 1);                     /* Save pixels of finished frame */
+        if (s->img != NULL) {
+            gui_draw_image(&disp, s->x, s->y, s->img);
+        } else {
+            gui_draw_filledrectangle(&disp, s->x, s->y, s->width, s->height, s->color);
+        }
+        guii_widget_addrect(dst->display, &dst->display_count, GUI_CFG_DISPLAY_DIRTY_RECTS, s->drawn.x1, s->drawn.y1, s->drawn.x2, s->drawn.y2);
+        s->flags |= SPRITE_FLAG_DRAWN;
+    }
+}
+
+/**
+ * \brief           Check if any sprite is on screen or will be drawn on next frame
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Pixels of last frame can not be moved when sprite is active, they might include sprite
+ * \return          `1` if sprite is active, `0` otherwise
+ */
+uint8_t
+guii_sprite_isactive(void) {
+    size_t i;
+    
+    for (i = 0; i < GUI_COUNT_OF(sprites); i++) {
+        if (sprites[i].flags & (SPRITE_FLAG_VISIBLE | SPRITE_FLAG_DRAWN)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif /* GUI_CFG_SPRITE_COUNT || __DOXYGEN__ */
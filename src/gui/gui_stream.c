@@ -0,0 +1,281 @@
+/**	
+ * \file            gui_stream.c
+ * \brief           Images streamed from file system
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_stream.h"
+#include "gui/gui_assets.h"
+#include "widget/gui_widget.h"
+#include "system/gui_sys.h"
+
+#if GUI_CFG_USE_STREAM || __DOXYGEN__
+
+#if GUI_CFG_OS
+static gui_sys_thread_t stream_thread_id;   /* I/O thread reading image files */
+static gui_sys_mbox_t stream_mbox;          /* Images waiting for I/O thread */
+#else /* GUI_CFG_OS */
+static gui_stream_image_t* stream_list;     /* Images waiting for idle task, first one is being loaded */
+static gui_idle_task_t stream_task;
+#endif /* !GUI_CFG_OS */
+
+/**
+ * \brief           Finish image load and release memory when load failed or image was released
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       s: Streamed image
+ * \param[in]       state: Final state of load, \ref GUI_STREAM_READY or \ref GUI_STREAM_ERROR
+ */
+static void
+stream_finish(gui_stream_image_t* s, gui_stream_state_t state) {
+    if (s->cancel || state != GUI_STREAM_READY) {
+        if (s->data != NULL) {
+            GUI_MEMFREE(s->data);
+            s->data = NULL;
+        }
+        s->state = s->cancel ? GUI_STREAM_IDLE : state;
+        s->cancel = 0;
+        return;
+    }
+    s->desc.image = s->data;                        /* Image can be drawn from now on */
+    s->state = GUI_STREAM_READY;
+    if (s->h != NULL) {
+        guii_widget_setinvalidatewithparent(s->h, s->desc.bpp == 32);
+        guii_widget_invalidatewithparent(s->h);     /* Replace placeholder with image */
+    }
+}
+
+/**
+ * \brief           Read image header or next chunk of pixels
+ * \note            File is read without GUI protection, it is activated only to allocate memory and finish load
+ * \param[in]       s: Streamed image
+ * \return          `1` when more chunks are waiting, `0` when load is finished
+ */
+static uint8_t
+stream_step(gui_stream_image_t* s) {
+    gui_assets_image_t hdr;
+    size_t len;
+    
+    if (s->cancel) {
+        __GUI_ENTER();
+        stream_finish(s, GUI_STREAM_IDLE);
+        __GUI_LEAVE();
+        return 0;
+    }
+    if (s->data == NULL) {                          /* Header is read first */
+        if (!s->read(s->file, s->offset, &hdr, sizeof(hdr))
+            || !hdr.x_size || !hdr.y_size || !hdr.bpp || hdr.bpp > 32) {
+            __GUI_ENTER();
+            stream_finish(s, GUI_STREAM_ERROR);
+            __GUI_LEAVE();
+            return 0;
+        }
+        __GUI_ENTER();
+        s->size = (((uint32_t)hdr.x_size * hdr.bpp + 7) / 8) * hdr.y_size;
+        GUI_MEM_TAGGED(GUI_MEM_TAG_STREAM, s->data = GUI_MEMALLOC_NOZERO(s->size));
+        if (s->data == NULL) {
+            stream_finish(s, GUI_STREAM_ERROR);     /* No memory for pixels */
+        } else {
+            s->desc.x_size = hdr.x_size;
+            s->desc.y_size = hdr.y_size;
+            s->desc.bpp = hdr.bpp;
+            s->state = GUI_STREAM_LOADING;
+        }
+        __GUI_LEAVE();
+        return s->data != NULL;
+    }
+    
+    len = GUI_MIN(GUI_CFG_STREAM_CHUNK, s->size - s->loaded);
+    if (!s->read(s->file, s->offset + sizeof(hdr) + s->loaded, s->data + s->loaded, len)) {
+        __GUI_ENTER();
+        stream_finish(s, GUI_STREAM_ERROR);
+        __GUI_LEAVE();
+        return 0;
+    }
+    s->loaded += len;
+    if (s->loaded < s->size) {
+        return 1;
+    }
+    __GUI_ENTER();
+    stream_finish(s, GUI_STREAM_READY);
+    __GUI_LEAVE();
+    return 0;
+}
+
+#if GUI_CFG_OS || __DOXYGEN__
+
+/**
+ * \brief           I/O thread loading queued images one after another
+ * \param[in]       arg: Unused
+ */
+static void
+stream_thread(void* const arg) {
+    gui_stream_image_t* s;
+    
+    GUI_UNUSED(arg);
+    while (1) {
+        gui_sys_mbox_get(&stream_mbox, (void **)&s, 0);
+        while (stream_step(s)) {}
+    }
+}
+
+#else /* GUI_CFG_OS || __DOXYGEN__ */
+
+/**
+ * \brief           Idle task reading chunks of queued images
+ * \param[in]       budget: Time available for reading, in units of microseconds
+ * \param[in]       arg: Unused
+ * \return          `1` when more images are waiting, `0` otherwise
+ */
+static uint8_t
+stream_process(uint32_t budget, void* arg) {
+    uint32_t start = GUI_CFG_IDLE_TIME();
+    
+    GUI_UNUSED(arg);
+    while (stream_list != NULL) {
+        if (!stream_step(stream_list)) {
+            stream_list = stream_list->next;        /* Continue with next image */
+        }
+        if (GUI_CFG_IDLE_TIME() - start >= budget) {
+            break;
+        }
+    }
+    return stream_list != NULL;
+}
+
+#endif /* !(GUI_CFG_OS || __DOXYGEN__) */
+
+/**
+ * \brief           Start loading image from file
+ * \note            Function returns immediately, file is read in background.
+ *                  Descriptor `s->desc` has no pixels and widget draws placeholder until load is finished
+ * \note            With \ref GUI_CFG_OS, function blocks when \ref GUI_CFG_STREAM_QUEUE loads already wait for I/O thread
+ * \param[in]       s: Streamed image structure, owned by user
+ * \param[in]       read: File read function, called from I/O thread or GUI thread without operating system
+ * \param[in]       file: File handle passed to read function
+ * \param[in]       offset: Offset of image header in file, in units of bytes
+ * \param[in]       h: Image widget invalidated when image is ready. Set to `NULL` if not used
+ * \return          `1` on success, `0` when image is already loading or load cannot be started
+ * \sa              gui_stream_image_release
+ */
+uint8_t
+gui_stream_image_load(gui_stream_image_t* s, gui_stream_read_fn read, void* file, uint32_t offset, gui_handle_p h) {
+    uint8_t ret = 0;
+    
+    __GUI_ASSERTPARAMS(s != NULL && read != NULL);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    if (s->state != GUI_STREAM_QUEUED && s->state != GUI_STREAM_LOADING) {
+        if (s->data != NULL) {
+            GUI_MEMFREE(s->data);                   /* Image is loaded again */
+        }
+        memset(s, 0x00, sizeof(*s));
+        s->read = read;
+        s->file = file;
+        s->offset = offset;
+        s->h = h;
+        s->state = GUI_STREAM_QUEUED;
+        ret = 1;
+#if GUI_CFG_OS
+        if (stream_thread_id == NULL) {             /* Start I/O thread on first load */
+            if (!gui_sys_mbox_create(&stream_mbox, GUI_CFG_STREAM_QUEUE)
+                || !gui_sys_thread_create(&stream_thread_id, "gui_stream", stream_thread, NULL, GUI_SYS_THREAD_SS, GUI_SYS_THREAD_PRIO)) {
+                s->state = GUI_STREAM_ERROR;
+                ret = 0;
+            }
+        }
+#else /* GUI_CFG_OS */
+        {
+            gui_stream_image_t** p;
+            
+            for (p = &stream_list; *p != NULL; p = &(*p)->next) {}
+            *p = s;                                 /* Images are loaded in order of requests */
+        }
+        guii_idle_add(&stream_task, stream_process, NULL, 0, GUI_CFG_IDLE_SLICE);
+#endif /* !GUI_CFG_OS */
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+#if GUI_CFG_OS
+    if (ret) {
+        gui_sys_mbox_put(&stream_mbox, s);          /* Pass to I/O thread without GUI protection */
+    }
+#endif /* GUI_CFG_OS */
+    return ret;
+}
+
+/**
+ * \brief           Release memory of streamed image or stop its load
+ * \note            Image must not be used by any widget anymore.
+ *                  With \ref GUI_CFG_OS, running load is stopped by I/O thread after current chunk is read
+ *                  and image cannot be loaded again before its state is \ref GUI_STREAM_IDLE
+ * \param[in]       s: Streamed image structure
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_stream_image_load
+ */
+uint8_t
+gui_stream_image_release(gui_stream_image_t* s) {
+    __GUI_ASSERTPARAMS(s != NULL);                  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    s->desc.image = NULL;
+    if (s->state == GUI_STREAM_QUEUED || s->state == GUI_STREAM_LOADING) {
+#if GUI_CFG_OS
+        s->cancel = 1;                              /* Memory is released by I/O thread */
+#else /* GUI_CFG_OS */
+        gui_stream_image_t** p;
+        
+        for (p = &stream_list; *p != NULL; p = &(*p)->next) {
+            if (*p == s) {
+                *p = s->next;
+                break;
+            }
+        }
+        s->cancel = 1;
+        stream_finish(s, GUI_STREAM_IDLE);
+#endif /* !GUI_CFG_OS */
+    } else {
+        if (s->data != NULL) {
+            GUI_MEMFREE(s->data);
+            s->data = NULL;
+        }
+        s->state = GUI_STREAM_IDLE;
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Get state of streamed image
+ * \param[in]       s: Streamed image structure
+ * \return          Member of \ref gui_stream_state_t enumeration
+ */
+gui_stream_state_t
+gui_stream_image_getstate(const gui_stream_image_t* s) {
+    __GUI_ASSERTPARAMS(s != NULL);                  /* Check input parameters */
+    return (gui_stream_state_t)s->state;
+}
+
+#endif /* GUI_CFG_USE_STREAM || __DOXYGEN__ */
@@ -31,6 +31,46 @@
 #define GUI_INTERNAL
 #include "gui/gui_string.h"
 
+#if GUI_CFG_USE_UNICODE || __DOXYGEN__
+
+/**
+ * \brief           Check if all 4 bytes of word are 7-bit characters and none of them is trailing zero
+ * \note            Subtracting `1` from zero byte sets its top bit, the same as any non-ASCII byte has it set
+ * \hideinitializer
+ */
+#define WORD_IS_ASCII(w)            (((((uint32_t)(w)) | ((uint32_t)(w) - 0x01010101UL)) & 0x80808080UL) == 0)
+
+/**
+ * \brief           Get number of 7-bit characters at the beginning of string
+ * 
+ *                  When string pointer is aligned, 4 bytes are checked at a time,
+ *                  so runs of ASCII text don't go through UTF-8 decoder byte by byte
+ *
+ * \param[in]       str: Pointer to string
+ * \param[in]       max: Maximal number of characters to check
+ * \return          Number of leading 7-bit characters, excluding trailing zero
+ */
+static size_t
+ascii_run(const gui_char* str, size_t max) {
+    const gui_char* p = str;
+    
+    while ((size_t)(p - str) < max && ((uintptr_t)p & 0x03)) { /* Go byte by byte until aligned */
+        if (!*p || *p >= 0x80) {
+            return p - str;
+        }
+        p++;
+    }
+    while (max - (size_t)(p - str) >= 4 && WORD_IS_ASCII(*(const uint32_t *)p)) {  /* Aligned word read stays inside string memory */
+        p += 4;
+    }
+    while ((size_t)(p - str) < max && *p && *p < 0x80) {    /* Bytes remaining after last full word */
+        p++;
+    }
+    return p - str;
+}
+
+#endif /* GUI_CFG_USE_UNICODE || __DOXYGEN__ */
+
 /**
  * \brief           Initialize unicode processing structure
  * \param[in]       s: Pointer to \ref gui_string_unicode_t to initialize to default values
@@ -140,6 +180,14 @@ gui_string_length(const gui_char* src) {
     
     gui_string_unicode_init(&s);            /* Init unicode */
     while (*tmp) {                          /* Process string */
+        if (!s.r) {                         /* Not inside multi-byte sequence */
+            size_t n = ascii_run(tmp, SIZE_MAX);
+            out += n;                       /* Every 7-bit byte is one character */
+            tmp += n;
+            if (!*tmp) {
+                break;
+            }
+        }
         if (gui_string_unicode_decode(&s, *tmp++) == UNICODE_OK) {  /* Process character */
             out++;                          /* Increase number of characters */
         }
@@ -200,6 +248,105 @@ gui_string_compare(const gui_char* s1, const gui_char* s2) {
     return strcmp((const char *)s1, (const char *)s2);
 }
 
+/* Get lower case of ASCII character, other bytes are not modified */
+#define LOWER_ASCII(c)              ((c) >= 'A' && (c) <= 'Z' ? (c) - 'A' + 'a' : (c))
+
+/**
+ * \brief           Check if text contains query, ignoring case of ASCII letters
+ * \note            Function has \ref gui_string_match_fn prototype and is default filter of list widgets
+ * \param[in]       text: Text to search in
+ * \param[in]       query: Text to search for
+ * \return          `1` when query is found in text, `0` otherwise
+ */
+uint8_t
+gui_string_contains(const gui_char* text, const gui_char* query) {
+    const gui_char *t, *q;
+    
+    for (; *text; text++) {
+        for (t = text, q = query; *q && LOWER_ASCII(*t) == LOWER_ASCII(*q); t++, q++) {}
+        if (!*q) {
+            return 1;
+        }
+    }
+    return !*query;
+}
+
+/**
+ * \brief           Format signed fixed-point number without printf
+ * \note            Used by \ref gui_string_fmt_int and \ref gui_string_fmt_fixed
+ * \param[out]      dst: Destination memory address
+ * \param[in]       size: Size of destination memory in units of bytes, including trailing zero
+ * \param[in]       value: Number to format, scaled by `10^decimals`
+ * \param[in]       decimals: Number of digits after decimal point
+ * \return          Length of formatted string, `0` when it does not fit to destination
+ */
+static size_t
+fmt_number(gui_char* dst, size_t size, int32_t value, uint8_t decimals) {
+    gui_char digits[12];                            /* Up to 10 digits of 32-bit value with leading zeros */
+    uint32_t u;
+    size_t cnt = 0, len, i;
+    
+    u = value < 0 ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;    /* Also valid for INT32_MIN */
+    do {
+        digits[cnt++] = (gui_char)('0' + u % 10);   /* Digits in reverse order */
+        u /= 10;
+    } while (u || cnt <= decimals);                 /* At least one digit before decimal point */
+    
+    len = cnt + (value < 0) + (decimals > 0);
+    if (size == 0) {
+        return 0;
+    }
+    if (len >= size) {                              /* Trailing zero must fit too */
+        dst[0] = 0;
+        return 0;
+    }
+    i = 0;
+    if (value < 0) {
+        dst[i++] = '-';
+    }
+    while (cnt) {
+        dst[i++] = digits[--cnt];
+        if (cnt && cnt == decimals) {
+            dst[i++] = '.';
+        }
+    }
+    dst[i] = 0;
+    return i;
+}
+
+/**
+ * \brief           Format signed integer to string without printf
+ * \param[out]      dst: Destination memory address
+ * \param[in]       size: Size of destination memory in units of bytes, including trailing zero
+ * \param[in]       value: Number to format
+ * \return          Length of formatted string, `0` when it does not fit to destination
+ * \sa              gui_string_fmt_fixed
+ */
+size_t
+gui_string_fmt_int(gui_char* dst, size_t size, int32_t value) {
+    return fmt_number(dst, size, value, 0);
+}
+
+/**
+ * \brief           Format fixed-point number to string without printf
+ *
+ *                  Value `-1234` with `2` decimals is formatted as `-12.34`, value `5` with `2` decimals as `0.05`
+ *
+ * \param[out]      dst: Destination memory address
+ * \param[in]       size: Size of destination memory in units of bytes, including trailing zero
+ * \param[in]       value: Number to format, scaled by `10^decimals`
+ * \param[in]       decimals: Number of digits after decimal point, up to `9`
+ * \return          Length of formatted string, `0` when it does not fit to destination
+ * \sa              gui_string_fmt_int
+ */
+size_t
+gui_string_fmt_fixed(gui_char* dst, size_t size, int32_t value, uint8_t decimals) {
+    if (decimals > 9) {
+        decimals = 9;
+    }
+    return fmt_number(dst, size, value, decimals);
+}
+
 /**
  * \brief           Prepare string before it can be used with \ref gui_string_getch or \ref gui_string_getchreverse functions
  * \param[in,out]   *s: Pointer to \ref gui_string_t as base string object
@@ -236,6 +383,13 @@ gui_string_getch(gui_string_t* s, uint32_t* out, uint8_t* len) {
     if (!*s->Str) {                         /* End of string check */
         return 0;
     }
+    if (!s->S.r && *s->Str < 0x80) {        /* 7-bit character outside sequence needs no decoding */
+        *out = *s->Str++;
+        if (len) {
+            *len = 1;
+        }
+        return 1;
+    }
     
     while (*s->Str) {                       /* Check all characters */
         r = gui_string_unicode_decode(&s->S, *s->Str++);    /* Try to decode string */
@@ -261,6 +415,40 @@ gui_string_getch(gui_string_t* s, uint32_t* out, uint8_t* len) {
 #endif /* GUI_CFG_USE_UNICODE */  
 }
 
+/**
+ * \brief           Skip characters in string
+ * \note            When \ref GUI_CFG_USE_UNICODE is set to 1, runs of 7-bit characters
+ *                  are skipped 4 bytes at a time and only multi-byte sequences are decoded
+ * \param[in,out]   *s: Pointer to \ref gui_string_t structure with input string
+ * \param[in]       cnt: Number of characters to skip
+ * \return          Number of characters skipped, less than `cnt` when end of string was reached
+ * \sa              gui_string_getch
+ */
+size_t
+gui_string_skip(gui_string_t* s, size_t cnt) {
+    size_t done = 0;
+    uint32_t ch;
+    uint8_t l;
+    
+    while (done < cnt) {
+#if GUI_CFG_USE_UNICODE
+        if (!s->S.r) {                      /* Not inside multi-byte sequence */
+            size_t n = ascii_run(s->Str, cnt - done);
+            s->Str += n;
+            done += n;
+            if (done == cnt) {
+                break;
+            }
+        }
+#endif /* GUI_CFG_USE_UNICODE */
+        if (!gui_string_getch(s, &ch, &l)) {/* End of string */
+            break;
+        }
+        done++;
+    }
+    return done;
+}
+
 /**
  * \brief           Get character by character from end of string up
  * \note            Functionality is the same as \ref gui_string_getch except order is swapped
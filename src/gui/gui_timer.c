@@ -35,14 +35,83 @@
 
 #define GUI_FLAG_TIMER_ACTIVE           ((uint16_t)(1 << 0UL))  /*!< Timer is active */
 #define GUI_FLAG_TIMER_PERIODIC         ((uint16_t)(1 << 1UL))  /*!< Timer will start from beginning after reach end */ 
-#define GUI_FLAG_TIMER_CALL             ((uint16_t)(1 << 2UL))  /*!< Call callback function on timer */
 
 #define guii_timer_isperiodic(t)        ((t)->flags & GUI_FLAG_TIMER_PERIODIC)
+#define guii_timer_isactive(t)          ((t)->flags & GUI_FLAG_TIMER_ACTIVE)
+
+/**
+ * \brief           Check if time `a` is after time `b`, safe for time overflow
+ * \hideinitializer
+ */
+#define timer_isafter(a, b)             ((int32_t)((uint32_t)(a) - (uint32_t)(b)) > 0)
+
+#if GUI_CFG_MEM_STATIC
+static uint64_t timer_mem_array[GUI_MEM_POOL_WORDS(sizeof(gui_timer_t), GUI_CFG_MEM_STATIC_TIMERS)];
+static gui_mem_static_t timer_mem = GUI_MEM_STATIC_INIT(timer_mem_array);
+static gui_mem_pool_t timer_pool = GUI_MEM_POOL_INIT_STATIC(sizeof(gui_timer_t), &timer_mem);
+#else /* GUI_CFG_MEM_STATIC */
+static gui_mem_pool_t timer_pool = GUI_MEM_POOL_INIT(sizeof(gui_timer_t));
+#endif /* !GUI_CFG_MEM_STATIC */
 
 #if GUI_CFG_OS
 static gui_mbox_msg_t timer_msg = {GUI_SYS_MBOX_TYPE_TIMER};
 #endif /* GUI_CFG_OS */
 
+/**
+ * \brief           Put timer to list of active timers, sorted by expiry time
+ * \note            List is searched from the end as new timers usually expire last
+ * \param[in]       t: Timer to insert. Expiry time must be already set
+ */
+static void
+timer_insert(gui_timer_t* t) {
+    gui_linkedlist_t* prev;
+    gui_linkedlist_t* el = (gui_linkedlist_t *)t;
+    
+    for (prev = GUI.timers.list.last; prev != NULL && timer_isafter(((gui_timer_t *)prev)->expire, t->expire);
+        prev = (gui_linkedlist_t *)GUI_LINKEDLIST_PTR(prev->prev)) {}
+    
+    el->prev = GUI_LINKEDLIST_LINK(prev);
+    if (prev != NULL) {                             /* Insert after previous timer */
+        el->next = prev->next;
+        prev->next = GUI_LINKEDLIST_LINK(el);
+    } else {                                        /* Insert as first timer */
+        el->next = GUI_LINKEDLIST_LINK(GUI.timers.list.first);
+        GUI.timers.list.first = el;
+    }
+    if (el->next) {
+        ((gui_linkedlist_t *)GUI_LINKEDLIST_PTR(el->next))->prev = GUI_LINKEDLIST_LINK(el);
+    } else {
+        GUI.timers.list.last = el;
+    }
+    t->flags |= GUI_FLAG_TIMER_ACTIVE;              /* Timer is on list */
+}
+
+/**
+ * \brief           Remove timer from list of active timers if it is on list
+ * \param[in]       t: Timer to remove
+ */
+static void
+timer_unlink(gui_timer_t* t) {
+    if (guii_timer_isactive(t)) {
+        gui_linkedlist_remove_gen(&GUI.timers.list, (gui_linkedlist_t *)t);
+        t->flags &= ~GUI_FLAG_TIMER_ACTIVE;         /* Clear active flag */
+    }
+}
+
+/**
+ * \brief           Start timer from current time
+ * \param[in]       t: Timer to start
+ */
+static void
+timer_schedule(gui_timer_t* t) {
+    timer_unlink(t);                                /* Remove from current position */
+    t->expire = gui_sys_now() + GUI_MAX(t->period, 1);  /* Set new expiry time */
+    timer_insert(t);
+#if GUI_CFG_OS
+    __GUI_WAKEUP(&timer_msg);                       /* Wake up thread to get new deadline */
+#endif /* GUI_CFG_OS */
+}
+
 /**
  * \brief           Create new software timer
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -55,20 +124,14 @@ gui_timer_t *
 guii_timer_create(uint16_t period, void (*callback)(gui_timer_t *), void* params) {
     gui_timer_t* ptr;
     
-    ptr = GUI_MEMALLOC(sizeof(*ptr));               /* Allocate memory for timer */
+    GUI_MEM_TAGGED(GUI_MEM_TAG_TIMER, ptr = gui_mem_pool_alloc(&timer_pool));    /* Allocate memory for timer */
     if (ptr != NULL) {
         memset(ptr, 0x00, sizeof(gui_timer_t));     /* Reset memory */
         
         ptr->period = period;                       /* Set period value */
-        ptr->counter = period;                      /* Set current counter value */
         ptr->callback = callback;                   /* Set callback */
         ptr->params = params;                       /* Timer custom parameters */
-        ptr->flags = 0;                             /* Timer flags management */
-        
-        gui_linkedlist_add_gen(&GUI.timers.list, (gui_linkedlist_t *)ptr);  /* Add timer to linked list */
-#if GUI_CFG_OS
-        gui_sys_mbox_putnow(&GUI.OS.mbox, &timer_msg);  /* Add new message to queue */
-#endif /* GUI_CFG_OS */
+        ptr->flags = 0;                             /* Timer is not active until started */
     }
     return ptr;
 }
@@ -83,8 +146,8 @@ guii_timer_create(uint16_t period, void (*callback)(gui_timer_t *), void* params
 uint8_t
 guii_timer_remove(gui_timer_t** t) {  
     __GUI_ASSERTPARAMS(t && *t);                    /* Check input parameters */  
-    gui_linkedlist_remove_gen(&GUI.timers.list, (gui_linkedlist_t *)(*t));  /* Remove timer from linked list */
-    GUI_MEMFREE(*t);                                /* Free memory for timer */
+    timer_unlink(*t);                               /* Remove timer from active list */
+    gui_mem_pool_free(&timer_pool, *t);             /* Free memory for timer */
     *t = 0;                                         /* Clear pointer */
     
     return 1;
@@ -99,12 +162,8 @@ guii_timer_remove(gui_timer_t** t) {
 uint8_t
 guii_timer_start(gui_timer_t* t) {
     __GUI_ASSERTPARAMS(t);                          /* Check input parameters */
-    t->counter = t->period;                         /* Reset counter to top value */
     t->flags &= ~GUI_FLAG_TIMER_PERIODIC;           /* Clear periodic flag */
-    t->flags |= GUI_FLAG_TIMER_ACTIVE;              /* Set active flag */
-#if GUI_CFG_OS
-    gui_sys_mbox_putnow(&GUI.OS.mbox, &timer_msg);  /* Add new message to queue */
-#endif /* GUI_CFG_OS */
+    timer_schedule(t);                              /* Start timer */
     
     return 1;
 }
@@ -118,8 +177,8 @@ guii_timer_start(gui_timer_t* t) {
 uint8_t
 guii_timer_startperiodic(gui_timer_t* t) {
     __GUI_ASSERTPARAMS(t);                          /* Check input parameters */
-    t->counter = t->period;                         /* Reset counter to top value */
-    t->flags |= GUI_FLAG_TIMER_ACTIVE | GUI_FLAG_TIMER_PERIODIC;    /* Set active flag */
+    t->flags |= GUI_FLAG_TIMER_PERIODIC;            /* Set periodic flag */
+    timer_schedule(t);                              /* Start timer */
     
     return 1;
 }
@@ -133,14 +192,13 @@ guii_timer_startperiodic(gui_timer_t* t) {
 uint8_t
 guii_timer_stop(gui_timer_t* t) {
     __GUI_ASSERTPARAMS(t);                          /* Check input parameters */
-    t->counter = t->period;                         /* Reset counter to top value */
-    t->flags &= ~GUI_FLAG_TIMER_ACTIVE;             /* Clear active flag */
+    timer_unlink(t);                                /* Remove from active list */
     
     return 1;
 }
 
 /**
- * \brief           Reset timer to zero
+ * \brief           Reset timer to start counting full period from now
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
  * \param[in]       t: Pointer to \ref gui_timer_t structure
  * \return          `1` on success, `0` otherwise
@@ -148,7 +206,9 @@ guii_timer_stop(gui_timer_t* t) {
 uint8_t
 guii_timer_reset(gui_timer_t* t) {
     __GUI_ASSERTPARAMS(t);                          /* Check input parameters */
-    t->counter = t->period;                         /* Clear and reset timer */
+    if (guii_timer_isactive(t)) {                   /* Stopped timer restarts on next start anyway */
+        timer_schedule(t);
+    }
     
     return 1;
 }
@@ -156,48 +216,27 @@ guii_timer_reset(gui_timer_t* t) {
 /**
  * \brief           Internal processing called by GUI library
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
- * \note            Processes all timers in loop and calls callback function if needed 
+ * \note            Active timers are sorted by expiry time, only expired timers are processed
  */
 void
 guii_timer_process(void) {
     gui_timer_t* t;
-    volatile uint32_t time = gui_sys_now();         /* Get current time */
-    volatile uint32_t lastTime = GUI.timers.Time;
-    uint32_t diff = time - lastTime;                /* Get difference in time */
+    uint32_t time = gui_sys_now();                  /* Get current time */
     
-    if (diff == 0) {                                /* No difference in time */
-        return;
-    }
-    
-    /* Process all software timers */
-    for (t = (gui_timer_t *)GUI.timers.list.first; t != NULL;
-        t = (gui_timer_t *)t->list.next) {
-        if (t->flags & GUI_FLAG_TIMER_CALL) {       /* Counter is set to 0, process callback */
-            t->flags &= ~GUI_FLAG_TIMER_CALL;       /* Clear timer flag */
-            if (!guii_timer_isperiodic(t)) {        /* If timer is not periodic */
-                guii_timer_stop(t);                 /* Stop timer */
-            }
-            if (t->callback != NULL) {              /* Process callback */
-                t->callback(t);                     /* Call user function */
+    /* Timers restarted in callback expire after current time and stop the loop */
+    while ((t = (gui_timer_t *)GUI.timers.list.first) != NULL && !timer_isafter(t->expire, time)) {
+        timer_unlink(t);                            /* Remove expired timer */
+        if (guii_timer_isperiodic(t)) {             /* Periodic timer starts again */
+            t->expire += GUI_MAX(t->period, 1);
+            if (!timer_isafter(t->expire, time)) {  /* Processing was late, skip missed periods */
+                t->expire = time + GUI_MAX(t->period, 1);
             }
+            timer_insert(t);
         }
-        
-        if (!(t->flags & GUI_FLAG_TIMER_ACTIVE)) {  /* Timer is not active */
-            continue;
-        }
-        if (t->counter >= diff) {                   /* Decrease counter value by zero */
-            t->counter -= diff;                     /* Try to decrease to 0 */
-            if (!t->counter) {
-                t->counter = t->period;             /* Set new period value */
-                t->flags |= GUI_FLAG_TIMER_CALL;    /* Set flag for timer callback next time */
-            }
-        } else {                                    /* Overflow mode */
-            t->counter = 0;                         /* Set new counter value */
-            t->flags |= GUI_FLAG_TIMER_CALL;        /* Set callback flag in next check */
+        if (t->callback != NULL) {                  /* Process callback */
+            t->callback(t);                         /* Call user function */
         }
     }
-    
-    GUI.timers.Time = time;                         /* Reset time */
 }
 
 /**
@@ -210,9 +249,27 @@ guii_timer_getactivecount(void) {
     gui_timer_t* t;
     for (t = (gui_timer_t *)gui_linkedlist_getnext_gen(&GUI.timers.list, NULL); t != NULL;
         t = (gui_timer_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)t)) {
-        if ((t->flags & GUI_FLAG_TIMER_ACTIVE)) {
-            cnt++;
-        }
+        cnt++;                                      /* Only active timers are on list */
     }
     return cnt;
 }
+
+/**
+ * \brief           Get time until next timer requires processing
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[out]      time: Pointer to output variable to save time in units of milliseconds.
+ *                      Set to `0` when timer processing is required immediately
+ * \return          `1` if at least one timer is active, `0` otherwise
+ */
+uint8_t
+guii_timer_getnext(uint32_t* time) {
+    gui_timer_t* t = (gui_timer_t *)GUI.timers.list.first;  /* First timer expires first */
+    uint32_t now;
+    
+    if (t == NULL) {                                /* No active timers */
+        return 0;
+    }
+    now = gui_sys_now();
+    *time = timer_isafter(t->expire, now) ? t->expire - now : 0;
+    return 1;
+}
@@ -0,0 +1,358 @@
+/**	
+ * \file            gui_trace.c
+ * \brief           Trace events for performance analysis
+ */
+
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_trace.h"
+
+#if GUI_CFG_USE_TRACE || __DOXYGEN__
+
+#if GUI_CFG_TRACE_BUFFER_SIZE
+static gui_trace_event_t events[GUI_CFG_TRACE_BUFFER_SIZE]; /* Ring buffer of events */
+static size_t events_start, events_count;
+#endif /* GUI_CFG_TRACE_BUFFER_SIZE */
+static uint8_t enabled = 1;
+static gui_ll_t ll_driver;                      /* Low-level functions of driver, called by wrappers */
+
+/* Names of widget commands, order must match gui_wc_t enumeration */
+static const char* const
+wc_names[] = {
+    "None", "PreInit", "ExcludeLinkedList", "SetParam", "GetParam", "Init",
+    "ChildWidgetCreated", "Draw", "CanRemove", "Remove", "FocusIn", "FocusOut",
+    "ActiveIn", "ActiveOut", "TouchStart", "TouchMove", "TouchEnd", "Click",
+    "LongClick", "DblClick", "Swipe", "Pinch", "KeyPress", "SelectionChanged",
+    "ValueChanged", "TextChanged", "IncSelection", "OnDismiss", "VisibilityChanged",
+};
+
+/* Names of low-level operations, order must match gui_trace_ll_t enumeration */
+static const char* const
+ll_names[] = {
+    "Fill", "Copy", "CopyBlend", "DrawHLine", "DrawVLine", "FillRect", "DrawImage16",
+    "DrawImage24", "DrawImage32", "CopyChar", "DrawImageIndexed", "BlendHLine",
+    "FillGradient", "FillRects", "CopyMask", "DrawJPEG", "CopyRects",
+};
+
+/* Categories of events, order must match gui_trace_type_t enumeration */
+static const char* const
+type_names[] = {
+    "widget", "redraw", "touch", "ll", "ll",
+};
+
+/**
+ * \brief           Add trace event
+ * \note            Use \ref guii_trace_begin and \ref guii_trace_end macros
+ * \param[in]       type: Event type, member of \ref gui_trace_type_t enumeration
+ * \param[in]       begin: Set to `1` for begin event or `0` for end event
+ * \param[in]       op: Operation, see \ref gui_trace_type_t
+ * \param[in]       h: Widget handle or `NULL`
+ * \param[in]       arg: Operation argument
+ */
+void
+guii_trace(uint8_t type, uint8_t begin, uint8_t op, gui_handle_p h, uint32_t arg) {
+    gui_trace_event_t* evt;
+#if !GUI_CFG_TRACE_BUFFER_SIZE
+    gui_trace_event_t e;
+#endif /* !GUI_CFG_TRACE_BUFFER_SIZE */
+    
+    if (!enabled) {
+        return;
+    }
+#if GUI_CFG_TRACE_BUFFER_SIZE
+    evt = &events[(events_start + events_count) % GUI_CFG_TRACE_BUFFER_SIZE];
+    if (events_count < GUI_CFG_TRACE_BUFFER_SIZE) {
+        events_count++;
+    } else {                                    /* Overwrite oldest event */
+        events_start = (events_start + 1) % GUI_CFG_TRACE_BUFFER_SIZE;
+    }
+#else
+    evt = &e;
+#endif /* GUI_CFG_TRACE_BUFFER_SIZE */
+    evt->time = GUI_CFG_TRACE_TIME();
+    evt->widget = h != NULL ? h->widget : NULL;
+    evt->id = h != NULL ? h->id : 0;
+    evt->arg = arg;
+    evt->type = type;
+    evt->op = op;
+    evt->begin = begin;
+#if defined(GUI_CFG_TRACE_HOOK)
+    GUI_CFG_TRACE_HOOK(evt);
+#endif /* defined(GUI_CFG_TRACE_HOOK) */
+}
+
+/*
+ * Wrappers of low-level functions.
+ * Argument of event is number of pixels processed by operation
+ */
+#define LL_WRAP(name, pixels, call)     do {                                \
+    guii_trace_begin(GUI_TRACE_TYPE_LL, GUI_TRACE_LL_ ## name, NULL, (pixels)); \
+    ll_driver.name call;                                                    \
+    guii_trace_end(GUI_TRACE_TYPE_LL, GUI_TRACE_LL_ ## name, NULL, (pixels));   \
+} while (0)
+
+static void
+trace_Fill(gui_lcd_t* LCD, gui_layer_t* layer, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLine, gui_color_t color) {
+    LL_WRAP(Fill, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, dst, xSize, ySize, offLine, color));
+}
+
+static void
+trace_Copy(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    LL_WRAP(Copy, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, src, dst, xSize, ySize, offLineSrc, offLineDst));
+}
+
+static void
+trace_CopyBlend(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, uint8_t alphaSrc, uint8_t alphaDst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    LL_WRAP(CopyBlend, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, src, dst, alphaSrc, alphaDst, xSize, ySize, offLineSrc, offLineDst));
+}
+
+static void
+trace_DrawHLine(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t length, gui_color_t color) {
+    LL_WRAP(DrawHLine, (uint32_t)length, (LCD, layer, x, y, length, color));
+}
+
+static void
+trace_DrawVLine(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t length, gui_color_t color) {
+    LL_WRAP(DrawVLine, (uint32_t)length, (LCD, layer, x, y, length, color));
+}
+
+static void
+trace_FillRect(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color) {
+    LL_WRAP(FillRect, (uint32_t)width * (uint32_t)height, (LCD, layer, x, y, width, height, color));
+}
+
+static void
+trace_DrawImage16(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    LL_WRAP(DrawImage16, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, img, src, dst, xSize, ySize, offLineSrc, offLineDst));
+}
+
+static void
+trace_DrawImage24(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    LL_WRAP(DrawImage24, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, img, src, dst, xSize, ySize, offLineSrc, offLineDst));
+}
+
+static void
+trace_DrawImage32(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    LL_WRAP(DrawImage32, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, img, src, dst, xSize, ySize, offLineSrc, offLineDst));
+}
+
+static void
+trace_CopyChar(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst, gui_color_t color) {
+    LL_WRAP(CopyChar, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, src, dst, xSize, ySize, offLineSrc, offLineDst, color));
+}
+
+static void
+trace_DrawImageIndexed(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    LL_WRAP(DrawImageIndexed, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, img, src, dst, xSize, ySize, offLineSrc, offLineDst));
+}
+
+static void
+trace_BlendHLine(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t length, const uint8_t* alpha, gui_color_t color) {
+    LL_WRAP(BlendHLine, (uint32_t)length, (LCD, layer, x, y, length, alpha, color));
+}
+
+static void
+trace_FillGradient(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, const gui_color_t* colors, uint8_t vertical) {
+    LL_WRAP(FillGradient, (uint32_t)width * (uint32_t)height, (LCD, layer, x, y, width, height, colors, vertical));
+}
+
+static void
+trace_FillRects(gui_lcd_t* LCD, gui_layer_t* layer, const gui_ll_rect_t* rects, size_t count) {
+    uint32_t pixels = 0;
+    size_t i;
+    
+    for (i = 0; i < count; i++) {
+        pixels += (uint32_t)rects[i].width * (uint32_t)rects[i].height;
+    }
+    LL_WRAP(FillRects, pixels, (LCD, layer, rects, count));
+}
+
+static void
+trace_CopyMask(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, const uint8_t* mask, uint8_t alpha, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst, gui_dim_t offLineMask) {
+    LL_WRAP(CopyMask, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, src, dst, mask, alpha, xSize, ySize, offLineSrc, offLineDst, offLineMask));
+}
+
+static void
+trace_DrawJPEG(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, void* dst, gui_dim_t left, gui_dim_t top, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineDst) {
+    LL_WRAP(DrawJPEG, (uint32_t)xSize * (uint32_t)ySize, (LCD, layer, img, dst, left, top, xSize, ySize, offLineDst));
+}
+
+static void
+trace_CopyRects(gui_lcd_t* LCD, gui_layer_t* layer, const gui_layer_t* src, const gui_display_t* rects, size_t count) {
+    uint32_t pixels = 0;
+    size_t i;
+    
+    for (i = 0; i < count; i++) {
+        pixels += (uint32_t)(rects[i].x2 - rects[i].x1) * (uint32_t)(rects[i].y2 - rects[i].y1);
+    }
+    LL_WRAP(CopyRects, pixels, (LCD, layer, src, rects, count));
+}
+
+/**
+ * \brief           Replace low-level drawing functions with tracing wrappers
+ * \note            Functions not set by driver stay unset. Per pixel functions and
+ *                  ready check are not wrapped, waiting is traced as \ref GUI_TRACE_TYPE_WAIT
+ * \param[in,out]   ll: Low-level functions filled by driver
+ */
+void
+guii_trace_setll(gui_ll_t* ll) {
+    memcpy(&ll_driver, ll, sizeof(ll_driver));  /* Keep driver functions */
+    if (ll->Fill != NULL)               { ll->Fill = trace_Fill; }
+    if (ll->Copy != NULL)               { ll->Copy = trace_Copy; }
+    if (ll->CopyBlend != NULL)          { ll->CopyBlend = trace_CopyBlend; }
+    if (ll->DrawHLine != NULL)          { ll->DrawHLine = trace_DrawHLine; }
+    if (ll->DrawVLine != NULL)          { ll->DrawVLine = trace_DrawVLine; }
+    if (ll->FillRect != NULL)           { ll->FillRect = trace_FillRect; }
+    if (ll->DrawImage16 != NULL)        { ll->DrawImage16 = trace_DrawImage16; }
+    if (ll->DrawImage24 != NULL)        { ll->DrawImage24 = trace_DrawImage24; }
+    if (ll->DrawImage32 != NULL)        { ll->DrawImage32 = trace_DrawImage32; }
+    if (ll->CopyChar != NULL)           { ll->CopyChar = trace_CopyChar; }
+    if (ll->DrawImageIndexed != NULL)   { ll->DrawImageIndexed = trace_DrawImageIndexed; }
+    if (ll->BlendHLine != NULL)         { ll->BlendHLine = trace_BlendHLine; }
+    if (ll->FillGradient != NULL)       { ll->FillGradient = trace_FillGradient; }
+    if (ll->FillRects != NULL)          { ll->FillRects = trace_FillRects; }
+    if (ll->CopyMask != NULL)           { ll->CopyMask = trace_CopyMask; }
+    if (ll->DrawJPEG != NULL)           { ll->DrawJPEG = trace_DrawJPEG; }
+    if (ll->CopyRects != NULL)          { ll->CopyRects = trace_CopyRects; }
+}
+
+/**
+ * \brief           Enable or disable recording of trace events
+ * \note            Recording is enabled by default
+ * \param[in]       enable: Set to `1` to enable or `0` to disable recording
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_trace_enable(uint8_t enable) {
+    __GUI_ENTER();                                  /* Enter GUI */
+    enabled = enable ? 1 : 0;
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Remove all events from trace buffer
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_trace_clear(void) {
+    __GUI_ENTER();                                  /* Enter GUI */
+#if GUI_CFG_TRACE_BUFFER_SIZE
+    events_start = 0;
+    events_count = 0;
+#endif /* GUI_CFG_TRACE_BUFFER_SIZE */
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Copy events from trace buffer, oldest first
+ * \param[out]      evts: Array to copy events to
+ * \param[in]       count: Number of entries in array
+ * \return          Number of copied events
+ */
+size_t
+gui_trace_getevents(gui_trace_event_t* evts, size_t count) {
+    size_t i = 0;
+    
+    __GUI_ASSERTPARAMS(evts != NULL);               /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+#if GUI_CFG_TRACE_BUFFER_SIZE
+    for (; i < count && i < events_count; i++) {
+        memcpy(&evts[i], &events[(events_start + i) % GUI_CFG_TRACE_BUFFER_SIZE], sizeof(*evts));
+    }
+#else
+    GUI_UNUSED(count);
+#endif /* GUI_CFG_TRACE_BUFFER_SIZE */
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return i;
+}
+
+/**
+ * \brief           Export trace buffer as Chrome trace JSON
+ * \note            Recording is paused during export. End events of operations
+ *                  which begin events were already overwritten are skipped
+ * \param[in]       out: Output function, called for every part of text
+ * \param[in]       arg: User argument passed to output function
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_trace_export(gui_trace_output_fn out, void* arg) {
+#if GUI_CFG_TRACE_BUFFER_SIZE
+    char str[128];
+    const gui_trace_event_t* evt;
+    const char* name;
+    const char* cmd;
+    size_t i;
+    uint32_t depth = 0;
+    uint8_t first = 1, en;
+#endif /* GUI_CFG_TRACE_BUFFER_SIZE */
+    
+    __GUI_ASSERTPARAMS(out != NULL);                /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    out("{\"traceEvents\":[", arg);
+#if GUI_CFG_TRACE_BUFFER_SIZE
+    en = enabled;
+    enabled = 0;                                    /* Output may draw, do not trace it */
+    for (i = 0; i < events_count; i++) {
+        evt = &events[(events_start + i) % GUI_CFG_TRACE_BUFFER_SIZE];
+        if (!evt->begin) {
+            if (!depth) {                           /* Begin event was overwritten */
+                continue;
+            }
+            depth--;
+        } else {
+            depth++;
+        }
+        
+        name = evt->widget != NULL ? (const char *)evt->widget->name : "";
+        cmd = "";
+        if (evt->type == GUI_TRACE_TYPE_WIDGET) {
+            cmd = evt->op < GUI_COUNT_OF(wc_names) ? wc_names[evt->op] : "Unknown";
+        } else if (evt->type == GUI_TRACE_TYPE_LL) {
+            name = evt->op < GUI_COUNT_OF(ll_names) ? ll_names[evt->op] : "Unknown";
+        } else if (evt->type == GUI_TRACE_TYPE_WAIT) {
+            name = "Wait";
+        }
+        sprintf(str, "%s{\"name\":\"%.32s%s%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%lu,\"pid\":0,\"tid\":0,\"args\":{\"id\":%lu,\"arg\":%lu}}",
+            first ? "\n" : ",\n", name, cmd[0] ? " " : "", cmd,
+            evt->type < GUI_COUNT_OF(type_names) ? type_names[evt->type] : "",
+            evt->begin ? 'B' : 'E', (unsigned long)evt->time, (unsigned long)evt->id, (unsigned long)evt->arg);
+        out(str, arg);
+        first = 0;
+    }
+    enabled = en;
+#endif /* GUI_CFG_TRACE_BUFFER_SIZE */
+    out("\n]}\n", arg);
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+#endif /* GUI_CFG_USE_TRACE || __DOXYGEN__ */
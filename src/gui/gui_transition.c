@@ -0,0 +1,321 @@
+/**	
+ * \file            gui_transition.c
+ * \brief           Animated transitions between screens
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_transition.h"
+#include "widget/gui_widget.h"
+#include "system/gui_sys.h"
+
+#if GUI_CFG_USE_TRANSITION || __DOXYGEN__
+
+#define TRANSITION_STATE_IDLE           0x00        /*!< No transition is running */
+#define TRANSITION_STATE_CAPTURE        0x01        /*!< Screens are copied to buffers on next frame */
+#define TRANSITION_STATE_RUNNING        0x02        /*!< Buffers are copied to display on each frame */
+
+#define TRANSITION_SCALE                1024        /*!< Fixed point scale for transition progress */
+
+#define T                               GUI.transition
+
+/**
+ * \brief           Copy rectangle between layer and one of transition buffers
+ * \param[in,out]   buff: Transition buffer
+ * \param[in,out]   layer: Drawing layer
+ * \param[in]       sx, sy: Position of rectangle in buffer, relative to transition area
+ * \param[in]       dx, dy: Absolute position of rectangle on screen
+ * \param[in]       width, height: Rectangle size in units of pixels
+ * \param[in]       save: Set to `1` to copy from layer to buffer or `0` to copy buffer to layer
+ */
+static void
+transition_copy(uint8_t* buff, gui_layer_t* layer, gui_dim_t sx, gui_dim_t sy,
+                    gui_dim_t dx, gui_dim_t dy, gui_dim_t width, gui_dim_t height, uint8_t save) {
+    gui_dim_t ax, ay, aw, bx, by;
+    void* pixels;
+    
+    ax = T.area.x1;
+    ay = T.area.y1;
+    aw = T.area.x2 - T.area.x1;
+    bx = ax + sx;
+    by = ay + sy;
+#if GUI_CFG_LCD_ROTATION
+    {
+        gui_dim_t ah = T.area.y2 - T.area.y1, bw = width, bh = height;
+        
+        /* Buffers keep pixels as they are in display memory */
+        guii_lcd_maprect(&ax, &ay, &aw, &ah);
+        guii_lcd_maprect(&bx, &by, &bw, &bh);
+        guii_lcd_maprect(&dx, &dy, &width, &height);
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    buff += layer->pixel_size * ((size_t)(by - ay) * (size_t)aw + (size_t)(bx - ax));
+    pixels = (void *)(layer->start_address + layer->pixel_size * (dy * layer->width + dx));
+    GUI.ll.Copy(&GUI.lcd, layer,
+        save ? pixels : (void *)buff,               /* Source address */
+        save ? (void *)buff : pixels,               /* Destination address */
+        width, height,                              /* Area size */
+        save ? layer->width - width : aw - width,   /* Offline source */
+        save ? aw - width : layer->width - width    /* Offline destination */
+    );
+}
+
+/**
+ * \brief           Copy part of buffer to layer along transition direction
+ * \param[in,out]   layer: Drawing layer
+ * \param[in]       buff: Transition buffer
+ * \param[in]       pos: Start of part on screen, relative to transition area
+ * \param[in]       len: Length of part in units of pixels
+ * \param[in]       src: Start of part in buffer
+ */
+static void
+transition_segment(gui_layer_t* layer, uint8_t* buff, gui_dim_t pos, gui_dim_t len, gui_dim_t src) {
+    if (len <= 0) {
+        return;
+    }
+    if (T.type & 0x02) {                            /* Vertical movement */
+        transition_copy(buff, layer, 0, src, T.area.x1, T.area.y1 + pos, T.area.x2 - T.area.x1, len, 0);
+    } else {
+        transition_copy(buff, layer, src, 0, T.area.x1 + pos, T.area.y1, len, T.area.y2 - T.area.y1, 0);
+    }
+}
+
+/**
+ * \brief           Copy old and new screen to layer for current progress
+ * \param[in,out]   layer: Drawing layer
+ * \param[in]       progress: Transition progress between `0` and \ref TRANSITION_SCALE
+ */
+static void
+transition_compose(gui_layer_t* layer, int32_t progress) {
+    gui_dim_t d, off;
+    uint8_t push = (T.type & 0x04) != 0;
+    
+    d = (T.type & 0x02) ? T.area.y2 - T.area.y1 : T.area.x2 - T.area.x1;
+    off = (gui_dim_t)((d * progress) / TRANSITION_SCALE);   /* Part of area already covered by new screen */
+    if (!(T.type & 0x01)) {                         /* New screen comes from right or bottom */
+        transition_segment(layer, T.buff_out, 0, d - off, push ? off : 0);
+        transition_segment(layer, T.buff_in, d - off, off, 0);
+    } else {                                        /* New screen comes from left or top */
+        transition_segment(layer, T.buff_in, 0, off, d - off);
+        transition_segment(layer, T.buff_out, off, d - off, push ? 0 : off);
+    }
+}
+
+/**
+ * \brief           Timer callback, requests new frame for next transition step
+ * \param[in]       t: Timer handle
+ */
+static void
+transition_timer_callback(gui_timer_t* t) {
+    GUI.flags |= GUI_FLAG_REDRAW;                   /* Frame only copies buffers */
+    GUI_UNUSED(t);
+}
+
+/**
+ * \brief           Stop transition and free its buffers
+ */
+static void
+transition_stop(void) {
+    if (T.timer != NULL) {
+        guii_timer_stop(T.timer);
+    }
+    guii_ll_waitready();                            /* Pixels may still be copied by low-level */
+    GUI_MEMFREE(T.buff_out);
+    GUI_MEMFREE(T.buff_in);
+    T.state = TRANSITION_STATE_IDLE;
+}
+
+/**
+ * \brief           Start animated transition to new screen
+ *
+ *                  Screen currently visible in area of new screen widget is saved and
+ *                  replaced by new screen with selected effect. Switch screens as usual
+ *                  (hide old one, show new one) right after function call
+ *
+ * \note            When transition is not possible, function returns `0`
+ *                  and screens are switched without animation
+ * \note            Running transition is finished immediately when new one is started
+ * \param[in]       h: Widget handle of new screen. Transition is animated in its area
+ * \param[in]       type: Transition effect, member of \ref gui_transition_t
+ * \param[in]       duration: Transition duration in units of milliseconds
+ * \return          `1` if transition started, `0` otherwise
+ */
+uint8_t
+gui_transition_start(gui_handle_p h, gui_transition_t type, uint16_t duration) {
+    gui_dim_t x, y;
+    size_t size;
+    uint8_t ret = 0;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));   /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (T.state != TRANSITION_STATE_IDLE) {         /* Old screen is saved as it is on screen now */
+        transition_stop();
+    }
+    x = guii_widget_getabsolutex(h);
+    y = guii_widget_getabsolutey(h);
+    T.area.x1 = GUI_MAX(x, 0);                      /* Only part on screen is animated */
+    T.area.y1 = GUI_MAX(y, 0);
+    T.area.x2 = GUI_MIN(x + guii_widget_getwidth(h), GUI.lcd.width);
+    T.area.y2 = GUI_MIN(y + guii_widget_getheight(h), GUI.lcd.height);
+    if (GUI.ll.Copy != NULL && duration && T.area.x1 < T.area.x2 && T.area.y1 < T.area.y2) {
+        size = (size_t)(T.area.x2 - T.area.x1) * (size_t)(T.area.y2 - T.area.y1) * GUI.lcd.drawing_layer->pixel_size;
+        GUI_MEM_TAGGED(GUI_MEM_TAG_TRANSITION, T.buff_out = GUI_MEMALLOC_NOZERO_HINT(size, GUI_MEM_BULK));
+        GUI_MEM_TAGGED(GUI_MEM_TAG_TRANSITION, T.buff_in = GUI_MEMALLOC_NOZERO_HINT(size, GUI_MEM_BULK));
+        if (T.timer == NULL) {
+            T.timer = guii_timer_create(GUI_CFG_ANIM_PERIOD, transition_timer_callback, NULL);
+        }
+        if (T.buff_out != NULL && T.buff_in != NULL && T.timer != NULL) {
+            T.type = (uint8_t)type;
+            T.duration = duration;
+            T.state = TRANSITION_STATE_CAPTURE;
+#if GUI_CFG_LCD_ROTATION
+            T.rotation = GUI.lcd.rotation;
+#endif /* GUI_CFG_LCD_ROTATION */
+            guii_widget_invalidate(h);              /* New screen is drawn completely on next frame */
+            ret = 1;
+        } else {
+            GUI_MEMFREE(T.buff_out);
+            GUI_MEMFREE(T.buff_in);
+        }
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Check if screen transition is running
+ * \return          `1` if running, `0` otherwise
+ */
+uint8_t
+gui_transition_isactive(void) {
+    uint8_t ret;
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    ret = guii_transition_isactive();
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Check if screen transition is running
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Pixels of last frame show composed screens while transition is running
+ * \return          `1` if running, `0` otherwise
+ */
+uint8_t
+guii_transition_isactive(void) {
+    return T.state != TRANSITION_STATE_IDLE;
+}
+
+/**
+ * \brief           Prepare transition area for new frame
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack when list of dirty regions is complete, before regions changed on last frame are copied.
+ *                  Parts of area redrawn by widgets are remembered and whole area is added to dirty regions,
+ *                  so it is neither copied from last frame nor are widgets drawn in it
+ * \param[in]       src: Layer with last frame, shown on display
+ */
+void
+guii_transition_prepare(gui_layer_t* src) {
+    gui_display_t* r;
+    size_t i;
+    
+    if (T.state == TRANSITION_STATE_IDLE) {
+        return;
+    }
+#if GUI_CFG_LCD_ROTATION
+    if (T.rotation != GUI.lcd.rotation) {           /* Buffers are not valid anymore, all widgets are drawn again */
+        transition_stop();
+        return;
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    T.changed_count = 0;
+    if (T.state == TRANSITION_STATE_CAPTURE) {
+        transition_copy(T.buff_out, src, 0, 0, T.area.x1, T.area.y1,
+            T.area.x2 - T.area.x1, T.area.y2 - T.area.y1, 1);   /* Old screen is still on display */
+    } else {
+        for (i = 0; i < GUI.DirtyRectsCount; i++) {
+            r = &GUI.DirtyRects[i];
+            if (__GUI_RECT_MATCH(r->x1, r->y1, r->x2, r->y2, T.area.x1, T.area.y1, T.area.x2, T.area.y2)) {
+                r = &T.changed[T.changed_count++];
+                r->x1 = GUI_MAX(GUI.DirtyRects[i].x1, T.area.x1);
+                r->y1 = GUI_MAX(GUI.DirtyRects[i].y1, T.area.y1);
+                r->x2 = GUI_MIN(GUI.DirtyRects[i].x2, T.area.x2);
+                r->y2 = GUI_MIN(GUI.DirtyRects[i].y2, T.area.y2);
+            }
+        }
+    }
+    guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS,
+        T.area.x1, T.area.y1, T.area.x2, T.area.y2);
+}
+
+/**
+ * \brief           Copy old and new screen to transition area
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack when widgets of frame are drawn, before sprites are drawn.
+ *                  Parts of new screen redrawn by widgets are saved to buffer first
+ * \param[in,out]   dst: Layer with frame being drawn
+ */
+void
+guii_transition_draw(gui_layer_t* dst) {
+    gui_display_t* r;
+    uint32_t elapsed;
+    int32_t progress = 0;
+    size_t i;
+    
+    if (T.state == TRANSITION_STATE_CAPTURE) {
+        transition_copy(T.buff_in, dst, 0, 0, T.area.x1, T.area.y1,
+            T.area.x2 - T.area.x1, T.area.y2 - T.area.y1, 1);   /* New screen is drawn completely */
+        T.state = TRANSITION_STATE_RUNNING;
+        T.time = gui_sys_now();
+        guii_timer_startperiodic(T.timer);
+    } else if (T.state == TRANSITION_STATE_RUNNING) {
+        for (i = 0; i < T.changed_count; i++) {     /* Keep new screen up to date */
+            r = &T.changed[i];
+            transition_copy(T.buff_in, dst, r->x1 - T.area.x1, r->y1 - T.area.y1,
+                r->x1, r->y1, r->x2 - r->x1, r->y2 - r->y1, 1);
+        }
+        elapsed = gui_sys_now() - T.time;
+        if (elapsed >= T.duration) {
+            progress = TRANSITION_SCALE;
+        } else {
+            progress = TRANSITION_SCALE - (int32_t)((elapsed * TRANSITION_SCALE) / T.duration);
+            progress = TRANSITION_SCALE - (progress * progress) / TRANSITION_SCALE; /* Ease out, like finger released screen */
+        }
+    } else {
+        return;
+    }
+    transition_compose(dst, progress);
+    if (progress == TRANSITION_SCALE) {             /* Last frame shows new screen only */
+        transition_stop();
+    }
+}
+
+#endif /* GUI_CFG_USE_TRANSITION || __DOXYGEN__ */
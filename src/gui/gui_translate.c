@@ -31,23 +31,84 @@
 #define GUI_INTERNAL
 #include "gui/gui_private.h"
 #include "gui/gui_translate.h"
+#include "widget/gui_widget.h"
 
 #if GUI_CFG_USE_TRANSLATE || __DOXYGEN__
 
+/**
+ * \brief           Calculate hash of string for translation index
+ * \param[in]       str: String to calculate hash for
+ * \return          String hash
+ */
+static uint32_t
+translate_hash(const gui_char* str) {
+    uint32_t hash = 0x811C9DC5;                     /* FNV-1a hash */
+    
+    for (; *str; str++) {
+        hash = (hash ^ (uint8_t)*str) * 0x01000193;
+    }
+    return hash;
+}
+
+/**
+ * \brief           Build hash index of source language entries
+ * \note            When memory is not available, entries are scanned linearly on lookup
+ * \param[in]       lang: Source language to build index for
+ */
+static void
+translate_buildindex(const gui_translate_language_t* lang) {
+    size_t i, size, pos;
+    
+    if (GUI.translate.index != NULL) {
+        GUI_MEMFREE(GUI.translate.index);           /* Free index of previous language */
+    }
+    GUI.translate.index_size = 0;
+    if (lang == NULL || !lang->count || lang->count >= 0xFFFF) {
+        return;
+    }
+    
+    for (size = 4; size < 2 * lang->count; size <<= 1) {}   /* Keep index at most half full */
+    GUI.translate.index = GUI_MEMALLOC(sizeof(*GUI.translate.index) * size);
+    if (GUI.translate.index == NULL) {
+        return;
+    }
+    GUI.translate.index_size = size;
+    for (i = 0; i < lang->count; i++) {
+        for (pos = translate_hash(lang->entries[i]) & (size - 1); GUI.translate.index[pos];
+            pos = (pos + 1) & (size - 1)) {}        /* Find free slot, first entry of duplicates stays first */
+        GUI.translate.index[pos] = (uint16_t)(i + 1);
+    }
+}
+
 /**
  * \brief           Get translated entry from input string
+ * \note            Source entry is found with hash index built when source language is set
  * \param[in]       src: Pointer to \ref gui_char string to translate
  * \return          Pointer to translated string or source string if translate not found
  */
 const gui_char*
 gui_translate_get(const gui_char* src) {
-    size_t i;
+    size_t i, pos, mask;
     
     /* Try to find source string in translate table */
     if (GUI.translate.source == NULL || GUI.translate.active == NULL) { /* Check if languages set correctly */
         return src;                                 /* Just return original string */
     }
     
+    if (GUI.translate.index_size) {                 /* Index is available */
+        mask = GUI.translate.index_size - 1;
+        for (pos = translate_hash(src) & mask; GUI.translate.index[pos]; pos = (pos + 1) & mask) {
+            i = GUI.translate.index[pos] - 1;
+            if (gui_string_compare(src, GUI.translate.source->entries[i]) == 0) {
+                if (i < GUI.translate.active->count) {  /* Check if in valid range */
+                    return GUI.translate.active->entries[i];    /* Return translated string */
+                }
+                break;
+            }
+        }
+        return src;
+    }
+    
     /*
      * Scan all entries and return appropriate string
      */
@@ -65,24 +126,35 @@ gui_translate_get(const gui_char* src) {
 /**
  * \brief           Set currently active language for translated entries
  * \note            These entries are returned when index matches the source string from source language
+ * \note            All widgets are updated to new language and screen is redrawn once
  * \param[in]       lang: Pointer to \ref GUI_TRANSLATE_Language_t structure with translation entries
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_translate_setactivelanguage(const gui_translate_language_t* lang) {
+    __GUI_ENTER();                                  /* Enter GUI */
     GUI.translate.active = lang;                    /* Set currently active language */
+    GUI.translate.gen++;                            /* Memorized translations are not valid anymore */
+    guii_widget_translatechanged();                 /* Update widgets in single pass */
+    __GUI_LEAVE();                                  /* Leave GUI */
     return 1;
 }
 
 /**
  * \brief           Set source language for translated entries
  * \note            These entries are compared with input string to get index for translated value
+ * \note            Hash index of entries is built once here, entries must not change later
  * \param[in]       lang: Pointer to \ref GUI_TRANSLATE_Language_t structure with translation entries
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_translate_setsourcelanguage(const gui_translate_language_t* lang) {
+    __GUI_ENTER();                                  /* Enter GUI */
     GUI.translate.source = lang;                    /* Set source language */
+    translate_buildindex(lang);                     /* Build lookup index */
+    GUI.translate.gen++;                            /* Memorized translations are not valid anymore */
+    guii_widget_translatechanged();                 /* Update widgets in single pass */
+    __GUI_LEAVE();                                  /* Leave GUI */
     return 1;
 }
 
@@ -56,9 +56,16 @@ extern "C" {
 #include "gui/gui_linkedlist.h"
 #include "gui/gui_string.h"
 #include "gui/gui_timer.h"
+#include "gui/gui_anim.h"
 #include "gui/gui_math.h"
 #include "gui/gui_mem.h"
 #include "gui/gui_translate.h"
+#include "gui/gui_assets.h"
+#include "gui/gui_trace.h"
+#include "gui/gui_sprite.h"
+#include "gui/gui_transition.h"
+#include "gui/gui_screen.h"
+#include "gui/gui_metrics.h"
 
 /* GUI Low-Level drivers */
 #include "system/gui_ll.h"
@@ -75,8 +82,22 @@ extern "C" {
 
 #define __GUI_SYS_PROTECT()     gui_sys_protect()
 #define __GUI_SYS_UNPROTECT()   gui_sys_unprotect()
+#if GUI_CFG_INSTANCES > 1
+/* Instance is selected again on every entry, other thread could process other instance before */
+#define __GUI_ENTER()           do { __GUI_SYS_PROTECT(); guii_instance_enter(); } while (0)
+#define __GUI_LEAVE()           do { if (!GUI.BatchLevel && (GUI.flags & GUI_FLAG_REDRAW)) { __GUI_WAKEUP(0x00); } __GUI_SYS_UNPROTECT(); } while (0)
+#else /* GUI_CFG_INSTANCES > 1 */
 #define __GUI_ENTER()           __GUI_SYS_PROTECT()
-#define __GUI_LEAVE()           do { __GUI_SYS_UNPROTECT(); gui_sys_mbox_putnow(&GUI.OS.mbox, 0x00); } while (0)
+#define __GUI_LEAVE()           do { uint8_t leave_post = !GUI.BatchLevel && (GUI.flags & GUI_FLAG_REDRAW); __GUI_SYS_UNPROTECT(); if (leave_post) { __GUI_WAKEUP(0x00); } } while (0)
+#endif /* !(GUI_CFG_INSTANCES > 1) */
+
+/**
+ * \brief           Wake up GUI thread with message
+ * \note            Only one message is sent until GUI thread starts next processing pass,
+ *                  all changes made before are processed by that pass anyway
+ * \hideinitializer
+ */
+#define __GUI_WAKEUP(msg)       do { if (!GUI.OS.wakeup_pending) { GUI.OS.wakeup_pending = 1; gui_sys_mbox_putnow(&GUI.OS.mbox, (msg)); } } while (0)
 
 #else
 
@@ -103,6 +124,33 @@ extern "C" {
  */
 #define GUI_MEMALLOC(size)          gui_mem_calloc(size, 1)
 
+/**
+ * \brief           Allocate memory with specific size in bytes and region preference
+ * \note            This function must take care of reseting memory to zero
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       hint: Region preference. This parameter can be a value of \ref gui_mem_hint_t enumeration
+ * \hideinitializer
+ */
+#define GUI_MEMALLOC_HINT(size, hint)   gui_mem_calloc_hint(size, 1, hint)
+
+/**
+ * \brief           Allocate memory with specific size in bytes without reseting it to zero
+ * \note            Use it only for buffers completely written before they are read,
+ *                  such as pixel buffers filled by low-level copy or decoder
+ * \param[in]       size: Number of bytes to allocate
+ * \hideinitializer
+ */
+#define GUI_MEMALLOC_NOZERO(size)   gui_mem_alloc(size)
+
+/**
+ * \brief           Allocate memory with specific size in bytes and region preference without reseting it to zero
+ * \note            Use it only for buffers completely written before they are read
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       hint: Region preference. This parameter can be a value of \ref gui_mem_hint_t enumeration
+ * \hideinitializer
+ */
+#define GUI_MEMALLOC_NOZERO_HINT(size, hint)    gui_mem_alloc_hint(size, hint)
+
 /**
  * \brief           Reallocate memory with specific size in bytes
  * \hideinitializer
@@ -194,10 +242,35 @@ extern "C" {
 /* Include widget structure */
 #include "widget/gui_widget.h"
 #include "gui/gui_input.h"
+#include "gui/gui_gesture.h"
+#include "gui/gui_bind.h"
+#include "gui/gui_idle.h"
+#include "gui/gui_stream.h"
 
 guir_t  gui_init(void);
 int32_t gui_process(void);
 uint8_t gui_seteventcallback(gui_eventcallback_t cb);
+#if GUI_CFG_INSTANCES > 1 || __DOXYGEN__
+uint8_t gui_instance_select(uint8_t num);
+uint8_t gui_instance_getselected(void);
+#if !__DOXYGEN__
+void    guii_instance_enter(void);
+#endif /* !__DOXYGEN__ */
+#endif /* GUI_CFG_INSTANCES > 1 || __DOXYGEN__ */
+#if GUI_CFG_USE_STATS || __DOXYGEN__
+uint8_t gui_getstats(gui_stats_t* stats);
+#endif /* GUI_CFG_USE_STATS || __DOXYGEN__ */
+#if GUI_CFG_FRAME_PERIOD || __DOXYGEN__
+uint8_t gui_setframeperiod(uint32_t min_period, uint32_t max_period);
+uint32_t gui_getframeperiod(void);
+#endif /* GUI_CFG_FRAME_PERIOD || __DOXYGEN__ */
+#if GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__
+uint8_t gui_setdebugoverlay(uint8_t enable);
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__ */
+#if (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1) || __DOXYGEN__
+guir_t  gui_tile_init(void);
+uint32_t gui_tile_process(void);
+#endif /* (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1) || __DOXYGEN__ */
  
 /**
  * \}
@@ -0,0 +1,74 @@
+/**	
+ * \file            gui_anim.h
+ * \brief           Time based animations
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_ANIM_H
+#define __GUI_ANIM_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_ANIM Animations
+ * \brief           Time based animation of widget values
+ * \{
+ *
+ * Animation changes integer value from start to end value in given time.
+ * All running animations are evaluated together by single software timer.
+ * Value is always calculated from time elapsed since start of animation,
+ * so animation speed does not depend on timer period or processing load.
+ * When evaluation is late, intermediate values are skipped.
+ *
+ * Callback is called only when value changes, widget is responsible to invalidate its area.
+ * Animations of widget are removed automatically when widget is deleted.
+ */
+
+uint8_t guii_anim_start(gui_handle_p h, gui_anim_exec_fn exec, int32_t start, int32_t end, uint16_t duration, gui_anim_ease_t ease);
+uint8_t guii_anim_stop(gui_handle_p h, gui_anim_exec_fn exec);
+uint8_t guii_anim_isrunning(gui_handle_p h, gui_anim_exec_fn exec);
+
+#if (GUI_CFG_USE_TOUCH && GUI_CFG_TOUCH_HISTORY_SIZE) || __DOXYGEN__
+uint8_t guii_anim_fling(gui_handle_p h, gui_anim_exec_fn exec, int32_t pos, int32_t max, const guii_touch_data_t* ts);
+#endif /* (GUI_CFG_USE_TOUCH && GUI_CFG_TOUCH_HISTORY_SIZE) || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_ANIM_H */
@@ -0,0 +1,138 @@
+/**	
+ * \file            gui_assets.h
+ * \brief           Asset bank for fonts and images in memory-mapped flash
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_ASSETS_H
+#define __GUI_ASSETS_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_ASSETS Asset bank
+ * \brief           Fonts and images stored in memory-mapped external flash
+ * \{
+ *
+ * Asset bank is binary image generated separately from firmware and programmed to memory-mapped
+ * flash, for example QSPI or OctoSPI. It starts with \ref gui_assets_header_t, followed by
+ * table of \ref gui_assets_entry_t entries. All offsets are relative to start of bank,
+ * all values are little-endian and aligned to their size.
+ *
+ * Character and image data are used directly from flash, only descriptors are built in RAM when asset is requested.
+ * Assets can be updated without linking firmware again, as long as no asset from bank is in use while it is programmed.
+ */
+
+#define GUI_ASSETS_MAGIC                ((uint32_t)0x41495547)  /*!< Bank identification, `GUIA` in ASCII */
+#define GUI_ASSETS_VERSION              ((uint16_t)0x0001)      /*!< Supported bank format version */
+#define GUI_ASSETS_NAME_LEN             24                      /*!< Maximal asset name length including trailing zero */
+
+#define GUI_ASSETS_TYPE_FONT            ((uint8_t)0x01)         /*!< Entry is font, \ref gui_assets_font_t */
+#define GUI_ASSETS_TYPE_IMAGE           ((uint8_t)0x02)         /*!< Entry is image, \ref gui_assets_image_t */
+
+/**
+ * \brief           Asset bank header at start of bank
+ */
+typedef struct {
+    uint32_t magic;                         /*!< Must be set to \ref GUI_ASSETS_MAGIC */
+    uint16_t version;                       /*!< Must be set to \ref GUI_ASSETS_VERSION */
+    uint16_t count;                         /*!< Number of entries in table following header */
+} gui_assets_header_t;
+
+/**
+ * \brief           Asset table entry
+ */
+typedef struct {
+    gui_char name[GUI_ASSETS_NAME_LEN];     /*!< Zero terminated asset name */
+    uint8_t type;                           /*!< Asset type, \ref GUI_ASSETS_TYPE_FONT or \ref GUI_ASSETS_TYPE_IMAGE */
+    uint8_t reserved[3];                    /*!< Reserved, set to 0 */
+    uint32_t offset;                        /*!< Offset of asset data from start of bank */
+} gui_assets_entry_t;
+
+/**
+ * \brief           Image asset, raw pixel data follow the structure
+ */
+typedef struct {
+    uint16_t x_size;                        /*!< Image X size */
+    uint16_t y_size;                        /*!< Image Y size */
+    uint8_t bpp;                            /*!< Bits per pixel */
+    uint8_t reserved[3];                    /*!< Reserved, set to 0 */
+} gui_assets_image_t;
+
+/**
+ * \brief           Font asset
+ * \note            Structure is followed by `ranges_count` entries of \ref gui_assets_font_range_t
+ *                  and then by \ref gui_assets_font_char_t entry for every character in all ranges
+ */
+typedef struct {
+    uint8_t size;                           /*!< Font size in units of pixels */
+    uint8_t flags;                          /*!< List of font flags, \ref GUI_FLAG_FONT_AA and others */
+    uint16_t ranges_count;                  /*!< Number of character ranges, sorted by start character */
+} gui_assets_font_t;
+
+/**
+ * \brief           Font asset character range
+ */
+typedef struct {
+    uint32_t startchar;                     /*!< First character in range */
+    uint32_t endchar;                       /*!< Last character in range */
+} gui_assets_font_range_t;
+
+/**
+ * \brief           Font asset character information
+ */
+typedef struct {
+    uint8_t x_size;                         /*!< Character x size in units of pixels */
+    uint8_t y_size;                         /*!< Character y size in units of pixels */
+    uint8_t x_pos;                          /*!< Character relative x offset in units of pixels */
+    uint8_t y_pos;                          /*!< Character relative y offset in units of pixels */
+    uint8_t x_margin;                       /*!< Right margin after character in units of pixels */
+    uint8_t reserved[3];                    /*!< Reserved, set to 0 */
+    uint32_t offset;                        /*!< Offset of character data from start of bank */
+} gui_assets_font_char_t;
+
+uint8_t gui_assets_mount(const void* base);
+uint8_t gui_assets_unmount(void);
+const gui_font_t* gui_assets_getfont(const gui_char* name);
+const gui_image_desc_t* gui_assets_getimage(const gui_char* name);
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_ASSETS_H */
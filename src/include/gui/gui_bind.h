@@ -0,0 +1,95 @@
+/**	
+ * \file            gui_bind.h
+ * \brief           Value slots bound to widget text
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_BIND_H
+#define __GUI_BIND_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_BIND Data binding
+ * \brief           Value slots written from producer threads and shown by bound widgets
+ * \{
+ *
+ * Value slot is \ref gui_bind_value_t structure owned by user. Producer thread writes it
+ * with \ref gui_bind_setint, \ref gui_bind_setfloat or \ref gui_bind_setstring without GUI lock.
+ * Write only increments slot sequence twice and wakes up GUI thread, it never waits for frame to finish.
+ *
+ * Widgets are bound to slot with printf style format. Once per frame GUI thread checks sequence
+ * of every bound slot, formats changed values and sets widget text only when formatted text differs
+ * from text shown before. Many writes between frames cause single formatting and
+ * unchanged text, for example `%.1f` of slowly changing temperature, causes no redraw.
+ *
+ * \code{c}
+gui_bind_value_t temp;
+
+gui_bind_init(&temp, GUI_BIND_FLOAT);
+gui_bind_widget(textview, &temp, "Temp: %.1f C");
+
+//In sensor thread
+gui_bind_setfloat(&temp, degrees);
+\endcode
+ */
+
+#if GUI_CFG_BIND_COUNT || __DOXYGEN__
+
+void            gui_bind_init(gui_bind_value_t* v, gui_bind_type_t type);
+void            gui_bind_setint(gui_bind_value_t* v, int32_t value);
+void            gui_bind_setfloat(gui_bind_value_t* v, float value);
+void            gui_bind_setstring(gui_bind_value_t* v, const gui_char* str);
+
+uint8_t         gui_bind_widget(gui_handle_p h, const gui_bind_value_t* v, const char* fmt);
+uint8_t         gui_bind_remove(gui_handle_p h);
+
+#if defined(GUI_INTERNAL) || __DOXYGEN__
+
+void            guii_bind_process(void);
+void            guii_bind_remove(gui_handle_p h);
+
+#endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
+
+#endif /* GUI_CFG_BIND_COUNT || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_BIND_H */
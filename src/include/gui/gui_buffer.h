@@ -71,6 +71,11 @@ uint8_t gui_buffer_init(GUI_BUFFER_t* Buffer, uint32_t Size, void* BufferPtr);
 void gui_buffer_free(GUI_BUFFER_t* Buffer);
 uint32_t gui_buffer_write(GUI_BUFFER_t* Buffer, const void* Data, uint32_t count);
 uint32_t gui_buffer_read(GUI_BUFFER_t* Buffer, void* Data, uint32_t count);
+uint32_t gui_buffer_peek(GUI_BUFFER_t* Buffer, uint32_t skip, void* Data, uint32_t count);
+void* gui_buffer_getlinearread(GUI_BUFFER_t* Buffer, uint32_t* count);
+uint32_t gui_buffer_skip(GUI_BUFFER_t* Buffer, uint32_t count);
+void* gui_buffer_getlinearwrite(GUI_BUFFER_t* Buffer, uint32_t* count);
+uint32_t gui_buffer_advance(GUI_BUFFER_t* Buffer, uint32_t count);
 uint32_t gui_buffer_getfree(GUI_BUFFER_t* Buffer);
 uint32_t gui_buffer_getfull(GUI_BUFFER_t* Buffer);
 void gui_buffer_reset(GUI_BUFFER_t* Buffer);
@@ -44,6 +44,93 @@
 #define GUI_CFG_OS                              1
 #endif
 
+/**
+ * \brief           Number of GUI instances, one for each display
+ *
+ *                  Every instance has own low-level driver, widget tree, dirty regions,
+ *                  timers and frame period. Instance is selected with \ref gui_instance_select
+ *                  before \ref gui_init and before widgets of its display are used.
+ *                  With \ref GUI_CFG_OS enabled, every instance has own GUI thread.
+ *                  Character cache and image buffers are shared by all instances.
+ *
+ * \note            Input devices, sprites, value bindings and idle tasks are processed by first instance
+ * \note            Low-level driver gets instance being initialized with \ref gui_instance_getselected
+ * \note            Not available with \ref GUI_CFG_OS_RENDER_THREAD, \ref GUI_CFG_LL_STATIC and \ref GUI_CFG_USE_TRACE
+ */
+#ifndef GUI_CFG_INSTANCES
+#define GUI_CFG_INSTANCES                       1
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) POSIX threads system port instead of CMSIS OS
+ *
+ *                  Used by host simulator where `src/system/gui_system_posix.c` is compiled
+ *                  instead of `src/system/gui_system_cmsis_os.c`
+ *
+ * \note            Used only when \ref GUI_CFG_OS is enabled
+ */
+#ifndef GUI_CFG_SYS_POSIX
+#define GUI_CFG_SYS_POSIX                       0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) native FreeRTOS system port instead of CMSIS OS
+ *
+ *                  When enabled, `src/system/gui_system_freertos.c` is compiled
+ *                  instead of `src/system/gui_system_cmsis_os.c`.
+ *                  Mutexes, semaphores and message queues are allocated statically
+ *                  and GUI thread is woken up with direct task notification
+ *
+ * \note            Used only when \ref GUI_CFG_OS is enabled
+ */
+#ifndef GUI_CFG_SYS_FREERTOS
+#define GUI_CFG_SYS_FREERTOS                    0
+#endif
+
+/**
+ * \brief           Maximal number of entries in single message queue of FreeRTOS port
+ *
+ *                  Entries are part of message queue structure to avoid dynamic allocation,
+ *                  create function fails when more entries are requested
+ *
+ * \note            Used only when \ref GUI_CFG_SYS_FREERTOS is enabled
+ */
+#ifndef GUI_CFG_SYS_FREERTOS_MBOX_SIZE
+#define GUI_CFG_SYS_FREERTOS_MBOX_SIZE          32
+#endif
+
+/**
+ * \brief           Number of widget parameter changes from other threads which can wait to be applied
+ *
+ *                  Parameter setters called from thread other than GUI thread put change to queue
+ *                  and return without waiting GUI thread to finish current processing.
+ *                  Changes are applied at the beginning of next \ref gui_process call.
+ *                  When queue is full, change is applied directly.
+ *
+ *                  Set to `0` to always apply changes directly
+ *
+ * \note            Used only when \ref GUI_CFG_OS is enabled
+ */
+#ifndef GUI_CFG_WIDGET_POST_QUEUE_SIZE
+#define GUI_CFG_WIDGET_POST_QUEUE_SIZE          16
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) separate rasterizer thread
+ *
+ *                  GUI thread processes input, timers and widget callbacks and records
+ *                  drawing commands of dirty regions to frame display list.
+ *                  Rasterizer thread draws recorded frames to drawing layer and swaps layers,
+ *                  while GUI thread already processes input and records next frame.
+ *
+ * \note            Requires \ref GUI_CFG_OS and \ref GUI_CFG_USE_DISPLAY_LIST.
+ *                  Not available with \ref GUI_CFG_LCD_BAND, \ref GUI_CFG_LCD_TILE and \ref GUI_CFG_USE_TRANSPARENCY,
+ *                  retained bitmaps and scrolling by memory copy are not used
+ */
+#ifndef GUI_CFG_OS_RENDER_THREAD
+#define GUI_CFG_OS_RENDER_THREAD                0
+#endif
+
 /**
  * \brief           Enables (1) or disables (0) touch support
  */
@@ -51,6 +138,23 @@
 #define GUI_CFG_USE_TOUCH                       1
 #endif
 
+/**
+ * \brief           Memory barrier used between input producer and GUI thread
+ *
+ *                  Touch and keyboard entries are exchanged with GUI thread without locks,
+ *                  so entry data must be visible before new index is published.
+ *                  Define to `__DMB()` or equivalent when compiler is not recognized
+ */
+#ifndef GUI_CFG_MEMORY_BARRIER
+#if defined(__CC_ARM)
+#define GUI_CFG_MEMORY_BARRIER()                __dmb(0xF)
+#elif defined(__GNUC__) || defined(__clang__)
+#define GUI_CFG_MEMORY_BARRIER()                __sync_synchronize()
+#else
+#define GUI_CFG_MEMORY_BARRIER()                do {} while (0)
+#endif
+#endif
+
 /**
  * \brief           Enables (1) or disables (0) keyboard support
  */
@@ -83,6 +187,159 @@
 #define GUI_CFG_TOUCH_MAX_PRESSES               2
 #endif
 
+/**
+ * \brief           Enables (1) or disables (0) merging of consecutive touch move samples
+ *
+ *                  When touch controller reports more move samples between 2 processing loops,
+ *                  only latest of them is delivered to widget with \ref GUI_WC_TouchMove event,
+ *                  so widget callback and redraw are executed only once per frame.
+ *                  Press, release and change in number of touches are never merged
+ *
+ * \note            Merged samples are still recorded in touch history, see \ref GUI_CFG_TOUCH_HISTORY_SIZE
+ */
+#ifndef GUI_CFG_TOUCH_MOVE_COALESCE
+#define GUI_CFG_TOUCH_MOVE_COALESCE             1
+#endif
+
+/**
+ * \brief           Number of latest touch positions kept while touch is pressed
+ *
+ *                  History includes merged move samples and is used to calculate
+ *                  touch velocity for gestures. Set to `0` to disable history
+ */
+#ifndef GUI_CFG_TOUCH_HISTORY_SIZE
+#define GUI_CFG_TOUCH_HISTORY_SIZE              8
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) conditioning of touch samples in \ref gui_input_touchadd
+ *
+ *                  Raw controller coordinates are calibrated with \ref gui_input_touchsetcalibration,
+ *                  filtered with median of 3 and IIR filter, and moves smaller than \ref GUI_CFG_TOUCH_DEADZONE
+ *                  are dropped before they are written to touch buffer. All processing uses integer math
+ */
+#ifndef GUI_CFG_TOUCH_FILTER
+#define GUI_CFG_TOUCH_FILTER                    0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) median of last 3 samples to remove single-sample spikes
+ *
+ * \note            Used only when \ref GUI_CFG_TOUCH_FILTER is enabled
+ */
+#ifndef GUI_CFG_TOUCH_FILTER_MEDIAN
+#define GUI_CFG_TOUCH_FILTER_MEDIAN             1
+#endif
+
+/**
+ * \brief           IIR filter strength, new position moves `1 / 2^value` of the way to new sample
+ *
+ *                  Higher value removes more jitter and adds more lag. Set to `0` to disable IIR filter
+ *
+ * \note            Used only when \ref GUI_CFG_TOUCH_FILTER is enabled
+ */
+#ifndef GUI_CFG_TOUCH_FILTER_IIR_SHIFT
+#define GUI_CFG_TOUCH_FILTER_IIR_SHIFT          1
+#endif
+
+/**
+ * \brief           Minimal move of pressed touch on any axis to report new position, in units of pixels
+ *
+ *                  Smaller moves caused by noise do not create \ref GUI_WC_TouchMove events and redraws
+ *
+ * \note            Used only when \ref GUI_CFG_TOUCH_FILTER is enabled
+ */
+#ifndef GUI_CFG_TOUCH_DEADZONE
+#define GUI_CFG_TOUCH_DEADZONE                  3
+#endif
+
+/**
+ * \brief           Time touch must be pressed without move to detect long click in units of milliseconds
+ */
+#ifndef GUI_CFG_TOUCH_LONGCLICK_TIME
+#define GUI_CFG_TOUCH_LONGCLICK_TIME            2000
+#endif
+
+/**
+ * \brief           Maximal time between release and second press to detect double click in units of milliseconds
+ */
+#ifndef GUI_CFG_TOUCH_DBLCLICK_TIME
+#define GUI_CFG_TOUCH_DBLCLICK_TIME             300
+#endif
+
+/**
+ * \brief           Maximal distance between 2 clicks on each axis to detect double click in units of pixels
+ */
+#ifndef GUI_CFG_TOUCH_DBLCLICK_DISTANCE
+#define GUI_CFG_TOUCH_DBLCLICK_DISTANCE         30
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) recognition of swipe and pinch gestures
+ *
+ *                  Gestures are recognized once in touch processing and sent to active widget
+ *                  with \ref GUI_WC_Swipe and \ref GUI_WC_Pinch events.
+ *                  When widget does not process event, it is sent to its parent
+ */
+#ifndef GUI_CFG_USE_TOUCH_GESTURES
+#define GUI_CFG_USE_TOUCH_GESTURES              1
+#endif
+
+/**
+ * \brief           Minimal distance of single touch between press and release to detect swipe in units of pixels
+ */
+#ifndef GUI_CFG_TOUCH_SWIPE_DISTANCE
+#define GUI_CFG_TOUCH_SWIPE_DISTANCE            50
+#endif
+
+/**
+ * \brief           Minimal touch velocity at release to detect swipe in units of pixels per second
+ */
+#ifndef GUI_CFG_TOUCH_SWIPE_VELOCITY
+#define GUI_CFG_TOUCH_SWIPE_VELOCITY            300
+#endif
+
+/**
+ * \brief           Minimal change of distance between 2 touches to start pinch in units of pixels
+ */
+#ifndef GUI_CFG_TOUCH_PINCH_DISTANCE
+#define GUI_CFG_TOUCH_PINCH_DISTANCE            10
+#endif
+
+/**
+ * \brief           Number of grid cells per screen dimension for touch hit-test index
+ *
+ *                  Visible widgets are collected to list with already clipped positions
+ *                  and sorted to grid cells, so widget below touch is found
+ *                  without walking complete widget tree on every press.
+ *                  List is rebuilt only after geometry, visibility or order of widgets changes.
+ *
+ * \note            Set to `0` to disable index and always walk widget tree
+ */
+#ifndef GUI_CFG_TOUCH_INDEX_GRID
+#define GUI_CFG_TOUCH_INDEX_GRID                8
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) independent touch pointers
+ *
+ *                  Touch point pressed on widget not related to widget of first touch
+ *                  gets its own active widget and receives its own press, move, release and click events,
+ *                  so 2 users can press 2 buttons at the same time. Touch points on the same widget
+ *                  or its children are still delivered together, for example for pinch.
+ *                  Points are tracked between samples by their nearest previous position.
+ *                  Widget is found with touch hit-test index only once, when point is pressed
+ *
+ * \note            Requires \ref GUI_CFG_TOUCH_MAX_PRESSES greater than `1` and \ref GUI_CFG_TOUCH_INDEX_GRID
+ */
+#ifndef GUI_CFG_TOUCH_POINTERS
+#define GUI_CFG_TOUCH_POINTERS                  0
+#endif
+#if GUI_CFG_TOUCH_MAX_PRESSES < 2 || !GUI_CFG_TOUCH_INDEX_GRID
+#undef GUI_CFG_TOUCH_POINTERS
+#define GUI_CFG_TOUCH_POINTERS                  0   /* Nothing to split or no index to find widget */
+#endif
+
 /**
  * \brief           Maximal number of keyboard entries in buffer
  */
@@ -101,6 +358,31 @@
 #define GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE   1
 #endif
 
+/**
+ * \brief           Enables (1) or disables (0) cached background of graph widgets
+ *
+ *                  Background, border and grid lines are kept in bitmap of widget size
+ *                  and copied to display on next redraws. Bitmap is drawn again
+ *                  when size, borders, grid or colors change.
+ *
+ * \note            It requires \ref gui_ll_t.Copy function and one bitmap of widget size in RAM for each graph
+ */
+#ifndef GUI_CFG_WIDGET_GRAPH_BG_CACHE
+#define GUI_CFG_WIDGET_GRAPH_BG_CACHE           0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) cached dial of gauge widgets
+ *
+ *                  Dial face with ticks and labels is kept in bitmap of widget size
+ *                  and copied to display on next redraws, only needle is drawn again
+ *
+ * \note            It requires \ref gui_ll_t.Copy function and one bitmap of widget size in RAM for each gauge
+ */
+#ifndef GUI_CFG_WIDGET_GAUGE_DIAL_CACHE
+#define GUI_CFG_WIDGET_GAUGE_DIAL_CACHE         0
+#endif
+
 /**
  * \brief           Enables (1) or disables (0) widget mode inside parent only
  *                  
@@ -114,6 +396,19 @@
 #define GUI_CFG_WIDGET_INSIDE_PARENT            0
 #endif
 
+/**
+ * \brief           Enables (1) or disables (0) 16.16 fixed-point storage for widget position and size
+ *
+ *                  When enabled, widget geometry is stored as integer values
+ *                  and no floating point operations are used when calculating widget position and size.
+ *                  Use it on targets without FPU
+ *
+ * \note            Percent values are stored with precision of `1/65536` percent
+ */
+#ifndef GUI_CFG_WIDGET_FIXED_POINT
+#define GUI_CFG_WIDGET_FIXED_POINT              0
+#endif
+
 /**
  * \brief           Enables (1) or disables (0) automatic translations on widget text
  *
@@ -123,6 +418,96 @@
 #define GUI_CFG_USE_TRANSLATE                   1
 #endif
 
+/**
+ * \brief           Enables (1) or disables (0) fonts and images from asset bank in memory-mapped flash
+ *
+ * \note            When enabled, bank must be mounted in \ref GUI_ASSETS module before assets are requested
+ */
+#ifndef GUI_CFG_USE_ASSETS
+#define GUI_CFG_USE_ASSETS                      0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) images streamed from file system to RAM
+ *
+ *                  With \ref GUI_CFG_OS images are read by separate I/O thread,
+ *                  otherwise in chunks by idle task of GUI thread, see \ref GUI_CFG_USE_IDLE_TASKS
+ *
+ * \note            When enabled, images are loaded with \ref gui_stream_image_load
+ */
+#ifndef GUI_CFG_USE_STREAM
+#define GUI_CFG_USE_STREAM                      0
+#endif
+
+/**
+ * \brief           Number of bytes read from file by single read call of image stream
+ *
+ * \note            Used only when \ref GUI_CFG_USE_STREAM is enabled
+ */
+#ifndef GUI_CFG_STREAM_CHUNK
+#define GUI_CFG_STREAM_CHUNK                    4096
+#endif
+
+/**
+ * \brief           Number of image loads waiting for I/O thread before \ref gui_stream_image_load blocks
+ *
+ * \note            Used only when \ref GUI_CFG_USE_STREAM and \ref GUI_CFG_OS are enabled
+ */
+#ifndef GUI_CFG_STREAM_QUEUE
+#define GUI_CFG_STREAM_QUEUE                    8
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) built-in software drawing for functions not implemented by low-level driver
+ *
+ * \note            Software functions write directly to layer memory with CPU
+ */
+#ifndef GUI_CFG_LL_SOFTWARE
+#define GUI_CFG_LL_SOFTWARE                     1
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) SIMD instructions in software drawing functions
+ *
+ *                  Color channels are blended in pairs with DSP extension instructions
+ *                  (`UXTB16`, `UXTAB16`) of Cortex-M4, M7, M33, M55 and M85.
+ *                  Result is identical to generic C implementation.
+ *                  Enabled by default when compiler reports SIMD support
+ *
+ * \note            Used only when \ref GUI_CFG_LL_SOFTWARE is enabled
+ */
+#ifndef GUI_CFG_LL_SOFTWARE_SIMD
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#define GUI_CFG_LL_SOFTWARE_SIMD                1
+#else
+#define GUI_CFG_LL_SOFTWARE_SIMD                0
+#endif
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) compile-time binding of low-level drawing functions
+ *
+ *                  When enabled, \ref GUI_CFG_LL_STATIC_HEADER is included by GUI core and can map
+ *                  any drawing function of \ref gui_ll_t to a function known at compile time,
+ *                  for example `#define GUI_LL_SetPixel my_lcd_setpixel`.
+ *                  Drawing module then calls it directly, which allows compiler to inline it.
+ *                  Functions not mapped by header are still called through \ref gui_ll_t.
+ *
+ * \note            Low-level driver must still set the same functions to \ref gui_ll_t on initialization.
+ *                  Directly called functions are not traced when \ref GUI_CFG_USE_TRACE is enabled
+ */
+#ifndef GUI_CFG_LL_STATIC
+#define GUI_CFG_LL_STATIC                       0
+#endif
+
+/**
+ * \brief           Header file with low-level functions bound at compile time
+ * \note            Used only when \ref GUI_CFG_LL_STATIC is enabled
+ */
+#ifndef GUI_CFG_LL_STATIC_HEADER
+#define GUI_CFG_LL_STATIC_HEADER                "gui_ll_static.h"
+#endif
+
 /**
  * \brief           Enables (1) or disables (0) library custom allocation algorithm.
  *      
@@ -133,25 +518,1161 @@
 #endif
 
 /**
- * \brief           Memory alignment setup, used for memory allocation in systems where unaligned memory access is not allowed
- * \note            Value must be power of 2, in most cases number 4 will be ok.
+ * \brief           Enables (1) or disables (0) two-level segregated fit (TLSF) allocation algorithm
  *
- *                  1: No memory alignment
- *                  2: align memory to 2 bytes
- *                  4: align memory to 4 bytes
- *                  8: align memory to 8 bytes
+ *                  When enabled, free blocks are kept in lists by size class and
+ *                  allocation and free operations take constant time regardless of heap fragmentation.
+ *                  When disabled, first-fit algorithm with single list of free blocks is used
+ *
+ * \note            Used only when \ref GUI_CFG_USE_MEM is enabled
  */
-#ifndef GUI_CFG_MEM_ALIGNMENT
-#define GUI_CFG_MEM_ALIGNMENT                   4
+#ifndef GUI_CFG_MEM_TLSF
+#define GUI_CFG_MEM_TLSF                        0
 #endif
 
 /**
- * \brief           Enables (1) or disables (0) transparency option for widgets
+ * \brief           Maximal number of memory regions with own TLSF free lists
  *
- *                  When enabled, widgets can overlay each other and bottom widget can be visible below top one
+ *                  Allocation with \ref GUI_MEM_HOT or \ref GUI_MEM_BULK hint finds block
+ *                  of preferred region in constant time. Further regions share lists of the last one.
+ *                  Each region takes about `1.8 kB` of static memory for its lists on 32-bit system
+ *
+ * \note            Used only when \ref GUI_CFG_MEM_TLSF is enabled
  */
-#ifndef GUI_CFG_USE_TRANSPARENCY
-#define GUI_CFG_USE_TRANSPARENCY                0
+#ifndef GUI_CFG_MEM_TLSF_REGIONS
+#define GUI_CFG_MEM_TLSF_REGIONS                2
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) movable memory blocks and heap compaction
+ *
+ *                  Large buffers, such as dynamic widget text and cached widget bitmaps,
+ *                  are marked as movable together with address of pointer owning them.
+ *                  When memory is freed, idle task slides movable blocks down to free space before them
+ *                  and updates owner pointers, so free memory is merged to bigger blocks.
+ *                  Check result with \ref gui_mem_getlargestfree
+ *
+ * \note            Pointers to movable memory, such as text returned by \ref gui_widget_gettext,
+ *                  are valid only until GUI thread runs idle tasks
+ * \note            Requires first-fit allocator, \ref GUI_CFG_MEM_TLSF must be disabled.
+ *                  Not available with \ref GUI_CFG_OS_RENDER_THREAD
+ */
+#ifndef GUI_CFG_MEM_RELOC
+#define GUI_CFG_MEM_RELOC                       0
+#endif
+
+/**
+ * \brief           Maximal number of bytes moved at a time by heap compaction
+ *
+ *                  Idle task checks its time budget after each chunk
+ *
+ * \note            Used only when \ref GUI_CFG_MEM_RELOC is enabled
+ */
+#ifndef GUI_CFG_MEM_RELOC_CHUNK
+#define GUI_CFG_MEM_RELOC_CHUNK                 2048
+#endif
+
+/**
+ * \brief           Minimal size of zeroed allocation in bytes reset by low-level fill instead of CPU
+ *
+ *                  Big blocks allocated with \ref GUI_MEMALLOC are reset with low-level `Fill` function,
+ *                  such as DMA2D register-to-memory transfer, while smaller ones still use `memset`.
+ *                  Set to `0` to always reset memory with CPU
+ *
+ * \note            All memory regions assigned with \ref gui_mem_assignmemory
+ *                  must be accessible by low-level hardware without data cache maintenance
+ * \note            Requires \ref GUI_CFG_USE_MEM, not available with \ref GUI_CFG_OS_RENDER_THREAD
+ */
+#ifndef GUI_CFG_MEM_ZERO_LL
+#define GUI_CFG_MEM_ZERO_LL                     0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) fixed-size object pools
+ *
+ *                  When enabled, widget handles, timers and list items are allocated from pools.
+ *                  Pool allocates memory for \ref GUI_CFG_MEM_POOL_SLAB_COUNT objects at a time
+ *                  and keeps freed objects for next allocations instead of returning them to heap
+ */
+#ifndef GUI_CFG_MEM_POOL
+#define GUI_CFG_MEM_POOL                        1
+#endif
+
+/**
+ * \brief           Number of objects allocated from heap at a time when pool is empty
+ */
+#ifndef GUI_CFG_MEM_POOL_SLAB_COUNT
+#define GUI_CFG_MEM_POOL_SLAB_COUNT             16
+#endif
+
+/**
+ * \brief           Maximal number of different widget handle sizes with own pool
+ *
+ *                  Widgets of other sizes are allocated directly from heap
+ */
+#ifndef GUI_CFG_MEM_POOL_WIDGET_SIZES
+#define GUI_CFG_MEM_POOL_WIDGET_SIZES           8
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) static memory for pools and glyph cache
+ *
+ *                  Widget handles, timers, listview rows and items and font characters prepared in RAM
+ *                  are taken from statically allocated arrays with size set at compile time and never from heap.
+ *                  Allocation takes constant time, freed objects are reused for objects of the same size
+ *                  and memory used by GUI objects is known at link time. Allocation fails when array is full.
+ *                  Font characters are placed to ring of \ref GUI_CFG_FONT_CACHE_SIZE bytes
+ *                  and oldest characters are released first when ring is full
+ *
+ * \note            Other memory, such as dynamic widget text and cached bitmaps, is still taken from
+ *                  regions assigned with \ref gui_mem_assignmemory, enable \ref GUI_CFG_MEM_TLSF
+ *                  for constant time of these allocations
+ * \note            Requires \ref GUI_CFG_MEM_POOL and \ref GUI_CFG_FONT_CACHE_SIZE greater than `0`,
+ *                  not available with \ref GUI_CFG_LINKEDLIST_COMPACT
+ */
+#ifndef GUI_CFG_MEM_STATIC
+#define GUI_CFG_MEM_STATIC                      0
+#endif
+
+/**
+ * \brief           Size of static memory for widget handles in units of bytes
+ *
+ *                  Memory is shared by widgets of all types, each handle size takes its objects from it
+ *
+ * \note            Used only when \ref GUI_CFG_MEM_STATIC is enabled
+ */
+#ifndef GUI_CFG_MEM_STATIC_WIDGETS_SIZE
+#define GUI_CFG_MEM_STATIC_WIDGETS_SIZE         8192
+#endif
+
+/**
+ * \brief           Maximal number of timers
+ *
+ * \note            Used only when \ref GUI_CFG_MEM_STATIC is enabled
+ */
+#ifndef GUI_CFG_MEM_STATIC_TIMERS
+#define GUI_CFG_MEM_STATIC_TIMERS               16
+#endif
+
+/**
+ * \brief           Maximal number of rows of all listview widgets
+ *
+ * \note            Used only when \ref GUI_CFG_MEM_STATIC is enabled
+ */
+#ifndef GUI_CFG_MEM_STATIC_LISTVIEW_ROWS
+#define GUI_CFG_MEM_STATIC_LISTVIEW_ROWS        64
+#endif
+
+/**
+ * \brief           Maximal number of items in rows of all listview widgets
+ *
+ * \note            Used only when \ref GUI_CFG_MEM_STATIC is enabled
+ */
+#ifndef GUI_CFG_MEM_STATIC_LISTVIEW_ITEMS
+#define GUI_CFG_MEM_STATIC_LISTVIEW_ITEMS       256
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) heap usage profiling by allocation tag
+ *
+ *                  Every allocation is tagged with widget type name or purpose of memory,
+ *                  such as text, glyph cache or transparency layer.
+ *                  Usage per tag is read with \ref gui_mem_gettagstats or printed with \ref gui_mem_report
+ *
+ * \note            Each allocation uses additional header memory and fixed-size pools
+ *                  allocate objects directly from heap, so each object is accounted to own tag
+ */
+#ifndef GUI_CFG_MEM_PROFILE
+#define GUI_CFG_MEM_PROFILE                     0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) release of cached memory when allocation fails
+ *
+ *                  Caches registered with \ref gui_mem_reclaim_add are asked to release memory
+ *                  in order of their priority and allocation is tried again.
+ *                  Glyph cache, scaled images, retained bitmaps and screen stack register themselves
+ *                  when they allocate first memory
+ */
+#ifndef GUI_CFG_MEM_RECLAIM
+#define GUI_CFG_MEM_RECLAIM                     1
+#endif
+
+/**
+ * \brief           Maximal number of different tags tracked by heap profiler
+ *
+ *                  When all entries are used, allocations with new tags are accounted to first entry
+ *
+ * \note            Used only when \ref GUI_CFG_MEM_PROFILE is enabled
+ */
+#ifndef GUI_CFG_MEM_PROFILE_TAGS
+#define GUI_CFG_MEM_PROFILE_TAGS                24
+#endif
+
+/**
+ * \brief           Memory alignment setup, used for memory allocation in systems where unaligned memory access is not allowed
+ * \note            Value must be power of 2, in most cases number 4 will be ok.
+ *
+ *                  1: No memory alignment
+ *                  2: align memory to 2 bytes
+ *                  4: align memory to 4 bytes
+ *                  8: align memory to 8 bytes
+ */
+#ifndef GUI_CFG_MEM_ALIGNMENT
+#define GUI_CFG_MEM_ALIGNMENT                   4
+#endif
+
+/**
+ * \brief           Maximal number of separate dirty rectangles tracked between 2 redraw operations
+ *
+ *                  Invalidated areas are merged together only when merged area is not bigger
+ *                  than areas drawn separately or when there is no free slot anymore.
+ *                  When set to 1, all invalidated areas are merged to single bounding box
+ */
+#ifndef GUI_CFG_DISPLAY_DIRTY_RECTS
+#define GUI_CFG_DISPLAY_DIRTY_RECTS             4
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) partial band rendering for displays with internal GRAM
+ *
+ *                  Dirty regions are drawn in small bands to one of 2 band buffers, each band is sent to display
+ *                  with \ref GUI_LL_Command_Flush command while next band is drawn to other buffer.
+ *                  Frame buffer in MCU memory is not required
+ *
+ * \note            Low-level driver must confirm finished transfer with \ref gui_lcd_confirmflush.
+ *                  Debug overlay and moving pixels of scrolled widgets are not available in this mode
+ */
+#ifndef GUI_CFG_LCD_BAND
+#define GUI_CFG_LCD_BAND                        0
+#endif
+
+/**
+ * \brief           Size of single band buffer in units of bytes
+ *
+ *                  Band holds as many lines of dirty region as possible,
+ *                  2 buffers are used when \ref GUI_CFG_LCD_BAND is enabled
+ */
+#ifndef GUI_CFG_LCD_BAND_SIZE
+#define GUI_CFG_LCD_BAND_SIZE                   4096
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) tile based redraw to fast on-chip memory
+ *
+ *                  Dirty regions are split to tiles of fixed grid. All widgets of tile are drawn
+ *                  to small tile buffer first and finished tile is copied to drawing layer with single
+ *                  low-level copy operation. Pixels drawn multiple times by overlapping widgets
+ *                  this way cost fast memory bandwidth instead of display memory bandwidth.
+ *
+ * \note            Not available together with \ref GUI_CFG_LCD_BAND, low-level driver must implement `Copy` function
+ *                  to copy finished tiles. Use display lists with \ref GUI_CFG_USE_DISPLAY_LIST to draw widgets
+ *                  spread over many tiles with single call of their draw callback
+ */
+#ifndef GUI_CFG_LCD_TILE
+#define GUI_CFG_LCD_TILE                        0
+#endif
+
+/**
+ * \brief           Width of single tile in units of pixels when \ref GUI_CFG_LCD_TILE is enabled
+ */
+#ifndef GUI_CFG_LCD_TILE_WIDTH
+#define GUI_CFG_LCD_TILE_WIDTH                  32
+#endif
+
+/**
+ * \brief           Height of single tile in units of pixels when \ref GUI_CFG_LCD_TILE is enabled
+ */
+#ifndef GUI_CFG_LCD_TILE_HEIGHT
+#define GUI_CFG_LCD_TILE_HEIGHT                 32
+#endif
+
+/**
+ * \brief           Attribute placed after declaration of tile buffer when \ref GUI_CFG_LCD_TILE is enabled
+ *
+ *                  Use it to place buffer to fast on-chip memory accessible by low-level driver,
+ *                  for example `__attribute__((section(".dtcm")))`
+ */
+#ifndef GUI_CFG_LCD_TILE_ATTR
+#define GUI_CFG_LCD_TILE_ATTR
+#endif
+
+/**
+ * \brief           Number of processor cores drawing tiles when \ref GUI_CFG_LCD_TILE is enabled
+ *
+ *                  When set to `2`, widgets of dirty regions are recorded to display list once
+ *                  and tiles are drawn from it by main core and by second core, which calls \ref gui_tile_process.
+ *                  Low-level driver of both cores must support \ref GUI_LL_Command_CoreLock
+ *                  and \ref GUI_LL_Command_CoreUnlock commands
+ *
+ * \note            Requires \ref GUI_CFG_USE_DISPLAY_LIST. Not available with \ref GUI_CFG_LCD_ROTATION
+ *                  and \ref GUI_CFG_USE_TRANSPARENCY, retained bitmaps are not used.
+ *                  GUI memory must be accessible by both cores, display list is allocated from it
+ */
+#ifndef GUI_CFG_LCD_TILE_CORES
+#define GUI_CFG_LCD_TILE_CORES                  1
+#endif
+
+/**
+ * \brief           Attribute placed after declaration of tile job shared between cores
+ *
+ *                  Job must be at the same address in images of both cores, in memory without data cache,
+ *                  for example `__attribute__((section(".shared")))`
+ */
+#ifndef GUI_CFG_LCD_TILE_SHARED_ATTR
+#define GUI_CFG_LCD_TILE_SHARED_ATTR
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) static background hardware layer
+ *
+ *                  Low-level driver provides additional layer which display controller
+ *                  shows below drawing layers. It is drawn once with \ref gui_lcd_setbackground
+ *                  and widgets are drawn to drawing layers with alpha channel on top of it.
+ *
+ * \note            Drawing layers must use \ref GUI_PIXEL_FORMAT_ARGB8888 pixel format
+ *                  and desktop is cleared to transparent color instead of solid background
+ */
+#ifndef GUI_CFG_LCD_BACKGROUND
+#define GUI_CFG_LCD_BACKGROUND                  0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) splash image shown from initialization until first frame
+ *
+ *                  Image set with \ref gui_lcd_setsplash is drawn to visible layer right after
+ *                  low-level initialization. With more than one layer, widgets are created and
+ *                  first frame is drawn to hidden layer behind it and shown with layer swap.
+ *
+ * \note            Precomposed screenshot of first screen in pixel format of layers
+ *                  is drawn with low-level image function, usually single DMA transfer
+ * \note            Not available with \ref GUI_CFG_LCD_BAND
+ */
+#ifndef GUI_CFG_LCD_SPLASH
+#define GUI_CFG_LCD_SPLASH                      0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) rotation of logical screen with \ref gui_lcd_setrotation
+ *
+ *                  Widgets and drawing functions use rotated coordinates,
+ *                  they are mapped to display memory before low-level driver is called.
+ *                  Fills stay rectangles for low-level driver, images are rotated in strips
+ *                  and glyphs are rotated once when they are put to font cache
+ *
+ * \note            Not available together with \ref GUI_CFG_LCD_BAND,
+ *                  use rotation of display controller there
+ */
+#ifndef GUI_CFG_LCD_ROTATION
+#define GUI_CFG_LCD_ROTATION                    0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) callback with regions of each drawn frame, set with \ref gui_lcd_setframecallback
+ *
+ *                  Callback is called once per frame after all regions are drawn to layer memory
+ *                  and before layer is shown. It receives only regions changed in that frame,
+ *                  so remote view or screen recording can send changes instead of complete screen
+ *
+ * \note            Not available together with \ref GUI_CFG_LCD_BAND, frame is never complete in memory there
+ */
+#ifndef GUI_CFG_LCD_FRAME_CALLBACK
+#define GUI_CFG_LCD_FRAME_CALLBACK              0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) screen capture with \ref gui_lcd_capture
+ *
+ *                  Shown frame is encoded to image file format and passed
+ *                  to user callback in small chunks, no copy of frame is made
+ *
+ * \note            Not available together with \ref GUI_CFG_LCD_BAND, frame is never complete in memory there
+ */
+#ifndef GUI_CFG_LCD_CAPTURE
+#define GUI_CFG_LCD_CAPTURE                     0
+#endif
+
+/**
+ * \brief           Size of buffer for encoded screen capture data in units of bytes
+ *
+ *                  Capture callback is called each time buffer is full
+ *
+ * \note            Used only when \ref GUI_CFG_LCD_CAPTURE is enabled
+ */
+#ifndef GUI_CFG_LCD_CAPTURE_BUFF_SIZE
+#define GUI_CFG_LCD_CAPTURE_BUFF_SIZE           256
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) layers with \ref GUI_PIXEL_FORMAT_L8 indexed pixel format
+ *
+ *                  Each pixel is 8-bit index to display palette, loaded to display controller.
+ *                  Layer memory is half of RGB565 layer, palette is set by low-level driver,
+ *                  with \ref gui_lcd_setpalette or default palette with color cube and gray ramp is used.
+ *
+ *                  Colors are mapped to nearest palette color with table of `4096` bytes,
+ *                  drawing blends in full colors and maps result back to palette.
+ *                  Indexed images with display palette are copied to layer without conversion
+ *
+ * \note            Low-level driver selects format with `1` byte per pixel or \ref GUI_PIXEL_FORMAT_L8 layer format
+ */
+#ifndef GUI_CFG_LCD_CLUT
+#define GUI_CFG_LCD_CLUT                        0
+#endif
+
+/**
+ * \brief           Maximal number of widgets with deferred invalidation between 2 redraw operations
+ *
+ *                  Widget invalidation only marks widget and it is resolved once per frame,
+ *                  no matter how many times widget was invalidated.
+ *                  When list is full, invalidation is resolved immediately
+ */
+#ifndef GUI_CFG_WIDGET_INVALIDATE_QUEUE_SIZE
+#define GUI_CFG_WIDGET_INVALIDATE_QUEUE_SIZE    16
+#endif
+
+/**
+ * \brief           Number of hash buckets used for lookup of widgets by ID
+ *
+ *                  Widgets are added to hash map on creation and removed on delete,
+ *                  so \ref gui_widget_getbyid does not need to search complete widget tree.
+ *                  Set to `0` to disable hash map and search widget tree instead
+ *
+ * \note            Value must be power of 2
+ */
+#ifndef GUI_CFG_WIDGET_ID_HASH_SIZE
+#define GUI_CFG_WIDGET_ID_HASH_SIZE             32
+#endif
+
+/**
+ * \brief           Distance between 2 entries of linked list index in units of list elements
+ *
+ *                  Index keeps pointer to every n-th element of linked list,
+ *                  so element access by index walks at most this number of elements.
+ *                  Used by widgets with long lists, such as listview rows
+ *
+ * \sa              gui_linkedlist_index_get
+ */
+#ifndef GUI_CFG_LINKEDLIST_INDEX_STRIDE
+#define GUI_CFG_LINKEDLIST_INDEX_STRIDE         8
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) compact linked list entries
+ *
+ *                  Previous and next links of widgets, timers, list items and glyph cache entries
+ *                  are stored as 16-bit index of object in GUI memory instead of pointers,
+ *                  which halves memory used for links and keeps more list entries in cache during traversal
+ *
+ * \note            Index is in units of \ref GUI_CFG_MEM_ALIGNMENT bytes from start of first memory region,
+ *                  so all regions assigned with \ref gui_mem_assignmemory must end within
+ *                  `65535 * GUI_CFG_MEM_ALIGNMENT` bytes from start of first region,
+ *                  for example `256 kB` with default alignment of `4` bytes.
+ *                  Larger regions are rejected and \ref gui_init fails
+ */
+#ifndef GUI_CFG_LINKEDLIST_COMPACT
+#define GUI_CFG_LINKEDLIST_COMPACT              0
+#endif
+
+/**
+ * \brief           Maximal number of animations running at the same time
+ *
+ *                  All animations are evaluated by single software timer,
+ *                  started when first animation starts and stopped when last one ends.
+ *                  When no free entry is available, value is set to its final value immediately
+ *
+ * \sa              GUI_CFG_ANIM_PERIOD
+ */
+#ifndef GUI_CFG_ANIM_MAX
+#define GUI_CFG_ANIM_MAX                        8
+#endif
+
+/**
+ * \brief           Period of animation evaluation in units of milliseconds
+ *
+ *                  Animation values are calculated from elapsed time, not from number of
+ *                  evaluations, so late evaluation skips intermediate values instead of slowing down animation
+ */
+#ifndef GUI_CFG_ANIM_PERIOD
+#define GUI_CFG_ANIM_PERIOD                     20
+#endif
+
+/**
+ * \brief           Deceleration of kinetic scroll after touch release in units of pixels per second squared
+ *
+ * \sa              guii_anim_fling
+ */
+#ifndef GUI_CFG_ANIM_FLING_DECELERATION
+#define GUI_CFG_ANIM_FLING_DECELERATION         2000
+#endif
+
+/**
+ * \brief           Minimal touch velocity at release to start kinetic scroll in units of pixels per second
+ *
+ * \sa              guii_anim_fling
+ */
+#ifndef GUI_CFG_ANIM_FLING_MIN_VELOCITY
+#define GUI_CFG_ANIM_FLING_MIN_VELOCITY         150
+#endif
+
+/**
+ * \brief           Maximal number of widget scroll operations between 2 redraw operations
+ *
+ *                  When widget content is scrolled, already drawn pixels are moved
+ *                  with memory copy from previous frame and only newly exposed area is redrawn.
+ *                  When list is full, widget is invalidated completely. Set to `0` to disable feature
+ *
+ * \note            Feature requires at least 2 layers for drawing and \ref gui_ll_t.Copy function
+ */
+#ifndef GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE
+#define GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE        8
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) saving of pixels below popup widgets
+ *
+ *                  When popup part of widget (for example opened dropdown list) is shown,
+ *                  pixels below it are copied to memory and copied back when popup is closed,
+ *                  widgets below popup are not drawn again on open and close
+ *
+ * \note            Feature requires \ref gui_ll_t.Copy function. Not used with \ref GUI_CFG_LCD_BAND,
+ *                  \ref GUI_CFG_LCD_TILE and \ref GUI_CFG_OS_RENDER_THREAD, popup invalidates its parent instead
+ */
+#ifndef GUI_CFG_WIDGET_SAVE_UNDER
+#define GUI_CFG_WIDGET_SAVE_UNDER               1
+#endif
+
+/**
+ * \brief           Number of rendered widget bitmaps shared between instanced widgets
+ *
+ *                  Widget enabled with \ref gui_widget_setinstanced is drawn once to bitmap in RAM.
+ *                  Other instanced widgets of the same type, size, state, colors, text and background
+ *                  are copied from it instead of being drawn. Set to `0` to disable feature
+ *
+ * \note            Feature requires \ref gui_ll_t.Copy function. Not available with \ref GUI_CFG_OS_RENDER_THREAD
+ *                  and with \ref GUI_CFG_LCD_TILE_CORES greater than `1`
+ */
+#ifndef GUI_CFG_WIDGET_INSTANCE_CACHE
+#define GUI_CFG_WIDGET_INSTANCE_CACHE           0
+#endif
+
+/**
+ * \brief           Number of pre-rendered state bitmaps of checkbox, radio and LED widgets
+ *
+ *                  Box or circle of each visual state, such as checked, disabled or on,
+ *                  is drawn once per size and colors and copied from bitmap on next redraws.
+ *                  Bitmaps are shared by all widgets of the same type. Set to `0` to disable feature
+ *
+ * \note            Feature requires \ref gui_ll_t.Copy function. Not available with \ref GUI_CFG_OS_RENDER_THREAD
+ *                  and with \ref GUI_CFG_LCD_TILE_CORES greater than `1`
+ */
+#ifndef GUI_CFG_WIDGET_STATE_CACHE
+#define GUI_CFG_WIDGET_STATE_CACHE              0
+#endif
+
+/**
+ * \brief           Maximal number of sprites drawn over widgets at the same time
+ *
+ *                  Sprite (cursor, drag feedback) is drawn after widgets of each frame.
+ *                  Pixels below it are saved and copied back on next frame,
+ *                  moving sprite does not redraw widgets below it. Set to `0` to disable feature
+ *
+ * \note            Feature requires \ref gui_ll_t.Copy function. Not available with \ref GUI_CFG_LCD_BAND
+ *                  and \ref GUI_CFG_OS_RENDER_THREAD
+ * \sa              gui_sprite_create
+ */
+#ifndef GUI_CFG_SPRITE_COUNT
+#define GUI_CFG_SPRITE_COUNT                    2
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) animated transitions between screens
+ *
+ *                  Old and new screen are kept in two buffers of screen area size.
+ *                  Animation frames copy both buffers to drawing layer at moving offsets,
+ *                  widgets are not drawn again on each frame
+ *
+ * \note            Feature requires \ref gui_ll_t.Copy function. Not available with \ref GUI_CFG_LCD_BAND
+ *                  and \ref GUI_CFG_OS_RENDER_THREAD
+ * \sa              gui_transition_start
+ */
+#ifndef GUI_CFG_USE_TRANSITION
+#define GUI_CFG_USE_TRANSITION                  0
+#endif
+
+/**
+ * \brief           Maximal number of screens on screen stack
+ *
+ *                  Screen hidden by \ref gui_screen_push keeps its pixels in RAM.
+ *                  When it is shown again by \ref gui_screen_pop, pixels are copied to display
+ *                  and only widgets changed while it was hidden are drawn again.
+ *                  Set to `0` to disable feature
+ *
+ * \note            Pixels require \ref gui_ll_t.Copy function, screens are drawn again completely without it.
+ *                  Not supported together with \ref GUI_CFG_LCD_BAND or \ref GUI_CFG_OS_RENDER_THREAD
+ * \sa              GUI_CFG_SCREEN_CACHE_SIZE
+ */
+#ifndef GUI_CFG_SCREEN_STACK
+#define GUI_CFG_SCREEN_STACK                    0
+#endif
+
+/**
+ * \brief           Maximal number of bytes used for pixels of hidden screens
+ *
+ *                  When budget is exceeded, pixels of oldest screens are released first
+ *
+ * \sa              GUI_CFG_SCREEN_STACK
+ */
+#ifndef GUI_CFG_SCREEN_CACHE_SIZE
+#define GUI_CFG_SCREEN_CACHE_SIZE               (1024UL * 1024UL)
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) static elements of widgets with children
+ *
+ *                  Labels, icons and rectangles without own widget handle are described
+ *                  in constant array and drawn by their parent widget
+ *
+ * \sa              gui_widget_setstatics
+ */
+#ifndef GUI_CFG_WIDGET_STATICS
+#define GUI_CFG_WIDGET_STATICS                  1
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) creation of widgets from constant tree description
+ *
+ *                  Handles of all widgets in tree are allocated with single memory allocation
+ *
+ * \sa              gui_widget_createtree
+ */
+#ifndef GUI_CFG_WIDGET_TREE
+#define GUI_CFG_WIDGET_TREE                     1
+#endif
+
+/**
+ * \brief           Size of memory arena for widgets of each window in units of bytes
+ *
+ *                  When first widget is created inside window placed on desktop, arena of this size is allocated
+ *                  and handles of all widgets inside window are placed one after another in order of creation,
+ *                  so drawing and touch processing of window walks through contiguous memory.
+ *                  Memory of removed widgets is used again for widgets of the same size.
+ *                  When arena is full, handles are allocated as usual.
+ *
+ *                  Set to `0` to disable arenas
+ *
+ * \note            Requires \ref GUI_CFG_WIDGET_TREE enabled
+ */
+#ifndef GUI_CFG_WIDGET_ARENA_SIZE
+#define GUI_CFG_WIDGET_ARENA_SIZE               0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) lock-free read-only widget getters
+ *
+ *                  Each widget keeps version of its state, increased before and after every change.
+ *                  Getters like \ref gui_widget_getwidth or \ref gui_slider_getvalue then read state
+ *                  without GUI protection and repeat reading when version changed meanwhile,
+ *                  so other threads are not blocked by long redraw of GUI thread.
+ *                  Values which must be computed first are still read with GUI protection
+ *
+ * \note            Useful only when \ref GUI_CFG_OS is enabled
+ */
+#ifndef GUI_CFG_WIDGET_LOCKFREE_GET
+#define GUI_CFG_WIDGET_LOCKFREE_GET             0
+#endif
+
+/**
+ * \brief           Maximal nesting level of widgets processed by redraw and touch
+ *
+ *                  Widget tree is walked without recursion, redraw and touch keep
+ *                  state of each nesting level in local array of this size,
+ *                  so GUI thread stack usage does not depend on widget tree.
+ *                  Top level widgets, such as desktop window, are on first level.
+ *
+ *                  Children of widgets on last level are not drawn and do not receive touch
+ */
+#ifndef GUI_CFG_WIDGET_TREE_DEPTH
+#define GUI_CFG_WIDGET_TREE_DEPTH               16
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) shared widget styles
+ *
+ *                  Widgets point to reference counted style with colors, font, padding and border radius,
+ *                  instead of allocating private copy of colors each
+ *
+ * \sa              gui_style_create, gui_widget_setstyle
+ */
+#ifndef GUI_CFG_WIDGET_STYLE
+#define GUI_CFG_WIDGET_STYLE                    1
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) row, column and grid layout of children widgets
+ *
+ *                  Container widget places its visible children one after another,
+ *                  ignoring their own position. Sizes of all children are resolved together
+ *                  in single pass per frame and remain cached until any geometry changes
+ *
+ * \sa              gui_widget_setlayout, gui_widget_setflexgrow
+ */
+#ifndef GUI_CFG_WIDGET_LAYOUT
+#define GUI_CFG_WIDGET_LAYOUT                   0
+#endif
+
+/**
+ * \brief           Default size of circular text buffer in units of bytes for debugbox widget
+ *
+ *                  Lines are copied to preallocated buffer and oldest lines are overwritten
+ *                  when there is no more space. Maximal value is `65535` bytes.
+ *
+ * \sa              gui_debugbox_setbuffersize
+ */
+#ifndef GUI_CFG_WIDGET_DEBUGBOX_BUFFER_SIZE
+#define GUI_CFG_WIDGET_DEBUGBOX_BUFFER_SIZE     1024
+#endif
+
+/**
+ * \brief           Maximal number of dialogs waiting for dismiss at the same time
+ *
+ *                  Dismiss status of each dialog is kept in statically allocated entry.
+ *                  With \ref GUI_CFG_OS, blocking dialogs reuse semaphore of their entry,
+ *                  it is created on first use and never deleted
+ *
+ * \sa              gui_dialog_createasync, gui_dialog_createblocking
+ */
+#ifndef GUI_CFG_WIDGET_DIALOG_POOL_SIZE
+#define GUI_CFG_WIDGET_DIALOG_POOL_SIZE         4
+#endif
+
+/**
+ * \brief           Maximal number of bytes used for font characters prepared in RAM for fast drawing
+ *
+ *                  When limit is reached, least recently used characters are removed from memory.
+ *                  Set to 0 to disable limit
+ */
+#ifndef GUI_CFG_FONT_CACHE_SIZE
+#define GUI_CFG_FONT_CACHE_SIZE                 32768
+#endif
+
+/**
+ * \brief           Number of hash buckets used for lookup of font characters prepared in RAM
+ * \note            Value must be power of 2
+ */
+#ifndef GUI_CFG_FONT_CACHE_HASH_SIZE
+#define GUI_CFG_FONT_CACHE_HASH_SIZE            64
+#endif
+
+/**
+ * \brief           Number of string tables waiting to have their characters prepared in RAM
+ *
+ *                  Tables are added with \ref gui_draw_font_prewarm and processed
+ *                  when \ref gui_process has nothing to redraw. Set to 0 to disable feature
+ *
+ * \note            Requires \ref GUI_CFG_USE_IDLE_TASKS
+ * \note            Not available with \ref GUI_CFG_OS_RENDER_THREAD
+ */
+#ifndef GUI_CFG_FONT_PREWARM_QUEUE
+#define GUI_CFG_FONT_PREWARM_QUEUE              4
+#endif
+
+/**
+ * \brief           Maximal time of characters preparation in single idle call of \ref gui_process, in units of microseconds
+ *
+ *                  Preparation runs as idle task, see \ref GUI_CFG_USE_IDLE_TASKS
+ */
+#ifndef GUI_CFG_FONT_PREWARM_BUDGET
+#define GUI_CFG_FONT_PREWARM_BUDGET             2000
+#endif
+
+/**
+ * \brief           Number of entries for memorized character lookups resolved in fallback fonts
+ * \note            Value must be power of 2. Set to 0 to resolve fallback fonts on every lookup
+ */
+#ifndef GUI_CFG_FONT_FALLBACK_CACHE_SIZE
+#define GUI_CFG_FONT_FALLBACK_CACHE_SIZE        16
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) composing of visible text line to alpha strip
+ *
+ *                  Characters of line are composed with CPU to single strip in low-level alpha format,
+ *                  which is then blended with one low-level `CopyChar` call per text color,
+ *                  instead of one call per character. Strip is allocated on first use
+ *                  and grows to the largest line drawn.
+ *
+ * \note            Used only when screen is not rotated
+ */
+#ifndef GUI_CFG_FONT_LINE_COMPOSE
+#define GUI_CFG_FONT_LINE_COMPOSE               0
+#endif
+
+/**
+ * \brief           Number of bytes of buffer for lines of compressed images decoded before drawing
+ * \note            Buffer is allocated on first use and grows when single visible line of image does not fit
+ */
+#ifndef GUI_CFG_IMAGE_DECODE_BUFFER_SIZE
+#define GUI_CFG_IMAGE_DECODE_BUFFER_SIZE        4096
+#endif
+
+/**
+ * \brief           Number of scaled image copies kept in memory for next draws at the same size
+ * \note            Scaled pixels are allocated from big memory region. Set to 0 to scale
+ *                  visible lines on every draw through image decode buffer
+ */
+#ifndef GUI_CFG_IMAGE_SCALE_CACHE
+#define GUI_CFG_IMAGE_SCALE_CACHE               4
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) animated images with delta frames in image widget
+ *
+ *                  Widget keeps current frame in RAM and applies only changed area of next frame,
+ *                  see \ref gui_image_setanimation
+ */
+#ifndef GUI_CFG_IMAGE_ANIM
+#define GUI_CFG_IMAGE_ANIM                      1
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) collecting of processing statistics
+ *
+ *                  When enabled, time spent in processing timers, inputs and redraw is measured
+ *                  and can be read with \ref gui_getstats function
+ */
+#ifndef GUI_CFG_USE_STATS
+#define GUI_CFG_USE_STATS                       0
+#endif
+
+/**
+ * \brief           Get current time for statistics measurement
+ *
+ *                  By default system time in units of milliseconds is used.
+ *                  For better resolution it can be set to cycle counter, for example `DWT->CYCCNT`
+ */
+#ifndef GUI_CFG_STATS_TIME
+#define GUI_CFG_STATS_TIME()                    gui_sys_now()
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) measurement of input-to-display latency
+ *
+ *                  Time of touch sample which invalidated widgets is kept until frame with its result is drawn
+ *                  and display driver confirms the layer is shown with \ref gui_lcd_confirmactivelayer.
+ *                  Latency percentiles of last \ref GUI_CFG_STATS_LATENCY_SAMPLES measured inputs
+ *                  are read with \ref gui_getstats in units of milliseconds
+ *
+ * \note            Requires \ref GUI_CFG_USE_STATS and \ref GUI_CFG_USE_TOUCH,
+ *                  not available with \ref GUI_CFG_LCD_BAND or \ref GUI_CFG_OS_RENDER_THREAD.
+ *                  When driver confirms layer from interrupt, \ref gui_sys_now must be callable from interrupt
+ */
+#ifndef GUI_CFG_STATS_LATENCY
+#define GUI_CFG_STATS_LATENCY                   0
+#endif
+
+/**
+ * \brief           Number of last measured inputs used for latency percentiles
+ * \note            Used only when \ref GUI_CFG_STATS_LATENCY is enabled
+ */
+#ifndef GUI_CFG_STATS_LATENCY_SAMPLES
+#define GUI_CFG_STATS_LATENCY_SAMPLES           32
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) metrics snapshot for remote monitoring
+ *
+ *                  GUI thread periodically publishes counters of redrawn frames, frame time histogram,
+ *                  glyph cache, memory, accelerator load and input overflows.
+ *                  Other threads read them with \ref gui_metrics_get or \ref gui_metrics_report
+ *                  without waiting for GUI thread, for example to answer network requests
+ *
+ * \note            Requires \ref GUI_CFG_USE_STATS enabled
+ */
+#ifndef GUI_CFG_USE_METRICS
+#define GUI_CFG_USE_METRICS                     0
+#endif
+
+/**
+ * \brief           Time between 2 published metrics snapshots in units of milliseconds
+ * \note            Used only when \ref GUI_CFG_USE_METRICS is enabled
+ */
+#ifndef GUI_CFG_METRICS_PERIOD
+#define GUI_CFG_METRICS_PERIOD                  1000
+#endif
+
+/**
+ * \brief           Number of entries in frame time histogram
+ *
+ *                  Entry `i` counts frames redrawn in less than `GUI_CFG_METRICS_HIST_BASE << i` time,
+ *                  last entry counts all longer frames
+ *
+ * \note            Used only when \ref GUI_CFG_USE_METRICS is enabled
+ */
+#ifndef GUI_CFG_METRICS_HIST_SIZE
+#define GUI_CFG_METRICS_HIST_SIZE               8
+#endif
+
+/**
+ * \brief           Frame time limit of first histogram entry in units of \ref GUI_CFG_STATS_TIME
+ * \note            Used only when \ref GUI_CFG_USE_METRICS is enabled
+ */
+#ifndef GUI_CFG_METRICS_HIST_BASE
+#define GUI_CFG_METRICS_HIST_BASE               2
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) recording and replay of input events
+ *
+ *                  Touch and keyboard entries added with \ref gui_input_touchadd and \ref gui_input_keyadd
+ *                  are recorded with timestamps to user buffer with \ref gui_input_recordstart
+ *                  and can be fed back at original timing with \ref gui_input_replaystart,
+ *                  for example to benchmark different firmware builds on the same interaction
+ */
+#ifndef GUI_CFG_INPUT_RECORD
+#define GUI_CFG_INPUT_RECORD                    0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) trace events around widget callbacks,
+ *                  redraw, touch processing and low-level drawing operations
+ *
+ *                  Events are stored to RAM ring buffer and can be exported as Chrome trace
+ *                  with \ref gui_trace_export function or routed to external tool with \ref GUI_CFG_TRACE_HOOK
+ */
+#ifndef GUI_CFG_USE_TRACE
+#define GUI_CFG_USE_TRACE                       0
+#endif
+
+/**
+ * \brief           Get current time for trace events in units of microseconds
+ *
+ *                  For better resolution it can be set to cycle counter, for example `(DWT->CYCCNT / 216)`
+ *
+ * \note            Used only when \ref GUI_CFG_USE_TRACE is enabled
+ */
+#ifndef GUI_CFG_TRACE_TIME
+#define GUI_CFG_TRACE_TIME()                    (gui_sys_now() * 1000UL)
+#endif
+
+/**
+ * \brief           Number of events in trace ring buffer
+ *
+ *                  When buffer is full, oldest events are overwritten.
+ *                  Set to `0` when events are only passed to \ref GUI_CFG_TRACE_HOOK
+ *
+ * \note            Used only when \ref GUI_CFG_USE_TRACE is enabled
+ */
+#ifndef GUI_CFG_TRACE_BUFFER_SIZE
+#define GUI_CFG_TRACE_BUFFER_SIZE               256
+#endif
+
+/**
+ * \brief           Optional hook called with pointer to every \ref gui_trace_event_t
+ *
+ *                  Use it to route events to SEGGER SystemView, ITM or other tool, for example
+ *                  `#define GUI_CFG_TRACE_HOOK(evt)    my_trace_send(evt)`
+ *
+ * \note            Used only when \ref GUI_CFG_USE_TRACE is enabled
+ */
+#if defined(__DOXYGEN__)
+#define GUI_CFG_TRACE_HOOK(evt)
+#endif
+
+/**
+ * \brief           Minimal time between 2 redraw operations in units of milliseconds
+ *
+ *                  Invalidations made before period expires are collected and drawn
+ *                  together with next frame, so frequent changes cannot redraw at full display rate.
+ *                  Period can be changed with \ref gui_setframeperiod, for example on battery power.
+ *                  Set to `0` to redraw as soon as anything is invalidated
+ */
+#ifndef GUI_CFG_FRAME_PERIOD
+#define GUI_CFG_FRAME_PERIOD                    0
+#endif
+
+/**
+ * \brief           Maximal frame period in units of milliseconds when redraw is slow
+ *
+ *                  When redraw takes more than half of frame period, period is increased up to this value
+ *                  to leave processing time to other threads. It is decreased back to \ref GUI_CFG_FRAME_PERIOD
+ *                  when redraw is fast again. Set to same value as \ref GUI_CFG_FRAME_PERIOD to keep period fixed
+ *
+ * \note            Used only when \ref GUI_CFG_FRAME_PERIOD is not `0`
+ */
+#ifndef GUI_CFG_FRAME_PERIOD_MAX
+#define GUI_CFG_FRAME_PERIOD_MAX                GUI_CFG_FRAME_PERIOD
+#endif
+
+/**
+ * \brief           Maximal time spent in drawing widgets of single frame in units of milliseconds
+ *
+ *                  Dirty regions are drawn in strips of \ref GUI_CFG_REDRAW_BUDGET_LINES lines,
+ *                  regions with focused or touched widget first and then smaller regions before bigger ones.
+ *                  When time is spent, frame is shown with rest of regions from previous frame
+ *                  and drawing continues in next frame, after inputs are processed.
+ *                  Dirty regions are copied from shown layer before drawing, so frame never shows old content of drawing layer.
+ *                  Set to `0` to draw all dirty regions in every frame
+ *
+ * \note            Not available with \ref GUI_CFG_LCD_BAND, \ref GUI_CFG_LCD_TILE or \ref GUI_CFG_OS_RENDER_THREAD
+ */
+#ifndef GUI_CFG_REDRAW_BUDGET
+#define GUI_CFG_REDRAW_BUDGET                   0
+#endif
+
+/**
+ * \brief           Maximal height of strip of dirty region drawn at a time in units of pixels
+ *
+ *                  Time budget is checked after every strip
+ *
+ * \note            Used only when \ref GUI_CFG_REDRAW_BUDGET is not `0`
+ */
+#ifndef GUI_CFG_REDRAW_BUDGET_LINES
+#define GUI_CFG_REDRAW_BUDGET_LINES             32
+#endif
+
+/**
+ * \brief           Time without invalidation and input before display is powered down, in units of milliseconds
+ *
+ *                  Low-level driver receives \ref GUI_LL_Command_PowerDown command and may stop display refresh,
+ *                  put panel to sleep and stop drawing accelerator clocks. Timers are not processed
+ *                  and GUI thread sleeps until new input or invalidation wakes it up with \ref GUI_LL_Command_PowerUp command.
+ *                  Touch which wakes display up is not passed to widgets.
+ *                  Set to `0` to keep display always on
+ */
+#ifndef GUI_CFG_IDLE_TIMEOUT
+#define GUI_CFG_IDLE_TIMEOUT                    0
+#endif
+
+/**
+ * \brief           Maximal number of widgets bound to value slots at the same time
+ *
+ *                  Producer threads write value slots without GUI lock. GUI thread formats
+ *                  changed values once per frame and redraws only widgets with changed text.
+ *                  Set to `0` to disable feature
+ *
+ * \sa              gui_bind_widget
+ */
+#ifndef GUI_CFG_BIND_COUNT
+#define GUI_CFG_BIND_COUNT                      0
+#endif
+
+/**
+ * \brief           Size of string value slot and formatted text of bound widget in units of bytes,
+ *                  including trailing zero
+ *
+ * \note            Used only when \ref GUI_CFG_BIND_COUNT is not `0`
+ */
+#ifndef GUI_CFG_BIND_TEXT_SIZE
+#define GUI_CFG_BIND_TEXT_SIZE                  24
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) queue of background tasks run by GUI thread in idle time
+ *
+ *                  Tasks added with \ref gui_idle_add run when \ref gui_process has nothing to redraw
+ *                  and stop as soon as input, timer or invalidation is waiting
+ *
+ * \note            Required by \ref GUI_CFG_FONT_PREWARM_QUEUE
+ */
+#ifndef GUI_CFG_USE_IDLE_TASKS
+#define GUI_CFG_USE_IDLE_TASKS                  1
+#endif
+
+/**
+ * \brief           Maximal time of all idle tasks in single \ref gui_process call, in units of microseconds
+ *
+ * \note            Used only when \ref GUI_CFG_USE_IDLE_TASKS is enabled
+ */
+#ifndef GUI_CFG_IDLE_SLICE
+#define GUI_CFG_IDLE_SLICE                      4000
+#endif
+
+/**
+ * \brief           Get current time for idle tasks budget, in units of microseconds
+ *
+ *                  By default system time in units of milliseconds is converted.
+ *                  For better resolution it can be set to microsecond timer
+ */
+#ifndef GUI_CFG_IDLE_TIME
+#define GUI_CFG_IDLE_TIME()                     ((uint32_t)gui_sys_now() * 1000UL)
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) support for dirty region debug overlay
+ *
+ *                  When overlay is turned on with \ref gui_setdebugoverlay, redrawn regions of last frames
+ *                  are outlined on screen with color fading with frame age.
+ *                  Every redrawn widget shows number of its redraws in top left corner
+ */
+#ifndef GUI_CFG_USE_DEBUG_OVERLAY
+#define GUI_CFG_USE_DEBUG_OVERLAY               0
+#endif
+
+/**
+ * \brief           Number of frames redrawn regions stay outlined on screen by debug overlay
+ *
+ * \note            Used only when \ref GUI_CFG_USE_DEBUG_OVERLAY is enabled
+ */
+#ifndef GUI_CFG_DEBUG_OVERLAY_FRAMES
+#define GUI_CFG_DEBUG_OVERLAY_FRAMES            4
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) support for widget display lists
+ *
+ *                  Widget with display list enabled records its drawing commands once
+ *                  and replays them later without calling its draw callback, until widget is invalidated.
+ *                  Enable it per widget with \ref gui_widget_setdisplaylist
+ */
+#ifndef GUI_CFG_USE_DISPLAY_LIST
+#define GUI_CFG_USE_DISPLAY_LIST                0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) transparency option for widgets
+ *
+ *                  When enabled, widgets can overlay each other and bottom widget can be visible below top one
+ */
+#ifndef GUI_CFG_USE_TRANSPARENCY
+#define GUI_CFG_USE_TRANSPARENCY                0
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) 8-bit alpha masks on widgets
+ *
+ *                  Widget with mask set by \ref gui_widget_setmask is drawn with its children
+ *                  to temporary layer and blended to screen with mask as alpha of each pixel,
+ *                  children of rounded or other non-rectangular containers are clipped by single blend
+ *
+ * \note            Requires \ref GUI_CFG_USE_TRANSPARENCY. Mask is not applied on rotated screen
+ */
+#ifndef GUI_CFG_WIDGET_MASK
+#define GUI_CFG_WIDGET_MASK                     0
+#endif
+
+/**
+ * \brief           Initial size of scratch memory for temporary transparency layers in units of bytes
+ *
+ *                  Transparent widgets are drawn to temporary layers taken from scratch memory.
+ *                  Scratch memory is kept between frames and grows when redraw needs more memory.
+ *                  Set to expected maximal size to avoid growing later, or to `0` to allocate it on first use
+ *
+ * \note            Used only when \ref GUI_CFG_USE_TRANSPARENCY is enabled
+ */
+#ifndef GUI_CFG_TRANSPARENCY_SCRATCH_SIZE
+#define GUI_CFG_TRANSPARENCY_SCRATCH_SIZE       0
+#endif
+
+/**
+ * \brief           Maximal number of nested transparent widgets drawn to own temporary layers
+ *
+ *                  Transparent widgets nested deeper are drawn without transparency
+ *
+ * \note            Used only when \ref GUI_CFG_USE_TRANSPARENCY is enabled
+ */
+#ifndef GUI_CFG_TRANSPARENCY_LAYERS
+#define GUI_CFG_TRANSPARENCY_LAYERS             4
 #endif
 
 /**
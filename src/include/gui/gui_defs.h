@@ -74,6 +74,16 @@ extern "C" {
 #define GUI_FLAG_TOUCH_MOVE                 ((uint32_t)0x00008000)  /*!< Indicates widget callback has processed touch move event. This parameter works in conjunction with \ref GUI_FLAG_ACTIVE flag */
 #define GUI_FLAG_XPOS_PERCENT               ((uint32_t)0x00010000)  /*!< Indicates widget X position is in percent relative to parent width */
 #define GUI_FLAG_YPOS_PERCENT               ((uint32_t)0x00020000)  /*!< Indicates widget Y position is in percent relative to parent height */
+#define GUI_FLAG_INVALIDATE_PENDING         ((uint32_t)0x00400000)  /*!< Indicates widget invalidation was requested and waits to be resolved in current frame */
+#define GUI_FLAG_RETAINED                   ((uint32_t)0x00800000)  /*!< Indicates widget with children is drawn once to retained bitmap and copied from it later */
+#define GUI_FLAG_RETAINED_VALID             ((uint32_t)0x01000000)  /*!< Indicates retained bitmap of widget matches current content */
+#define GUI_FLAG_DISPLAY_LIST               ((uint32_t)0x02000000)  /*!< Indicates widget drawing commands are recorded and replayed later */
+#define GUI_FLAG_DISPLAY_LIST_VALID         ((uint32_t)0x04000000)  /*!< Indicates display list of widget matches current content */
+#define GUI_FLAG_SAVE_UNDER                 ((uint32_t)0x08000000)  /*!< Indicates pixels below widget are saved before its next drawing */
+#define GUI_FLAG_REDRAW_CHILDREN            ((uint32_t)0x10000000)  /*!< Indicates any widget inside widget has redraw flag set */
+#define GUI_FLAG_PARENT_HIDDEN              ((uint32_t)0x20000000)  /*!< Indicates any parent of widget is hidden, widget is not visible on screen */
+#define GUI_FLAG_INSTANCED                  ((uint32_t)0x40000000)  /*!< Indicates widget is copied from bitmap of identical widget drawn before */
+#define GUI_FLAG_RETAINED_BLEND             ((uint32_t)0x80000000)  /*!< Indicates pending invalidation only changes transparency of widget drawn from retained bitmap */
 
 /**
  * \defgroup        GUI_WIDGETS_CORE_FLAGS Widget type flags
@@ -84,12 +94,14 @@ extern "C" {
 #define GUI_FLAG_WIDGET_ALLOW_CHILDREN      ((uint32_t)0x00040000)  /*!< Widget allows children widgets */
 #define GUI_FLAG_WIDGET_DIALOG_BASE         ((uint32_t)0x00080000)  /*!< Widget is dialog base. When it is active, no other widget around dialog can be pressed */
 #define GUI_FLAG_WIDGET_INVALIDATE_PARENT   ((uint32_t)0x00100000)  /*!< Anytime widget is invalidated, parent should be invalidated too */
+#define GUI_FLAG_WIDGET_OPAQUE              ((uint32_t)0x00200000)  /*!< Widget fully covers its area with background when drawn */
 
 /**
  * \}
  */
 
 #define GUI_FLAG_LCD_WAIT_LAYER_CONFIRM     ((uint32_t)0x00000001)  /*!< Indicates waiting for layer change confirmation */
+#define GUI_FLAG_LCD_CHAR_A4                ((uint32_t)0x00000002)  /*!< Low-level CopyChar function accepts packed 4-bit alpha (A4) characters instead of A8 */
 
 /**
  * \}
@@ -135,14 +147,24 @@ typedef enum guir_t {
     guiERROR = 0x01                         /*!< There was an error in processing */
 } guir_t;
 
+/**
+ * \brief           Link to other object in linked list
+ * \note            Links are converted to pointers with \ref GUI_LINKEDLIST_PTR and from pointers with \ref GUI_LINKEDLIST_LINK
+ */
+#if GUI_CFG_LINKEDLIST_COMPACT || __DOXYGEN__
+typedef uint16_t gui_linkedlist_link_t;
+#else /* GUI_CFG_LINKEDLIST_COMPACT || __DOXYGEN__ */
+typedef void* gui_linkedlist_link_t;
+#endif /* !(GUI_CFG_LINKEDLIST_COMPACT || __DOXYGEN__) */
+
 /**
  * \brief           Linked list structure
  * \note            This structure must be first element in \ref gui_handle_p structure
  * \sa              gui_linkedlistroot_t
  */
 typedef struct gui_linkedlist_t {
-    void* prev;                             /*!< Previous object in linked list */
-    void* next;                             /*!< Next object in linked list */
+    gui_linkedlist_link_t prev;             /*!< Previous object in linked list */
+    gui_linkedlist_link_t next;             /*!< Next object in linked list */
 } gui_linkedlist_t;
 
 /**
@@ -163,18 +185,42 @@ typedef struct gui_linkedlistroot_t {
     void* first;                            /*!< First element in linked list */
     void* last;                             /*!< Last element in linked list */
 } gui_linkedlistroot_t;
+
+/**
+ * \brief           Index of linked list for fast access to elements by index
+ * \note            Index is built on first use and must be invalidated when list changes
+ * \sa              gui_linkedlist_index_get
+ */
+typedef struct gui_linkedlist_index_t {
+    gui_linkedlist_t** marks;               /*!< Pointers to every \ref GUI_CFG_LINKEDLIST_INDEX_STRIDE-th element of list */
+    size_t marks_size;                      /*!< Number of allocated entries in \ref marks array */
+    size_t count;                           /*!< Number of elements in list */
+    uint8_t valid;                          /*!< Set to `1` when index matches list */
+} gui_linkedlist_index_t;
  
 /**
  * \brief           Core timer structure for GUI timers
  */
 typedef struct gui_timer_core_t {
-    uint32_t Time;                          /*!< Last processed time */
-    gui_linkedlistroot_t list;              /*!< Root linked list object */
+    gui_linkedlistroot_t list;              /*!< Active timers, sorted by expiry time */
 } gui_timer_core_t;
 
 typedef uint32_t    gui_id_t;               /*!< GUI object ID */
 typedef uint32_t    gui_color_t;            /*!< Color definition */
 typedef int16_t     gui_dim_t;              /*!< GUI dimensions in units of pixels */
+#if GUI_CFG_WIDGET_FIXED_POINT || __DOXYGEN__
+typedef int32_t     gui_geom_t;             /*!< Widget position or size in units of pixels or percents, 16.16 fixed-point format */
+#define GUI_GEOM_FROM_DIM(x)        ((gui_geom_t)(x) * 0x10000L)    /*!< Convert pixels to geometry value */
+#define GUI_GEOM_FROM_FLOAT(x)      ((gui_geom_t)((x) * 65536.0f))  /*!< Convert float to geometry value */
+#define GUI_GEOM_TO_DIM(x)          ((gui_dim_t)((x) / 0x10000L))   /*!< Convert geometry value to pixels */
+#define GUI_GEOM_PERCENT(x, total)  ((gui_dim_t)((((x) >> 8) * (int32_t)(total) + (50L << 8)) / (100L << 8)))  /*!< Get percent of total pixels */
+#else
+typedef float       gui_geom_t;             /*!< Widget position or size in units of pixels or percents */
+#define GUI_GEOM_FROM_DIM(x)        ((gui_geom_t)(x))
+#define GUI_GEOM_FROM_FLOAT(x)      ((gui_geom_t)(x))
+#define GUI_GEOM_TO_DIM(x)          ((gui_dim_t)(x))
+#define GUI_GEOM_PERCENT(x, total)  ((gui_dim_t)GUI_ROUND((x) * (float)(total) / 100.0f))
+#endif /* GUI_CFG_WIDGET_FIXED_POINT || __DOXYGEN__ */
 typedef uint8_t     gui_char;               /*!< GUI char data type for all string operations */
 #define _GT(x)      (gui_char *)(x)         /*!< Macro to force strings to right format for processing */
 #define gui_const   const                   /*!< Macro for constant keyword */
@@ -234,6 +280,70 @@ typedef struct gui_touch_data_t {
     uint32_t time;                          /*!< Time when touch was recorded */
 } gui_touch_data_t;
 
+/**
+ * \brief           Affine touch calibration in Q16 fixed-point format
+ *
+ *                  Screen coordinates are calculated from raw controller coordinates as
+ *                  `x = (xa * raw_x + xb * raw_y + xc) / 65536` and `y = (ya * raw_x + yb * raw_y + yc) / 65536`
+ */
+typedef struct gui_touch_calibration_t {
+    int32_t xa, xb, xc;                     /*!< Coefficients for X coordinate */
+    int32_t ya, yb, yc;                     /*!< Coefficients for Y coordinate */
+} gui_touch_calibration_t;
+
+/**
+ * \brief           State of click and double click detection for touch events
+ */
+typedef struct {
+    uint32_t time;                          /*!< Time of last touch event used for timeout */
+    uint8_t index;                          /*!< Index of current click, `0` for first and `1` for second click */
+    gui_dim_t x[2];                         /*!< Relative X positions of both clicks */
+    gui_dim_t y[2];                         /*!< Relative Y positions of both clicks */
+} guii_touch_click_t;
+
+#if GUI_CFG_TOUCH_HISTORY_SIZE || __DOXYGEN__
+/**
+ * \brief           Single position in touch history
+ */
+typedef struct {
+    gui_dim_t x;                            /*!< Absolute X position of first touch */
+    gui_dim_t y;                            /*!< Absolute Y position of first touch */
+    uint32_t time;                          /*!< Time when position was recorded */
+} guii_touch_sample_t;
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE || __DOXYGEN__ */
+
+#if GUI_CFG_USE_TOUCH_GESTURES || __DOXYGEN__
+/**
+ * \brief           List of swipe directions
+ */
+typedef enum {
+    GUI_TOUCH_SWIPE_LEFT = 0x00,            /*!< Finger moved to the left */
+    GUI_TOUCH_SWIPE_RIGHT,                  /*!< Finger moved to the right */
+    GUI_TOUCH_SWIPE_UP,                     /*!< Finger moved up */
+    GUI_TOUCH_SWIPE_DOWN,                   /*!< Finger moved down */
+} gui_touch_swipe_dir_t;
+
+/**
+ * \brief           Gesture recognition state and result of last recognized gesture
+ */
+typedef struct {
+    gui_dim_t start_x;                      /*!< Absolute X position of first touch at press */
+    gui_dim_t start_y;                      /*!< Absolute Y position of first touch at press */
+    uint32_t start_time;                    /*!< Time of touch press */
+    uint8_t multi;                          /*!< Set to `1` when more than 1 touch was detected since press */
+    uint8_t pinching;                       /*!< Set to `1` when pinch is in progress */
+    float distance;                         /*!< Distance between 2 touches at last pinch event */
+    
+    gui_touch_swipe_dir_t dir;              /*!< Swipe direction */
+    gui_dim_t dx;                           /*!< Swipe distance on X axis in units of pixels */
+    gui_dim_t dy;                           /*!< Swipe distance on Y axis in units of pixels */
+    float velocity;                         /*!< Swipe velocity in swipe direction in units of pixels per second */
+    float scale;                            /*!< Pinch scale since previous pinch event, greater than `1` when touches move apart */
+    gui_dim_t x;                            /*!< Absolute X position of swipe start or pinch center */
+    gui_dim_t y;                            /*!< Absolute Y position of swipe start or pinch center */
+} guii_touch_gesture_t;
+#endif /* GUI_CFG_USE_TOUCH_GESTURES || __DOXYGEN__ */
+
 /**
  * \brief           Internal touch structure used for widget callbacks
  */
@@ -250,8 +360,32 @@ typedef struct {
     float distance_old;                     /*!< Old distance between 2 points */
 #endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 || __DOXYGEN__ */
     struct pt pt;                           /*!< Protothread structure */
+    guii_touch_click_t click;               /*!< Click detection state used by protothread */
+#if GUI_CFG_USE_TOUCH_GESTURES || __DOXYGEN__
+    guii_touch_gesture_t gesture;           /*!< Gesture recognition state, valid on \ref GUI_WC_Swipe and \ref GUI_WC_Pinch events */
+#endif /* GUI_CFG_USE_TOUCH_GESTURES || __DOXYGEN__ */
+#if GUI_CFG_TOUCH_MOVE_COALESCE || __DOXYGEN__
+    uint8_t coalesced;                      /*!< Number of move samples merged into current one */
+#endif /* GUI_CFG_TOUCH_MOVE_COALESCE || __DOXYGEN__ */
+#if GUI_CFG_TOUCH_HISTORY_SIZE || __DOXYGEN__
+    guii_touch_sample_t history[GUI_CFG_TOUCH_HISTORY_SIZE];   /*!< Latest positions since touch has been pressed */
+    uint8_t history_count;                  /*!< Number of valid entries in \ref history */
+    uint8_t history_index;                  /*!< Index in \ref history for next position */
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE || __DOXYGEN__ */
 } guii_touch_data_t;
 
+#if GUI_CFG_TOUCH_POINTERS || __DOXYGEN__
+/**
+ * \brief           Independent touch pointer with single touch point and its own active widget
+ */
+typedef struct {
+    guii_touch_data_t touch;                /*!< Current touch data of pointer */
+    guii_touch_data_t old;                  /*!< Touch data of previous sample */
+    struct gui_handle* h;                   /*!< Widget receiving events of pointer or `NULL` */
+    struct gui_handle* prev;                /*!< Widget of previous press, used for double click detection */
+} guii_touch_pointer_t;
+#endif /* GUI_CFG_TOUCH_POINTERS || __DOXYGEN__ */
+
 /**
  * \brief           Single key data structure
  */
@@ -291,14 +425,52 @@ typedef struct {
     gui_dim_t y2;                           /*!< Clipping area end Y */
 } gui_display_t;
 
+/**
+ * \brief           Pixel format of layer memory
+ */
+typedef enum {
+    GUI_PIXEL_FORMAT_DEFAULT = 0x00,        /*!< Format is selected by \ref gui_lcd_t.pixel_size */
+    GUI_PIXEL_FORMAT_ARGB8888,              /*!< 32-bit color with alpha channel */
+    GUI_PIXEL_FORMAT_RGB888,                /*!< 24-bit color without alpha channel */
+    GUI_PIXEL_FORMAT_RGB565,                /*!< 16-bit color without alpha channel */
+    GUI_PIXEL_FORMAT_L8,                    /*!< 8-bit index to display palette \ref gui_lcd_t.palette, requires \ref GUI_CFG_LCD_CLUT */
+} gui_pixel_format_t;
+
+/**
+ * \brief           Rotation of logical screen on physical display, clockwise
+ */
+typedef enum {
+    GUI_LCD_ROTATION_0 = 0x00,              /*!< Logical screen matches display memory */
+    GUI_LCD_ROTATION_90,                    /*!< Logical screen is rotated by 90 degrees, width and height are swapped */
+    GUI_LCD_ROTATION_180,                   /*!< Logical screen is rotated by 180 degrees */
+    GUI_LCD_ROTATION_270,                   /*!< Logical screen is rotated by 270 degrees, width and height are swapped */
+} gui_lcd_rotation_t;
+
+/**
+ * \brief           Get number of bytes per pixel of pixel format
+ * \param[in]       fmt: Member of \ref gui_pixel_format_t enumeration
+ * \hideinitializer
+ */
+#define GUI_PIXEL_FORMAT_SIZE(fmt)          ((fmt) == GUI_PIXEL_FORMAT_L8 ? 1 : ((fmt) == GUI_PIXEL_FORMAT_RGB565 ? 2 : ((fmt) == GUI_PIXEL_FORMAT_RGB888 ? 3 : 4)))
+
+/**
+ * \brief           Get default pixel format for number of bytes per pixel
+ * \param[in]       size: Number of bytes per pixel, `1` to `4`
+ * \hideinitializer
+ */
+#define GUI_PIXEL_FORMAT_FROM_SIZE(size)    ((size) == 1 ? GUI_PIXEL_FORMAT_L8 : ((size) == 2 ? GUI_PIXEL_FORMAT_RGB565 : ((size) == 3 ? GUI_PIXEL_FORMAT_RGB888 : GUI_PIXEL_FORMAT_ARGB8888)))
+
 /**
  * \brief           LCD layer structure
  */
 typedef struct {
     uint8_t num;                            /*!< Layer number */
-    uint32_t start_address;                 /*!< Start address in memory if it exists */
+    uintptr_t start_address;                /*!< Start address in memory if it exists */
+    uint8_t pixel_format;                   /*!< Pixel format of layer memory, member of \ref gui_pixel_format_t set by low-level driver */
+    uint8_t pixel_size;                     /*!< Number of bytes per pixel, set by GUI from pixel format */
     volatile uint8_t pending;               /*!< Layer pending for redrawing operation */
-    gui_display_t display;                  /*!< Display setup for clipping regions for main layers (no virtual) */
+    gui_display_t display[GUI_CFG_DISPLAY_DIRTY_RECTS]; /*!< List of regions drawn on main layers (no virtual) in last redraw operation */
+    size_t display_count;                   /*!< Number of valid regions in \ref display array */
     
     gui_dim_t width;                        /*!< Layer width, used for virtual layers mainly */
     gui_dim_t height;                       /*!< Layer height, used for virtual layers mainly */
@@ -310,16 +482,53 @@ typedef struct {
  * \brief           GUI LCD structure
  */
 typedef struct {
-    gui_dim_t width;                        /*!< LCD width in units of pixels */
-    gui_dim_t height;                       /*!< LCD height in units of pixels */
-    uint8_t pixel_size;                     /*!< Number of bytes per pixel */
+    gui_dim_t width;                        /*!< LCD width in units of pixels, logical width when rotated */
+    gui_dim_t height;                       /*!< LCD height in units of pixels, logical height when rotated */
+#if GUI_CFG_LCD_ROTATION || __DOXYGEN__
+    uint8_t rotation;                       /*!< Rotation of logical screen, member of \ref gui_lcd_rotation_t */
+#endif /* GUI_CFG_LCD_ROTATION || __DOXYGEN__ */
+    uint8_t pixel_size;                     /*!< Default number of bytes per pixel for layers without own pixel format */
+#if GUI_CFG_LCD_CLUT || __DOXYGEN__
+    const gui_color_t* palette;             /*!< Colors of \ref GUI_PIXEL_FORMAT_L8 pixel values, set by low-level driver or \ref gui_lcd_setpalette. GUI uses default palette when `NULL` */
+    uint16_t palette_size;                  /*!< Number of colors in palette, up to `256` */
+    uint8_t palette_id;                     /*!< Changed on every palette change, bitmaps saved with other palette are not used */
+#endif /* GUI_CFG_LCD_CLUT || __DOXYGEN__ */
     gui_layer_t* active_layer;              /*!< Active layer number currently shown to LCD */
     gui_layer_t* drawing_layer;             /*!< Currently active drawing layer */
     size_t layer_count;                     /*!< Number of layers used for LCD and drawings */
     gui_layer_t* layers;                    /*!< Pointer to layers */
+#if GUI_CFG_LCD_BACKGROUND || __DOXYGEN__
+    gui_layer_t* background;                /*!< Static layer shown below drawing layers by display controller, set by low-level driver */
+#endif /* GUI_CFG_LCD_BACKGROUND || __DOXYGEN__ */
     uint32_t flags;                         /*!< List of flags */
 } gui_lcd_t;
 
+/**
+ * \brief           Callback function with regions changed in last drawn frame
+ * \param[in]       layer: Layer with finished frame, pixels are valid until callback returns
+ * \param[in]       rects: Changed regions in display memory coordinates of layer
+ * \param[in]       count: Number of regions
+ * \param[in]       arg: User argument set with \ref gui_lcd_setframecallback
+ */
+typedef void (*gui_lcd_frame_fn)(const gui_layer_t* layer, const gui_display_t* rects, size_t count, void* arg);
+
+/**
+ * \brief           Image file format of screen capture
+ */
+typedef enum {
+    GUI_LCD_CAPTURE_BMP = 0x00,             /*!< Uncompressed 24-bit BMP file */
+    GUI_LCD_CAPTURE_QOI,                    /*!< QOI file, lossless compression with small encoder state */
+} gui_lcd_capture_format_t;
+
+/**
+ * \brief           Callback function receiving encoded screen capture data
+ * \param[in]       data: Next chunk of file data
+ * \param[in]       len: Length of chunk in units of bytes
+ * \param[in]       arg: User argument set with \ref gui_lcd_capture
+ * \return          `1` to continue, `0` to abort capture
+ */
+typedef uint8_t (*gui_lcd_capture_fn)(const void* data, size_t len, void* arg);
+
 /**
  * \ingroup         GUI_IMAGE
  * \brief           Image descriptor structure
@@ -329,8 +538,56 @@ typedef struct {
     gui_dim_t y_size;                       /*!< Image Y size */
     uint8_t bpp;                            /*!< Bits per pixel */
     const uint8_t* image;                   /*!< Pointer to image byte array */
+    uint8_t flags;                          /*!< List of image flags */
+    const gui_color_t* palette;             /*!< ARGB8888 color table for indexed images with 8 or 4 bits per pixel. Set to `NULL` for direct color images */
+    uint16_t palette_size;                  /*!< Number of colors in palette, up to `256` */
+    uint32_t size;                          /*!< Size of image data in units of bytes, required for \ref GUI_FLAG_IMAGE_JPEG images */
 } gui_image_desc_t;
 
+#define GUI_FLAG_IMAGE_RLE              ((uint8_t)0x01) /*!< Image data are run-length compressed. Each block starts with control byte `n`: when bit 7 is set, next pixel is repeated `(n & 0x7F) + 1` times, otherwise `n + 1` literal pixels follow. Blocks may continue in next line */
+#define GUI_FLAG_IMAGE_JPEG             ((uint8_t)0x02) /*!< Image data are baseline JPEG file of \ref gui_image_desc_t.size bytes, decoded by \ref gui_ll_t.DrawJPEG. Image is opaque, `bpp` is ignored */
+
+/**
+ * \ingroup         GUI_WIDGETS
+ * \brief           8-bit alpha mask of widget, see \ref gui_widget_setmask
+ */
+typedef struct {
+    gui_dim_t width;                        /*!< Mask width in units of pixels */
+    gui_dim_t height;                       /*!< Mask height in units of pixels */
+    const uint8_t* data;                    /*!< Alpha values, one byte per pixel with lines of `width` bytes. `0x00` hides widget, `0xFF` shows it */
+} gui_mask_t;
+
+/**
+ * \ingroup         GUI_IMAGE
+ * \brief           Get number of bytes for single line of indexed image
+ * \note            Lines of indexed images start on byte boundary, with 4 bits per pixel first pixel is in low nibble
+ * \param[in]       img: Image descriptor
+ */
+#define GUI_IMAGE_INDEXED_LINE_SIZE(img)    ((img)->bpp == 4 ? (((img)->x_size + 1) >> 1) : (img)->x_size)
+
+/**
+ * \ingroup         GUI_IMAGE
+ * \brief           Single frame of animated image
+ */
+typedef struct {
+    const gui_image_desc_t* delta;          /*!< Pixels changed from previous frame, optionally \ref GUI_FLAG_IMAGE_RLE compressed.
+                                                    Must have the same format as base image. Set to `NULL` when frame equals previous one */
+    gui_dim_t x;                            /*!< X position of changed area in animation */
+    gui_dim_t y;                            /*!< Y position of changed area in animation */
+    uint16_t duration;                      /*!< Time frame is shown, in units of milliseconds */
+} gui_image_frame_t;
+
+/**
+ * \ingroup         GUI_IMAGE
+ * \brief           Animated image made of base image and delta frames
+ * \note            Total duration of all frames must not exceed `65535` milliseconds
+ */
+typedef struct {
+    const gui_image_desc_t* base;           /*!< Image with all pixels, first frame is applied over it. At least 8 bits per pixel */
+    const gui_image_frame_t* frames;        /*!< List of frames */
+    uint16_t count;                         /*!< Number of frames */
+} gui_image_anim_t;
+
 /**
  * \brief           Low-level LCD command enumeration
  */
@@ -350,14 +607,118 @@ typedef enum {
      * \param[out]  *result: Pointer to \ref uint8_t variable to save result: 0 = OK otherwise ERROR
      */
     GUI_LL_Command_SetActiveLayer,          /*!< Set new layer as active layer */
+    
+    /**
+     * \brief       Send band buffer to display memory when \ref GUI_CFG_LCD_BAND is enabled
+     *
+     *              Band position on screen is in `x_offset` and `y_offset`, its size in `width` and `height` fields of band layer.
+     *              Driver may start transfer in background and calls \ref gui_lcd_confirmflush when band buffer is not used anymore
+     *
+     * \param[in]   *param: Pointer to \ref gui_ll_flush_t structure with band to send
+     * \param[out]  *result: Pointer to \ref uint8_t variable to save result: 0 = OK otherwise ERROR
+     */
+    GUI_LL_Command_Flush,                   /*!< Send band buffer to display */
+    
+    /**
+     * \brief       Take lock shared between cores when \ref GUI_CFG_LCD_TILE_CORES is greater than `1`
+     *
+     *              Driver waits until lock is taken, for example with hardware semaphore,
+     *              and makes all previous writes visible to other core
+     *
+     * \param[in]   *param: Not used
+     * \param[out]  *result: Pointer to \ref uint8_t variable to save result: 0 = OK otherwise ERROR
+     */
+    GUI_LL_Command_CoreLock,                /*!< Take lock shared between cores */
+    
+    /**
+     * \brief       Release lock taken with \ref GUI_LL_Command_CoreLock command
+     *
+     * \param[in]   *param: Not used
+     * \param[out]  *result: Pointer to \ref uint8_t variable to save result: 0 = OK otherwise ERROR
+     */
+    GUI_LL_Command_CoreUnlock,              /*!< Release lock shared between cores */
+    
+    /**
+     * \brief       Enter low-power state after \ref GUI_CFG_IDLE_TIMEOUT without activity
+     *
+     *              Driver may stop display refresh, put panel to sleep and disable clocks
+     *              of drawing accelerator. No drawing is done until \ref GUI_LL_Command_PowerUp command
+     *
+     * \param[in]   *param: Not used
+     * \param[out]  *result: Pointer to \ref uint8_t variable to save result: 0 = OK otherwise ERROR
+     */
+    GUI_LL_Command_PowerDown,               /*!< Enter low-power state */
+    
+    /**
+     * \brief       Leave low-power state entered with \ref GUI_LL_Command_PowerDown command
+     *
+     * \param[out]  *param: Pointer to \ref uint8_t variable, set to `1` when layer memory kept its content.
+     *                  When left at `0`, complete screen is redrawn
+     * \param[out]  *result: Pointer to \ref uint8_t variable to save result: 0 = OK otherwise ERROR
+     */
+    GUI_LL_Command_PowerUp,                 /*!< Leave low-power state */
+
+    /**
+     * \brief       Get load of drawing accelerator when \ref GUI_CFG_USE_METRICS is enabled
+     *
+     *              Driver reports part of time accelerator was busy since previous command.
+     *              Command is optional, load is reported as unknown when driver does not process it
+     *
+     * \param[out]  *param: Pointer to \ref uint8_t variable to save load in units of percent
+     * \param[out]  *result: Pointer to \ref uint8_t variable to save result: 0 = OK otherwise ERROR
+     */
+    GUI_LL_Command_GetLoad,                 /*!< Get load of drawing accelerator */
+    
+    /**
+     * \brief       Load display palette to display controller when \ref GUI_CFG_LCD_CLUT is enabled
+     *
+     *              Palette is in \ref gui_lcd_t.palette and \ref gui_lcd_t.palette_size.
+     *              Command is sent once at initialization and on each \ref gui_lcd_setpalette call
+     *
+     * \param[in]   *param: Not used
+     * \param[out]  *result: Pointer to \ref uint8_t variable to save result: 0 = OK otherwise ERROR
+     */
+    GUI_LL_Command_SetPalette,              /*!< Load display palette */
 } GUI_LL_Command_t;
 
+/**
+ * \brief           Band flush parameters for \ref GUI_LL_Command_Flush command
+ */
+typedef struct {
+    gui_layer_t* band;                      /*!< Band buffer with pixels in LCD format and band position on screen */
+    uint8_t last;                           /*!< Set to `1` when band is last one of frame */
+} gui_ll_flush_t;
+
+/**
+ * \brief           Filled rectangle for batched drawing
+ * \sa              gui_draw_filledrectangles
+ */
+typedef struct {
+    gui_dim_t x;                            /*!< Top left X position */
+    gui_dim_t y;                            /*!< Top left Y position */
+    gui_dim_t width;                        /*!< Rectangle width */
+    gui_dim_t height;                       /*!< Rectangle height */
+    gui_color_t color;                      /*!< Fill color */
+} gui_ll_rect_t;
+
+#if GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__
+/**
+ * \brief           List of recorded drawing commands
+ */
+typedef struct {
+    uint8_t* data;                          /*!< Recorded commands */
+    size_t len;                             /*!< Number of used bytes */
+    size_t size;                            /*!< Number of allocated bytes */
+    uint8_t detached;                       /*!< Set to `1` when list is replayed after widgets may change, widget memory is then not referenced */
+} gui_dlist_t;
+#endif /* GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__ */
+
 /**
  * \brief           GUI Low-Level structure for drawing operations
  */
 typedef struct gui_ll_t {
     void            (*Init)         (gui_lcd_t *);                                                                      /*!< Pointer to LCD initialization function */
-    uint8_t         (*IsReady)      (gui_lcd_t *);                                                                      /*!< Pointer to LCD is ready function */
+    uint8_t         (*IsReady)      (gui_lcd_t *);                                                                      /*!< Pointer to LCD is ready function, returns 1 when all queued operations are finished */
     void            (*SetPixel)     (gui_lcd_t *, gui_layer_t *, gui_dim_t, gui_dim_t, gui_color_t);                    /*!< Pointer to LCD set pixel function */
     gui_color_t     (*GetPixel)     (gui_lcd_t *, gui_layer_t *, gui_dim_t, gui_dim_t);                                 /*!< Pointer to read pixel from LCD */
     void            (*Fill)         (gui_lcd_t *, gui_layer_t *, void *, gui_dim_t, gui_dim_t, gui_dim_t, gui_color_t); /*!< Pointer to LCD fill screen or rectangle function */
@@ -370,6 +731,13 @@ typedef struct gui_ll_t {
     void            (*DrawImage24)  (gui_lcd_t *, gui_layer_t *, const gui_image_desc_t *, const void *, void *, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t);   /*!< Pointer to function for drawing 24BPP (RGB888) images */
     void            (*DrawImage32)  (gui_lcd_t *, gui_layer_t *, const gui_image_desc_t *, const void *, void *, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t);   /*!< Pointer to function for drawing 32BPP (ARGB8888) images */
     void            (*CopyChar)     (gui_lcd_t *, gui_layer_t *, const void *, void *, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t, gui_color_t);                /*!< Pointer to copy char function with alpha only as source */
+    void            (*DrawImageIndexed) (gui_lcd_t *, gui_layer_t *, const gui_image_desc_t *, const void *, void *, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t);   /*!< Pointer to function for drawing indexed images with palette, 8 or 4 bits per pixel. Source line offset is in units of pixels and source always starts on byte boundary */
+    void            (*BlendHLine)   (gui_lcd_t *, gui_layer_t *, gui_dim_t, gui_dim_t, gui_dim_t, const uint8_t *, gui_color_t);   /*!< Pointer to function for blending color to horizontal line with 8-bit alpha for each pixel */
+    void            (*FillGradient) (gui_lcd_t *, gui_layer_t *, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t, const gui_color_t *, uint8_t);  /*!< Pointer to function for filling rectangle with one ARGB8888 color per row when last parameter is `1` or per column when `0`. Color array is only valid during the call */
+    void            (*FillRects)    (gui_lcd_t *, gui_layer_t *, const gui_ll_rect_t *, size_t);                     /*!< Pointer to function for filling list of rectangles at once. Rectangles must be filled in array order, array is only valid during the call */
+    void            (*CopyMask)     (gui_lcd_t *, gui_layer_t *, const void *, void *, const uint8_t *, uint8_t, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t);   /*!< Pointer to function to blend source over destination of the same format with 8-bit alpha mask of each pixel multiplied by overall transparency. Last parameter is mask line offset */
+    void            (*DrawJPEG)     (gui_lcd_t *, gui_layer_t *, const gui_image_desc_t *, void *, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t);   /*!< Pointer to function for decoding \ref GUI_FLAG_IMAGE_JPEG image. Parameters after destination are left and top offset of visible part in image, its width and height and destination line offset. Decoding may continue after function returns, until \ref gui_ll_t.IsReady reports it */
+    void            (*CopyRects)    (gui_lcd_t *, gui_layer_t *, const gui_layer_t *, const gui_display_t *, size_t);  /*!< Pointer to function for copying list of regions from source layer (third parameter) to the same position in destination layer at once. Regions are in memory orientation of layers, array is only valid during the call */
 } gui_ll_t;
 
 /**
@@ -391,31 +759,71 @@ typedef struct {
 } gui_font_char_t;
 
 /**
- * \brief           FONT structure for writing usage
+ * \brief           Range of consecutive characters in sparse font
+ * \note            Ranges in font must be sorted by start character and must not overlap
  */
 typedef struct {
+    uint32_t startchar;                     /*!< First character in range */
+    uint32_t endchar;                       /*!< Last character in range */
+    const gui_font_char_t* data;            /*!< Pointer to character info of first character in range */
+    const uint8_t* advance;                 /*!< Optional advance table of range, see \ref gui_font_t.advance */
+} gui_font_range_t;
+
+/**
+ * \brief           FONT structure for writing usage
+ * \note            When \ref gui_font_t.ranges is set, characters are looked up in range table
+ *                  and \ref gui_font_t.startchar, \ref gui_font_t.endchar and \ref gui_font_t.data are ignored.
+ *                  This allows fonts with characters from distant unicode blocks without empty entries
+ * \note            Characters not available in font are searched in \ref gui_font_t.fallback chain
+ *                  before `?` character of font is used
+ */
+typedef struct gui_font {
     const gui_char* name;                   /*!< Pointer to font name */
     uint8_t size;                           /*!< Font size in units of pixels */
     uint16_t startchar;                     /*!< Start character number in list */
     uint16_t endchar;                       /*!< End character number in list */
     uint8_t flags;                          /*!< List of flags for font */
     const gui_font_char_t* data;            /*!< Pointer to first character */
+    const gui_font_range_t* ranges;         /*!< Optional sorted list of character ranges. Set to `NULL` for single range font */
+    size_t ranges_count;                    /*!< Number of entries in ranges list */
+    const struct gui_font* fallback;        /*!< Optional font used for characters not available in this font */
+    const uint8_t* advance;                 /*!< Optional table with `x_size + x_margin` of each character from \ref gui_font_t.startchar to \ref gui_font_t.endchar.
+                                                    Text measurement reads only this dense table instead of character info. Set to `NULL` if not used */
 } gui_font_t;
 
 #define GUI_FLAG_FONT_AA                ((uint8_t)0x01) /*!< Indicates anti-alliasing on font */
 #define GUI_FLAG_FONT_RIGHTALIGN        ((uint8_t)0x02) /*!< Indicates right align text if string length is too wide for rectangle */
 #define GUI_FLAG_FONT_MULTILINE         ((uint8_t)0x04) /*!< Indicates multi line support on widget */
 #define GUI_FLAG_FONT_EDITMODE          ((uint8_t)0x08) /*!< Edit mode is enabled on text */
+#define GUI_FLAG_FONT_FIXEDWIDTH        ((uint8_t)0x10) /*!< Font flag indicating all characters have the same width and right margin as first character in font */
+#define GUI_FLAG_FONT_RLE               ((uint8_t)0x20) /*!< Character data is run-length compressed. Each block starts with control byte `n`: when bit 7 is set, next byte is repeated `(n & 0x7F) + 1` times, otherwise `n + 1` literal bytes follow */
+#define GUI_FLAG_FONT_A8                ((uint8_t)0x40) /*!< Character data is 8-bit alpha, one byte per pixel with lines of `x_size` bytes. Uncompressed data are copied by low-level from font memory without RAM cache */
+#define GUI_FLAG_FONT_A4                ((uint8_t)0x80) /*!< Character data is 4-bit alpha with first pixel in low nibble and lines of `(x_size + 1) / 2` bytes. Uncompressed data are copied by low-level from font memory without RAM cache when low-level sets \ref GUI_FLAG_LCD_CHAR_A4 */
 
 #if defined(GUI_INTERNAL) || __DOXYGEN__
 /**
  * \brief           Char temporary entry stored in RAM for faster copy with blending operations
  */
-typedef struct {
+typedef struct gui_font_charentry {
     gui_linkedlist_t list;                  /*!< Linked list entry. Must always be first on the list */
+    struct gui_font_charentry* hash_next;   /*!< Next entry in the same hash bucket */
+    size_t size;                            /*!< Number of bytes allocated for entry */
     const gui_font_char_t* Ch;              /*!< Character value */
     const gui_font_t* Font;                 /*!< Pointer to font structure */
+#if GUI_CFG_LCD_ROTATION || __DOXYGEN__
+    uint8_t rotation;                       /*!< Screen rotation character image is rotated for */
+#endif /* GUI_CFG_LCD_ROTATION || __DOXYGEN__ */
 } gui_font_charentry_t;
+
+/**
+ * \brief           Memorized character lookup resolved in fallback font
+ */
+typedef struct {
+    const gui_font_t* Font;                 /*!< Font used for lookup */
+    uint32_t ch;                            /*!< Unicode character */
+    const gui_font_t* Owner;                /*!< Font in fallback chain with character or `NULL` if not found */
+    const gui_font_char_t* Ch;              /*!< Character info from owner font */
+} gui_font_fallback_t;
 #endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
 
 #if !__DOXYGEN__
@@ -692,7 +1100,7 @@ typedef struct {
 typedef struct gui_timer_t {
     gui_linkedlist_t list;                  /*!< Linked list entry, must be first on the list */
     uint16_t period;                        /*!< Timer period value */
-    uint16_t counter;                       /*!< Timer current counter */
+    uint32_t expire;                        /*!< Absolute time of next expiry in units of milliseconds */
     uint8_t flags;                          /*!< Timer flags */
     void* params;                           /*!< Custom parameters passed to callback function */
     void (*callback)(struct gui_timer_t *); /*!< Timer callback function */
@@ -704,6 +1112,170 @@ typedef struct gui_timer_t {
  */
 typedef gui_timer_t* gui_timer_p;
 
+/**
+ * \ingroup         GUI_SPRITE
+ * \brief           Sprite drawn over widgets when frame is finished
+ */
+typedef struct gui_sprite_t {
+    const gui_image_desc_t* img;            /*!< Sprite image or `NULL` for filled rectangle */
+    gui_color_t color;                      /*!< Color of filled rectangle sprite */
+    gui_dim_t x;                            /*!< Absolute X position on screen */
+    gui_dim_t y;                            /*!< Absolute Y position on screen */
+    gui_dim_t width;                        /*!< Sprite width in units of pixels */
+    gui_dim_t height;                       /*!< Sprite height in units of pixels */
+    gui_display_t drawn;                    /*!< Area covered by sprite on last drawn frame */
+    void* under;                            /*!< Pixels below sprite on last drawn frame */
+    uint8_t flags;                          /*!< Sprite flags */
+} gui_sprite_t;
+
+/**
+ * \ingroup         GUI_SPRITE
+ * \brief           Pointer to \ref gui_sprite_t
+ */
+typedef gui_sprite_t* gui_sprite_p;
+
+/**
+ * \ingroup         GUI_TRANSITION
+ * \brief           List of screen transition effects
+ * \note            Lower 2 bits are direction new screen is moving to, bit `2` is set for push effects
+ */
+typedef enum {
+    GUI_TRANSITION_SLIDE_LEFT = 0x00,       /*!< New screen slides from right side over old screen */
+    GUI_TRANSITION_SLIDE_RIGHT = 0x01,      /*!< New screen slides from left side over old screen */
+    GUI_TRANSITION_SLIDE_UP = 0x02,         /*!< New screen slides from bottom over old screen */
+    GUI_TRANSITION_SLIDE_DOWN = 0x03,       /*!< New screen slides from top over old screen */
+    GUI_TRANSITION_PUSH_LEFT = 0x04,        /*!< New screen comes from right side and pushes old screen out on left side */
+    GUI_TRANSITION_PUSH_RIGHT = 0x05,       /*!< New screen comes from left side and pushes old screen out on right side */
+    GUI_TRANSITION_PUSH_UP = 0x06,          /*!< New screen comes from bottom and pushes old screen out on top */
+    GUI_TRANSITION_PUSH_DOWN = 0x07,        /*!< New screen comes from top and pushes old screen out on bottom */
+} gui_transition_t;
+
+/**
+ * \ingroup         GUI_TRANSITION
+ * \brief           Screen transition state for internal use
+ */
+typedef struct {
+    gui_display_t area;                     /*!< Animated area on screen */
+    uint8_t* buff_out;                      /*!< Pixels of old screen as they are in display memory */
+    uint8_t* buff_in;                       /*!< Pixels of new screen as they are in display memory */
+    gui_display_t changed[GUI_CFG_DISPLAY_DIRTY_RECTS]; /*!< Parts of area redrawn by widgets in current frame */
+    size_t changed_count;                   /*!< Number of valid entries in \ref changed */
+    gui_timer_t* timer;                     /*!< Timer requesting animation frames */
+    uint32_t time;                          /*!< Time of first animation frame */
+    uint16_t duration;                      /*!< Transition duration in units of milliseconds */
+    uint8_t type;                           /*!< Transition effect, member of \ref gui_transition_t */
+    uint8_t state;                          /*!< Transition state */
+    uint8_t rotation;                       /*!< Screen rotation buffers are copied with */
+} gui_transition_core_t;
+
+#if GUI_CFG_SCREEN_STACK || __DOXYGEN__
+
+/**
+ * \ingroup         GUI_SCREEN
+ * \brief           Screen on screen stack
+ */
+typedef struct {
+    struct gui_handle* h;                   /*!< Screen widget handle */
+    uint8_t* pixels;                        /*!< Pixels of hidden screen as they are in display memory, `NULL` when not cached */
+    size_t size;                            /*!< Size of \ref pixels in units of bytes */
+    gui_display_t area;                     /*!< Absolute area of screen when pixels were saved */
+    gui_display_t changed[GUI_CFG_DISPLAY_DIRTY_RECTS]; /*!< Areas changed while screen is hidden */
+    size_t changed_count;                   /*!< Number of valid entries in \ref changed */
+    struct gui_handle* focus;               /*!< Widget focused inside screen when pixels were saved */
+    uint8_t rotation;                       /*!< Screen rotation pixels were saved with */
+} gui_screen_entry_t;
+
+/**
+ * \ingroup         GUI_SCREEN
+ * \brief           Screen stack for internal use
+ */
+typedef struct {
+    gui_screen_entry_t stack[GUI_CFG_SCREEN_STACK]; /*!< Screens from oldest to visible one */
+    size_t count;                           /*!< Number of screens on stack */
+    size_t used;                            /*!< Number of bytes used for cached pixels */
+    uint8_t restore;                        /*!< Set to `1` when visible screen is copied from its pixels on next frame */
+} gui_screen_core_t;
+
+#endif /* GUI_CFG_SCREEN_STACK || __DOXYGEN__ */
+
+/**
+ * \ingroup         GUI_BIND
+ * \brief           Type of value in value slot
+ */
+typedef enum {
+    GUI_BIND_INT = 0x00,                    /*!< Signed 32-bit integer, formatted with `%d` style format */
+    GUI_BIND_FLOAT,                         /*!< Float value, formatted with `%f` style format */
+    GUI_BIND_STRING,                        /*!< String up to \ref GUI_CFG_BIND_TEXT_SIZE bytes, formatted with `%s` style format */
+} gui_bind_type_t;
+
+/**
+ * \ingroup         GUI_BIND
+ * \brief           Value slot written by producer thread and read by GUI thread
+ * \note            Each slot must have single writer. Structure is owned by user and must stay valid while widgets are bound to it
+ */
+typedef struct gui_bind_value_t {
+    volatile uint32_t seq;                  /*!< Write sequence, incremented before and after write, odd while value is written */
+    gui_bind_type_t type;                   /*!< Value type */
+    volatile union {
+        int32_t i;                          /*!< Integer value */
+        float f;                            /*!< Float value */
+        gui_char str[GUI_CFG_BIND_TEXT_SIZE];   /*!< String value */
+    } v;                                    /*!< Value */
+} gui_bind_value_t;
+
+/**
+ * \ingroup         GUI_IDLE
+ * \brief           Idle task callback function
+ * \param[in]       budget: Time task may use in this call, in units of microseconds.
+ *                      Task should do small chunk of work, check elapsed time with \ref GUI_CFG_IDLE_TIME and return
+ * \param[in]       arg: User argument passed on \ref gui_idle_add
+ * \return          `1` when more work is waiting, `0` when task is done and is removed from queue
+ */
+typedef uint8_t (*gui_idle_fn)(uint32_t budget, void* arg);
+
+/**
+ * \ingroup         GUI_IDLE
+ * \brief           Idle task queue entry
+ * \note            Structure is owned by user and must stay valid while task is in queue
+ */
+typedef struct gui_idle_task_t {
+    struct gui_idle_task_t* next;           /*!< Next task in queue */
+    gui_idle_fn fn;                         /*!< Task callback function */
+    void* arg;                              /*!< User argument for callback */
+    uint32_t budget;                        /*!< Maximal time of single call, in units of microseconds */
+    uint8_t priority;                       /*!< Task priority, tasks with higher value run first */
+    uint8_t queued;                         /*!< Set to `1` while task is in queue */
+} gui_idle_task_t;
+
+/**
+ * \ingroup         GUI_WIDGETS_CORE
+ * \brief           Type of static element
+ */
+typedef enum {
+    GUI_STATIC_TEXT = 0x00,                 /*!< Text drawn with font of parent widget, `data` is pointer to string */
+    GUI_STATIC_IMAGE,                       /*!< Image, `data` is pointer to \ref gui_image_desc_t */
+    GUI_STATIC_RECT,                        /*!< Filled rectangle, `data` is not used */
+} gui_static_type_t;
+
+/**
+ * \ingroup         GUI_WIDGETS_CORE
+ * \brief           Static element drawn by parent widget, without widget handle
+ *
+ *                  Static elements (labels, icons) are kept in constant array, they can not receive
+ *                  touch or focus and they are drawn below children widgets of their parent
+ * \sa              gui_widget_setstatics
+ */
+typedef struct {
+    gui_dim_t x;                            /*!< X position relative to inner area of parent widget */
+    gui_dim_t y;                            /*!< Y position relative to inner area of parent widget */
+    gui_dim_t width;                        /*!< Element width in units of pixels */
+    gui_dim_t height;                       /*!< Element height in units of pixels */
+    const void* data;                       /*!< Text or image, depending on type */
+    gui_color_t color;                      /*!< Text or rectangle color */
+    uint8_t type;                           /*!< Element type, member of \ref gui_static_type_t */
+    uint8_t align;                          /*!< Text align, combination of horizontal and vertical align flags */
+} gui_static_t;
+
 /**
  * \addtogroup      GUI_WIDGETS_CORE
  * \{
@@ -891,6 +1463,28 @@ typedef enum {
      */
     GUI_WC_DblClick,
     
+    /**
+     * \brief       Notification when swipe with single touch has been detected
+     *
+     * \note        Sent once on release, before \ref GUI_WC_TouchEnd event.
+     *              If widget does not process it, event is sent to parent widget
+     *
+     * \param[in]   *param: Pointer to \ref guii_touch_data_t structure, swipe is described in `gesture` member
+     * \param[out]  *result: None
+     */
+    GUI_WC_Swipe,
+    
+    /**
+     * \brief       Notification when distance between 2 touches has changed
+     *
+     * \note        Sent on touch move after distance changed for more than \ref GUI_CFG_TOUCH_PINCH_DISTANCE.
+     *              If widget does not process it, event is sent to parent widget
+     *
+     * \param[in]   *param: Pointer to \ref guii_touch_data_t structure, pinch scale and center are in `gesture` member
+     * \param[out]  *result: None
+     */
+    GUI_WC_Pinch,
+    
     /**
      * \brief       Notification when key has been pushed to this widget
      *
@@ -956,8 +1550,38 @@ typedef enum {
      * \param[out]  *result: None
      */
     GUI_WC_OnDismiss,
+    
+    /**     
+     * \brief       Widget has been shown or hidden
+     *
+     * \note        Called from \ref gui_widget_show and \ref gui_widget_hide when hidden status of widget changes
+     *
+     * \param[in]   *param: Pointer to int variable, set to `1` when widget was shown or `0` when it was hidden
+     * \param[out]  *result: None
+     */
+    GUI_WC_VisibilityChanged,
 } gui_wc_t;
 
+/**
+ * \brief           Get subscription mask bit of widget callback command
+ * \param[in]       cmd: Callback command, member of \ref gui_wc_t enumeration
+ * \hideinitializer
+ */
+#define GUI_WC_MASK(cmd)                    ((uint32_t)1 << (cmd))
+
+/**
+ * \brief           Subscription mask of commands always sent to widget callback
+ * \note            Commands which create, draw and remove widget can not be skipped
+ */
+#define GUI_WC_MASK_CORE                    ((GUI_WC_MASK(GUI_WC_Init) - 1) | GUI_WC_MASK(GUI_WC_Init) | \
+                                                GUI_WC_MASK(GUI_WC_ChildWidgetCreated) | GUI_WC_MASK(GUI_WC_Draw) | \
+                                                GUI_WC_MASK(GUI_WC_CanRemove) | GUI_WC_MASK(GUI_WC_Remove))
+
+/**
+ * \brief           Subscription mask to receive all commands
+ */
+#define GUI_WC_MASK_ALL                     ((uint32_t)0)
+
 /**
  * \brief           Basic widget structure
  */
@@ -968,6 +1592,18 @@ struct gui_handle;
  */
 typedef struct gui_handle* gui_handle_p;    /*!< Handle object for GUI widget */
 
+/**
+ * \ingroup         GUI_WIDGET_STYLE
+ * \brief           Shared widget style
+ */
+struct gui_style;
+
+/**
+ * \ingroup         GUI_WIDGET_STYLE
+ * \brief           Handle object for shared widget style
+ */
+typedef struct gui_style* gui_style_p;
+
 /**
  * \brief           Structure used in setting and getting parameter values from widgets using callbacks
  */
@@ -1037,38 +1673,144 @@ typedef struct {
     gui_widget_callback_t callback;         /*!< Pointer to control function, returns 1 if command handled or 0 if not */
     const gui_color_t* colors;              /*!< Pointer to list of colors as default values for widget */
     uint8_t color_count;                    /*!< Number of colors used in widget */
+    uint32_t events;                        /*!< Commands handled by \ref callback, built with \ref GUI_WC_MASK and \ref GUI_WC_MASK_CORE.
+                                                    Other commands are not sent to callback. Set to \ref GUI_WC_MASK_ALL to receive all */
 } gui_widget_t;
 
+/**
+ * \ingroup         GUI_WIDGET_LAYOUT
+ * \brief           Placement of children widgets inside container
+ */
+typedef enum {
+    GUI_LAYOUT_NONE = 0x00,                 /*!< Children are placed on their own position */
+    GUI_LAYOUT_ROW,                         /*!< Children are placed from left to right */
+    GUI_LAYOUT_COLUMN,                      /*!< Children are placed from top to bottom */
+    GUI_LAYOUT_GRID,                        /*!< Children fill cells of equal width, row by row */
+} gui_layout_type_t;
+
 #if defined(GUI_INTERNAL) || __DOXYGEN__
 
+#define GUI_STYLE_FLAG_FONT                 0x01    /*!< Style sets widget font */
+#define GUI_STYLE_FLAG_PADDING              0x02    /*!< Style sets widget padding */
+#define GUI_STYLE_FLAG_RADIUS               0x04    /*!< Style sets widget border radius */
+
+/**
+ * \ingroup         GUI_WIDGET_STYLE
+ * \brief           Style shared between widgets, values override widget defaults
+ */
+typedef struct gui_style {
+    const gui_color_t* colors;              /*!< Colors, indexed as colors of widget, or `NULL` */
+    const gui_font_t* font;                 /*!< Font when \ref GUI_STYLE_FLAG_FONT is set */
+    uint32_t padding;                       /*!< Padding in format of \ref gui_handle.padding when \ref GUI_STYLE_FLAG_PADDING is set */
+    gui_dim_t border_radius;                /*!< Border radius when \ref GUI_STYLE_FLAG_RADIUS is set */
+    uint16_t ref_count;                     /*!< Number of references: widgets using style and creator */
+    uint8_t color_count;                    /*!< Number of entries in \ref colors array */
+    uint8_t flags;                          /*!< Values set by style */
+} gui_style_t;
+
+/**
+ * \brief           Layout parameters of widget
+ */
+typedef struct {
+    uint8_t type;                           /*!< Layout of children, member of \ref gui_layout_type_t */
+    uint8_t columns;                        /*!< Number of columns for \ref GUI_LAYOUT_GRID */
+    uint8_t grow;                           /*!< Share of free space widget takes in row or column parent */
+    gui_dim_t gap;                          /*!< Space between children in units of pixels */
+} gui_handle_layout_t;
+
+/**
+ * \brief           Cached widget geometry, valid until any geometry change in the system
+ */
+typedef struct {
+    uint32_t gen;                           /*!< Geometry generation number values were calculated for */
+    uint8_t valid;                          /*!< Bit mask of valid cached values */
+    gui_dim_t abs_x;                        /*!< Cached absolute X position on screen */
+    gui_dim_t abs_y;                        /*!< Cached absolute Y position on screen */
+    gui_dim_t width;                        /*!< Cached width in units of pixels */
+    gui_dim_t height;                       /*!< Cached height in units of pixels */
+} gui_handle_geometry_t;
+
+/**
+ * \brief           Rarely used values of widget, allocated only when widget needs one of them
+ * \note            Values are not needed for tree traversal by redraw, touch and invalidate
+ * \sa              gui_handle.ext
+ */
+typedef struct gui_handle_ext {
+    size_t textmemsize;                     /*!< Number of bytes for text when dynamically allocated */
+    size_t textcursor;                      /*!< Text cursor position */
+#if GUI_CFG_USE_TRANSLATE || __DOXYGEN__
+    const gui_char* texttranslated;         /*!< Memorized translation of static text */
+    const gui_char* texttranslatedsrc;      /*!< Text translation was memorized for, `NULL` when not valid */
+    uint32_t texttranslatedgen;             /*!< Translation generation memorized value belongs to */
+#endif /* GUI_CFG_USE_TRANSLATE || __DOXYGEN__ */
+    gui_timer_t* timer;                     /*!< Software timer pointer */
+    gui_color_t* colors;                    /*!< Pointer to allocated color memory when custom colors are used */
+    void* UserData;                         /*!< Pointer to optional user data */
+    uint8_t* retained;                      /*!< Retained bitmap of widget and its children when \ref GUI_FLAG_RETAINED is set */
+    gui_dim_t retained_width;               /*!< Width of retained bitmap in units of pixels */
+    gui_dim_t retained_height;              /*!< Height of retained bitmap in units of pixels */
+    uint8_t retained_format;                /*!< Pixel format of retained bitmap, member of \ref gui_pixel_format_t */
+#if GUI_CFG_LCD_ROTATION || __DOXYGEN__
+    uint8_t retained_rotation;              /*!< Screen rotation retained bitmap was saved with */
+#endif /* GUI_CFG_LCD_ROTATION || __DOXYGEN__ */
+#if GUI_CFG_LCD_CLUT || __DOXYGEN__
+    uint8_t retained_palette;               /*!< Value of \ref gui_lcd_t.palette_id retained bitmap was saved with */
+#endif /* GUI_CFG_LCD_CLUT || __DOXYGEN__ */
+#if GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__
+    gui_dlist_t dlist;                      /*!< Recorded drawing commands when \ref GUI_FLAG_DISPLAY_LIST is set */
+    gui_display_t dlist_disp;               /*!< Visible area of widget when display list was recorded */
+#endif /* GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__ */
+} gui_handle_ext_t;
+
 /**
  * \brief           Common GUI values for widgets
+ * \note            Values used by tree traversal are placed first, rarely used ones are in \ref gui_handle_ext_t
  */
 typedef struct gui_handle {
     gui_linkedlist_t list;                  /*!< Linked list entry, must always be on top for casting */
-    gui_id_t id;                            /*!< Widget ID number */
-    uint32_t footprint;                     /*!< Footprint indicates widget is valid */
-    const gui_widget_t* widget;             /*!< Widget parameters with callback functions */
-    gui_widget_callback_t callback;         /*!< Callback function prototype */
+    uint32_t flags;                         /*!< All possible flags for specific widget */
     struct gui_handle* parent;              /*!< Pointer to parent widget */
-    float x;                                /*!< Object X position relative to parent window in units of pixels */
-    float y;                                /*!< Object Y position relative to parent window in units of pixels */
-    float width;                            /*!< Object width in units of pixels or percentages */
-    float height;                           /*!< Object height in units of pixels or percentages */
+    const gui_widget_t* widget;             /*!< Widget parameters with callback functions */
+    gui_handle_geometry_t geometry;         /*!< Cached absolute position and size */
+    int32_t zindex;                         /*!< Z-Index value of widget, which can be set by user. All widgets with same z-index are changeable when active on visible area */
+    gui_geom_t x;                           /*!< Object X position relative to parent window in units of pixels */
+    gui_geom_t y;                           /*!< Object Y position relative to parent window in units of pixels */
+    gui_geom_t width;                       /*!< Object width in units of pixels or percentages */
+    gui_geom_t height;                      /*!< Object height in units of pixels or percentages */
     uint32_t padding;                       /*!< 4-bytes long padding, each byte of one side, MSB = top padding, LSB = left padding.
                                                     Used for children widgets if virtual padding should be used */
-    int32_t zindex;                         /*!< Z-Index value of widget, which can be set by user. All widgets with same z-index are changeable when active on visible area */
 #if GUI_CFG_USE_TRANSPARENCY || __DOXYGEN__
     uint8_t transparency;                   /*!< Widget transparency relative to parent widget */
 #endif /* GUI_CFG_USE_TRANSPARENCY */
-    uint32_t flags;                         /*!< All possible flags for specific widget */
+#if GUI_CFG_WIDGET_MASK || __DOXYGEN__
+    const gui_mask_t* mask;                 /*!< Alpha mask of widget with children or `NULL` */
+#endif /* GUI_CFG_WIDGET_MASK || __DOXYGEN__ */
+#if GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__
+    gui_handle_layout_t layout;             /*!< Layout of children and flex grow factor */
+#endif /* GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__ */
     gui_const gui_font_t* font;             /*!< Font used for widget drawings */
     gui_char* text;                         /*!< Pointer to widget text if exists */
-    size_t textmemsize;                     /*!< Number of bytes for text when dynamically allocated */
-    size_t textcursor;                      /*!< Text cursor position */
-    gui_timer_t* timer;                     /*!< Software timer pointer */
-    gui_color_t* colors;                    /*!< Pointer to allocated color memory when custom colors are used */
-    void* UserData;                         /*!< Pointer to optional user data */
+    size_t textlen;                         /*!< Length of text in units of bytes, excluding trailing zero */
+    size_t textchars;                       /*!< Number of characters in text, less than \ref textlen for multi-byte UTF-8 characters */
+    struct gui_draw_text_layout* textlayout;/*!< Cached layout of widget text, used by \ref gui_draw_writetext */
+#if GUI_CFG_WIDGET_STYLE || __DOXYGEN__
+    gui_style_t* style;                     /*!< Shared style or `NULL` */
+#endif /* GUI_CFG_WIDGET_STYLE || __DOXYGEN__ */
+    gui_widget_callback_t callback;         /*!< Callback function prototype */
+    uint32_t callback_events;               /*!< Commands handled by \ref callback or \ref GUI_WC_MASK_ALL, see \ref gui_widget_t.events */
+    gui_handle_ext_t* ext;                  /*!< Rarely used values or `NULL` when widget does not use any of them */
+    gui_id_t id;                            /*!< Widget ID number */
+#if GUI_CFG_WIDGET_ID_HASH_SIZE || __DOXYGEN__
+    struct gui_handle* id_next;             /*!< Next widget in the same bucket of ID hash map */
+#endif /* GUI_CFG_WIDGET_ID_HASH_SIZE || __DOXYGEN__ */
+    struct gui_handle* remove_next;         /*!< Next widget in queue of widgets waiting to be removed */
+    uint32_t footprint;                     /*!< Footprint indicates widget is valid */
+#if GUI_CFG_WIDGET_LOCKFREE_GET || __DOXYGEN__
+    volatile uint16_t version;              /*!< Version of state read by lock-free getters, odd while state is being changed */
+#endif /* GUI_CFG_WIDGET_LOCKFREE_GET || __DOXYGEN__ */
+#if GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__
+    uint32_t redraw_count;                  /*!< Number of widget redraws, shown by debug overlay */
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__ */
 } gui_handle;
 
 /**
@@ -1080,13 +1822,176 @@ typedef struct gui_handle_root {
     gui_linkedlistroot_t root_list;         /*!< Linked list root of children widgets */
     gui_dim_t x_scroll;                     /*!< Scroll of widgets in horizontal direction in units of pixels */
     gui_dim_t y_scroll;                     /*!< Scroll of widgets in vertical direction in units of pixels */
+#if GUI_CFG_WIDGET_STATICS || __DOXYGEN__
+    const gui_static_t* statics;            /*!< Static elements drawn below children widgets */
+    uint16_t statics_count;                 /*!< Number of elements in \ref statics array */
+#endif /* GUI_CFG_WIDGET_STATICS || __DOXYGEN__ */
 } gui_handle_root_t;
 #endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
 
+#if GUI_CFG_USE_STATS || __DOXYGEN__
+/**
+ * \brief           GUI processing statistics
+ * \note            Time values are in units of \ref GUI_CFG_STATS_TIME and refer to last redrawn frame.
+ *                  Frame includes all processing since previous redraw
+ * \sa              gui_getstats
+ */
+typedef struct {
+    uint32_t frames;                        /*!< Number of redrawn frames */
+    uint32_t time_timers;                   /*!< Time spent in processing timers */
+    uint32_t time_touch;                    /*!< Time spent in processing touch inputs */
+    uint32_t time_keyboard;                 /*!< Time spent in processing keyboard inputs */
+    uint32_t time_redraw;                   /*!< Time spent in redrawing widgets */
+    uint32_t time_redraw_max;               /*!< Maximal time spent in redrawing of single frame */
+    uint32_t time_wait;                     /*!< Time spent in waiting low-level drawing to finish */
+    uint32_t widgets_redrawn;               /*!< Number of widgets redrawn */
+    uint32_t dirty_area;                    /*!< Number of redrawn pixels */
+    size_t mem_min_free;                    /*!< Minimal free memory ever available in memory regions */
+#if GUI_CFG_STATS_LATENCY || __DOXYGEN__
+    uint32_t latency_count;                 /*!< Number of touch inputs measured since initialization */
+    uint32_t latency_frame;                 /*!< Number of frame with result of last measured input */
+    uint32_t latency_last;                  /*!< Input-to-display latency of last measured input in units of milliseconds */
+    uint32_t latency_p50;                   /*!< Median latency of last \ref GUI_CFG_STATS_LATENCY_SAMPLES inputs in units of milliseconds */
+    uint32_t latency_p90;                   /*!< 90th percentile of latency in units of milliseconds */
+    uint32_t latency_p99;                   /*!< 99th percentile of latency in units of milliseconds */
+    uint32_t latency_max;                   /*!< Maximal latency of last measured inputs in units of milliseconds */
+#endif /* GUI_CFG_STATS_LATENCY || __DOXYGEN__ */
+} gui_stats_t;
+#endif /* GUI_CFG_USE_STATS || __DOXYGEN__ */
+
+#if GUI_CFG_USE_METRICS || __DOXYGEN__
+/**
+ * \brief           Metrics snapshot for remote monitoring
+ * \note            Counters are totals since initialization, time values are in units of \ref GUI_CFG_STATS_TIME
+ * \sa              gui_metrics_get
+ */
+typedef struct {
+    uint32_t time;                          /*!< System time when snapshot was published in units of milliseconds */
+    uint32_t frames;                        /*!< Number of redrawn frames */
+    uint32_t frame_hist[GUI_CFG_METRICS_HIST_SIZE]; /*!< Number of frames by redraw time, see \ref GUI_CFG_METRICS_HIST_BASE */
+    uint32_t time_redraw_max;               /*!< Maximal time spent in redrawing of single frame */
+    uint32_t widgets_redrawn;               /*!< Number of widget redraws */
+    uint64_t dirty_area;                    /*!< Number of redrawn pixels */
+    uint32_t glyph_hits;                    /*!< Number of characters found in glyph cache */
+    uint32_t glyph_misses;                  /*!< Number of characters not found in glyph cache */
+    size_t mem_free;                        /*!< Free memory */
+    size_t mem_min_free;                    /*!< Minimal free memory ever available */
+    size_t mem_largest_free;                /*!< Size of largest free block */
+    uint8_t mem_fragmentation;              /*!< Part of free memory not in largest free block in units of percent */
+    uint8_t ll_load;                        /*!< Load of drawing accelerator since previous snapshot in units of percent,
+                                                    `0xFF` when not reported by low-level, see \ref GUI_LL_Command_GetLoad */
+    uint32_t touch_overflow;                /*!< Number of touch entries dropped because input buffer was full */
+    uint32_t key_overflow;                  /*!< Number of keyboard entries dropped because input buffer was full */
+} gui_metrics_t;
+#endif /* GUI_CFG_USE_METRICS || __DOXYGEN__ */
+
+#if GUI_CFG_INPUT_RECORD || __DOXYGEN__
+/**
+ * \brief           Type of recorded input entry
+ */
+typedef enum {
+    GUI_INPUT_RECORD_TOUCH = 0x00,          /*!< Entry holds touch data */
+    GUI_INPUT_RECORD_KEY,                   /*!< Entry holds keyboard data */
+} gui_input_record_type_t;
+
+/**
+ * \brief           Recorded input entry
+ * \sa              gui_input_recordstart, gui_input_replaystart
+ */
+typedef struct {
+    uint32_t time;                          /*!< Time of entry relative to start of recording in units of milliseconds */
+    gui_input_record_type_t type;           /*!< Type of entry */
+    union {
+#if GUI_CFG_USE_TOUCH || __DOXYGEN__
+        gui_touch_data_t ts;                /*!< Raw touch data as passed to \ref gui_input_touchadd */
+#endif /* GUI_CFG_USE_TOUCH || __DOXYGEN__ */
+#if GUI_CFG_USE_KEYBOARD || __DOXYGEN__
+        gui_keyboard_data_t kb;             /*!< Key data as passed to \ref gui_input_keyadd */
+#endif /* GUI_CFG_USE_KEYBOARD || __DOXYGEN__ */
+        uint8_t dummy;                      /*!< Keeps union valid when no input is enabled */
+    } data;                                 /*!< Entry data */
+} gui_input_record_t;
+#endif /* GUI_CFG_INPUT_RECORD || __DOXYGEN__ */
+
+#if GUI_CFG_USE_TRACE || __DOXYGEN__
+/**
+ * \brief           Type of traced operation
+ */
+typedef enum {
+    GUI_TRACE_TYPE_WIDGET = 0x00,           /*!< Widget callback, operation is \ref gui_wc_t command */
+    GUI_TRACE_TYPE_REDRAW,                  /*!< Redraw of widget with its children, argument is number of pixels in clipping region */
+    GUI_TRACE_TYPE_TOUCH,                   /*!< Touch processing of widget children, operation is touch status */
+    GUI_TRACE_TYPE_LL,                      /*!< Low-level drawing operation, operation is \ref gui_trace_ll_t, argument is number of pixels */
+    GUI_TRACE_TYPE_WAIT,                    /*!< Waiting for low-level to finish queued operations */
+} gui_trace_type_t;
+
+/**
+ * \brief           Low-level operation of \ref GUI_TRACE_TYPE_LL event
+ */
+typedef enum {
+    GUI_TRACE_LL_Fill = 0x00,               /*!< \ref gui_ll_t.Fill */
+    GUI_TRACE_LL_Copy,                      /*!< \ref gui_ll_t.Copy */
+    GUI_TRACE_LL_CopyBlend,                 /*!< \ref gui_ll_t.CopyBlend */
+    GUI_TRACE_LL_DrawHLine,                 /*!< \ref gui_ll_t.DrawHLine */
+    GUI_TRACE_LL_DrawVLine,                 /*!< \ref gui_ll_t.DrawVLine */
+    GUI_TRACE_LL_FillRect,                  /*!< \ref gui_ll_t.FillRect */
+    GUI_TRACE_LL_DrawImage16,               /*!< \ref gui_ll_t.DrawImage16 */
+    GUI_TRACE_LL_DrawImage24,               /*!< \ref gui_ll_t.DrawImage24 */
+    GUI_TRACE_LL_DrawImage32,               /*!< \ref gui_ll_t.DrawImage32 */
+    GUI_TRACE_LL_CopyChar,                  /*!< \ref gui_ll_t.CopyChar */
+    GUI_TRACE_LL_DrawImageIndexed,          /*!< \ref gui_ll_t.DrawImageIndexed */
+    GUI_TRACE_LL_BlendHLine,                /*!< \ref gui_ll_t.BlendHLine */
+    GUI_TRACE_LL_FillGradient,              /*!< \ref gui_ll_t.FillGradient */
+    GUI_TRACE_LL_FillRects,                 /*!< \ref gui_ll_t.FillRects */
+    GUI_TRACE_LL_CopyMask,                  /*!< \ref gui_ll_t.CopyMask */
+    GUI_TRACE_LL_DrawJPEG,                  /*!< \ref gui_ll_t.DrawJPEG */
+    GUI_TRACE_LL_CopyRects,                 /*!< \ref gui_ll_t.CopyRects */
+} gui_trace_ll_t;
+
+/**
+ * \brief           Single trace event
+ * \note            Begin and end events of the same operation are always nested properly
+ */
+typedef struct {
+    uint32_t time;                          /*!< Event time in units of microseconds, see \ref GUI_CFG_TRACE_TIME */
+    const gui_widget_t* widget;             /*!< Widget type or `NULL` when event does not belong to widget */
+    gui_id_t id;                            /*!< Widget ID when widget type is set */
+    uint32_t arg;                           /*!< Operation argument, see \ref gui_trace_type_t */
+    uint8_t type;                           /*!< Event type, member of \ref gui_trace_type_t enumeration */
+    uint8_t op;                             /*!< Operation, see \ref gui_trace_type_t */
+    uint8_t begin;                          /*!< Set to `1` for begin event and `0` for end event */
+} gui_trace_event_t;
+
+/**
+ * \brief           Output function for trace export
+ * \param[in]       str: Part of exported text
+ * \param[in]       arg: User argument
+ */
+typedef void (*gui_trace_output_fn)(const char* str, void* arg);
+#endif /* GUI_CFG_USE_TRACE || __DOXYGEN__ */
+
 /**
  * \brief           Widget create function footprint for structures as callbacks
  */
-typedef gui_handle_p (*gui_widget_createfunc_t)(gui_id_t, gui_dim_t, gui_dim_t, gui_dim_t, gui_dim_t, gui_handle_p, gui_widget_callback_t, uint16_t);
+typedef gui_handle_p (*gui_widget_createfunc_t)(gui_id_t, float, float, float, float, gui_handle_p, gui_widget_callback_t, uint16_t);
+
+/**
+ * \brief           Description of one widget in constant widget tree
+ * \sa              gui_widget_createtree
+ */
+typedef struct {
+    gui_widget_createfunc_t create;         /*!< Widget create function, for example \ref gui_button_create */
+    gui_id_t id;                            /*!< Widget ID */
+    float x;                                /*!< X position relative to parent widget */
+    float y;                                /*!< Y position relative to parent widget */
+    float width;                            /*!< Widget width in units of pixels */
+    float height;                           /*!< Widget height in units of pixels */
+    gui_widget_callback_t cb;               /*!< Widget callback or `NULL` for default callback */
+    const gui_char* text;                   /*!< Constant widget text or `NULL` */
+    const gui_font_t* font;                 /*!< Widget font or `NULL` for default font */
+    int16_t parent;                         /*!< Index of parent entry in array, not used for first entry */
+    uint16_t flags;                         /*!< Widget create flags */
+} gui_widget_desc_t;
 
 /**
  * \}
@@ -1109,8 +2014,117 @@ typedef struct {
 typedef struct gui_translate_t {
     const gui_translate_language_t* source; /*!< Pointer to source language table */
     const gui_translate_language_t* active; /*!< Pointer to current language table */
+    uint16_t* index;                        /*!< Hash index of source entries, entry index plus `1` or `0` for empty slot */
+    size_t index_size;                      /*!< Number of slots in \ref index, power of `2` */
+    uint32_t gen;                           /*!< Generation, increased when any language changes */
 } gui_translate_t;
 
+/**
+ * \ingroup         GUI_ASSETS
+ * \brief           Asset bank structure for internal use
+ */
+typedef struct {
+    const void* base;                       /*!< Start of mounted bank in memory-mapped flash */
+    void* items;                            /*!< List of descriptors built for requested assets */
+} gui_assets_t;
+
+/**
+ * \ingroup         GUI_STREAM
+ * \brief           Read function of streamed file
+ * \param[in]       file: File handle passed on \ref gui_stream_image_load
+ * \param[in]       offset: Offset in file to read from, in units of bytes
+ * \param[out]      dst: Destination memory, may be used directly as DMA destination
+ * \param[in]       len: Number of bytes to read
+ * \return          `1` when all bytes were read, `0` otherwise
+ */
+typedef uint8_t (*gui_stream_read_fn)(void* file, uint32_t offset, void* dst, size_t len);
+
+/**
+ * \ingroup         GUI_STREAM
+ * \brief           State of streamed image
+ */
+typedef enum {
+    GUI_STREAM_IDLE = 0x00,                 /*!< Image is not loaded */
+    GUI_STREAM_QUEUED,                      /*!< Load is waiting to be started */
+    GUI_STREAM_LOADING,                     /*!< Pixels are being read */
+    GUI_STREAM_READY,                       /*!< Pixels are in memory and image can be drawn */
+    GUI_STREAM_ERROR,                       /*!< File could not be read or no memory */
+} gui_stream_state_t;
+
+/**
+ * \ingroup         GUI_STREAM
+ * \brief           Image streamed from file
+ * \note            Structure is owned by user and must stay valid until image is released
+ */
+typedef struct gui_stream_image_t {
+    gui_image_desc_t desc;                  /*!< Image descriptor, pixels are set to `NULL` until image is ready */
+    struct gui_stream_image_t* next;        /*!< Next image waiting to be loaded */
+    gui_stream_read_fn read;                /*!< File read function */
+    void* file;                             /*!< File handle */
+    uint32_t offset;                        /*!< Offset of image header in file */
+    gui_handle_p h;                         /*!< Widget invalidated when image is ready */
+    uint8_t* data;                          /*!< Allocated pixel memory */
+    uint32_t size;                          /*!< Size of pixel data in units of bytes */
+    uint32_t loaded;                        /*!< Number of bytes already read */
+    volatile uint8_t state;                 /*!< Image state, member of \ref gui_stream_state_t */
+    volatile uint8_t cancel;                /*!< Set to `1` when image was released while loading */
+} gui_stream_image_t;
+
+/**
+ * \ingroup         GUI_ANIM
+ * \brief           List of animation easing functions
+ */
+typedef enum {
+    GUI_ANIM_EASE_LINEAR = 0x00,            /*!< Constant speed from start to end */
+    GUI_ANIM_EASE_IN,                       /*!< Start slow and accelerate */
+    GUI_ANIM_EASE_OUT,                      /*!< Start fast and decelerate */
+    GUI_ANIM_EASE_IN_OUT,                   /*!< Accelerate in first half and decelerate in second half */
+} gui_anim_ease_t;
+
+/**
+ * \ingroup         GUI_ANIM
+ * \brief           Animation value callback, called each time animated value is changed
+ * \param[in]       h: Widget handle animation belongs to
+ * \param[in]       value: New animated value
+ */
+typedef void (*gui_anim_exec_fn)(gui_handle_p h, int32_t value);
+
+/**
+ * \ingroup         GUI_ANIM
+ * \brief           Single running animation
+ */
+typedef struct {
+    gui_handle_p h;                         /*!< Widget handle animation belongs to */
+    gui_anim_exec_fn exec;                  /*!< Callback to apply new value */
+    int32_t start;                          /*!< Value at start of animation */
+    int32_t end;                            /*!< Value at end of animation */
+    int32_t value;                          /*!< Last value set with callback */
+    uint32_t time;                          /*!< Time when animation started */
+    uint16_t duration;                      /*!< Animation duration in units of milliseconds */
+    uint8_t ease;                           /*!< Easing function, member of \ref gui_anim_ease_t */
+} gui_anim_t;
+
+/**
+ * \ingroup         GUI_WIDGETS_CORE
+ * \brief           Bitmap with static part of widget drawing, copied to display on next redraws
+ */
+typedef struct {
+    uint8_t* data;                          /*!< Pixels as they are in display memory, `NULL` when not allocated */
+    size_t size;                            /*!< Size of pixels memory in units of bytes */
+    uint32_t key;                           /*!< Hash of widget state pixels were drawn with */
+    uint8_t valid;                          /*!< Set to `1` when pixels are valid for \ref key */
+} gui_widget_bitmap_t;
+
+/**
+ * \ingroup         GUI_ANIM
+ * \brief           Animation scheduler structure for internal use
+ */
+typedef struct {
+    gui_anim_t anims[GUI_CFG_ANIM_MAX];     /*!< List of running animations */
+    size_t count;                           /*!< Number of valid entries in \ref anims */
+    gui_timer_t* timer;                     /*!< Shared timer for evaluation of all animations */
+} gui_anim_core_t;
+
 /**
  * \}
  */
@@ -143,6 +143,39 @@ extern "C" {
 #define GUI_VALIGN_CENTER               0x10/*!< Vertical align is center */
 #define GUI_VALIGN_BOTTOM               0x20/*!< Vertical align is bottom */         
 
+/**
+ * \brief           Single line of text layout
+ */
+typedef struct {
+    const gui_char* str;                    /*!< Pointer to first character of line */
+    size_t total;                           /*!< Number of characters to read for line */
+    size_t draw;                            /*!< Number of characters to actually draw */
+    gui_dim_t width;                        /*!< Line width in units of pixels */
+    uint32_t hash;                          /*!< Hash of line bytes until start of next line, used to find edited lines */
+    size_t lookahead;                       /*!< Number of bytes from line start read to get line break, including text termination when reached */
+} gui_draw_text_line_t;
+
+/**
+ * \brief           Computed line breaks and sizes of text for drawing
+ * \note            Layout is valid as long as text, font and drawing box parameters don't change.
+ *                  In multi-line edit mode, only lines around edited part are computed again when text changes
+ */
+typedef struct gui_draw_text_layout {
+    const gui_char* str;                    /*!< Pointer to text layout is computed for */
+    size_t len;                             /*!< Text length in units of bytes */
+    uint32_t hash;                          /*!< Hash of text content */
+    const gui_font_t* font;                 /*!< Font used for layout */
+    gui_dim_t width;                        /*!< Width of drawing box */
+    gui_dim_t lineheight;                   /*!< Line height */
+    uint8_t flags;                          /*!< Text drawing flags */
+    
+    gui_dim_t rect_width;                   /*!< Width of complete text rectangle */
+    gui_dim_t rect_height;                  /*!< Height of complete text rectangle */
+    gui_dim_t x_offset;                     /*!< X offset added when right aligned text is wider than box */
+    size_t lines_count;                     /*!< Number of valid lines in \ref lines array */
+    gui_draw_text_line_t lines[];           /*!< Array of lines */
+} gui_draw_text_layout_t;
+
 /**
  * \brief           Structure for drawing strings on widgets
  * \sa              gui_draw_font_init
@@ -159,6 +192,7 @@ typedef struct {
     gui_color_t color1;                     /*!< Color 1 */
     gui_color_t Color2;                     /*!< Color 2 */
     uint32_t Scrolly;                       /*!< Scroll in vertical direction */
+    gui_draw_text_layout_t** layout;        /*!< Pointer to layout cache of text, allocated and reused by drawing function. Set to `NULL` to disable cache */
 } gui_draw_font_t;
 
 /**
@@ -192,6 +226,28 @@ typedef enum {
     GUI_DRAW_3D_State_Lowered = 0x01        /*!< Lowered 3D style */
 } gui_draw_3d_state_t;
 
+/**
+ * \brief           Gradient direction enumeration
+ * \sa              gui_draw_gradientrectangle
+ */
+typedef enum {
+    GUI_DRAW_GRADIENT_DIR_VERTICAL = 0x00,  /*!< Color changes from top to bottom */
+    GUI_DRAW_GRADIENT_DIR_HORIZONTAL = 0x01,/*!< Color changes from left to right */
+} gui_draw_gradient_dir_t;
+
+/**
+ * \brief           Font character cache statistics
+ * \sa              gui_draw_font_getcachestats
+ */
+typedef struct {
+    uint32_t hits;                          /*!< Number of characters found in cache */
+    uint32_t misses;                        /*!< Number of characters not found in cache */
+    uint32_t evictions;                     /*!< Number of characters removed to free memory */
+    size_t entries;                         /*!< Number of characters currently in cache */
+    size_t size;                            /*!< Number of bytes currently used by cache */
+    size_t size_max;                        /*!< Maximal number of bytes ever used by cache */
+} gui_draw_font_cache_stats_t;
+
 /**
  * \brief           Poly line object coordinates
  * \sa              gui_draw_poly
@@ -202,29 +258,56 @@ typedef struct {
 } gui_draw_poly_t;
 
 void        gui_draw_font_init(gui_draw_font_t* f);
+uint8_t     gui_draw_font_getcachestats(gui_draw_font_cache_stats_t* stats);
+#if GUI_CFG_FONT_PREWARM_QUEUE || __DOXYGEN__
+uint8_t     gui_draw_font_prewarm(const gui_font_t* font, const gui_char* const* strings, size_t count);
+uint8_t     gui_draw_font_prewarmlanguage(const gui_font_t* font, const gui_translate_language_t* lang);
+#endif /* GUI_CFG_FONT_PREWARM_QUEUE || __DOXYGEN__ */
 void        gui_draw_fillscreen(const gui_display_t* disp, gui_color_t color);
 void        gui_draw_setpixel(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_color_t color);
 gui_color_t gui_draw_getpixel(const gui_display_t* disp, gui_dim_t x, gui_dim_t y);
 void        gui_draw_vline(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t length, gui_color_t color);
 void        gui_draw_hline(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t length, gui_color_t color);
 void        gui_draw_line(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x2, gui_dim_t y2, gui_color_t color);
+void        gui_draw_line_aa(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x2, gui_dim_t y2, gui_color_t color);
 void        gui_draw_rectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color);
 void        gui_draw_filledrectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color);
+void        gui_draw_filledrectangles(const gui_display_t* disp, const gui_ll_rect_t* rects, size_t count);
+void        gui_draw_gradientrectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, const gui_gradient_t* gradient, gui_draw_gradient_dir_t dir);
 void        gui_draw_roundedrectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t r, gui_color_t color);
 void        gui_draw_filledroundedrectangle(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t r, gui_color_t color);
 void        gui_draw_circle(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y0, gui_dim_t r, gui_color_t color);
 void        gui_draw_filledcircle(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y0, gui_dim_t r, gui_color_t color);
+void        gui_draw_circle_aa(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y0, gui_dim_t r, gui_color_t color);
+void        gui_draw_arc_aa(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y0, gui_dim_t r, int16_t start, int16_t end, gui_color_t color);
 void        gui_draw_circlecorner(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y0, gui_dim_t r, uint8_t c, gui_color_t color);
 void        gui_draw_filledcirclecorner(const gui_display_t* disp, gui_dim_t x0, gui_dim_t y0, gui_dim_t r, uint8_t c, uint32_t color);
 void         gui_draw_triangle(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1,  gui_dim_t x2, gui_dim_t y2, gui_dim_t x3, gui_dim_t y3, gui_color_t color);
 void        gui_draw_filledtriangle(const gui_display_t* disp, gui_dim_t x1, gui_dim_t y1, gui_dim_t x2, gui_dim_t y2, gui_dim_t x3, gui_dim_t y3, gui_color_t color);
 void        gui_draw_image(gui_display_t* disp, gui_dim_t x, gui_dim_t y, const gui_image_desc_t* img);
+void        gui_draw_image_scaled(gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, const gui_image_desc_t* img);
 void        gui_draw_writetext(const gui_display_t* disp, const gui_font_t* font, const gui_char* str, gui_draw_font_t* draw);
+uint8_t     gui_draw_textsize(const gui_font_t* font, const gui_char* str, const gui_draw_font_t* draw, gui_dim_t* width, gui_dim_t* height);
 void        gui_draw_rectangle3d(const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_draw_3d_state_t state);
 void        gui_draw_poly(const gui_display_t* disp, const gui_draw_poly_t* points, size_t len, gui_color_t color);
+void        gui_draw_filledpoly(const gui_display_t* disp, const gui_draw_poly_t* points, size_t len, gui_color_t color);
 void        gui_draw_scrollbar_init(gui_draw_sb_t* sb);
 void        gui_draw_scrollbar(const gui_display_t* disp, gui_draw_sb_t* sb);
 
+#if !__DOXYGEN__ && defined(GUI_INTERNAL)
+void        guii_draw_font_release(const gui_font_t* font);
+uint8_t     guii_draw_image_decode(const gui_image_desc_t* img, uint8_t* dst, size_t stride);
+#if GUI_CFG_IMAGE_SCALE_CACHE
+void        guii_draw_image_release(const gui_image_desc_t* img);
+#endif /* GUI_CFG_IMAGE_SCALE_CACHE */
+#if GUI_CFG_USE_DISPLAY_LIST
+void        guii_draw_dlist_begin(gui_dlist_t* list);
+uint8_t     guii_draw_dlist_end(void);
+uint8_t     guii_draw_dlist_isrecording(void);
+void        guii_draw_dlist_replay(const gui_dlist_t* list, const gui_display_t* disp);
+#endif /* GUI_CFG_USE_DISPLAY_LIST */
+#endif /* !__DOXYGEN__ && defined(GUI_INTERNAL) */
+
 /**
  * \}
  */
@@ -0,0 +1,69 @@
+/**	
+ * \file            gui_gesture.h
+ * \brief           Touch gesture recognition
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_GESTURE_H
+#define __GUI_GESTURE_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_INPUT
+ * \defgroup        GUI_GESTURE Touch gestures
+ * \brief           Recognition of swipe and pinch gestures from raw touch samples
+ * \{
+ *
+ * Recognition runs once for every touch sample, after sample is read from input buffer
+ * and before it is processed by widgets. Recognized gesture is sent to active widget
+ * with \ref GUI_WC_Swipe or \ref GUI_WC_Pinch event, widgets do not need to derive
+ * gestures from \ref GUI_WC_TouchMove events.
+ *
+ * Thresholds are set with \ref GUI_CFG_TOUCH_SWIPE_DISTANCE, \ref GUI_CFG_TOUCH_SWIPE_VELOCITY
+ * and \ref GUI_CFG_TOUCH_PINCH_DISTANCE configuration options.
+ */
+
+#if GUI_CFG_USE_TOUCH_GESTURES || __DOXYGEN__
+gui_wc_t guii_gesture_process(guii_touch_data_t* touch, const guii_touch_data_t* old);
+#endif /* GUI_CFG_USE_TOUCH_GESTURES || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_GESTURE_H */
@@ -0,0 +1,98 @@
+/**	
+ * \file            gui_idle.h
+ * \brief           Background tasks run by GUI thread in idle time
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_IDLE_H
+#define __GUI_IDLE_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_IDLE Idle tasks
+ * \brief           Background work done by GUI thread when there is nothing to redraw
+ * \{
+ *
+ * Idle task is \ref gui_idle_task_t structure owned by user with callback doing small chunk
+ * of work per call, for example decoding part of next image or precomputing layout of next screen.
+ *
+ * Tasks run only when \ref gui_process has no widget to redraw. Higher priority tasks run first,
+ * each one for at most its own budget and all together for at most \ref GUI_CFG_IDLE_SLICE.
+ * Before every task GUI checks for waiting touch or key input, expired timers and new invalidation
+ * and returns immediately, so background work never delays response to user.
+ *
+ * \code{c}
+gui_idle_task_t decode_task;
+
+uint8_t
+decode_fn(uint32_t budget, void* arg) {
+    uint32_t start = GUI_CFG_IDLE_TIME();
+    do {
+        if (!decode_next_lines(arg)) {
+            return 0;                               //Done, task is removed
+        }
+    } while (GUI_CFG_IDLE_TIME() - start < budget);
+    return 1;                                       //Continue in next idle time
+}
+
+gui_idle_add(&decode_task, decode_fn, &image, 10, 2000);
+\endcode
+ */
+
+#if GUI_CFG_USE_IDLE_TASKS || __DOXYGEN__
+
+uint8_t         gui_idle_add(gui_idle_task_t* t, gui_idle_fn fn, void* arg, uint8_t priority, uint32_t budget);
+uint8_t         gui_idle_remove(gui_idle_task_t* t);
+
+#if defined(GUI_INTERNAL) || __DOXYGEN__
+
+uint8_t         guii_idle_add(gui_idle_task_t* t, gui_idle_fn fn, void* arg, uint8_t priority, uint32_t budget);
+uint8_t         guii_idle_remove(gui_idle_task_t* t);
+uint8_t         guii_idle_pending(void);
+uint8_t         guii_idle_process(void);
+
+#endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
+
+#endif /* GUI_CFG_USE_IDLE_TASKS || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_IDLE_H */
@@ -44,13 +44,38 @@ extern "C" {
 #include "gui/gui.h"
     
 uint8_t gui_input_touchadd(gui_touch_data_t* ts);
+uint32_t gui_input_touchoverflow(void);
+#if GUI_CFG_TOUCH_FILTER || __DOXYGEN__
+uint8_t gui_input_touchsetcalibration(const gui_touch_calibration_t* cal);
+uint8_t gui_input_touchcalibrate(const gui_dim_t* raw, const gui_dim_t* screen, gui_touch_calibration_t* cal);
+#endif /* GUI_CFG_TOUCH_FILTER || __DOXYGEN__ */
 uint8_t gui_input_keyadd(gui_keyboard_data_t* kb);
+uint32_t gui_input_keyoverflow(void);
+#if GUI_CFG_INPUT_RECORD || __DOXYGEN__
+uint8_t gui_input_recordstart(gui_input_record_t* buff, size_t len);
+size_t  gui_input_recordstop(uint32_t* overflow);
+uint8_t gui_input_replaystart(const gui_input_record_t* buff, size_t len);
+uint8_t gui_input_replaystop(void);
+uint8_t gui_input_replayisactive(void);
+#if GUI_CFG_USE_STATS || __DOXYGEN__
+uint8_t gui_input_replaygetstats(gui_stats_t* stats);
+#endif /* GUI_CFG_USE_STATS || __DOXYGEN__ */
+#endif /* GUI_CFG_INPUT_RECORD || __DOXYGEN__ */
 
 #if !__DOXYGEN__ && defined(GUI_INTERNAL)
 void gui_input_init(void);
 uint8_t gui_input_touchavailable(void);
 uint8_t gui_input_touchread(gui_touch_data_t* ts);
+uint8_t gui_input_touchpeek(gui_touch_data_t* ts);
+#if GUI_CFG_TOUCH_HISTORY_SIZE
+void    guii_input_touchhistoryadd(guii_touch_data_t* touch, const gui_touch_data_t* ts);
+uint8_t guii_input_touchvelocity(const guii_touch_data_t* touch, float* vx, float* vy);
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE */
+uint8_t gui_input_keyavailable(void);
 uint8_t gui_input_keyread(gui_keyboard_data_t* kb);
+#if GUI_CFG_INPUT_RECORD && GUI_CFG_USE_STATS
+void    guii_input_replayframe(const gui_stats_t* frame);
+#endif /* GUI_CFG_INPUT_RECORD && GUI_CFG_USE_STATS */
 #endif /* !__DOXYGEN__ && defined(GUI_INTERNAL) */
 
 /**
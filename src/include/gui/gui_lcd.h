@@ -48,6 +48,68 @@ extern "C" {
 gui_dim_t  gui_lcd_getwidth(void);
 gui_dim_t  gui_lcd_getheight(void);
 void        gui_lcd_confirmactivelayer(uint8_t layer_num);
+#if GUI_CFG_LCD_BAND || __DOXYGEN__
+void        gui_lcd_confirmflush(uint8_t band_num);
+#endif /* GUI_CFG_LCD_BAND || __DOXYGEN__ */
+#if GUI_CFG_LCD_BACKGROUND || __DOXYGEN__
+uint8_t     gui_lcd_setbackground(const gui_image_desc_t* img, gui_color_t color);
+#endif /* GUI_CFG_LCD_BACKGROUND || __DOXYGEN__ */
+#if GUI_CFG_LCD_SPLASH || __DOXYGEN__
+uint8_t     gui_lcd_setsplash(const gui_image_desc_t* img, gui_color_t color);
+#endif /* GUI_CFG_LCD_SPLASH || __DOXYGEN__ */
+#if GUI_CFG_LCD_ROTATION || __DOXYGEN__
+uint8_t     gui_lcd_setrotation(gui_lcd_rotation_t rotation);
+gui_lcd_rotation_t  gui_lcd_getrotation(void);
+#endif /* GUI_CFG_LCD_ROTATION || __DOXYGEN__ */
+#if GUI_CFG_LCD_CLUT || __DOXYGEN__
+uint8_t     gui_lcd_setpalette(const gui_color_t* colors, size_t count);
+#endif /* GUI_CFG_LCD_CLUT || __DOXYGEN__ */
+#if GUI_CFG_LCD_FRAME_CALLBACK || __DOXYGEN__
+uint8_t     gui_lcd_setframecallback(gui_lcd_frame_fn fn, void* arg);
+#endif /* GUI_CFG_LCD_FRAME_CALLBACK || __DOXYGEN__ */
+#if GUI_CFG_LCD_CAPTURE || __DOXYGEN__
+uint8_t     gui_lcd_capture(gui_lcd_capture_format_t format, gui_lcd_capture_fn fn, void* arg);
+#endif /* GUI_CFG_LCD_CAPTURE || __DOXYGEN__ */
+
+#if !__DOXYGEN__ && defined(GUI_INTERNAL)
+void        guii_lcd_setsoftwaredrawing(gui_ll_t* ll);
+#if GUI_CFG_LCD_SPLASH
+uint8_t     guii_lcd_drawsplash(void);
+#endif /* GUI_CFG_LCD_SPLASH */
+#if GUI_CFG_LCD_CLUT
+void        guii_lcd_initpalette(void);
+uint8_t     guii_lcd_colortoindex(gui_color_t color);
+#endif /* GUI_CFG_LCD_CLUT */
+#if GUI_CFG_LCD_FRAME_CALLBACK
+void        guii_lcd_framedone(const gui_layer_t* layer);
+#endif /* GUI_CFG_LCD_FRAME_CALLBACK */
+#if GUI_CFG_LCD_ROTATION
+void        guii_lcd_rotaterect(uint8_t rotation, gui_dim_t width, gui_dim_t height, gui_dim_t* x, gui_dim_t* y, gui_dim_t* w, gui_dim_t* h);
+void        guii_lcd_touchtological(gui_dim_t* x, gui_dim_t* y);
+
+/**
+ * \brief           Map rectangle on logical screen to display memory
+ * \param[in,out]   x, y: Pointers to top left position
+ * \param[in,out]   w, h: Pointers to rectangle size
+ * \hideinitializer
+ */
+#define guii_lcd_maprect(x, y, w, h)    do {                                \
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {                           \
+        guii_lcd_rotaterect(GUI.lcd.rotation, GUI.lcd.width, GUI.lcd.height, (x), (y), (w), (h));  \
+    }                                                                       \
+} while (0)
+
+/**
+ * \brief           Map pixel position on logical screen to display memory
+ * \param[in,out]   x, y: Pointers to pixel position
+ * \hideinitializer
+ */
+#define guii_lcd_mappoint(x, y)     do {                                    \
+    gui_dim_t __w = 1, __h = 1;                                             \
+    guii_lcd_maprect((x), (y), &__w, &__h);                                 \
+} while (0)
+#endif /* GUI_CFG_LCD_ROTATION */
+#endif /* !__DOXYGEN__ && defined(GUI_INTERNAL) */
 
 /**
  * \}
@@ -47,6 +47,32 @@ extern "C" {
 
 #if defined(GUI_INTERNAL) || __DOXYGEN__
 
+#if GUI_CFG_LINKEDLIST_COMPACT || __DOXYGEN__
+
+extern size_t guii_linkedlist_base;
+
+/**
+ * \brief           Get pointer to object from linked list link
+ * \param[in]       l: Link of \ref gui_linkedlist_link_t type
+ * \return          Pointer to object or `NULL` for empty link
+ * \hideinitializer
+ */
+#define GUI_LINKEDLIST_PTR(l)               ((l) ? (void *)(guii_linkedlist_base + (size_t)(l) * GUI_CFG_MEM_ALIGNMENT) : NULL)
+
+/**
+ * \brief           Get linked list link from pointer to object
+ * \note            Object must be allocated from GUI memory
+ * \param[in]       p: Pointer to object or `NULL`
+ * \return          Link of \ref gui_linkedlist_link_t type
+ * \hideinitializer
+ */
+#define GUI_LINKEDLIST_LINK(p)              ((p) != NULL ? (gui_linkedlist_link_t)(((size_t)(p) - guii_linkedlist_base) / GUI_CFG_MEM_ALIGNMENT) : 0)
+
+#else /* GUI_CFG_LINKEDLIST_COMPACT || __DOXYGEN__ */
+#define GUI_LINKEDLIST_PTR(l)               ((void *)(l))
+#define GUI_LINKEDLIST_LINK(p)              ((void *)(p))
+#endif /* !(GUI_CFG_LINKEDLIST_COMPACT || __DOXYGEN__) */
+
 /**
  * \brief           Get data from multi linked list object
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -61,6 +87,10 @@ gui_linkedlist_t*       gui_linkedlist_remove_gen(gui_linkedlistroot_t* root, gu
 gui_linkedlist_t*       gui_linkedlist_getnext_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element);
 gui_linkedlist_t*       gui_linkedlist_getprev_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element);
 gui_linkedlist_t*       gui_linkedlist_getnext_byindex_gen(gui_linkedlistroot_t* root, uint16_t index);
+gui_linkedlist_t*       gui_linkedlist_index_get(gui_linkedlistroot_t* root, gui_linkedlist_index_t* idx, size_t index);
+void                    gui_linkedlist_index_add(gui_linkedlist_index_t* idx, gui_linkedlist_t* element);
+void                    gui_linkedlist_index_invalidate(gui_linkedlist_index_t* idx);
+void                    gui_linkedlist_index_free(gui_linkedlist_index_t* idx);
 uint8_t                 gui_linkedlist_movedown_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element);
 uint8_t                 gui_linkedlist_moveup_gen(gui_linkedlistroot_t* root, gui_linkedlist_t* element);
 gui_linkedlistmulti_t*  gui_linkedlist_multi_add_gen(gui_linkedlistroot_t* root, void* element);
@@ -96,7 +126,7 @@ uint8_t                 gui_linkedlist_multi_find_remove(gui_linkedlistroot_t* r
  * \return          `1` on success, `0` otherwise
  * \hideinitializer
  */
-#define gui_linkedlist_iswidgetfirst(h)       ((h) == NULL || (__GH(h))->list.prev == NULL)
+#define gui_linkedlist_iswidgetfirst(h)       ((h) == NULL || !(__GH(h))->list.prev)
 
 /**
  * \brief           Check if widget is last child element in linked list
@@ -105,7 +135,7 @@ uint8_t                 gui_linkedlist_multi_find_remove(gui_linkedlistroot_t* r
  * \return          `1` on success, `0` otherwise
  * \hideinitializer
  */
-#define gui_linkedlist_iswidgetlast(h)        ((h) == NULL || (__GH(h))->list.next == NULL)
+#define gui_linkedlist_iswidgetlast(h)        ((h) == NULL || !(__GH(h))->list.next)
 
 void            gui_linkedlist_widgetadd(gui_handle_root_t* parent, gui_handle_p h);
 void            gui_linkedlist_widgetremove(gui_handle_p h);
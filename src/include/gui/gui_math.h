@@ -51,6 +51,8 @@ uint8_t gui_math_sqrt(float x, float* result);
 uint8_t gui_math_rsqrt(float x, float* result);
 uint8_t gui_math_distancebetweenxy(float x1, float y1, float x2, float y2, float* result);
 uint8_t gui_math_centerofxy(float x1, float y1, float x2, float y2, float* resultx, float* resulty);
+int16_t gui_math_sin(int32_t angle);
+int16_t gui_math_cos(int32_t angle);
     
 /**
  * \}
@@ -58,15 +58,222 @@ typedef struct mem_region_t {
  */
 typedef mem_region_t GUI_MEM_Region_t;
 
+/**
+ * \brief           Memory region preference for allocation
+ * \sa              gui_mem_calloc_hint
+ */
+typedef enum {
+    GUI_MEM_ANY = 0x00,                 /*!< No preference, first sufficient block is used */
+    GUI_MEM_HOT,                        /*!< Small and often used data, prefer first (fast) region */
+    GUI_MEM_BULK,                       /*!< Big buffers, prefer last (big) region */
+} gui_mem_hint_t;
+
+/**
+ * \brief           Static memory objects of pools are taken from instead of heap
+ * \note            Memory may be shared by multiple pools, it is never returned
+ * \sa              GUI_MEM_STATIC_INIT
+ */
+typedef struct gui_mem_static {
+    uint8_t* ptr;                       /*!< Pointer to first memory not yet given to pool */
+    uint8_t* end;                       /*!< Pointer to end of memory */
+} gui_mem_static_t;
+
+/**
+ * \brief           Fixed-size object pool
+ * \sa              GUI_MEM_POOL_INIT, GUI_MEM_POOL_INIT_STATIC
+ */
+typedef struct gui_mem_pool {
+    size_t size;                        /*!< Size of single object in units of bytes */
+    void* free_list;                    /*!< List of free objects ready for allocation */
+    size_t used;                        /*!< Number of objects currently allocated from pool */
+    size_t total;                       /*!< Number of objects allocated from heap or static memory for pool */
+    gui_mem_static_t* mem;              /*!< Static memory for new objects, `NULL` to allocate them from heap */
+} gui_mem_pool_t;
+
+/**
+ * \brief           Size of static memory for pool objects in units of 8-byte words
+ * \param[in]       s: Size of single object in units of bytes
+ * \param[in]       count: Number of objects
+ * \hideinitializer
+ */
+#define GUI_MEM_POOL_WORDS(s, count)    (((count) * GUI_MEM_ALIGN(GUI_MAX((s), sizeof(void *))) + 7) / 8)
+
+/**
+ * \brief           Initializer for \ref gui_mem_static_t structure
+ * \param[in]       array: Statically allocated array used as memory
+ * \hideinitializer
+ */
+#define GUI_MEM_STATIC_INIT(array)      { (uint8_t *)(array), (uint8_t *)(array) + sizeof(array) }
+
+/**
+ * \brief           Initializer for \ref gui_mem_pool_t structure
+ * \param[in]       s: Size of single object in units of bytes
+ * \hideinitializer
+ */
+#define GUI_MEM_POOL_INIT(s)            { (s), NULL, 0, 0, NULL }
+
+/**
+ * \brief           Initializer for \ref gui_mem_pool_t structure with objects in static memory
+ * \param[in]       s: Size of single object in units of bytes
+ * \param[in]       m: Pointer to \ref gui_mem_static_t structure with memory for objects
+ * \hideinitializer
+ */
+#define GUI_MEM_POOL_INIT_STATIC(s, m)  { (s), NULL, 0, 0, (m) }
+
+#if GUI_CFG_MEM_RECLAIM || __DOXYGEN__
+
+/**
+ * \brief           Callback releasing cached memory when allocation fails
+ * \note            Callback is called with GUI protection against multiple access activated
+ *                  and must not allocate memory
+ * \param[in]       size: Number of bytes of failed allocation. Callback should release at least
+ *                      this amount when possible, least valuable memory first
+ * \param[in]       arg: User argument passed on \ref gui_mem_reclaim_add
+ * \return          Number of released bytes, `0` when nothing is left to release
+ */
+typedef size_t (*gui_mem_reclaim_fn)(size_t size, void* arg);
+
+/**
+ * \brief           Memory reclaimer entry
+ * \note            Structure is owned by user and must stay valid while it is added
+ * \sa              gui_mem_reclaim_add
+ */
+typedef struct gui_mem_reclaim {
+    struct gui_mem_reclaim* next;       /*!< Next reclaimer in list */
+    gui_mem_reclaim_fn fn;              /*!< Callback function */
+    void* arg;                          /*!< User argument for callback */
+    uint8_t priority;                   /*!< Reclaimer priority, reclaimers with higher value release memory first */
+    uint8_t added;                      /*!< Set to `1` while reclaimer is in list */
+} gui_mem_reclaim_t;
+
+/**
+ * \defgroup        GUI_MEM_RECLAIM_PRIO Reclaim priorities
+ * \brief           Priorities of caches of GUI library, memory of highest one is released first
+ * \{
+ */
+#define GUI_MEM_RECLAIM_PRIO_SCREEN     40                  /*!< Pixels of hidden screens, screen is drawn again when shown */
+#define GUI_MEM_RECLAIM_PRIO_IMAGE      30                  /*!< Scaled copies of images */
+#define GUI_MEM_RECLAIM_PRIO_RETAINED   20                  /*!< Retained bitmaps, widgets are drawn normally until saved again */
+#define GUI_MEM_RECLAIM_PRIO_GLYPH      10                  /*!< Glyph cache, characters are prepared on every draw */
+/**
+ * \}
+ */
+
+#endif /* GUI_CFG_MEM_RECLAIM || __DOXYGEN__ */
+
+#if GUI_CFG_MEM_PROFILE || __DOXYGEN__
+
+/**
+ * \brief           Heap usage of single allocation tag
+ * \sa              gui_mem_gettagstats
+ */
+typedef struct {
+    const char* name;                   /*!< Tag name, widget type name or purpose of memory */
+    size_t bytes;                       /*!< Number of bytes currently allocated */
+    size_t blocks;                      /*!< Number of blocks currently allocated */
+    size_t peak;                        /*!< Maximal number of bytes allocated at the same time */
+} gui_mem_tagstat_t;
+
+/**
+ * \brief           Output function for heap report
+ * \param[in]       str: Line of report
+ * \param[in]       arg: User argument
+ */
+typedef void (*gui_mem_output_fn)(const char* str, void* arg);
+
+size_t gui_mem_gettagstats(gui_mem_tagstat_t* stats, size_t count);
+uint8_t gui_mem_report(gui_mem_output_fn out, void* arg);
+
+#endif /* GUI_CFG_MEM_PROFILE || __DOXYGEN__ */
+
+#if defined(GUI_INTERNAL) || __DOXYGEN__
+
+/**
+ * \defgroup        GUI_MEM_TAGS Allocation tags
+ * \brief           Names of memory purposes for heap profiler
+ * \{
+ */
+#define GUI_MEM_TAG_OTHER               "other"             /*!< Allocation without tag */
+#define GUI_MEM_TAG_TEXT                "text"              /*!< Widget text buffer */
+#define GUI_MEM_TAG_WIDGET_EXT          "widget extension"  /*!< Rarely used values of widget */
+#define GUI_MEM_TAG_TEXTLAYOUT          "text layout"       /*!< Cached text layout */
+#define GUI_MEM_TAG_GLYPH               "glyph cache"       /*!< Font character cache entry */
+#define GUI_MEM_TAG_TEXT_STRIP          "text strip"        /*!< Text line composed before blending */
+#define GUI_MEM_TAG_IMAGE               "image buffer"      /*!< Decoded lines of compressed images */
+#define GUI_MEM_TAG_IMAGE_SCALED        "scaled image"      /*!< Cached pixels of scaled image */
+#define GUI_MEM_TAG_IMAGE_ANIM          "animated image"    /*!< Current frame of animated image */
+#define GUI_MEM_TAG_LISTVIEW_ROW        "listview row"      /*!< Listview row or item */
+#define GUI_MEM_TAG_LISTVIEW_SORT       "listview sort"     /*!< Sorted order of listview rows */
+#define GUI_MEM_TAG_LIST_FILTER         "list filter"       /*!< Entries of list widget matching filter */
+#define GUI_MEM_TAG_LAYER               "transparency layer"/*!< Scratch memory of temporary transparency layers */
+#define GUI_MEM_TAG_GRAPH_BG            "graph background"  /*!< Cached background and grid of graph widget */
+#define GUI_MEM_TAG_GAUGE_DIAL          "gauge dial"        /*!< Cached dial face of gauge widget */
+#define GUI_MEM_TAG_RETAINED            "retained bitmap"   /*!< Retained bitmap of widget */
+#define GUI_MEM_TAG_INSTANCE            "instance bitmap"   /*!< Bitmap shared by identical instanced widgets */
+#define GUI_MEM_TAG_STATE               "state bitmap"      /*!< Visual state of checkbox, radio or LED widgets */
+#define GUI_MEM_TAG_DISPLAY_LIST        "display list"      /*!< Recorded drawing commands of widget */
+#define GUI_MEM_TAG_SAVE_UNDER          "save under"        /*!< Pixels below popup widget */
+#define GUI_MEM_TAG_SPRITE              "sprite"            /*!< Pixels below sprite */
+#define GUI_MEM_TAG_TRANSITION          "transition"        /*!< Pixels of old and new screen during transition */
+#define GUI_MEM_TAG_SCREEN              "screen cache"      /*!< Pixels of hidden screen on screen stack */
+#define GUI_MEM_TAG_STREAM              "streamed image"    /*!< Pixels of image streamed from file */
+#define GUI_MEM_TAG_TIMER               "timer"             /*!< Software timer */
+#define GUI_MEM_TAG_WIDGET_TREE         "widget tree"       /*!< Handles of widgets created from tree description */
+#define GUI_MEM_TAG_WIDGET_ARENA        "widget arena"      /*!< Handles of widgets inside window */
+#define GUI_MEM_TAG_TOUCH               "touch index"       /*!< Touch hit-test index */
+
+/**
+ * \}
+ */
+
+#if GUI_CFG_MEM_PROFILE || __DOXYGEN__
+const char* guii_mem_settag(const char* tag);
+
+/**
+ * \brief           Execute expression with allocations tagged with specific tag
+ * \param[in]       tag: Tag name, one of \ref GUI_MEM_TAGS or widget type name
+ * \param[in]       expr: Expression, usually assignment of allocated memory
+ * \hideinitializer
+ */
+#define GUI_MEM_TAGGED(tag, expr)       do {                        \
+    const char* __prev_tag = guii_mem_settag(tag);                  \
+    expr;                                                           \
+    guii_mem_settag(__prev_tag);                                    \
+} while (0)
+#else
+#define GUI_MEM_TAGGED(tag, expr)       do { expr; } while (0)
+#endif /* GUI_CFG_MEM_PROFILE || __DOXYGEN__ */
+
+#endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
+
 void* gui_mem_alloc(uint32_t size);
 void* gui_mem_realloc(void* ptr, size_t size);
 void* gui_mem_calloc(size_t num, size_t size);
+void* gui_mem_alloc_hint(size_t size, gui_mem_hint_t hint);
+void* gui_mem_calloc_hint(size_t num, size_t size, gui_mem_hint_t hint);
 void gui_mem_free(void* ptr);
 size_t gui_mem_getfree(void);
 size_t gui_mem_getfull(void);
 size_t gui_mem_getminfree(void);
+uint8_t gui_mem_getfragmentation(void);
+size_t gui_mem_getlargestfree(void);
+void gui_mem_getreallocstats(size_t* total, size_t* inplace);
 
+#if GUI_CFG_MEM_RELOC || __DOXYGEN__
+uint8_t gui_mem_setmovable(void** ref);
+void gui_mem_setfixed(void* ptr);
+size_t gui_mem_compact(size_t max);
+#endif /* GUI_CFG_MEM_RELOC || __DOXYGEN__ */
+
+
+#if GUI_CFG_MEM_RECLAIM || __DOXYGEN__
+uint8_t gui_mem_reclaim_add(gui_mem_reclaim_t* r, gui_mem_reclaim_fn fn, void* arg, uint8_t priority);
+uint8_t gui_mem_reclaim_remove(gui_mem_reclaim_t* r);
+#endif /* GUI_CFG_MEM_RECLAIM || __DOXYGEN__ */
 uint8_t gui_mem_assignmemory(const GUI_MEM_Region_t* regions, size_t size);
+
+void* gui_mem_pool_alloc(gui_mem_pool_t* pool);
+void gui_mem_pool_free(gui_mem_pool_t* pool, void* ptr);
     
 /**
  * \}
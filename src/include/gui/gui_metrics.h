@@ -0,0 +1,86 @@
+/**	
+ * \file            gui_metrics.h
+ * \brief           Metrics snapshot for remote monitoring
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_METRICS_H
+#define __GUI_METRICS_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_METRICS Metrics
+ * \brief           Performance counters published for remote monitoring
+ * \{
+ *
+ * GUI thread collects counters of every redrawn frame and publishes their snapshot
+ * every \ref GUI_CFG_METRICS_PERIOD milliseconds.
+ * Snapshot is read without GUI protection, so thread answering network requests
+ * never waits for GUI thread to finish redraw.
+ *
+ * \sa              GUI_CFG_USE_METRICS
+ */
+
+#if GUI_CFG_USE_METRICS || __DOXYGEN__
+
+/**
+ * \brief           Output function for metrics report
+ * \param[in]       str: Line of report
+ * \param[in]       arg: User argument
+ */
+typedef void (*gui_metrics_output_fn)(const char* str, void* arg);
+
+uint8_t     gui_metrics_get(gui_metrics_t* m);
+uint8_t     gui_metrics_report(gui_metrics_output_fn out, void* arg);
+
+#if defined(GUI_INTERNAL) || __DOXYGEN__
+
+void        guii_metrics_frame(const gui_stats_t* frame);
+void        guii_metrics_process(void);
+
+#endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
+
+#endif /* GUI_CFG_USE_METRICS || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_METRICS_H */
@@ -53,6 +53,7 @@ extern "C" {
 #define GUI_SYS_MBOX_TYPE_TIMER             0x04
 #define GUI_SYS_MBOX_TYPE_WIDGET_CREATED    0x05
 #define GUI_SYS_MBOX_TYPE_INVALIDATE        0x06
+#define GUI_SYS_MBOX_TYPE_WIDGET_POST       0x07
 
 /**
  * \brief           Message box data type
@@ -67,9 +68,111 @@ typedef struct {
 typedef struct {
     gui_sys_thread_t thread_id;             /*!< GUI thread ID */
     gui_sys_mbox_t mbox;                    /*!< Operating system message box */
+    volatile uint8_t wakeup_pending;        /*!< Set to `1` when message to wake up GUI thread is already in message box */
+    gui_sys_thread_t batch_thread_id;       /*!< Thread doing batched widget updates */
+#if GUI_CFG_WIDGET_POST_QUEUE_SIZE
+    gui_sys_mutex_t post_mutex;             /*!< Mutex protecting only queue of posted widget parameters */
+#endif /* GUI_CFG_WIDGET_POST_QUEUE_SIZE */
+#if GUI_CFG_OS_RENDER_THREAD
+    gui_sys_thread_t render_thread_id;      /*!< Rasterizer thread ID */
+    gui_sys_mbox_t render_mbox;             /*!< Message box with recorded frames for rasterizer thread */
+    gui_sys_sem_t render_sem;               /*!< Semaphore released when layer of previous frame is shown */
+#endif /* GUI_CFG_OS_RENDER_THREAD */
 } GUI_OS_t;
 #endif /* GUI_CFG_OS */
 
+#if GUI_CFG_OS_RENDER_THREAD || __DOXYGEN__
+/**
+ * \brief           Frame recorded by GUI thread and drawn by rasterizer thread
+ */
+typedef struct {
+    gui_dlist_t list;                       /*!< Drawing commands of all dirty regions */
+    gui_display_t rects[GUI_CFG_DISPLAY_DIRTY_RECTS];   /*!< Dirty regions of frame */
+    size_t rects_count;                     /*!< Number of valid entries in \ref rects */
+    gui_display_t copy[GUI_CFG_DISPLAY_DIRTY_RECTS];    /*!< Regions of previous frame copied from active layer first */
+    size_t copy_count;                      /*!< Number of valid entries in \ref copy */
+    gui_layer_t* layer;                     /*!< Layer to draw to, `NULL` for drawing layer with layer swap after frame */
+    volatile uint8_t busy;                  /*!< Set to `1` until rasterizer thread finishes frame */
+} gui_frame_t;
+#endif /* GUI_CFG_OS_RENDER_THREAD || __DOXYGEN__ */
+
+#if (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1) || __DOXYGEN__
+/**
+ * \brief           Tiles of one frame shared between cores
+ * \note            Fields are changed only when lock between cores is taken
+ */
+typedef struct {
+    gui_dlist_t list;                       /*!< Drawing commands of all dirty regions */
+    gui_display_t rects[GUI_CFG_DISPLAY_DIRTY_RECTS];   /*!< Dirty regions of frame */
+    size_t rects_count;                     /*!< Number of valid entries in \ref rects */
+    gui_layer_t layer;                      /*!< Drawing layer tiles are copied to */
+    uint32_t count;                         /*!< Number of tiles in all dirty regions */
+    uint32_t next;                          /*!< Index of next tile to draw */
+    volatile uint32_t done;                 /*!< Number of tiles copied to drawing layer */
+} gui_tile_job_t;
+#endif /* (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1) || __DOXYGEN__ */
+
+#if (GUI_CFG_USE_TOUCH && GUI_CFG_TOUCH_INDEX_GRID) || __DOXYGEN__
+/**
+ * \brief           Visible widget entry in touch hit-test index
+ */
+typedef struct {
+    gui_handle_p h;                         /*!< Widget handle */
+    gui_dim_t x1;                           /*!< Clipped top left X position on screen */
+    gui_dim_t y1;                           /*!< Clipped top left Y position on screen */
+    gui_dim_t x2;                           /*!< Clipped bottom right X position on screen */
+    gui_dim_t y2;                           /*!< Clipped bottom right Y position on screen */
+    uint8_t keyboard;                       /*!< Set to `1` when widget is part of keyboard */
+} gui_touch_index_entry_t;
+
+/**
+ * \brief           Touch hit-test index
+ * \note            Entries are ordered from most to least visible widget
+ */
+typedef struct {
+    gui_touch_index_entry_t* entries;       /*!< List of visible widgets */
+    size_t count;                           /*!< Number of valid entries */
+    size_t size;                            /*!< Number of allocated entries */
+    uint16_t* items;                        /*!< Entry indexes, grouped by grid cells */
+    size_t items_size;                      /*!< Number of allocated entry indexes */
+    uint16_t cells[GUI_CFG_TOUCH_INDEX_GRID * GUI_CFG_TOUCH_INDEX_GRID + 1];  /*!< Start of each cell in \ref items */
+    uint32_t geometry_gen;                  /*!< Geometry generation index was built for */
+    uint32_t tree_gen;                      /*!< Tree generation index was built for */
+    uint8_t valid;                          /*!< Set to `1` when index was built successfully */
+} gui_touch_index_t;
+#endif /* (GUI_CFG_USE_TOUCH && GUI_CFG_TOUCH_INDEX_GRID) || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE || __DOXYGEN__
+/**
+ * \brief           Scroll operation of widget content waiting for redraw
+ */
+typedef struct {
+    gui_handle_p h;                         /*!< Widget handle */
+    gui_display_t area;                     /*!< Scrolled area, relative to widget until processed, absolute on screen afterwards */
+    gui_dim_t dx;                           /*!< Number of pixels content moved left (positive) or right (negative) */
+    gui_dim_t dy;                           /*!< Number of pixels content moved up (positive) or down (negative) */
+    uint8_t children;                       /*!< Set to `1` when children widgets move together with content */
+} gui_widget_scroll_t;
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE || __DOXYGEN__ */
+
+#if GUI_CFG_STATS_LATENCY || __DOXYGEN__
+/**
+ * \brief           Input-to-display latency measurement
+ */
+typedef struct {
+    uint32_t input_time;                    /*!< Time of oldest touch sample with result not drawn yet */
+    uint8_t input_valid;                    /*!< Set to `1` when \ref input_time is valid */
+    uint32_t shown_time;                    /*!< Time of touch sample drawn to layer waiting to be shown */
+    uint32_t shown_frame;                   /*!< Number of frame drawn to layer waiting to be shown */
+    volatile uint8_t shown_valid;           /*!< Set to `1` until display confirms layer of \ref shown_frame */
+    volatile uint32_t confirmed;            /*!< Latency measured by display confirmation, not added to samples yet */
+    volatile uint8_t confirmed_valid;       /*!< Set to `1` when \ref confirmed is valid */
+    uint32_t frame;                         /*!< Number of frame with result of last measured input */
+    uint32_t count;                         /*!< Number of measured inputs */
+    uint32_t samples[GUI_CFG_STATS_LATENCY_SAMPLES];    /*!< Latencies of last measured inputs */
+} gui_latency_t;
+#endif /* GUI_CFG_STATS_LATENCY || __DOXYGEN__ */
+
 /**
  * \brief           GUI main object structure
  */
@@ -79,17 +182,67 @@ typedef struct {
     
     uint32_t flags;                         /*!< Core GUI flags management */
     
-    gui_display_t Display;                  /*!< Clipping management */
+    gui_display_t Display;                  /*!< Clipping region currently being redrawn */
     gui_display_t DisplayTemp;              /*!< Clipping for widgets for drawing and touch */
+    gui_display_t DirtyRects[GUI_CFG_DISPLAY_DIRTY_RECTS];  /*!< List of invalidated regions waiting for redraw */
+    size_t DirtyRectsCount;                 /*!< Number of valid entries in \ref DirtyRects */
+    gui_handle_p InvalidateList[GUI_CFG_WIDGET_INVALIDATE_QUEUE_SIZE];  /*!< Widgets waiting for invalidation to be resolved */
+    size_t InvalidateListCount;             /*!< Number of valid entries in \ref InvalidateList */
+    uint32_t BatchLevel;                    /*!< Nesting level of batched widget updates */
+#if GUI_CFG_IDLE_TIMEOUT || __DOXYGEN__
+    uint32_t IdleTime;                      /*!< Time of last invalidation or input */
+    uint8_t PowerDown;                      /*!< Set to `1` when display is powered down */
+    uint8_t IdleTouchIgnore;                /*!< Set to `1` to ignore touches until release of waking touch */
+#endif /* GUI_CFG_IDLE_TIMEOUT || __DOXYGEN__ */
+#if GUI_CFG_FRAME_PERIOD || __DOXYGEN__
+    uint32_t FrameTime;                     /*!< Time when last redraw started */
+    uint32_t FramePeriod;                   /*!< Current minimal time between 2 redraws */
+    uint32_t FramePeriodMin;                /*!< Frame period when redraw is fast */
+    uint32_t FramePeriodMax;                /*!< Frame period limit when redraw is slow */
+#endif /* GUI_CFG_FRAME_PERIOD || __DOXYGEN__ */
+    gui_display_t BatchRect;                /*!< Combined area invalidated during batched widget updates */
     
     gui_handle_p WindowActive;              /*!< Pointer to currently active window when creating new widgets */
     gui_handle_p FocusedWidget;             /*!< Pointer to focused widget for keyboard events if any */
     gui_handle_p FocusedWidgetPrev;         /*!< Pointer to previously focused widget */
+#if GUI_CFG_WIDGET_ID_HASH_SIZE || __DOXYGEN__
+    gui_handle_p WidgetIdHash[GUI_CFG_WIDGET_ID_HASH_SIZE]; /*!< Hash buckets of widgets for lookup by ID */
+#endif /* GUI_CFG_WIDGET_ID_HASH_SIZE || __DOXYGEN__ */
+    gui_handle_p RemoveQueue;               /*!< First widget waiting to be removed, see \ref guii_widget_executeremove */
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE || __DOXYGEN__
+    gui_widget_scroll_t ScrollList[GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE];   /*!< Scroll operations waiting for redraw */
+    size_t ScrollCount;                     /*!< Number of valid entries in \ref ScrollList */
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE || __DOXYGEN__ */
     
     gui_linkedlistroot_t root;              /*!< Root linked list of widgets */
+    uint32_t GeometryGen;                   /*!< Geometry generation, increased on any widget position, size, padding or scroll change */
+    uint32_t TreeGen;                       /*!< Tree generation, increased on any widget add, remove, order or visibility change */
+#if GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__
+    uint32_t LayoutGen;                     /*!< Geometry generation last layout pass was done for */
+#endif /* GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__ */
     gui_timer_core_t timers;                /*!< Software structure management */
+    gui_anim_core_t anim;                   /*!< Animation scheduler */
+#if GUI_CFG_USE_TRANSITION || __DOXYGEN__
+    gui_transition_core_t transition;       /*!< Screen transition */
+#endif /* GUI_CFG_USE_TRANSITION || __DOXYGEN__ */
+#if GUI_CFG_SCREEN_STACK || __DOXYGEN__
+    gui_screen_core_t screen;               /*!< Screen stack */
+#endif /* GUI_CFG_SCREEN_STACK || __DOXYGEN__ */
     
-    gui_linkedlistroot_t RootFonts;         /*!< Root linked list of font widgets */
+#if GUI_CFG_USE_STATS || __DOXYGEN__
+    gui_stats_t Stats;                      /*!< Statistics of last redrawn frame */
+    gui_stats_t StatsFrame;                 /*!< Statistics of frame currently being processed */
+#endif /* GUI_CFG_USE_STATS || __DOXYGEN__ */
+#if GUI_CFG_STATS_LATENCY || __DOXYGEN__
+    gui_latency_t Latency;                  /*!< Input-to-display latency measurement */
+#endif /* GUI_CFG_STATS_LATENCY || __DOXYGEN__ */
+#if GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__
+    uint8_t Overlay;                        /*!< Set to `1` when debug overlay is turned on */
+    uint8_t OverlayPass;                    /*!< Set to `1` when redraw is caused by overlay itself */
+    size_t OverlayFrame;                    /*!< Index of slot in \ref OverlayRects used by last frame */
+    gui_display_t OverlayRects[GUI_CFG_DEBUG_OVERLAY_FRAMES][GUI_CFG_DISPLAY_DIRTY_RECTS];  /*!< Redrawn regions of last frames */
+    size_t OverlayRectsCount[GUI_CFG_DEBUG_OVERLAY_FRAMES]; /*!< Number of valid regions of each frame */
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY || __DOXYGEN__ */
     
     gui_widget_param_t WidgetParam;
     gui_widget_result_t WidgetResult;
@@ -99,12 +252,58 @@ typedef struct {
     guii_touch_data_t Touch;                /*!< Current touch data and processing tool */
     gui_handle_p ActiveWidget;              /*!< Pointer to widget currently active by touch */
     gui_handle_p ActiveWidgetPrev;          /*!< Previously active widget */
+#if GUI_CFG_TOUCH_INDEX_GRID || __DOXYGEN__
+    gui_touch_index_t TouchIndex;           /*!< Hit-test index of visible widgets */
+#endif /* GUI_CFG_TOUCH_INDEX_GRID || __DOXYGEN__ */
+#if GUI_CFG_TOUCH_POINTERS || __DOXYGEN__
+    guii_touch_pointer_t TouchPointers[GUI_CFG_TOUCH_MAX_PRESSES - 1];  /*!< Pointers split from first touch */
+    uint8_t TouchPointersPressed;           /*!< Number of pressed pointers in \ref TouchPointers */
+#endif /* GUI_CFG_TOUCH_POINTERS || __DOXYGEN__ */
+    gui_timer_t* TouchTimer;                /*!< One-shot timer armed for next long press or double click deadline */
+    uint32_t TouchDeadline;                 /*!< Absolute time \ref TouchTimer is armed for */
+    uint8_t TouchTimerArmed;                /*!< Set when \ref TouchTimer is waiting for \ref TouchDeadline */
+    uint8_t TouchTimeout;                   /*!< Set by \ref TouchTimer when touch threads must check timeouts */
 #endif /* GUI_CFG_USE_TOUCH */
 
+#if GUI_CFG_USE_TRANSPARENCY || __DOXYGEN__
+    uint8_t* Scratch;                       /*!< Scratch memory for temporary transparency layers */
+    size_t ScratchSize;                     /*!< Size of scratch memory in units of bytes */
+    size_t ScratchUsed;                     /*!< Number of bytes currently used in scratch memory */
+    size_t ScratchPeak;                     /*!< Maximal number of bytes required at the same time */
+    gui_layer_t LayerStack[GUI_CFG_TRANSPARENCY_LAYERS];  /*!< Stack of temporary layers for transparent widgets */
+    size_t LayerStackDepth;                 /*!< Number of temporary layers currently in use */
+    gui_layer_t* LayerStackBase;            /*!< Drawing layer below first temporary layer */
+#endif /* GUI_CFG_USE_TRANSPARENCY || __DOXYGEN__ */
+    
+#if GUI_CFG_LCD_BAND || __DOXYGEN__
+    gui_layer_t Band[2];                    /*!< Band buffers, one is drawn while other is sent to display */
+    uint8_t BandIdx;                        /*!< Index of band buffer used for next band */
+#endif /* GUI_CFG_LCD_BAND || __DOXYGEN__ */
+    
+#if GUI_CFG_OS_RENDER_THREAD || __DOXYGEN__
+    gui_frame_t Frames[2];                  /*!< Frames alternately recorded by GUI thread and drawn by rasterizer thread */
+    uint8_t FrameIdx;                       /*!< Index of frame recorded next */
+#if GUI_CFG_LCD_BACKGROUND || __DOXYGEN__
+    gui_frame_t BackgroundFrame;            /*!< Recorded drawing of background layer */
+#endif /* GUI_CFG_LCD_BACKGROUND || __DOXYGEN__ */
+#endif /* GUI_CFG_OS_RENDER_THREAD || __DOXYGEN__ */
+    
+#if GUI_CFG_LCD_TILE || __DOXYGEN__
+    gui_layer_t Tile;                       /*!< Tile buffer widgets are drawn to before copy to drawing layer */
+#endif /* GUI_CFG_LCD_TILE || __DOXYGEN__ */
+#if GUI_CFG_LCD_FRAME_CALLBACK || __DOXYGEN__
+    gui_lcd_frame_fn FrameCallback;         /*!< Callback with changed regions of each drawn frame */
+    void* FrameCallbackArg;                 /*!< User argument of frame callback */
+#endif /* GUI_CFG_LCD_FRAME_CALLBACK || __DOXYGEN__ */
+    
 #if GUI_CFG_USE_TRANSLATE
     gui_translate_t translate;              /*!< Translation management structure */
 #endif /* GUI_CFG_USE_TRANSLATE */
     
+#if GUI_CFG_USE_ASSETS
+    gui_assets_t assets;                    /*!< Asset bank management structure */
+#endif /* GUI_CFG_USE_ASSETS */
+    
 #if GUI_CFG_OS
     GUI_OS_t OS;                            /*!< Operating system dependant structure */
 #endif /* GUI_CFG_OS */
@@ -114,7 +313,164 @@ typedef struct {
     uint8_t Initialized;                    /*!< Status indicating GUI is initialized */
 } gui_t;
 
+/**
+ * \brief           Wait low-level to finish all queued drawing operations
+ * \note            Time spent in waiting is added to statistics when \ref GUI_CFG_USE_STATS is enabled
+ *                  and traced when \ref GUI_CFG_USE_TRACE is enabled
+ * \hideinitializer
+ */
+#if GUI_CFG_USE_STATS || __DOXYGEN__
+#define guii_ll_waitready()         do {                                    \
+    uint32_t __t = GUI_CFG_STATS_TIME();                                    \
+    guii_trace_begin(GUI_TRACE_TYPE_WAIT, 0, NULL, 0);                      \
+    while (!GUI_LL(IsReady)(&GUI.lcd));                                     \
+    guii_trace_end(GUI_TRACE_TYPE_WAIT, 0, NULL, 0);                        \
+    GUI.StatsFrame.time_wait += GUI_CFG_STATS_TIME() - __t;                 \
+} while (0)
+#else
+#define guii_ll_waitready()         do {                                    \
+    guii_trace_begin(GUI_TRACE_TYPE_WAIT, 0, NULL, 0);                      \
+    while (!GUI_LL(IsReady)(&GUI.lcd));                                     \
+    guii_trace_end(GUI_TRACE_TYPE_WAIT, 0, NULL, 0);                        \
+} while (0)
+#endif /* GUI_CFG_USE_STATS || __DOXYGEN__ */
+
+#if GUI_CFG_INSTANCES > 1 || __DOXYGEN__
+extern gui_t guii_instances[GUI_CFG_INSTANCES];
+extern gui_t* guii_instance;
+
+/**
+ * \brief           Instance of GUI currently processed
+ * \hideinitializer
+ */
+#define GUI                         (*guii_instance)
+
+/**
+ * \brief           Check if current instance is the first one, which owns input devices, sprites and idle tasks
+ * \hideinitializer
+ */
+#define guii_instance_isfirst()     (guii_instance == &guii_instances[0])
+#else /* GUI_CFG_INSTANCES > 1 || __DOXYGEN__ */
 extern gui_t GUI;
+#define guii_instance_isfirst()     1
+#endif /* !(GUI_CFG_INSTANCES > 1 || __DOXYGEN__) */
+
+#if GUI_CFG_LL_STATIC
+#include GUI_CFG_LL_STATIC_HEADER
+#endif /* GUI_CFG_LL_STATIC */
+
+/**
+ * \brief           Get low-level drawing function to call
+ * \note            Function is bound directly when mapped by \ref GUI_CFG_LL_STATIC_HEADER,
+ *                  otherwise it is called through \ref gui_ll_t structure
+ * \param[in]       fn: Function name as member of \ref gui_ll_t structure
+ * \hideinitializer
+ */
+#define GUI_LL(fn)                  GUI_LL_ ## fn
+
+/**
+ * \brief           Check if low-level drawing function is implemented
+ * \param[in]       fn: Function name as member of \ref gui_ll_t structure
+ * \hideinitializer
+ */
+#define GUI_LL_HAS(fn)              GUI_LL_HAS_ ## fn
+
+#ifdef GUI_LL_IsReady
+#define GUI_LL_HAS_IsReady                  1
+#else
+#define GUI_LL_IsReady                      GUI.ll.IsReady
+#define GUI_LL_HAS_IsReady                  (GUI.ll.IsReady != NULL)
+#endif
+#ifdef GUI_LL_SetPixel
+#define GUI_LL_HAS_SetPixel                 1
+#else
+#define GUI_LL_SetPixel                     GUI.ll.SetPixel
+#define GUI_LL_HAS_SetPixel                 (GUI.ll.SetPixel != NULL)
+#endif
+#ifdef GUI_LL_GetPixel
+#define GUI_LL_HAS_GetPixel                 1
+#else
+#define GUI_LL_GetPixel                     GUI.ll.GetPixel
+#define GUI_LL_HAS_GetPixel                 (GUI.ll.GetPixel != NULL)
+#endif
+#ifdef GUI_LL_Fill
+#define GUI_LL_HAS_Fill                     1
+#else
+#define GUI_LL_Fill                         GUI.ll.Fill
+#define GUI_LL_HAS_Fill                     (GUI.ll.Fill != NULL)
+#endif
+#ifdef GUI_LL_FillRect
+#define GUI_LL_HAS_FillRect                 1
+#else
+#define GUI_LL_FillRect                     GUI.ll.FillRect
+#define GUI_LL_HAS_FillRect                 (GUI.ll.FillRect != NULL)
+#endif
+#ifdef GUI_LL_FillRects
+#define GUI_LL_HAS_FillRects                1
+#else
+#define GUI_LL_FillRects                    GUI.ll.FillRects
+#define GUI_LL_HAS_FillRects                (GUI.ll.FillRects != NULL)
+#endif
+#ifdef GUI_LL_FillGradient
+#define GUI_LL_HAS_FillGradient             1
+#else
+#define GUI_LL_FillGradient                 GUI.ll.FillGradient
+#define GUI_LL_HAS_FillGradient             (GUI.ll.FillGradient != NULL)
+#endif
+#ifdef GUI_LL_DrawHLine
+#define GUI_LL_HAS_DrawHLine                1
+#else
+#define GUI_LL_DrawHLine                    GUI.ll.DrawHLine
+#define GUI_LL_HAS_DrawHLine                (GUI.ll.DrawHLine != NULL)
+#endif
+#ifdef GUI_LL_DrawVLine
+#define GUI_LL_HAS_DrawVLine                1
+#else
+#define GUI_LL_DrawVLine                    GUI.ll.DrawVLine
+#define GUI_LL_HAS_DrawVLine                (GUI.ll.DrawVLine != NULL)
+#endif
+#ifdef GUI_LL_DrawImage16
+#define GUI_LL_HAS_DrawImage16              1
+#else
+#define GUI_LL_DrawImage16                  GUI.ll.DrawImage16
+#define GUI_LL_HAS_DrawImage16              (GUI.ll.DrawImage16 != NULL)
+#endif
+#ifdef GUI_LL_DrawImage24
+#define GUI_LL_HAS_DrawImage24              1
+#else
+#define GUI_LL_DrawImage24                  GUI.ll.DrawImage24
+#define GUI_LL_HAS_DrawImage24              (GUI.ll.DrawImage24 != NULL)
+#endif
+#ifdef GUI_LL_DrawImage32
+#define GUI_LL_HAS_DrawImage32              1
+#else
+#define GUI_LL_DrawImage32                  GUI.ll.DrawImage32
+#define GUI_LL_HAS_DrawImage32              (GUI.ll.DrawImage32 != NULL)
+#endif
+#ifdef GUI_LL_DrawImageIndexed
+#define GUI_LL_HAS_DrawImageIndexed         1
+#else
+#define GUI_LL_DrawImageIndexed             GUI.ll.DrawImageIndexed
+#define GUI_LL_HAS_DrawImageIndexed         (GUI.ll.DrawImageIndexed != NULL)
+#endif
+#ifdef GUI_LL_DrawJPEG
+#define GUI_LL_HAS_DrawJPEG                 1
+#else
+#define GUI_LL_DrawJPEG                     GUI.ll.DrawJPEG
+#define GUI_LL_HAS_DrawJPEG                 (GUI.ll.DrawJPEG != NULL)
+#endif
+#ifdef GUI_LL_CopyChar
+#define GUI_LL_HAS_CopyChar                 1
+#else
+#define GUI_LL_CopyChar                     GUI.ll.CopyChar
+#define GUI_LL_HAS_CopyChar                 (GUI.ll.CopyChar != NULL)
+#endif
+#ifdef GUI_LL_BlendHLine
+#define GUI_LL_HAS_BlendHLine               1
+#else
+#define GUI_LL_BlendHLine                   GUI.ll.BlendHLine
+#define GUI_LL_HAS_BlendHLine               (GUI.ll.BlendHLine != NULL)
+#endif
 
 /**
  * \brief           Check if 2 rectangle objects covers each other in any way
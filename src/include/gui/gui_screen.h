@@ -0,0 +1,88 @@
+/**	
+ * \file            gui_screen.h
+ * \brief           Stack of screens with cached pixels
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_SCREEN_H
+#define __GUI_SCREEN_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_SCREEN Screen stack
+ * \brief           Navigation between screens with pixels of hidden screens kept in RAM
+ * \{
+ *
+ * Screen is a widget (usually container or window) covering part of display.
+ * When new screen is pushed, pixels of screen it hides are copied from display memory
+ * and changes of its widgets are recorded while it is hidden.
+ * When screen is popped, previous screen is copied back to display
+ * and only areas changed meanwhile are drawn again by widgets.
+ *
+ * Pixels are kept only for opaque screens fully visible on display.
+ * When pixels are not available or memory budget is exceeded,
+ * previous screen is drawn again completely, like it is shown with \ref gui_widget_show.
+ *
+ * \note            Pixels require \ref gui_ll_t.Copy function
+ * \sa              GUI_CFG_SCREEN_STACK, GUI_CFG_SCREEN_CACHE_SIZE
+ */
+
+#if GUI_CFG_SCREEN_STACK || __DOXYGEN__
+
+uint8_t         gui_screen_push(gui_handle_p h);
+uint8_t         gui_screen_pop(void);
+gui_handle_p    gui_screen_gettop(void);
+
+#if defined(GUI_INTERNAL) || __DOXYGEN__
+
+void            guii_screen_invalidated(gui_handle_p h);
+void            guii_screen_remove(gui_handle_p h);
+void            guii_screen_draw(gui_layer_t* dst);
+void            guii_screen_drawdone(gui_layer_t* dst);
+
+#endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
+
+#endif /* GUI_CFG_SCREEN_STACK || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_SCREEN_H */
@@ -0,0 +1,86 @@
+/**	
+ * \file            gui_sprite.h
+ * \brief           Sprites composited over widgets
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_SPRITE_H
+#define __GUI_SPRITE_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_SPRITE Sprites
+ * \brief           Small images drawn over widgets, like cursors and drag feedback
+ * \{
+ *
+ * Sprites are drawn on drawing layer after all widgets of frame are drawn.
+ * Pixels below sprite are saved before it is drawn and copied back on next frame,
+ * so moving, showing or hiding sprite costs two small memory copies
+ * and widgets below sprite are not drawn again.
+ *
+ * Sprite is filled rectangle (text cursor) or image with optional alpha channel.
+ * Position is absolute position on screen in units of pixels.
+ *
+ * \note            Sprites require \ref gui_ll_t.Copy function and are not available
+ *                  with \ref GUI_CFG_LCD_BAND and \ref GUI_CFG_OS_RENDER_THREAD
+ */
+
+#if GUI_CFG_SPRITE_COUNT || __DOXYGEN__
+
+gui_sprite_p    gui_sprite_create(const gui_image_desc_t* img);
+gui_sprite_p    gui_sprite_createfilled(gui_dim_t width, gui_dim_t height, gui_color_t color);
+uint8_t         gui_sprite_setposition(gui_sprite_p s, gui_dim_t x, gui_dim_t y);
+uint8_t         gui_sprite_setvisible(gui_sprite_p s, uint8_t visible);
+uint8_t         gui_sprite_remove(gui_sprite_p s);
+
+#if defined(GUI_INTERNAL) || __DOXYGEN__
+
+void            guii_sprite_restore(gui_layer_t* dst);
+void            guii_sprite_draw(gui_layer_t* dst);
+uint8_t         guii_sprite_isactive(void);
+
+#endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
+
+#endif /* GUI_CFG_SPRITE_COUNT || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_SPRITE_H */
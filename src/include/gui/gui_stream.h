@@ -0,0 +1,94 @@
+/**	
+ * \file            gui_stream.h
+ * \brief           Images streamed from file system
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_STREAM_H
+#define __GUI_STREAM_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_STREAM Image streaming
+ * \brief           Images loaded from file system to RAM without blocking GUI thread
+ * \{
+ *
+ * Image file has the same format as image in asset bank, \ref gui_assets_image_t header
+ * followed by raw pixel data. Pixels are read in chunks of \ref GUI_CFG_STREAM_CHUNK bytes
+ * directly to memory allocated for image, read function may use it as DMA destination.
+ *
+ * With \ref GUI_CFG_OS, chunks are read by separate I/O thread created on first load,
+ * GUI thread is never blocked by file system. Without operating system, chunks are read
+ * by GUI thread with idle task, only when there is nothing to redraw.
+ *
+ * Descriptor of image can be set to image widget immediately, placeholder is drawn until
+ * pixels are ready and widget is invalidated then.
+ *
+ * \code{c}
+static uint8_t
+fatfs_read(void* file, uint32_t offset, void* dst, size_t len) {
+    UINT br;
+    return f_lseek(file, offset) == FR_OK && f_read(file, dst, len, &br) == FR_OK && br == len;
+}
+
+gui_stream_image_t photo;
+FIL file;
+
+f_open(&file, "photo.img", FA_READ);
+gui_stream_image_load(&photo, fatfs_read, &file, 0, image);
+gui_image_setsource(image, &photo.desc);
+
+//When photo is not shown anymore
+gui_stream_image_release(&photo);
+\endcode
+ */
+
+#if GUI_CFG_USE_STREAM || __DOXYGEN__
+
+uint8_t         gui_stream_image_load(gui_stream_image_t* s, gui_stream_read_fn read, void* file, uint32_t offset, gui_handle_p h);
+uint8_t         gui_stream_image_release(gui_stream_image_t* s);
+gui_stream_state_t  gui_stream_image_getstate(const gui_stream_image_t* s);
+
+#endif /* GUI_CFG_USE_STREAM || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_STREAM_H */
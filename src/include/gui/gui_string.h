@@ -87,14 +87,27 @@ typedef struct {
 #endif /* GUI_CFG_USE_UNICODE || __DOXYGEN__ */
 } gui_string_t;
 
+/**
+ * \brief           Text match function, used to filter entries of list widgets
+ * \param[in]       text: Text of entry
+ * \param[in]       query: Filter query
+ * \return          `1` when entry matches query, `0` otherwise
+ * \sa              gui_string_contains
+ */
+typedef uint8_t (*gui_string_match_fn)(const gui_char* text, const gui_char* query);
+
 size_t gui_string_length(const gui_char* src);
 size_t gui_string_lengthtotal(const gui_char* src);
 gui_char* gui_string_copy(gui_char* dst, const gui_char* src);
 gui_char* gui_string_copyn(gui_char* dst, const gui_char* src, size_t len);
 int gui_string_compare(const gui_char* s1, const gui_char* s2);
+uint8_t gui_string_contains(const gui_char* text, const gui_char* query);
+size_t gui_string_fmt_int(gui_char* dst, size_t size, int32_t value);
+size_t gui_string_fmt_fixed(gui_char* dst, size_t size, int32_t value, uint8_t decimals);
 uint8_t gui_string_isprintable(uint32_t ch);
 uint8_t gui_string_prepare(gui_string_t* s, const gui_char* str);
 uint8_t gui_string_getch(gui_string_t* str, uint32_t* out, uint8_t* len);
+size_t gui_string_skip(gui_string_t* s, size_t cnt);
 uint8_t gui_string_getchreverse(gui_string_t* str, uint32_t* out, uint8_t* len);
 uint8_t gui_string_gotoend(gui_string_t* str);
     
@@ -62,6 +62,7 @@ uint8_t guii_timer_stop(gui_timer_t* t);
 uint8_t guii_timer_reset(gui_timer_t* t);
 
 uint32_t guii_timer_getactivecount(void);
+uint8_t guii_timer_getnext(uint32_t* time);
 void guii_timer_process(void);
 
 /**
@@ -0,0 +1,104 @@
+/**	
+ * \file            gui_trace.h
+ * \brief           Trace events for performance analysis
+ */
+
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_TRACE_H
+#define __GUI_TRACE_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_TRACE Trace events
+ * \brief           Begin and end events of widget callbacks, redraw, touch and low-level drawing
+ * \{
+ *
+ * Trace is enabled with \ref GUI_CFG_USE_TRACE. At GUI initialization, low-level
+ * drawing functions are replaced with wrappers, so every call to driver is traced too.
+ *
+ * Events are stored to RAM ring buffer and exported with \ref gui_trace_export
+ * as Chrome trace JSON, which can be opened in `chrome://tracing` or Perfetto.
+ */
+
+#if GUI_CFG_USE_TRACE || __DOXYGEN__
+
+uint8_t gui_trace_enable(uint8_t enable);
+uint8_t gui_trace_clear(void);
+size_t  gui_trace_getevents(gui_trace_event_t* evts, size_t count);
+uint8_t gui_trace_export(gui_trace_output_fn out, void* arg);
+
+#if defined(GUI_INTERNAL) || __DOXYGEN__
+
+void    guii_trace(uint8_t type, uint8_t begin, uint8_t op, gui_handle_p h, uint32_t arg);
+void    guii_trace_setll(gui_ll_t* ll);
+
+/**
+ * \brief           Add begin event of operation
+ * \param[in]       type: Event type, member of \ref gui_trace_type_t enumeration
+ * \param[in]       op: Operation, see \ref gui_trace_type_t
+ * \param[in]       h: Widget handle or `NULL`
+ * \param[in]       arg: Operation argument
+ * \hideinitializer
+ */
+#define guii_trace_begin(type, op, h, arg)      guii_trace((type), 1, (op), (h), (arg))
+
+/**
+ * \brief           Add end event of operation
+ * \param[in]       type: Event type, member of \ref gui_trace_type_t enumeration
+ * \param[in]       op: Operation, see \ref gui_trace_type_t
+ * \param[in]       h: Widget handle or `NULL`
+ * \param[in]       arg: Operation argument
+ * \hideinitializer
+ */
+#define guii_trace_end(type, op, h, arg)        guii_trace((type), 0, (op), (h), (arg))
+
+#endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
+
+#endif /* GUI_CFG_USE_TRACE || __DOXYGEN__ */
+
+#if !GUI_CFG_USE_TRACE && defined(GUI_INTERNAL)
+#define guii_trace_begin(type, op, h, arg)
+#define guii_trace_end(type, op, h, arg)
+#endif /* !GUI_CFG_USE_TRACE && defined(GUI_INTERNAL) */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_TRACE_H */
@@ -0,0 +1,83 @@
+/**	
+ * \file            gui_transition.h
+ * \brief           Animated transitions between screens
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_TRANSITION_H
+#define __GUI_TRANSITION_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_utils.h"
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_TRANSITION Screen transitions
+ * \brief           Slide and push animations when one screen is replaced by another
+ * \{
+ *
+ * Old screen is copied from display memory when transition starts and new one
+ * is copied after it is drawn on next frame. Animation frames only copy both buffers
+ * to drawing layer at moving offsets, widgets of new screen are drawn again
+ * only when they are invalidated during transition.
+ *
+ * Start transition with new screen widget and switch screens as usual right after it.
+ * Switch is animated within area of new screen widget.
+ *
+ * \note            Transitions require \ref gui_ll_t.Copy function and memory for
+ *                  two buffers of new screen widget size
+ */
+
+#if GUI_CFG_USE_TRANSITION || __DOXYGEN__
+
+uint8_t         gui_transition_start(gui_handle_p h, gui_transition_t type, uint16_t duration);
+uint8_t         gui_transition_isactive(void);
+
+#if defined(GUI_INTERNAL) || __DOXYGEN__
+
+void            guii_transition_prepare(gui_layer_t* src);
+void            guii_transition_draw(gui_layer_t* dst);
+uint8_t         guii_transition_isactive(void);
+
+#endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
+
+#endif /* GUI_CFG_USE_TRANSITION || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_TRANSITION_H */
@@ -0,0 +1,114 @@
+/**	
+ * \file            gui_headless.h
+ * \brief           Headless render-to-memory port for benchmarks and image tests
+ */
+ 
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_HEADLESS_H
+#define __GUI_HEADLESS_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_PORT
+ * \{
+ */
+
+/**
+ * \defgroup        GUI_HEADLESS Headless port
+ * \brief           Render to memory without display and OS, driven by virtual time
+ *
+ *                  Port consists of "gui_ll_headless.c" and "gui_system_headless.c" and requires
+ *                  \ref GUI_CFG_OS disabled and \ref GUI_CFG_LL_SOFTWARE enabled.
+ *
+ *                  Time returned by \ref gui_sys_now only changes with \ref gui_sys_headless_settime
+ *                  and \ref gui_headless_run, so the same input script always produces the same frames.
+ *                  For real frame times in statistics, set \ref GUI_CFG_STATS_TIME to host clock
+ *
+ * \{
+ */
+
+#include "gui/gui.h"
+
+/**
+ * \brief           LCD width in units of pixels
+ */
+#ifndef GUI_HEADLESS_WIDTH
+#define GUI_HEADLESS_WIDTH                  480
+#endif
+
+/**
+ * \brief           LCD height in units of pixels
+ */
+#ifndef GUI_HEADLESS_HEIGHT
+#define GUI_HEADLESS_HEIGHT                 272
+#endif
+
+/**
+ * \brief           Number of bytes per pixel, `1` for L8, `2` for RGB565, `3` for RGB888 or `4` for ARGB8888
+ * \note            L8 requires \ref GUI_CFG_LCD_CLUT, frame then contains indices to \ref gui_lcd_t.palette
+ */
+#ifndef GUI_HEADLESS_PIXEL_SIZE
+#define GUI_HEADLESS_PIXEL_SIZE             4
+#endif
+
+/**
+ * \brief           Size of memory assigned to GUI in units of bytes
+ * \note            With \ref GUI_CFG_LINKEDLIST_COMPACT enabled, default is the largest heap compact links can address
+ */
+#ifndef GUI_HEADLESS_HEAP_SIZE
+#if GUI_CFG_LINKEDLIST_COMPACT
+#define GUI_HEADLESS_HEAP_SIZE              ((0xFFFF - 1) * GUI_CFG_MEM_ALIGNMENT)
+#else /* GUI_CFG_LINKEDLIST_COMPACT */
+#define GUI_HEADLESS_HEAP_SIZE              0x00100000
+#endif /* !GUI_CFG_LINKEDLIST_COMPACT */
+#endif
+
+void            gui_sys_headless_settime(uint32_t time);
+
+const void*     gui_headless_getframe(size_t* size);
+uint32_t        gui_headless_getchecksum(void);
+uint32_t        gui_headless_getframecount(void);
+uint32_t        gui_headless_run(uint32_t time, uint32_t step);
+ 
+/**
+ * \}
+ */
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_HEADLESS_H */
@@ -0,0 +1,77 @@
+/**	
+ * \file            gui_ll_ili9341.h
+ * \brief           Low-level driver for ILI9341 display with internal GRAM on SPI
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_LL_ILI9341_H
+#define __GUI_LL_ILI9341_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_LL
+ * \{
+ */
+
+#include "system/gui_ll.h"
+
+/**
+ * \brief           Display width in units of pixels, landscape orientation
+ */
+#ifndef GUI_LL_ILI9341_WIDTH
+#define GUI_LL_ILI9341_WIDTH                320
+#endif
+
+/**
+ * \brief           Display height in units of pixels, landscape orientation
+ */
+#ifndef GUI_LL_ILI9341_HEIGHT
+#define GUI_LL_ILI9341_HEIGHT               240
+#endif
+
+/**
+ * \brief           SPI handle connected to display, with TX DMA linked
+ */
+#ifndef GUI_LL_ILI9341_SPI
+#define GUI_LL_ILI9341_SPI                  hspi1
+#endif
+
+/**
+ * \brief           Chip select pin, active low
+ */
+#ifndef GUI_LL_ILI9341_CS_PORT
+#define GUI_LL_ILI9341_CS_PORT              GPIOC
+#define GUI_LL_ILI9341_CS_PIN               GPIO_PIN_2
+#endif
+
+/**
+ * \brief           Data/command pin, low for command bytes
+ */
+#ifndef GUI_LL_ILI9341_DC_PORT
+#define GUI_LL_ILI9341_DC_PORT              GPIOD
+#define GUI_LL_ILI9341_DC_PIN               GPIO_PIN_13
+#endif
+
+/**
+ * \brief           Size of memory assigned to GUI in units of bytes
+ */
+#ifndef GUI_LL_ILI9341_HEAP_SIZE
+#define GUI_LL_ILI9341_HEAP_SIZE            0x00008000
+#endif
+
+void gui_ll_ili9341_txcomplete(void);
+ 
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_LL_ILI9341_H */
@@ -0,0 +1,90 @@
+/**	
+ * \file            gui_ll_sdl.h
+ * \brief           Low-level driver for SDL2 host simulator
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_LL_SDL_H
+#define __GUI_LL_SDL_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup      GUI_LL
+ * \{
+ */
+
+#include "system/gui_ll.h"
+
+/**
+ * \brief           Simulated LCD width in units of pixels
+ */
+#ifndef GUI_LL_SDL_WIDTH
+#define GUI_LL_SDL_WIDTH                    480
+#endif
+
+/**
+ * \brief           Simulated LCD height in units of pixels
+ */
+#ifndef GUI_LL_SDL_HEIGHT
+#define GUI_LL_SDL_HEIGHT                   272
+#endif
+
+/**
+ * \brief           Integer window zoom factor, LCD pixels are scaled on host screen
+ */
+#ifndef GUI_LL_SDL_ZOOM
+#define GUI_LL_SDL_ZOOM                     2
+#endif
+
+/**
+ * \brief           Size of memory assigned to GUI in units of bytes
+ * \note            With \ref GUI_CFG_LINKEDLIST_COMPACT enabled, default is the largest heap compact links can address
+ */
+#ifndef GUI_LL_SDL_HEAP_SIZE
+#if GUI_CFG_LINKEDLIST_COMPACT
+#define GUI_LL_SDL_HEAP_SIZE                ((0xFFFF - 1) * GUI_CFG_MEM_ALIGNMENT)
+#else /* GUI_CFG_LINKEDLIST_COMPACT */
+#define GUI_LL_SDL_HEAP_SIZE                0x00400000
+#endif /* !GUI_CFG_LINKEDLIST_COMPACT */
+#endif
+
+uint8_t gui_ll_sdl_process(uint32_t timeout);
+ 
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_LL_SDL_H */
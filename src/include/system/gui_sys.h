@@ -53,7 +53,68 @@ extern "C" {
  * \{
  */
 
-#if GUI_CFG_OS || __DOXYGEN__
+#if GUI_CFG_OS && GUI_CFG_SYS_POSIX
+#include "pthread.h"
+
+/*
+ * POSIX threads port, implemented in "gui_system_posix.c".
+ * Semaphores and message queues are private structures allocated by port,
+ * thread ID is value of pthread_self() casted to pointer
+ */
+
+typedef pthread_mutex_t*    gui_sys_mutex_t;
+typedef struct gui_sys_sem* gui_sys_sem_t;
+typedef struct gui_sys_mbox* gui_sys_mbox_t;
+typedef void*               gui_sys_thread_t;
+typedef int                 gui_sys_thread_prio_t;
+
+#define GUI_SYS_MBOX_NULL           (gui_sys_mbox_t)0
+#define GUI_SYS_SEM_NULL            (gui_sys_sem_t)0
+#define GUI_SYS_MUTEX_NULL          (gui_sys_mutex_t)0
+#define GUI_SYS_TIMEOUT             ((uint32_t)0xFFFFFFFF)
+#define GUI_SYS_THREAD_PRIO         (0)
+#define GUI_SYS_THREAD_SS           (0)
+
+#elif GUI_CFG_OS && GUI_CFG_SYS_FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/*
+ * Native FreeRTOS port, implemented in "gui_system_freertos.c".
+ * Objects are structures with static storage owned by caller,
+ * handle member is set to NULL when object is not valid
+ */
+
+typedef struct {
+    SemaphoreHandle_t handle;                   /*!< Recursive mutex handle */
+    StaticSemaphore_t buff;                     /*!< Mutex storage */
+} gui_sys_mutex_t;
+
+typedef struct {
+    SemaphoreHandle_t handle;                   /*!< Binary semaphore handle */
+    StaticSemaphore_t buff;                     /*!< Semaphore storage */
+} gui_sys_sem_t;
+
+typedef struct {
+    void* handle;                               /*!< Set to entries when valid */
+    TaskHandle_t waiter;                        /*!< Task waiting for new entry, woken with notification */
+    size_t size;                                /*!< Number of entries queue can hold */
+    size_t in, out, count;                      /*!< Write index, read index and number of entries */
+    void* entries[GUI_CFG_SYS_FREERTOS_MBOX_SIZE];  /*!< Entries */
+} gui_sys_mbox_t;
+
+typedef TaskHandle_t        gui_sys_thread_t;
+typedef UBaseType_t         gui_sys_thread_prio_t;
+
+#define GUI_SYS_MBOX_NULL           (void *)0
+#define GUI_SYS_SEM_NULL            (SemaphoreHandle_t)0
+#define GUI_SYS_MUTEX_NULL          (SemaphoreHandle_t)0
+#define GUI_SYS_TIMEOUT             ((uint32_t)0xFFFFFFFF)
+#define GUI_SYS_THREAD_PRIO         (tskIDLE_PRIORITY + 3)
+#define GUI_SYS_THREAD_SS           (1024 * sizeof(StackType_t))
+
+#elif GUI_CFG_OS || __DOXYGEN__
 #include "cmsis_os.h"
 
 /**
@@ -123,11 +184,12 @@ typedef osPriority          gui_sys_thread_prio_t;
  * \note            Keep as is in case of CMSIS based OS, otherwise change for your OS
  */
 #define GUI_SYS_THREAD_SS           (1024)
-#endif /* GUI_OS || __DOXYGEN__ */
+#endif /* GUI_CFG_OS || __DOXYGEN__ */
 
 uint8_t     gui_sys_init(void);
 uint32_t    gui_sys_now(void);
 
+#if GUI_CFG_OS || __DOXYGEN__
 uint8_t     gui_sys_protect(void);
 uint8_t     gui_sys_unprotect(void);
 
@@ -155,6 +217,8 @@ uint8_t     gui_sys_mbox_isvalid(gui_sys_mbox_t* b);
 uint8_t     gui_sys_mbox_invalid(gui_sys_mbox_t* b);
 
 uint8_t     gui_sys_thread_create(gui_sys_thread_t* t, const char* name, void(*thread_func)(void *), void* const arg, size_t stack_size, gui_sys_thread_prio_t prio);
+gui_sys_thread_t    gui_sys_thread_getid(void);
+#endif /* GUI_CFG_OS || __DOXYGEN__ */
  
 /**
  * \}
@@ -56,18 +56,31 @@ typedef enum {
     GUI_CONTAINER_COLOR_BG = 0x00,          /*!< Background color index */
 } gui_container_color_t;
 
+/**
+ * \brief           Function to create children widgets of container
+ * \param[in]       h: Container widget handle to be used as parent for new widgets
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_container_setbuilder
+ */
+typedef uint8_t (*gui_container_builder_fn)(gui_handle_p h);
+
 #if defined(GUI_INTERNAL) || __DOXYGEN__
 /**
  * \brief           Container object structure
  */
 typedef struct {
     gui_handle_root_t C;                    /*!< GUI handle object, must always be first on list */
+    
+    gui_container_builder_fn builder;       /*!< Function to create children widgets on first show */
+    uint16_t destroy_timeout;               /*!< Time in units of milliseconds after children are removed when container is hidden, `0` to keep them */
+    uint8_t built;                          /*!< Set to `1` when children widgets are created */
 } gui_container_t;
 
 #endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
 
 gui_handle_p    gui_container_create(gui_id_t id, float x, float y, float width, float height, gui_handle_p parent, gui_widget_callback_t cb, uint16_t flags);
 uint8_t         gui_container_setcolor(gui_handle_p h, gui_container_color_t index, gui_color_t color);
+uint8_t         gui_container_setbuilder(gui_handle_p h, gui_container_builder_fn builder, uint16_t destroy_timeout);
 
 /**
  * \}
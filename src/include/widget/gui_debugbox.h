@@ -58,14 +58,6 @@ typedef enum {
 #define GUI_FLAG_DEBUGBOX_SLIDER_ON      0x01/*!< Slider is currently active */
 #define GUI_FLAG_DEBUGBOX_SLIDER_AUTO    0x02/*!< Show right slider automatically when required, otherwise, manual mode is used */
 
-/**
- * \brief           DEBUGBOX string item object
- */
-typedef struct {
-    gui_linkedlist_t list;                  /*!< Linked list entry, must be first on list */
-    gui_char* text;                         /*!< Text entry */
-} gui_debugbox_item_t;
-    
 /**
  * \brief           DEBUGBOX object structure
  */
@@ -76,7 +68,11 @@ typedef struct {
     int16_t maxcount;                       /*!< Maximal number of lines in debug window */
     int16_t visiblestartindex;              /*!< Index in array of string on top of visible area of widget */
     
-    gui_linkedlistroot_t root;              /*!< Root of linked list entries */
+    gui_char* buff;                         /*!< Circular buffer with text of all lines */
+    uint16_t buffsize;                      /*!< Size of text buffer in units of bytes */
+    uint16_t head;                          /*!< Offset in text buffer where next line is written */
+    uint16_t* lines;                        /*!< Circular index of line offsets in text buffer, \ref maxcount entries */
+    int16_t first;                          /*!< Index in \ref lines of oldest line */
     
     gui_dim_t sliderwidth;                  /*!< Slider width in units of pixels */
     uint8_t flags;                          /*!< Widget flags */
@@ -92,6 +88,7 @@ uint8_t         gui_debugbox_setslidervisibility(gui_handle_p h, uint8_t visible
 uint8_t         gui_debugbox_scroll(gui_handle_p h, int16_t step);
 
 uint8_t         gui_debugbox_setmaxitems(gui_handle_p h, int16_t max_items);
+uint8_t         gui_debugbox_setbuffersize(gui_handle_p h, size_t size);
 
 /**
  * \}
@@ -45,6 +45,16 @@ extern "C" {
  * \{
  */
 
+/**
+ * \brief           Callback function called when dialog is dismissed
+ * \note            Function is called from \ref gui_dialog_dismiss with GUI protection activated,
+ *                  it must not wait for other threads
+ * \param[in]       h: Dialog handle, removed after callback returns
+ * \param[in]       status: Dismiss status
+ * \param[in]       arg: User argument passed to \ref gui_dialog_createasync
+ */
+typedef void (*gui_dialog_done_fn)(gui_handle_p h, int status, void* arg);
+
 #if defined(GUI_INTERNAL) || __DOXYGEN__
 /**
  * \brief           Dialog object structure
@@ -55,6 +65,7 @@ typedef struct {
 #endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
 
 gui_handle_p    gui_dialog_create(gui_id_t id, float x, float y, float width, float height, gui_widget_createfunc_t func, gui_widget_callback_t cb, uint16_t flags);
+gui_handle_p    gui_dialog_createasync(gui_id_t id, float x, float y, float width, float height, gui_widget_createfunc_t func, gui_widget_callback_t cb, uint16_t flags, gui_dialog_done_fn done, void* arg);
 int             gui_dialog_createblocking(gui_id_t id, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_widget_createfunc_t func, gui_widget_callback_t cb, uint16_t flags);
 uint8_t         gui_dialog_dismiss(gui_handle_p h, int status);
 
@@ -83,7 +83,6 @@ typedef enum {
  * \brief           Dropdown string item object
  */
 typedef struct {
-    gui_linkedlist_t list;                  /*!< Linked list entry, must be first on list */
     gui_char* text;                         /*!< Text entry */
 } gui_dropdown_item_t;
     
@@ -99,8 +98,10 @@ typedef struct {
     int16_t count;                          /*!< Current number of strings attached to this widget */
     int16_t selected;                       /*!< selected text index */
     int16_t visiblestartindex;              /*!< Index in array of string on top of visible area of widget */
+    gui_dim_t visibleoffset;                /*!< Number of pixels of entry on top of visible area scrolled out of view */
     
-    gui_linkedlistroot_t root;              /*!< Root of linked list entries */
+    gui_dropdown_item_t* items;             /*!< Contiguous array of entries, indexed directly */
+    int16_t capacity;                       /*!< Number of entries allocated in \ref items array */
     
     gui_dim_t sliderwidth;                  /*!< Slider width in units of pixels */
     uint8_t flags;                          /*!< Widget flags */
@@ -0,0 +1,109 @@
+/**	
+ * \file            gui_gauge.h
+ * \brief           Gauge widget
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#ifndef __GUI_GAUGE_H
+#define __GUI_GAUGE_H
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui_widget.h"
+
+/**
+ * \ingroup         GUI_WIDGETS
+ * \defgroup        GUI_GAUGE Gauge
+ * \brief           Analog meter with dial and rotating needle
+ *
+ *                  Dial face with ticks and labels does not change with value.
+ *                  With \ref GUI_CFG_WIDGET_GAUGE_DIAL_CACHE enabled it is drawn once to bitmap
+ *                  and only copied on next redraws. When value changes,
+ *                  only area covered by old and new needle position is redrawn.
+ *
+ * \{
+ */
+
+/**
+ * \brief           Gauge color list enumeration
+ * \sa              gui_gauge_setcolor
+ */
+typedef enum {
+    GUI_GAUGE_COLOR_BG = 0x00,              /*!< Background color index, area outside dial */
+    GUI_GAUGE_COLOR_DIAL = 0x01,            /*!< Dial face color index */
+    GUI_GAUGE_COLOR_TICK = 0x02,            /*!< Ticks and dial border color index */
+    GUI_GAUGE_COLOR_TEXT = 0x03,            /*!< Tick labels color index */
+    GUI_GAUGE_COLOR_NEEDLE = 0x04           /*!< Needle color index */
+} gui_gauge_color_t;
+
+#if defined(GUI_INTERNAL) || __DOXYGEN__
+/**
+ * \brief           Gauge widget structure
+ */
+typedef struct {
+    gui_handle C;                           /*!< GUI handle object, must always be first on list */
+    
+    int32_t min;                            /*!< Value at start of scale */
+    int32_t max;                            /*!< Value at end of scale */
+    int32_t currentvalue;                   /*!< Value needle currently shows */
+    int32_t desiredvalue;                   /*!< Desired value, set by user */
+    int16_t start_angle;                    /*!< Angle of scale start in degrees, clockwise from top */
+    int16_t sweep;                          /*!< Angle between scale start and end in degrees */
+    uint8_t ticks;                          /*!< Number of labeled divisions of scale */
+    uint8_t minor;                          /*!< Number of minor divisions between labeled ticks */
+    uint8_t flags;                          /*!< flags variable */
+#if GUI_CFG_WIDGET_GAUGE_DIAL_CACHE || __DOXYGEN__
+    gui_widget_bitmap_t dial;               /*!< Cached pixels of dial face */
+#endif /* GUI_CFG_WIDGET_GAUGE_DIAL_CACHE || __DOXYGEN__ */
+} gui_gauge_t;
+#endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
+
+gui_handle_p    gui_gauge_create(gui_id_t id, float x, float y, float width, float height, gui_handle_p parent, gui_widget_callback_t cb, uint16_t flags);
+uint8_t         gui_gauge_setcolor(gui_handle_p h, gui_gauge_color_t index, gui_color_t color);
+uint8_t         gui_gauge_setmin(gui_handle_p h, int32_t val);
+uint8_t         gui_gauge_setmax(gui_handle_p h, int32_t val);
+uint8_t         gui_gauge_setvalue(gui_handle_p h, int32_t val);
+uint8_t         gui_gauge_setangles(gui_handle_p h, int16_t start, int16_t sweep);
+uint8_t         gui_gauge_setticks(gui_handle_p h, uint8_t ticks, uint8_t minor);
+uint8_t         gui_gauge_setanimation(gui_handle_p h, uint8_t anim);
+int32_t         gui_gauge_getmin(gui_handle_p h);
+int32_t         gui_gauge_getmax(gui_handle_p h);
+int32_t         gui_gauge_getvalue(gui_handle_p h);
+
+/**
+ * \}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GUI_GAUGE_H */
@@ -90,6 +90,7 @@ typedef struct {
     
     gui_color_t color;                      /*!< Curve color */
     gui_graph_type_t type;                  /*!< Plot data type */
+    uint8_t minmax;                         /*!< Set to `1` to draw \ref GUI_GRAPH_TYPE_YT plot as min-max span per pixel column */
 } gui_graph_data_t;
 
 typedef gui_graph_data_t * gui_graph_data_p;/*!< GUI Graph data pointer */
@@ -113,6 +114,18 @@ typedef struct {
     float visible_max_x;                    /*!< Visible maximal X value for plot */
     float visible_min_y;                    /*!< Visible minimal Y value for plot */
     float visible_max_y;                    /*!< Visible maximal Y value for plot */
+    uint8_t strip;                          /*!< Set to `1` when new samples scroll existing plot pixels */
+    float strip_offset;                     /*!< Number of pixels vertical grid lines moved left in strip-chart mode */
+    uint8_t scale_valid;                    /*!< Set to `1` when fixed-point scale factors are calculated for current visible range */
+    gui_dim_t scale_width;                  /*!< Plot area width used for scale factors */
+    gui_dim_t scale_height;                 /*!< Plot area height used for scale factors */
+    int32_t scale_x;                        /*!< Number of pixels per X unit in Q16 format */
+    int32_t scale_y;                        /*!< Number of pixels per Y unit in Q16 format */
+    int64_t offset_x;                       /*!< Pixels offset of visible minimal X value in Q16 format */
+    int64_t offset_y;                       /*!< Pixels offset of visible minimal Y value in Q16 format */
+#if GUI_CFG_WIDGET_GRAPH_BG_CACHE || __DOXYGEN__
+    gui_widget_bitmap_t bg;                 /*!< Cached pixels of borders, background and grid lines */
+#endif /* GUI_CFG_WIDGET_GRAPH_BG_CACHE || __DOXYGEN__ */
 } gui_graph_t;
 #endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
 
@@ -124,12 +137,15 @@ uint8_t         gui_graph_setminy(gui_handle_p h, float v);
 uint8_t         gui_graph_setmaxy(gui_handle_p h, float v);
 uint8_t         gui_graph_zoomreset(gui_handle_p h);
 uint8_t         gui_graph_zoom(gui_handle_p h, float zoom, float x, float y);
+uint8_t         gui_graph_setstripchart(gui_handle_p h, uint8_t strip);
 uint8_t         gui_graph_attachdata(gui_handle_p h, gui_graph_data_p data);
 uint8_t         gui_graph_detachdata(gui_handle_p h, gui_graph_data_p data);
 
 gui_graph_data_p    gui_graph_data_create(gui_id_t id, gui_graph_type_t type, size_t length);
 uint8_t             gui_graph_data_addvalue(gui_graph_data_p data, int16_t x, int16_t y);
+uint8_t             gui_graph_data_addvalues(gui_graph_data_p data, const int16_t* xs, const int16_t* ys, size_t n);
 uint8_t             gui_graph_data_setcolor(gui_graph_data_p data, gui_color_t color);
+uint8_t             gui_graph_data_setminmax(gui_graph_data_p data, uint8_t minmax);
 gui_graph_data_p    gui_graph_data_get_by_id(gui_handle_p graph_h, gui_id_t id);
 
  
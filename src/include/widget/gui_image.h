@@ -46,6 +46,9 @@ extern "C" {
  */
 
 #if defined(GUI_INTERNAL) || __DOXYGEN__
+
+#define GUI_IMAGE_FLAG_SCALE        0x01    /*!< Image is scaled to widget size */
+
 /**
  * \brief           Image widget structure
  */
@@ -53,11 +56,24 @@ typedef struct {
     gui_handle C;                           /*!< GUI handle object, must always be first on list */
     
     const gui_image_desc_t* image;          /*!< Pointer to image object to draw */
+    uint8_t flags;                          /*!< List of widget flags */
+#if GUI_CFG_IMAGE_ANIM || __DOXYGEN__
+    const gui_image_anim_t* anim;           /*!< Animation being played or `NULL` */
+    gui_image_desc_t frame;                 /*!< Current frame of animation in RAM */
+    uint16_t index;                         /*!< Index of current frame */
+    uint8_t loop;                           /*!< Set to `1` to start animation again after last frame */
+#endif /* GUI_CFG_IMAGE_ANIM || __DOXYGEN__ */
 } GUI_IMAGE_t;
 #endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
     
 gui_handle_p    gui_image_create(gui_id_t id, float x, float y, float width, float height, gui_handle_p parent, gui_widget_callback_t cb, uint16_t flags);
 uint8_t         gui_image_setsource(gui_handle_p h, const gui_image_desc_t* img);
+uint8_t         gui_image_setscale(gui_handle_p h, uint8_t enable);
+uint8_t         gui_image_releasescaled(const gui_image_desc_t* img);
+#if GUI_CFG_IMAGE_ANIM || __DOXYGEN__
+uint8_t         gui_image_setanimation(gui_handle_p h, const gui_image_anim_t* anim, uint8_t loop);
+uint8_t         gui_image_stopanimation(gui_handle_p h);
+#endif /* GUI_CFG_IMAGE_ANIM || __DOXYGEN__ */
 
 /**
  * \}
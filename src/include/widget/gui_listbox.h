@@ -69,7 +69,6 @@ typedef enum {
  * \brief           LISTBOX string item object
  */
 typedef struct {
-    gui_linkedlist_t list;                  /*!< Linked list entry, must be first on list */
     gui_char* text;                         /*!< Text entry */
 } gui_listbox_item_t;
     
@@ -82,8 +81,15 @@ typedef struct {
     int16_t count;                          /*!< Current number of strings attached to this widget */
     int16_t selected;                       /*!< selected text index */
     int16_t visiblestartindex;              /*!< Index in array of string on top of visible area of widget */
+    gui_dim_t visibleoffset;                /*!< Number of pixels of entry on top of visible area scrolled out of view */
     
-    gui_linkedlistroot_t root;              /*!< Root of linked list entries */
+    gui_listbox_item_t* items;              /*!< Contiguous array of entries, indexed directly */
+    int16_t capacity;                       /*!< Number of entries allocated in \ref items array */
+    
+    gui_char* filter;                       /*!< Copy of filter query, all entries are shown when `NULL` */
+    gui_string_match_fn filter_fn;          /*!< Filter match function, \ref gui_string_contains is used when `NULL` */
+    int16_t* view;                          /*!< Indexes of entries matching filter, in ascending order */
+    int16_t view_count;                     /*!< Number of entries matching filter */
     
     gui_dim_t sliderwidth;                  /*!< Slider width in units of pixels */
     uint8_t flags;                          /*!< Widget flags */
@@ -93,6 +99,7 @@ typedef struct {
 gui_handle_p    gui_listbox_create(gui_id_t id, float x, float y, float width, float height, gui_handle_p parent, gui_widget_callback_t cb, uint16_t flags);
 uint8_t         gui_listbox_setcolor(gui_handle_p h, gui_listbox_color_t index, gui_color_t color);
 uint8_t         gui_listbox_addstring(gui_handle_p h, const gui_char* text);
+uint8_t         gui_listbox_addstrings(gui_handle_p h, const gui_char* const* texts, size_t count);
 uint8_t         gui_listbox_deletefirststring(gui_handle_p h);
 uint8_t         gui_listbox_deletelaststring(gui_handle_p h);
 uint8_t         gui_listbox_deletestring(gui_handle_p h, uint16_t index);
@@ -102,6 +109,8 @@ int16_t         gui_listbox_getselection(gui_handle_p h);
 uint8_t         gui_listbox_setsliderauto(gui_handle_p h, uint8_t autoMode);
 uint8_t         gui_listbox_setslidervisibility(gui_handle_p h, uint8_t visible);
 uint8_t         gui_listbox_scroll(gui_handle_p h, int16_t step);
+uint8_t         gui_listbox_setfilter(gui_handle_p h, const gui_char* query);
+uint8_t         gui_listbox_setfilterfn(gui_handle_p h, gui_string_match_fn fn);
 
 /**
  * \}
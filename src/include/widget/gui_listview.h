@@ -61,10 +61,44 @@ typedef enum {
     GUI_LISTVIEW_COLOR_BORDER,              /*!< Border color index for top line when not in 3D mode */
 } gui_listview_color_t;
 
+/**
+ * \brief           Data provider callback for virtual list view
+ * \param[in]       h: Widget handle
+ * \param[in]       row: Row index, from `0` to number of rows - 1
+ * \param[in]       col: Column index
+ * \return          Text to display in cell or `NULL` to leave it empty.
+ *                  Text must stay valid until drawing of widget is finished
+ * \sa              gui_listview_setvirtual
+ */
+typedef const gui_char* (*gui_listview_data_fn)(gui_handle_p h, uint16_t row, uint16_t col);
+
+/**
+ * \brief           Sort mode of list view rows
+ * \sa              gui_listview_sort
+ */
+typedef enum {
+    GUI_LISTVIEW_SORT_NONE = 0x00,          /*!< Rows are shown in order they were added */
+    GUI_LISTVIEW_SORT_STRING,               /*!< Compare column texts as strings */
+    GUI_LISTVIEW_SORT_NUMBER,               /*!< Compare column texts as decimal numbers */
+    GUI_LISTVIEW_SORT_CUSTOM,               /*!< Compare column texts with user function set by \ref gui_listview_setsortfn */
+} gui_listview_sort_t;
+
+/**
+ * \brief           Compare function for custom sort of list view rows
+ * \param[in]       a: Text of first row in sorted column, empty string when not set
+ * \param[in]       b: Text of second row in sorted column, empty string when not set
+ * \return          Negative value when first row goes before second, positive when after, `0` when equal
+ * \sa              gui_listview_setsortfn
+ */
+typedef int (*gui_listview_cmp_fn)(const gui_char* a, const gui_char* b);
+
 #if defined(GUI_INTERNAL) || __DOXYGEN__
     
 #define GUI_FLAG_LISTVIEW_SLIDER_ON     0x01/*!< Slider is currently active */
 #define GUI_FLAG_LISTVIEW_SLIDER_AUTO   0x02/*!< Show right slider automatically when required, otherwise, manual mode is used */
+#define GUI_FLAG_LISTVIEW_SORT_DIRTY    0x04/*!< Rows changed since they were sorted, sort order must be built again */
+#define GUI_FLAG_LISTVIEW_FILTER_DIRTY  0x08/*!< Rows or filter changed, rows matching filter must be found again */
+#define GUI_FLAG_LISTVIEW_FILTER_REFINE 0x10/*!< Query was extended, only rows matching previous query must be checked */
 
 /**
  * \brief           Listview main row item
@@ -113,10 +147,25 @@ typedef struct {
      * Use linked list for rows
      */
     gui_linkedlistroot_t root;              /*!< Linked list root entry for \ref gui_listview_row_t for rows */
+    gui_linkedlist_index_t rows_index;      /*!< Index of rows for fast access by row number */
+    gui_listview_row_t** order;             /*!< Rows in sorted order, rows are shown in linked list order when `NULL` */
+    gui_listview_cmp_fn sort_fn;            /*!< User compare function for \ref GUI_LISTVIEW_SORT_CUSTOM mode */
+    uint16_t sort_col;                      /*!< Column rows are sorted by */
+    uint8_t sort_mode;                      /*!< Sort mode, value of \ref gui_listview_sort_t enumeration */
+    uint8_t sort_desc;                      /*!< Set to `1` when rows are sorted in descending order */
+    
+    gui_char* filter;                       /*!< Copy of filter query, all rows are shown when `NULL` */
+    gui_string_match_fn filter_fn;          /*!< Filter match function, \ref gui_string_contains is used when `NULL` */
+    int16_t filter_col;                     /*!< Column checked by filter or `-1` for any column */
+    gui_listview_row_t** view;              /*!< Rows matching filter, in order they are shown */
+    int16_t view_count;                     /*!< Number of rows matching filter */
+    
+    gui_listview_data_fn data_fn;           /*!< Data provider in virtual mode. When set, rows are not stored in widget */
     
     int16_t count;                          /*!< Current number of strings attached to this widget */
     int16_t selected;                       /*!< selected text index */
     int16_t visiblestartindex;              /*!< Index in array of string on top of visible area of widget */
+    gui_dim_t visibleoffset;                /*!< Number of pixels of row on top of visible area scrolled out of view */
     
     gui_dim_t sliderwidth;                  /*!< Slider width in units of pixels */
     uint8_t flags;                          /*!< Widget flags */
@@ -146,6 +195,14 @@ uint8_t         gui_listview_setslidervisibility(gui_handle_p h, uint8_t visible
 uint8_t         gui_listview_scroll(gui_handle_p h, int16_t step);
 uint8_t         gui_listview_getitemvalue(gui_handle_p h, uint16_t rindex, uint16_t cindex, gui_char* dst, size_t length);
 
+uint8_t         gui_listview_sort(gui_handle_p h, uint16_t col, gui_listview_sort_t mode, uint8_t descending);
+uint8_t         gui_listview_setsortfn(gui_handle_p h, gui_listview_cmp_fn fn);
+uint8_t         gui_listview_setfilter(gui_handle_p h, int16_t col, const gui_char* query);
+uint8_t         gui_listview_setfilterfn(gui_handle_p h, gui_string_match_fn fn);
+
+uint8_t         gui_listview_setvirtual(gui_handle_p h, gui_listview_data_fn data_fn, int16_t count);
+uint8_t         gui_listview_setrowcount(gui_handle_p h, int16_t count);
+
 /**
  * \}
  */
@@ -60,16 +60,26 @@ typedef enum {
 #define GUI_FLAG_RADIO_CHECKED              0x01    /*!< Indicates radio is currently checked */
 #define GUI_FLAG_RADIO_DISABLED             0x02    /*!< Indicates radio is currently disabled */
 
+/**
+ * \brief           Radio group object, shared by all radios with the same parent and group ID
+ */
+typedef struct gui_radio_group {
+    struct gui_radio_group* next;           /*!< Next group in list of all groups */
+    gui_handle_p parent;                    /*!< Parent widget of group members */
+    uint8_t group_id;                       /*!< Group ID of members */
+    size_t members;                         /*!< Number of radios in group */
+    gui_handle_p checked;                   /*!< Currently checked radio, `NULL` if none */
+    uint32_t selected_value;                /*!< Currently selected value in radio group */
+} gui_radio_group_t;
+
 /**
  * \brief           Radio object structure
  */
 typedef struct {
     gui_handle C;                           /*!< GUI handle object, must always be first on list */
     
-    uint8_t group_id;                       /*!< Group ID for radio box */
+    gui_radio_group_t* group;               /*!< Radio group widget belongs to */
     uint32_t value;                         /*!< Single radio value when selected */
-    uint32_t selected_value;                /*!< Currently selected value in radio group. 
-                                                    All Widgets in the same group share the same value in this field all the time */
     uint8_t flags;                          /*!< flags for checkbox */
 } gui_radio_t;
 #endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
@@ -81,6 +81,7 @@ typedef struct {
 
     gui_textalign_valign_t valign;           /*!< Vertical text align */
     gui_textalign_halign_t halign;           /*!< Horizontal text align */
+    uint32_t scroll;                        /*!< Vertical scroll of text in units of pixels */
     uint8_t flags;                          /*!< Widget flags */
 } gui_textview_t;
 #endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
@@ -89,6 +90,8 @@ gui_handle_p    gui_textview_create(gui_id_t id, float x, float y, float width,
 uint8_t         gui_textview_setcolor(gui_handle_p h, gui_textview_color_t index, gui_color_t color);
 uint8_t         gui_textview_setvalign(gui_handle_p h, gui_textalign_valign_t align);
 uint8_t         gui_textview_sethalign(gui_handle_p h, gui_textalign_halign_t align);
+uint8_t         gui_textview_setscroll(gui_handle_p h, uint32_t scroll);
+uint32_t        gui_textview_getscrollmax(gui_handle_p h);
     
 /**
  * \}
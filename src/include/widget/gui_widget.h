@@ -108,6 +108,87 @@ extern "C" {
  */
 #define guii_widget_iswidget(h)                     ((h) != NULL && (h)->footprint == GUI_WIDGET_FOOTPRINT)
 
+/**
+ * \brief           Notify stack that position, size, padding or scroll of any widget has changed
+ * \note            All cached widget geometry values become invalid
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \hideinitializer
+ */
+#define guii_widget_geometrychanged()               (++GUI.GeometryGen)
+
+/**
+ * \brief           Notify stack that widget was added, removed, reordered, shown or hidden
+ * \note            When layouts are enabled, geometry is invalidated too as siblings may move
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \hideinitializer
+ */
+#if GUI_CFG_WIDGET_LAYOUT
+#define guii_widget_treechanged()                   (++GUI.TreeGen, guii_widget_geometrychanged())
+#else
+#define guii_widget_treechanged()                   (++GUI.TreeGen)
+#endif /* GUI_CFG_WIDGET_LAYOUT */
+
+/**
+ * \brief           Number of lock-free attempts to read widget state before GUI protection is used
+ */
+#define GUI_WIDGET_STATE_READ_RETRIES               4
+
+#if GUI_CFG_WIDGET_LOCKFREE_GET || __DOXYGEN__
+
+/**
+ * \brief           Start change of widget state read by lock-free getters
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle
+ * \sa              guii_widget_stateend, guii_widget_stateread
+ * \hideinitializer
+ */
+#define guii_widget_statebegin(h)                   do { ++(h)->version; GUI_CFG_MEMORY_BARRIER(); } while (0)
+
+/**
+ * \brief           Finish change of widget state read by lock-free getters
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle
+ * \sa              guii_widget_statebegin
+ * \hideinitializer
+ */
+#define guii_widget_stateend(h)                     do { GUI_CFG_MEMORY_BARRIER(); ++(h)->version; } while (0)
+
+/**
+ * \brief           Read widget state from any thread without GUI protection
+ * \note            Statement may only read widget memory, it is repeated when state changed meanwhile.
+ *                  Writer preempted in the middle of change would block reader forever,
+ *                  statement is executed with GUI protection after \ref GUI_WIDGET_STATE_READ_RETRIES attempts
+ * \param[in]       h: Widget handle
+ * \param[in]       stmt: Statement reading state to local variables
+ * \hideinitializer
+ */
+#define guii_widget_stateread(h, stmt)              do {                        \
+    uint16_t state_version;                                                     \
+    uint8_t state_try;                                                          \
+    for (state_try = 0; state_try < GUI_WIDGET_STATE_READ_RETRIES; state_try++) { \
+        state_version = (h)->version;                                           \
+        GUI_CFG_MEMORY_BARRIER();                                               \
+        if (!(state_version & 0x01)) {                                          \
+            stmt;                                                               \
+            GUI_CFG_MEMORY_BARRIER();                                           \
+            if ((h)->version == state_version) {                                \
+                break;                                                          \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+    if (state_try == GUI_WIDGET_STATE_READ_RETRIES) {                           \
+        __GUI_ENTER();                                                          \
+        stmt;                                                                   \
+        __GUI_LEAVE();                                                          \
+    }                                                                           \
+} while (0)
+
+#else /* GUI_CFG_WIDGET_LOCKFREE_GET || __DOXYGEN__ */
+#define guii_widget_statebegin(h)                   do {} while (0)
+#define guii_widget_stateend(h)                     do {} while (0)
+#define guii_widget_stateread(h, stmt)              do { __GUI_ENTER(); stmt; __GUI_LEAVE(); } while (0)
+#endif /* !(GUI_CFG_WIDGET_LOCKFREE_GET || __DOXYGEN__) */
+
 /**
  * \brief           Get widget relative X position according to parent widget
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -116,7 +197,7 @@ extern "C" {
  * \hideinitializer
  */
 #define guii_widget_getrelativex(h)                 (guii_widget_isexpanded(h) ? 0 : \
-                                                        (guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) ? (gui_dim_t)((float)GUI_ROUND((h)->x * guii_widget_getparentinnerwidth(h)) / 100.0f) : (h)->x) \
+                                                        (guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) ? GUI_GEOM_PERCENT((h)->x, guii_widget_getparentinnerwidth(h)) : GUI_GEOM_TO_DIM((h)->x)) \
                                                     )
 
 /**
@@ -127,9 +208,47 @@ extern "C" {
  * \hideinitializer
  */
 #define guii_widget_getrelativey(h)                 (guii_widget_isexpanded(h) ? 0 : \
-                                                        (guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) ? (gui_dim_t)((float)GUI_ROUND((h)->y * guii_widget_getparentinnerheight(h)) / 100.0f) : (h)->y) \
+                                                        (guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) ? GUI_GEOM_PERCENT((h)->y, guii_widget_getparentinnerheight(h)) : GUI_GEOM_TO_DIM((h)->y)) \
                                                     )
 
+#if GUI_CFG_WIDGET_STYLE || __DOXYGEN__
+
+/**
+ * \brief           Get color from shared style of widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle
+ * \param[in]       index: Color index from color array for specific widget
+ * \param[in]       def: Color to use when style does not set it
+ * \retval          Color value
+ * \hideinitializer
+ */
+#define guii_widget_getstylecolor(h, index, def)    ((h)->style != NULL && (uint8_t)(index) < (h)->style->color_count ? (h)->style->colors[(uint8_t)(index)] : (def))
+
+/**
+ * \brief           Get 4-bytes long padding of widget, from shared style when style sets it
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle
+ * \retval          Padding, MSB = top padding, LSB = left padding
+ * \hideinitializer
+ */
+#define guii_widget_getpaddingvalue(h)              ((h)->style != NULL && ((h)->style->flags & GUI_STYLE_FLAG_PADDING) ? (h)->style->padding : (h)->padding)
+
+/**
+ * \brief           Get border radius of widget, from shared style when style sets it
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle
+ * \param[in]       radius: Radius of widget itself
+ * \retval          Radius in units of pixels
+ * \hideinitializer
+ */
+#define guii_widget_getborderradius(h, radius)      ((h)->style != NULL && ((h)->style->flags & GUI_STYLE_FLAG_RADIUS) ? (h)->style->border_radius : (radius))
+
+#else /* GUI_CFG_WIDGET_STYLE || __DOXYGEN__ */
+#define guii_widget_getstylecolor(h, index, def)    (def)
+#define guii_widget_getpaddingvalue(h)              ((h)->padding)
+#define guii_widget_getborderradius(h, radius)      (radius)
+#endif /* !(GUI_CFG_WIDGET_STYLE || __DOXYGEN__) */
+
 /**
  * \brief           Get widget top padding as 8-bit value
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -137,7 +256,7 @@ extern "C" {
  * \retval          Padding in units of pixels
  * \hideinitializer
  */
-#define guii_widget_getpaddingtop(h)                ((uint8_t)(((h)->padding >> 24) & 0xFFUL))
+#define guii_widget_getpaddingtop(h)                ((uint8_t)((guii_widget_getpaddingvalue(h) >> 24) & 0xFFUL))
 
 /**
  * \brief           Get widget right padding as 8-bit value
@@ -146,7 +265,7 @@ extern "C" {
  * \retval          Padding in units of pixels
  * \hideinitializer
  */
-#define guii_widget_getpaddingright(h)              ((uint8_t)(((h)->padding >> 16) & 0xFFUL))
+#define guii_widget_getpaddingright(h)              ((uint8_t)((guii_widget_getpaddingvalue(h) >> 16) & 0xFFUL))
 
 /**
  * \brief           Get widget bottom padding as 8-bit value
@@ -155,7 +274,7 @@ extern "C" {
  * \retval          Padding in units of pixels
  * \hideinitializer
  */
-#define guii_widget_getpaddingbottom(h)             ((uint8_t)(((h)->padding >>  8) & 0xFFUL))
+#define guii_widget_getpaddingbottom(h)             ((uint8_t)((guii_widget_getpaddingvalue(h) >>  8) & 0xFFUL))
 
 /**
  * \brief           Get widget left padding as 8-bit value
@@ -164,7 +283,7 @@ extern "C" {
  * \retval          Padding in units of pixels
  * \hideinitializer
  */
-#define guii_widget_getpaddingleft(h)               ((uint8_t)(((h)->padding >>  0) & 0xFFUL))
+#define guii_widget_getpaddingleft(h)               ((uint8_t)((guii_widget_getpaddingvalue(h) >>  0) & 0xFFUL))
 
 /**
  * \brief           Set top padding on widget
@@ -176,7 +295,7 @@ extern "C" {
  * \param[in]       x: Padding in byte format
  * \hideinitializer
  */
-#define guii_widget_setpaddingtop(h, x)              ((h)->padding = (uint32_t)(((h)->padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)(x)) << 24))
+#define guii_widget_setpaddingtop(h, x)              ((h)->padding = (uint32_t)(((h)->padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)(x)) << 24), guii_widget_geometrychanged())
 
 /**
  * \brief           Set right padding on widget
@@ -188,7 +307,7 @@ extern "C" {
  * \param[in]       x: Padding in byte format
  * \hideinitializer
  */
-#define guii_widget_setpaddingright(h, x)            ((h)->padding = (uint32_t)(((h)->padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)(x)) << 16))
+#define guii_widget_setpaddingright(h, x)            ((h)->padding = (uint32_t)(((h)->padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)(x)) << 16), guii_widget_geometrychanged())
 
 /**
  * \brief           Set bottom padding on widget
@@ -200,7 +319,7 @@ extern "C" {
  * \param[in]       x: Padding in byte format
  * \hideinitializer
  */
-#define guii_widget_setpaddingbottom(h, x)           ((h)->padding = (uint32_t)(((h)->padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)(x)) <<  8))
+#define guii_widget_setpaddingbottom(h, x)           ((h)->padding = (uint32_t)(((h)->padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)(x)) <<  8), guii_widget_geometrychanged())
 
 /**
  * \brief           Set left padding on widget
@@ -212,7 +331,7 @@ extern "C" {
  * \param[in]       x: Padding in byte format
  * \hideinitializer
  */
-#define guii_widget_setpaddingleft(h, x)             ((h)->padding = (uint32_t)(((h)->padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)(x)) <<  0))
+#define guii_widget_setpaddingleft(h, x)             ((h)->padding = (uint32_t)(((h)->padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)(x)) <<  0), guii_widget_geometrychanged())
 
 /**
  * \brief           Set top and bottom paddings on widget
@@ -270,6 +389,26 @@ extern "C" {
  */
 #define guii_widget_getid(h)                        ((h)->id)
 
+/**
+ * \brief           Get length of widget text in units of bytes, without trailing zero
+ * \note            Value is cached when text is set or edited
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \retval          Number of bytes in text
+ * \hideinitializer
+ */
+#define guii_widget_gettextlength(h)                ((h)->textlen)
+
+/**
+ * \brief           Get number of characters in widget text
+ * \note            Value is cached when text is set or edited
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \retval          Number of UTF-8 decoded characters in text
+ * \hideinitializer
+ */
+#define guii_widget_gettextchars(h)                 ((h)->textchars)
+
 /**
  * \brief           Get widget flag(s)
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -344,8 +483,20 @@ extern "C" {
  */
 #define guii_widget_hasparent(h)                    ((h) != NULL && __GH(h)->parent != NULL)
 
+/**
+ * \brief           Check if callback command is in subscription mask
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       mask: Subscription mask or \ref GUI_WC_MASK_ALL
+ * \param[in]       cmd: Callback command. This parameter can be a value of \ref gui_wc_t enumeration
+ * \return          `1` when callback must be called, `0` otherwise
+ * \hideinitializer
+ */
+#define guii_widget_issubscribed(mask, cmd)         (!(mask) || (((mask) | GUI_WC_MASK_CORE) & GUI_WC_MASK(cmd)))
+
 /**
  * \brief           Process widget callback with command, parameters and result pointers
+ * \note            Commands not in subscription mask of user callback are sent directly to widget callback,
+ *                  commands not in subscription mask of widget are not sent at all
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
  * \param[in,out]   h: Widget handle
  * \param[in]       cmd: Callback command. This parameter can be a value of \ref gui_wc_t enumeration
@@ -354,18 +505,38 @@ extern "C" {
  * \return          `1` on success, `0` otherwise
  * \hideinitializer
  */
-#define guii_widget_callback(h, cmd, param, result) ((h)->callback != NULL ? (h)->callback(h, cmd, param, result) : (h)->widget->callback(h, cmd, param, result))
+#define guii_widget_callback_raw(h, cmd, param, result) \
+    ((h)->callback != NULL && guii_widget_issubscribed((h)->callback_events, cmd) ? (h)->callback(h, cmd, param, result) : \
+    (guii_widget_issubscribed((h)->widget->events, cmd) ? (h)->widget->callback(h, cmd, param, result) : 0))
+#if GUI_CFG_USE_TRACE
+#define guii_widget_callback(h, cmd, param, result) guii_widget_callback_trace(h, cmd, param, result)
+#else
+#define guii_widget_callback(h, cmd, param, result) guii_widget_callback_raw(h, cmd, param, result)
+#endif /* GUI_CFG_USE_TRACE */
+
+/**
+ * \brief           Get value from rarely used values of widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle
+ * \param[in]       field: Member of \ref gui_handle_ext_t structure
+ * \param[in]       def: Value returned when widget has no extension allocated
+ * \retval          Value of field
+ * \hideinitializer
+ */
+#define guii_widget_getextvalue(h, field, def)      (__GH(h)->ext != NULL ? __GH(h)->ext->field : (def))
 
 /**
  * \brief           Get widget colors from list of colors
- *                  It takes colors from allocated memory if exists or from default widget setup for default
+ *                  It takes colors from allocated memory if exists, then from shared style or from default widget setup for default
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
  * \param[in,out]   h: Widget handle
  * \param[in]       index: Color index from color array for specific widget
  * \retval          Color index
  * \hideinitializer
  */
-#define guii_widget_getcolor(h, index)              ((h)->colors != NULL ? (h)->colors[(uint8_t)(index)] : ((h)->widget->colors != NULL ? (h)->widget->colors[(uint8_t)(index)] : GUI_COLOR_BLACK))
+#define guii_widget_getcolor(h, index)              ((h)->ext != NULL && (h)->ext->colors != NULL ? (h)->ext->colors[(uint8_t)(index)] : \
+                                                        guii_widget_getstylecolor(h, index, ((h)->widget->colors != NULL ? (h)->widget->colors[(uint8_t)(index)] : GUI_COLOR_BLACK)) \
+                                                    )
 
 /**
  * \brief           Get inner width (total width - padding left - padding right)
@@ -447,6 +618,16 @@ extern "C" {
  */
 #define guii_widget_ishidden(h)                     (!guii_widget_isvisible(h))
 
+/**
+ * \brief           Check if any parent of widget is hidden
+ * \note            Value is kept up to date on show, hide and transparency change of any parent
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle
+ * \return          `1` if widget is not visible because of its parents, `0` otherwise
+ * \hideinitializer
+ */
+#define guii_widget_isparenthidden(h)               (!!guii_widget_getflag(h, GUI_FLAG_PARENT_HIDDEN))
+
 /**
  * \brief           Check if widget allows children widgets
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -456,6 +637,36 @@ extern "C" {
  */
 #define guii_widget_allowchildren(h)                (!!guii_widget_getcoreflag(h, GUI_FLAG_WIDGET_ALLOW_CHILDREN))
 
+/**
+ * \brief           Check if widget completely covers its area when drawn
+ * \note            Widget with transparency set is never opaque
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ * \hideinitializer
+ */
+#if GUI_CFG_WIDGET_MASK
+#define guii_widget_isopaque(h)                     (!!guii_widget_getcoreflag(h, GUI_FLAG_WIDGET_OPAQUE) && guii_widget_gettransparency(h) == 0xFF && !guii_widget_hasmask(h))
+#elif GUI_CFG_USE_TRANSPARENCY
+#define guii_widget_isopaque(h)                     (!!guii_widget_getcoreflag(h, GUI_FLAG_WIDGET_OPAQUE) && guii_widget_gettransparency(h) == 0xFF)
+#else
+#define guii_widget_isopaque(h)                     (!!guii_widget_getcoreflag(h, GUI_FLAG_WIDGET_OPAQUE))
+#endif
+
+/**
+ * \brief           Check if widget drawing covers its area, regardless of widget transparency
+ * \note            Content of such widget does not depend on pixels below it and can be blended from bitmap
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ * \hideinitializer
+ */
+#if GUI_CFG_WIDGET_MASK
+#define guii_widget_iscontentopaque(h)              (!!guii_widget_getcoreflag(h, GUI_FLAG_WIDGET_OPAQUE) && !guii_widget_hasmask(h))
+#else
+#define guii_widget_iscontentopaque(h)              (!!guii_widget_getcoreflag(h, GUI_FLAG_WIDGET_OPAQUE))
+#endif
+
 /**
  * \brief           Check if widget is base for dialog
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -486,13 +697,33 @@ extern "C" {
 #if GUI_CFG_USE_TRANSPARENCY || __DOXYGEN__
 /**
  * \brief           Check is widget has transparency
- * \note            Check if widget is visible and transparency is not set to 1 (full view)
+ * \note            Check if widget is visible and transparency is not set to 1 (full view).
+ *                  Widget with alpha mask is blended to screen the same way
  *
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
  * \param[in,out]   h: Widget handle
  * \return          `1` on success, `0` otherwise
  */
+#if GUI_CFG_WIDGET_MASK || __DOXYGEN__
+#define guii_widget_istransparent(h)                (guii_widget_isvisible(h) && (guii_widget_gettransparency(h) < 0xFF || guii_widget_hasmask(h)))
+#else
 #define guii_widget_istransparent(h)                (guii_widget_isvisible(h) && guii_widget_gettransparency(h) < 0xFF)
+#endif /* GUI_CFG_WIDGET_MASK || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_MASK || __DOXYGEN__
+/**
+ * \brief           Check if widget has alpha mask applied on current screen
+ * \note            Mask is not applied on rotated screen
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ */
+#if GUI_CFG_LCD_ROTATION
+#define guii_widget_hasmask(h)                      ((h)->mask != NULL && GUI.lcd.rotation == GUI_LCD_ROTATION_0)
+#else
+#define guii_widget_hasmask(h)                      ((h)->mask != NULL)
+#endif /* GUI_CFG_LCD_ROTATION */
+#endif /* GUI_CFG_WIDGET_MASK || __DOXYGEN__ */
 
 /**
  * \brief           Get widget transparency value
@@ -522,8 +753,28 @@ gui_dim_t       guii_widget_getabsolutex(gui_handle_p h);
 gui_dim_t       guii_widget_getabsolutey(gui_handle_p h);
 gui_dim_t       guii_widget_getparentabsolutex(gui_handle_p h);
 gui_dim_t       guii_widget_getparentabsolutey(gui_handle_p h);
+#if GUI_CFG_WIDGET_LAYOUT
+void            guii_widget_layout(void);
+#endif /* GUI_CFG_WIDGET_LAYOUT */
 uint8_t         guii_widget_invalidate(gui_handle_p h);
 uint8_t         guii_widget_invalidatewithparent(gui_handle_p h);
+void            guii_widget_processinvalidated(void);
+void            guii_widget_addrect(gui_display_t* list, size_t* cnt, size_t max, gui_dim_t x1, gui_dim_t y1, gui_dim_t x2, gui_dim_t y2);
+uint8_t         guii_widget_scroll(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t dy);
+uint8_t         guii_widget_scrollx(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t dx);
+uint8_t         guii_widget_scrollchildren(gui_handle_p h, gui_dim_t dx, gui_dim_t dy);
+void            guii_widget_scrollrows(gui_handle_p h, int32_t rows, gui_dim_t offset, gui_dim_t itemheight, gui_dim_t top, gui_dim_t sliderwidth);
+uint8_t         guii_widget_invalidaterect(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height);
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE
+void            guii_widget_processscrolled(void);
+void            guii_widget_blitscrolled(gui_layer_t* src, gui_layer_t* dst);
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE */
+#if GUI_CFG_WIDGET_SAVE_UNDER
+uint8_t         guii_widget_saveunder(gui_handle_p h);
+uint8_t         guii_widget_restoreunder(gui_handle_p h);
+void            guii_widget_captureunder(gui_handle_p h);
+void            guii_widget_blitunder(gui_layer_t* dst);
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
 uint8_t         guii_widget_setinvalidatewithparent(gui_handle_p h, uint8_t value);
 uint8_t         guii_widget_setposition(gui_handle_p h, gui_dim_t x, gui_dim_t y);
 uint8_t         guii_widget_setpositionpercent(gui_handle_p h, float x, float y);
@@ -538,6 +789,30 @@ uint8_t         guii_widget_setheight(gui_handle_p h, gui_dim_t height);
 uint8_t         guii_widget_setwidthpercent(gui_handle_p h, float width);
 uint8_t         guii_widget_setheightpercent(gui_handle_p h, float height);
 uint8_t         guii_widget_set3dstyle(gui_handle_p h, uint8_t enable);
+uint8_t         guii_widget_setretained(gui_handle_p h, uint8_t enable);
+uint8_t         guii_widget_drawretained(gui_handle_p h, const gui_display_t* disp);
+void            guii_widget_saveretained(gui_handle_p h, const gui_display_t* disp);
+uint32_t        guii_widget_hash(uint32_t hash, const void* data, size_t len);
+uint8_t         guii_widget_drawbitmap(gui_handle_p h, const gui_widget_bitmap_t* bmp, uint32_t key, const gui_display_t* disp);
+uint8_t         guii_widget_savebitmap(gui_handle_p h, gui_widget_bitmap_t* bmp, uint32_t key, const char* tag, const gui_display_t* disp);
+void            guii_widget_freebitmap(gui_widget_bitmap_t* bmp);
+#if GUI_CFG_WIDGET_INSTANCE_CACHE
+uint8_t         guii_widget_setinstanced(gui_handle_p h, uint8_t enable);
+uint8_t         guii_widget_drawinstance(gui_handle_p h, const gui_display_t* disp, uint32_t* key);
+void            guii_widget_saveinstance(gui_handle_p h, uint32_t key);
+#endif /* GUI_CFG_WIDGET_INSTANCE_CACHE */
+#if GUI_CFG_WIDGET_STATE_CACHE
+uint8_t         guii_widget_drawstate(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t r, uint32_t state, const gui_display_t* disp);
+void            guii_widget_savestate(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, uint32_t state, const gui_display_t* disp);
+#endif /* GUI_CFG_WIDGET_STATE_CACHE */
+#if GUI_CFG_USE_DISPLAY_LIST
+uint8_t         guii_widget_setdisplaylist(gui_handle_p h, uint8_t enable);
+uint8_t         guii_widget_drawlist(gui_handle_p h, gui_display_t* disp);
+#endif /* GUI_CFG_USE_DISPLAY_LIST */
+void            guii_widget_drawbackground(gui_handle_p h, const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color);
+#if GUI_CFG_WIDGET_STATICS
+void            guii_widget_drawstatics(gui_handle_p h, const gui_display_t* disp);
+#endif /* GUI_CFG_WIDGET_STATICS */
 uint8_t         guii_widget_setfont(gui_handle_p h, const gui_font_t* font);
 uint8_t         guii_widget_settext(gui_handle_p h, const gui_char* text);
 const gui_char*     guii_widget_gettext(gui_handle_p h);
@@ -549,6 +824,10 @@ void*           guii_widget_create(const gui_widget_t* widget, gui_id_t id, floa
 uint8_t         guii_widget_remove(gui_handle_p h);
 uint8_t         guii_widget_show(gui_handle_p h);
 uint8_t         guii_widget_hide(gui_handle_p h);
+#if GUI_CFG_SCREEN_STACK || __DOXYGEN__
+uint8_t         guii_widget_setvisiblequiet(gui_handle_p h, uint8_t visible);
+uint8_t         guii_widget_invalidatearea(gui_handle_p h, const gui_display_t* area);
+#endif /* GUI_CFG_SCREEN_STACK || __DOXYGEN__ */
 uint8_t         guii_widget_hidechildren(gui_handle_p h);
 uint8_t         guii_widget_toggleexpanded(gui_handle_p h);
 uint8_t         guii_widget_setexpanded(gui_handle_p h, uint8_t state);
@@ -560,6 +839,9 @@ uint8_t         guii_widget_setcolor(gui_handle_p h, uint8_t index, gui_color_t
 gui_handle_p    guii_widget_getbyid(gui_id_t id);
 
 uint8_t         guii_widget_settransparency(gui_handle_p h, uint8_t trans);
+#if GUI_CFG_WIDGET_MASK
+uint8_t         guii_widget_setmask(gui_handle_p h, const gui_mask_t* mask);
+#endif /* GUI_CFG_WIDGET_MASK */
 uint8_t         guii_widget_setzindex(gui_handle_p h, int32_t zindex);
 
 gui_dim_t       guii_widget_getwidth(gui_handle_p h);
@@ -568,8 +850,11 @@ gui_dim_t       guii_widget_getheight(gui_handle_p h);
 uint8_t         guii_widget_setuserdata(gui_handle_p h, void* data);
 void*           guii_widget_getuserdata(gui_handle_p h);
 
-uint8_t         guii_widget_setparam(gui_handle_p h, uint16_t cfg, const void* data, uint8_t invalidate, uint8_t invalidateparent);
+uint8_t         guii_widget_setparam(gui_handle_p h, uint16_t cfg, const void* data, size_t size, uint8_t invalidate, uint8_t invalidateparent);
 uint8_t         guii_widget_getparam(gui_handle_p h, uint16_t cfg, void* data);
+#if GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE
+void            guii_widget_processposted(void);
+#endif /* GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE */
 
 /**
  * \}
@@ -584,6 +869,8 @@ uint8_t         guii_widget_getparam(gui_handle_p h, uint16_t cfg, void* data);
 uint32_t        gui_widget_alloctextmemory(gui_handle_p h, uint32_t size);
 uint8_t         gui_widget_freetextmemory(gui_handle_p h);
 uint8_t         gui_widget_settext(gui_handle_p h, const gui_char* text);
+uint8_t         gui_widget_settextint(gui_handle_p h, int32_t value);
+uint8_t         gui_widget_settextfixed(gui_handle_p h, int32_t value, uint8_t decimals);
 const gui_char* gui_widget_gettext(gui_handle_p h);
 const gui_char* gui_widget_gettextcopy(gui_handle_p h, gui_char* dst, uint32_t len);
 uint8_t         guii_widget_setfont(gui_handle_p h, const gui_font_t* font);
@@ -650,6 +937,9 @@ uint8_t gui_widget_hidechildren(gui_handle_p h);
 uint8_t gui_widget_putonfront(gui_handle_p h);
 uint8_t gui_widget_gettransparency(gui_handle_p h);
 uint8_t gui_widget_settransparency(gui_handle_p h, uint8_t trans);
+#if GUI_CFG_WIDGET_MASK || __DOXYGEN__
+uint8_t gui_widget_setmask(gui_handle_p h, const gui_mask_t* mask);
+#endif /* GUI_CFG_WIDGET_MASK || __DOXYGEN__ */
  
 /**
  * \}
@@ -662,6 +952,8 @@ uint8_t gui_widget_settransparency(gui_handle_p h, uint8_t trans);
  */
 
 uint8_t gui_widget_invalidate(gui_handle_p h);
+uint8_t gui_widget_batch_begin(void);
+uint8_t gui_widget_batch_commit(void);
 uint8_t gui_widget_setuserdata(gui_handle_p h, void* data);
 void* gui_widget_getuserdata(gui_handle_p h);
 uint8_t gui_widget_ischildof(gui_handle_p h, gui_handle_p parent);
@@ -670,6 +962,23 @@ uint8_t gui_widget_setfocus(gui_handle_p h);
 uint8_t gui_widget_setzindex(gui_handle_p h, int32_t zindex);
 int32_t gui_widget_getzindex(gui_handle_p h);
 uint8_t gui_widget_set3dstyle(gui_handle_p h, uint8_t enable);
+uint8_t gui_widget_setretained(gui_handle_p h, uint8_t enable);
+#if GUI_CFG_WIDGET_INSTANCE_CACHE || __DOXYGEN__
+uint8_t gui_widget_setinstanced(gui_handle_p h, uint8_t enable);
+#endif /* GUI_CFG_WIDGET_INSTANCE_CACHE || __DOXYGEN__ */
+#if GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__
+uint8_t gui_widget_setdisplaylist(gui_handle_p h, uint8_t enable);
+#endif /* GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__ */
+#if GUI_CFG_WIDGET_STATICS || __DOXYGEN__
+uint8_t gui_widget_setstatics(gui_handle_p h, const gui_static_t* statics, size_t count);
+uint8_t gui_widget_invalidatestatic(gui_handle_p h, size_t index);
+#endif /* GUI_CFG_WIDGET_STATICS || __DOXYGEN__ */
+#if GUI_CFG_WIDGET_TREE || __DOXYGEN__
+gui_handle_p gui_widget_createtree(const gui_widget_desc_t* desc, size_t count, gui_handle_p parent);
+#endif /* GUI_CFG_WIDGET_TREE || __DOXYGEN__ */
+#if GUI_CFG_WIDGET_STYLE || __DOXYGEN__
+uint8_t gui_widget_setstyle(gui_handle_p h, gui_style_p s);
+#endif /* GUI_CFG_WIDGET_STYLE || __DOXYGEN__ */
 gui_id_t gui_widget_getid(gui_handle_p h);
 gui_handle_p gui_widget_getbyid(gui_id_t id);
 uint8_t gui_widget_remove(gui_handle_p* h);
@@ -678,6 +987,45 @@ uint8_t gui_widget_remove(gui_handle_p* h);
  * \}
  */
 
+#if GUI_CFG_WIDGET_STYLE || __DOXYGEN__
+
+/**
+ * \defgroup        GUI_WIDGET_STYLE Shared styles
+ * \brief           Colors, font, padding and border radius shared between widgets
+ * \{
+ */
+
+gui_style_p gui_style_create(const gui_color_t* colors, uint8_t count);
+uint8_t gui_style_release(gui_style_p s);
+uint8_t gui_style_setcolors(gui_style_p s, const gui_color_t* colors, uint8_t count);
+uint8_t gui_style_setfont(gui_style_p s, const gui_font_t* font);
+uint8_t gui_style_setpadding(gui_style_p s, gui_dim_t top, gui_dim_t right, gui_dim_t bottom, gui_dim_t left);
+uint8_t gui_style_setborderradius(gui_style_p s, gui_dim_t radius);
+
+/**
+ * \}
+ */
+
+#endif /* GUI_CFG_WIDGET_STYLE || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__
+
+/**
+ * \defgroup        GUI_WIDGET_LAYOUT Layout
+ * \brief           Row, column and grid placement of children widgets
+ * \{
+ */
+
+uint8_t gui_widget_setlayout(gui_handle_p h, gui_layout_type_t type, gui_dim_t gap);
+uint8_t gui_widget_setlayoutcolumns(gui_handle_p h, uint8_t columns);
+uint8_t gui_widget_setflexgrow(gui_handle_p h, uint8_t grow);
+
+/**
+ * \}
+ */
+
+#endif /* GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__ */
+
 /**
  * \defgroup        GUI_WIDGET_PADDING Padding
  * \brief           Padding related functions
@@ -709,6 +1057,7 @@ gui_dim_t gui_widget_getpaddingleft(gui_handle_p h);
 
 uint8_t gui_widget_processdefaultcallback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
 uint8_t gui_widget_setcallback(gui_handle_p h, gui_widget_callback_t callback);
+uint8_t gui_widget_setcallbackevents(gui_handle_p h, uint32_t events);
 uint8_t gui_widget_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
 
 /**
@@ -722,10 +1071,19 @@ void guii_widget_init(void);
 
 //Clipping regions
 uint8_t guii_widget_isinsideclippingregion(gui_handle_p h);
+#if GUI_CFG_USE_TRACE || __DOXYGEN__
+uint8_t guii_widget_callback_trace(gui_handle_p h, gui_wc_t cmd, gui_widget_param_t* param, gui_widget_result_t* result);
+#endif /* GUI_CFG_USE_TRACE || __DOXYGEN__ */
+
+//Allocate rarely used values of widget on first use
+gui_handle_ext_t* guii_widget_getext(gui_handle_p h);
 
 //Move widget down and all its parents with it
 void guii_widget_movedowntree(gui_handle_p h);
 
+//Walk widget subtree without recursion
+gui_handle_p guii_widget_treenext(gui_handle_p root, gui_handle_p h, uint8_t children);
+
 void guii_widget_focus_clear(void);
 void guii_widget_focus_set(gui_handle_p h);
 void guii_widget_active_clear(void);
@@ -733,6 +1091,10 @@ void guii_widget_active_set(gui_handle_p h);
 
 //Execute actual widget remove process
 uint8_t guii_widget_executeremove(void);
+uint8_t guii_widget_removechildren(gui_handle_p parent);
+
+//Update widgets after language change
+void guii_widget_translatechanged(void);
 #endif /* !__DOXYGEN__ */
 
 /**
@@ -0,0 +1,310 @@
+/**	
+ * \file            gui_ll_headless.c
+ * \brief           Low-level driver rendering to memory for headless port
+ *
+ * \note            All drawing is done by software functions of GUI to plain RAM frame buffers.
+ *                  Each finished frame is confirmed immediately, so \ref gui_process never waits for display
+ */
+ 
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "system/gui_ll.h"
+#include "system/gui_headless.h"
+
+#if !GUI_CFG_LL_SOFTWARE
+#error "Headless low-level driver requires GUI_CFG_LL_SOFTWARE to be enabled"
+#endif /* !GUI_CFG_LL_SOFTWARE */
+
+#if GUI_HEADLESS_PIXEL_SIZE == 1 && !GUI_CFG_LCD_CLUT
+#error "Headless L8 frame buffer requires GUI_CFG_LCD_CLUT to be enabled"
+#endif /* GUI_HEADLESS_PIXEL_SIZE == 1 && !GUI_CFG_LCD_CLUT */
+#if GUI_HEADLESS_PIXEL_SIZE == 1 && GUI_CFG_LCD_BACKGROUND
+#error "Headless background composition does not support L8 frame buffer"
+#endif /* GUI_HEADLESS_PIXEL_SIZE == 1 && GUI_CFG_LCD_BACKGROUND */
+#if GUI_CFG_LINKEDLIST_COMPACT && GUI_HEADLESS_HEAP_SIZE > (0xFFFF - 1) * GUI_CFG_MEM_ALIGNMENT
+#error "GUI_HEADLESS_HEAP_SIZE is too big for GUI_CFG_LINKEDLIST_COMPACT links"
+#endif /* GUI_CFG_LINKEDLIST_COMPACT && GUI_HEADLESS_HEAP_SIZE > (0xFFFF - 1) * GUI_CFG_MEM_ALIGNMENT */
+
+#if GUI_CFG_LCD_BAND
+#define GUI_LAYERS                  1           /* Frame buffer acts as display memory */
+#else /* GUI_CFG_LCD_BAND */
+#define GUI_LAYERS                  2
+#endif /* !GUI_CFG_LCD_BAND */
+#define FRAME_SIZE                  ((size_t)GUI_HEADLESS_WIDTH * (size_t)GUI_HEADLESS_HEIGHT * (size_t)GUI_HEADLESS_PIXEL_SIZE)
+#if GUI_CFG_LCD_BACKGROUND
+#define LAYER_SIZE                  ((size_t)GUI_HEADLESS_WIDTH * (size_t)GUI_HEADLESS_HEIGHT * 4)  /* Drawing layers have alpha channel */
+#else /* GUI_CFG_LCD_BACKGROUND */
+#define LAYER_SIZE                  FRAME_SIZE
+#endif /* !GUI_CFG_LCD_BACKGROUND */
+
+static gui_layer_t layers[GUI_LAYERS];
+static uint32_t frame_buffers[GUI_LAYERS][(LAYER_SIZE + 3) / 4];    /* Word aligned frame buffers */
+#if GUI_CFG_LCD_BACKGROUND
+static gui_layer_t background;
+static gui_layer_t display;                     /* Result of composition as virtual display controller would show it */
+static uint32_t background_buffer[(FRAME_SIZE + 3) / 4];
+static uint32_t display_buffer[(FRAME_SIZE + 3) / 4];
+#endif /* GUI_CFG_LCD_BACKGROUND */
+static uint32_t heap[GUI_HEADLESS_HEAP_SIZE / 4];
+static gui_layer_t* shown_layer;                /* Layer currently on virtual display */
+static uint32_t frame_count;                    /* Number of frames shown since initialization */
+
+static void
+LCD_Init(gui_lcd_t* LCD) {
+    GUI_UNUSED(LCD);
+}
+
+#if GUI_CFG_LCD_BACKGROUND
+
+/**
+ * \brief           Compose drawing layer over background layer to display memory
+ * \param[in]       layer: Drawing layer with ARGB8888 pixels
+ */
+static void
+compose(const gui_layer_t* layer) {
+    const uint32_t* src = (const uint32_t *)layer->start_address;
+    const uint8_t* bg = (const uint8_t *)background_buffer;
+    uint8_t* dst = (uint8_t *)display_buffer;
+    uint32_t c, b, a, rb, g;
+    size_t i, k;
+    
+    for (i = 0; i < (size_t)GUI_HEADLESS_WIDTH * (size_t)GUI_HEADLESS_HEIGHT; i++, bg += GUI_HEADLESS_PIXEL_SIZE, dst += GUI_HEADLESS_PIXEL_SIZE) {
+        if (GUI_HEADLESS_PIXEL_SIZE == 2) {
+            b = *(const uint16_t *)bg;
+            b = ((b & 0xF800) << 8) | ((b & 0x07E0) << 5) | ((b & 0x001F) << 3);
+        } else {
+            b = bg[0] | (bg[1] << 8) | ((uint32_t)bg[2] << 16);
+        }
+        c = src[i];
+        a = c >> 24;
+        rb = (c & 0x00FF00FF) * a + (b & 0x00FF00FF) * (0xFF - a) + 0x00800080;
+        rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+        g = (c & 0x0000FF00) * a + (b & 0x0000FF00) * (0xFF - a) + 0x00008000;
+        g = ((g + (g >> 8)) >> 8) & 0x0000FF00;
+        c = 0xFF000000UL | rb | g;
+        if (GUI_HEADLESS_PIXEL_SIZE == 2) {
+            *(uint16_t *)dst = (uint16_t)(((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F));
+        } else {
+            for (k = 0; k < GUI_HEADLESS_PIXEL_SIZE; k++) {
+                dst[k] = (uint8_t)(c >> (8 * k));
+            }
+        }
+    }
+}
+
+#endif /* GUI_CFG_LCD_BACKGROUND */
+
+/**
+ * \brief           Get memory of last shown frame
+ * \param[out]      size: Pointer to output variable to save number of bytes of frame. Can be set to `NULL`
+ * \return          Pointer to frame memory, `width * height` pixels in LCD pixel format, or `NULL` if nothing is shown yet
+ */
+const void *
+gui_headless_getframe(size_t* size) {
+    if (size != NULL) {
+        *size = shown_layer != NULL ? FRAME_SIZE : 0;
+    }
+    return shown_layer != NULL ? (const void *)shown_layer->start_address : NULL;
+}
+
+/**
+ * \brief           Get checksum of last shown frame for comparison with golden value
+ * \note            FNV-1a 32-bit hash over all bytes of frame
+ * \return          Checksum of frame, `0` if nothing is shown yet
+ */
+uint32_t
+gui_headless_getchecksum(void) {
+    const uint8_t* p;
+    size_t i, size;
+    uint32_t hash = 0x811C9DC5UL;
+    
+    p = gui_headless_getframe(&size);
+    if (p == NULL) {
+        return 0;
+    }
+    for (i = 0; i < size; i++) {
+        hash = (hash ^ p[i]) * 0x01000193UL;
+    }
+    return hash;
+}
+
+/**
+ * \brief           Get number of frames shown since initialization
+ * \return          Number of frames
+ */
+uint32_t
+gui_headless_getframecount(void) {
+    return frame_count;
+}
+
+/**
+ * \brief           Advance virtual time and process GUI
+ *
+ *                  \ref gui_process is called at start and after each step of virtual time,
+ *                  inputs added before call are processed at current time
+ *
+ * \param[in]       time: Virtual time to advance in units of milliseconds
+ * \param[in]       step: Time between two process calls in units of milliseconds, `0` processes only once at the end
+ * \return          Number of frames shown during call
+ */
+uint32_t
+gui_headless_run(uint32_t time, uint32_t step) {
+    uint32_t frames = frame_count, dt;
+    
+    gui_process();
+    while (time > 0) {
+        dt = step && step < time ? step : time;
+        gui_sys_headless_settime(gui_sys_now() + dt);
+        time -= dt;
+        gui_process();
+    }
+    return frame_count - frames;
+}
+
+uint8_t
+gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void* result) {
+    switch (cmd) {
+        case GUI_LL_Command_Init: {
+            size_t i;
+            gui_ll_t* LL = (gui_ll_t *)param;
+            
+            /*******************************/
+            /* Assign memory to GUI        */
+            /*******************************/
+            do {
+                static GUI_MEM_Region_t const regions[] = {
+                    {heap, sizeof(heap)},
+                };
+                if (!gui_mem_assignmemory(regions, GUI_COUNT_OF(regions))) {
+                    return 1;                   /* Command processed, result stays failed */
+                }
+            } while (0);
+            
+            /*******************************/
+            /* Set up LCD data             */
+            /*******************************/
+            LCD->width = GUI_HEADLESS_WIDTH;
+            LCD->height = GUI_HEADLESS_HEIGHT;
+            LCD->pixel_size = GUI_HEADLESS_PIXEL_SIZE;
+            
+            /*******************************/
+            /* Set layers count            */
+            /*******************************/
+            LCD->layer_count = GUI_LAYERS;
+            LCD->layers = layers;
+            for (i = 0; i < GUI_LAYERS; i++) {
+                layers[i].num = (uint8_t)i;
+                layers[i].start_address = (uintptr_t)frame_buffers[i];
+#if GUI_CFG_LCD_BACKGROUND
+                layers[i].pixel_format = GUI_PIXEL_FORMAT_ARGB8888;
+#endif /* GUI_CFG_LCD_BACKGROUND */
+            }
+#if GUI_CFG_LCD_BACKGROUND
+            background.start_address = (uintptr_t)background_buffer;    /* Background uses LCD pixel format */
+            display.start_address = (uintptr_t)display_buffer;
+            LCD->background = &background;
+#endif /* GUI_CFG_LCD_BACKGROUND */
+            shown_layer = NULL;
+            frame_count = 0;
+            
+            /*******************************/
+            /* Set up LCD drawing routines */
+            /*******************************/
+            LL->Init = LCD_Init;                /* All other functions are set by software drawing */
+            
+            if (result != NULL) {
+                *(uint8_t *)result = 0;         /* Successful initialization */
+            }
+            return 1;                           /* Command processed */
+        }
+        case GUI_LL_Command_SetActiveLayer: {   /* Set new active layer */
+            gui_layer_t* layer = *(gui_layer_t **)param;   /* Get layer to show */
+            
+            /* Drawing is synchronous, frame is complete and shown immediately */
+#if GUI_CFG_LCD_BACKGROUND
+            compose(layer);
+            shown_layer = &display;
+#else /* GUI_CFG_LCD_BACKGROUND */
+            shown_layer = layer;
+#endif /* !GUI_CFG_LCD_BACKGROUND */
+            frame_count++;
+            gui_lcd_confirmactivelayer(layer->num);
+            
+            if (result != NULL) {
+                *(uint8_t *)result = 0;         /* Successful layer set as active */
+            }
+            return 1;                           /* Command processed */
+        }
+#if GUI_CFG_LCD_BAND
+        case GUI_LL_Command_Flush: {            /* Copy band to display memory */
+            const gui_ll_flush_t* flush = (const gui_ll_flush_t *)param;
+            const gui_layer_t* band = flush->band;
+            gui_dim_t y;
+            
+            for (y = 0; y < band->height; y++) {
+                memcpy((uint8_t *)frame_buffers[0] + LCD->pixel_size * ((size_t)(band->y_offset + y) * LCD->width + band->x_offset),
+                    (const uint8_t *)band->start_address + LCD->pixel_size * (size_t)y * band->width,
+                    LCD->pixel_size * (size_t)band->width);
+            }
+            if (flush->last) {                  /* Frame is complete */
+                shown_layer = &layers[0];
+                frame_count++;
+            }
+            gui_lcd_confirmflush(band->num);    /* Band buffer is free immediately */
+            
+            if (result != NULL) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;
+        }
+#endif /* GUI_CFG_LCD_BAND */
+#if GUI_CFG_LCD_CLUT
+        case GUI_LL_Command_SetPalette: {       /* Frame keeps indices, palette is read from LCD structure */
+            if (result != NULL) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;
+        }
+#endif /* GUI_CFG_LCD_CLUT */
+        case GUI_LL_Command_PowerDown: {        /* Nothing to switch off */
+            if (result != NULL) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;
+        }
+        case GUI_LL_Command_PowerUp: {
+            *(uint8_t *)param = 1;              /* Frame buffers keep their content */
+            if (result != NULL) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;
+        }
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,232 @@
+/**	
+ * \file            gui_ll_ili9341.c
+ * \brief           Low-level driver for ILI9341 display with internal GRAM on SPI
+ */
+
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "system/gui_ll_ili9341.h"
+
+#include "stm32fxxx_hal.h"
+
+#if !GUI_CFG_LL_SOFTWARE
+#error "ILI9341 low-level driver requires GUI_CFG_LL_SOFTWARE to be enabled"
+#endif /* !GUI_CFG_LL_SOFTWARE */
+#if !GUI_CFG_LCD_BAND
+#error "ILI9341 low-level driver requires GUI_CFG_LCD_BAND to be enabled"
+#endif /* !GUI_CFG_LCD_BAND */
+#if GUI_CFG_LCD_BAND_SIZE / 2 > 0xFFFF
+#error "GUI_CFG_LCD_BAND_SIZE is too big for single DMA transfer"
+#endif /* GUI_CFG_LCD_BAND_SIZE / 2 > 0xFFFF */
+#if GUI_CFG_LINKEDLIST_COMPACT && GUI_LL_ILI9341_HEAP_SIZE > (0xFFFF - 1) * GUI_CFG_MEM_ALIGNMENT
+#error "GUI_LL_ILI9341_HEAP_SIZE is too big for GUI_CFG_LINKEDLIST_COMPACT links"
+#endif /* GUI_CFG_LINKEDLIST_COMPACT && GUI_LL_ILI9341_HEAP_SIZE > (0xFFFF - 1) * GUI_CFG_MEM_ALIGNMENT */
+
+#define ILI9341_SWRESET             0x01
+#define ILI9341_SLPOUT              0x11
+#define ILI9341_DISPON              0x29
+#define ILI9341_CASET               0x2A
+#define ILI9341_PASET               0x2B
+#define ILI9341_RAMWR               0x2C
+#define ILI9341_MADCTL              0x36
+#define ILI9341_PIXFMT              0x3A
+
+#define CS_LOW()                    HAL_GPIO_WritePin(GUI_LL_ILI9341_CS_PORT, GUI_LL_ILI9341_CS_PIN, GPIO_PIN_RESET)
+#define CS_HIGH()                   HAL_GPIO_WritePin(GUI_LL_ILI9341_CS_PORT, GUI_LL_ILI9341_CS_PIN, GPIO_PIN_SET)
+#define DC_CMD()                    HAL_GPIO_WritePin(GUI_LL_ILI9341_DC_PORT, GUI_LL_ILI9341_DC_PIN, GPIO_PIN_RESET)
+#define DC_DATA()                   HAL_GPIO_WritePin(GUI_LL_ILI9341_DC_PORT, GUI_LL_ILI9341_DC_PIN, GPIO_PIN_SET)
+
+extern SPI_HandleTypeDef GUI_LL_ILI9341_SPI;
+
+static gui_layer_t layer;                       /* Display memory is inside controller */
+static uint32_t heap[GUI_LL_ILI9341_HEAP_SIZE / 4];
+static volatile int16_t tx_band = -1;           /* Number of band in transfer, `-1` when idle */
+
+/**
+ * \brief           Set SPI frame size
+ * \note            Pixels are sent as 16-bit frames, so RGB565 pixels from memory go out MSB first as controller expects
+ * \param[in]       size: `SPI_DATASIZE_8BIT` or `SPI_DATASIZE_16BIT`
+ */
+static void
+spi_setdatasize(uint32_t size) {
+    if (GUI_LL_ILI9341_SPI.Init.DataSize != size) {
+        GUI_LL_ILI9341_SPI.Init.DataSize = size;
+        HAL_SPI_Init(&GUI_LL_ILI9341_SPI);
+    }
+}
+
+/**
+ * \brief           Send command with parameters to controller
+ * \param[in]       cmd: Command byte
+ * \param[in]       data: Parameters, can be `NULL` when `len` is `0`
+ * \param[in]       len: Number of parameter bytes
+ */
+static void
+send_cmd(uint8_t cmd, const uint8_t* data, size_t len) {
+    spi_setdatasize(SPI_DATASIZE_8BIT);
+    CS_LOW();
+    DC_CMD();
+    HAL_SPI_Transmit(&GUI_LL_ILI9341_SPI, &cmd, 1, 10);
+    if (len) {
+        DC_DATA();
+        HAL_SPI_Transmit(&GUI_LL_ILI9341_SPI, (uint8_t *)data, len, 10);
+    }
+    CS_HIGH();
+}
+
+/**
+ * \brief           Set GRAM window for next memory write
+ * \param[in]       x: Window start X position
+ * \param[in]       y: Window start Y position
+ * \param[in]       width: Window width
+ * \param[in]       height: Window height
+ */
+static void
+set_window(gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height) {
+    uint8_t d[4];
+    
+    d[0] = (uint8_t)(x >> 8);
+    d[1] = (uint8_t)x;
+    d[2] = (uint8_t)((x + width - 1) >> 8);
+    d[3] = (uint8_t)(x + width - 1);
+    send_cmd(ILI9341_CASET, d, sizeof(d));
+    d[0] = (uint8_t)(y >> 8);
+    d[1] = (uint8_t)y;
+    d[2] = (uint8_t)((y + height - 1) >> 8);
+    d[3] = (uint8_t)(y + height - 1);
+    send_cmd(ILI9341_PASET, d, sizeof(d));
+}
+
+static void
+LCD_Init(gui_lcd_t* LCD) {
+    uint8_t d;
+    
+    GUI_UNUSED(LCD);
+    CS_HIGH();
+    send_cmd(ILI9341_SWRESET, NULL, 0);
+    HAL_Delay(5);
+    send_cmd(ILI9341_SLPOUT, NULL, 0);
+    HAL_Delay(120);                             /* Controller needs time to wake up */
+    d = 0x55;                                   /* 16 bits per pixel */
+    send_cmd(ILI9341_PIXFMT, &d, 1);
+    d = 0x28;                                   /* Landscape with row/column exchange, BGR panel order */
+    send_cmd(ILI9341_MADCTL, &d, 1);
+    send_cmd(ILI9341_DISPON, NULL, 0);
+}
+
+/**
+ * \brief           Notify driver that SPI DMA transfer is finished
+ * \note            Call from `HAL_SPI_TxCpltCallback` for display SPI
+ */
+void
+gui_ll_ili9341_txcomplete(void) {
+    int16_t band = tx_band;
+    
+    if (band < 0) {
+        return;
+    }
+    CS_HIGH();
+    tx_band = -1;
+    gui_lcd_confirmflush((uint8_t)band);        /* Band buffer may be drawn again */
+}
+
+uint8_t
+gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void* result) {
+    switch (cmd) {
+        case GUI_LL_Command_Init: {
+            gui_ll_t* LL = (gui_ll_t *)param;
+            
+            /*******************************/
+            /* Assign memory to GUI        */
+            /*******************************/
+            do {
+                static GUI_MEM_Region_t const regions[] = {
+                    {heap, sizeof(heap)},
+                };
+                if (!gui_mem_assignmemory(regions, GUI_COUNT_OF(regions))) {
+                    return 1;                   /* Command processed, result stays failed */
+                }
+            } while (0);
+            
+            /*******************************/
+            /* Set up LCD data             */
+            /*******************************/
+            LCD->width = GUI_LL_ILI9341_WIDTH;
+            LCD->height = GUI_LL_ILI9341_HEIGHT;
+            LCD->pixel_size = 2;                /* RGB565 */
+            
+            /*******************************/
+            /* Set layers count            */
+            /*******************************/
+            LCD->layer_count = 1;               /* Only describes display, GUI draws to band buffers */
+            LCD->layers = &layer;
+            
+            /*******************************/
+            /* Set up LCD drawing routines */
+            /*******************************/
+            LL->Init = LCD_Init;                /* All other functions are set by software drawing */
+            
+            if (result != NULL) {
+                *(uint8_t *)result = 0;         /* Successful initialization */
+            }
+            return 1;                           /* Command processed */
+        }
+        case GUI_LL_Command_Flush: {            /* Stream band to GRAM window */
+            const gui_ll_flush_t* flush = (const gui_ll_flush_t *)param;
+            gui_layer_t* band = flush->band;
+            uint8_t cmd = ILI9341_RAMWR;
+            
+            while (tx_band >= 0) {}             /* Only one transfer on bus, other band is still being sent */
+            set_window(band->x_offset, band->y_offset, band->width, band->height);
+            
+            spi_setdatasize(SPI_DATASIZE_8BIT);
+            CS_LOW();
+            DC_CMD();
+            HAL_SPI_Transmit(&GUI_LL_ILI9341_SPI, &cmd, 1, 10);
+            DC_DATA();
+            spi_setdatasize(SPI_DATASIZE_16BIT);
+            tx_band = band->num;
+            if (HAL_SPI_Transmit_DMA(&GUI_LL_ILI9341_SPI, (uint8_t *)band->start_address,
+                    (uint16_t)((size_t)band->width * (size_t)band->height)) != HAL_OK) {
+                tx_band = -1;
+                CS_HIGH();
+                if (result != NULL) {
+                    *(uint8_t *)result = 1;     /* Transfer not started */
+                }
+                return 1;
+            }
+            
+            if (result != NULL) {
+                *(uint8_t *)result = 0;         /* Band is sent in background */
+            }
+            return 1;                           /* Command processed */
+        }
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,256 @@
+/**	
+ * \file            gui_ll_sdl.c
+ * \brief           Low-level driver for SDL2 host simulator
+ *
+ * \note            Drawing is done by software functions of GUI to memory frame buffers in ARGB8888 format.
+ *                  Frame buffers are copied to SDL window from \ref gui_ll_sdl_process,
+ *                  which must be called periodically from thread which called \ref gui_init
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "system/gui_ll_sdl.h"
+#include "gui/gui_input.h"
+
+#include "SDL.h"
+
+#if !GUI_CFG_LL_SOFTWARE
+#error "SDL low-level driver requires GUI_CFG_LL_SOFTWARE to be enabled"
+#endif /* !GUI_CFG_LL_SOFTWARE */
+#if GUI_CFG_LINKEDLIST_COMPACT && GUI_LL_SDL_HEAP_SIZE > (0xFFFF - 1) * GUI_CFG_MEM_ALIGNMENT
+#error "GUI_LL_SDL_HEAP_SIZE is too big for GUI_CFG_LINKEDLIST_COMPACT links"
+#endif /* GUI_CFG_LINKEDLIST_COMPACT && GUI_LL_SDL_HEAP_SIZE > (0xFFFF - 1) * GUI_CFG_MEM_ALIGNMENT */
+
+#define GUI_LAYERS                  2
+
+static gui_layer_t layers[GUI_LAYERS];
+static uint32_t frame_buffers[GUI_LAYERS][GUI_LL_SDL_WIDTH * GUI_LL_SDL_HEIGHT];
+static uint8_t heap[GUI_LL_SDL_HEAP_SIZE];
+
+static SDL_Window* window;
+static SDL_Renderer* renderer;
+static SDL_Texture* texture;
+static void* pending_layer;                     /* Layer waiting to be shown, accessed with SDL atomics */
+
+static void
+LCD_Init(gui_lcd_t* LCD) {
+    if (SDL_Init(SDL_INIT_VIDEO)) {
+        printf("SDL init failed: %s\r\n", SDL_GetError());
+        exit(1);
+    }
+    window = SDL_CreateWindow("EasyGUI", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+        LCD->width * GUI_LL_SDL_ZOOM, LCD->height * GUI_LL_SDL_ZOOM, 0);
+    renderer = SDL_CreateRenderer(window, -1, 0);
+    SDL_RenderSetLogicalSize(renderer, LCD->width, LCD->height);    /* Mouse events are scaled to LCD coordinates too */
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, LCD->width, LCD->height);
+    SDL_StartTextInput();
+}
+
+/**
+ * \brief           Copy pending layer to window and confirm it to GUI
+ */
+static void
+present_layer(void) {
+    gui_layer_t* layer;
+    
+    layer = SDL_AtomicSetPtr(&pending_layer, NULL);
+    if (layer == NULL) {
+        return;
+    }
+    SDL_UpdateTexture(texture, NULL, (void *)layer->start_address, GUI.lcd.width * GUI.lcd.pixel_size);
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, texture, NULL, NULL);
+    SDL_RenderPresent(renderer);
+    gui_lcd_confirmactivelayer(layer->num);     /* Layer is on screen, GUI may draw to other one */
+}
+
+/**
+ * \brief           Send touch state to GUI
+ * \param[in]       x: X position in LCD coordinates
+ * \param[in]       y: Y position in LCD coordinates
+ * \param[in]       pressed: Set to `1` when mouse button is pressed
+ */
+static void
+send_touch(int x, int y, uint8_t pressed) {
+    gui_touch_data_t t = {0};
+    
+    t.status = pressed ? GUI_TOUCH_STATE_PRESSED : GUI_TOUCH_STATE_RELEASED;
+    t.count = pressed;
+    t.x[0] = (gui_dim_t)x;
+    t.y[0] = (gui_dim_t)y;
+    gui_input_touchadd(&t);
+}
+
+/**
+ * \brief           Send key to GUI, followed by end key as virtual keyboard does
+ * \param[in]       keys: Key bytes, UTF-8 encoded
+ * \param[in]       len: Number of bytes in key
+ */
+static void
+send_key(const char* keys, size_t len) {
+    gui_keyboard_data_t kb = {0};
+    
+    memcpy(kb.keys, keys, GUI_MIN(len, sizeof(kb.keys)));
+    gui_input_keyadd(&kb);
+    memset(kb.keys, 0x00, sizeof(kb.keys));
+    gui_input_keyadd(&kb);
+}
+
+/**
+ * \brief           Process SDL events and show drawn layers
+ * \note            Must be called periodically from thread which called \ref gui_init
+ *
+ *                  Left mouse button acts as touch, text input and
+ *                  special keys are sent as keyboard input
+ *
+ * \param[in]       timeout: Maximal time to wait for event in units of milliseconds
+ * \return          `0` when window was closed, `1` otherwise
+ */
+uint8_t
+gui_ll_sdl_process(uint32_t timeout) {
+    SDL_Event e;
+    uint8_t run = 1;
+    
+    if (SDL_WaitEventTimeout(&e, (int)timeout)) {
+        do {
+            switch (e.type) {
+                case SDL_QUIT:
+                    run = 0;
+                    break;
+                case SDL_MOUSEBUTTONDOWN:
+                case SDL_MOUSEBUTTONUP:
+                    if (e.button.button == SDL_BUTTON_LEFT) {
+                        send_touch(e.button.x, e.button.y, e.type == SDL_MOUSEBUTTONDOWN);
+                    }
+                    break;
+                case SDL_MOUSEMOTION:
+                    if (e.motion.state & SDL_BUTTON_LMASK) {
+                        send_touch(e.motion.x, e.motion.y, 1);
+                    }
+                    break;
+                case SDL_TEXTINPUT: {
+                    const char* t = e.text.text;
+                    size_t len;
+                    
+                    while (*t) {                /* Send characters one by one */
+                        len = (*t & 0x80) == 0x00 ? 1 : (*t & 0xE0) == 0xC0 ? 2 : (*t & 0xF0) == 0xE0 ? 3 : 4;
+                        send_key(t, len);
+                        for (; len && *t; len--) {
+                            t++;
+                        }
+                    }
+                    break;
+                }
+                case SDL_KEYDOWN: {
+                    char key = 0;
+                    switch (e.key.keysym.sym) {
+                        case SDLK_BACKSPACE:    key = (char)GUI_KEY_BACKSPACE; break;
+                        case SDLK_RETURN:       key = (char)GUI_KEY_CR; break;
+                        case SDLK_TAB:          key = (char)GUI_KEY_TAB; break;
+                        case SDLK_ESCAPE:       key = (char)GUI_KEY_ESC; break;
+                        case SDLK_UP:           key = (char)GUI_KEY_UP; break;
+                        case SDLK_DOWN:         key = (char)GUI_KEY_DOWN; break;
+                        case SDLK_LEFT:         key = (char)GUI_KEY_LEFT; break;
+                        case SDLK_RIGHT:        key = (char)GUI_KEY_RIGHT; break;
+                        default: break;
+                    }
+                    if (key) {
+                        send_key(&key, 1);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        } while (SDL_PollEvent(&e));
+    }
+    present_layer();                            /* Show layer if GUI finished one */
+    return run;
+}
+
+uint8_t
+gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void* result) {
+    switch (cmd) {
+        case GUI_LL_Command_Init: {
+            size_t i;
+            gui_ll_t* LL = (gui_ll_t *)param;
+            
+            /*******************************/
+            /* Assign memory to GUI        */
+            /*******************************/
+            do {
+                static GUI_MEM_Region_t const regions[] = {
+                    {heap, sizeof(heap)},
+                };
+                if (!gui_mem_assignmemory(regions, GUI_COUNT_OF(regions))) {
+                    return 1;                   /* Command processed, result stays failed */
+                }
+            } while (0);
+            
+            /*******************************/
+            /* Set up LCD data             */
+            /*******************************/
+            LCD->width = GUI_LL_SDL_WIDTH;
+            LCD->height = GUI_LL_SDL_HEIGHT;
+            LCD->pixel_size = sizeof(frame_buffers[0][0]);  /* ARGB8888 matches SDL texture format */
+            
+            /*******************************/
+            /* Set layers count            */
+            /*******************************/
+            LCD->layer_count = GUI_LAYERS;
+            LCD->layers = layers;
+            for (i = 0; i < GUI_LAYERS; i++) {
+                layers[i].num = (uint8_t)i;
+                layers[i].start_address = (uintptr_t)frame_buffers[i];
+            }
+            
+            /*******************************/
+            /* Set up LCD drawing routines */
+            /*******************************/
+            LL->Init = LCD_Init;                /* All other functions are set by software drawing */
+            
+            if (result != NULL) {
+                *(uint8_t *)result = 0;         /* Successful initialization */
+            }
+            return 1;                           /* Command processed */
+        }
+        case GUI_LL_Command_SetActiveLayer: {   /* Set new active layer */
+            gui_layer_t* layer = *(gui_layer_t **)param;   /* Get layer to show */
+            
+            /* Software drawing is finished at this point, layer is shown from SDL thread */
+            SDL_AtomicSetPtr(&pending_layer, layer);
+            
+            if (result != NULL) {
+                *(uint8_t *)result = 0;         /* Successful layer set as active */
+            }
+            return 1;                           /* Command processed */
+        }
+        default:
+            return 0;
+    }
+}
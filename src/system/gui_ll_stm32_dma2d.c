@@ -35,260 +35,1189 @@
 #include "lcd_discovery.h"
 
 gui_layer_t Layers[GUI_LAYERS];
+#if GUI_CFG_LCD_BACKGROUND
+gui_layer_t BackgroundLayer;                    /* Shown on LTDC layer 0, below drawing layers */
+#endif /* GUI_CFG_LCD_BACKGROUND */
 static DMA2D_HandleTypeDef DMA2DHandle;
+#if USE_JPEG_CODEC
+static JPEG_HandleTypeDef JPEGHandle;
+#endif /* USE_JPEG_CODEC */
 uint16_t startAddress;
 
-#define DMA2D_START(type) do {                  \
-    DMA2D->CR = (type);                         \
-    DMA2D->CR |= 0 | 0;             \
-    DMA2D->CR |= DMA2D_CR_START;                /* Start the transmission */\
-} while (0)
+/**
+ * \brief           Number of DMA2D transfers which can wait in queue
+ */
+#define DMA2D_QUEUE_SIZE            32
+
+/**
+ * \brief           Maximal number of pixels filled by CPU instead of DMA2D
+ *
+ *                  Setup of DMA2D transfer and its interrupt cost more than
+ *                  CPU writing few pixels directly to frame buffer
+ */
+#define DMA2D_CPU_FILL_MAX          64
+
+/**
+ * \brief           Set to `1` to use write-back data cache for frame buffers
+ *
+ *                  CPU drawing then runs from cache. Cache lines are cleaned after CPU writes
+ *                  and invalidated before CPU reads, only for affected rectangles,
+ *                  to keep frame buffers coherent with DMA2D and LTDC.
+ *                  Set to `0` to keep frame buffers write-through, where only reads are cached
+ */
+#ifndef FRAME_BUFFER_WRITEBACK
+#define FRAME_BUFFER_WRITEBACK      1
+#endif
+
+/**
+ * \brief           Maximal number of bytes for cache maintenance by address
+ *
+ *                  Cleaning or invalidating more data than cache can hold is slower by address
+ *                  than processing complete data cache at once
+ */
+#define DCACHE_BY_ADDR_MAX          0x4000
+
+/**
+ * \brief           Size of data cache line in units of bytes
+ */
+#define DCACHE_LINE_SIZE            32
+
+/**
+ * \brief           Set to `1` when hardware JPEG codec and DMA2D with YCbCr input are available,
+ *                  for example on STM32F769 and STM32H7
+ */
+#if defined(HAL_JPEG_MODULE_ENABLED) && defined(DMA2D_INPUT_YCBCR)
+#define USE_JPEG_CODEC              1
+#else
+#define USE_JPEG_CODEC              0
+#endif
+
+/**
+ * \brief           Set to `1` when MDMA is available, for example on STM32H7
+ *
+ *                  Regions of previous frame are then copied to drawing layer by MDMA
+ *                  with one linked list transfer, while DMA2D continues with drawing
+ */
+#if defined(MDMA) && defined(HAL_MDMA_MODULE_ENABLED)
+#define USE_MDMA                    1
+#else
+#define USE_MDMA                    0
+#endif
+
+/*
+ * DMA2D cannot write L8 pixels. Blending, characters and images are drawn by software
+ * functions of GUI, DMA2D only fills and copies indexed frame buffers
+ */
+#if LCD_PIXEL_SIZE == 1 && (!GUI_CFG_LCD_CLUT || !GUI_CFG_LL_SOFTWARE)
+#error "L8 frame buffer requires GUI_CFG_LCD_CLUT and GUI_CFG_LL_SOFTWARE to be enabled"
+#endif /* LCD_PIXEL_SIZE == 1 && (!GUI_CFG_LCD_CLUT || !GUI_CFG_LL_SOFTWARE) */
+
+/**
+ * \brief           Total size of frame buffers, placed one after another from \ref LCD_FRAME_BUFFER
+ */
+#if GUI_CFG_LCD_BACKGROUND
+#define FRAME_BUFFERS_SIZE          (GUI_LAYERS * LCD_FRAME_BUFFER_SIZE + LCD_WIDTH * LCD_HEIGHT * LCD_PIXEL_SIZE)
+#else
+#define FRAME_BUFFERS_SIZE          (GUI_LAYERS * LCD_FRAME_BUFFER_SIZE)
+#endif /* GUI_CFG_LCD_BACKGROUND */
+
+/**
+ * \brief           Single DMA2D transfer with register setup
+ */
+typedef struct {
+    uint32_t mode;                              /*!< Transfer mode for CR register */
+    uint32_t fgmar;                             /*!< Foreground memory address */
+    uint32_t bgmar;                             /*!< Background memory address */
+    uint32_t omar;                              /*!< Output memory address */
+    uint32_t fgor;                              /*!< Foreground offline */
+    uint32_t bgor;                              /*!< Background offline */
+    uint32_t oor;                               /*!< Output offline */
+    uint32_t fgpfccr;                           /*!< Foreground pixel format */
+    uint32_t bgpfccr;                           /*!< Background pixel format */
+    uint32_t opfccr;                            /*!< Output pixel format */
+    uint32_t fgcmar;                            /*!< Foreground CLUT address or 0 if CLUT is not used */
+    uint32_t clut;                              /*!< CLUT size for FGPFCCR register */
+    uint32_t fgcolr;                            /*!< Foreground color */
+    uint32_t ocolr;                             /*!< Output color */
+    uint32_t nlr;                               /*!< Number of pixels per line and number of lines */
+} dma2d_cmd_t;
+
+static dma2d_cmd_t Queue[DMA2D_QUEUE_SIZE];     /* Ring buffer of transfers */
+static volatile uint32_t QueueIn, QueueOut;     /* Write and read indexes */
+static volatile uint8_t QueueBusy;              /* Set to 1 when transfer from queue is in progress */
+static volatile uint32_t QueuePut, QueueDone;   /* Number of queued and finished transfers */
+static gui_layer_t* volatile PendingLayer;      /* Layer to show when all queued transfers are finished */
+static uint32_t LoadedCLUT;                     /* Address of CLUT currently loaded to DMA2D */
+#if GUI_CFG_USE_METRICS
+static uint32_t BusyStart, BusyTime, LoadStart; /* Time DMA2D started working, its total busy time and start of measurement */
+#endif /* GUI_CFG_USE_METRICS */
+#if USE_MDMA
+static volatile uint8_t MdmaBusy;               /* Set to 1 while MDMA copies regions */
+static uint32_t MdmaSpans[GUI_CFG_DISPLAY_DIRTY_RECTS][2];  /* First and last + 1 address written by MDMA for each region */
+static size_t MdmaCount;                        /* Number of regions copied by MDMA */
+static MDMA_LinkNodeTypeDef MdmaNodes[GUI_CFG_DISPLAY_DIRTY_RECTS] __ALIGNED(DCACHE_LINE_SIZE); /* Linked list of regions after first one */
+
+/**
+ * \brief           Check if DMA2D transfer accesses memory MDMA is writing to
+ * \note            Lines of transfer and regions are compared as continuous address ranges
+ * \param[in]       cmd: DMA2D transfer
+ * \return          `1` if transfer must wait for MDMA, `0` otherwise
+ */
+static uint8_t
+mdma_isused(const dma2d_cmd_t* cmd) {
+    uint32_t ps, len, i;
+    
+    switch (cmd->opfccr & DMA2D_OPFCCR_CM) {
+        case DMA2D_OUTPUT_RGB565:   ps = 2; break;
+        case DMA2D_OUTPUT_RGB888:   ps = 3; break;
+        default:                    ps = 4; break;
+    }
+    if (cmd->mode == DMA2D_M2M && (cmd->fgpfccr & DMA2D_FGPFCCR_CM) == DMA2D_INPUT_L8) {
+        ps = 1;                                 /* Indexed copy without conversion */
+    }
+    len = (((cmd->nlr & 0xFFFF) - 1) * ((cmd->nlr >> 16) + cmd->oor) + (cmd->nlr >> 16)) * ps;
+    for (i = 0; i < MdmaCount; i++) {
+        if (cmd->omar < MdmaSpans[i][1] && cmd->omar + len > MdmaSpans[i][0]) {
+            return 1;                           /* Output is written by both */
+        }
+        if (cmd->mode == DMA2D_M2M && cmd->fgmar < MdmaSpans[i][1] && cmd->fgmar + len > MdmaSpans[i][0]) {
+            return 1;                           /* Copy within layer reads region not copied yet */
+        }
+    }
+    return 0;
+}
+#else
+#define MdmaBusy                    0           /* DMA2D works alone */
+#endif /* USE_MDMA */
+
+/**
+ * \brief           Start next transfer from queue if available
+ * \note            Called from DMA2D interrupt or with DMA2D interrupt disabled
+ */
+static void
+dma2d_start_next(void) {
+    dma2d_cmd_t* cmd = &Queue[QueueOut];
+    
+    if (QueueOut == QueueIn                     /* Nothing more to do */
+#if USE_MDMA
+        || (MdmaBusy && mdma_isused(cmd))       /* Continued from MDMA interrupt when copy is done */
+#endif /* USE_MDMA */
+        ) {
+#if GUI_CFG_USE_METRICS
+        if (QueueBusy) {
+            BusyTime += GUI_CFG_STATS_TIME() - BusyStart;
+        }
+#endif /* GUI_CFG_USE_METRICS */
+        QueueBusy = 0;
+        if (PendingLayer != NULL && QueueOut == QueueIn && !MdmaBusy) { /* Layer is fully drawn now */
+            PendingLayer->pending = 1;          /* Display driver shows it on next refresh */
+            PendingLayer = NULL;
+        }
+        return;
+    }
+    DMA2D->FGMAR = cmd->fgmar;
+    DMA2D->BGMAR = cmd->bgmar;
+    DMA2D->OMAR = cmd->omar;
+    DMA2D->FGOR = cmd->fgor;
+    DMA2D->BGOR = cmd->bgor;
+    DMA2D->OOR = cmd->oor;
+    if (cmd->fgcmar && cmd->fgcmar != LoadedCLUT) { /* Load new CLUT, the same palette is loaded only once */
+        DMA2D->FGCMAR = cmd->fgcmar;
+        DMA2D->FGPFCCR = cmd->fgpfccr | cmd->clut | DMA2D_FGPFCCR_START;
+        while (!(DMA2D->ISR & (DMA2D_ISR_CTCIF | DMA2D_ISR_CAEIF)));  /* CLUT of up to 256 colors is loaded quickly */
+        DMA2D->IFCR = DMA2D_IFCR_CCTCIF | DMA2D_IFCR_CAECIF;
+        LoadedCLUT = cmd->fgcmar;
+    }
+    DMA2D->FGPFCCR = cmd->fgpfccr | cmd->clut;
+    DMA2D->BGPFCCR = cmd->bgpfccr;
+    DMA2D->OPFCCR = cmd->opfccr;
+    DMA2D->FGCOLR = cmd->fgcolr;
+    DMA2D->OCOLR = cmd->ocolr;
+    DMA2D->NLR = cmd->nlr;
+    QueueOut = (QueueOut + 1) % DMA2D_QUEUE_SIZE;
+#if GUI_CFG_USE_METRICS
+    if (!QueueBusy) {
+        BusyStart = GUI_CFG_STATS_TIME();       /* DMA2D starts working after idle time */
+    }
+#endif /* GUI_CFG_USE_METRICS */
+    QueueBusy = 1;
+    
+    DMA2D->CR = cmd->mode | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE;
+    DMA2D->CR |= DMA2D_CR_START;                /* Start the transmission */
+}
+
+/**
+ * \brief           Get free entry in queue for new transfer
+ * \note            Function waits for free slot if queue is full
+ * \return          Pointer to cleared command to fill
+ */
+static dma2d_cmd_t *
+dma2d_get_cmd(void) {
+    dma2d_cmd_t* cmd;
+    
+    while ((QueueIn + 1) % DMA2D_QUEUE_SIZE == QueueOut);    /* Wait for free slot */
+    cmd = &Queue[QueueIn];
+    memset(cmd, 0x00, sizeof(*cmd));
+    return cmd;
+}
+
+/**
+ * \brief           Put filled command to queue and start transfer if DMA2D is idle
+ * \param[in]       mode: DMA2D transfer mode
+ */
+static void
+dma2d_put_cmd(uint32_t mode) {
+    Queue[QueueIn].mode = mode;
+    
+    HAL_NVIC_DisableIRQ(DMA2D_IRQn);            /* Prevent interrupt to start transfer at the same time */
+    QueueIn = (QueueIn + 1) % DMA2D_QUEUE_SIZE; /* Publish new command */
+    QueuePut++;
+    if (!QueueBusy) {
+        dma2d_start_next();
+    }
+    HAL_NVIC_EnableIRQ(DMA2D_IRQn);
+}
+
+/**
+ * \brief           Wait until all queued transfers are finished
+ * \note            Use it before CPU access to memory used by DMA2D
+ */
+static void
+dma2d_wait(void) {
+    while (QueueBusy || MdmaBusy || (DMA2D->CR & DMA2D_CR_START));
+}
+
+#if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+/**
+ * \brief           Clean or invalidate complete data cache
+ * \note            Complete cache is never only invalidated, it may hold data of other memories
+ * \param[in]       clean: Set to `1` to clean after CPU write or `0` to invalidate before CPU read
+ */
+static void
+dcache_all(uint8_t clean) {
+    if (clean) {
+        SCB_CleanDCache();
+    } else {
+        SCB_CleanInvalidateDCache();
+    }
+}
+
+/**
+ * \brief           Clean or invalidate cache lines of memory
+ * \note            When there is more data than cache can hold, complete cache is processed at once
+ * \param[in]       addr: Start address of memory
+ * \param[in]       size: Number of bytes
+ * \param[in]       clean: Set to `1` to clean after CPU write or `0` to invalidate before CPU read
+ */
+static void
+dcache_range(const void* addr, uint32_t size, uint8_t clean) {
+    uint32_t* start = (uint32_t *)((uint32_t)addr & ~(DCACHE_LINE_SIZE - 1));
+    
+    size += (uint32_t)addr & (DCACHE_LINE_SIZE - 1);
+    if (size > DCACHE_BY_ADDR_MAX) {
+        dcache_all(clean);
+    } else if (clean) {
+        SCB_CleanDCache_by_Addr(start, size);
+    } else {
+        SCB_InvalidateDCache_by_Addr(start, size);
+    }
+}
+#endif /* defined(__DCACHE_PRESENT) && __DCACHE_PRESENT */
+
+/**
+ * \brief           Keep rectangle of layer memory coherent around CPU access
+ * \note            Before access, pending transfers are finished and cache lines are invalidated
+ *                  to get data written by DMA2D. After access, cache lines are cleaned
+ *                  so DMA2D and LTDC see data written by CPU.
+ *
+ * \note            Only lines of rectangle are processed, not pixels of other widgets between them
+ * \param[in]       layer: Layer memory belongs to, selects pixel size
+ * \param[in]       addr: Address of top left pixel
+ * \param[in]       xSize: Number of pixels per line
+ * \param[in]       ySize: Number of lines
+ * \param[in]       OffLine: Number of pixels to skip after each line
+ * \param[in]       end: Set to `1` when CPU access has finished, `0` before CPU access
+ */
+static void
+cpu_access_rect(gui_layer_t* layer, const void* addr, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t OffLine, uint8_t end) {
+#if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+    uint32_t line = (uint32_t)xSize * layer->pixel_size;
+    uint32_t stride = (uint32_t)(xSize + OffLine) * layer->pixel_size;
+    const uint8_t* ptr = (const uint8_t *)addr;
+    gui_dim_t y;
+#endif /* defined(__DCACHE_PRESENT) && __DCACHE_PRESENT */
+    
+    if (!end) {
+        dma2d_wait();                               /* CPU accesses memory, wait for pending transfers */
+    }
+#if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+    if (SCB->CCR & SCB_CCR_DC_Msk) {
+        if (ySize == 1 || stride - line < DCACHE_LINE_SIZE) {   /* Lines share cache lines, use single range */
+            dcache_range(addr, (uint32_t)(ySize - 1) * stride + line, end);
+        } else if ((uint32_t)ySize * (line + DCACHE_LINE_SIZE) > DCACHE_BY_ADDR_MAX) {
+            dcache_all(end);                        /* Complete cache at once */
+        } else {
+            for (y = 0; y < ySize; y++, ptr += stride) {
+                dcache_range(ptr, line, end);
+            }
+        }
+    }
+#else
+    GUI_UNUSED(layer);
+    GUI_UNUSED(addr);
+    GUI_UNUSED(xSize);
+    GUI_UNUSED(ySize);
+    GUI_UNUSED(OffLine);
+#endif /* defined(__DCACHE_PRESENT) && __DCACHE_PRESENT */
+}
+
+/**
+ * \brief           Prepare frame buffer memory for CPU access
+ * \note            Cache lines are invalidated to get data written by DMA2D
+ * \param[in]       addr: Start address of memory
+ * \param[in]       size: Number of bytes CPU will access
+ */
+static void
+cpu_access_begin(const void* addr, uint32_t size) {
+    dma2d_wait();                                   /* CPU accesses memory, wait for pending transfers */
+#if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+    if (SCB->CCR & SCB_CCR_DC_Msk) {
+        dcache_range(addr, size, 0);
+    }
+#else
+    GUI_UNUSED(addr);
+    GUI_UNUSED(size);
+#endif /* defined(__DCACHE_PRESENT) && __DCACHE_PRESENT */
+}
+
+/**
+ * \brief           Finish CPU write access to frame buffer memory
+ * \note            Cache lines are cleaned so DMA2D and LTDC see data written by CPU
+ * \param[in]       addr: Start address of memory
+ * \param[in]       size: Number of bytes CPU has written
+ */
+static void
+cpu_access_end(const void* addr, uint32_t size) {
+#if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+    if (SCB->CCR & SCB_CCR_DC_Msk) {
+        dcache_range(addr, size, 1);
+    }
+#else
+    GUI_UNUSED(addr);
+    GUI_UNUSED(size);
+#endif /* defined(__DCACHE_PRESENT) && __DCACHE_PRESENT */
+}
+
+#if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+/**
+ * \brief           Set memory attributes of SDRAM with MPU
+ * \note            Frame buffers are cached according to \ref FRAME_BUFFER_WRITEBACK.
+ *                  Rest of SDRAM holds heap with data written by CPU and read by DMA2D
+ *                  (font cache, retained bitmaps), it is normal memory without cache
+ *
+ * \note            Heap must not start inside last 1/8 part of frame buffer region
+ */
+static void
+mpu_config(void) {
+    MPU_Region_InitTypeDef r = {0};
+    uint32_t size;
+    uint8_t n;
+    
+    if (SCB->CCR & SCB_CCR_DC_Msk) {
+        SCB_CleanInvalidateDCache();                /* Attributes of cached lines change */
+    }
+    HAL_MPU_Disable();
+    
+    /* Complete SDRAM, normal memory without cache */
+    for (n = 4; (2UL << n) < SDRAM_MEMORY_SIZE; n++) {} /* Region size is 2 ^ (n + 1) bytes */
+    r.Enable = MPU_REGION_ENABLE;
+    r.Number = MPU_REGION_NUMBER6;
+    r.BaseAddress = SDRAM_START_ADR;
+    r.Size = n;
+    r.SubRegionDisable = 0x00;
+    r.TypeExtField = MPU_TEX_LEVEL1;
+    r.AccessPermission = MPU_REGION_FULL_ACCESS;
+    r.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+    r.IsShareable = MPU_ACCESS_NOT_SHAREABLE;
+    r.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
+    r.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+    HAL_MPU_ConfigRegion(&r);
+    
+    /* Frame buffers, only subregions they occupy are enabled */
+    for (n = 4; (2UL << n) < FRAME_BUFFERS_SIZE; n++) {}
+    size = (2UL << n) / 8;                          /* Size of one subregion */
+    r.Number = MPU_REGION_NUMBER7;                  /* Higher region number has priority */
+    r.BaseAddress = LCD_FRAME_BUFFER;
+    r.Size = n;
+    r.SubRegionDisable = (uint8_t)(0xFFU << ((FRAME_BUFFERS_SIZE + size - 1) / size));
+#if FRAME_BUFFER_WRITEBACK
+    r.TypeExtField = MPU_TEX_LEVEL1;                /* Write-back, write and read allocate */
+    r.IsBufferable = MPU_ACCESS_BUFFERABLE;
+#else
+    r.TypeExtField = MPU_TEX_LEVEL0;                /* Write-through, no write allocate */
+    r.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+#endif /* FRAME_BUFFER_WRITEBACK */
+    r.IsCacheable = MPU_ACCESS_CACHEABLE;
+    HAL_MPU_ConfigRegion(&r);
+    
+    HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);         /* Default memory map for other memories */
+}
+#endif /* defined(__DCACHE_PRESENT) && __DCACHE_PRESENT */
 
 static
 void LCD_Init(gui_lcd_t* LCD) {
     TM_SDRAM_Init();                                /* Init SDRAM */
     
     DMA2DHandle.Instance = DMA2D;
+#if USE_JPEG_CODEC
+    __HAL_RCC_JPEG_CLK_ENABLE();
+    JPEGHandle.Instance = JPEG;
+    HAL_JPEG_Init(&JPEGHandle);
+#endif /* USE_JPEG_CODEC */
     
     _LCD_Init();                                    /* Init LCD */
 }
 
 static
 uint32_t GetPixelFormat(gui_layer_t* layer) {
-#if defined(LCD_COLOR_FORMAT_ARGB8888)
-    return DMA2D_OUTPUT_ARGB8888;                   /* ARGB8888 format */
-#else
-    return DMA2D_OUTPUT_RGB565;                     /* RGB565 format */
-#endif /* defined(LCD_COLOR_FORMAT_ARGB8888) */
+    switch (layer->pixel_format) {
+        case GUI_PIXEL_FORMAT_RGB565:   return DMA2D_OUTPUT_RGB565;
+        case GUI_PIXEL_FORMAT_RGB888:   return DMA2D_OUTPUT_RGB888;
+        default:                        return DMA2D_OUTPUT_ARGB8888;
+    }
+}
+
+/**
+ * \brief           Convert ARGB8888 color to pixel value of layer format
+ * \note            Last conversion is remembered, the same color is usually used for many calls
+ * \param[in]       layer: Layer to get format from
+ * \param[in]       color: Color to convert
+ * \return          Pixel value for DMA2D output color register
+ */
+static uint32_t
+color_to_pixel(gui_layer_t* layer, gui_color_t color) {
+    static gui_color_t last_color;
+    static uint32_t last_pixel;
+    static uint8_t last_format = GUI_PIXEL_FORMAT_DEFAULT;
+    
+    if (layer->pixel_format == GUI_PIXEL_FORMAT_ARGB8888) {
+        return color;
+    }
+    if (color != last_color || layer->pixel_format != last_format) {
+        last_color = color;
+        last_format = layer->pixel_format;
+#if GUI_CFG_LCD_CLUT
+        if (last_format == GUI_PIXEL_FORMAT_L8) {
+            last_pixel = guii_lcd_colortoindex(color);
+        } else
+#endif /* GUI_CFG_LCD_CLUT */
+        if (last_format == GUI_PIXEL_FORMAT_RGB565) {
+            last_pixel = ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+        } else {
+            last_pixel = color & 0x00FFFFFFUL;
+        }
+    }
+    return last_pixel;
 }
 
 static
 uint8_t LCD_Ready(gui_lcd_t* LCD) {
-    return !(DMA2D->CR & DMA2D_CR_START);           /* Return status */
+    return !QueueBusy && !MdmaBusy && !(DMA2D->CR & DMA2D_CR_START);   /* Return status */
 }
 
 static
 gui_color_t LCD_GetPixel(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y) {
-#if defined(LCD_COLOR_FORMAT_ARGB8888)
-    return *(gui_color_t *)(layer->start_address + GUI.lcd.pixel_size * (layer->width * y + x));
-#else
-    gui_color_t color;
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait till end */
+    const uint8_t* addr = (const uint8_t *)(layer->start_address + layer->pixel_size * (layer->width * y + x));
+    uint32_t r, g, b;
+    uint16_t pixel;
     
-    DMA2D->FGMAR = (uint32_t)(layer->start_address + GUI.lcd.pixel_size * (layer->width * y + x));
-    DMA2D->OMAR = (uint32_t)&color;                 /* Set output address */
-    DMA2D->FGOR = 0;                                /* Set foreground offline */    
-    DMA2D->OOR = 0;                                 /* Set output offline */
-    DMA2D->FGPFCCR = GetPixelFormat(layer);         /* Get source pixel format */
-    DMA2D->OPFCCR = LTDC_PIXEL_FORMAT_ARGB8888;     /* Set output pixel format */
-    DMA2D->NLR = (uint32_t)(1 << 16) | (uint16_t)1; /* Set X and Y */
+    cpu_access_begin(addr, layer->pixel_size);
+    switch (layer->pixel_format) {                  /* Read pixel directly, DMA2D transfer is too slow for single pixel */
+        case GUI_PIXEL_FORMAT_RGB565:
+            pixel = *(const uint16_t *)addr;
+            r = (pixel >> 11) & 0x1F;               /* Expand to 8-bit channels the same way as DMA2D */
+            g = (pixel >>  5) & 0x3F;
+            b = (pixel >>  0) & 0x1F;
+            return 0xFF000000UL | ((r << 3) | (r >> 2)) << 16 | ((g << 2) | (g >> 4)) << 8 | ((b << 3) | (b >> 2));
+        case GUI_PIXEL_FORMAT_RGB888:
+            return 0xFF000000UL | ((uint32_t)addr[2] << 16) | ((uint32_t)addr[1] << 8) | addr[0];
+#if GUI_CFG_LCD_CLUT
+        case GUI_PIXEL_FORMAT_L8:
+            return 0xFF000000UL | (*addr < LCD->palette_size ? LCD->palette[*addr] : 0);
+#endif /* GUI_CFG_LCD_CLUT */
+        default:
+            return *(const gui_color_t *)addr;
+    }
+}
 
-    DMA2D_START(DMA2D_M2M_PFC);                     /* Start DMA2D transfer */
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait till end */
-    return 0xFF000000UL | color;
-#endif /* defined(LCD_COLOR_FORMAT_ARGB8888) */
+/**
+ * \brief           Fill small area with CPU
+ * \param[in]       layer: Layer to fill, selects pixel format
+ * \param[in]       dst: Destination address
+ * \param[in]       xSize: Number of pixels per line
+ * \param[in]       ySize: Number of lines
+ * \param[in]       OffLine: Number of pixels to skip after each line
+ * \param[in]       color: Color already converted to layer pixel format
+ */
+static void
+cpu_fill(gui_layer_t* layer, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t OffLine, uint32_t color) {
+    gui_dim_t x, y;
+    
+    cpu_access_rect(layer, dst, xSize, ySize, OffLine, 0);
+    if (layer->pixel_size == 1) {
+        uint8_t* ptr = (uint8_t *)dst;
+        for (y = 0; y < ySize; y++, ptr += xSize + OffLine) {
+            memset(ptr, (int)color, xSize);
+        }
+    } else if (layer->pixel_format == GUI_PIXEL_FORMAT_RGB565) {
+        uint16_t* ptr = (uint16_t *)dst;
+        for (y = 0; y < ySize; y++, ptr += OffLine) {
+            for (x = 0; x < xSize; x++) {
+                *ptr++ = (uint16_t)color;
+            }
+        }
+    } else if (layer->pixel_format == GUI_PIXEL_FORMAT_RGB888) {
+        uint8_t* ptr = (uint8_t *)dst;
+        for (y = 0; y < ySize; y++, ptr += 3 * OffLine) {
+            for (x = 0; x < xSize; x++, ptr += 3) {
+                ptr[0] = (uint8_t)color;
+                ptr[1] = (uint8_t)(color >> 8);
+                ptr[2] = (uint8_t)(color >> 16);
+            }
+        }
+    } else {
+        uint32_t* ptr = (uint32_t *)dst;
+        for (y = 0; y < ySize; y++, ptr += OffLine) {
+            for (x = 0; x < xSize; x++) {
+                *ptr++ = color;
+            }
+        }
+    }
+    cpu_access_rect(layer, dst, xSize, ySize, OffLine, 1);
 }
 
 static
 void LCD_Fill(gui_lcd_t* LCD, gui_layer_t* layer, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t OffLine, gui_color_t color) {
-#if LCD_PIXEL_SIZE == 2
-    uint8_t r, g, b;
-//    r = (color >> 20) & 0x0F;
-//    g = (color >> 12) & 0x0F;
-//    b = (color >>  4) & 0x0F;
-//    color = 0x0000F000UL | (r << 8) | (g << 4) | b;
-    r = (color >> 19) & 0x1F;
-    g = (color >> 10) & 0x3F;
-    b = (color >>  3) & 0x1F;
-    color = 0x00000000UL | (r << 11) | (g << 5) | b;
-#endif
+    uint32_t opfccr = GetPixelFormat(layer);
+    dma2d_cmd_t* cmd;
+    
     if (!xSize || !ySize) {
         return;
     }
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->OCOLR = color;                           /* Color to be used */
-    DMA2D->OMAR = (uint32_t)dst;                    /* Destination address */
-    DMA2D->OOR = OffLine;                           /* Destination line offset */
-    DMA2D->OPFCCR = GetPixelFormat(layer);          /* Defines the number of pixels to be transfered */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; /* Size configuration of area to be transfered */
+    color = color_to_pixel(layer, color);           /* Output color register uses layer format */
+#if GUI_CFG_LCD_CLUT
+    if (layer->pixel_format == GUI_PIXEL_FORMAT_L8) {
+        /* Aligned area is filled as ARGB8888 area with 4 indices in each word, others with CPU */
+        if ((((uint32_t)dst | (uint32_t)xSize | (uint32_t)OffLine) & 0x03) || (uint32_t)xSize * ySize <= 4 * DMA2D_CPU_FILL_MAX) {
+            cpu_fill(layer, dst, xSize, ySize, OffLine, color);
+            return;
+        }
+        color *= 0x01010101UL;
+        xSize >>= 2;
+        OffLine >>= 2;
+        opfccr = DMA2D_OUTPUT_ARGB8888;
+    } else
+#endif /* GUI_CFG_LCD_CLUT */
+    if ((uint32_t)xSize * ySize <= DMA2D_CPU_FILL_MAX) {    /* Small areas are faster with CPU */
+        cpu_fill(layer, dst, xSize, ySize, OffLine, color);
+        return;
+    }
+    cmd = dma2d_get_cmd();                          /* Get free queue entry */
+    cmd->ocolr = color;                             /* Color to be used */
+    cmd->omar = (uint32_t)dst;                      /* Destination address */
+    cmd->oor = OffLine;                             /* Destination line offset */
+    cmd->opfccr = opfccr;                           /* Defines the number of pixels to be transfered */
+    cmd->nlr = (uint32_t)(xSize << 16) | (uint16_t)ySize;   /* Size configuration of area to be transfered */
     
-    DMA2D_START(DMA2D_R2M);                         /* Start DMA2D transfer */
+    dma2d_put_cmd(DMA2D_R2M);                       /* Queue DMA2D transfer */
 }
 
 static
 void LCD_Copy(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
     uint32_t PixelFormat = GetPixelFormat(layer);
+    dma2d_cmd_t* cmd;
     
     if (!xSize || !ySize) {
         return;
     }
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = PixelFormat;
-    DMA2D->BGPFCCR = PixelFormat;
-    DMA2D->OPFCCR = PixelFormat;
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+    cmd = dma2d_get_cmd();                          /* Get free queue entry */
+    cmd->fgmar = (uint32_t)src;
+    cmd->bgmar = (uint32_t)dst;
+    cmd->omar = (uint32_t)dst;
+    cmd->fgor = offLineSrc;
+    cmd->bgor = offLineDst;
+    cmd->oor = offLineDst;
+    cmd->fgpfccr = PixelFormat;
+    cmd->bgpfccr = PixelFormat;
+    cmd->opfccr = PixelFormat;
+#if GUI_CFG_LCD_CLUT
+    if (layer->pixel_format == GUI_PIXEL_FORMAT_L8) {
+        cmd->fgpfccr = DMA2D_INPUT_L8;              /* Copy without conversion has pixel size of foreground */
+    }
+#endif /* GUI_CFG_LCD_CLUT */
+    cmd->nlr = (uint32_t)(xSize << 16) | (uint16_t)ySize;
     
-    DMA2D_START(DMA2D_M2M);                         /* Start DMA2D transfer */
+    dma2d_put_cmd(DMA2D_M2M);                       /* Queue DMA2D transfer */
 }
 
+#if USE_MDMA
+/**
+ * \brief           Copy regions from source layer to destination layer with MDMA
+ *
+ *                  All regions are copied with single linked list transfer, one node per region.
+ *                  DMA2D meanwhile continues with queued transfers which do not access copied memory
+ */
+static
+void LCD_CopyRects(gui_lcd_t* LCD, gui_layer_t* layer, const gui_layer_t* src, const gui_display_t* rects, size_t count) {
+    MDMA_Channel_TypeDef* ch = MDMA_Channel0;
+    MDMA_LinkNodeTypeDef first, *node = &first;
+    uint32_t sa, da, line, soff, doff, lines, size;
+    size_t i, n = 0;
+    
+    dma2d_wait();                                   /* Drawing of both layers and previous copy are finished */
+    for (i = 0; i < count; i++, rects++) {
+        if (rects->x2 <= rects->x1 || rects->y2 <= rects->y1) {
+            continue;
+        }
+        line = (uint32_t)(rects->x2 - rects->x1) * layer->pixel_size;
+        lines = (uint32_t)(rects->y2 - rects->y1);
+        sa = src->start_address + src->pixel_size * (src->width * rects->y1 + rects->x1);
+        da = layer->start_address + layer->pixel_size * (layer->width * rects->y1 + rects->x1);
+        soff = (uint32_t)src->width * src->pixel_size - line;
+        doff = (uint32_t)layer->width * layer->pixel_size - line;
+        size = sa | da | line | soff | doff;        /* Widest access all addresses are aligned to */
+        size = (size & 0x01) ? 0 : (size & 0x02) ? 1 : 2;
+        
+        if (n) {                                    /* Link previous node to this one */
+            node->CLAR = (uint32_t)&MdmaNodes[n - 1];
+            node = &MdmaNodes[n - 1];
+        }
+        node->CTCR = MDMA_CTCR_BWM | MDMA_CTCR_SWRM | MDMA_CTCR_TRGM   /* Complete list is transferred on one software request */
+            | (127UL << MDMA_CTCR_TLEN_Pos)         /* 128 bytes per buffer transfer */
+            | (size << MDMA_CTCR_DINCOS_Pos) | (size << MDMA_CTCR_SINCOS_Pos)
+            | (size << MDMA_CTCR_DSIZE_Pos) | (size << MDMA_CTCR_SSIZE_Pos)
+            | MDMA_CTCR_DINC_1 | MDMA_CTCR_SINC_1;  /* Increment both addresses */
+        node->CBNDTR = line | ((lines - 1) << MDMA_CBNDTR_BRC_Pos); /* One block per line */
+        node->CSAR = sa;
+        node->CDAR = da;
+        node->CBRUR = (doff << MDMA_CBRUR_DUV_Pos) | soff;  /* Skip rest of line after each block */
+        node->CLAR = 0;                             /* Last node for now */
+        node->CTBR = 0;                             /* Both memories are on AXI bus */
+        node->CMAR = 0;
+        node->CMDR = 0;
+        
+        MdmaSpans[n][0] = da;
+        MdmaSpans[n][1] = da + (lines - 1) * (line + doff) + line;
+        n++;
+    }
+    if (!n) {
+        return;
+    }
+    cpu_access_end(MdmaNodes, sizeof(MdmaNodes));   /* MDMA loads nodes from memory */
+    
+    ch->CCR = 0;                                    /* Channel is configured while disabled */
+    ch->CIFCR = MDMA_CIFCR_CTEIF | MDMA_CIFCR_CCTCIF | MDMA_CIFCR_CBRTIF | MDMA_CIFCR_CBTIF | MDMA_CIFCR_CLTCIF;
+    ch->CTCR = first.CTCR;
+    ch->CBNDTR = first.CBNDTR;
+    ch->CSAR = first.CSAR;
+    ch->CDAR = first.CDAR;
+    ch->CBRUR = first.CBRUR;
+    ch->CLAR = first.CLAR;
+    ch->CTBR = first.CTBR;
+    ch->CMAR = 0;
+    ch->CMDR = 0;
+    
+    MdmaCount = n;
+    MdmaBusy = 1;                                   /* DMA2D is idle, nothing checks regions meanwhile */
+    ch->CCR = MDMA_CCR_PL_1 | MDMA_CCR_CTCIE | MDMA_CCR_TEIE | MDMA_CCR_EN;
+    ch->CCR |= MDMA_CCR_SWRQ;                       /* Start linked list transfer */
+}
+#endif /* USE_MDMA */
+
 /* Copy layers with blending with alpha combine */
 static
 void LCD_CopyBlending(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, uint8_t alphaSrc, uint8_t alphaDst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
     uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = PixelFormat;                   /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
+    dma2d_cmd_t* cmd = dma2d_get_cmd();             /* Get free queue entry */
+    
+    cmd->fgmar = (uint32_t)src;
+    cmd->bgmar = (uint32_t)dst;                       
+    cmd->omar = (uint32_t)dst;
+    cmd->fgor = offLineSrc;
+    cmd->bgor = offLineDst;
+    cmd->oor = offLineDst;
+    cmd->fgpfccr = PixelFormat;                     /* Foreground PFC Control Register */
+    cmd->bgpfccr = PixelFormat;                     /* Background PFC Control Register (Defines the BG pixel format) */
+    cmd->opfccr  = PixelFormat;                     /* Output     PFC Control Register (Defines the output pixel format) */
     
-    DMA2D->FGPFCCR |= DMA2D_FGPFCCR_AM_0 | alphaSrc << 24;               /* Set alpha for source */
-    DMA2D->BGPFCCR |= alphaDst << 24;               /* Set alpha for destination */
+    cmd->fgpfccr |= DMA2D_FGPFCCR_AM_0 | alphaSrc << 24;    /* Set alpha for source */
+    cmd->bgpfccr |= alphaDst << 24;                 /* Set alpha for destination */
     
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+    cmd->nlr = (uint32_t)(xSize << 16) | (uint16_t)ySize;
     
-    DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
+    dma2d_put_cmd(DMA2D_M2M_BLEND);                 /* Queue DMA2D transfer */
 }
 
-static
-void LCD_DrawImage16(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+/**
+ * \brief           Queue image blending with selected input pixel format
+ */
+static void
+draw_image(gui_layer_t* layer, uint32_t fgpfccr, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
     uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
+    dma2d_cmd_t* cmd;
+    
     if (!xSize || !ySize) {
         return;
     }
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = DMA2D_INPUT_RGB565;            /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
+    cmd = dma2d_get_cmd();                          /* Get free queue entry */
+    cmd->fgmar = (uint32_t)src;
+    cmd->bgmar = (uint32_t)dst;                       
+    cmd->omar = (uint32_t)dst;
+    cmd->fgor = offLineSrc;
+    cmd->bgor = offLineDst;
+    cmd->oor = offLineDst;
+    cmd->fgpfccr = fgpfccr;                         /* Foreground PFC Control Register */
+    cmd->bgpfccr = PixelFormat;                     /* Background PFC Control Register (Defines the BG pixel format) */
+    cmd->opfccr  = PixelFormat;                     /* Output     PFC Control Register (Defines the output pixel format) */
+    cmd->nlr = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
+    
+    dma2d_put_cmd(DMA2D_M2M_BLEND);                 /* Queue DMA2D transfer */
+}
+
+static
+void LCD_DrawImage16(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    uint32_t fgpfccr = DMA2D_INPUT_RGB565;
     
     /* Enable invert alpha and swap R and B values with hardware */
 #if defined(DMA2D_FGPFCCR_AI) && defined(DMA2D_FGPFCCR_RBS)
-    DMA2D->FGPFCCR |= DMA2D_FGPFCCR_RBS;
+    fgpfccr |= DMA2D_FGPFCCR_RBS;
 #endif  /* defined(DMA2D_FGPFCCR_AM_1) */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
-    
-    DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
+    draw_image(layer, fgpfccr, src, dst, xSize, ySize, offLineSrc, offLineDst);
 }
 
 static
 void LCD_DrawImage24(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
-    uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = DMA2D_INPUT_RGB888;            /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
+    uint32_t fgpfccr = DMA2D_INPUT_RGB888;
     
     /* Enable invert alpha and swap R and B values with hardware */
 #if defined(DMA2D_FGPFCCR_RBS)
-    DMA2D->FGPFCCR |= DMA2D_FGPFCCR_RBS;
+    fgpfccr |= DMA2D_FGPFCCR_RBS;
 #endif  /* defined(DMA2D_FGPFCCR_AM_1) */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
-    
-    DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
+    draw_image(layer, fgpfccr, src, dst, xSize, ySize, offLineSrc, offLineDst);
 }
 
 static
 void LCD_DrawImage32(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
-    uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;
-    DMA2D->FGPFCCR = DMA2D_INPUT_ARGB8888;          /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
+    uint32_t fgpfccr = DMA2D_INPUT_ARGB8888;
     
     /* Enable invert alpha and swap R and B values with hardware */
 #if defined(DMA2D_FGPFCCR_AI) && defined(DMA2D_FGPFCCR_RBS)
-    DMA2D->FGPFCCR |= DMA2D_FGPFCCR_AI | DMA2D_FGPFCCR_RBS;
+    fgpfccr |= DMA2D_FGPFCCR_AI | DMA2D_FGPFCCR_RBS;
 #endif  /* defined(DMA2D_FGPFCCR_AM_1) */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+    draw_image(layer, fgpfccr, src, dst, xSize, ySize, offLineSrc, offLineDst);
+}
+
+static
+void LCD_DrawImageIndexed(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst) {
+    uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
+    dma2d_cmd_t* cmd;
+    
+    if (!xSize || !ySize || !img->palette_size) {
+        return;
+    }
+    cmd = dma2d_get_cmd();                          /* Get free queue entry */
+    cmd->fgmar = (uint32_t)src;
+    cmd->bgmar = (uint32_t)dst;                       
+    cmd->omar = (uint32_t)dst;
+    cmd->fgor = offLineSrc;
+    cmd->bgor = offLineDst;
+    cmd->oor = offLineDst;
+    cmd->fgpfccr = img->bpp == 4 ? DMA2D_INPUT_L4 : DMA2D_INPUT_L8; /* Pixels are expanded with CLUT by hardware */
+    cmd->fgcmar = (uint32_t)img->palette;           /* Palette in ARGB8888 format */
+    cmd->clut = (uint32_t)(img->palette_size - 1) << DMA2D_FGPFCCR_CS_Pos;
+    cmd->bgpfccr = PixelFormat;
+    cmd->opfccr  = PixelFormat;
+    cmd->nlr = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
     
-    DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
+    dma2d_put_cmd(DMA2D_M2M_BLEND);                 /* Queue DMA2D transfer */
 }
 
+#if USE_JPEG_CODEC
+
+/**
+ * \brief           JPEG image being decoded
+ *
+ *                  Codec writes one row of MCU blocks to one of two YCbCr buffers while DMA2D
+ *                  converts previous row to layer format and copies its visible part to layer
+ */
+typedef struct {
+    gui_layer_t* layer;                         /*!< Destination layer */
+    const uint8_t* in;                          /*!< Next JPEG data for codec */
+    uint32_t in_len;                            /*!< Number of JPEG bytes left */
+    uint8_t* ycbcr[2];                          /*!< MCU row buffers filled by codec */
+    uint32_t ycbcr_size;                        /*!< Size of one MCU row in units of bytes */
+    uint8_t* rgb;                               /*!< MCU row converted to layer pixel format */
+    uint8_t buf;                                /*!< Index of buffer filled by codec */
+    uint8_t ok;                                 /*!< Set to `0` when image cannot be converted */
+    uint32_t css;                               /*!< DMA2D chroma subsampling of image */
+    gui_dim_t mcu_height;                       /*!< Number of lines in MCU row */
+    gui_dim_t aligned;                          /*!< Image width rounded up to MCU width */
+    gui_dim_t row;                              /*!< First image line of MCU row being decoded */
+    uint8_t* dst;                               /*!< Layer address of top left visible pixel */
+    gui_dim_t left, top, xSize, ySize;          /*!< Visible part of image */
+    gui_dim_t offLineDst;                       /*!< Layer line offset */
+} jpeg_decode_t;
+
+static jpeg_decode_t Jpeg;
+static uint8_t* JpegMem;                        /* YCbCr and converted MCU row buffers */
+static uint32_t JpegMemSize;
+static uint32_t JpegFree[2];                    /* Transfer count after which DMA2D finished with YCbCr buffer */
+
+void HAL_JPEG_InfoReadyCallback(JPEG_HandleTypeDef* hjpeg, JPEG_ConfTypeDef* info) {
+    Jpeg.ok = info->ColorSpace == JPEG_YCBCR_COLORSPACE;    /* DMA2D converts only YCbCr images */
+    if (info->ChromaSubsampling == JPEG_420_SUBSAMPLING) {
+        Jpeg.css = DMA2D_CSS_420;
+        Jpeg.mcu_height = 16;
+        Jpeg.ycbcr_size = (uint32_t)Jpeg.aligned * 24;  /* 6 blocks of 64 bytes per 16 pixels */
+    } else if (info->ChromaSubsampling == JPEG_422_SUBSAMPLING) {
+        Jpeg.css = DMA2D_CSS_422;
+        Jpeg.mcu_height = 8;
+        Jpeg.ycbcr_size = (uint32_t)Jpeg.aligned * 16;  /* 4 blocks of 64 bytes per 16 pixels */
+    } else {
+        Jpeg.css = DMA2D_NO_CSS;
+        Jpeg.mcu_height = 8;
+        Jpeg.aligned = (gui_dim_t)((info->ImageWidth + 7) & ~7UL);  /* MCU is only 8 pixels wide */
+        Jpeg.ycbcr_size = (uint32_t)Jpeg.aligned * 24;  /* 3 blocks of 64 bytes per 8 pixels */
+    }
+    HAL_JPEG_ConfigOutputBuffer(hjpeg, Jpeg.ycbcr[Jpeg.buf], Jpeg.ycbcr_size);
+}
+
+void HAL_JPEG_GetDataCallback(JPEG_HandleTypeDef* hjpeg, uint32_t NbDecodedData) {
+    NbDecodedData = GUI_MIN(NbDecodedData, Jpeg.in_len);
+    Jpeg.in += NbDecodedData;                   /* Complete image is in memory, continue with rest of it */
+    Jpeg.in_len -= NbDecodedData;
+    HAL_JPEG_ConfigInputBuffer(hjpeg, (uint8_t *)Jpeg.in, Jpeg.in_len);
+}
+
+void HAL_JPEG_DataReadyCallback(JPEG_HandleTypeDef* hjpeg, uint8_t* pDataOut, uint32_t OutDataLength) {
+    uint32_t PixelFormat = GetPixelFormat(Jpeg.layer);
+    gui_dim_t first, last;
+    dma2d_cmd_t* cmd;
+    
+    /* Only rows of MCU blocks with visible lines are converted */
+    first = GUI_MAX(Jpeg.row, Jpeg.top);
+    last = GUI_MIN(Jpeg.row + Jpeg.mcu_height, Jpeg.top + Jpeg.ySize);
+    if (Jpeg.ok && first < last) {
+        cpu_access_end(pDataOut, OutDataLength);    /* Codec output was read from FIFO by CPU */
+        
+        cmd = dma2d_get_cmd();
+        cmd->fgmar = (uint32_t)pDataOut;
+        cmd->omar = (uint32_t)Jpeg.rgb;
+        cmd->fgpfccr = DMA2D_INPUT_YCBCR | (Jpeg.css << DMA2D_FGPFCCR_CSS_Pos);
+        cmd->opfccr = PixelFormat;
+        cmd->nlr = (uint32_t)(Jpeg.aligned << 16) | (uint16_t)Jpeg.mcu_height;
+        dma2d_put_cmd(DMA2D_M2M_PFC);           /* Convert complete row, YCbCr input cannot start inside MCU */
+        JpegFree[Jpeg.buf] = QueuePut;
+        
+        LCD_Copy(NULL, Jpeg.layer,
+            Jpeg.rgb + ((uint32_t)(first - Jpeg.row) * Jpeg.aligned + Jpeg.left) * Jpeg.layer->pixel_size,
+            Jpeg.dst + (uint32_t)(first - Jpeg.top) * (Jpeg.xSize + Jpeg.offLineDst) * Jpeg.layer->pixel_size,
+            Jpeg.xSize, last - first, Jpeg.aligned - Jpeg.xSize, Jpeg.offLineDst);
+    }
+    Jpeg.row += Jpeg.mcu_height;
+    Jpeg.buf ^= 1;
+    while ((int32_t)(QueueDone - JpegFree[Jpeg.buf]) < 0);  /* Wait until DMA2D converted older row */
+    HAL_JPEG_ConfigOutputBuffer(hjpeg, Jpeg.ycbcr[Jpeg.buf], Jpeg.ycbcr_size);
+}
+
+void HAL_JPEG_ErrorCallback(JPEG_HandleTypeDef* hjpeg) {
+    Jpeg.ok = 0;                                /* Corrupted image, nothing more is drawn */
+}
+
+/**
+ * \brief           Decode JPEG image with hardware codec and draw visible part of it
+ * \note            Codec is polled by CPU, while DMA2D converts and copies previous MCU row.
+ *                  Function returns when last row is decoded, its conversion continues with other queued transfers
+ */
+static
+void LCD_DrawJPEG(gui_lcd_t* LCD, gui_layer_t* layer, const gui_image_desc_t* img, void* dst, gui_dim_t left, gui_dim_t top, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineDst) {
+    uint32_t aligned = ((uint32_t)img->x_size + 15) & ~15UL, size;
+    
+    size = 2 * 24 * aligned + aligned * 16 * layer->pixel_size;
+    if (size > JpegMemSize) {                   /* Buffers grow with widest image */
+        dma2d_wait();                           /* Old buffers may still be used */
+        if (JpegMem != NULL) {
+            GUI_MEMFREE(JpegMem);
+        }
+        GUI_MEM_TAGGED(GUI_MEM_TAG_IMAGE, JpegMem = GUI_MEMALLOC_NOZERO(size));
+        JpegMemSize = JpegMem != NULL ? size : 0;
+        JpegFree[0] = JpegFree[1] = QueuePut;
+        if (JpegMem == NULL) {
+            return;
+        }
+    }
+    
+    memset(&Jpeg, 0x00, sizeof(Jpeg));
+    Jpeg.layer = layer;
+    Jpeg.in = img->image;
+    Jpeg.in_len = img->size;
+    Jpeg.aligned = (gui_dim_t)aligned;
+    Jpeg.ycbcr[0] = JpegMem;
+    Jpeg.ycbcr[1] = JpegMem + 24 * aligned;
+    Jpeg.rgb = JpegMem + 2 * 24 * aligned;
+    Jpeg.ycbcr_size = 24 * aligned;
+    Jpeg.dst = dst;
+    Jpeg.left = left;
+    Jpeg.top = top;
+    Jpeg.xSize = xSize;
+    Jpeg.ySize = ySize;
+    Jpeg.offLineDst = offLineDst;
+    while ((int32_t)(QueueDone - JpegFree[0]) < 0);     /* Previous image may still be converted */
+    
+    HAL_JPEG_Decode(&JPEGHandle, (uint8_t *)Jpeg.in, Jpeg.in_len, Jpeg.ycbcr[0], Jpeg.ycbcr_size, HAL_MAX_DELAY);
+}
+
+#endif /* USE_JPEG_CODEC */
+
 static
 void LCD_CopyChar(gui_lcd_t* LCD, gui_layer_t* layer, const void* src, void* dst, gui_dim_t xSize, gui_dim_t ySize, gui_dim_t offLineSrc, gui_dim_t offLineDst, gui_color_t color) {
     uint32_t PixelFormat = GetPixelFormat(layer);   /* Get pixel format of specific layer */
+    dma2d_cmd_t* cmd;
     
     if (!xSize || !ySize) {
         return;
     }
-    while (DMA2D->CR & DMA2D_CR_START);             /* Wait finished */
-    DMA2D->FGMAR = (uint32_t)src;
-    DMA2D->BGMAR = (uint32_t)dst;                       
-    DMA2D->OMAR = (uint32_t)dst;
-    DMA2D->FGOR = offLineSrc;
-    DMA2D->BGOR = offLineDst;
-    DMA2D->OOR = offLineDst;  
-    DMA2D->FGCOLR = color & 0x00FFFFFFUL;           /* Since foreground input color is A4, value in this register will be used for blending purpose */
-    DMA2D->FGPFCCR = DMA2D_INPUT_A8;                /* Foreground PFC Control Register */
-    DMA2D->BGPFCCR = PixelFormat;                   /* Background PFC Control Register (Defines the BG pixel format) */
-    DMA2D->OPFCCR  = PixelFormat;                   /* Output     PFC Control Register (Defines the output pixel format) */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
+    cmd = dma2d_get_cmd();                          /* Get free queue entry */
+    cmd->fgmar = (uint32_t)src;
+    cmd->bgmar = (uint32_t)dst;                       
+    cmd->omar = (uint32_t)dst;
+    cmd->fgor = offLineSrc;
+    cmd->bgor = offLineDst;
+    cmd->oor = offLineDst;  
+    cmd->fgcolr = color & 0x00FFFFFFUL;             /* Since foreground input color is A4/A8, value in this register will be used for blending purpose */
+    cmd->fgpfccr = (LCD->flags & GUI_FLAG_LCD_CHAR_A4) ? DMA2D_INPUT_A4 : DMA2D_INPUT_A8;   /* Foreground PFC Control Register */
+    cmd->bgpfccr = PixelFormat;                     /* Background PFC Control Register (Defines the BG pixel format) */
+    cmd->opfccr  = PixelFormat;                     /* Output     PFC Control Register (Defines the output pixel format) */
+    cmd->nlr = (uint32_t)(xSize << 16) | (uint16_t)ySize; 
+    
+    dma2d_put_cmd(DMA2D_M2M_BLEND);                 /* Queue DMA2D transfer */
+}
+
+/**
+ * \brief           Blend single color channel, `(x + 0x80 + (x >> 8)) >> 8` is fast division by 255
+ */
+#define BLEND_CHANNEL(f, b, a)      ((((f) * (a) + (b) * (0xFF - (a)) + 0x80) + ((((f) * (a) + (b) * (0xFF - (a)) + 0x80)) >> 8)) >> 8)
+
+static
+void LCD_BlendHLine(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t length, const uint8_t* alpha, gui_color_t color) {
+    uint8_t* addr = (uint8_t *)(layer->start_address + layer->pixel_size * (layer->width * y + x));
+    uint32_t fr = (color >> 16) & 0xFF, fg = (color >> 8) & 0xFF, fb = color & 0xFF;
+    uint32_t r, g, b, a;
+    gui_dim_t i;
     
-    DMA2D_START(DMA2D_M2M_BLEND);                   /* Start DMA2D transfer */
+    /* Anti-aliased spans are short, blend them with CPU instead of DMA2D transfer */
+    cpu_access_begin(addr, length * layer->pixel_size);
+    for (i = 0; i < length; i++) {
+        if (!(a = alpha[i])) {
+            continue;
+        }
+        if (layer->pixel_format == GUI_PIXEL_FORMAT_RGB565) {
+            uint16_t* p = (uint16_t *)addr + i;
+            r = (*p >> 11) & 0x1F;                  /* Blend in 565 format directly */
+            g = (*p >>  5) & 0x3F;
+            b = (*p >>  0) & 0x1F;
+            r = BLEND_CHANNEL((fr >> 3), r, a);
+            g = BLEND_CHANNEL((fg >> 2), g, a);
+            b = BLEND_CHANNEL((fb >> 3), b, a);
+            *p = (uint16_t)((r << 11) | (g << 5) | b);
+        } else if (layer->pixel_format == GUI_PIXEL_FORMAT_RGB888) {
+            uint8_t* p = addr + 3 * i;
+            p[0] = (uint8_t)BLEND_CHANNEL(fb, p[0], a);
+            p[1] = (uint8_t)BLEND_CHANNEL(fg, p[1], a);
+            p[2] = (uint8_t)BLEND_CHANNEL(fr, p[2], a);
+        } else {
+            uint32_t* p = (uint32_t *)addr + i;
+            uint32_t da = *p >> 24, oa = 0xFF;
+            if (da != 0xFF) {                       /* Translucent layer is composited by LTDC, coverage grows */
+                oa = a + (da * (0xFF - a) + 0x7F) / 0xFF;
+                a = (a * 0xFF + (oa >> 1)) / oa;
+            }
+            r = (*p >> 16) & 0xFF;
+            g = (*p >>  8) & 0xFF;
+            b = (*p >>  0) & 0xFF;
+            r = BLEND_CHANNEL(fr, r, a);
+            g = BLEND_CHANNEL(fg, g, a);
+            b = BLEND_CHANNEL(fb, b, a);
+            *p = (oa << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+    cpu_access_end(addr, length * layer->pixel_size);
 }
 
 static
 void LCD_DrawHLine(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t length, gui_color_t color) {
-    uint32_t addr = layer->start_address + (LCD->pixel_size * (layer->width * y + x));
+    uint32_t addr = layer->start_address + (layer->pixel_size * (layer->width * y + x));
     
     LCD_Fill(LCD, layer, (void *)addr, length, 1, layer->width - length, color);
 }
 
 static
 void LCD_DrawVLine(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t length, gui_color_t color) {
-    uint32_t addr = layer->start_address + (LCD->pixel_size * (layer->width * y + x));
+    uint32_t addr = layer->start_address + (layer->pixel_size * (layer->width * y + x));
     
     LCD_Fill(LCD, layer, (void *)addr, 1, length, layer->width - 1, color);
 }
 
 static
 void LCD_FillRect(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t xSize, gui_dim_t ySize, gui_color_t color) {
-    uint32_t addr = layer->start_address + (LCD->pixel_size * (layer->width * y + x));
+    uint32_t addr = layer->start_address + (layer->pixel_size * (layer->width * y + x));
     
     LCD_Fill(LCD, layer, (void *)addr, xSize, ySize, layer->width - xSize, color);
 }
 
+/**
+ * \brief           Fill list of rectangles with one queue update
+ *
+ *                  All free queue entries are filled first and published together,
+ *                  interrupt is disabled only once for each group of transfers.
+ *                  Small rectangles use DMA2D too, CPU fill would have to wait for complete queue
+ */
+static
+void LCD_FillRects(gui_lcd_t* LCD, gui_layer_t* layer, const gui_ll_rect_t* rects, size_t count) {
+    uint32_t opfccr = GetPixelFormat(layer);
+    dma2d_cmd_t* cmd;
+    uint32_t in;
+    
+    while (count) {
+        in = QueueIn;
+        for (; count && (in + 1) % DMA2D_QUEUE_SIZE != QueueOut; count--, rects++) {
+            if (rects->width <= 0 || rects->height <= 0) {
+                continue;
+            }
+            cmd = &Queue[in];
+            memset(cmd, 0x00, sizeof(*cmd));
+            cmd->mode = DMA2D_R2M;
+            cmd->ocolr = color_to_pixel(layer, rects->color);
+            cmd->omar = layer->start_address + layer->pixel_size * (layer->width * rects->y + rects->x);
+            cmd->oor = layer->width - rects->width;
+            cmd->opfccr = opfccr;
+            cmd->nlr = (uint32_t)(rects->width << 16) | (uint16_t)rects->height;
+            in = (in + 1) % DMA2D_QUEUE_SIZE;
+        }
+        
+        HAL_NVIC_DisableIRQ(DMA2D_IRQn);            /* Prevent interrupt to start transfer at the same time */
+        QueueIn = in;                               /* Publish all new commands */
+        if (!QueueBusy) {
+            dma2d_start_next();
+        }
+        HAL_NVIC_EnableIRQ(DMA2D_IRQn);
+    }
+}
+
+/**
+ * \brief           Fill rectangle with gradient, one color per row or column
+ *
+ *                  CPU writes only first column (or row) with all colors,
+ *                  DMA2D then doubles filled part with each transfer until rectangle is complete.
+ *                  Rectangle is filled with few transfers instead of one transfer per line
+ */
+static
+void LCD_FillGradient(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_dim_t xSize, gui_dim_t ySize, const gui_color_t* colors, uint8_t vertical) {
+    uint8_t* dst = (uint8_t *)(layer->start_address + layer->pixel_size * (layer->width * y + x));
+    uint8_t* ptr;
+    uint32_t pixel, size, step;
+    gui_dim_t i, count, done, total, n;
+    
+    if (!xSize || !ySize) {
+        return;
+    }
+    count = vertical ? ySize : xSize;               /* Number of colors */
+    total = vertical ? xSize : ySize;               /* Number of pixels with the same color */
+    step = vertical ? layer->pixel_size * layer->width : layer->pixel_size; /* Bytes between two colors */
+    if ((uint32_t)xSize * ySize <= DMA2D_CPU_FILL_MAX) {    /* Small areas are faster with CPU */
+        for (i = 0; i < count; i++) {
+            if (vertical) {
+                cpu_fill(layer, dst + i * step, xSize, 1, 0, color_to_pixel(layer, colors[i]));
+            } else {
+                cpu_fill(layer, dst + i * step, 1, ySize, layer->width - 1, color_to_pixel(layer, colors[i]));
+            }
+        }
+        return;
+    }
+    
+    /* Write single strip of pixels with all colors */
+    size = (uint32_t)(count - 1) * step + layer->pixel_size;
+    cpu_access_begin(dst, size);
+    for (i = 0, ptr = dst; i < count; i++, ptr += step) {
+        pixel = color_to_pixel(layer, colors[i]);
+        if (layer->pixel_format == GUI_PIXEL_FORMAT_RGB565) {
+            *(uint16_t *)ptr = (uint16_t)pixel;
+        } else if (layer->pixel_format == GUI_PIXEL_FORMAT_RGB888) {
+            ptr[0] = (uint8_t)pixel;
+            ptr[1] = (uint8_t)(pixel >> 8);
+            ptr[2] = (uint8_t)(pixel >> 16);
+        } else {
+            *(uint32_t *)ptr = pixel;
+        }
+    }
+    cpu_access_end(dst, size);
+    
+    /* Copy already filled part next to itself, transfers are executed in queue order */
+    for (done = 1; done < total; done += n) {
+        n = GUI_MIN(done, total - done);
+        if (vertical) {
+            LCD_Copy(LCD, layer, dst, dst + done * layer->pixel_size, n, ySize, layer->width - n, layer->width - n);
+        } else {
+            LCD_Copy(LCD, layer, dst, dst + done * layer->pixel_size * layer->width, xSize, n, layer->width - xSize, layer->width - xSize);
+        }
+    }
+}
+
 static
 void LCD_SetPixel(gui_lcd_t* LCD, gui_layer_t* layer, gui_dim_t x, gui_dim_t y, gui_color_t color) {
     LCD_DrawHLine(LCD, layer, x, y, 1, color);
 }
 
+void TransferErrorCallback(DMA2D_HandleTypeDef* hdma2d) {
+     while (1);
+}
+
 /* Process DMA2D interrupt */
 void DMA2D_IRQHandler(void) {
-    HAL_DMA2D_IRQHandler(&DMA2DHandle);
+    uint32_t isr = DMA2D->ISR;
+    
+    if (isr & (DMA2D_ISR_TEIF | DMA2D_ISR_CEIF)) {  /* Transfer or configuration error */
+        DMA2D->IFCR = DMA2D_IFCR_CTEIF | DMA2D_IFCR_CCEIF;
+        TransferErrorCallback(&DMA2DHandle);
+    }
+    if (isr & DMA2D_ISR_TCIF) {                     /* Transfer complete */
+        DMA2D->IFCR = DMA2D_IFCR_CTCIF;
+        QueueDone++;
+        dma2d_start_next();                         /* Start next queued transfer */
+#if USE_MDMA
+    } else if (!QueueBusy) {                        /* Set pending by MDMA interrupt after copy */
+        dma2d_start_next();                         /* Start transfers waiting for copy or show pending layer */
+#endif /* USE_MDMA */
+    }
 }
 
-void TransferErrorCallback(DMA2D_HandleTypeDef* hdma2d) {
-     while (1);
+#if USE_MDMA
+/* Process MDMA interrupt */
+void MDMA_IRQHandler(void) {
+    uint32_t isr = MDMA_Channel0->CISR;
+    
+    MDMA_Channel0->CIFCR = MDMA_CIFCR_CTEIF | MDMA_CIFCR_CCTCIF | MDMA_CIFCR_CBRTIF | MDMA_CIFCR_CBTIF | MDMA_CIFCR_CLTCIF;
+    if (isr & MDMA_CISR_TEIF) {                     /* Transfer error */
+        TransferErrorCallback(&DMA2DHandle);
+    }
+    if (isr & MDMA_CISR_CTCIF) {                    /* Complete linked list is copied */
+        MdmaCount = 0;
+        MdmaBusy = 0;
+        NVIC_SetPendingIRQ(DMA2D_IRQn);             /* Queue is continued from DMA2D interrupt, it is locked by disabling it */
+    }
 }
+#endif /* USE_MDMA */
+
 uint8_t gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void* result) {
     switch (cmd) {
         case GUI_LL_Command_Init: {
@@ -299,6 +1228,9 @@ uint8_t gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void*
             /* Assign memory to GUI        */
             /*******************************/
             TM_SDRAM_Init();
+#if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+            mpu_config();                       /* Set cache attributes before SDRAM is used */
+#endif /* defined(__DCACHE_PRESENT) && __DCACHE_PRESENT */
             do {
 #if defined(__GNUC__)
                 static uint8_t DTCMMemory1[0x10000];
@@ -311,11 +1243,14 @@ uint8_t gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void*
 #else
                 static uint8_t SDRAMMemory[SDRAM_HEAP_SIZE] __attribute__((at(SDRAM_START_ADR + SDRAM_MEMORY_SIZE - SDRAM_HEAP_SIZE))); /* SDRAM heap memory */
 #endif
+                /* Fast DTCM first for hot data, big SDRAM last for bulk buffers */
                 static GUI_MEM_Region_t const regions[] = {
                     {DTCMMemory1, sizeof(DTCMMemory1)},
                     {SDRAMMemory, sizeof(SDRAMMemory)},
                 };
-                gui_mem_assignmemory(regions, GUI_COUNT_OF(regions));
+                if (!gui_mem_assignmemory(regions, GUI_COUNT_OF(regions))) {
+                    return 1;                   /* Command processed, result stays failed */
+                }
             } while (0);
             
             /*******************************/
@@ -333,7 +1268,15 @@ uint8_t gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void*
             for (i = 0; i < GUI_LAYERS; i++) {  /* Set each layer */
                 Layers[i].num = i;
                 Layers[i].start_address = LCD_FRAME_BUFFER + (i * LCD_FRAME_BUFFER_SIZE);
+#if GUI_CFG_LCD_BACKGROUND
+                Layers[i].pixel_format = GUI_PIXEL_FORMAT_ARGB8888; /* LTDC blends drawing layer with pixel alpha */
+#endif /* GUI_CFG_LCD_BACKGROUND */
             }
+#if GUI_CFG_LCD_BACKGROUND
+            BackgroundLayer.num = GUI_LAYERS;
+            BackgroundLayer.start_address = LCD_BG_FRAME_BUFFER;    /* Background keeps LCD pixel format */
+            LCD->background = &BackgroundLayer;
+#endif /* GUI_CFG_LCD_BACKGROUND */
             
             /*******************************/
             /* Set up LCD drawing routines */
@@ -348,11 +1291,24 @@ uint8_t gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void*
             LL->DrawVLine = LCD_DrawVLine;      /* Set drawing horizontal line routine */
             LL->Fill = LCD_Fill;                /* Set fill screen routine */
             LL->FillRect = LCD_FillRect;        /* Set fill rectangle routine */
+#if LCD_PIXEL_SIZE != 1                         /* GUI draws to L8 frame buffer with software functions */
             LL->CopyBlend = LCD_CopyBlending;   /* Set copy with blending */
             LL->DrawImage16 = LCD_DrawImage16;  /* Set draw function for 24bit image (RGB565) format */
             LL->DrawImage24 = LCD_DrawImage24;  /* Set draw function for 24bit image (RGB888) format */
             LL->DrawImage32 = LCD_DrawImage32;  /* Set draw function for 32bit image (ARGB8888/ABGR8888) format */
+            LL->DrawImageIndexed = LCD_DrawImageIndexed;    /* Set draw function for L8 and L4 images with CLUT */
             LL->CopyChar = LCD_CopyChar;        /* Set draw function for char copy with alpha information */
+            LL->BlendHLine = LCD_BlendHLine;    /* Set blending function for anti-aliased drawing */
+            LL->FillGradient = LCD_FillGradient;/* Set gradient fill with strip expanded by DMA2D */
+            LL->FillRects = LCD_FillRects;      /* Set batched rectangle fill */
+#if USE_JPEG_CODEC
+            LL->DrawJPEG = LCD_DrawJPEG;        /* Set JPEG decoding with hardware codec */
+#endif /* USE_JPEG_CODEC */
+            LCD->flags |= GUI_FLAG_LCD_CHAR_A4; /* Characters are copied from packed 4-bit alpha data */
+#endif /* LCD_PIXEL_SIZE != 1 */
+#if USE_MDMA
+            LL->CopyRects = LCD_CopyRects;      /* Set layer synchronization with MDMA linked list */
+#endif /* USE_MDMA */
             
             if (result) {
                 *(uint8_t *)result = 0;         /* Successful initialization */
@@ -360,18 +1316,87 @@ uint8_t gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void*
             
             HAL_NVIC_SetPriority(DMA2D_IRQn, 4, 0); /* Set priority level for DMA2D */
             HAL_NVIC_EnableIRQ(DMA2D_IRQn);     /* Enable IRQ */
+#if USE_MDMA
+            __HAL_RCC_MDMA_CLK_ENABLE();
+            HAL_NVIC_SetPriority(MDMA_IRQn, 4, 0);  /* Same level as DMA2D, handlers do not preempt each other */
+            HAL_NVIC_EnableIRQ(MDMA_IRQn);
+#endif /* USE_MDMA */
             
             return 1;                           /* Command processed */
         }
         case GUI_LL_Command_SetActiveLayer: {   /* Set new active layer */
-            gui_layer_t* layer = (gui_layer_t *)param;/* Read layer as byte */
-            layer->pending = 1;                 /* Set layer as pending and redraw on next reload */
+            gui_layer_t* layer = *(gui_layer_t **)param;   /* Get layer to show */
+            
+            /*
+             * Layer must be fully drawn before it is shown.
+             * Instead of waiting here, mark it pending from DMA2D interrupt when queue gets empty.
+             * Display driver then swaps layers on refresh interrupt and confirms with gui_lcd_confirmactivelayer
+             */
+            HAL_NVIC_DisableIRQ(DMA2D_IRQn);
+            if (QueueBusy || MdmaBusy) {        /* MDMA interrupt pends DMA2D interrupt when done */
+                PendingLayer = layer;
+            } else {
+                layer->pending = 1;             /* Set layer as pending and redraw on next reload */
+            }
+            HAL_NVIC_EnableIRQ(DMA2D_IRQn);
 
             if (result) {
                 *(uint8_t *)result = 0;         /* Successful layer set as active */
             }
             return 1;                           /* Command processed */
         }
+#if GUI_CFG_LCD_CLUT
+        case GUI_LL_Command_SetPalette: {       /* Load palette of L8 layers to LTDC */
+            _LCD_SetCLUT(LCD->palette, LCD->palette_size);
+            if (result) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;                           /* Command processed */
+        }
+#endif /* GUI_CFG_LCD_CLUT */
+#if GUI_CFG_IDLE_TIMEOUT
+        case GUI_LL_Command_PowerDown: {        /* GUI is idle, last frame is shown */
+            _LCD_Sleep(1);                      /* Stop refresh and put panel to sleep */
+            HAL_NVIC_DisableIRQ(DMA2D_IRQn);
+            __HAL_RCC_DMA2D_CLK_DISABLE();      /* Queue is empty, GUI waited for it */
+            if (result) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;                           /* Command processed */
+        }
+        case GUI_LL_Command_PowerUp: {
+            __HAL_RCC_DMA2D_CLK_ENABLE();       /* DMA2D keeps its configuration while clock is stopped */
+            HAL_NVIC_EnableIRQ(DMA2D_IRQn);
+            _LCD_Sleep(0);
+            *(uint8_t *)param = 1;              /* SDRAM stays in self refresh, frame buffers are kept */
+            if (result) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;                           /* Command processed */
+        }
+#endif /* GUI_CFG_IDLE_TIMEOUT */
+#if GUI_CFG_USE_METRICS
+        case GUI_LL_Command_GetLoad: {          /* Part of time DMA2D was busy since previous call */
+            uint32_t now, busy, primask;
+            
+            primask = __get_PRIMASK();
+            __disable_irq();                    /* Transfer may finish in interrupt meanwhile */
+            now = GUI_CFG_STATS_TIME();
+            busy = BusyTime;
+            if (QueueBusy) {                    /* Count running transfer until now */
+                busy += now - BusyStart;
+                BusyStart = now;
+            }
+            BusyTime = 0;
+            __set_PRIMASK(primask);
+            *(uint8_t *)param = now != LoadStart ? (uint8_t)GUI_MIN(100, (uint64_t)busy * 100 / (uint32_t)(now - LoadStart)) : 0;
+            LoadStart = now;
+            if (result) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;                           /* Command processed */
+        }
+#endif /* GUI_CFG_USE_METRICS */
         default:
             return 0;
     }
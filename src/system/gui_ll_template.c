@@ -33,6 +33,8 @@ DMA2D_HandleTypeDef DMA2DHandle;
 LTDC_HandleTypeDef LTDCHandle;
 uint16_t startAddress;
 
+#define GUI_TILE_HSEM_ID            0           /* Hardware semaphore protecting tiles shared between cores */
+
 #define DMA2D_START(type) do {                  \
     startAddress = __LINE__;                    \
     DMA2D->CR = (type);                         \
@@ -320,7 +322,9 @@ gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void* result)
                     {DTCMMemory1, sizeof(DTCMMemory1)},
                     {SDRAMMemory, sizeof(SDRAMMemory)},
                 };
-                gui_mem_assignmemory(regions, GUI_COUNT_OF(regions));
+                if (!gui_mem_assignmemory(regions, GUI_COUNT_OF(regions))) {
+                    return 1;                   /* Command processed, result stays failed */
+                }
             } while (0);
             
             /*******************************/
@@ -369,14 +373,55 @@ gui_ll_control(gui_lcd_t* LCD, GUI_LL_Command_t cmd, void* param, void* result)
             return 1;                           /* Command processed */
         }
         case GUI_LL_Command_SetActiveLayer: {   /* Set new active layer */
-            uint8_t layer = *(uint8_t *)param;/* Read layer as byte */
-            LCD->Layers[layer].Pending = 1;     /* Set layer as pending and redraw on next reload */
+            gui_layer_t* layer = *(gui_layer_t **)param;   /* Get layer to show */
+            
+            /*
+             * Layer may be shown only when all drawing operations to it are finished.
+             * When accelerator is still busy, mark layer pending from its transfer complete interrupt instead.
+             * Display driver swaps layers on refresh interrupt and confirms with gui_lcd_confirmactivelayer
+             */
+            layer->pending = 1;                 /* Set layer as pending and show on next reload */
 
             if (result) {
                 *(uint8_t *)result = 0;         /* Successful layer set as active */
             }
             return 1;                           /* Command processed */
         }
+#if GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1
+        case GUI_LL_Command_CoreLock: {         /* Take lock shared with other core */
+            while (HAL_HSEM_FastTake(GUI_TILE_HSEM_ID) != HAL_OK) {}
+            __DMB();                            /* Shared data are read after lock is taken */
+            if (result) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;                           /* Command processed */
+        }
+        case GUI_LL_Command_CoreUnlock: {       /* Release lock shared with other core */
+            __DMB();                            /* Shared data are written before lock is released */
+            HAL_HSEM_Release(GUI_TILE_HSEM_ID, 0);
+            if (result) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;                           /* Command processed */
+        }
+#endif /* GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1 */
+#if GUI_CFG_IDLE_TIMEOUT
+        case GUI_LL_Command_PowerDown: {        /* Display is not used until power up */
+            /* Stop display refresh, put panel to sleep and disable accelerator clock here */
+            if (result) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;                           /* Command processed */
+        }
+        case GUI_LL_Command_PowerUp: {          /* Display is used again */
+            /* Restart clocks and display refresh here */
+            *(uint8_t *)param = 1;              /* Set to 1 when display memory kept its content */
+            if (result) {
+                *(uint8_t *)result = 0;
+            }
+            return 1;                           /* Command processed */
+        }
+#endif /* GUI_CFG_IDLE_TIMEOUT */
         default:
             return 0;
     }
@@ -366,3 +366,13 @@ gui_sys_thread_create(gui_sys_thread_t* t, const char* name, void (*thread_func)
     *t = osThreadCreate(&thread_def, arg);      /* Create thread */
     return !!*t;
 }
+
+/**
+ * \brief           Get ID of currently running thread
+ * \note            This function is required with OS
+ * \return          Thread identifier
+ */
+gui_sys_thread_t
+gui_sys_thread_getid(void) {
+    return osThreadGetId();                     /* Get current thread */
+}
@@ -0,0 +1,467 @@
+/**
+ * \file            gui_system_freertos.c
+ * \brief           System dependant functions for native FreeRTOS API
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "system/gui_sys.h"
+
+#if GUI_CFG_OS && GUI_CFG_SYS_FREERTOS
+
+/*
+ * Mutexes and semaphores are created with static storage provided by caller.
+ * FreeRTOS mutexes implement priority inheritance, low priority thread holding
+ * GUI lock is raised to priority of GUI thread waiting for it.
+ *
+ * Message queue is ring buffer inside caller structure. Receiving thread
+ * registers itself as waiter and blocks on direct task notification,
+ * which is faster and smaller than waking it up with queue object.
+ */
+
+/**
+ * \brief           Check if function is called from interrupt context
+ */
+#define IN_ISR()                    (xPortIsInsideInterrupt() == pdTRUE)
+
+static gui_sys_mutex_t sys_mutex;               /* Mutex for main protection */
+
+/**
+ * \brief           Convert timeout in units of milliseconds to ticks
+ * \param[in]       timeout: Timeout in milliseconds. When 0 is applied, wait forever
+ * \return          Number of ticks to wait
+ */
+static TickType_t
+ms_to_ticks(uint32_t timeout) {
+    if (!timeout) {
+        return portMAX_DELAY;
+    }
+    return pdMS_TO_TICKS(timeout) ? pdMS_TO_TICKS(timeout) : 1;
+}
+
+/**
+ * \brief           Init system dependant parameters
+ * \note            Called from high-level application layer when required
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_init(void) {
+    return gui_sys_mutex_create(&sys_mutex);    /* Create system mutex */
+}
+
+/**
+ * \brief           Get current time in units of milliseconds
+ * \return          Current time in units of milliseconds
+ */
+uint32_t
+gui_sys_now(void) {
+    if (IN_ISR()) {
+        return (uint32_t)xTaskGetTickCountFromISR() * portTICK_PERIOD_MS;
+    }
+    return (uint32_t)xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+/**
+ * \brief           Protect stack core
+ * \note            This function may be called multiple times, recursive protection is required
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_protect(void) {
+    gui_sys_mutex_lock(&sys_mutex);             /* Lock system and protect it */
+    return 1;
+}
+
+/**
+ * \brief           Protect stack core
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_unprotect(void) {
+    gui_sys_mutex_unlock(&sys_mutex);           /* Release lock */
+    return 1;
+}
+
+/**
+ * \brief           Create a new recursive mutex in storage of mutex structure
+ * \param[out]      p: Pointer to mutex structure to save result to
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_create(gui_sys_mutex_t* p) {
+    p->handle = xSemaphoreCreateRecursiveMutexStatic(&p->buff);
+    return p->handle != NULL;
+}
+
+/**
+ * \brief           Delete mutex
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_delete(gui_sys_mutex_t* p) {
+    vSemaphoreDelete(p->handle);                /* Storage is not freed, only removed from kernel */
+    p->handle = GUI_SYS_MUTEX_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Wait forever to lock the mutex
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_lock(gui_sys_mutex_t* p) {
+    return xSemaphoreTakeRecursive(p->handle, portMAX_DELAY) == pdTRUE;
+}
+
+/**
+ * \brief           Unlock mutex
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_unlock(gui_sys_mutex_t* p) {
+    return xSemaphoreGiveRecursive(p->handle) == pdTRUE;
+}
+
+/**
+ * \brief           Check if mutex structure is valid
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_isvalid(gui_sys_mutex_t* p) {
+    return p->handle != GUI_SYS_MUTEX_NULL;
+}
+
+/**
+ * \brief           Set mutex structure as invalid
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_invalid(gui_sys_mutex_t* p) {
+    p->handle = GUI_SYS_MUTEX_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Create a new binary semaphore in storage of semaphore structure
+ * \param[out]      p: Pointer to semaphore structure to fill with result
+ * \param[in]       cnt: Count indicating default semaphore state:
+ *                     0: Lock it immediteally
+ *                     1: Leave it unlocked
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_create(gui_sys_sem_t* p, uint8_t cnt) {
+    p->handle = xSemaphoreCreateBinaryStatic(&p->buff); /* Created in taken state */
+    if (p->handle == NULL) {
+        return 0;
+    }
+    if (cnt) {
+        xSemaphoreGive(p->handle);
+    }
+    return 1;
+}
+
+/**
+ * \brief           Delete binary semaphore
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_delete(gui_sys_sem_t* p) {
+    vSemaphoreDelete(p->handle);
+    p->handle = GUI_SYS_SEM_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Wait for semaphore to be available
+ * \param[in]       p: Pointer to semaphore structure
+ * \param[in]       timeout: Timeout to wait in milliseconds. When 0 is applied, wait forever
+ * \return          Number of milliseconds waited for semaphore to become available
+ */
+uint32_t
+gui_sys_sem_wait(gui_sys_sem_t* p, uint32_t timeout) {
+    uint32_t tick = gui_sys_now();
+
+    if (xSemaphoreTake(p->handle, ms_to_ticks(timeout)) != pdTRUE) {
+        return GUI_SYS_TIMEOUT;
+    }
+    return gui_sys_now() - tick;
+}
+
+/**
+ * \brief           Release semaphore
+ * \note            Safe to call from interrupt, used by layer reload interrupt
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_release(gui_sys_sem_t* p) {
+    BaseType_t woken = pdFALSE, res;
+
+    if (IN_ISR()) {
+        res = xSemaphoreGiveFromISR(p->handle, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else {
+        res = xSemaphoreGive(p->handle);
+    }
+    return res == pdTRUE;
+}
+
+/**
+ * \brief           Check if semaphore is valid
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_isvalid(gui_sys_sem_t* p) {
+    return p->handle != GUI_SYS_SEM_NULL;
+}
+
+/**
+ * \brief           Invalid semaphore
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_invalid(gui_sys_sem_t* p) {
+    p->handle = GUI_SYS_SEM_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Create a new message queue with entry type of "void *"
+ * \param[out]      b: Pointer to message queue structure
+ * \param[in]       size: Number of entries for message queue to hold,
+ *                      up to \ref GUI_CFG_SYS_FREERTOS_MBOX_SIZE
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_create(gui_sys_mbox_t* b, size_t size) {
+    if (size > GUI_CFG_SYS_FREERTOS_MBOX_SIZE) {
+        b->handle = GUI_SYS_MBOX_NULL;
+        return 0;
+    }
+    b->size = size ? size : 1;
+    b->in = b->out = b->count = 0;
+    b->waiter = NULL;
+    b->handle = b->entries;
+    return 1;
+}
+
+/**
+ * \brief           Delete message queue
+ * \param[in]       b: Pointer to message queue structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_delete(gui_sys_mbox_t* b) {
+    if (b->count) {                             /* We still have messages in queue, should not delete queue */
+        return 0;
+    }
+    b->handle = GUI_SYS_MBOX_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Put a new entry to message queue without timeout (now or fail)
+ * \note            Safe to call from interrupt, used by input drivers
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to message to save to queue
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_putnow(gui_sys_mbox_t* b, void* m) {
+    TaskHandle_t waiter = NULL;
+    UBaseType_t mask = 0;
+    BaseType_t woken = pdFALSE;
+    uint8_t isr = IN_ISR(), ok;
+
+    if (isr) {
+        mask = taskENTER_CRITICAL_FROM_ISR();
+    } else {
+        taskENTER_CRITICAL();
+    }
+    ok = b->count < b->size;
+    if (ok) {
+        b->entries[b->in] = m;
+        b->in = (b->in + 1) % b->size;
+        b->count++;
+        waiter = b->waiter;                     /* Receiver is woken only once per wait */
+        b->waiter = NULL;
+    }
+    if (isr) {
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+    } else {
+        taskEXIT_CRITICAL();
+    }
+
+    if (waiter != NULL) {                       /* Notify outside critical section */
+        if (isr) {
+            vTaskNotifyGiveFromISR(waiter, &woken);
+            portYIELD_FROM_ISR(woken);
+        } else {
+            xTaskNotifyGive(waiter);
+        }
+    }
+    return ok;
+}
+
+/**
+ * \brief           Put a new entry to message queue and wait until memory available
+ * \note            Full queue is polled every tick, \ref gui_sys_mbox_putnow is used by stack
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to entry to insert to message queue
+ * \return          Time in units of milliseconds needed to put a message to queue
+ */
+uint32_t
+gui_sys_mbox_put(gui_sys_mbox_t* b, void* m) {
+    uint32_t tick = gui_sys_now();
+
+    while (!gui_sys_mbox_putnow(b, m)) {
+        vTaskDelay(1);
+    }
+    return gui_sys_now() - tick;
+}
+
+/**
+ * \brief           Get an entry from message queue immediatelly
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to pointer to result to save value from message queue to
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_getnow(gui_sys_mbox_t* b, void** m) {
+    uint8_t ok;
+
+    taskENTER_CRITICAL();
+    ok = b->count > 0;
+    if (ok) {
+        *m = b->entries[b->out];
+        b->out = (b->out + 1) % b->size;
+        b->count--;
+    }
+    taskEXIT_CRITICAL();
+    return ok;
+}
+
+/**
+ * \brief           Get a new entry from message queue with timeout
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to pointer to result to save value from message queue to
+ * \param[in]       timeout: Maximal timeout to wait for new message. When 0 is applied, wait for unlimited time
+ * \return          Time in units of milliseconds needed to put a message to queue
+ */
+uint32_t
+gui_sys_mbox_get(gui_sys_mbox_t* b, void** m, uint32_t timeout) {
+    TickType_t start = xTaskGetTickCount(), ticks = ms_to_ticks(timeout), waited;
+    uint32_t tick = gui_sys_now();
+
+    while (1) {
+        taskENTER_CRITICAL();
+        if (b->count) {
+            *m = b->entries[b->out];
+            b->out = (b->out + 1) % b->size;
+            b->count--;
+            b->waiter = NULL;
+            taskEXIT_CRITICAL();
+            return gui_sys_now() - tick;
+        }
+        b->waiter = xTaskGetCurrentTaskHandle();/* Sender notifies us after insert */
+        taskEXIT_CRITICAL();
+
+        if (ticks == portMAX_DELAY) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        } else {
+            waited = xTaskGetTickCount() - start;
+            if (waited >= ticks || !ulTaskNotifyTake(pdTRUE, ticks - waited)) {
+                break;                          /* Notification may be late, check queue once more */
+            }
+        }
+    }
+    return gui_sys_mbox_getnow(b, m) ? (gui_sys_now() - tick) : GUI_SYS_TIMEOUT;
+}
+
+/**
+ * \brief           Check if message queue is valid
+ * \param[in]       b: Pointer to message queue structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_isvalid(gui_sys_mbox_t* b) {
+    return b->handle != GUI_SYS_MBOX_NULL;
+}
+
+/**
+ * \brief           Invalid message queue
+ * \param[in]       b: Pointer to message queue structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_invalid(gui_sys_mbox_t* b) {
+    b->handle = GUI_SYS_MBOX_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Create a new thread
+ * \param[out]      t: Pointer to thread identifier if create was successful
+ * \param[in]       name: Name of a new thread
+ * \param[in]       thread_func: Thread function to use as thread body
+ * \param[in]       arg: Thread function argument
+ * \param[in]       stack_size: Size of thread stack in uints of bytes
+ * \param[in]       prio: Thread priority
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_thread_create(gui_sys_thread_t* t, const char* name, void (*thread_func)(void *), void* const arg, size_t stack_size, gui_sys_thread_prio_t prio) {
+    TaskHandle_t handle;
+
+    if (xTaskCreate(thread_func, name, (configSTACK_DEPTH_TYPE)(stack_size / sizeof(StackType_t)), arg, prio, &handle) != pdPASS) {
+        return 0;
+    }
+    if (t != NULL) {
+        *t = handle;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Get ID of currently running thread
+ * \return          Thread ID
+ */
+gui_sys_thread_t
+gui_sys_thread_getid(void) {
+    return xTaskGetCurrentTaskHandle();
+}
+
+#endif /* GUI_CFG_OS && GUI_CFG_SYS_FREERTOS */
@@ -0,0 +1,68 @@
+/**	
+ * \file            gui_system_headless.c
+ * \brief           System functions for headless port without OS, driven by virtual time
+ */
+ 
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "system/gui_sys.h"
+#include "system/gui_headless.h"
+
+#if GUI_CFG_OS
+#error "Headless port requires GUI_CFG_OS to be disabled"
+#endif /* GUI_CFG_OS */
+
+static uint32_t now;                            /* Virtual time in units of milliseconds */
+
+/**
+ * \brief           Init system dependant parameters
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_init(void) {
+    now = 0;
+    return 1;
+}
+
+/**
+ * \brief           Get current virtual time in units of milliseconds
+ * \return          Current time in units of milliseconds
+ */
+uint32_t
+gui_sys_now(void) {
+    return now;
+}
+
+/**
+ * \brief           Set virtual time returned by \ref gui_sys_now
+ * \note            Time should only move forward, timers expire when time passes their period
+ * \param[in]       time: New time in units of milliseconds
+ */
+void
+gui_sys_headless_settime(uint32_t time) {
+    now = time;
+}
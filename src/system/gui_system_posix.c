@@ -0,0 +1,565 @@
+/**
+ * \file            gui_system_posix.c
+ * \brief           System dependant functions for POSIX threads based host
+ */
+
+/*
+ * Copyright (c) 2018 Tilen Majerle
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "system/gui_sys.h"
+
+#if GUI_CFG_OS && GUI_CFG_SYS_POSIX
+
+#include "time.h"
+#include "limits.h"
+#include "errno.h"
+
+/**
+ * \brief           Binary semaphore built from mutex and condition variable
+ */
+struct gui_sys_sem {
+    pthread_mutex_t mutex;                      /*!< Mutex protecting token */
+    pthread_cond_t cond;                        /*!< Condition signaled when token is released */
+    uint8_t cnt;                                /*!< Token available when set to `1` */
+};
+
+/**
+ * \brief           Message queue with fixed number of "void *" entries
+ */
+struct gui_sys_mbox {
+    pthread_mutex_t mutex;                      /*!< Mutex protecting queue */
+    pthread_cond_t not_empty;                   /*!< Condition signaled when new entry is inserted */
+    pthread_cond_t not_full;                    /*!< Condition signaled when entry is removed */
+    size_t size;                                /*!< Number of entries queue can hold */
+    size_t in, out, count;                      /*!< Write index, read index and number of entries */
+    void* entries[1];                           /*!< Entries, allocated together with structure */
+};
+
+/**
+ * \brief           Thread start parameters passed to \ref thread_entry
+ */
+typedef struct {
+    void (*thread_func)(void *);                /*!< Thread body function */
+    void* arg;                                  /*!< Thread function argument */
+} thread_start_t;
+
+static pthread_mutex_t sys_mutex;               /* Mutex for main protection */
+static gui_sys_mutex_t sys_mutex_p;             /* Pointer to main mutex */
+static struct timespec start_time;              /* Time when system was initialized */
+
+/**
+ * \brief           Calculate absolute time for timed waits
+ * \param[out]      ts: Absolute time structure to fill
+ * \param[in]       timeout: Timeout in units of milliseconds from now
+ */
+static void
+abs_timeout(struct timespec* ts, uint32_t timeout) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * \brief           Wait for condition with optional timeout
+ * \param[in]       cond: Condition to wait for
+ * \param[in]       mutex: Locked mutex protecting condition
+ * \param[in]       ts: Absolute timeout or `NULL` to wait forever
+ * \return          `1` when signaled, `0` on timeout
+ */
+static uint8_t
+cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* ts) {
+    if (ts == NULL) {
+        return pthread_cond_wait(cond, mutex) == 0;
+    }
+    return pthread_cond_timedwait(cond, mutex, ts) != ETIMEDOUT;
+}
+
+/**
+ * \brief           Thread entry converting POSIX thread signature to GUI thread signature
+ * \param[in]       param: Pointer to \ref thread_start_t structure, freed here
+ */
+static void *
+thread_entry(void* param) {
+    thread_start_t start = *(thread_start_t *)param;
+
+    free(param);
+    start.thread_func(start.arg);               /* Run thread body */
+    return NULL;
+}
+
+/**
+ * \brief           Init system dependant parameters
+ * \note            Called from high-level application layer when required
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_init(void) {
+    pthread_mutexattr_t attr;
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);/* Save reference time */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&sys_mutex, &attr);      /* Create system mutex */
+    pthread_mutexattr_destroy(&attr);
+    sys_mutex_p = &sys_mutex;
+    return 1;
+}
+
+/**
+ * \brief           Get current time in units of milliseconds
+ * \return          Current time in units of milliseconds
+ */
+uint32_t
+gui_sys_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);        /* Get monotonic time, not affected by clock changes */
+    return (uint32_t)((ts.tv_sec - start_time.tv_sec) * 1000 + (ts.tv_nsec - start_time.tv_nsec) / 1000000L);
+}
+
+/**
+ * \brief           Protect stack core
+ * \note            This function may be called multiple times, recursive protection is required
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_protect(void) {
+    gui_sys_mutex_lock(&sys_mutex_p);           /* Lock system and protect it */
+    return 1;
+}
+
+/**
+ * \brief           Protect stack core
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_unprotect(void) {
+    gui_sys_mutex_unlock(&sys_mutex_p);         /* Release lock */
+    return 1;
+}
+
+/**
+ * \brief           Create a new recursive mutex and pass it to input pointer
+ * \param[out]      p: Pointer to mutex structure to save result to
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_create(gui_sys_mutex_t* p) {
+    pthread_mutexattr_t attr;
+
+    *p = malloc(sizeof(**p));
+    if (*p == NULL) {
+        return 0;
+    }
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    if (pthread_mutex_init(*p, &attr)) {        /* Create recursive mutex */
+        free(*p);
+        *p = GUI_SYS_MUTEX_NULL;
+    }
+    pthread_mutexattr_destroy(&attr);
+    return !!*p;
+}
+
+/**
+ * \brief           Delete mutex
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_delete(gui_sys_mutex_t* p) {
+    if (pthread_mutex_destroy(*p)) {
+        return 0;
+    }
+    free(*p);
+    return 1;
+}
+
+/**
+ * \brief           Wait forever to lock the mutex
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_lock(gui_sys_mutex_t* p) {
+    return pthread_mutex_lock(*p) == 0;
+}
+
+/**
+ * \brief           Unlock mutex
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_unlock(gui_sys_mutex_t* p) {
+    return pthread_mutex_unlock(*p) == 0;
+}
+
+/**
+ * \brief           Check if mutex structure is valid
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_isvalid(gui_sys_mutex_t* p) {
+    return !!*p;
+}
+
+/**
+ * \brief           Set mutex structure as invalid
+ * \param[in]       p: Pointer to mutex structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mutex_invalid(gui_sys_mutex_t* p) {
+    *p = GUI_SYS_MUTEX_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Create a new binary semaphore and set initial state
+ * \param[out]      p: Pointer to semaphore structure to fill with result
+ * \param[in]       cnt: Count indicating default semaphore state:
+ *                     0: Lock it immediteally
+ *                     1: Leave it unlocked
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_create(gui_sys_sem_t* p, uint8_t cnt) {
+    *p = malloc(sizeof(**p));
+    if (*p == NULL) {
+        return 0;
+    }
+    pthread_mutex_init(&(*p)->mutex, NULL);
+    pthread_cond_init(&(*p)->cond, NULL);
+    (*p)->cnt = !!cnt;
+    return 1;
+}
+
+/**
+ * \brief           Delete binary semaphore
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_delete(gui_sys_sem_t* p) {
+    pthread_cond_destroy(&(*p)->cond);
+    pthread_mutex_destroy(&(*p)->mutex);
+    free(*p);
+    return 1;
+}
+
+/**
+ * \brief           Wait for semaphore to be available
+ * \param[in]       p: Pointer to semaphore structure
+ * \param[in]       timeout: Timeout to wait in milliseconds. When 0 is applied, wait forever
+ * \return          Number of milliseconds waited for semaphore to become available
+ */
+uint32_t
+gui_sys_sem_wait(gui_sys_sem_t* p, uint32_t timeout) {
+    struct timespec ts;
+    uint32_t tick = gui_sys_now();
+    uint8_t ok = 1;
+
+    if (timeout) {
+        abs_timeout(&ts, timeout);
+    }
+    pthread_mutex_lock(&(*p)->mutex);
+    while (!(*p)->cnt && ok) {
+        ok = cond_wait(&(*p)->cond, &(*p)->mutex, timeout ? &ts : NULL);
+    }
+    if ((*p)->cnt) {                            /* Condition may be valid even after timeout */
+        (*p)->cnt = 0;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&(*p)->mutex);
+    return ok ? (gui_sys_now() - tick) : GUI_SYS_TIMEOUT;
+}
+
+/**
+ * \brief           Release semaphore
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_release(gui_sys_sem_t* p) {
+    pthread_mutex_lock(&(*p)->mutex);
+    (*p)->cnt = 1;
+    pthread_cond_signal(&(*p)->cond);
+    pthread_mutex_unlock(&(*p)->mutex);
+    return 1;
+}
+
+/**
+ * \brief           Check if semaphore is valid
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_isvalid(gui_sys_sem_t* p) {
+    return !!*p;
+}
+
+/**
+ * \brief           Invalid semaphore
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_sem_invalid(gui_sys_sem_t* p) {
+    *p = GUI_SYS_SEM_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Create a new message queue with entry type of "void *"
+ * \param[out]      b: Pointer to message queue structure
+ * \param[in]       size: Number of entries for message queue to hold
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_create(gui_sys_mbox_t* b, size_t size) {
+    if (!size) {
+        size = 1;
+    }
+    *b = malloc(sizeof(**b) + (size - 1) * sizeof((*b)->entries[0]));
+    if (*b == NULL) {
+        return 0;
+    }
+    pthread_mutex_init(&(*b)->mutex, NULL);
+    pthread_cond_init(&(*b)->not_empty, NULL);
+    pthread_cond_init(&(*b)->not_full, NULL);
+    (*b)->size = size;
+    (*b)->in = (*b)->out = (*b)->count = 0;
+    return 1;
+}
+
+/**
+ * \brief           Delete message queue
+ * \param[in]       b: Pointer to message queue structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_delete(gui_sys_mbox_t* b) {
+    if ((*b)->count) {                          /* We still have messages in queue, should not delete queue */
+        return 0;
+    }
+    pthread_cond_destroy(&(*b)->not_full);
+    pthread_cond_destroy(&(*b)->not_empty);
+    pthread_mutex_destroy(&(*b)->mutex);
+    free(*b);
+    return 1;
+}
+
+/**
+ * \brief           Put entry to queue, queue mutex must be locked
+ * \param[in]       mb: Message queue
+ * \param[in]       m: Entry to insert
+ */
+static void
+mbox_write(gui_sys_mbox_t mb, void* m) {
+    mb->entries[mb->in] = m;
+    mb->in = (mb->in + 1) % mb->size;
+    mb->count++;
+    pthread_cond_signal(&mb->not_empty);
+}
+
+/**
+ * \brief           Get entry from queue, queue mutex must be locked
+ * \param[in]       mb: Message queue
+ * \param[out]      m: Pointer to save entry to
+ */
+static void
+mbox_read(gui_sys_mbox_t mb, void** m) {
+    *m = mb->entries[mb->out];
+    mb->out = (mb->out + 1) % mb->size;
+    mb->count--;
+    pthread_cond_signal(&mb->not_full);
+}
+
+/**
+ * \brief           Put a new entry to message queue and wait until memory available
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to entry to insert to message queue
+ * \return          Time in units of milliseconds needed to put a message to queue
+ */
+uint32_t
+gui_sys_mbox_put(gui_sys_mbox_t* b, void* m) {
+    uint32_t tick = gui_sys_now();
+
+    pthread_mutex_lock(&(*b)->mutex);
+    while ((*b)->count == (*b)->size) {
+        pthread_cond_wait(&(*b)->not_full, &(*b)->mutex);
+    }
+    mbox_write(*b, m);
+    pthread_mutex_unlock(&(*b)->mutex);
+    return gui_sys_now() - tick;
+}
+
+/**
+ * \brief           Get a new entry from message queue with timeout
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to pointer to result to save value from message queue to
+ * \param[in]       timeout: Maximal timeout to wait for new message. When 0 is applied, wait for unlimited time
+ * \return          Time in units of milliseconds needed to put a message to queue
+ */
+uint32_t
+gui_sys_mbox_get(gui_sys_mbox_t* b, void** m, uint32_t timeout) {
+    struct timespec ts;
+    uint32_t tick = gui_sys_now();
+    uint8_t ok = 1;
+
+    if (timeout) {
+        abs_timeout(&ts, timeout);
+    }
+    pthread_mutex_lock(&(*b)->mutex);
+    while (!(*b)->count && ok) {
+        ok = cond_wait(&(*b)->not_empty, &(*b)->mutex, timeout ? &ts : NULL);
+    }
+    ok = (*b)->count > 0;
+    if (ok) {
+        mbox_read(*b, m);
+    }
+    pthread_mutex_unlock(&(*b)->mutex);
+    return ok ? (gui_sys_now() - tick) : GUI_SYS_TIMEOUT;
+}
+
+/**
+ * \brief           Put a new entry to message queue without timeout (now or fail)
+ * \note            Safe to call from any thread, including SDL event thread of simulator
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to message to save to queue
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_putnow(gui_sys_mbox_t* b, void* m) {
+    uint8_t ok;
+
+    pthread_mutex_lock(&(*b)->mutex);
+    ok = (*b)->count < (*b)->size;
+    if (ok) {
+        mbox_write(*b, m);
+    }
+    pthread_mutex_unlock(&(*b)->mutex);
+    return ok;
+}
+
+/**
+ * \brief           Get an entry from message queue immediatelly
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to pointer to result to save value from message queue to
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_getnow(gui_sys_mbox_t* b, void** m) {
+    uint8_t ok;
+
+    pthread_mutex_lock(&(*b)->mutex);
+    ok = (*b)->count > 0;
+    if (ok) {
+        mbox_read(*b, m);
+    }
+    pthread_mutex_unlock(&(*b)->mutex);
+    return ok;
+}
+
+/**
+ * \brief           Check if message queue is valid
+ * \param[in]       b: Pointer to message queue structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_isvalid(gui_sys_mbox_t* b) {
+    return !!*b;
+}
+
+/**
+ * \brief           Invalid message queue
+ * \param[in]       b: Pointer to message queue structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_mbox_invalid(gui_sys_mbox_t* b) {
+    *b = GUI_SYS_MBOX_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Create a new detached thread
+ * \param[out]      t: Pointer to thread identifier if create was successful
+ * \param[in]       name: Name of a new thread, not used
+ * \param[in]       thread_func: Thread function to use as thread body
+ * \param[in]       arg: Thread function argument
+ * \param[in]       stack_size: Size of thread stack in uints of bytes. Default host stack is used when value is too small
+ * \param[in]       prio: Thread priority, not used
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_sys_thread_create(gui_sys_thread_t* t, const char* name, void (*thread_func)(void *), void* const arg, size_t stack_size, gui_sys_thread_prio_t prio) {
+    pthread_attr_t attr;
+    pthread_t thread;
+    thread_start_t* start;
+    uint8_t ok;
+
+    (void)name;
+    (void)prio;
+
+    start = malloc(sizeof(*start));
+    if (start == NULL) {
+        return 0;
+    }
+    start->thread_func = thread_func;
+    start->arg = arg;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (stack_size >= PTHREAD_STACK_MIN) {      /* Embedded stack sizes are too small for host */
+        pthread_attr_setstacksize(&attr, stack_size);
+    }
+    ok = pthread_create(&thread, &attr, thread_entry, start) == 0;
+    pthread_attr_destroy(&attr);
+    if (ok) {
+        *t = (gui_sys_thread_t)(uintptr_t)thread;
+    } else {
+        free(start);
+    }
+    return ok;
+}
+
+/**
+ * \brief           Get ID of currently running thread
+ * \return          Thread identifier
+ */
+gui_sys_thread_t
+gui_sys_thread_getid(void) {
+    return (gui_sys_thread_t)(uintptr_t)pthread_self();
+}
+
+#endif /* GUI_CFG_OS && GUI_CFG_SYS_POSIX */
@@ -222,6 +222,11 @@ gui_sys_thread_create(const char* name, void (*thread_func)(void *), void* const
     return osThreadCreate(&thread_def, arg);    /* Create thread */
 }
 
+gui_sys_thread_t
+gui_sys_thread_getid(void) {
+    return osThreadGetId();                     /* Get current thread */
+}
+
 #endif /* GUI_OS || __DOXYGEN__ */
 
 /**
@@ -59,6 +59,8 @@ gui_widget_t widget = {
     .callback = gui_button_callback,                /*!< Callback function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_ActiveIn) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_ActiveOut) | GUI_WC_MASK(GUI_WC_KeyPress),
 };
 
 #define b                   ((gui_button_t *)(h))
@@ -116,8 +118,8 @@ gui_button_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gu
                 gui_draw_filledrectangle(disp, x + 2, y + 2, width - 4, height - 4, c1);
                 gui_draw_rectangle3d(disp, x, y, width, height, guii_widget_getflag(h, GUI_FLAG_ACTIVE) ? GUI_DRAW_3D_State_Lowered : GUI_DRAW_3D_State_Raised);
             } else {
-                gui_draw_filledroundedrectangle(disp, x, y, width, height, b->borderradius, c1);
-                gui_draw_roundedrectangle(disp, x, y, width, height, b->borderradius, c2);
+                gui_draw_filledroundedrectangle(disp, x, y, width, height, guii_widget_getborderradius(h, b->borderradius), c1);
+                gui_draw_roundedrectangle(disp, x, y, width, height, guii_widget_getborderradius(h, b->borderradius), c2);
             }
             
             /* Draw text if possible */
@@ -132,6 +134,7 @@ gui_button_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gu
                 f.align = GUI_HALIGN_CENTER | GUI_VALIGN_CENTER;
                 f.color1width = f.width;
                 f.color1 = c2;
+                f.layout = &h->textlayout;          /* Reuse text layout between redraws */
                 gui_draw_writetext(disp, guii_widget_getfont(h), guii_widget_gettext(h), &f);
             }
             return 1;
@@ -197,5 +200,5 @@ gui_button_setcolor(gui_handle_p h, gui_button_color_t index, gui_color_t color)
 uint8_t
 gui_button_setborderradius(gui_handle_p h, gui_dim_t size) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_BORDER_RADIUS, &size, 1, 1);    /* Set parameter */
+    return guii_widget_setparam(h, CFG_BORDER_RADIUS, &size, sizeof(size), 1, 1);    /* Set parameter */
 }
@@ -62,6 +62,7 @@ gui_widget_t widget = {
     .callback = gui_checkbox_callback,              /*!< Callback function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_Click),/*!< Handled callback commands */
 };
 
 #define c                   ((gui_checkbox_t *)(h))
@@ -125,6 +126,7 @@ gui_checkbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             gui_display_t* disp = GUI_WIDGET_PARAMTYPE_DISP(param);
             gui_color_t c1;
             gui_dim_t x, y, width, height, size, sx, sy;
+            uint32_t state;
             
             x = guii_widget_getabsolutex(h);       /* Get absolute X coordinate */
             y = guii_widget_getabsolutey(h);       /* Get absolute Y coordinate */
@@ -136,27 +138,41 @@ gui_checkbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             sx = x;
             sy = y + (height - size) / 2;
             
-            if (c->flags & GUI_FLAG_CHECKBOX_DISABLED) {
-                c1 = guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_DISABLED_BG);
-            } else {
-                c1 = guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_BG);
+            state = c->flags & (GUI_FLAG_CHECKBOX_CHECKED | GUI_FLAG_CHECKBOX_DISABLED);
+            if (guii_widget_isfocused(h) && !(c->flags & GUI_FLAG_CHECKBOX_DISABLED)) {
+                state |= 0x100;                     /* Focus rectangle is part of box */
             }
-            
-            gui_draw_filledrectangle(disp, sx + 1, sy + 1, size - 2, size - 2, c1);
-            gui_draw_rectangle3d(disp, sx, sy, size, size, GUI_DRAW_3D_State_Lowered);
-            
-            if (guii_widget_isfocused(h) && !(c->flags & GUI_FLAG_CHECKBOX_DISABLED)) {    /* When in focus */
-                gui_draw_rectangle(disp, sx + 2, sy + 2, size - 4, size - 4, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
-            }
-            
-            if (c->flags & GUI_FLAG_CHECKBOX_CHECKED) {
-                gui_draw_line(disp, sx + 4, sy + 5, sx + size - 4 - 2, sy + size - 4 - 1, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
-                gui_draw_line(disp, sx + 4, sy + 4, sx + size - 4 - 1, sy + size - 4 - 1, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
-                gui_draw_line(disp, sx + 5, sy + 4, sx + size - 4 - 1, sy + size - 4 - 2, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
+#if GUI_CFG_WIDGET_STATE_CACHE
+            if (!guii_widget_drawstate(h, sx, sy, size, size, 0, state, disp))  /* Box is copied from bitmap when possible */
+#endif /* GUI_CFG_WIDGET_STATE_CACHE */
+            {
+                if (c->flags & GUI_FLAG_CHECKBOX_DISABLED) {
+                    c1 = guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_DISABLED_BG);
+                } else {
+                    c1 = guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_BG);
+                }
+                
+                gui_draw_filledrectangle(disp, sx + 1, sy + 1, size - 2, size - 2, c1);
+                gui_draw_rectangle3d(disp, sx, sy, size, size, GUI_DRAW_3D_State_Lowered);
+                
+                if (state & 0x100) {                /* When in focus */
+                    gui_draw_rectangle(disp, sx + 2, sy + 2, size - 4, size - 4, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
+                }
                 
-                gui_draw_line(disp, sx + 4, sy + size - 4 - 2, sx + size - 4 - 2, sy + 4, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
-                gui_draw_line(disp, sx + 4, sy + size - 4 - 1, sx + size - 4 - 1, sy + 4, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
-                gui_draw_line(disp, sx + 5, sy + size - 4 - 1, sx + size - 4 - 1, sy + 5, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
+                if (c->flags & GUI_FLAG_CHECKBOX_CHECKED) {
+                    gui_draw_line(disp, sx + 4, sy + 5, sx + size - 4 - 2, sy + size - 4 - 1, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
+                    gui_draw_line(disp, sx + 4, sy + 4, sx + size - 4 - 1, sy + size - 4 - 1, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
+                    gui_draw_line(disp, sx + 5, sy + 4, sx + size - 4 - 1, sy + size - 4 - 2, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
+                    
+                    gui_draw_line(disp, sx + 4, sy + size - 4 - 2, sx + size - 4 - 2, sy + 4, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
+                    gui_draw_line(disp, sx + 4, sy + size - 4 - 1, sx + size - 4 - 1, sy + 4, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
+                    gui_draw_line(disp, sx + 5, sy + size - 4 - 1, sx + size - 4 - 1, sy + 5, guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_FG));
+                }
+#if GUI_CFG_WIDGET_STATE_CACHE
+                if ((c1 >> 24) == 0xFF) {           /* Box covers its area */
+                    guii_widget_savestate(h, sx, sy, size, size, state, disp);
+                }
+#endif /* GUI_CFG_WIDGET_STATE_CACHE */
             }
             
             /* Draw text if possible */
@@ -171,6 +187,7 @@ gui_checkbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                 f.align = GUI_HALIGN_LEFT | GUI_VALIGN_CENTER;
                 f.color1width = f.width;
                 f.color1 = guii_widget_getcolor(h, GUI_CHECKBOX_COLOR_TEXT);
+                f.layout = &h->textlayout;          /* Reuse text layout between redraws */
                 gui_draw_writetext(disp, guii_widget_getfont(h), guii_widget_gettext(h), &f);
             }
             
@@ -229,7 +246,7 @@ gui_checkbox_setcolor(gui_handle_p h, gui_checkbox_color_t index, gui_color_t co
 uint8_t
 gui_checkbox_setchecked(gui_handle_p h, uint8_t checked) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_CHECK, &checked, 0, 0); /* Set parameter */
+    return guii_widget_setparam(h, CFG_CHECK, &checked, sizeof(checked), 0, 0); /* Set parameter */
 }
 
 /**
@@ -241,7 +258,7 @@ gui_checkbox_setchecked(gui_handle_p h, uint8_t checked) {
 uint8_t
 gui_checkbox_setdisabled(gui_handle_p h, uint8_t disabled) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_DISABLE, &disabled, 0, 0);  /* Set parameter */
+    return guii_widget_setparam(h, CFG_DISABLE, &disabled, sizeof(disabled), 0, 0);  /* Set parameter */
 }
 
 /**
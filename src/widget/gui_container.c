@@ -33,6 +33,7 @@
 #include "widget/gui_container.h"
 
 #define __GW(x)             ((gui_window_t *)(x))
+#define o                   ((gui_container_t *)(h))
 
 static uint8_t gui_container_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
 
@@ -51,12 +52,39 @@ static const
 gui_widget_t widget = {
     .name = _GT("CONTAINER"),                       /*!< Widget name */
     .size = sizeof(gui_container_t),                /*!< Size of widget for memory allocation */
-    .flags = GUI_FLAG_WIDGET_ALLOW_CHILDREN,        /*!< List of widget flags */
+    .flags = GUI_FLAG_WIDGET_ALLOW_CHILDREN | GUI_FLAG_WIDGET_OPAQUE,   /*!< List of widget flags */
     .callback = gui_container_callback,             /*!< Control function */
     .colors = colors,                               /*!< Pointer to colors array */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_VisibilityChanged),/*!< Handled callback commands */
 };
 
+/**
+ * \brief           Create children widgets with builder function if not created yet
+ * \param[in]       h: Widget handle
+ */
+static void
+build_children(gui_handle_p h) {
+    if (o->builder != NULL && !o->built) {
+        o->built = 1;                               /* Set before call, builder creates widgets */
+        o->builder(h);
+    }
+}
+
+/**
+ * \brief           Timer callback to remove children widgets of hidden container
+ * \param[in]       t: Timer handle
+ */
+static void
+timer_callback(gui_timer_t* t) {
+    gui_handle_p h = guii_timer_getparams(t);       /* Get timer parameters */
+    
+    if (guii_widget_ishidden(h) && o->built) {      /* Still hidden */
+        guii_widget_removechildren(h);              /* Free children until next show */
+        o->built = 0;
+    }
+}
+
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -78,10 +106,21 @@ gui_container_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             wi = guii_widget_getwidth(h);
             hi = guii_widget_getheight(h);
  
-            gui_draw_filledrectangle(disp, x, y, wi, hi, guii_widget_getcolor(h, GUI_CONTAINER_COLOR_BG));
+            guii_widget_drawbackground(h, disp, x, y, wi, hi, guii_widget_getcolor(h, GUI_CONTAINER_COLOR_BG));
             
             return 1;
         }
+        case GUI_WC_VisibilityChanged: {
+            if (GUI_WIDGET_PARAMTYPE_INT(param)) {  /* Container was shown */
+                if (guii_widget_getextvalue(h, timer, NULL) != NULL) {
+                    guii_timer_stop(h->ext->timer); /* Keep children */
+                }
+                build_children(h);                  /* Create children on first show */
+            } else if (guii_widget_getextvalue(h, timer, NULL) != NULL && o->built) {
+                guii_timer_start(h->ext->timer);    /* Remove children when hidden for too long */
+            }
+            return 1;
+        }
         default:                                    /* Handle default option */
             GUI_UNUSED3(h, param, result);          /* Unused elements to prevent compiler warnings */
             return 0;                               /* Command was not processed */
@@ -117,3 +156,37 @@ gui_container_setcolor(gui_handle_p h, gui_container_color_t index, gui_color_t
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     return guii_widget_setcolor(h, (uint8_t)index, color); /* Set color */
 }
+
+/**
+ * \brief           Set function to create children widgets of container when it is shown for the first time
+ * \note            When container is visible, children widgets are created immediately.
+ *                  Otherwise they are created on first \ref gui_widget_show call on container
+ * \note            Builder is called with GUI protection activated, from the thread showing container
+ * \param[in,out]   h: Widget handle
+ * \param[in]       builder: Function to create children widgets. Set to `NULL` to disable deferred creation
+ * \param[in]       destroy_timeout: Time in units of milliseconds container must be hidden before
+ *                      its children widgets are removed and created again on next show. Set to `0` to keep them
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_container_setbuilder(gui_handle_p h, gui_container_builder_fn builder, uint16_t destroy_timeout) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    o->builder = builder;
+    o->destroy_timeout = destroy_timeout;
+    if (guii_widget_getextvalue(h, timer, NULL) != NULL) {
+        guii_timer_remove(&h->ext->timer);          /* Remove previous timer */
+    }
+    if (builder != NULL && destroy_timeout && guii_widget_getext(h) != NULL) {
+        h->ext->timer = guii_timer_create(destroy_timeout, timer_callback, h);  /* Timer is removed with widget */
+    }
+    if (guii_widget_isvisible(h)) {
+        build_children(h);                          /* Visible now, create children immediately */
+    } else if (guii_widget_getextvalue(h, timer, NULL) != NULL && o->built) {
+        guii_timer_start(h->ext->timer);
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
@@ -56,6 +56,8 @@ gui_widget_t widget = {
     .callback = gui_debugbox_callback,              /*!< Callback function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Define number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_Click) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_TouchStart) | GUI_WC_MASK(GUI_WC_TouchMove),
 };
 
 #define o                   ((gui_debugbox_t *)(h))
@@ -83,24 +85,85 @@ nr_entries_pp(gui_handle_p h) {
     return res;
 }
 
+/* Redraw widget after visible start index changed, move already drawn rows when possible */
+static void
+scroll_redraw(gui_handle_p h, int16_t start, uint8_t flags) {
+    guii_widget_scrollrows(h, o->visiblestartindex - start, 0,
+        flags == o->flags ? item_height(h, NULL) : 0, 0,    /* Height is 0 without font */
+        o->flags & GUI_FLAG_DEBUGBOX_SLIDER_ON ? o->sliderwidth : 0);
+}
+
 /* Slide up or slide down widget elements */
 static void
 slide(gui_handle_p h, int16_t dir) {
     int16_t mPP = nr_entries_pp(h);
+    int16_t start = o->visiblestartindex;
+    
     if (dir < 0) {                                  /* Slide elements up */
         if ((o->visiblestartindex + dir) < 0) {
             o->visiblestartindex = 0;
         } else {
             o->visiblestartindex += dir;
         }
-        guii_widget_invalidate(h);
     } else if (dir > 0) {
         if ((o->visiblestartindex + dir) > (o->count - mPP - 1)) {  /* Slide elements down */
-            o->visiblestartindex = o->count - mPP;
+            o->visiblestartindex = GUI_MAX(o->count - mPP, 0);
         } else {
             o->visiblestartindex += dir;
         }
-        guii_widget_invalidate(h);
+    }
+    scroll_redraw(h, start, o->flags);              /* Redraw changed part */
+}
+
+/* Get text of line at logical index, where index `0` is the oldest line */
+#define line_text(h, index) (o->buff + o->lines[(o->first + (index)) % o->maxcount])
+
+/* Allocate text buffer and line index on first use */
+static uint8_t
+alloc_buffers(gui_handle_p h) {
+    if (o->buff == NULL) {
+        o->buff = GUI_MEMALLOC(o->buffsize);        /* Allocate memory for text */
+    }
+    if (o->lines == NULL) {
+        o->lines = GUI_MEMALLOC(o->maxcount * sizeof(*o->lines));   /* Allocate memory for line offsets */
+    }
+    return o->buff != NULL && o->lines != NULL;
+}
+
+/* Remove oldest line from buffer */
+static void
+drop_oldest(gui_handle_p h) {
+    o->first = (o->first + 1) % o->maxcount;
+    if (--o->count == 0) {                          /* Start at the beginning when empty */
+        o->first = 0;
+        o->head = 0;
+    }
+}
+
+/* Get offset for "len" bytes in text buffer and remove oldest lines if there is no space */
+static uint16_t
+reserve_space(gui_handle_p h, uint16_t len) {
+    uint16_t tail;
+    
+    while (1) {
+        if (o->count == 0) {                        /* Empty buffer has all memory available */
+            o->first = 0;
+            o->head = 0;
+            return 0;
+        }
+        if (o->count < o->maxcount) {               /* Is there free line entry? */
+            tail = o->lines[o->first];              /* Oldest line offset */
+            if (o->head > tail) {                   /* Used memory does not wrap */
+                if (o->buffsize - o->head >= len) {
+                    return o->head;
+                } else if (tail >= len) {           /* Wrap to start, end of buffer stays unused */
+                    return 0;
+                }
+            } else if (tail - o->head >= len) {     /* Free memory between newest and oldest line */
+                return o->head;
+            }
+        }
+        drop_oldest(h);                             /* Overwrite oldest line */
     }
 }
 
@@ -148,6 +211,7 @@ gui_debugbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
         case GUI_WC_PreInit: {
             __GL(h)->sliderwidth = 30;              /* Set slider width */
             __GL(h)->maxcount = 15;                 /* Number of maximal entries for debug */
+            __GL(h)->buffsize = GUI_CFG_WIDGET_DEBUGBOX_BUFFER_SIZE;    /* Size of text buffer */
             __GL(h)->flags |= GUI_FLAG_DEBUGBOX_SLIDER_AUTO;   /* Set auto mode for slider */
             return 1;
         }
@@ -185,11 +249,10 @@ gui_debugbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             }
             
             /* Draw text if possible */
-            if (h->font != NULL && gui_linkedlist_hasentries(&__GL(h)->root)) { /* Is first set? */
+            if (h->font != NULL && __GL(h)->count > 0) { /* Is first set? */
                 gui_draw_font_t f;
-                gui_debugbox_item_t* item;
                 uint16_t itemheight;                /* Get item height */
-                uint16_t index = 0;                 /* Start index */
+                int16_t index;
                 gui_dim_t tmp;
                 
                 itemheight = item_height(h, 0);     /* Get item height and Y offset */
@@ -208,13 +271,9 @@ gui_debugbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                     disp->y2 = y + height - 2;
                 }
                 
-                for (index = 0, item = (gui_debugbox_item_t *)gui_linkedlist_getnext_gen(&o->root, NULL); item && f.y <= disp->y2;
-                        item = (gui_debugbox_item_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)item), index++) {
-                    if (index < o->visiblestartindex) { /* Check for start drawing index */
-                        continue;
-                    }
+                for (index = o->visiblestartindex; index < o->count && f.y <= disp->y2; index++) {
                     f.color1 = guii_widget_getcolor(h, GUI_DEBUGBOX_COLOR_TEXT);
-                    gui_draw_writetext(disp, guii_widget_getfont(h), item->text, &f);
+                    gui_draw_writetext(disp, guii_widget_getfont(h), line_text(h, index), &f);
                     f.y += itemheight;
                 }
                 disp->y2 = tmp;
@@ -223,10 +282,13 @@ gui_debugbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             return 1;
         }
         case GUI_WC_Remove: {
-            gui_debugbox_item_t* item;
-            while ((item = (gui_debugbox_item_t *)gui_linkedlist_remove_gen(&o->root, (gui_linkedlist_t *)gui_linkedlist_getnext_gen(&o->root, NULL))) != NULL) {
-                GUI_MEMFREE(item);                  /* Free memory */
+            if (o->buff != NULL) {
+                GUI_MEMFREE(o->buff);               /* Free text buffer */
+            }
+            if (o->lines != NULL) {
+                GUI_MEMFREE(o->lines);              /* Free line index */
             }
+            o->count = 0;
             return 1;
         }
 #if GUI_CFG_USE_TOUCH
@@ -305,52 +367,61 @@ gui_debugbox_setcolor(gui_handle_p h, GUI_DEBUGBOX_COLOR_t index, gui_color_t co
 }
 
 /**
- * \brief           Add a new string to list box
+ * \brief           Add a new string to debug box
+ * \note            Text is copied to circular buffer of widget. When there is no space
+ *                  or maximal number of lines is reached, oldest lines are overwritten.
+ *                  Text longer than buffer size is truncated
  * \param[in,out]   h: Widget handle
- * \param[in]       text: Pointer to text to add to list. Only pointer is saved to memory!
+ * \param[in]       text: Pointer to text to add to list
  * \return          `1` on success, `0` otherwise
+ * \sa              gui_debugbox_setmaxitems, gui_debugbox_setbuffersize
  */
 uint8_t
 gui_debugbox_addstring(gui_handle_p h, const gui_char* text) {
-    gui_debugbox_item_t* item;
-    uint8_t ret = 0;
+    size_t len;
+    uint16_t pos;
+    int16_t start, dropped;
+    uint8_t flags, ret = 0;
     
-    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && text != NULL);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
     
-    item = GUI_MEMALLOC(sizeof(*item) + gui_string_lengthtotal(text) + 1);  /* Allocate memory for entry */
-    if (item != NULL) {
-        __GUI_ENTER();                              /* Enter GUI */
-        item->text = (void *)((char *)item + sizeof(*item));/* Add text to entry */
-        gui_string_copy(item->text, text);          /* Copy text */
-        gui_linkedlist_add_gen(&__GL(h)->root, &item->list);/* Add to linked list */
-        __GL(h)->count++;                           /* Increase number of strings */
-        
-        /*
-         * Use while loop in case user later changed max
-         * number of entries to lower value.
-         *
-         * In this case we have to remove more than just one element
-         */
-        while (__GL(h)->count > __GL(h)->maxcount) {
-            gui_debugbox_item_t* firstItem;
-            firstItem = (gui_debugbox_item_t *)gui_linkedlist_getnext_gen(&__GL(h)->root, NULL);
-            if (firstItem != NULL) {
-                gui_linkedlist_remove_gen(&__GL(h)->root, (gui_linkedlist_t *)firstItem);
-                GUI_MEMFREE(firstItem);
-                __GL(h)->count--;
-            } else {
-                break;
+    if (alloc_buffers(h)) {                         /* Allocate buffers on first use */
+        len = gui_string_lengthtotal(text) + 1;     /* Number of bytes including trailing zero */
+        if (len > __GL(h)->buffsize) {              /* Truncate too long text */
+            len = __GL(h)->buffsize;
+            while (len > 1 && (text[len - 1] & 0xC0) == 0x80) {  /* Do not split multi-byte character */
+                len--;
             }
         }
         
+        start = __GL(h)->visiblestartindex;
+        flags = __GL(h)->flags;
+        dropped = __GL(h)->count + 1;
+        
+        pos = reserve_space(h, len);                /* Get place for new line */
+        __GL(h)->lines[(__GL(h)->first + __GL(h)->count) % __GL(h)->maxcount] = pos;
+        memcpy(&__GL(h)->buff[pos], text, len - 1); /* Copy text */
+        __GL(h)->buff[pos + len - 1] = 0;
+        __GL(h)->head = pos + len;                  /* Set next write position */
+        __GL(h)->count++;                           /* Increase number of strings */
+        dropped -= __GL(h)->count;                  /* Number of overwritten lines */
+        
         __GL(h)->visiblestartindex = __GL(h)->count;/* Invalidate visible start index */
         check_values(h);                            /* Check values */
-        guii_widget_invalidate(h);                 /* Invalidate widget */
-        __GUI_LEAVE();                              /* Leave GUI */
-        
+        if (__GL(h)->visiblestartindex + dropped != start) {
+            scroll_redraw(h, start - dropped, flags);   /* Visible lines moved up */
+        } else if (h->font != NULL && flags == __GL(h)->flags && !(flags & GUI_FLAG_DEBUGBOX_SLIDER_ON)) {
+            gui_dim_t itemheight = item_height(h, NULL);
+            guii_widget_invalidaterect(h, 2, 2 + (__GL(h)->count - 1 - start) * itemheight,
+                guii_widget_getwidth(h) - 4, itemheight);   /* Draw only new line */
+        } else {
+            guii_widget_invalidate(h);             /* Invalidate widget */
+        }
         ret = 1;
     }
     
+    __GUI_LEAVE();                                  /* Leave GUI */
     return ret;
 }
 
@@ -419,40 +490,92 @@ gui_debugbox_setslidervisibility(gui_handle_p h, uint8_t visible) {
 uint8_t
 gui_debugbox_scroll(gui_handle_p h, int16_t step) {
     volatile int16_t start;
+    uint8_t flags;
     
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
+    flags = __GL(h)->flags;
     start = __GL(h)->visiblestartindex;
     __GL(h)->visiblestartindex += step;
         
     check_values(h);                                /* Check widget values */
+    scroll_redraw(h, start, flags);                 /* Redraw changed part */
     
     start = start != __GL(h)->visiblestartindex;    /* Check if there was valid change */
     
-    if (start) {
-        guii_widget_invalidate(h);
-    }
-    
     __GUI_LEAVE();                                  /* Leave GUI */
     return start;
 }
 
 /**
  * \brief           Set maximal number of items for debugbox
+ * \note            When new value is lower than current number of lines, oldest lines are removed
  * \param[in,out]   h: Widget handle
  * \param[in]       max_items: Maximal number of items
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_debugbox_setmaxitems(gui_handle_p h, int16_t max_items) {
-    volatile int16_t start;
+    uint16_t* lines;
+    int16_t i, count;
+    uint8_t ret = 1;
     
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && max_items > 0);   /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
-    __GL(h)->maxcount = max_items;
+    if (__GL(h)->lines != NULL) {                   /* Line index already in use? */
+        lines = GUI_MEMALLOC(max_items * sizeof(*lines));
+        if (lines != NULL) {
+            count = GUI_MIN(__GL(h)->count, max_items); /* Keep only newest lines */
+            for (i = 0; i < count; i++) {
+                lines[i] = __GL(h)->lines[(__GL(h)->first + __GL(h)->count - count + i) % __GL(h)->maxcount];
+            }
+            GUI_MEMFREE(__GL(h)->lines);
+            __GL(h)->lines = lines;
+            __GL(h)->first = 0;
+            __GL(h)->count = count;
+            if (count == 0) {
+                __GL(h)->head = 0;
+            }
+        } else {
+            ret = 0;
+        }
+    }
+    if (ret) {
+        __GL(h)->maxcount = max_items;
+        check_values(h);                            /* Check values */
+        guii_widget_invalidate(h);                 /* Invalidate widget */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Set size of circular text buffer for debugbox
+ * \note            All existing lines are removed from widget
+ * \param[in,out]   h: Widget handle
+ * \param[in]       size: Size of buffer in units of bytes, between `2` and `65535`
+ * \return          `1` on success, `0` otherwise
+ * \sa              GUI_CFG_WIDGET_DEBUGBOX_BUFFER_SIZE
+ */
+uint8_t
+gui_debugbox_setbuffersize(gui_handle_p h, size_t size) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && size > 1 && size <= 0xFFFF);    /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (__GL(h)->buff != NULL) {
+        GUI_MEMFREE(__GL(h)->buff);                 /* Buffer is allocated again on next line */
+    }
+    __GL(h)->buffsize = (uint16_t)size;
+    __GL(h)->count = 0;
+    __GL(h)->first = 0;
+    __GL(h)->head = 0;
+    
+    check_values(h);                                /* Check values */
+    guii_widget_invalidate(h);                     /* Invalidate widget */
     
     __GUI_LEAVE();                                  /* Leave GUI */
-    return 0;
+    return 1;
 }
@@ -33,26 +33,28 @@
 #include "widget/gui_dialog.h"
 
 /**
- * \brief           Structure of dismissed dialogs
+ * \brief           Structure of dialog waiting for dismiss
  */
 typedef struct {
-    gui_linkedlist_t list;                          /*!< Linked list entry element, must always be first on list */
+    gui_handle_p h;                                 /*!< Pointer to dialog address, `NULL` when dismissed */
     gui_id_t id;                                    /*!< Dialog ID */
-    gui_handle_p h;                                 /*!< Pointer to dialog address */
+    uint8_t used;                                   /*!< Entry is in use */
     volatile int status;                            /*!< Status on dismissed call */
+    gui_dialog_done_fn done;                        /*!< Callback on dismiss */
+    void* arg;                                      /*!< User argument for callback */
 #if GUI_CFG_OS
-    gui_sys_sem_t sem;                              /*!< Semaphore handle for blocking */
+    gui_sys_sem_t sem;                              /*!< Semaphore handle for blocking, kept for next dialogs */
     uint8_t ib;                                     /*!< Indication if dialog is blocking */
 #endif /* GUI_CFG_OS */
-} dissmissed_dialog_list_t;
+} dialog_entry_t;
 
 static uint8_t gui_dialog_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
 
 /**
- * \brief           List of dismissed dialog elements not yet read
+ * \brief           Pool of dialogs not dismissed yet
  */
 static
-gui_linkedlistroot_t ddlist;
+dialog_entry_t dialogs[GUI_CFG_WIDGET_DIALOG_POOL_SIZE];
 
 /**
  * \brief           Widget initialization structure
@@ -65,44 +67,49 @@ gui_widget_t widget = {
     .callback = gui_dialog_callback,                /*!< Control function */
     .colors = NULL,                                 /*!< Pointer to colors array */
     .color_count = 0,                               /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE,                     /*!< Handled callback commands */
 };
 
 /* Add widget to active dialogs (not yet dismissed) */
-static dissmissed_dialog_list_t *
+static dialog_entry_t *
 add_to_active_dialogs(gui_handle_p h) {
-    dissmissed_dialog_list_t* l;
+    size_t i;
     
-    l = GUI_MEMALLOC(sizeof(*l));                   /* Allocate memory for dismissed dialog list */
-    if (l != NULL) {
-        l->h = h;
-        l->id = guii_widget_getid(h);
-        gui_linkedlist_add_gen(&ddlist, &l->list);  /* Add entry to linked list */
+    for (i = 0; i < GUI_COUNT_OF(dialogs); i++) {
+        if (!dialogs[i].used) {                     /* Take first free entry */
+            dialogs[i].used = 1;
+            dialogs[i].h = h;
+            dialogs[i].id = guii_widget_getid(h);
+            dialogs[i].done = NULL;
+#if GUI_CFG_OS
+            dialogs[i].ib = 0;
+#endif /* GUI_CFG_OS */
+            return &dialogs[i];
+        }
     }
-    return l;
+    return NULL;
 }
 
-/* Remove and free memory from linked list */
+/* Return entry to pool */
 static void
-remove_from_active_dialogs(dissmissed_dialog_list_t* l) {
-    gui_linkedlist_remove_gen(&ddlist, &l->list);   /* Remove entry from linked list first */
-    GUI_MEMFREE(l);                                 /* Free memory */
+remove_from_active_dialogs(dialog_entry_t* l) {
+    l->h = NULL;
+    l->used = 0;
 }
 
-/* Get entry from linked list for specific dialog */
-static dissmissed_dialog_list_t *
+/* Get entry from pool for specific dialog */
+static dialog_entry_t *
 get_dialog(gui_handle_p h) {
-    dissmissed_dialog_list_t* l = NULL;
     gui_id_t id;
+    size_t i;
     
-    id = guii_widget_getid(h);                     /* Get id of widget */
-    
-    for (l = (dissmissed_dialog_list_t *)gui_linkedlist_getnext_gen((gui_linkedlistroot_t *)&ddlist, NULL); l != NULL;
-        l = (dissmissed_dialog_list_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)l)) {
-        if (l->h == h && l->id == id) {             /* Check match for handle and id */
-            break;
+    id = guii_widget_getid(h);                      /* Get id of widget */
+    for (i = 0; i < GUI_COUNT_OF(dialogs); i++) {
+        if (dialogs[i].used && dialogs[i].h == h && dialogs[i].id == id) {  /* Check match for handle and id */
+            return &dialogs[i];
         }
     }
-    return l;
+    return NULL;
 }
 
 /**
@@ -146,6 +153,7 @@ gui_dialog_create(gui_id_t id, float x, float y, float width, float height, gui_
     if (ptr != NULL) {
         __GUI_ENTER();                              /* Enter GUI */
         guii_widget_setflag(ptr, GUI_FLAG_WIDGET_DIALOG_BASE); /* Add dialog base flag to widget */
+        guii_widget_treechanged();                  /* Dialogs limit touch to widgets above them */
         gui_linkedlist_widgetmovetobottom(ptr);     /* Move to bottom on linked list make it on top now with flag set as dialog */
         add_to_active_dialogs(ptr);                 /* Add this dialog to active dialogs */
         __GUI_LEAVE();                              /* Leave GUI */
@@ -154,6 +162,45 @@ gui_dialog_create(gui_id_t id, float x, float y, float width, float height, gui_
     return (gui_handle_p)ptr;
 }
 
+/**
+ * \brief           Create new dialog base element without any "design" style and get dismiss status with callback
+ * \note            Function returns immediately, `done` callback is called when dialog is dismissed
+ *                  using \ref gui_dialog_dismiss function by user
+ *
+ * \param[in]       id: Widget unique ID to use for identity for callback processing
+ * \param[in]       x: Widget X position relative to parent widget
+ * \param[in]       y: Widget Y position relative to parent widget
+ * \param[in]       width: Widget width in units of pixels
+ * \param[in]       height: Widget height in uints of pixels
+ * \param[in]       func: Widget create function used as dialog base. In most cases \ref gui_container_create will be used to create empty container
+ * \param[in]       cb: Pointer to \ref gui_widget_callback_t callback function. Set to NULL to use default widget callback
+ * \param[in]       flags: flags for widget creation
+ * \param[in]       done: Callback function called with dismiss status
+ * \param[in]       arg: User argument passed to `done` callback
+ * \return          \ref gui_handle_p object of created widget on success, NULL otherwise
+ */
+gui_handle_p
+gui_dialog_createasync(gui_id_t id, float x, float y, float width, float height, gui_widget_createfunc_t func, gui_widget_callback_t cb, uint16_t flags, gui_dialog_done_fn done, void* arg) {
+    gui_handle_p ptr;
+    
+    ptr = gui_dialog_create(id, x, y, width, height, func, cb, flags);  /* Create dialog first */
+    if (ptr != NULL) {
+        dialog_entry_t* l;
+        
+        __GUI_ENTER();                              /* Enter GUI */
+        l = get_dialog(ptr);
+        if (l != NULL) {
+            l->done = done;
+            l->arg = arg;
+        } else {                                    /* No free entry for dismiss status */
+            guii_widget_remove(ptr);
+            ptr = NULL;
+        }
+        __GUI_LEAVE();                              /* Leave GUI */
+    }
+    return ptr;
+}
+
 #if GUI_CFG_OS || __DOXYGEN__
 /**
  * \brief           Create new dialog base element without any "design" style and wait for dismiss status
@@ -176,24 +223,22 @@ gui_dialog_createblocking(gui_id_t id, gui_dim_t x, gui_dim_t y, gui_dim_t width
     
     ptr = gui_dialog_create(id, x, y, width, height, func, cb, flags);  /* Create dialog first */
     if (ptr != NULL) {                              /* Widget created */
-        dissmissed_dialog_list_t* l;
+        dialog_entry_t* l;
         
         __GUI_ENTER();                              /* Enter GUI */
         l = get_dialog(ptr);                        /* Get entry from active dialogs */
-        if (l != NULL) {                            /* Check if successfully added widget to active dialogs */
+        if (l != NULL && (gui_sys_sem_isvalid(&l->sem) || gui_sys_sem_create(&l->sem, 0))) {  /* Semaphore of entry is created only once */
             l->ib = 1;                              /* Blocking entry */
-            if (gui_sys_sem_create(&l->sem, 0)) {   /* Create semaphore and lock it immediatelly */
-                __GUI_SYS_UNPROTECT();              /* Disable protection while waiting for semaphore */
-                gui_sys_sem_wait(&l->sem, 0);       /* Wait for semaphore again, should be released from dismiss function */
-                __GUI_SYS_PROTECT();                /* Protect back before continuing */
-                gui_sys_sem_delete(&l->sem);        /* Delete system semaphore */
-                resp = l->status;                   /* Get new status */
-                remove_from_active_dialogs(l);      /* Remove from active dialogs */
-            } else {
-                guii_widget_remove(ptr);           /* Remove widget */
-            }
+            __GUI_SYS_UNPROTECT();                  /* Disable protection while waiting for semaphore */
+            gui_sys_sem_wait(&l->sem, 0);           /* Wait for semaphore again, should be released from dismiss function */
+            __GUI_SYS_PROTECT();                    /* Protect back before continuing */
+            resp = l->status;                       /* Get new status */
+            remove_from_active_dialogs(l);          /* Remove from active dialogs */
         } else {
-            guii_widget_remove(ptr);               /* Remove widget */
+            if (l != NULL) {
+                remove_from_active_dialogs(l);
+            }
+            guii_widget_remove(ptr);                /* Remove widget */
         }
         __GUI_LEAVE();                              /* Leave GUI */
     }
@@ -210,7 +255,7 @@ gui_dialog_createblocking(gui_id_t id, gui_dim_t x, gui_dim_t y, gui_dim_t width
  */
 uint8_t
 gui_dialog_dismiss(gui_handle_p h, int status) {
-    dissmissed_dialog_list_t* l;
+    dialog_entry_t* l;
     uint8_t ret = 0;
     gui_widget_param_t param = {0};
     
@@ -221,11 +266,15 @@ gui_dialog_dismiss(gui_handle_p h, int status) {
     l = get_dialog(h);                              /* Get entry from list */
     if (l != NULL) {
         l->status = status;                         /* Save status for later */
+        l->h = NULL;                                /* Entry does not match dialog anymore */
         
         GUI_WIDGET_PARAMTYPE_INT(&param) = l->status;
         guii_widget_callback(h, GUI_WC_OnDismiss, &param, NULL);   /* Process callback */
+        if (l->done != NULL) {
+            l->done(h, status, l->arg);             /* Complete asynchronous dialog */
+        }
 #if GUI_CFG_OS
-        if (l->ib && gui_sys_sem_isvalid(&l->sem)) {/* Check if semaphore is valid */
+        if (l->ib) {                                /* Waiting thread reads status and frees entry */
             gui_sys_sem_release(&l->sem);           /* Release locked semaphore */
         } else 
 #endif /* GUI_CFG_OS */
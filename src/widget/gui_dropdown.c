@@ -60,6 +60,10 @@ gui_widget_t widget = {
     .callback = gui_dropdown_callback,              /*!< Callback function */
     .colors = colors,
     .color_count = GUI_COUNT_OF(colors),            /*!< Define number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_FocusOut) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_TouchStart) | GUI_WC_MASK(GUI_WC_TouchMove) |
+            GUI_WC_MASK(GUI_WC_TouchEnd) | GUI_WC_MASK(GUI_WC_Click) |
+            GUI_WC_MASK(GUI_WC_IncSelection) | GUI_WC_MASK(GUI_WC_KeyPress),
 };
 
 #define o                   ((gui_dropdown_t *)(h))
@@ -112,6 +116,61 @@ nr_entries_pp(gui_handle_p h) {
     return res;
 }
 
+/* Get scroll position of opened list in units of pixels */
+static int32_t
+get_scroll(gui_handle_p h) {
+    return (int32_t)o->visiblestartindex * item_height(h, NULL) + o->visibleoffset;
+}
+
+/* Get maximal scroll position in units of pixels, last entry is aligned to bottom */
+static int32_t
+get_maxscroll(gui_handle_p h) {
+    return (int32_t)GUI_MAX(o->count - nr_entries_pp(h), 0) * item_height(h, NULL);
+}
+
+/* Scroll opened list to pixel position, move already drawn entries when possible */
+static void
+set_scroll(gui_handle_p h, int32_t scroll) {
+    gui_dim_t y, width, height, y1, height1, dy;
+    uint16_t itemheight;
+    
+    if (h->font == NULL || !is_opened(h)) {
+        return;
+    }
+    itemheight = item_height(h, NULL);
+    scroll = GUI_MAX(GUI_MIN(scroll, get_maxscroll(h)), 0);
+    dy = (gui_dim_t)(scroll - get_scroll(h));
+    if (!dy) {                                      /* Nothing changed */
+        return;
+    }
+    o->visiblestartindex = (int16_t)(scroll / itemheight);
+    o->visibleoffset = (gui_dim_t)(scroll % itemheight);
+    
+    y = 0;                                          /* Relative position of opened part */
+    width = guii_widget_getwidth(h);
+    height = guii_widget_getheight(h);
+    get_opened_positions(h, &y, &height, &y1, &height1);
+    if (GUI_ABS(dy) >= height - 4) {
+        guii_widget_invalidate(h);                  /* All visible entries are new */
+        return;
+    }
+    if (o->flags & GUI_FLAG_DROPDOWN_SLIDER_ON) {
+        width -= o->sliderwidth;
+        guii_widget_invalidaterect(h, width - 1, y + 1, o->sliderwidth, height - 2);   /* Slider position changed */
+    } else {
+        width--;
+    }
+    guii_widget_scroll(h, 2, y + 2, width - 3, height - 4, dy); /* Move entries area */
+}
+
+#if GUI_CFG_USE_TOUCH
+/* Animation callback for kinetic scroll */
+static void
+anim_exec(gui_handle_p h, int32_t value) {
+    set_scroll(h, value);
+}
+#endif /* GUI_CFG_USE_TOUCH */
+
 /* Open or close dropdown widget */
 static uint8_t
 open_close(gui_handle_p h, uint8_t state) {
@@ -123,11 +182,23 @@ open_close(gui_handle_p h, uint8_t state) {
             o->C.y = o->C.y - (HEIGHT_CONST(h) - 1) * o->C.height; /* Go up for 3 height values */
         }
         o->C.height = HEIGHT_CONST(h) * o->C.height;
+#if GUI_CFG_WIDGET_SAVE_UNDER
+        guii_widget_saveunder(h);                   /* Keep pixels below list for close */
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
         guii_widget_invalidate(h);                  /* Invalidate widget */
         return 1;
     } else if (!state && (o->flags & GUI_FLAG_DROPDOWN_OPENED)) {
-        guii_widget_invalidatewithparent(h);        /* Invalidate widget */
+#if GUI_CFG_WIDGET_SAVE_UNDER
+        if (guii_widget_restoreunder(h)) {          /* Widgets below list are not drawn again */
+            guii_widget_invalidate(h);
+        } else
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
+        {
+            guii_widget_invalidatewithparent(h);    /* Invalidate widget */
+        }
         o->flags &= ~GUI_FLAG_DROPDOWN_OPENED;      /* Clear flag */
+        guii_anim_stop(h, NULL);                    /* Stop kinetic scroll */
+        o->visibleoffset = 0;
         o->C.height = o->oldheight;                 /* Restore height value */
         o->C.y = o->oldy;                           /* Restore position */
         if (o->selected == -1) {                    /* Go to top selection */
@@ -147,27 +218,6 @@ open_close(gui_handle_p h, uint8_t state) {
     return 0;
 }
 
-/* Slide up or slide down widget elements */
-static void
-slide(gui_handle_p h, int16_t dir) {
-    int16_t mPP = nr_entries_pp(h);
-    if (dir < 0) {                                  /* Slide elements up */
-        if ((o->visiblestartindex + dir) < 0) {
-            o->visiblestartindex = 0;
-        } else {
-            o->visiblestartindex += dir;
-        }
-        guii_widget_invalidate(h);
-    } else if (dir > 0) {
-        if ((o->visiblestartindex + dir) > (o->count - mPP - 1)) {  /* Slide elements down */
-            o->visiblestartindex = o->count - mPP;
-        } else {
-            o->visiblestartindex += dir;
-        }
-        guii_widget_invalidate(h);
-    }
-}
-
 /* Set selection for widget */
 static void
 set_selection(gui_handle_p h, int16_t selected) {
@@ -180,24 +230,38 @@ set_selection(gui_handle_p h, int16_t selected) {
 /* Get item from listbox entry */
 static gui_dropdown_item_t*
 get_item(gui_handle_p h, uint16_t index) {
-    uint16_t i = 0;
-    gui_dropdown_item_t* item = 0;
-    
     if (index >= o->count) {                        /* Check if valid index */
         return 0;
     }
+    return &o->items[index];                        /* Entries are stored in contiguous array */
+}
+
+/* Make sure array can hold at least "count" entries, grow geometrically otherwise */
+static uint8_t
+reserve_items(gui_handle_p h, size_t count) {
+    gui_dropdown_item_t* items;
+    size_t capacity;
     
-    if (index == 0) {                               /* Check for first element */
-        return (gui_dropdown_item_t *)gui_linkedlist_getnext_gen(&o->root, NULL);   /* Return first element */
-    } else if (index == o->count - 1) {
-        return (gui_dropdown_item_t *)gui_linkedlist_getprev_gen(&o->root, NULL);   /* Return last element */
+    if (count <= (size_t)o->capacity) {             /* Enough memory already */
+        return 1;
     }
-    
-    item = (gui_dropdown_item_t *)gui_linkedlist_getnext_gen(&o->root, NULL);
-    while (i++ < index) {
-        item = (gui_dropdown_item_t *)gui_linkedlist_getnext_gen(NULL, &item->list);
+    if (count > INT16_MAX) {                        /* Index is stored as signed 16-bit value */
+        return 0;
+    }
+    capacity = o->capacity ? o->capacity : 4;       /* Start with small array */
+    while (capacity < count) {
+        capacity <<= 1;                             /* Double the size each time */
+    }
+    if (capacity > INT16_MAX) {
+        capacity = INT16_MAX;
+    }
+    items = GUI_MEMREALLOC(o->items, capacity * sizeof(*items));
+    if (items == NULL) {
+        return 0;
     }
-    return item;
+    o->items = items;
+    o->capacity = (int16_t)capacity;
+    return 1;
 }
 
 /**
@@ -225,6 +289,9 @@ check_values(gui_handle_p h) {
             }
         }
     }
+    if (o->visiblestartindex >= o->count - mPP) {
+        o->visibleoffset = 0;                       /* No partial entry at the end of range */
+    }
     
     if (o->flags & GUI_FLAG_DROPDOWN_SLIDER_AUTO) { /* Check slider mode */
         if (o->count > mPP) {
@@ -262,7 +329,7 @@ delete_item(gui_handle_p h, uint16_t index) {
     
     item = get_item(h, index);                      /* Get list item from handle */
     if (item) {
-        gui_linkedlist_remove_gen(&__GD(h)->root, &item->list);
+        memmove(item, item + 1, (o->count - index - 1) * sizeof(*item));    /* Close the gap */
         __GD(h)->count--;                           /* Decrease count */
         
         if (o->selected == index) {
@@ -297,9 +364,9 @@ process_click(gui_handle_p h, guii_touch_data_t* ts) {
         uint16_t tmpselected;
         
         if (is_dir_up(h)) {
-            tmpselected = ts->y_rel[0] / item_height(h, NULL);  /* Get temporary selected index */
+            tmpselected = (ts->y_rel[0] + o->visibleoffset) / item_height(h, NULL); /* Get temporary selected index */
         } else {
-            tmpselected = (ts->y_rel[0] - height1) / item_height(h, NULL);  /* Get temporary selected index */
+            tmpselected = (ts->y_rel[0] - height1 + o->visibleoffset) / item_height(h, NULL);   /* Get temporary selected index */
         }
         if ((o->visiblestartindex + tmpselected) < o->count) {
             set_selection(h, o->visiblestartindex + tmpselected);
@@ -320,10 +387,6 @@ process_click(gui_handle_p h, guii_touch_data_t* ts) {
  */
 static uint8_t
 gui_dropdown_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result) {
-#if GUI_CFG_USE_TOUCH
-    static gui_dim_t ty;
-#endif /* GUI_CFG_USE_TOUCH */
-    
     switch (ctrl) {                                 /* Handle control function if required */
         case GUI_WC_PreInit: {
             __GD(h)->selected = -1;                 /* Invalidate selection */
@@ -358,15 +421,11 @@ gui_dropdown_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             }
                 
             if (__GD(h)->selected >= 0 && h->font != NULL) {
-                int16_t i;
                 gui_draw_font_t f;
                 gui_dropdown_item_t* item;
                 gui_draw_font_init(&f);             /* Init structure */
                 
-                item = (gui_dropdown_item_t *)gui_linkedlist_getnext_gen(&__GD(h)->root, NULL);
-                for (i = 0; i < __GD(h)->selected; i++) {
-                    item = (gui_dropdown_item_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)item);
-                }
+                item = &__GD(h)->items[__GD(h)->selected];  /* Get selected item */
                 
                 f.x = x + 3;
                 f.y = y1 + 3;
@@ -399,20 +458,19 @@ gui_dropdown_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                 width--;                            /* Go down for one for alignment on non-slider */
             }
             
-            if (is_opened(h) && h->font != NULL && gui_linkedlist_hasentries(&__GD(h)->root)) {
+            if (is_opened(h) && h->font != NULL && __GD(h)->count > 0) {
                 gui_draw_font_t f;
-                gui_dropdown_item_t* item;
                 uint16_t yOffset;
                 uint16_t itemheight;                /* Get item height */
-                uint16_t index = 0;                 /* Start index */
-                gui_dim_t tmp;
+                int16_t index;
+                gui_dim_t tmp, tmp1;
                 
                 itemheight = item_height(h, &yOffset); /* Get item height and Y offset */
                 
                 gui_draw_font_init(&f);             /* Init structure */
                 
                 f.x = x + 4;
-                f.y = y + 2;
+                f.y = y + 2 - o->visibleoffset;     /* First entry may be partially scrolled out */
                 f.width = width - 6;
                 f.height = itemheight;
                 f.align = GUI_HALIGN_LEFT | GUI_VALIGN_CENTER;
@@ -422,54 +480,55 @@ gui_dropdown_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                 if (disp->y2 > (y + height)) {      /* Set cut-off Y position for drawing operations */
                     disp->y2 = y + height;
                 }
+                tmp1 = disp->y1;
+                if (disp->y1 < (y + 2)) {
+                    disp->y1 = y + 2;
+                }
                 
                 /* Try to process all strings */
-                for (index = 0, item = (gui_dropdown_item_t *)gui_linkedlist_getnext_gen(&o->root, NULL); item != NULL && f.y <= disp->y2;
-                        item = (gui_dropdown_item_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)item), index++) {
-                    if (index < o->visiblestartindex) { /* Check for start visible */
-                        continue;
-                    }
+                for (index = o->visiblestartindex; index < o->count && f.y <= disp->y2; index++) {
                     if (index == __GD(h)->selected) {
                         gui_draw_filledrectangle(disp, x + 2, f.y, width - 3, GUI_MIN(f.height, itemheight), guii_widget_isfocused(h) ? guii_widget_getcolor(h, GUI_DROPDOWN_COLOR_SEL_FOC_BG) : guii_widget_getcolor(h, GUI_DROPDOWN_COLOR_SEL_NOFOC_BG));
                         f.color1 = guii_widget_isfocused(h) ? guii_widget_getcolor(h, GUI_DROPDOWN_COLOR_SEL_FOC) : guii_widget_getcolor(h, GUI_DROPDOWN_COLOR_SEL_NOFOC);
                     } else {
                         f.color1 = guii_widget_getcolor(h, GUI_DROPDOWN_COLOR_TEXT);
                     }
-                    gui_draw_writetext(disp, guii_widget_getfont(h), item->text, &f);
+                    gui_draw_writetext(disp, guii_widget_getfont(h), o->items[index].text, &f);
                     f.y += itemheight;
                 }
                 disp->y2 = tmp;                     /* Set temporary value back */
+                disp->y1 = tmp1;
             }
             return 1;
         }
         case GUI_WC_Remove: {
-            gui_dropdown_item_t* item;
-            while ((item = (gui_dropdown_item_t *)gui_linkedlist_remove_gen(&o->root, (gui_linkedlist_t *)gui_linkedlist_getnext_gen(&o->root, NULL))) != NULL) {
-                GUI_MEMFREE(item);                  /* Free memory */
+            if (o->items != NULL) {
+                GUI_MEMFREE(o->items);              /* Free array of entries */
             }
+            o->count = o->capacity = 0;
             return 1;
         }
 #if GUI_CFG_USE_TOUCH
         case GUI_WC_TouchStart: {
-            guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
-            ty = ts->y_rel[0];                       /* Save relative Y position */
-            
+            guii_anim_stop(h, anim_exec);           /* Touch stops kinetic scroll */
             GUI_WIDGET_RESULTTYPE_TOUCH(result) = touchHANDLED;
             return 1;
         }
         case GUI_WC_TouchMove: {
             guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
-            if (h->font != NULL) {
-                gui_dim_t height = item_height(h, NULL);   /* Get element height */
-                gui_dim_t diff = ty - ts->y_rel[0];
-                
-                if (GUI_ABS(diff) > height) {
-                    slide(h, diff > 0 ? 1 : -1);    /* Slide widget */
-                    ty = ts->y_rel[0];               /* Save pointer */
-                }
+            if (h->font != NULL && is_opened(h)) {
+                set_scroll(h, get_scroll(h) + ts->y_rel_old[0] - ts->y_rel[0]);   /* Entries follow finger */
+            }
+            return 1;
+        }
+#if GUI_CFG_TOUCH_HISTORY_SIZE
+        case GUI_WC_TouchEnd: {
+            if (h->font != NULL && is_opened(h)) {
+                guii_anim_fling(h, anim_exec, get_scroll(h), get_maxscroll(h), GUI_WIDGET_PARAMTYPE_TOUCH(param));
             }
             return 1;
         }
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE */
 #endif /* GUI_CFG_USE_TOUCH */
         case GUI_WC_Click: {
             guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
@@ -547,25 +606,20 @@ gui_dropdown_setcolor(gui_handle_p h, gui_dropdown_color_t index, gui_color_t co
  */
 uint8_t
 gui_dropdown_addstring(gui_handle_p h, const gui_char* text) {
-    gui_dropdown_item_t* item;
     uint8_t ret = 0;
     
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
     
-    item = GUI_MEMALLOC(sizeof(*item));             /* Allocate memory for entry */
-    if (item != NULL) {
-        __GUI_ENTER();                              /* Enter GUI */
-        item->text = (gui_char *)text;              /* Add text to entry */
-        gui_linkedlist_add_gen(&__GD(h)->root, &item->list);/* Add to linked list */
-        __GD(h)->count++;                           /* Increase number of strings */
+    if (reserve_items(h, (size_t)__GD(h)->count + 1)) { /* Make room for new entry */
+        __GD(h)->items[__GD(h)->count++].text = (gui_char *)text;   /* Add text to entry */
         
         check_values(h);                            /* Check values */
         guii_widget_invalidate(h);                 /* Invalidate widget */
-         
         ret = 1;
-        __GUI_LEAVE();                              /* Leave GUI */
     }
     
+    __GUI_LEAVE();                                  /* Leave GUI */
     return ret;
 }
 
@@ -748,8 +802,10 @@ gui_dropdown_scroll(gui_handle_p h, int16_t step) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
+    guii_anim_stop(h, NULL);                        /* Stop kinetic scroll */
     start = __GD(h)->visiblestartindex;
     __GD(h)->visiblestartindex += step;
+    __GD(h)->visibleoffset = 0;
         
     check_values(h);                                /* Check widget values */
     
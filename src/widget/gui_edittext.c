@@ -62,10 +62,13 @@ static const
 gui_widget_t widget = {
     .name = _GT("EDITTEXT"),                        /*!< Widget name */
     .size = sizeof(GUI_EDITTEXT_t),                 /*!< Size of widget for memory allocation */
-    .flags = 0,                                     /*!< List of widget flags */
+    .flags = GUI_FLAG_WIDGET_OPAQUE,                /*!< List of widget flags */
     .callback = gui_edittext_callback,              /*!< Control function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_FocusIn) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_FocusOut) | GUI_WC_MASK(GUI_WC_TouchStart) |
+            GUI_WC_MASK(GUI_WC_KeyPress),
 };
 
 #define e          ((GUI_EDITTEXT_t *)h)
@@ -73,6 +76,43 @@ gui_widget_t widget = {
 /* Check if edit text is multiline */
 #define is_multiline(h)            (__GE(h)->flags & GUI_EDITTEXT_FLAG_MULTILINE)
 
+#if GUI_CFG_USE_KEYBOARD || __DOXYGEN__
+/**
+ * \brief           Invalidate part of widget where text has been edited
+ *
+ *                  When multi-line text is top aligned and fits into widget,
+ *                  lines before edited one keep their position and only area
+ *                  from line before edited one to the bottom is redrawn.
+ *                  Previous line is included as word wrap may move text back to it.
+ *                  In all other cases complete widget is invalidated
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       pos: Cursor position in text before edit, in units of bytes
+ */
+static void
+invalidate_edit(gui_handle_p h, size_t pos) {
+    const gui_draw_text_layout_t* l = h->textlayout;
+    const gui_char* edit;
+    gui_dim_t y, height;
+    size_t i;
+    
+    height = guii_widget_getheight(h);
+    if (!is_multiline(h) || __GE(h)->valign != GUI_EDITTEXT_VALIGN_TOP || l == NULL || l->str != h->text
+        || !l->lines_count || l->rect_height + l->lineheight > height - 10) { /* Text may start to scroll */
+        guii_widget_invalidate(h);
+        return;
+    }
+    
+    edit = &h->text[pos ? pos - 1 : 0];             /* Character before cursor */
+    for (i = l->lines_count - 1; i > 0 && l->lines[i].str > edit; i--) {}
+    if (i) {
+        i--;                                        /* Include previous line */
+    }
+    y = 5 + (gui_dim_t)i * l->lineheight;           /* Top of line, the same as used for drawing */
+    guii_widget_invalidaterect(h, 2, y, guii_widget_getwidth(h) - 4, height - 2 - y);
+}
+#endif /* GUI_CFG_USE_KEYBOARD || __DOXYGEN__ */
+
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -144,6 +184,7 @@ gui_edittext_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                     f.flags |= GUI_FLAG_FONT_MULTILINE; /* Set multiline flag for widget */
                 }
                 
+                f.layout = &h->textlayout;          /* Reuse text layout between redraws */
                 gui_draw_writetext(disp, guii_widget_getfont(h), guii_widget_gettext(h), &f);
             }
             return 1;
@@ -167,7 +208,9 @@ gui_edittext_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
 #if GUI_CFG_USE_KEYBOARD
         case GUI_WC_KeyPress: {
             guii_keyboard_data_t* kb = GUI_WIDGET_PARAMTYPE_KEYBOARD(param);    /* Get keyboard data */
+            size_t pos = guii_widget_getextvalue(h, textcursor, 0);    /* Cursor position before edit */
             if (guii_widget_processtextkey(h, kb)) {
+                invalidate_edit(h, pos);            /* Redraw only edited lines */
                 GUI_WIDGET_RESULTTYPE_KEYBOARD(result) = keyHANDLED;
             }
             return 1;
@@ -221,7 +264,7 @@ gui_edittext_setcolor(gui_handle_p h, gui_edittext_color_t index, gui_color_t co
 uint8_t
 gui_edittext_setmultiline(gui_handle_p h, uint8_t multiline) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MULTILINE, &multiline, 1, 0);   /* Set parameter */
+    return guii_widget_setparam(h, CFG_MULTILINE, &multiline, sizeof(multiline), 1, 0);   /* Set parameter */
 }
 
 /**
@@ -233,7 +276,7 @@ gui_edittext_setmultiline(gui_handle_p h, uint8_t multiline) {
 uint8_t
 gui_edittext_setvalign(gui_handle_p h, gui_edittext_valign_t align) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_VALIGN, &align, 1, 1);  /* Set parameter */
+    return guii_widget_setparam(h, CFG_VALIGN, &align, sizeof(align), 1, 1);  /* Set parameter */
 }
 
 /**
@@ -245,5 +288,5 @@ gui_edittext_setvalign(gui_handle_p h, gui_edittext_valign_t align) {
 uint8_t
 gui_edittext_sethalign(gui_handle_p h, gui_edittext_halign_t align) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_HALIGN, &align, 1, 1);  /* Set parameter */
+    return guii_widget_setparam(h, CFG_HALIGN, &align, sizeof(align), 1, 1);  /* Set parameter */
 }
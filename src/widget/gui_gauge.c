@@ -0,0 +1,571 @@
+/**	
+ * \file            gui_gauge.c
+ * \brief           Gauge widget
+ */
+ 
+/*
+ * Copyright (c) 2017 Tilen Majerle
+ *  
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING 
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen Majerle <tilen@majerle.eu>
+ */
+#define GUI_INTERNAL
+#include "gui/gui_private.h"
+#include "gui/gui_math.h"
+#include "widget/gui_gauge.h"
+
+#define __GA(x)             ((gui_gauge_t *)(x))
+
+#define GUI_GAUGE_FLAG_ANIMATE      0x01            /*!< Animation for needle changes */
+
+#define CFG_VALUE           0x01
+#define CFG_MIN             0x02
+#define CFG_MAX             0x03
+#define CFG_ANGLES          0x04
+#define CFG_TICKS           0x05
+#define CFG_ANIM            0x06
+
+static uint8_t gui_gauge_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
+
+/**
+ * \brief           List of default color in the same order of widget color enumeration
+ */
+static const
+gui_color_t colors[] = {
+    GUI_COLOR_WIN_LIGHTGRAY,                        /*!< Default background color */
+    GUI_COLOR_WHITE,                                /*!< Default dial color */
+    GUI_COLOR_BLACK,                                /*!< Default tick color */
+    GUI_COLOR_WIN_TEXT,                             /*!< Default text color */
+    GUI_COLOR_WIN_RED,                              /*!< Default needle color */
+};
+
+/**
+ * \brief           Widget initialization structure
+ */
+static const
+gui_widget_t widget = {
+    .name = _GT("GAUGE"),                           /*!< Widget name */
+    .size = sizeof(gui_gauge_t),                    /*!< Size of widget for memory allocation */
+    .flags = 0,                                     /*!< List of widget flags */
+    .callback = gui_gauge_callback,                 /*!< Callback function */
+    .colors = colors,                               /*!< List of default colors */
+    .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE,                     /*!< Handled callback commands */
+};
+
+#define a           ((gui_gauge_t *)h)
+#define is_anim(h)  (!!(__GA(h)->flags & GUI_GAUGE_FLAG_ANIMATE))
+
+#define ANIM_DURATION       300                     /*!< Time to animate needle change in units of milliseconds */
+
+/* Multiply length with sine or cosine in Q15 format and round result */
+static gui_dim_t
+gauge_mul(gui_dim_t len, int16_t q) {
+    int32_t v = (int32_t)len * q;
+    return (gui_dim_t)(v >= 0 ? (v + 0x4000) / 0x8000 : -((0x4000 - v) / 0x8000));
+}
+
+/* Get center and radius of dial relative to widget */
+static void
+gauge_center(gui_handle_p h, gui_dim_t* cx, gui_dim_t* cy, gui_dim_t* r) {
+    *cx = guii_widget_getwidth(h) / 2;
+    *cy = guii_widget_getheight(h) / 2;
+    *r = GUI_MIN(guii_widget_getwidth(h), guii_widget_getheight(h)) / 2 - 1;
+}
+
+/* Get angle of value on scale in units of 0.1 degree */
+static int32_t
+gauge_angle(gui_handle_p h, int32_t value) {
+    if (value < a->min) {
+        value = a->min;
+    } else if (value > a->max) {
+        value = a->max;
+    }
+    return (int32_t)a->start_angle * 10 + (int32_t)(((int64_t)(value - a->min) * a->sweep * 10) / (a->max - a->min));
+}
+
+/**
+ * \brief           Calculate needle outline for value
+ * \param[in]       h: Widget handle
+ * \param[in]       value: Value needle points to
+ * \param[out]      pts: Array of 4 points of needle relative to widget
+ * \param[out]      hub: Radius of hub in the middle of dial
+ */
+static void
+gauge_needle(gui_handle_p h, int32_t value, gui_draw_poly_t* pts, gui_dim_t* hub) {
+    gui_dim_t cx, cy, r, len, tail, w;
+    int32_t angle;
+    int16_t s, c;
+    
+    gauge_center(h, &cx, &cy, &r);
+    angle = gauge_angle(h, value);
+    s = gui_math_sin(angle);                        /* Direction of needle is (sin, -cos) on screen */
+    c = gui_math_cos(angle);
+    len = r - r / 8 - 2;                            /* Tip ends below ticks */
+    tail = r / 8;
+    w = GUI_MAX(2, r / 24);                         /* Half width of needle base */
+    
+    pts[0].x = cx + gauge_mul(len, s);              /* Tip */
+    pts[0].y = cy - gauge_mul(len, c);
+    pts[1].x = cx + gauge_mul(w, c);                /* Side of base */
+    pts[1].y = cy + gauge_mul(w, s);
+    pts[2].x = cx - gauge_mul(tail, s);             /* End of tail */
+    pts[2].y = cy + gauge_mul(tail, c);
+    pts[3].x = cx - gauge_mul(w, c);                /* Other side of base */
+    pts[3].y = cy - gauge_mul(w, s);
+    *hub = w + 1;
+}
+
+/* Invalidate rectangle covered by needle for value */
+static void
+invalidate_needle(gui_handle_p h, int32_t value) {
+    gui_draw_poly_t pts[4];
+    gui_dim_t cx, cy, r, hub, x1, y1, x2, y2;
+    size_t i;
+    
+    gauge_center(h, &cx, &cy, &r);
+    gauge_needle(h, value, pts, &hub);
+    x1 = cx - hub;
+    y1 = cy - hub;
+    x2 = cx + hub;
+    y2 = cy + hub;
+    for (i = 0; i < GUI_COUNT_OF(pts); i++) {
+        x1 = GUI_MIN(x1, pts[i].x);
+        y1 = GUI_MIN(y1, pts[i].y);
+        x2 = GUI_MAX(x2, pts[i].x);
+        y2 = GUI_MAX(y2, pts[i].y);
+    }
+    guii_widget_invalidaterect(h, x1 - 1, y1 - 1, x2 - x1 + 3, y2 - y1 + 3);
+}
+
+/* Redraw only areas of old and new needle position */
+static void
+invalidate_value(gui_handle_p h, int32_t old) {
+    if (gauge_angle(h, old) != gauge_angle(h, a->currentvalue)) {
+        invalidate_needle(h, old);
+        invalidate_needle(h, a->currentvalue);
+    }
+}
+
+/* Animation callback to set currently displayed value */
+static void
+anim_exec(gui_handle_p h, int32_t value) {
+    int32_t old = a->currentvalue;
+    a->currentvalue = value;
+    invalidate_value(h, old);                       /* Invalidate changed part */
+}
+
+/* Set value for widget */
+static uint8_t
+set_value(gui_handle_p h, int32_t val) {
+    int32_t old = a->currentvalue;
+    if (a->desiredvalue != val && val >= a->min && val <= a->max) { /* Value has changed */
+        a->desiredvalue = val;                      /* Set value */
+        if (is_anim(h)) {                           /* Animate from currently displayed value */
+            guii_anim_start(h, anim_exec, a->currentvalue, a->desiredvalue, ANIM_DURATION, GUI_ANIM_EASE_OUT);
+        } else {
+            a->currentvalue = a->desiredvalue;      /* Set values to the same */
+        }
+        invalidate_value(h, old);                   /* Redraw changed part, animation redraws the rest */
+        guii_widget_callback(h, GUI_WC_ValueChanged, NULL, NULL);  /* Process callback */
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Draw dial face with ticks and labels
+ * \param[in]       h: Widget handle
+ * \param[in]       disp: Clipping region
+ * \param[in]       x: Screen X position of widget
+ * \param[in]       y: Screen Y position of widget
+ */
+static void
+gauge_draw_dial(gui_handle_p h, const gui_display_t* disp, gui_dim_t x, gui_dim_t y) {
+    const gui_font_t* font = guii_widget_getfont(h);
+    gui_dim_t cx, cy, r, ro, ri;
+    int32_t angle, divisions, i, minor;
+    int16_t s, c;
+    
+    gauge_center(h, &cx, &cy, &r);
+    cx += x;
+    cy += y;
+    gui_draw_filledrectangle(disp, x, y, guii_widget_getwidth(h), guii_widget_getheight(h), guii_widget_getcolor(h, GUI_GAUGE_COLOR_BG));
+    gui_draw_filledcircle(disp, cx, cy, r, guii_widget_getcolor(h, GUI_GAUGE_COLOR_DIAL));
+    gui_draw_circle(disp, cx, cy, r, guii_widget_getcolor(h, GUI_GAUGE_COLOR_TICK));
+    
+    minor = GUI_MAX(a->minor, 1);
+    divisions = (int32_t)a->ticks * minor;
+    ro = r - 2;                                     /* Ticks start at dial border */
+    for (i = 0; i <= divisions && divisions; i++) {
+        angle = (int32_t)a->start_angle * 10 + (int32_t)a->sweep * 10 * i / divisions;
+        s = gui_math_sin(angle);
+        c = gui_math_cos(angle);
+        ri = ro - (i % minor ? r / 16 : r / 8);     /* Labeled ticks are longer */
+        gui_draw_line(disp, cx + gauge_mul(ro, s), cy - gauge_mul(ro, c),
+            cx + gauge_mul(ri, s), cy - gauge_mul(ri, c), guii_widget_getcolor(h, GUI_GAUGE_COLOR_TICK));
+        
+        if (font != NULL && !(i % minor)) {         /* Label in front of labeled tick */
+            gui_draw_font_t f;
+            gui_char buff[12];
+            
+            gui_string_fmt_int(buff, sizeof(buff), a->min + (int32_t)(((int64_t)(a->max - a->min) * (i / minor)) / a->ticks));
+            ri -= font->size;                       /* Middle of label */
+            gui_draw_font_init(&f);
+            f.x = cx + gauge_mul(ri, s) - 2 * font->size;
+            f.y = cy - gauge_mul(ri, c) - font->size / 2;
+            f.width = 4 * font->size;
+            f.height = font->size;
+            f.align = GUI_HALIGN_CENTER | GUI_VALIGN_CENTER;
+            f.color1 = guii_widget_getcolor(h, GUI_GAUGE_COLOR_TEXT);
+            gui_draw_writetext(disp, font, buff, &f);
+        }
+    }
+}
+
+#if GUI_CFG_WIDGET_GAUGE_DIAL_CACHE || __DOXYGEN__
+
+/**
+ * \brief           Calculate key of everything cached dial depends on
+ * \param[in]       h: Widget handle
+ * \return          Hash of size, scale, colors and font
+ */
+static uint32_t
+gauge_dial_key(gui_handle_p h) {
+    uint32_t hash = 0x811C9DC5;
+    gui_dim_t dim;
+    gui_color_t color;
+    const gui_font_t* font;
+    uint8_t i;
+    
+    dim = guii_widget_getwidth(h);
+    hash = guii_widget_hash(hash, &dim, sizeof(dim));
+    dim = guii_widget_getheight(h);
+    hash = guii_widget_hash(hash, &dim, sizeof(dim));
+    hash = guii_widget_hash(hash, &a->min, sizeof(a->min));
+    hash = guii_widget_hash(hash, &a->max, sizeof(a->max));
+    hash = guii_widget_hash(hash, &a->start_angle, sizeof(a->start_angle));
+    hash = guii_widget_hash(hash, &a->sweep, sizeof(a->sweep));
+    hash = guii_widget_hash(hash, &a->ticks, sizeof(a->ticks));
+    hash = guii_widget_hash(hash, &a->minor, sizeof(a->minor));
+    for (i = 0; i < GUI_GAUGE_COLOR_NEEDLE; i++) {  /* Needle is not part of dial */
+        color = guii_widget_getcolor(h, i);
+        hash = guii_widget_hash(hash, &color, sizeof(color));
+    }
+    font = guii_widget_getfont(h);
+    hash = guii_widget_hash(hash, &font, sizeof(font));
+    return hash;
+}
+
+#endif /* GUI_CFG_WIDGET_GAUGE_DIAL_CACHE || __DOXYGEN__ */
+
+/**
+ * \brief           Default widget callback function
+ * \param[in]       h: Widget handle
+ * \param[in]       ctr: Callback type
+ * \param[in]       param: Input parameters for callback type
+ * \param[out]      result: Result for callback type
+ * \return          1 if command processed, 0 otherwise
+ */
+static uint8_t
+gui_gauge_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check parameters */
+    switch (ctrl) {                                 /* Handle control function if required */
+        case GUI_WC_PreInit: {
+            a->min = a->currentvalue = a->desiredvalue = 0;
+            a->max = 100;
+            a->start_angle = -135;                  /* Scale from bottom left to bottom right */
+            a->sweep = 270;
+            a->ticks = 10;
+            a->minor = 5;
+            return 1;
+        }
+        case GUI_WC_SetParam: {                     /* Set parameter for widget */
+            gui_widget_param* v = GUI_WIDGET_PARAMTYPE_WIDGETPARAM(param);
+            int32_t tmp;
+            switch (v->type) {
+                case CFG_VALUE:                     /* Set current value */
+                    set_value(h, *(int32_t *)v->data);
+                    break;
+                case CFG_MAX:                       /* Set maximal value */
+                    tmp = *(int32_t *)v->data;
+                    if (tmp > a->min) {
+                        a->max = tmp;
+                        if (a->desiredvalue > a->max || a->currentvalue > a->max) {
+                            set_value(h, tmp);
+                        }
+                    }
+                    break;
+                case CFG_MIN:                       /* Set minimal value */
+                    tmp = *(int32_t *)v->data;
+                    if (tmp < a->max) {
+                        a->min = tmp;
+                        if (a->desiredvalue < a->min || a->currentvalue < a->min) {
+                            set_value(h, tmp);
+                        }
+                    }
+                    break;
+                case CFG_ANGLES: {                  /* Set scale angles */
+                    const int16_t* angles = (const int16_t *)v->data;
+                    if (angles[1] > 0 && angles[1] <= 360) {
+                        a->start_angle = angles[0];
+                        a->sweep = angles[1];
+                    }
+                    break;
+                }
+                case CFG_TICKS: {                   /* Set number of scale divisions */
+                    const uint8_t* ticks = (const uint8_t *)v->data;
+                    a->ticks = ticks[0];
+                    a->minor = ticks[1];
+                    break;
+                }
+                case CFG_ANIM:
+                    if (*(uint8_t *)v->data) {
+                        __GA(h)->flags |= GUI_GAUGE_FLAG_ANIMATE;   /* Enable animations */
+                    } else {
+                        __GA(h)->flags &= ~GUI_GAUGE_FLAG_ANIMATE;  /* Disable animation */
+                        if (guii_anim_stop(h, anim_exec)) { /* Stop running animation */
+                            anim_exec(h, a->desiredvalue);  /* Show final value */
+                        }
+                    }
+                    break;
+                default: break;
+            }
+            GUI_WIDGET_RESULTTYPE_U8(result) = 1;   /* Save result */
+            return 1;
+        }
+        case GUI_WC_Draw: {
+            gui_draw_poly_t pts[4];
+            gui_dim_t x, y, cx, cy, r, hub;
+#if GUI_CFG_WIDGET_GAUGE_DIAL_CACHE
+            uint32_t key;
+#endif /* GUI_CFG_WIDGET_GAUGE_DIAL_CACHE */
+            size_t i;
+            gui_display_t* disp = GUI_WIDGET_PARAMTYPE_DISP(param);
+    
+            x = guii_widget_getabsolutex(h);        /* Get absolute position on screen */
+            y = guii_widget_getabsolutey(h);        /* Get absolute position on screen */
+            
+#if GUI_CFG_WIDGET_GAUGE_DIAL_CACHE
+            key = gauge_dial_key(h);
+            if (!guii_widget_drawbitmap(h, &a->dial, key, disp))    /* Dial is copied from cache when possible */
+#endif /* GUI_CFG_WIDGET_GAUGE_DIAL_CACHE */
+            {
+                gauge_draw_dial(h, disp, x, y);
+#if GUI_CFG_WIDGET_GAUGE_DIAL_CACHE
+                if ((guii_widget_getcolor(h, GUI_GAUGE_COLOR_BG) >> 24) == 0xFF) {
+                    guii_widget_savebitmap(h, &a->dial, key, GUI_MEM_TAG_GAUGE_DIAL, disp); /* Keep pixels for next redraws */
+                }
+#endif /* GUI_CFG_WIDGET_GAUGE_DIAL_CACHE */
+            }
+            
+            /* Needle is filled with scanlines */
+            gauge_center(h, &cx, &cy, &r);
+            gauge_needle(h, a->currentvalue, pts, &hub);
+            for (i = 0; i < GUI_COUNT_OF(pts); i++) {
+                pts[i].x += x;
+                pts[i].y += y;
+            }
+            gui_draw_filledpoly(disp, pts, GUI_COUNT_OF(pts), guii_widget_getcolor(h, GUI_GAUGE_COLOR_NEEDLE));
+            gui_draw_filledcircle(disp, x + cx, y + cy, hub, guii_widget_getcolor(h, GUI_GAUGE_COLOR_NEEDLE));
+            return 1;
+        }
+#if GUI_CFG_WIDGET_GAUGE_DIAL_CACHE
+        case GUI_WC_Remove: {                       /* When widget is about to be removed */
+            guii_widget_freebitmap(&a->dial);
+            return 1;
+        }
+#endif /* GUI_CFG_WIDGET_GAUGE_DIAL_CACHE */
+        default:                                    /* Handle default option */
+            GUI_UNUSED3(h, param, result);          /* Unused elements to prevent compiler warnings */
+            return 0;                               /* Command was not processed */
+    }
+}
+
+/**
+ * \brief           Create new gauge widget
+ * \param[in]       id: Widget unique ID to use for identity for callback processing
+ * \param[in]       x: Widget X position relative to parent widget
+ * \param[in]       y: Widget Y position relative to parent widget
+ * \param[in]       width: Widget width in units of pixels
+ * \param[in]       height: Widget height in uints of pixels
+ * \param[in]       parent: Parent widget handle. Set to NULL to use current active parent widget
+ * \param[in]       cb: Pointer to \ref gui_widget_callback_t callback function. Set to NULL to use default widget callback
+ * \param[in]       flags: flags for create procedure
+ * \return          \ref gui_handle_p object of created widget on success, NULL otherwise
+ */
+gui_handle_p
+gui_gauge_create(gui_id_t id, float x, float y, float width, float height, gui_handle_p parent, gui_widget_callback_t cb, uint16_t flags) {
+    return (gui_handle_p)guii_widget_create(&widget, id, x, y, width, height, parent, cb, flags);  /* Allocate memory for basic widget */
+}
+
+/**
+ * \brief           Set color to specific part of widget
+ * \param[in,out]   h: Widget handle
+ * \param[in]       index: Color index. This parameter can be a value of \ref gui_gauge_color_t enumeration
+ * \param[in]       color: Color value
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_gauge_setcolor(gui_handle_p h, gui_gauge_color_t index, gui_color_t color) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    return guii_widget_setcolor(h, (uint8_t)index, color); /* Set color */
+}
+
+/**
+ * \brief           Set gauge current value
+ * \param[in,out]   h: Widget handle
+ * \param[in]       val: New current value
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_gauge_setmin, gui_gauge_setmax, gui_gauge_getvalue
+ */
+uint8_t
+gui_gauge_setvalue(gui_handle_p h, int32_t val) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    return guii_widget_setparam(h, CFG_VALUE, &val, sizeof(val), 0, 0); /* Set parameter, needle area is invalidated by widget */
+}
+
+/**
+ * \brief           Set value at start of gauge scale
+ * \param[in,out]   h: Widget handle
+ * \param[in]       val: New minimal value
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_gauge_setvalue, gui_gauge_setmax, gui_gauge_getmin
+ */
+uint8_t
+gui_gauge_setmin(gui_handle_p h, int32_t val) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    return guii_widget_setparam(h, CFG_MIN, &val, sizeof(val), 1, 0);   /* Set parameter */
+}
+
+/**
+ * \brief           Set value at end of gauge scale
+ * \param[in,out]   h: Widget handle
+ * \param[in]       val: New maximal value
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_gauge_setvalue, gui_gauge_setmin, gui_gauge_getmax
+ */
+uint8_t
+gui_gauge_setmax(gui_handle_p h, int32_t val) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    return guii_widget_setparam(h, CFG_MAX, &val, sizeof(val), 1, 0);   /* Set parameter */
+}
+
+/**
+ * \brief           Set position of gauge scale on dial
+ * \param[in,out]   h: Widget handle
+ * \param[in]       start: Angle of scale start in units of degrees, clockwise from top of dial
+ * \param[in]       sweep: Angle between scale start and end in units of degrees, between `1` and `360`
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_gauge_setangles(gui_handle_p h, int16_t start, int16_t sweep) {
+    int16_t angles[2];
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && sweep > 0 && sweep <= 360);  /* Check input parameters */
+    angles[0] = start;
+    angles[1] = sweep;
+    return guii_widget_setparam(h, CFG_ANGLES, angles, sizeof(angles), 1, 0);   /* Set parameter */
+}
+
+/**
+ * \brief           Set number of divisions of gauge scale
+ * \param[in,out]   h: Widget handle
+ * \param[in]       ticks: Number of labeled divisions, set to `0` to disable ticks
+ * \param[in]       minor: Number of minor divisions between labeled ticks, `0` or `1` for none
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_gauge_setticks(gui_handle_p h, uint8_t ticks, uint8_t minor) {
+    uint8_t v[2];
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    v[0] = ticks;
+    v[1] = minor;
+    return guii_widget_setparam(h, CFG_TICKS, v, sizeof(v), 1, 0);  /* Set parameter */
+}
+
+/**
+ * \brief           Set gauge to animation mode
+ * \param[in,out]   h: Widget handle
+ * \param[in]       anim: New animation value either 1 (enable) or 0 (disable)
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_gauge_setanimation(gui_handle_p h, uint8_t anim) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    return guii_widget_setparam(h, CFG_ANIM, &anim, sizeof(anim), 0, 0); /* Set parameter */
+}
+
+/**
+ * \brief           Get value at start of gauge scale
+ * \param[in,out]   h: Widget handle
+ * \return          Minimal value
+ * \sa              gui_gauge_setmin, gui_gauge_getmax, gui_gauge_getvalue
+ */
+int32_t
+gui_gauge_getmin(gui_handle_p h) {
+    int32_t val;
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+
+    val = __GA(h)->min;                             /* Get minimal value */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return val;
+}
+
+/**
+ * \brief           Get value at end of gauge scale
+ * \param[in,out]   h: Widget handle
+ * \return          Maximal value
+ * \sa              gui_gauge_setmax, gui_gauge_getmin, gui_gauge_getvalue
+ */
+int32_t
+gui_gauge_getmax(gui_handle_p h) {
+    int32_t val;
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+
+    val = __GA(h)->max;                             /* Get maximal value */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return val;
+}
+
+/**
+ * \brief           Get gauge current value
+ * \param[in,out]   h: Widget handle
+ * \return          Current value
+ * \sa              gui_gauge_setvalue, gui_gauge_getmin, gui_gauge_getmax
+ */
+int32_t
+gui_gauge_getvalue(gui_handle_p h) {
+    int32_t val;
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+
+    val = __GA(h)->desiredvalue;                    /* Get current value */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return val;
+}
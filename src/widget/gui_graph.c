@@ -40,6 +40,7 @@
 #define CFG_MIN_Y           0x03
 #define CFG_MAX_Y           0x04
 #define CFG_ZOOM_RESET      0x05
+#define CFG_STRIP           0x06
 
 static uint8_t gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
 
@@ -65,6 +66,9 @@ gui_widget_t widget = {
     .callback = gui_graph_callback,                 /*!< Callback function for various events */
     .colors = colors,                               /*<! List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_TouchStart) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_TouchMove) | GUI_WC_MASK(GUI_WC_TouchEnd) |
+            GUI_WC_MASK(GUI_WC_DblClick) | GUI_WC_MASK(GUI_WC_Pinch),
 };
 
 #define g       ((gui_graph_t *)(h))
@@ -76,6 +80,7 @@ graph_reset(gui_handle_p h) {
     g->visible_min_x = g->min_x;
     g->visible_max_y = g->max_y;
     g->visible_min_y = g->min_y;
+    g->scale_valid = 0;                             /* Visible range changed */
 }
 
 /**
@@ -94,8 +99,191 @@ graph_zoom(gui_handle_p h, float zoom, float xpos, float ypos) {
 
     g->visible_min_y += (g->visible_max_y - g->visible_min_y) * (zoom - 1.0f) * ypos;
     g->visible_max_y -= (g->visible_max_y - g->visible_min_y) * (zoom - 1.0f) * (1.0f - ypos);
+    g->scale_valid = 0;                             /* Visible range changed */
 }
 
+/**
+ * \brief           Calculate fixed-point scale factors for visible range
+ * \note            Factors are calculated only when visible range or plot size changes
+ * \param[in]       h: Widget handle
+ * \param[in]       pw: Plot area width
+ * \param[in]       ph: Plot area height
+ */
+static void
+graph_update_scale(gui_handle_p h, gui_dim_t pw, gui_dim_t ph) {
+    float sx, sy;
+    
+    if (g->scale_valid && g->scale_width == pw && g->scale_height == ph) {
+        return;
+    }
+    sx = (float)pw * 65536.0f / (g->visible_max_x - g->visible_min_x);
+    sy = (float)ph * 65536.0f / (g->visible_max_y - g->visible_min_y);
+    g->scale_x = (int32_t)sx;
+    g->scale_y = (int32_t)sy;
+    g->offset_x = -(int64_t)(g->visible_min_x * sx);
+    g->offset_y = -(int64_t)(g->visible_min_y * sy);
+    g->scale_width = pw;
+    g->scale_height = ph;
+    g->scale_valid = 1;
+}
+
+/**
+ * \brief           Get screen X offset of value from plot left position
+ * \param[in]       v: Value to transform, X value or sample index for YT plot
+ */
+#define graph_getx(h, v)            ((gui_dim_t)(((int64_t)(v) * g->scale_x + g->offset_x) >> 16))
+
+/**
+ * \brief           Get screen Y offset of value from plot bottom position
+ * \param[in]       v: Y value to transform
+ */
+#define graph_gety(h, v)            ((gui_dim_t)(((int64_t)(v) * g->scale_y + g->offset_y) >> 16))
+
+/**
+ * \brief           Draw YT plot with single vertical line per pixel column
+ * \note            Only samples inside clipping area are processed,
+ *                  number of drawing operations is limited by plot width
+ * \param[in]       h: Graph widget handle with valid scale factors
+ * \param[in]       disp: Display clipping area, already limited to plot area
+ * \param[in]       data: YT data to draw
+ * \param[in]       xLeft: Screen X position of plot area
+ * \param[in]       yBottom: Screen Y position of minimal visible value
+ */
+static void
+graph_draw_minmax(gui_handle_p h, const gui_display_t* disp, gui_graph_data_p data, gui_dim_t xLeft, gui_dim_t yBottom) {
+    int64_t k, kend;
+    int16_t vmin, vmax, v = 0, vlast;
+    gui_dim_t col, c, y1, y2;
+    
+    if (!data->length || g->scale_x <= 0) {
+        return;
+    }
+    k = ((((int64_t)(disp->x1 - xLeft)) << 16) - g->offset_x) / g->scale_x;    /* First visible sample */
+    kend = ((((int64_t)(disp->x2 - xLeft)) << 16) - g->offset_x) / g->scale_x + 1; /* Sample after last visible */
+    if (k < 0) {
+        k = 0;
+    }
+    if (kend > (int64_t)data->length) {
+        kend = data->length;
+    }
+    if (k >= kend) {
+        return;
+    }
+    
+    vlast = vmin = vmax = data->data[(data->ptr + (size_t)k) % data->length];
+    col = xLeft + graph_getx(h, k);
+    for (; k <= kend; k++) {
+        if (k < kend) {
+            v = data->data[(data->ptr + (size_t)k) % data->length];
+            c = xLeft + graph_getx(h, k);           /* Pixel column of sample */
+        } else {
+            c = col + 1;                            /* Flush last column */
+        }
+        if (c != col) {                             /* New column, draw collected span */
+            y1 = yBottom - graph_gety(h, vmax);
+            y2 = yBottom - graph_gety(h, vmin);
+            gui_draw_vline(disp, col, y1, y2 - y1 + 1, data->color);
+            col = c;
+            vmin = vmax = vlast;                    /* Connect with previous column */
+        }
+        if (k < kend) {
+            vmin = GUI_MIN(vmin, v);
+            vmax = GUI_MAX(vmax, v);
+            vlast = v;
+        }
+    }
+}
+
+/**
+ * \brief           Draw vertical grid lines of plot area
+ * \param[in]       h: Widget handle
+ * \param[in]       disp: Clipping region
+ * \param[in]       x: Screen X position of widget
+ * \param[in]       y: Screen Y position of widget
+ */
+static void
+graph_draw_columns(gui_handle_p h, const gui_display_t* disp, gui_dim_t x, gui_dim_t y) {
+    gui_dim_t bt = g->border[GUI_GRAPH_BORDER_TOP], bb = g->border[GUI_GRAPH_BORDER_BOTTOM];
+    gui_dim_t bl = g->border[GUI_GRAPH_BORDER_LEFT], br = g->border[GUI_GRAPH_BORDER_RIGHT];
+    gui_dim_t width = guii_widget_getwidth(h), height = guii_widget_getheight(h);
+    float step, pos;
+    
+    if (!g->columns) {
+        return;
+    }
+    /* Lines move together with plot in strip-chart mode */
+    step = (float)(width - bl - br) / (float)g->columns;
+    for (pos = step - g->strip_offset; pos < (float)(width - bl - br); pos += step) {
+        gui_draw_vline(disp, x + bl + (gui_dim_t)pos, y + bt, height - bt - bb, guii_widget_getcolor(h, GUI_GRAPH_COLOR_GRID));
+    }
+}
+
+/**
+ * \brief           Draw borders, plot area background and grid lines
+ * \note            Vertical grid lines are not drawn in strip-chart mode as they move with plot
+ * \param[in]       h: Widget handle
+ * \param[in]       disp: Clipping region
+ * \param[in]       x: Screen X position of widget
+ * \param[in]       y: Screen Y position of widget
+ */
+static void
+graph_draw_background(gui_handle_p h, const gui_display_t* disp, gui_dim_t x, gui_dim_t y) {
+    gui_dim_t bt = g->border[GUI_GRAPH_BORDER_TOP], bb = g->border[GUI_GRAPH_BORDER_BOTTOM];
+    gui_dim_t bl = g->border[GUI_GRAPH_BORDER_LEFT], br = g->border[GUI_GRAPH_BORDER_RIGHT];
+    gui_dim_t width = guii_widget_getwidth(h), height = guii_widget_getheight(h);
+    uint8_t i;
+    
+    gui_draw_filledrectangle(disp, x, y, bl, height, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BG));
+    gui_draw_filledrectangle(disp, x + bl, y, width - bl - br, bt, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BG));
+    gui_draw_filledrectangle(disp, x + bl, y + height - bb, width - bl - br, bb, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BG));
+    gui_draw_filledrectangle(disp, x + width - br, y, br, height, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BG));
+    gui_draw_filledrectangle(disp, x + bl, y + bt, width - bl - br, height - bt - bb, guii_widget_getcolor(h, GUI_GRAPH_COLOR_FG));
+    gui_draw_rectangle(disp, x, y, width, height, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BORDER));
+    
+    /* Draw horizontal lines */
+    if (g->rows) {
+        float step;
+        step = (float)(height - bt - bb) / (float)g->rows;
+        for (i = 1; i < g->rows; i++) {
+            gui_draw_hline(disp, x + bl, y + bt + i * step, width - bl - br, guii_widget_getcolor(h, GUI_GRAPH_COLOR_GRID));
+        }
+    }
+    if (!g->strip) {
+        graph_draw_columns(h, disp, x, y);
+    }
+}
+
+#if GUI_CFG_WIDGET_GRAPH_BG_CACHE || __DOXYGEN__
+
+/**
+ * \brief           Calculate key of everything cached background depends on
+ * \param[in]       h: Widget handle
+ * \return          Hash of size, borders, grid and colors
+ */
+static uint32_t
+graph_bg_key(gui_handle_p h) {
+    uint32_t hash = 0x811C9DC5;
+    gui_dim_t dim;
+    gui_color_t color;
+    uint8_t i;
+    
+    dim = guii_widget_getwidth(h);
+    hash = guii_widget_hash(hash, &dim, sizeof(dim));
+    dim = guii_widget_getheight(h);
+    hash = guii_widget_hash(hash, &dim, sizeof(dim));
+    hash = guii_widget_hash(hash, g->border, sizeof(g->border));
+    hash = guii_widget_hash(hash, &g->rows, sizeof(g->rows));
+    hash = guii_widget_hash(hash, &g->columns, sizeof(g->columns));
+    hash = guii_widget_hash(hash, &g->strip, sizeof(g->strip));
+    for (i = 0; i < GUI_COUNT_OF(colors); i++) {
+        color = guii_widget_getcolor(h, i);
+        hash = guii_widget_hash(hash, &color, sizeof(color));
+    }
+    return hash;
+}
+
+#endif /* GUI_CFG_WIDGET_GRAPH_BG_CACHE || __DOXYGEN__ */
+
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -134,6 +322,7 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
                 case CFG_MIN_Y: g->min_y = *(float *)p->data; break;/* Set min Y value to widget */
                 case CFG_MAX_Y: g->max_y = *(float *)p->data; break;/* Set max Y value to widget */
                 case CFG_ZOOM_RESET: graph_reset(h); break; /* Reset zoom */
+                case CFG_STRIP: g->strip = *(uint8_t *)p->data ? 1 : 0; g->strip_offset = 0; break;  /* Set strip-chart mode */
                 default: break;
             }
             GUI_WIDGET_RESULTTYPE_U8(result) = 1;   /* Save result */
@@ -143,7 +332,9 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
             gui_graph_data_p data;
             gui_linkedlistmulti_t* link;
             gui_dim_t bt, br, bb, bl, x, y, width, height;
-            uint8_t i;
+#if GUI_CFG_WIDGET_GRAPH_BG_CACHE
+            uint32_t key;
+#endif /* GUI_CFG_WIDGET_GRAPH_BG_CACHE */
             gui_display_t* disp = GUI_WIDGET_PARAMTYPE_DISP(param);   /* Get display pointer */
             
             bt = g->border[GUI_GRAPH_BORDER_TOP];
@@ -156,42 +347,32 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
             width = guii_widget_getwidth(h);       /* Get widget width */
             height = guii_widget_getheight(h);     /* Get widget height */
             
-            gui_draw_filledrectangle(disp, x, y, bl, height, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BG));
-            gui_draw_filledrectangle(disp, x + bl, y, width - bl - br, bt, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BG));
-            gui_draw_filledrectangle(disp, x + bl, y + height - bb, width - bl - br, bb, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BG));
-            gui_draw_filledrectangle(disp, x + width - br, y, br, height, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BG));
-            gui_draw_filledrectangle(disp, x + bl, y + bt, width - bl - br, height - bt - bb, guii_widget_getcolor(h, GUI_GRAPH_COLOR_FG));
-            gui_draw_rectangle(disp, x, y, width, height, guii_widget_getcolor(h, GUI_GRAPH_COLOR_BORDER));
-            
-            /* Draw horizontal lines */
-            if (g->rows) {
-                float step;
-                step = (float)(height - bt - bb) / (float)g->rows;
-                for (i = 1; i < g->rows; i++) {
-                    gui_draw_hline(disp, x + bl, y + bt + i * step, width - bl - br, guii_widget_getcolor(h, GUI_GRAPH_COLOR_GRID));
+#if GUI_CFG_WIDGET_GRAPH_BG_CACHE
+            key = graph_bg_key(h);
+            if (!guii_widget_drawbitmap(h, &g->bg, key, disp))  /* Static part is copied from cache when possible */
+#endif /* GUI_CFG_WIDGET_GRAPH_BG_CACHE */
+            {
+                graph_draw_background(h, disp, x, y);
+#if GUI_CFG_WIDGET_GRAPH_BG_CACHE
+                if ((guii_widget_getcolor(h, GUI_GRAPH_COLOR_BG) >> 24) == 0xFF
+                    && (guii_widget_getcolor(h, GUI_GRAPH_COLOR_FG) >> 24) == 0xFF) {
+                    guii_widget_savebitmap(h, &g->bg, key, GUI_MEM_TAG_GRAPH_BG, disp);  /* Keep pixels for next redraws */
                 }
+#endif /* GUI_CFG_WIDGET_GRAPH_BG_CACHE */
             }
-            /* Draw vertical lines */
-            if (g->columns) {
-                float step;
-                step = (float)(width - bl - br) / (float)g->columns;
-                for (i = 1; i < g->columns; i++) {
-                    gui_draw_vline(disp, x + bl + i * step, y + bt, height - bt - bb, guii_widget_getcolor(h, GUI_GRAPH_COLOR_GRID));
-                }
+            if (g->strip) {                         /* Moving grid lines are never cached */
+                graph_draw_columns(h, disp, x, y);
             }
             
             /* Check if any data attached to this graph */
             if (gui_linkedlist_hasentries(&g->root)) {  /* We have attached plots */
                 gui_display_t display;
-                register float x1, y1, x2, y2;      /* Try to add these variables to core registers */
-                float xSize = g->visible_max_x - g->visible_min_x;  /* Calculate X size */
-                float ySize = g->visible_max_y - g->visible_min_y;  /* Calculate Y size */
-                float xStep = (float)(width - bl - br) / (float)xSize;  /* Calculate X step */
-                float yStep = (float)(height - bt - bb) / (float)ySize; /* calculate Y step */
+                gui_dim_t x1, y1, x2, y2;
                 gui_dim_t yBottom = y + height - bb - 1;    /* Bottom Y value */
                 gui_dim_t xLeft = x + bl;                   /* Left X position */
-                uint32_t read, write;
+                uint32_t read, write, k;
                 
+                graph_update_scale(h, width - bl - br, height - bt - bb);   /* Only integer math is used for points */
                 memcpy(&display, disp, sizeof(gui_display_t));  /* Save GUI display data */
                 
                 /* Set clipping region */
@@ -216,24 +397,26 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
                     read = data->ptr;               /* Get start read pointer */
                     write = data->ptr;              /* Get start write pointer */
                     
-                    if (data->type == GUI_GRAPH_TYPE_YT) {  /* Draw YT plot */
+                    if (data->type == GUI_GRAPH_TYPE_YT && data->minmax && g->scale_x < 0x10000) {  /* More samples per pixel column */
+                        graph_draw_minmax(h, disp, data, xLeft, yBottom);
+                    } else if (data->type == GUI_GRAPH_TYPE_YT) {  /* Draw YT plot */
                         /* Calculate first point */
-                        x1 = xLeft - g->visible_min_x * xStep;  /* Calculate start X */
-                        y1 = yBottom - (data->data[read] - g->visible_min_y) * yStep;   /* Calculate start Y */
+                        x1 = xLeft + graph_getx(h, 0);  /* Calculate start X */
+                        y1 = yBottom - graph_gety(h, data->data[read]); /* Calculate start Y */
                         if (++read == data->length) {   /* Check overflow */
                             read = 0;
                         }
                         
                         /* Outside of right || outside on left */
-                        if (x1 > disp->x2 || (x1 + (data->length * xStep)) < disp->x1) {/* Plot start is on the right of active area */
+                        if (x1 > disp->x2 || xLeft + graph_getx(h, data->length) < disp->x1) {/* Plot start is on the right of active area */
                             continue;
                         }
                         
-                        while (read != write && x1 <= disp->x2) {   /* Calculate next points */
-                            x2 = x1 + xStep;                /* Calculate next X */
-                            y2 = yBottom - ((float)data->data[read] - g->visible_min_y) * yStep;/* Calculate next Y */
+                        for (k = 1; read != write && x1 <= disp->x2; k++) { /* Calculate next points */
+                            x2 = xLeft + graph_getx(h, k);  /* Calculate next X */
+                            y2 = yBottom - graph_gety(h, data->data[read]); /* Calculate next Y */
                             if ((x1 >= disp->x1 || x2 >= disp->x1) && (x1 < disp->x2 || x2 < disp->x2)) {
-                                gui_draw_line(disp, x1, y1, x2, y2, data->color);   /* Draw actual line */
+                                gui_draw_line_aa(disp, x1, y1, x2, y2, data->color);    /* Draw actual line */
                             }
                             x1 = x2, y1 = y2;       /* Copy values as old */
                             
@@ -243,16 +426,16 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
                         }
                     } else if (data->type == GUI_GRAPH_TYPE_XY) {   /* Draw XY plot */                        
                         /* Calculate first point */
-                        x1 = xLeft + ((float)data->data[2 * read + 0] - g->visible_min_x) * xStep;
-                        y1 = yBottom - ((float)data->data[2 * read + 1] - g->visible_min_y) * yStep;
+                        x1 = xLeft + graph_getx(h, data->data[2 * read + 0]);
+                        y1 = yBottom - graph_gety(h, data->data[2 * read + 1]);
                         if (++read == data->length) {   /* Check overflow */
                             read = 0;
                         }
                         
                         while (read != write) {     /* Calculate next points */
-                            x2 = xLeft + ((float)(data->data[2 * read + 0] - g->visible_min_x) * xStep);
-                            y2 = yBottom - ((float)(data->data[2 * read + 1] - g->visible_min_y) * yStep);
-                            gui_draw_line(disp, x1, y1, x2, y2, data->color);   /* Draw actual line */
+                            x2 = xLeft + graph_getx(h, data->data[2 * read + 0]);
+                            y2 = yBottom - graph_gety(h, data->data[2 * read + 1]);
+                            gui_draw_line_aa(disp, x1, y1, x2, y2, data->color);    /* Draw actual line */
                             x1 = x2, y1 = y2;       /* Check overflow */
                             
                             if (++read == data->length) {   /* Check overflow */
@@ -295,7 +478,7 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
                 diff = (float)(y - ty[0]) / step;
                 g->visible_min_y += diff;
                 g->visible_max_y += diff;
-#if GUI_CFG_TOUCH_MAX_PRESSES > 1
+#if GUI_CFG_TOUCH_MAX_PRESSES > 1 && !GUI_CFG_USE_TOUCH_GESTURES
             } else if (ts->ts.count == 2) {         /* Scale widget on multiple widgets */
                 float centerX, centerY, zoom;
                 
@@ -303,7 +486,7 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
                 zoom = ts->distance / ts->distance_old; /* Calculate zoom value */
                 
                 graph_zoom(h, zoom, (float)centerX / (float)guii_widget_getwidth(h), (float)centerY / (float)guii_widget_getheight(h));
-#endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 */
+#endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 && !GUI_CFG_USE_TOUCH_GESTURES */
             }
             
             for (i = 0; i < ts->ts.count; i++) {
@@ -316,14 +499,26 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
         }
         case GUI_WC_TouchEnd:
             return 1;
+#if GUI_CFG_USE_TOUCH_GESTURES
+        case GUI_WC_Pinch: {                        /* Zoom around pinch center */
+            guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
+            
+            graph_zoom(h, ts->gesture.scale,
+                (float)(ts->gesture.x - guii_widget_getabsolutex(h)) / (float)guii_widget_getwidth(h),
+                (float)(ts->gesture.y - guii_widget_getabsolutey(h)) / (float)guii_widget_getheight(h));
+            guii_widget_invalidate(h);
+            return 1;
+        }
+#endif /* GUI_CFG_USE_TOUCH_GESTURES */
 #endif /* GUI_CFG_USE_TOUCH */
         case GUI_WC_DblClick:
             graph_reset(h);                         /* Reset zoom */
             guii_widget_invalidate(h);              /* Invalidate widget */
             return 1;
         
-#if GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE
+#if GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE || GUI_CFG_WIDGET_GRAPH_BG_CACHE
         case GUI_WC_Remove: {                       /* When widget is about to be removed */
+#if GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE
             gui_graph_data_p data;
             gui_linkedlistmulti_t* link;
             
@@ -335,10 +530,14 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
                 data = (gui_graph_data_p)gui_linkedlist_multi_getdata(link);    /* Get data from list */
                 gui_linkedlist_multi_find_remove(&data->root, h);   /* Remove element from linked list with search */
             }
+#endif /* GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE */
+#if GUI_CFG_WIDGET_GRAPH_BG_CACHE
+            guii_widget_freebitmap(&g->bg);
+#endif /* GUI_CFG_WIDGET_GRAPH_BG_CACHE */
             
             return 1;
         }
-#endif /* GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE */
+#endif /* GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE || GUI_CFG_WIDGET_GRAPH_BG_CACHE */
         default:                                    /* Handle default option */
             GUI_UNUSED3(h, param, result);          /* Unused elements to prevent compiler warnings */
             return 0;                               /* Command was not processed */
@@ -348,12 +547,53 @@ gui_graph_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
 
 #if GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE
 
+/**
+ * \brief           Move plot area of strip-chart graph for new sample
+ * \param[in]       h: Graph widget handle
+ * \param[in]       data: Data handle with added samples
+ * \param[in]       count: Number of added samples
+ * \return          `1` when only newest part of graph will be redrawn, `0` otherwise
+ */
+static uint8_t
+graph_strip_scroll(gui_handle_p h, gui_graph_data_p data, size_t count) {
+    gui_graph_t* gr = __GG(h);
+    gui_dim_t bl = gr->border[GUI_GRAPH_BORDER_LEFT], bt = gr->border[GUI_GRAPH_BORDER_TOP];
+    gui_dim_t pw = guii_widget_getwidth(h) - bl - gr->border[GUI_GRAPH_BORDER_RIGHT];
+    gui_dim_t ph = guii_widget_getheight(h) - bt - gr->border[GUI_GRAPH_BORDER_BOTTOM];
+    float xStep;
+    gui_dim_t n;
+    
+    if (!gr->strip || data->type != GUI_GRAPH_TYPE_YT || pw <= 0 || gr->visible_max_x <= gr->visible_min_x) {
+        return 0;
+    }
+    xStep = (float)pw / (gr->visible_max_x - gr->visible_min_x);    /* Pixels per sample */
+    n = (gui_dim_t)(xStep + 0.5f);
+    if (n < 1 || GUI_ABS(xStep - n) > 0.01f || count >= (size_t)(pw / n)) {  /* Pixels can only move for whole number of pixels */
+        return 0;
+    }
+    n *= (gui_dim_t)count;                          /* Number of pixels to move */
+    
+    if (gui_linkedlist_multi_getdata(gui_linkedlist_multi_getnext_gen(&gr->root, NULL)) == data) {
+        /* First attached data defines time and moves all plots */
+        if (gr->columns) {
+            float step = (float)pw / (float)gr->columns;
+            gr->strip_offset += n;
+            while (gr->strip_offset >= step) {
+                gr->strip_offset -= step;
+            }
+        }
+        return guii_widget_scrollx(h, bl, bt, pw, ph, n);
+    }
+    return guii_widget_invalidaterect(h, bl + pw - n, bt, n, ph);   /* Other plots only draw newest part */
+}
+
 /**
  * \brief           Invalidate all graphs where data plot is attached at
  * \param[in]       data: Data handle
+ * \param[in]       added: Number of samples added to data, `0` when data was changed otherwise
  */
 static void
-graph_invalidate(gui_graph_data_p data) {
+graph_invalidate(gui_graph_data_p data, size_t added) {
     gui_handle_p h;
     gui_linkedlistmulti_t* link;
     /*
@@ -367,9 +607,12 @@ graph_invalidate(gui_graph_data_p data) {
         h = (gui_handle_p)gui_linkedlist_multi_getdata(link); /* Get data from linked list object */
         
         /*
-         * Invalidate each object attached to this data graph
+         * Invalidate each object attached to this data graph,
+         * strip-chart graphs redraw only newest part
          */
-        guii_widget_invalidate(h);
+        if (!added || !graph_strip_scroll(h, data, added)) {
+            guii_widget_invalidate(h);
+        }
     }
 }
 #endif /* GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE */
@@ -414,7 +657,7 @@ gui_graph_setcolor(gui_handle_p h, gui_graph_color_t index, gui_color_t color) {
 uint8_t
 gui_graph_setminx(gui_handle_p h, float v) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MIN_X, &v, 1, 0);    /* Set parameter */
+    return guii_widget_setparam(h, CFG_MIN_X, &v, sizeof(v), 1, 0);    /* Set parameter */
 }
 
 /**
@@ -427,7 +670,7 @@ gui_graph_setminx(gui_handle_p h, float v) {
 uint8_t
 gui_graph_setmaxx(gui_handle_p h, float v) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MAX_X, &v, 1, 0);    /* Set parameter */
+    return guii_widget_setparam(h, CFG_MAX_X, &v, sizeof(v), 1, 0);    /* Set parameter */
 }
 
 /**
@@ -440,7 +683,7 @@ gui_graph_setmaxx(gui_handle_p h, float v) {
 uint8_t
 gui_graph_setminy(gui_handle_p h, float v) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MIN_Y, &v, 1, 0);    /* Set parameter */
+    return guii_widget_setparam(h, CFG_MIN_Y, &v, sizeof(v), 1, 0);    /* Set parameter */
 }
 
 /**
@@ -453,7 +696,7 @@ gui_graph_setminy(gui_handle_p h, float v) {
 uint8_t
 gui_graph_setmaxy(gui_handle_p h, float v) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MAX_Y, &v, 1, 0);    /* Set parameter */
+    return guii_widget_setparam(h, CFG_MAX_Y, &v, sizeof(v), 1, 0);    /* Set parameter */
 }
 
 /**
@@ -464,7 +707,26 @@ gui_graph_setmaxy(gui_handle_p h, float v) {
 uint8_t
 gui_graph_zoomreset(gui_handle_p h) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_ZOOM_RESET, NULL, 1, 0);  /* Set parameter */
+    return guii_widget_setparam(h, CFG_ZOOM_RESET, NULL, 0, 1, 0);  /* Set parameter */
+}
+
+/**
+ * \brief           Set strip-chart mode of graph
+ *
+ *                  When enabled, each value added to first attached \ref GUI_GRAPH_TYPE_YT data
+ *                  moves already drawn plot to the left and only newest part of graph is drawn.
+ *                  Mode is used only when single sample takes whole number of pixels, otherwise graph is redrawn completely
+ *
+ * \note            Data must be attached with \ref GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE enabled.
+ *                  Add new values to all attached data before next redraw
+ * \param[in,out]   h: Widget handle
+ * \param[in]       strip: Set to `1` to enable strip-chart mode, `0` to disable it
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_graph_setstripchart(gui_handle_p h, uint8_t strip) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    return guii_widget_setparam(h, CFG_STRIP, &strip, sizeof(strip), 1, 0); /* Set parameter */
 }
 
 /**
@@ -567,9 +829,9 @@ gui_graph_data_create(gui_id_t id, gui_graph_type_t type, size_t length) {
         data->type = type;
         data->length = length;
         if (type == GUI_GRAPH_TYPE_YT) {            /* Only Y values are stored */
-            data->data = GUI_MEMALLOC(sizeof(*data->data) * length);/* Store Y values for plot */
+            data->data = GUI_MEMALLOC_HINT(sizeof(*data->data) * length, GUI_MEM_BULK);    /* Store Y values for plot */
         } else {
-            data->data = GUI_MEMALLOC(sizeof(*data->data) * length * 2);/* Store X and Y values for plot */
+            data->data = GUI_MEMALLOC_HINT(sizeof(*data->data) * length * 2, GUI_MEM_BULK);/* Store X and Y values for plot */
         }
         if (data->data == NULL) {
             GUI_MEMFREE(data);                      /* Remove widget because data memory could not be allocated */
@@ -606,7 +868,53 @@ gui_graph_data_addvalue(gui_graph_data_p data, int16_t x, int16_t y) {
     }
     
 #if GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE
-    graph_invalidate(data);                         /* Invalidate graphs attached to this data object */
+    graph_invalidate(data, 1);                      /* Invalidate graphs attached to this data object */
+#endif /* GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Add block of values to the end of data object
+ * \note            When more values than data length are added, only last values are kept
+ * \param[in]       data: Data object handle
+ * \param[in]       xs: Array of X values. Used only in case data type is \ref GUI_GRAPH_TYPE_XY, otherwise it is ignored and can be `NULL`
+ * \param[in]       ys: Array of Y values. Always used no matter of data type
+ * \param[in]       n: Number of values in arrays
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_graph_data_addvalue
+ */
+uint8_t
+gui_graph_data_addvalues(gui_graph_data_p data, const int16_t* xs, const int16_t* ys, size_t n) {
+    size_t i, cnt, skip;
+    
+    __GUI_ASSERTPARAMS(data != NULL && ys != NULL && (data->type != GUI_GRAPH_TYPE_XY || xs != NULL));  /* Check input parameters */
+    if (!n) {
+        return 1;
+    }
+    
+    skip = n > data->length ? n - data->length : 0; /* Values overwritten in the same call are not copied */
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (data->type == GUI_GRAPH_TYPE_YT) {          /* Only Y values, copy with at most 2 operations */
+        cnt = GUI_MIN(n - skip, data->length - data->ptr);
+        memcpy(&data->data[data->ptr], &ys[skip], cnt * sizeof(*ys));
+        memcpy(&data->data[0], &ys[skip + cnt], (n - skip - cnt) * sizeof(*ys));
+    } else if (data->type == GUI_GRAPH_TYPE_XY) {   /* X and Y values are interleaved */
+        for (i = skip, cnt = data->ptr; i < n; i++) {
+            data->data[2 * cnt + 0] = xs[i];
+            data->data[2 * cnt + 1] = ys[i];
+            if (++cnt == data->length) {
+                cnt = 0;
+            }
+        }
+    }
+    data->ptr = (data->ptr + n - skip) % data->length;  /* Set new write and read pointer */
+    
+#if GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE
+    graph_invalidate(data, n);                      /* Invalidate graphs attached to this data object only once */
 #endif /* GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE */
     
     __GUI_LEAVE();                                  /* Leave GUI */
@@ -627,7 +935,34 @@ gui_graph_data_setcolor(gui_graph_data_p data, gui_color_t color) {
     if (data->color != color) {                     /* Check color change */
         data->color = color;                        /* Set new color */
 #if GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE
-        graph_invalidate(data);                     /* Invalidate graphs attached to this data object */
+        graph_invalidate(data, 0);                  /* Invalidate graphs attached to this data object */
+#endif /* GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Set min-max drawing mode for graph data
+ *
+ *                  When enabled and more samples fall to single pixel column,
+ *                  \ref GUI_GRAPH_TYPE_YT data is drawn as vertical line between minimal and maximal sample of each column
+ *
+ * \param[in,out]   data: Pointer to \ref gui_graph_data_p structure with valid data
+ * \param[in]       minmax: Set to `1` to enable min-max mode or `0` to draw line between each sample
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_graph_data_setminmax(gui_graph_data_p data, uint8_t minmax) {
+    __GUI_ASSERTPARAMS(data != NULL);               /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    minmax = minmax ? 1 : 0;
+    if (data->minmax != minmax) {                   /* Check mode change */
+        data->minmax = minmax;
+#if GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE
+        graph_invalidate(data, 0);                  /* Invalidate graphs attached to this data object */
 #endif /* GUI_CFG_WIDGET_GRAPH_DATA_AUTO_INVALIDATE */
     }
     
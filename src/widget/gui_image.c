@@ -47,9 +47,123 @@ gui_widget_t widget = {
     .callback = gui_image_callback,                 /*!< Callback function */
     .colors = 0,                                    /*!< List of default colors */
     .color_count = 0,                               /*!< Define number of colors */
+    .events = GUI_WC_MASK_CORE,                     /*!< Handled callback commands */
 };
 #define o       ((GUI_IMAGE_t *)(h))
 
+#if GUI_CFG_IMAGE_ANIM || __DOXYGEN__
+
+/**
+ * \brief           Release current frame memory of animation
+ * \param[in]       h: Widget handle
+ */
+static void
+anim_release(gui_handle_p h) {
+    void* pixels;
+    
+    if (o->anim != NULL) {
+        guii_anim_stop(h, NULL);
+        guii_ll_waitready();                        /* Pixels may still be read by low-level */
+        pixels = (void *)o->frame.image;            /* Descriptor holds constant pointer */
+        GUI_MEMFREE(pixels);
+        o->anim = NULL;
+        o->image = NULL;
+    }
+}
+
+/**
+ * \brief           Apply changed pixels of frame to current frame in RAM and invalidate only their area
+ * \param[in]       h: Widget handle
+ * \param[in]       f: Frame to apply
+ */
+static void
+anim_apply(gui_handle_p h, const gui_image_frame_t* f) {
+    const gui_image_desc_t* d = f->delta;
+    size_t stride = (size_t)o->frame.x_size * (o->frame.bpp >> 3);
+    gui_dim_t x = f->x, y = f->y, width, height;
+    
+    if (d == NULL || d->bpp != o->frame.bpp || x < 0 || y < 0
+        || x + d->x_size > o->frame.x_size || y + d->y_size > o->frame.y_size) {
+        return;                                     /* Frame shows the same pixels */
+    }
+    guii_ll_waitready();                            /* Previous frame may still be read by low-level */
+    guii_draw_image_decode(d, (uint8_t *)o->frame.image + y * stride + x * (o->frame.bpp >> 3), stride);
+    
+    width = d->x_size;
+    height = d->y_size;
+    if (o->flags & GUI_IMAGE_FLAG_SCALE) {          /* Area is scaled with pixels */
+        gui_dim_t w = guii_widget_getwidth(h), hh = guii_widget_getheight(h);
+        
+        width = (gui_dim_t)(((int32_t)(x + width) * w + o->frame.x_size - 1) / o->frame.x_size);
+        height = (gui_dim_t)(((int32_t)(y + height) * hh + o->frame.y_size - 1) / o->frame.y_size);
+        x = (gui_dim_t)((int32_t)x * w / o->frame.x_size);
+        y = (gui_dim_t)((int32_t)y * hh / o->frame.y_size);
+        width -= x;
+        height -= y;
+#if GUI_CFG_IMAGE_SCALE_CACHE
+        guii_draw_image_release(&o->frame);         /* Scaled copy is not valid anymore */
+#endif /* GUI_CFG_IMAGE_SCALE_CACHE */
+    }
+    guii_widget_invalidaterect(h, x, y, width, height);
+}
+
+/**
+ * \brief           Show first frame of animation
+ * \param[in]       h: Widget handle
+ */
+static void
+anim_rewind(gui_handle_p h) {
+    guii_ll_waitready();
+    guii_draw_image_decode(o->anim->base, (uint8_t *)o->frame.image, (size_t)o->frame.x_size * (o->frame.bpp >> 3));
+    o->index = 0;
+    anim_apply(h, &o->anim->frames[0]);
+    guii_widget_invalidate(h);                      /* Complete image may change */
+}
+
+/**
+ * \brief           Get total duration of animation
+ * \param[in]       a: Animation
+ * \return          Duration in units of milliseconds
+ */
+static uint16_t
+anim_duration(const gui_image_anim_t* a) {
+    uint32_t total = 0;
+    uint16_t i;
+    
+    for (i = 0; i < a->count; i++) {
+        total += a->frames[i].duration;
+    }
+    return (uint16_t)GUI_MIN(total, 0xFFFF);
+}
+
+/**
+ * \brief           Animation scheduler callback with time elapsed since first frame
+ * \param[in]       h: Widget handle
+ * \param[in]       value: Time in units of milliseconds
+ */
+static void
+anim_exec(gui_handle_p h, int32_t value) {
+    const gui_image_anim_t* a = o->anim;
+    int32_t t = 0;
+    uint16_t target;
+    
+    if (a == NULL) {
+        return;
+    }
+    for (target = 0; target + 1 < a->count && t + a->frames[target].duration <= value; target++) {
+        t += a->frames[target].duration;            /* Find frame shown at this time */
+    }
+    while (o->index < target) {                     /* Late frames are applied too, only their areas are redrawn */
+        anim_apply(h, &a->frames[++o->index]);
+    }
+    if (value >= anim_duration(a) && o->loop) {     /* Last frame has been shown for its time */
+        anim_rewind(h);
+        guii_anim_start(h, anim_exec, 0, anim_duration(a), anim_duration(a), GUI_ANIM_EASE_LINEAR);
+    }
+}
+
+#endif /* GUI_CFG_IMAGE_ANIM || __DOXYGEN__ */
+
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -69,9 +183,22 @@ gui_image_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
             x = guii_widget_getabsolutex(h);        /* Get absolute X coordinate */
             y = guii_widget_getabsolutey(h);        /* Get absolute Y coordinate */
             
-            gui_draw_image(disp, x, y, o->image);   /* Draw actual image on screen */
+            if (o->image == NULL || o->image->image == NULL) { /* Pixels are not loaded yet, draw placeholder */
+                gui_draw_filledrectangle(disp, x, y, guii_widget_getwidth(h), guii_widget_getheight(h), GUI_COLOR_LIGHTGRAY);
+                gui_draw_rectangle(disp, x, y, guii_widget_getwidth(h), guii_widget_getheight(h), GUI_COLOR_GRAY);
+            } else if (o->flags & GUI_IMAGE_FLAG_SCALE) {   /* Fill complete widget with image */
+                gui_draw_image_scaled(disp, x, y, guii_widget_getwidth(h), guii_widget_getheight(h), o->image);
+            } else {
+                gui_draw_image(disp, x, y, o->image);   /* Draw actual image on screen */
+            }
+            return 1;
+        }
+#if GUI_CFG_IMAGE_ANIM
+        case GUI_WC_Remove: {                       /* When widget is about to be removed */
+            anim_release(h);
             return 1;
         }
+#endif /* GUI_CFG_IMAGE_ANIM */
         default:                                    /* Handle default option */
             GUI_UNUSED3(h, param, result);          /* Unused elements to prevent compiler warnings */
             return 0;                               /* Command was not processed */
@@ -109,6 +236,9 @@ gui_image_setsource(gui_handle_p h, const gui_image_desc_t* img) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && img != NULL);   /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
+#if GUI_CFG_IMAGE_ANIM
+    anim_release(h);                                /* Image replaces animation */
+#endif /* GUI_CFG_IMAGE_ANIM */
     __GI(h)->image = img;                           /* Set image */
     guii_widget_setinvalidatewithparent(h, img != NULL && img->bpp == 32);  /* Set how invalidation functon hebaves */
     guii_widget_invalidatewithparent(h);           /* Invalidate widget */
@@ -116,3 +246,111 @@ gui_image_setsource(gui_handle_p h, const gui_image_desc_t* img) {
     __GUI_LEAVE();                                  /* Leave GUI */
     return ret;
 }
+
+/**
+ * \brief           Set scale mode of image
+ * \note            When enabled, image is scaled to widget size. Scaled copy is kept for next redraws,
+ *                  see \ref GUI_CFG_IMAGE_SCALE_CACHE
+ * \param[in]       h: Widget handle
+ * \param[in]       enable: Set to `1` to scale image to widget size or `0` to draw it at native size
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_image_setscale(gui_handle_p h, uint8_t enable) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (!enable != !(__GI(h)->flags & GUI_IMAGE_FLAG_SCALE)) {
+        __GI(h)->flags ^= GUI_IMAGE_FLAG_SCALE;
+        guii_widget_invalidatewithparent(h);       /* Invalidate widget */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Remove cached scaled copies of image
+ * \note            Call it before pixels of image in RAM are modified or image memory is released
+ * \param[in]       img: Pointer to \ref gui_image_desc_t image object. Use NULL to remove all cached images
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_image_releasescaled(const gui_image_desc_t* img) {
+    __GUI_ENTER();                                  /* Enter GUI */
+#if GUI_CFG_IMAGE_SCALE_CACHE
+    guii_draw_image_release(img);
+#else /* GUI_CFG_IMAGE_SCALE_CACHE */
+    GUI_UNUSED(img);
+#endif /* !GUI_CFG_IMAGE_SCALE_CACHE */
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+#if GUI_CFG_IMAGE_ANIM || __DOXYGEN__
+
+/**
+ * \brief           Play animated image with delta frames
+ * \note            Widget keeps current frame in memory. Each frame decodes only its changed area
+ *                  and only that area is redrawn. Frames are paced by animation scheduler,
+ *                  when processing is late, intermediate frames are applied at once
+ * \param[in]       h: Widget handle
+ * \param[in]       anim: Animation to play. Set to `NULL` to stop and release animation
+ * \param[in]       loop: Set to `1` to play animation in loop or `0` to stop on last frame
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_image_stopanimation
+ */
+uint8_t
+gui_image_setanimation(gui_handle_p h, const gui_image_anim_t* anim, uint8_t loop) {
+    const gui_image_desc_t* base;
+    uint8_t* mem = NULL;
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && (anim == NULL || (anim->base != NULL && anim->frames != NULL && anim->count)));  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    anim_release(h);
+    if (anim != NULL && (anim->base->bpp >> 3)) {
+        base = anim->base;
+        GUI_MEM_TAGGED(GUI_MEM_TAG_IMAGE_ANIM, mem = GUI_MEMALLOC_NOZERO((size_t)base->x_size * base->y_size * (base->bpp >> 3)));
+    }
+    if (mem != NULL) {
+        memset(&__GI(h)->frame, 0x00, sizeof(__GI(h)->frame));
+        __GI(h)->frame.x_size = base->x_size;
+        __GI(h)->frame.y_size = base->y_size;
+        __GI(h)->frame.bpp = base->bpp;
+        __GI(h)->frame.palette = base->palette;
+        __GI(h)->frame.palette_size = base->palette_size;
+        __GI(h)->frame.image = mem;
+        __GI(h)->anim = anim;
+        __GI(h)->loop = loop;
+        __GI(h)->image = &__GI(h)->frame;
+        guii_widget_setinvalidatewithparent(h, base->bpp == 32);
+        anim_rewind(h);
+        if (anim->count > 1) {
+            guii_anim_start(h, anim_exec, 0, anim_duration(anim), anim_duration(anim), GUI_ANIM_EASE_LINEAR);
+        }
+    } else {
+        guii_widget_invalidatewithparent(h);        /* Nothing is shown anymore */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return mem != NULL || anim == NULL;
+}
+
+/**
+ * \brief           Stop playing animation, current frame stays shown
+ * \param[in]       h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_image_stopanimation(gui_handle_p h) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    ret = guii_anim_stop(h, anim_exec);
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+#endif /* GUI_CFG_IMAGE_ANIM || __DOXYGEN__ */
@@ -62,10 +62,23 @@ gui_widget_t widget = {
     .callback = gui_led_callback,                   /*!< Control function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE,                     /*!< Handled callback commands */
 };
 
 #define l           ((GUI_LED_t *)(h))
 
+/* Redraw LED after state change */
+static void
+invalidate_state(gui_handle_p h) {
+    /* Rectangle border is kept when both states use the same border color */
+    if (l->type == GUI_LED_TYPE_RECT &&
+        guii_widget_getcolor(h, GUI_LED_COLOR_ON_BORDER) == guii_widget_getcolor(h, GUI_LED_COLOR_OFF_BORDER)) {
+        guii_widget_invalidaterect(h, 1, 1, guii_widget_getwidth(h) - 2, guii_widget_getheight(h) - 2);
+    } else {
+        guii_widget_invalidate(h);
+    }
+}
+
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -82,14 +95,14 @@ gui_led_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_w
             gui_widget_param* p = GUI_WIDGET_PARAMTYPE_WIDGETPARAM(param);
             switch (p->type) {
                 case CFG_SET:
-                    if (*(uint8_t *)p->data) {
-                        l->flags |= GUI_LED_FLAG_ON;
-                    } else {
-                        l->flags &= ~GUI_LED_FLAG_ON;
+                    if (!*(uint8_t *)p->data != !(l->flags & GUI_LED_FLAG_ON)) {  /* State has changed */
+                        l->flags ^= GUI_LED_FLAG_ON;
+                        invalidate_state(h);
                     }
                     break;
                 case CFG_TOGGLE: 
                     l->flags ^= GUI_LED_FLAG_ON;    /* Toggle flag */
+                    invalidate_state(h);
                     break;
                 case CFG_TYPE: 
                     l->type = *(gui_led_type_t *)p->data;   /* Set type */
@@ -119,11 +132,34 @@ gui_led_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_w
             }
             
             if (l->type == GUI_LED_TYPE_RECT) {     /* When led has rectangle shape */
+#if GUI_CFG_WIDGET_STATE_CACHE
+                if (guii_widget_drawstate(h, x, y, width, height, 0, l->flags & GUI_LED_FLAG_ON, disp)) {
+                    return 1;                       /* Copied from bitmap of the same state */
+                }
+#endif /* GUI_CFG_WIDGET_STATE_CACHE */
                 gui_draw_filledrectangle(disp, x + 1, y + 1, width - 2, height - 2, c1);
                 gui_draw_rectangle(disp, x, y, width, height, c2);
+#if GUI_CFG_WIDGET_STATE_CACHE
+                if ((c1 >> 24) == 0xFF && (c2 >> 24) == 0xFF) {
+                    guii_widget_savestate(h, x, y, width, height, l->flags & GUI_LED_FLAG_ON, disp);
+                }
+#endif /* GUI_CFG_WIDGET_STATE_CACHE */
             } else {
-                gui_draw_filledcircle(disp, x + width / 2, y + height / 2, width / 2, c1);
-                gui_draw_circle(disp, x + width / 2, y + height / 2, width / 2, c2);
+                gui_dim_t r = width / 2;
+                
+                /* Circle covers 2 * r + 1 pixels around center */
+#if GUI_CFG_WIDGET_STATE_CACHE
+                if (r > 0 && guii_widget_drawstate(h, x, y + height / 2 - r, 2 * r + 1, 2 * r + 1, r, 0x100 | (l->flags & GUI_LED_FLAG_ON), disp)) {
+                    return 1;                       /* Copied from bitmap of the same state */
+                }
+#endif /* GUI_CFG_WIDGET_STATE_CACHE */
+                gui_draw_filledcircle(disp, x + r, y + height / 2, r, c1);
+                gui_draw_circle(disp, x + r, y + height / 2, r, c2);
+#if GUI_CFG_WIDGET_STATE_CACHE
+                if (r > 0 && (c1 >> 24) == 0xFF) { /* Border is drawn inside filled circle */
+                    guii_widget_savestate(h, x, y + height / 2 - r, 2 * r + 1, 2 * r + 1, 0x100 | (l->flags & GUI_LED_FLAG_ON), disp);
+                }
+#endif /* GUI_CFG_WIDGET_STATE_CACHE */
             }
             return 1;                               /* */
         }
@@ -173,7 +209,7 @@ gui_led_setcolor(gui_handle_p h, gui_led_color_t index, gui_color_t color) {
 uint8_t
 gui_led_settype(gui_handle_p h, gui_led_type_t type) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_TYPE, &type, 1, 1); /* Set parameter */
+    return guii_widget_setparam(h, CFG_TYPE, &type, sizeof(type), 1, 1); /* Set parameter */
 }
 
 /**
@@ -184,7 +220,7 @@ gui_led_settype(gui_handle_p h, gui_led_type_t type) {
 uint8_t
 gui_led_toggle(gui_handle_p h) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_TOGGLE, NULL, 1, 0);/* Set parameter */
+    return guii_widget_setparam(h, CFG_TOGGLE, NULL, 0, 0, 0);/* Set parameter */
 }
 
 /**
@@ -196,7 +232,7 @@ gui_led_toggle(gui_handle_p h) {
 uint8_t
 gui_led_set(gui_handle_p h, uint8_t state) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_SET, &state, 1, 0); /* Set parameter */
+    return guii_widget_setparam(h, CFG_SET, &state, sizeof(state), 0, 0); /* Set parameter */
 }
 
 /**
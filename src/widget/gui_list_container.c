@@ -55,10 +55,12 @@ static const
 gui_widget_t widget = {
     .name = _GT("LED"),                             /*!< Widget name */ 
     .size = sizeof(gui_list_container_t),           /*!< Size of widget for memory allocation */
-    .flags = GUI_FLAG_WIDGET_ALLOW_CHILDREN,        /*!< List of widget flags */
+    .flags = GUI_FLAG_WIDGET_ALLOW_CHILDREN | GUI_FLAG_WIDGET_OPAQUE,   /*!< List of widget flags */
     .callback = gui_listcontainer_callback,         /*!< Control function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_TouchStart) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_TouchMove) | GUI_WC_MASK(GUI_WC_TouchEnd),
 };
 #define l           ((gui_list_container_t *)(h))
 
@@ -100,13 +102,38 @@ calculate_limits(gui_handle_p h) {
         l->maxscrolly = cmy - height;
     }
     
-    if (gui_widget_getscrollx(h) > l->maxscrollx) {
-        gui_widget_setscrollx(h, l->maxscrollx);
+    /* Limits are checked during drawing, frame is not complete to move its pixels */
+    if (__GHR(h)->x_scroll > l->maxscrollx || __GHR(h)->y_scroll > l->maxscrolly) {
+        __GHR(h)->x_scroll = GUI_MIN(__GHR(h)->x_scroll, l->maxscrollx);
+        __GHR(h)->y_scroll = GUI_MIN(__GHR(h)->y_scroll, l->maxscrolly);
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
+        guii_widget_invalidate(h);
     }
-    if (gui_widget_getscrolly(h) > l->maxscrolly) {
-        gui_widget_setscrolly(h, l->maxscrolly);
+}
+
+/* Set vertical scroll within limits, drawn children are moved and only exposed strip is redrawn */
+static void
+set_scrolly(gui_handle_p h, int32_t scroll) {
+    if (scroll > l->maxscrolly) {
+        scroll = l->maxscrolly;
     }
+    if (scroll < 0) {
+        scroll = 0;
+    }
+    if (__GHR(h)->y_scroll != scroll) {
+        guii_widget_scrollchildren(h, 0, scroll - __GHR(h)->y_scroll);
+        __GHR(h)->y_scroll = scroll;
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
+    }
+}
+
+#if GUI_CFG_USE_TOUCH
+/* Animation callback for kinetic scroll */
+static void
+anim_exec(gui_handle_p h, int32_t value) {
+    set_scrolly(h, value);
 }
+#endif /* GUI_CFG_USE_TOUCH */
 
 /**
  * \brief           Default widget callback function
@@ -138,23 +165,27 @@ gui_listcontainer_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* pa
             width = guii_widget_getwidth(h);        /* Get widget width */
             height = guii_widget_getheight(h);      /* Get widget height */
             
-            gui_draw_filledrectangle(disp, x, y, width, height, guii_widget_getcolor(h, GUI_LIST_CONTAINER_COLOR_BG));
+            guii_widget_drawbackground(h, disp, x, y, width, height, guii_widget_getcolor(h, GUI_LIST_CONTAINER_COLOR_BG));
             return 1;                               /* */
         }
 #if GUI_CFG_USE_TOUCH
         case GUI_WC_TouchStart: {
+            guii_anim_stop(h, anim_exec);           /* Touch stops kinetic scroll */
             GUI_WIDGET_RESULTTYPE_TOUCH(result) = touchHANDLED;
             return 1;
         }
         case GUI_WC_TouchMove: {
             guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
             GUI_WIDGET_RESULTTYPE_TOUCH(result) = touchHANDLED;
-            gui_widget_incscrolly(h, ts->y_rel_old[0] - ts->y_rel[0]);
-            if (gui_widget_getscrolly(h) < 0) {
-                gui_widget_setscrolly(h, 0);
-            }
+            set_scrolly(h, __GHR(h)->y_scroll + ts->y_rel_old[0] - ts->y_rel[0]);
+            return 1;
+        }
+#if GUI_CFG_TOUCH_HISTORY_SIZE
+        case GUI_WC_TouchEnd: {
+            guii_anim_fling(h, anim_exec, __GHR(h)->y_scroll, l->maxscrolly, GUI_WIDGET_PARAMTYPE_TOUCH(param));
             return 1;
         }
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE */
 #endif /* GUI_CFG_USE_TOUCH */
         default:                                    /* Handle default option */
             GUI_UNUSED3(h, param, result);          /* Unused elements to prevent compiler warnings */
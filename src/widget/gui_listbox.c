@@ -56,10 +56,14 @@ static const
 gui_widget_t widget = {
     .name = _GT("LISTBOX"),                         /*!< Widget name */
     .size = sizeof(gui_listbox_t),                  /*!< Size of widget for memory allocation */
-    .flags = 0,                                     /*!< List of widget flags */
+    .flags = GUI_FLAG_WIDGET_OPAQUE,                /*!< List of widget flags */
     .callback = gui_listbox_callback,               /*!< Callback function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Define number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_TouchStart) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_TouchMove) | GUI_WC_MASK(GUI_WC_TouchEnd) |
+            GUI_WC_MASK(GUI_WC_Click) | GUI_WC_MASK(GUI_WC_KeyPress) |
+            GUI_WC_MASK(GUI_WC_IncSelection),
 };
 
 #define o                   ((gui_listbox_t *)(h))
@@ -67,24 +71,57 @@ gui_widget_t widget = {
 /* Get item from listbox entry */
 static gui_listbox_item_t*
 get_item(gui_handle_p h, uint16_t index) {
-    uint16_t i = 0;
-    gui_listbox_item_t* item = 0;
-    
     if (index >= o->count) {                        /* Check if valid index */
         return 0;
     }
+    return &o->items[index];                        /* Entries are stored in contiguous array */
+}
+
+/* Make sure array can hold at least "count" entries, grow geometrically otherwise */
+static uint8_t
+reserve_items(gui_handle_p h, size_t count) {
+    gui_listbox_item_t* items;
+    size_t capacity;
     
-    if (index == 0) {                               /* Check for first element */
-        return (gui_listbox_item_t *)gui_linkedlist_getnext_gen(&o->root, NULL);/* Return first element */
-    } else if (index == o->count - 1) {
-        return (gui_listbox_item_t *)gui_linkedlist_getprev_gen(&o->root, NULL);/* Return last element */
+    if (count <= (size_t)o->capacity) {             /* Enough memory already */
+        return 1;
     }
-    
-    item = (gui_listbox_item_t *)gui_linkedlist_getnext_gen(&o->root, NULL);
-    while (i++ < index) {
-        item = (gui_listbox_item_t *)gui_linkedlist_getnext_gen(NULL, &item->list);
+    if (count > INT16_MAX) {                        /* Index is stored as signed 16-bit value */
+        return 0;
+    }
+    capacity = o->capacity ? o->capacity : 4;       /* Start with small array */
+    while (capacity < count) {
+        capacity <<= 1;                             /* Double the size each time */
     }
-    return item;
+    if (capacity > INT16_MAX) {
+        capacity = INT16_MAX;
+    }
+    items = GUI_MEMREALLOC(o->items, capacity * sizeof(*items));
+    if (items == NULL) {
+        return 0;
+    }
+    o->items = items;
+    o->capacity = (int16_t)capacity;
+    return 1;
+}
+
+/* Get number of entries shown in widget, only entries matching filter when it is set */
+static int16_t
+view_count(gui_handle_p h) {
+    return o->filter != NULL ? o->view_count : o->count;
+}
+
+/* Get entry index from index of shown entry */
+static int16_t
+view_entry(gui_handle_p h, int16_t index) {
+    return o->filter != NULL ? o->view[index] : index;
+}
+
+/* Check if entry matches filter query */
+static uint8_t
+filter_match(gui_handle_p h, int16_t index) {
+    const gui_char* text = o->items[index].text != NULL ? o->items[index].text : _GT("");
+    return (o->filter_fn != NULL ? o->filter_fn : gui_string_contains)(text, o->filter);
 }
 
 /* Get item height in listbox */
@@ -107,25 +144,73 @@ nr_entries_pp(gui_handle_p h) {
     return res;
 }
 
+/* Get scroll position of visible area in units of pixels */
+static int32_t
+get_scroll(gui_handle_p h) {
+    return (int32_t)o->visiblestartindex * item_height(h, NULL) + o->visibleoffset;
+}
+
+/* Get maximal scroll position in units of pixels, last entry is aligned to bottom */
+static int32_t
+get_maxscroll(gui_handle_p h) {
+    return (int32_t)GUI_MAX(view_count(h) - nr_entries_pp(h), 0) * item_height(h, NULL);
+}
+
+/* Redraw widget after visible area changed, move already drawn rows when possible */
+static void
+scroll_redraw(gui_handle_p h, int16_t start, gui_dim_t offset, uint8_t flags) {
+    guii_widget_scrollrows(h, o->visiblestartindex - start, o->visibleoffset - offset,
+        h->font != NULL && flags == o->flags ? item_height(h, NULL) : 0, 0,
+        o->flags & GUI_FLAG_LISTBOX_SLIDER_ON ? o->sliderwidth : 0);
+}
+
+/* Scroll visible area to pixel position */
+static void
+set_scroll(gui_handle_p h, int32_t scroll) {
+    int16_t start = o->visiblestartindex;
+    gui_dim_t offset = o->visibleoffset;
+    uint16_t itemheight;
+    
+    if (h->font == NULL) {
+        return;
+    }
+    itemheight = item_height(h, NULL);
+    scroll = GUI_MAX(GUI_MIN(scroll, get_maxscroll(h)), 0);
+    o->visiblestartindex = (int16_t)(scroll / itemheight);
+    o->visibleoffset = (gui_dim_t)(scroll % itemheight);
+    scroll_redraw(h, start, offset, o->flags);      /* Redraw changed part */
+}
+
+#if GUI_CFG_USE_TOUCH
+/* Animation callback for kinetic scroll */
+static void
+anim_exec(gui_handle_p h, int32_t value) {
+    set_scroll(h, value);
+}
+#endif /* GUI_CFG_USE_TOUCH */
+
 /* Slide up or slide down widget elements */
 static void
 slide(gui_handle_p h, int16_t dir) {
     int16_t mPP = nr_entries_pp(h);
+    int16_t start = o->visiblestartindex;
+    gui_dim_t offset = o->visibleoffset;
+    
+    o->visibleoffset = 0;                           /* Align to entry */
     if (dir < 0) {                                  /* Slide elements up */
         if ((o->visiblestartindex + dir) < 0) {
             o->visiblestartindex = 0;
         } else {
             o->visiblestartindex += dir;
         }
-        guii_widget_invalidate(h);
     } else if (dir > 0) {
-        if ((o->visiblestartindex + dir) > (o->count - mPP - 1)) {  /* Slide elements down */
-            o->visiblestartindex = o->count - mPP;
+        if ((o->visiblestartindex + dir) > (view_count(h) - mPP - 1)) {  /* Slide elements down */
+            o->visiblestartindex = GUI_MAX(view_count(h) - mPP, 0);
         } else {
             o->visiblestartindex += dir;
         }
-        guii_widget_invalidate(h);
     }
+    scroll_redraw(h, start, offset, o->flags);      /* Redraw changed part */
 }
 
 /* Set selection for widget */
@@ -148,8 +233,8 @@ inc_selection(gui_handle_p h, int16_t dir) {
         }
         guii_widget_invalidate(h);
     } else if (dir > 0) {
-        if ((o->selected + dir) > (o->count - 1)) { /* Slide elements down */
-            set_selection(h, o->count - 1);
+        if ((o->selected + dir) > (view_count(h) - 1)) { /* Slide elements down */
+            set_selection(h, view_count(h) - 1);
         } else {
             set_selection(h, o->selected + dir);
         }
@@ -163,22 +248,25 @@ check_values(gui_handle_p h) {
     int16_t mPP = nr_entries_pp(h);                 /* Get number of lines visible in widget at a time */
    
     if (o->selected >= 0) {                         /* Check for selected value range */
-        if (o->selected >= o->count) {
-            set_selection(h, o->count - 1);
+        if (o->selected >= view_count(h)) {
+            set_selection(h, view_count(h) - 1);
         }
     }
     if (o->visiblestartindex < 0) {                 /* Check visible start index position */
         o->visiblestartindex = 0;
     } else if (o->visiblestartindex > 0) {
-        if (o->count > mPP) {
-            if (o->visiblestartindex + mPP >= o->count) {
-                o->visiblestartindex = o->count - mPP;
+        if (view_count(h) > mPP) {
+            if (o->visiblestartindex + mPP >= view_count(h)) {
+                o->visiblestartindex = view_count(h) - mPP;
             }
         }
     }
+    if (o->visiblestartindex >= view_count(h) - mPP) {
+        o->visibleoffset = 0;                       /* No partial entry at the end of range */
+    }
     
     if (o->flags & GUI_FLAG_LISTBOX_SLIDER_AUTO) {  /* Check slider mode */
-        if (o->count > mPP) {
+        if (view_count(h) > mPP) {
             o->flags |= GUI_FLAG_LISTBOX_SLIDER_ON;
         } else {
             o->flags &= ~GUI_FLAG_LISTBOX_SLIDER_ON;
@@ -186,6 +274,63 @@ check_values(gui_handle_p h) {
     }
 }
 
+/* Get index of selected entry or `-1` if none */
+static int16_t
+selected_entry(gui_handle_p h) {
+    return o->selected >= 0 && o->selected < view_count(h) ? view_entry(h, o->selected) : -1;
+}
+
+/**
+ * \brief           Build array of entries matching filter
+ * \note            Selection follows selected entry and is cleared when entry does not match anymore
+ * \param[in]       h: Widget handle
+ * \param[in]       refine: Set to `1` to check only entries which matched previous query,
+ *                      valid when previous query is beginning of current one
+ * \param[in]       sel: Index of selected entry before filter changed or `-1` if none
+ * \return          `1` on success, `0` when there is no memory and filter was removed
+ */
+static uint8_t
+filter_items(gui_handle_p h, uint8_t refine, int16_t sel) {
+    int16_t i, cnt = 0;
+    int16_t* view;
+    
+    refine = refine && o->view != NULL;
+    if (!refine) {                                  /* Check all entries */
+        GUI_MEM_TAGGED(GUI_MEM_TAG_LIST_FILTER, view = GUI_MEMREALLOC(o->view, GUI_MAX(o->count, 1) * sizeof(*view)));
+        if (view == NULL) {
+            GUI_MEMFREE(o->filter);                 /* Show all entries without memory */
+            if (o->view != NULL) {
+                GUI_MEMFREE(o->view);
+            }
+            o->selected = sel;
+            return 0;
+        }
+        o->view = view;
+        for (i = 0; i < o->count; i++) {
+            if (filter_match(h, i)) {
+                o->view[cnt++] = i;
+            }
+        }
+    } else {                                        /* Entries can only be removed from view */
+        for (i = 0; i < o->view_count; i++) {
+            if (filter_match(h, o->view[i])) {
+                o->view[cnt++] = o->view[i];
+            }
+        }
+    }
+    o->view_count = cnt;
+    
+    if (sel >= 0) {                                 /* Find new position of selected entry */
+        for (i = 0; i < cnt && o->view[i] != sel; i++) {}
+        if (i < cnt) {
+            o->selected = i;                        /* The same entry is still selected */
+        } else {
+            set_selection(h, -1);
+        }
+    }
+    return 1;
+}
+
 /* Delete list item box by index */
 static uint8_t
 delete_item(gui_handle_p h, uint16_t index) {
@@ -193,10 +338,20 @@ delete_item(gui_handle_p h, uint16_t index) {
     
     item = get_item(h, index);                      /* Get list item from handle */
     if (item) {
-        gui_linkedlist_remove_gen(&__GL(h)->root, &item->list);
+        int16_t i, cnt, sel = selected_entry(h);
+        
+        memmove(item, item + 1, (o->count - index - 1) * sizeof(*item));    /* Close the gap */
         __GL(h)->count--;                           /* Decrease count */
+        if (o->filter != NULL) {                    /* Remove entry from filtered entries */
+            for (i = 0, cnt = 0; i < o->view_count; i++) {
+                if (o->view[i] != index) {
+                    o->view[cnt++] = o->view[i] > index ? o->view[i] - 1 : o->view[i];
+                }
+            }
+            o->view_count = cnt;
+        }
         
-        if (o->selected == index) {
+        if (sel == index) {
             set_selection(h, -1);
         }
         
@@ -217,10 +372,6 @@ delete_item(gui_handle_p h, uint16_t index) {
  */
 static uint8_t
 gui_listbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result) {
-#if GUI_CFG_USE_TOUCH
-    static gui_dim_t ty;
-#endif /* GUI_CFG_USE_TOUCH */
-    
     switch (ctrl) {                                 /* Handle control function if required */
         case GUI_WC_PreInit: {
             __GL(h)->selected = -1;                 /* No selection */
@@ -253,7 +404,7 @@ gui_listbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, g
                 sb.height = height - 2;
                 sb.dir = GUI_DRAW_SB_DIR_VERTICAL;
                 sb.entriestop = o->visiblestartindex;
-                sb.entriestotal = o->count;
+                sb.entriestotal = view_count(h);
                 sb.entriesvisible = nr_entries_pp(h);
                 
                 gui_draw_scrollbar(disp, &sb);      /* Draw scroll bar */
@@ -262,19 +413,18 @@ gui_listbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, g
             }
             
             /* Draw text if possible */
-            if (h->font != NULL && gui_linkedlist_hasentries(&__GL(h)->root)) {   /* Is first set? */
+            if (h->font != NULL && view_count(h) > 0) { /* Is first set? */
                 gui_draw_font_t f;
-                gui_listbox_item_t* item;
                 uint16_t itemheight;                /* Get item height */
-                uint16_t index = 0;                 /* Start index */
-                gui_dim_t tmp;
+                int16_t index;
+                gui_dim_t tmp, tmp1;
                 
                 itemheight = item_height(h, 0);     /* Get item height and Y offset */
                 
                 gui_draw_font_init(&f);             /* Init structure */
                 
                 f.x = x + 4;
-                f.y = y + 2;
+                f.y = y + 2 - o->visibleoffset;     /* First entry may be partially scrolled out */
                 f.width = width - 4;
                 f.height = itemheight;
                 f.align = GUI_HALIGN_LEFT | GUI_VALIGN_CENTER;
@@ -284,54 +434,62 @@ gui_listbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, g
                 if (disp->y2 > (y + height - 2)) {
                     disp->y2 = y + height - 2;
                 }
+                tmp1 = disp->y1;
+                if (disp->y1 < (y + 2)) {
+                    disp->y1 = y + 2;
+                }
                 
-                for (index = 0, item = (gui_listbox_item_t *)gui_linkedlist_getnext_gen(&o->root, NULL); item && f.y <= disp->y2;
-                        item = (gui_listbox_item_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)item), index++) {
-                    if (index < o->visiblestartindex) { /* Check for start drawing index */
-                        continue;
-                    }
+                /* Start directly at first visible entry */
+                for (index = o->visiblestartindex; index < view_count(h) && f.y <= disp->y2; index++) {
                     if (index == __GL(h)->selected) {
                         gui_draw_filledrectangle(disp, x + 2, f.y, width - 3, GUI_MIN(f.height, itemheight), guii_widget_isfocused(h) ? guii_widget_getcolor(h, GUI_LISTBOX_COLOR_SEL_FOC_BG) : guii_widget_getcolor(h, GUI_LISTBOX_COLOR_SEL_NOFOC_BG));
                         f.color1 = guii_widget_isfocused(h) ? guii_widget_getcolor(h, GUI_LISTBOX_COLOR_SEL_FOC) : guii_widget_getcolor(h, GUI_LISTBOX_COLOR_SEL_NOFOC);
                     } else {
                         f.color1 = guii_widget_getcolor(h, GUI_LISTBOX_COLOR_TEXT);
                     }
-                    gui_draw_writetext(disp, guii_widget_getfont(h), item->text, &f);
+                    gui_draw_writetext(disp, guii_widget_getfont(h), o->items[view_entry(h, index)].text, &f);
                     f.y += itemheight;
                 }
                 disp->y2 = tmp;
+                disp->y1 = tmp1;
             }
             
             return 1;
         }
         case GUI_WC_Remove: {
-            gui_listbox_item_t* item;
-            while ((item = (gui_listbox_item_t *)gui_linkedlist_remove_gen(&o->root, (gui_linkedlist_t *)gui_linkedlist_getnext_gen(&o->root, NULL))) != NULL) {
-                GUI_MEMFREE(item);                  /* Free memory */
+            if (o->items != NULL) {
+                GUI_MEMFREE(o->items);              /* Free array of entries */
+            }
+            o->count = o->capacity = 0;
+            if (o->filter != NULL) {
+                GUI_MEMFREE(o->filter);             /* Free filter query */
+            }
+            if (o->view != NULL) {
+                GUI_MEMFREE(o->view);               /* Free filtered entries */
             }
             return 1;
         }
 #if GUI_CFG_USE_TOUCH
         case GUI_WC_TouchStart: {
-            guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
-            ty = ts->y_rel[0];
-            
+            guii_anim_stop(h, anim_exec);           /* Touch stops kinetic scroll */
             GUI_WIDGET_RESULTTYPE_TOUCH(result) = touchHANDLED;
             return 1;
         }
         case GUI_WC_TouchMove: {
             guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
             if (h->font != NULL) {
-                gui_dim_t height = item_height(h, NULL);   /* Get element height */
-                gui_dim_t diff = ty - ts->y_rel[0];
-                
-                if (GUI_ABS(diff) > height) {
-                    slide(h, diff > 0 ? 1 : -1);    /* Slide widget */
-                    ty = ts->y_rel[0];               /* Save pointer */
-                }
+                set_scroll(h, get_scroll(h) + ts->y_rel_old[0] - ts->y_rel[0]);   /* Entries follow finger */
+            }
+            return 1;
+        }
+#if GUI_CFG_TOUCH_HISTORY_SIZE
+        case GUI_WC_TouchEnd: {
+            if (h->font != NULL) {
+                guii_anim_fling(h, anim_exec, get_scroll(h), get_maxscroll(h), GUI_WIDGET_PARAMTYPE_TOUCH(param));
             }
             return 1;
         }
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE */
 #endif /* GUI_CFG_USE_TOUCH */
         case GUI_WC_Click: {
             guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
@@ -353,8 +511,8 @@ gui_listbox_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, g
                 uint16_t height = item_height(h, NULL);    /* Get element height */
                 uint16_t tmpselected;
                 
-                tmpselected = ts->y_rel[0] / height; /* Get temporary selected index */
-                if ((o->visiblestartindex + tmpselected) <= o->count) {
+                tmpselected = (ts->y_rel[0] + o->visibleoffset) / height;  /* Get temporary selected index */
+                if ((o->visiblestartindex + tmpselected) < view_count(h)) {
                     set_selection(h, o->visiblestartindex + tmpselected);
                     guii_widget_invalidate(h);     /* Choose new selection */
                 }
@@ -422,25 +580,54 @@ gui_listbox_setcolor(gui_handle_p h, gui_listbox_color_t index, gui_color_t colo
  */
 uint8_t
 gui_listbox_addstring(gui_handle_p h, const gui_char* text) {
-    gui_listbox_item_t* item;
+    return gui_listbox_addstrings(h, &text, 1);     /* Add single entry */
+}
+
+/**
+ * \brief           Add multiple strings to list box at once
+ * \note            Array of entries is resized only once and widget is invalidated only once,
+ *                  which makes it much faster than calling \ref gui_listbox_addstring in a loop
+ * \param[in,out]   h: Widget handle
+ * \param[in]       texts: Array of pointers to texts to add to list. Only pointers are saved to memory!
+ * \param[in]       count: Number of entries in \arg texts array
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_listbox_addstring
+ */
+uint8_t
+gui_listbox_addstrings(gui_handle_p h, const gui_char* const* texts, size_t count) {
+    size_t i;
     uint8_t ret = 0;
     
-    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && texts != NULL && count > 0);    /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
     
-    item = GUI_MEMALLOC(sizeof(*item));             /* Allocate memory for entry */
-    if (item != NULL) {
-        __GUI_ENTER();                              /* Enter GUI */
-        item->text = (gui_char *)text;              /* Add text to entry */
-        gui_linkedlist_add_gen(&__GL(h)->root, &item->list);/* Add to linked list */
-        __GL(h)->count++;                           /* Increase number of strings */
+    if (reserve_items(h, (size_t)__GL(h)->count + count)) {   /* Allocate memory for all entries */
+        int16_t start = __GL(h)->count;
+        
+        for (i = 0; i < count; i++) {
+            __GL(h)->items[__GL(h)->count++].text = (gui_char *)texts[i];   /* Add text to entry */
+        }
+        if (__GL(h)->filter != NULL) {              /* Check only new entries against filter */
+            int16_t* view;
+            GUI_MEM_TAGGED(GUI_MEM_TAG_LIST_FILTER, view = GUI_MEMREALLOC(__GL(h)->view, __GL(h)->count * sizeof(*view)));
+            if (view != NULL) {
+                __GL(h)->view = view;
+                for (; start < __GL(h)->count; start++) {
+                    if (filter_match(h, start)) {
+                        __GL(h)->view[__GL(h)->view_count++] = start;
+                    }
+                }
+            } else {
+                filter_items(h, 0, selected_entry(h));  /* Try again, filter is removed without memory */
+            }
+        }
         
         check_values(h);                            /* Check values */
         guii_widget_invalidate(h);                 /* Invalidate widget */
-        __GUI_LEAVE();                              /* Leave GUI */
-        
         ret = 1;
     }
     
+    __GUI_LEAVE();                                  /* Leave GUI */
     return ret;
 }
 
@@ -461,6 +648,10 @@ gui_listbox_setstring(gui_handle_p h, uint16_t index, const gui_char* text) {
     item = get_item(h, index);                      /* Get list item from handle */
     if (item) {
         item->text = (gui_char *)text;              /* Set new text */
+        if (__GL(h)->filter != NULL) {              /* Entry may match filter differently */
+            filter_items(h, 0, selected_entry(h));
+            check_values(h);
+        }
         guii_widget_invalidate(h);                 /* Invalidate widget */
     }
 
@@ -591,27 +782,31 @@ gui_listbox_setslidervisibility(gui_handle_p h, uint8_t visible) {
 uint8_t
 gui_listbox_scroll(gui_handle_p h, int16_t step) {
     volatile int16_t start;
+    gui_dim_t offset;
+    uint8_t flags;
     
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
+    guii_anim_stop(h, NULL);                        /* Stop kinetic scroll */
+    flags = __GL(h)->flags;
     start = __GL(h)->visiblestartindex;
+    offset = __GL(h)->visibleoffset;
     __GL(h)->visiblestartindex += step;
+    __GL(h)->visibleoffset = 0;
         
     check_values(h);                                /* Check widget values */
+    scroll_redraw(h, start, offset, flags);         /* Redraw changed part */
     
     start = start != __GL(h)->visiblestartindex;    /* Check if there was valid change */
     
-    if (start) {
-        guii_widget_invalidate(h);
-    }
-    
     __GUI_LEAVE();                                  /* Leave GUI */
     return start;
 }
 
 /**
  * \brief           Set selected value
+ * \note            When filter is set, selection is cleared if entry does not match it
  * \param[in,out]   h: Widget handle
  * \param[in]       selection: Set to -1 to invalidate selection or 0 - count-1 for specific selection 
  * \return          `1` on success, `0` otherwise
@@ -622,6 +817,11 @@ gui_listbox_setselection(gui_handle_p h, int16_t selection) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
+    if (__GL(h)->filter != NULL && selection >= 0) {/* Find entry in filtered entries */
+        int16_t i;
+        for (i = 0; i < __GL(h)->view_count && __GL(h)->view[i] != selection; i++) {}
+        selection = i < __GL(h)->view_count ? i : -1;
+    }
     set_selection(h, selection);                    /* Set selection */
     check_values(h);                                /* Check values */
     guii_widget_invalidate(h);                     /* Invalidate widget */
@@ -632,6 +832,7 @@ gui_listbox_setselection(gui_handle_p h, int16_t selection) {
 
 /**
  * \brief           Get selected value
+ * \note            Index of entry is returned also when filter is set
  * \param[in,out]   h: Widget handle
  * \return          Selection on success, -1 otherwise
  * \sa              gui_listbox_setselection
@@ -643,8 +844,89 @@ gui_listbox_getselection(gui_handle_p h) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
-    selection = __GL(h)->selected;                  /* Read selection */
+    selection = selected_entry(h);                  /* Read selection */
     
     __GUI_LEAVE();                                  /* Leave GUI */
     return selection;
 }
+
+/**
+ * \brief           Show only entries matching filter query
+ * \note            Entries are not modified, widget keeps array of matching entries and shows only them.
+ *                  When new query starts with previous one, for example when user types to edit text,
+ *                  only entries which matched previous query are checked again
+ * \note            Filter function must not match more entries when query is extended
+ * \param[in,out]   h: Widget handle
+ * \param[in]       query: Filter query, copy is saved to memory. Set to `NULL` or empty string to show all entries
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_listbox_setfilterfn
+ */
+uint8_t
+gui_listbox_setfilter(gui_handle_p h, const gui_char* query) {
+    uint8_t ret = 1;
+    int16_t sel;
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    sel = selected_entry(h);
+    if (query == NULL || !*query) {                 /* Remove filter */
+        if (__GL(h)->filter != NULL) {
+            GUI_MEMFREE(__GL(h)->filter);
+            GUI_MEMFREE(__GL(h)->view);
+            __GL(h)->selected = sel;
+        }
+    } else {
+        size_t len = gui_string_lengthtotal(query), old = 0;
+        uint8_t refine = 0;
+        gui_char* q;
+        
+        if (__GL(h)->filter != NULL) {              /* Is new query extension of previous one? */
+            old = gui_string_lengthtotal(__GL(h)->filter);
+            refine = old <= len && !memcmp(__GL(h)->filter, query, old * sizeof(*query));
+        }
+        if (!refine || old != len) {
+            GUI_MEM_TAGGED(GUI_MEM_TAG_LIST_FILTER, q = GUI_MEMREALLOC(__GL(h)->filter, (len + 1) * sizeof(*q)));
+            if (q != NULL) {
+                memcpy(q, query, (len + 1) * sizeof(*q));
+                __GL(h)->filter = q;
+                ret = filter_items(h, refine, sel); /* Build entries matching filter */
+            } else {
+                ret = 0;
+            }
+        }
+    }
+    guii_anim_stop(h, NULL);                        /* Stop kinetic scroll */
+    __GL(h)->visiblestartindex = 0;                 /* Show first matching entry */
+    __GL(h)->visibleoffset = 0;
+    check_values(h);                                /* Check values */
+    guii_widget_invalidate(h);                      /* Invalidate widget */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Set function to check entries against filter query
+ * \param[in,out]   h: Widget handle
+ * \param[in]       fn: Match function. Set to `NULL` to use \ref gui_string_contains
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_listbox_setfilter
+ */
+uint8_t
+gui_listbox_setfilterfn(gui_handle_p h, gui_string_match_fn fn) {
+    uint8_t ret = 1;
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    __GL(h)->filter_fn = fn;
+    if (__GL(h)->filter != NULL) {                  /* Check all entries with new function */
+        ret = filter_items(h, 0, selected_entry(h));
+        check_values(h);
+        guii_widget_invalidate(h);
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
@@ -35,6 +35,7 @@
 #define __GL(x)             ((gui_listview_t *)(x))
 
 static uint8_t gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
+static void update_view(gui_handle_p h);
 
 /**
  * \brief           List of default color in the same order of widget color enumeration
@@ -57,16 +58,164 @@ static const
 gui_widget_t widget = {
     .name = _GT("LISTVIEW"),                        /*!< Widget name */
     .size = sizeof(gui_listview_t),                 /*!< Size of widget for memory allocation */
-    .flags = 0,                                     /*!< List of widget flags */
+    .flags = GUI_FLAG_WIDGET_OPAQUE,                /*!< List of widget flags */
     .callback = gui_listview_callback,              /*!< Callback function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Define number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_TouchStart) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_TouchMove) | GUI_WC_MASK(GUI_WC_TouchEnd) |
+            GUI_WC_MASK(GUI_WC_Click) | GUI_WC_MASK(GUI_WC_KeyPress) |
+            GUI_WC_MASK(GUI_WC_IncSelection),
 };
 #define o                   ((gui_listview_t *)(h))
 
-/* Get item from LISTVIEW entry */
+#if GUI_CFG_MEM_STATIC
+static uint64_t row_mem_array[GUI_MEM_POOL_WORDS(sizeof(gui_listview_row_t), GUI_CFG_MEM_STATIC_LISTVIEW_ROWS)];
+static uint64_t item_mem_array[GUI_MEM_POOL_WORDS(sizeof(gui_listview_item_t), GUI_CFG_MEM_STATIC_LISTVIEW_ITEMS)];
+static gui_mem_static_t row_mem = GUI_MEM_STATIC_INIT(row_mem_array);
+static gui_mem_static_t item_mem = GUI_MEM_STATIC_INIT(item_mem_array);
+static gui_mem_pool_t row_pool = GUI_MEM_POOL_INIT_STATIC(sizeof(gui_listview_row_t), &row_mem);
+static gui_mem_pool_t item_pool = GUI_MEM_POOL_INIT_STATIC(sizeof(gui_listview_item_t), &item_mem);
+#else /* GUI_CFG_MEM_STATIC */
+static gui_mem_pool_t row_pool = GUI_MEM_POOL_INIT(sizeof(gui_listview_row_t));
+static gui_mem_pool_t item_pool = GUI_MEM_POOL_INIT(sizeof(gui_listview_item_t));
+#endif /* !GUI_CFG_MEM_STATIC */
+
+/* Get item pointer from row pointer and column index */
+static gui_listview_item_t *
+get_item_for_row(gui_handle_p h, gui_listview_row_t* row, uint8_t c) {
+    if (row == NULL) {                              /* Check input value if exists */
+        return NULL;
+    }
+    
+    return (gui_listview_item_t *)gui_linkedlist_getnext_byindex_gen(&row->root, c);/* Get item by index value = column number */
+}
+
+/* Parse decimal number at beginning of text for numeric sort */
+static float
+parse_number(const gui_char* str) {
+    float value = 0, div = 1;
+    uint8_t neg = 0, frac = 0;
+    
+    while (*str == ' ') {                           /* Ignore leading spaces */
+        str++;
+    }
+    if (*str == '-' || *str == '+') {
+        neg = *str++ == '-';
+    }
+    for (; (*str >= '0' && *str <= '9') || (*str == '.' && !frac); str++) {
+        if (*str == '.') {
+            frac = 1;
+        } else if (frac) {
+            div *= 10;
+            value += (float)(*str - '0') / div;
+        } else {
+            value = value * 10 + (float)(*str - '0');
+        }
+    }
+    return neg ? -value : value;
+}
+
+/* Compare 2 rows by sort column and mode */
+static int
+compare_rows(gui_handle_p h, gui_listview_row_t* a, gui_listview_row_t* b) {
+    gui_listview_item_t *ia, *ib;
+    const gui_char *ta = _GT(""), *tb = _GT("");
+    float fa, fb;
+    int res;
+    
+    ia = get_item_for_row(h, a, o->sort_col);
+    ib = get_item_for_row(h, b, o->sort_col);
+    if (ia != NULL && ia->text != NULL) {
+        ta = ia->text;
+    }
+    if (ib != NULL && ib->text != NULL) {
+        tb = ib->text;
+    }
+    switch (o->sort_mode) {
+        case GUI_LISTVIEW_SORT_NUMBER:
+            fa = parse_number(ta);
+            fb = parse_number(tb);
+            res = fa < fb ? -1 : fa > fb;
+            break;
+        case GUI_LISTVIEW_SORT_CUSTOM:
+            res = o->sort_fn(ta, tb);
+            break;
+        default:
+            res = gui_string_compare(ta, tb);
+            break;
+    }
+    return o->sort_desc ? -res : res;
+}
+
+/**
+ * \brief           Build sorted order of rows
+ * \note            Stable merge sort is used, rows with equal texts keep order from previous sort
+ * \param[in]       h: Widget handle
+ */
+static void
+sort_rows(gui_handle_p h) {
+    gui_listview_row_t **order, **tmp, **src, **dst, *row;
+    size_t cnt = (size_t)o->count, width, i, l, r, le, re, k;
+    uint8_t fill = o->order == NULL;
+    
+    if (!cnt || o->sort_mode == GUI_LISTVIEW_SORT_NONE) {
+        GUI_MEMFREE(o->order);                      /* Rows are shown in list order */
+        return;
+    }
+    
+    GUI_MEM_TAGGED(GUI_MEM_TAG_LISTVIEW_SORT, order = GUI_MEMREALLOC(o->order, cnt * sizeof(*order)));
+    GUI_MEM_TAGGED(GUI_MEM_TAG_LISTVIEW_SORT, tmp = order != NULL ? GUI_MEMALLOC(cnt * sizeof(*tmp)) : NULL);
+    if (tmp == NULL) {                              /* Show unsorted rows without memory */
+        if (order != NULL) {
+            o->order = order;
+        }
+        GUI_MEMFREE(o->order);
+        return;
+    }
+    
+    /* Start from previous order if exists to keep sort stable between columns */
+    if (fill) {
+        for (i = 0, row = (gui_listview_row_t *)gui_linkedlist_getnext_gen(&o->root, NULL); row != NULL && i < cnt;
+                row = (gui_listview_row_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)row), i++) {
+            order[i] = row;
+        }
+    }
+    
+    /* Bottom-up merge sort between both arrays */
+    src = order;
+    dst = tmp;
+    for (width = 1; width < cnt; width <<= 1) {
+        for (i = 0; i < cnt; i += width << 1) {
+            l = i;
+            le = GUI_MIN(i + width, cnt);
+            r = le;
+            re = GUI_MIN(i + (width << 1), cnt);
+            for (k = i; k < re; k++) {
+                if (l < le && (r >= re || compare_rows(h, src[l], src[r]) <= 0)) {
+                    dst[k] = src[l++];
+                } else {
+                    dst[k] = src[r++];
+                }
+            }
+        }
+        tmp = src;                                  /* Swap arrays */
+        src = dst;
+        dst = tmp;
+    }
+    if (src != order) {                             /* Result must be in order array */
+        memcpy(order, src, cnt * sizeof(*order));
+        tmp = src;
+    } else {
+        tmp = dst;
+    }
+    GUI_MEMFREE(tmp);
+    o->order = order;
+}
+
+/* Get row from linked list by index */
 static gui_listview_row_t*
-get_row(gui_handle_p h, uint16_t r) {
+list_row(gui_handle_p h, uint16_t r) {
     gui_listview_row_t* row = 0;
     
     if (r >= o->count) {                            /* Check if valid index */
@@ -78,27 +227,87 @@ get_row(gui_handle_p h, uint16_t r) {
     } else if (r == o->count - 1) {
         row = (gui_listview_row_t *)gui_linkedlist_getprev_gen(&o->root, 0);/* Get last element */
     } else {
-        row = (gui_listview_row_t *)gui_linkedlist_getnext_byindex_gen(&o->root, r);/* Get row by index */
+        row = (gui_listview_row_t *)gui_linkedlist_index_get(&o->root, &o->rows_index, r);/* Get row by index */
     }
     return row;
 }
 
-/* Get item pointer from row pointer and column index */
-static gui_listview_item_t *
-get_item_for_row(gui_handle_p h, gui_listview_row_t* row, uint8_t c) {
-    if (row == NULL) {                              /* Check input value if exists */
-        return NULL;
+/* Get number of rows shown in widget, only rows matching filter when it is set */
+static int16_t
+view_count(gui_handle_p h) {
+    return o->filter != NULL ? o->view_count : o->count;
+}
+
+/* Check if row matches filter query */
+static uint8_t
+filter_match(gui_handle_p h, gui_listview_row_t* row) {
+    gui_string_match_fn fn = o->filter_fn != NULL ? o->filter_fn : gui_string_contains;
+    gui_listview_item_t* item;
+    
+    if (o->filter_col >= 0) {                       /* Check only one column */
+        item = (gui_listview_item_t *)gui_linkedlist_getnext_byindex_gen(&row->root, (uint16_t)o->filter_col);
+        return fn(item != NULL && item->text != NULL ? item->text : _GT(""), o->filter);
+    }
+    for (item = (gui_listview_item_t *)gui_linkedlist_getnext_gen(&row->root, NULL); item != NULL;
+            item = (gui_listview_item_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)item)) {
+        if (fn(item->text != NULL ? item->text : _GT(""), o->filter)) {
+            return 1;                               /* Any column matches */
+        }
     }
+    return 0;
+}
+
+/**
+ * \brief           Build array of rows matching filter, in order rows are shown
+ * \param[in]       h: Widget handle
+ * \param[in]       refine: Set to `1` to check only rows which matched previous query
+ */
+static void
+filter_rows(gui_handle_p h, uint8_t refine) {
+    gui_listview_row_t **view, *row;
+    int16_t i, cnt = 0;
     
-    return (gui_listview_item_t *)gui_linkedlist_getnext_byindex_gen(&row->root, c);/* Get item by index value = column number */
+    if (refine && o->view != NULL) {                /* Rows can only be removed from view */
+        for (i = 0; i < o->view_count; i++) {
+            if (filter_match(h, o->view[i])) {
+                o->view[cnt++] = o->view[i];
+            }
+        }
+        o->view_count = cnt;
+        return;
+    }
+    
+    GUI_MEM_TAGGED(GUI_MEM_TAG_LIST_FILTER, view = GUI_MEMREALLOC(o->view, GUI_MAX(o->count, 1) * sizeof(*view)));
+    if (view == NULL) {                             /* Show all rows without memory */
+        GUI_MEMFREE(o->filter);
+        GUI_MEMFREE(o->view);
+        return;
+    }
+    o->view = view;
+    
+    if (o->order != NULL) {                         /* Keep sorted order */
+        for (i = 0; i < o->count; i++) {
+            if (filter_match(h, o->order[i])) {
+                view[cnt++] = o->order[i];
+            }
+        }
+    } else {
+        for (row = (gui_listview_row_t *)gui_linkedlist_getnext_gen(&o->root, NULL); row != NULL;
+                row = (gui_listview_row_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)row)) {
+            if (filter_match(h, row)) {
+                view[cnt++] = row;
+            }
+        }
+    }
+    o->view_count = cnt;
 }
 
 /* Get item height in LISTVIEW */
 static gui_dim_t
 item_height(gui_handle_p h, gui_dim_t* offset) {
-    gui_dim_t size = (float)h->font->size * 1.3f;
+    gui_dim_t size = (float)guii_widget_getfont(h)->size * 1.3f;
     if (offset != NULL) {                           /* Calculate top offset */
-        *offset = (size - h->font->size) >> 1;
+        *offset = (size - guii_widget_getfont(h)->size) >> 1;
     }
     return size;                                    /* Return height for element */
 }
@@ -107,46 +316,164 @@ item_height(gui_handle_p h, gui_dim_t* offset) {
 static int16_t
 nr_entries_pp(gui_handle_p h) {
     int16_t res = 0;
-    if (h->font != NULL) {                          /* Font is responsible for this setup */
+    if (guii_widget_getfont(h) != NULL) {                          /* Font is responsible for this setup */
         gui_dim_t height = item_height(h, 0);       /* Get item height */
         res = (guii_widget_getheight(h) - height) / height;
     }
     return res;
 }
 
+/* Get scroll position of visible rows in units of pixels */
+static int32_t
+get_scroll(gui_handle_p h) {
+    return (int32_t)o->visiblestartindex * item_height(h, NULL) + o->visibleoffset;
+}
+
+/* Get maximal scroll position in units of pixels, last row is aligned to bottom */
+static int32_t
+get_maxscroll(gui_handle_p h) {
+    update_view(h);
+    return (int32_t)GUI_MAX(view_count(h) - nr_entries_pp(h), 0) * item_height(h, NULL);
+}
+
+/* Redraw widget after visible rows changed, move already drawn rows when possible */
+static void
+scroll_redraw(gui_handle_p h, int16_t start, gui_dim_t offset, uint8_t flags) {
+    gui_dim_t itemheight = guii_widget_getfont(h) != NULL && flags == o->flags ? item_height(h, NULL) : 0;
+    
+    guii_widget_scrollrows(h, o->visiblestartindex - start, o->visibleoffset - offset, itemheight,
+        itemheight, o->flags & GUI_FLAG_LISTVIEW_SLIDER_ON ? o->sliderwidth : 0);   /* Header row stays */
+}
+
+/* Scroll visible rows to pixel position */
+static void
+set_scroll(gui_handle_p h, int32_t scroll) {
+    int16_t start = o->visiblestartindex;
+    gui_dim_t offset = o->visibleoffset;
+    gui_dim_t itemheight;
+    
+    if (guii_widget_getfont(h) == NULL) {
+        return;
+    }
+    itemheight = item_height(h, NULL);
+    scroll = GUI_MAX(GUI_MIN(scroll, get_maxscroll(h)), 0);
+    o->visiblestartindex = (int16_t)(scroll / itemheight);
+    o->visibleoffset = (gui_dim_t)(scroll % itemheight);
+    scroll_redraw(h, start, offset, o->flags);      /* Redraw changed part */
+}
+
+#if GUI_CFG_USE_TOUCH
+/* Animation callback for kinetic scroll */
+static void
+anim_exec(gui_handle_p h, int32_t value) {
+    set_scroll(h, value);
+}
+#endif /* GUI_CFG_USE_TOUCH */
+
 /* Slide up or slide down widget elements */
 static void
 slide(gui_handle_p h, int16_t dir) {
     int16_t mPP = nr_entries_pp(h);
+    int16_t start = o->visiblestartindex;
+    gui_dim_t offset = o->visibleoffset;
+    
+    o->visibleoffset = 0;                           /* Align to row */
     if (dir < 0) {                                  /* Slide elements up */
         if ((o->visiblestartindex + dir) < 0) {
             o->visiblestartindex = 0;
         } else {
             o->visiblestartindex += dir;
         }
-        guii_widget_invalidate(h);
     } else if (dir > 0) {
-        if ((o->visiblestartindex + dir) > (o->count - mPP - 1)) {  /* Slide elements down */
-            o->visiblestartindex = o->count - mPP;
+        if ((o->visiblestartindex + dir) > (view_count(h) - mPP - 1)) {  /* Slide elements down */
+            o->visiblestartindex = GUI_MAX(view_count(h) - mPP, 0);
         } else {
             o->visiblestartindex += dir;
         }
-        guii_widget_invalidate(h);
     }
+    scroll_redraw(h, start, offset, o->flags);      /* Redraw changed part */
 }
 
 /* Set selection for widget */
 static void
 set_selection(gui_handle_p h, int16_t selected) {
     if (o->selected != selected) {                  /* Set selected value */
+        guii_widget_statebegin(h);
         o->selected = selected;
+        guii_widget_stateend(h);
         guii_widget_callback(h, GUI_WC_SelectionChanged, NULL, NULL);  /* Notify about selection changed */
     }                         
 }
 
+/* Get row shown at index, also when view was not updated after rows changed */
+static gui_listview_row_t*
+shown_row(gui_handle_p h, uint16_t r) {
+    if (o->filter != NULL && o->view != NULL) {
+        return r < o->view_count ? o->view[r] : NULL;
+    } else if (o->order != NULL) {
+        return r < o->count ? o->order[r] : NULL;
+    }
+    return list_row(h, r);
+}
+
+/* Set selection to index where row is shown or clear it when row is not shown anymore */
+static void
+select_row(gui_handle_p h, gui_listview_row_t* sel) {
+    int16_t i, cnt = view_count(h);
+    
+    if (sel != NULL) {
+        for (i = 0; i < cnt && shown_row(h, i) != sel; i++) {}
+        if (i < cnt) {
+            guii_widget_statebegin(h);
+            o->selected = i;                        /* The same row is still selected */
+            guii_widget_stateend(h);
+        } else {
+            set_selection(h, -1);
+        }
+    }
+}
+
+/**
+ * \brief           Sort and filter rows again if they changed since last time
+ * \note            Selection follows selected row to its new position
+ * \param[in]       h: Widget handle
+ */
+static void
+update_view(gui_handle_p h) {
+    gui_listview_row_t* sel;
+    uint8_t sorted = 0;
+    
+    if (!(o->flags & (GUI_FLAG_LISTVIEW_SORT_DIRTY | GUI_FLAG_LISTVIEW_FILTER_DIRTY))) {
+        return;
+    }
+    sel = o->selected >= 0 ? shown_row(h, (uint16_t)o->selected) : NULL;   /* Pointer is only compared */
+    if (o->flags & GUI_FLAG_LISTVIEW_SORT_DIRTY) {
+        sort_rows(h);
+        sorted = 1;
+    }
+    if (o->filter != NULL && (sorted || (o->flags & GUI_FLAG_LISTVIEW_FILTER_DIRTY))) {
+        filter_rows(h, !sorted && (o->flags & GUI_FLAG_LISTVIEW_FILTER_REFINE));
+    }
+    select_row(h, sel);
+    
+    /* Cleared after selection follows its row, lock-free getter reads selection only when view is updated */
+    o->flags &= ~(GUI_FLAG_LISTVIEW_SORT_DIRTY | GUI_FLAG_LISTVIEW_FILTER_DIRTY | GUI_FLAG_LISTVIEW_FILTER_REFINE);
+}
+
+/* Get row shown at index */
+static gui_listview_row_t*
+get_row(gui_handle_p h, uint16_t r) {
+    update_view(h);                                 /* Sort and filter rows if needed */
+    if (r >= view_count(h)) {                       /* Check if valid index */
+        return NULL;
+    }
+    return shown_row(h, r);
+}
+
 /* Increase or decrease selection */
 static void
 inc_selection(gui_handle_p h, int16_t dir) {
+    update_view(h);
     if (dir < 0) {                                  /* Slide elements up */
         if ((o->selected + dir) < 0) {
             set_selection(h, 0);
@@ -155,8 +482,8 @@ inc_selection(gui_handle_p h, int16_t dir) {
         }
         guii_widget_invalidate(h);
     } else if (dir > 0) {
-        if ((o->selected + dir) > (o->count - 1)) { /* Slide elements down */
-            set_selection(h, o->count - 1);
+        if ((o->selected + dir) > (view_count(h) - 1)) { /* Slide elements down */
+            set_selection(h, view_count(h) - 1);
         } else {
             set_selection(h, o->selected + dir);
         }
@@ -170,22 +497,25 @@ check_values(gui_handle_p h) {
     int16_t mPP = nr_entries_pp(h);                 /* Get number of lines visible in widget at a time */
    
     if (o->selected >= 0) {                         /* Check for selected value range */
-        if (o->selected >= o->count) {
-            set_selection(h, o->count - 1);
+        if (o->selected >= view_count(h)) {
+            set_selection(h, view_count(h) - 1);
         }
     }
     if (o->visiblestartindex < 0) {                 /* Check visible start index position */
         o->visiblestartindex = 0;
     } else if (o->visiblestartindex > 0) {
-        if (o->count > mPP) {
-            if (o->visiblestartindex + mPP >= o->count) {
-                o->visiblestartindex = o->count - mPP;
+        if (view_count(h) > mPP) {
+            if (o->visiblestartindex + mPP >= view_count(h)) {
+                o->visiblestartindex = view_count(h) - mPP;
             }
         }
     }
+    if (o->visiblestartindex >= view_count(h) - mPP) {
+        o->visibleoffset = 0;                       /* No partial row at the end of range */
+    }
     
     if (o->flags & GUI_FLAG_LISTVIEW_SLIDER_AUTO) {  /* Check slider mode */
-        if (o->count > mPP) {
+        if (view_count(h) > mPP) {
             o->flags |= GUI_FLAG_LISTVIEW_SLIDER_ON;
         } else {
             o->flags &= ~GUI_FLAG_LISTVIEW_SLIDER_ON;
@@ -203,7 +533,7 @@ remove_row_items(gui_listview_row_t* row) {
     gui_listview_item_t* item;
     
     while ((item = (gui_listview_item_t *)gui_linkedlist_remove_gen(&row->root, (gui_linkedlist_t *)gui_linkedlist_getnext_gen(&row->root, NULL))) != NULL) {
-        GUI_MEMFREE(item);
+        gui_mem_pool_free(&item_pool, item);
     }
 }
 
@@ -218,9 +548,12 @@ remove_rows(gui_handle_p h) {
     /* Remove first row until any available */
     while ((row = (gui_listview_row_t *)gui_linkedlist_remove_gen(&o->root, (gui_linkedlist_t *)gui_linkedlist_getnext_gen(&o->root, NULL))) != NULL) {
         remove_row_items(row);              /* Remove row items */
-        GUI_MEMFREE(row);                   /* Remove actual row entry */
+        gui_mem_pool_free(&row_pool, row);  /* Remove actual row entry */
     }
     __GL(h)->count = 0;
+    __GL(h)->view_count = 0;                        /* Filter has no rows to show */
+    gui_linkedlist_index_invalidate(&__GL(h)->rows_index);
+    GUI_MEMFREE(__GL(h)->order);
 }
 
 /**
@@ -258,6 +591,7 @@ gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             width = guii_widget_getwidth(h);       /* Get widget width */
             height = guii_widget_getheight(h);     /* Get widget height */
             
+            update_view(h);                         /* Sort and filter rows if needed */
             check_values(h);                        /* Check values if size changed */
             
             if (is3D) {
@@ -281,7 +615,7 @@ gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                 sb.height = height - 2;
                 sb.dir = GUI_DRAW_SB_DIR_VERTICAL;
                 sb.entriestop = o->visiblestartindex;
-                sb.entriestotal = o->count;
+                sb.entriestotal = view_count(h);
                 sb.entriesvisible = nr_entries_pp(h);
                 
                 gui_draw_scrollbar(disp, &sb);      /* Draw scroll bar */
@@ -321,24 +655,61 @@ gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                     gui_draw_writetext(disp, guii_widget_getfont(h), o->cols[i]->text, &f);
                     xTmp += o->cols[i]->width;      /* Increase X value */
                 }
-                f.y += itemheight;                  /* Go to next line */
+                f.y += itemheight - o->visibleoffset;   /* Go to next line, first row may be partially scrolled out */
                 
-                /* Draw all rows and entry elements */           
-                if (h->font != NULL && gui_linkedlist_hasentries(&__GL(h)->root)) { /* Is first set? */
+                /* Draw only visible rows, cell strings are provided by user callback */
+                if (guii_widget_getfont(h) != NULL && o->data_fn != NULL) {
+                    int16_t index;
+                    const gui_char* text;
+                    gui_dim_t tmp, tmp1;
+                    
+                    tmp = disp->y2;                 /* Scale out drawing area */
+                    if (disp->y2 > (y + height - 2)) {
+                        disp->y2 = y + height - 2;
+                    }
+                    tmp1 = disp->y1;
+                    if (disp->y1 < (y + 2 + itemheight)) {  /* Rows must not overlap header */
+                        disp->y1 = y + 2 + itemheight;
+                    }
+                    for (index = o->visiblestartindex; index < o->count && f.y <= disp->y2; index++) {
+                        if (index == __GL(h)->selected) {
+                            gui_draw_filledrectangle(disp, x + 2, f.y, width - 2, GUI_MIN(f.height, itemheight), guii_widget_isfocused(h) ? guii_widget_getcolor(h, GUI_LISTVIEW_COLOR_SEL_FOC_BG) : guii_widget_getcolor(h, GUI_LISTVIEW_COLOR_SEL_NOFOC_BG));
+                            f.color1 = guii_widget_isfocused(h) ? guii_widget_getcolor(h, GUI_LISTVIEW_COLOR_SEL_FOC) : guii_widget_getcolor(h, GUI_LISTVIEW_COLOR_SEL_NOFOC);
+                        } else {
+                            f.color1 = guii_widget_getcolor(h, GUI_LISTVIEW_COLOR_TEXT);
+                        }
+                        xTmp = x + 2;
+                        for (i = 0; i < o->col_count; i++) {
+                            text = o->data_fn(h, (uint16_t)index, i);   /* Get cell text from user */
+                            if (text != NULL) {     /* Draw if text set */
+                                f.width = o->cols[i]->width - 6;    /* Set width */
+                                f.color1width = GUI.lcd.width;  /* Use the same color for entire width */
+                                f.x = xTmp + 3;     /* Set offset */
+                                gui_draw_writetext(disp, guii_widget_getfont(h), text, &f);
+                            }
+                            xTmp += o->cols[i]->width;  /* Increase X value */
+                        }
+                        f.y += itemheight;
+                    }
+                    disp->y2 = tmp;                 /* Set clipping region back */
+                    disp->y1 = tmp1;
+                } else if (guii_widget_getfont(h) != NULL && gui_linkedlist_hasentries(&__GL(h)->root)) { /* Is first set? */
                     uint16_t index = 0;             /* Start index */
-                    gui_dim_t tmp;
+                    gui_dim_t tmp, tmp1;
                     
                     tmp = disp->y2;                 /* Scale out drawing area */
                     if (disp->y2 > (y + height - 2)) {
                         disp->y2 = y + height - 2;
                     }
+                    tmp1 = disp->y1;
+                    if (disp->y1 < (y + 2 + itemheight)) {  /* Rows must not overlap header */
+                        disp->y1 = y + 2 + itemheight;
+                    }
                     
                     /* Try to process all strings */
-                    for (index = 0, row = (gui_listview_row_t *)gui_linkedlist_getnext_gen(&o->root, NULL); row != NULL && f.y <= disp->y2;
-                            row = (gui_listview_row_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)row), index++) {
-                        if (index < o->visiblestartindex) { /* Check for start visible */
-                            continue;
-                        }               
+                    index = o->visiblestartindex;   /* Start with first visible row */
+                    for (row = get_row(h, index); row != NULL && f.y <= disp->y2;
+                            row = o->order != NULL || o->filter != NULL ? get_row(h, ++index) : (index++, (gui_listview_row_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)row))) {
                         if (index == __GL(h)->selected) {
                             gui_draw_filledrectangle(disp, x + 2, f.y, width - 2, GUI_MIN(f.height, itemheight), guii_widget_isfocused(h) ? guii_widget_getcolor(h, GUI_LISTVIEW_COLOR_SEL_FOC_BG) : guii_widget_getcolor(h, GUI_LISTVIEW_COLOR_SEL_NOFOC_BG));
                             f.color1 = guii_widget_isfocused(h) ? guii_widget_getcolor(h, GUI_LISTVIEW_COLOR_SEL_FOC) : guii_widget_getcolor(h, GUI_LISTVIEW_COLOR_SEL_NOFOC);
@@ -359,6 +730,7 @@ gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                         f.y += itemheight;
                     }
                     disp->y2 = tmp;                 /* Set clipping region back */
+                    disp->y1 = tmp1;
                 }
                 disp->x2 = tmpX2;                   /* Reset to first value */
             }
@@ -369,6 +741,10 @@ gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             uint16_t i = 0;
             
             remove_rows(h);                         /* Remove all rows from widget */
+            gui_linkedlist_index_free(&o->rows_index);  /* Free rows index memory */
+            GUI_MEMFREE(o->order);                  /* Free sorted order of rows */
+            GUI_MEMFREE(o->view);                   /* Free rows matching filter */
+            GUI_MEMFREE(o->filter);
             
             /*
              * Remove all columns
@@ -387,22 +763,19 @@ gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             tx = ts->x_rel[0];                       /* Save X position */
             ty = ts->y_rel[0];                       /* Save Y position */
             
+            guii_anim_stop(h, anim_exec);           /* Touch stops kinetic scroll */
             GUI_WIDGET_RESULTTYPE_TOUCH(result) = touchHANDLED;
             return 1;
         }
         case GUI_WC_TouchMove: {
             guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
-            if (h->font != NULL) {
+            if (guii_widget_getfont(h) != NULL) {
                 gui_dim_t height = item_height(h, NULL);   /* Get element height */
                 gui_dim_t diff;
                 
-                diff = ty - ts->y_rel[0];            /* Check Y difference */
-                if (GUI_ABS(diff) > height) {       /* Difference must be greater than 1 height entry */
-                    slide(h, diff > 0 ? 1 : -1);    /* Slide widget */
-                    ty = ts->y_rel[0];               /* Save pointer */
-                }
-                
-                if (ty < height) {                  /* Check if we are in top region part */
+                if (ty >= height) {                 /* Rows follow finger */
+                    set_scroll(h, get_scroll(h) + ts->y_rel_old[0] - ts->y_rel[0]);
+                } else {                            /* Touch started in header, resize columns */
                     uint16_t i;
                     gui_dim_t sum = 0;
                     
@@ -424,6 +797,14 @@ gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
             }
             return 1;
         }
+#if GUI_CFG_TOUCH_HISTORY_SIZE
+        case GUI_WC_TouchEnd: {
+            if (guii_widget_getfont(h) != NULL && ty >= item_height(h, NULL)) {
+                guii_anim_fling(h, anim_exec, get_scroll(h), get_maxscroll(h), GUI_WIDGET_PARAMTYPE_TOUCH(param));
+            }
+            return 1;
+        }
+#endif /* GUI_CFG_TOUCH_HISTORY_SIZE */
 #endif /* GUI_CFG_USE_TOUCH */
         case GUI_WC_Click: {
             guii_touch_data_t* ts = GUI_WIDGET_PARAMTYPE_TOUCH(param);  /* Get touch data */
@@ -447,8 +828,9 @@ gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                 uint16_t tmpselected;
                 
                 if (ts->y_rel[0] > itemheight) {     /* Check item height */
-                    tmpselected = (ts->y_rel[0] - itemheight) / itemheight;  /* Get temporary selected index */
-                    if ((o->visiblestartindex + tmpselected) < o->count) {
+                    tmpselected = (ts->y_rel[0] - itemheight + o->visibleoffset) / itemheight;  /* Get temporary selected index */
+                    update_view(h);
+                    if ((o->visiblestartindex + tmpselected) < view_count(h)) {
                         set_selection(h, o->visiblestartindex + tmpselected);
                         guii_widget_invalidate(h); /* Choose new selection */
                     }
@@ -466,8 +848,12 @@ gui_listview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                         
                     sum += o->cols[i]->width;       /* Increase sum value */
                 }
-                if (i != o->col_count) {            /* We have value */
-                    //TODO: Sort rows on press
+                if (i != o->col_count && o->sort_mode != GUI_LISTVIEW_SORT_NONE && o->data_fn == NULL) {
+                    o->sort_desc = i == o->sort_col ? !o->sort_desc : 0;    /* Second press on column reverses order */
+                    o->sort_col = i;
+                    o->flags |= GUI_FLAG_LISTVIEW_SORT_DIRTY;
+                    update_view(h);                 /* Sort rows by pressed column */
+                    guii_widget_invalidate(h);
                 }
                 handled = 1;
             }
@@ -596,12 +982,30 @@ gui_listview_addrow(gui_handle_p h) {
     gui_listview_row_t* row;
     
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);   /* Check input parameters */
+    if (__GL(h)->data_fn != NULL) {                 /* Rows are not stored in virtual mode */
+        return NULL;
+    }
 
-    row = GUI_MEMALLOC(sizeof(*row));               /* Allocate memory for new row(s) */
+    GUI_MEM_TAGGED(GUI_MEM_TAG_LISTVIEW_ROW, row = gui_mem_pool_alloc(&row_pool));   /* Allocate memory for new row(s) */
     if (row != NULL) {
         __GUI_ENTER();                              /* Enter GUI */
         gui_linkedlist_add_gen(&__GL(h)->root, (gui_linkedlist_t *)row);/* Add new row to linked list */
+        gui_linkedlist_index_add(&__GL(h)->rows_index, (gui_linkedlist_t *)row);   /* Row is added to the end */
         __GL(h)->count++;                           /* Increase number of rows */
+        if (__GL(h)->order != NULL) {               /* Add row to sorted order, it is sorted before next drawing */
+            gui_listview_row_t** order;
+            GUI_MEM_TAGGED(GUI_MEM_TAG_LISTVIEW_SORT, order = GUI_MEMREALLOC(__GL(h)->order, __GL(h)->count * sizeof(*order)));
+            if (order != NULL) {
+                order[__GL(h)->count - 1] = row;
+                __GL(h)->order = order;
+            } else {
+                GUI_MEMFREE(__GL(h)->order);        /* Order is built from list again */
+            }
+            __GL(h)->flags |= GUI_FLAG_LISTVIEW_SORT_DIRTY;
+        }
+        if (__GL(h)->filter != NULL) {              /* Filter rows again before next drawing */
+            __GL(h)->flags |= GUI_FLAG_LISTVIEW_FILTER_DIRTY;
+        }
         check_values(h);                            /* Check values situation */
         __GUI_LEAVE();                              /* Leave GUI */
     }
@@ -622,8 +1026,24 @@ gui_listview_removerow(gui_handle_p h, gui_listview_row_p row) {
     __GUI_ENTER();                                  /* Enter GUI */
     
     gui_linkedlist_remove_gen(&__GL(h)->root, (gui_linkedlist_t *)row);
+    gui_linkedlist_index_invalidate(&__GL(h)->rows_index);
+    if (__GL(h)->order != NULL) {                   /* Remove row from sorted order, remaining rows stay sorted */
+        int16_t i;
+        for (i = 0; i < __GL(h)->count && __GL(h)->order[i] != row; i++) {}
+        if (i < __GL(h)->count) {
+            memmove(&__GL(h)->order[i], &__GL(h)->order[i + 1], (__GL(h)->count - i - 1) * sizeof(*__GL(h)->order));
+        }
+    }
+    if (__GL(h)->filter != NULL && __GL(h)->view != NULL) { /* Remove row from rows matching filter */
+        int16_t i;
+        for (i = 0; i < __GL(h)->view_count && __GL(h)->view[i] != row; i++) {}
+        if (i < __GL(h)->view_count) {
+            memmove(&__GL(h)->view[i], &__GL(h)->view[i + 1], (__GL(h)->view_count - i - 1) * sizeof(*__GL(h)->view));
+            __GL(h)->view_count--;
+        }
+    }
     remove_row_items(row);                          /* Remove row items */
-    GUI_MEMFREE(row);
+    gui_mem_pool_free(&row_pool, row);
     __GL(h)->count--;                               /* Decrease number of elements */
     check_values(h);
     
@@ -669,7 +1089,7 @@ gui_listview_setitemstring(gui_handle_p h, gui_listview_row_p row, uint16_t col,
     col++;
     while (col--) {                                 /* Find proper column */
         if (item == NULL) {
-            item = GUI_MEMALLOC(sizeof(*item));     /* Allocate for item */
+            GUI_MEM_TAGGED(GUI_MEM_TAG_LISTVIEW_ROW, item = gui_mem_pool_alloc(&item_pool));   /* Allocate for item */
             if (item == NULL) {
                 break;
             }
@@ -681,6 +1101,14 @@ gui_listview_setitemstring(gui_handle_p h, gui_listview_row_p row, uint16_t col,
     }
     if (item != NULL) {
         item->text = (gui_char *)text;              /* Set text to item */
+        if (__GL(h)->sort_mode != GUI_LISTVIEW_SORT_NONE) {
+            __GL(h)->flags |= GUI_FLAG_LISTVIEW_SORT_DIRTY; /* Row may have moved */
+            guii_widget_invalidate(h);
+        }
+        if (__GL(h)->filter != NULL) {
+            __GL(h)->flags |= GUI_FLAG_LISTVIEW_FILTER_DIRTY;   /* Row may match filter differently */
+            guii_widget_invalidate(h);
+        }
         ret = 1;
     }
 
@@ -753,19 +1181,23 @@ gui_listview_setslidervisibility(gui_handle_p h, uint8_t visible) {
 uint8_t
 gui_listview_scroll(gui_handle_p h, int16_t step) {
     volatile int16_t start;
+    gui_dim_t offset;
+    uint8_t flags;
     
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
+    guii_anim_stop(h, NULL);                        /* Stop kinetic scroll */
+    flags = __GL(h)->flags;
     start = __GL(h)->visiblestartindex;
+    offset = __GL(h)->visibleoffset;
     __GL(h)->visiblestartindex += step;
+    __GL(h)->visibleoffset = 0;
         
     check_values(h);                                /* Check widget values */
+    scroll_redraw(h, start, offset, flags);         /* Redraw changed part */
     
     start = start != __GL(h)->visiblestartindex;    /* Check if there was valid change */
-    if (start) {
-        guii_widget_invalidate(h);
-    }
     
     __GUI_LEAVE();                                  /* Leave GUI */
     return (uint8_t)start;
@@ -782,6 +1214,7 @@ gui_listview_setselection(gui_handle_p h, int16_t selection) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
+    update_view(h);                                 /* Index is position in shown rows */
     set_selection(h, selection);                    /* Set selection */
     check_values(h);                                /* Check values */
     guii_widget_invalidate(h);                     /* Invalidate widget */
@@ -798,10 +1231,20 @@ gui_listview_setselection(gui_handle_p h, int16_t selection) {
 int16_t
 gui_listview_getselection(gui_handle_p h) {
     int16_t selection;
+#if GUI_CFG_WIDGET_LOCKFREE_GET
+    uint8_t dirty;
+#endif /* GUI_CFG_WIDGET_LOCKFREE_GET */
     
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+#if GUI_CFG_WIDGET_LOCKFREE_GET
+    guii_widget_stateread(h, dirty = (__GL(h)->flags & (GUI_FLAG_LISTVIEW_SORT_DIRTY | GUI_FLAG_LISTVIEW_FILTER_DIRTY)) != 0; selection = __GL(h)->selected);
+    if (!dirty) {                                   /* Rows were not changed since last view update */
+        return selection;
+    }
+#endif /* GUI_CFG_WIDGET_LOCKFREE_GET */
     __GUI_ENTER();                                  /* Enter GUI */
     
+    update_view(h);                                 /* Selection follows sorted rows */
     selection = __GL(h)->selected;                  /* Read selection */
     
     __GUI_LEAVE();                                  /* Leave GUI */
@@ -826,8 +1269,15 @@ gui_listview_getitemvalue(gui_handle_p h, uint16_t rindex, uint16_t cindex, gui_
     __GUI_ENTER();                                  /* Enter GUI */
     
     *dst = 0;
-    row = (gui_listview_row_t *)get_row(h, rindex); /* Get row pointer */
-    if (row != NULL) {
+    if (__GL(h)->data_fn != NULL) {                 /* Get value from data provider */
+        if (rindex < __GL(h)->count && cindex < __GL(h)->col_count) {
+            const gui_char* text = __GL(h)->data_fn(h, rindex, cindex);
+            if (text != NULL) {
+                gui_string_copyn(dst, text, length - 1);    /* Copy text to destination */
+                ret = 1;
+            }
+        }
+    } else if ((row = (gui_listview_row_t *)get_row(h, rindex)) != NULL) {  /* Get row pointer */
         gui_listview_item_t* item = get_item_for_row(h, row, cindex);   /* Get item from column */
         if (item != NULL) {                         /* In case of valid index */
             gui_string_copyn(dst, item->text, length - 1);  /* Copy text to destination */
@@ -838,3 +1288,207 @@ gui_listview_getitemvalue(gui_handle_p h, uint16_t rindex, uint16_t cindex, gui_
     __GUI_LEAVE();                                  /* Leave GUI */
     return ret;
 }
+
+/**
+ * \brief           Set list view to virtual mode
+ * \note            In virtual mode, widget only knows number of rows and asks data provider
+ *                  for cell strings of visible rows when drawing.
+ *                  Functions to add or modify rows cannot be used in this mode
+ * \note            Rows previously added to widget are removed
+ * \param[in,out]   h: Widget handle
+ * \param[in]       data_fn: Data provider callback. Set to `NULL` to disable virtual mode
+ * \param[in]       count: Number of rows in list
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_listview_setrowcount
+ */
+uint8_t
+gui_listview_setvirtual(gui_handle_p h, gui_listview_data_fn data_fn, int16_t count) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && count >= 0);    /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    remove_rows(h);                                 /* Remove stored rows */
+    __GL(h)->data_fn = data_fn;
+    __GL(h)->count = data_fn != NULL ? count : 0;
+    check_values(h);                                /* Check values */
+    guii_widget_invalidate(h);                      /* Invalidate widget */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Set number of rows in virtual mode
+ * \param[in,out]   h: Widget handle
+ * \param[in]       count: New number of rows
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_listview_setvirtual
+ */
+uint8_t
+gui_listview_setrowcount(gui_handle_p h, int16_t count) {
+    uint8_t ret = 0;
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && count >= 0);    /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (__GL(h)->data_fn != NULL) {                 /* Only in virtual mode */
+        __GL(h)->count = count;
+        check_values(h);                            /* Check values */
+        guii_widget_invalidate(h);                  /* Invalidate widget */
+        ret = 1;
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Sort rows by column
+ * \note            Rows are not moved in memory. Widget keeps sorted order of rows and shows them in it.
+ *                  Rows added or modified later are sorted again once before widget is drawn.
+ *                  Row indexes of selection and \ref gui_listview_getitemvalue follow sorted order
+ * \note            When sort mode is set, pressing column header sorts rows by that column,
+ *                  pressing the same column again reverses order
+ * \note            Not available in virtual mode, data provider is responsible for order of rows.
+ *                  When filter is set, only matching rows are shown in sorted order
+ * \param[in,out]   h: Widget handle
+ * \param[in]       col: Column index to sort by
+ * \param[in]       mode: Sort mode. Use \ref GUI_LISTVIEW_SORT_NONE to show rows in order they were added
+ * \param[in]       descending: Set to `1` to sort in descending order, `0` for ascending
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_listview_setsortfn
+ */
+uint8_t
+gui_listview_sort(gui_handle_p h, uint16_t col, gui_listview_sort_t mode, uint8_t descending) {
+    uint8_t ret = 0;
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (__GL(h)->data_fn == NULL && (col < __GL(h)->col_count || mode == GUI_LISTVIEW_SORT_NONE)
+        && (mode != GUI_LISTVIEW_SORT_CUSTOM || __GL(h)->sort_fn != NULL)) {
+        __GL(h)->sort_col = col;
+        __GL(h)->sort_mode = (uint8_t)mode;
+        __GL(h)->sort_desc = !!descending;
+        __GL(h)->flags |= GUI_FLAG_LISTVIEW_SORT_DIRTY;
+        update_view(h);                             /* Build sorted order */
+        guii_widget_invalidate(h);                  /* Invalidate widget */
+        ret = 1;
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Set compare function for \ref GUI_LISTVIEW_SORT_CUSTOM sort mode
+ * \param[in,out]   h: Widget handle
+ * \param[in]       fn: Compare function
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_listview_sort
+ */
+uint8_t
+gui_listview_setsortfn(gui_handle_p h, gui_listview_cmp_fn fn) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    __GL(h)->sort_fn = fn;
+    if (__GL(h)->sort_mode == GUI_LISTVIEW_SORT_CUSTOM) {
+        if (fn == NULL) {                           /* Custom sort cannot work anymore */
+            __GL(h)->sort_mode = GUI_LISTVIEW_SORT_NONE;
+        }
+        __GL(h)->flags |= GUI_FLAG_LISTVIEW_SORT_DIRTY;
+        update_view(h);                             /* Sort rows again */
+        guii_widget_invalidate(h);                  /* Invalidate widget */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Show only rows matching filter query
+ * \note            Rows are not modified, widget keeps array of matching rows and shows only them.
+ *                  When new query starts with previous one for the same column, for example when user types
+ *                  to edit text, only rows which matched previous query are checked again
+ * \note            Row indexes of selection and \ref gui_listview_getitemvalue refer to shown rows only
+ * \note            Filter function must not match more rows when query is extended.
+ *                  Not available in virtual mode
+ * \param[in,out]   h: Widget handle
+ * \param[in]       col: Column index to check or `-1` to show rows where any column matches
+ * \param[in]       query: Filter query, copy is saved to memory. Set to `NULL` or empty string to show all rows
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_listview_setfilterfn
+ */
+uint8_t
+gui_listview_setfilter(gui_handle_p h, int16_t col, const gui_char* query) {
+    uint8_t ret = 0;
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && col >= -1);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (__GL(h)->data_fn == NULL) {
+        update_view(h);                             /* Apply pending changes first */
+        if (query == NULL || !*query) {             /* Remove filter */
+            if (__GL(h)->filter != NULL) {
+                gui_listview_row_t* sel = __GL(h)->selected >= 0 ? shown_row(h, (uint16_t)__GL(h)->selected) : NULL;
+                GUI_MEMFREE(__GL(h)->filter);
+                GUI_MEMFREE(__GL(h)->view);
+                select_row(h, sel);
+            }
+            ret = 1;
+        } else {
+            size_t len = gui_string_lengthtotal(query), old;
+            gui_char* q;
+            
+            if (__GL(h)->filter != NULL && __GL(h)->filter_col == col) {    /* Is new query extension of previous one? */
+                old = gui_string_lengthtotal(__GL(h)->filter);
+                if (old <= len && !memcmp(__GL(h)->filter, query, old * sizeof(*query))) {
+                    __GL(h)->flags |= GUI_FLAG_LISTVIEW_FILTER_REFINE;
+                }
+            }
+            GUI_MEM_TAGGED(GUI_MEM_TAG_LIST_FILTER, q = GUI_MEMREALLOC(__GL(h)->filter, (len + 1) * sizeof(*q)));
+            if (q != NULL) {
+                memcpy(q, query, (len + 1) * sizeof(*q));
+                __GL(h)->filter = q;
+                __GL(h)->filter_col = col;
+                __GL(h)->flags |= GUI_FLAG_LISTVIEW_FILTER_DIRTY;
+                update_view(h);                     /* Build rows matching filter */
+                ret = __GL(h)->filter != NULL;
+            }
+            __GL(h)->flags &= ~GUI_FLAG_LISTVIEW_FILTER_REFINE;
+        }
+        guii_anim_stop(h, NULL);                    /* Stop kinetic scroll */
+        __GL(h)->visiblestartindex = 0;             /* Show first matching row */
+        __GL(h)->visibleoffset = 0;
+        check_values(h);                            /* Check values */
+        guii_widget_invalidate(h);                  /* Invalidate widget */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+/**
+ * \brief           Set function to check rows against filter query
+ * \param[in,out]   h: Widget handle
+ * \param[in]       fn: Match function, called with text of each checked column.
+ *                      Set to `NULL` to use \ref gui_string_contains
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_listview_setfilter
+ */
+uint8_t
+gui_listview_setfilterfn(gui_handle_p h, gui_string_match_fn fn) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    __GL(h)->filter_fn = fn;
+    if (__GL(h)->filter != NULL) {                  /* Check all rows with new function */
+        __GL(h)->flags |= GUI_FLAG_LISTVIEW_FILTER_DIRTY;
+        update_view(h);
+        check_values(h);
+        guii_widget_invalidate(h);
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
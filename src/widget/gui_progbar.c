@@ -62,54 +62,74 @@ static const
 gui_widget_t widget = {
     .name = _GT("PROGBAR"),                         /*!< Widget name */
     .size = sizeof(gui_progbar_t),                  /*!< Size of widget for memory allocation */
-    .flags = 0,                                     /*!< List of widget flags */
+    .flags = GUI_FLAG_WIDGET_OPAQUE,                /*!< List of widget flags */
     .callback = gui_progbar_callback,               /*!< Callback function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE,                     /*!< Handled callback commands */
 };
 
 #define p           ((gui_progbar_t *)h)
 #define is_anim(h)  (!!(__GP(h)->flags & GUI_PROGBAR_FLAG_ANIMATE))
 
+#define ANIM_DURATION       300                     /*!< Time to animate progress change in units of milliseconds */
+
+/* Get width of active part for specific value */
+static gui_dim_t
+value_width(gui_handle_p h, int32_t value) {
+    return ((guii_widget_getwidth(h) - 4) * (value - p->min)) / (p->max - p->min);
+}
+
+/* Redraw only part of bar which changed from old value to current value */
+static void
+invalidate_value(gui_handle_p h, int32_t old) {
+    gui_dim_t wo, wn;
+    
+    /* Text crosses complete bar and changes color at the edge of active part */
+    if (guii_widget_getfont(h) != NULL && (p->flags & GUI_PROGBAR_FLAG_PERCENT || guii_widget_isfontandtextset(h))) {
+        guii_widget_invalidaterect(h, 2, 2, guii_widget_getwidth(h) - 4, guii_widget_getheight(h) - 4);
+        return;
+    }
+    wo = value_width(h, old);
+    wn = value_width(h, p->currentvalue);
+    if (wo != wn) {                                 /* Redraw only strip between old and new edge */
+        guii_widget_invalidaterect(h, 2 + GUI_MIN(wo, wn), 2, GUI_ABS(wn - wo), guii_widget_getheight(h) - 4);
+    }
+}
+
+/* Animation callback to set currently displayed value */
+static void
+anim_exec(gui_handle_p h, int32_t value) {
+    int32_t old = p->currentvalue;
+    p->currentvalue = value;
+    invalidate_value(h, old);                       /* Invalidate changed part */
+}
+
 /* Set value for widget */
 static uint8_t
 set_value(gui_handle_p h, int32_t val) {
+    int32_t old = p->currentvalue;
     if (p->desiredvalue != val && val >= p->min && val <= p->max) { /* Value has changed */
+        guii_widget_statebegin(h);
         p->desiredvalue = val;                      /* Set value */
+        guii_widget_stateend(h);
         if (p->currentvalue < p->min) {
             p->currentvalue = p->min;
         } else if (p->currentvalue > p->max) {
             p->currentvalue = p->max;
         }
-        if (is_anim(h) && h->timer != NULL) {       /* In case of animation and timer availability */
-            guii_timer_start(h->timer);             /* Start timer */
+        if (is_anim(h)) {                           /* Animate from currently displayed value */
+            guii_anim_start(h, anim_exec, p->currentvalue, p->desiredvalue, ANIM_DURATION, GUI_ANIM_EASE_OUT);
         } else {
             p->currentvalue = p->desiredvalue;      /* Set values to the same */
         }
-        guii_widget_invalidate(h);                  /* Redraw widget */
+        invalidate_value(h, old);                   /* Redraw changed part, animation redraws the rest */
         guii_widget_callback(h, GUI_WC_ValueChanged, NULL, NULL);  /* Process callback */
         return 1;
     }
     return 0;
 }
 
-/* Timer callback for widget */
-static void
-timer_callback(gui_timer_t* t) {
-    gui_handle_p h = guii_timer_getparams(t);       /* Get timer parameters */
-    if (h) {
-        if (p->currentvalue != p->desiredvalue) {   /* Check difference */
-            if (p->currentvalue > p->desiredvalue) {
-                p->currentvalue--;
-            } else {
-                p->currentvalue++;
-            }
-            guii_widget_invalidate(h);              /* Invalidate widget */
-            guii_timer_start(t);                    /* Start timer */
-        }
-    }
-}
-
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -162,18 +182,12 @@ gui_progbar_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, g
                     break;
                 case CFG_ANIM:
                     if (*(uint8_t *)v->data) {
-                        if (h->timer == NULL) {
-                            h->timer = guii_timer_create(10, timer_callback, h);    /* Create animation timer */
-                        }
-                        if (h->timer != NULL) { /* Check timer response */
-                            __GP(h)->flags |= GUI_PROGBAR_FLAG_ANIMATE; /* Enable animations */
-                        }
+                        __GP(h)->flags |= GUI_PROGBAR_FLAG_ANIMATE; /* Enable animations */
                     } else {
                         __GP(h)->flags &= ~GUI_PROGBAR_FLAG_ANIMATE;    /* Disable animation */
-                        if (h->timer != NULL) {
-                            guii_timer_remove(&h->timer);   /* Remove timer */
+                        if (guii_anim_stop(h, anim_exec)) { /* Stop running animation */
+                            anim_exec(h, p->desiredvalue);  /* Show final value */
                         }
-                        set_value(h, p->desiredvalue);  /* Reset value */
                     }
                     break;
                 default: break;
@@ -190,19 +204,22 @@ gui_progbar_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, g
             width = guii_widget_getwidth(h);        /* Get widget width */
             height = guii_widget_getheight(h);      /* Get widget height */
            
-            w = ((width - 4) * (p->currentvalue - p->min)) / (p->max - p->min); /* Get width for active part */
+            w = value_width(h, p->currentvalue);    /* Get width for active part */
             
             gui_draw_filledrectangle(disp, x + w + 2, y + 2, width - w - 4, height - 4, guii_widget_getcolor(h, GUI_PROGBAR_COLOR_BG));
             gui_draw_filledrectangle(disp, x + 2, y + 2, w, height - 4, guii_widget_getcolor(h, GUI_PROGBAR_COLOR_FG));
             gui_draw_rectangle3d(disp, x, y, width, height, GUI_DRAW_3D_State_Lowered);
             
             /* Draw text if possible */
-            if (h->font != NULL) {
+            if (guii_widget_getfont(h) != NULL) {
                 const gui_char* text = NULL;
                 gui_char buff[5];
+                size_t len;
                 
                 if (p->flags & GUI_PROGBAR_FLAG_PERCENT) {
-                    sprintf((char *)buff, "%lu%%", (unsigned long)(((p->currentvalue - p->min) * 100) / (p->max - p->min)));
+                    len = gui_string_fmt_int(buff, sizeof(buff) - 1, (int32_t)(((p->currentvalue - p->min) * 100) / (p->max - p->min)));
+                    buff[len] = '%';                /* Room for percent sign is kept */
+                    buff[len + 1] = 0;
                     text = buff;
                 } else if (guii_widget_isfontandtextset(h)) {
                     text = guii_widget_gettext(h);
@@ -270,7 +287,7 @@ gui_progbar_setcolor(gui_handle_p h, gui_progbar_color_t index, gui_color_t colo
 uint8_t
 gui_progbar_setvalue(gui_handle_p h, int32_t val) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_VALUE, &val, 1, 0); /* Set parameter */
+    return guii_widget_setparam(h, CFG_VALUE, &val, sizeof(val), 0, 0); /* Set parameter, changed part is invalidated by widget */
 }
 
 /**
@@ -283,7 +300,7 @@ gui_progbar_setvalue(gui_handle_p h, int32_t val) {
 uint8_t
 gui_progbar_setmin(gui_handle_p h, int32_t val) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MIN, &val, 1, 0);   /* Set parameter */
+    return guii_widget_setparam(h, CFG_MIN, &val, sizeof(val), 1, 0);   /* Set parameter */
 }
 
 /**
@@ -296,7 +313,7 @@ gui_progbar_setmin(gui_handle_p h, int32_t val) {
 uint8_t
 gui_progbar_setmax(gui_handle_p h, int32_t val) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MAX, &val, 1, 0);   /* Set parameter */
+    return guii_widget_setparam(h, CFG_MAX, &val, sizeof(val), 1, 0);   /* Set parameter */
 }
 
 /**
@@ -308,7 +325,7 @@ gui_progbar_setmax(gui_handle_p h, int32_t val) {
 uint8_t
 gui_progbar_setpercentmode(gui_handle_p h, uint8_t enable) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_PERCENT, &enable, 1, 0);    /* Set parameter */
+    return guii_widget_setparam(h, CFG_PERCENT, &enable, sizeof(enable), 1, 0);    /* Set parameter */
 }
 
 /**
@@ -320,7 +337,7 @@ gui_progbar_setpercentmode(gui_handle_p h, uint8_t enable) {
 uint8_t
 gui_progbar_setanimation(gui_handle_p h, uint8_t anim) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_ANIM, &anim, 1, 0); /* Set parameter */
+    return guii_widget_setparam(h, CFG_ANIM, &anim, sizeof(anim), 1, 0); /* Set parameter */
 }
 
 /**
@@ -369,10 +386,7 @@ int32_t
 gui_progbar_getvalue(gui_handle_p h) {
     int32_t val;
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    __GUI_ENTER();                                  /* Enter GUI */
-
-    val = __GP(h)->desiredvalue;                    /* Get current value */
     
-    __GUI_LEAVE();                                  /* Leave GUI */
+    guii_widget_stateread(h, val = __GP(h)->desiredvalue);  /* Get current value */
     return val;
 }
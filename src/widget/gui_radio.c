@@ -58,36 +58,83 @@ gui_widget_t widget = {
     .callback = gui_radio_callback,                 /*!< Callback function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_Click),/*!< Handled callback commands */
 };
 
+static gui_radio_group_t* groups;                  /*!< List of all radio groups */
+
+/**
+ * \brief           Get radio group with parent and group ID
+ * \note            Group is created when it does not exist yet
+ * \param[in]       parent: Parent widget of group members
+ * \param[in]       group_id: Group ID
+ * \return          Group on success, `NULL` otherwise
+ */
+static gui_radio_group_t*
+group_get(gui_handle_p parent, uint8_t group_id) {
+    gui_radio_group_t* g;
+    
+    for (g = groups; g != NULL; g = g->next) {
+        if (g->parent == parent && g->group_id == group_id) {
+            return g;
+        }
+    }
+    g = GUI_MEMALLOC(sizeof(*g));                   /* First radio of group */
+    if (g != NULL) {
+        memset(g, 0x00, sizeof(*g));
+        g->parent = parent;
+        g->group_id = group_id;
+        g->next = groups;
+        groups = g;
+    }
+    return g;
+}
+
+/**
+ * \brief           Remove radio from its group
+ * \note            Group is deleted with last member
+ * \param[in,out]   h: Widget handle
+ */
+static void
+group_leave(gui_handle_p h) {
+    gui_radio_group_t* g = __GR(h)->group;
+    gui_radio_group_t** prev;
+    
+    if (g == NULL) {
+        return;
+    }
+    __GR(h)->group = NULL;
+    __GR(h)->flags &= ~GUI_FLAG_RADIO_CHECKED;      /* Radio is checked only inside group */
+    if (g->checked == h) {
+        g->checked = NULL;
+    }
+    if (--g->members == 0) {
+        for (prev = &groups; *prev != g; prev = &(*prev)->next) {}
+        *prev = g->next;
+        GUI_MEMFREE(g);
+    }
+}
+
 static uint8_t
 set_active(gui_handle_p h) {
-    gui_handle_p handle;
+    gui_radio_group_t* g = __GR(h)->group;
     
     if (__GR(h)->flags & GUI_FLAG_RADIO_DISABLED) { /* Check if it can be enabled */
         return 0;
     }
     
-    /*
-     * Find radio widgets on the same page
-     * and with the same group ID as widget to be set as active
-     */
-    for (handle = gui_linkedlist_widgetgetnext((gui_handle_root_t *)guii_widget_getparent(h), NULL); handle != NULL; 
-            handle = gui_linkedlist_widgetgetnext(NULL, handle)) {
-        if (handle != h && handle->widget == &widget && __GR(handle)->group_id == __GR(h)->group_id) {  /* Check if widget is radio box and group is the same as clicked widget */
-            __GR(handle)->selected_value = __GR(h)->value;  /* Set selected value for widget */
-            if (__GR(handle)->flags & GUI_FLAG_RADIO_CHECKED) { /* Check if widget active */
-                __GR(handle)->flags &= ~GUI_FLAG_RADIO_CHECKED; /* Clear flag */
-                guii_widget_invalidate(handle);     /* Invalidate widget */
-            }
-        }
+    /* Only previously checked radio of group is changed */
+    if (g->checked != NULL && g->checked != h) {
+        __GR(g->checked)->flags &= ~GUI_FLAG_RADIO_CHECKED; /* Clear flag */
+        guii_widget_invalidate(g->checked);         /* Invalidate widget */
     }
     
     if (!(__GR(h)->flags & GUI_FLAG_RADIO_CHECKED)) {   /* Invalidate only if not checked already */
         guii_widget_invalidate(h);                  /* Invalidate widget */
     }
     __GR(h)->flags |= GUI_FLAG_RADIO_CHECKED;       /* Set active flag */
-    __GR(h)->selected_value = __GR(h)->value;       /* Set selected value of this radio */
+    g->checked = h;
+    g->selected_value = __GR(h)->value;             /* Set selected value of group */
     guii_widget_callback(h, GUI_WC_SelectionChanged, NULL, NULL);  /* Call user function */
     
     return 1;
@@ -120,10 +167,25 @@ static uint8_t
 gui_radio_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     switch (ctrl) {                                 /* Handle control function if required */
+        case GUI_WC_PreInit: {
+            gui_radio_group_t* g = group_get(guii_widget_getparent(h), 0);  /* All radios start in group 0 */
+            
+            if (g != NULL) {
+                g->members++;
+                __GR(h)->group = g;
+            }
+            GUI_WIDGET_RESULTTYPE_U8(result) = g != NULL;
+            return 1;
+        }
+        case GUI_WC_Remove: {
+            group_leave(h);
+            return 1;
+        }
         case GUI_WC_Draw: {
             gui_display_t* disp = GUI_WIDGET_PARAMTYPE_DISP(param);
             gui_color_t c1;
             gui_dim_t x, y, width, height, size, sx, sy;
+            uint32_t state;
             
             x = guii_widget_getabsolutex(h);       /* Get absolute X coordinate */
             y = guii_widget_getabsolutey(h);       /* Get absolute Y coordinate */
@@ -135,21 +197,36 @@ gui_radio_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
             sx = x;
             sy = y + (height - size) / 2;
             
-            if (__GR(h)->flags & GUI_FLAG_RADIO_DISABLED) {
-                c1 = guii_widget_getcolor(h, GUI_RADIO_COLOR_DISABLED_BG);
-            } else {
-                c1 = guii_widget_getcolor(h, GUI_RADIO_COLOR_BG);
+            state = __GR(h)->flags & (GUI_FLAG_RADIO_CHECKED | GUI_FLAG_RADIO_DISABLED);
+            if (guii_widget_isfocused(h) && !(__GR(h)->flags & GUI_FLAG_RADIO_DISABLED)) {
+                state |= 0x100;                     /* Focus circle is part of state */
             }
-            
-            gui_draw_filledcircle(disp, sx + size / 2, sy + size / 2, size / 2, c1);
-            gui_draw_circle(disp, sx + size / 2, sy + size / 2, size / 2, guii_widget_getcolor(h, GUI_RADIO_COLOR_BORDER));
-            
-            if (guii_widget_isfocused(h) && !(__GR(h)->flags & GUI_FLAG_RADIO_DISABLED)) {  /* When in focus */
-                gui_draw_circle(disp, sx + size / 2, sy + size / 2, size / 2 - 2, guii_widget_getcolor(h, GUI_RADIO_COLOR_FG));
-            }
-
-            if (__GR(h)->flags & GUI_FLAG_RADIO_CHECKED) {
-                gui_draw_filledcircle(disp, sx + size / 2, sy + size / 2, size / 2 - 5, guii_widget_getcolor(h, GUI_RADIO_COLOR_FG));
+#if GUI_CFG_WIDGET_STATE_CACHE
+            /* Circle with radius size / 2 covers size + 1 pixels */
+            if (!guii_widget_drawstate(h, sx, sy, size + 1, size + 1, size / 2, state, disp))
+#endif /* GUI_CFG_WIDGET_STATE_CACHE */
+            {
+                if (__GR(h)->flags & GUI_FLAG_RADIO_DISABLED) {
+                    c1 = guii_widget_getcolor(h, GUI_RADIO_COLOR_DISABLED_BG);
+                } else {
+                    c1 = guii_widget_getcolor(h, GUI_RADIO_COLOR_BG);
+                }
+                
+                gui_draw_filledcircle(disp, sx + size / 2, sy + size / 2, size / 2, c1);
+                gui_draw_circle(disp, sx + size / 2, sy + size / 2, size / 2, guii_widget_getcolor(h, GUI_RADIO_COLOR_BORDER));
+                
+                if (state & 0x100) {                /* When in focus */
+                    gui_draw_circle(disp, sx + size / 2, sy + size / 2, size / 2 - 2, guii_widget_getcolor(h, GUI_RADIO_COLOR_FG));
+                }
+                
+                if (__GR(h)->flags & GUI_FLAG_RADIO_CHECKED) {
+                    gui_draw_filledcircle(disp, sx + size / 2, sy + size / 2, size / 2 - 5, guii_widget_getcolor(h, GUI_RADIO_COLOR_FG));
+                }
+#if GUI_CFG_WIDGET_STATE_CACHE
+                if ((c1 >> 24) == 0xFF) {           /* Circle covers its pixels */
+                    guii_widget_savestate(h, sx, sy, size + 1, size + 1, state, disp);
+                }
+#endif /* GUI_CFG_WIDGET_STATE_CACHE */
             }
             
             /* Draw text if possible */
@@ -164,6 +241,7 @@ gui_radio_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui
                 f.align = GUI_HALIGN_LEFT | GUI_VALIGN_CENTER;
                 f.color1width = f.width;
                 f.color1 = guii_widget_getcolor(h, GUI_RADIO_COLOR_FG);
+                f.layout = &h->textlayout;          /* Reuse text layout between redraws */
                 gui_draw_writetext(disp, guii_widget_getfont(h), guii_widget_gettext(h), &f);
             }
             
@@ -216,7 +294,8 @@ gui_radio_setcolor(gui_handle_p h, gui_radio_color_t index, gui_color_t color) {
 
 /**
  * \brief           Set radio group for widget
- * \note            Radio widgets with the same group must be on the same parent widget
+ * \note            Radio widgets with the same group must be on the same parent widget.
+ *                  Widget is unchecked when it leaves its group
  * \param[in,out]   h: Widget handle
  * \param[in]       groupId: Group ID for widget
  * \return          `1` on success, `0` otherwise
@@ -224,32 +303,26 @@ gui_radio_setcolor(gui_handle_p h, gui_radio_color_t index, gui_color_t color) {
  */
 uint8_t
 gui_radio_setgroup(gui_handle_p h, uint8_t groupId) {
+    uint8_t ret = 1;
+    
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
-    if (__GR(h)->group_id != groupId) {
-        gui_handle_p handle;
+    if (__GR(h)->group->group_id != groupId) {
+        gui_radio_group_t* g = group_get(guii_widget_getparent(h), groupId);
         
-        /*
-         * Find radio widgets on the same parent 
-         * and with the group the same as desired group ID
-         *
-         * This is to set selected value to new radio with new group ID
-         */
-        for (handle = gui_linkedlist_widgetgetnext((gui_handle_root_t *)guii_widget_getparent(h), NULL); handle;
-                handle = gui_linkedlist_widgetgetnext(NULL, handle)) {
-            if (handle != h && __GH(handle)->widget == &widget && __GR(handle)->group_id == groupId) {  /* Check if widget is radio box and group is the same as input group */
-                __GR(h)->selected_value = __GR(handle)->selected_value;   /* Set selected value for widget */
-                break;          
-            }
+        if (g != NULL) {                            /* Selected value of new group applies to widget */
+            group_leave(h);
+            g->members++;
+            __GR(h)->group = g;
+            guii_widget_invalidate(h);              /* Invalidate widget */
+        } else {
+            ret = 0;
         }
-        
-        __GR(h)->group_id = groupId;                /* Set new group id */
-        guii_widget_invalidate(h);                  /* Invalidate widget */
     }
     
     __GUI_LEAVE();                                  /* Leave GUI */
-    return 1;
+    return ret;
 }
 
 /**
@@ -264,7 +337,7 @@ gui_radio_getgroup(gui_handle_p h) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
-    group = __GR(h)->group_id;
+    group = __GR(h)->group->group_id;
     
     __GUI_LEAVE();                                  /* Leave GUI */
     return group;
@@ -342,7 +415,7 @@ gui_radio_getselectedvalue(gui_handle_p h) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
     __GUI_ENTER();                                  /* Enter GUI */
     
-    val = __GR(h)->selected_value;
+    val = __GR(h)->group->selected_value;
     
     __GUI_LEAVE();                                  /* Leave GUI */
     return val;
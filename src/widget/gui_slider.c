@@ -63,6 +63,9 @@ gui_widget_t widget = {
     .callback = gui_slider_callback,                /*!< Callback function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Define number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_ActiveIn) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_ActiveOut) | GUI_WC_MASK(GUI_WC_TouchStart) |
+            GUI_WC_MASK(GUI_WC_TouchMove) | GUI_WC_MASK(GUI_WC_TouchEnd),
 };
 #define o       ((gui_slider_t *)(h))
 
@@ -84,7 +87,9 @@ set_value(gui_handle_p h, int32_t value) {
         value = o->Min;
     }
     if (value != o->Value) {                        /* Check difference in values */
+        guii_widget_statebegin(h);
         o->Value = value;                           /* Set new value */
+        guii_widget_stateend(h);
         guii_widget_callback(h, GUI_WC_ValueChanged, NULL, NULL);  /* Callback process */
         return 1;
     }
@@ -139,23 +144,20 @@ touch_handle(gui_handle_p h, guii_touch_data_t* ts) {
     return set_value(h, value);                     /* Set new value */
 }
 
-/* Timer callback function for slider widget */
+#define ANIM_DURATION       120                     /*!< Time to grow circle from 0 to maximal size in units of milliseconds */
+
+/* Animation callback for circle size */
 static void
-timer_callback(gui_timer_t* timer) {
-    gui_handle_p h = (gui_handle_p)guii_timer_getparams(timer); /* Get user parameters */
-    if (guii_widget_isactive(h)) {                  /* Timer is in focus */
-        if (__GS(h)->CurrentSize < __GS(h)->MaxSize) {
-            __GS(h)->CurrentSize++;                 /* Increase size */
-            guii_widget_invalidate(h);              /* Invalidate widget */
-        }
-    } else {
-        if (__GS(h)->CurrentSize > 0) {
-            __GS(h)->CurrentSize--;
-            guii_widget_invalidate(h);              /* Invalidate widget */
-        } else {
-            guii_timer_stop(timer);                 /* Stop timer execution */
-        }
-    }
+anim_exec(gui_handle_p h, int32_t value) {
+    __GS(h)->CurrentSize = (uint8_t)value;
+    guii_widget_invalidate(h);                      /* Invalidate widget */
+}
+
+/* Animate circle size to new value, duration is relative to size difference */
+static void
+anim_size(gui_handle_p h, uint8_t size) {
+    uint8_t diff = size > __GS(h)->CurrentSize ? size - __GS(h)->CurrentSize : __GS(h)->CurrentSize - size;
+    guii_anim_start(h, anim_exec, __GS(h)->CurrentSize, size, ANIM_DURATION * diff / __GS(h)->MaxSize, GUI_ANIM_EASE_OUT);
 }
 
 /**
@@ -177,10 +179,6 @@ gui_slider_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gu
             
             o->MaxSize = 4;
             o->CurrentSize = 0;
-            h->timer = guii_timer_create(30, timer_callback, o);    /* Create timer for widget, when widget is deleted, timer will be automatically deleted too */
-            if (h->timer == NULL) {                 /* Check if timer created */
-                GUI_WIDGET_RESULTTYPE_U8(result) = 0;   /* Failed, widget will be deleted */
-            }
             return 1;
         }
         case GUI_WC_SetParam: {                     /* Set parameter for widget */
@@ -293,10 +291,11 @@ gui_slider_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gu
             return 1;
 #endif /* GUI_CFG_USE_TOUCH */
         case GUI_WC_ActiveIn: {
-            guii_timer_startperiodic(h->timer);     /* Start animation timer */
+            anim_size(h, o->MaxSize);               /* Grow circle */
             return 1;
         }
         case GUI_WC_ActiveOut: {
+            anim_size(h, 0);                        /* Shrink circle */
             guii_widget_invalidate(h);              /* Invalidate widget */
             return 1;
         }
@@ -346,7 +345,7 @@ gui_slider_setcolor(gui_handle_p h, gui_slider_color_t index, gui_color_t color)
 uint8_t
 gui_slider_setmode(gui_handle_p h, gui_slider_mode_t mode) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MODE, &mode, 1, 0); /* Set parameter */
+    return guii_widget_setparam(h, CFG_MODE, &mode, sizeof(mode), 1, 0); /* Set parameter */
 }
 
 /**
@@ -359,7 +358,7 @@ gui_slider_setmode(gui_handle_p h, gui_slider_mode_t mode) {
 uint8_t
 gui_slider_setvalue(gui_handle_p h, int32_t val) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_VALUE, &val, 1, 0); /* Set parameter */
+    return guii_widget_setparam(h, CFG_VALUE, &val, sizeof(val), 1, 0); /* Set parameter */
 }
 
 /**
@@ -372,7 +371,7 @@ gui_slider_setvalue(gui_handle_p h, int32_t val) {
 uint8_t
 gui_slider_setmin(gui_handle_p h, int32_t val) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MIN, &val, 1, 0);   /* Set parameter */
+    return guii_widget_setparam(h, CFG_MIN, &val, sizeof(val), 1, 0);   /* Set parameter */
 }
 
 /**
@@ -385,7 +384,7 @@ gui_slider_setmin(gui_handle_p h, int32_t val) {
 uint8_t
 gui_slider_setmax(gui_handle_p h, int32_t val) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_MAX, &val, 1, 0);   /* Set parameter */
+    return guii_widget_setparam(h, CFG_MAX, &val, sizeof(val), 1, 0);   /* Set parameter */
 }
 
 /**
@@ -434,10 +433,7 @@ int32_t
 gui_slider_getvalue(gui_handle_p h) {
     int32_t val;
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    __GUI_ENTER();                                  /* Enter GUI */
-
-    val = __GS(h)->Value;                           /* Get current value */
     
-    __GUI_LEAVE();                                  /* Leave GUI */
+    guii_widget_stateread(h, val = __GS(h)->Value); /* Get current value */
     return val;
 }
@@ -36,6 +36,7 @@
 
 #define CFG_VALIGN          0x01
 #define CFG_HALIGN          0x02
+#define CFG_SCROLL          0x03
 
 static uint8_t gui_textview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gui_widget_result_t* result);
 
@@ -59,6 +60,8 @@ gui_widget_t widget = {
     .callback = gui_textview_callback,              /*!< Callback function */
     .colors = colors,                               /*!< List of default colors */
     .color_count = GUI_COUNT_OF(colors),            /*!< Define number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_Click) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_KeyPress),
 };
 #define o                   ((gui_textview_t *)(h))
 
@@ -82,6 +85,9 @@ gui_textview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                 case CFG_VALIGN: 
                     o->valign = *(gui_textalign_valign_t *)p->data;
                     break;
+                case CFG_SCROLL:
+                    o->scroll = *(uint32_t *)p->data;
+                    break;
                 default: break;
             }
             GUI_WIDGET_RESULTTYPE_U8(result) = 1;   /* Save result */
@@ -116,6 +122,15 @@ gui_textview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
                 f.flags |= GUI_FLAG_FONT_MULTILINE; /* Enable multiline */
                 f.color1width = f.width;
                 f.color1 = guii_widget_getcolor(h, GUI_TEXTVIEW_COLOR_TEXT);
+                f.layout = &h->textlayout;          /* Reuse text layout between redraws */
+                f.Scrolly = o->scroll;
+                if (h->textlayout != NULL && h->textlayout->rect_height > f.height) {
+                    if (f.Scrolly > (uint32_t)(h->textlayout->rect_height - f.height)) {
+                        f.Scrolly = h->textlayout->rect_height - f.height;  /* Limit scroll to end of text */
+                    }
+                } else if (h->textlayout != NULL) {
+                    f.Scrolly = 0;                  /* Complete text is visible */
+                }
                 gui_draw_writetext(disp, guii_widget_getfont(h), guii_widget_gettext(h), &f);
             }
             return 1;
@@ -124,6 +139,7 @@ gui_textview_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param,
         case GUI_WC_KeyPress: {
             guii_keyboard_data_t* kb = GUI_WIDGET_PARAMTYPE_KEYBOARD(param);    /* Get keyboard data */
             if (guii_widget_processtextkey(h, kb)) {
+                guii_widget_invalidate(h);         /* Redraw text */
                 GUI_WIDGET_RESULTTYPE_KEYBOARD(result) = keyHANDLED;
             }
             return 1;
@@ -188,7 +204,7 @@ gui_textview_setcolor(gui_handle_p h, gui_textview_color_t index, gui_color_t co
 uint8_t
 gui_textview_setvalign(gui_handle_p h, gui_textalign_valign_t align) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_VALIGN, &align, 1, 1);  /* Set parameter */
+    return guii_widget_setparam(h, CFG_VALIGN, &align, sizeof(align), 1, 1);  /* Set parameter */
 }
 
 /**
@@ -200,5 +216,40 @@ gui_textview_setvalign(gui_handle_p h, gui_textalign_valign_t align) {
 uint8_t
 gui_textview_sethalign(gui_handle_p h, gui_textalign_halign_t align) {
     __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
-    return guii_widget_setparam(h, CFG_HALIGN, &align, 1, 1);  /* Set parameter */
+    return guii_widget_setparam(h, CFG_HALIGN, &align, sizeof(align), 1, 1);  /* Set parameter */
+}
+
+/**
+ * \brief           Set vertical scroll of text inside text box
+ * \note            Scroll is limited to end of text when drawn. Long text is drawn from first visible line,
+ *                  lines above it are skipped without being measured again
+ * \param[in,out]   h: Widget handle
+ * \param[in]       scroll: Scroll from top of text in units of pixels
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_textview_setscroll(gui_handle_p h, uint32_t scroll) {
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    return guii_widget_setparam(h, CFG_SCROLL, &scroll, sizeof(scroll), 1, 1);  /* Set parameter */
+}
+
+/**
+ * \brief           Get maximal vertical scroll of text inside text box
+ * \note            Value is known after text has been drawn once with current text, font and widget size
+ * \param[in]       h: Widget handle
+ * \return          Maximal scroll in units of pixels
+ */
+uint32_t
+gui_textview_getscrollmax(gui_handle_p h) {
+    uint32_t ret = 0;
+    gui_dim_t hi;
+    
+    __GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    hi = guii_widget_getheight(h) - 2;              /* Text box height */
+    if (h->textlayout != NULL && h->textlayout->rect_height > hi) {
+        ret = h->textlayout->rect_height - hi;
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
 }
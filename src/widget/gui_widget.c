@@ -47,15 +47,526 @@ static gui_mbox_msg_t msg_widget_remove = { GUI_SYS_MBOX_TYPE_REMOVE };
 static gui_mbox_msg_t msg_widget_invalidate = { GUI_SYS_MBOX_TYPE_INVALIDATE };
 #endif /* GUI_CFG_OS */
 
+#if GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE
 /**
- * \brief           Remove widget from memory
+ * \brief           Widget parameter change posted from other thread
+ */
+typedef struct {
+    gui_handle_p h;                         /*!< Widget handle */
+    uint16_t cfg;                           /*!< Configuration to use */
+    uint8_t hasdata;                        /*!< Set to `1` when data are valid */
+    uint8_t invalidate;                     /*!< Invalidate widget after change */
+    uint8_t invalidateparent;               /*!< Invalidate widget and parent after change */
+    union {
+        uint8_t bytes[8];                   /*!< Raw data */
+        uint32_t u32;                       /*!< Member for alignment */
+        void* ptr;                          /*!< Member for alignment */
+    } data;                                 /*!< Copy of parameter value */
+} widget_post_t;
+
+static widget_post_t post_queue[GUI_CFG_WIDGET_POST_QUEUE_SIZE];    /* Ring buffer of posted changes */
+static size_t post_in, post_out;            /* Write and read indexes */
+static gui_mbox_msg_t msg_widget_post = { GUI_SYS_MBOX_TYPE_WIDGET_POST };
+#endif /* GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE */
+
+#if GUI_CFG_WIDGET_SAVE_UNDER
+/**
+ * \brief           Pixels saved below popup widget
+ */
+typedef struct {
+    gui_handle_p h;                         /*!< Popup widget, `NULL` when not used */
+    gui_display_t area;                     /*!< Saved area, absolute on screen */
+    uint8_t* data;                          /*!< Saved pixels as they are in display memory */
+    uint8_t format;                         /*!< Pixel format of saved pixels, member of \ref gui_pixel_format_t */
+    uint8_t valid;                          /*!< Set to `1` when pixels match content below popup */
+    uint8_t restore;                        /*!< Set to `1` when pixels are copied back on next redraw */
+} widget_under_t;
+
+static widget_under_t under;                /* Pixels below currently opened popup */
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
+
+#if GUI_CFG_MEM_POOL
+static gui_mem_pool_t widget_pools[GUI_CFG_MEM_POOL_WIDGET_SIZES];  /* Pools of widget handles by handle size */
+#if GUI_CFG_MEM_STATIC
+static uint64_t widget_mem_array[(GUI_CFG_MEM_STATIC_WIDGETS_SIZE + 7) / 8];
+static gui_mem_static_t widget_mem = GUI_MEM_STATIC_INIT(widget_mem_array);    /* Static memory shared by all widget pools */
+#endif /* GUI_CFG_MEM_STATIC */
+#endif /* GUI_CFG_MEM_POOL */
+
+#if GUI_CFG_WIDGET_TREE
+#define TREE_MAX_DEPTH                  8           /*!< Maximal nesting of widgets in tree description */
+
+/**
+ * \brief           Memory block with handles of all widgets of one tree
+ */
+typedef struct widget_tree {
+    struct widget_tree* next;               /*!< Next block on list */
+    uint8_t* end;                           /*!< End of memory for handles */
+    size_t count;                           /*!< Number of handles not freed yet */
+#if GUI_CFG_WIDGET_ARENA_SIZE
+    gui_handle_p owner;                     /*!< Window with widgets in arena, `NULL` for tree block */
+    uint8_t* ptr;                           /*!< Next free handle memory of arena */
+    void* free_list;                        /*!< Handles of removed widgets, see \ref widget_arena_free_t */
+#endif /* GUI_CFG_WIDGET_ARENA_SIZE */
+} widget_tree_t;
+
+#if GUI_CFG_WIDGET_ARENA_SIZE
+/**
+ * \brief           Memory of removed widget handle in arena
+ */
+typedef struct widget_arena_free {
+    struct widget_arena_free* next;         /*!< Next free handle */
+    size_t size;                            /*!< Size of handle in units of bytes */
+} widget_arena_free_t;
+#endif /* GUI_CFG_WIDGET_ARENA_SIZE */
+
+static widget_tree_t* trees;                /* Blocks of created trees */
+static struct {
+    widget_tree_t* tree;                    /*!< Block handles are allocated from, `NULL` when not creating tree */
+    uint8_t* ptr;                           /*!< Next free handle memory in block */
+    size_t measure;                         /*!< Total size of handles when measuring */
+    uint8_t measuring;                      /*!< Set to `1` when only sizes of handles are summed */
+} tree_alloc;
+#endif /* GUI_CFG_WIDGET_TREE */
+
+#if GUI_CFG_WIDGET_ARENA_SIZE || __DOXYGEN__
+
+/**
+ * \brief           Allocate widget handle from arena of window new widget is created in
+ * \param[in]       size: Size of widget handle in units of bytes
+ * \param[in]       parent: Parent widget of new widget
+ * \return          Pointer to handle memory set to zero on success, `NULL` otherwise
+ */
+static gui_handle_p
+arena_alloc(size_t size, gui_handle_p parent) {
+    widget_arena_free_t** f;
+    widget_tree_t* t;
+    uint8_t* ptr;
+    
+    size = GUI_MEM_ALIGN(size);
+    if (parent == NULL || parent->parent == NULL || size > GUI_CFG_WIDGET_ARENA_SIZE) {
+        return NULL;                                /* Widgets placed directly on desktop are windows itself */
+    }
+    for (; parent->parent->parent != NULL; parent = parent->parent) {}  /* Find window placed on desktop */
+    
+    for (t = trees; t != NULL && t->owner != parent; t = t->next) {}
+    if (t == NULL) {                                /* First widget in window */
+        GUI_MEM_TAGGED(GUI_MEM_TAG_WIDGET_ARENA,
+            t = GUI_MEMALLOC_HINT(GUI_MEM_ALIGN(sizeof(widget_tree_t)) + GUI_CFG_WIDGET_ARENA_SIZE, GUI_MEM_HOT));
+        if (t == NULL) {
+            return NULL;
+        }
+        t->owner = parent;
+        t->ptr = (uint8_t *)t + GUI_MEM_ALIGN(sizeof(widget_tree_t));
+        t->end = t->ptr + GUI_CFG_WIDGET_ARENA_SIZE;
+        t->next = trees;
+        trees = t;
+    }
+    
+    /* Removed widget of the same type leaves memory of exactly the same size */
+    for (f = (widget_arena_free_t **)&t->free_list; *f != NULL; f = &(*f)->next) {
+        if ((*f)->size == size) {
+            ptr = (uint8_t *)*f;
+            *f = (*f)->next;
+            memset(ptr, 0x00, size);
+            t->count++;
+            return (gui_handle_p)ptr;
+        }
+    }
+    if (t->ptr + size <= t->end) {
+        ptr = t->ptr;
+        t->ptr += size;                             /* Block is already set to zero */
+        t->count++;
+        return (gui_handle_p)ptr;
+    }
+    return NULL;                                    /* Arena is full */
+}
+
+/**
+ * \brief           Return widget handle to arena it was allocated from
+ * \param[in]       t: Arena block
  * \param[in]       h: Widget handle
- * \return          `1` on success, `0` otherwise
+ * \param[in]       size: Size of widget handle in units of bytes
+ */
+static void
+arena_free(widget_tree_t* t, gui_handle_p h, size_t size) {
+    widget_arena_free_t* f = (widget_arena_free_t *)h;
+    
+    size = GUI_MEM_ALIGN(size);
+    if ((uint8_t *)h + size == t->ptr) {            /* Last handle in arena, simply move end back */
+        t->ptr = (uint8_t *)h;
+    } else {
+        f->size = size;
+        f->next = t->free_list;
+        t->free_list = f;
+    }
+}
+
+#endif /* GUI_CFG_WIDGET_ARENA_SIZE || __DOXYGEN__ */
+
+/**
+ * \brief           Allocate memory for widget handle
+ * \note            Handles of the same size share pool
+ * \param[in]       size: Size of widget handle in units of bytes
+ * \param[in]       parent: Parent widget of new widget
+ * \return          Pointer to handle memory set to zero on success, `NULL` otherwise
+ */
+static gui_handle_p
+alloc_widget(size_t size, gui_handle_p parent) {
+#if GUI_CFG_MEM_POOL
+    size_t i;
+#endif /* GUI_CFG_MEM_POOL */
+#if GUI_CFG_WIDGET_ARENA_SIZE
+    gui_handle_p h;
+#endif /* GUI_CFG_WIDGET_ARENA_SIZE */
+    
+    GUI_UNUSED(parent);
+#if GUI_CFG_WIDGET_TREE
+    if (tree_alloc.measuring) {                     /* Nothing is created on first pass */
+        tree_alloc.measure += GUI_MEM_ALIGN(size);
+        return NULL;
+    }
+    if (tree_alloc.tree != NULL && tree_alloc.ptr + GUI_MEM_ALIGN(size) <= tree_alloc.tree->end) {
+        gui_handle_p h = (gui_handle_p)tree_alloc.ptr;
+        
+        tree_alloc.ptr += GUI_MEM_ALIGN(size);      /* Block is already set to zero */
+        tree_alloc.tree->count++;
+        return h;
+    }
+#endif /* GUI_CFG_WIDGET_TREE */
+#if GUI_CFG_WIDGET_ARENA_SIZE
+    if (tree_alloc.tree == NULL && (h = arena_alloc(size, parent)) != NULL) {
+        return h;
+    }
+#endif /* GUI_CFG_WIDGET_ARENA_SIZE */
+#if GUI_CFG_MEM_POOL
+    for (i = 0; i < GUI_COUNT_OF(widget_pools); i++) {
+        if (!widget_pools[i].size) {                /* First free pool, use it for new size */
+            widget_pools[i].size = size;
+#if GUI_CFG_MEM_STATIC
+            widget_pools[i].mem = &widget_mem;
+#endif /* GUI_CFG_MEM_STATIC */
+        }
+        if (widget_pools[i].size == size) {
+            return gui_mem_pool_alloc(&widget_pools[i]);
+        }
+    }
+#endif /* GUI_CFG_MEM_POOL */
+#if GUI_CFG_MEM_STATIC
+    return NULL;                                    /* No pool for this size, heap is not used */
+#else /* GUI_CFG_MEM_STATIC */
+    return GUI_MEMALLOC_HINT(size, GUI_MEM_HOT);    /* No pool for this size */
+#endif /* !GUI_CFG_MEM_STATIC */
+}
+
+/**
+ * \brief           Free memory of widget handle previously allocated with \ref alloc_widget
+ * \param[in]       h: Widget handle
+ * \param[in]       size: Size of widget handle in units of bytes
+ */
+static void
+free_widget(gui_handle_p h, size_t size) {
+#if GUI_CFG_MEM_POOL
+    size_t i;
+#endif /* GUI_CFG_MEM_POOL */
+#if GUI_CFG_WIDGET_TREE
+    widget_tree_t** t;
+    
+#if GUI_CFG_WIDGET_ARENA_SIZE
+    for (t = &trees; *t != NULL; t = &(*t)->next) {
+        if ((*t)->owner == h) {                     /* Window is removed, its arena is not used for new widgets */
+            (*t)->owner = NULL;
+        }
+    }
+#endif /* GUI_CFG_WIDGET_ARENA_SIZE */
+    for (t = &trees; *t != NULL; t = &(*t)->next) {
+        if ((uint8_t *)h > (uint8_t *)*t && (uint8_t *)h < (*t)->end) {
+            if (!--(*t)->count) {                   /* Last handle of tree, free complete block */
+                widget_tree_t* tmp = *t;
+                
+                *t = tmp->next;
+                GUI_MEMFREE(tmp);
+#if GUI_CFG_WIDGET_ARENA_SIZE
+            } else if ((*t)->ptr != NULL) {         /* Handle in arena of window */
+                arena_free(*t, h, size);
+#endif /* GUI_CFG_WIDGET_ARENA_SIZE */
+            }
+            return;
+        }
+    }
+#endif /* GUI_CFG_WIDGET_TREE */
+#if GUI_CFG_MEM_POOL
+    for (i = 0; i < GUI_COUNT_OF(widget_pools) && widget_pools[i].size; i++) {
+        if (widget_pools[i].size == size) {
+            gui_mem_pool_free(&widget_pools[i], h);
+            return;
+        }
+    }
+#endif /* GUI_CFG_MEM_POOL */
+    GUI_MEMFREE(h);
+}
+
+/**
+ * \brief           Remove widget from list of widgets waiting for invalidation
+ * \param[in]       h: Widget handle
+ */
+static void
+invalidate_list_remove(gui_handle_p h) {
+    size_t i;
+    
+    if (!guii_widget_getflag(h, GUI_FLAG_INVALIDATE_PENDING)) {
+        return;
+    }
+    guii_widget_clrflag(h, GUI_FLAG_INVALIDATE_PENDING);
+    for (i = 0; i < GUI.InvalidateListCount; i++) {
+        if (GUI.InvalidateList[i] == h) {
+            GUI.InvalidateList[i] = GUI.InvalidateList[--GUI.InvalidateListCount];
+            break;
+        }
+    }
+}
+
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE || __DOXYGEN__
+/**
+ * \brief           Remove all pending scroll operations of widget
+ * \param[in]       h: Widget handle
+ */
+static void
+scroll_list_remove(gui_handle_p h) {
+    size_t i;
+    
+    for (i = 0; i < GUI.ScrollCount; ) {
+        if (GUI.ScrollList[i].h == h) {
+            GUI.ScrollList[i] = GUI.ScrollList[--GUI.ScrollCount];
+        } else {
+            i++;
+        }
+    }
+}
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE || __DOXYGEN__ */
+
+#if GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE || __DOXYGEN__
+/**
+ * \brief           Remove all posted changes of widget
+ * \note            Called when widget is deleted to not apply changes to freed memory
+ * \param[in]       h: Widget handle
+ */
+static void
+post_purge(gui_handle_p h) {
+    size_t i;
+    
+    gui_sys_mutex_lock(&GUI.OS.post_mutex);
+    for (i = post_out; i != post_in; i = (i + 1) % GUI_COUNT_OF(post_queue)) {
+        if (post_queue[i].h == h) {
+            post_queue[i].h = NULL;                 /* Entry is skipped when processed */
+        }
+    }
+    gui_sys_mutex_unlock(&GUI.OS.post_mutex);
+}
+
+/**
+ * \brief           Put widget parameter change to queue
+ * \param[in]       h: Widget handle
+ * \param[in]       cfg: Configuration to use
+ * \param[in]       data: Parameter data to copy or `NULL`
+ * \param[in]       size: Size of parameter data in units of bytes
+ * \param[in]       invalidate: Flag if widget should be invalidated after change
+ * \param[in]       invalidateparent: Flag if parent widget should be invalidated after change
+ * \return          `1` on success, `0` when queue is full
  */
 static uint8_t
-remove_widget(gui_handle_p h) {
-    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+post_put(gui_handle_p h, uint16_t cfg, const void* data, size_t size, uint8_t invalidate, uint8_t invalidateparent) {
+    widget_post_t* p;
+    uint8_t ret = 0;
+    
+    gui_sys_mutex_lock(&GUI.OS.post_mutex);
+    if ((post_in + 1) % GUI_COUNT_OF(post_queue) != post_out) {
+        p = &post_queue[post_in];
+        p->h = h;
+        p->cfg = cfg;
+        p->hasdata = data != NULL;
+        p->invalidate = invalidate;
+        p->invalidateparent = invalidateparent;
+        if (data != NULL) {
+            memcpy(p->data.bytes, data, size);
+        }
+        post_in = (post_in + 1) % GUI_COUNT_OF(post_queue);
+        ret = 1;
+    }
+    gui_sys_mutex_unlock(&GUI.OS.post_mutex);
+    return ret;
+}
+#endif /* GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_ID_HASH_SIZE || __DOXYGEN__
+
+/**
+ * \brief           Get bucket of ID hash map for widget ID
+ * \param[in]       id: Widget ID
+ * \return          Bucket index in range of \ref GUI_CFG_WIDGET_ID_HASH_SIZE
+ * \hideinitializer
+ */
+#define ID_HASH(id)                 ((size_t)((uint32_t)(id) ^ ((uint32_t)(id) >> 8)) & (GUI_CFG_WIDGET_ID_HASH_SIZE - 1))
+
+/**
+ * \brief           Add widget to ID hash map
+ * \note            Widget is added to the end of bucket, so the oldest widget with the same ID is found first
+ * \param[in]       h: Widget handle
+ */
+static void
+id_hash_add(gui_handle_p h) {
+    gui_handle_p* p;
+    
+    for (p = &GUI.WidgetIdHash[ID_HASH(h->id)]; *p != NULL; p = &(*p)->id_next) {}
+    h->id_next = NULL;
+    *p = h;
+}
+
+/**
+ * \brief           Remove widget from ID hash map
+ * \param[in]       h: Widget handle
+ */
+static void
+id_hash_remove(gui_handle_p h) {
+    gui_handle_p* p;
+    
+    for (p = &GUI.WidgetIdHash[ID_HASH(h->id)]; *p != NULL; p = &(*p)->id_next) {
+        if (*p == h) {
+            *p = h->id_next;                        /* Unlink widget from bucket */
+            break;
+        }
+    }
+}
+
+#endif /* GUI_CFG_WIDGET_ID_HASH_SIZE || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_SAVE_UNDER
+/**
+ * \brief           Free pixels saved below popup widget
+ */
+static void
+under_free(void) {
+    if (under.data != NULL) {
+        guii_ll_waitready();                        /* Pixels may still be read by low-level */
+        GUI_MEMFREE(under.data);
+    }
+    if (under.h != NULL) {
+        guii_widget_clrflag(under.h, GUI_FLAG_SAVE_UNDER);
+    }
+    memset(&under, 0x00, sizeof(under));
+}
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
+
+/**
+ * \brief           Get next widget of subtree in tree order, parent before its children
+ * \note            Links of widgets are followed instead of recursion, walk needs no stack
+ *
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       root: Widget whose subtree is walked. Set to `NULL` for complete tree
+ * \param[in]       h: Current widget in subtree. Set to `NULL` to get first child of `root`
+ * \param[in]       children: Set to `1` to enter children of current widget or `0` to skip them
+ * \return          Next widget in subtree or `NULL` when subtree is done
+ */
+gui_handle_p
+guii_widget_treenext(gui_handle_p root, gui_handle_p h, uint8_t children) {
+    gui_handle_p next;
+    
+    if (h == NULL) {
+        return gui_linkedlist_widgetgetnext(__GHR(root), NULL);
+    }
+    if (children && guii_widget_allowchildren(h)) {
+        next = gui_linkedlist_widgetgetnext(__GHR(h), NULL);
+        if (next != NULL) {
+            return next;
+        }
+    }
+    for (; h != root; h = guii_widget_getparent(h)) {  /* Go up until any parent has next sibling */
+        next = gui_linkedlist_widgetgetnext(NULL, h);
+        if (next != NULL) {
+            return next;
+        }
+    }
+    return NULL;
+}
+
+#if GUI_CFG_WIDGET_STYLE
+/**
+ * \brief           Remove one reference of shared style and free it when not used anymore
+ * \param[in]       s: Style handle
+ */
+static void
+style_release(gui_style_t* s) {
+    if (!--s->ref_count) {
+        GUI_MEMFREE(s);
+    }
+}
+
+/**
+ * \brief           Redraw all widgets using shared style after it has changed
+ * \param[in]       parent: Parent widget to start with or `NULL` for top level
+ * \param[in]       s: Changed style
+ * \param[in]       geometry: Set to `1` when padding has changed
+ */
+static void
+style_update(gui_handle_p parent, gui_style_t* s, uint8_t geometry) {
+    gui_handle_p h;
     
+    for (h = guii_widget_treenext(parent, NULL, 1); h != NULL; h = guii_widget_treenext(parent, h, 1)) {
+        if (h->style == s) {
+            if (geometry) {                         /* Position of children has changed */
+                guii_widget_invalidatewithparent(h);
+            } else {
+                guii_widget_invalidate(h);
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Apply change of shared style to widgets
+ * \param[in]       s: Changed style
+ * \param[in]       geometry: Set to `1` when padding has changed
+ */
+static void
+style_changed(gui_style_t* s, uint8_t geometry) {
+    if (s->ref_count > 1) {                         /* Style is used by any widget */
+        if (geometry) {
+            guii_widget_geometrychanged();
+        }
+        gui_widget_batch_begin();                   /* Redraw all widgets with single region */
+        style_update(NULL, s, geometry);
+        gui_widget_batch_commit();
+    }
+}
+#endif /* GUI_CFG_WIDGET_STYLE */
+
+/**
+ * \brief           Remove widget from queue of widgets waiting to be removed
+ * \param[in]       h: Widget handle
+ */
+static void
+remove_queue_unlink(gui_handle_p h) {
+    gui_handle_p* p;
+    
+    for (p = &GUI.RemoveQueue; *p != NULL; p = &(*p)->remove_next) {
+        if (*p == h) {
+            *p = h->remove_next;                    /* Unlink widget from queue */
+            break;
+        }
+    }
+}
+
+/**
+ * \brief           Free widget memory and clear all references to it
+ * \note            Widget is not invalidated and not removed from linked list of parent
+ * \param[in]       h: Widget handle
+ */
+static void
+destroy_widget(gui_handle_p h) {
+#if GUI_CFG_TOUCH_POINTERS
+    size_t i;
+    
+#endif /* GUI_CFG_TOUCH_POINTERS */
     /*
      * Check and react on:
      *
@@ -84,99 +595,162 @@ remove_widget(gui_handle_p h) {
     if (GUI.WindowActive != NULL && h == GUI.WindowActive) {/* Check for parent window */
         GUI.WindowActive = guii_widget_getparent(GUI.WindowActive);
     }
+#if GUI_CFG_TOUCH_POINTERS
+    for (i = 0; i < GUI_COUNT_OF(GUI.TouchPointers); i++) {
+        if (GUI.TouchPointers[i].h == h) {          /* Pointer stays pressed without widget */
+            GUI.TouchPointers[i].h = NULL;
+        }
+        if (GUI.TouchPointers[i].prev == h) {
+            GUI.TouchPointers[i].prev = NULL;
+        }
+    }
+#endif /* GUI_CFG_TOUCH_POINTERS */
     
     /*
      * Final steps to remove widget are:
      * 
-     * - Invalidate widget and its parent,
-     *      make sure parent is redrawn on screen
      * - Free any possible memory used for text operation
-     * - Remove software timer if exists
+     * - Remove software timer and running animations if exist
      * - Remove custom colors
-     * - Remove widget from its linkedlist
      * - Free widget required memory
      */
-    guii_widget_invalidatewithparent(h);            /* Invalidate object and its parent */
     guii_widget_freetextmemory(h);                  /* Free text memory */
-    if (h->timer != NULL) {                         /* Check timer memory */
-        guii_timer_remove(&h->timer);               /* Free timer memory */
+    if (h->textlayout != NULL) {                    /* Check text layout memory */
+        GUI_MEMFREE(h->textlayout);                 /* Free cached text layout */
     }
-    if (h->colors != NULL) {                        /* Check colors memory */
-        GUI_MEMFREE(h->colors);                     /* Free colors memory */
-        h->colors = NULL;
+    if (h->ext != NULL && h->ext->retained != NULL) {   /* Check retained bitmap memory */
+        GUI_MEMFREE(h->ext->retained);              /* Free retained bitmap */
+    }
+#if GUI_CFG_WIDGET_SAVE_UNDER
+    if (under.h == h) {                             /* Popup is removed, its parent is redrawn */
+        under_free();
+    }
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
+#if GUI_CFG_USE_DISPLAY_LIST
+    if (h->ext != NULL && h->ext->dlist.data != NULL) { /* Check display list memory */
+        GUI_MEMFREE(h->ext->dlist.data);            /* Free recorded commands */
+    }
+#endif /* GUI_CFG_USE_DISPLAY_LIST */
+    guii_anim_stop(h, NULL);                        /* Stop all widget animations */
+    if (h->ext != NULL) {
+        if (h->ext->timer != NULL) {                /* Check timer memory */
+            guii_timer_remove(&h->ext->timer);      /* Free timer memory */
+        }
+        if (h->ext->colors != NULL) {               /* Check colors memory */
+            GUI_MEMFREE(h->ext->colors);            /* Free colors memory */
+        }
+        GUI_MEMFREE(h->ext);                        /* Free rarely used values */
+    }
+#if GUI_CFG_WIDGET_STYLE
+    if (h->style != NULL) {                         /* Release shared style */
+        style_release(h->style);
+        h->style = NULL;
+    }
+#endif /* GUI_CFG_WIDGET_STYLE */
+    invalidate_list_remove(h);                      /* Widget does not exist anymore */
+#if GUI_CFG_WIDGET_ID_HASH_SIZE
+    id_hash_remove(h);                              /* Widget cannot be found by ID anymore */
+#endif /* GUI_CFG_WIDGET_ID_HASH_SIZE */
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE
+    scroll_list_remove(h);
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE */
+#if GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE
+    post_purge(h);                                  /* Drop changes not yet applied */
+#endif /* GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE */
+#if GUI_CFG_BIND_COUNT
+    guii_bind_remove(h);                            /* Widget is not updated from value slot anymore */
+#endif /* GUI_CFG_BIND_COUNT */
+#if GUI_CFG_SCREEN_STACK
+    guii_screen_remove(h);                          /* Screen is removed from screen stack */
+#endif /* GUI_CFG_SCREEN_STACK */
+    if (guii_widget_getflag(h, GUI_FLAG_REMOVE)) {  /* Widget freed together with its parent */
+        remove_queue_unlink(h);
+    }
+    free_widget(h, h->widget->size);                /* Free memory for widget */
+}
+
+/**
+ * \brief           Free all children widgets of parent widget, including their children
+ * \note            Children are not invalidated and not unlinked one by one,
+ *                  complete list of each parent is dropped at once
+ * \note            Children are freed before their parent, without recursion
+ * \param[in]       parent: Parent widget handle
+ */
+static void
+destroy_children(gui_handle_p parent) {
+    gui_handle_p h, p, next;
+    
+    h = gui_linkedlist_widgetgetnext(__GHR(parent), NULL);
+    while (h != NULL) {
+        if (guii_widget_allowchildren(h)) {         /* Children first, they may refer to parent */
+            next = gui_linkedlist_widgetgetnext(__GHR(h), NULL);
+            if (next != NULL) {
+                h = next;
+                continue;
+            }
+        }
+        p = guii_widget_getparent(h);
+        next = gui_linkedlist_widgetgetnext(NULL, h);   /* Get next before memory is freed */
+        destroy_widget(h);
+        if (next == NULL) {                         /* Last child of parent was freed */
+            __GHR(p)->root_list.first = NULL;       /* List of parent is empty now */
+            __GHR(p)->root_list.last = NULL;
+            next = p != parent ? p : NULL;          /* Parent has no children anymore, free it too */
+        }
+        h = next;
+    }
+}
+
+/**
+ * \brief           Remove widget and all its children widgets from memory
+ * \note            Only area of removed widget and its parent is invalidated,
+ *                  children widgets are freed without invalidation
+ * \param[in]       h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+remove_widget(gui_handle_p h) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    
+    guii_widget_invalidatewithparent(h);            /* Invalidate object and its parent */
+    if (guii_widget_allowchildren(h)) {
+        destroy_children(h);                        /* Free complete subtree */
     }
     gui_linkedlist_widgetremove(h);                 /* Remove entry from linked list of parent widget */
-    GUI_MEMFREE(h);                                 /* Free memory for widget */
+    destroy_widget(h);
     
     return 1;                                       /* Widget deleted */
 }
 
 /**
- * \brief           Check and remove all widgets with delete flag enabled using recursion
+ * \brief           Remove all children widgets of parent widget immediately
+ * \note            Children which refuse to be removed with \ref GUI_WC_Remove stay in parent
+ *
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated.
+ *                  It must not be called while widget tree is being processed, such as from widget callbacks
  * \param[in]       parent: Parent widget handle
+ * \return          `1` on success, `0` otherwise
  */
-static void
-remove_widgets(gui_handle_p parent) {
+uint8_t
+guii_widget_removechildren(gui_handle_p parent) {
     gui_handle_p h, next;
-    static uint32_t lvl = 0;
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(parent) && guii_widget_allowchildren(parent));  /* Check valid parameter */
     
-    /*
-     * Scan all widgets in system
-     */
-    for (h = gui_linkedlist_widgetgetnext((gui_handle_root_t *)parent, NULL); h != NULL; ) {        
-        if (guii_widget_getflag(h, GUI_FLAG_REMOVE)) { /* Widget should be deleted */
-            next = gui_linkedlist_widgetgetnext(NULL, h);   /* Get next widget of current */
-            
-            /*
-             * Before we can actually delete widget,
-             * we have to check for its children widgets.
-             *
-             * In this case set remove flags to all children widgets
-             * and process with delete of all
-             *
-             * Steps to perform are:
-             *
-             * - Step 1: Set remove flag to all direct children widgets
-             * - Step 2: Perform mass erase of children widgets 
-             *      This step is recursive operation.
-             */
-            if (guii_widget_allowchildren(h)) {    /* Children widgets are supported */
-                gui_handle_p tmp;
-                
-                /* Step 1 */
-                for (tmp = gui_linkedlist_widgetgetnext((gui_handle_root_t *)h, NULL); tmp != NULL; 
-                        tmp = gui_linkedlist_widgetgetnext(NULL, tmp)) {
-                    guii_widget_setflag(tmp, GUI_FLAG_REMOVE); /* Set remove bit to all children elements */
-                }
-                
-                /* Step 2 */
-                lvl++;
-                remove_widgets(h);                  /* Remove children widgets directly */
-                lvl--;
-            }
-            
-            /*
-             * Removing widget will also remove linked list chain
-             * Therefore we have to save previous widget so we know next one
-             */
-            remove_widget(h);                       /* Remove widget itself */
-            
-            /*
-             * Move widget pointer to next widget of already deleted and continue checking
-             */
-            h = next;                               /* Set current pointer to next one */
-            continue;                               /* Continue to prevent further execution */
-        } else if (guii_widget_allowchildren(h)) { /* Children widgets are supported */
-            remove_widgets(h);                      /* Check children widgets if anything to remove */
+    for (h = gui_linkedlist_widgetgetnext(__GHR(parent), NULL); h != NULL;
+            h = gui_linkedlist_widgetgetnext(NULL, h)) {
+        guii_widget_remove(h);                      /* Mark children for remove */
+    }
+    for (h = gui_linkedlist_widgetgetnext(__GHR(parent), NULL); h != NULL; h = next) {
+        next = gui_linkedlist_widgetgetnext(NULL, h);   /* Get next widget of current */
+        if (guii_widget_getflag(h, GUI_FLAG_REMOVE)) {
+            remove_queue_unlink(h);                 /* Remove it now instead of later */
+            remove_widget(h);                       /* Remove widget with its children */
         }
-        h = gui_linkedlist_widgetgetnext(NULL, h);  /* Get next widget of current */
     }
-    
 #if GUI_CFG_OS
-    if (lvl == 0) {                                 /* Notify about remove execution */
-        gui_sys_mbox_putnow(&GUI.OS.mbox, &msg_widget_remove);
-    }
+    __GUI_WAKEUP(&msg_widget_remove);               /* Notify about remove execution */
 #endif /* GUI_CFG_OS */
+    return 1;
 }
 
 /**
@@ -228,125 +802,326 @@ get_lcd_abs_position_and_visible_width_height(gui_handle_p h, gui_dim_t* x1, gui
     return 1;
 }
 
+#define GEOMETRY_ABS_X              0x01
+#define GEOMETRY_ABS_Y              0x02
+#define GEOMETRY_WIDTH              0x04
+#define GEOMETRY_HEIGHT             0x08
+
 /**
- * \brief           Set clipping region for visible part of widget
+ * \brief           Check if cached geometry value of widget is still valid
+ * \note            Cache is reset when geometry generation has changed since last calculation
  * \param[in]       h: Widget handle
- * \return          `1` on success, `0` otherwise
+ * \param[in]       mask: Cached value bit to check
+ * \return          `1` when cached value can be used, `0` otherwise
  */
 static uint8_t
-set_clipping_region(gui_handle_p h) {
-    gui_dim_t x1, y1, x2, y2;
-    
-    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    
-    /* Get visible widget part and absolute position on screen according to parent */
-    get_lcd_abs_position_and_visible_width_height(h, &x1, &y1, &x2, &y2);
-    
-    /* TODO Get actual visible widget part according to other widgets above current one */
-    
-    /* Set invalid clipping region */
-    if (GUI.Display.x1 > x1)    { GUI.Display.x1 = x1; }
-    if (GUI.Display.x2 < x2)    { GUI.Display.x2 = x2; }
-    if (GUI.Display.y1 > y1)    { GUI.Display.y1 = y1; }
-    if (GUI.Display.y2 < y2)    { GUI.Display.y2 = y2; }
-    
-    return 1;
+geometry_isvalid(gui_handle_p h, uint8_t mask) {
+    if (h->geometry.gen != GUI.GeometryGen) {       /* Anything changed since values were cached? */
+        guii_widget_statebegin(h);
+        h->geometry.gen = GUI.GeometryGen;
+        h->geometry.valid = 0;
+        guii_widget_stateend(h);
+    }
+    return (h->geometry.valid & mask) ? 1 : 0;
+}
+
+#if GUI_CFG_WIDGET_LOCKFREE_GET || __DOXYGEN__
+/**
+ * \brief           Check if cached geometry value is valid without changing cache
+ * \note            Used by lock-free getters, cache is refreshed only by GUI protected code
+ * \param[in]       h: Widget handle
+ * \param[in]       mask: Cached value bit to check
+ * \return          `1` when cached value can be used, `0` otherwise
+ */
+static uint8_t
+geometry_iscached(gui_handle_p h, uint8_t mask) {
+    return h->geometry.gen == GUI.GeometryGen && (h->geometry.valid & mask) ? 1 : 0;
+}
+#endif /* GUI_CFG_WIDGET_LOCKFREE_GET || __DOXYGEN__ */
+
+/**
+ * \brief           Add rectangle to list of rectangles
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Rectangle is merged with existing one if merged area is not bigger than
+ *                  both areas drawn separately, or when there is no free slot anymore.
+ *                  In that case, merge with the smallest area increase is used
+ * \param[in,out]   list: List of rectangles
+ * \param[in,out]   cnt: Pointer to number of valid rectangles in list
+ * \param[in]       max: Maximal number of rectangles in list
+ * \param[in]       x1: Start X coordinate
+ * \param[in]       y1: Start Y coordinate
+ * \param[in]       x2: End X coordinate
+ * \param[in]       y2: End Y coordinate
+ */
+void
+guii_widget_addrect(gui_display_t* list, size_t* cnt, size_t max, gui_dim_t x1, gui_dim_t y1, gui_dim_t x2, gui_dim_t y2) {
+    gui_display_t* r;
+    size_t i, best;
+    int32_t cost, best_cost;
+    
+    if (x1 >= x2 || y1 >= y2) {                     /* Empty rectangle */
+        return;
+    }
+    
+    while (1) {
+        best = *cnt;
+        best_cost = 0x7FFFFFFF;
+        
+        /*
+         * Find rectangle where merge adds the least of area
+         * which was not covered by any of both rectangles
+         */
+        for (i = 0; i < *cnt; i++) {
+            r = &list[i];
+            cost = (int32_t)(GUI_MAX(x2, r->x2) - GUI_MIN(x1, r->x1)) * (int32_t)(GUI_MAX(y2, r->y2) - GUI_MIN(y1, r->y1));
+            cost -= (int32_t)(x2 - x1) * (int32_t)(y2 - y1);
+            cost -= (int32_t)(r->x2 - r->x1) * (int32_t)(r->y2 - r->y1);
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = i;
+            }
+        }
+        
+        /* Keep separate rectangle when merge is not worth and we have free slot */
+        if (best == *cnt || (best_cost > 0 && *cnt < max)) {
+            r = &list[(*cnt)++];
+            r->x1 = x1;
+            r->y1 = y1;
+            r->x2 = x2;
+            r->y2 = y2;
+            return;
+        }
+        
+        /*
+         * Merge with selected rectangle and remove it from list.
+         * Merged rectangle may now overlap others, try to insert it again
+         */
+        r = &list[best];
+        x1 = GUI_MIN(x1, r->x1);
+        y1 = GUI_MIN(y1, r->y1);
+        x2 = GUI_MAX(x2, r->x2);
+        y2 = GUI_MAX(y2, r->y2);
+        list[best] = list[--(*cnt)];
+    }
+}
+
+/**
+ * \brief           Set clipping region for visible part of widget
+ * \param[in]       h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+set_clipping_region(gui_handle_p h) {
+    gui_dim_t x1, y1, x2, y2;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    
+    /* Get visible widget part and absolute position on screen according to parent */
+    get_lcd_abs_position_and_visible_width_height(h, &x1, &y1, &x2, &y2);
+    
+    /* TODO Get actual visible widget part according to other widgets above current one */
+    
+    guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS, x1, y1, x2, y2);    /* Add region to list of invalid regions */
+    
+    return 1;
+}
+
+/**
+ * \brief           Set redraw flag on widget and mark all its parents to contain widget to redraw
+ * \note            Marking stops at first already marked parent, its parents are marked already.
+ *                  Redraw process follows marks and skips branches without widgets to redraw
+ * \param[in]       h: Widget handle
+ */
+static void
+set_redraw(gui_handle_p h) {
+    guii_widget_setflag(h, GUI_FLAG_REDRAW);
+    for (h = guii_widget_getparent(h); h != NULL && !guii_widget_getflag(h, GUI_FLAG_REDRAW_CHILDREN);
+        h = guii_widget_getparent(h)) {
+        guii_widget_setflag(h, GUI_FLAG_REDRAW_CHILDREN);
+    }
+}
+
+/**
+ * \brief           Update hidden parent flag of all children after visibility of widget has changed
+ * \note            Children with already correct state are not checked deeper, their subtree is valid
+ * \param[in]       parent: Widget with changed visibility
+ */
+static void
+visibility_update(gui_handle_p parent) {
+    gui_handle_p h, p;
+    uint8_t hidden, changed = 0;
+    
+    if (!guii_widget_allowchildren(parent)) {
+        return;
+    }
+    for (h = guii_widget_treenext(parent, NULL, 1); h != NULL; h = guii_widget_treenext(parent, h, changed)) {
+        p = guii_widget_getparent(h);
+        hidden = guii_widget_ishidden(p) || guii_widget_isparenthidden(p);
+        changed = guii_widget_isparenthidden(h) != hidden;
+        if (changed) {
+            if (hidden) {
+                guii_widget_setflag(h, GUI_FLAG_PARENT_HIDDEN);
+            } else {
+                guii_widget_clrflag(h, GUI_FLAG_PARENT_HIDDEN);
+            }
+        }
+    }
 }
 
 /**
  * \brief           Invalidate widget and set redraw flag
  * \note            If widget is transparent, parent must be updated too. This function will handle these cases.
+ *
+ * \note            Parents which must be invalidated with widget are processed in single loop from widget
+ *                  towards root, each of them at most once, without recursion
  * \param[in]       h: Widget handle
  * \param[in]       setclipping: When set to 1, clipping region will be expanded to widget size
  * \return          `1` on success, `0` otherwise
  */
 static uint8_t
 invalidate_widget(gui_handle_p h, uint8_t setclipping) {
-    gui_handle_p h1, h2;
-    gui_dim_t h1x1, h1x2, h2x1, h2x2;
-    gui_dim_t h1y1, h1y2, h2y1, h2y2;
+    gui_handle_p h1, h2, parent;
+    gui_dim_t x1, y1, x2, y2;
+    gui_display_t rects[GUI_CFG_DISPLAY_DIRTY_RECTS];
+    size_t rects_cnt, i;
+    uint8_t pending = 1, retained = 0;
+#if GUI_CFG_USE_TRANSPARENCY
+    uint8_t transparent = 0;
+#endif /* GUI_CFG_USE_TRANSPARENCY */
     
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-                                                    /* Get widget handle */
-    if (guii_widget_getflag(h, GUI_FLAG_IGNORE_INVALIDATE)) {   /* Check ignore flag */
-        return 0;                                   /* Ignore invalidate process */
-    }
     
     /*
-     * First check if any of parent widgets is hidden = ignore redraw
+     * Widget and its parents are processed in loop, from widget towards root.
+     * Parent is invalidated when it is transparent or not the last on its linked list,
+     * when it contains retained content and when it is first transparent parent of invalidated widget
      */
-    for (h1 = guii_widget_getparent(h); h1 != NULL;
-        h1 = guii_widget_getparent(h1)) {
-        if (guii_widget_ishidden(h1)) {
-            return 1;
+    for (h1 = h; h1 != NULL; h1 = parent) {
+        parent = guii_widget_getparent(h1);
+        
+        /* Content changed, retained widgets containing it must be drawn again completely */
+        if (retained && guii_widget_getflag(h1, GUI_FLAG_RETAINED_VALID)) {
+            guii_widget_clrflag(h1, GUI_FLAG_RETAINED_VALID);
+            pending = 1;
+            setclipping = 1;
         }
-    }
+#if GUI_CFG_USE_TRANSPARENCY
+        if (transparent && guii_widget_istransparent(h1)) { /* First transparent parent of invalidated widget */
+            transparent = 0;
+            pending = 1;
+        }
+#endif /* GUI_CFG_USE_TRANSPARENCY */
+        if (!pending) {
+            continue;
+        }
+        pending = 0;
         
-    h1 = h;                                         /* Save temporary */
-    guii_widget_setflag(h1, GUI_FLAG_REDRAW);       /* Redraw widget */
-    GUI.flags |= GUI_FLAG_REDRAW;                   /* Notify stack about redraw operations */
-    
-    if (setclipping) {
-        set_clipping_region(h);                     /* Set clipping region for widget redrawing operation */
-    }
-    
-    /*
-     * Invalid only widget with higher Z-index (lowered on linked list) of current object
-     * 
-     * If widget should be redrawn, then any widget above it should be redrawn too, otherwise z-index match will fail.
-     *
-     * Widget may not need redraw operation if positions don't match
-     *
-     * If widget is transparent, check all widgets, even those which are below current widget in list
-     * Get first element of parent linked list for checking
-     */
+        if (guii_widget_getflag(h1, GUI_FLAG_IGNORE_INVALIDATE)) {  /* Check ignore flag */
+            if (h1 == h) {
+                return 0;                           /* Ignore invalidate process */
+            }
+            setclipping = 0;
+            continue;
+        }
+        
+        /*
+         * First check if any of parent widgets is hidden = ignore redraw
+         */
+        if (guii_widget_isparenthidden(h1)) {
+#if GUI_CFG_SCREEN_STACK
+            if (setclipping) {
+                guii_screen_invalidated(h1);        /* Cached screen must redraw changed area */
+            }
+#endif /* GUI_CFG_SCREEN_STACK */
+            if (h1 == h) {
+                return 1;
+            }
+            setclipping = 0;
+            continue;
+        }
+#if GUI_CFG_SCREEN_STACK
+        if (setclipping && guii_widget_getflag(h1, GUI_FLAG_HIDDEN)) {
+            guii_screen_invalidated(h1);            /* Content of hidden screen itself has changed */
+        }
+#endif /* GUI_CFG_SCREEN_STACK */
+        
+        set_redraw(h1);                             /* Redraw widget */
+        GUI.flags |= GUI_FLAG_REDRAW;               /* Notify stack about redraw operations */
+        
+        if (setclipping) {
+            set_clipping_region(h1);                /* Set clipping region for widget redrawing operation */
+            guii_widget_clrflag(h1, GUI_FLAG_DISPLAY_LIST_VALID);   /* Widget content changed, record it again */
+#if GUI_CFG_WIDGET_SAVE_UNDER
+            /* Content below popup changed, saved pixels are not valid anymore */
+            if (under.valid && !under.restore && h1 != under.h) {
+                get_lcd_abs_position_and_visible_width_height(h1, &x1, &y1, &x2, &y2);
+                if (x1 < under.area.x2 && x2 > under.area.x1 && y1 < under.area.y2 && y2 > under.area.y1) {
+                    under.valid = 0;
+                }
+            }
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
+            if (guii_widget_getflag(h1, GUI_FLAG_RETAINED_BLEND)) {
+                guii_widget_clrflag(h1, GUI_FLAG_RETAINED_BLEND);   /* Only transparency changed, bitmap stays valid */
+            } else {
+                guii_widget_clrflag(h1, GUI_FLAG_RETAINED_VALID);
+            }
+            retained = 1;                           /* Check retained parents */
+            setclipping = 0;                        /* Parents are invalidated without clipping */
+        }
+        
+        /*
+         * Invalid only widget with higher Z-index (lowered on linked list) of current object
+         * 
+         * If widget should be redrawn, then any widget above it should be redrawn too, otherwise z-index match will fail.
+         *
+         * Widget may not need redraw operation if positions don't match
+         *
+         * If widget is transparent, check all widgets, even those which are below current widget in list
+         * Get first element of parent linked list for checking
+         */
 #if GUI_CFG_USE_TRANSPARENCY
-    if (guii_widget_istransparent(h1)) {
-        invalidate_widget(guii_widget_getparent(h1), 0);    /* Invalidate parent widget */
-    }
+        if (guii_widget_istransparent(h1)) {
+            pending = 1;                            /* Invalidate parent widget */
+        }
 #endif /* GUI_CFG_USE_TRANSPARENCY */
-    for (; h1 != NULL; h1 = gui_linkedlist_widgetgetnext(NULL, h1)) {
-        get_lcd_abs_position_and_visible_width_height(h1, &h1x1, &h1y1, &h1x2, &h1y2); /* Get visible position on LCD for widget */
-        for (h2 = gui_linkedlist_widgetgetnext(NULL, h1); h2;
+        /*
+         * Keep list of areas which will be redrawn on current level.
+         * Every next widget overlapping any of them must be redrawn too and its area is added to list
+         */
+        rects_cnt = 0;
+        get_lcd_abs_position_and_visible_width_height(h1, &x1, &y1, &x2, &y2);
+        guii_widget_addrect(rects, &rects_cnt, GUI_COUNT_OF(rects), x1, y1, x2 + 1, y2 + 1);
+        for (h2 = gui_linkedlist_widgetgetnext(NULL, h1); h2 != NULL;
                 h2 = gui_linkedlist_widgetgetnext(NULL, h2)) {
-            get_lcd_abs_position_and_visible_width_height(h2, &h2x1, &h2y1, &h2x2, &h2y2);
-            if (
-                guii_widget_getflag(h2, GUI_FLAG_REDRAW) ||    /* Flag is already set */
-                !__GUI_RECT_MATCH(                  /* Widgets are not one over another */
-                    h1x1, h1y1, h1x2, h1y2,
-                    h2x1, h2y1, h2x2, h2y2)
-            ) {
-                continue;
+            get_lcd_abs_position_and_visible_width_height(h2, &x1, &y1, &x2, &y2);
+            if (!guii_widget_getflag(h2, GUI_FLAG_REDRAW)) {
+                for (i = 0; i < rects_cnt; i++) {
+                    if (__GUI_RECT_MATCH(           /* Widgets are one over another */
+                        rects[i].x1, rects[i].y1, rects[i].x2 - 1, rects[i].y2 - 1,
+                        x1, y1, x2, y2)) {
+                        break;
+                    }
+                }
+                if (i == rects_cnt) {               /* No overlap with area to redraw */
+                    continue;
+                }
+                set_redraw(h2);                     /* Redraw widget on next loop */
             }
-            guii_widget_setflag(h2, GUI_FLAG_REDRAW);  /* Redraw widget on next loop */
-        }
-    }
-    
-    /*
-     * If widget is not the last on the linked list (top z-index)
-     * check status of parent widget if it is last.
-     * If it is not, process parent redraw and check similar parent widgets if are over our widget
-     */
-    if (guii_widget_hasparent(h)) {
-        gui_handle_p ph = guii_widget_getparent(h);
-        if (!gui_linkedlist_iswidgetlast(ph)) {
-            invalidate_widget(guii_widget_getparent(h), 0);
+            guii_widget_addrect(rects, &rects_cnt, GUI_COUNT_OF(rects), x1, y1, x2 + 1, y2 + 1);
         }
-    }
-
-#if GUI_CFG_USE_TRANSPARENCY    
-    /*
-     * Check if any of parent widgets has transparency = should be invalidated too
-     *
-     * Since recursion is used, call function only once and recursion will take care for upper level of parent widgets
-     */
-    for (h = guii_widget_getparent(h); h != NULL; h = guii_widget_getparent(h)) {
-        if (guii_widget_istransparent(h)) {        /* If widget is transparent */
-            invalidate_widget(h, 0);                /* Invalidate this parent too */
-            break;
+        
+        /*
+         * If widget is not the last on the linked list (top z-index)
+         * check status of parent widget if it is last.
+         * If it is not, process parent redraw and check similar parent widgets if are over our widget
+         */
+        if (parent != NULL && !gui_linkedlist_iswidgetlast(parent)) {
+            pending = 1;
         }
-    }
+#if GUI_CFG_USE_TRANSPARENCY
+        transparent = 1;                            /* First transparent parent is invalidated too */
 #endif /* GUI_CFG_USE_TRANSPARENCY */
+    }
     
     return 1;
 }
@@ -356,21 +1131,27 @@ invalidate_widget(gui_handle_p h, uint8_t setclipping) {
  * \param[in]       parent: Parent widget handle. Set to NULL to use root
  * \param[in]       id: Widget id we are searching for in parent
  * \param[in]       deep: Flag if searchi should go deeper to check for widget on parent tree
+ * \note            Complete tree search from root is done with ID hash map when enabled
  * \return          Widget handle on success, NULL otherwise
  */
 static gui_handle_p
 get_widget_by_id(gui_handle_p parent, gui_id_t id, uint8_t deep) {
     gui_handle_p h;
     
-    for (h = gui_linkedlist_widgetgetnext(__GHR(parent), NULL); h != NULL;
-            h = gui_linkedlist_widgetgetnext(NULL, h)) {
+#if GUI_CFG_WIDGET_ID_HASH_SIZE
+    if (parent == NULL && deep) {                   /* Complete tree search is replaced with hash map */
+        for (h = GUI.WidgetIdHash[ID_HASH(id)]; h != NULL; h = h->id_next) {
+            if (guii_widget_getid(h) == id) {
+                return h;
+            }
+        }
+        return NULL;
+    }
+#endif /* GUI_CFG_WIDGET_ID_HASH_SIZE */
+    for (h = guii_widget_treenext(parent, NULL, deep); h != NULL; 
+            h = guii_widget_treenext(parent, h, deep)) {  /* Children are checked only when deep */
         if (guii_widget_getid(h) == id) {          /* Compare ID values */
             return h;
-        } else if (deep && guii_widget_allowchildren(h)) { /* Check children if possible */
-            gui_handle_p tmp = get_widget_by_id(h, id, deep);
-            if (tmp != NULL) {
-                return tmp;
-            }
         }
     }
     return NULL;
@@ -407,7 +1188,7 @@ get_common_parentwidget(gui_handle_p h1, gui_handle_p h2) {
  * \return          `1` on success, `0` otherwise
  */
 static uint8_t
-set_widget_size(gui_handle_p h, float wi, float hi) {
+set_widget_size(gui_handle_p h, gui_geom_t wi, gui_geom_t hi) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     
     if (wi != h->width || hi != h->height) {        /* Check any differences */
@@ -420,6 +1201,7 @@ set_widget_size(gui_handle_p h, float wi, float hi) {
         }
         h->width = wi;                              /* Set parameter */
         h->height = hi;                             /* Set parameter */
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
         if (invalidateSecond) {                     /* Invalidate second time only if widget greater than before */
             guii_widget_invalidatewithparent(h);    /* Set new clipping region */
         }
@@ -435,7 +1217,7 @@ set_widget_size(gui_handle_p h, float wi, float hi) {
  * \return          `1` on success, `0` otherwise
  */
 static uint8_t
-set_widget_position(gui_handle_p h, float x, float y) {
+set_widget_position(gui_handle_p h, gui_geom_t x, gui_geom_t y) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     
     if (h->x != x || h->y != y) {                   /* Check any differences */
@@ -444,6 +1226,7 @@ set_widget_position(gui_handle_p h, float x, float y) {
         }
         h->x = x;                                   /* Set parameter */
         h->y = y;                                   /* Set parameter */
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
         if (!guii_widget_isexpanded(h)) {
             guii_widget_invalidatewithparent(h);    /* Set new clipping region */
         }
@@ -478,14 +1261,16 @@ can_remove_widget(gui_handle_p h) {
     }
     
     /*
-     * Check children widgets recursively
+     * Check all children widgets in tree order, parent before its children
      */
     if (GUI_WIDGET_RESULTTYPE_U8(&result) && guii_widget_allowchildren(h)) {   /* Check if we can delete all children widgets */
         gui_handle_p h1;
-        for (h1 = gui_linkedlist_widgetgetnext((gui_handle_root_t *)h, NULL); h1;
-                h1 = gui_linkedlist_widgetgetnext(NULL, h1)) {
-            if (!can_remove_widget(h1)) {           /* If we should not delete it */
-                return 0;                           /* Stop on first call */
+        for (h1 = guii_widget_treenext(h, NULL, 1); h1 != NULL; h1 = guii_widget_treenext(h, h1, 1)) {
+            GUI_WIDGET_RESULTTYPE_U8(&result) = 1;
+            if (!guii_widget_callback(h1, GUI_WC_Remove, NULL, &result) || GUI_WIDGET_RESULTTYPE_U8(&result)) {
+                GUI_WIDGET_RESULTTYPE_U8(&result) = 1;
+            } else {
+                return 0;                           /* Stop on first widget which refuses */
             }
         }
     }
@@ -511,6 +1296,27 @@ guii_widget_isinsideclippingregion(gui_handle_p h) {
     );
 }
 
+#if GUI_CFG_USE_TRACE || __DOXYGEN__
+/**
+ * \brief           Process widget callback with begin and end trace events around it
+ * \note            Used by \ref guii_widget_callback when \ref GUI_CFG_USE_TRACE is enabled
+ * \param[in,out]   h: Widget handle
+ * \param[in]       cmd: Callback command. This parameter can be a value of \ref gui_wc_t enumeration
+ * \param[in]       param: Pointer to parameters if any for this command
+ * \param[out]      result: Pointer to result pointer where calback can store result
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_callback_trace(gui_handle_p h, gui_wc_t cmd, gui_widget_param_t* param, gui_widget_result_t* result) {
+    uint8_t ret;
+    
+    guii_trace_begin(GUI_TRACE_TYPE_WIDGET, (uint8_t)cmd, h, 0);
+    ret = guii_widget_callback_raw(h, cmd, param, result);
+    guii_trace_end(GUI_TRACE_TYPE_WIDGET, (uint8_t)cmd, h, ret);
+    return ret;
+}
+#endif /* GUI_CFG_USE_TRACE || __DOXYGEN__ */
+
 /**
  * \brief           Init widget part of library
  */
@@ -519,18 +1325,71 @@ guii_widget_init(void) {
     gui_window_createdesktop(GUI_ID_WINDOW_BASE, NULL); /* Create base window object */
 }
 
+#if GUI_CFG_USE_TRANSLATE || __DOXYGEN__
+
+/**
+ * \brief           Resolve new translations of widget and its children and mark them for redraw
+ * \param[in]       parent: Parent widget to check children of or `NULL` for top level widgets
+ */
+static void
+translate_update(gui_handle_p parent) {
+    gui_handle_p h;
+    const gui_char* text;
+    
+    for (h = guii_widget_treenext(parent, NULL, 1); h != NULL; h = guii_widget_treenext(parent, h, 1)) {
+        if (h->text != NULL) {
+            text = guii_widget_gettext(h);          /* Memorize translation for new language */
+            if (h->textlayout != NULL && h->textlayout->str != text) {
+                GUI_MEMFREE(h->textlayout);         /* Layout of old text is not needed anymore */
+            }
+        }
+        guii_widget_clrflag(h, GUI_FLAG_RETAINED_VALID);    /* Retained content shows old text */
+        if (guii_widget_isvisible(h)) {
+            set_redraw(h);
+        }
+    }
+}
+
+/**
+ * \brief           Update all widgets after active or source language has changed
+ * \note            Translations and text layouts are resolved in single pass over widget tree
+ *                  and screen is invalidated once as one dirty region, instead of invalidating each widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ */
+void
+guii_widget_translatechanged(void) {
+    if (GUI.root.first == NULL) {                   /* GUI not initialized yet */
+        return;
+    }
+    translate_update(NULL);
+    guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS,
+        0, 0, GUI.lcd.width, GUI.lcd.height);       /* Complete screen is dirty */
+    GUI.flags |= GUI_FLAG_REDRAW;                   /* Notify stack about redraw operations */
+}
+
+#endif /* GUI_CFG_USE_TRANSLATE || __DOXYGEN__ */
+
 /**
- * \brief           Execute remove, check all widgets with remove status
+ * \brief           Execute remove of all widgets waiting in remove queue
+ * \note            Only queued widgets are processed, widget tree is not scanned.
+ *                  Queued children of removed widget are unlinked from queue when freed
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 guii_widget_executeremove(void) {
-    if (GUI.flags & GUI_FLAG_REMOVE) {              /* Anything to remove? */
-        remove_widgets(NULL);                       /* Remove widgets */
-        GUI.flags &= ~GUI_FLAG_REMOVE;
-        return 1;
+    gui_handle_p h;
+    
+    if (GUI.RemoveQueue == NULL) {                  /* Anything to remove? */
+        return 0;
     }
-    return 0;
+    while ((h = GUI.RemoveQueue) != NULL) {
+        GUI.RemoveQueue = h->remove_next;           /* Widget is not in queue anymore */
+        remove_widget(h);                           /* Remove widget with its children */
+    }
+#if GUI_CFG_OS
+    __GUI_WAKEUP(&msg_widget_remove);               /* Notify about remove execution */
+#endif /* GUI_CFG_OS */
+    return 1;
 }
 
 /**
@@ -661,76 +1520,323 @@ guii_widget_active_set(gui_handle_p h) {
     }
 }
 
+#if GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__
+
 /**
- * \brief           Get total width of widget in units of pixels
- *                     Function returns width of widget according to current widget setup (expanded, fill, percent, etc.)
- * \note            The function is private and can be called only when GUI protection against multiple access is activated
- *
- * \note            Even if percentage width is used, function will always return value in pixels
- * \param[in]       h: Pointer to \ref gui_handle_p structure
- * \return          Total width in units of pixels
- * \sa              __gui_widget_getinnerwidth
+ * \brief           Get size of widget placed by layout of its parent
+ * \note            Own position of widget is ignored, fill and expanded modes take complete parent size
+ * \param[in]       h: Widget handle
+ * \param[in]       vertical: Set to `1` for height or `0` for width
+ * \param[in]       parent: Parent inner size in the same direction
+ * \return          Size in units of pixels
+ */
+static gui_dim_t
+layout_size(gui_handle_p h, uint8_t vertical, gui_dim_t parent) {
+    if (guii_widget_getflag(h, GUI_FLAG_EXPANDED | (vertical ? GUI_FLAG_HEIGHT_FILL : GUI_FLAG_WIDTH_FILL))) {
+        return parent;
+    } else if (guii_widget_getflag(h, vertical ? GUI_FLAG_HEIGHT_PERCENT : GUI_FLAG_WIDTH_PERCENT)) {
+        return GUI_GEOM_PERCENT(vertical ? h->height : h->width, parent);
+    }
+    return GUI_GEOM_TO_DIM(vertical ? h->height : h->width);
+}
+
+/**
+ * \brief           Place children of row or column container and save their geometry to cache
+ * \note            Free space is shared between children with grow factor,
+ *                  children in fill mode in direction of layout grow by factor `1`
+ * \param[in]       p: Container widget
+ * \param[in]       x: Absolute inner X position of container
+ * \param[in]       y: Absolute inner Y position of container
+ * \param[in]       vertical: Set to `1` for column or `0` for row layout
  */
-gui_dim_t
-guii_widget_getwidth(gui_handle_p h) {
-    //__GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+static void
+layout_flex(gui_handle_p p, gui_dim_t x, gui_dim_t y, uint8_t vertical) {
+    gui_handle_p h;
+    gui_dim_t main, cross, free, used = 0, pos = 0, size;
+    uint32_t grow, grow_total = 0;
+    size_t cnt = 0;
     
-    if (!(guii_widget_iswidget(h)) || !(GUI.Initialized)) {
-        return 0;                                   \
+    main = vertical ? guii_widget_getinnerheight(p) : guii_widget_getinnerwidth(p);
+    cross = vertical ? guii_widget_getinnerwidth(p) : guii_widget_getinnerheight(p);
+    
+    /* Get base size of children and total grow factor */
+    for (h = gui_linkedlist_widgetgetnext(__GHR(p), NULL); h != NULL; h = gui_linkedlist_widgetgetnext(NULL, h)) {
+        if (guii_widget_ishidden(h)) {
+            continue;
+        }
+        grow = h->layout.grow;
+        if (!grow && guii_widget_getflag(h, GUI_FLAG_EXPANDED | (vertical ? GUI_FLAG_HEIGHT_FILL : GUI_FLAG_WIDTH_FILL))) {
+            grow = 1;                               /* Fill mode takes share of free space instead of complete parent */
+            size = 0;
+        } else {
+            size = layout_size(h, vertical, main);
+        }
+        geometry_isvalid(h, 0);                     /* Start with new cache generation */
+        if (vertical) {
+            h->geometry.height = size;
+            h->geometry.width = layout_size(h, 0, cross);
+        } else {
+            h->geometry.width = size;
+            h->geometry.height = layout_size(h, 1, cross);
+        }
+        used += size;
+        grow_total += grow;
+        cnt++;
+    }
+    if (!cnt) {
+        return;
     }
+    free = main - used - p->layout.gap * (gui_dim_t)(cnt - 1);
     
-    if (guii_widget_getflag(h, GUI_FLAG_EXPANDED)) {   /* Maximize window over parent */
-        return guii_widget_getparentinnerwidth(h); /* Return parent inner width */
-    } else if (guii_widget_getflag(h, GUI_FLAG_WIDTH_FILL)) {  /* "fill_parent" mode for width */
-        gui_dim_t parent = guii_widget_getparentinnerwidth(h);
-        gui_dim_t rel_x = guii_widget_getrelativex(h);
-        if (parent > rel_x) {
-            return parent - rel_x;                  /* Return widget width */
+    /* Share free space and set positions */
+    for (h = gui_linkedlist_widgetgetnext(__GHR(p), NULL); h != NULL; h = gui_linkedlist_widgetgetnext(NULL, h)) {
+        if (guii_widget_ishidden(h)) {
+            continue;
         }
-    } else if (guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT)) {   /* Percentage width */
-        return GUI_ROUND((h->width * guii_widget_getparentinnerwidth(h)) / 100.0f);
-    } else {                                        /* Normal width */
-        return h->width;                            /* Width in pixels */
+        grow = h->layout.grow;
+        if (!grow && guii_widget_getflag(h, GUI_FLAG_EXPANDED | (vertical ? GUI_FLAG_HEIGHT_FILL : GUI_FLAG_WIDTH_FILL))) {
+            grow = 1;
+        }
+        size = vertical ? h->geometry.height : h->geometry.width;
+        if (grow && free > 0) {                     /* Last growing child gets rounding remainder */
+            gui_dim_t add = (gui_dim_t)(((uint32_t)free * grow) / grow_total);
+            size += add;
+            free -= add;
+            grow_total -= grow;
+        }
+        guii_widget_statebegin(h);
+        if (vertical) {
+            h->geometry.height = size;
+            h->geometry.abs_x = x;
+            h->geometry.abs_y = y + pos;
+        } else {
+            h->geometry.width = size;
+            h->geometry.abs_x = x + pos;
+            h->geometry.abs_y = y;
+        }
+        h->geometry.valid = GEOMETRY_ABS_X | GEOMETRY_ABS_Y | GEOMETRY_WIDTH | GEOMETRY_HEIGHT;
+        guii_widget_stateend(h);
+        pos += size + p->layout.gap;
     }
-    return 0;
 }
 
 /**
- * \brief           Get total height of widget
- *                     Function returns height of widget according to current widget setup (expanded, fill, percent, etc.)
- * \note            The function is private and can be called only when GUI protection against multiple access is activated
- *
- * \note            Even if percentage height is used, function will always return value in pixels
- * \param[in]       h: Pointer to \ref gui_handle_p structure
- * \return          Total height in units of pixels
- * \sa              __gui_widget_getinnerheight
- * \hideinitializer
+ * \brief           Place children of grid container and save their geometry to cache
+ * \note            Columns have equal width, row is as high as its highest child,
+ *                  children in height fill mode take height of their row
+ * \param[in]       p: Container widget
+ * \param[in]       x: Absolute inner X position of container
+ * \param[in]       y: Absolute inner Y position of container
  */
-gui_dim_t
-guii_widget_getheight(gui_handle_p h) {
-    //__GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    if (!(guii_widget_iswidget(h)) || !(GUI.Initialized)) {
-        return 0;                                   \
+static void
+layout_grid(gui_handle_p p, gui_dim_t x, gui_dim_t y) {
+    gui_handle_p h, first;
+    gui_dim_t cell, height, row_height;
+    uint8_t cols, col;
+    
+    cols = p->layout.columns ? p->layout.columns : 1;
+    height = guii_widget_getinnerheight(p);
+    cell = (guii_widget_getinnerwidth(p) - p->layout.gap * (cols - 1)) / cols;
+    if (cell < 0) {
+        cell = 0;
     }
     
-    if (guii_widget_getflag(h, GUI_FLAG_EXPANDED)) {   /* Maximize window over parent */
-        return guii_widget_getparentinnerheight(h);/* Return parent inner height */
-    } else if (guii_widget_getflag(h, GUI_FLAG_HEIGHT_FILL)) { /* "fill_parent" mode for height */
-        gui_dim_t parent = guii_widget_getparentinnerheight(h);
-        gui_dim_t rel_y = guii_widget_getrelativey(h);
-        if (parent > rel_y) {
-            return parent - rel_y;                  /* Return widget height */
+    h = gui_linkedlist_widgetgetnext(__GHR(p), NULL);
+    while (h != NULL) {
+        /* Find height of current row */
+        row_height = 0;
+        first = h;
+        for (col = 0; h != NULL && col < cols; h = gui_linkedlist_widgetgetnext(NULL, h)) {
+            if (guii_widget_ishidden(h)) {
+                continue;
+            }
+            geometry_isvalid(h, 0);                 /* Start with new cache generation */
+            h->geometry.width = cell;
+            h->geometry.height = guii_widget_getflag(h, GUI_FLAG_EXPANDED | GUI_FLAG_HEIGHT_FILL) ? 0 : layout_size(h, 1, height);
+            if (h->geometry.height > row_height) {
+                row_height = h->geometry.height;
+            }
+            col++;
         }
-    } else if (guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT)) {  /* Percentage height */
-        return GUI_ROUND((h->height * guii_widget_getparentinnerheight(h)) / 100.0f);
-    } else {                                        /* Normal height */
-        return h->height;                           /* height in pixels */
+        
+        /* Place children of current row */
+        for (col = 0; first != h; first = gui_linkedlist_widgetgetnext(NULL, first)) {
+            if (guii_widget_ishidden(first)) {
+                continue;
+            }
+            guii_widget_statebegin(first);
+            if (!first->geometry.height) {
+                first->geometry.height = row_height;
+            }
+            first->geometry.abs_x = x + col * (cell + p->layout.gap);
+            first->geometry.abs_y = y;
+            first->geometry.valid = GEOMETRY_ABS_X | GEOMETRY_ABS_Y | GEOMETRY_WIDTH | GEOMETRY_HEIGHT;
+            guii_widget_stateend(first);
+            col++;
+        }
+        y += row_height + p->layout.gap;
     }
-    return 0;
 }
 
 /**
- * \brief           Get absolute X position on LCD for specific widget
+ * \brief           Resolve geometry of widget placed by layout of its parent
+ * \note            All visible children of the parent are resolved at once
+ * \param[in]       h: Widget handle
+ * \return          `1` when widget geometry was saved to cache, `0` when widget is not in layout
+ */
+static uint8_t
+layout_resolve(gui_handle_p h) {
+    gui_handle_p p = guii_widget_getparent(h);
+    gui_dim_t x, y;
+    
+    if (p == NULL || p->layout.type == GUI_LAYOUT_NONE || guii_widget_ishidden(h)) {
+        return 0;
+    }
+    x = guii_widget_getabsolutex(p) + guii_widget_getpaddingleft(p) - __GHR(p)->x_scroll;
+    y = guii_widget_getabsolutey(p) + guii_widget_getpaddingtop(p) - __GHR(p)->y_scroll;
+    if (p->layout.type == GUI_LAYOUT_GRID) {
+        layout_grid(p, x, y);
+    } else {
+        layout_flex(p, x, y, p->layout.type == GUI_LAYOUT_COLUMN);
+    }
+    return 1;
+}
+
+/**
+ * \brief           Resolve geometry of widget and all its children
+ * \param[in]       parent: Parent widget or `NULL` for root widgets
+ */
+static void
+layout_tree(gui_handle_p parent) {
+    gui_handle_p h;
+    
+    for (h = gui_linkedlist_widgetgetnext(parent != NULL ? __GHR(parent) : NULL, NULL); h != NULL;
+        h = gui_linkedlist_widgetgetnext(NULL, h)) {
+        if (guii_widget_ishidden(h)) {              /* Hidden widgets are resolved on first use */
+            continue;
+        }
+        guii_widget_getabsolutex(h);                /* Fill cache from top to bottom */
+        guii_widget_getabsolutey(h);
+        guii_widget_getwidth(h);
+        guii_widget_getheight(h);
+        if (guii_widget_allowchildren(h)) {
+            layout_tree(h);
+        }
+    }
+}
+
+/**
+ * \brief           Resolve geometry of all visible widgets when anything has changed
+ * \note            Called once per frame before touch and redraw processing,
+ *                  which then only read cached values
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ */
+void
+guii_widget_layout(void) {
+    if (GUI.LayoutGen != GUI.GeometryGen) {
+        layout_tree(NULL);
+        GUI.LayoutGen = GUI.GeometryGen;
+    }
+}
+
+#endif /* GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__ */
+
+/**
+ * \brief           Get total width of widget in units of pixels
+ *                     Function returns width of widget according to current widget setup (expanded, fill, percent, etc.)
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ *
+ * \note            Even if percentage width is used, function will always return value in pixels
+ * \param[in]       h: Pointer to \ref gui_handle_p structure
+ * \return          Total width in units of pixels
+ * \sa              __gui_widget_getinnerwidth
+ */
+gui_dim_t
+guii_widget_getwidth(gui_handle_p h) {
+    gui_dim_t out = 0;
+    //__GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    
+    if (!(guii_widget_iswidget(h)) || !(GUI.Initialized)) {
+        return 0;                                   \
+    }
+    if (geometry_isvalid(h, GEOMETRY_WIDTH)) {      /* Use cached value if possible */
+        return h->geometry.width;
+    }
+#if GUI_CFG_WIDGET_LAYOUT
+    if (layout_resolve(h) && geometry_isvalid(h, GEOMETRY_WIDTH)) {
+        return h->geometry.width;                   /* Widget is placed by parent layout */
+    }
+#endif /* GUI_CFG_WIDGET_LAYOUT */
+    
+    if (guii_widget_getflag(h, GUI_FLAG_EXPANDED)) {   /* Maximize window over parent */
+        out = guii_widget_getparentinnerwidth(h);  /* Return parent inner width */
+    } else if (guii_widget_getflag(h, GUI_FLAG_WIDTH_FILL)) {  /* "fill_parent" mode for width */
+        gui_dim_t parent = guii_widget_getparentinnerwidth(h);
+        gui_dim_t rel_x = guii_widget_getrelativex(h);
+        if (parent > rel_x) {
+            out = parent - rel_x;                   /* Return widget width */
+        }
+    } else if (guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT)) {   /* Percentage width */
+        out = GUI_GEOM_PERCENT(h->width, guii_widget_getparentinnerwidth(h));
+    } else {                                        /* Normal width */
+        out = GUI_GEOM_TO_DIM(h->width);            /* Width in pixels */
+    }
+    guii_widget_statebegin(h);
+    h->geometry.width = out;                        /* Save to cache */
+    h->geometry.valid |= GEOMETRY_WIDTH;
+    guii_widget_stateend(h);
+    return out;
+}
+
+/**
+ * \brief           Get total height of widget
+ *                     Function returns height of widget according to current widget setup (expanded, fill, percent, etc.)
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ *
+ * \note            Even if percentage height is used, function will always return value in pixels
+ * \param[in]       h: Pointer to \ref gui_handle_p structure
+ * \return          Total height in units of pixels
+ * \sa              __gui_widget_getinnerheight
+ * \hideinitializer
+ */
+gui_dim_t
+guii_widget_getheight(gui_handle_p h) {
+    gui_dim_t out = 0;
+    //__GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    if (!(guii_widget_iswidget(h)) || !(GUI.Initialized)) {
+        return 0;                                   \
+    }
+    if (geometry_isvalid(h, GEOMETRY_HEIGHT)) {     /* Use cached value if possible */
+        return h->geometry.height;
+    }
+#if GUI_CFG_WIDGET_LAYOUT
+    if (layout_resolve(h) && geometry_isvalid(h, GEOMETRY_HEIGHT)) {
+        return h->geometry.height;                  /* Widget is placed by parent layout */
+    }
+#endif /* GUI_CFG_WIDGET_LAYOUT */
+    
+    if (guii_widget_getflag(h, GUI_FLAG_EXPANDED)) {   /* Maximize window over parent */
+        out = guii_widget_getparentinnerheight(h); /* Return parent inner height */
+    } else if (guii_widget_getflag(h, GUI_FLAG_HEIGHT_FILL)) { /* "fill_parent" mode for height */
+        gui_dim_t parent = guii_widget_getparentinnerheight(h);
+        gui_dim_t rel_y = guii_widget_getrelativey(h);
+        if (parent > rel_y) {
+            out = parent - rel_y;                   /* Return widget height */
+        }
+    } else if (guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT)) {  /* Percentage height */
+        out = GUI_GEOM_PERCENT(h->height, guii_widget_getparentinnerheight(h));
+    } else {                                        /* Normal height */
+        out = GUI_GEOM_TO_DIM(h->height);           /* height in pixels */
+    }
+    guii_widget_statebegin(h);
+    h->geometry.height = out;                       /* Save to cache */
+    h->geometry.valid |= GEOMETRY_HEIGHT;
+    guii_widget_stateend(h);
+    return out;
+}
+
+/**
+ * \brief           Get absolute X position on LCD for specific widget
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
  * \param[in,out]   h: Widget handle
  * \return          X position on LCD
@@ -744,16 +1850,26 @@ guii_widget_getabsolutex(gui_handle_p h) {
     if (h == NULL) {                                /* Check input value */
         return 0;                                   /* At left value */
     }
+    if (geometry_isvalid(h, GEOMETRY_ABS_X)) {      /* Use cached value if possible */
+        return h->geometry.abs_x;
+    }
+#if GUI_CFG_WIDGET_LAYOUT
+    if (layout_resolve(h) && geometry_isvalid(h, GEOMETRY_ABS_X)) {
+        return h->geometry.abs_x;                   /* Widget is placed by parent layout */
+    }
+#endif /* GUI_CFG_WIDGET_LAYOUT */
     
     /* If widget is not expanded, use actual value */
     out = guii_widget_getrelativex(h);              /* Get start relative position */
     
-    /* Process all parent widgets to get real absolute screen value */
-    for (w = guii_widget_getparent(h); w != NULL;
-        w = guii_widget_getparent(w)) {             /* Go through all parent windows */
-        out += guii_widget_getrelativex(w) + guii_widget_getpaddingleft(w);   /* Add X offset from parent and left padding of parent */
+    /* Parent absolute position is cached, use it */
+    w = guii_widget_getparent(h);
+    if (w != NULL) {
+        out += guii_widget_getabsolutex(w) + guii_widget_getpaddingleft(w); /* Add X offset from parent and left padding of parent */
         out -= __GHR(w)->x_scroll;                  /* Decrease by scroll value */
     }
+    h->geometry.abs_x = out;                        /* Save to cache */
+    h->geometry.valid |= GEOMETRY_ABS_X;
     return out;
 }
 
@@ -772,16 +1888,26 @@ guii_widget_getabsolutey(gui_handle_p h) {
     if (h == NULL) {                                /* Check input value */
         return 0;                                   /* At top value */
     }
+    if (geometry_isvalid(h, GEOMETRY_ABS_Y)) {      /* Use cached value if possible */
+        return h->geometry.abs_y;
+    }
+#if GUI_CFG_WIDGET_LAYOUT
+    if (layout_resolve(h) && geometry_isvalid(h, GEOMETRY_ABS_Y)) {
+        return h->geometry.abs_y;                   /* Widget is placed by parent layout */
+    }
+#endif /* GUI_CFG_WIDGET_LAYOUT */
     
     /* If widget is not expanded, use actual value */
     out = guii_widget_getrelativey(h);              /* Get start relative position */
     
-    /* Process all parent widgets to get real absolute screen value */
-    for (w = guii_widget_getparent(h); w != NULL;
-        w = guii_widget_getparent(w)) {             /* Go through all parent windows */
-        out += guii_widget_getrelativey(w) + guii_widget_getpaddingtop(w);    /* Add X offset from parent and left padding of parent */
+    /* Parent absolute position is cached, use it */
+    w = guii_widget_getparent(h);
+    if (w != NULL) {
+        out += guii_widget_getabsolutey(w) + guii_widget_getpaddingtop(w);  /* Add Y offset from parent and top padding of parent */
         out -= __GHR(w)->y_scroll;                  /* Decrease by scroll value */
     }
+    h->geometry.abs_y = out;                        /* Save to cache */
+    h->geometry.valid |= GEOMETRY_ABS_Y;
     return out;
 }
 
@@ -836,16 +1962,66 @@ guii_widget_getparentabsolutey(gui_handle_p h) {
 }
 
 /**
- * \brief           Invalidate widget for redraw 
- * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \brief           Add visible area of widget to combined area of batched update
+ * \param[in]       h: Widget handle
+ */
+static void
+batch_addwidget(gui_handle_p h) {
+    gui_handle_p t;
+    gui_dim_t x1, y1, x2, y2;
+    
+    guii_widget_clrflag(h, GUI_FLAG_DISPLAY_LIST_VALID);    /* Widget content changed */
+    for (t = h; t != NULL; t = guii_widget_getparent(t)) {  /* Retained widgets are drawn again completely */
+        if (guii_widget_getflag(t, GUI_FLAG_RETAINED_VALID)) {
+            guii_widget_clrflag(t, GUI_FLAG_RETAINED_VALID);
+            batch_addwidget(t);
+        }
+    }
+    get_lcd_abs_position_and_visible_width_height(h, &x1, &y1, &x2, &y2);
+    if (x1 >= x2 || y1 >= y2) {                     /* Nothing visible */
+        return;
+    }
+    GUI.BatchRect.x1 = GUI_MIN(GUI.BatchRect.x1, x1);
+    GUI.BatchRect.y1 = GUI_MIN(GUI.BatchRect.y1, y1);
+    GUI.BatchRect.x2 = GUI_MAX(GUI.BatchRect.x2, x2);
+    GUI.BatchRect.y2 = GUI_MAX(GUI.BatchRect.y2, y2);
+}
+
+/**
+ * \brief           Mark for redraw all visible widgets overlapping combined area of batched update
+ * \param[in]       parent: Parent widget to check children of or `NULL` for top level widgets
+ */
+static void
+batch_invalidateregion(gui_handle_p parent) {
+    gui_handle_p h;
+    gui_dim_t x1, y1, x2, y2;
+    
+    for (h = gui_linkedlist_widgetgetnext((gui_handle_root_t *)parent, NULL); h != NULL;
+            h = gui_linkedlist_widgetgetnext(NULL, h)) {
+        if (!guii_widget_isvisible(h)) {
+            continue;
+        }
+        get_lcd_abs_position_and_visible_width_height(h, &x1, &y1, &x2, &y2);
+        if (x1 >= x2 || y1 >= y2 || !__GUI_RECT_MATCH(
+            GUI.BatchRect.x1, GUI.BatchRect.y1, GUI.BatchRect.x2 - 1, GUI.BatchRect.y2 - 1,
+            x1, y1, x2 - 1, y2 - 1)) {
+            continue;
+        }
+        set_redraw(h);                              /* Widget is drawn in combined area */
+        if (guii_widget_allowchildren(h)) {
+            batch_invalidateregion(h);
+        }
+    }
+}
+
+/**
+ * \brief           Resolve invalidation of widget, its overlapping widgets and parent if required
  * \param[in,out]   h: Widget handle
  * \return          `1` on success, `0` otherwise
- * \hideinitializer
  */
-uint8_t
-guii_widget_invalidate(gui_handle_p h) {
+static uint8_t
+resolve_invalidate(gui_handle_p h) {
     uint8_t ret;
-    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     
     ret = invalidate_widget(h, 1);                  /* Invalidate widget with clipping */
     
@@ -859,68 +2035,1726 @@ guii_widget_invalidate(gui_handle_p h) {
         ) && guii_widget_hasparent(h)) {
         invalidate_widget(guii_widget_getparent(h), 0); /* Invalidate parent object too but without clipping */
     }
-#if GUI_CFG_OS
-    gui_sys_mbox_putnow(&GUI.OS.mbox, &msg_widget_invalidate);
-#endif /* GUI_CFG_OS */
     return ret;
 }
 
 /**
- * \brief           Invalidate widget and parent widget for redraw 
+ * \brief           Invalidate widget for redraw 
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Widget is only marked for invalidation. Overlapping widgets and clipping regions
+ *                  are resolved once per frame in \ref guii_widget_processinvalidated, no matter
+ *                  how many times widget was invalidated before
  * \param[in,out]   h: Widget handle
  * \return          `1` on success, `0` otherwise
  * \hideinitializer
  */
 uint8_t
-guii_widget_invalidatewithparent(gui_handle_p h) {
+guii_widget_invalidate(gui_handle_p h) {
+    uint8_t ret = 1;
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    invalidate_widget(h, 1);                        /* Invalidate object with clipping */
-    if (guii_widget_hasparent(h)) {                 /* If parent exists, invalid only parent */
-        invalidate_widget(guii_widget_getparent(h), 0); /* Invalidate parent object without clipping */
+    
+    if (guii_widget_getflag(h, GUI_FLAG_IGNORE_INVALIDATE)) {   /* Check ignore flag */
+        return 0;
     }
-    return 1;
+    guii_widget_clrflag(h, GUI_FLAG_RETAINED_BLEND);    /* Content of widget may change */
+    if (GUI.BatchLevel) {                           /* Resolved on batch commit */
+        batch_addwidget(h);
+        return 1;
+    }
+    if (!guii_widget_getflag(h, GUI_FLAG_INVALIDATE_PENDING)) { /* Not yet waiting in current frame */
+        if (GUI.InvalidateListCount < GUI_COUNT_OF(GUI.InvalidateList)) {
+            GUI.InvalidateList[GUI.InvalidateListCount++] = h;
+            guii_widget_setflag(h, GUI_FLAG_INVALIDATE_PENDING);
+            GUI.flags |= GUI_FLAG_REDRAW;           /* Notify stack about redraw operations */
+        } else {
+            ret = resolve_invalidate(h);            /* No free slot, resolve now */
+        }
+    }
+#if GUI_CFG_OS
+    __GUI_WAKEUP(&msg_widget_invalidate);
+#endif /* GUI_CFG_OS */
+    return ret;
 }
 
 /**
- * \brief           Set if parent widget should be invalidated when we invalidate primary widget
+ * \brief           Resolve all pending widget invalidations
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
- * \note            Useful for widgets where there is no background: Transparent images, textview, slider, etc
- * \param[in]       h: Widget handle
- * \param[in]       value: Value either to enable or disable. 0 = disable, > 0 = enable
+ * \note            Called by GUI stack before redraw operation
+ */
+void
+guii_widget_processinvalidated(void) {
+    gui_handle_p h;
+    
+    while (GUI.InvalidateListCount) {
+        h = GUI.InvalidateList[--GUI.InvalidateListCount];
+        guii_widget_clrflag(h, GUI_FLAG_INVALIDATE_PENDING);
+        resolve_invalidate(h);
+    }
+}
+
+/**
+ * \brief           Add scroll operation of widget area to queue
+ * \param[in,out]   h: Widget handle
+ * \param[in]       x: Area X position relative to widget
+ * \param[in]       y: Area Y position relative to widget
+ * \param[in]       width: Area width in units of pixels
+ * \param[in]       height: Area height in units of pixels
+ * \param[in]       dx: Number of pixels to move content left
+ * \param[in]       dy: Number of pixels to move content up
+ * \param[in]       children: Set to `1` when children widgets move together with content
  * \return          `1` on success, `0` otherwise
  */
-uint8_t
-guii_widget_setinvalidatewithparent(gui_handle_p h, uint8_t value) {
+static uint8_t
+widget_scroll(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t dx, gui_dim_t dy, uint8_t children) {
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE
+    gui_widget_scroll_t* e;
+    gui_handle_p t;
+    size_t i;
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE */
+    
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    if (value) {                                    /* On positive value */
-        guii_widget_setflag(h, GUI_FLAG_WIDGET_INVALIDATE_PARENT); /* Enable auto invalidation of parent widget */
-    } else {                                        /* On zero */
-        guii_widget_clrflag(h, GUI_FLAG_WIDGET_INVALIDATE_PARENT); /* Disable auto invalidation of parent widget */
+    
+    if (guii_widget_getflag(h, GUI_FLAG_IGNORE_INVALIDATE)) {   /* Check ignore flag */
+        return 0;
+    }
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE
+    /* Band rendering has no frame buffer to move pixels in, frame buffer of rasterizer thread is not accessed */
+    if (GUI.BatchLevel || GUI.ll.Copy == NULL || GUI_CFG_LCD_BAND || GUI_CFG_OS_RENDER_THREAD || width <= 0 || height <= 0) {
+        return guii_widget_invalidate(h);           /* Redraw complete widget */
+    }
+#if GUI_CFG_USE_DEBUG_OVERLAY
+    if (GUI.Overlay) {                              /* Moved pixels would carry overlay outlines */
+        return guii_widget_invalidate(h);
+    }
+#endif /* GUI_CFG_USE_DEBUG_OVERLAY */
+#if GUI_CFG_SPRITE_COUNT
+    if (guii_sprite_isactive()) {                   /* Moved pixels might carry sprite */
+        return guii_widget_invalidate(h);
+    }
+#endif /* GUI_CFG_SPRITE_COUNT */
+    for (t = h; t != NULL && !guii_widget_getflag(t, GUI_FLAG_RETAINED); t = guii_widget_getparent(t)) {}
+    if (t != NULL) {                                /* Retained bitmap must be drawn again too */
+        return guii_widget_invalidate(h);
+    }
+    if (guii_widget_getflag(h, GUI_FLAG_INVALIDATE_PENDING)) {  /* Widget is redrawn completely anyway */
+        return 1;
+    }
+    
+    /* Combine with operation on the same area in current frame */
+    for (i = 0; i < GUI.ScrollCount; i++) {
+        e = &GUI.ScrollList[i];
+        if (e->h == h && e->children == children && e->area.x1 == x && e->area.y1 == y &&
+            e->area.x2 == x + width && e->area.y2 == y + height) {
+            e->dx += dx;
+            e->dy += dy;
+            return 1;
+        }
     }
+    if (GUI.ScrollCount == GUI_COUNT_OF(GUI.ScrollList)) { /* No more free entries */
+        return guii_widget_invalidate(h);
+    }
+    e = &GUI.ScrollList[GUI.ScrollCount++];
+    e->h = h;
+    e->area.x1 = x;
+    e->area.y1 = y;
+    e->area.x2 = x + width;
+    e->area.y2 = y + height;
+    e->dx = dx;
+    e->dy = dy;
+    e->children = children;
+    
+    GUI.flags |= GUI_FLAG_REDRAW;                   /* Notify stack about redraw operations */
+#if GUI_CFG_OS
+    __GUI_WAKEUP(&msg_widget_invalidate);
+#endif /* GUI_CFG_OS */
     return 1;
+#else
+    GUI_UNUSED(x); GUI_UNUSED(y); GUI_UNUSED(width); GUI_UNUSED(height); GUI_UNUSED(dx); GUI_UNUSED(dy); GUI_UNUSED(children);
+    return guii_widget_invalidate(h);               /* Redraw complete widget */
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE */
 }
 
 /**
- * \brief           Set 3D mode on widget
+ * \brief           Scroll part of widget content for specific number of pixels
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Pixels already drawn on screen are moved by memory copy and only newly exposed part
+ *                  of area is redrawn. Widget is invalidated completely when this is not possible,
+ *                  for example when other widget overlaps it or when widget is transparent
  * \param[in,out]   h: Widget handle
- * \param[in]       enable: Value to enable, either 1 or 0
+ * \param[in]       x: Area X position relative to widget
+ * \param[in]       y: Area Y position relative to widget
+ * \param[in]       width: Area width in units of pixels
+ * \param[in]       height: Area height in units of pixels
+ * \param[in]       dy: Number of pixels to move content. Positive value moves content up,
+ *                      negative moves it down. Set to `0` to only redraw area
  * \return          `1` on success, `0` otherwise
+ * \sa              guii_widget_scrollx, guii_widget_invalidaterect
  */
 uint8_t
-guii_widget_set3dstyle(gui_handle_p h, uint8_t enable) {
-    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    if (enable && !guii_widget_getflag(h, GUI_FLAG_3D)) {  /* Enable style */
-        guii_widget_setflag(h, GUI_FLAG_3D);        /* Enable 3D style */
-        guii_widget_invalidate(h);                  /* Invalidate object */
-    } else if (!enable && guii_widget_getflag(h, GUI_FLAG_3D)) {/* Disable style */
-        guii_widget_clrflag(h, GUI_FLAG_3D);        /* Disable 3D style */
-        guii_widget_invalidate(h);                  /* Invalidate object */
+guii_widget_scroll(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t dy) {
+    return widget_scroll(h, x, y, width, height, 0, dy, 0);
+}
+
+/**
+ * \brief           Scroll part of widget content horizontally for specific number of pixels
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Area scrolled in both directions in the same frame is redrawn completely
+ * \param[in,out]   h: Widget handle
+ * \param[in]       x: Area X position relative to widget
+ * \param[in]       y: Area Y position relative to widget
+ * \param[in]       width: Area width in units of pixels
+ * \param[in]       height: Area height in units of pixels
+ * \param[in]       dx: Number of pixels to move content. Positive value moves content left,
+ *                      negative moves it right. Set to `0` to only redraw area
+ * \return          `1` on success, `0` otherwise
+ * \sa              guii_widget_scroll, guii_widget_invalidaterect
+ */
+uint8_t
+guii_widget_scrollx(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t dx) {
+    return widget_scroll(h, x, y, width, height, dx, 0, 0);
+}
+
+/**
+ * \brief           Redraw rows of list widget after its visible rows changed
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Rows area is inside 2 pixels wide border, below optional header and left of optional slider.
+ *                  Already drawn rows are moved and only new rows and slider are redrawn.
+ *                  Widget is invalidated completely when layout changed or when all visible rows are new
+ * \param[in,out]   h: Widget handle
+ * \param[in]       rows: Number of rows first visible row moved down in list, negative when it moved up
+ * \param[in]       offset: Change of pixel offset of first visible row
+ * \param[in]       itemheight: Height of single row in units of pixels. Set to `0` when layout changed
+ * \param[in]       top: Height of header above rows in units of pixels, `0` when there is none
+ * \param[in]       sliderwidth: Width of visible slider in units of pixels, `0` when there is none
+ * \sa              guii_widget_scroll
+ */
+void
+guii_widget_scrollrows(gui_handle_p h, int32_t rows, gui_dim_t offset, gui_dim_t itemheight, gui_dim_t top, gui_dim_t sliderwidth) {
+    gui_dim_t width, height;
+    int32_t dy;
+    
+    if (!rows && !offset) {                         /* Nothing changed */
+        return;
+    }
+    width = guii_widget_getwidth(h);
+    height = guii_widget_getheight(h);
+    dy = rows * itemheight + offset;
+    if (!itemheight || GUI_ABS(dy) >= height - 4 - top) {
+        guii_widget_invalidate(h);                  /* Layout changed or all visible rows are new */
+        return;
+    }
+    if (sliderwidth) {
+        width -= sliderwidth;
+        guii_widget_invalidaterect(h, width - 1, 1, sliderwidth, height - 2);  /* Slider position changed */
+    } else {
+        width--;
+    }
+    guii_widget_scroll(h, 2, 2 + top, width - 3, height - 4 - top, (gui_dim_t)dy); /* Move rows area */
+}
+
+/**
+ * \brief           Redraw widget after its children scroll changed
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Inner area is moved together with children widgets and only newly exposed strip is redrawn.
+ *                  Children widgets outside strip are not drawn again. Widget background must not depend on scroll
+ * \param[in,out]   h: Widget handle with children support
+ * \param[in]       dx: Change of X scroll in units of pixels
+ * \param[in]       dy: Change of Y scroll in units of pixels
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_setscrollx, gui_widget_setscrolly
+ */
+uint8_t
+guii_widget_scrollchildren(gui_handle_p h, gui_dim_t dx, gui_dim_t dy) {
+    if (dx && dy) {                                 /* Content cannot be moved in both directions */
+        return guii_widget_invalidate(h);
+    }
+    return widget_scroll(h, guii_widget_getpaddingleft(h), guii_widget_getpaddingtop(h),
+        guii_widget_getinnerwidth(h), guii_widget_getinnerheight(h), dx, dy, 1);
+}
+
+/**
+ * \brief           Invalidate only part of widget for redraw
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \param[in]       x: Area X position relative to widget
+ * \param[in]       y: Area Y position relative to widget
+ * \param[in]       width: Area width in units of pixels
+ * \param[in]       height: Area height in units of pixels
+ * \return          `1` on success, `0` otherwise
+ * \sa              guii_widget_scroll
+ */
+uint8_t
+guii_widget_invalidaterect(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height) {
+    return guii_widget_scroll(h, x, y, width, height, 0);   /* Redraw area without moving content */
+}
+
+#if GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE || __DOXYGEN__
+
+/**
+ * \brief           Check if area of widget can be updated without redrawing complete widget
+ * \note            Area must be completely visible, no other widget may overlap it
+ *                  and widget must not have transparency. Children are only allowed when they move with content
+ * \param[in]       h: Widget handle
+ * \param[in]       area: Absolute area on screen
+ * \param[in]       children: Set to `1` when children widgets move together with content
+ * \return          `1` if allowed, `0` otherwise
+ */
+static uint8_t
+scroll_isallowed(gui_handle_p h, const gui_display_t* area, uint8_t children) {
+    gui_handle_p t, s;
+    gui_dim_t x1, y1, x2, y2;
+    
+    get_lcd_abs_position_and_visible_width_height(h, &x1, &y1, &x2, &y2);
+    if (area->x1 < x1 || area->y1 < y1 || area->x2 > x2 || area->y2 > y2) {
+        return 0;                                   /* Part of area is hidden */
+    }
+    if (!children && guii_widget_allowchildren(h) && gui_linkedlist_widgetgetnext((gui_handle_root_t *)h, NULL) != NULL) {
+        return 0;                                   /* Children are drawn over content */
+    }
+    for (t = h; t != NULL; t = guii_widget_getparent(t)) {
+#if GUI_CFG_USE_TRANSPARENCY
+        if (guii_widget_istransparent(t)) {        /* Blended content cannot be moved */
+            return 0;
+        }
+#endif /* GUI_CFG_USE_TRANSPARENCY */
+        for (s = gui_linkedlist_widgetgetnext(NULL, t); s != NULL; s = gui_linkedlist_widgetgetnext(NULL, s)) {
+            if (!guii_widget_isvisible(s)) {
+                continue;
+            }
+            get_lcd_abs_position_and_visible_width_height(s, &x1, &y1, &x2, &y2);
+            if (x1 < x2 && y1 < y2 && __GUI_RECT_MATCH(
+                area->x1, area->y1, area->x2 - 1, area->y2 - 1,
+                x1, y1, x2 - 1, y2 - 1)) {
+                return 0;                           /* Widget above overlaps area */
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Check if moved pixels of scroll operation would overwrite pixels drawn in this frame
+ * \note            Pixels are moved after redraw, regions drawn inside moved area would be lost.
+ *                  Operation inside area moved by parent is copied together with parent already
+ * \param[in]       e: Scroll operation with absolute area
+ * \return          `1` when widget must be redrawn completely, `0` otherwise
+ */
+static uint8_t
+scroll_isoverdrawn(const gui_widget_scroll_t* e) {
+    gui_display_t m;
+    gui_handle_p t;
+    size_t i;
+    
+    m = e->area;                                    /* Destination of moved pixels */
+    if (e->dy > 0) {
+        m.y2 -= e->dy;
+    } else if (e->dy < 0) {
+        m.y1 -= e->dy;
+    } else if (e->dx > 0) {
+        m.x2 -= e->dx;
+    } else {
+        m.x1 -= e->dx;
+    }
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {
+        if (__GUI_RECT_MATCH(
+            m.x1, m.y1, m.x2 - 1, m.y2 - 1,
+            GUI.DirtyRects[i].x1, GUI.DirtyRects[i].y1, GUI.DirtyRects[i].x2 - 1, GUI.DirtyRects[i].y2 - 1)) {
+            return 1;
+        }
+    }
+    for (i = 0; i < GUI.ScrollCount; i++) {
+        if (!GUI.ScrollList[i].children) {
+            continue;
+        }
+        for (t = guii_widget_getparent(e->h); t != NULL && t != GUI.ScrollList[i].h; t = guii_widget_getparent(t)) {}
+        if (t != NULL) {                            /* Parent moves children in the same frame */
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Check if area of scroll operation is redrawn completely in current frame
+ * \note            Redraw flag alone is not enough, widgets overlapping invalidated widget
+ *                  get it too but are redrawn only inside dirty regions
+ * \param[in]       e: Scroll operation with area relative to widget
+ * \return          `1` when operation is not needed, `0` otherwise
+ */
+static uint8_t
+scroll_isredrawn(const gui_widget_scroll_t* e) {
+    gui_handle_p t;
+    gui_dim_t x, y;
+    size_t i;
+    
+    for (t = e->h; t != NULL && !guii_widget_getflag(t, GUI_FLAG_REDRAW); t = guii_widget_getparent(t)) {}
+    if (t == NULL) {                                /* Widget is not drawn at all */
+        return 0;
+    }
+    x = guii_widget_getabsolutex(e->h);
+    y = guii_widget_getabsolutey(e->h);
+    for (i = 0; i < GUI.DirtyRectsCount; i++) {
+        if (GUI.DirtyRects[i].x1 <= e->area.x1 + x && GUI.DirtyRects[i].x2 >= e->area.x2 + x &&
+            GUI.DirtyRects[i].y1 <= e->area.y1 + y && GUI.DirtyRects[i].y2 >= e->area.y2 + y) {
+            return 1;                               /* Complete area is inside dirty region */
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Prepare all pending scroll operations for redraw
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack after \ref guii_widget_processinvalidated and before redraw.
+ *                  Newly exposed parts are added to dirty regions, operations which cannot
+ *                  be processed fall back to complete widget invalidation
+ */
+void
+guii_widget_processscrolled(void) {
+    gui_widget_scroll_t* e;
+    gui_dim_t x, y;
+    size_t i, cnt;
+    
+    /* Drop operations of areas which are redrawn completely anyway */
+    for (i = 0; i < GUI.ScrollCount; ) {
+        if (scroll_isredrawn(&GUI.ScrollList[i])) {
+            GUI.ScrollList[i] = GUI.ScrollList[--GUI.ScrollCount];
+        } else {
+            i++;
+        }
+    }
+    
+    for (i = 0, cnt = 0; i < GUI.ScrollCount; i++) {
+        e = &GUI.ScrollList[i];
+        x = guii_widget_getabsolutex(e->h);
+        y = guii_widget_getabsolutey(e->h);
+        e->area.x1 += x;                            /* Convert to absolute coordinates */
+        e->area.x2 += x;
+        e->area.y1 += y;
+        e->area.y2 += y;
+        if (GUI_ABS(e->dy) >= e->area.y2 - e->area.y1 || GUI_ABS(e->dx) >= e->area.x2 - e->area.x1 || (e->dx && e->dy) ||
+            ((e->dx || e->dy) && GUI.lcd.active_layer == GUI.lcd.drawing_layer) || !scroll_isallowed(e->h, &e->area, e->children)) {
+            resolve_invalidate(e->h);               /* Redraw complete widget instead */
+            continue;
+        }
+        
+        /* Only newly exposed part of area is redrawn */
+        if (e->dy > 0) {
+            guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS, e->area.x1, e->area.y2 - e->dy, e->area.x2, e->area.y2);
+        } else if (e->dy < 0) {
+            guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS, e->area.x1, e->area.y1, e->area.x2, e->area.y1 - e->dy);
+        } else if (e->dx > 0) {
+            guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS, e->area.x2 - e->dx, e->area.y1, e->area.x2, e->area.y2);
+        } else if (e->dx < 0) {
+            guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS, e->area.x1, e->area.y1, e->area.x1 - e->dx, e->area.y2);
+        } else {
+            guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS, e->area.x1, e->area.y1, e->area.x2, e->area.y2);
+        }
+        set_redraw(e->h);                           /* Draw widget inside dirty regions */
+        GUI.flags |= GUI_FLAG_REDRAW;
+        if (e->dx || e->dy) {
+            GUI.ScrollList[cnt++] = *e;            /* Keep entry for pixels copy */
+        }
+    }
+    GUI.ScrollCount = cnt;
+    
+    /* Complete redraw of one widget adds regions which may overlap other operations */
+    do {
+        cnt = GUI.ScrollCount;
+        for (i = 0; i < GUI.ScrollCount; ) {
+            if (scroll_isoverdrawn(&GUI.ScrollList[i])) {
+                resolve_invalidate(GUI.ScrollList[i].h);
+                GUI.ScrollList[i] = GUI.ScrollList[--GUI.ScrollCount];
+            } else {
+                i++;
+            }
+        }
+    } while (cnt != GUI.ScrollCount);
+}
+
+/**
+ * \brief           Move already drawn pixels of scrolled areas
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack after redraw, before drawing layer is set as active.
+ *                  Moved areas are added to list of regions changed on drawing layer
+ * \param[in]       src: Layer with last shown frame
+ * \param[in,out]   dst: Layer with frame being drawn
+ */
+void
+guii_widget_blitscrolled(gui_layer_t* src, gui_layer_t* dst) {
+    gui_widget_scroll_t* e;
+    gui_dim_t width, rows, sx, sy, dx, dy;
+    size_t i;
+    
+    for (i = 0; i < GUI.ScrollCount; i++) {
+        e = &GUI.ScrollList[i];
+        width = e->area.x2 - e->area.x1 - GUI_ABS(e->dx);
+        rows = e->area.y2 - e->area.y1 - GUI_ABS(e->dy);
+        if (e->dy > 0) {                            /* Content moves up */
+            sy = e->area.y1 + e->dy;
+            dy = e->area.y1;
+        } else {                                    /* Content moves down */
+            sy = e->area.y1;
+            dy = e->area.y1 - e->dy;
+        }
+        if (e->dx > 0) {                            /* Content moves left */
+            sx = e->area.x1 + e->dx;
+            dx = e->area.x1;
+        } else {                                    /* Content moves right */
+            sx = e->area.x1;
+            dx = e->area.x1 - e->dx;
+        }
+#if GUI_CFG_LCD_ROTATION
+        {
+            gui_dim_t w = width, h = rows;
+            
+            guii_lcd_maprect(&sx, &sy, &w, &h);     /* Moved area stays rectangle in display memory */
+            guii_lcd_maprect(&dx, &dy, &width, &rows);
+        }
+#endif /* GUI_CFG_LCD_ROTATION */
+        GUI.ll.Copy(&GUI.lcd, dst,
+            (void *)(src->start_address + src->pixel_size * (sy * src->width + sx)), /* Source address */
+            (void *)(dst->start_address + dst->pixel_size * (dy * dst->width + dx)), /* Destination address */
+            width, rows,                            /* Area size */
+            src->width - width,                     /* Offline source */
+            dst->width - width                      /* Offline destination */
+        );
+        guii_widget_addrect(dst->display, &dst->display_count, GUI_CFG_DISPLAY_DIRTY_RECTS, e->area.x1, e->area.y1, e->area.x2, e->area.y2);
+    }
+    GUI.ScrollCount = 0;
+}
+#endif /* GUI_CFG_WIDGET_SCROLL_QUEUE_SIZE || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_SAVE_UNDER || __DOXYGEN__
+/**
+ * \brief           Save pixels below widget before its popup part is drawn
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called after widget has grown to popup size. Pixels are saved on next drawing of widget
+ *                  when its complete area is drawn in one region. Only one popup uses saved pixels at a time
+ * \param[in,out]   h: Widget handle
+ * \return          `1` when pixels will be saved, `0` otherwise
+ * \sa              guii_widget_restoreunder
+ */
+uint8_t
+guii_widget_saveunder(gui_handle_p h) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    
+    /* Drawing layer does not keep complete frame or is not accessed by GUI thread */
+    if (GUI_CFG_LCD_BAND || GUI_CFG_LCD_TILE || GUI_CFG_OS_RENDER_THREAD || GUI.ll.Copy == NULL || under.restore) {
+        return 0;
+    }
+    if (under.h != NULL) {                          /* Other popup redraws its parent on close */
+        under_free();
+    }
+    under.h = h;
+    guii_widget_setflag(h, GUI_FLAG_SAVE_UNDER);
+    return 1;
+}
+
+/**
+ * \brief           Restore pixels below popup part of widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called before widget shrinks back from popup size.
+ *                  Widgets above popup area are redrawn on top of restored pixels
+ * \param[in,out]   h: Widget handle
+ * \return          `1` when pixels are restored on next redraw, `0` when parent must be redrawn instead
+ * \sa              guii_widget_saveunder
+ */
+uint8_t
+guii_widget_restoreunder(gui_handle_p h) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    
+    if (under.h != h) {
+        return 0;
+    }
+    if (!under.valid) {                             /* Content below popup changed */
+        under_free();
+        return 0;
+    }
+    guii_widget_clrflag(h, GUI_FLAG_SAVE_UNDER);
+    under.restore = 1;
+    invalidate_widget(h, 0);                        /* Widgets above popup area are drawn again */
+    guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS,
+        under.area.x1, under.area.y1, under.area.x2, under.area.y2);
+    return 1;
+}
+
+/**
+ * \brief           Save pixels below widget when requested with \ref guii_widget_saveunder
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack before widget is drawn, widgets below it are already drawn
+ * \param[in,out]   h: Widget handle
+ */
+void
+guii_widget_captureunder(gui_handle_p h) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    gui_dim_t x1, y1, x2, y2, width, height;
+    
+    guii_widget_clrflag(h, GUI_FLAG_SAVE_UNDER);    /* Pixels are saved once */
+    if (under.h != h) {
+        return;
+    }
+    get_lcd_abs_position_and_visible_width_height(h, &x1, &y1, &x2, &y2);
+    if (x1 < GUI.Display.x1 || y1 < GUI.Display.y1 || x2 > GUI.Display.x2 || y2 > GUI.Display.y2
+#if GUI_CFG_USE_TRANSPARENCY
+        || GUI.LayerStackDepth                      /* Widget is drawn to temporary layer */
+#endif /* GUI_CFG_USE_TRANSPARENCY */
+        || x1 >= x2 || y1 >= y2) {
+        return;                                     /* Area below widget is not drawn completely */
+    }
+    width = x2 - x1;
+    height = y2 - y1;
+    GUI_MEM_TAGGED(GUI_MEM_TAG_SAVE_UNDER,
+        under.data = GUI_MEMALLOC_NOZERO_HINT((size_t)width * (size_t)height * layer->pixel_size, GUI_MEM_BULK));
+    if (under.data == NULL) {
+        return;
+    }
+    under.area.x1 = x1;
+    under.area.y1 = y1;
+    under.area.x2 = x2;
+    under.area.y2 = y2;
+    under.format = layer->pixel_format;
+#if GUI_CFG_LCD_ROTATION
+    guii_lcd_maprect(&x1, &y1, &width, &height);    /* Copy rectangle as it is in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI.ll.Copy(&GUI.lcd, layer,
+        (void *)(layer->start_address + layer->pixel_size * ((y1 - layer->y_offset) * layer->width + (x1 - layer->x_offset))),
+        under.data,
+        width, height,                              /* Area size */
+        layer->width - width,                       /* Offline source */
+        0                                           /* Offline destination */
+    );
+    under.valid = 1;
+}
+
+/**
+ * \brief           Copy saved pixels back below closed popup
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack after unchanged regions are copied from last frame, before widgets are drawn
+ * \param[in,out]   dst: Layer with frame being drawn
+ */
+void
+guii_widget_blitunder(gui_layer_t* dst) {
+    gui_dim_t x, y, width, height;
+    
+    if (!under.restore) {
+        return;
+    }
+    if (under.format == dst->pixel_format) {
+        x = under.area.x1;
+        y = under.area.y1;
+        width = under.area.x2 - under.area.x1;
+        height = under.area.y2 - under.area.y1;
+#if GUI_CFG_LCD_ROTATION
+        guii_lcd_maprect(&x, &y, &width, &height);  /* Area is saved as it is in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+        GUI.ll.Copy(&GUI.lcd, dst,
+            under.data,                             /* Source address */
+            (void *)(dst->start_address + dst->pixel_size * (y * dst->width + x)),  /* Destination address */
+            width, height,                          /* Area size */
+            0,                                      /* Offline source */
+            dst->width - width                      /* Offline destination */
+        );
+    }
+    under_free();
+}
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER || __DOXYGEN__ */
+
+/**
+ * \brief           Invalidate widget and parent widget for redraw 
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ * \hideinitializer
+ */
+uint8_t
+guii_widget_invalidatewithparent(gui_handle_p h) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    if (GUI.BatchLevel) {                           /* Resolved on batch commit */
+        if (!guii_widget_getflag(h, GUI_FLAG_IGNORE_INVALIDATE)) {
+            batch_addwidget(h);
+        }
+        return 1;
+    }
+    invalidate_widget(h, 1);                        /* Invalidate object with clipping */
+    if (guii_widget_hasparent(h)) {                 /* If parent exists, invalid only parent */
+        invalidate_widget(guii_widget_getparent(h), 0); /* Invalidate parent object without clipping */
+    }
+    return 1;
+}
+
+/**
+ * \brief           Set if parent widget should be invalidated when we invalidate primary widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Useful for widgets where there is no background: Transparent images, textview, slider, etc
+ * \param[in]       h: Widget handle
+ * \param[in]       value: Value either to enable or disable. 0 = disable, > 0 = enable
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_setinvalidatewithparent(gui_handle_p h, uint8_t value) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    if (value) {                                    /* On positive value */
+        guii_widget_setflag(h, GUI_FLAG_WIDGET_INVALIDATE_PARENT); /* Enable auto invalidation of parent widget */
+    } else {                                        /* On zero */
+        guii_widget_clrflag(h, GUI_FLAG_WIDGET_INVALIDATE_PARENT); /* Disable auto invalidation of parent widget */
+    }
+    return 1;
+}
+
+/**
+ * \brief           Set 3D mode on widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \param[in]       enable: Value to enable, either 1 or 0
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_set3dstyle(gui_handle_p h, uint8_t enable) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    if (enable && !guii_widget_getflag(h, GUI_FLAG_3D)) {  /* Enable style */
+        guii_widget_setflag(h, GUI_FLAG_3D);        /* Enable 3D style */
+        guii_widget_invalidate(h);                  /* Invalidate object */
+    } else if (!enable && guii_widget_getflag(h, GUI_FLAG_3D)) {/* Disable style */
+        guii_widget_clrflag(h, GUI_FLAG_3D);        /* Disable 3D style */
+        guii_widget_invalidate(h);                  /* Invalidate object */
+    }
+    return 1;
+}
+
+/**
+ * \brief           Enable or disable retained bitmap for widget and its children
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Widget is drawn once to bitmap in RAM and copied from it on next redraws,
+ *                  until widget or any of its children is invalidated.
+ *                  Bitmap is used only for opaque widgets when they are completely visible.
+ *                  Change of transparency keeps bitmap valid, faded widget is blended from it
+ * \note            Not available with \ref GUI_CFG_OS_RENDER_THREAD, GUI thread has no access to pixels,
+ *                  and with \ref GUI_CFG_LCD_TILE_CORES greater than `1`, where tiles are drawn from display list only
+ * \param[in,out]   h: Widget handle
+ * \param[in]       enable: Value to enable, either 1 or 0
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_setretained(gui_handle_p h, uint8_t enable) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+#if GUI_CFG_OS_RENDER_THREAD || (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1)
+    if (enable) {
+        return 0;
+    }
+#endif /* GUI_CFG_OS_RENDER_THREAD || (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1) */
+    if (enable) {
+        if (guii_widget_getext(h) == NULL) {        /* Bitmap is kept in rarely used values */
+            return 0;
+        }
+        guii_widget_setflag(h, GUI_FLAG_RETAINED);  /* Bitmap is created on next complete redraw */
+    } else {
+        guii_widget_clrflag(h, GUI_FLAG_RETAINED | GUI_FLAG_RETAINED_VALID);
+        if (h->ext != NULL && h->ext->retained != NULL) {
+            guii_ll_waitready();                    /* Bitmap may still be read by low-level */
+            GUI_MEMFREE(h->ext->retained);
+        }
+    }
+    return 1;
+}
+
+#if GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__
+
+/**
+ * \brief           Enable or disable display list for widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \param[in]       enable: Value to enable, either 1 or 0
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_setdisplaylist(gui_handle_p h, uint8_t enable) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    if (enable) {
+        if (guii_widget_getext(h) == NULL) {        /* List is kept in rarely used values */
+            return 0;
+        }
+        guii_widget_setflag(h, GUI_FLAG_DISPLAY_LIST);  /* List is recorded on next complete redraw */
+    } else {
+        guii_widget_clrflag(h, GUI_FLAG_DISPLAY_LIST | GUI_FLAG_DISPLAY_LIST_VALID);
+        if (h->ext != NULL) {
+            if (h->ext->dlist.data != NULL) {
+                GUI_MEMFREE(h->ext->dlist.data);
+            }
+            h->ext->dlist.len = h->ext->dlist.size = 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Draw widget from its display list, list is recorded first when it is not valid
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            List is recorded for complete visible part of widget without drawing,
+ *                  it is replayed while widget is not invalidated and its visible part does not change.
+ *                  Widget callback is this way called once even when widget is drawn in many smaller regions
+ * \param[in,out]   h: Widget handle
+ * \param[in]       disp: Clipping region of widget
+ * \return          `1` if widget was drawn, `0` if it must be drawn normally with callback
+ */
+uint8_t
+guii_widget_drawlist(gui_handle_p h, gui_display_t* disp) {
+    gui_handle_ext_t* ext = h->ext;
+    gui_display_t vis;
+    
+    if (ext == NULL) {
+        return 0;
+    }
+    get_lcd_abs_position_and_visible_width_height(h, &vis.x1, &vis.y1, &vis.x2, &vis.y2);
+    if (!guii_widget_getflag(h, GUI_FLAG_DISPLAY_LIST_VALID) || memcmp(&vis, &ext->dlist_disp, sizeof(vis))) {
+        guii_widget_clrflag(h, GUI_FLAG_DISPLAY_LIST_VALID);    /* Widget moved or its visible part changed */
+        
+        guii_draw_dlist_begin(&ext->dlist);
+        GUI_WIDGET_PARAMTYPE_DISP(&GUI.WidgetParam) = &vis;
+        guii_widget_callback(h, GUI_WC_Draw, &GUI.WidgetParam, &GUI.WidgetResult);
+        if (!guii_draw_dlist_end()) {
+            return 0;                               /* Not enough memory, nothing was drawn */
+        }
+        ext->dlist_disp = vis;
+        guii_widget_setflag(h, GUI_FLAG_DISPLAY_LIST_VALID);
+    }
+    guii_draw_dlist_replay(&ext->dlist, disp);              /* Draw without widget callback */
+    return 1;
+}
+
+#endif /* GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__ */
+
+#define BACKGROUND_RECTS            16              /* Maximal number of rectangles of exposed background */
+
+/**
+ * \brief           Fill background of widget, except areas covered by opaque children widgets
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Children widgets are always drawn after parent widget, pixels below opaque ones would be overwritten anyway.
+ *                  Parts which cannot be split anymore are filled completely
+ * \param[in]       h: Widget handle
+ * \param[in]       disp: Clipping region of widget
+ * \param[in]       x: Top left X position of background
+ * \param[in]       y: Top left Y position of background
+ * \param[in]       width: Background width
+ * \param[in]       height: Background height
+ * \param[in]       color: Background color
+ */
+void
+guii_widget_drawbackground(gui_handle_p h, const gui_display_t* disp, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_color_t color) {
+    gui_display_t r[BACKGROUND_RECTS], *a, v, c;
+    gui_ll_rect_t rects[BACKGROUND_RECTS];
+    gui_handle_p t;
+    size_t i, cnt = 1, n;
+    
+    r[0].x1 = GUI_MAX(disp->x1, x);                 /* Visible part of background */
+    r[0].y1 = GUI_MAX(disp->y1, y);
+    r[0].x2 = GUI_MIN(disp->x2, x + width);
+    r[0].y2 = GUI_MIN(disp->y2, y + height);
+    if (r[0].x1 >= r[0].x2 || r[0].y1 >= r[0].y2) {
+        return;
+    }
+    
+    /* Recorded commands are replayed without children when they move */
+#if GUI_CFG_USE_DISPLAY_LIST
+    if (!guii_widget_getflag(h, GUI_FLAG_DISPLAY_LIST))
+#endif /* GUI_CFG_USE_DISPLAY_LIST */
+    {
+        for (t = gui_linkedlist_widgetgetnext((gui_handle_root_t *)h, NULL); t != NULL; t = gui_linkedlist_widgetgetnext(NULL, t)) {
+            if (!guii_widget_isvisible(t) || !guii_widget_isopaque(t)) {
+                continue;
+            }
+            get_lcd_abs_position_and_visible_width_height(t, &v.x1, &v.y1, &v.x2, &v.y2);
+            if (v.x1 >= v.x2 || v.y1 >= v.y2) {
+                continue;                           /* Child is hidden by parents */
+            }
+            
+            /* Cut child area out of each rectangle, up to 4 pieces remain */
+            for (i = 0; i < cnt; ) {
+                a = &r[i];
+                if (v.x1 >= a->x2 || v.x2 <= a->x1 || v.y1 >= a->y2 || v.y2 <= a->y1) {
+                    i++;
+                    continue;                       /* Child does not overlap rectangle */
+                }
+                n = (v.y1 > a->y1) + (v.y2 < a->y2) + (v.x1 > a->x1) + (v.x2 < a->x2);
+                if (cnt - 1 + n > GUI_COUNT_OF(r)) {
+                    i++;
+                    continue;                       /* No space for pieces, fill rectangle completely */
+                }
+                c.x1 = GUI_MAX(v.x1, a->x1);        /* Covered part of rectangle */
+                c.y1 = GUI_MAX(v.y1, a->y1);
+                c.x2 = GUI_MIN(v.x2, a->x2);
+                c.y2 = GUI_MIN(v.y2, a->y2);
+                if (c.y1 > a->y1) {                 /* Part above child */
+                    r[cnt].x1 = a->x1; r[cnt].y1 = a->y1; r[cnt].x2 = a->x2; r[cnt].y2 = c.y1;
+                    cnt++;
+                }
+                if (c.y2 < a->y2) {                 /* Part below child */
+                    r[cnt].x1 = a->x1; r[cnt].y1 = c.y2; r[cnt].x2 = a->x2; r[cnt].y2 = a->y2;
+                    cnt++;
+                }
+                if (c.x1 > a->x1) {                 /* Part left of child */
+                    r[cnt].x1 = a->x1; r[cnt].y1 = c.y1; r[cnt].x2 = c.x1; r[cnt].y2 = c.y2;
+                    cnt++;
+                }
+                if (c.x2 < a->x2) {                 /* Part right of child */
+                    r[cnt].x1 = c.x2; r[cnt].y1 = c.y1; r[cnt].x2 = a->x2; r[cnt].y2 = c.y2;
+                    cnt++;
+                }
+                r[i] = r[--cnt];                    /* Replace rectangle with last one, new pieces are checked too */
+            }
+        }
+    }
+    
+    for (i = 0; i < cnt; i++) {
+        rects[i].x = r[i].x1;
+        rects[i].y = r[i].y1;
+        rects[i].width = r[i].x2 - r[i].x1;
+        rects[i].height = r[i].y2 - r[i].y1;
+        rects[i].color = color;
+    }
+    gui_draw_filledrectangles(disp, rects, cnt);
+}
+
+#if GUI_CFG_WIDGET_STATICS || __DOXYGEN__
+
+/**
+ * \brief           Draw static elements of widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Called by GUI stack after widget is drawn, before its children widgets
+ * \param[in]       h: Widget handle
+ * \param[in]       disp: Clipping region of widget
+ */
+void
+guii_widget_drawstatics(gui_handle_p h, const gui_display_t* disp) {
+    const gui_static_t* s;
+    gui_display_t clip;
+    gui_draw_font_t f;
+    gui_dim_t x, y;
+    size_t i;
+    
+    if (!guii_widget_allowchildren(h) || __GHR(h)->statics == NULL) {
+        return;
+    }
+    
+    /* Elements are clipped to inner area of widget, as children widgets are */
+    x = guii_widget_getabsolutex(h) + guii_widget_getpaddingleft(h);
+    y = guii_widget_getabsolutey(h) + guii_widget_getpaddingtop(h);
+    clip.x1 = GUI_MAX(disp->x1, x);
+    clip.y1 = GUI_MAX(disp->y1, y);
+    clip.x2 = GUI_MIN(disp->x2, x + guii_widget_getinnerwidth(h));
+    clip.y2 = GUI_MIN(disp->y2, y + guii_widget_getinnerheight(h));
+    if (clip.x1 >= clip.x2 || clip.y1 >= clip.y2) {
+        return;
+    }
+    x -= __GHR(h)->x_scroll;                        /* Elements scroll together with children */
+    y -= __GHR(h)->y_scroll;
+    
+    for (i = 0; i < __GHR(h)->statics_count; i++) {
+        s = &__GHR(h)->statics[i];
+        if (!__GUI_RECT_MATCH(clip.x1, clip.y1, clip.x2, clip.y2,
+            x + s->x, y + s->y, x + s->x + s->width, y + s->y + s->height)) {
+            continue;                               /* Element is not in region being drawn */
+        }
+        switch (s->type) {
+            case GUI_STATIC_TEXT:
+                if (s->data != NULL && guii_widget_getfont(h) != NULL) {
+                    gui_draw_font_init(&f);         /* Init structure */
+                    f.x = x + s->x;
+                    f.y = y + s->y;
+                    f.width = s->width;
+                    f.height = s->height;
+                    if (s->align) {
+                        f.align = s->align;
+                    }
+                    f.color1width = f.width;
+                    f.color1 = s->color;
+                    gui_draw_writetext(&clip, guii_widget_getfont(h), (const gui_char *)s->data, &f);
+                }
+                break;
+            case GUI_STATIC_IMAGE:
+                if (s->data != NULL) {
+                    gui_draw_image(&clip, x + s->x, y + s->y, (const gui_image_desc_t *)s->data);
+                }
+                break;
+            case GUI_STATIC_RECT:
+                gui_draw_filledrectangle(&clip, x + s->x, y + s->y, s->width, s->height, s->color);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+#endif /* GUI_CFG_WIDGET_STATICS || __DOXYGEN__ */
+
+/**
+ * \brief           Draw widget from retained bitmap
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle
+ * \param[in]       disp: Clipping region of widget
+ * \return          `1` if widget was drawn from bitmap, `0` if it must be drawn normally
+ */
+uint8_t
+guii_widget_drawretained(gui_handle_p h, const gui_display_t* disp) {
+    gui_handle_ext_t* ext = h->ext;
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    gui_dim_t x, y, width, height, sx, sy, stride;
+    
+    if (ext == NULL || !guii_widget_getflag(h, GUI_FLAG_RETAINED_VALID) || !guii_widget_iscontentopaque(h) ||
+        ext->retained_width != guii_widget_getwidth(h) || ext->retained_height != guii_widget_getheight(h) ||
+        ext->retained_format != layer->pixel_format) {
+        return 0;
+    }
+#if GUI_CFG_LCD_CLUT
+    if (ext->retained_palette != GUI.lcd.palette_id) {
+        return 0;
+    }
+#endif /* GUI_CFG_LCD_CLUT */
+    x = disp->x1;
+    y = disp->y1;
+    sx = disp->x1 - guii_widget_getabsolutex(h);
+    sy = disp->y1 - guii_widget_getabsolutey(h);
+    width = disp->x2 - disp->x1;
+    height = disp->y2 - disp->y1;
+    stride = ext->retained_width;
+#if GUI_CFG_LCD_ROTATION
+    if (ext->retained_rotation != GUI.lcd.rotation) {
+        return 0;
+    }
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {   /* Bitmap is saved as it is in display memory */
+        gui_dim_t w = width, hh = height;
+        
+        guii_lcd_rotaterect(GUI.lcd.rotation, ext->retained_width, ext->retained_height, &sx, &sy, &w, &hh);
+        guii_lcd_maprect(&x, &y, &width, &height);
+        if (GUI.lcd.rotation & 0x01) {
+            stride = ext->retained_height;
+        }
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+#if GUI_CFG_USE_TRANSPARENCY
+    if (guii_widget_gettransparency(h) < 0xFF) {    /* Fading widget is blended from bitmap, children are not drawn again */
+        if (GUI.ll.CopyBlend == NULL) {
+            return 0;
+        }
+        GUI.ll.CopyBlend(&GUI.lcd, layer,
+            ext->retained + layer->pixel_size * (sy * stride + sx),
+            (void *)(layer->start_address + layer->pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset))),
+            guii_widget_gettransparency(h), 0xFF,
+            width, height,
+            stride - width,
+            layer->width - width
+        );
+        return 1;
+    }
+#endif /* GUI_CFG_USE_TRANSPARENCY */
+    GUI.ll.Copy(&GUI.lcd, layer,
+        ext->retained + layer->pixel_size * (sy * stride + sx),  /* Source address */
+        (void *)(layer->start_address + layer->pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset))),
+        width, height,                              /* Area size */
+        stride - width,                             /* Offline source */
+        layer->width - width                        /* Offline destination */
+    );
+    return 1;
+}
+
+#if GUI_CFG_MEM_RECLAIM || __DOXYGEN__
+
+static gui_mem_reclaim_t retained_reclaim;
+
+/**
+ * \brief           Free retained bitmaps of widgets in tree
+ * \param[in]       parent: Parent widget handle. Set to `NULL` to use root
+ * \param[in]       size: Number of bytes to release
+ * \param[in]       visible: Set to `0` to free bitmaps of hidden widgets or `1` for visible ones
+ * \param[in,out]   released: Number of already released bytes
+ */
+static void
+retained_release(gui_handle_p parent, size_t size, uint8_t visible, size_t* released) {
+    gui_handle_p h;
+    
+    for (h = gui_linkedlist_widgetgetnext(__GHR(parent), NULL); h != NULL && *released < size;
+            h = gui_linkedlist_widgetgetnext(NULL, h)) {
+        if (h->ext != NULL && h->ext->retained != NULL
+            && visible == (guii_widget_isvisible(h) && !guii_widget_isparenthidden(h))) {
+            guii_widget_clrflag(h, GUI_FLAG_RETAINED_VALID);    /* Widget is drawn normally and saved again */
+            guii_ll_waitready();                    /* Bitmap may still be read by low-level */
+            *released += (size_t)h->ext->retained_width * (size_t)h->ext->retained_height * GUI.lcd.drawing_layer->pixel_size;
+            GUI_MEMFREE(h->ext->retained);
+        }
+        if (guii_widget_allowchildren(h)) {
+            retained_release(h, size, visible, released);
+        }
+    }
+}
+
+/**
+ * \brief           Memory reclaimer of retained bitmaps, bitmaps of hidden widgets are released first
+ * \param[in]       size: Number of bytes of failed allocation
+ * \param[in]       arg: Unused
+ * \return          Number of released bytes
+ */
+static size_t
+retained_reclaim_fn(size_t size, void* arg) {
+    size_t released = 0;
+    
+    GUI_UNUSED(arg);
+    retained_release(NULL, size, 0, &released);
+    retained_release(NULL, size, 1, &released);
+    return released;
+}
+
+#endif /* GUI_CFG_MEM_RECLAIM || __DOXYGEN__ */
+
+/**
+ * \brief           Save drawn widget to retained bitmap
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Bitmap is saved only when complete widget was drawn in clipping region
+ * \param[in,out]   h: Widget handle
+ * \param[in]       disp: Clipping region widget was drawn in
+ */
+void
+guii_widget_saveretained(gui_handle_p h, const gui_display_t* disp) {
+    gui_handle_ext_t* ext = h->ext;
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    gui_dim_t x, y, width, height;
+    
+    /* Transparent widget is drawn to temporary layer, which holds its content before blending */
+    if (ext == NULL || !guii_widget_iscontentopaque(h) || GUI.ll.Copy == NULL) {
+        return;
+    }
+    x = guii_widget_getabsolutex(h);
+    y = guii_widget_getabsolutey(h);
+    width = guii_widget_getwidth(h);
+    height = guii_widget_getheight(h);
+    if (disp->x1 != x || disp->y1 != y || disp->x2 != x + width || disp->y2 != y + height) {
+        return;                                     /* Widget is not completely visible */
+    }
+    if (ext->retained == NULL || ext->retained_width != width || ext->retained_height != height ||
+        ext->retained_format != layer->pixel_format) {
+        if (ext->retained != NULL) {
+            guii_ll_waitready();                    /* Old bitmap may still be read by low-level */
+            GUI_MEMFREE(ext->retained);
+        }
+#if GUI_CFG_MEM_RECLAIM
+        if (!retained_reclaim.added) {
+            gui_mem_reclaim_add(&retained_reclaim, retained_reclaim_fn, NULL, GUI_MEM_RECLAIM_PRIO_RETAINED);
+        }
+#endif /* GUI_CFG_MEM_RECLAIM */
+        GUI_MEM_TAGGED(GUI_MEM_TAG_RETAINED,
+            ext->retained = GUI_MEMALLOC_NOZERO_HINT((size_t)width * (size_t)height * layer->pixel_size, GUI_MEM_BULK));
+        if (ext->retained == NULL) {
+            return;
+        }
+        ext->retained_width = width;
+        ext->retained_format = layer->pixel_format;
+        ext->retained_height = height;
+    }
+#if GUI_CFG_LCD_CLUT
+    ext->retained_palette = GUI.lcd.palette_id;
+#endif /* GUI_CFG_LCD_CLUT */
+#if GUI_CFG_LCD_ROTATION
+    ext->retained_rotation = GUI.lcd.rotation;
+    guii_lcd_maprect(&x, &y, &width, &height);      /* Copy rectangle as it is in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI.ll.Copy(&GUI.lcd, layer,
+        (void *)(layer->start_address + layer->pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset))),
+        ext->retained,
+        width, height,                              /* Area size */
+        layer->width - width,                       /* Offline source */
+        0                                           /* Offline destination */
+    );
+    guii_widget_setflag(h, GUI_FLAG_RETAINED_VALID);
+}
+
+/**
+ * \brief           Add bytes to FNV-1a hash
+ * \note            Start with `0x811C9DC5` for new hash
+ * \param[in]       hash: Current hash value
+ * \param[in]       data: Data to add
+ * \param[in]       len: Number of bytes to add
+ * \return          New hash value
+ */
+uint32_t
+guii_widget_hash(uint32_t hash, const void* data, size_t len) {
+    const uint8_t* p = data;
+    while (len--) {
+        hash = (hash ^ *p++) * 0x01000193;
+    }
+    return hash;
+}
+
+/**
+ * \brief           Copy static part of widget from bitmap to visible region
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Key must include everything pixels depend on, except pixel format, screen rotation and display palette
+ * \param[in]       h: Widget handle
+ * \param[in]       bmp: Bitmap saved with \ref guii_widget_savebitmap
+ * \param[in]       key: Hash of current widget state
+ * \param[in]       disp: Clipping region
+ * \return          `1` if bitmap was copied, `0` if static part must be drawn normally
+ */
+uint8_t
+guii_widget_drawbitmap(gui_handle_p h, const gui_widget_bitmap_t* bmp, uint32_t key, const gui_display_t* disp) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    gui_dim_t x, y, width, height, sx, sy, stride;
+    
+    key = guii_widget_hash(key, &layer->pixel_format, sizeof(layer->pixel_format));
+#if GUI_CFG_LCD_ROTATION
+    key = guii_widget_hash(key, &GUI.lcd.rotation, sizeof(GUI.lcd.rotation));
+#endif /* GUI_CFG_LCD_ROTATION */
+#if GUI_CFG_LCD_CLUT
+    key = guii_widget_hash(key, &GUI.lcd.palette_id, sizeof(GUI.lcd.palette_id));
+#endif /* GUI_CFG_LCD_CLUT */
+    if (!bmp->valid || bmp->key != key
+#if GUI_CFG_USE_DISPLAY_LIST
+        || guii_draw_dlist_isrecording()            /* Copy would not be part of recorded list */
+#endif /* GUI_CFG_USE_DISPLAY_LIST */
+    ) {
+        return 0;
+    }
+    x = GUI_MAX(disp->x1, guii_widget_getabsolutex(h));
+    y = GUI_MAX(disp->y1, guii_widget_getabsolutey(h));
+    width = GUI_MIN(disp->x2, guii_widget_getabsolutex(h) + guii_widget_getwidth(h)) - x;
+    height = GUI_MIN(disp->y2, guii_widget_getabsolutey(h) + guii_widget_getheight(h)) - y;
+    if (width <= 0 || height <= 0) {
+        return 1;                                   /* Nothing visible to copy */
+    }
+    sx = x - guii_widget_getabsolutex(h);
+    sy = y - guii_widget_getabsolutey(h);
+    stride = guii_widget_getwidth(h);
+#if GUI_CFG_LCD_ROTATION
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {   /* Bitmap is saved as it is in display memory */
+        gui_dim_t w = width, hh = height;
+        
+        guii_lcd_rotaterect(GUI.lcd.rotation, guii_widget_getwidth(h), guii_widget_getheight(h), &sx, &sy, &w, &hh);
+        guii_lcd_maprect(&x, &y, &width, &height);
+        if (GUI.lcd.rotation & 0x01) {
+            stride = guii_widget_getheight(h);
+        }
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI.ll.Copy(&GUI.lcd, layer,
+        bmp->data + layer->pixel_size * (sy * stride + sx), /* Source address */
+        (void *)(layer->start_address + layer->pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset))),
+        width, height,                              /* Area size */
+        stride - width,                             /* Offline source */
+        layer->width - width                        /* Offline destination */
+    );
+    return 1;
+}
+
+/**
+ * \brief           Save static part of widget drawn to layer to bitmap
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Bitmap is saved only when complete widget was drawn in clipping region.
+ *                  Static part must cover complete widget area with opaque pixels
+ * \param[in]       h: Widget handle
+ * \param[in,out]   bmp: Bitmap to save pixels to
+ * \param[in]       key: Hash of widget state pixels were drawn with
+ * \param[in]       tag: Memory tag for bitmap allocation
+ * \param[in]       disp: Clipping region static part was drawn in
+ * \return          `1` if bitmap was saved, `0` otherwise
+ */
+uint8_t
+guii_widget_savebitmap(gui_handle_p h, gui_widget_bitmap_t* bmp, uint32_t key, const char* tag, const gui_display_t* disp) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    gui_dim_t x, y, width, height;
+    size_t size;
+    
+    GUI_UNUSED(tag);
+    if (GUI.ll.Copy == NULL
+#if GUI_CFG_USE_DISPLAY_LIST
+        || guii_draw_dlist_isrecording()            /* Layer does not contain pixels yet */
+#endif /* GUI_CFG_USE_DISPLAY_LIST */
+    ) {
+        return 0;
+    }
+    x = guii_widget_getabsolutex(h);
+    y = guii_widget_getabsolutey(h);
+    width = guii_widget_getwidth(h);
+    height = guii_widget_getheight(h);
+    if (disp->x1 > x || disp->y1 > y || disp->x2 < x + width || disp->y2 < y + height) {
+        return 0;                                   /* Widget is not completely visible */
+    }
+    bmp->valid = 0;
+    size = (size_t)width * (size_t)height * layer->pixel_size;
+    if (bmp->data == NULL || bmp->size != size) {
+        guii_widget_freebitmap(bmp);
+        GUI_MEM_TAGGED(tag, bmp->data = GUI_MEMALLOC_NOZERO_HINT(size, GUI_MEM_BULK));
+        if (bmp->data == NULL) {
+            return 0;
+        }
+#if GUI_CFG_MEM_RELOC
+        gui_mem_setmovable((void **)&bmp->data);    /* Cache can be moved by heap compaction */
+#endif /* GUI_CFG_MEM_RELOC */
+        bmp->size = size;
+    }
+    bmp->key = guii_widget_hash(key, &layer->pixel_format, sizeof(layer->pixel_format));
+#if GUI_CFG_LCD_CLUT
+    bmp->key = guii_widget_hash(bmp->key, &GUI.lcd.palette_id, sizeof(GUI.lcd.palette_id));
+#endif /* GUI_CFG_LCD_CLUT */
+#if GUI_CFG_LCD_ROTATION
+    bmp->key = guii_widget_hash(bmp->key, &GUI.lcd.rotation, sizeof(GUI.lcd.rotation));
+    guii_lcd_maprect(&x, &y, &width, &height);      /* Copy rectangle as it is in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI.ll.Copy(&GUI.lcd, layer,
+        (void *)(layer->start_address + layer->pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset))),
+        bmp->data,
+        width, height,                              /* Area size */
+        layer->width - width,                       /* Offline source */
+        0                                           /* Offline destination */
+    );
+    bmp->valid = 1;
+    return 1;
+}
+
+/**
+ * \brief           Free memory of widget bitmap
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   bmp: Bitmap to free
+ */
+void
+guii_widget_freebitmap(gui_widget_bitmap_t* bmp) {
+    if (bmp->data != NULL) {
+        guii_ll_waitready();                        /* Bitmap may still be read by low-level */
+        GUI_MEMFREE(bmp->data);
+    }
+    bmp->size = 0;
+    bmp->valid = 0;
+}
+
+#if GUI_CFG_WIDGET_INSTANCE_CACHE || GUI_CFG_WIDGET_STATE_CACHE || __DOXYGEN__
+
+/* Rendered bitmap shared by identical widgets */
+typedef struct {
+    const gui_widget_t* widget;                     /*!< Widget type bitmap was drawn for */
+    uint32_t key;                                   /*!< Hash of widget state, colors, text and background */
+    gui_dim_t width;                                /*!< Width of bitmap in units of pixels */
+    gui_dim_t height;                               /*!< Height of bitmap in units of pixels */
+    uint8_t format;                                 /*!< Pixel format of bitmap, member of \ref gui_pixel_format_t */
+#if GUI_CFG_LCD_ROTATION
+    uint8_t rotation;                               /*!< Screen rotation bitmap was saved with */
+#endif /* GUI_CFG_LCD_ROTATION */
+#if GUI_CFG_LCD_CLUT
+    uint8_t palette;                                /*!< Display palette bitmap was saved with */
+#endif /* GUI_CFG_LCD_CLUT */
+    uint8_t* data;                                  /*!< Bitmap pixels, `NULL` when entry is free */
+    uint32_t used;                                  /*!< Value of use counter on last copy */
+} cache_entry_t;
+
+static uint32_t cache_used;                         /* Use counter to find least recently used entry */
+
+/**
+ * \brief           Find bitmap for current pixel format and rotation in cache
+ * \param[in]       cache: Cache entries
+ * \param[in]       count: Number of entries in cache
+ * \param[in]       widget: Widget type bitmap was drawn for
+ * \param[in]       key: Hash of widget state
+ * \param[in]       width: Width of bitmap in units of pixels
+ * \param[in]       height: Height of bitmap in units of pixels
+ * \return          Entry marked as recently used, `NULL` if not found
+ */
+static cache_entry_t*
+cache_find(cache_entry_t* cache, size_t count, const gui_widget_t* widget, uint32_t key, gui_dim_t width, gui_dim_t height) {
+    cache_entry_t* e;
+    
+    for (e = cache; e < cache + count; e++) {
+        if (e->data == NULL || e->key != key || e->widget != widget ||
+            e->width != width || e->height != height || e->format != GUI.lcd.drawing_layer->pixel_format) {
+            continue;
+        }
+#if GUI_CFG_LCD_ROTATION
+        if (e->rotation != GUI.lcd.rotation) {
+            continue;
+        }
+#endif /* GUI_CFG_LCD_ROTATION */
+#if GUI_CFG_LCD_CLUT
+        if (e->palette != GUI.lcd.palette_id) {
+            continue;
+        }
+#endif /* GUI_CFG_LCD_CLUT */
+        e->used = ++cache_used;
+        return e;
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Save rectangle of drawing layer to cache
+ * \note            Least recently used bitmap is replaced
+ * \param[in]       cache: Cache entries
+ * \param[in]       count: Number of entries in cache
+ * \param[in]       tag: Memory tag for bitmap allocation
+ * \param[in]       widget: Widget type bitmap was drawn for
+ * \param[in]       key: Hash of widget state
+ * \param[in]       x: Absolute X position of rectangle
+ * \param[in]       y: Absolute Y position of rectangle
+ * \param[in]       width: Rectangle width in units of pixels
+ * \param[in]       height: Rectangle height in units of pixels
+ */
+static void
+cache_save(cache_entry_t* cache, size_t count, const char* tag, const gui_widget_t* widget, uint32_t key,
+            gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    cache_entry_t *e, *victim = NULL;
+    
+    GUI_UNUSED(tag);
+    for (e = cache; e < cache + count; e++) {
+        if (victim == NULL || (victim->data != NULL && (e->data == NULL || e->used < victim->used))) {
+            victim = e;                             /* Free or least recently used entry */
+        }
+    }
+    if (victim->data == NULL || victim->width * victim->height != width * height || victim->format != layer->pixel_format) {
+        if (victim->data != NULL) {
+            guii_ll_waitready();                    /* Old bitmap may still be read by low-level */
+            GUI_MEMFREE(victim->data);
+        }
+        GUI_MEM_TAGGED(tag,
+            victim->data = GUI_MEMALLOC_NOZERO_HINT((size_t)width * (size_t)height * layer->pixel_size, GUI_MEM_BULK));
+        if (victim->data == NULL) {
+            return;
+        }
+    } else {
+        guii_ll_waitready();                        /* Bitmap may still be read by low-level */
+    }
+    victim->widget = widget;
+    victim->key = key;
+    victim->width = width;
+    victim->height = height;
+    victim->format = layer->pixel_format;
+    victim->used = ++cache_used;
+#if GUI_CFG_LCD_CLUT
+    victim->palette = GUI.lcd.palette_id;
+#endif /* GUI_CFG_LCD_CLUT */
+#if GUI_CFG_LCD_ROTATION
+    victim->rotation = GUI.lcd.rotation;
+    guii_lcd_maprect(&x, &y, &width, &height);      /* Copy rectangle as it is in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI.ll.Copy(&GUI.lcd, layer,
+        (void *)(layer->start_address + layer->pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset))),
+        victim->data,
+        width, height,                              /* Area size */
+        layer->width - width,                       /* Offline source */
+        0                                           /* Offline destination */
+    );
+}
+
+#endif /* GUI_CFG_WIDGET_INSTANCE_CACHE || GUI_CFG_WIDGET_STATE_CACHE || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_INSTANCE_CACHE || __DOXYGEN__
+
+static cache_entry_t instance_cache[GUI_CFG_WIDGET_INSTANCE_CACHE];
+
+/**
+ * \brief           Calculate key of everything instanced widget drawing depends on
+ * \note            Pixels below widget are part of key when widget does not cover its area
+ * \param[in]       h: Widget handle
+ * \param[in]       x: Absolute X position of widget
+ * \param[in]       y: Absolute Y position of widget
+ * \param[in]       width: Widget width in units of pixels
+ * \param[in]       height: Widget height in units of pixels
+ * \return          Key of widget, never `0`
+ */
+static uint32_t
+instance_key(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height) {
+    uint32_t hash = 0x811C9DC5, v;
+    const gui_font_t* font;
+    const gui_char* text;
+    gui_color_t color;
+    gui_dim_t radius;
+    uint8_t i;
+    
+    v = guii_widget_getflag(h, GUI_FLAG_ACTIVE | GUI_FLAG_FOCUS | GUI_FLAG_DISABLED | GUI_FLAG_3D);
+    hash = guii_widget_hash(hash, &v, sizeof(v));
+    v = guii_widget_getpaddingvalue(h);
+    hash = guii_widget_hash(hash, &v, sizeof(v));
+    radius = guii_widget_getborderradius(h, 0);
+    hash = guii_widget_hash(hash, &radius, sizeof(radius));
+    hash = guii_widget_hash(hash, &h->callback, sizeof(h->callback));
+    font = guii_widget_getfont(h);
+    hash = guii_widget_hash(hash, &font, sizeof(font));
+    for (i = 0; i < h->widget->color_count; i++) {
+        color = guii_widget_getcolor(h, i);
+        hash = guii_widget_hash(hash, &color, sizeof(color));
+    }
+    text = guii_widget_gettext(h);
+    if (text != NULL) {
+        hash = guii_widget_hash(hash, text, gui_string_lengthtotal(text));
+    }
+    hash = guii_widget_hash(hash, (const uint8_t *)h + sizeof(gui_handle), h->widget->size - sizeof(gui_handle));  /* Widget specific values */
+    if (!guii_widget_isopaque(h)) {                 /* Parent shows through widget */
+        gui_layer_t* layer = GUI.lcd.drawing_layer;
+        const uint8_t* p;
+        
+#if GUI_CFG_LCD_ROTATION
+        guii_lcd_maprect(&x, &y, &width, &height);  /* Rectangle as it is in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+        guii_ll_waitready();                        /* Parent may still be drawn by low-level */
+        p = (const uint8_t *)(layer->start_address + layer->pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset)));
+        for (; height > 0; height--, p += layer->pixel_size * layer->width) {
+            hash = guii_widget_hash(hash, p, (size_t)width * layer->pixel_size);
+        }
+    }
+    return hash != 0 ? hash : 1;
+}
+
+/**
+ * \brief           Enable or disable drawing of widget from bitmap shared with identical widgets
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Not available with \ref GUI_CFG_OS_RENDER_THREAD and with \ref GUI_CFG_LCD_TILE_CORES greater than `1`,
+ *                  and for widgets which allow children
+ * \param[in,out]   h: Widget handle
+ * \param[in]       enable: Value to enable, either 1 or 0
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_setinstanced(gui_handle_p h, uint8_t enable) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+#if GUI_CFG_OS_RENDER_THREAD || (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1)
+    if (enable) {
+        return 0;
+    }
+#endif /* GUI_CFG_OS_RENDER_THREAD || (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1) */
+    if (enable) {
+        if (guii_widget_allowchildren(h)) {         /* Children are not part of key */
+            return 0;
+        }
+        guii_widget_setflag(h, GUI_FLAG_INSTANCED);
+    } else {
+        guii_widget_clrflag(h, GUI_FLAG_INSTANCED);
+    }
+    return 1;
+}
+
+/**
+ * \brief           Draw instanced widget from bitmap of identical widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in]       h: Widget handle
+ * \param[in]       disp: Clipping region of widget
+ * \param[out]      key: Key to save widget with after drawing, `0` when widget cannot be saved
+ * \return          `1` if widget was drawn from bitmap, `0` if it must be drawn normally
+ */
+uint8_t
+guii_widget_drawinstance(gui_handle_p h, const gui_display_t* disp, uint32_t* key) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    cache_entry_t* e;
+    gui_dim_t x, y, width, height;
+    
+    *key = 0;
+    x = guii_widget_getabsolutex(h);
+    y = guii_widget_getabsolutey(h);
+    width = guii_widget_getwidth(h);
+    height = guii_widget_getheight(h);
+    if (GUI.ll.Copy == NULL || guii_widget_allowchildren(h) ||
+        disp->x1 != x || disp->y1 != y || disp->x2 != x + width || disp->y2 != y + height) {
+        return 0;                                   /* Widget is not completely visible */
+    }
+#if GUI_CFG_USE_TRANSPARENCY
+    if (guii_widget_istransparent(h)) {
+        return 0;
+    }
+#endif /* GUI_CFG_USE_TRANSPARENCY */
+#if GUI_CFG_WIDGET_SAVE_UNDER
+    if (guii_widget_getflag(h, GUI_FLAG_SAVE_UNDER)) {
+        return 0;
+    }
+#endif /* GUI_CFG_WIDGET_SAVE_UNDER */
+    *key = instance_key(h, x, y, width, height);
+    e = cache_find(instance_cache, GUI_COUNT_OF(instance_cache), h->widget, *key, width, height);
+    if (e == NULL) {
+        return 0;
+    }
+#if GUI_CFG_LCD_ROTATION
+    guii_lcd_maprect(&x, &y, &width, &height);      /* Bitmap is saved as it is in display memory */
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI.ll.Copy(&GUI.lcd, layer,
+        e->data,                                    /* Source address */
+        (void *)(layer->start_address + layer->pixel_size * ((y - layer->y_offset) * layer->width + (x - layer->x_offset))),
+        width, height,                              /* Area size */
+        0,                                          /* Offline source */
+        layer->width - width                        /* Offline destination */
+    );
+    *key = 0;                                       /* Nothing to save */
+    return 1;
+}
+
+/**
+ * \brief           Save drawn instanced widget to bitmap shared with identical widgets
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Least recently used bitmap is replaced
+ * \param[in]       h: Widget handle
+ * \param[in]       key: Key returned by \ref guii_widget_drawinstance before widget was drawn
+ */
+void
+guii_widget_saveinstance(gui_handle_p h, uint32_t key) {
+    if (key) {
+        cache_save(instance_cache, GUI_COUNT_OF(instance_cache), GUI_MEM_TAG_INSTANCE, h->widget, key,
+            guii_widget_getabsolutex(h), guii_widget_getabsolutey(h), guii_widget_getwidth(h), guii_widget_getheight(h));
+    }
+}
+
+#endif /* GUI_CFG_WIDGET_INSTANCE_CACHE || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_STATE_CACHE || __DOXYGEN__
+
+static cache_entry_t state_cache[GUI_CFG_WIDGET_STATE_CACHE];
+
+/**
+ * \brief           Copy rectangle of state bitmap to drawing layer
+ * \param[in]       e: Cache entry with bitmap
+ * \param[in]       sx: X position of rectangle in bitmap
+ * \param[in]       sy: Y position of rectangle in bitmap
+ * \param[in]       x: Absolute X position of bitmap
+ * \param[in]       y: Absolute Y position of bitmap
+ * \param[in]       width: Rectangle width in units of pixels
+ * \param[in]       height: Rectangle height in units of pixels
+ * \param[in]       disp: Clipping region
+ */
+static void
+state_copy(const cache_entry_t* e, gui_dim_t sx, gui_dim_t sy, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, const gui_display_t* disp) {
+    gui_layer_t* layer = GUI.lcd.drawing_layer;
+    gui_dim_t x1, y1, stride = e->width;
+    
+    x1 = GUI_MAX(disp->x1, x + sx);
+    y1 = GUI_MAX(disp->y1, y + sy);
+    width = GUI_MIN(disp->x2, x + sx + width) - x1;
+    height = GUI_MIN(disp->y2, y + sy + height) - y1;
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    sx = x1 - x;
+    sy = y1 - y;
+#if GUI_CFG_LCD_ROTATION
+    if (GUI.lcd.rotation != GUI_LCD_ROTATION_0) {   /* Bitmap is saved as it is in display memory */
+        gui_dim_t w = width, h = height;
+        
+        guii_lcd_rotaterect(GUI.lcd.rotation, e->width, e->height, &sx, &sy, &w, &h);
+        guii_lcd_maprect(&x1, &y1, &width, &height);
+        if (GUI.lcd.rotation & 0x01) {
+            stride = e->height;
+        }
+    }
+#endif /* GUI_CFG_LCD_ROTATION */
+    GUI.ll.Copy(&GUI.lcd, layer,
+        e->data + layer->pixel_size * (sy * stride + sx),   /* Source address */
+        (void *)(layer->start_address + layer->pixel_size * ((y1 - layer->y_offset) * layer->width + (x1 - layer->x_offset))),
+        width, height,                              /* Area size */
+        stride - width,                             /* Offline source */
+        layer->width - width                        /* Offline destination */
+    );
+}
+
+/**
+ * \brief           Calculate key of state bitmap
+ * \param[in]       h: Widget handle
+ * \param[in]       state: Widget specific value of visual state
+ * \return          Hash of state and widget colors
+ */
+static uint32_t
+state_key(gui_handle_p h, uint32_t state) {
+    uint32_t hash = 0x811C9DC5;
+    gui_color_t color;
+    uint8_t i;
+    
+    hash = guii_widget_hash(hash, &state, sizeof(state));
+    for (i = 0; i < h->widget->color_count; i++) {
+        color = guii_widget_getcolor(h, i);
+        hash = guii_widget_hash(hash, &color, sizeof(color));
+    }
+    return hash;
+}
+
+/**
+ * \brief           Check if state bitmaps can be used for current drawing
+ * \return          `1` if bitmaps can be copied and saved, `0` otherwise
+ */
+static uint8_t
+state_canuse(void) {
+#if GUI_CFG_OS_RENDER_THREAD || (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1)
+    return 0;                                       /* Cache is shared by all drawing threads */
+#else
+    return GUI.ll.Copy != NULL
+#if GUI_CFG_USE_DISPLAY_LIST
+        && !guii_draw_dlist_isrecording()           /* Copy would not be part of recorded list */
+#endif /* GUI_CFG_USE_DISPLAY_LIST */
+        ;
+#endif /* GUI_CFG_OS_RENDER_THREAD || (GUI_CFG_LCD_TILE && GUI_CFG_LCD_TILE_CORES > 1) */
+}
+
+/**
+ * \brief           Draw visual state of widget from bitmap shared by widgets of the same type
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            With `r` set, only pixels of filled circle centered in square area are copied,
+ *                  pixels in corners come from background. Several lines of the same width are copied at once
+ * \param[in]       h: Widget handle
+ * \param[in]       x: Absolute X position of state area
+ * \param[in]       y: Absolute Y position of state area
+ * \param[in]       width: Width of state area in units of pixels
+ * \param[in]       height: Height of state area in units of pixels
+ * \param[in]       r: Radius of circle when area is `2 * r + 1` pixels square circle, `0` for opaque rectangle
+ * \param[in]       state: Widget specific value of visual state, such as flags and focus.
+ *                      Together with size and widget colors it must define all pixels of area
+ * \param[in]       disp: Clipping region
+ * \return          `1` if state was copied, `0` if it must be drawn normally and saved with \ref guii_widget_savestate
+ */
+uint8_t
+guii_widget_drawstate(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, gui_dim_t r, uint32_t state, const gui_display_t* disp) {
+    const cache_entry_t* e;
+    gui_dim_t row, start, dx, dy, cur;
+    int32_t lim = (int32_t)r * r + r;               /* Midpoint limit for pixel inside circle, as used by fill of circle */
+    
+    if (!state_canuse()) {
+        return 0;
+    }
+    e = cache_find(state_cache, GUI_COUNT_OF(state_cache), h->widget, state_key(h, state), width, height);
+    if (e == NULL) {
+        return 0;
+    }
+    if (!r) {
+        state_copy(e, 0, 0, x, y, width, height, disp);
+        return 1;
+    }
+    
+    /* Copy lines of circle, consecutive lines of the same width at once */
+    for (start = 0, cur = -1, row = 0; row <= height; row++) {
+        dx = -1;
+        if (row < height) {
+            dy = row < r ? r - row : row - r;
+            for (dx = r; dx >= 0 && (int32_t)dx * dx + (int32_t)dy * dy > lim; dx--) {}
+        }
+        if (dx != cur) {
+            if (cur >= 0) {
+                state_copy(e, r - cur, start, x, y, 2 * cur + 1, row - start, disp);
+            }
+            start = row;
+            cur = dx;
+        }
     }
     return 1;
 }
 
+/**
+ * \brief           Save drawn visual state of widget to bitmap shared by widgets of the same type
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            State is saved only when complete area was drawn in clipping region.
+ *                  Least recently used bitmap is replaced
+ * \param[in]       h: Widget handle
+ * \param[in]       x: Absolute X position of state area
+ * \param[in]       y: Absolute Y position of state area
+ * \param[in]       width: Width of state area in units of pixels
+ * \param[in]       height: Height of state area in units of pixels
+ * \param[in]       state: Visual state area was drawn in, same as passed to \ref guii_widget_drawstate
+ * \param[in]       disp: Clipping region state was drawn in
+ */
+void
+guii_widget_savestate(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height, uint32_t state, const gui_display_t* disp) {
+    if (state_canuse() && disp->x1 <= x && disp->y1 <= y && disp->x2 >= x + width && disp->y2 >= y + height) {
+        cache_save(state_cache, GUI_COUNT_OF(state_cache), GUI_MEM_TAG_STATE, h->widget, state_key(h, state), x, y, width, height);
+    }
+}
+
+#endif /* GUI_CFG_WIDGET_STATE_CACHE || __DOXYGEN__ */
+
 /*******************************************/
 /**  Widget create and remove management  **/
 /*******************************************/
@@ -957,46 +3791,47 @@ guii_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, fl
         return 0;
     }
     
-    h = GUI_MEMALLOC(widget->size);                 /* Allocate memory for widget */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    /*
+     * Parent window check
+     *
+     * - Dialog's parent widget is desktop widget
+     * - If flag for parent desktop is set, parent widget is also desktop
+     * - Otherwise parent widget passed as parameter is used if it supports children widgets
+     *
+     * Parent is known before allocation, so handle can be placed to arena of its window
+     */
+    if ((widget->flags & GUI_FLAG_WIDGET_DIALOG_BASE) || flags & GUI_FLAG_WIDGET_CREATE_PARENT_DESKTOP) {/* Dialogs do not have parent widget */
+        parent = gui_window_getdesktop();           /* Set parent object */
+    } else if (parent == NULL || !guii_widget_allowchildren(parent)) {
+        parent = GUI.WindowActive;                  /* Set parent object. It will be NULL on first call */
+    }
+    
+    GUI_MEM_TAGGED((const char *)widget->name, h = alloc_widget(widget->size, parent)); /* Allocate memory for widget */
     if (h != NULL) {
         gui_widget_param_t param = {0};
         gui_widget_result_t result = {0};
-    
-        memset(h, 0x00, widget->size);              /* Set memory to 0 */
-        
-        __GUI_ENTER();                              /* Enter GUI */
         
         h->id = id;                                 /* Save ID */
         h->widget = widget;                         /* Widget object structure */
         h->footprint = GUI_WIDGET_FOOTPRINT;        /* Set widget footprint */
         h->callback = cb;                           /* Set widget callback */
+        h->geometry.gen = GUI.GeometryGen - 1;      /* Force geometry calculation on first use */
 #if GUI_CFG_USE_TRANSPARENCY
         h->transparency = 0xFF;                     /* Set full transparency by default */
 #endif /* GUI_CFG_USE_TRANSPARENCY */
-        
-        /*
-         * Parent window check
-         *
-         * - Dialog's parent widget is desktop widget
-         * - If flag for parent desktop is set, parent widget is also desktop
-         * - Otherwise parent widget passed as parameter is used if it supports children widgets
-         */
-        if (guii_widget_isdialogbase(h) || flags & GUI_FLAG_WIDGET_CREATE_PARENT_DESKTOP) {/* Dialogs do not have parent widget */
-            h->parent = gui_window_getdesktop();    /* Set parent object */
-        } else {
-            if (parent != NULL && guii_widget_allowchildren(parent)) {
-                h->parent = parent;
-            } else {
-                h->parent = GUI.WindowActive;       /* Set parent object. It will be NULL on first call */
-            }
+        h->parent = parent;
+        if (h->parent != NULL && (guii_widget_ishidden(h->parent) || guii_widget_isparenthidden(h->parent))) {
+            guii_widget_setflag(h, GUI_FLAG_PARENT_HIDDEN); /* Created inside hidden widget */
         }
         
         GUI_WIDGET_RESULTTYPE_U8(&result) = 1;
         guii_widget_callback(h, GUI_WC_PreInit, NULL, &result);    /* Notify internal widget library about init successful */
         
         if (!GUI_WIDGET_RESULTTYPE_U8(&result)) {   /* Check result */
-            GUI_MEMFREE(h);                         /* Clear widget memory */
-            h = 0;                                  /* Reset handle */
+            free_widget(h, widget->size);           /* Clear widget memory */
+            __GUI_LEAVE();                          /* Leave GUI */
             return 0;                               /* Stop execution at this point */
         }
         
@@ -1013,6 +3848,9 @@ guii_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, fl
         guii_widget_callback(h, GUI_WC_ExcludeLinkedList, NULL, &result);
         if (!GUI_WIDGET_RESULTTYPE_U8(&result)) {   /* Check if widget should be added to linked list */
             gui_linkedlist_widgetadd((gui_handle_root_t *)h->parent, h); /* Add entry to linkedlist of parent widget */
+#if GUI_CFG_WIDGET_ID_HASH_SIZE
+            id_hash_add(h);                         /* Widget can be found by ID from now */
+#endif /* GUI_CFG_WIDGET_ID_HASH_SIZE */
         }
         guii_widget_callback(h, GUI_WC_Init, NULL, NULL);  /* Notify user about init successful */
         guii_widget_invalidate(h);                  /* Invalidate object */
@@ -1025,8 +3863,10 @@ guii_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, fl
         __GUI_LEAVE();                              /* Leave GUI */
 #if GUI_CFG_OS
         static gui_mbox_msg_t msg = {GUI_SYS_MBOX_TYPE_WIDGET_CREATED};
-        gui_sys_mbox_putnow(&GUI.OS.mbox, &msg);    /* Post message queue */
+        __GUI_WAKEUP(&msg);                         /* Post message queue */
 #endif /* GUI_CFG_OS */
+    } else {
+        __GUI_LEAVE();                              /* Leave GUI */
     }
     
     return (void *)h;
@@ -1047,13 +3887,16 @@ uint8_t
 guii_widget_remove(gui_handle_p h) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (can_remove_widget(h)) {                     /* Check if we can delete widget */
-        guii_widget_setflag(h, GUI_FLAG_REMOVE);    /* Set flag for widget delete */
-        GUI.flags |= GUI_FLAG_REMOVE;               /* Set flag for to remove at least one widget from tree */
+        if (!guii_widget_getflag(h, GUI_FLAG_REMOVE)) { /* Put widget to remove queue only once */
+            guii_widget_setflag(h, GUI_FLAG_REMOVE);    /* Set flag for widget delete */
+            h->remove_next = GUI.RemoveQueue;
+            GUI.RemoveQueue = h;
+        }
         if (guii_widget_isfocused(h)) {             /* In case current widget is in focus */
             guii_widget_focus_set(guii_widget_getparent(h)); /* Set parent as focused */
         }
 #if GUI_CFG_OS
-    gui_sys_mbox_putnow(&GUI.OS.mbox, &msg_widget_remove);  /* Put message to queue */
+    __GUI_WAKEUP(&msg_widget_remove);               /* Put message to queue */
 #endif /* GUI_CFG_OS */
         return 1;                                   /* Widget will be deleted */
     }
@@ -1080,6 +3923,30 @@ guii_widget_setfont(gui_handle_p h, const gui_font_t* font) {
     return 1;
 }
 
+/**
+ * \brief           Update cached byte length and number of characters of widget text
+ * \note            Both values are calculated in single pass over text without decoding characters
+ * \param[in,out]   h: Widget handle
+ */
+static void
+text_update_length(gui_handle_p h) {
+    const gui_char* p = h->text;
+    size_t chars = 0;
+    
+    if (p != NULL) {
+        for (; *p; p++) {
+#if GUI_CFG_USE_UNICODE
+            if ((*p & 0xC0) != 0x80)                /* Count only first bytes of UTF-8 sequences */
+#endif /* GUI_CFG_USE_UNICODE */
+            {
+                chars++;
+            }
+        }
+    }
+    h->textlen = p != NULL ? (size_t)(p - h->text) : 0;
+    h->textchars = chars;
+}
+
 /**
  * \brief           Set text for widget
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -1096,31 +3963,64 @@ uint8_t
 guii_widget_settext(gui_handle_p h, const gui_char* text) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC)) {   /* Memory for text is dynamically allocated */
-        if (h->textmemsize) {
-            if (gui_string_lengthtotal(text) > (h->textmemsize - 1)) {  /* Check string length */
-                gui_string_copyn(h->text, text, h->textmemsize - 1);    /* Do not copy all bytes because of memory overflow */
+        size_t memsize = guii_widget_getextvalue(h, textmemsize, 0);
+        if (memsize) {
+            if (gui_string_lengthtotal(text) > (memsize - 1)) { /* Check string length */
+                gui_string_copyn(h->text, text, memsize - 1);   /* Do not copy all bytes because of memory overflow */
             } else {
                 gui_string_copy(h->text, text);     /* Copy entire string */
             }
+            text_update_length(h);                  /* Save new length */
             guii_widget_invalidate(h);              /* Redraw object */
             guii_widget_callback(h, GUI_WC_TextChanged, NULL, NULL);   /* Process callback */
         }
     } else {                                        /* Memory allocated by user */
         if (h->text != NULL && h->text == text) {   /* In case the same pointer is passed to WIDGET */
+            text_update_length(h);                  /* Content may have changed */
             guii_widget_invalidate(h);              /* Redraw object */
             guii_widget_callback(h, GUI_WC_TextChanged, NULL, NULL);   /* Process callback */
         }
         
         if (h->text != text) {                      /* Check if pointer do not match */
             h->text = (gui_char *)text;             /* Set parameter */
+            text_update_length(h);                  /* Save new length */
             guii_widget_invalidate(h);              /* Redraw object */
             guii_widget_callback(h, GUI_WC_TextChanged, NULL, NULL);   /* Process callback */
         }
     }
-    h->textcursor = gui_string_lengthtotal(h->text);/* Set cursor to the end of string */
+    if (h->ext != NULL) {
+        h->ext->textcursor = guii_widget_gettextlength(h);  /* Set cursor to the end of string */
+#if GUI_CFG_USE_TRANSLATE
+        h->ext->texttranslatedsrc = NULL;           /* Text content may have changed */
+#endif /* GUI_CFG_USE_TRANSLATE */
+    }
     return 1;
 }
 
+/**
+ * \brief           Format number to dynamic text memory of widget
+ * \note            Widget is not invalidated when formatted text equals current text
+ * \param[in,out]   h: Widget handle
+ * \param[in]       value: Number to format, scaled by `10^decimals`
+ * \param[in]       decimals: Number of digits after decimal point
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+settext_number(gui_handle_p h, int32_t value, uint8_t decimals) {
+    gui_char buff[13];                              /* Sign, 10 digits, decimal point and trailing zero */
+    
+    if (!guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC) || !guii_widget_getextvalue(h, textmemsize, 0)) {
+        return 0;                                   /* Formatted text needs widget text memory */
+    }
+    if (!gui_string_fmt_fixed(buff, GUI_MIN(sizeof(buff), h->ext->textmemsize), value, decimals)) {
+        return 0;
+    }
+    if (h->text != NULL && !gui_string_compare(h->text, buff)) {
+        return 1;                                   /* Same text, nothing to redraw */
+    }
+    return guii_widget_settext(h, buff);
+}
+
 /**
  * \brief           Allocate text memory for widget
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -1132,19 +4032,36 @@ guii_widget_settext(gui_handle_p h, const gui_char* text) {
  */
 uint8_t
 guii_widget_alloctextmemory(gui_handle_p h, uint32_t size) {
+    gui_handle_ext_t* ext;
+    gui_char* text = NULL;
+    
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    if ((ext = guii_widget_getext(h)) == NULL) {    /* Memory size and cursor are kept in rarely used values */
+        return 0;
+    }
     if (guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC) && h->text) {  /* Check if already allocated */
-        GUI_MEMFREE(h->text);                       /* Free memory first */
-        h->textmemsize = 0;                         /* Reset memory size */
+        GUI_MEM_TAGGED(GUI_MEM_TAG_TEXT, text = GUI_MEMREALLOC(h->text, sizeof(gui_char) * size));  /* Resize memory, in place when possible */
+        if (text != NULL) {
+            memset(text, 0x00, sizeof(gui_char) * size);   /* Reset memory as on new allocation */
+        } else {
+            GUI_MEMFREE(h->text);                   /* Free old memory */
+        }
+    } else {
+        GUI_MEM_TAGGED(GUI_MEM_TAG_TEXT, text = GUI_MEMALLOC(sizeof(gui_char) * size)); /* Allocate memory for text */
     }
-    h->text = NULL;                                 /* Reset pointer */
     
-    h->textmemsize = sizeof(gui_char) * size;       /* Allocate text memory */
-    h->text = GUI_MEMALLOC(__GH(h)->textmemsize);   /* Allocate memory for text */
+    h->text = text;
+    h->textlen = 0;                                 /* New memory is empty */
+    h->textchars = 0;
+    ext->textcursor = 0;
+    ext->textmemsize = sizeof(gui_char) * size;     /* Set text memory size */
     if (h->text != NULL) {                          /* Check if allocated */
+#if GUI_CFG_MEM_RELOC
+        gui_mem_setmovable((void **)&h->text);      /* Text can be moved by heap compaction */
+#endif /* GUI_CFG_MEM_RELOC */
         guii_widget_setflag(h, GUI_FLAG_DYNAMICTEXTALLOC); /* Dynamically allocated */
     } else {
-        h->textmemsize = 0;                         /* No dynamic bytes available */
+        ext->textmemsize = 0;                       /* No dynamic bytes available */
         guii_widget_clrflag(h, GUI_FLAG_DYNAMICTEXTALLOC); /* Not allocated */
     }
     guii_widget_invalidate(h);                      /* Redraw object */
@@ -1166,7 +4083,12 @@ guii_widget_freetextmemory(gui_handle_p h) {
     if (guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC) && h->text != NULL) { /* Check if dynamically alocated */
         GUI_MEMFREE(h->text);                       /* Free memory first */
         h->text = NULL;                             /* Reset memory */
-        h->textmemsize = 0;                         /* Reset memory size */
+        h->textlen = 0;
+        h->textchars = 0;
+        if (h->ext != NULL) {
+            h->ext->textmemsize = 0;                /* Reset memory size */
+            h->ext->textcursor = 0;
+        }
         guii_widget_clrflag(h, GUI_FLAG_DYNAMICTEXTALLOC); /* Not allocated */
         guii_widget_invalidate(h);                  /* Redraw object */
         guii_widget_callback(h, GUI_WC_TextChanged, NULL, NULL);   /* Process callback */
@@ -1183,26 +4105,29 @@ guii_widget_freetextmemory(gui_handle_p h) {
 uint8_t
 guii_widget_isfontandtextset(gui_handle_p h) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    return h->text != NULL && h->font != NULL && gui_string_length(h->text);    /* Check if conditions are met for drawing string */
+    return h->text != NULL && guii_widget_getfont(h) != NULL && guii_widget_gettextchars(h);    /* Check if conditions are met for drawing string */
 }
 
 /**
  * \brief           Process text key (add character, remove it, move cursor, etc)
+ * \note            Byte length and number of characters of text are cached in widget,
+ *                  so no decoding of complete text is required.
+ *                  Widget is not invalidated, caller shall invalidate only area where text changed
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
  * \param[in,out]   h: Widget handle
  * \param[in]       kb: Pointer to \ref guii_keyboard_data_t structure
- * \return          `1` on success, `0` otherwise
+ * \return          `1` when text has changed, `0` otherwise
  */
 uint8_t
 guii_widget_processtextkey(gui_handle_p h, guii_keyboard_data_t* kb) {
-    size_t len, tlen;
+    gui_handle_ext_t* ext = h->ext;
     uint32_t ch;
     uint8_t l;
     gui_string_t currStr;
     
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     
-    if (!guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC)) {  /* Must be dynamically allocated memory */
+    if (!guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC) || ext == NULL) {   /* Must be dynamically allocated memory */
         return 0;
     }
     
@@ -1211,39 +4136,28 @@ guii_widget_processtextkey(gui_handle_p h, guii_keyboard_data_t* kb) {
         return 0;                                   /* Invalid input key */
     }
     
-    tlen = gui_string_lengthtotal(h->text);         /* Get total length of string */
-    len = gui_string_length(h->text);               /* Get string length */
     if ((ch == GUI_KEY_LF || ch >= 32) && ch != 127) {  /* Check valid character character */
-        if (len < (h->textmemsize - l)) {           /* Memory still available for new character */
-            uint16_t pos;
-            for (pos = tlen + l - 1; pos > h->textcursor; pos--) {  /* Shift characters down */
-                h->text[pos] = h->text[pos - l];
-            }
-            for (pos = 0; pos < l; pos++) {         /* Fill new characters to empty memory */
-                h->text[h->textcursor++] = kb->kb.keys[pos];
-            }
-            h->text[tlen + l] = 0;                  /* Add 0 to the end */
+        if (h->textlen + l < ext->textmemsize) {      /* Memory still available for new character and trailing zero */
+            memmove(&h->text[ext->textcursor + l], &h->text[ext->textcursor], h->textlen - ext->textcursor + 1);  /* Make space, including trailing zero */
+            memcpy(&h->text[ext->textcursor], kb->kb.keys, l);
+            ext->textcursor += l;
+            h->textlen += l;
+            h->textchars++;
             
-            guii_widget_invalidate(h);              /* Invalidate widget */
             guii_widget_callback(h, GUI_WC_TextChanged, NULL, NULL);   /* Process callback */
             return 1;
         }
     } else if (ch == 8 || ch == 127) {              /* Backspace character */
-        if (tlen && h->textcursor) {
-            uint16_t pos;
-            
-            gui_string_prepare(&currStr, (gui_char *)((uint32_t)h->text + h->textcursor - 1));  /* Set string to process */
-            gui_string_gotoend(&currStr);           /* Go to the end of string */
+        if (h->textlen && ext->textcursor) {
+            gui_string_prepare(&currStr, &h->text[ext->textcursor - 1]);  /* Point to last byte before cursor */
             if (!gui_string_getchreverse(&currStr, &ch, &l)) {  /* Get last character */
                 return 0;                           
             }
-            for (pos = h->textcursor - l; pos < (tlen - l); pos++) {/* Shift characters up */
-                h->text[pos] = h->text[pos + l];
-            }
-            h->textcursor -= l;                     /* Decrease text cursor by number of bytes for character deleted */
-            h->text[tlen - l] = 0;                  /* Set 0 to the end of string */
+            memmove(&h->text[ext->textcursor - l], &h->text[ext->textcursor], h->textlen - ext->textcursor + 1);  /* Remove character, including trailing zero */
+            ext->textcursor -= l;                     /* Decrease text cursor by number of bytes for character deleted */
+            h->textlen -= l;
+            h->textchars--;
             
-            guii_widget_invalidate(h);              /* Invalidate widget */
             guii_widget_callback(h, GUI_WC_TextChanged, NULL, NULL);/* Process callback */
             return 1;
         }
@@ -1259,13 +4173,25 @@ guii_widget_processtextkey(gui_handle_p h, guii_keyboard_data_t* kb) {
  */
 const gui_char *
 guii_widget_gettext(gui_handle_p h) {
+#if GUI_CFG_USE_TRANSLATE
+    gui_handle_ext_t* ext;
+#endif /* GUI_CFG_USE_TRANSLATE */
+    
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     
     /* Prepare for transpate support */
 #if GUI_CFG_USE_TRANSLATE
     /* For static texts only */
     if (!guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC) && h->text != NULL) {
-        return gui_translate_get(h->text);          /* Get translation entry */
+        if ((ext = guii_widget_getext(h)) == NULL) {/* No memory to memorize translation */
+            return gui_translate_get(h->text);
+        }
+        if (ext->texttranslatedsrc != h->text || ext->texttranslatedgen != GUI.translate.gen) {
+            ext->texttranslated = gui_translate_get(h->text);   /* Get translation entry and memorize it */
+            ext->texttranslatedsrc = h->text;
+            ext->texttranslatedgen = GUI.translate.gen;
+        }
+        return ext->texttranslated;
     }
 #endif /* GUI_CFG_USE_TRANSLATE */
     return h->text;                                 /* Return text for widget */
@@ -1280,6 +4206,11 @@ guii_widget_gettext(gui_handle_p h) {
 const gui_font_t *
 guii_widget_getfont(gui_handle_p h) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+#if GUI_CFG_WIDGET_STYLE
+    if (h->style != NULL && (h->style->flags & GUI_STYLE_FLAG_FONT)) {
+        return h->style->font;                      /* Font of shared style */
+    }
+#endif /* GUI_CFG_WIDGET_STYLE */
     return h->font;                                 /* Return font for widget */
 }
 
@@ -1299,9 +4230,9 @@ guii_widget_setwidth(gui_handle_p h, gui_dim_t width) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT)) {   /* Invalidate if percent not yet enabled to force invalidation */
         guii_widget_clrflag(h, GUI_FLAG_WIDTH_PERCENT); /* Set percentage flag */
-        h->width = width + 1;                       /* Invalidate height */
+        h->width = GUI_GEOM_FROM_DIM(width) + 1;    /* Invalidate height */
     }
-    return set_widget_size(h, width, h->height);    /* Set new height */
+    return set_widget_size(h, GUI_GEOM_FROM_DIM(width), h->height); /* Set new height */
 }
 
 /**
@@ -1317,9 +4248,9 @@ guii_widget_setheight(gui_handle_p h, gui_dim_t height) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT)) {  /* Invalidate if percent not yet enabled to force invalidation */
         guii_widget_clrflag(h, GUI_FLAG_HEIGHT_PERCENT);    /* Set percentage flag */
-        __GH(h)->height = height + 1;               /* Invalidate height */
+        __GH(h)->height = GUI_GEOM_FROM_DIM(height) + 1; /* Invalidate height */
     }
-    return set_widget_size(h, h->width, height);    /* Set new height */
+    return set_widget_size(h, h->width, GUI_GEOM_FROM_DIM(height)); /* Set new height */
 }
 
 /**
@@ -1335,9 +4266,9 @@ guii_widget_setwidthpercent(gui_handle_p h, float width) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (!guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT)) {  /* Invalidate if percent not yet enabled to force invalidation */
         guii_widget_setflag(h, GUI_FLAG_WIDTH_PERCENT); /* Set percentage flag */
-        h->width = width + 1;                       /* Invalidate widget */
+        h->width = GUI_GEOM_FROM_FLOAT(width) + 1;  /* Invalidate widget */
     }
-    return set_widget_size(h, width, h->height);    /* Set new width */
+    return set_widget_size(h, GUI_GEOM_FROM_FLOAT(width), h->height); /* Set new width */
 }
 
 /**
@@ -1353,9 +4284,9 @@ guii_widget_setheightpercent(gui_handle_p h, float height) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (!guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT)) {    /* Invalidate if percent not yet enabled to force invalidation */
         guii_widget_setflag(h, GUI_FLAG_HEIGHT_PERCENT);   /* Set percentage flag */
-        h->height = height + 1;                     /* Invalidate height */
+        h->height = GUI_GEOM_FROM_FLOAT(height) + 1; /* Invalidate height */
     }
-    return set_widget_size(h, h->width, height);    /* Set new height */
+    return set_widget_size(h, h->width, GUI_GEOM_FROM_FLOAT(height)); /* Set new height */
 }
 
 /**
@@ -1372,10 +4303,10 @@ guii_widget_setsize(gui_handle_p h, gui_dim_t wi, gui_dim_t hi) {
     /* If percentage enabled on at least one, either width or height */
     if (guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT)) {
         guii_widget_clrflag(h, GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT);  /* Clear both flags */
-        h->width = wi + 1;                          /* Invalidate width */
-        h->height = hi + 1;                         /* Invalidate height */
+        h->width = GUI_GEOM_FROM_DIM(wi) + 1;       /* Invalidate width */
+        h->height = GUI_GEOM_FROM_DIM(hi) + 1;      /* Invalidate height */
     }
-    return set_widget_size(h, wi, hi);              /* Set widget size */
+    return set_widget_size(h, GUI_GEOM_FROM_DIM(wi), GUI_GEOM_FROM_DIM(hi)); /* Set widget size */
 }
 
 /**
@@ -1392,10 +4323,10 @@ guii_widget_setsizepercent(gui_handle_p h, float wi, float hi) {
     /* If percentage not enabled on both */
     if (guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT) != (GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT)) {
         guii_widget_setflag(h, GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT);  /* Set both flags */
-        h->width = wi + 1;                          /* Invalidate width */
-        h->height = hi + 1;                         /* Invalidate height */
+        h->width = GUI_GEOM_FROM_FLOAT(wi) + 1;     /* Invalidate width */
+        h->height = GUI_GEOM_FROM_FLOAT(hi) + 1;    /* Invalidate height */
     }
-    return set_widget_size(h, wi, hi);              /* Set widget size */
+    return set_widget_size(h, GUI_GEOM_FROM_FLOAT(wi), GUI_GEOM_FROM_FLOAT(hi)); /* Set widget size */
 }
 
 /**
@@ -1423,8 +4354,10 @@ guii_widget_setexpanded(gui_handle_p h, uint8_t state) {
     if (!state && guii_widget_isexpanded(h)) {     /* Check current status */
         guii_widget_invalidatewithparent(h);       /* Invalidate with parent first for clipping region */
         guii_widget_clrflag(h, GUI_FLAG_EXPANDED); /* Clear expanded after invalidation */
+        guii_widget_geometrychanged();             /* Invalidate cached geometry */
     } else if (state && !guii_widget_isexpanded(h)) {
         guii_widget_setflag(h, GUI_FLAG_EXPANDED); /* Expand widget */
+        guii_widget_geometrychanged();             /* Invalidate cached geometry */
         guii_widget_invalidate(h);                 /* Redraw only selected widget as it is over all window */
     }
     return 1;
@@ -1447,10 +4380,10 @@ guii_widget_setposition(gui_handle_p h, gui_dim_t x, gui_dim_t y) {
     /* If percent enabled on at least one coordinate, clear to force invalidation */
     if (guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT)) {
         guii_widget_clrflag(h, GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT); /* Disable percent on X and Y position */
-        h->x = x + 1;                               /* Invalidate X position */
-        h->y = y + 1;                               /* Invalidate Y position */
+        h->x = GUI_GEOM_FROM_DIM(x) + 1;            /* Invalidate X position */
+        h->y = GUI_GEOM_FROM_DIM(y) + 1;            /* Invalidate Y position */
     }  
-    return set_widget_position(h, x, y);            /* Set widget position */
+    return set_widget_position(h, GUI_GEOM_FROM_DIM(x), GUI_GEOM_FROM_DIM(y)); /* Set widget position */
 }
  
 /**
@@ -1467,10 +4400,10 @@ guii_widget_setpositionpercent(gui_handle_p h, float x, float y) {
     /* If percent not set on both, enable to force invalidation */
     if (guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT) != (GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT)) {
         guii_widget_setflag(h, GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT); /* Enable percent on X and Y position */
-        h->x = x + 1;                               /* Invalidate X position */
-        h->y = y + 1;                               /* Invalidate Y position */
+        h->x = GUI_GEOM_FROM_FLOAT(x) + 1;          /* Invalidate X position */
+        h->y = GUI_GEOM_FROM_FLOAT(y) + 1;          /* Invalidate Y position */
     }
-    return set_widget_position(h, x, y);            /* Set widget position */
+    return set_widget_position(h, GUI_GEOM_FROM_FLOAT(x), GUI_GEOM_FROM_FLOAT(y)); /* Set widget position */
 }
  
 /**
@@ -1486,9 +4419,9 @@ guii_widget_setxposition(gui_handle_p h, gui_dim_t x) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT)) {/* if percent enabled */
         guii_widget_clrflag(h, GUI_FLAG_XPOS_PERCENT);  /* Clear it to force invalidation */
-        h->x = x + 1;                               /* Invalidate position */
+        h->x = GUI_GEOM_FROM_DIM(x) + 1;            /* Invalidate position */
     }
-    return set_widget_position(h, x, h->y);         /* Set widget position */
+    return set_widget_position(h, GUI_GEOM_FROM_DIM(x), h->y); /* Set widget position */
 }
  
 /**
@@ -1504,9 +4437,9 @@ guii_widget_setxpositionpercent(gui_handle_p h, float x) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (!guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT)) {  /* if percent not enabled */
         guii_widget_setflag(h, GUI_FLAG_XPOS_PERCENT); /* Set it to force invalidation */
-        h->x = x + 1;                               /* Invalidate position */
+        h->x = GUI_GEOM_FROM_FLOAT(x) + 1;          /* Invalidate position */
     }
-    return set_widget_position(h, x, h->y);         /* Set widget position */
+    return set_widget_position(h, GUI_GEOM_FROM_FLOAT(x), h->y); /* Set widget position */
 }
  
 /**
@@ -1522,9 +4455,9 @@ guii_widget_setyposition(gui_handle_p h, gui_dim_t y) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT)) {   /* if percent enabled */
         guii_widget_clrflag(h, GUI_FLAG_YPOS_PERCENT); /* Clear it to force invalidation */
-        h->y = y + 1;                               /* Invalidate position */
+        h->y = GUI_GEOM_FROM_DIM(y) + 1;            /* Invalidate position */
     }
-    return set_widget_position(h, h->x, y);         /* Set widget position */
+    return set_widget_position(h, h->x, GUI_GEOM_FROM_DIM(y)); /* Set widget position */
 }
  
 /**
@@ -1540,46 +4473,88 @@ guii_widget_setypositionpercent(gui_handle_p h, float y) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     if (!guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT)) {  /* if percent not enabled */
         guii_widget_setflag(h, GUI_FLAG_YPOS_PERCENT); /* Set it to force invalidation */
-        h->y = y + 1;                               /* Invalidate position */
+        h->y = GUI_GEOM_FROM_FLOAT(y) + 1;          /* Invalidate position */
     }
-    return set_widget_position(h, h->y, y);         /* Set widget position */
+    return set_widget_position(h, h->x, GUI_GEOM_FROM_FLOAT(y)); /* Set widget position */
 }
 
 /*******************************************/
 /**                  .....                **/
 /*******************************************/
 /**
- * \brief           Show widget from visible area
- * \note            The function is private and can be called only when GUI protection against multiple access is activated
- * \param[in,out]   h: Widget handle
+ * \brief           Start batched update of widgets
+ * \note            GUI stays locked until \ref gui_widget_batch_commit is called,
+ *                  which must be called from the same thread.
+ *                  Invalidations inside batch are combined to single area and GUI thread is notified only once on commit
+ * \note            Batches may be nested, changes are applied when outermost batch is committed
  * \return          `1` on success, `0` otherwise
- * \sa              guii_widget_hide
+ * \sa              gui_widget_batch_commit
  */
 uint8_t
-guii_widget_show(gui_handle_p h) {
-    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    
-    if (guii_widget_getflag(h, GUI_FLAG_HIDDEN)) {  /* If hidden, show it */
-        guii_widget_clrflag(h, GUI_FLAG_HIDDEN);
-        guii_widget_invalidatewithparent(h);        /* Invalidate it for redraw with parent */
+gui_widget_batch_begin(void) {
+    __GUI_ENTER();                                  /* Enter GUI, released on commit */
+    if (!GUI.BatchLevel++) {                        /* Outermost batch */
+        GUI.BatchRect.x1 = 0x7FFF;
+        GUI.BatchRect.y1 = 0x7FFF;
+        GUI.BatchRect.x2 = 0x8000;
+        GUI.BatchRect.y2 = 0x8000;
+#if GUI_CFG_OS
+        GUI.OS.batch_thread_id = gui_sys_thread_getid();
+#endif /* GUI_CFG_OS */
     }
     return 1;
 }
 
 /**
- * \brief           Hide widget from visible area
- * \note            The function is private and can be called only when GUI protection against multiple access is activated
- * \param[in,out]   h: Widget handle
+ * \brief           Finish batched update of widgets started with \ref gui_widget_batch_begin
  * \return          `1` on success, `0` otherwise
- * \sa              guii_widget_show
+ * \sa              gui_widget_batch_begin
  */
 uint8_t
-guii_widget_hide(gui_handle_p h) {
-    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    
-    if (!guii_widget_getflag(h, GUI_FLAG_HIDDEN)) { /* If visible, hide it */
-        guii_widget_setflag(h, GUI_FLAG_HIDDEN);
-        guii_widget_invalidatewithparent(h);        /* Invalidate it for redraw with parent */
+gui_widget_batch_commit(void) {
+    __GUI_ASSERTPARAMS(GUI.BatchLevel > 0);         /* Batch must be started */
+    if (!--GUI.BatchLevel) {                        /* Outermost batch finished */
+#if GUI_CFG_OS
+        GUI.OS.batch_thread_id = NULL;
+#endif /* GUI_CFG_OS */
+        if (GUI.BatchRect.x1 < GUI.BatchRect.x2 && GUI.BatchRect.y1 < GUI.BatchRect.y2) {
+            batch_invalidateregion(NULL);           /* Redraw everything in combined area */
+            guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS,
+                GUI.BatchRect.x1, GUI.BatchRect.y1, GUI.BatchRect.x2, GUI.BatchRect.y2);
+            GUI.flags |= GUI_FLAG_REDRAW;           /* Notify stack about redraw operations */
+        }
+    }
+    __GUI_LEAVE();                                  /* Leave GUI, wakes up GUI thread after outermost batch */
+    return 1;
+}
+
+/**
+ * \brief           Change visibility of widget
+ * \param[in,out]   h: Widget handle
+ * \param[in]       visible: Set to `1` to show widget or `0` to hide it
+ * \param[in]       invalidate: Set to `1` to invalidate widget with parent
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+set_visible(gui_handle_p h, uint8_t visible, uint8_t invalidate) {
+    if (!visible == !guii_widget_getflag(h, GUI_FLAG_HIDDEN)) {  /* Visibility changes */
+        gui_widget_param_t param = {0};
+        
+        if (visible) {
+            guii_widget_clrflag(h, GUI_FLAG_HIDDEN);
+        } else {
+            guii_widget_setflag(h, GUI_FLAG_HIDDEN);
+        }
+        visibility_update(h);                       /* Children follow visibility of widget */
+        guii_widget_treechanged();                  /* Visible widgets have changed */
+        if (invalidate) {
+            guii_widget_invalidatewithparent(h);    /* Invalidate it for redraw with parent */
+        }
+        GUI_WIDGET_PARAMTYPE_INT(&param) = visible;
+        guii_widget_callback(h, GUI_WC_VisibilityChanged, &param, NULL);  /* Notify widget */
+    }
+    if (visible) {
+        return 1;
     }
     
     /*
@@ -1595,6 +4570,74 @@ guii_widget_hide(gui_handle_p h) {
     return 1;
 }
 
+/**
+ * \brief           Show widget from visible area
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ * \sa              guii_widget_hide
+ */
+uint8_t
+guii_widget_show(gui_handle_p h) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    return set_visible(h, 1, 1);
+}
+
+/**
+ * \brief           Hide widget from visible area
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ * \sa              guii_widget_show
+ */
+uint8_t
+guii_widget_hide(gui_handle_p h) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    return set_visible(h, 0, 1);
+}
+
+#if GUI_CFG_SCREEN_STACK || __DOXYGEN__
+
+/**
+ * \brief           Show or hide widget without invalidating it
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Caller restores pixels of widget area itself, see \ref GUI_SCREEN
+ * \param[in,out]   h: Widget handle
+ * \param[in]       visible: Set to `1` to show widget or `0` to hide it
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_setvisiblequiet(gui_handle_p h, uint8_t visible) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    return set_visible(h, visible, 0);
+}
+
+/**
+ * \brief           Redraw widget, its children and widgets above it only inside area
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \param[in]       area: Absolute area on screen
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_invalidatearea(gui_handle_p h, const gui_display_t* area) {
+    gui_dim_t x1, y1, x2, y2;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h) && area != NULL);    /* Check valid parameter */
+    get_lcd_abs_position_and_visible_width_height(h, &x1, &y1, &x2, &y2);
+    x1 = GUI_MAX(x1, area->x1);
+    y1 = GUI_MAX(y1, area->y1);
+    x2 = GUI_MIN(x2, area->x2);
+    y2 = GUI_MIN(y2, area->y2);
+    if (x1 >= x2 || y1 >= y2) {
+        return 0;
+    }
+    guii_widget_addrect(GUI.DirtyRects, &GUI.DirtyRectsCount, GUI_CFG_DISPLAY_DIRTY_RECTS, x1, y1, x2, y2);
+    return invalidate_widget(h, 0);                 /* Widgets are drawn only in dirty regions */
+}
+
+#endif /* GUI_CFG_SCREEN_STACK || __DOXYGEN__ */
+
 /**
  * \brief           Hide direct children widgets of current widget
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -1681,14 +4724,48 @@ guii_widget_settransparency(gui_handle_p h, uint8_t trans) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     
     if (h->transparency != trans) {                 /* Check transparency match */
+        uint8_t changed = !h->transparency != !trans;   /* Widget is hidden with zero level */
+        
         h->transparency = trans;                    /* Set new transparency level */
+        if (changed) {
+            visibility_update(h);                   /* Children follow visibility of widget */
+            guii_widget_treechanged();              /* Visible widgets have changed */
+        }
         guii_widget_invalidate(h);                  /* Invalidate widget */
+        if (guii_widget_getflag(h, GUI_FLAG_RETAINED_VALID) && guii_widget_getflag(h, GUI_FLAG_INVALIDATE_PENDING)
+            && guii_widget_iscontentopaque(h)) {
+            guii_widget_setflag(h, GUI_FLAG_RETAINED_BLEND);    /* Content is the same, only blending of bitmap changes */
+        }
     }
     
     return 1;
 }
 #endif /* GUI_CFG_USE_TRANSPARENCY */
 
+#if GUI_CFG_WIDGET_MASK || __DOXYGEN__
+/**
+ * \brief           Set alpha mask to widget
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \param[in,out]   h: Widget handle
+ * \param[in]       mask: Mask placed on top left corner of widget or `NULL` to remove it
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_setmask
+ */
+uint8_t
+guii_widget_setmask(gui_handle_p h, const gui_mask_t* mask) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    
+    if (h->mask != mask) {
+        if (h->mask != NULL) {
+            guii_widget_invalidate(h);              /* Area outside new mask shows parent again */
+        }
+        h->mask = mask;
+        guii_widget_invalidate(h);
+    }
+    return 1;
+}
+#endif /* GUI_CFG_WIDGET_MASK || __DOXYGEN__ */
+
 /**
  * \brief           Set color to widget specific index
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -1699,15 +4776,18 @@ guii_widget_settransparency(gui_handle_p h, uint8_t trans) {
  */
 uint8_t
 guii_widget_setcolor(gui_handle_p h, uint8_t index, gui_color_t color) {
+    gui_handle_ext_t* ext;
     uint8_t ret = 1;
     
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     __GUI_ENTER();                                  /* Enter GUI context */
-    if (h->colors == NULL) {                        /* Do we need to allocate color memory? */
+    if ((ext = guii_widget_getext(h)) == NULL) {    /* Colors are kept in rarely used values */
+        ret = 0;
+    } else if (ext->colors == NULL) {               /* Do we need to allocate color memory? */
         if (h->widget->color_count) {               /* Check if at least some colors should be used */
-            h->colors = GUI_MEMALLOC(sizeof(*h->colors) * h->widget->color_count);
-            if (h->colors != NULL) {          /* Copy all colors to new memory first */
-                memcpy(h->colors, h->widget->colors, sizeof(*h->colors) * h->widget->color_count);
+            ext->colors = GUI_MEMALLOC(sizeof(*ext->colors) * h->widget->color_count);
+            if (ext->colors != NULL) {              /* Copy all colors to new memory first */
+                memcpy(ext->colors, h->widget->colors, sizeof(*ext->colors) * h->widget->color_count);
             } else {
                 ret = 0;
             }
@@ -1717,7 +4797,7 @@ guii_widget_setcolor(gui_handle_p h, uint8_t index, gui_color_t color) {
     }
     if (ret) {
         if (index < h->widget->color_count) {       /* Index in valid range */
-           h->colors[index] = color;                /* Set new color */
+           ext->colors[index] = color;              /* Set new color */
         } else {
             ret = 0;
         }
@@ -1728,7 +4808,7 @@ guii_widget_setcolor(gui_handle_p h, uint8_t index, gui_color_t color) {
 
 /**
  * \brief           Get first widget handle by ID
- * \note            If multiple widgets have the same ID, first found will be used
+ * \note            If multiple widgets have the same ID, the oldest one will be used
  *
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
  * \param[in,out]   id: Widget ID to search for
@@ -1740,6 +4820,21 @@ guii_widget_getbyid(gui_id_t id) {
     return get_widget_by_id(NULL, id, 1);           /* Find widget by ID */
 }
 
+/**
+ * \brief           Get rarely used values of widget, allocate them on first use
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ * \note            Values are freed together with widget
+ * \param[in,out]   h: Widget handle
+ * \return          Pointer to \ref gui_handle_ext_t or `NULL` when there is no memory
+ */
+gui_handle_ext_t*
+guii_widget_getext(gui_handle_p h) {
+    if (h->ext == NULL) {
+        GUI_MEM_TAGGED(GUI_MEM_TAG_WIDGET_EXT, h->ext = GUI_MEMALLOC(sizeof(*h->ext)));
+    }
+    return h->ext;
+}
+
 /**
  * \brief           Set custom user data to widget
  * \note            The function is private and can be called only when GUI protection against multiple access is activated
@@ -1753,7 +4848,13 @@ guii_widget_getbyid(gui_id_t id) {
 uint8_t
 guii_widget_setuserdata(gui_handle_p h, void* data) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */    
-    __GH(h)->UserData = data;                       /* Set user data */
+    if (data == NULL && h->ext == NULL) {           /* Nothing to store */
+        return 1;
+    }
+    if (guii_widget_getext(h) == NULL) {            /* User data are kept in rarely used values */
+        return 0;
+    }
+    __GH(h)->ext->UserData = data;                  /* Set user data */
     return 1;
 }
 
@@ -1768,21 +4869,16 @@ guii_widget_getuserdata(gui_handle_p h) {
     void* data;
     
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    data = h->UserData;                             /* Get user data */
+    data = guii_widget_getextvalue(h, UserData, NULL);  /* Get user data */
     return data;
 }
 
 /**
- * \brief           Set widget parameter in OS secure way
- * \param[in,out]   h: Widget handle
- * \param[in]       cfg: Configuration to use, passed later to callback function
- * \param[in]       data: Custom data to pass later to configuration callback
- * \param[in]       invalidate: Flag if widget should be invalidated after parameter change
- * \param[in]       invalidateparent: change if parent widget should be invalidated after parameter change
- * \return          `1` on success, `0` otherwise
+ * \brief           Apply widget parameter change
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
  */
-uint8_t
-guii_widget_setparam(gui_handle_p h, uint16_t cfg, const void* data, uint8_t invalidate, uint8_t invalidateparent) {
+static void
+apply_param(gui_handle_p h, uint16_t cfg, const void* data, uint8_t invalidate, uint8_t invalidateparent) {
     gui_widget_param p;
     gui_widget_param_t param = {0};
     gui_widget_result_t result = {0};
@@ -1793,19 +4889,79 @@ guii_widget_setparam(gui_handle_p h, uint16_t cfg, const void* data, uint8_t inv
     p.type = cfg;
     p.data = (void *)data;
     
-    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
-    __GUI_ENTER();                                  /* Enter GUI */
     guii_widget_callback(h, GUI_WC_SetParam, &param, &result); /* Process callback function */
     if (invalidateparent) {
         guii_widget_invalidatewithparent(h);        /* Invalidate widget and parent */
     } else if (invalidate) {
         guii_widget_invalidate(h);                  /* Invalidate widget only */
     }
+}
+
+/**
+ * \brief           Set widget parameter in OS secure way
+ * \note            When called from thread other than GUI thread, change is put to queue
+ *                  and applied on next \ref gui_process call without waiting for GUI thread.
+ *                  Reading parameter back from the same thread may return old value until it is applied
+ * \param[in,out]   h: Widget handle
+ * \param[in]       cfg: Configuration to use, passed later to callback function
+ * \param[in]       data: Custom data to pass later to configuration callback
+ * \param[in]       size: Size of data in units of bytes
+ * \param[in]       invalidate: Flag if widget should be invalidated after parameter change
+ * \param[in]       invalidateparent: change if parent widget should be invalidated after parameter change
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_setparam(gui_handle_p h, uint16_t cfg, const void* data, size_t size, uint8_t invalidate, uint8_t invalidateparent) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    
+#if GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE
+    if (GUI.OS.thread_id != NULL && gui_sys_thread_getid() != GUI.OS.thread_id &&
+        gui_sys_thread_getid() != GUI.OS.batch_thread_id && /* Batch owner already holds GUI */
+        size <= sizeof(post_queue[0].data) &&
+        post_put(h, cfg, data, size, invalidate, invalidateparent)) {
+        __GUI_WAKEUP(&msg_widget_post);             /* Wake up GUI thread */
+        return 1;
+    }
+#else
+    GUI_UNUSED(size);
+#endif /* GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE */
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+#if GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE
+    guii_widget_processposted();                    /* Keep order with changes already in queue */
+#endif /* GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE */
+    apply_param(h, cfg, data, invalidate, invalidateparent);
     __GUI_LEAVE();                                  /* Leave GUI */
     
     return 1;
 }
 
+#if GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE || __DOXYGEN__
+/**
+ * \brief           Apply all widget parameter changes posted from other threads
+ * \note            The function is private and can be called only when GUI protection against multiple access is activated
+ */
+void
+guii_widget_processposted(void) {
+    widget_post_t p;
+    
+    while (1) {
+        gui_sys_mutex_lock(&GUI.OS.post_mutex);     /* Lock only to take entry from queue */
+        if (post_out == post_in) {
+            gui_sys_mutex_unlock(&GUI.OS.post_mutex);
+            break;
+        }
+        memcpy(&p, &post_queue[post_out], sizeof(p));
+        post_out = (post_out + 1) % GUI_COUNT_OF(post_queue);
+        gui_sys_mutex_unlock(&GUI.OS.post_mutex);
+        
+        if (p.h != NULL) {                          /* Widget was not deleted meanwhile */
+            apply_param(p.h, p.cfg, p.hasdata ? p.data.bytes : NULL, p.invalidate, p.invalidateparent);
+        }
+    }
+}
+#endif /* GUI_CFG_OS && GUI_CFG_WIDGET_POST_QUEUE_SIZE || __DOXYGEN__ */
+
 /******************************************************************************/
 /******************************************************************************/
 /***                  Thread safe version of public API                      **/
@@ -1850,7 +5006,7 @@ gui_widget_alloctextmemory(gui_handle_p h, uint32_t size) {
     
     __GUI_LEAVE();                                  /* Leave GUI */
     
-    return h->textmemsize;                          /* Return number of bytes allocated */
+    return guii_widget_getextvalue(h, textmemsize, 0);  /* Return number of bytes allocated */
 }
 
 /**
@@ -1889,7 +5045,52 @@ gui_widget_settext(gui_handle_p h, const gui_char* text) {
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     __GUI_ENTER();                                  /* Enter GUI */
     
-    res = guii_widget_settext(h, text);            /* Set text for widget */
+    res = guii_widget_settext(h, text);            /* Set text for widget */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return res;
+}
+
+/**
+ * \brief           Set integer number as widget text, without printf
+ * \note            Widget must have text memory allocated with \ref gui_widget_alloctextmemory.
+ *                  Widget is not redrawn when number gives the same text as before
+ * \param[in,out]   h: Widget handle
+ * \param[in]       value: Number to set
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_settextfixed, gui_string_fmt_int
+ */
+uint8_t
+gui_widget_settextint(gui_handle_p h, int32_t value) {
+    uint8_t res;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    res = settext_number(h, value, 0);
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return res;
+}
+
+/**
+ * \brief           Set fixed-point number as widget text, without printf
+ * \note            Widget must have text memory allocated with \ref gui_widget_alloctextmemory.
+ *                  Widget is not redrawn when number gives the same text as before
+ * \param[in,out]   h: Widget handle
+ * \param[in]       value: Number scaled by `10^decimals`, for example `2504` with `2` decimals is shown as `25.04`
+ * \param[in]       decimals: Number of digits after decimal point, up to `9`
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_settextint, gui_string_fmt_fixed
+ */
+uint8_t
+gui_widget_settextfixed(gui_handle_p h, int32_t value, uint8_t decimals) {
+    uint8_t res;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    res = settext_number(h, value, decimals);
     
     __GUI_LEAVE();                                  /* Leave GUI */
     return res;
@@ -2111,7 +5312,16 @@ gui_widget_setheightpercent(gui_handle_p h, float height) {
 gui_dim_t
 gui_widget_getwidth(gui_handle_p h) {
     gui_dim_t res;
+#if GUI_CFG_WIDGET_LOCKFREE_GET
+    uint8_t cached;
+#endif /* GUI_CFG_WIDGET_LOCKFREE_GET */
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+#if GUI_CFG_WIDGET_LOCKFREE_GET
+    guii_widget_stateread(h, cached = geometry_iscached(h, GEOMETRY_WIDTH); res = h->geometry.width);
+    if (cached) {                                   /* Size known since last geometry change */
+        return res;
+    }
+#endif /* GUI_CFG_WIDGET_LOCKFREE_GET */
     __GUI_ENTER();                                  /* Enter GUI */
     
     res = guii_widget_getwidth(h);                  /* Get widget width */
@@ -2134,7 +5344,16 @@ gui_widget_getwidth(gui_handle_p h) {
 gui_dim_t
 gui_widget_getheight(gui_handle_p h) {
     gui_dim_t res;
+#if GUI_CFG_WIDGET_LOCKFREE_GET
+    uint8_t cached;
+#endif /* GUI_CFG_WIDGET_LOCKFREE_GET */
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+#if GUI_CFG_WIDGET_LOCKFREE_GET
+    guii_widget_stateread(h, cached = geometry_iscached(h, GEOMETRY_HEIGHT); res = h->geometry.height);
+    if (cached) {                                   /* Size known since last geometry change */
+        return res;
+    }
+#endif /* GUI_CFG_WIDGET_LOCKFREE_GET */
     __GUI_ENTER();                                  /* Enter GUI */
     
     res = guii_widget_getheight(h);                /* Get widget height */
@@ -2406,7 +5625,8 @@ gui_widget_getid(gui_handle_p h) {
 
 /**
  * \brief           Get first widget handle by ID
- * \note            If multiple widgets have the same ID, first found will be used
+ * \note            If multiple widgets have the same ID, the oldest one will be used
+ * \note            Lookup time does not depend on number of widgets, see \ref GUI_CFG_WIDGET_ID_HASH_SIZE
  * \param[in,out]   id: Widget ID to search for
  * \return          > 0: Widget handle when widget found
  * \return          `1` on success, `0` otherwise
@@ -2491,7 +5711,7 @@ gui_widget_processdefaultcallback(gui_handle_p h, gui_wc_t ctrl, gui_widget_para
     __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
     __GUI_ENTER();                                  /* Enter GUI */
     
-    ret = h->widget->callback(h, ctrl, param, result);  /* Call callback function */
+    ret = guii_widget_issubscribed(h->widget->events, ctrl) ? h->widget->callback(h, ctrl, param, result) : 0;  /* Call callback function */
     
     __GUI_LEAVE();                                  /* Leave GUI */
     return ret;
@@ -2515,6 +5735,27 @@ gui_widget_setcallback(gui_handle_p h, gui_widget_callback_t callback) {
     return 1;
 }
 
+/**
+ * \brief           Set commands handled by user callback of widget
+ * \note            Commands not in mask are sent directly to default widget callback,
+ *                  for example touch move samples when application handles only clicks
+ * \param[in,out]   h: Widget handle object
+ * \param[in]       events: Mask of commands built with \ref GUI_WC_MASK or \ref GUI_WC_MASK_ALL to receive all commands.
+ *                      Commands in \ref GUI_WC_MASK_CORE are always received
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_setcallback
+ */
+uint8_t
+gui_widget_setcallbackevents(gui_handle_p h, uint32_t events) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    h->callback_events = events;                    /* Set subscribed commands */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
 /**
  * \brief           Widget callback function for all events
  * \note            Called from user outside callback. For calling default callback
@@ -2557,8 +5798,9 @@ gui_widget_setscrollx(gui_handle_p h, gui_dim_t scroll) {
     __GUI_ENTER();                                  /* Enter GUI */
     
     if (__GHR(h)->x_scroll != scroll) {             /* Only widgets with children support can set scroll */
+        guii_widget_scrollchildren(h, scroll - __GHR(h)->x_scroll, 0);   /* Move by difference */
         __GHR(h)->x_scroll = scroll;
-        guii_widget_invalidate(h);
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
         ret = 1;
     }
     
@@ -2582,8 +5824,9 @@ gui_widget_setscrolly(gui_handle_p h, gui_dim_t scroll) {
     __GUI_ENTER();                                  /* Enter GUI */
     
     if (__GHR(h)->y_scroll != scroll) {             /* Only widgets with children support can set scroll */
+        guii_widget_scrollchildren(h, 0, scroll - __GHR(h)->y_scroll);   /* Move by difference */
         __GHR(h)->y_scroll = scroll;
-        guii_widget_invalidate(h);
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
         ret = 1;
     }
     
@@ -2608,7 +5851,8 @@ gui_widget_incscrollx(gui_handle_p h, gui_dim_t scroll) {
     
     if (scroll) {                                   /* Only widgets with children support can set scroll */
         __GHR(h)->x_scroll += scroll;
-        guii_widget_invalidate(h);
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
+        guii_widget_scrollchildren(h, scroll, 0);   /* Move drawn children, redraw exposed strip */
         ret = 1;
     }
     
@@ -2633,7 +5877,8 @@ gui_widget_incscrolly(gui_handle_p h, gui_dim_t scroll) {
     
     if (scroll) {                                   /* Only widgets with children support can set scroll */
         __GHR(h)->y_scroll += scroll;
-        guii_widget_invalidate(h);
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
+        guii_widget_scrollchildren(h, 0, scroll);   /* Move drawn children, redraw exposed strip */
         ret = 1;
     }
     
@@ -2774,6 +6019,8 @@ gui_widget_getzindex(gui_handle_p h) {
 #if GUI_CFG_USE_TRANSPARENCY || __DOXYGEN__
 /**
  * \brief           Set transparency level to widget
+ * \note            To fade widget with children at cost of single blend per step,
+ *                  enable retained bitmap with \ref gui_widget_setretained
  * \param[in,out]   h: Widget handle
  * \param[in]       trans: Transparency level, where 0x00 means hidden and 0xFF means totally visible widget
  * \return          `1` on success, `0` otherwise
@@ -2792,6 +6039,32 @@ gui_widget_settransparency(gui_handle_p h, uint8_t trans) {
     return ret;
 }
 
+#if GUI_CFG_WIDGET_MASK || __DOXYGEN__
+/**
+ * \brief           Set 8-bit alpha mask to widget
+ * \note            Widget and its children are drawn to temporary layer and blended to screen
+ *                  with mask value as alpha of each pixel, multiplied by widget transparency.
+ *                  Use it to clip children of rounded or other non-rectangular containers
+ * \note            Mask starts on top left corner of widget, part of widget outside mask is not visible.
+ *                  Mask memory must stay valid while it is set. Mask is not applied on rotated screen
+ * \param[in,out]   h: Widget handle
+ * \param[in]       mask: Pointer to \ref gui_mask_t mask or `NULL` to remove it
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_widget_setmask(gui_handle_p h, const gui_mask_t* mask) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    ret = guii_widget_setmask(h, mask);             /* Set widget mask */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+#endif /* GUI_CFG_WIDGET_MASK || __DOXYGEN__ */
+
 /**
  * \brief           Get widget transparency value
  * \note            Value between 0 and 0xFF is used:
@@ -2835,6 +6108,458 @@ gui_widget_set3dstyle(gui_handle_p h, uint8_t enable) {
     return ret;
 }
 
+/**
+ * \brief           Enable or disable retained bitmap for widget and its children
+ * \note            Use it for static content, such as containers with labels, icons and frames.
+ *                  Redraw of widget is then single memory copy until widget or any of its children changes.
+ *                  Each retained widget uses one bitmap of its size in RAM
+ * \note            Use it also for windows and dialogs faded in or out with \ref gui_widget_settransparency.
+ *                  Content is drawn once and every fade step is single blend of bitmap with transparency level
+ * \param[in,out]   h: Widget handle
+ * \param[in]       enable: Value to enable, either 1 or 0
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_widget_setretained(gui_handle_p h, uint8_t enable) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    ret = guii_widget_setretained(h, enable);       /* Set retained mode */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+#if GUI_CFG_WIDGET_INSTANCE_CACHE || __DOXYGEN__
+
+/**
+ * \brief           Enable or disable drawing of widget from bitmap shared with identical widgets
+ * \note            Use it for many widgets with the same look, such as keys of keyboard or status LEDs.
+ *                  First drawn widget is saved to bitmap, others with the same type, size, state,
+ *                  colors, text and pixels below are copied from it
+ * \note            Widget drawing must only depend on these values and on widget specific structure,
+ *                  data changed in place behind pointers are not detected
+ * \param[in,out]   h: Widget handle
+ * \param[in]       enable: Value to enable, either 1 or 0
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_widget_setinstanced(gui_handle_p h, uint8_t enable) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    ret = guii_widget_setinstanced(h, enable);      /* Set instanced mode */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+#endif /* GUI_CFG_WIDGET_INSTANCE_CACHE || __DOXYGEN__ */
+
+#if GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__
+
+/**
+ * \brief           Enable or disable display list for widget
+ * \note            Drawing commands of widget are recorded on complete redraw and replayed later
+ *                  without calling widget draw callback, until widget is invalidated.
+ *                  Use it for widgets with expensive drawing logic which change rarely.
+ *                  Children widgets are not part of the list, each of them needs own list.
+ *                  Draw callback must not depend on anything else than widget state, as it is not called on replay
+ * \param[in,out]   h: Widget handle
+ * \param[in]       enable: Value to enable, either 1 or 0
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_widget_setdisplaylist(gui_handle_p h, uint8_t enable) {
+    uint8_t ret;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    ret = guii_widget_setdisplaylist(h, enable);    /* Set display list mode */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+#endif /* GUI_CFG_USE_DISPLAY_LIST || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_STATICS || __DOXYGEN__
+
+/**
+ * \brief           Set static elements drawn by widget
+ * \note            Static elements (labels, icons) have no widget handle and use only memory of array.
+ *                  They can not receive touch or focus and are drawn below children widgets,
+ *                  text elements use font of widget
+ * \param[in,out]   h: Widget handle. Widget must allow children widgets
+ * \param[in]       statics: Array of elements. It must stay valid while set to widget. Set to `NULL` to remove elements
+ * \param[in]       count: Number of elements in array
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_invalidatestatic
+ */
+uint8_t
+gui_widget_setstatics(gui_handle_p h, const gui_static_t* statics, size_t count) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h) && guii_widget_allowchildren(h) && count <= 0xFFFF);   /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    __GHR(h)->statics = statics;
+    __GHR(h)->statics_count = statics != NULL ? (uint16_t)count : 0;
+    guii_widget_invalidate(h);                      /* Redraw widget with new elements */
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Redraw area of one static element of widget
+ * \note            Use it when content pointed to by element has changed
+ * \param[in,out]   h: Widget handle
+ * \param[in]       index: Index of element in array set with \ref gui_widget_setstatics
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_widget_invalidatestatic(gui_handle_p h, size_t index) {
+    const gui_static_t* s;
+    uint8_t ret = 0;
+    
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h) && guii_widget_allowchildren(h));  /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (index < __GHR(h)->statics_count) {
+        s = &__GHR(h)->statics[index];
+        ret = guii_widget_invalidaterect(h,
+            guii_widget_getpaddingleft(h) - __GHR(h)->x_scroll + s->x,
+            guii_widget_getpaddingtop(h) - __GHR(h)->y_scroll + s->y,
+            s->width, s->height);
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return ret;
+}
+
+#endif /* GUI_CFG_WIDGET_STATICS || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_TREE || __DOXYGEN__
+
+/**
+ * \brief           Create widgets from constant tree description
+ * \note            Handles of all widgets are allocated with single memory allocation,
+ *                  which is freed when all widgets of tree are removed.
+ *                  Text and font are used directly from description, text is not copied
+ *
+ * \note            First entry is root of tree. Other entries must follow their parent entry in depth-first order,
+ *                  as generated by tools, with at most `8` levels of nesting
+ * \param[in]       desc: Array of widget descriptions
+ * \param[in]       count: Number of entries in array
+ * \param[in]       parent: Parent widget of tree root. Set to `NULL` to use current active parent widget
+ * \return          Handle of root widget on success, `NULL` otherwise
+ */
+gui_handle_p
+gui_widget_createtree(const gui_widget_desc_t* desc, size_t count, gui_handle_p parent) {
+    gui_handle_p stack[TREE_MAX_DEPTH];
+    int16_t stack_idx[TREE_MAX_DEPTH];
+    gui_handle_p h, root = NULL;
+    const gui_widget_desc_t* d;
+    size_t i, depth = 0;
+    
+    __GUI_ASSERTPARAMS(desc != NULL && count > 0);  /* Check input parameters */
+    gui_widget_batch_begin();                       /* Combine invalidation of all widgets */
+    
+    /* First pass only sums sizes of handles */
+    tree_alloc.measuring = 1;
+    tree_alloc.measure = 0;
+    for (i = 0; i < count; i++) {
+        desc[i].create(desc[i].id, desc[i].x, desc[i].y, desc[i].width, desc[i].height, NULL, desc[i].cb, desc[i].flags);
+    }
+    tree_alloc.measuring = 0;
+    
+    GUI_MEM_TAGGED(GUI_MEM_TAG_WIDGET_TREE,
+        tree_alloc.tree = GUI_MEMALLOC_HINT(GUI_MEM_ALIGN(sizeof(widget_tree_t)) + tree_alloc.measure, GUI_MEM_HOT));
+    if (tree_alloc.tree != NULL) {
+        tree_alloc.tree->end = (uint8_t *)tree_alloc.tree + GUI_MEM_ALIGN(sizeof(widget_tree_t)) + tree_alloc.measure;
+        tree_alloc.tree->count = 1;                 /* Block is kept until tree is created */
+        tree_alloc.tree->next = trees;
+        trees = tree_alloc.tree;
+        tree_alloc.ptr = (uint8_t *)tree_alloc.tree + GUI_MEM_ALIGN(sizeof(widget_tree_t));
+    }
+    
+    for (i = 0; i < count; i++) {
+        d = &desc[i];
+        if (i) {                                    /* Find parent between entries above in tree */
+            while (depth > 0 && stack_idx[depth - 1] != d->parent) {
+                depth--;
+            }
+            if (!depth) {                           /* Invalid order of entries */
+                break;
+            }
+        }
+        h = d->create(d->id, d->x, d->y, d->width, d->height, i ? stack[depth - 1] : parent, d->cb, d->flags);
+        if (h == NULL) {
+            break;
+        }
+        if (d->font != NULL) {
+            guii_widget_setfont(h, d->font);
+        }
+        if (d->text != NULL) {
+            guii_widget_settext(h, d->text);        /* Pointer to constant text is kept */
+        }
+        if (!i) {
+            root = h;
+        }
+        if (depth == TREE_MAX_DEPTH) {
+            break;
+        }
+        stack[depth] = h;
+        stack_idx[depth++] = (int16_t)i;
+    }
+    if (tree_alloc.tree != NULL) {
+        tree_alloc.tree->count--;                   /* Remove reference of tree creation */
+        if (!tree_alloc.tree->count) {              /* Nothing was allocated from block */
+            trees = tree_alloc.tree->next;
+            GUI_MEMFREE(tree_alloc.tree);
+        }
+        tree_alloc.tree = NULL;
+    }
+    if (i < count && root != NULL) {                /* Remove partially created tree */
+        guii_widget_remove(root);
+        root = NULL;
+    }
+    
+    gui_widget_batch_commit();
+    return root;
+}
+
+#endif /* GUI_CFG_WIDGET_TREE || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_STYLE || __DOXYGEN__
+
+/**
+ * \brief           Create new shared style
+ * \note            Values of style override widget values, except colors set with widget set color functions.
+ *                  Style is freed when it is released with \ref gui_style_release and not used by any widget
+ * \param[in]       colors: Array of colors, indexed as colors of widgets using style, or `NULL`.
+ *                      Array must stay valid while used by style and can be placed in flash memory
+ * \param[in]       count: Number of entries in colors array
+ * \return          Style handle on success, `NULL` otherwise
+ * \sa              gui_widget_setstyle, gui_style_release
+ */
+gui_style_p
+gui_style_create(const gui_color_t* colors, uint8_t count) {
+    gui_style_t* s;
+    
+    __GUI_ENTER();                                  /* Enter GUI */
+    s = GUI_MEMALLOC(sizeof(*s));
+    if (s != NULL) {
+        s->colors = colors;
+        s->color_count = colors != NULL ? count : 0;
+        s->ref_count = 1;                           /* Reference of creator */
+    }
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return s;
+}
+
+/**
+ * \brief           Release style reference of its creator
+ * \note            Style stays valid until it is removed from all widgets using it
+ * \param[in]       s: Style handle. It must not be used by creator after function call
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_release(gui_style_p s) {
+    __GUI_ASSERTPARAMS(s != NULL);                  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    style_release(s);
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Set colors of style and redraw all widgets using it
+ * \note            Switch of theme is single pointer change when theme colors are in constant arrays
+ * \param[in,out]   s: Style handle
+ * \param[in]       colors: Array of colors, indexed as colors of widgets using style, or `NULL`
+ * \param[in]       count: Number of entries in colors array
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_setcolors(gui_style_p s, const gui_color_t* colors, uint8_t count) {
+    __GUI_ASSERTPARAMS(s != NULL);                  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    s->colors = colors;
+    s->color_count = colors != NULL ? count : 0;
+    style_changed(s, 0);
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Set font of style and redraw all widgets using it
+ * \param[in,out]   s: Style handle
+ * \param[in]       font: Font or `NULL` to use font of each widget
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_setfont(gui_style_p s, const gui_font_t* font) {
+    __GUI_ASSERTPARAMS(s != NULL);                  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    s->font = font;
+    if (font != NULL) {
+        s->flags |= GUI_STYLE_FLAG_FONT;
+    } else {
+        s->flags &= ~GUI_STYLE_FLAG_FONT;
+    }
+    style_changed(s, 0);
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Set padding of style and redraw all widgets using it
+ * \param[in,out]   s: Style handle
+ * \param[in]       top: Top padding in units of pixels
+ * \param[in]       right: Right padding in units of pixels
+ * \param[in]       bottom: Bottom padding in units of pixels
+ * \param[in]       left: Left padding in units of pixels
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_setpadding(gui_style_p s, gui_dim_t top, gui_dim_t right, gui_dim_t bottom, gui_dim_t left) {
+    __GUI_ASSERTPARAMS(s != NULL);                  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    s->padding = (uint32_t)((uint8_t)top) << 24 | (uint32_t)((uint8_t)right) << 16 | (uint32_t)((uint8_t)bottom) << 8 | (uint32_t)((uint8_t)left);
+    s->flags |= GUI_STYLE_FLAG_PADDING;
+    style_changed(s, 1);
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Set border radius of style and redraw all widgets using it
+ * \note            Radius is used by widgets with rounded borders, for example buttons
+ * \param[in,out]   s: Style handle
+ * \param[in]       radius: Border radius in units of pixels
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_setborderradius(gui_style_p s, gui_dim_t radius) {
+    __GUI_ASSERTPARAMS(s != NULL);                  /* Check input parameters */
+    __GUI_ENTER();                                  /* Enter GUI */
+    s->border_radius = radius;
+    s->flags |= GUI_STYLE_FLAG_RADIUS;
+    style_changed(s, 0);
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Set shared style of widget
+ * \param[in,out]   h: Widget handle
+ * \param[in]       s: Style handle or `NULL` to remove style from widget
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_style_create
+ */
+uint8_t
+gui_widget_setstyle(gui_handle_p h, gui_style_p s) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (h->style != s) {
+        if (s != NULL) {
+            s->ref_count++;
+        }
+        if (h->style != NULL) {
+            style_release(h->style);
+        }
+        h->style = s;
+        guii_widget_geometrychanged();              /* Padding of style might be different */
+        guii_widget_invalidatewithparent(h);        /* Redraw with new values */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+#endif /* GUI_CFG_WIDGET_STYLE || __DOXYGEN__ */
+
+#if GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__
+
+/**
+ * \brief           Set placement of children widgets
+ * \note            Children in layout ignore their own position and are never reordered on touch or focus
+ * \param[in]       h: Widget handle. Widget must allow children
+ * \param[in]       type: Layout type, member of \ref gui_layout_type_t
+ * \param[in]       gap: Space between children in units of pixels
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_setlayoutcolumns, gui_widget_setflexgrow
+ */
+uint8_t
+gui_widget_setlayout(gui_handle_p h, gui_layout_type_t type, gui_dim_t gap) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h) && guii_widget_allowchildren(h) && type <= GUI_LAYOUT_GRID && gap >= 0); /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (h->layout.type != (uint8_t)type || h->layout.gap != gap) {
+        h->layout.type = (uint8_t)type;
+        h->layout.gap = gap;
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
+        guii_widget_invalidate(h);                  /* Redraw with new positions of children */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Set number of columns for \ref GUI_LAYOUT_GRID layout
+ * \param[in]       h: Widget handle
+ * \param[in]       columns: Number of columns of equal width. Value must be greater than `0`
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_setlayout
+ */
+uint8_t
+gui_widget_setlayoutcolumns(gui_handle_p h, uint8_t columns) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h) && columns > 0); /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (h->layout.columns != columns) {
+        h->layout.columns = columns;
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
+        guii_widget_invalidate(h);                  /* Redraw with new positions of children */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+/**
+ * \brief           Set share of free space widget takes in row or column layout of parent
+ * \note            Free space is divided between children proportionally to their grow factor,
+ *                  widget size is used as minimal size
+ * \param[in]       h: Widget handle
+ * \param[in]       grow: Grow factor. Set to `0` to keep widget size
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_setlayout
+ */
+uint8_t
+gui_widget_setflexgrow(gui_handle_p h, uint8_t grow) {
+    __GUI_ASSERTPARAMS(guii_widget_iswidget(h));    /* Check valid parameter */
+    __GUI_ENTER();                                  /* Enter GUI */
+    
+    if (h->layout.grow != grow) {
+        h->layout.grow = grow;
+        guii_widget_geometrychanged();              /* Invalidate cached geometry */
+        guii_widget_invalidatewithparent(h);        /* Siblings are moved too */
+    }
+    
+    __GUI_LEAVE();                                  /* Leave GUI */
+    return 1;
+}
+
+#endif /* GUI_CFG_WIDGET_LAYOUT || __DOXYGEN__ */
+
 /**
  * \brief           Set widget top padding
  * \param[in]       h: Widget handle
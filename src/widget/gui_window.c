@@ -55,10 +55,14 @@ static const
 gui_widget_t widget = {
     .name = _GT("WINDOW"),                          /*!< Widget name */
     .size = sizeof(gui_window_t),                   /*!< Size of widget for memory allocation */
-    .flags = GUI_FLAG_WIDGET_ALLOW_CHILDREN,        /*!< List of widget flags */
+    .flags = GUI_FLAG_WIDGET_ALLOW_CHILDREN | GUI_FLAG_WIDGET_OPAQUE,   /*!< List of widget flags */
     .callback = gui_window_callback,                /*!< Control function */
     .colors = colors,                               /*!< Pointer to colors array */
     .color_count = GUI_COUNT_OF(colors),            /*!< Number of colors */
+    .events = GUI_WC_MASK_CORE | GUI_WC_MASK(GUI_WC_TouchStart) | /*!< Handled callback commands */
+            GUI_WC_MASK(GUI_WC_TouchMove) | GUI_WC_MASK(GUI_WC_TouchEnd) |
+            GUI_WC_MASK(GUI_WC_Click) | GUI_WC_MASK(GUI_WC_DblClick) |
+            GUI_WC_MASK(GUI_WC_KeyPress),
 };
 
 #define w          ((gui_window_t *)h)
@@ -95,7 +99,7 @@ gui_window_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gu
             wi = guii_widget_getwidth(h);
             hi = guii_widget_getheight(h);
             
-            gui_draw_filledrectangle(disp, x, y, wi, hi, guii_widget_getcolor(h, GUI_WINDOW_COLOR_BG));
+            guii_widget_drawbackground(h, disp, x, y, wi, hi, guii_widget_getcolor(h, GUI_WINDOW_COLOR_BG));
             if (guii_widget_getflag(h, GUI_FLAG_CHILD)) {
                 gui_dim_t tx, ty, tW;
                 
@@ -162,6 +166,7 @@ gui_window_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gu
                     f.align = GUI_HALIGN_CENTER | GUI_VALIGN_CENTER;
                     f.color1width = f.width;
                     f.color1 = guii_widget_getcolor(h, GUI_WINDOW_COLOR_TEXT);
+                    f.layout = &h->textlayout;      /* Reuse text layout between redraws */
                     gui_draw_writetext(disp, guii_widget_getfont(h), guii_widget_gettext(h), &f);
                 }
             }
@@ -279,7 +284,15 @@ gui_window_callback(gui_handle_p h, gui_wc_t ctrl, gui_widget_param_t* param, gu
  */
 gui_handle_p
 gui_window_createdesktop(gui_id_t id, gui_widget_callback_t cb) {
-    return (gui_handle_p)guii_widget_create(&widget, id, 0, 0, GUI.lcd.width, GUI.lcd.height, 0, cb, GUI_FLAG_WIDGET_CREATE_PARENT_DESKTOP);/* Allocate memory for basic widget */
+    gui_handle_p h;
+    
+    h = (gui_handle_p)guii_widget_create(&widget, id, 0, 0, GUI.lcd.width, GUI.lcd.height, 0, cb, GUI_FLAG_WIDGET_CREATE_PARENT_DESKTOP);/* Allocate memory for basic widget */
+#if GUI_CFG_LCD_BACKGROUND
+    if (h != NULL && GUI.lcd.background != NULL) {  /* Desktop only clears drawing layer and lets background layer show through */
+        guii_widget_setcolor(h, GUI_WINDOW_COLOR_BG, GUI_COLOR_TRANS);
+    }
+#endif /* GUI_CFG_LCD_BACKGROUND */
+    return h;
 }
 
 /**